@@ -17,6 +17,17 @@ namespace ov::genai {
                     * of a given token in cache */
     };
 
+    /**
+    * @brief Represents the policy selecting the tokens, whose attention scores define importance of blocks for eviction
+    */
+    enum class CacheEvictionPolicy {
+        H2O,    /**< Heavy hitters: scores of each token are aggregated over all generation steps since the token is in cache,
+                   * including all steps of prompt processing, and blocks are evicted whenever the cache is overfilled */
+        SNAPKV  /**< Prompt compression: eviction is postponed until the whole prompt is processed, then the prompt is compressed
+                   * based on the scores from the observation window (queries of the last prompt chunk) only, smoothed by max pooling
+                   * to keep clustered important tokens together. Afterwards scores are aggregated as in H2O */
+    };
+
     /**
     * @brief Configuration struct for the cache eviction algorithm.
     */
@@ -60,6 +71,12 @@ namespace ov::genai {
 
         /** The mode used to compute the importance of tokens for eviction */
         AggregationMode aggregation_mode = AggregationMode::NORM_SUM;
+
+        /** The policy selecting attention scores used to compute the importance of tokens for eviction */
+        CacheEvictionPolicy policy = CacheEvictionPolicy::H2O;
+
+        /** Size of the max pooling window (in tokens) applied to the observation window scores in SNAPKV policy, 1 disables pooling */
+        std::size_t pooling_kernel_size = 7;
     private:
         /** Number of tokens in the *beginning* of KV cache that should be retained
  * in the KV cache for this sequence during generation. Must be non-zero and a multiple of the KV cache block size for
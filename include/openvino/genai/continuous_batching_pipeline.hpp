@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 #include <openvino/openvino.hpp>
 
@@ -19,11 +21,39 @@
 
 namespace ov::genai {
 
+class VLMPipeline;
+
+/**
+ * @brief Distribution of values observed at pipeline steps, in a shape of Prometheus histogram.
+ */
+struct OPENVINO_GENAI_EXPORTS MetricsHistogram {
+    /**
+     * Upper bounds of buckets in increasing order, the last bucket collects values above the last bound (+Inf).
+     */
+    std::vector<double> upper_bounds;
+
+    /**
+     * Number of observed values per bucket, not cumulative. Contains upper_bounds.size() + 1 elements.
+     */
+    std::vector<size_t> counts;
+
+    /**
+     * Sum and number of all observed values.
+     */
+    double sum = 0.0;
+    size_t count = 0;
+
+    MetricsHistogram() = default;
+    explicit MetricsHistogram(std::vector<double> upper_bounds);
+
+    void observe(double value);
+};
+
 /**
  * @brief Contains general pipeline metrics, either aggregated throughout the lifetime of the generation pipeline
- * or measured at the previous generation step.
+ * or measured at the previous generation step. Counters named num_* grow monotonically during the lifetime of the pipeline.
  */
-struct PipelineMetrics {
+struct OPENVINO_GENAI_EXPORTS PipelineMetrics {
     /**
      * Number of requests to be processed by the pipeline.
      */
@@ -48,6 +78,84 @@ struct PipelineMetrics {
     * Running average of the KV cache usage during the lifetime of the pipeline, with max window size of 1000 steps
     */
     float avg_cache_usage = 0.0;
+
+    /**
+     * Number of requests, which were not scheduled at the previous step, e.g. waiting for KV cache or preempted,
+     * including the ones added after the step.
+     */
+    size_t waiting_requests = 0;
+
+    /**
+     * Number of KV cache blocks (per layer) allocated for the pipeline, occupied by sequences and not occupied, but
+     * holding contents of finished sequences for prefix caching. Cached blocks are also counted as free ones.
+     */
+    size_t kv_blocks_total = 0;
+    size_t kv_blocks_free = 0;
+    size_t kv_blocks_cached = 0;
+
+    /**
+     * Prompt tokens of requests, which were looked up in prefix cache, and the ones found there. The ratio of the two
+     * is prefix cache hit rate.
+     */
+    size_t num_prefix_cache_queried_tokens = 0;
+    size_t num_prefix_cache_hit_tokens = 0;
+
+    /**
+     * Number of times sequence groups were preempted to free KV cache for other ones.
+     */
+    size_t num_preemptions = 0;
+
+    /**
+     * Number of KV cache blocks evicted by cache eviction algorithm.
+     */
+    size_t num_evicted_blocks = 0;
+
+    /**
+     * Number of requests, whose handles were dropped before generation finished, and token positions, which were processed
+     * for them by model inference and are wasted.
+     */
+    size_t num_cancelled_requests = 0;
+    size_t num_cancelled_processed_tokens = 0;
+
+    /**
+     * Number of pipeline steps, tokens processed by model inference (prompt and generated ones) and tokens generated.
+     */
+    size_t num_steps = 0;
+    size_t num_processed_tokens = 0;
+    size_t num_generated_tokens = 0;
+
+    /**
+     * Generated tokens per second over the latest steps, with the same window as 'avg_cache_usage'.
+     */
+    float generated_tokens_per_second = 0.0f;
+
+    /**
+     * Step latency in milliseconds, the number of scheduled requests and tokens processed per step.
+     */
+    MetricsHistogram step_latency_ms{{1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000}};
+    MetricsHistogram batch_size{{1, 2, 4, 8, 16, 32, 64, 128, 256}};
+    MetricsHistogram tokens_per_step{{1, 4, 16, 64, 256, 1024, 4096, 16384}};
+
+    /**
+     * Formats metrics in Prometheus text exposition format.
+     * @param prefix Prefix of metric names.
+     */
+    std::string to_prometheus(const std::string& prefix = "openvino_genai") const;
+};
+
+/**
+ * @brief Log probabilities of target tokens of a prompt computed by ContinuousBatchingPipeline::score().
+ */
+struct OPENVINO_GENAI_EXPORTS ScoringResult {
+    /**
+     * Log probability of each target token given all preceding tokens, empty if only the sum is requested.
+     */
+    std::vector<float> log_probs;
+
+    /**
+     * Sum of log probabilities of target tokens, i.e. log-likelihood of the target span given the preceding tokens.
+     */
+    float sum_log_prob = 0.0f;
 };
 
 class OPENVINO_GENAI_EXPORTS ContinuousBatchingPipeline {
@@ -56,13 +164,23 @@ protected:
     class ContinuousBatchingImpl;
     class ContinuousBatchingForSpeculativeDecodingImpl;
     class ContinuousBatchingForPromptLookupImpl;
+    class ContinuousBatchingForMedusaImpl;
     class SpeculativeDecodingImpl;
     class PromptLookupImpl;
+    class MedusaImpl;
+    class DataParallelImpl;
+    class DisaggregatedImpl;
 
     friend class ContinuousBatchingForSpeculativeDecodingImpl;
     friend class ContinuousBatchingForPromptLookupImpl;
+    friend class ContinuousBatchingForMedusaImpl;
     friend class SpeculativeDecodingImpl;
     friend class PromptLookupImpl;
+    friend class MedusaImpl;
+    friend class DataParallelImpl;
+    friend class DisaggregatedImpl;
+    // language model of VLMPipeline is run by ContinuousBatchingImpl with embeddings of prompts
+    friend class VLMPipeline;
 
     std::shared_ptr<ImplInterface> m_impl;
 
@@ -123,7 +241,8 @@ public:
     ov::genai::GenerationConfig get_config() const;
 
     /**
-     * Allows to get the current pipeline metrics.
+     * Allows to get the current pipeline metrics. Can be called from any thread, while the pipeline is running:
+     * metrics are published as a consistent snapshot after each step, so a call never waits for a step to complete.
      * @return The struct with pipeline metrics for the previous generation step.
      */
     ov::genai::PipelineMetrics get_metrics() const;
@@ -149,5 +268,35 @@ public:
     * @brief finish chat and clear kv cache.
     */
     void finish_chat();
+
+    /**
+    * @brief prepare the pipeline to serve requests without delays of the first ones.
+    * Tokenizes and detokenizes a text and generates synthetic prompts of the configured shapes with the default generation config,
+    * so that kernels are compiled and memory is allocated for these shapes. Results are discarded, while metrics count the warmup
+    * requests. Cannot be called while requests are processed.
+    * @param config prompt lengths, batch sizes and number of generated tokens.
+    */
+    void warmup(const WarmupConfig& config = {});
+
+    /**
+    * @brief compute log probabilities of prompt tokens without generation, e.g. for reranking or perplexity evaluation.
+    * Prompts are added as prefill-only requests, which the scheduler packs into steps like other prompts, and whose KV cache
+    * is freed once their prompts are processed. Set SchedulerConfig::device_prompt_log_probs to compute log probabilities on device.
+    * Cannot be called while requests are processed.
+    * @param input_ids prompts of shape [1, prompt length].
+    * @param target_offsets position of the first target token per prompt, tokens from it to the end of the prompt are scored.
+    * If empty, all tokens except the first one, which has no context, are scored.
+    * @param return_log_probs whether log probabilities of target tokens are returned in addition to their sum.
+    */
+    std::vector<ScoringResult> score(const std::vector<ov::Tensor>& input_ids, const std::vector<size_t>& target_offsets = {}, bool return_log_probs = true);
+
+    /**
+    * @brief compute log-likelihood of each continuation given its context, e.g. for reranking or multiple choice evaluation.
+    * A context is tokenized with special tokens, a continuation without them, and their tokens are scored as one prompt.
+    * @param contexts texts conditioning continuations, must produce at least one token.
+    * @param continuations scored texts.
+    * @param return_log_probs whether log probabilities of continuation tokens are returned in addition to their sum.
+    */
+    std::vector<ScoringResult> score(const std::vector<std::string>& contexts, const std::vector<std::string>& continuations, bool return_log_probs = true);
 };
 }
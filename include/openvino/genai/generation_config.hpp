@@ -44,6 +44,21 @@ enum class StopCriteria { EARLY, HEURISTIC, NEVER };
  * @param echo if set to true, output will include user prompt (default: false).
  * @param logprobs number of top logprobs computed for each position, if set to 0, logprobs are not computed and value 0.0 is returned.
  *                 Currently only single top logprob can be returned, so any logprobs > 1 is treated as logprobs == 1. (default: 0).
+ * @param priority scheduling priority of the request in continuous batching pipelines. Requests with greater values are scheduled
+ *        first and preempted last when SchedulerConfig::scheduling_policy is SchedulingPolicy::PRIORITY (default: 0).
+ * @param deadline_ms deadline of the request in milliseconds, counted from the moment the request is added to the pipeline.
+ *        Used by SchedulingPolicy::EARLIEST_DEADLINE_FIRST, 0 means no deadline (default: 0).
+ * @param expected_new_tokens hint of the number of tokens the request generates, which continuous batching pipelines reserve KV cache
+ *        for, when they admit the request (see SchedulerConfig::output_length_estimate), 0 means no hint (default: 0).
+ * @param streamer_queue_size if non-zero, the streamer passed to generate() is called by a dedicated thread, which takes generated tokens
+ *        from a queue of this capacity, so that a slow streamer delays generation only when the queue is full. A streamer stopping
+ *        generation is noticed by the next generated token, while tokens queued before are not passed to it (default: 0).
+ *
+ * Structured output parameters (greedy decoding and multinomial sampling only):
+ * @param regex if not empty, only tokens keeping the generated text a prefix of a text fully matched by this regular expression are
+ *        generated, and stop tokens are generated only once the whole text is matched (default: "").
+ * @param json_schema if not empty, only JSON documents valid against this JSON schema are generated. The schema is converted to
+ *        a regular expression, so recursive schemas are not supported. Mutually exclusive with `regex` (default: "").
  *
  * Beam search specific parameters:
  * @param num_beams number of beams for beam search. 1 disables beam search.
@@ -60,6 +75,9 @@ enum class StopCriteria { EARLY, HEURISTIC, NEVER };
  *        "EARLY", where the generation stops as soon as there are `num_beams` complete candidates; "HEURISTIC", where an
  *        "HEURISTIC" is applied and the generation stops when is it very unlikely to find better candidates;
  *        "NEVER", where the beam search procedure only stops when there cannot be better candidates (canonical beam search algorithm).
+ * @param prune_beams if true, a running beam is dropped together with its KV cache as soon as even with the most favorable length
+ *        penalty it cannot outscore the worst of `num_beams / num_beam_groups` finished candidates of its group, and its place is
+ *        given to other beams. Results may differ from the canonical beam search, since kept beams get more children (default: false).
  *
  * Random sampling parameters:
  * @param temperature the value used to modulate token probabilities for random sampling.
@@ -74,6 +92,8 @@ enum class StopCriteria { EARLY, HEURISTIC, NEVER };
  * Assisting generation parameters:
  * @param assistant_confidence_threshold the lower token probability of candidate to be validated by main model in case of dynamic strategy candidates number update.
  * @param num_assistant_tokens the defined candidates number to be generated by draft model/prompt lookup in case of static strategy candidates number update.
+ * @param adaptive_num_assistant_tokens if true, speculative decoding drafts up to `num_assistant_tokens` candidates per step, choosing their number
+ *        from the observed acceptance rate and measured durations of draft and main model steps to maximize accepted tokens per second (default: false).
  * @param max_ngram_size is maximum ngram to use when looking for matches in the prompt.
  */
 
@@ -90,7 +110,19 @@ public:
     size_t min_new_tokens = 0;
     bool echo = false;
     size_t logprobs = 0;
-    
+
+    // Scheduling
+    size_t priority = 0;
+    size_t deadline_ms = 0;
+    size_t expected_new_tokens = 0;
+
+    // Streaming
+    size_t streamer_queue_size = 0;
+
+    // Structured output
+    std::string regex;
+    std::string json_schema;
+
     std::set<std::string> stop_strings;
     // Default setting in vLLM (and OpenAI API) is not to include stop string in the output
     bool include_stop_str_in_output = false;
@@ -104,6 +136,7 @@ public:
     size_t num_return_sequences = 1;
     size_t no_repeat_ngram_size = std::numeric_limits<size_t>::max();
     StopCriteria stop_criteria = StopCriteria::HEURISTIC;
+    bool prune_beams = false;
 
     // Multinomial
     float temperature = 1.0f;
@@ -118,6 +151,7 @@ public:
     // Assisting generation parameters
     float assistant_confidence_threshold = 0.f;
     size_t num_assistant_tokens = 0;
+    bool adaptive_num_assistant_tokens = false;
     size_t max_ngram_size = 0;
 
     // EOS special token
@@ -138,6 +172,7 @@ public:
     bool is_speculative_decoding() const;
     bool is_assisting_generation() const;
     bool is_prompt_lookup() const;
+    bool is_structured_output() const;
     void update_generation_config(const ov::AnyMap& config_map);
 
     template <typename... Properties>
@@ -150,6 +185,20 @@ public:
     void validate() const;
 };
 
+/**
+ * @brief Shapes, which warmup() of LLMPipeline and ContinuousBatchingPipeline drives through the model before serving, so that
+ * kernels are compiled and memory is allocated before the first user request.
+ *
+ * @param prompt_lengths numbers of tokens of synthetic prompts, each of them is prefilled separately.
+ * @param batch_sizes numbers of prompts generated together, each batch size is combined with each prompt length.
+ * @param max_new_tokens number of tokens generated for each prompt to run decoding steps.
+ */
+struct WarmupConfig {
+    std::vector<size_t> prompt_lengths = {16, 256};
+    std::vector<size_t> batch_sizes = {1};
+    size_t max_new_tokens = 4;
+};
+
 /*
  * utils that allow to use generate and operator() in the following way:
  * pipe.generate(input_ids, ov::genai::max_new_tokens(200), ov::genai::temperature(1.0f),...)
@@ -162,6 +211,11 @@ static constexpr ov::Property<size_t> min_new_tokens{"min_new_tokens"};
 static constexpr ov::Property<std::set<std::string>> stop_strings{"stop_strings"};
 static constexpr ov::Property<bool> include_stop_str_in_output{"include_stop_str_in_output"};
 static constexpr ov::Property<std::set<int64_t>> stop_token_ids{"stop_token_ids"};
+static constexpr ov::Property<size_t> priority{"priority"};
+static constexpr ov::Property<size_t> deadline_ms{"deadline_ms"};
+static constexpr ov::Property<size_t> expected_new_tokens{"expected_new_tokens"};
+static constexpr ov::Property<std::string> regex{"regex"};
+static constexpr ov::Property<std::string> json_schema{"json_schema"};
 
 static constexpr ov::Property<size_t> num_beam_groups{"num_beam_groups"};
 static constexpr ov::Property<size_t> num_beams{"num_beams"};
@@ -170,6 +224,7 @@ static constexpr ov::Property<float> length_penalty{"length_penalty"};
 static constexpr ov::Property<size_t> num_return_sequences{"num_return_sequences"};
 static constexpr ov::Property<size_t> no_repeat_ngram_size{"no_repeat_ngram_size"};
 static constexpr ov::Property<StopCriteria> stop_criteria{"stop_criteria"};
+static constexpr ov::Property<bool> prune_beams{"prune_beams"};
 
 static constexpr ov::Property<float> temperature{"temperature"};
 static constexpr ov::Property<float> top_p{"top_p"};
@@ -183,6 +238,7 @@ extern OPENVINO_GENAI_EXPORTS ov::Property<size_t> rng_seed;
 
 static constexpr ov::Property<float> assistant_confidence_threshold{"assistant_confidence_threshold"};
 static constexpr ov::Property<size_t> num_assistant_tokens{"num_assistant_tokens"};
+static constexpr ov::Property<bool> adaptive_num_assistant_tokens{"adaptive_num_assistant_tokens"};
 
 // Predefined Configs
 OPENVINO_GENAI_EXPORTS GenerationConfig beam_search();
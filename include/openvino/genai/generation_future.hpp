@@ -0,0 +1,66 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+namespace ov {
+namespace genai {
+
+/**
+* @brief Handle of a generation started by generate_async() of a pipeline.
+* Copies of the handle refer to the same generation. Results are kept while any copy exists.
+*/
+template <typename Results>
+class GenerationFuture {
+public:
+    GenerationFuture(std::shared_future<Results> future, std::shared_ptr<std::atomic<bool>> is_cancelled) :
+        m_future(std::move(future)), m_is_cancelled(std::move(is_cancelled)) {}
+
+    /**
+    * @brief whether results or an error of the generation are available, get() does not block then.
+    */
+    bool is_ready() const {
+        return m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /**
+    * @brief block until the generation finishes.
+    */
+    void wait() const {
+        m_future.wait();
+    }
+
+    /**
+    * @brief block until the generation finishes and return its results.
+    * Rethrows an exception thrown by the generation, including one of a generation cancelled before it started.
+    */
+    const Results& get() const {
+        return m_future.get();
+    }
+
+    /**
+    * @brief request to stop the generation.
+    * A generation, which has not started yet, is skipped. A running one stops after the next generated token,
+    * if the pipeline streams tokens for the given inputs and generation config, and runs to the end otherwise.
+    * Results of a stopped generation contain the tokens generated so far.
+    */
+    void cancel() {
+        m_is_cancelled->store(true);
+    }
+
+    bool is_cancelled() const {
+        return m_is_cancelled->load();
+    }
+
+private:
+    std::shared_future<Results> m_future;
+    std::shared_ptr<std::atomic<bool>> m_is_cancelled;
+};
+
+}  // namespace genai
+}  // namespace ov
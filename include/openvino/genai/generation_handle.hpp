@@ -4,7 +4,9 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "openvino/genai/generation_config.hpp"
 #include "openvino/genai/visibility.hpp"
@@ -18,6 +20,26 @@ enum class GenerationStatus {
     DROPPED_BY_HANDLE = 4 // Status set when generation handle is dropped
 };
 
+// Timings of a request measured by a continuous batching pipeline, durations are in milliseconds
+struct RequestTimings {
+    // from add_request() until the request is taken by a pipeline step
+    float queue_wait_ms = 0.0f;
+    // from add_request() until the first step, which scheduled the request
+    float time_to_first_schedule_ms = 0.0f;
+    // number of steps, which processed prompt tokens
+    size_t num_prefill_steps = 0;
+    // from add_request() until the first token is generated
+    float ttft_ms = 0.0f;
+    // intervals between steps generating subsequent tokens
+    std::vector<float> token_intervals_ms;
+    // number of times the request was preempted to free KV cache for other requests
+    size_t num_preemptions = 0;
+    // number of processed tokens, whose KV cache was dropped by preemptions and was computed again
+    size_t num_recomputed_tokens = 0;
+    // time from preemptions until the request returned to the progress it had made before them
+    float preemption_loss_ms = 0.0f;
+};
+
 struct EncodedGenerationResult {
     // request ID - obsolete when handle API is approved as handle will connect results with prompts.
     uint64_t m_request_id;
@@ -30,6 +52,9 @@ struct EncodedGenerationResult {
 
     // Status of generation
     GenerationStatus m_status = GenerationStatus::RUNNING;
+
+    // Timings of the request
+    RequestTimings m_timings;
 };
 
 enum class GenerationFinishReason {
@@ -50,6 +75,9 @@ struct GenerationResult {
 
     // Status of generation
     GenerationStatus m_status = GenerationStatus::RUNNING;
+
+    // Timings of the request
+    RequestTimings m_timings;
 };
 
 struct GenerationOutput {
@@ -61,6 +89,9 @@ struct GenerationOutput {
 
 using GenerationOutputs = std::unordered_map<uint64_t, GenerationOutput>;
 
+// Receives outputs of a single generation step. Called from the thread running the pipeline step.
+using OutputsCallback = std::function<void(GenerationOutputs)>;
+
 class GenerationStream;
 
 class OPENVINO_GENAI_EXPORTS GenerationHandleImpl {
@@ -82,10 +113,17 @@ public:
 
     GenerationStatus get_status();
 
+    // Timings measured so far, they are final once the generation is not running
+    RequestTimings get_timings();
+
     bool can_read();
 
     void drop();
 
+    // Delivers outputs of each subsequent step to the callback instead of buffering them for read().
+    // The callback must be lightweight, since it is called from the thread running the pipeline step
+    void set_callback(OutputsCallback callback);
+
     GenerationOutputs back();
     // Reads result of a generation for single iteration
     GenerationOutputs read();
@@ -118,6 +118,32 @@ public:
 
     AutoencoderKL& reshape(int batch_size, int height, int width);
 
+    /**
+     * Reshapes the models to ranges of image sizes, e.g. ov::Dimension(512, 1024), so that a single compiled model serves
+     * all resolutions within the ranges without recompilation, while devices can plan memory for the upper bounds.
+     * Both bounds must be divisible by the VAE scale factor.
+     */
+    AutoencoderKL& reshape(int batch_size, const ov::Dimension& height, const ov::Dimension& width);
+
+    /**
+     * Enables decoding and encoding of images by overlapping square tiles instead of whole images, which bounds
+     * memory of the VAE and lets a single compiled shape serve any resolution. Seams are hidden by linear blending
+     * of overlapping tiles. Must be called before compile(), which reshapes the models to the tile size.
+     * @param tile_size Tile size in pixels, must be divisible by the VAE scale factor
+     * @param tile_overlap Overlap of neighboring tiles in pixels, must be divisible by the VAE scale factor
+     * @param num_infer_requests Number of infer requests processing tiles in parallel
+     */
+    AutoencoderKL& enable_tiling(size_t tile_size = 512, size_t tile_overlap = 64, size_t num_infer_requests = 1);
+
+    /**
+     * Enables the cache of encoder outputs, so that encode() of an image, which is already encoded, e.g. the source
+     * image of iterative Image2Image or Inpainting edits, skips the encoder model. Images are looked up by a hash of
+     * their content and shape, the least recently used outputs are evicted. Latents are still sampled and scaled
+     * by every encode() call, so they follow its generator. Copies of the model share the cache.
+     * @param capacity Maximum byte size of cached outputs, 0 disables the cache
+     */
+    AutoencoderKL& enable_encoder_cache(size_t capacity);
+
     AutoencoderKL& compile(const std::string& device, const ov::AnyMap& properties = {});
 
     template <typename... Properties>
@@ -136,11 +162,18 @@ public:
     size_t get_vae_scale_factor() const;
 
 private:
+    struct EncoderCache;
+
     void merge_vae_image_post_processing() const;
 
     Config m_config;
     ov::InferRequest m_encoder_request, m_decoder_request;
+    // tiling is disabled if m_tile_size is 0, otherwise tiles are processed by m_tile_*_requests
+    size_t m_tile_size = 0, m_tile_overlap = 0, m_num_tile_requests = 1;
+    std::vector<ov::InferRequest> m_tile_encoder_requests, m_tile_decoder_requests;
     std::shared_ptr<ov::Model> m_encoder_model = nullptr, m_decoder_model = nullptr;
+    // the cache is disabled if m_encoder_cache is nullptr
+    std::shared_ptr<EncoderCache> m_encoder_cache = nullptr;
 };
 
 } // namespace genai
@@ -18,6 +18,8 @@
 namespace ov {
 namespace genai {
 
+class TextEncoderCache;
+
 class OPENVINO_GENAI_EXPORTS CLIPTextModelWithProjection {
 public:
     struct OPENVINO_GENAI_EXPORTS Config {
@@ -84,6 +86,12 @@ public:
 
     void set_adapters(const std::optional<AdapterConfig>& adapters);
 
+    /**
+     * Sets a number of prompts, whose outputs are cached, so that repeated prompts skip inference.
+     * @param capacity Maximum number of cached prompts, 0 disables caching
+     */
+    CLIPTextModelWithProjection& set_cache_capacity(size_t capacity);
+
     ov::Tensor infer(const std::string& pos_prompt, const std::string& neg_prompt, bool do_classifier_free_guidance);
 
     ov::Tensor get_output_tensor(const size_t idx);
@@ -93,6 +101,7 @@ private:
     AdapterController m_adapter_controller;
     ov::InferRequest m_request;
     std::shared_ptr<ov::Model> m_model;
+    std::shared_ptr<TextEncoderCache> m_cache;
 
     Tokenizer m_clip_tokenizer;
 };
@@ -6,6 +6,7 @@
 #include <string>
 #include <random>
 #include <optional>
+#include <vector>
 
 #include "openvino/runtime/tensor.hpp"
 #include "openvino/runtime/properties.hpp"
@@ -225,6 +226,20 @@ static constexpr ov::Property<std::shared_ptr<Generator>> generator{"generator"}
  */
 extern OPENVINO_GENAI_EXPORTS ov::Property<size_t> rng_seed;
 
+/**
+ * Random generators per image of a batch, their number must match 'num_images_per_prompt'. Each image is generated
+ * with its own generator as if it were generated alone, so multiple seeds share a single batched denoising loop.
+ * Generators must be distinct objects. Supported by text to image generation only.
+ * @note If `generators` are specified, they have higher priority than `rng_seeds` and `generator` parameters.
+ */
+static constexpr ov::Property<std::vector<std::shared_ptr<Generator>>> generators{"generators"};
+
+/**
+ * Seeds of 'CppStdGenerator' per image of a batch, their number must match 'num_images_per_prompt'.
+ * @note If `rng_seeds` are specified, they have higher priority than `generator` parameter.
+ */
+static constexpr ov::Property<std::vector<size_t>> rng_seeds{"rng_seeds"};
+
 /**
  * This parameters limits max sequence length for T5 encoder for SD3 and FLUX models.
  * T5 tokenizer output is padded with pad tokens to 'max_sequence_length' within a pipeline.
@@ -244,6 +259,46 @@ static constexpr ov::Property<int> max_sequence_length{"max_sequence_length"};
  */
 static constexpr ov::Property<std::function<bool(size_t, size_t, ov::Tensor&)>> callback{"callback"};
 
+/**
+ * User callback for progressive previews, which is called within a pipeline with the same arguments as 'callback', but
+ * instead of latent it receives an u8 preview image [num_images, height / vae_scale_factor, width / vae_scale_factor, 3].
+ * Previews are approximated from latents by a linear projection to RGB, so they are almost free compared to 'decode()'.
+ * Supported by Stable Diffusion, Latent Consistency Model and Stable Diffusion XL pipelines.
+ */
+static constexpr ov::Property<std::function<bool(size_t, size_t, ov::Tensor&)>> preview_callback{"preview_callback"};
+
+/**
+ * Enables masked-region crop mode of inpainting pipeline: only a bounding box of masked pixels extended by the given
+ * margin in pixels is denoised at its own resolution and then composited back into the initial image, so the cost
+ * of small edits is proportional to masked area. 'height' and 'width' are ignored in this mode and the resulting
+ * image has the size of the initial image. If the box covers the whole image, regular inpainting is performed.
+ * Not applicable to pipelines reshaped to static image size.
+ */
+static constexpr ov::Property<int> padding_mask_crop{"padding_mask_crop"};
+
+/**
+ * Quantization applied to the denoising model (UNet or transformer) when a pipeline compiles it.
+ */
+enum class DenoiserQuantization {
+    NONE,           // model is executed with the precision it was exported with
+    INT8_DYNAMIC    // activations of layers with int8 compressed weights are quantized to int8 at runtime
+                    // with scales computed per group of each inference, so they follow activation ranges of every
+                    // denoising step and no calibration is required; weights must be compressed at export
+};
+
+/**
+ * Pipeline construction and compile() property, which selects quantization of the denoising model.
+ * Other submodels are compiled with properties as passed.
+ */
+static constexpr ov::Property<DenoiserQuantization> denoiser_quantization{"denoiser_quantization"};
+
+/**
+ * Image2Image and Inpainting pipeline construction and compile() property with the maximum byte size of the cache
+ * of VAE encoder outputs, see AutoencoderKL::enable_encoder_cache(). A source image edited again with another prompt
+ * or seed is not encoded again. 0, the default, disables the cache.
+ */
+static constexpr ov::Property<size_t> vae_encoder_cache_size{"vae_encoder_cache_size"};
+
 /**
  * Function to pass 'ImageGenerationConfig' as property to 'generate()' call.
  * @param generation_config An image generation config to convert to property-like format
@@ -58,6 +58,9 @@ public:
     // with static shapes performance is better
     void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale);
 
+    // with bounded dynamic shapes a single compiled model serves all image sizes within the ranges
+    void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale);
+
     void compile(const std::string& device, const ov::AnyMap& properties = {});
 
     template <typename... Properties>
@@ -87,6 +90,11 @@ public:
 
     ov::Tensor decode(const ov::Tensor latent);
 
+    /**
+     * Returns performance metrics of the last 'generate()' call and following 'decode()' calls.
+     */
+    ImageGenerationPerfMetrics get_performance_metrics();
+
 private:
     std::shared_ptr<DiffusionPipeline> m_impl;
 
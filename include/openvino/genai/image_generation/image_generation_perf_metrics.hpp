@@ -0,0 +1,87 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "openvino/genai/perf_metrics.hpp"
+#include "openvino/genai/visibility.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * @brief Durations of stages of image generation, collected by 'generate()' and 'decode()' calls.
+ *
+ * @param text_encoder_inference_durations Durations of text encoders inferences, per text encoder
+ * ("text_encoder", "text_encoder_2", "text_encoder_3" as named in the model directory).
+ * @param denoiser_inference_durations Durations of UNet or transformer inference, per denoising step.
+ * @param scheduler_step_durations Durations of scheduler steps, per denoising step.
+ * @param iteration_durations Durations of whole denoising steps including user callbacks.
+ * @param vae_encoder_inference_durations Durations of VAE encoder inferences of initial images.
+ * @param vae_decoder_inference_durations Durations of VAE decoder inferences.
+ * @param generate_durations Durations of 'generate()' calls.
+ */
+struct OPENVINO_GENAI_EXPORTS RawImageGenerationPerfMetrics {
+    std::map<std::string, std::vector<MicroSeconds>> text_encoder_inference_durations;
+    std::vector<MicroSeconds> denoiser_inference_durations;
+    std::vector<MicroSeconds> scheduler_step_durations;
+    std::vector<MicroSeconds> iteration_durations;
+    std::vector<MicroSeconds> vae_encoder_inference_durations;
+    std::vector<MicroSeconds> vae_decoder_inference_durations;
+    std::vector<MicroSeconds> generate_durations;
+};
+
+/**
+ * @brief Performance metrics of the last generation of image generation pipelines, all durations are in milliseconds.
+ * Metrics are reset by each 'generate()' call, while 'decode()' calls add VAE decoder durations to the current metrics.
+ *
+ * @param load_time Time of pipeline construction from a model directory, 0 if the pipeline is constructed from models.
+ * @param generate_duration Total duration of 'generate()'.
+ * @param text_encoder_inference_duration Total duration of inferences of each text encoder.
+ * @param denoiser_inference_duration Mean and standard deviation of UNet or transformer inference per step.
+ * @param scheduler_step_duration Mean and standard deviation of scheduler step.
+ * @param iteration_duration Mean and standard deviation of denoising step.
+ * @param vae_encoder_inference_duration Total duration of VAE encoder inferences.
+ * @param vae_decoder_inference_duration Total duration of VAE decoder inferences.
+ */
+struct OPENVINO_GENAI_EXPORTS ImageGenerationPerfMetrics {
+    float load_time = 0.0f;
+    float generate_duration = 0.0f;
+    std::map<std::string, float> text_encoder_inference_duration;
+    MeanStdPair denoiser_inference_duration = {-1.0f, -1.0f};
+    MeanStdPair scheduler_step_duration = {-1.0f, -1.0f};
+    MeanStdPair iteration_duration = {-1.0f, -1.0f};
+    float vae_encoder_inference_duration = 0.0f;
+    float vae_decoder_inference_duration = 0.0f;
+
+    RawImageGenerationPerfMetrics raw_metrics;
+
+    float get_load_time();
+    float get_generate_duration();
+    std::map<std::string, float> get_text_encoder_inference_duration();
+    MeanStdPair get_denoiser_inference_duration();
+    MeanStdPair get_scheduler_step_duration();
+    MeanStdPair get_iteration_duration();
+    float get_vae_encoder_inference_duration();
+    float get_vae_decoder_inference_duration();
+
+    // Flag indicating if raw metrics were evaluated.
+    bool m_evaluated = false;
+
+    /**
+     * @brief Calculates mean/std and total values from raw_metrics.
+     */
+    void evaluate_statistics();
+
+    /**
+     * @brief Discards metrics of the previous generation, load time is kept.
+     */
+    void clean_up();
+};
+
+}  // namespace genai
+}  // namespace ov
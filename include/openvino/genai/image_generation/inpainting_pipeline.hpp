@@ -13,6 +13,7 @@
 
 #include "openvino/genai/image_generation/scheduler.hpp"
 #include "openvino/genai/image_generation/generation_config.hpp"
+#include "openvino/genai/image_generation/image_generation_perf_metrics.hpp"
 
 #include "openvino/genai/image_generation/clip_text_model.hpp"
 #include "openvino/genai/image_generation/clip_text_model_with_projection.hpp"
@@ -80,6 +81,9 @@ public:
     // with static shapes performance is better
     void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale);
 
+    // with bounded dynamic shapes a single compiled model serves all image sizes within the ranges
+    void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale);
+
     void compile(const std::string& device, const ov::AnyMap& properties = {});
 
     template <typename... Properties>
@@ -110,6 +114,11 @@ public:
 
     ov::Tensor decode(const ov::Tensor latent);
 
+    /**
+     * Returns performance metrics of the last 'generate()' call and following 'decode()' calls.
+     */
+    ImageGenerationPerfMetrics get_performance_metrics();
+
 private:
     std::shared_ptr<DiffusionPipeline> m_impl;
 
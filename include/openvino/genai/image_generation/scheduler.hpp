@@ -20,7 +20,10 @@ public:
         EULER_DISCRETE,
         FLOW_MATCH_EULER_DISCRETE,
         PNDM,
-        EULER_ANCESTRAL_DISCRETE
+        EULER_ANCESTRAL_DISCRETE,
+        DPM_SOLVER_MULTISTEP,
+        UNIPC_MULTISTEP,
+        FLOW_MATCH_HEUN_DISCRETE
     };
 
     static std::shared_ptr<Scheduler> from_config(const std::filesystem::path& scheduler_config_path,
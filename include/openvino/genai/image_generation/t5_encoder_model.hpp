@@ -18,6 +18,8 @@
 namespace ov {
 namespace genai {
 
+class TextEncoderCache;
+
 class OPENVINO_GENAI_EXPORTS T5EncoderModel {
 public:
     explicit T5EncoderModel(const std::filesystem::path& root_dir);
@@ -65,6 +67,12 @@ public:
         return compile(device, ov::AnyMap{std::forward<Properties>(properties)...});
     }
 
+    /**
+     * Sets a number of prompts, whose outputs are cached, so that repeated prompts skip inference.
+     * @param capacity Maximum number of cached prompts, 0 disables caching
+     */
+    T5EncoderModel& set_cache_capacity(size_t capacity);
+
     ov::Tensor infer(const std::string& pos_prompt,
                      const std::string& neg_prompt,
                      bool do_classifier_free_guidance,
@@ -76,6 +84,7 @@ private:
     AdapterController m_adapter_controller;
     ov::InferRequest m_request;
     std::shared_ptr<ov::Model> m_model;
+    std::shared_ptr<TextEncoderCache> m_cache;
 
     Tokenizer m_tokenizer;
 };
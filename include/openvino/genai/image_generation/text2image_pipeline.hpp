@@ -184,6 +184,17 @@ public:
      */
     void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale);
 
+    /**
+     * Reshapes pipeline to ranges of image sizes, e.g. ov::Dimension(512, 1024), instead of a single size. Models are compiled once
+     * with bounded dynamic shapes and then serve any resolution within the ranges without recompilation, while devices can plan
+     * memory for the upper bounds. Supported by Stable Diffusion and Stable Diffusion XL pipelines.
+     * @param num_images_per_prompt A number of image to generate per 'generate()' call
+     * @param height A range of heights of resulting images, both bounds must be divisible by VAE scale factor
+     * @param width A range of widths of resulting images, both bounds must be divisible by VAE scale factor
+     * @param guidance_scale A guidance scale, see reshape() above
+     */
+    void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale);
+
     /**
      * Compiles image generation pipeline for a given device
      * @param device A device to compile models with
@@ -214,6 +225,37 @@ public:
         return generate(positive_prompt, ov::AnyMap{std::forward<Properties>(properties)...});
     }
 
+    /**
+     * Generates images for a batch of prompts, which share a single denoising loop and are passed to the denoising
+     * model as one batch. Prompts share image generation parameters, e.g. resolution and number of inference steps.
+     * @param positive_prompts Prompts to generate images from
+     * @param properties Image generation parameters specified as properties. Values in 'properties' override default value for generation parameters.
+     * @returns A tensor which has dimensions [positive_prompts.size() * num_images_per_prompt, height, width, 3],
+     * images of each prompt are contiguous
+     * @note Supported by Stable Diffusion and Latent Consistency Model pipelines only
+     */
+    ov::Tensor generate(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties = {});
+
+    /**
+     * Generates images for prompts one after another. VAE decoding of each prompt runs concurrently with denoising
+     * of the next one, so that the denoising model doesn't idle while images are decoded.
+     * @param positive_prompts Prompts to generate images from
+     * @param properties Image generation parameters specified as properties, shared by all prompts
+     * @returns Tensors with dimensions [num_images_per_prompt, height, width, 3], one per prompt
+     * @note Decoding is overlapped for Stable Diffusion, Latent Consistency Model and Stable Diffusion XL pipelines,
+     * other pipelines generate images sequentially. Callbacks must not call 'decode()', which may run concurrently
+     */
+    std::vector<ov::Tensor> generate_pipelined(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties = {});
+
+    /**
+     * Prepares the pipeline to serve requests without delays of the first ones: generates an image with a single inference step,
+     * so that text encoders, the denoising model and VAE decoder are compiled and their memory is allocated for the resolution
+     * and the number of images of the properties. The image is discarded.
+     * @param properties Image generation parameters of requests to be served, e.g. width and height. num_inference_steps
+     * is 1, unless it is set explicitly
+     */
+    void warmup(const ov::AnyMap& properties = {});
+
     /**
      * Performs latent image decoding. It can be useful to use within 'callback' which accepts current latent image
      * @param latent A latent image
@@ -221,6 +263,11 @@ public:
      */
     ov::Tensor decode(const ov::Tensor latent);
 
+    /**
+     * Returns performance metrics of the last 'generate()' call and following 'decode()' calls.
+     */
+    ImageGenerationPerfMetrics get_performance_metrics();
+
 private:
     std::shared_ptr<DiffusionPipeline> m_impl;
 
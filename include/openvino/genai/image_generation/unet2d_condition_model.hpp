@@ -76,6 +76,42 @@ public:
 
     UNet2DConditionModel& reshape(int batch_size, int height, int width, int tokenizer_model_max_length);
 
+    /**
+     * Reshapes the model to ranges of image sizes, e.g. ov::Dimension(512, 1024), so that a single compiled model serves
+     * all resolutions within the ranges without recompilation. Not applicable to NPU, which requires static shapes.
+     */
+    UNet2DConditionModel& reshape(int batch_size, const ov::Dimension& height, const ov::Dimension& width, int tokenizer_model_max_length);
+
+    /**
+     * Folds classifier-free guidance into the model graph. The compiled model then takes a single copy of
+     * samples, duplicates them on device, and outputs the guided noise prediction, scaled by an extra
+     * 'guidance_scale' input. Halves host / device traffic of samples and noise predictions per step.
+     * Must be called before compile().
+     */
+    UNet2DConditionModel& enable_fused_guidance();
+
+    bool has_fused_guidance() const {
+        return m_fused_guidance;
+    }
+
+    /**
+     * Enables DeepCache, which runs the full model every 'cache_interval' denoising steps and a shallow model in between,
+     * which reuses high-level features cached by the full model. Requires a split export, where the full model exposes
+     * 'cached_features' output and 'openvino_model_shallow.xml' model takes them as input. Must be called before compile().
+     * @param cache_interval A number of denoising steps, which reuse features of a single full model inference
+     */
+    UNet2DConditionModel& enable_deep_cache(size_t cache_interval = 3);
+
+    /**
+     * Enables token merging of self-attentions at the highest resolution of UNet, where attention over latent tokens
+     * dominates inference time of high resolution images. Keys and values are merged by averaging 'merge_factor' x
+     * 'merge_factor' windows of latent tokens, while queries keep all tokens, so attention cost is reduced by
+     * 'merge_factor' squared times and outputs need no unmerging. Requires a model exported with ScaledDotProductAttention
+     * operations. Must be called before compile().
+     * @param merge_factor A size of a window of latent tokens merged into a single key / value token
+     */
+    UNet2DConditionModel& enable_token_merging(size_t merge_factor = 2);
+
     UNet2DConditionModel& compile(const std::string& device, const ov::AnyMap& properties = {});
 
     template <typename... Properties>
@@ -103,9 +139,16 @@ private:
     AdapterController m_adapter_controller;
     std::shared_ptr<ov::Model> m_model;
     size_t m_vae_scale_factor;
+    bool m_fused_guidance = false;
+    // split export for DeepCache, which is enabled if m_deep_cache_interval is non-zero
+    std::shared_ptr<ov::Model> m_shallow_model;
+    size_t m_deep_cache_interval = 0;
+    // window size of token merging, which is disabled if zero
+    size_t m_token_merging_factor = 0;
 
     class UNetInferenceDynamic;
     class UNetInferenceStaticBS1;
+    class UNetInferenceDeepCache;
 };
 
 } // namespace genai
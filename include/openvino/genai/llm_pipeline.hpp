@@ -10,6 +10,7 @@
 
 #include "openvino/core/any.hpp"
 #include "openvino/genai/generation_config.hpp"
+#include "openvino/genai/generation_future.hpp"
 #include "openvino/genai/tokenizer.hpp"
 #include "openvino/genai/streamer_base.hpp"
 #include "openvino/genai/perf_metrics.hpp"
@@ -92,6 +93,32 @@ public:
 
 class LLMPipelineImplBase;
 
+/**
+* @brief Chat saved by LLMPipeline::save_chat(): KV cache of the conversation copied to host memory together with its history,
+* so that the chat can be continued later by LLMPipeline::start_chat(const ChatSnapshot&), possibly after other chats were run
+* by the same pipeline. Copies of a snapshot share its data.
+*/
+class OPENVINO_GENAI_EXPORTS ChatSnapshot {
+public:
+    struct State;
+
+    ChatSnapshot() = default;
+    explicit ChatSnapshot(std::shared_ptr<const State> state);
+
+    // @brief Whether the snapshot holds a chat.
+    bool empty() const;
+
+    // @brief Number of bytes of host memory occupied by the KV cache of the snapshot.
+    size_t get_byte_size() const;
+
+    const std::shared_ptr<const State>& get_state() const {
+        return m_state;
+    }
+
+private:
+    std::shared_ptr<const State> m_state;
+};
+
 /**
 * @brief This class is used for generation with LLMs.
  */
@@ -271,11 +298,59 @@ public:
     */
     void start_chat(const std::string& system_message = {});
 
+    /**
+    * @brief continue a chat saved by save_chat().
+    * Replaces the current chat, if any, by the saved one, its KV cache is restored instead of being computed again.
+    * Supported by the stateful pipeline only.
+    *
+    * @param snapshot chat saved by save_chat() of a pipeline with the same model.
+    */
+    void start_chat(const ChatSnapshot& snapshot);
+
+    /**
+    * @brief save the current chat to host memory.
+    * The chat continues afterwards, call finish_chat() to release the pipeline for other chats.
+    * Supported by the stateful pipeline only.
+    *
+    * @param compress_kv_cache whether f32 KV cache is stored in f16 to halve the size of the snapshot, which makes
+    * the restored chat slightly differ from the original one.
+    * @return snapshot of the chat.
+    */
+    ChatSnapshot save_chat(bool compress_kv_cache = false);
+
     /**
     * @brief finish chat and clear kv cache.
     * Turns off keeping KV cache between generate calls.
     */
     void finish_chat();
+
+    /**
+    * @brief prepare the pipeline to serve requests without delays of the first ones.
+    * Tokenizes and detokenizes a text and generates synthetic prompts of the configured shapes with the current generation config,
+    * so that kernels are compiled and memory is allocated for these shapes. Results are discarded. Cannot be called during a chat.
+    * @param config prompt lengths, batch sizes and number of generated tokens.
+    */
+    void warmup(const WarmupConfig& config = {});
+
+    /**
+    * @brief start generation in background and return without waiting for it.
+    * Generations run on threads of the pipeline in the order of calls, one at a time by default, while the stateful pipeline
+    * runs up to ov::genai::max_concurrent_generations of them concurrently. Generations are independent of each other
+    * and of chat. Other methods of the pipeline must not be called until started generations finish.
+    * Destruction of the pipeline waits for running generations, queued ones fail with std::future_error.
+    *
+    * @param inputs input prompt or a vector of prompts
+    * @param generation_config optional GenerationConfig, the current default config if not set
+    * @param streamer optional streamer, called from a thread of the pipeline
+    * @param on_completion optional callback, called from a thread of the pipeline once results or an error are available
+    * @return handle to wait for, get or cancel the generation
+    */
+    GenerationFuture<DecodedResults> generate_async(
+        StringInputs inputs,
+        OptionalGenerationConfig generation_config = std::nullopt,
+        StreamerVariant streamer = std::monostate(),
+        std::function<void(GenerationFuture<DecodedResults>)> on_completion = {}
+    );
 private:
     std::unique_ptr<LLMPipelineImplBase> m_pimpl;
 };
@@ -320,6 +395,14 @@ inline std::pair<std::string, Any> draft_model(
 */
 static constexpr ov::Property<SchedulerConfig> scheduler_config{"scheduler_config"};
 
+/**
+* @brief expected_concurrency property serves to select the pipeline backend automatically instead of tuning it per model and device.
+* If more than one concurrent request is expected, continuous batching pipeline is created with SchedulerConfig chosen from
+* the device, the size of model weights and the number of requests: max_num_seqs, max_num_batched_tokens and cache_size.
+* Otherwise, the stateful pipeline is created. Ignored if scheduler_config is set explicitly or the device is NPU.
+*/
+static constexpr ov::Property<size_t> expected_concurrency{"expected_concurrency"};
+
 /**
 * @brief enable prompt_lookup property serves to activate prompt lookup decoding.
 * Set `true` to activate this mode.
@@ -327,5 +410,102 @@ static constexpr ov::Property<SchedulerConfig> scheduler_config{"scheduler_confi
 */
 static constexpr ov::Property<bool> prompt_lookup{"prompt_lookup"};
 
+/**
+* @brief data_parallel_devices property serves to run ContinuousBatchingPipeline on several devices at once.
+* Each listed device (the same device can be listed several times) runs its own replica of the model with its own KV cache,
+* while new requests are routed to the replicas by their load and prefix cache contents.
+* The device passed to the pipeline constructor is ignored in this case.
+*/
+static constexpr ov::Property<std::vector<std::string>> data_parallel_devices{"data_parallel_devices"};
+
+/**
+* @brief pipeline_parallel_devices property serves to run ContinuousBatchingPipeline with a model, which does not fit a single device.
+* Consecutive decoder layers are split between the listed GPUs according to their memory, each layer keeps its KV cache on its device.
+* Set SchedulerConfig::num_inference_streams to the number of devices, so that a step is split into micro-batches, which are inferred
+* by different devices at the same time. The device passed to the pipeline constructor is ignored in this case.
+*/
+static constexpr ov::Property<std::vector<std::string>> pipeline_parallel_devices{"pipeline_parallel_devices"};
+
+/**
+* @brief prefill_scheduler_config property serves to disaggregate prefill and decode phases of ContinuousBatchingPipeline.
+* Prompts of new requests are processed by a separate prefill instance of the model with its own KV cache configured by this property,
+* then KV cache blocks of the prompts are transferred to the decode instance configured by the pipeline SchedulerConfig, which
+* generates all tokens, so that long prompts do not delay generation of running requests. Both configs must enable prefix caching,
+* while both devices must have the same KV cache layout.
+*/
+static constexpr ov::Property<SchedulerConfig> prefill_scheduler_config{"prefill_scheduler_config"};
+
+/**
+* @brief prefill_device property sets the device of the prefill instance, see prefill_scheduler_config.
+* The device passed to the pipeline constructor is used by default.
+*/
+static constexpr ov::Property<std::string> prefill_device{"prefill_device"};
+
+/**
+* @brief self_speculative_num_layers property serves to activate speculative decoding without a separate draft model.
+* Candidates are drafted by the given number of first decoder layers of the main model followed by its final norm and LM head,
+* so that no draft checkpoint is needed. The draft keeps a separate KV cache of only these layers, which is not shared with the main model,
+* so it takes num_layers / (number of decoder layers) of the main KV cache size. Mutually exclusive with draft_model and prompt_lookup.
+*/
+static constexpr ov::Property<size_t> self_speculative_num_layers{"self_speculative_num_layers"};
+
+/**
+* @brief medusa_heads property serves to activate speculative decoding with Medusa heads, which predict candidates from hidden states
+* of the main model in the same forward pass, so that no draft model is inferred. The value is a path to OpenVINO IR of the heads
+* with a single input of hidden states of shape [..., hidden_size] and a single output of logits of shape [..., num_heads, vocab_size].
+* Each step validates up to num_heads candidates or GenerationConfig::num_assistant_tokens, if it is set.
+* Mutually exclusive with draft_model, prompt_lookup and self_speculative_num_layers.
+*/
+static constexpr ov::Property<std::string> medusa_heads{"medusa_heads"};
+
+/**
+* @brief incremental_chat property serves to speed up long chats of the stateful pipeline.
+* Set `true` so that each turn tokenizes only its part of the templated history, which is appended to KV cache as is,
+* instead of tokenizing the whole history twice to find tokens to be trimmed from KV cache. The whole history is still
+* tokenized, if the chat template changes already templated turns or beam search answer has to replace the generated one.
+*/
+static constexpr ov::Property<bool> incremental_chat{"incremental_chat"};
+
+/**
+* @brief prefill_chunk_size property serves to bound peak memory of the stateful pipeline on long prompts.
+* Prompts longer than the given number of tokens are inferred by chunks of this size, which append to KV cache one by one,
+* so that activations of the prompt phase are proportional to the chunk size instead of the prompt length. 0 (default) disables chunking.
+*/
+static constexpr ov::Property<size_t> prefill_chunk_size{"prefill_chunk_size"};
+
+/**
+* @brief prefix_state_cache_size property serves to reuse KV cache of the stateful pipeline between generate calls outside of chat,
+* e.g. for prompts sharing a long system prompt. KV cache states of the given number of the most recent prompts are kept
+* in host memory, and a new prompt restores the state of its longest cached prefix, so that only the rest of the prompt is inferred.
+* Applies to a single prompt without beam search and LoRA adapters. 0 (default) disables caching.
+*/
+static constexpr ov::Property<size_t> prefix_state_cache_size{"prefix_state_cache_size"};
+
+/**
+* @brief max_concurrent_generations property sets how many LLMPipeline::generate_async() calls of the stateful pipeline run
+* concurrently. Each concurrent generation uses its own infer request of the compiled model, so its own KV cache, which is
+* created on first use. Not supported with LoRA adapters. 1 (default) runs async generations one by one.
+* If greater than 1, generate() may be called from several threads outside of chat as well: calls share the same infer requests
+* with async generations and wait for a free one, if all of them are busy.
+*/
+static constexpr ov::Property<size_t> max_concurrent_generations{"max_concurrent_generations"};
+
+/**
+* @brief share_compiled_model property serves to run several pipelines of the same model with a single copy of weights.
+* Set `true` so that a pipeline reuses the model compiled by another living pipeline with the same model, device and properties,
+* e.g. pipelines with different generation configs, or the main model of speculative decoding and a continuous batching LLMPipeline.
+* Each pipeline keeps its own infer requests and KV cache. Applies to the stateful pipeline without LoRA adapters and
+* to continuous batching pipelines. Properties of non-printable types disable sharing.
+*/
+static constexpr ov::Property<bool> share_compiled_model{"share_compiled_model"};
+
+/**
+* @brief fast_startup property serves to shorten construction of LLMPipeline and ContinuousBatchingPipeline from a directory.
+* Set `true` so that the tokenizer is loaded in background (see ov::genai::deferred_load), while the LLM is compiled, and,
+* unless ov::cache_dir is set, compiled models are cached in `openvino_model_cache` directory next to the models: a warm cache
+* left by a previous start is imported instead of compiling models, a cold one is created and filled, if the directory is writable.
+*/
+static constexpr ov::Property<bool> fast_startup{"fast_startup"};
+
 }  // namespace genai
 }  // namespace ov
@@ -50,7 +50,9 @@ struct OPENVINO_GENAI_EXPORTS AdapterConfig {
         MODE_DYNAMIC,       // A, B, alpha are fully variable
         MODE_STATIC_RANK,   // A and B have static shape, alpha is variable // FIXME: WA to unlock experiments, gives a unique perf level
         MODE_STATIC,        // A, B and alpha are constants
-        MODE_FUSE           // A, B and alpha are constants, fused to main matrix W
+        MODE_FUSE,          // A, B and alpha are constants, fused to main matrix W
+        MODE_HOT_SWAP       // A and B of all adapters passed at initialization are kept as variables, switching between them changes alpha only,
+                            // alpha may differ per batch row, so that rows with different adapters share a single inference
     };
 
     Mode get_mode() const { return mode; }
@@ -66,6 +68,19 @@ struct OPENVINO_GENAI_EXPORTS AdapterConfig {
     const std::optional<std::string>& get_tensor_name_prefix() const { return tensor_name_prefix; }
     void set_tensor_name_prefix(const std::optional<std::string>& _tensor_name_prefix) { tensor_name_prefix = _tensor_name_prefix; }
 
+    // Methods to get and set quantization of LoRA A and B tensors to int8 with a scale per group of 64 elements, when they are loaded
+    // to the model state in MODE_DYNAMIC, MODE_STATIC_RANK and MODE_HOT_SWAP. Quantized adapters take 2-4x less device memory and
+    // bandwidth, while decompression is a part of LoRA subgraph. The value is used when the model is adapted at the initialization
+    // and ignored later and in other modes. The default value is false.
+    bool get_weights_quantization() const { return weights_quantization; }
+    void set_weights_quantization(bool _weights_quantization) { weights_quantization = _weights_quantization; }
+
+    // Methods to get and set whether layers fused in MODE_FUSE keep references to their original weights and fused LoRA tensors, which
+    // AdapterController::update_fused_weights requires to fuse other configs later. Kept original weights are not released after fusion.
+    // The value is used when the model is adapted at the initialization and ignored later and in other modes. The default value is false.
+    bool get_fused_weights_update() const { return fused_weights_update; }
+    void set_fused_weights_update(bool _fused_weights_update) { fused_weights_update = _fused_weights_update; }
+
     AdapterConfig (Mode mode = MODE_AUTO);
 
     AdapterConfig (const Adapter& adapter, float alpha, Mode mode = MODE_AUTO) : AdapterConfig(std::vector<std::pair<Adapter, float>>{{adapter, alpha}}, mode) {}
@@ -103,6 +118,8 @@ private:
     std::vector<Adapter> adapters;
     std::vector<float> alphas;
     std::optional<std::string> tensor_name_prefix;
+    bool weights_quantization = false;
+    bool fused_weights_update = false;
 
 };
 
@@ -190,6 +207,18 @@ public:
     // Apply adapters configured in the current config set last time, or set and use new config given as optional `config` argument
     void apply(ov::InferRequest& request, const std::optional<AdapterConfig>& config = std::nullopt);
 
+    // Apply adapters separately to groups of consecutive rows of the batch in a single inference, where each group is given
+    // by its config and a number of rows, std::nullopt config disables adapters for its rows. Requires AdapterConfig::MODE_HOT_SWAP,
+    // configs may select only adapters passed at the initialization.
+    void apply_to_row_groups(ov::InferRequest& request, const std::vector<std::pair<std::optional<AdapterConfig>, size_t>>& row_configs);
+
+    // Fuse a new config to weights of the model passed at the initialization in AdapterConfig::MODE_FUSE, instead of reading and transforming
+    // the model again. Weights of layers where adapters or alphas changed are recomputed from the original weights in place, other layers
+    // are kept. Only layers adapted at the initialization can be updated, so all adapters which may be used later should be passed there,
+    // possibly with zero alpha, and AdapterConfig::set_fused_weights_update(true) must be set there. The model must be compiled again
+    // to run with updated weights.
+    void update_fused_weights(const AdapterConfig& config);
+
     // Returns true if a given name is one of the state names created by this adapter controller for dynamic LoRA
     // Helps to distinguish LoRA states from other states (e.g. KV cache state) in the model for a partial state reset.
     bool has_state_name(const std::string& name);
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include "openvino/genai/visibility.hpp"
 #include <vector>
 #include <memory>
@@ -15,6 +16,54 @@ namespace genai {
 using TimePoint = std::chrono::steady_clock::time_point;
 using MicroSeconds = std::chrono::duration<float, std::ratio<1, 1000000>>;
 
+/**
+* @brief Structure to store mean and standard deviation values.
+*/
+struct OPENVINO_GENAI_EXPORTS MeanStdPair {
+    float mean;
+    float std;
+};
+
+/**
+* @brief Structure to store percentiles of durations in milliseconds.
+*/
+struct OPENVINO_GENAI_EXPORTS DurationPercentiles {
+    float p50 = -1.0f;
+    float p90 = -1.0f;
+    float p99 = -1.0f;
+};
+
+/**
+* @brief Constant memory statistics of durations: count, mean and variance updated online, and a histogram with
+* logarithmic buckets, which estimates percentiles with relative error below 1%.
+* The histogram is allocated by the first added duration.
+*/
+class OPENVINO_GENAI_EXPORTS DurationStatistics {
+public:
+    void add(MicroSeconds duration);
+    void add(const std::vector<MicroSeconds>& durations);
+    void merge(const DurationStatistics& other);
+
+    size_t get_count() const {
+        return m_count;
+    }
+
+    // Mean and standard deviation in milliseconds, {-1, -1} if there are no durations.
+    MeanStdPair get_mean_std() const;
+
+    // Percentile in milliseconds for percentile in [0, 100] range, -1 if there are no durations.
+    float get_percentile(float percentile) const;
+
+    DurationPercentiles get_percentiles() const;
+
+private:
+    size_t m_count = 0;
+    // in microseconds
+    double m_mean = 0.0, m_m2 = 0.0;
+    float m_min = 0.0f, m_max = 0.0f;
+    std::vector<uint64_t> m_buckets;
+};
+
 /**
  * @brief Structure with raw performance metrics for each generation before any statistics are calculated.
  *
@@ -27,6 +76,8 @@ using MicroSeconds = std::chrono::duration<float, std::ratio<1, 1000000>>;
  * @param m_batch_sizes Batch sizes for each generate call.
  * @param m_durations Total durations for each generate call in microseconds.
  * @param m_inference_durations Total inference duration for each generate call in microseconds.
+ * @param folded_* Statistics of durations, which were moved out of the corresponding vectors by
+ *        PerfMetrics::fold_raw_metrics(); evaluated statistics cover both.
  */
 struct OPENVINO_GENAI_EXPORTS RawPerfMetrics {
     std::vector<MicroSeconds> generate_durations;
@@ -39,14 +90,15 @@ struct OPENVINO_GENAI_EXPORTS RawPerfMetrics {
     std::vector<size_t> m_batch_sizes;
     std::vector<MicroSeconds> m_durations;
     std::vector<MicroSeconds> m_inference_durations;
-};
 
-/**
-* @brief Structure to store mean and standard deviation values.
-*/
-struct OPENVINO_GENAI_EXPORTS MeanStdPair {
-    float mean;
-    float std;
+    // Durations moved out of the vectors above by PerfMetrics::fold_raw_metrics().
+    DurationStatistics folded_generate_durations;
+    DurationStatistics folded_tokenization_durations;
+    DurationStatistics folded_detokenization_durations;
+    DurationStatistics m_folded_times_to_first_token;
+    DurationStatistics m_folded_durations;
+    DurationStatistics m_folded_token_infer_durations;
+    DurationStatistics m_folded_inference_durations;
 };
 
 /**
@@ -76,6 +128,9 @@ struct OPENVINO_GENAI_EXPORTS MeanStdPair {
  * @param get_generate_duration Returns the mean and standard deviation of generate duration.
  * @param get_tokenization_duration Returns the mean and standard deviation of tokenization duration.
  * @param get_detokenization_duration Returns the mean and standard deviation of detokenization duration.
+ * @param get_ttft_percentiles Returns p50, p90 and p99 of TTFT.
+ * @param get_tpot_percentiles Returns p50, p90 and p99 of TPOT.
+ * @param get_ipot_percentiles Returns p50, p90 and p99 of IPOT.
  * @param get_microsec Converts a duration to microseconds.
  * @param m_evaluated Flag indicating if raw metrics were evaluated.
  *        If false, current mean/std TTFT, TPOT, etc. are not actual and evaluate_statistics() should recalculate them.
@@ -83,6 +138,9 @@ struct OPENVINO_GENAI_EXPORTS MeanStdPair {
  *        Optional start_time can be provided to update durations.
  * @param operator+ Adds two PerfMetrics objects.
  * @param operator+= Adds and assigns the right-hand PerfMetrics to the current object.
+ * @param streaming_statistics If true, the result of operator+ keeps raw durations in constant memory statistics only,
+ *        so that metrics accumulated over a long session don't grow. Set it on the accumulating object.
+ * @param fold_raw_metrics Moves raw durations of already evaluated metrics to constant memory statistics.
  * @param raw_metrics A structure of RawPerfMetrics type that holds raw metrics.
  * @param load_time Load time in milliseconds.
  *
@@ -108,6 +166,10 @@ struct OPENVINO_GENAI_EXPORTS PerfMetrics {
     MeanStdPair tokenization_duration = {-1.0f, -1.0f};
     MeanStdPair detokenization_duration = {-1.0f, -1.0f};
 
+    DurationPercentiles ttft_percentiles;
+    DurationPercentiles tpot_percentiles;
+    DurationPercentiles ipot_percentiles;
+
     size_t num_generated_tokens;
     size_t num_input_tokens;
 
@@ -124,6 +186,10 @@ struct OPENVINO_GENAI_EXPORTS PerfMetrics {
     MeanStdPair get_tokenization_duration();    // in ms
     MeanStdPair get_detokenization_duration();  // in ms
 
+    DurationPercentiles get_ttft_percentiles();  // in ms
+    DurationPercentiles get_tpot_percentiles();  // in ms
+    DurationPercentiles get_ipot_percentiles();  // in ms
+
     // Flag indicating if raw metrics were evaluated.
     // If false means current mean/std ttft, tpot, etc. are not actual
     // and evaluate_statistics() should recalculate them.
@@ -145,6 +211,14 @@ struct OPENVINO_GENAI_EXPORTS PerfMetrics {
     PerfMetrics operator+(const PerfMetrics& metrics) const;
     PerfMetrics& operator+=(const PerfMetrics& right);
 
+    bool streaming_statistics = false;
+
+    /**
+     * @brief moves raw durations to constant memory statistics. Token times, which are needed to evaluate
+     * statistics with start_time, are dropped, so metrics must be evaluated before.
+     */
+    void fold_raw_metrics();
+
     RawPerfMetrics raw_metrics;
 };
 
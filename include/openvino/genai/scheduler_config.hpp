@@ -4,9 +4,49 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
+#include "openvino/core/type/element_type.hpp"
 #include "cache_eviction.hpp"
 
 namespace ov::genai {
+
+/**
+ * @brief Defines the order in which the continuous batching scheduler admits sequence groups and selects
+ * victims for preemption. Groups which are first in the order are scheduled first and preempted last.
+ */
+enum class SchedulingPolicy {
+    FCFS,                       // first come, first served - arrival order of requests
+    PRIORITY,                   // greater GenerationConfig::priority first, arrival order within the same priority
+    EARLIEST_DEADLINE_FIRST     // earliest GenerationConfig::deadline_ms first, requests without deadline go last
+};
+
+/**
+ * @brief Defines what happens with KV cache of a sequence group preempted by the scheduler due to lack of free KV cache blocks.
+ */
+enum class PreemptionMode {
+    RECOMPUTE,  // KV cache blocks are released and the whole context is recomputed when the group is scheduled again
+    SWAP        // KV cache blocks are copied to a host memory pool and copied back when the group is scheduled again
+};
+
+/**
+ * @brief Defines how ContinuousBatchingPipeline::add_request treats new requests once the pipeline is overloaded,
+ * i.e. too many requests wait to be picked up by the next step or KV cache usage is too high.
+ */
+enum class AdmissionControlMode {
+    DISABLED,   // requests are always accepted
+    REJECT,     // add_request throws an exception for requests arriving while the pipeline is overloaded
+    BACKPRESSURE // add_request blocks until the pipeline is not overloaded; must not be used with generate() from the same thread
+};
+
+/**
+ * @brief Defines how many tokens a new request is predicted to generate, when the scheduler reserves KV cache blocks for it on admission.
+ */
+enum class OutputLengthEstimate {
+    NONE,               // only the prompt is accounted, unless GenerationConfig::expected_new_tokens is set
+    MAX_NEW_TOKENS,     // GenerationConfig::max_new_tokens (or the rest of max_length), which never underestimates
+    HISTORICAL_AVERAGE  // average number of tokens generated by finished requests; max_new_tokens until the first request finishes
+};
+
 struct SchedulerConfig {
     // a maximum number of tokens to batch
     // (in contrast to max_batch_size which combines independent sequences, we consider total amount of tokens in a batch)
@@ -17,11 +57,34 @@ struct SchedulerConfig {
     std::size_t num_kv_blocks = 0;
 
     // total size of KV cache in GB
+    // if neither num_kv_blocks nor cache_size is set, KV cache takes memory, which is free after compilation of the model:
+    // device memory on GPU and host memory on CPU, except the headroom left to activations (see cache_memory_headroom)
     std::size_t cache_size = 0;
 
+    // number of tokens in a KV cache block, 0 means the default of the device: 32 on CPU and 16 on GPU
+    // CPU accepts powers of 2 from 16 to 256: larger blocks make attention kernels process longer contiguous runs of keys,
+    // while smaller ones waste less memory in partially filled last blocks and match prompts in prefix cache at a finer granularity
+    // GPU paged attention kernels support block size 16 only
+    std::size_t block_size = 0;
+
+    // share of free memory, which is not given to automatically sized KV cache (see cache_size), in addition to logits of
+    // max_num_batched_tokens tokens; it is left to activations and other allocations made during inference
+    float cache_memory_headroom = 0.1f;
+
     // whether to split prompt / generate to different scheduling phases
     bool dynamic_split_fuse = true;
 
+    // maximum number of prompt tokens scheduled per step in dynamic split fuse mode, the rest of
+    // max_num_batched_tokens is left to generation phase; 0 means that prompts can take all tokens left after generation phase
+    std::size_t max_num_prefill_tokens = 0;
+
+    // maximum number of prompt tokens of a single sequence group scheduled per step in dynamic split fuse mode, 0 means no limit
+    std::size_t max_prefill_chunk_size = 0;
+
+    // if non-zero, the number of prompt tokens scheduled per step in dynamic split fuse mode is adjusted after each step,
+    // so that the step latency stays close to this value; max_num_prefill_tokens (if set) is used as the upper limit
+    float target_step_latency_ms = 0.0f;
+
 
     /**
      * Whether to use cache eviction for all sequences processed by this pipeline. When cache eviction is enabled,
@@ -36,6 +99,16 @@ struct SchedulerConfig {
      */
     CacheEvictionConfig cache_eviction_config;
 
+    // if non-zero, KV cache blocks of a sequence holding only tokens older than this many most recent tokens are freed after each step,
+    // so that memory per sequence is bounded by the window instead of the sequence length; intended for models with sliding window attention
+    // and for StreamingLLM-like generation with attention sinks. The window is rounded up to a whole number of KV cache blocks.
+    // Cannot be used together with prefix caching or cache eviction.
+    std::size_t attention_window_size = 0;
+
+    // number of first tokens of a sequence (attention sinks), which are kept in KV cache when attention_window_size is set
+    // rounded up to a whole number of KV cache blocks, 0 means that only the window is kept
+    std::size_t num_attention_sink_tokens = 0;
+
     //
     // vLLM-like settings
     //
@@ -51,11 +124,145 @@ struct SchedulerConfig {
     // when a sequence has finished genegartion its cache is released.
     bool enable_prefix_caching = false;
 
+    // Directory to store prefix cached KV blocks in, so that they can be reused after the pipeline is recreated.
+    // Blocks are saved when the pipeline is destroyed and loaded lazily once a prompt of a new request matches to them.
+    // Empty string disables the persistent storage. Used only if enable_prefix_caching is true.
+    std::string prefix_cache_dir = "";
+
+    // Whether a request, whose prompt is identical to the prompt of a request being prefilled, waits for that prefill to
+    // complete and then reuses its KV cache blocks, instead of prefilling the same prompt concurrently. Used only if
+    // enable_prefix_caching is true. Not supported by speculative decoding.
+    bool coalesce_identical_prompts = false;
+
+    // Whether sequences forked from the same parent (num_return_sequences > 1, beam search) keep sharing the partially filled last
+    // KV cache block as long as their generated tokens are identical, instead of copying the block right at the next step.
+    // Has effect only if enable_prefix_caching is false, since prefix caching deduplicates such copies by block hashes.
+    bool enable_lazy_copy_on_write = false;
+
+    // policy controlling both admission order of requests and preemption victims selection
+    SchedulingPolicy scheduling_policy = SchedulingPolicy::FCFS;
+
+    // how KV cache of preempted sequence groups is handled
+    // SWAP mode has effect only for sequence groups in generation phase and only when prefix caching is disabled,
+    // in other cases preempted sequence groups are recomputed
+    PreemptionMode preemption_mode = PreemptionMode::RECOMPUTE;
+
+    // total number of KV blocks in host memory available to store swapped out blocks, used in SWAP preemption mode
+    std::size_t num_swap_blocks = 0;
+
+    // total size of host memory in GB used to store swapped out KV blocks, used in SWAP preemption mode
+    std::size_t swap_space = 0;
+
+    // number of steps whose outputs are buffered per request in a lock-free ring buffer, so that the pipeline never locks
+    // or wakes up readers of GenerationHandle; read() then returns outputs of all steps completed since the previous read
+    // 0 means that outputs are passed via a synchronized queue, which wakes up the reader on each step
+    std::size_t stream_ring_buffer_size = 0;
+
+    // number of KV cache blocks allocated at start, the cache grows on demand up to num_kv_blocks / cache_size
+    // 0 means that the whole KV cache is allocated at start
+    // with speculative decoding and a default draft scheduler config, main and draft KV caches share cache_size instead of splitting it:
+    // each grows while memory is available and releases its unused blocks, when the other one lacks memory
+    std::size_t initial_num_kv_blocks = 0;
+
+    // whether KV cache grown on demand is shrunk back to initial_num_kv_blocks, once there are no requests to process
+    // prefix cached blocks beyond the initial size are discarded in this case
+    bool shrink_kv_cache_when_idle = false;
+
+    // precisions of keys and values in KV cache, which override the precision chosen from the device and ov::hint::kv_cache_precision
+    // u8 and u4 (CPU only) quantize keys / values per token with a scale and a zero point for each group of channels of each head
+    // ov::element::undefined keeps the default precision
+    ov::element::Type key_cache_precision = ov::element::undefined;
+    ov::element::Type value_cache_precision = ov::element::undefined;
+
+    // number of channels of a head sharing a scale and a zero point of u8 / u4 quantized keys and values
+    // 0 means that the whole head is quantized as a single group
+    std::size_t key_cache_group_size = 0;
+    std::size_t value_cache_group_size = 0;
+
+    // on multi-socket CPU hosts, places KV cache of consecutive decoder layers on different NUMA nodes in a round-robin manner,
+    // so that attention reads are spread over memory controllers of all sockets instead of the constructing thread's one
+    bool numa_interleave_kv_cache = false;
+
+    // GPU only: whether "logits" and attention score outputs are bound once to host-visible (USM host) tensors sized for max_num_seqs
+    // sequences and the whole KV cache, so that each step writes them to host memory directly instead of copying them to buffers
+    // managed by the infer request; outputs of larger steps grow the tensors
+    bool use_host_output_tensors = false;
+
+    // CPU only: number of streams the model is compiled with, so that scheduled sequence groups of each step are split into up to
+    // this number of sub-batches with balanced numbers of tokens, which are inferred concurrently by their own infer requests
+    // sharing KV cache; 1 means that a step is inferred by a single infer request
+    // with ov::genai::pipeline_parallel_devices sub-batches are micro-batches, which occupy different stages at the same time
+    // cannot be used with cache eviction, adapters, device_top_k, device_prompt_log_probs and models taking inputs_embeds
+    std::size_t num_inference_streams = 1;
+
+    // if non-zero, the model is extended to select this number of the most probable tokens on device, so that only their
+    // log probabilities and IDs instead of full vocabulary logits are read back to host after each step
+    // supports greedy decoding and multinomial sampling with top_k not greater than this value, without repetition, presence and
+    // frequency penalties, min_new_tokens and echo; cannot be used with speculative decoding
+    std::size_t device_top_k = 0;
+
+    // whether log probabilities of prompt tokens requested by GenerationConfig::echo are computed on device by log-softmax and gather
+    // appended to the model, so that host does not process full vocabulary logits of each prompt token
+    bool device_prompt_log_probs = false;
+
+    // CPU only: if non-zero, a decode step of a sequence with more KV cache blocks attends to this number of blocks per layer only:
+    // the first and the last blocks and the blocks with the highest upper bounds of attention scores, which are estimated from
+    // per-block minimums and maximums of keys and the query of the previous token of the sequence (Quest-like sparse attention)
+    // must be at least 2; cannot be used with cache eviction, attention_window_size and num_inference_streams greater than 1
+    std::size_t sparse_decode_block_budget = 0;
+
+    // whether next tokens of different sequence groups are sampled concurrently
+    // sampled tokens do not depend on it, since each request uses its own random stream derived from GenerationConfig::rng_seed and the request ID
+    bool enable_parallel_sampling = false;
+
+    // speculative decoding only (configuration of the main model): whether the draft model generates candidates for the next step
+    // while the main model validates the current ones, assuming that they are accepted; draft sequences diverged from validated
+    // tokens are rolled back, so that the result is the same, while draft and main models run on their devices simultaneously
+    bool enable_pipelined_speculative_decoding = false;
+
+    // if not NONE or if admission_watermark is set, the prompt of a new request is scheduled only once KV cache is expected to fit
+    // its prompt and predicted output in addition to blocks, which already scheduled requests are predicted to take by the end of
+    // their generation, so that generation phase has to preempt requests less often; GenerationConfig::expected_new_tokens
+    // overrides the prediction; a request is always scheduled, when no other request occupies KV cache
+    OutputLengthEstimate output_length_estimate = OutputLengthEstimate::NONE;
+
+    // share of KV cache blocks left free when the prompt of a new request is scheduled, as a headroom for requests
+    // generating more tokens than predicted; must be less than 1
+    float admission_watermark = 0.0f;
+
+    // how new requests are treated when the pipeline is overloaded
+    AdmissionControlMode admission_control = AdmissionControlMode::DISABLED;
+
+    // the pipeline is overloaded when at least this number of added requests is not picked up by a step yet (0 means no limit)
+    std::size_t max_num_awaiting_requests = 0;
+
+    // the pipeline is overloaded when KV cache usage reported by the last step exceeds this value (in percents)
+    float max_cache_usage_for_admission = 100.0f;
+
     bool operator==(const SchedulerConfig& other) const {
         return max_num_batched_tokens == other.max_num_batched_tokens && num_kv_blocks == other.num_kv_blocks &&
-               cache_size == other.cache_size &&
-               dynamic_split_fuse == other.dynamic_split_fuse && use_cache_eviction == other.use_cache_eviction &&
-               max_num_seqs == other.max_num_seqs && enable_prefix_caching == other.enable_prefix_caching;
+               cache_size == other.cache_size && block_size == other.block_size && cache_memory_headroom == other.cache_memory_headroom &&
+               dynamic_split_fuse == other.dynamic_split_fuse && max_num_prefill_tokens == other.max_num_prefill_tokens &&
+               max_prefill_chunk_size == other.max_prefill_chunk_size && target_step_latency_ms == other.target_step_latency_ms && use_cache_eviction == other.use_cache_eviction &&
+               attention_window_size == other.attention_window_size && num_attention_sink_tokens == other.num_attention_sink_tokens &&
+               max_num_seqs == other.max_num_seqs && enable_prefix_caching == other.enable_prefix_caching &&
+               enable_lazy_copy_on_write == other.enable_lazy_copy_on_write &&
+               scheduling_policy == other.scheduling_policy && preemption_mode == other.preemption_mode &&
+               output_length_estimate == other.output_length_estimate && admission_watermark == other.admission_watermark &&
+               num_swap_blocks == other.num_swap_blocks && swap_space == other.swap_space &&
+               prefix_cache_dir == other.prefix_cache_dir && coalesce_identical_prompts == other.coalesce_identical_prompts &&
+               admission_control == other.admission_control &&
+               stream_ring_buffer_size == other.stream_ring_buffer_size && numa_interleave_kv_cache == other.numa_interleave_kv_cache &&
+               use_host_output_tensors == other.use_host_output_tensors &&
+               num_inference_streams == other.num_inference_streams &&
+               key_cache_precision == other.key_cache_precision && value_cache_precision == other.value_cache_precision &&
+               key_cache_group_size == other.key_cache_group_size && value_cache_group_size == other.value_cache_group_size &&
+               initial_num_kv_blocks == other.initial_num_kv_blocks && shrink_kv_cache_when_idle == other.shrink_kv_cache_when_idle &&
+               max_num_awaiting_requests == other.max_num_awaiting_requests && enable_parallel_sampling == other.enable_parallel_sampling &&
+               device_top_k == other.device_top_k && device_prompt_log_probs == other.device_prompt_log_probs &&
+               sparse_decode_block_budget == other.sparse_decode_block_budget &&
+               enable_pipelined_speculative_decoding == other.enable_pipelined_speculative_decoding &&
+               max_cache_usage_for_admission == other.max_cache_usage_for_admission;
     }
 };
 }
@@ -0,0 +1,107 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "openvino/core/any.hpp"
+#include "openvino/runtime/properties.hpp"
+#include "openvino/runtime/tensor.hpp"
+
+#include "openvino/genai/tokenizer.hpp"
+#include "openvino/genai/visibility.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * @brief Defines how token states of the last hidden layer are reduced to a text embedding.
+ */
+enum class PoolingType {
+    CLS,    // state of the first token, e.g. BGE models
+    MEAN    // mean of states of all tokens excluding padding, e.g. sentence-transformers models
+};
+
+/**
+ * @brief Pipeline computing embeddings of texts by sentence embedding models (BERT-like encoders).
+ * Texts are tokenized, sorted by length and split into batches of texts of similar lengths limited by a budget of tokens,
+ * so that little computation is spent on padding. Pooling and normalization are appended to the model and run on device.
+ */
+class OPENVINO_GENAI_EXPORTS TextEmbeddingPipeline {
+public:
+    /**
+     * @brief Constructs the pipeline from `openvino_model.xml`, whose first output is the last hidden state, and tokenizers
+     * in the same dir.
+     *
+     * @param models_path Path to the dir with the model and tokenizers
+     * @param device Device to compile the model for
+     * @param properties Properties of the pipeline (ov::genai::pooling_type, ov::genai::normalize_embeddings,
+     * ov::genai::embedding_batch_token_budget, ov::genai::embedding_max_length) and compile properties of the model
+     */
+    TextEmbeddingPipeline(const std::filesystem::path& models_path,
+                          const std::string& device,
+                          const ov::AnyMap& properties = {});
+
+    template <typename... Properties,
+              typename std::enable_if<ov::util::StringAny<Properties...>::value, bool>::type = true>
+    TextEmbeddingPipeline(const std::filesystem::path& models_path, const std::string& device, Properties&&... properties)
+        : TextEmbeddingPipeline(models_path, device, ov::AnyMap{std::forward<Properties>(properties)...}) {}
+
+    ~TextEmbeddingPipeline();
+
+    /**
+     * @brief Computes embeddings of texts and writes them to a caller provided tensor, e.g. one wrapping a caller's buffer.
+     *
+     * @param texts Texts to embed
+     * @param embeddings f32 tensor of shape [texts.size(), get_embedding_size()], whose rows receive embeddings of texts in order
+     */
+    void embed(const std::vector<std::string>& texts, ov::Tensor& embeddings);
+
+    /**
+     * @brief Computes embeddings of texts.
+     * @return Embedding of each text in order
+     */
+    std::vector<std::vector<float>> embed_documents(const std::vector<std::string>& texts);
+
+    /**
+     * @brief Computes an embedding of a single text.
+     */
+    std::vector<float> embed_query(const std::string& text);
+
+    size_t get_embedding_size() const;
+
+    Tokenizer get_tokenizer() const;
+
+private:
+    class TextEmbeddingPipelineImpl;
+    std::unique_ptr<TextEmbeddingPipelineImpl> m_impl;
+};
+
+/**
+* @brief pooling_type property of TextEmbeddingPipeline selects how token states are reduced to an embedding (default: PoolingType::CLS).
+*/
+static constexpr ov::Property<PoolingType> pooling_type{"pooling_type"};
+
+/**
+* @brief normalize_embeddings property of TextEmbeddingPipeline sets whether embeddings are scaled to unit L2 norm (default: true).
+*/
+static constexpr ov::Property<bool> normalize_embeddings{"normalize_embeddings"};
+
+/**
+* @brief embedding_batch_token_budget property of TextEmbeddingPipeline limits the number of tokens of a batch including padding,
+* i.e. batch size times the length of its longest text. A text longer than the budget is inferred alone (default: 8192).
+*/
+static constexpr ov::Property<size_t> embedding_batch_token_budget{"embedding_batch_token_budget"};
+
+/**
+* @brief embedding_max_length property of TextEmbeddingPipeline sets the maximum number of tokens of a text, longer texts are
+* truncated, e.g. to max_position_embeddings of the model. 0 (default) disables truncation.
+*/
+static constexpr ov::Property<size_t> embedding_max_length{"embedding_max_length"};
+
+}  // namespace genai
+}  // namespace ov
@@ -7,6 +7,7 @@
 #include <vector>
 #include <initializer_list>
 #include <filesystem>
+#include <future>
 
 #include "openvino/runtime/tensor.hpp"
 #include "openvino/genai/visibility.hpp"
@@ -22,6 +23,26 @@ struct TokenizedInputs {
     ov::Tensor attention_mask;
 };
 
+/**
+* @brief Counters of the tokenization cache enabled by ov::genai::tokenization_cache_size
+*/
+struct TokenizationCacheMetrics {
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+/**
+* @brief Statistics of the infer request pools of the tokenizer and the detokenizer
+*/
+struct TokenizerInferRequestsMetrics {
+    // current number of infer requests, which grows under contention up to ov::genai::tokenizer_max_infer_requests
+    size_t num_tokenizer_requests = 0;
+    size_t num_detokenizer_requests = 0;
+    // number of calls, which waited for an idle infer request, and the total time of waiting
+    size_t num_waits = 0;
+    float total_wait_ms = 0.0f;
+};
+
 /**
 * @brief class is used to encode prompts and decode resulting tokens
 */
@@ -231,15 +252,61 @@ public:
     std::string get_eos_token() const;
     std::string get_pad_token() const;
 
+    /// @brief Returns hits and misses of the tokenization cache, zeros if the cache is disabled.
+    TokenizationCacheMetrics get_tokenization_cache_metrics() const;
+
+    /// @brief Returns sizes of infer request pools and time callers waited for idle infer requests.
+    TokenizerInferRequestsMetrics get_infer_requests_metrics() const;
+
     Tokenizer() = default;
     ~Tokenizer();
 private:
     class TokenizerImpl;
     std::shared_ptr<TokenizerImpl> m_pimpl;
+    // set instead of m_pimpl by a constructor with ov::genai::deferred_load, while models are loaded in background
+    std::shared_future<std::shared_ptr<TokenizerImpl>> m_deferred_pimpl;
+
+    const std::shared_ptr<TokenizerImpl>& get_pimpl() const;
 };
 
 static constexpr ov::Property<bool> add_special_tokens{"add_special_tokens"};
 static constexpr ov::Property<bool> skip_special_tokens{"skip_special_tokens"};
 
+/**
+* @brief native_tokenizer property serves to tokenize and detokenize short inputs without inference of OV tokenizer models.
+* If tokenizer.json next to the models describes a byte-level BPE tokenizer (GPT-2 like), encode() and decode() use its vocabulary
+* and merges directly, while texts and tokens not supported natively fall back to OV models. The native implementation is enabled
+* only if it reproduces results of OV models on probe inputs at load time. Applies to Tokenizer constructed from a directory.
+*/
+static constexpr ov::Property<bool> native_tokenizer{"native_tokenizer"};
+
+/**
+* @brief tokenization_cache_size property serves to skip tokenization of repeated texts, e.g. shared system prompts or stop strings.
+* Token IDs of the given number of the most recently encoded single prompts are cached and returned for exactly the same text
+* and add_special_tokens mode. Hits and misses are reported by Tokenizer::get_tokenization_cache_metrics(). 0 (default) disables caching.
+*/
+static constexpr ov::Property<size_t> tokenization_cache_size{"tokenization_cache_size"};
+
+/**
+* @brief tokenizer_max_infer_requests property serves to absorb bursts of concurrent encode() and decode() calls.
+* Pools of infer requests start from ov::optimal_number_of_infer_requests of the compiled tokenizer and detokenizer and create
+* more requests, while all existing ones are busy, up to the given number. 0 (default) keeps the initial number.
+*/
+static constexpr ov::Property<size_t> tokenizer_max_infer_requests{"tokenizer_max_infer_requests"};
+
+/**
+* @brief streaming_detokenizer_infer_requests property serves to keep streaming latency independent of batch decoding.
+* The given number of detokenizer infer requests are reserved for decoding short single sequences (up to 16 tokens),
+* e.g. by streamers and stop strings matching, so that they never wait for requests decoding batches. 0 (default) disables the reserve.
+*/
+static constexpr ov::Property<size_t> streaming_detokenizer_infer_requests{"streaming_detokenizer_infer_requests"};
+
+/**
+* @brief deferred_load property serves to overlap loading of the tokenizer with other work, e.g. compilation of the LLM.
+* Set `true` so that Tokenizer constructed from a directory reads and compiles its models in background, while the constructor
+* returns immediately. The first call of a Tokenizer method waits for loading to complete and rethrows its error, if any.
+*/
+static constexpr ov::Property<bool> deferred_load{"deferred_load"};
+
 }  // namespace genai
 }  // namespace ov
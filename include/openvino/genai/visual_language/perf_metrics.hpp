@@ -12,13 +12,48 @@ namespace ov::genai {
 struct OPENVINO_GENAI_EXPORTS VLMRawPerfMetrics {
     /** @brief Duration of preparation of embeddings */
     std::vector<MicroSeconds> prepare_embeddings_durations;
+    /** @brief Duration of preprocessing of each encoded image into pixel values of the vision encoder */
+    std::vector<MicroSeconds> image_preprocessing_durations;
+    /** @brief Duration of each infer of the vision encoder */
+    std::vector<MicroSeconds> vision_encoder_infer_durations;
+    /** @brief Number of image patches encoded by each infer of the vision encoder */
+    std::vector<size_t> vision_encoder_infer_batch_sizes;
+    /** @brief Duration of each resampling of image features by MiniCPM-V, including preparation of its inputs */
+    std::vector<MicroSeconds> resampling_durations;
+    /** @brief Duration of merging of image embeddings into text embeddings of each prompt, without resampling */
+    std::vector<MicroSeconds> embeddings_merge_durations;
+    /** @brief Number of image tokens passed to the language model */
+    size_t num_image_tokens = 0;
+    /** @brief Number of images found in the vision embeddings cache */
+    size_t vision_embeddings_cache_hits = 0;
+    /** @brief Number of images looked up in the vision embeddings cache */
+    size_t vision_embeddings_cache_lookups = 0;
 };
 
 struct OPENVINO_GENAI_EXPORTS VLMPerfMetrics : public PerfMetrics {
     /** @brief Mean and standard deviation of preparation of embeddings in milliseconds */
     MeanStdPair prepare_embeddings_duration;
+    /** @brief Mean and standard deviation of preprocessing of an image in milliseconds */
+    MeanStdPair image_preprocessing_duration;
+    /** @brief Mean and standard deviation of an infer of the vision encoder in milliseconds */
+    MeanStdPair vision_encoder_infer_duration;
+    /** @brief Mean and standard deviation of an infer of the vision encoder per image patch in milliseconds */
+    MeanStdPair vision_encoder_patch_duration;
+    /** @brief Mean and standard deviation of an infer of the resampler in milliseconds */
+    MeanStdPair resampling_duration;
+    /** @brief Mean and standard deviation of merging of image and text embeddings in milliseconds */
+    MeanStdPair embeddings_merge_duration;
+    /** @brief Fraction of images found in the vision embeddings cache, 0 if the cache is disabled */
+    float vision_embeddings_cache_hit_rate = 0.0f;
 
     MeanStdPair get_prepare_embeddings_duration();
+    MeanStdPair get_image_preprocessing_duration();
+    MeanStdPair get_vision_encoder_infer_duration();
+    MeanStdPair get_vision_encoder_patch_duration();
+    MeanStdPair get_resampling_duration();
+    MeanStdPair get_embeddings_merge_duration();
+    size_t get_num_image_tokens() const;
+    float get_vision_embeddings_cache_hit_rate();
 
     VLMPerfMetrics() = default;
 
@@ -31,4 +66,4 @@ struct OPENVINO_GENAI_EXPORTS VLMPerfMetrics : public PerfMetrics {
     VLMRawPerfMetrics vlm_raw_metrics;
 };
 
-}
\ No newline at end of file
+}
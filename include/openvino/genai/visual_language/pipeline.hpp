@@ -34,6 +34,8 @@ public:
     /// @param device Inference device. A tokenizer is always compiled
     /// for CPU.
     /// @param properties A config to pass to ov::Core::compile_model().
+    /// If it contains ov::genai::scheduler_config, the language model
+    /// is run by continuous batching with paged attention.
     VLMPipeline(
         const std::filesystem::path& models_path,
         const std::string& device,
@@ -129,6 +131,41 @@ public:
         const ov::AnyMap& config_map
     );
 
+    /// @brief Start generation in background and return without waiting
+    /// for it. Generations run on a thread of the pipeline one by one
+    /// in the order of calls and are independent of chat. Other methods
+    /// of the pipeline must not be called until started generations
+    /// finish. Destruction of the pipeline waits for the running
+    /// generation, queued ones fail with std::future_error.
+    /// @param prompt A prompt to respond to.
+    /// @param images Images to be prepended to a prompt.
+    /// @param generation_config A config to follow for text generation.
+    /// @param streamer A streamer called from a thread of the pipeline.
+    /// @param on_completion A callback called from a thread of the
+    /// pipeline once results or an error are available.
+    /// @return A handle to wait for, get or cancel the generation.
+    GenerationFuture<VLMDecodedResults> generate_async(
+        const std::string& prompt,
+        const std::vector<ov::Tensor>& rgbs,
+        const GenerationConfig& generation_config,
+        const StreamerVariant& streamer = std::monostate(),
+        std::function<void(GenerationFuture<VLMDecodedResults>)> on_completion = {}
+    );
+
+    /// @brief Generate responses given several prompts with their
+    /// images. With ov::genai::scheduler_config passed to a constructor
+    /// the requests are generated together by continuous batching,
+    /// otherwise one by one.
+    /// @param prompts Prompts to respond to.
+    /// @param images Images to be prepended to each prompt.
+    /// @param generation_configs A config for each prompt.
+    /// @return Results generated by a model for each prompt.
+    std::vector<VLMDecodedResults> generate(
+        const std::vector<std::string>& prompts,
+        const std::vector<std::vector<ov::Tensor>>& images,
+        const std::vector<GenerationConfig>& generation_configs
+    );
+
     /// @brief Generate a response given a prompt and arbitrary number
     /// of ov::Property instances.
     /// Example:
@@ -192,4 +229,73 @@ private:
 */
 static constexpr ov::Property<ov::Tensor> image{"image"};
 static constexpr ov::Property<std::vector<ov::Tensor>> images{"images"};
+
+/**
+ * @brief generate() property with video frames of uint8 RGB [NHWC] layout, which are prepended to a prompt as images.
+ * Frames are sampled according to video_max_frames, a frame equal to the previous sampled one is skipped.
+ * Cannot be combined with image or images.
+ */
+static constexpr ov::Property<ov::Tensor> video{"video"};
+
+/**
+ * @brief generate() property with the maximum number of video frames, which are sampled uniformly from the video.
+ * 0, the default, keeps all frames.
+ */
+static constexpr ov::Property<size_t> video_max_frames{"video_max_frames"};
+
+/**
+ * @brief generate() property with the number of consecutive sampled video frames, whose image tokens are averaged
+ * into tokens of a single image, which reduces prefill cost and KV cache memory of long videos. 1, the default,
+ * keeps tokens of each frame. Applies to LLaVA, LLaVA-Next and InternVL.
+ */
+static constexpr ov::Property<size_t> video_temporal_pool{"video_temporal_pool"};
+
+/**
+ * @brief VLMPipeline property, which embeds resize, center crop, normalization and layout conversion of images into
+ * the vision encoder model of LLaVA, LLaVA-NeXT and InternVL2, so that they run on the target device and an image is
+ * passed to it as u8. The embedded steps follow preprocessor_config.json and resize like Pillow bicubic, so values may
+ * slightly differ from the CPU preprocessing. Slicing of an image into patches is still done on the CPU. Ignored by
+ * MiniCPM-V.
+ */
+static constexpr ov::Property<bool> embedded_image_preprocessing{"embedded_image_preprocessing"};
+
+/**
+ * @brief VLMPipeline property with the maximum number of image patches per infer of the vision encoder. Patches of all
+ * images of a prompt are encoded by batched infers of up to this size, 0 means all in one infer. MiniCPM-V encodes
+ * each image by a separate infer.
+ */
+static constexpr ov::Property<size_t> vision_encoder_max_batch_size{"vision_encoder_max_batch_size"};
+
+/**
+ * @brief VLMPipeline property with the maximum byte size of the cache of image embeddings, the least recently used
+ * ones are evicted. Images are looked up by a hash of their content and of the processor config, so an image
+ * sent again, e.g. in a follow-up chat question, is not encoded again. 0, the default, disables the cache.
+ */
+static constexpr ov::Property<size_t> vision_embeddings_cache_size{"vision_embeddings_cache_size"};
+
+/**
+ * @brief VLMPipeline property with the fraction of visual tokens of each image passed to the language model, in (0, 1].
+ * Embeddings of consecutive image tokens are averaged in groups, which lowers prefill cost and KV cache memory of
+ * image-heavy prompts at the cost of detail. Applies to LLaVA, LLaVA-Next and InternVL, MiniCPM already resamples
+ * images to a fixed number of tokens. 1, the default, keeps all tokens.
+ */
+static constexpr ov::Property<float> visual_tokens_keep_ratio{"visual_tokens_keep_ratio"};
+
+/**
+ * @brief VLMPipeline properties with devices of the vision encoder (and the MiniCPM-V resampler), the text embeddings
+ * model and the language model, which default to the device passed to the pipeline. For example, the vision encoder
+ * may run on NPU while the language model runs on GPU. Images are encoded in parallel with embedding of the prompt,
+ * so submodels on different devices also overlap.
+ */
+static constexpr ov::Property<std::string> vision_encoder_device{"vision_encoder_device"};
+static constexpr ov::Property<std::string> text_embeddings_device{"text_embeddings_device"};
+static constexpr ov::Property<std::string> language_model_device{"language_model_device"};
+
+/**
+ * @brief VLMPipeline properties with compile properties of a single submodel, which override the same properties
+ * passed to the pipeline for that submodel only.
+ */
+static constexpr ov::Property<ov::AnyMap> vision_encoder_properties{"vision_encoder_properties"};
+static constexpr ov::Property<ov::AnyMap> text_embeddings_properties{"text_embeddings_properties"};
+static constexpr ov::Property<ov::AnyMap> language_model_properties{"language_model_properties"};
 }
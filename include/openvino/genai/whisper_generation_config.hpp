@@ -5,6 +5,8 @@
 
 #include <filesystem>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "openvino/genai/tokenizer.hpp"
 #include "openvino/runtime/compiled_model.hpp"
@@ -78,6 +80,16 @@ public:
     // Note that a segment of text refers to a sequence of one or more words, rather than individual words.
     bool return_timestamps = false;
 
+    // If `true`, timestamps of words are returned in WhisperDecodedResults::words. Tokens are aligned with audio by
+    // DTW over cross-attention weights of `alignment_heads`, so the pipeline has to be created with the
+    // ov::genai::word_timestamps(true) property, which adds these weights to decoder outputs.
+    // Supported with greedy decoding only.
+    bool word_timestamps = false;
+
+    // Pairs of decoder layer and head indices, whose cross-attention is aligned with audio.
+    // Initialized from the generation_config.json alignment_heads list.
+    std::vector<std::pair<size_t, size_t>> alignment_heads;
+
     /*
      * Initial prompt tokens passed as a previous transcription (after `<|startofprev|>` token) to the first processing
      * window. Can be used to steer the model to use particular spellings or styles.
@@ -110,6 +122,48 @@ public:
     // A list containing the non-speech tokens that will be suppressed during generation.
     std::vector<int64_t> suppress_tokens;
 
+    // Beam search and temperature fallback
+
+    // Number of beams for beam search at zero temperature, 1 means greedy decoding. Beams are decoded as rows of one
+    // batch. The same number of candidates is sampled at non-zero temperatures and the most probable one is kept.
+    size_t num_beams = 1;
+
+    // Exponential penalty to the length of candidates, which are ranked by the sum of their token log probabilities
+    // divided by length^length_penalty.
+    float length_penalty = 1.0f;
+
+    // Temperatures of decoding attempts of a window, which reuse its encoder output. The next temperature is tried
+    // while the result exceeds `compression_ratio_threshold` or falls below `logprob_threshold`.
+    // Zero temperature means beam search or greedy decoding.
+    std::vector<float> temperatures = {0.0f};
+
+    // Maximum compression ratio of window tokens, which is the number of tokens divided by the number of phrases
+    // of their LZ77 parsing. Highly repetitive results, e.g. caused by looping, are decoded again.
+    std::optional<float> compression_ratio_threshold = std::nullopt;
+
+    // Minimum average log probability of window tokens including the end of stream token.
+    std::optional<float> logprob_threshold = std::nullopt;
+
+    // Seed of the random generator used at non-zero temperatures.
+    size_t rng_seed = 0;
+
+    // Number of tokens proposed by the draft decoder per verification step of greedy decoding, if the pipeline is
+    // created with the ov::genai::draft_decoder property.
+    size_t num_assistant_tokens = 5;
+
+    // Voice activity detection
+
+    // If set, silent regions of the audio are not transcribed. A 20 ms frame is speech, if its energy is above the
+    // energy of the loudest frame plus `vad_threshold` dB, e.g. -40. Speech regions are packed one after another into
+    // processing windows and timestamps of segments are mapped back to the original audio.
+    std::optional<float> vad_threshold = std::nullopt;
+
+    // Silence shorter than this duration in seconds is kept within speech regions.
+    float vad_min_silence_duration = 1.0f;
+
+    // Duration in seconds of audio kept before and after each speech region.
+    float vad_speech_pad_duration = 0.2f;
+
     /** @brief sets eos_token_id to tokenizer_eos_token_id if eos_token_id is less than 0.
      * Otherwise verifies eos_token_id == tokenizer_eos_token_id.
      */
@@ -144,9 +198,16 @@ static constexpr ov::Property<int64_t> prev_sot_token_id{"prev_sot_token_id"};
 static constexpr ov::Property<std::string> language{"language"};
 static constexpr ov::Property<std::string> task{"task"};
 static constexpr ov::Property<bool> return_timestamps{"return_timestamps"};
+static constexpr ov::Property<bool> word_timestamps{"word_timestamps"};
 static constexpr ov::Property<std::string> initial_prompt{"initial_prompt"};
 static constexpr ov::Property<std::string> hotwords{"hotwords"};
 static constexpr ov::Property<std::map<std::string, int64_t>> lang_to_id{"lang_to_id"};
+static constexpr ov::Property<std::vector<float>> temperatures{"temperatures"};
+static constexpr ov::Property<float> compression_ratio_threshold{"compression_ratio_threshold"};
+static constexpr ov::Property<float> logprob_threshold{"logprob_threshold"};
+static constexpr ov::Property<float> vad_threshold{"vad_threshold"};
+static constexpr ov::Property<float> vad_min_silence_duration{"vad_min_silence_duration"};
+static constexpr ov::Property<float> vad_speech_pad_duration{"vad_speech_pad_duration"};
 
 }  // namespace genai
 }  // namespace ov
@@ -28,6 +28,13 @@ public:
     /// @brief put is called every time new token chunk is generated,
     /// @return bool flag to indicate whether generation should be stopped, if return true generation stops
     virtual bool put_chunk(std::vector<int64_t> tokens) = 0;
+
+    /// @brief put_partial_chunk is called by streaming sessions every time the window is decoded again with tokens,
+    /// which are not finalised yet. Each call replaces tokens of the previous one, tokens can be empty.
+    /// @return bool flag to indicate whether generation should be stopped, if return true generation stops
+    virtual bool put_partial_chunk(std::vector<int64_t> tokens) {
+        return false;
+    }
 };
 
 // Return flag corresponds whether generation should be stopped: false means continue generation, true means stop.
@@ -68,10 +75,21 @@ struct WhisperDecodedResultChunk {
     std::string text;
 };
 
+struct WhisperDecodedResultWord {
+    // start of word in seconds
+    float start_ts;
+
+    // end of word in seconds
+    float end_ts;
+    std::string word;
+};
+
 struct WhisperDecodedResults {
     std::vector<std::string> texts;
     std::vector<float> scores;
     std::optional<std::vector<WhisperDecodedResultChunk>> chunks = std::nullopt;
+    // set if word_timestamps is enabled
+    std::optional<std::vector<WhisperDecodedResultWord>> words = std::nullopt;
     WhisperPerfMetrics perf_metrics;
 
     operator std::string() const {
@@ -101,6 +119,25 @@ struct WhisperDecodedResults {
     }
 };
 
+/**
+ * @brief Parameters of a streaming transcription session, see WhisperPipeline::start_stream
+ */
+struct WhisperStreamingConfig {
+    // minimal duration of new audio in seconds, which triggers decoding of the current window
+    float step_duration = 1.0f;
+    // segments ending within the last lookahead_duration seconds of received audio are partial,
+    // since more audio can change them
+    float lookahead_duration = 1.0f;
+};
+
+/**
+ * @brief Format of headerless audio files: interleaved little-endian signed 16-bit samples
+ */
+struct WhisperPcmFormat {
+    size_t sampling_rate = 16000;
+    size_t n_channels = 1;
+};
+
 /**
  * @brief Automatic speech recognition pipeline
  */
@@ -169,11 +206,103 @@ public:
     }
     WhisperDecodedResults generate(const RawSpeechInput& raw_speech_input, const ov::AnyMap& config_map);
 
+    /**
+     * @brief Generate for an audio file. WAV (integer PCM or IEEE float samples) and FLAC files are detected by the
+     * file header, other files are read as headerless PCM of pcm_format. Audio is decoded, down-mixed to mono and
+     * resampled block by block straight into feature extraction, so that the whole waveform is not kept in memory.
+     * Voice activity detection by vad_threshold is not supported for file input.
+     *
+     * @param audio_path path to the audio file
+     * @param generation_config optional GenerationConfig
+     * @param streamer optional streamer with the same restrictions as for raw speech input
+     * @param pcm_format sampling rate and number of channels of headerless PCM files
+     * @return WhisperDecodedResults decoded resulting text transcription
+     */
+    WhisperDecodedResults generate(const std::filesystem::path& audio_path,
+                                   OptionalWhisperGenerationConfig generation_config = std::nullopt,
+                                   ChunkStreamerVariant streamer = std::monostate(),
+                                   const WhisperPcmFormat& pcm_format = {});
+
+    /**
+     * @brief Batched generate for several independent raw speech inputs, e.g. concurrent requests of a service.
+     * 30 seconds windows of different inputs are encoded and decoded together, inputs leave the batch after their
+     * last window and waiting inputs take their rows. Streaming is not supported in this mode.
+     *
+     * @param raw_speech_inputs raw speech inputs with the same requirements as for a single input
+     * @param generation_config optional GenerationConfig shared by all inputs
+     * @param max_batch_size maximal number of windows in encoder and decoder infers, 0 means all inputs
+     * @return std::vector<WhisperDecodedResults> results in the order of inputs, they share perf_metrics of
+     * batched infers
+     */
+    std::vector<WhisperDecodedResults> generate(const std::vector<RawSpeechInput>& raw_speech_inputs,
+                                                OptionalWhisperGenerationConfig generation_config = std::nullopt,
+                                                size_t max_batch_size = 0);
+
+    /**
+     * @brief Starts a streaming transcription session, which receives audio by push_audio() chunks. The current 30
+     * seconds window is decoded every step_duration seconds of new audio. Finalised segments are passed to the
+     * streamer by put_chunk(), a text callback streamer receives finalised text only. Tokens, which can change
+     * with more audio, are passed to ChunkStreamerBase::put_partial_chunk().
+     *
+     * @param generation_config optional GenerationConfig, timestamps are always predicted to find finalised segments
+     * @param streamer optional streamer
+     * @param streaming_config decoding step and look-ahead
+     */
+    void start_stream(OptionalWhisperGenerationConfig generation_config = std::nullopt,
+                      ChunkStreamerVariant streamer = std::monostate(),
+                      const WhisperStreamingConfig& streaming_config = {});
+
+    /**
+     * @brief Appends audio to the current session with the same requirements as raw_speech_input of generate()
+     * @return bool flag, which is true if the streamer requested to stop or max_new_tokens are generated
+     */
+    bool push_audio(const RawSpeechInput& audio_chunk);
+
+    /**
+     * @brief Decodes the remaining audio of the current session and ends it
+     * @return WhisperDecodedResults finalised transcription of the whole session
+     */
+    WhisperDecodedResults finish_stream();
+
     ov::genai::Tokenizer get_tokenizer();
     WhisperGenerationConfig get_generation_config() const;
     void set_generation_config(const WhisperGenerationConfig& config);
+
+    /**
+     * @brief Prepares the pipeline to serve requests without delays of the first ones: transcribes a second of silence
+     * with the current generation config, so that the encoder, the decoder with and without past and detokenizer
+     * are compiled and their memory is allocated. Every audio is padded to a 30 seconds window, so these are the shapes
+     * of real requests. The result is discarded.
+     * @param max_new_tokens number of tokens decoded to run decoding steps
+     */
+    void warmup(size_t max_new_tokens = 4);
 };
 
+/**
+ * @brief WhisperPipeline property, which enables encoding of the next 30 seconds window of long-form audio during
+ * decoding of the current one with a second encoder infer request. The window is encoded again, if predicted
+ * timestamps move it from the nominal offset. Ignored by NPU.
+ */
+static constexpr ov::Property<bool> pipelined_encoder{"pipelined_encoder"};
+
+/**
+ * @brief WhisperPipeline property with a directory of a draft model, e.g. distil-whisper, whose
+ * openvino_decoder_model.xml and openvino_decoder_with_past_model.xml propose WhisperGenerationConfig::
+ * num_assistant_tokens tokens per step of greedy decoding. The main decoder verifies them by one infer with the same
+ * encoder hidden states, so the encoder of the draft model has to be the same and it is not loaded. The output is the
+ * same as without the draft model. Batched generate() decodes without the draft. Ignored by NPU.
+ */
+static constexpr ov::Property<std::string> draft_decoder{"draft_decoder"};
+
+/**
+ * @brief WhisperPipeline properties with devices of the encoder and of the decoders, which default to the device
+ * passed to the constructor, e.g. the compute-bound encoder on GPU and the latency-bound decoders on CPU. If they
+ * differ, hidden states of the encoder are written to host memory of the non-CPU device, which both devices read
+ * without a copy. Ignored by NPU, which runs the static pipeline.
+ */
+static constexpr ov::Property<std::string> encoder_device{"encoder_device"};
+static constexpr ov::Property<std::string> decoder_device{"decoder_device"};
+
 OPENVINO_GENAI_EXPORTS std::pair<std::string, Any> streamer(ChunkStreamerVariant func);
 OPENVINO_GENAI_EXPORTS std::pair<std::string, Any> generation_config(const WhisperGenerationConfig& config);
 }  // namespace ov::genai
@@ -0,0 +1,101 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "openvino/core/except.hpp"
+#include "openvino/genai/generation_future.hpp"
+
+namespace ov::genai {
+
+// Fixed number of threads running submitted tasks in submission order.
+// The destructor waits for running tasks and destroys queued ones without running them,
+// so promises captured by queued tasks are broken.
+class AsyncExecutor {
+    std::mutex m_mutex;
+    std::condition_variable m_has_tasks;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopped = false;
+    std::vector<std::thread> m_threads;
+
+    void _run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_has_tasks.wait(lock, [this] { return m_stopped || !m_tasks.empty(); });
+                if (m_stopped)
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit AsyncExecutor(size_t num_threads) {
+        OPENVINO_ASSERT(num_threads > 0, "AsyncExecutor requires at least one thread");
+        for (size_t i = 0; i < num_threads; ++i)
+            m_threads.emplace_back([this] { _run(); });
+    }
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    ~AsyncExecutor() {
+        std::deque<std::function<void()>> dropped_tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+            dropped_tasks.swap(m_tasks);
+        }
+        m_has_tasks.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    // tasks must not throw
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            OPENVINO_ASSERT(!m_stopped, "AsyncExecutor is stopped");
+            m_tasks.push_back(std::move(task));
+        }
+        m_has_tasks.notify_one();
+    }
+
+    // queues generate_fn, which gets the cancellation flag of the returned future, on_completion is optional
+    template <typename Results>
+    GenerationFuture<Results> submit_generation(std::function<Results(const std::shared_ptr<std::atomic<bool>>&)> generate_fn,
+                                                std::function<void(GenerationFuture<Results>)> on_completion) {
+        auto is_cancelled = std::make_shared<std::atomic<bool>>(false);
+        auto promise = std::make_shared<std::promise<Results>>();
+        GenerationFuture<Results> future(promise->get_future().share(), is_cancelled);
+        submit([generate_fn = std::move(generate_fn), on_completion = std::move(on_completion), is_cancelled, promise, future]() {
+            try {
+                OPENVINO_ASSERT(!is_cancelled->load(), "Generation is cancelled before it started");
+                promise->set_value(generate_fn(is_cancelled));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+            if (on_completion) {
+                try {
+                    on_completion(future);
+                } catch (...) {
+                    // there is no caller to report to, results are available through the future anyway
+                }
+            }
+        });
+        return future;
+    }
+};
+
+}
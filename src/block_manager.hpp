@@ -6,11 +6,14 @@
 #include <memory>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <fstream>
 #include <chrono>
 
 #include "sequence_group.hpp"
+#include "prefix_tree.hpp"
 
 namespace ov::genai {
 
@@ -79,8 +82,32 @@ using BlocksPerLayer = std::vector<KVCacheBlock::Ptr>;
  * runs out of fresh blocks, or reused if their contents match to the prefix-based requested hash.
  */
 class OverwritableBlocksHashStore {
-    std::map<size_t, BlocksPerLayer> m_blocks;
+    using Timestamp = std::chrono::time_point<std::chrono::system_clock>;
+    // blocks ordered by their timestamps (oldest first), so that the least recently used ones can be found in O(1)
+    std::multimap<Timestamp, size_t> m_lru_index;
+    struct StoredBlocks {
+        BlocksPerLayer blocks_for_all_layers;
+        std::multimap<Timestamp, size_t>::iterator lru_it;
+    };
+    std::unordered_map<size_t, StoredBlocks> m_blocks;
     size_t m_num_layers;
+    size_t m_num_hits = 0;
+    size_t m_num_misses = 0;
+
+    BlocksPerLayer _pop(std::unordered_map<size_t, StoredBlocks>::iterator it) {
+        BlocksPerLayer blocks_for_all_layers = std::move(it->second.blocks_for_all_layers);
+        m_lru_index.erase(it->second.lru_it);
+        m_blocks.erase(it);
+        return blocks_for_all_layers;
+    }
+
+    static void _acquire(BlocksPerLayer& blocks_for_all_layers) {
+        auto timestamp = std::chrono::system_clock::now();
+        for (auto& block_ptr : blocks_for_all_layers) {
+            block_ptr->set_timestamp(timestamp);
+            block_ptr->increment();
+        }
+    }
     public:
     /**
      * Constructs the BlockHashStore.
@@ -104,7 +131,8 @@ class OverwritableBlocksHashStore {
             }
         }
         OPENVINO_ASSERT(m_blocks.count(hash) == 0);
-        m_blocks[hash] = blocks_for_all_layers;
+        auto lru_it = m_lru_index.emplace(blocks_for_all_layers[0]->get_timestamp(), hash);
+        m_blocks.emplace(hash, StoredBlocks{blocks_for_all_layers, lru_it});
     }
 
 
@@ -118,15 +146,12 @@ class OverwritableBlocksHashStore {
         auto it = m_blocks.find(hash);
         if (it == m_blocks.end())
         {
+            ++m_num_misses;
             return {};
         }
-        BlocksPerLayer blocks_for_all_layers = it->second;
-        for (auto& block_ptr : blocks_for_all_layers) {
-
-            block_ptr->set_timestamp(std::chrono::system_clock::now());
-            block_ptr->increment();
-        }
-        m_blocks.erase(it);
+        ++m_num_hits;
+        BlocksPerLayer blocks_for_all_layers = _pop(it);
+        _acquire(blocks_for_all_layers);
         return blocks_for_all_layers;
     }
 
@@ -140,17 +165,21 @@ class OverwritableBlocksHashStore {
         if (m_blocks.empty()) {
             return {};
         }
-        auto hash_and_blocks_for_all_layers = std::min_element(std::begin(m_blocks), std::end(m_blocks), [](const auto& lhs, const auto& rhs) -> bool { return lhs.second[0]->get_timestamp() < rhs.second[0]->get_timestamp(); });
-        auto blocks_for_all_layers = hash_and_blocks_for_all_layers->second;
-        auto timestamp = std::chrono::system_clock::now();
-        for (auto& block_ptr : blocks_for_all_layers) {
-            block_ptr->set_timestamp(timestamp);
-            block_ptr->increment();
-        }
-        m_blocks.erase(hash_and_blocks_for_all_layers->first);
+        BlocksPerLayer blocks_for_all_layers = _pop(m_blocks.find(m_lru_index.begin()->second));
+        _acquire(blocks_for_all_layers);
         return blocks_for_all_layers;
     }
 
+    /**
+     * Looks up KV cache blocks by their hash without removing them from the store.
+     * @param hash The hash value to look up in the store.
+     * @return A vector of KV cache blocks (one for each decoder layer) stored under this hash, or an empty vector if the hash is not found.
+     */
+    BlocksPerLayer find(size_t hash) const {
+        auto it = m_blocks.find(hash);
+        return it == m_blocks.end() ? BlocksPerLayer{} : it->second.blocks_for_all_layers;
+    }
+
     /**
      *
      * @return Number of blocks (per layer) currently in the store.
@@ -159,6 +188,34 @@ class OverwritableBlocksHashStore {
         return m_blocks.size();
     }
 
+    /**
+     * @return Number of `get_block_to_restore` lookups which found the requested hash in the store.
+     */
+    size_t num_hits() const {
+        return m_num_hits;
+    }
+
+    /**
+     * @return Number of `get_block_to_restore` lookups which did not find the requested hash in the store.
+     */
+    size_t num_misses() const {
+        return m_num_misses;
+    }
+
+    /**
+     * @param num_blocks Number of KV cache blocks to remain.
+     * @return Hashes of stored blocks, which have an index not less than `num_blocks` for any layer.
+     */
+    std::set<uint64_t> get_hashes_of_blocks_beyond(size_t num_blocks) const {
+        std::set<uint64_t> hashes;
+        for (const auto& [hash, stored_blocks] : m_blocks) {
+            const auto& blocks = stored_blocks.blocks_for_all_layers;
+            if (std::any_of(blocks.begin(), blocks.end(), [num_blocks](const KVCacheBlock::Ptr& block) { return block->get_index() >= num_blocks; }))
+                hashes.insert(hash);
+        }
+        return hashes;
+    }
+
     /**
      * @brief Removes blocks matching to the supplied hashes from the store
      * @param hashes_to_discard A set of hashes. For each hash, if it is present in the store, the corresponding block will be discarded
@@ -171,8 +228,7 @@ class OverwritableBlocksHashStore {
         for (uint64_t hash : hashes_to_discard) {
             auto it = m_blocks.find(hash);
             if (it != m_blocks.end()) {
-                retval.push_back(it->second);
-                m_blocks.erase(it);
+                retval.push_back(_pop(it));
             }
         }
         return retval;
@@ -180,6 +236,7 @@ class OverwritableBlocksHashStore {
 };
 
 class CacheStateDumper;
+class BinaryCacheStateDumper;
 
 /**
  * @brief Maintains a pool of KV cache block descriptors (layered as configured at initialization), freeing or allocating
@@ -192,6 +249,7 @@ class BlockAllocator {
     std::vector<size_t> m_free_blocks_num;
     size_t m_total_num_blocks;
     friend class CacheStateDumper;
+    friend class BinaryCacheStateDumper;
     size_t m_num_layers;
     bool m_enable_prefix_caching;
     ov::genai::OverwritableBlocksHashStore m_overwriteable_blocks;
@@ -237,6 +295,14 @@ public:
         return m_overwriteable_blocks.num_blocks();
     }
 
+    /**
+     * @return The store of KV cache blocks which are not owned by any sequence, but can be restored by their hash
+     * (prefix caching) or overwritten.
+     */
+    const OverwritableBlocksHashStore& get_overwriteable_blocks_store() const {
+        return m_overwriteable_blocks;
+    }
+
     /**
      * Returns a boolean describing whether a given number of blocks can be allocated, based on the number of currently
      * available free blocks.
@@ -451,6 +517,21 @@ public:
         return {};
     }
 
+    /**
+     * Looks up blocks corresponding to a given hash in the same manner as `get_cached_block`, but keeps them intact.
+     * @param hash The hash of the blocks to be looked up.
+     * @param cached_blocks The map of known hashes to already allocated and filled blocks.
+     * @return A vector of blocks (one for each layer) corresponding to this hash, or an empty vector if the hash is not found.
+     */
+    BlocksPerLayer find_cached_block(size_t hash, const std::map<uint64_t, BlocksPerLayer>& cached_blocks) const {
+        auto blocks_for_all_layers = m_overwriteable_blocks.find(hash);
+        if (!blocks_for_all_layers.empty()) {
+            return blocks_for_all_layers;
+        }
+        auto it = cached_blocks.find(hash);
+        return it == cached_blocks.end() ? BlocksPerLayer{} : it->second;
+    }
+
     /**
      * @return The percentage of the allocator's free block pool utilization.
      */
@@ -459,6 +540,49 @@ public:
         for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) sum += num_free_blocks(layer_idx);
         return static_cast<float>(m_num_layers * m_total_num_blocks - sum) / (m_num_layers * m_total_num_blocks) * 100;
     }
+
+    /**
+     * @return Number of KV cache blocks (per layer) in the pool owned by this allocator.
+     */
+    size_t get_total_number_of_kv_blocks() const {
+        return m_total_num_blocks;
+    }
+
+    /**
+     * Changes the size of the pool of blocks owned by this allocator. New blocks get subsequent indices and are free.
+     * When the pool is shrunk, blocks with indices beyond the new size must not be owned by any sequence;
+     * such blocks stored for prefix caching are discarded.
+     * @param num_blocks The new number of KV cache blocks (per layer).
+     */
+    void resize(size_t num_blocks) {
+        OPENVINO_ASSERT(num_blocks > 0, "Number of KV cache blocks must be non-zero");
+        if (num_blocks < m_total_num_blocks) {
+            for (auto& blocks_for_all_layers : m_overwriteable_blocks.clean_store(m_overwriteable_blocks.get_hashes_of_blocks_beyond(num_blocks))) {
+                for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+                    if (blocks_for_all_layers[layer_idx]->get_index() < num_blocks) {
+                        m_free_blocks[layer_idx].push_back(blocks_for_all_layers[layer_idx]);
+                        ++m_free_blocks_num[layer_idx];
+                    }
+                }
+            }
+            for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+                auto& free_blocks = m_free_blocks[layer_idx];
+                size_t num_free_blocks_before = m_free_blocks_num[layer_idx];
+                free_blocks.remove_if([num_blocks](const KVCacheBlock::Ptr& block) { return block->get_index() >= num_blocks; });
+                m_free_blocks_num[layer_idx] = free_blocks.size();
+                OPENVINO_ASSERT(num_free_blocks_before - m_free_blocks_num[layer_idx] == m_total_num_blocks - num_blocks,
+                                "KV cache blocks being removed are still in use");
+            }
+        } else {
+            for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+                for (size_t block_id = m_total_num_blocks; block_id < num_blocks; ++block_id) {
+                    m_free_blocks[layer_idx].push_back(std::make_shared<KVCacheBlock>(block_id));
+                }
+                m_free_blocks_num[layer_idx] += num_blocks - m_total_num_blocks;
+            }
+        }
+        m_total_num_blocks = num_blocks;
+    }
 };
 
 /**
@@ -469,18 +593,151 @@ public:
  */
 class BlockManager {
     friend class CacheStateDumper;
+    friend class BinaryCacheStateDumper;
     BlockAllocator m_allocator;
     bool m_enable_prefix_caching;
     size_t m_block_size;
     size_t m_num_layers;
-    // TODO: caching time can probably be improved if we use the prefix tree
     std::map<uint64_t, BlocksPerLayer> m_prefix_hash_to_occupied_block_map;
 
     // stores blocks for each sequence (not sequence group)
     // the same block can be seen in multiple block_tables for different sequences
     std::map<uint64_t, std::vector<BlocksPerLayer>> m_block_table;
 
+    // whether sequences sharing a partially filled last block keep sharing it until their generated tokens differ
+    bool m_enable_lazy_copy_on_write = false;
+
+    // number of blocks beyond the logical ones, which a sequence keeps after its tokens are rolled back, e.g. rejected
+    // speculative candidates, so that the next candidates reuse them instead of allocating blocks again
+    size_t m_num_reserved_tail_blocks = 0;
+
+    // host memory blocks, where KV cache of swapped out sequences is stored
+    BlockAllocator m_swap_allocator;
+    // stores swapped out blocks for each sequence, in the same manner as m_block_table
+    std::map<uint64_t, std::vector<BlocksPerLayer>> m_swapped_block_table;
+    // swap blocks, which were swapped in, but whose contents are not copied to device yet, so they cannot be reused
+    std::vector<BlocksPerLayer> m_swap_blocks_to_release;
+
+    // index of the prefix cached blocks contents, which allows to find the longest cached prefix of a prompt in one traversal
+    PrefixTree m_prefix_tree;
+    struct PrefixTreeCursor {
+        // the last node registered for the fully filled blocks of a sequence and the number of such blocks
+        std::weak_ptr<PrefixTree::Node> last_full_block;
+        size_t num_full_blocks = 0;
+        // the node registered for the partially filled last block of a sequence
+        std::weak_ptr<PrefixTree::Node> last_partial_block;
+    };
+    std::map<uint64_t, PrefixTreeCursor> m_prefix_tree_cursors;
+    // sequences whose last block was partially restored from the prefix cache and may need to be copied before being appended to
+    std::set<uint64_t> m_sequences_to_copy_on_write;
+
+    // hashes of the blocks available in the persistent prefix cache storage
+    std::unordered_set<size_t> m_persistent_hashes;
+    struct PendingPersistentRestore {
+        // matched prefix tree nodes which were not found in KV cache, but may be loaded from the persistent storage
+        std::vector<PrefixTree::Match> matches;
+        size_t num_restored_tokens;
+    };
+    std::map<uint64_t, PendingPersistentRestore> m_pending_persistent_restores;
+
+    // prompt tokens looked up in the prefix cache and the ones restored from it, reported by pipeline metrics
+    size_t m_num_prefix_cache_queried_tokens = 0;
+    size_t m_num_prefix_cache_hit_tokens = 0;
+
+    // guards the prefix tree and cached blocks of the allocator, which are read by threads adding requests, see get_num_prefix_cached_tokens
     std::mutex m_cached_blocks_map_mutex;
+
+    static void _get_tokens(TokenIds& tokens, const TokenIds& prompt_ids, const TokenIds& generated_ids, size_t begin, size_t end) {
+        tokens.clear();
+        for (size_t token_idx = begin; token_idx < end; ++token_idx) {
+            tokens.push_back(token_idx < prompt_ids.size() ? prompt_ids[token_idx] : generated_ids[token_idx - prompt_ids.size()]);
+        }
+    }
+
+    // methods below change cached blocks of the allocator on the step thread, while m_cached_blocks_map_mutex is not held by the caller
+    void _free_blocks(const BlocksPerLayer& blocks) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        m_allocator.free(blocks);
+    }
+
+    BlocksPerLayer _allocate_cached_block(size_t hash) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        return m_allocator.allocate_block(hash, m_prefix_hash_to_occupied_block_map);
+    }
+
+    // moves blocks, which are used by a single sequence, to the hash of their new contents
+    void _rehash_blocks(const BlocksPerLayer& blocks, size_t hash) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        m_prefix_hash_to_occupied_block_map.erase(blocks[0]->get_hash());
+        for (const auto& block : blocks) {
+            block->set_hash(hash);
+        }
+        m_prefix_hash_to_occupied_block_map[hash] = blocks;
+    }
+
+    // registers contents of the sequence blocks in the prefix tree up to a given content length
+    void _update_prefix_tree(Sequence::Ptr sequence, const TokenIds& prompt_ids, size_t content_length) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        const TokenIds& generated_ids = sequence->get_generated_ids();
+        content_length = std::min(content_length, prompt_ids.size() + generated_ids.size());
+
+        auto& cursor = m_prefix_tree_cursors[sequence->get_id()];
+        PrefixTree::NodePtr parent = cursor.last_full_block.lock();
+        if (!parent) {
+            // nodes could be evicted from the tree; the path is restored starting from the root in such case
+            cursor.num_full_blocks = 0;
+        }
+
+        TokenIds block_tokens;
+        block_tokens.reserve(m_block_size);
+        for (size_t num_full_blocks = content_length / m_block_size; cursor.num_full_blocks < num_full_blocks; ++cursor.num_full_blocks) {
+            size_t begin = cursor.num_full_blocks * m_block_size, end = begin + m_block_size;
+            _get_tokens(block_tokens, prompt_ids, generated_ids, begin, end);
+            parent = m_prefix_tree.insert(parent, block_tokens.begin(), block_tokens.end(), sequence->get_hash(end));
+        }
+        cursor.last_full_block = parent;
+
+        // partially filled block changes its contents and hash each time a token is appended
+        m_prefix_tree.erase(cursor.last_partial_block.lock());
+        cursor.last_partial_block.reset();
+        if (content_length % m_block_size != 0) {
+            _get_tokens(block_tokens, prompt_ids, generated_ids, content_length - content_length % m_block_size, content_length);
+            cursor.last_partial_block = m_prefix_tree.insert(parent, block_tokens.begin(), block_tokens.end(), sequence->get_hash(content_length));
+        }
+    }
+
+    // frees physical blocks beyond the logical ones in running sequences of the group, but keeps up to num_kept_blocks of them,
+    // which are used by the sequence only
+    void _free_tail_blocks(SequenceGroup::Ptr seq_group, size_t num_kept_blocks) {
+        size_t num_logical_blocks = seq_group->get_num_logical_blocks();
+        if (num_logical_blocks == 0) {
+            return;
+        }
+        for (const auto& sequence : seq_group->get_running_sequences()) {
+            auto seq_id = sequence->get_id();
+            if (m_block_table.find(seq_id) == m_block_table.end()) {
+                // e.g. sequence is swapped out
+                continue;
+            }
+            auto& block_table = m_block_table[seq_id];
+            size_t num_physical_blocks = block_table[0].size();
+            if (num_physical_blocks <= num_logical_blocks) {
+                continue;
+            }
+            size_t num_tail_blocks = num_physical_blocks - num_logical_blocks;
+            size_t num_reserved_blocks = 0;
+            // appending to a shared last block requires its copy, which is handled only without reserved blocks
+            bool can_keep_blocks = !block_table[0][num_logical_blocks - 1]->copy_on_write();
+            // blocks are kept from the lowest logical index, so that the reserve stays contiguous with the sequence
+            while (can_keep_blocks && num_reserved_blocks < std::min(num_tail_blocks, num_kept_blocks) &&
+                   !block_table[0][num_logical_blocks + num_reserved_blocks]->copy_on_write()) {
+                ++num_reserved_blocks;
+            }
+            if (num_tail_blocks > num_reserved_blocks) {
+                free_sequence_partially(seq_id, num_tail_blocks - num_reserved_blocks);
+            }
+        }
+    }
 public:
     /**
      * Constructs the BlockManager.
@@ -490,11 +747,16 @@ public:
      * @param block_size The size of an individual KV cache block in tokens.
      * @param num_layers The number of separate attention layers with KV caches in the LLM associated with the pipeline.
      * In current implementation each layer must have the same number of logical blocks allocated at all times.
+     * @param num_swap_blocks Number of KV cache blocks in host memory available to store swapped out sequences.
      */
-    BlockManager(int num_blocks, bool enable_prefix_caching, size_t block_size, size_t num_layers = 1)
+    BlockManager(int num_blocks, bool enable_prefix_caching, size_t block_size, size_t num_layers = 1, size_t num_swap_blocks = 0,
+                 bool enable_lazy_copy_on_write = false)
         : m_allocator(num_blocks, enable_prefix_caching, num_layers), m_enable_prefix_caching(enable_prefix_caching), m_block_size(block_size),
-        m_num_layers(num_layers) {
+        m_num_layers(num_layers), m_swap_allocator(num_swap_blocks, false, num_layers),
+        m_prefix_tree(block_size, std::max(2 * static_cast<size_t>(num_blocks), size_t(1))) {
         OPENVINO_ASSERT(num_layers != 0, "num_layers must be non-zero");
+        // with prefix caching, copies of shared blocks are deduplicated by hash instead
+        m_enable_lazy_copy_on_write = enable_lazy_copy_on_write && !enable_prefix_caching;
     }
 
     ~BlockManager() {
@@ -570,7 +832,7 @@ public:
         for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
             blocks_to_free.push_back(block_table[layer_idx].back());
         }
-        m_allocator.free(blocks_to_free);
+        _free_blocks(blocks_to_free);
         for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
             block_table[layer_idx].resize(block_table[layer_idx].size() - 1);
         }
@@ -618,10 +880,10 @@ public:
 
     /**
      * @param seq_id The identifier of an ov::genai::Sequence
-     * @return Whether or not this BlockManager is managing this sequence group.
+     * @return Whether or not this BlockManager is managing this sequence group (either in device or in swap memory).
      */
     const bool has_block_table(uint64_t seq_id) {
-        return m_block_table.count(seq_id) > 0;
+        return m_block_table.count(seq_id) > 0 || m_swapped_block_table.count(seq_id) > 0;
     }
 
     /**
@@ -631,6 +893,13 @@ public:
         return m_allocator.num_free_blocks(0); // relying on the invariant that all layers have identical number of blocks
     }
 
+    /**
+     * @return The number of free KV cache blocks, which hold contents of finished sequences for prefix caching.
+     */
+    size_t num_cached_blocks() const {
+        return m_allocator.num_overwriteable_blocks();
+    }
+
     /**
      * @param num_blocks A number of KV cache blocks
      * @return Whether this number of KV cache blocks may be assigned to new sequences.
@@ -679,17 +948,13 @@ public:
             if (block_table.size() > 0) {
                 KVCacheBlock::Ptr last_block = block_table.back();
                 auto hash = sequence->get_hash(block_table.size() * m_block_size);
-                auto prev_hash = last_block->get_hash();
-                if (prev_hash != hash) {
+                if (last_block->get_hash() != hash) {
                     BlocksPerLayer last_blocks_vec;
                     last_blocks_vec.reserve(m_num_layers);
                     for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
-                        auto& lst_blk = m_block_table[sequence_id][layer_idx].back();
-                        lst_blk->set_hash(hash);
-                        m_prefix_hash_to_occupied_block_map.erase(prev_hash);
-                        last_blocks_vec.push_back(lst_blk);
+                        last_blocks_vec.push_back(m_block_table[sequence_id][layer_idx].back());
                     }
-                    m_prefix_hash_to_occupied_block_map[hash] = last_blocks_vec;
+                    _rehash_blocks(last_blocks_vec, hash);
                 }
             }
             for (size_t i = 0; i < num_blocks; ++i) {
@@ -698,11 +963,12 @@ public:
                     num_hashed_tokens = content_length;
                 }
                 auto hash = sequence->get_hash(num_hashed_tokens);
-                auto blocks_for_all_layers = m_allocator.allocate_block(hash, m_prefix_hash_to_occupied_block_map);
+                auto blocks_for_all_layers = _allocate_cached_block(hash);
                 for (size_t layer_idx = 0; layer_idx < blocks_for_all_layers.size(); layer_idx++) {
                     m_block_table[sequence_id][layer_idx].push_back(blocks_for_all_layers[layer_idx]);
                 }
             }
+            _update_prefix_tree(sequence, prompt_ids, num_hashed_tokens);
         }
     }
 
@@ -713,6 +979,37 @@ public:
         return m_allocator.get_used_percentage();
     }
 
+    /**
+     * @return Number of KV cache blocks (per layer) currently available to sequences.
+     */
+    size_t get_total_number_of_kv_blocks() const {
+        return m_allocator.get_total_number_of_kv_blocks();
+    }
+
+    /**
+     * @return The smallest number of KV cache blocks (per layer), to which the pool can be shrunk without losing blocks owned by sequences.
+     */
+    size_t get_min_number_of_kv_blocks() const {
+        size_t num_blocks = 1;
+        for (const auto& [seq_id, block_table] : m_block_table) {
+            for (const auto& blocks : block_table) {
+                for (const auto& block : blocks) {
+                    num_blocks = std::max(num_blocks, block->get_index() + 1);
+                }
+            }
+        }
+        return num_blocks;
+    }
+
+    /**
+     * Changes the number of KV cache blocks available to sequences, see BlockAllocator::resize.
+     * @param num_blocks The new number of KV cache blocks (per layer).
+     */
+    void resize(size_t num_blocks) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        m_allocator.resize(num_blocks);
+    }
+
     /**
      * @brief Forks a sequence, establishing a new sequence from an existing one, reusing
      * currently allocated blocks of the existing sequence.
@@ -722,6 +1019,14 @@ public:
      */
     void fork_sequence(uint64_t parent_id, uint64_t child_id) {
         OPENVINO_ASSERT(m_block_table.count(child_id) == 0);
+        if (m_enable_prefix_caching) {
+            const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+            auto cursor_it = m_prefix_tree_cursors.find(parent_id);
+            if (cursor_it != m_prefix_tree_cursors.end()) {
+                // partially filled block of the parent is not inherited, since the child appends different tokens to it
+                m_prefix_tree_cursors[child_id] = {cursor_it->second.last_full_block, cursor_it->second.num_full_blocks, {}};
+            }
+        }
         m_block_table[child_id].resize(m_num_layers);
         for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
             m_block_table[child_id][layer_idx].reserve(m_block_table[parent_id][layer_idx].size());
@@ -737,6 +1042,24 @@ public:
      * @param seq_id Identifier of the sequence to free.
      */
     void free_sequence(size_t seq_id) {
+        if (m_enable_prefix_caching) {
+            const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+            m_prefix_tree_cursors.erase(seq_id);
+            m_sequences_to_copy_on_write.erase(seq_id);
+            m_pending_persistent_restores.erase(seq_id);
+        }
+
+        auto swapped_it = m_swapped_block_table.find(seq_id);
+        if (swapped_it != m_swapped_block_table.end()) {
+            for (size_t layer_idx = 0; layer_idx < swapped_it->second.size(); layer_idx++) {
+                for (auto& block : swapped_it->second[layer_idx]) {
+                    m_swap_allocator.free(block, layer_idx);
+                }
+            }
+            m_swapped_block_table.erase(swapped_it);
+            return;
+        }
+
         OPENVINO_ASSERT(m_block_table.find(seq_id) != m_block_table.end(), "sequence with id ", seq_id,
                         " not found in BlockManager, but requested to free");
         auto& block_table = m_block_table[seq_id];
@@ -748,7 +1071,7 @@ public:
             for (size_t layer_idx = 0; layer_idx < effective_num_layers; layer_idx++) {
                blocks_to_free.push_back(block_table[layer_idx][i]);
             }
-            m_allocator.free(blocks_to_free);
+            _free_blocks(blocks_to_free);
         }
 
         OPENVINO_ASSERT(m_block_table.erase(seq_id) == 1);
@@ -776,7 +1099,7 @@ public:
                 size_t block_idx = layer_block_table.size() - idx - 1;
                 blocks_to_free.push_back(layer_block_table[block_idx]);
             }
-            m_allocator.free(blocks_to_free);
+            _free_blocks(blocks_to_free);
         }
 
         for (size_t layer_idx = 0; layer_idx < effective_num_layers; layer_idx++) {
@@ -835,7 +1158,7 @@ public:
                 auto block = per_layer_block_table[logical_block_idx];
                 per_layer_cache_blocks_to_free.push_back(block);
             }
-            m_allocator.free(per_layer_cache_blocks_to_free);
+            _free_blocks(per_layer_cache_blocks_to_free);
         }
 
         // remove freed entries from the block table at this BlockManager's level
@@ -865,6 +1188,27 @@ public:
         return required_blocks_count(std::move(seq_group)) <= m_allocator.num_free_blocks(0);
     }
 
+    /**
+     * @param running_sequences Running sequences of a sequence group.
+     * @param last_block_id Index of a partially filled block shared by some of the sequences as their last block.
+     * @return Number of copies of the block, which are not needed in lazy copy-on-write mode, since several sequences
+     * sharing the block have the same content.
+     */
+    size_t _get_num_copies_saved_by_lazy_copy_on_write(const std::vector<Sequence::CPtr>& running_sequences, size_t last_block_id) {
+        if (!m_enable_lazy_copy_on_write)
+            return 0;
+        size_t num_sharing_sequences = 0;
+        std::set<TokenIds> contents;
+        for (const auto& seq : running_sequences) {
+            auto it = m_block_table.find(seq->get_id());
+            if (it == m_block_table.end() || it->second[0].empty() || it->second[0].back()->get_index() != last_block_id)
+                continue;
+            ++num_sharing_sequences;
+            contents.insert(seq->get_generated_ids());
+        }
+        return num_sharing_sequences - contents.size();
+    }
+
     /**
      * @param seq_group Pointer to a sequence group.
      * @return The number of blocks necessary to host the sequences in the group, excluding the already
@@ -909,7 +1253,8 @@ public:
 
                 if (needed_blocks_per_sequence == 0) {
                     // case when last block is not completely filled and needs to be copied n - 1 times, where n - references count
-                    blocks_count += references_count - 1;
+                    // in lazy mode, running sequences with the same content share a single copy
+                    blocks_count += references_count - 1 - _get_num_copies_saved_by_lazy_copy_on_write(running_sequences, last_block_id);
                 }
                 else {
                     blocks_count += needed_blocks_per_sequence * references_count;
@@ -924,25 +1269,47 @@ public:
     }
 
     /**
-     * Clean up not busy physical KV cache blocks in a sequence group.
+     * Sets the number of tail blocks kept by free_empty_physical_blocks() beyond the logical blocks of a sequence.
+     * Reserved blocks are kept only by groups with a single running sequence, whose blocks are not shared, and never with prefix caching,
+     * since hashes of the reserved blocks are not valid anymore.
+     * @param num_reserved_tail_blocks Maximum number of reserved blocks per sequence.
+     */
+    void set_num_reserved_tail_blocks(size_t num_reserved_tail_blocks) {
+        m_num_reserved_tail_blocks = m_enable_prefix_caching ? 0 : num_reserved_tail_blocks;
+    }
+
+    /**
+     * Clean up not busy physical KV cache blocks in a sequence group, except for reserved tail blocks.
      * @param seq_group Pointer to a sequence group.
      */
     void free_empty_physical_blocks(SequenceGroup::Ptr seq_group) {
-        size_t num_logical_blocks = seq_group->get_num_logical_blocks();
-        if (num_logical_blocks == 0) {
-            return;
-        }
-        for (const auto& sequence : seq_group->get_running_sequences()) {
-            auto seq_id = sequence->get_id();
-            auto& block_table = m_block_table[seq_id];
-            size_t num_physical_blocks = block_table[0].size();
-            if (num_physical_blocks > num_logical_blocks) {
-                free_sequence_partially(seq_id, num_physical_blocks - num_logical_blocks);
+        _free_tail_blocks(seq_group, seq_group->num_running_seqs() == 1 ? m_num_reserved_tail_blocks : 0);
+    }
+
+    /**
+     * Frees reserved tail blocks of a sequence group, e.g. when KV cache is exhausted and other groups need the blocks.
+     * @param seq_group Pointer to a sequence group.
+     */
+    void free_reserved_tail_blocks(SequenceGroup::Ptr seq_group) {
+        _free_tail_blocks(seq_group, 0);
+    }
+
+    /**
+     * @return Whether any sequence keeps more physical blocks than logical ones.
+     */
+    bool has_reserved_tail_blocks(const std::vector<SequenceGroup::Ptr>& seq_groups) const {
+        if (m_num_reserved_tail_blocks == 0)
+            return false;
+        for (const auto& seq_group : seq_groups) {
+            for (const auto& sequence : seq_group->get_running_sequences()) {
+                auto it = m_block_table.find(sequence->get_id());
+                if (it != m_block_table.end() && it->second[0].size() > seq_group->get_num_logical_blocks())
+                    return true;
             }
         }
+        return false;
     }
 
-
     /**
      * Allocates just enough physical KV cache blocks to a sequence group to be enough for the sequences in it. If the sequences
      * in the group were forked before and their last block is a copy-on-write, then the block contents will have to be copied separately
@@ -958,6 +1325,9 @@ public:
         std::vector<Sequence::Ptr> running_sequences = seq_group->get_running_sequences();
 
         std::map<size_t, std::list<size_t>> copy_blocks_map;
+        // for each shared last block in lazy copy-on-write mode: sequences whose contents were already placed
+        // and the blocks they use, the first content keeps the original block
+        std::map<size_t, std::vector<std::pair<Sequence::Ptr, BlocksPerLayer>>> last_block_contents;
         for (size_t i = 0; i < running_sequences.size(); ++i) {
             Sequence::Ptr sequence = running_sequences[i];
             auto seq_id = sequence->get_id();
@@ -970,7 +1340,11 @@ public:
 
             if (num_logical_blocks > num_physical_blocks) {
                 OPENVINO_ASSERT(can_allocate_blocks(num_logical_blocks - num_physical_blocks));
-                allocate(sequence, num_logical_blocks - num_physical_blocks, seq_group->get_prompt_ids());
+                allocate(sequence, num_logical_blocks - num_physical_blocks, seq_group->get_prompt_cache_ids());
+            } else if (num_logical_blocks < num_physical_blocks) {
+                // reserved tail blocks host new tokens, such blocks are kept only when they and the last logical block are not shared
+                OPENVINO_ASSERT(!m_block_table[seq_id][0][num_logical_blocks - 1]->copy_on_write(),
+                                "Sequence with reserved tail blocks must not share its last logical block");
             } else {
                 OPENVINO_ASSERT(num_logical_blocks == num_physical_blocks, "A number of physical and logic blocks must be the same in this code path");
 
@@ -983,12 +1357,36 @@ public:
 
                 bool is_copy_on_write = last_blocks[0]->copy_on_write();
 
+                if (is_copy_on_write && m_enable_lazy_copy_on_write) {
+                    // KV cache depends on tokens only, so sequences with the same generated tokens can keep sharing the block
+                    auto& contents = last_block_contents[last_blocks[0]->get_index()];
+                    auto content_it = std::find_if(contents.begin(), contents.end(), [&sequence] (const auto& content) {
+                        return content.first->get_generated_ids() == sequence->get_generated_ids();
+                    });
+                    if (content_it == contents.end() && contents.empty()) {
+                        contents.emplace_back(sequence, last_blocks);
+                        continue;
+                    }
+                    if (content_it != contents.end()) {
+                        if (content_it->second != last_blocks) {
+                            // the content was already copied, share the copy
+                            for (size_t i = 0; i < effective_num_layers; i++) {
+                                content_it->second[i]->increment();
+                                m_block_table[seq_id][i][num_physical_blocks - 1] = content_it->second[i];
+                            }
+                            _free_blocks(last_blocks);
+                        }
+                        continue;
+                    }
+                }
+
                 if (is_copy_on_write) {
                     BlocksPerLayer new_blocks_for_all_layers;
                     new_blocks_for_all_layers.reserve(effective_num_layers);
                     if (m_enable_prefix_caching) {
                         auto hash = sequence->get_hash();
-                        new_blocks_for_all_layers = m_allocator.allocate_block(hash, m_prefix_hash_to_occupied_block_map);
+                        new_blocks_for_all_layers = _allocate_cached_block(hash);
+                        _update_prefix_tree(sequence, seq_group->get_prompt_cache_ids(), seq_group->get_context_len());
                     } else {
                         for (size_t i = 0; i < effective_num_layers; i++) {
                             new_blocks_for_all_layers.push_back(m_allocator.allocate_block(i));
@@ -1002,19 +1400,16 @@ public:
                         auto& last_block = last_blocks[i];
                         copy_blocks_map[last_block->get_index()].push_back(new_block->get_index());
                     }
-                    m_allocator.free(last_blocks);
+                    if (m_enable_lazy_copy_on_write) {
+                        last_block_contents[last_blocks[0]->get_index()].emplace_back(sequence, new_blocks_for_all_layers);
+                    }
+                    _free_blocks(last_blocks);
                 } else {
                     // we are the only users of this block
                     if (m_enable_prefix_caching) {
                         // update hash of block
-                        auto prev_hash = last_blocks[0]->get_hash();
-                        auto hash = sequence->get_hash();
-                        for (size_t i = 0; i < effective_num_layers; i++) {
-                            auto& last_block = last_blocks[i];
-                            last_block->set_hash(hash);
-                        }
-                        m_prefix_hash_to_occupied_block_map.erase(prev_hash);
-                        m_prefix_hash_to_occupied_block_map[hash] = last_blocks;
+                        _rehash_blocks(last_blocks, sequence->get_hash());
+                        _update_prefix_tree(sequence, seq_group->get_prompt_cache_ids(), seq_group->get_context_len());
                     }
                 }
             }
@@ -1024,11 +1419,154 @@ public:
         return copy_blocks_map;
     }
 
+    /**
+     * @param seq_group Pointer to a sequence group.
+     * @return Whether KV cache blocks of the sequence group are currently stored in swap memory.
+     */
+    bool is_swapped_out(SequenceGroup::CPtr seq_group) const {
+        for (const auto& sequence : seq_group->get_sequences()) {
+            if (m_swapped_block_table.count(sequence->get_id()) > 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @param seq_group Pointer to a sequence group.
+     * @return Whether swap memory has enough free blocks to host all device blocks of the sequence group.
+     */
+    bool can_swap_out(SequenceGroup::Ptr seq_group) {
+        size_t num_blocks = get_number_of_blocks_occupied_by_sequence(seq_group);
+        return num_blocks > 0 && m_swap_allocator.can_allocate_blocks(num_blocks);
+    }
+
+    /**
+     * @param seq_group Pointer to a swapped out sequence group.
+     * @param num_reserved_blocks Number of free blocks, which have to be kept for other sequence groups.
+     * @return Whether device KV cache has enough free blocks to host all swapped out blocks of the sequence group and a block
+     * for the next token of each its running sequence, so that the group is not preempted back right after it is swapped in.
+     */
+    bool can_swap_in(SequenceGroup::Ptr seq_group, size_t num_reserved_blocks = 0) {
+        return can_allocate_blocks(get_number_of_swapped_blocks(seq_group) + seq_group->num_running_seqs() + num_reserved_blocks);
+    }
+
+    /**
+     * @param seq_group Pointer to a sequence group.
+     * @return The number of distinct swap blocks occupied by swapped out sequences of the sequence group.
+     */
+    size_t get_number_of_swapped_blocks(SequenceGroup::Ptr seq_group) {
+        std::set<size_t> indices;
+        for (const auto& sequence : seq_group->get_not_finished_sequences()) {
+            auto it = m_swapped_block_table.find(sequence->get_id());
+            if (it == m_swapped_block_table.end())
+                continue;
+            for (const auto& block : it->second[0]) {
+                indices.insert(block->get_index());
+            }
+        }
+        return indices.size();
+    }
+
+    /**
+     * Moves all blocks of not finished sequences in a group from device KV cache to swap memory. Blocks shared between
+     * sequences within the group remain shared in swap memory. Device blocks are freed.
+     * @param seq_group Pointer to a sequence group.
+     * @return Per-layer maps of *physical* device block index -> swap block index, which contents should be copied by CacheManager.
+     */
+    std::vector<std::map<size_t, size_t>> swap_out(SequenceGroup::Ptr seq_group) {
+        OPENVINO_ASSERT(!m_enable_prefix_caching, "Swapping is not supported together with prefix caching");
+        OPENVINO_ASSERT(can_swap_out(seq_group));
+
+        std::vector<std::map<size_t, size_t>> swap_map(m_num_layers);
+        std::vector<std::map<size_t, KVCacheBlock::Ptr>> device_to_swap_blocks(m_num_layers);
+        for (const auto& sequence : seq_group->get_not_finished_sequences()) {
+            auto seq_id = sequence->get_id();
+            if (m_block_table.find(seq_id) == m_block_table.end())
+                continue;
+
+            std::vector<BlocksPerLayer> swapped_block_table(m_num_layers);
+            for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+                for (const auto& block : m_block_table[seq_id][layer_idx]) {
+                    auto it = device_to_swap_blocks[layer_idx].find(block->get_index());
+                    KVCacheBlock::Ptr swap_block;
+                    if (it == device_to_swap_blocks[layer_idx].end()) {
+                        swap_block = m_swap_allocator.allocate_block(layer_idx);
+                        device_to_swap_blocks[layer_idx][block->get_index()] = swap_block;
+                        swap_map[layer_idx][block->get_index()] = swap_block->get_index();
+                    } else {
+                        swap_block = it->second;
+                        swap_block->increment();
+                    }
+                    swapped_block_table[layer_idx].push_back(swap_block);
+                }
+            }
+            // release device blocks before the sequence is registered as swapped out
+            free_sequence(seq_id);
+            m_swapped_block_table[seq_id] = std::move(swapped_block_table);
+        }
+        return swap_map;
+    }
+
+    /**
+     * Moves all blocks of a swapped out sequence group back to device KV cache. Swap blocks are freed by a
+     * subsequent `release_swapped_in_blocks` call, once their contents are copied to device.
+     * @param seq_group Pointer to a swapped out sequence group.
+     * @return Per-layer maps of swap block index -> *physical* device block index, which contents should be copied by CacheManager.
+     */
+    std::vector<std::map<size_t, size_t>> swap_in(SequenceGroup::Ptr seq_group) {
+        OPENVINO_ASSERT(can_swap_in(seq_group));
+
+        std::vector<std::map<size_t, size_t>> swap_map(m_num_layers);
+        std::vector<std::map<size_t, KVCacheBlock::Ptr>> swap_to_device_blocks(m_num_layers);
+        m_swap_blocks_to_release.resize(m_num_layers);
+        for (const auto& sequence : seq_group->get_not_finished_sequences()) {
+            auto seq_id = sequence->get_id();
+            auto swapped_it = m_swapped_block_table.find(seq_id);
+            if (swapped_it == m_swapped_block_table.end())
+                continue;
+
+            OPENVINO_ASSERT(m_block_table.find(seq_id) == m_block_table.end());
+            auto& block_table = m_block_table[seq_id];
+            block_table.resize(m_num_layers);
+            for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+                for (auto& swap_block : swapped_it->second[layer_idx]) {
+                    auto it = swap_to_device_blocks[layer_idx].find(swap_block->get_index());
+                    KVCacheBlock::Ptr block;
+                    if (it == swap_to_device_blocks[layer_idx].end()) {
+                        block = m_allocator.allocate_block(layer_idx);
+                        swap_to_device_blocks[layer_idx][swap_block->get_index()] = block;
+                        swap_map[layer_idx][swap_block->get_index()] = block->get_index();
+                    } else {
+                        block = it->second;
+                        block->increment();
+                    }
+                    block_table[layer_idx].push_back(block);
+                    m_swap_blocks_to_release[layer_idx].push_back(swap_block);
+                }
+            }
+            m_swapped_block_table.erase(swapped_it);
+        }
+        return swap_map;
+    }
+
+    /**
+     * Returns swap blocks of sequences swapped in by previous `swap_in` calls back to the swap pool.
+     * Must be called only after all swap-in maps returned before are consumed.
+     */
+    void release_swapped_in_blocks() {
+        for (size_t layer_idx = 0; layer_idx < m_swap_blocks_to_release.size(); layer_idx++) {
+            for (auto& swap_block : m_swap_blocks_to_release[layer_idx]) {
+                m_swap_allocator.free(swap_block, layer_idx);
+            }
+        }
+        m_swap_blocks_to_release.clear();
+    }
+
     void restore_cached_blocks(SequenceGroup::Ptr group) {
         // When add_request() is executed in multiple threads accessing to cached_blocks causes segfault.
         // The mutex is needed to prevent such segfaults.
         const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
-        auto prompt_ids = group->get_prompt_ids();
+        auto prompt_ids = group->get_prompt_cache_ids();
         auto sequences = group->get_not_finished_sequences();
         OPENVINO_ASSERT(sequences.size() == 1);
         auto sequence = sequences[0];
@@ -1040,48 +1578,289 @@ public:
         auto& block_table = m_block_table[seq_id];
 
         size_t content_len = 0;
-        while (content_len < prompt_ids.size()) {
-            size_t prev_iteration_content_len = content_len;
-            content_len += m_block_size;
-            if (content_len > prompt_ids.size()) {
-                content_len = prompt_ids.size();
+        auto matches = m_prefix_tree.match(prompt_ids);
+        for (size_t match_idx = 0; match_idx < matches.size(); ++match_idx) {
+            const auto& match = matches[match_idx];
+            auto blocks = m_allocator.get_cached_block(match.node->get_hash(), m_prefix_hash_to_occupied_block_map);
+            if (blocks.empty()) {
+                if (m_persistent_hashes.count(match.node->get_hash()) > 0) {
+                    // loading from the persistent storage requires allocation of new blocks, which is done by the scheduler
+                    m_pending_persistent_restores[seq_id] = {{matches.begin() + match_idx, matches.end()}, content_len};
+                } else {
+                    // blocks were overwritten, so the node and its descendants do not correspond to cached contents anymore
+                    m_prefix_tree.erase(match.node);
+                }
+                break;
             }
-            // restore fully filled blocks
-            auto full_block_hash = sequence->get_hash(content_len);
-            auto blocks = m_allocator.get_cached_block(full_block_hash, m_prefix_hash_to_occupied_block_map);
+
             auto timestamp = std::chrono::system_clock::now();
-            if (!blocks.empty()) {
-                for (size_t layer_idx = 0; layer_idx < block_table.size(); layer_idx++) {
-                    auto& block = blocks[layer_idx];
-                    block->set_timestamp(timestamp);
-                    block_table[layer_idx].push_back(block);
-                }
-                group->update_processed_tokens_num(content_len == prompt_ids.size() ? content_len - 1 : content_len);
-            } else {
-            // restore partially filled block
-                for (size_t i = 1; i < m_block_size; i++) {
-                    if (prev_iteration_content_len + i > prompt_ids.size()) {
-                        break;
-                    }
-                    auto hash = sequence->get_hash(prev_iteration_content_len + i);
-                    auto blocks = m_allocator.get_cached_block(hash, m_prefix_hash_to_occupied_block_map);
-                    if (!blocks.empty()) {
-                        auto timestamp = std::chrono::system_clock::now();
-
-                        for (size_t layer_idx = 0; layer_idx < block_table.size(); layer_idx++) {
-                            auto& block = blocks[layer_idx];
-                            block->set_timestamp(timestamp);
-                            block_table[layer_idx].push_back(block);
-                        }
+            for (size_t layer_idx = 0; layer_idx < block_table.size(); layer_idx++) {
+                auto& block = blocks[layer_idx];
+                block->set_timestamp(timestamp);
+                block_table[layer_idx].push_back(block);
+            }
+            content_len += match.num_matched_tokens;
+
+            if (match.num_matched_tokens < m_block_size) {
+                // partially matched block will be appended with the rest of the prompt, so it is copied to a block owned by the sequence
+                m_sequences_to_copy_on_write.insert(seq_id);
+            }
+        }
 
-                        group->update_processed_tokens_num(prev_iteration_content_len + i == prompt_ids.size() ? prev_iteration_content_len + i - 1 : prev_iteration_content_len + i);
+        if (content_len > 0) {
+            group->update_processed_tokens_num(content_len == prompt_ids.size() ? content_len - 1 : content_len);
+        }
+        m_num_prefix_cache_queried_tokens += prompt_ids.size();
+        m_num_prefix_cache_hit_tokens += content_len;
+    }
 
-                        break;
-                    }
+    /**
+     * @return Number of prompt tokens looked up in the prefix cache by restore_cached_blocks() during the lifetime of the block manager.
+     */
+    size_t get_num_prefix_cache_queried_tokens() const {
+        return m_num_prefix_cache_queried_tokens;
+    }
+
+    /**
+     * @return Number of prompt tokens restored from the prefix cache by restore_cached_blocks() during the lifetime of the block manager.
+     */
+    size_t get_num_prefix_cache_hit_tokens() const {
+        return m_num_prefix_cache_hit_tokens;
+    }
+
+    /**
+     * Looks up how many leading tokens of a prompt could be restored from the prefix cache, without restoring them.
+     * @param tokens The prompt tokens.
+     * @return Number of leading prompt tokens, whose KV cache values are present in KV cache or in the persistent prefix cache storage.
+     */
+    size_t get_num_prefix_cached_tokens(const TokenIds& tokens) {
+        if (!m_enable_prefix_caching)
+            return 0;
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        size_t num_cached_tokens = 0;
+        for (const auto& match : m_prefix_tree.match(tokens)) {
+            size_t hash = match.node->get_hash();
+            if (m_persistent_hashes.count(hash) == 0 && m_allocator.find_cached_block(hash, m_prefix_hash_to_occupied_block_map).empty())
+                break;
+            num_cached_tokens += match.num_matched_tokens;
+        }
+        return num_cached_tokens;
+    }
+
+    /**
+     * Registers blocks available in the persistent prefix cache storage, so that prompts matching to them can restore them.
+     * @param blocks Descriptions of the stored blocks, in which each block is described after the block preceding it in a prefix.
+     */
+    void add_persistent_blocks(const std::vector<PrefixTree::BlockInfo>& blocks) {
+        OPENVINO_ASSERT(m_enable_prefix_caching, "Persistent prefix cache requires prefix caching to be enabled");
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        m_prefix_tree.insert_blocks(blocks);
+        for (const auto& block : blocks) {
+            m_persistent_hashes.insert(block.hash);
+        }
+    }
+
+    /**
+     * Continues restoring the prompt of a sequence group from blocks, which were not found in KV cache by `restore_cached_blocks`,
+     * but are available in the persistent prefix cache storage. KV cache blocks are allocated for them while there are free ones.
+     * @param seq_group Pointer to a sequence group in prompt phase.
+     * @return Hashes of the stored blocks together with the per-layer indices of allocated KV cache blocks, which contents
+     * have to be loaded from the persistent storage before inference.
+     */
+    std::vector<std::pair<size_t, std::vector<size_t>>> restore_persistent_blocks(SequenceGroup::Ptr seq_group) {
+        std::vector<std::pair<size_t, std::vector<size_t>>> blocks_to_load;
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        auto sequence = (*seq_group)[0];
+        auto seq_id = sequence->get_id();
+        auto pending_it = m_pending_persistent_restores.find(seq_id);
+        if (pending_it == m_pending_persistent_restores.end())
+            return blocks_to_load;
+        PendingPersistentRestore pending = std::move(pending_it->second);
+        m_pending_persistent_restores.erase(pending_it);
+
+        const size_t prompt_len = seq_group->get_prompt_len();
+        auto& block_table = m_block_table[seq_id];
+        size_t content_len = pending.num_restored_tokens;
+        // the group could be preempted or processed further in the meantime
+        size_t expected_num_processed_tokens = content_len == prompt_len ? content_len - 1 : content_len;
+        if (seq_group->get_num_processed_tokens() != expected_num_processed_tokens || block_table[0].size() * m_block_size != content_len)
+            return blocks_to_load;
+
+        for (const auto& match : pending.matches) {
+            size_t hash = match.node->get_hash();
+            auto blocks = m_allocator.get_cached_block(hash, m_prefix_hash_to_occupied_block_map);
+            if (blocks.empty()) {
+                if (m_persistent_hashes.count(hash) == 0 || !can_allocate_blocks(1))
+                    break;
+                blocks = m_allocator.allocate_block(hash, m_prefix_hash_to_occupied_block_map);
+                std::vector<size_t> block_ids;
+                for (const auto& block : blocks) {
+                    block_ids.push_back(block->get_index());
                 }
+                blocks_to_load.emplace_back(hash, std::move(block_ids));
+            }
+            if (match.num_matched_tokens < m_block_size) {
+                // loaded blocks are registered under their stored hash as well, so they are copied the same way as cached ones
+                m_sequences_to_copy_on_write.insert(seq_id);
+            }
+
+            auto timestamp = std::chrono::system_clock::now();
+            for (size_t layer_idx = 0; layer_idx < block_table.size(); layer_idx++) {
+                blocks[layer_idx]->set_timestamp(timestamp);
+                block_table[layer_idx].push_back(blocks[layer_idx]);
+            }
+            content_len += match.num_matched_tokens;
+        }
+
+        if (content_len > pending.num_restored_tokens) {
+            seq_group->update_processed_tokens_num(content_len == prompt_len ? content_len - 1 : content_len);
+        }
+        return blocks_to_load;
+    }
+
+    /**
+     * @return Descriptions of the fully filled blocks registered in the prefix tree which are present in KV cache, together
+     * with their per-layer indices, where each block is described after the block preceding it in a prefix.
+     */
+    std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> get_prefix_cached_blocks() {
+        std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> cached_blocks;
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        std::unordered_set<size_t> cached_hashes;
+        for (auto& info : m_prefix_tree.get_full_blocks()) {
+            if (info.has_parent && cached_hashes.count(info.parent_hash) == 0)
+                continue;
+            auto blocks = m_allocator.find_cached_block(info.hash, m_prefix_hash_to_occupied_block_map);
+            if (blocks.empty())
+                continue;
+            std::vector<size_t> block_ids;
+            for (const auto& block : blocks) {
+                block_ids.push_back(block->get_index());
+            }
+            cached_hashes.insert(info.hash);
+            cached_blocks.emplace_back(std::move(info), std::move(block_ids));
+        }
+        return cached_blocks;
+    }
+
+    /**
+     * @param tokens The prompt tokens.
+     * @return Descriptions of the fully filled blocks of the leading prompt tokens, which are present in KV cache, together
+     * with their per-layer indices, where each block is described after the block preceding it in the prompt.
+     */
+    std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> get_prefix_cached_blocks(const TokenIds& tokens) {
+        std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> cached_blocks;
+        if (!m_enable_prefix_caching)
+            return cached_blocks;
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        size_t num_cached_tokens = 0;
+        for (const auto& match : m_prefix_tree.match(tokens)) {
+            if (match.num_matched_tokens < m_block_size)
                 break;
+            size_t hash = match.node->get_hash();
+            auto blocks = m_allocator.find_cached_block(hash, m_prefix_hash_to_occupied_block_map);
+            if (blocks.empty())
+                break;
+            std::vector<size_t> block_ids;
+            for (const auto& block : blocks) {
+                block_ids.push_back(block->get_index());
             }
+            PrefixTree::BlockInfo info{hash, !cached_blocks.empty(), cached_blocks.empty() ? 0 : cached_blocks.back().first.hash,
+                                       TokenIds(tokens.begin() + num_cached_tokens, tokens.begin() + num_cached_tokens + m_block_size)};
+            cached_blocks.emplace_back(std::move(info), std::move(block_ids));
+            num_cached_tokens += m_block_size;
+        }
+        return cached_blocks;
+    }
+
+    /**
+     * Allocates KV cache blocks for blocks of another KV cache with the same layout, which are not cached yet, and registers
+     * them in the prefix tree, so that prompts matching to them can restore them. The blocks are not owned by any sequence,
+     * so they can be overwritten by later allocations as any other cached blocks.
+     * @param blocks Descriptions of the blocks, in which each block is described after the block preceding it in a prefix.
+     * @return Indices of the imported blocks in `blocks` together with the per-layer indices of allocated KV cache blocks,
+     * which contents have to be written before the next inference. Import stops at the first block, which cannot be allocated.
+     */
+    std::vector<std::pair<size_t, std::vector<size_t>>> import_prefix_cached_blocks(const std::vector<PrefixTree::BlockInfo>& blocks) {
+        OPENVINO_ASSERT(m_enable_prefix_caching, "Import of KV cache blocks requires prefix caching to be enabled");
+        std::vector<std::pair<size_t, std::vector<size_t>>> blocks_to_write;
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        // already cached blocks of the prefix are held until the end, so that allocations of the next blocks do not overwrite them
+        std::vector<BlocksPerLayer> held_blocks;
+        size_t num_blocks = 0;
+        for (; num_blocks < blocks.size(); ++num_blocks) {
+            size_t hash = blocks[num_blocks].hash;
+            auto cached_blocks = m_allocator.get_cached_block(hash, m_prefix_hash_to_occupied_block_map);
+            if (cached_blocks.empty()) {
+                if (!can_allocate_blocks(1))
+                    break;
+                cached_blocks = m_allocator.allocate_block(hash, m_prefix_hash_to_occupied_block_map);
+                auto timestamp = std::chrono::system_clock::now();
+                std::vector<size_t> block_ids;
+                for (const auto& block : cached_blocks) {
+                    block->set_timestamp(timestamp);
+                    block_ids.push_back(block->get_index());
+                }
+                blocks_to_write.emplace_back(num_blocks, std::move(block_ids));
+            }
+            held_blocks.push_back(std::move(cached_blocks));
+        }
+        for (const auto& held_blocks_for_all_layers : held_blocks) {
+            m_allocator.free(held_blocks_for_all_layers);
+        }
+        m_prefix_tree.insert_blocks({blocks.begin(), blocks.begin() + num_blocks});
+        return blocks_to_write;
+    }
+
+    /**
+     * @param seq_group Pointer to a sequence group in prompt phase.
+     * @return Whether the last block of the sequence was partially restored from the prefix cache, so that it must be copied by
+     * `copy_on_write_restored_block` before the rest of the prompt is appended to it. The block is copied even if the sequence is
+     * its only user, since it stays registered under the hash of its cached contents, which must not be overwritten.
+     */
+    bool needs_copy_on_write(SequenceGroup::Ptr seq_group) {
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        auto seq_id = (*seq_group)[0]->get_id();
+        if (m_sequences_to_copy_on_write.count(seq_id) == 0)
+            return false;
+        auto it = m_block_table.find(seq_id);
+        if (it == m_block_table.end() || it->second[0].empty() ||
+            seq_group->get_num_processed_tokens() >= it->second[0].size() * m_block_size) {
+            m_sequences_to_copy_on_write.erase(seq_id);
+            return false;
         }
+        return true;
+    }
+
+    /**
+     * Replaces the shared last block of the sequence, which was partially restored from the prefix cache, with a newly allocated one.
+     * @param seq_group Pointer to a sequence group in prompt phase.
+     * @return A map where each key is an index of a source *physical* block, and the corresponding value is a list of newly allocated *physical* block
+     * indices into which the source block contents should be copied into.
+     */
+    std::map<size_t, std::list<size_t>> copy_on_write_restored_block(SequenceGroup::Ptr seq_group) {
+        OPENVINO_ASSERT(can_allocate_blocks(1));
+        const std::lock_guard<std::mutex> lock(m_cached_blocks_map_mutex);
+        auto sequence = (*seq_group)[0];
+        auto seq_id = sequence->get_id();
+        m_sequences_to_copy_on_write.erase(seq_id);
+
+        auto& block_table = m_block_table[seq_id];
+        BlocksPerLayer last_blocks;
+        last_blocks.reserve(m_num_layers);
+        for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+            last_blocks.push_back(block_table[layer_idx].back());
+        }
+
+        size_t content_length = std::min(seq_group->get_prompt_len(), block_table[0].size() * m_block_size);
+        auto new_blocks = m_allocator.allocate_block(sequence->get_hash(content_length), m_prefix_hash_to_occupied_block_map);
+
+        std::map<size_t, std::list<size_t>> copy_blocks_map;
+        for (size_t layer_idx = 0; layer_idx < m_num_layers; layer_idx++) {
+            block_table[layer_idx].back() = new_blocks[layer_idx];
+            copy_blocks_map[last_blocks[layer_idx]->get_index()].push_back(new_blocks[layer_idx]->get_index());
+        }
+        m_allocator.free(last_blocks);
+        return copy_blocks_map;
     }
 };
 
@@ -0,0 +1,64 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ov::genai {
+
+// Thread-safe pool of std::vector buffers, which keeps capacity of released buffers for reuse, so that buffers growing
+// with generated tokens are not reallocated for each new sequence. Buffers are handed out as shared pointers, whose
+// deleter returns them to the pool, so they can be shared by several owners, e.g. copy-on-write by forked sequences.
+template <typename T>
+class BufferPool {
+public:
+    using Buffer = std::vector<T>;
+    using Ptr = std::shared_ptr<Buffer>;
+
+    // m_max_buffers released buffers are kept, buffers with capacity above m_max_capacity are freed to bound held memory
+    BufferPool(size_t max_buffers, size_t max_capacity) : m_max_buffers(max_buffers), m_max_capacity(max_capacity) { }
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // returns an empty buffer
+    Ptr acquire() {
+        std::unique_ptr<Buffer> buffer;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_buffers.empty()) {
+                buffer = std::move(m_buffers.back());
+                m_buffers.pop_back();
+            }
+        }
+        if (!buffer)
+            buffer = std::make_unique<Buffer>();
+        return Ptr(buffer.release(), [this](Buffer* released) { release(released); });
+    }
+
+    // returns a buffer with a copy of the given contents
+    Ptr acquire(const Buffer& contents) {
+        Ptr buffer = acquire();
+        buffer->assign(contents.begin(), contents.end());
+        return buffer;
+    }
+
+private:
+    void release(Buffer* released) {
+        std::unique_ptr<Buffer> buffer(released);
+        if (buffer->capacity() > m_max_capacity)
+            return;
+        buffer->clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffers.size() < m_max_buffers)
+            m_buffers.push_back(std::move(buffer));
+    }
+
+    const size_t m_max_buffers, m_max_capacity;
+    std::vector<std::unique_ptr<Buffer>> m_buffers;
+    std::mutex m_mutex;
+};
+
+}  // namespace ov::genai
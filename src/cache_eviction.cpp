@@ -1,8 +1,12 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+
 #include "cache_eviction.hpp"
 
+#include "openvino/core/parallel.hpp"
+
 namespace ov::genai {
     CacheEvictionAlgorithm::CacheEvictionAlgorithm(const CacheEvictionConfig &eviction_config, size_t block_size,
                                                    size_t num_decoder_layers) :
@@ -36,14 +40,18 @@ namespace ov::genai {
         // tokens was being computed.
 
         std::vector<std::set<size_t>> retval(m_num_decoder_layers);
+        if (m_eviction_config.policy == CacheEvictionPolicy::SNAPKV && !m_is_prompt_compressed) {
+            // SNAPKV postpones eviction until the whole prompt is processed
+            return retval;
+        }
 
-
-        for (size_t decoder_layer_idx = 0; decoder_layer_idx < m_scores.size(); decoder_layer_idx++) {
+        // layers are independent from each other, so they are processed in parallel
+        ov::parallel_for(m_num_decoder_layers, [&](size_t decoder_layer_idx) {
             const auto &accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
             auto scores_length = accumulated_scores_for_current_decoder_layer.size();
             if (scores_length + m_eviction_config.get_start_size() <= get_max_cache_size_after_eviction()) {
                 // KV cache is not yet filled, keep all currently occupied blocks
-                continue;
+                return;
             }
 
             // Only the blocks in the "intermediate" part of the logical KV cache will be considered for eviction
@@ -51,8 +59,6 @@ namespace ov::genai {
             size_t num_blocks_to_evict = get_num_blocks_to_evict(decoder_layer_idx);
             auto evicted_block_indices = get_indices_of_blocks_to_evict(scores_for_all_evictable_blocks, num_blocks_to_evict);
 
-            m_num_evicted_tokens += evicted_block_indices.size() * m_block_size;
-
             // No longer need to track the overall "heavy-hitter" attention scores for freshly evicted blocks
             remove_scores_of_evicted_blocks(evicted_block_indices, decoder_layer_idx);
 
@@ -60,6 +66,10 @@ namespace ov::genai {
             for (auto &idx: evicted_block_indices) idx += get_num_blocks(m_eviction_config.get_start_size());
             // auto remaining_block_indices = get_remaining_block_indices(evicted_block_indices);
             for (auto &idx: evicted_block_indices) retval[decoder_layer_idx].insert(idx);
+        });
+
+        for (const auto& evicted_block_indices : retval) {
+            m_num_evicted_tokens += evicted_block_indices.size() * m_block_size;
         }
         return retval;
     }
@@ -79,66 +89,79 @@ namespace ov::genai {
     }
 
     void CacheEvictionAlgorithm::register_new_token_scores(
-            const AttentionScoresForEachDecoderLayer &attention_scores_for_all_decoder_layers) {
-        for (size_t decoder_layer_idx = 0; decoder_layer_idx < m_cache_counter.size(); decoder_layer_idx++) {
-
-            const auto &attention_scores = attention_scores_for_all_decoder_layers[decoder_layer_idx];
-            // "Start" tokens are never evicted, won't track scores for these
-            // "Recent" tokens are also not evicted just yet, but need to accumulate their scores since they may
-            // ultimately move into the "intermediate" eviction region of cache
-            // Taking the [1, start_size:seq_len] span of the attention scores:
-            auto attn_shape = attention_scores.get_shape();
-            size_t kv_cache_size_in_tokens = attn_shape[0];
-            if (kv_cache_size_in_tokens <= m_eviction_config.get_start_size() + 1) {
-                return;
-            }
+            const AttentionScoresForEachDecoderLayer &attention_scores_for_all_decoder_layers, bool is_prompt_completed) {
+        ov::parallel_for(m_num_decoder_layers, [&](size_t decoder_layer_idx) {
+            register_new_token_scores(attention_scores_for_all_decoder_layers[decoder_layer_idx], decoder_layer_idx, is_prompt_completed);
+        });
+        m_is_prompt_compressed = m_is_prompt_compressed || is_prompt_completed;
+    }
+
+    std::vector<float> CacheEvictionAlgorithm::get_pooled_scores(const float* scores, size_t num_tokens) const {
+        size_t half_kernel_size = m_eviction_config.pooling_kernel_size / 2;
+        std::vector<float> pooled_scores(num_tokens);
+        for (size_t i = 0; i < num_tokens; ++i) {
+            size_t begin = i > half_kernel_size ? i - half_kernel_size : 0;
+            size_t end = std::min(num_tokens, i + half_kernel_size + 1);
+            pooled_scores[i] = *std::max_element(scores + begin, scores + end);
+        }
+        return pooled_scores;
+    }
 
-            auto hh_score = ov::Tensor(
-                    attention_scores,
-                    ov::Coordinate{m_eviction_config.get_start_size()},
-                    ov::Coordinate{kv_cache_size_in_tokens}
-            );
+    void CacheEvictionAlgorithm::register_new_token_scores(const ov::Tensor &attention_scores, size_t decoder_layer_idx, bool is_prompt_completed) {
+        // "Start" tokens are never evicted, won't track scores for these
+        // "Recent" tokens are also not evicted just yet, but need to accumulate their scores since they may
+        // ultimately move into the "intermediate" eviction region of cache
+        // Taking the [1, start_size:seq_len] span of the attention scores:
+        size_t kv_cache_size_in_tokens = attention_scores.get_shape()[0];
+        if (kv_cache_size_in_tokens <= m_eviction_config.get_start_size() + 1) {
+            return;
+        }
 
-            auto &accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
+        const float* hh_score_data = attention_scores.data<float>() + m_eviction_config.get_start_size();
+        size_t new_size_in_tokens = kv_cache_size_in_tokens - m_eviction_config.get_start_size();
 
-            if (accumulated_scores_for_current_decoder_layer.empty()) {
-                accumulated_scores_for_current_decoder_layer = std::vector<double>(hh_score.get_size());
-                for (size_t idx = 0; idx < accumulated_scores_for_current_decoder_layer.size(); idx++) {
-                    accumulated_scores_for_current_decoder_layer[idx] = hh_score.data<float>()[idx];
-                }
-                if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
-                    // New sequence to track - will simulate that the tokens comprising the sequence were added one-by-one
-                    // from the standpoint of the occurrence tracker
-                    std::size_t new_scores_size = hh_score.get_size();
-                    std::vector<std::size_t> counter(new_scores_size);
-                    std::generate(counter.begin(), counter.begin() + new_scores_size,
-                                  [&new_scores_size] { return new_scores_size--; });
-                    m_cache_counter[decoder_layer_idx] = counter;
-                }
+        auto &accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
+        std::vector<float> pooled_scores;
+        float hh_score_weight = 1.0f;
+        if (m_eviction_config.policy == CacheEvictionPolicy::SNAPKV && !m_is_prompt_compressed) {
+            if (!is_prompt_completed) {
+                // scores of queries outside of the observation window are ignored, tokens are tracked only
+                hh_score_weight = 0.0f;
             } else {
-                size_t old_size_in_tokens = accumulated_scores_for_current_decoder_layer.size();
-                size_t num_new_tokens = hh_score.get_size() - accumulated_scores_for_current_decoder_layer.size();
-                if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
-                    // Increment occurrence counts of all currently tracked cache blocks
-                    auto &counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
-                    for (auto it = counter_for_current_decoder_layer.begin();
-                         it != counter_for_current_decoder_layer.end(); it++) {
-                        *it += num_new_tokens;
-                    }
-                    // Add occurrence counts for new tokens like above
-                    counter_for_current_decoder_layer.resize(hh_score.get_size());
-                    for (size_t i = 0; i < num_new_tokens; i++) {
-                        auto idx = old_size_in_tokens + i;
-                        counter_for_current_decoder_layer[idx] = num_new_tokens - i;
-                    }
-                }
-                accumulated_scores_for_current_decoder_layer.resize(hh_score.get_size());
-                auto hh_score_data = hh_score.data<float>();
-                for (size_t i = 0; i < hh_score.get_size(); ++i) {
-                    accumulated_scores_for_current_decoder_layer[i] += hh_score_data[i];
+                // importance of the prompt tokens is defined by the observation window only, as if they were added at once
+                accumulated_scores_for_current_decoder_layer.clear();
+                m_cache_counter[decoder_layer_idx].clear();
+                if (m_eviction_config.pooling_kernel_size > 1) {
+                    pooled_scores = get_pooled_scores(hh_score_data, new_size_in_tokens);
+                    hh_score_data = pooled_scores.data();
                 }
             }
         }
+        size_t old_size_in_tokens = accumulated_scores_for_current_decoder_layer.size();
+        OPENVINO_ASSERT(new_size_in_tokens >= old_size_in_tokens, "attention scores must cover all tokens tracked by cache eviction");
+        size_t num_new_tokens = new_size_in_tokens - old_size_in_tokens;
+
+        if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
+            // Increment occurrence counts of all currently tracked cache blocks and add occurrence counts for new tokens
+            // as if they were added one-by-one; for a new sequence to track all its tokens are new
+            auto &counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
+            counter_for_current_decoder_layer.resize(new_size_in_tokens);
+            float* counter_data = counter_for_current_decoder_layer.data();
+            const float num_new_tokens_f = static_cast<float>(num_new_tokens);
+            for (size_t i = 0; i < old_size_in_tokens; ++i) {
+                counter_data[i] += num_new_tokens_f;
+            }
+            for (size_t i = 0; i < num_new_tokens; ++i) {
+                counter_data[old_size_in_tokens + i] = static_cast<float>(num_new_tokens - i);
+            }
+        }
+
+        // scores of new tokens start from zero, so that accumulation is a single contiguous loop, which is vectorized by compiler
+        accumulated_scores_for_current_decoder_layer.resize(new_size_in_tokens, 0.0f);
+        float* accumulated_scores_data = accumulated_scores_for_current_decoder_layer.data();
+        for (size_t i = 0; i < new_size_in_tokens; ++i) {
+            accumulated_scores_data[i] += hh_score_weight * hh_score_data[i];
+        }
     }
 
     std::size_t CacheEvictionAlgorithm::get_num_blocks(std::size_t num_tokens) const {
@@ -160,9 +183,9 @@ namespace ov::genai {
     }
 
     std::vector<double> CacheEvictionAlgorithm::get_scores_for_all_evictable_blocks(size_t decoder_layer_idx) const {
-        auto accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
+        const auto& accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
         auto num_tracked_tokens = accumulated_scores_for_current_decoder_layer.size();
-        auto counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
+        const auto& counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
 
         // Make sure that there is at least one block that can be completely evicted
         OPENVINO_ASSERT((num_tracked_tokens + m_eviction_config.get_start_size()) > get_max_cache_size_after_eviction(),
@@ -170,17 +193,19 @@ namespace ov::genai {
 
         size_t num_evictable_blocks = get_num_evictable_blocks(decoder_layer_idx);
 
+        // block-wise reduction over contiguous spans of block_size tokens
         std::vector<double> block_scores(num_evictable_blocks);
         for (size_t i = 0; i < num_evictable_blocks; ++i) {
-            double normalized_accumulated_attn_score_for_block = 0.0;
-            for (size_t j = 0; j < m_block_size; ++j) {
-                size_t token_offset = m_block_size * i + j;
-                if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
-                    normalized_accumulated_attn_score_for_block +=
-                            accumulated_scores_for_current_decoder_layer[token_offset] /
-                            counter_for_current_decoder_layer[token_offset];
-                } else {
-                    normalized_accumulated_attn_score_for_block += accumulated_scores_for_current_decoder_layer[token_offset];
+            const float* block_scores_data = accumulated_scores_for_current_decoder_layer.data() + m_block_size * i;
+            float normalized_accumulated_attn_score_for_block = 0.0f;
+            if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
+                const float* block_counter_data = counter_for_current_decoder_layer.data() + m_block_size * i;
+                for (size_t j = 0; j < m_block_size; ++j) {
+                    normalized_accumulated_attn_score_for_block += block_scores_data[j] / block_counter_data[j];
+                }
+            } else {
+                for (size_t j = 0; j < m_block_size; ++j) {
+                    normalized_accumulated_attn_score_for_block += block_scores_data[j];
                 }
             }
             block_scores[i] = normalized_accumulated_attn_score_for_block;
@@ -229,42 +254,30 @@ namespace ov::genai {
             return;
         }
 
-        const auto &accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
-        const auto &counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
+        auto &accumulated_scores_for_current_decoder_layer = m_scores[decoder_layer_idx];
+        auto &counter_for_current_decoder_layer = m_cache_counter[decoder_layer_idx];
 
         if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
             OPENVINO_ASSERT(
                     accumulated_scores_for_current_decoder_layer.size() == counter_for_current_decoder_layer.size());
         }
 
-        auto old_size = accumulated_scores_for_current_decoder_layer.size();
-        auto new_size =
-                accumulated_scores_for_current_decoder_layer.size() - evicted_block_indices.size() * m_block_size;
-
-        std::vector<double> new_scores;
-        new_scores.reserve(new_size);
-
-        std::vector<size_t> new_counter;
+        // compacts values in place by moving spans between evicted blocks to the left
+        auto remove_evicted_blocks = [&](std::vector<float>& values) {
+            size_t old_size = values.size();
+            size_t dst_token_idx = evicted_block_indices[0] * m_block_size;
+            for (size_t i = 0; i < evicted_block_indices.size(); ++i) {
+                size_t src_begin = (evicted_block_indices[i] + 1) * m_block_size;
+                size_t src_end = i + 1 < evicted_block_indices.size() ? evicted_block_indices[i + 1] * m_block_size : old_size;
+                std::copy(values.begin() + src_begin, values.begin() + src_end, values.begin() + dst_token_idx);
+                dst_token_idx += src_end - src_begin;
+            }
+            values.resize(dst_token_idx);
+        };
 
+        remove_evicted_blocks(accumulated_scores_for_current_decoder_layer);
         if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
-            new_counter.reserve(new_size);
+            remove_evicted_blocks(counter_for_current_decoder_layer);
         }
-
-        for (size_t token_idx = 0, evicted_block_idx = 0; token_idx < old_size;) {
-            if (evicted_block_idx < evicted_block_indices.size() &&
-                token_idx == evicted_block_indices[evicted_block_idx] * m_block_size) {
-                ++evicted_block_idx;
-                token_idx += m_block_size;
-                continue;
-            }
-            new_scores.push_back(accumulated_scores_for_current_decoder_layer[token_idx]);
-            if (m_eviction_config.aggregation_mode == AggregationMode::NORM_SUM) {
-                new_counter.push_back(counter_for_current_decoder_layer[token_idx]);
-            }
-            ++token_idx;
-        }
-
-        m_scores[decoder_layer_idx] = new_scores;
-        m_cache_counter[decoder_layer_idx] = new_counter;
     }
 }
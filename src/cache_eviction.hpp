@@ -83,8 +83,17 @@ public:
      * the tokens' lifetime in the KV cache and of the accumulated importance score of each token.
      * @param attention_scores_for_all_decoder_layers A vector with a size equal to the configured num_decoder_layers, where each entry is a
      * vector of per-token attention scores calculated within this layer.
+     * @param is_prompt_completed Whether the step completed processing of the prompt, i.e. whether the scores are from the SNAPKV observation window.
      */
-    void register_new_token_scores(const AttentionScoresForEachDecoderLayer& attention_scores_for_all_decoder_layers);
+    void register_new_token_scores(const AttentionScoresForEachDecoderLayer& attention_scores_for_all_decoder_layers, bool is_prompt_completed = true);
+
+    /**
+     * Same as above, but registers attention scores of a single decoder layer. Different layers may be registered concurrently.
+     * @param attention_scores Per-token attention scores calculated within the layer.
+     * @param decoder_layer_idx Index of the decoder layer.
+     * @param is_prompt_completed Whether the step completed processing of the prompt.
+     */
+    void register_new_token_scores(const ov::Tensor& attention_scores, size_t decoder_layer_idx, bool is_prompt_completed = true);
 
     /**
      * Returns the per-layer sets of logical block indices that should be evicted according to the internally computed importance scores
@@ -109,12 +118,19 @@ private:
 
     void remove_scores_of_evicted_blocks(const std::vector<std::size_t>& evicted_block_indices, size_t decoder_layer_idx);
 
+    // max pooling of scores over a window centered at each token
+    std::vector<float> get_pooled_scores(const float* scores, size_t num_tokens) const;
+
     CacheEvictionConfig m_eviction_config;
     std::size_t m_block_size;
     std::size_t m_num_evicted_tokens = 0;
     std::size_t m_num_decoder_layers;
-    std::vector<std::vector<double>> m_scores;
-    std::vector<std::vector<size_t>> m_cache_counter;
+    // whether scores of the whole prompt are registered, SNAPKV policy compresses the prompt at this moment
+    bool m_is_prompt_compressed = false;
+    // per-layer contiguous buffers of accumulated scores and occurrence counters of tracked tokens, kept in float
+    // so that accumulation and block-wise reduction are vectorized; counters are exact up to 2^24 generated tokens
+    std::vector<std::vector<float>> m_scores;
+    std::vector<std::vector<float>> m_cache_counter;
 };
 
 }
@@ -4,51 +4,170 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <list>
+#include <map>
+#include <future>
+#include <limits>
 
 #include "openvino/runtime/tensor.hpp"
+#include "openvino/core/parallel.hpp"
 
 #include "device_config.hpp"
+#include "utils/numa_utils.hpp"
 
 namespace ov::genai {
 class CacheManager {
     DeviceConfig m_device_config;
     std::vector<ov::Tensor> m_key_cache;
     std::vector<ov::Tensor> m_value_cache;
+    // host memory pool for KV blocks swapped out from m_key_cache / m_value_cache
+    std::vector<ov::Tensor> m_swap_key_cache;
+    std::vector<ov::Tensor> m_swap_value_cache;
+    // pending asynchronous copies from host swap space to device KV cache
+    std::future<void> m_async_swap_in;
+    // number of blocks in m_key_cache / m_value_cache, which is less than DeviceConfig::get_num_kv_blocks when KV cache grows on demand
+    size_t m_num_allocated_blocks = 0;
     ov::Core m_core;
 
+    static ov::Shape _with_num_blocks(ov::Shape shape, size_t num_blocks) {
+        shape[0] = num_blocks;
+        return shape;
+    }
+
+    void _allocate(size_t num_blocks, std::vector<ov::Tensor>& key_cache, std::vector<ov::Tensor>& value_cache) {
+        const std::string device_name = m_device_config.get_device();
+        ov::Shape key_cache_shape = _with_num_blocks(m_device_config.get_key_cache_shape(), num_blocks);
+        ov::Shape value_cache_shape = _with_num_blocks(m_device_config.get_value_cache_shape(), num_blocks);
+        key_cache.reserve(m_device_config.get_num_layers());
+        value_cache.reserve(m_device_config.get_num_layers());
+
+        if (device_name.find("GPU") == std::string::npos) {// Allocate KV caches
+            std::vector<std::vector<ov::Tensor>> layer_caches;
+            for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
+                key_cache.emplace_back(m_device_config.get_key_cache_precision(), key_cache_shape);
+                value_cache.emplace_back(m_device_config.get_value_cache_precision(), value_cache_shape);
+                layer_caches.push_back({key_cache.back(), value_cache.back()});
+            }
+            // force allocation, pages are placed on NUMA nodes of the threads touching them first
+            utils::parallel_first_touch(layer_caches, m_device_config.is_numa_interleaved_cache());
+        } else {
+            for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
+                // layers may be placed on different devices, see DeviceConfig::set_pipeline_parallel
+                auto remote_context = m_core.get_default_context(m_device_config.get_layer_device(decoder_layer_id));
+                key_cache.emplace_back(remote_context.create_tensor(m_device_config.get_key_cache_precision(), key_cache_shape));
+                value_cache.emplace_back(remote_context.create_tensor(m_device_config.get_value_cache_precision(), value_cache_shape));
+            }
+        }
+    }
+
+    // a run of consecutive blocks copied to consecutive blocks
+    struct BlocksRange {
+        size_t src_block_id;
+        size_t dst_block_id;
+        size_t num_blocks;
+    };
+
+    static std::vector<BlocksRange> _get_contiguous_ranges(const std::map<size_t, std::list<size_t>>& block_copy_map) {
+        std::vector<std::pair<size_t, size_t>> src_dst_pairs;
+        for (const auto& [src_block_id, dst_block_ids] : block_copy_map) {
+            for (size_t dst_block_id : dst_block_ids)
+                src_dst_pairs.emplace_back(src_block_id, dst_block_id);
+        }
+        std::sort(src_dst_pairs.begin(), src_dst_pairs.end());
+
+        std::vector<BlocksRange> ranges;
+        for (const auto& [src_block_id, dst_block_id] : src_dst_pairs) {
+            if (!ranges.empty()) {
+                auto& last_range = ranges.back();
+                if (last_range.src_block_id + last_range.num_blocks == src_block_id && last_range.dst_block_id + last_range.num_blocks == dst_block_id) {
+                    ++last_range.num_blocks;
+                    continue;
+                }
+            }
+            ranges.push_back({src_block_id, dst_block_id, 1});
+        }
+        return ranges;
+    }
+
+    static void _copy_block(const ov::Tensor& src, size_t src_block_id, const ov::Tensor& dst, size_t dst_block_id, size_t num_blocks = 1) {
+        ov::Shape src_shape = src.get_shape(), dst_shape = dst.get_shape();
+
+        // blocks are the outermost dimension, so a range of blocks is a single contiguous region
+        ov::Coordinate src_start_roi(src_shape.size(), 0), src_end_roi = src_shape;
+        src_end_roi[0] = (src_start_roi[0] = src_block_id) + num_blocks;
+        ov::Coordinate dst_start_roi(dst_shape.size(), 0), dst_end_roi = dst_shape;
+        dst_end_roi[0] = (dst_start_roi[0] = dst_block_id) + num_blocks;
+
+        ov::Tensor src_roi(src, src_start_roi, src_end_roi);
+        ov::Tensor dst_roi(dst, dst_start_roi, dst_end_roi);
+        src_roi.copy_to(dst_roi);
+    }
+
 public:
     explicit CacheManager(const DeviceConfig &device_config, ov::Core core) :
             m_device_config(device_config),
             m_core(core) {
-        m_key_cache.reserve(m_device_config.get_num_layers());
-        m_value_cache.reserve(m_device_config.get_num_layers());
+        m_num_allocated_blocks = device_config.get_initial_num_kv_blocks();
+        _allocate(m_num_allocated_blocks, m_key_cache, m_value_cache);
 
         const std::string device_name = device_config.get_device();
-        if (device_name.find("GPU") == std::string::npos) {// Allocate KV caches
+        if (device_name.find("GPU") != std::string::npos) {
+            auto remote_context = m_core.get_default_context(device_name);
+            if (m_device_config.get_num_swap_blocks() > 0) {
+                // host tensors are allocated via remote context to get memory which can be used for fast device <-> host copies
+                for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
+                    m_swap_key_cache.emplace_back(remote_context.create_host_tensor(device_config.get_key_cache_precision(),
+                                                                                   device_config.get_swap_key_cache_shape()));
+                    m_swap_value_cache.emplace_back(remote_context.create_host_tensor(device_config.get_value_cache_precision(),
+                                                                                     device_config.get_swap_value_cache_shape()));
+                }
+            }
+        }
+
+        if (m_device_config.get_num_swap_blocks() > 0 && m_swap_key_cache.empty()) {
             for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
-                ov::Tensor key_cache(device_config.get_cache_precision(), device_config.get_key_cache_shape());
-                ov::Tensor value_cache(device_config.get_cache_precision(), device_config.get_value_cache_shape());
+                m_swap_key_cache.emplace_back(device_config.get_key_cache_precision(), device_config.get_swap_key_cache_shape());
+                m_swap_value_cache.emplace_back(device_config.get_value_cache_precision(), device_config.get_swap_value_cache_shape());
+            }
+        }
+    }
 
-                // force allocation
-                std::memset(key_cache.data(), 0, key_cache.get_byte_size());
-                std::memset(value_cache.data(), 0, value_cache.get_byte_size());
+    size_t get_num_layers() const {
+        return m_key_cache.size();
+    }
 
-                m_key_cache.emplace_back(key_cache);
-                m_value_cache.emplace_back(value_cache);
-            }
-        } else {
-            auto remote_context = m_core.get_default_context(device_name);
-            for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
-                ov::Tensor key_cache = remote_context.create_tensor(device_config.get_cache_precision(),
-                                                                    device_config.get_key_cache_shape());
-                ov::Tensor value_cache = remote_context.create_tensor(device_config.get_cache_precision(),
-                                                                      device_config.get_value_cache_shape());
+    // number of bytes taken by a single block of keys and values of all layers
+    size_t get_block_byte_size() const {
+        return m_device_config.get_block_byte_size();
+    }
 
-                m_key_cache.emplace_back(key_cache);
-                m_value_cache.emplace_back(value_cache);
-            }
+    /**
+     * @return Number of KV cache blocks currently allocated for each layer.
+     */
+    size_t get_num_allocated_blocks() const {
+        return m_num_allocated_blocks;
+    }
+
+    /**
+     * Reallocates KV cache of each layer to hold a given number of blocks, preserving contents of the blocks which fit into
+     * the new size. Tensors returned by get_key_cache / get_value_cache before the call must be replaced by new ones by the user.
+     * @param num_blocks The new number of KV cache blocks.
+     */
+    void resize(size_t num_blocks) {
+        OPENVINO_ASSERT(num_blocks > 0 && num_blocks <= m_device_config.get_num_kv_blocks(), "Number of KV cache blocks must be in range [1, ",
+                        m_device_config.get_num_kv_blocks(), "], while ", num_blocks, " is requested");
+        wait_async_swap_in();
+        std::vector<ov::Tensor> key_cache, value_cache;
+        _allocate(num_blocks, key_cache, value_cache);
+        size_t num_preserved_blocks = std::min(num_blocks, m_num_allocated_blocks);
+        for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
+            _copy_block(m_key_cache[decoder_layer_id], 0, key_cache[decoder_layer_id], 0, num_preserved_blocks);
+            _copy_block(m_value_cache[decoder_layer_id], 0, value_cache[decoder_layer_id], 0, num_preserved_blocks);
         }
+        m_key_cache = std::move(key_cache);
+        m_value_cache = std::move(value_cache);
+        m_num_allocated_blocks = num_blocks;
     }
 
     ov::Tensor get_key_cache(size_t decoder_layer_id) const {
@@ -61,40 +180,148 @@ public:
         return m_value_cache[decoder_layer_id];
     }
 
-    void copy_blocks(const std::map<size_t, std::list<size_t>>& block_copy_map) {
-        ov::Shape key_shape = m_device_config.get_key_cache_shape();
-        ov::Shape value_shape = m_device_config.get_value_cache_shape();
+    /**
+     * Copies contents of a single KV cache block of a given layer to host tensors.
+     * @param decoder_layer_id The index of the layer.
+     * @param block_id The index of the block.
+     * @param key_block Host tensor of the key cache shape with the first dimension equal to 1.
+     * @param value_block Host tensor of the value cache shape with the first dimension equal to 1.
+     */
+    void read_block(size_t decoder_layer_id, size_t block_id, const ov::Tensor& key_block, const ov::Tensor& value_block) const {
+        OPENVINO_ASSERT(decoder_layer_id < m_key_cache.size());
+        _copy_block(m_key_cache[decoder_layer_id], block_id, key_block, 0);
+        _copy_block(m_value_cache[decoder_layer_id], block_id, value_block, 0);
+    }
+
+    /**
+     * Computes per-channel minimums and maximums of keys of a single full KV cache block of a given layer, which bound dot products
+     * of any query with these keys. Supported for CPU KV cache of f32, f16 and bf16 precisions only.
+     * @param decoder_layer_id The index of the layer.
+     * @param block_id The index of the block.
+     * @param summary Buffer of 2 * num_kv_heads * head_size values, which receives minimums of each head followed by maximums.
+     */
+    void compute_key_summary(size_t decoder_layer_id, size_t block_id, float* summary) const {
+        OPENVINO_ASSERT(decoder_layer_id < m_key_cache.size());
+        const ov::Tensor& key_cache = m_key_cache[decoder_layer_id];
+        // CPU layout is [num_blocks, num_kv_heads, block_size, head_size]
+        const ov::Shape& shape = key_cache.get_shape();
+        const size_t num_kv_heads = shape[1], block_size = shape[2], head_size = shape[3];
+        float* min_data = summary;
+        float* max_data = summary + num_kv_heads * head_size;
+        auto summarize = [&](auto* block_data) {
+            for (size_t head = 0; head < num_kv_heads; ++head) {
+                float* head_min = min_data + head * head_size;
+                float* head_max = max_data + head * head_size;
+                std::fill_n(head_min, head_size, std::numeric_limits<float>::max());
+                std::fill_n(head_max, head_size, std::numeric_limits<float>::lowest());
+                for (size_t token = 0; token < block_size; ++token) {
+                    const auto* key = block_data + (head * block_size + token) * head_size;
+                    for (size_t channel = 0; channel < head_size; ++channel) {
+                        const float value = static_cast<float>(key[channel]);
+                        head_min[channel] = std::min(head_min[channel], value);
+                        head_max[channel] = std::max(head_max[channel], value);
+                    }
+                }
+            }
+        };
+        const size_t block_offset = block_id * num_kv_heads * block_size * head_size;
+        if (key_cache.get_element_type() == ov::element::f32) {
+            summarize(key_cache.data<float>() + block_offset);
+        } else if (key_cache.get_element_type() == ov::element::f16) {
+            summarize(key_cache.data<ov::float16>() + block_offset);
+        } else if (key_cache.get_element_type() == ov::element::bf16) {
+            summarize(key_cache.data<ov::bfloat16>() + block_offset);
+        } else {
+            OPENVINO_THROW("Key summaries are not supported for KV cache precision ", key_cache.get_element_type());
+        }
+    }
 
-        ov::Coordinate key_src_start_roi(key_shape.size(), 0);
-        ov::Coordinate key_src_end_roi = key_shape;
-        ov::Coordinate key_dst_start_roi(key_shape.size(), 0);
-        ov::Coordinate key_dst_end_roi = key_shape;
+    /**
+     * Copies contents of host tensors to a single KV cache block of a given layer.
+     * @param decoder_layer_id The index of the layer.
+     * @param block_id The index of the block.
+     * @param key_block Host tensor of the key cache shape with the first dimension equal to 1.
+     * @param value_block Host tensor of the value cache shape with the first dimension equal to 1.
+     */
+    void write_block(size_t decoder_layer_id, size_t block_id, const ov::Tensor& key_block, const ov::Tensor& value_block) {
+        OPENVINO_ASSERT(decoder_layer_id < m_key_cache.size());
+        _copy_block(key_block, 0, m_key_cache[decoder_layer_id], block_id);
+        _copy_block(value_block, 0, m_value_cache[decoder_layer_id], block_id);
+    }
 
-        ov::Coordinate value_src_start_roi(value_shape.size(), 0);
-        ov::Coordinate value_src_end_roi = value_shape;
-        ov::Coordinate value_dst_start_roi(value_shape.size(), 0);
-        ov::Coordinate value_dst_end_roi = value_shape;
+    /**
+     * Copies contents of KV cache blocks to other blocks for all layers. Runs of consecutive source blocks copied to consecutive
+     * destination blocks are copied at once.
+     * @param block_copy_map Map of source block index -> indices of destination blocks.
+     */
+    void copy_blocks(const std::map<size_t, std::list<size_t>>& block_copy_map) {
+        if (block_copy_map.empty())
+            return;
+        const std::vector<BlocksRange> ranges = _get_contiguous_ranges(block_copy_map);
+        auto copy_layer_blocks = [&](size_t decoder_layer_id) {
+            for (const auto& range : ranges) {
+                _copy_block(m_key_cache[decoder_layer_id], range.src_block_id, m_key_cache[decoder_layer_id], range.dst_block_id, range.num_blocks);
+                _copy_block(m_value_cache[decoder_layer_id], range.src_block_id, m_value_cache[decoder_layer_id], range.dst_block_id, range.num_blocks);
+            }
+        };
 
-        for (const auto & blocks_pair : block_copy_map) {
-            size_t src_block_id = blocks_pair.first;
-            key_src_end_roi[0] = (key_src_start_roi[0] = src_block_id) + 1;
-            value_src_end_roi[0] = (value_src_start_roi[0] = src_block_id) + 1;
+        if (m_device_config.get_device().find("GPU") == std::string::npos) {
+            // layers are independent host tensors, so they are copied in parallel
+            ov::parallel_for(m_device_config.get_num_layers(), copy_layer_blocks);
+        } else {
+            // remote tensor copies are enqueued to the device queue, so the host only issues them
+            for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id)
+                copy_layer_blocks(decoder_layer_id);
+        }
+    }
 
-            const std::list<size_t>& dst_block_ids = blocks_pair.second;
-            for (size_t dst_block_id : dst_block_ids) {
-                key_dst_end_roi[0] = (key_dst_start_roi[0] = dst_block_id) + 1;
-                value_dst_end_roi[0] = (value_dst_start_roi[0] = dst_block_id) + 1;
+    /**
+     * Copies KV blocks from device KV cache to host swap space.
+     * @param block_swap_map Per-layer maps of device block index -> host block index.
+     */
+    void swap_out(const std::vector<std::map<size_t, size_t>>& block_swap_map) {
+        OPENVINO_ASSERT(block_swap_map.empty() || !m_swap_key_cache.empty(), "Swap space is not allocated");
+        for (size_t decoder_layer_id = 0; decoder_layer_id < block_swap_map.size(); ++decoder_layer_id) {
+            for (const auto& device_host : block_swap_map[decoder_layer_id]) {
+                _copy_block(m_key_cache[decoder_layer_id], device_host.first, m_swap_key_cache[decoder_layer_id], device_host.second);
+                _copy_block(m_value_cache[decoder_layer_id], device_host.first, m_swap_value_cache[decoder_layer_id], device_host.second);
+            }
+        }
+    }
 
-                for (size_t decoder_layer_id = 0; decoder_layer_id < m_device_config.get_num_layers(); ++decoder_layer_id) {
-                    ov::Tensor key_src_cache_roi(m_key_cache[decoder_layer_id], key_src_start_roi, key_src_end_roi);
-                    ov::Tensor key_dst_cache_roi(m_key_cache[decoder_layer_id], key_dst_start_roi, key_dst_end_roi);
+    /**
+     * Starts copying KV blocks from host swap space back to device KV cache in a background thread.
+     * Destination blocks must not be used by inference until `wait_async_swap_in` is called.
+     * @param block_swap_map Per-layer maps of host block index -> device block index.
+     */
+    void swap_in_async(const std::vector<std::map<size_t, size_t>>& block_swap_map) {
+        wait_async_swap_in();
+        if (block_swap_map.empty())
+            return;
+        m_async_swap_in = std::async(std::launch::async, [this, block_swap_map] {
+            swap_in(block_swap_map);
+        });
+    }
 
-                    ov::Tensor value_src_cache_roi(m_value_cache[decoder_layer_id], value_src_start_roi, value_src_end_roi);
-                    ov::Tensor value_dst_cache_roi(m_value_cache[decoder_layer_id], value_dst_start_roi, value_dst_end_roi);
+    /**
+     * Waits for copies started by the previous `swap_in_async` call.
+     */
+    void wait_async_swap_in() {
+        if (m_async_swap_in.valid()) {
+            m_async_swap_in.get();
+        }
+    }
 
-                    key_src_cache_roi.copy_to(key_dst_cache_roi);
-                    value_src_cache_roi.copy_to(value_dst_cache_roi);
-                }
+    /**
+     * Copies KV blocks from host swap space back to device KV cache.
+     * @param block_swap_map Per-layer maps of host block index -> device block index.
+     */
+    void swap_in(const std::vector<std::map<size_t, size_t>>& block_swap_map) {
+        OPENVINO_ASSERT(block_swap_map.empty() || !m_swap_key_cache.empty(), "Swap space is not allocated");
+        for (size_t decoder_layer_id = 0; decoder_layer_id < block_swap_map.size(); ++decoder_layer_id) {
+            for (const auto& host_device : block_swap_map[decoder_layer_id]) {
+                _copy_block(m_swap_key_cache[decoder_layer_id], host_device.first, m_key_cache[decoder_layer_id], host_device.second);
+                _copy_block(m_swap_value_cache[decoder_layer_id], host_device.first, m_value_cache[decoder_layer_id], host_device.second);
             }
         }
     }
@@ -3,8 +3,23 @@
 
 #pragma once
 
-#include <string>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "block_manager.hpp"
@@ -105,4 +120,196 @@ public:
 private:
     std::string m_run_id;
 };
+
+/**
+ * Low overhead counterpart of CacheStateDumper, which can stay enabled in release builds. Every N-th step it encodes
+ * the block table of the first layer, numbers of free and overwriteable blocks and eviction decisions of the step
+ * into a compact binary record. The latest records are kept in a ring buffer in memory and are written to a file,
+ * when the dumper is destroyed. The file is decoded offline by the `cache_dump_decoder` tool.
+ *
+ * Enabled by environment variables:
+ *   OPENVINO_GENAI_CACHE_DUMP - path of the output file, which is suffixed by ".<process id>.<dumper id>", so that pipelines
+ *                               of the same or different processes, e.g. a draft model or replicas, do not overwrite each other;
+ *   OPENVINO_GENAI_CACHE_DUMP_INTERVAL - number of steps between records, 16 by default;
+ *   OPENVINO_GENAI_CACHE_DUMP_CAPACITY - number of the latest records to keep, 4096 by default.
+ *
+ * File layout, all integers are little endian:
+ *   header: char[8] MAGIC, u32 VERSION, u32 interval, u64 number of records taken, u64 number of records in the file
+ *   record: u32 size of the rest of the record in bytes, u64 step, u64 time since the dumper creation in us,
+ *           u32 total blocks, u32 free blocks, u32 overwriteable blocks, u64 prefix cache hit tokens,
+ *           u32 number of sequences, for each: u64 request id, u64 sequence id, u32 number of blocks,
+ *                                              for each: u32 block index, u32 references count
+ *           u32 number of evicted sequences, for each: u64 sequence id, u32 number of layers,
+ *                                                      for each: u32 number of blocks, for each: u32 logical block index
+ */
+class BinaryCacheStateDumper {
+public:
+    static constexpr char MAGIC[8] = {'O', 'V', 'G', 'C', 'D', 'U', 'M', 'P'};
+    static constexpr uint32_t VERSION = 1;
+
+    BinaryCacheStateDumper() {
+        const char* path = std::getenv("OPENVINO_GENAI_CACHE_DUMP");
+        if (path == nullptr || path[0] == '\0')
+            return;
+#ifdef _WIN32
+        const auto pid = _getpid();
+#else
+        const auto pid = getpid();
+#endif
+        m_path = std::string(path) + "." + std::to_string(pid) + "." + std::to_string(m_num_instances++);
+        m_interval = read_env_var("OPENVINO_GENAI_CACHE_DUMP_INTERVAL", 16);
+        m_records.resize(read_env_var("OPENVINO_GENAI_CACHE_DUMP_CAPACITY", 4096));
+    }
+
+    BinaryCacheStateDumper(const BinaryCacheStateDumper&) = delete;
+    BinaryCacheStateDumper& operator=(const BinaryCacheStateDumper&) = delete;
+
+    ~BinaryCacheStateDumper() {
+        if (!is_enabled())
+            return;
+        try {
+            write(m_path);
+        } catch (const std::exception& error) {
+            std::cerr << "Failed to write KV cache state dump: " << error.what() << std::endl;
+        }
+    }
+
+    bool is_enabled() const {
+        return !m_path.empty();
+    }
+
+    /**
+     * Starts a step, eviction decisions and the state of the cache are recorded only if it returns true.
+     */
+    bool begin_step() {
+        m_is_sampled_step = is_enabled() && m_step % m_interval == 0;
+        m_step++;
+        if (m_is_sampled_step)
+            m_evictions.clear();
+        return m_is_sampled_step;
+    }
+
+    void register_eviction(uint64_t seq_id, const std::vector<std::set<size_t>>& logical_blocks_per_layer) {
+        if (!m_is_sampled_step)
+            return;
+        append<uint64_t>(m_evictions, seq_id);
+        append<uint32_t>(m_evictions, logical_blocks_per_layer.size());
+        for (const auto& logical_blocks : logical_blocks_per_layer) {
+            append<uint32_t>(m_evictions, logical_blocks.size());
+            for (size_t logical_block : logical_blocks)
+                append<uint32_t>(m_evictions, logical_block);
+        }
+        m_num_evicted_sequences++;
+    }
+
+    /**
+     * Records the state of the cache at the end of a sampled step.
+     * @param schdl A scheduler managing the cache.
+     * @param sequence_groups Sequence groups currently utilizing the cache.
+     */
+    void end_step(const Scheduler& schdl, const std::vector<SequenceGroup::Ptr>& sequence_groups) {
+        if (!m_is_sampled_step)
+            return;
+        m_is_sampled_step = false;
+
+        std::unordered_map<uint64_t, uint64_t> seq_id_to_request_id;
+        for (const auto& seq_group_ptr : sequence_groups) {
+            for (const auto& seq_ptr : seq_group_ptr->get_sequences())
+                seq_id_to_request_id[seq_ptr->get_id()] = seq_group_ptr->get_request_id();
+        }
+
+        const BlockManager& block_mgr = schdl.m_block_manager;
+        const BlockAllocator& allocator = block_mgr.m_allocator;
+        // reuses memory of the overwritten record
+        std::vector<uint8_t>& record = m_records[m_num_records % m_records.size()];
+        record.clear();
+        append<uint32_t>(record, 0);
+        append<uint64_t>(record, m_step - 1);
+        append<uint64_t>(record, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start_time).count());
+        append<uint32_t>(record, allocator.m_total_num_blocks);
+        append<uint32_t>(record, allocator.m_free_blocks_num[0]);
+        append<uint32_t>(record, allocator.num_overwriteable_blocks());
+        append<uint64_t>(record, schdl.get_num_prefix_cache_hit_tokens());
+
+        append<uint32_t>(record, block_mgr.m_block_table.size());
+        for (const auto& seq_id_and_blocks : block_mgr.m_block_table) {
+            const uint64_t seq_id = seq_id_and_blocks.first;
+            auto it = seq_id_to_request_id.find(seq_id);
+            append<uint64_t>(record, it == seq_id_to_request_id.end() ? std::numeric_limits<uint64_t>::max() : it->second);
+            append<uint64_t>(record, seq_id);
+            // all layers have the same number of blocks, which are allocated and freed together unless evicted
+            const auto& blocks = seq_id_and_blocks.second[0];
+            append<uint32_t>(record, blocks.size());
+            for (const auto& block : blocks) {
+                append<uint32_t>(record, block->get_index());
+                append<uint32_t>(record, block->get_references_count());
+            }
+        }
+
+        append<uint32_t>(record, m_num_evicted_sequences);
+        record.insert(record.end(), m_evictions.begin(), m_evictions.end());
+        m_evictions.clear();
+        m_num_evicted_sequences = 0;
+
+        const uint32_t size = record.size() - sizeof(uint32_t);
+        std::memcpy(record.data(), &size, sizeof(size));
+        m_num_records++;
+    }
+
+    void write(const std::filesystem::path& path) const {
+        std::ofstream file(path, std::ios::binary);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", path.string(), " to write KV cache state dump");
+
+        const uint64_t num_stored_records = std::min<uint64_t>(m_num_records, m_records.size());
+        file.write(MAGIC, sizeof(MAGIC));
+        write_value<uint32_t>(file, VERSION);
+        write_value<uint32_t>(file, m_interval);
+        write_value<uint64_t>(file, m_num_records);
+        write_value<uint64_t>(file, num_stored_records);
+        // the oldest record goes first
+        for (uint64_t i = m_num_records - num_stored_records; i < m_num_records; ++i) {
+            const std::vector<uint8_t>& record = m_records[i % m_records.size()];
+            file.write(reinterpret_cast<const char*>(record.data()), record.size());
+        }
+        OPENVINO_ASSERT(file.good(), "Failed to write KV cache state dump to ", path.string());
+    }
+
+private:
+    static size_t read_env_var(const char* name, size_t default_value) {
+        const char* value = std::getenv(name);
+        if (value == nullptr || value[0] == '\0')
+            return default_value;
+        const long long parsed = std::atoll(value);
+        OPENVINO_ASSERT(parsed > 0, name, " must be a positive number, got ", value);
+        return parsed;
+    }
+
+    // the dump is read on the same machine, whose byte order is little endian for all supported platforms
+    template <typename T>
+    static void append(std::vector<uint8_t>& buffer, T value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    static void write_value(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // dumpers created by the process so far, used to name their files
+    static inline std::atomic<size_t> m_num_instances{0};
+    std::string m_path;
+    size_t m_interval = 1;
+    std::chrono::steady_clock::time_point m_start_time = std::chrono::steady_clock::now();
+
+    size_t m_step = 0;
+    bool m_is_sampled_step = false;
+    // eviction decisions of the current step
+    std::vector<uint8_t> m_evictions;
+    uint32_t m_num_evicted_sequences = 0;
+
+    // ring buffer of encoded records
+    std::vector<std::vector<uint8_t>> m_records;
+    uint64_t m_num_records = 0;
+};
 }
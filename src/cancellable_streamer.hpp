@@ -0,0 +1,55 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "openvino/genai/llm_pipeline.hpp"
+#include "openvino/genai/streamer_base.hpp"
+
+namespace ov {
+namespace genai {
+
+// Streamer, which requests to stop generation once the flag is set, the wrapped streamer is optional.
+class CancellableStreamer : public StreamerBase {
+    std::shared_ptr<StreamerBase> m_streamer;
+    std::shared_ptr<std::atomic<bool>> m_is_cancelled;
+public:
+    CancellableStreamer(std::shared_ptr<StreamerBase> streamer, std::shared_ptr<std::atomic<bool>> is_cancelled) :
+        m_streamer(std::move(streamer)), m_is_cancelled(std::move(is_cancelled)) {}
+
+    bool put(int64_t token) override {
+        bool stop = m_streamer && m_streamer->put(token);
+        return stop || m_is_cancelled->load();
+    }
+
+    void end() override {
+        if (m_streamer)
+            m_streamer->end();
+    }
+};
+
+// Wraps the streamer of generate_async() to stop generation on GenerationFuture::cancel(). Without a streamer, a streamer
+// checking the flag only is added if `is_streaming_supported`, as pipelines reject streamers for some inputs and configs.
+inline StreamerVariant make_cancellable_streamer(const StreamerVariant& streamer,
+                                                 const std::shared_ptr<std::atomic<bool>>& is_cancelled,
+                                                 bool is_streaming_supported) {
+    if (auto callback = std::get_if<std::function<bool(std::string)>>(&streamer)) {
+        return std::function<bool(std::string)>{[callback = *callback, is_cancelled](std::string text) {
+            bool stop = callback(std::move(text));
+            return stop || is_cancelled->load();
+        }};
+    } else if (auto streamer_ptr = std::get_if<std::shared_ptr<StreamerBase>>(&streamer)) {
+        if (*streamer_ptr == nullptr)
+            return streamer;
+        return std::make_shared<CancellableStreamer>(*streamer_ptr, is_cancelled);
+    } else if (is_streaming_supported) {
+        return std::make_shared<CancellableStreamer>(nullptr, is_cancelled);
+    }
+    return streamer;
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -7,34 +7,40 @@
 #include <mutex>
 #include <future>
 #include <algorithm>
-#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
 
 namespace ov::genai {
 
-// From OVMS:
+// Based on OVMS:
 // https://github.com/openvinotoolkit/model_server/blob/d73e85cbb8ac1d761754cb2064a00551a9ffc655/src/queue.hpp#L34
+// The queue starts with length elements and creates more elements up to max_length, while all existing ones are in use,
+// callers wait for a returned element once max_length elements exist.
 template <typename T>
 class CircularBufferQueue
 {
-    int m_front_idx;
-    std::atomic<int> m_back_idx;
-    std::vector<int> m_values;
-    std::queue<std::promise<int>> m_promises;
+    // elements are never moved, so references returned by get() stay valid while the queue grows
     std::vector<T> m_data;
-    std::mutex m_front_mut;
-    std::mutex m_queue_mutex;
+    size_t m_num_created = 0;
+    std::function<T()> m_create_fn;
+    std::vector<int> m_idle_values;
+    std::queue<std::promise<int>> m_promises;
+    std::mutex m_mutex;
+    // statistics of callers, which had to wait for an element
+    size_t m_num_waits = 0;
+    std::chrono::steady_clock::duration m_total_wait_time{0};
 
 public:
 
-    CircularBufferQueue(size_t length, const std::function<T()>& create_fn) :
-        m_values(length),
-        m_front_idx{0},
-        m_back_idx{0} {
-        std::iota(m_values.begin(), m_values.end(), 0);
-        m_data.reserve(length);
+    CircularBufferQueue(size_t length, const std::function<T()>& create_fn, size_t max_length = 0) :
+        m_data(std::max(length, max_length)),
+        m_create_fn(create_fn) {
         for (size_t i = 0; i < length; i++) {
-            m_data.emplace_back(std::move(create_fn()));
+            m_data[i] = m_create_fn();
+            m_idle_values.push_back(static_cast<int>(length - i - 1));
         }
+        m_num_created = length;
     }
 
     CircularBufferQueue(const CircularBufferQueue&) = delete;
@@ -46,25 +52,29 @@ public:
     }
 
     std::future<int> get_idle() {
-        int value;
         std::promise<int> idle_promise;
         std::future<int> idle_future = idle_promise.get_future();
-        std::unique_lock<std::mutex> lk(m_front_mut);
-        if (m_values[m_front_idx] < 0) {
-            std::unique_lock<std::mutex> queueLock(m_queue_mutex);
-            m_promises.push(std::move(idle_promise));
-        } else {
-            value = m_values[m_front_idx];
-            m_values[m_front_idx] = -1;
-            m_front_idx = (m_front_idx + 1) % m_values.size();
+        std::unique_lock<std::mutex> lk(m_mutex);
+        if (!m_idle_values.empty()) {
+            int value = m_idle_values.back();
+            m_idle_values.pop_back();
+            lk.unlock();
+            idle_promise.set_value(value);
+        } else if (m_num_created < m_data.size()) {
+            // created under the lock, so that a failed creation does not leave a gap
+            int value = static_cast<int>(m_num_created);
+            m_data[value] = m_create_fn();
+            ++m_num_created;
             lk.unlock();
             idle_promise.set_value(value);
+        } else {
+            m_promises.push(std::move(idle_promise));
         }
         return idle_future;
     }
 
     void return_to(int value) {
-        std::unique_lock<std::mutex> lk(m_queue_mutex);
+        std::unique_lock<std::mutex> lk(m_mutex);
         if (m_promises.size()) {
             std::promise<int> promise = std::move(m_promises.front());
             m_promises.pop();
@@ -72,13 +82,28 @@ public:
             promise.set_value(value);
             return;
         }
-        int old_back = m_back_idx.load();
-        while (!m_back_idx.compare_exchange_weak(
-            old_back,
-            (old_back + 1) % m_values.size(),
-            std::memory_order_relaxed)) {
-        }
-        m_values[old_back] = value;
+        m_idle_values.push_back(value);
+    }
+
+    void record_wait(std::chrono::steady_clock::duration wait_time) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        ++m_num_waits;
+        m_total_wait_time += wait_time;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_num_created;
+    }
+
+    size_t get_num_waits() {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_num_waits;
+    }
+
+    std::chrono::steady_clock::duration get_total_wait_time() {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_total_wait_time;
     }
 };
 
@@ -88,7 +113,14 @@ class CircularBufferQueueElementGuard {
     int m_value;
 public:
     CircularBufferQueueElementGuard(CircularBufferQueue<T>* queue) : m_queue(queue) {
-        m_value = m_queue->get_idle().get();   // blocking until we get the element
+        std::future<int> idle_future = m_queue->get_idle();
+        if (idle_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            m_value = idle_future.get();
+        } else {
+            auto start_time = std::chrono::steady_clock::now();
+            m_value = idle_future.get();   // blocking until we get the element
+            m_queue->record_wait(std::chrono::steady_clock::now() - start_time);
+        }
     }
 
     T& get() {
@@ -2,9 +2,12 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "text_callback_streamer.hpp"
+#include "threaded_streamer.hpp"
 #include "continuous_batching_impl.hpp"
 #include "utils.hpp"
 #include "utils/paged_attention_transformations.hpp"
+#include "lora_helper.hpp"
+#include "openvino/core/parallel.hpp"
 
 namespace ov::genai {
 template<class... Ts> struct overloaded : Ts... {using Ts::operator()...;};
@@ -17,7 +20,8 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::ContinuousBatchingImpl(
     const std::string& device,
     const ov::AnyMap& properties,
     const ov::genai::GenerationConfig& generation_config,
-    bool is_validation_mode_enabled
+    bool is_validation_mode_enabled,
+    float cache_memory_share
     ) {
     m_tokenizer = tokenizer;
     m_generation_config = generation_config;
@@ -25,38 +29,291 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::ContinuousBatchingImpl(
 
     ov::Core core;
 
-    auto [core_properties, compile_properties] = utils::split_core_compile_config(properties);
+    std::optional<AdapterConfig> adapters;
+    const ov::AnyMap filtered_properties = extract_adapters_from_properties(properties, &adapters).value_or(properties);
+
+    auto [core_properties, compile_properties] = utils::split_core_compile_config(filtered_properties);
     core.set_property(core_properties);
 
-    DeviceConfig device_config(core, scheduler_config, device, compile_properties);
+    std::vector<std::string> pipeline_parallel_devices;
+    if (auto it = compile_properties.find(ov::genai::pipeline_parallel_devices.name()); it != compile_properties.end()) {
+        pipeline_parallel_devices = it->second.as<std::vector<std::string>>();
+        compile_properties.erase(it);
+        OPENVINO_ASSERT(pipeline_parallel_devices.size() > 1, "pipeline_parallel_devices must list at least two devices");
+        for (const auto& stage_device : pipeline_parallel_devices) {
+            OPENVINO_ASSERT(stage_device.find("GPU") != std::string::npos, "pipeline_parallel_devices supports GPUs only, while ", stage_device, " is listed");
+        }
+    }
+
+    // KV cache layout and precision are shared by all layers, so stages take them from the first device
+    DeviceConfig device_config(core, scheduler_config, pipeline_parallel_devices.empty() ? device : pipeline_parallel_devices.front(), compile_properties);
+    device_config.set_cache_memory_share(cache_memory_share);
 
-    bool is_need_per_layer_cache_control = scheduler_config.use_cache_eviction;
+    // sparse decoding passes its own set of blocks for each layer
+    bool is_need_per_layer_cache_control = scheduler_config.use_cache_eviction || scheduler_config.sparse_decode_block_budget > 0;
     utils::apply_paged_attention_transformations(model, device_config, is_need_per_layer_cache_control);
+    if (scheduler_config.sparse_decode_block_budget > 0) {
+        utils::apply_sparse_decode_queries_transformation(model);
+    }
+    if (adapters) {
+        // A and B of all adapters are kept in the model, while requests select adapters by alphas of their tokens
+        OPENVINO_ASSERT(adapters->get_mode() == AdapterConfig::MODE_AUTO || adapters->get_mode() == AdapterConfig::MODE_HOT_SWAP,
+                        "Continuous batching supports adapters in AdapterConfig::MODE_HOT_SWAP only");
+        OPENVINO_ASSERT(!scheduler_config.enable_prefix_caching, "Adapters cannot be used together with prefix caching");
+        adapters->set_mode(AdapterConfig::MODE_HOT_SWAP);
+        adapters->set_tensor_name_prefix(adapters->get_tensor_name_prefix().value_or("base_model.model.model."));
+        m_adapter_controller = AdapterController(model, *adapters, device);
+        m_generation_config.adapters = adapters;
+    }
+    if (scheduler_config.device_prompt_log_probs) {
+        // must precede the top-k transformation, which replaces full vocabulary logits
+        utils::apply_prompt_log_probs_transformation(model);
+    }
+    if (scheduler_config.device_top_k > 0) {
+        utils::apply_top_k_logits_transformation(model, scheduler_config.device_top_k);
+    }
+    if (!pipeline_parallel_devices.empty()) {
+        // placement is done on the final model, so that every operation gets a device
+        device_config.set_pipeline_parallel(pipeline_parallel_devices,
+            utils::split_model_between_devices(core, model, pipeline_parallel_devices, compile_properties, device_config.get_num_layers()));
+        compile_properties[ov::hint::model_distribution_policy.name()] =
+            std::set<ov::hint::ModelDistributionPolicy>{ov::hint::ModelDistributionPolicy::PIPELINE_PARALLEL};
+    }
 
     init(model, scheduler_config, compile_properties, device_config, core);
 }
 
+ContinuousBatchingPipeline::ContinuousBatchingImpl::~ContinuousBatchingImpl() {
+    if (m_prefix_cache_storage) {
+        m_cache_manager->wait_async_swap_in();
+        try {
+            m_prefix_cache_storage->save(m_scheduler->get_prefix_cached_blocks(), *m_cache_manager);
+        } catch (const std::exception& ex) {
+            std::cerr << "Failed to save prefix cache: " << ex.what() << std::endl;
+        }
+    }
+}
+
+bool ContinuousBatchingPipeline::ContinuousBatchingImpl::_coalesce_request(const SequenceGroup::Ptr& sequence_group) {
+    if (!m_scheduler->get_config().coalesce_identical_prompts)
+        return false;
+    const std::lock_guard<std::mutex> lock(m_coalesced_prefills_mutex);
+    auto [it, is_inserted] = m_coalesced_prefills.try_emplace(sequence_group->get_prompt_cache_ids());
+    if (is_inserted) {
+        it->second.leader = sequence_group;
+        return false;
+    }
+    it->second.followers.push_back(sequence_group);
+    ++m_num_coalesced_requests;
+    return true;
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_release_coalesced_requests() {
+    const std::lock_guard<std::mutex> lock(m_coalesced_prefills_mutex);
+    for (auto it = m_coalesced_prefills.begin(); it != m_coalesced_prefills.end();) {
+        const SequenceGroup::Ptr& leader = it->second.leader;
+        // the leader may also be preempted and start its prefill again, then the followers keep waiting
+        const bool is_prefilled = leader->get_num_processed_tokens() >= leader->get_prompt_len() || leader->has_finished() ||
+                                  leader->out_of_memory() || leader->handle_dropped();
+        if (!is_prefilled) {
+            ++it;
+            continue;
+        }
+        for (auto& follower : it->second.followers) {
+            if (follower->handle_dropped()) {
+                _free_request(follower);
+                continue;
+            }
+            // blocks of the leader are found by prefix caching now, if they were not freed
+            m_scheduler->restore_cached_blocks(follower);
+            follower->register_dequeue();
+            m_requests.push_back(std::move(follower));
+        }
+        m_num_coalesced_requests -= it->second.followers.size();
+        it = m_coalesced_prefills.erase(it);
+    }
+}
+
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::_pull_awaiting_requests() {
-    std::lock_guard<std::mutex> lock{m_awaiting_requests_mutex};
-    m_requests.insert(m_requests.end(), m_awaiting_requests.begin(), m_awaiting_requests.end());
-    m_awaiting_requests.clear();
+    if (m_scheduler->get_config().coalesce_identical_prompts)
+        _release_coalesced_requests();
+    SequenceGroup::Ptr request;
+    while (m_awaiting_requests.try_pop(request)) {
+        // cancelled before the first schedule, only blocks restored from prefix cache are held
+        if (request->handle_dropped()) {
+            request->push_empty_outputs();
+            _free_request(request);
+            continue;
+        }
+        request->register_dequeue();
+        m_requests.push_back(std::move(request));
+    }
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_maybe_resize_kv_cache() {
+    const auto& config = m_scheduler->get_config();
+    if (config.initial_num_kv_blocks == 0)
+        return;
+
+    size_t num_blocks = m_scheduler->get_total_number_of_kv_blocks(), new_num_blocks = num_blocks;
+    size_t num_required_blocks = m_scheduler->get_num_required_kv_blocks(m_requests);
+    if (m_kv_cache_budget) {
+        new_num_blocks = _get_num_kv_blocks_within_budget(num_blocks, num_required_blocks);
+    } else if (num_required_blocks > num_blocks) {
+        // growing at least twice amortizes copying of the already allocated blocks
+        new_num_blocks = std::min(config.num_kv_blocks, std::max(num_required_blocks, 2 * num_blocks));
+    } else if (config.shrink_kv_cache_when_idle && m_requests.empty() && m_awaiting_requests.empty()) {
+        new_num_blocks = std::min(config.initial_num_kv_blocks, config.num_kv_blocks);
+    }
+    if (new_num_blocks == num_blocks)
+        return;
+
+    static ManualTimer timer("resize KV cache");
+    timer.start();
+    m_cache_manager->resize(new_num_blocks);
+    m_scheduler->resize_kv_cache(new_num_blocks);
+    for (ov::InferRequest& infer_request : m_model_runner->get_infer_requests()) {
+        for (size_t decoder_layer_id = 0; decoder_layer_id < m_cache_manager->get_num_layers(); ++decoder_layer_id) {
+            infer_request.set_tensor(std::string("key_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_key_cache(decoder_layer_id));
+            infer_request.set_tensor(std::string("value_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_value_cache(decoder_layer_id));
+        }
+    }
+    timer.end();
+}
+
+size_t ContinuousBatchingPipeline::ContinuousBatchingImpl::_get_num_kv_blocks_within_budget(size_t num_blocks, size_t num_required_blocks) {
+    const auto& config = m_scheduler->get_config();
+    const size_t block_byte_size = m_cache_manager->get_block_byte_size();
+    if (num_required_blocks > num_blocks) {
+        size_t num_desired_blocks = std::min(config.num_kv_blocks, std::max(num_required_blocks, 2 * num_blocks));
+        size_t num_missing_blocks = std::min(config.num_kv_blocks, num_required_blocks) - num_blocks;
+        // less memory than required is still used, the scheduler preempts sequences which do not fit
+        size_t reserved_bytes = m_kv_cache_budget->reserve(m_kv_cache_budget_consumer_id, num_missing_blocks * block_byte_size,
+                                                           (num_desired_blocks - num_blocks) * block_byte_size, block_byte_size);
+        return num_blocks + reserved_bytes / block_byte_size;
+    }
+
+    m_kv_cache_budget->reset_demand(m_kv_cache_budget_consumer_id);
+    const size_t num_initial_blocks = std::min(config.initial_num_kv_blocks, config.num_kv_blocks);
+    size_t new_num_blocks = num_blocks;
+    if (config.shrink_kv_cache_when_idle && m_requests.empty() && m_awaiting_requests.empty()) {
+        new_num_blocks = std::min(num_blocks, num_initial_blocks);
+    } else if (size_t demand_of_others = m_kv_cache_budget->get_demand_of_others(m_kv_cache_budget_consumer_id); demand_of_others > 0) {
+        // only blocks beyond the last block owned by a sequence can be released, since blocks are not moved
+        size_t num_demanded_blocks = (demand_of_others + block_byte_size - 1) / block_byte_size;
+        new_num_blocks = std::max({num_required_blocks, num_initial_blocks, m_scheduler->get_min_number_of_kv_blocks(),
+                                   num_blocks > num_demanded_blocks ? num_blocks - num_demanded_blocks : size_t(0)});
+        new_num_blocks = std::min(new_num_blocks, num_blocks);
+    }
+    if (new_num_blocks < num_blocks)
+        m_kv_cache_budget->release((num_blocks - new_num_blocks) * block_byte_size);
+    return new_num_blocks;
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::set_kv_cache_budget(std::shared_ptr<KVCacheBudget> budget, size_t consumer_id) {
+    OPENVINO_ASSERT(m_scheduler->get_config().initial_num_kv_blocks > 0, "KV cache budget can be shared only by KV caches growing on demand");
+    const size_t allocated_bytes = m_cache_manager->get_num_allocated_blocks() * m_cache_manager->get_block_byte_size();
+    OPENVINO_ASSERT(budget->reserve(consumer_id, allocated_bytes, allocated_bytes, 1) == allocated_bytes,
+                    "KV cache budget is too small for initially allocated KV cache blocks");
+    m_kv_cache_budget = std::move(budget);
+    m_kv_cache_budget_consumer_id = consumer_id;
+}
+
+bool ContinuousBatchingPipeline::ContinuousBatchingImpl::_is_overloaded() const {
+    const auto& config = m_scheduler->get_config();
+    return (config.max_num_awaiting_requests > 0 && m_awaiting_requests.size() >= config.max_num_awaiting_requests) ||
+           m_last_cache_usage.load() > config.max_cache_usage_for_admission;
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_admit_request(uint64_t request_id) {
+    switch (m_scheduler->get_config().admission_control) {
+    case AdmissionControlMode::DISABLED:
+        break;
+    case AdmissionControlMode::REJECT:
+        OPENVINO_ASSERT(!_is_overloaded(), "Request ", request_id, " is rejected, because the pipeline is overloaded");
+        break;
+    case AdmissionControlMode::BACKPRESSURE: {
+        std::unique_lock<std::mutex> lock(m_admission_mutex);
+        // steps notify waiting threads, while timeout protects from missed notifications
+        while (_is_overloaded()) {
+            m_admission_cv.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        break;
+    }
+    }
 }
 
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::init(
     std::shared_ptr<ov::Model> model,
     const SchedulerConfig& scheduler_config,
     const ov::AnyMap& properties,
-    const DeviceConfig& device_config,
+    DeviceConfig device_config,
     ov::Core& core) {
-    auto compiled_model = core.compile_model(model, device_config.get_device(), properties);
+    ov::AnyMap compile_properties = properties;
+    device_config.apply_kv_cache_hints(compile_properties);
+    const size_t num_inference_streams = scheduler_config.num_inference_streams;
+    OPENVINO_ASSERT(num_inference_streams > 0, "SchedulerConfig::num_inference_streams must be non-zero");
+    if (num_inference_streams > 1) {
+        OPENVINO_ASSERT(device_config.get_device().find("CPU") != std::string::npos || device_config.is_pipeline_parallel(),
+                        "SchedulerConfig::num_inference_streams greater than 1 is supported on CPU or with pipeline_parallel_devices only");
+        OPENVINO_ASSERT(!m_adapter_controller, "SchedulerConfig::num_inference_streams greater than 1 cannot be used with adapters");
+        // insert() keeps a number of streams explicitly passed by user, while HETERO stages infer requests one after another anyway
+        if (!device_config.is_pipeline_parallel())
+            compile_properties.insert(ov::num_streams(static_cast<int32_t>(num_inference_streams)));
+    }
+    bool share_compiled_model = false;
+    if (auto it = compile_properties.find(ov::genai::share_compiled_model.name()); it != compile_properties.end()) {
+        share_compiled_model = it->second.as<bool>();
+        compile_properties.erase(it);
+    }
+    m_compiled_model = share_compiled_model ?
+        utils::compile_shared_model(core, model, device_config.get_compile_device(), compile_properties) :
+        std::make_shared<ov::CompiledModel>(core.compile_model(model, device_config.get_compile_device(), compile_properties));
+    const ov::CompiledModel& compiled_model = *m_compiled_model;
     ov::genai::utils::print_compiled_model_properties(compiled_model, "LLM with Paged Attention");
-    ov::InferRequest infer_request = compiled_model.create_infer_request();
+    if (device_config.is_cache_size_automatic()) {
+        // weights and compilation buffers are allocated already, so KV cache takes the rest except the headroom for activations
+        const float headroom_share = scheduler_config.cache_memory_headroom;
+        OPENVINO_ASSERT(headroom_share >= 0.0f && headroom_share < 1.0f, "SchedulerConfig::cache_memory_headroom must be in [0, 1)");
+        size_t available_bytes = utils::get_available_memory(core, device_config.get_device());
+        if (device_config.is_pipeline_parallel()) {
+            // all layers have the same number of blocks, so the device with the least memory per its layer bounds the cache
+            available_bytes = std::numeric_limits<size_t>::max();
+            for (const auto& stage_device : device_config.get_pipeline_parallel_devices()) {
+                size_t num_stage_layers = 0;
+                for (size_t decoder_layer_id = 0; decoder_layer_id < device_config.get_num_layers(); ++decoder_layer_id)
+                    num_stage_layers += device_config.get_layer_device(decoder_layer_id) == stage_device;
+                if (num_stage_layers > 0)
+                    available_bytes = std::min(available_bytes, utils::get_available_memory(core, stage_device) / num_stage_layers * device_config.get_num_layers());
+            }
+        }
+        if (device_config.get_device().find("GPU") == std::string::npos) {
+            // available host memory counts page cache holding mmapped weights, which KV cache must not push out
+            available_bytes -= std::min(available_bytes, utils::get_model_weights_byte_size(model));
+        }
+        // pipelines sharing the memory, which are created after this one, e.g. draft model or data parallel replicas, take the rest
+        available_bytes = static_cast<size_t>(available_bytes * device_config.get_cache_memory_share());
+        // logits of all scheduled tokens are the largest activation of a step for typical vocabulary sizes
+        const ov::PartialShape logits_shape = compiled_model.output(0).get_partial_shape();
+        const size_t vocab_size = logits_shape.rank().is_static() && logits_shape[logits_shape.rank().get_length() - 1].is_static() ?
+                                  logits_shape[logits_shape.rank().get_length() - 1].get_length() : 0;
+        const size_t headroom_bytes = static_cast<size_t>(available_bytes * headroom_share) +
+                                      scheduler_config.max_num_batched_tokens * vocab_size * sizeof(float);
+        OPENVINO_ASSERT(available_bytes > headroom_bytes, "Not enough free memory on ", device_config.get_device(), " for KV cache: ",
+                        available_bytes, " bytes are free, while ", headroom_bytes, " bytes are left to activations. Set SchedulerConfig::cache_size explicitly");
+        device_config.set_cache_byte_size(available_bytes - headroom_bytes);
+    }
+    std::vector<ov::InferRequest> infer_requests;
+    for (size_t i = 0; i < num_inference_streams; ++i)
+        infer_requests.push_back(compiled_model.create_infer_request());
 
-    // setup KV caches
+    // setup KV caches, which are shared by all infer requests
     m_cache_manager = std::make_shared<CacheManager>(device_config, core);
-    for (size_t decoder_layer_id = 0; decoder_layer_id < device_config.get_num_layers(); ++decoder_layer_id) {
-        infer_request.set_tensor(std::string("key_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_key_cache(decoder_layer_id));
-        infer_request.set_tensor(std::string("value_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_value_cache(decoder_layer_id));
+    for (auto& infer_request : infer_requests) {
+        for (size_t decoder_layer_id = 0; decoder_layer_id < device_config.get_num_layers(); ++decoder_layer_id) {
+            infer_request.set_tensor(std::string("key_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_key_cache(decoder_layer_id));
+            infer_request.set_tensor(std::string("value_cache.") + std::to_string(decoder_layer_id), m_cache_manager->get_value_cache(decoder_layer_id));
+        }
     }
 
     SchedulerConfig updated_config = scheduler_config;
@@ -64,6 +321,8 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::init(
     if (scheduler_config.num_kv_blocks != device_config.get_num_kv_blocks()) {
         updated_config.num_kv_blocks = device_config.get_num_kv_blocks();
     }
+    // update swap blocks number in scheduler config
+    updated_config.num_swap_blocks = device_config.get_num_swap_blocks();
 
     bool can_use_partial_preemption = true;
     if (device_config.get_device().find("GPU") != std::string::npos && !updated_config.dynamic_split_fuse) {
@@ -72,12 +331,44 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::init(
         can_use_partial_preemption = false;
     }
 
+    if (updated_config.attention_window_size > 0) {
+        OPENVINO_ASSERT(!updated_config.enable_prefix_caching, "attention_window_size cannot be used together with prefix caching");
+        OPENVINO_ASSERT(!updated_config.use_cache_eviction, "attention_window_size cannot be used together with cache eviction");
+    }
+    if (updated_config.sparse_decode_block_budget > 0) {
+        // summaries are kept per logical block, which must not be shifted by freed blocks
+        OPENVINO_ASSERT(!updated_config.use_cache_eviction && updated_config.attention_window_size == 0,
+                        "SchedulerConfig::sparse_decode_block_budget cannot be used together with cache eviction and attention_window_size");
+        OPENVINO_ASSERT(num_inference_streams == 1, "SchedulerConfig::sparse_decode_block_budget cannot be used with num_inference_streams greater than 1");
+    }
+
     m_scheduler = std::make_shared<Scheduler>(device_config.get_block_size(), updated_config, device_config.get_num_layers(), can_use_partial_preemption);
+    if (updated_config.enable_prefix_caching && !updated_config.prefix_cache_dir.empty()) {
+        // the fingerprint hashes all weights, so that KV blocks of another model with the same architecture are never loaded
+        m_prefix_cache_storage = std::make_shared<PrefixCacheStorage>(updated_config.prefix_cache_dir, utils::get_model_fingerprint(model),
+                                                                      device_config, updated_config.num_kv_blocks);
+        m_scheduler->add_persistent_blocks(m_prefix_cache_storage->get_blocks());
+    }
     // and finally create model runner
     bool is_use_cache_eviction = m_scheduler->get_config().use_cache_eviction;
-    m_model_runner = std::make_shared<ModelRunner>(infer_request, m_scheduler->get_block_size(), device_config.get_num_layers(), is_use_cache_eviction);
+    m_model_runner = std::make_shared<ModelRunner>(infer_requests.front(), m_scheduler->get_block_size(), device_config.get_num_layers(), is_use_cache_eviction);
+    if (infer_requests.size() > 1) {
+        m_model_runner->set_sub_batch_requests({infer_requests.begin() + 1, infer_requests.end()});
+    }
+    if (m_adapter_controller) {
+        m_model_runner->set_adapter_controller(m_adapter_controller);
+    }
+    if (updated_config.use_host_output_tensors && device_config.get_device().find("GPU") != std::string::npos) {
+        m_model_runner->set_host_output_tensors(core.get_default_context(device_config.get_device()), updated_config.max_num_seqs,
+                                                device_config.get_num_kv_blocks() * device_config.get_block_size());
+    }
+    if (updated_config.sparse_decode_block_budget > 0) {
+        m_model_runner->set_sparse_decode_selector(
+            std::make_shared<SparseDecodeSelector>(m_cache_manager, device_config, updated_config.sparse_decode_block_budget));
+    }
     m_sampler = std::make_shared<Sampler>(m_tokenizer);
     m_sampler->set_seed(m_generation_config.rng_seed);
+    m_sampler->set_parallel_sampling(m_scheduler->get_config().enable_parallel_sampling);
 
     // If eos_token_id was not provided, take value
     if (m_generation_config.eos_token_id == -1)
@@ -89,26 +380,73 @@ GenerationHandle
 ContinuousBatchingPipeline::ContinuousBatchingImpl::add_request(uint64_t request_id,
                                                                const ov::Tensor& input_ids,
                                                                ov::genai::GenerationConfig sampling_params) {
+    _admit_request(request_id);
+    return _add_request(request_id, input_ids, sampling_params);
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::ContinuousBatchingImpl::_add_request(uint64_t request_id,
+                                                                const ov::Tensor& input_ids,
+                                                                ov::genai::GenerationConfig sampling_params,
+                                                                const ov::Tensor& inputs_embeds) {
+    SequenceGroup::Ptr sequence_group = _create_sequence_group(request_id, input_ids, sampling_params, inputs_embeds);
+    auto handle = std::make_shared<GenerationHandleImpl>(sequence_group->get_generation_stream(), sequence_group->get_sampling_parameters());
+    _enqueue_request(sequence_group);
+    return handle;
+}
+
+SequenceGroup::Ptr
+ContinuousBatchingPipeline::ContinuousBatchingImpl::_create_sequence_group(uint64_t request_id,
+                                                                          const ov::Tensor& input_ids,
+                                                                          ov::genai::GenerationConfig sampling_params,
+                                                                          const ov::Tensor& inputs_embeds) {
     // If eos_token_id was not provided, take value from default m_generation_config
     if (sampling_params.eos_token_id == -1)
         sampling_params.set_eos_token_id(m_generation_config.eos_token_id);
     sampling_params.validate();
+    OPENVINO_ASSERT(!sampling_params.adapters || m_adapter_controller,
+                    "Adapters are selected by request ", request_id, ", but the pipeline was not constructed with adapters");
+
+    size_t device_top_k = m_scheduler->get_config().device_top_k;
+    if (device_top_k > 0) {
+        // only device_top_k candidates per token are available on host, so logits processing must not depend on other tokens
+        OPENVINO_ASSERT(sampling_params.is_greedy_decoding() || (sampling_params.is_multinomial() && sampling_params.top_k > 0 && sampling_params.top_k <= device_top_k),
+                        "Only greedy decoding and multinomial sampling with 0 < top_k <= ", device_top_k, " are supported with SchedulerConfig::device_top_k");
+        OPENVINO_ASSERT(sampling_params.repetition_penalty == 1.0f && sampling_params.presence_penalty == 0.0f && sampling_params.frequency_penalty == 0.0f &&
+                        sampling_params.min_new_tokens == 0 && !sampling_params.echo && !sampling_params.is_structured_output(),
+                        "Penalties, min_new_tokens, echo and structured output are not supported with SchedulerConfig::device_top_k");
+    }
+
+    if (sampling_params.is_structured_output()) {
+        // a new expression is compiled by the thread adding the request rather than by the step
+        m_sampler->compile_structured_output(sampling_params);
+    }
 
     SequenceGroup::Ptr sequence_group = std::make_shared<SequenceGroup>(request_id, input_ids,
                                                                         sampling_params,
                                                                         m_scheduler->get_block_size(),
                                                                         m_scheduler->get_config().enable_prefix_caching);
     sequence_group->set_sequence_group_ptr(sequence_group);
-    if (m_scheduler->get_config().enable_prefix_caching) {
-        m_scheduler->restore_cached_blocks(sequence_group);
+    if (inputs_embeds) {
+        // must precede restoring of cached blocks, which are matched by hashes of embeddings
+        sequence_group->set_prompt_embeds(inputs_embeds);
+    }
+    if (m_scheduler->get_config().stream_ring_buffer_size > 0) {
+        sequence_group->get_generation_stream()->enable_ring_buffer(m_scheduler->get_config().stream_ring_buffer_size);
     }
+    return sequence_group;
+}
 
-    {
-        std::lock_guard<std::mutex> lock{m_awaiting_requests_mutex};
-        m_awaiting_requests.push_back(sequence_group);
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_enqueue_request(const SequenceGroup::Ptr& sequence_group) {
+    // echo returns log probabilities of all prompt tokens, which are not computed for tokens restored from the prefix cache
+    if (m_scheduler->get_config().enable_prefix_caching && !sequence_group->get_sampling_parameters().echo) {
+        if (_coalesce_request(sequence_group))
+            return;
+        m_scheduler->restore_cached_blocks(sequence_group);
     }
-    return std::make_shared<GenerationHandleImpl>(sequence_group->get_generation_stream(), sampling_params);
-};
+
+    m_awaiting_requests.push(sequence_group);
+}
 
 GenerationHandle
 ContinuousBatchingPipeline::ContinuousBatchingImpl::add_request(uint64_t request_id,
@@ -122,22 +460,35 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::add_request(uint64_t request
 }
 
 bool ContinuousBatchingPipeline::ContinuousBatchingImpl::has_non_finished_requests() {
-    std::lock_guard<std::mutex> lock{m_awaiting_requests_mutex};
-    return !m_awaiting_requests.empty() || !m_requests.empty();
+    return !m_awaiting_requests.empty() || !m_requests.empty() || m_num_coalesced_requests.load() > 0;
 }
 
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
-    static ManualTimer step_timer("step()");
+    static thread_local ManualTimer step_timer("step()");
     step_timer.start();
 
+    Scheduler::Output scheduler_output;
+    if (_launch_step(scheduler_output)) {
+        _complete_step(scheduler_output);
+    }
+
+    step_timer.end();
+}
+
+bool ContinuousBatchingPipeline::ContinuousBatchingImpl::_launch_step(Scheduler::Output& scheduler_output) {
+    m_step_start_time = std::chrono::steady_clock::now();
     _pull_awaiting_requests();
+    _reclaim_dropped_requests();
 
     m_pipeline_metrics.requests = m_requests.size();
+    m_num_running_requests = m_requests.size();
+    _maybe_resize_kv_cache();
 
-    Scheduler::Output scheduler_output;
     {
-        static ManualTimer timer("scheduling");
+        static thread_local ManualTimer timer("scheduling");
         timer.start();
+        // blocks prefetched during previous step must be ready before they are scheduled or their swap space is reused
+        m_cache_manager->wait_async_swap_in();
         m_scheduler->clean_empty_blocks(m_requests);
         scheduler_output = m_scheduler->schedule(m_requests);
         m_pipeline_metrics.scheduled_requests = scheduler_output.m_scheduled_sequence_groups_ids.size();
@@ -145,8 +496,24 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
         m_pipeline_metrics.max_cache_usage =
             std::max(m_pipeline_metrics.max_cache_usage, scheduler_output.m_cache_usage);
         _register_step_cache_usage(scheduler_output.m_cache_usage);
+        m_last_cache_usage = scheduler_output.m_cache_usage;
+        if (m_scheduler->get_config().admission_control == AdmissionControlMode::BACKPRESSURE)
+            m_admission_cv.notify_all();
         m_pipeline_metrics.avg_cache_usage = _get_current_running_average_cache_usage();
+        m_pipeline_metrics.waiting_requests = m_awaiting_requests.size() + m_num_coalesced_requests.load() + m_requests.size() -
+                                              m_pipeline_metrics.scheduled_requests;
+        m_pipeline_metrics.num_processed_tokens += scheduler_output.m_total_num_scheduled_tokens;
+        m_pipeline_metrics.batch_size.observe(m_pipeline_metrics.scheduled_requests);
+        m_pipeline_metrics.tokens_per_step.observe(scheduler_output.m_total_num_scheduled_tokens);
+        // swapped out blocks may be reused by swapped in or copied blocks, so swap out is performed first
+        m_cache_manager->swap_out(scheduler_output.m_block_swap_out_map);
+        m_cache_manager->swap_in(scheduler_output.m_block_swap_in_map);
+        // partially matched blocks loaded from the persistent storage are copied at the same step, so they are loaded first
+        if (m_prefix_cache_storage)
+            m_prefix_cache_storage->load(scheduler_output.m_persistent_blocks_to_load, *m_cache_manager);
         m_cache_manager->copy_blocks(scheduler_output.m_block_copy_map);
+        // prefetched groups are not scheduled at this step, so their blocks are copied concurrently with inference
+        m_cache_manager->swap_in_async(scheduler_output.m_block_prefetch_map);
         timer.end();
     }
 
@@ -160,14 +527,34 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
             }
         }
         _free_non_running_requests();
-        return;
+        _register_step_metrics(0);
+        return false;
     }
 
+    {
+        static thread_local ManualTimer timer("forward launch");
+        timer.start();
+        m_model_runner->forward_async(m_requests, scheduler_output);
+        timer.end();
+    }
+
+    {
+        // masks of tokens allowed by structured output are computed while the device is busy
+        static thread_local ManualTimer timer("structured output masks");
+        timer.start();
+        m_sampler->prefetch_structured_output_masks(m_requests);
+        timer.end();
+    }
+
+    return true;
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_complete_step(const Scheduler::Output& scheduler_output) {
     ov::Tensor logits;
     {
-        static ManualTimer timer("forward");
+        static thread_local ManualTimer timer("forward");
         timer.start();
-        logits = m_model_runner->forward(m_requests, scheduler_output);
+        logits = m_model_runner->wait_forward(m_requests, scheduler_output);
         timer.end();
     }
 
@@ -177,10 +564,14 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
     dumper.dump_cache_state(*m_scheduler, m_requests, step_count);
 #endif
     const auto& sched_config = m_scheduler->get_config();
+    m_cache_state_dumper.begin_step();
 
     // evict unimportant blocks from KV cache, if requested
     if (sched_config.use_cache_eviction) {
+        static thread_local ManualTimer timer("cache eviction");
+        timer.start();
         maybe_evict_cache_blocks(sched_config);
+        timer.end();
     }
 
 #ifdef DEBUG_CACHE_STATE_DUMP
@@ -188,20 +579,51 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
     dumper_after.dump_cache_state(*m_scheduler, m_requests, step_count);
     step_count++;
 #endif
+    m_cache_state_dumper.end_step(*m_scheduler, m_requests);
 
-    _fill_prompt_log_probs(m_requests, logits);
+    {
+        static thread_local ManualTimer timer("prompt log probs");
+        timer.start();
+        ov::Tensor prompt_log_probs;
+        if (sched_config.device_prompt_log_probs)
+            prompt_log_probs = m_model_runner->get_infer_request().get_tensor("prompt_log_probs");
+        _fill_prompt_log_probs(m_requests, logits, prompt_log_probs);
+        timer.end();
+    }
+
+    // each running sequence of a group, whose prompt is processed, gets a token
+    size_t num_generated_tokens = 0;
+    // whether scheduled groups process prompt tokens and generate tokens at this step, registered after sampling
+    std::vector<std::pair<bool, bool>> scheduled_group_phases;
+    scheduled_group_phases.reserve(scheduler_output.m_scheduled_sequence_groups_ids.size());
+    for (size_t sequence_group_id : scheduler_output.m_scheduled_sequence_groups_ids) {
+        const SequenceGroup::Ptr& sequence_group = m_requests[sequence_group_id];
+        const bool generates_tokens = sequence_group->requires_sampling();
+        if (generates_tokens)
+            num_generated_tokens += sequence_group->num_running_seqs();
+        scheduled_group_phases.emplace_back(sequence_group->get_num_processed_tokens() < sequence_group->get_prompt_len(), generates_tokens);
+    }
 
     SamplerOutput sampler_output;
     {
-        static ManualTimer timer("sample");
+        static thread_local ManualTimer timer("sample");
         timer.start();
-        sampler_output = m_sampler->sample(m_requests, logits, m_is_validation_mode_enabled);
+        // token IDs of the candidates selected on device
+        ov::Tensor logits_indices;
+        if (sched_config.device_top_k > 0)
+            logits_indices = m_model_runner->get_infer_request().get_tensor("logits_indices");
+        sampler_output = m_sampler->sample(m_requests, logits, m_is_validation_mode_enabled, logits_indices);
         timer.end();
     }
 
+    for (size_t i = 0; i < scheduled_group_phases.size(); ++i) {
+        const SequenceGroup::Ptr& sequence_group = m_requests[scheduler_output.m_scheduled_sequence_groups_ids[i]];
+        sequence_group->register_step(m_step_start_time, scheduled_group_phases[i].first, scheduled_group_phases[i].second);
+    }
+
     // process sampler_output (e.g. fork or drop sequences from BlockScheduler)
     {
-        static ManualTimer timer("fork / free sequence");
+        static thread_local ManualTimer timer("fork / free sequence");
         timer.start();
 
         for (const auto& pair : sampler_output.m_forked_sequences) {
@@ -217,9 +639,17 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
         timer.end();
     }
 
+    // recycle blocks which are not attended anymore
+    if (sched_config.attention_window_size > 0) {
+        static thread_local ManualTimer timer("free blocks outside attention window");
+        timer.start();
+        _free_blocks_outside_attention_window(sched_config);
+        timer.end();
+    }
+
     // notify requests dropped by handle
     {
-        static ManualTimer timer("notify requests dropped by handle");
+        static thread_local ManualTimer timer("notify requests dropped by handle");
         timer.start();
         _notify_requests_dropped_by_handle();
         timer.end();
@@ -228,22 +658,44 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::step() {
     // free non running requests for current step
 
     {
-        static ManualTimer timer("free non running requests");
+        static thread_local ManualTimer timer("free non running requests");
         timer.start();
         _free_non_running_requests();
         timer.end();
     }
 
-    step_timer.end();
+    // shrink KV cache, if the last request is finished
+    if (m_requests.empty())
+        _maybe_resize_kv_cache();
+
+    // let the scheduler adjust amount of prompt tokens per step to the observed step latency
+    std::chrono::duration<float, std::milli> step_latency = std::chrono::steady_clock::now() - m_step_start_time;
+    m_scheduler->register_step_latency(step_latency.count());
+
+    m_pipeline_metrics.step_latency_ms.observe(step_latency.count());
+    _register_step_metrics(num_generated_tokens);
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::set_embedding_model(const EmbeddingsModel& embedding) {
+    m_model_runner->set_embedding_model(embedding);
 }
 
 std::vector<EncodedGenerationResult>
 ContinuousBatchingPipeline::ContinuousBatchingImpl::generate(const std::vector<ov::Tensor>& input_ids,
                                                              const std::vector<GenerationConfig>& sampling_params,
                                                              const StreamerVariant& streamer) {
+    return generate(input_ids, {}, sampling_params, streamer);
+}
+
+std::vector<EncodedGenerationResult>
+ContinuousBatchingPipeline::ContinuousBatchingImpl::generate(const std::vector<ov::Tensor>& input_ids,
+                                                             const std::vector<ov::Tensor>& inputs_embeds,
+                                                             const std::vector<GenerationConfig>& sampling_params,
+                                                             const StreamerVariant& streamer) {
     OPENVINO_ASSERT(!has_non_finished_requests(), "Generate cannot be called while ContinuousBatchingPipeline is already in running state. Use ContinuousBatchingPipeline::add_request");
     OPENVINO_ASSERT(input_ids.size() == sampling_params.size());
-    const std::shared_ptr<StreamerBase>& streamer_ptr = std::visit(overloaded{
+    OPENVINO_ASSERT(inputs_embeds.empty() || inputs_embeds.size() == input_ids.size(), "Embeddings must be passed for each prompt or for none of them");
+    std::shared_ptr<StreamerBase> streamer_ptr = std::visit(overloaded{
         [](std::monostate) -> std::shared_ptr<StreamerBase> {
             return nullptr;
         },
@@ -255,41 +707,30 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::generate(const std::vector<o
         }
     }, streamer);
 
-    auto drop_requests = [&] () {
-        for (const std::shared_ptr<ov::genai::SequenceGroup> request : m_requests) {
-            for (const auto& sequence: request->get_sequences()) {
-                if (m_scheduler->has_block_table(sequence->get_id())) {
-                    m_scheduler->free_sequence(sequence->get_id());
-                }
-            }
-            m_sampler->clear_request_info(request->get_request_id());
-        }
-        m_requests.clear();
-    };
-
     OPENVINO_ASSERT(streamer_ptr == nullptr || input_ids.size() == 1 && sampling_params[0].num_return_sequences == 1 &&
         (sampling_params[0].is_greedy_decoding() || sampling_params[0].is_multinomial()),
         "Currently streaming is possible only with batch size=1 and only for greedy or multinomial decoding");
 
+    if (streamer_ptr && sampling_params[0].streamer_queue_size > 0) {
+        streamer_ptr = std::make_shared<ThreadedStreamer>(streamer_ptr, sampling_params[0].streamer_queue_size);
+    }
+
     std::vector<GenerationHandle> generations;
     for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
         OPENVINO_ASSERT(1 == input_ids[request_id].get_shape().at(0), "Use multiple tensors to pass a batch.");
-        generations.push_back(add_request(request_id, input_ids[request_id], sampling_params[request_id]));
+        // admission control is not applied, since requests are processed by the same thread
+        generations.push_back(_add_request(request_id, input_ids[request_id], sampling_params[request_id],
+                                           inputs_embeds.empty() ? ov::Tensor{} : inputs_embeds[request_id]));
     }
-    auto all_requests = m_awaiting_requests; // we need to store all requests to get results from them once generation has finished
+    _pull_awaiting_requests();
+    auto all_requests = _get_all_requests(); // we need to store all requests to get results from them once generation has finished
 
     bool continue_generation = true;
-    while (has_non_finished_requests() && continue_generation) {
-        try {
-            step();
-        } catch (...) {
-            drop_requests(); // remove all requests from pipeline state in case of exception
-            throw;
-        }
-
+    // streams tokens produced by already completed steps
+    auto stream_generated_tokens = [&] () {
         auto & generation = generations.at(0);
-        if (streamer_ptr && generation->can_read()) {
-            std::unordered_map<uint64_t, GenerationOutput> token = generation->back();
+        while (streamer_ptr && continue_generation && generation->can_read()) {
+            std::unordered_map<uint64_t, GenerationOutput> token = generation->read();
             for (const auto& gen_token : token.begin()->second.generated_ids) {
                 continue_generation = !streamer_ptr->put(gen_token);
                 if (!continue_generation) {
@@ -298,14 +739,32 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::generate(const std::vector<o
                 }
             }
         }
+    };
+
+    while (has_non_finished_requests() && continue_generation) {
+        try {
+            // inference of the current step is overlapped with streaming (and thus detokenization) of tokens from the
+            // previous step; if streamer stops generation, current step is wasted, but its results are dropped anyway
+            Scheduler::Output scheduler_output;
+            bool is_launched = _launch_step(scheduler_output);
+            stream_generated_tokens();
+            if (is_launched) {
+                _complete_step(scheduler_output);
+            }
+        } catch (...) {
+            _drop_requests(); // remove all requests from pipeline state in case of exception
+            throw;
+        }
     }
+    // stream tokens of the last step
+    stream_generated_tokens();
 
     if (streamer_ptr) { // push streamer's cache
         streamer_ptr->end();
     }
 
     if (!continue_generation) {
-        drop_requests();
+        _drop_requests();
     } else {
         OPENVINO_ASSERT(m_requests.empty(), "Internal error: current request is supposed to be dropped within step() function as completed");
     }
@@ -314,51 +773,105 @@ ContinuousBatchingPipeline::ContinuousBatchingImpl::generate(const std::vector<o
     results.reserve(all_requests.size());
 
     for (size_t request_id = 0; request_id < all_requests.size(); ++request_id) {
-        const auto& request = all_requests[request_id];
-        auto sampling_params = request->get_sampling_parameters();
-        const auto& sequences = request->get_finished_sequences();
-        size_t num_outputs = std::min(sampling_params.num_return_sequences, sequences.size());
-
-        EncodedGenerationResult result;
-        result.m_request_id = request_id;
-        result.m_generation_ids.resize(num_outputs);
-        result.m_scores.resize(num_outputs);
-
-        for (size_t i = 0; i < num_outputs; ++i) {
-            const auto & sequence = sequences[i];
-            const float score = sampling_params.is_beam_search() ? sequence->get_beam_search_score(sampling_params) : sequence->get_cumulative_log_probs();
-            const auto & generated_ids = sequence->get_generated_ids();
-
-            if (sampling_params.echo)
-                result.m_generation_ids[i] = request->get_prompt_ids();
-            std::copy(generated_ids.begin(), generated_ids.end(), std::back_inserter(result.m_generation_ids[i]));
-            result.m_scores[i] = score;
-        }
-
-        result.m_status = generations[request_id]->get_status();
-        results.push_back(std::move(result));
+        results.push_back(_get_generation_result(all_requests[request_id], generations[request_id]));
     }
 
     OPENVINO_ASSERT(results.size() == input_ids.size());
     return results;
 }
 
+std::vector<SequenceGroup::Ptr> ContinuousBatchingPipeline::ContinuousBatchingImpl::_get_all_requests() {
+    auto all_requests = m_requests;
+    {
+        // requests waiting for identical prompts join m_requests later
+        const std::lock_guard<std::mutex> lock(m_coalesced_prefills_mutex);
+        for (const auto& [prompt_ids, coalesced_prefill] : m_coalesced_prefills)
+            all_requests.insert(all_requests.end(), coalesced_prefill.followers.begin(), coalesced_prefill.followers.end());
+    }
+    std::sort(all_requests.begin(), all_requests.end(), [](const SequenceGroup::Ptr& lhs, const SequenceGroup::Ptr& rhs) {
+        return lhs->get_request_id() < rhs->get_request_id();
+    });
+    return all_requests;
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_drop_requests() {
+    for (const std::shared_ptr<ov::genai::SequenceGroup> request : m_requests) {
+        for (const auto& sequence: request->get_sequences()) {
+            if (m_scheduler->has_block_table(sequence->get_id())) {
+                m_scheduler->free_sequence(sequence->get_id());
+            }
+        }
+        m_sampler->clear_request_info(request->get_request_id());
+    }
+    m_requests.clear();
+    m_num_running_requests = 0;
+    // requests waiting for identical prompts don't hold KV cache blocks yet
+    const std::lock_guard<std::mutex> lock(m_coalesced_prefills_mutex);
+    m_coalesced_prefills.clear();
+    m_num_coalesced_requests = 0;
+}
+
+EncodedGenerationResult ContinuousBatchingPipeline::ContinuousBatchingImpl::_get_generation_result(const SequenceGroup::Ptr& request,
+                                                                                                    const GenerationHandle& generation) {
+    auto sampling_params = request->get_sampling_parameters();
+    const auto& sequences = request->get_finished_sequences();
+    size_t num_outputs = std::min(sampling_params.num_return_sequences, sequences.size());
+
+    EncodedGenerationResult result;
+    result.m_request_id = request->get_request_id();
+    result.m_generation_ids.resize(num_outputs);
+    result.m_scores.resize(num_outputs);
+
+    for (size_t i = 0; i < num_outputs; ++i) {
+        const auto & sequence = sequences[i];
+        const float score = sampling_params.is_beam_search() ? sequence->get_beam_search_score(sampling_params) : sequence->get_cumulative_log_probs();
+        const auto & generated_ids = sequence->get_generated_ids();
+
+        if (sampling_params.echo)
+            result.m_generation_ids[i] = request->get_prompt_ids();
+        std::copy(generated_ids.begin(), generated_ids.end(), std::back_inserter(result.m_generation_ids[i]));
+        result.m_scores[i] = score;
+    }
+
+    result.m_status = generation->get_status();
+    result.m_timings = generation->get_timings();
+    return result;
+}
+
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::_free_non_running_requests() {
     std::vector<SequenceGroup::Ptr>::iterator requests_iterator = m_requests.begin();
     while (requests_iterator != m_requests.end()) {
         const auto& request = *requests_iterator;
         if(request->has_finished() || request->out_of_memory() || request->handle_dropped()) {
-            for (const auto& sequence: request->get_sequences()) {
-                if (m_scheduler->has_block_table(sequence->get_id())) {
-                    m_scheduler->free_sequence(sequence->get_id());
-                }
-            }
-            m_sampler->clear_request_info(request->get_request_id());
+            _free_request(request);
             requests_iterator = m_requests.erase(requests_iterator);
         } else {
             requests_iterator++;
         }
     }
+    m_num_running_requests = m_requests.size();
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_free_request(const SequenceGroup::Ptr& request) {
+    if (request->handle_dropped() && !request->has_finished()) {
+        ++m_pipeline_metrics.num_cancelled_requests;
+        m_pipeline_metrics.num_cancelled_processed_tokens += request->get_num_processed_tokens();
+    }
+    if (request->has_finished())
+        m_scheduler->register_finished_sequence_group(request);
+    for (const auto& sequence: request->get_sequences()) {
+        if (m_scheduler->has_block_table(sequence->get_id())) {
+            m_scheduler->free_sequence(sequence->get_id());
+        }
+    }
+    m_sampler->clear_request_info(request->get_request_id());
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_reclaim_dropped_requests() {
+    if (std::none_of(m_requests.begin(), m_requests.end(), [](const SequenceGroup::Ptr& request) { return request->handle_dropped(); }))
+        return;
+    _notify_requests_dropped_by_handle();
+    _free_non_running_requests();
 }
 
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::_notify_requests_dropped_by_handle() {
@@ -381,6 +894,30 @@ float ContinuousBatchingPipeline::ContinuousBatchingImpl::_get_current_running_a
     return std::accumulate(m_previous_step_cache_usages.begin(), m_previous_step_cache_usages.end(), 0.0) / m_previous_step_cache_usages.size();
 }
 
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_register_step_metrics(size_t num_generated_tokens) {
+    ++m_pipeline_metrics.num_steps;
+    m_pipeline_metrics.num_generated_tokens += num_generated_tokens;
+
+    if (m_previous_step_generated_tokens.size() >= AVG_CACHE_USAGE_WINDOW_SIZE_IN_STEPS) {
+        m_previous_step_generated_tokens.pop_front();
+    }
+    m_previous_step_generated_tokens.emplace_back(m_step_start_time, num_generated_tokens);
+    size_t num_window_tokens = 0;
+    for (const auto& step : m_previous_step_generated_tokens)
+        num_window_tokens += step.second;
+    std::chrono::duration<float> window_duration = std::chrono::steady_clock::now() - m_previous_step_generated_tokens.front().first;
+    m_pipeline_metrics.generated_tokens_per_second = num_window_tokens / window_duration.count();
+
+    m_pipeline_metrics.kv_blocks_total = m_scheduler->get_total_number_of_kv_blocks();
+    m_pipeline_metrics.kv_blocks_free = m_scheduler->get_num_free_kv_blocks();
+    m_pipeline_metrics.kv_blocks_cached = m_scheduler->get_num_cached_kv_blocks();
+    m_pipeline_metrics.num_prefix_cache_queried_tokens = m_scheduler->get_num_prefix_cache_queried_tokens();
+    m_pipeline_metrics.num_prefix_cache_hit_tokens = m_scheduler->get_num_prefix_cache_hit_tokens();
+    m_pipeline_metrics.num_preemptions = m_scheduler->get_num_preemptions();
+
+    _publish_metrics();
+}
+
 void ContinuousBatchingPipeline::ContinuousBatchingImpl::maybe_evict_cache_blocks(const SchedulerConfig& sched_config) {
     std::unordered_map<SequenceGroup::Ptr, size_t> seq_group_to_num_blocks_evicted_map;
     auto sequence_attention_scores = m_model_runner->get_last_attention_scores();
@@ -394,14 +931,17 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::maybe_evict_cache_block
         }
         auto& cache_eviction_algo = m_seq_group_id_to_cache_eviction_algo_map[seq_id];
 
-        cache_eviction_algo.register_new_token_scores(attention_scores_for_all_decoder_layers);
-        auto logical_blocks_to_evict = cache_eviction_algo.evict_logical_blocks();
-
-        m_scheduler->free_blocks_from_sequence(seq_id, logical_blocks_to_evict);
-
         auto seq_group_ptr_it = std::find_if(m_requests.begin(), m_requests.end(), [seq_id](const SequenceGroup::Ptr& val) { return val->has_sequence_with_id(seq_id); });
         OPENVINO_ASSERT(seq_group_ptr_it != m_requests.end(), "could not find sequence group with sequence ", seq_id);
         auto seq_group_ptr = *seq_group_ptr_it;
+
+        // scheduled tokens are not yet accounted as processed at this point
+        bool is_prompt_completed = seq_group_ptr->get_num_processed_tokens() + seq_group_ptr->get_num_scheduled_tokens() >= seq_group_ptr->get_prompt_len();
+        cache_eviction_algo.register_new_token_scores(attention_scores_for_all_decoder_layers, is_prompt_completed);
+        auto logical_blocks_to_evict = cache_eviction_algo.evict_logical_blocks();
+        m_cache_state_dumper.register_eviction(seq_id, logical_blocks_to_evict);
+
+        m_scheduler->free_blocks_from_sequence(seq_id, logical_blocks_to_evict);
         size_t num_blocks_evicted = logical_blocks_to_evict[0].size();
 
         if (seq_group_to_num_blocks_evicted_map.find(seq_group_ptr) != seq_group_to_num_blocks_evicted_map.end()) {
@@ -416,27 +956,63 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::maybe_evict_cache_block
         auto seq_group_ptr = seq_group_ptr_and_num_blocks_evicted.first;
         auto num_blocks_evicted = seq_group_ptr_and_num_blocks_evicted.second;
         seq_group_ptr->register_token_eviction(num_blocks_evicted * m_scheduler->get_block_size());
+        m_pipeline_metrics.num_evicted_blocks += num_blocks_evicted;
+    }
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_free_blocks_outside_attention_window(const SchedulerConfig& sched_config) {
+    const size_t block_size = m_scheduler->get_block_size();
+    const size_t num_sink_blocks = (sched_config.num_attention_sink_tokens + block_size - 1) / block_size;
+    const size_t num_window_blocks = (sched_config.attention_window_size + block_size - 1) / block_size;
+    const size_t num_layers = m_cache_manager->get_num_layers();
+
+    for (const auto& sequence_group : m_requests) {
+        if (sequence_group->is_waiting() || sequence_group->has_finished())
+            continue;
+
+        // only full blocks are freed, so the last partially filled block always stays within the window
+        size_t num_cached_tokens = sequence_group->get_num_processed_tokens() - sequence_group->get_num_evicted_tokens();
+        size_t num_full_blocks = num_cached_tokens / block_size;
+        if (num_full_blocks <= num_sink_blocks + num_window_blocks)
+            continue;
+
+        // logical blocks right after the sinks are the oldest ones, since previously freed blocks are removed from the block table
+        std::set<size_t> logical_blocks_to_free;
+        for (size_t logical_block_idx = num_sink_blocks; logical_block_idx < num_full_blocks - num_window_blocks; ++logical_block_idx)
+            logical_blocks_to_free.insert(logical_block_idx);
+
+        // all sequences of a group have the same number of processed tokens and hence the same layout of the window,
+        // while blocks shared by forked sequences are released once the last sequence frees them
+        std::vector<std::set<size_t>> logical_blocks_to_free_per_layer(num_layers, logical_blocks_to_free);
+        for (const auto& sequence : sequence_group->get_running_sequences())
+            m_scheduler->free_blocks_from_sequence(sequence->get_id(), logical_blocks_to_free_per_layer);
+
+        // ModelRunner then passes past_lens and block indices of the remaining blocks only
+        sequence_group->register_token_eviction(logical_blocks_to_free.size() * block_size);
     }
 }
 
-void ContinuousBatchingPipeline::ContinuousBatchingImpl::_fill_prompt_log_probs(std::vector<SequenceGroup::Ptr>& sequence_groups, ov::Tensor& logits) {
+void ContinuousBatchingPipeline::ContinuousBatchingImpl::_fill_prompt_log_probs(std::vector<SequenceGroup::Ptr>& sequence_groups, ov::Tensor& logits,
+                                                                                const ov::Tensor& prompt_log_probs) {
     const float * logits_data = logits.data<float>();
     ov::Shape logits_shape = logits.get_shape();
     OPENVINO_ASSERT(logits_shape.size() == 3);
     size_t batch_seq_len = logits_shape[1], vocab_size = logits_shape[2];
     for (size_t sequence_group_id = 0, currently_processed_tokens = 0; sequence_group_id < sequence_groups.size(); ++sequence_group_id) {
         SequenceGroup::Ptr sequence_group = sequence_groups[sequence_group_id];
-        // requests not scheduled, in decoding phase or not echoing are not processed
-        if (!sequence_group->is_scheduled() || sequence_group->get_context_len() > sequence_group->get_prompt_len() ||
-            !sequence_group->get_sampling_parameters().echo)
+        if (!sequence_group->is_scheduled())
             continue;
 
         size_t num_running_sequences = sequence_group->num_running_seqs();
-        OPENVINO_ASSERT(num_running_sequences == 1);
         size_t actual_seq_len = sequence_group->get_num_scheduled_tokens();
         size_t padded_amount_of_processed_tokens = std::max(actual_seq_len, batch_seq_len);
+        size_t group_logits_offset = currently_processed_tokens;
+        currently_processed_tokens += padded_amount_of_processed_tokens * num_running_sequences;
 
-        const float * sequence_group_logits_data = logits_data + vocab_size * currently_processed_tokens;
+        // requests in decoding phase or not echoing are not processed
+        if (sequence_group->get_context_len() > sequence_group->get_prompt_len() || !sequence_group->get_sampling_parameters().echo)
+            continue;
+        OPENVINO_ASSERT(num_running_sequences == 1);
 
         size_t num_prompt_tokens_processed = sequence_group->get_num_processed_tokens();
         OPENVINO_ASSERT(num_prompt_tokens_processed + actual_seq_len <= sequence_group->get_prompt_len());
@@ -451,33 +1027,33 @@ void ContinuousBatchingPipeline::ContinuousBatchingImpl::_fill_prompt_log_probs(
         if (num_prompt_tokens_processed == 0)
             sequence_group->append_prompt_log_prob(1.0);
 
-        for (int token_logits_offset = 0, token_id_offset = num_prompt_tokens_processed + 1;
-             token_logits_offset < actual_seq_len - exclude_last_logprob;
-             token_logits_offset++, token_id_offset++) {
-
-            const float* token_logits = (sequence_group_logits_data + token_logits_offset * vocab_size);
-            int64_t token_id = sequence_group->get_prompt_ids()[token_id_offset];
-            float token_logit = token_logits[token_id];
-
-            // find max value for log softmax
-            float max_value = -std::numeric_limits<float>::infinity();
-            size_t max_index = 0;
-            for (size_t i = 0; i < vocab_size; ++i) {
-                if (token_logits[i] > max_value) {
-                    max_value = token_logits[i];
-                    max_index = i;
-                }
-            }
-
-            // apply log softmax to token logit
-            float log_sum = std::log(std::accumulate(
-                token_logits, token_logits + vocab_size, 0.0f, [max_value](float accumulated, float to_add) {
-                    return accumulated + std::exp(to_add - max_value);
-            }));
-
-            sequence_group->append_prompt_log_prob(token_logit - max_value - log_sum);
+        const size_t num_log_probs = actual_seq_len - exclude_last_logprob;
+        if (prompt_log_probs) {
+            // already computed on device for the next prompt token of each position
+            const float* prompt_log_probs_data = prompt_log_probs.data<const float>() + group_logits_offset;
+            for (size_t token_logits_offset = 0; token_logits_offset < num_log_probs; ++token_logits_offset)
+                sequence_group->append_prompt_log_prob(prompt_log_probs_data[token_logits_offset]);
+        } else {
+            const float * sequence_group_logits_data = logits_data + vocab_size * group_logits_offset;
+            const auto& prompt_ids = sequence_group->get_prompt_ids();
+            m_prompt_log_probs_buffer.resize(num_log_probs);
+            // positions are independent, each one is a pass of plain reductions over contiguous logits
+            ov::parallel_for(num_log_probs, [&] (size_t token_logits_offset) {
+                const float* token_logits = sequence_group_logits_data + token_logits_offset * vocab_size;
+                int64_t token_id = prompt_ids[num_prompt_tokens_processed + 1 + token_logits_offset];
+
+                float max_value = -std::numeric_limits<float>::infinity();
+                for (size_t i = 0; i < vocab_size; ++i)
+                    max_value = std::max(max_value, token_logits[i]);
+                float sum_exp = 0.0f;
+                for (size_t i = 0; i < vocab_size; ++i)
+                    sum_exp += std::exp(token_logits[i] - max_value);
+
+                m_prompt_log_probs_buffer[token_logits_offset] = token_logits[token_id] - max_value - std::log(sum_exp);
+            });
+            for (size_t token_logits_offset = 0; token_logits_offset < num_log_probs; ++token_logits_offset)
+                sequence_group->append_prompt_log_prob(m_prompt_log_probs_buffer[token_logits_offset]);
         }
-        currently_processed_tokens += padded_amount_of_processed_tokens * num_running_sequences;
         // For max_new_tokens == 0, we don't reach sampling so need to notify handle separately
         if(sequence_group->get_sampling_parameters().max_new_tokens == 0) {
             sequence_group->notify_handle_echo_only();
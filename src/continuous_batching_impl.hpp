@@ -3,9 +3,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
 #include "continuous_batching_impl_interface.hpp"
 #include "openvino/genai/continuous_batching_pipeline.hpp"
 #include "cache_eviction.hpp"
+#include "cache_state_dumper.hpp"
+#include "prefix_cache_storage.hpp"
+#include "kv_cache_budget.hpp"
+#include "mpsc_queue.hpp"
 
 namespace ov::genai {
 class ContinuousBatchingPipeline::ContinuousBatchingImpl : public ContinuousBatchingPipeline::ImplInterface {
@@ -13,45 +22,147 @@ protected:
     std::shared_ptr<Scheduler> m_scheduler;
     std::shared_ptr<CacheManager> m_cache_manager;
     std::shared_ptr<ModelRunner> m_model_runner;
+    // kept alive, so that other pipelines reuse it, see ov::genai::share_compiled_model
+    std::shared_ptr<ov::CompiledModel> m_compiled_model;
+    // applies adapters of each request to its tokens, so that requests with different adapters share a single inference
+    AdapterController m_adapter_controller;
     std::shared_ptr<Sampler> m_sampler;
+    // persistent storage of prefix cached KV blocks, used only if SchedulerConfig::prefix_cache_dir is set
+    std::shared_ptr<PrefixCacheStorage> m_prefix_cache_storage;
 
     // current requests to process
     std::vector<SequenceGroup::Ptr> m_requests;
     // requests added to the pipeline that will be added to m_requests in the next iteration
-    std::vector<SequenceGroup::Ptr> m_awaiting_requests;
-    // Mutex protecting access to m_awaiting_requests, so add_request and step methods can be called from different threads
-    std::mutex m_awaiting_requests_mutex;
+    // add_request and step methods can be called from different threads, add_request can be called from several threads at once
+    MPSCQueue<SequenceGroup::Ptr> m_awaiting_requests;
+
+    // requests waiting for the prefill of a request with the identical prompt, see SchedulerConfig::coalesce_identical_prompts
+    struct CoalescedPrefill {
+        SequenceGroup::Ptr leader;
+        std::vector<SequenceGroup::Ptr> followers;
+    };
+    // keyed by prompt cache IDs, accessed by threads adding requests and by the step thread
+    std::map<TokenIds, CoalescedPrefill> m_coalesced_prefills;
+    std::mutex m_coalesced_prefills_mutex;
+    std::atomic<size_t> m_num_coalesced_requests{0};
+
+    // KV cache usage reported by the last step, used by admission control of new requests
+    std::atomic<float> m_last_cache_usage{0.0f};
+    // size of m_requests, which can be read from threads adding requests
+    std::atomic<size_t> m_num_running_requests{0};
+    // notified after each step when admission control is in BACKPRESSURE mode
+    std::mutex m_admission_mutex;
+    std::condition_variable m_admission_cv;
 
     std::map<size_t, CacheEvictionAlgorithm> m_seq_group_id_to_cache_eviction_algo_map;
 
     static const size_t AVG_CACHE_USAGE_WINDOW_SIZE_IN_STEPS = 1000;
     std::deque<float> m_previous_step_cache_usages;
+    // start times and numbers of generated tokens of the latest steps, which give generation throughput
+    std::deque<std::pair<std::chrono::steady_clock::time_point, size_t>> m_previous_step_generated_tokens;
+
+    // start time of the step launched by `_launch_step`
+    std::chrono::steady_clock::time_point m_step_start_time;
     
+    // log probabilities of prompt tokens of a sequence group computed by host, reused across steps
+    std::vector<float> m_prompt_log_probs_buffer;
+
+    // memory budget shared with other pipelines, from which KV cache grown on demand reserves memory; nullptr if KV cache grows independently
+    std::shared_ptr<KVCacheBudget> m_kv_cache_budget;
+    size_t m_kv_cache_budget_consumer_id = 0;
+
     // flag to enable validation mode for sampler
     bool m_is_validation_mode_enabled = false;
 
+    // number of KV cache blocks a sequence keeps after rejected candidates are rolled back, in pipelines drafting or validating candidates;
+    // covers rollback of a draft up to a block long, which may free the partially filled block and the full one before it
+    static constexpr size_t NUM_RESERVED_TAIL_BLOCKS = 2;
+
 #ifdef DEBUG_CACHE_STATE_DUMP
     size_t step_count = 0;
 #endif
+    // sampled binary dumps of KV cache state, enabled by OPENVINO_GENAI_CACHE_DUMP environment variable
+    BinaryCacheStateDumper m_cache_state_dumper;
 
     // used by tests only
     ContinuousBatchingImpl() = default;
 
     void _free_non_running_requests();
+    // frees KV cache blocks and sampler state of a request, which leaves the pipeline
+    void _free_request(const SequenceGroup::Ptr& request);
     void _notify_requests_dropped_by_handle();
+    // frees all requests of the pipeline, e.g. when generate() is stopped by streamer or fails
+    void _drop_requests();
+    // current requests including the ones waiting for prefills of identical prompts, sorted by request ID
+    std::vector<SequenceGroup::Ptr> _get_all_requests();
+    // result of a request processed by generate(), which is finished or dropped
+    static EncodedGenerationResult _get_generation_result(const SequenceGroup::Ptr& request, const GenerationHandle& generation);
+    // frees requests dropped by handle since the end of the previous step, before they are scheduled again
+    void _reclaim_dropped_requests();
     void _register_step_cache_usage(float step_cache_usage);
     float _get_current_running_average_cache_usage() const;
+    // updates metrics, which are collected at the end of a step, and publishes them
+    void _register_step_metrics(size_t num_generated_tokens);
     void maybe_evict_cache_blocks(const SchedulerConfig& sched_config);
+    // frees KV cache blocks of running sequences, which are between attention sinks and SchedulerConfig::attention_window_size latest tokens
+    void _free_blocks_outside_attention_window(const SchedulerConfig& sched_config);
 
     void init(std::shared_ptr<ov::Model> model,
               const SchedulerConfig& scheduler_config,
               const ov::AnyMap& plugin_config,
-              const DeviceConfig& device_config,
+              DeviceConfig device_config,
               ov::Core& core);
 
     virtual void _pull_awaiting_requests();
 
-    void _fill_prompt_log_probs(std::vector<SequenceGroup::Ptr>& sequence_groups, ov::Tensor& logits);
+    // registers a request in m_coalesced_prefills, returns true if it has to wait for the prefill of an identical prompt
+    bool _coalesce_request(const SequenceGroup::Ptr& sequence_group);
+    // moves requests, which waited for prefills completed since the last call, to m_requests
+    void _release_coalesced_requests();
+
+    // grows KV cache grown on demand, when current requests need more blocks than allocated, or shrinks it, when idle
+    // or when other pipelines sharing the KV cache budget lack memory
+    void _maybe_resize_kv_cache();
+    // returns the number of KV cache blocks, to which KV cache should be resized within the shared budget
+    size_t _get_num_kv_blocks_within_budget(size_t num_blocks, size_t num_required_blocks);
+
+    bool _is_overloaded() const;
+    // applies SchedulerConfig::admission_control to a new request
+    void _admit_request(uint64_t request_id);
+    // inputs_embeds, if set, are passed to the model for the prompt instead of embeddings of input_ids, see SequenceGroup::set_prompt_embeds
+    GenerationHandle _add_request(uint64_t request_id, const ov::Tensor& input_ids, ov::genai::GenerationConfig sampling_params,
+                                  const ov::Tensor& inputs_embeds = {});
+    // first part of `_add_request`: validates sampling parameters and creates a sequence group, which is not scheduled yet
+    SequenceGroup::Ptr _create_sequence_group(uint64_t request_id, const ov::Tensor& input_ids, ov::genai::GenerationConfig sampling_params,
+                                              const ov::Tensor& inputs_embeds = {});
+    // second part of `_add_request`: restores cached prompt blocks of a sequence group and passes it to the next step
+    void _enqueue_request(const SequenceGroup::Ptr& sequence_group);
+
+    /**
+     * First part of `step()`: pulls awaiting requests, schedules them and launches asynchronous inference,
+     * so the caller may perform CPU work independent from the current step results while the device is busy.
+     * @param scheduler_output Filled with scheduling results, which must be passed to `_complete_step`.
+     * @return Whether inference was launched. If not, nothing was scheduled and `_complete_step` must not be called.
+     */
+    bool _launch_step(Scheduler::Output& scheduler_output);
+
+    /**
+     * Second part of `step()`: waits for the inference launched by `_launch_step`, samples next tokens and frees finished requests.
+     */
+    void _complete_step(const Scheduler::Output& scheduler_output);
+
+    /**
+     * Appends log probabilities of prompt tokens processed by the current step to sequence groups with GenerationConfig::echo.
+     * @param sequence_groups Current requests.
+     * @param logits Logits of the current step.
+     * @param prompt_log_probs If not empty, log probabilities of the next token for each row of logits computed on device.
+     */
+    void _fill_prompt_log_probs(std::vector<SequenceGroup::Ptr>& sequence_groups, ov::Tensor& logits, const ov::Tensor& prompt_log_probs = {});
+
+    // steps of replicas are interleaved by the data parallel pipeline
+    friend class ContinuousBatchingPipeline::DataParallelImpl;
+    // KV cache blocks of prompts are transferred from the prefill instance to the decode instance
+    friend class ContinuousBatchingPipeline::DisaggregatedImpl;
 public:
     ContinuousBatchingImpl(const std::shared_ptr<ov::Model>& model,
                            const Tokenizer& tokenizer,
@@ -59,7 +170,10 @@ public:
                            const std::string& device,
                            const ov::AnyMap& properties,
                            const ov::genai::GenerationConfig& generation_config,
-                           bool is_validation_mode_enabled = false);
+                           bool is_validation_mode_enabled = false,
+                           float cache_memory_share = 1.0f);
+
+    ~ContinuousBatchingImpl() override;
 
     GenerationHandle add_request(uint64_t request_id,
                                  const ov::Tensor& input_ids,
@@ -76,5 +190,51 @@ public:
     generate(const std::vector<ov::Tensor>& input_ids,
              const std::vector<GenerationConfig>& sampling_params,
              const StreamerVariant& streamer) override;
+
+    /**
+     * Generates for prompts, whose embeddings are computed by the caller, e.g. with embeddings of images merged by a VLM.
+     * Requires a model with `inputs_embeds` input and an embeddings model set by `set_embedding_model` for generated tokens.
+     * @param input_ids Prompt IDs of shape [1, prompt_len], which identify positions for prefix caching and penalties.
+     * @param inputs_embeds Prompt embeddings of shape [1, prompt_len, hidden_size] for each prompt, or empty.
+     */
+    std::vector<EncodedGenerationResult>
+    generate(const std::vector<ov::Tensor>& input_ids,
+             const std::vector<ov::Tensor>& inputs_embeds,
+             const std::vector<GenerationConfig>& sampling_params,
+             const StreamerVariant& streamer);
+
+    /**
+     * Sets the model embedding tokens for a model taking `inputs_embeds` instead of `input_ids`, see ModelRunner::set_embedding_model.
+     */
+    void set_embedding_model(const EmbeddingsModel& embedding);
+
+    /**
+     * @return Number of requests added to the pipeline, which are not finished yet. Can be called from any thread.
+     */
+    size_t get_num_requests() const {
+        return m_awaiting_requests.size() + m_num_coalesced_requests.load() + m_num_running_requests.load();
+    }
+
+    /**
+     * @return KV cache usage in percents reported by the last step. Can be called from any thread.
+     */
+    float get_last_cache_usage() const {
+        return m_last_cache_usage.load();
+    }
+
+    /**
+     * Makes KV cache grown on demand reserve memory from a budget shared with other pipelines instead of growing up to its own
+     * limit independently. Blocks allocated so far are reserved immediately.
+     * @param budget Shared budget. KV cache still never grows beyond SchedulerConfig::num_kv_blocks of this pipeline.
+     * @param consumer_id ID of this pipeline, unique among pipelines sharing the budget.
+     */
+    void set_kv_cache_budget(std::shared_ptr<KVCacheBudget> budget, size_t consumer_id);
+
+    /**
+     * @return Number of leading prompt tokens, which can be restored from the prefix cache. Can be called from any thread.
+     */
+    size_t get_num_prefix_cached_tokens(const TokenIds& prompt_ids) {
+        return m_scheduler->get_num_prefix_cached_tokens(prompt_ids);
+    }
 };
 }
\ No newline at end of file
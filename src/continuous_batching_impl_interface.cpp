@@ -10,7 +10,11 @@ GenerationConfig ContinuousBatchingPipeline::ImplInterface::get_config() const {
 }
 
 PipelineMetrics ContinuousBatchingPipeline::ImplInterface::get_metrics() const {
-    return m_pipeline_metrics;
+    return *std::atomic_load(&m_published_metrics);
+}
+
+void ContinuousBatchingPipeline::ImplInterface::_publish_metrics() {
+    std::atomic_store(&m_published_metrics, std::shared_ptr<const PipelineMetrics>(std::make_shared<PipelineMetrics>(m_pipeline_metrics)));
 }
 
 Tokenizer ContinuousBatchingPipeline::ImplInterface::get_tokenizer() {
@@ -69,7 +73,8 @@ ContinuousBatchingPipeline::ImplInterface::generate(
             res.m_request_id,
             std::move(generated),
             std::move(res.m_scores),
-            res.m_status
+            res.m_status,
+            std::move(res.m_timings)
         });
     }
     return decoded;
@@ -20,7 +20,12 @@ protected:
     // and pipeline only uses default rng_seed and some special tokens.
     ov::genai::GenerationConfig m_generation_config;
 
+    // metrics updated by steps, which are published to get_metrics() by _publish_metrics()
     PipelineMetrics m_pipeline_metrics;
+    // the latest published snapshot, which is replaced as a whole, so readers from other threads never block steps
+    std::shared_ptr<const PipelineMetrics> m_published_metrics = std::make_shared<PipelineMetrics>();
+
+    void _publish_metrics();
 
     struct PerfTime {
         float m_paged_attention_time_ms = 0.0f;
@@ -39,6 +44,8 @@ protected:
     ChatHistory m_history;
 
 public:
+    virtual ~ImplInterface() = default;
+
     ov::genai::GenerationConfig get_config() const;
     PipelineMetrics get_metrics() const;
     ov::genai::Tokenizer get_tokenizer();
@@ -1,9 +1,13 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
+#include <numeric>
+#include <optional>
 #include <memory>
+#include <sstream>
 #include <openvino/runtime/properties.hpp>
 
 #include "openvino/genai/continuous_batching_pipeline.hpp"
@@ -12,6 +16,9 @@
 #include "continuous_batching_impl.hpp"
 #include "speculative_decoding/speculative_decoding_impl.hpp"
 #include "prompt_lookup/prompt_lookup_impl.hpp"
+#include "medusa/medusa_impl.hpp"
+#include "data_parallel/data_parallel_impl.hpp"
+#include "disaggregated/disaggregated_impl.hpp"
 #include "timer.hpp"
 #include "utils.hpp"
 #include "debug_utils.hpp"
@@ -39,24 +46,114 @@ extract_prompt_lookup_from_config(ov::AnyMap& config) {
     return res;
 }
 
+inline size_t
+extract_self_speculative_num_layers_from_config(ov::AnyMap& config) {
+    size_t num_layers = 0;
+    if (config.find(ov::genai::self_speculative_num_layers.name()) != config.end()) {
+        num_layers = config.at(ov::genai::self_speculative_num_layers.name()).as<size_t>();
+        config.erase(ov::genai::self_speculative_num_layers.name());
+    }
+    return num_layers;
+}
+
+// draft model of self-speculative decoding is the main model, which exits after the first decoder layers
+inline void
+create_self_speculative_draft_model(ov::genai::ModelDesc& draft_model_desc, size_t num_layers, bool is_prompt_lookup_enabled,
+                                    const std::shared_ptr<ov::Model>& model, const ov::genai::Tokenizer& tokenizer,
+                                    const ov::genai::GenerationConfig& generation_config) {
+    if (num_layers == 0)
+        return;
+    OPENVINO_ASSERT(draft_model_desc.model == nullptr && !is_prompt_lookup_enabled,
+                    "Self-speculative decoding cannot be combined with a draft model or prompt lookup decoding");
+    draft_model_desc = ov::genai::ModelDesc(model->clone(), tokenizer, {}, {}, {}, generation_config);
+    draft_model_desc.num_early_exit_layers = num_layers;
+}
+
+inline std::shared_ptr<ov::Model>
+extract_medusa_heads_from_config(ov::AnyMap& config) {
+    std::shared_ptr<ov::Model> heads_model;
+    if (config.find(ov::genai::medusa_heads.name()) != config.end()) {
+        heads_model = utils::singleton_core().read_model(config.at(ov::genai::medusa_heads.name()).as<std::string>());
+        config.erase(ov::genai::medusa_heads.name());
+    }
+    return heads_model;
+}
+
+inline std::vector<std::string>
+extract_data_parallel_devices_from_config(ov::AnyMap& config) {
+    std::vector<std::string> devices;
+    if (config.find(ov::genai::data_parallel_devices.name()) != config.end()) {
+        devices = config.at(ov::genai::data_parallel_devices.name()).as<std::vector<std::string>>();
+        config.erase(ov::genai::data_parallel_devices.name());
+    }
+    return devices;
+}
+
+inline std::optional<SchedulerConfig>
+extract_prefill_scheduler_config_from_config(ov::AnyMap& config) {
+    std::optional<SchedulerConfig> prefill_scheduler_config;
+    if (config.find(ov::genai::prefill_scheduler_config.name()) != config.end()) {
+        prefill_scheduler_config = config.at(ov::genai::prefill_scheduler_config.name()).as<SchedulerConfig>();
+        config.erase(ov::genai::prefill_scheduler_config.name());
+    }
+    return prefill_scheduler_config;
+}
+
+inline std::string
+extract_prefill_device_from_config(ov::AnyMap& config, const std::string& device) {
+    std::string prefill_device = device;
+    if (config.find(ov::genai::prefill_device.name()) != config.end()) {
+        prefill_device = config.at(ov::genai::prefill_device.name()).as<std::string>();
+        config.erase(ov::genai::prefill_device.name());
+    }
+    return prefill_device;
+}
+
 ContinuousBatchingPipeline::ContinuousBatchingPipeline( const std::filesystem::path& models_path,
                                                         const SchedulerConfig& scheduler_config,
                                                         const std::string& device,
                                                         const ov::AnyMap& properties,
                                                         const ov::AnyMap& tokenizer_properties) {
-    auto properties_without_draft_model = properties;
+    ov::AnyMap pipeline_properties = properties;
+    const bool fast_startup = utils::extract_fast_startup(pipeline_properties, models_path);
+    auto properties_without_draft_model = pipeline_properties;
     auto draft_model_desr = extract_draft_model_from_config(properties_without_draft_model);
     auto is_prompt_lookup_enabled = extract_prompt_lookup_from_config(properties_without_draft_model);
+    auto data_parallel_devices = extract_data_parallel_devices_from_config(properties_without_draft_model);
+    auto self_speculative_num_layers = extract_self_speculative_num_layers_from_config(properties_without_draft_model);
+    auto medusa_heads_model = extract_medusa_heads_from_config(properties_without_draft_model);
+    auto prefill_scheduler_config = extract_prefill_scheduler_config_from_config(properties_without_draft_model);
+    auto prefill_device = extract_prefill_device_from_config(properties_without_draft_model, device);
     
     std::filesystem::path openvino_model_name = "openvino_model.xml";
     auto model = utils::singleton_core().read_model((models_path / openvino_model_name).string());
-    auto tokenizer = ov::genai::Tokenizer(models_path, tokenizer_properties);
+    ov::AnyMap updated_tokenizer_properties = tokenizer_properties;
+    if (fast_startup) {
+        // the tokenizer is loaded while the LLM is compiled
+        updated_tokenizer_properties.insert(ov::genai::deferred_load(true));
+    }
+    auto tokenizer = ov::genai::Tokenizer(models_path, updated_tokenizer_properties);
     auto generation_config = utils::from_config_json_if_exists(models_path);
-    if (is_prompt_lookup_enabled) {
+    create_self_speculative_draft_model(draft_model_desr, self_speculative_num_layers, is_prompt_lookup_enabled, model, tokenizer, generation_config);
+    if (!data_parallel_devices.empty()) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Data parallel pipeline cannot be combined with speculative decoding or prompt lookup decoding");
+        OPENVINO_ASSERT(!prefill_scheduler_config, "Data parallel pipeline cannot be combined with disaggregated prefill");
+        m_impl = std::make_shared<DataParallelImpl>(model, tokenizer, scheduler_config, data_parallel_devices, properties_without_draft_model, generation_config);
+    } else if (prefill_scheduler_config) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Disaggregated prefill cannot be combined with speculative decoding or prompt lookup decoding");
+        m_impl = std::make_shared<DisaggregatedImpl>(model, tokenizer, *prefill_scheduler_config, prefill_device, scheduler_config, device,
+                                                     properties_without_draft_model, generation_config);
+    } else if (medusa_heads_model) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled,
+                        "Medusa heads cannot be combined with a draft model or prompt lookup decoding");
+        m_impl = std::make_shared<MedusaImpl>(model, medusa_heads_model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
+    } else if (is_prompt_lookup_enabled) {
         OPENVINO_ASSERT(draft_model_desr.model == nullptr, "Speculative decoding and prompt lookup decoding are mutually excluded");
         m_impl = std::make_shared<PromptLookupImpl>(model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
     } else if (draft_model_desr.model == nullptr) {
-        m_impl = std::make_shared<ContinuousBatchingImpl>(model, tokenizer, scheduler_config, device, properties, generation_config);
+        m_impl = std::make_shared<ContinuousBatchingImpl>(model, tokenizer, scheduler_config, device, pipeline_properties, generation_config);
     } else {
         auto main_model_descr = ov::genai::ModelDesc(model, tokenizer, device, properties_without_draft_model, scheduler_config, generation_config);
         m_impl = std::make_shared<SpeculativeDecodingImpl>(main_model_descr, draft_model_desr);
@@ -72,11 +169,31 @@ ContinuousBatchingPipeline::ContinuousBatchingPipeline(
     auto properties_without_draft_model = properties;
     auto draft_model_desr = extract_draft_model_from_config(properties_without_draft_model);
     auto is_prompt_lookup_enabled = extract_prompt_lookup_from_config(properties_without_draft_model);
+    auto data_parallel_devices = extract_data_parallel_devices_from_config(properties_without_draft_model);
+    auto self_speculative_num_layers = extract_self_speculative_num_layers_from_config(properties_without_draft_model);
+    auto medusa_heads_model = extract_medusa_heads_from_config(properties_without_draft_model);
+    auto prefill_scheduler_config = extract_prefill_scheduler_config_from_config(properties_without_draft_model);
+    auto prefill_device = extract_prefill_device_from_config(properties_without_draft_model, device);
     std::filesystem::path openvino_model_name = "openvino_model.xml";
     auto model = utils::singleton_core().read_model((models_path / openvino_model_name).string());
     auto generation_config = utils::from_config_json_if_exists(models_path);
+    create_self_speculative_draft_model(draft_model_desr, self_speculative_num_layers, is_prompt_lookup_enabled, model, tokenizer, generation_config);
 
-    if (is_prompt_lookup_enabled) {
+    if (!data_parallel_devices.empty()) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Data parallel pipeline cannot be combined with speculative decoding or prompt lookup decoding");
+        OPENVINO_ASSERT(!prefill_scheduler_config, "Data parallel pipeline cannot be combined with disaggregated prefill");
+        m_impl = std::make_shared<DataParallelImpl>(model, tokenizer, scheduler_config, data_parallel_devices, properties_without_draft_model, generation_config);
+    } else if (prefill_scheduler_config) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Disaggregated prefill cannot be combined with speculative decoding or prompt lookup decoding");
+        m_impl = std::make_shared<DisaggregatedImpl>(model, tokenizer, *prefill_scheduler_config, prefill_device, scheduler_config, device,
+                                                     properties_without_draft_model, generation_config);
+    } else if (medusa_heads_model) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled,
+                        "Medusa heads cannot be combined with a draft model or prompt lookup decoding");
+        m_impl = std::make_shared<MedusaImpl>(model, medusa_heads_model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
+    } else if (is_prompt_lookup_enabled) {
         OPENVINO_ASSERT(draft_model_desr.model == nullptr, "Speculative decoding and prompt lookup decoding are mutually excluded");
         m_impl = std::make_shared<PromptLookupImpl>(model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
     } else if (draft_model_desr.model == nullptr) {
@@ -98,9 +215,29 @@ ContinuousBatchingPipeline::ContinuousBatchingPipeline(
     auto properties_without_draft_model = properties;
     auto draft_model_desr = extract_draft_model_from_config(properties_without_draft_model);
     auto is_prompt_lookup_enabled = extract_prompt_lookup_from_config(properties_without_draft_model);
+    auto data_parallel_devices = extract_data_parallel_devices_from_config(properties_without_draft_model);
+    auto self_speculative_num_layers = extract_self_speculative_num_layers_from_config(properties_without_draft_model);
+    auto medusa_heads_model = extract_medusa_heads_from_config(properties_without_draft_model);
+    auto prefill_scheduler_config = extract_prefill_scheduler_config_from_config(properties_without_draft_model);
+    auto prefill_device = extract_prefill_device_from_config(properties_without_draft_model, device);
     auto model = utils::singleton_core().read_model(model_str, weights_tensor);
+    create_self_speculative_draft_model(draft_model_desr, self_speculative_num_layers, is_prompt_lookup_enabled, model, tokenizer, generation_config);
 
-    if (is_prompt_lookup_enabled) {
+    if (!data_parallel_devices.empty()) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Data parallel pipeline cannot be combined with speculative decoding or prompt lookup decoding");
+        OPENVINO_ASSERT(!prefill_scheduler_config, "Data parallel pipeline cannot be combined with disaggregated prefill");
+        m_impl = std::make_shared<DataParallelImpl>(model, tokenizer, scheduler_config, data_parallel_devices, properties_without_draft_model, generation_config);
+    } else if (prefill_scheduler_config) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled && !medusa_heads_model,
+                        "Disaggregated prefill cannot be combined with speculative decoding or prompt lookup decoding");
+        m_impl = std::make_shared<DisaggregatedImpl>(model, tokenizer, *prefill_scheduler_config, prefill_device, scheduler_config, device,
+                                                     properties_without_draft_model, generation_config);
+    } else if (medusa_heads_model) {
+        OPENVINO_ASSERT(draft_model_desr.model == nullptr && !is_prompt_lookup_enabled,
+                        "Medusa heads cannot be combined with a draft model or prompt lookup decoding");
+        m_impl = std::make_shared<MedusaImpl>(model, medusa_heads_model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
+    } else if (is_prompt_lookup_enabled) {
         OPENVINO_ASSERT(draft_model_desr.model == nullptr, "Speculative decoding and prompt lookup decoding are mutually excluded");
         m_impl = std::make_shared<PromptLookupImpl>(model, tokenizer, scheduler_config, device, properties_without_draft_model, generation_config);
     } else if (draft_model_desr.model == nullptr) {
@@ -154,3 +291,154 @@ void ContinuousBatchingPipeline::start_chat(const std::string& system_message) {
 void ContinuousBatchingPipeline::finish_chat() {
     m_impl->finish_chat();
 };
+
+void ContinuousBatchingPipeline::warmup(const WarmupConfig& config) {
+    OPENVINO_ASSERT(!m_impl->has_non_finished_requests(), "warmup() cannot be called while requests are processed");
+    // infer requests of tokenizer and detokenizer are compiled on first use as well
+    Tokenizer tokenizer = m_impl->get_tokenizer();
+    tokenizer.decode(tokenizer.encode("Warmup").input_ids);
+
+    GenerationConfig generation_config = m_impl->get_config();
+    generation_config.max_new_tokens = config.max_new_tokens;
+    generation_config.ignore_eos = true;
+    size_t seed = 0;
+    for (size_t batch_size : config.batch_sizes) {
+        for (size_t prompt_length : config.prompt_lengths) {
+            // each prompt is a separate request, which are scheduled together as a batch
+            ov::Tensor batch_input_ids = utils::create_warmup_input_ids(batch_size, prompt_length, seed++);
+            std::vector<ov::Tensor> input_ids;
+            for (size_t row = 0; row < batch_size; ++row) {
+                input_ids.emplace_back(ov::element::i64, ov::Shape{1, prompt_length}, batch_input_ids.data<int64_t>() + row * prompt_length);
+            }
+            m_impl->generate(input_ids, std::vector<GenerationConfig>(batch_size, generation_config), std::monostate{});
+        }
+    }
+}
+
+std::vector<ScoringResult> ContinuousBatchingPipeline::score(const std::vector<ov::Tensor>& input_ids,
+                                                             const std::vector<size_t>& target_offsets,
+                                                             bool return_log_probs) {
+    OPENVINO_ASSERT(!m_impl->has_non_finished_requests(), "score() cannot be called while requests are processed");
+    OPENVINO_ASSERT(target_offsets.empty() || target_offsets.size() == input_ids.size(),
+                    "Number of target offsets (", target_offsets.size(), ") must match the number of prompts (", input_ids.size(), ")");
+
+    // echo returns log probabilities of prompt tokens, while requests without new tokens finish right after their prompts
+    GenerationConfig scoring_config;
+    scoring_config.max_new_tokens = 0;
+    scoring_config.echo = true;
+    scoring_config.set_eos_token_id(m_impl->get_config().eos_token_id);
+
+    std::vector<GenerationHandle> handles;
+    handles.reserve(input_ids.size());
+    for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
+        const size_t target_offset = target_offsets.empty() ? 1 : target_offsets[request_id];
+        OPENVINO_ASSERT(target_offset > 0 && target_offset <= input_ids[request_id].get_size(),
+                        "Target offset ", target_offset, " of prompt ", request_id, " must be in [1, ", input_ids[request_id].get_size(), "]");
+        handles.push_back(m_impl->add_request(request_id, input_ids[request_id], scoring_config));
+    }
+    while (m_impl->has_non_finished_requests()) {
+        m_impl->step();
+    }
+
+    std::vector<ScoringResult> results(input_ids.size());
+    for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
+        OPENVINO_ASSERT(handles[request_id]->get_status() == GenerationStatus::FINISHED,
+                        "Prompt ", request_id, " is not scored, since its KV cache does not fit into the cache");
+        const std::vector<GenerationOutput> outputs = handles[request_id]->read_all();
+        OPENVINO_ASSERT(outputs.size() == 1);
+        // the first element is a placeholder for the first token, which has no context
+        const std::vector<float>& log_probs = outputs[0].generated_log_probs;
+        OPENVINO_ASSERT(log_probs.size() == input_ids[request_id].get_size());
+
+        const size_t target_offset = target_offsets.empty() ? 1 : target_offsets[request_id];
+        results[request_id].sum_log_prob = std::accumulate(log_probs.begin() + target_offset, log_probs.end(), 0.0f);
+        if (return_log_probs)
+            results[request_id].log_probs.assign(log_probs.begin() + target_offset, log_probs.end());
+    }
+    return results;
+}
+
+std::vector<ScoringResult> ContinuousBatchingPipeline::score(const std::vector<std::string>& contexts,
+                                                             const std::vector<std::string>& continuations,
+                                                             bool return_log_probs) {
+    OPENVINO_ASSERT(contexts.size() == continuations.size(),
+                    "Number of contexts (", contexts.size(), ") must match the number of continuations (", continuations.size(), ")");
+    Tokenizer tokenizer = m_impl->get_tokenizer();
+    std::vector<ov::Tensor> input_ids;
+    std::vector<size_t> target_offsets;
+    input_ids.reserve(contexts.size());
+    target_offsets.reserve(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        ov::Tensor context_ids = tokenizer.encode(contexts[i]).input_ids;
+        ov::Tensor continuation_ids = tokenizer.encode(continuations[i], ov::genai::add_special_tokens(false)).input_ids;
+        OPENVINO_ASSERT(context_ids.get_size() > 0, "Context ", i, " must produce at least one token");
+
+        ov::Tensor prompt_ids(ov::element::i64, {1, context_ids.get_size() + continuation_ids.get_size()});
+        std::copy_n(context_ids.data<const int64_t>(), context_ids.get_size(), prompt_ids.data<int64_t>());
+        std::copy_n(continuation_ids.data<const int64_t>(), continuation_ids.get_size(), prompt_ids.data<int64_t>() + context_ids.get_size());
+        input_ids.push_back(prompt_ids);
+        target_offsets.push_back(context_ids.get_size());
+    }
+    return score(input_ids, target_offsets, return_log_probs);
+}
+
+MetricsHistogram::MetricsHistogram(std::vector<double> upper_bounds) :
+    upper_bounds(std::move(upper_bounds)),
+    counts(this->upper_bounds.size() + 1, 0) {
+    OPENVINO_ASSERT(std::is_sorted(this->upper_bounds.begin(), this->upper_bounds.end()), "Histogram bucket bounds must be sorted");
+}
+
+void MetricsHistogram::observe(double value) {
+    size_t bucket = std::lower_bound(upper_bounds.begin(), upper_bounds.end(), value) - upper_bounds.begin();
+    ++counts[bucket];
+    sum += value;
+    ++count;
+}
+
+std::string PipelineMetrics::to_prometheus(const std::string& prefix) const {
+    std::ostringstream out;
+    auto write_metric = [&](const std::string& name, const char* type, double value) {
+        out << "# TYPE " << prefix << "_" << name << " " << type << "\n";
+        out << prefix << "_" << name << " " << value << "\n";
+    };
+    auto write_histogram = [&](const std::string& name, const MetricsHistogram& histogram) {
+        const std::string full_name = prefix + "_" + name;
+        out << "# TYPE " << full_name << " histogram\n";
+        size_t cumulative_count = 0;
+        for (size_t i = 0; i < histogram.counts.size(); ++i) {
+            cumulative_count += histogram.counts[i];
+            out << full_name << "_bucket{le=\"";
+            if (i < histogram.upper_bounds.size())
+                out << histogram.upper_bounds[i];
+            else
+                out << "+Inf";
+            out << "\"} " << cumulative_count << "\n";
+        }
+        out << full_name << "_sum " << histogram.sum << "\n";
+        out << full_name << "_count " << histogram.count << "\n";
+    };
+
+    write_metric("requests", "gauge", requests);
+    write_metric("waiting_requests", "gauge", waiting_requests);
+    write_metric("scheduled_requests", "gauge", scheduled_requests);
+    write_metric("cache_usage_percent", "gauge", cache_usage);
+    write_metric("max_cache_usage_percent", "gauge", max_cache_usage);
+    write_metric("avg_cache_usage_percent", "gauge", avg_cache_usage);
+    write_metric("kv_blocks_total", "gauge", kv_blocks_total);
+    write_metric("kv_blocks_free", "gauge", kv_blocks_free);
+    write_metric("kv_blocks_cached", "gauge", kv_blocks_cached);
+    write_metric("prefix_cache_queried_tokens_total", "counter", num_prefix_cache_queried_tokens);
+    write_metric("prefix_cache_hit_tokens_total", "counter", num_prefix_cache_hit_tokens);
+    write_metric("preemptions_total", "counter", num_preemptions);
+    write_metric("evicted_blocks_total", "counter", num_evicted_blocks);
+    write_metric("cancelled_requests_total", "counter", num_cancelled_requests);
+    write_metric("cancelled_processed_tokens_total", "counter", num_cancelled_processed_tokens);
+    write_metric("steps_total", "counter", num_steps);
+    write_metric("processed_tokens_total", "counter", num_processed_tokens);
+    write_metric("generated_tokens_total", "counter", num_generated_tokens);
+    write_metric("generated_tokens_per_second", "gauge", generated_tokens_per_second);
+    write_histogram("step_latency_ms", step_latency_ms);
+    write_histogram("batch_size", batch_size);
+    write_histogram("tokens_per_step", tokens_per_step);
+    return out.str();
+}
@@ -0,0 +1,244 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "data_parallel_impl.hpp"
+#include "generation_stream.hpp"
+#include "text_callback_streamer.hpp"
+#include "timer.hpp"
+
+namespace ov::genai {
+template<class... Ts> struct overloaded : Ts... {using Ts::operator()...;};
+template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+ContinuousBatchingPipeline::DataParallelImpl::DataParallelImpl(const std::shared_ptr<ov::Model>& model,
+                                                               const Tokenizer& tokenizer,
+                                                               const SchedulerConfig& scheduler_config,
+                                                               const std::vector<std::string>& devices,
+                                                               const ov::AnyMap& properties,
+                                                               const ov::genai::GenerationConfig& generation_config) {
+    OPENVINO_ASSERT(!devices.empty(), "At least one device must be specified for data parallel pipeline");
+    m_tokenizer = tokenizer;
+    // replicas on CPU share host memory, as well as replicas on the same device
+    auto get_memory_domain = [](const std::string& device) {
+        return device.find("GPU") == std::string::npos ? std::string("HOST") : device;
+    };
+    for (size_t replica_idx = 0; replica_idx < devices.size(); ++replica_idx) {
+        SchedulerConfig replica_config = scheduler_config;
+        if (!scheduler_config.prefix_cache_dir.empty()) {
+            // replicas of the same layout would otherwise overwrite each other's stored blocks
+            replica_config.prefix_cache_dir = (std::filesystem::path(scheduler_config.prefix_cache_dir) / ("replica_" + std::to_string(replica_idx))).string();
+        }
+        // paged attention transformations modify the model in place, so each replica transforms its own copy
+        auto replica_model = replica_idx + 1 < devices.size() ? model->clone() : model;
+        // automatically sized KV caches of replicas sharing memory are created one after another, so each one takes
+        // an equal part of memory left by the previous ones
+        const size_t num_sharing_replicas = std::count_if(devices.begin() + replica_idx, devices.end(), [&](const std::string& device) {
+            return get_memory_domain(device) == get_memory_domain(devices[replica_idx]);
+        });
+        m_replicas.push_back(std::make_shared<ContinuousBatchingImpl>(replica_model, tokenizer, replica_config, devices[replica_idx],
+                                                                      properties, generation_config, false, 1.0f / num_sharing_replicas));
+    }
+    m_generation_config = m_replicas.front()->get_config();
+}
+
+size_t ContinuousBatchingPipeline::DataParallelImpl::_select_replica(const ov::Tensor& input_ids) {
+    std::vector<size_t> num_requests(m_replicas.size());
+    for (size_t replica_idx = 0; replica_idx < m_replicas.size(); ++replica_idx) {
+        num_requests[replica_idx] = m_replicas[replica_idx]->get_num_requests();
+    }
+    // prefix cache affinity is preferred only while it does not unbalance the replicas too much
+    size_t min_num_requests = *std::min_element(num_requests.begin(), num_requests.end());
+    size_t max_num_requests = min_num_requests + std::max<size_t>(1, min_num_requests / 4);
+
+    const int64_t* input_ids_data = input_ids.data<const int64_t>();
+    TokenIds prompt_ids(input_ids_data, input_ids_data + input_ids.get_size());
+
+    size_t best_replica_idx = 0, best_num_cached_tokens = 0;
+    float best_cache_usage = 0.0f;
+    bool is_found = false;
+    size_t first_replica_idx = m_next_replica_idx++;
+    for (size_t i = 0; i < m_replicas.size(); ++i) {
+        size_t replica_idx = (first_replica_idx + i) % m_replicas.size();
+        if (num_requests[replica_idx] > max_num_requests)
+            continue;
+        size_t num_cached_tokens = m_replicas[replica_idx]->get_num_prefix_cached_tokens(prompt_ids);
+        float cache_usage = m_replicas[replica_idx]->get_last_cache_usage();
+        bool is_better = !is_found || num_cached_tokens > best_num_cached_tokens ||
+            (num_cached_tokens == best_num_cached_tokens && (num_requests[replica_idx] < num_requests[best_replica_idx] ||
+            (num_requests[replica_idx] == num_requests[best_replica_idx] && cache_usage < best_cache_usage)));
+        if (is_better) {
+            best_replica_idx = replica_idx;
+            best_num_cached_tokens = num_cached_tokens;
+            best_cache_usage = cache_usage;
+            is_found = true;
+        }
+    }
+    return best_replica_idx;
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::DataParallelImpl::add_request(uint64_t request_id,
+                                                          const ov::Tensor& input_ids,
+                                                          ov::genai::GenerationConfig sampling_params) {
+    return m_replicas[_select_replica(input_ids)]->add_request(request_id, input_ids, sampling_params);
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::DataParallelImpl::add_request(uint64_t request_id,
+                                                          const std::string& prompt,
+                                                          ov::genai::GenerationConfig sampling_params) {
+    static ManualTimer timer("tokenize");
+    timer.start();
+    ov::Tensor input_ids = m_tokenizer.encode(prompt).input_ids;
+    timer.end();
+    return add_request(request_id, input_ids, sampling_params);
+}
+
+bool ContinuousBatchingPipeline::DataParallelImpl::has_non_finished_requests() {
+    return std::any_of(m_replicas.begin(), m_replicas.end(), [](const std::shared_ptr<ContinuousBatchingImpl>& replica) {
+        return replica->has_non_finished_requests();
+    });
+}
+
+void ContinuousBatchingPipeline::DataParallelImpl::step() {
+    // all replicas launch inference before any of them waits for results, so that devices work concurrently
+    std::vector<Scheduler::Output> scheduler_outputs(m_replicas.size());
+    std::vector<bool> is_launched(m_replicas.size(), false);
+    for (size_t replica_idx = 0; replica_idx < m_replicas.size(); ++replica_idx) {
+        if (m_replicas[replica_idx]->has_non_finished_requests())
+            is_launched[replica_idx] = m_replicas[replica_idx]->_launch_step(scheduler_outputs[replica_idx]);
+    }
+    for (size_t replica_idx = 0; replica_idx < m_replicas.size(); ++replica_idx) {
+        if (is_launched[replica_idx])
+            m_replicas[replica_idx]->_complete_step(scheduler_outputs[replica_idx]);
+    }
+    _update_metrics();
+}
+
+void ContinuousBatchingPipeline::DataParallelImpl::_update_metrics() {
+    auto merge_histogram = [](MetricsHistogram& histogram, const MetricsHistogram& replica_histogram) {
+        for (size_t i = 0; i < histogram.counts.size(); ++i)
+            histogram.counts[i] += replica_histogram.counts[i];
+        histogram.sum += replica_histogram.sum;
+        histogram.count += replica_histogram.count;
+    };
+
+    PipelineMetrics metrics;
+    for (const auto& replica : m_replicas) {
+        PipelineMetrics replica_metrics = replica->get_metrics();
+        metrics.requests += replica_metrics.requests;
+        metrics.scheduled_requests += replica_metrics.scheduled_requests;
+        metrics.cache_usage += replica_metrics.cache_usage / m_replicas.size();
+        metrics.max_cache_usage = std::max(metrics.max_cache_usage, replica_metrics.max_cache_usage);
+        metrics.avg_cache_usage += replica_metrics.avg_cache_usage / m_replicas.size();
+        metrics.waiting_requests += replica_metrics.waiting_requests;
+        metrics.kv_blocks_total += replica_metrics.kv_blocks_total;
+        metrics.kv_blocks_free += replica_metrics.kv_blocks_free;
+        metrics.kv_blocks_cached += replica_metrics.kv_blocks_cached;
+        metrics.num_prefix_cache_queried_tokens += replica_metrics.num_prefix_cache_queried_tokens;
+        metrics.num_prefix_cache_hit_tokens += replica_metrics.num_prefix_cache_hit_tokens;
+        metrics.num_preemptions += replica_metrics.num_preemptions;
+        metrics.num_evicted_blocks += replica_metrics.num_evicted_blocks;
+        metrics.num_cancelled_requests += replica_metrics.num_cancelled_requests;
+        metrics.num_cancelled_processed_tokens += replica_metrics.num_cancelled_processed_tokens;
+        // replicas are stepped together, so a step of the pipeline is a step of each replica
+        metrics.num_steps = std::max(metrics.num_steps, replica_metrics.num_steps);
+        metrics.num_processed_tokens += replica_metrics.num_processed_tokens;
+        metrics.num_generated_tokens += replica_metrics.num_generated_tokens;
+        metrics.generated_tokens_per_second += replica_metrics.generated_tokens_per_second;
+        merge_histogram(metrics.step_latency_ms, replica_metrics.step_latency_ms);
+        merge_histogram(metrics.batch_size, replica_metrics.batch_size);
+        merge_histogram(metrics.tokens_per_step, replica_metrics.tokens_per_step);
+    }
+    m_pipeline_metrics = metrics;
+    _publish_metrics();
+}
+
+std::vector<EncodedGenerationResult>
+ContinuousBatchingPipeline::DataParallelImpl::generate(const std::vector<ov::Tensor>& input_ids,
+                                                       const std::vector<GenerationConfig>& sampling_params,
+                                                       const StreamerVariant& streamer) {
+    OPENVINO_ASSERT(!has_non_finished_requests(), "Generate cannot be called while ContinuousBatchingPipeline is already in running state. Use ContinuousBatchingPipeline::add_request");
+    OPENVINO_ASSERT(input_ids.size() == sampling_params.size());
+    const std::shared_ptr<StreamerBase>& streamer_ptr = std::visit(overloaded{
+        [](std::monostate) -> std::shared_ptr<StreamerBase> {
+            return nullptr;
+        },
+        [](const std::shared_ptr<StreamerBase>& streamer) {
+            return streamer;
+        },
+        [this](const std::function<bool(std::string)>& streamer) -> std::shared_ptr<StreamerBase> {
+            return std::make_unique<TextCallbackStreamer>(m_tokenizer, streamer);
+        }
+    }, streamer);
+
+    OPENVINO_ASSERT(streamer_ptr == nullptr || input_ids.size() == 1 && sampling_params[0].num_return_sequences == 1 &&
+        (sampling_params[0].is_greedy_decoding() || sampling_params[0].is_multinomial()),
+        "Currently streaming is possible only with batch size=1 and only for greedy or multinomial decoding");
+
+    std::vector<GenerationHandle> generations;
+    for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
+        OPENVINO_ASSERT(1 == input_ids[request_id].get_shape().at(0), "Use multiple tensors to pass a batch.");
+        // admission control is not applied, since requests are processed by the same thread
+        auto& replica = m_replicas[_select_replica(input_ids[request_id])];
+        generations.push_back(replica->_add_request(request_id, input_ids[request_id], sampling_params[request_id]));
+    }
+    // requests are spread over the replicas, results are built from their sequence groups once generation has finished
+    std::vector<SequenceGroup::Ptr> all_requests;
+    for (auto& replica : m_replicas) {
+        replica->_pull_awaiting_requests();
+        auto replica_requests = replica->_get_all_requests();
+        all_requests.insert(all_requests.end(), replica_requests.begin(), replica_requests.end());
+    }
+    std::sort(all_requests.begin(), all_requests.end(), [](const SequenceGroup::Ptr& lhs, const SequenceGroup::Ptr& rhs) {
+        return lhs->get_request_id() < rhs->get_request_id();
+    });
+    OPENVINO_ASSERT(all_requests.size() == generations.size());
+
+    bool continue_generation = true;
+    auto stream_generated_tokens = [&] () {
+        auto& generation = generations.at(0);
+        while (streamer_ptr && continue_generation && generation->can_read()) {
+            GenerationOutputs outputs = generation->read();
+            for (const auto& gen_token : outputs.begin()->second.generated_ids) {
+                continue_generation = !streamer_ptr->put(gen_token);
+                if (!continue_generation) {
+                    generation->drop();
+                    break;
+                }
+            }
+        }
+    };
+    auto drop_requests = [&] () {
+        for (auto& replica : m_replicas) {
+            replica->_drop_requests();
+        }
+    };
+
+    while (has_non_finished_requests() && continue_generation) {
+        try {
+            step();
+        } catch (...) {
+            drop_requests(); // remove all requests from replicas' state in case of exception
+            throw;
+        }
+        stream_generated_tokens();
+    }
+
+    if (streamer_ptr) { // push streamer's cache
+        streamer_ptr->end();
+    }
+
+    if (!continue_generation) {
+        drop_requests();
+    }
+
+    std::vector<EncodedGenerationResult> results;
+    results.reserve(all_requests.size());
+    for (size_t request_id = 0; request_id < all_requests.size(); ++request_id) {
+        results.push_back(ContinuousBatchingImpl::_get_generation_result(all_requests[request_id], generations[request_id]));
+    }
+    return results;
+}
+
+}
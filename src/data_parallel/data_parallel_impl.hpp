@@ -0,0 +1,51 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "openvino/genai/continuous_batching_pipeline.hpp"
+#include "continuous_batching_impl.hpp"
+
+namespace ov::genai {
+
+/**
+ * @brief Data parallel pipeline, which owns several ContinuousBatchingImpl replicas, usually on different devices,
+ * and routes each new request to a single replica. A request is routed to the replica with the longest prefix of its prompt
+ * in the prefix cache, as long as that replica is not much more loaded than the least loaded one; ties are broken by the number
+ * of requests and then by KV cache usage. Steps of all replicas are interleaved, so that the devices infer concurrently.
+ */
+class ContinuousBatchingPipeline::DataParallelImpl : public ContinuousBatchingPipeline::ImplInterface {
+protected:
+    std::vector<std::shared_ptr<ContinuousBatchingImpl>> m_replicas;
+    // rotates the order in which replicas are considered, so that equally suitable replicas get requests in turn
+    std::atomic<size_t> m_next_replica_idx{0};
+
+    size_t _select_replica(const ov::Tensor& input_ids);
+    void _update_metrics();
+
+public:
+    DataParallelImpl(const std::shared_ptr<ov::Model>& model,
+                     const Tokenizer& tokenizer,
+                     const SchedulerConfig& scheduler_config,
+                     const std::vector<std::string>& devices,
+                     const ov::AnyMap& properties,
+                     const ov::genai::GenerationConfig& generation_config);
+
+    GenerationHandle add_request(uint64_t request_id,
+                                 const ov::Tensor& input_ids,
+                                 ov::genai::GenerationConfig sampling_params) override;
+    GenerationHandle add_request(uint64_t request_id,
+                                 const std::string& prompt,
+                                 ov::genai::GenerationConfig sampling_params) override;
+
+    bool has_non_finished_requests() override;
+
+    void step() override;
+
+    std::vector<EncodedGenerationResult>
+    generate(const std::vector<ov::Tensor>& input_ids,
+             const std::vector<GenerationConfig>& sampling_params,
+             const StreamerVariant& streamer) override;
+};
+
+}
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "openvino/runtime/core.hpp"
 #include "openvino/core/shape.hpp"
 #include "openvino/core/type/element_type.hpp"
@@ -12,20 +15,63 @@
 namespace ov::genai {
 class DeviceConfig {
     ov::element::Type m_kv_cache_type;
+    // precisions of keys and values, which may differ from m_kv_cache_type if set explicitly in SchedulerConfig
+    ov::element::Type m_key_cache_type, m_value_cache_type;
+    size_t m_key_cache_group_size = 0, m_value_cache_group_size = 0;
     ov::Shape m_key_cache_shape, m_value_cache_shape;
     ov::Shape::value_type m_num_kv_heads, m_head_size, m_num_decoder_layers;
+    // sizes of the innermost dimension of key and value caches, including scales and zero points of quantized caches
+    ov::Shape::value_type m_key_head_size = 0, m_value_head_size = 0;
     size_t m_num_kv_blocks = 0;
     size_t m_block_size = 0;
     size_t m_cache_size = 0;
+    size_t m_num_swap_blocks = 0;
+    size_t m_swap_space = 0;
+    size_t m_initial_num_kv_blocks = 0;
+    // number of KV cache blocks is computed from free memory after compilation of the model
+    bool m_is_cache_size_automatic = false;
+    bool m_is_numa_interleaved_cache = false;
+    // share of automatically measured free memory taken by KV cache, the rest is left to pipelines created later on the same memory
+    float m_cache_memory_share = 1.0f;
     std::string m_device;
+    // devices of stages and of each decoder layer, if layers are split between devices, see ov::genai::pipeline_parallel_devices
+    std::vector<std::string> m_pipeline_parallel_devices;
+    std::vector<std::string> m_layer_devices;
 
-    size_t get_block_size_by_device(const std::string& device) const {
+    size_t get_block_size_by_device(const std::string& device, size_t requested_block_size) const {
         const size_t cpu_block_size = 32;
         const size_t gpu_block_size = 16;
 
         bool is_gpu = device.find("GPU") != std::string::npos;
+        if (requested_block_size == 0)
+            return is_gpu ? gpu_block_size : cpu_block_size;
+
+        if (is_gpu) {
+            OPENVINO_ASSERT(requested_block_size == gpu_block_size, "KV cache block size ", requested_block_size, " is not supported on ", device,
+                            ", paged attention kernels of GPU support block size ", gpu_block_size, " only");
+        } else {
+            const bool is_power_of_two = (requested_block_size & (requested_block_size - 1)) == 0;
+            OPENVINO_ASSERT(is_power_of_two && requested_block_size >= 16 && requested_block_size <= 256,
+                            "KV cache block size must be a power of 2 from 16 to 256 on ", device, ", while ", requested_block_size, " is requested");
+        }
+        return requested_block_size;
+    }
+
+    static bool is_quantized(ov::element::Type type) {
+        return type == ov::element::u8 || type == ov::element::u4;
+    }
 
-        return is_gpu ? gpu_block_size : cpu_block_size;
+    // Scale, zero point and quantized data are stored together.
+    // The layout for per token per head:
+    // |scale(f32)|zeropoint(f32)|quantized data(group_1)|...|scale(f32)|zeropoint(f32)|quantized data(group_N)|
+    // so, head_size is extended by sizeof(float) for scale and sizeof(float) for zeropoint of each group, expressed in elements of the cache type
+    size_t get_head_size_with_scales(ov::element::Type type, size_t group_size) const {
+        if (m_device != "CPU" || !is_quantized(type))
+            return m_head_size;
+        group_size = group_size == 0 ? m_head_size : group_size;
+        OPENVINO_ASSERT(m_head_size % group_size == 0, "Head size ", m_head_size, " is not divisible by KV cache group size ", group_size);
+        const size_t scales_bits = 2 * sizeof(float) * 8;
+        return m_head_size + (m_head_size / group_size) * scales_bits / type.bitwidth();
     }
 
 public:
@@ -33,7 +79,7 @@ public:
         m_device = device;
 
         // keep information about blocsk
-        m_block_size = get_block_size_by_device(device);
+        m_block_size = get_block_size_by_device(device, scheduling_config.block_size);
 
         if (m_device == "CPU") {
             auto inference_precision = core.get_property(device, ov::hint::inference_precision);
@@ -80,13 +126,36 @@ public:
             OPENVINO_THROW(m_device, " is not supported by OpenVINO Continuous Batching");
         }
 
-        OPENVINO_ASSERT(scheduling_config.num_kv_blocks > 0 || scheduling_config.cache_size > 0, "num_kv_blocks or cache_size should be more than zero.");
+        m_key_cache_type = m_value_cache_type = m_kv_cache_type;
+        if (scheduling_config.key_cache_precision != ov::element::undefined)
+            m_key_cache_type = scheduling_config.key_cache_precision;
+        if (scheduling_config.value_cache_precision != ov::element::undefined)
+            m_value_cache_type = scheduling_config.value_cache_precision;
+        for (const auto type : {m_key_cache_type, m_value_cache_type}) {
+            OPENVINO_ASSERT(m_device == "CPU" || !is_quantized(type), "Quantized KV cache is supported only on CPU, while ", type, " is requested for ", m_device);
+            OPENVINO_ASSERT(type == ov::element::f32 || type == ov::element::f16 || type == ov::element::bf16 || is_quantized(type),
+                            "Unsupported KV cache precision ", type);
+        }
+        m_key_cache_group_size = scheduling_config.key_cache_group_size;
+        m_value_cache_group_size = scheduling_config.value_cache_group_size;
+
         if (scheduling_config.num_kv_blocks > 0) {
             m_num_kv_blocks = scheduling_config.num_kv_blocks;
         }
         else {
             m_cache_size = scheduling_config.cache_size;
         }
+        m_is_cache_size_automatic = m_num_kv_blocks == 0 && m_cache_size == 0;
+
+        if (scheduling_config.preemption_mode == PreemptionMode::SWAP) {
+            OPENVINO_ASSERT(scheduling_config.num_swap_blocks > 0 || scheduling_config.swap_space > 0,
+                "num_swap_blocks or swap_space should be more than zero for SWAP preemption mode.");
+            m_num_swap_blocks = scheduling_config.num_swap_blocks;
+            m_swap_space = scheduling_config.swap_space;
+        }
+
+        m_initial_num_kv_blocks = scheduling_config.initial_num_kv_blocks;
+        m_is_numa_interleaved_cache = scheduling_config.numa_interleave_kv_cache;
     }
 
     void set_model_params(size_t num_kv_heads, size_t head_size, size_t num_decoder_layers) {
@@ -94,42 +163,135 @@ public:
         m_head_size = head_size;
         m_num_decoder_layers = num_decoder_layers;
 
-        if (m_device == "CPU") {
-            // Scale, zero point and quantized data will be stored together.
-            // The layout for per token per head:
-            // |scale(f32)|zeropoint(f32)|quantized data(u8,idx_1)|quantized data(u8,idx_2)|...|quantized data(u8,idx_head_size)|
-            // so, we have to extend head_size by 8, which is sizeof(float)
-            // for scale and sizeof(float) for zeropoint
-            if (m_kv_cache_type == ov::element::u8)
-                m_head_size += 8;
-        }
+        m_key_head_size = get_head_size_with_scales(m_key_cache_type, m_key_cache_group_size);
+        m_value_head_size = get_head_size_with_scales(m_value_cache_type, m_value_cache_group_size);
 
-        if (m_num_kv_blocks == 0) {
-            OPENVINO_ASSERT(m_cache_size > 0, "num_kv_blocks or cache_size should be more than zero.");
+        if (m_num_kv_blocks == 0 && m_cache_size > 0) {
             size_t size_in_bytes = m_cache_size * 1024 * 1024 * 1024;
-            m_num_kv_blocks = size_in_bytes / (m_num_decoder_layers * 2 * m_num_kv_heads * m_block_size * m_head_size * m_kv_cache_type.size());
+            m_num_kv_blocks = size_in_bytes / get_block_byte_size();
         }
 
-        m_key_cache_shape = m_value_cache_shape = ov::Shape{m_num_kv_blocks,
-                                                            m_num_kv_heads,
-                                                            m_block_size,
-                                                            m_head_size};
+        if (m_num_swap_blocks == 0 && m_swap_space > 0) {
+            size_t size_in_bytes = m_swap_space * 1024 * 1024 * 1024;
+            m_num_swap_blocks = size_in_bytes / get_block_byte_size();
+        }
+
+        // the number of blocks is dynamic in the model, so automatically sized cache has 0 blocks until set_cache_byte_size()
+        update_cache_shapes();
+    }
+
+    bool is_cache_size_automatic() const {
+        return m_is_cache_size_automatic;
+    }
+
+    void set_cache_memory_share(float share) {
+        OPENVINO_ASSERT(share > 0.0f && share <= 1.0f, "KV cache memory share must be in (0, 1]");
+        m_cache_memory_share = share;
+    }
+
+    float get_cache_memory_share() const {
+        return m_cache_memory_share;
+    }
+
+    /**
+     * Sets the number of blocks of automatically sized KV cache.
+     * @param available_bytes Memory, which can be taken by KV cache.
+     */
+    void set_cache_byte_size(size_t available_bytes) {
+        OPENVINO_ASSERT(m_is_cache_size_automatic, "KV cache size is already set by num_kv_blocks or cache_size");
+        m_num_kv_blocks = available_bytes / get_block_byte_size();
+        OPENVINO_ASSERT(m_num_kv_blocks > 0, "Not enough free memory on ", m_device, " for a single KV cache block of ",
+                        get_block_byte_size(), " bytes, while ", available_bytes, " bytes are available");
+        update_cache_shapes();
+    }
+
+private:
+    void update_cache_shapes() {
+        m_key_cache_shape = ov::Shape{m_num_kv_blocks,
+                                      m_num_kv_heads,
+                                      m_block_size,
+                                      m_key_head_size};
+        m_value_cache_shape = ov::Shape{m_num_kv_blocks,
+                                        m_num_kv_heads,
+                                        m_block_size,
+                                        m_value_head_size};
 
         if (m_device.find("GPU") != std::string::npos) {
             // Update key shape, as the key's shape is different from the value's shape
             m_key_cache_shape = ov::Shape{m_num_kv_blocks,
                                           m_num_kv_heads,
-                                          m_head_size,
+                                          m_key_head_size,
                                           m_block_size};
         }
     }
 
+public:
     std::string get_device() const {
         return m_device;
     }
 
-    ov::element::Type get_cache_precision() const {
-        return m_kv_cache_type;
+    /**
+     * Places decoder layers on several devices of the same type as the device passed to the constructor, which is the first stage.
+     * @param devices Devices of pipeline stages.
+     * @param layer_devices Device of each decoder layer, whose KV cache is allocated there.
+     */
+    void set_pipeline_parallel(const std::vector<std::string>& devices, const std::vector<std::string>& layer_devices) {
+        OPENVINO_ASSERT(layer_devices.size() == m_num_decoder_layers, "Device is expected for each of ", m_num_decoder_layers, " decoder layers");
+        m_pipeline_parallel_devices = devices;
+        m_layer_devices = layer_devices;
+    }
+
+    bool is_pipeline_parallel() const {
+        return !m_pipeline_parallel_devices.empty();
+    }
+
+    const std::vector<std::string>& get_pipeline_parallel_devices() const {
+        return m_pipeline_parallel_devices;
+    }
+
+    // device to compile the model for, which is HETERO over stages in case of pipeline parallelism
+    std::string get_compile_device() const {
+        if (!is_pipeline_parallel())
+            return m_device;
+        std::string device = "HETERO:";
+        for (size_t i = 0; i < m_pipeline_parallel_devices.size(); ++i)
+            device += (i > 0 ? "," : "") + m_pipeline_parallel_devices[i];
+        return device;
+    }
+
+    std::string get_layer_device(size_t decoder_layer_id) const {
+        return m_layer_devices.empty() ? m_device : m_layer_devices.at(decoder_layer_id);
+    }
+
+    /**
+     * Adds hints making the plugin interpret KV cache tensors according to explicitly configured precisions and group sizes.
+     * @param plugin_config Properties to compile the model with.
+     */
+    void apply_kv_cache_hints(ov::AnyMap& plugin_config) const {
+        bool is_explicitly_configured = m_key_cache_type != m_kv_cache_type || m_value_cache_type != m_kv_cache_type ||
+                                        m_key_cache_group_size > 0 || m_value_cache_group_size > 0;
+        if (!is_explicitly_configured)
+            return;
+        plugin_config[ov::hint::key_cache_precision.name()] = m_key_cache_type;
+        plugin_config[ov::hint::value_cache_precision.name()] = m_value_cache_type;
+        plugin_config[ov::hint::key_cache_group_size.name()] = m_key_cache_group_size == 0 ? m_head_size : m_key_cache_group_size;
+        plugin_config[ov::hint::value_cache_group_size.name()] = m_value_cache_group_size == 0 ? m_head_size : m_value_cache_group_size;
+    }
+
+    ov::element::Type get_key_cache_precision() const {
+        return m_key_cache_type;
+    }
+
+    ov::element::Type get_value_cache_precision() const {
+        return m_value_cache_type;
+    }
+
+    size_t get_key_cache_group_size() const {
+        return m_key_cache_group_size;
+    }
+
+    size_t get_value_cache_group_size() const {
+        return m_value_cache_group_size;
     }
 
     size_t get_num_layers() const {
@@ -150,8 +312,40 @@ public:
         return m_num_kv_blocks;
     }
 
+    // number of KV cache blocks to be allocated at start, when KV cache grows on demand
+    size_t get_initial_num_kv_blocks() const {
+        return m_initial_num_kv_blocks > 0 ? std::min(m_initial_num_kv_blocks, m_num_kv_blocks) : m_num_kv_blocks;
+    }
+
+    // number of bytes taken by a single block of both keys and values of all layers
+    size_t get_block_byte_size() const {
+        size_t num_elements = m_num_kv_heads * m_block_size;
+        size_t num_bits = num_elements * (m_key_head_size * m_key_cache_type.bitwidth() + m_value_head_size * m_value_cache_type.bitwidth());
+        return m_num_decoder_layers * num_bits / 8;
+    }
+
     size_t get_block_size() const {
         return m_block_size;
     }
+
+    bool is_numa_interleaved_cache() const {
+        return m_is_numa_interleaved_cache;
+    }
+
+    size_t get_num_swap_blocks() const {
+        return m_num_swap_blocks;
+    }
+
+    ov::Shape get_swap_key_cache_shape() const {
+        ov::Shape shape = get_key_cache_shape();
+        shape[0] = m_num_swap_blocks;
+        return shape;
+    }
+
+    ov::Shape get_swap_value_cache_shape() const {
+        ov::Shape shape = get_value_cache_shape();
+        shape[0] = m_num_swap_blocks;
+        return shape;
+    }
 };
 }
@@ -0,0 +1,253 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <iterator>
+
+#include "disaggregated_impl.hpp"
+#include "generation_stream.hpp"
+#include "text_callback_streamer.hpp"
+#include "timer.hpp"
+
+namespace ov::genai {
+template<class... Ts> struct overloaded : Ts... {using Ts::operator()...;};
+template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+ContinuousBatchingPipeline::DisaggregatedImpl::DisaggregatedImpl(const std::shared_ptr<ov::Model>& model,
+                                                                 const Tokenizer& tokenizer,
+                                                                 const SchedulerConfig& prefill_scheduler_config,
+                                                                 const std::string& prefill_device,
+                                                                 const SchedulerConfig& decode_scheduler_config,
+                                                                 const std::string& decode_device,
+                                                                 const ov::AnyMap& properties,
+                                                                 const ov::genai::GenerationConfig& generation_config) {
+    // transferred blocks are found by the decode instance in its prefix cache
+    OPENVINO_ASSERT(prefill_scheduler_config.enable_prefix_caching && decode_scheduler_config.enable_prefix_caching,
+                    "Disaggregated prefill requires prefix caching to be enabled in both prefill and decode scheduler configs");
+    m_tokenizer = tokenizer;
+    // paged attention transformations modify the model in place, so each instance transforms its own copy
+    m_prefill = std::make_shared<ContinuousBatchingImpl>(model->clone(), tokenizer, prefill_scheduler_config, prefill_device,
+                                                         properties, generation_config);
+    m_decode = std::make_shared<ContinuousBatchingImpl>(model, tokenizer, decode_scheduler_config, decode_device,
+                                                        properties, generation_config);
+    m_generation_config = m_decode->get_config();
+
+    // blocks are matched by hashes of their tokens, so both instances must split prompts into the same blocks
+    OPENVINO_ASSERT(m_prefill->m_scheduler->get_block_size() == m_decode->m_scheduler->get_block_size(),
+                    "Disaggregated prefill requires the same KV cache block size on prefill and decode devices, while they are ",
+                    m_prefill->m_scheduler->get_block_size(), " and ", m_decode->m_scheduler->get_block_size());
+    auto get_block_shape = [](const ov::Tensor& cache) {
+        ov::Shape shape = cache.get_shape();
+        shape[0] = 1;
+        return shape;
+    };
+    ov::Tensor key_cache = m_prefill->m_cache_manager->get_key_cache(0), value_cache = m_prefill->m_cache_manager->get_value_cache(0);
+    ov::Tensor decode_key_cache = m_decode->m_cache_manager->get_key_cache(0), decode_value_cache = m_decode->m_cache_manager->get_value_cache(0);
+    OPENVINO_ASSERT(m_prefill->m_cache_manager->get_num_layers() == m_decode->m_cache_manager->get_num_layers() &&
+                    key_cache.get_element_type() == decode_key_cache.get_element_type() &&
+                    value_cache.get_element_type() == decode_value_cache.get_element_type() &&
+                    get_block_shape(key_cache) == get_block_shape(decode_key_cache) &&
+                    get_block_shape(value_cache) == get_block_shape(decode_value_cache),
+                    "Disaggregated prefill requires the same KV cache precision and layout on prefill and decode devices");
+    m_key_block = ov::Tensor(key_cache.get_element_type(), get_block_shape(key_cache));
+    m_value_block = ov::Tensor(value_cache.get_element_type(), get_block_shape(value_cache));
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::DisaggregatedImpl::_add_request(uint64_t request_id,
+                                                            const ov::Tensor& input_ids,
+                                                            ov::genai::GenerationConfig sampling_params) {
+    SequenceGroup::Ptr decode_request = m_decode->_create_sequence_group(request_id, input_ids, sampling_params);
+    auto handle = std::make_shared<GenerationHandleImpl>(decode_request->get_generation_stream(), decode_request->get_sampling_parameters());
+
+    // the prefill instance computes KV cache of the whole prompt and samples a single token, which is discarded
+    ov::genai::GenerationConfig prefill_params;
+    prefill_params.max_new_tokens = 1;
+    prefill_params.adapters = sampling_params.adapters;
+    const int64_t* input_ids_data = input_ids.data<const int64_t>();
+    TokenIds prompt_ids(input_ids_data, input_ids_data + input_ids.get_size());
+
+    // the prefill must not complete before the request is registered, otherwise its blocks could be overwritten before the transfer
+    std::lock_guard<std::mutex> lock(m_pending_transfers_mutex);
+    GenerationHandle prefill_handle = m_prefill->_add_request(request_id, input_ids, prefill_params);
+    m_pending_transfers.push_back({std::move(prefill_handle), std::move(decode_request), std::move(prompt_ids)});
+    return handle;
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::DisaggregatedImpl::add_request(uint64_t request_id,
+                                                           const ov::Tensor& input_ids,
+                                                           ov::genai::GenerationConfig sampling_params) {
+    // new requests are queued by the prefill instance first
+    m_prefill->_admit_request(request_id);
+    return _add_request(request_id, input_ids, sampling_params);
+}
+
+GenerationHandle
+ContinuousBatchingPipeline::DisaggregatedImpl::add_request(uint64_t request_id,
+                                                           const std::string& prompt,
+                                                           ov::genai::GenerationConfig sampling_params) {
+    static ManualTimer timer("tokenize");
+    timer.start();
+    ov::Tensor input_ids = m_tokenizer.encode(prompt).input_ids;
+    timer.end();
+    return add_request(request_id, input_ids, sampling_params);
+}
+
+bool ContinuousBatchingPipeline::DisaggregatedImpl::has_non_finished_requests() {
+    {
+        std::lock_guard<std::mutex> lock(m_pending_transfers_mutex);
+        if (!m_pending_transfers.empty())
+            return true;
+    }
+    return m_prefill->has_non_finished_requests() || m_decode->has_non_finished_requests();
+}
+
+void ContinuousBatchingPipeline::DisaggregatedImpl::step() {
+    // both instances launch inference before any of them waits for results, so that devices work concurrently
+    Scheduler::Output prefill_output, decode_output;
+    bool is_prefill_launched = m_prefill->has_non_finished_requests() && m_prefill->_launch_step(prefill_output);
+    bool is_decode_launched = m_decode->has_non_finished_requests() && m_decode->_launch_step(decode_output);
+    if (is_prefill_launched)
+        m_prefill->_complete_step(prefill_output);
+    if (is_decode_launched)
+        m_decode->_complete_step(decode_output);
+    // blocks of finished prefills are cached, but not owned by any sequence, so they are copied before the next prefill step
+    _transfer_prefilled_requests();
+    _update_metrics();
+}
+
+void ContinuousBatchingPipeline::DisaggregatedImpl::_transfer_prefilled_requests() {
+    std::vector<PendingTransfer> prefilled;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_transfers_mutex);
+        auto prefilled_begin = std::stable_partition(m_pending_transfers.begin(), m_pending_transfers.end(), [](const PendingTransfer& transfer) {
+            return transfer.prefill_handle->get_status() == GenerationStatus::RUNNING;
+        });
+        prefilled.assign(std::make_move_iterator(prefilled_begin), std::make_move_iterator(m_pending_transfers.end()));
+        m_pending_transfers.erase(prefilled_begin, m_pending_transfers.end());
+    }
+
+    for (auto& transfer : prefilled) {
+        // prompts, which were not processed by the prefill instance, e.g. because of its KV cache size, are processed by the decode instance
+        if (transfer.prefill_handle->get_status() == GenerationStatus::FINISHED && !transfer.decode_request->handle_dropped())
+            _transfer_kv_cache(transfer.prompt_ids);
+        m_decode->_enqueue_request(transfer.decode_request);
+    }
+}
+
+void ContinuousBatchingPipeline::DisaggregatedImpl::_transfer_kv_cache(const TokenIds& prompt_ids) {
+    static ManualTimer timer("transfer KV cache");
+    timer.start();
+    auto cached_blocks = m_prefill->m_scheduler->get_prefix_cached_blocks(prompt_ids);
+    std::vector<PrefixTree::BlockInfo> blocks;
+    blocks.reserve(cached_blocks.size());
+    for (const auto& cached_block : cached_blocks) {
+        blocks.push_back(cached_block.first);
+    }
+    // blocks already cached by the decode instance, e.g. of a shared system prompt, are not copied again
+    for (const auto& [block_idx, decode_block_ids] : m_decode->m_scheduler->import_prefix_cached_blocks(blocks)) {
+        const std::vector<size_t>& prefill_block_ids = cached_blocks[block_idx].second;
+        for (size_t layer_idx = 0; layer_idx < decode_block_ids.size(); ++layer_idx) {
+            m_prefill->m_cache_manager->read_block(layer_idx, prefill_block_ids[layer_idx], m_key_block, m_value_block);
+            m_decode->m_cache_manager->write_block(layer_idx, decode_block_ids[layer_idx], m_key_block, m_value_block);
+        }
+    }
+    timer.end();
+}
+
+void ContinuousBatchingPipeline::DisaggregatedImpl::_update_metrics() {
+    // each request is counted by the decode instance once its prompt is transferred, while it waits for generation until that
+    PipelineMetrics metrics = m_decode->get_metrics();
+    PipelineMetrics prefill_metrics = m_prefill->get_metrics();
+    metrics.requests += prefill_metrics.requests;
+    metrics.waiting_requests += prefill_metrics.requests;
+    metrics.num_processed_tokens += prefill_metrics.num_processed_tokens;
+    metrics.num_preemptions += prefill_metrics.num_preemptions;
+    m_pipeline_metrics = metrics;
+    _publish_metrics();
+}
+
+std::vector<EncodedGenerationResult>
+ContinuousBatchingPipeline::DisaggregatedImpl::generate(const std::vector<ov::Tensor>& input_ids,
+                                                        const std::vector<GenerationConfig>& sampling_params,
+                                                        const StreamerVariant& streamer) {
+    OPENVINO_ASSERT(!has_non_finished_requests(), "Generate cannot be called while ContinuousBatchingPipeline is already in running state. Use ContinuousBatchingPipeline::add_request");
+    OPENVINO_ASSERT(input_ids.size() == sampling_params.size());
+    const std::shared_ptr<StreamerBase>& streamer_ptr = std::visit(overloaded{
+        [](std::monostate) -> std::shared_ptr<StreamerBase> {
+            return nullptr;
+        },
+        [](const std::shared_ptr<StreamerBase>& streamer) {
+            return streamer;
+        },
+        [this](const std::function<bool(std::string)>& streamer) -> std::shared_ptr<StreamerBase> {
+            return std::make_unique<TextCallbackStreamer>(m_tokenizer, streamer);
+        }
+    }, streamer);
+
+    OPENVINO_ASSERT(streamer_ptr == nullptr || input_ids.size() == 1 && sampling_params[0].num_return_sequences == 1 &&
+        (sampling_params[0].is_greedy_decoding() || sampling_params[0].is_multinomial()),
+        "Currently streaming is possible only with batch size=1 and only for greedy or multinomial decoding");
+
+    std::vector<GenerationHandle> generations;
+    for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
+        OPENVINO_ASSERT(1 == input_ids[request_id].get_shape().at(0), "Use multiple tensors to pass a batch.");
+        // admission control is not applied, since requests are processed by the same thread
+        generations.push_back(_add_request(request_id, input_ids[request_id], sampling_params[request_id]));
+    }
+
+    std::vector<GenerationOutputs> request_outputs(generations.size());
+    bool continue_generation = true;
+    auto read_generated_tokens = [&] () {
+        for (size_t request_id = 0; request_id < generations.size(); ++request_id) {
+            auto& generation = generations[request_id];
+            while (generation->can_read()) {
+                GenerationOutputs outputs = generation->read();
+                if (streamer_ptr && !outputs.empty()) {
+                    for (const auto& gen_token : outputs.begin()->second.generated_ids) {
+                        continue_generation = !streamer_ptr->put(gen_token);
+                        if (!continue_generation) {
+                            generation->drop();
+                            break;
+                        }
+                    }
+                }
+                GenerationStream::merge_outputs(request_outputs[request_id], outputs);
+            }
+        }
+    };
+
+    while (has_non_finished_requests()) {
+        step();
+        read_generated_tokens();
+    }
+
+    if (streamer_ptr) { // push streamer's cache
+        streamer_ptr->end();
+    }
+
+    std::vector<EncodedGenerationResult> results;
+    results.reserve(generations.size());
+    for (size_t request_id = 0; request_id < generations.size(); ++request_id) {
+        std::vector<GenerationOutput> outputs;
+        for (auto& [sequence_id, output] : request_outputs[request_id]) {
+            outputs.push_back(std::move(output));
+        }
+        std::sort(outputs.begin(), outputs.end(), [](const GenerationOutput& lhs, const GenerationOutput& rhs) { return lhs.score > rhs.score; });
+        outputs.resize(std::min(sampling_params[request_id].num_return_sequences, outputs.size()));
+
+        EncodedGenerationResult result;
+        result.m_request_id = request_id;
+        for (auto& output : outputs) {
+            result.m_generation_ids.push_back(std::move(output.generated_ids));
+            result.m_scores.push_back(output.score);
+        }
+        result.m_status = generations[request_id]->get_status();
+        result.m_timings = generations[request_id]->get_timings();
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "openvino/genai/continuous_batching_pipeline.hpp"
+#include "continuous_batching_impl.hpp"
+
+namespace ov::genai {
+
+/**
+ * @brief Pipeline with disaggregated prefill, which owns two ContinuousBatchingImpl instances with their own SchedulerConfig
+ * and KV cache: the prefill instance computes KV cache of prompts of new requests, while the decode instance generates
+ * all tokens of the requests. Once a prompt is processed, its fully filled KV cache blocks are copied to the decode instance
+ * through host memory and registered in its prefix cache, so the decode instance restores them as a prefix cache hit
+ * and computes only the tail of the prompt. Steps of both instances are interleaved, so that their devices infer concurrently.
+ */
+class ContinuousBatchingPipeline::DisaggregatedImpl : public ContinuousBatchingPipeline::ImplInterface {
+protected:
+    std::shared_ptr<ContinuousBatchingImpl> m_prefill;
+    std::shared_ptr<ContinuousBatchingImpl> m_decode;
+
+    // request of the decode instance, which waits for the prefill of its prompt
+    struct PendingTransfer {
+        GenerationHandle prefill_handle;
+        SequenceGroup::Ptr decode_request;
+        TokenIds prompt_ids;
+    };
+    std::vector<PendingTransfer> m_pending_transfers;
+    std::mutex m_pending_transfers_mutex;
+
+    // host buffers for a single block of a single layer
+    ov::Tensor m_key_block, m_value_block;
+
+    GenerationHandle _add_request(uint64_t request_id, const ov::Tensor& input_ids, ov::genai::GenerationConfig sampling_params);
+    // copies KV cache of prompts, which are processed by the prefill instance, and passes their requests to the decode instance
+    void _transfer_prefilled_requests();
+    void _transfer_kv_cache(const TokenIds& prompt_ids);
+    void _update_metrics();
+
+public:
+    DisaggregatedImpl(const std::shared_ptr<ov::Model>& model,
+                      const Tokenizer& tokenizer,
+                      const SchedulerConfig& prefill_scheduler_config,
+                      const std::string& prefill_device,
+                      const SchedulerConfig& decode_scheduler_config,
+                      const std::string& decode_device,
+                      const ov::AnyMap& properties,
+                      const ov::genai::GenerationConfig& generation_config);
+
+    GenerationHandle add_request(uint64_t request_id,
+                                 const ov::Tensor& input_ids,
+                                 ov::genai::GenerationConfig sampling_params) override;
+    GenerationHandle add_request(uint64_t request_id,
+                                 const std::string& prompt,
+                                 ov::genai::GenerationConfig sampling_params) override;
+
+    bool has_non_finished_requests() override;
+
+    void step() override;
+
+    std::vector<EncodedGenerationResult>
+    generate(const std::vector<ov::Tensor>& input_ids,
+             const std::vector<GenerationConfig>& sampling_params,
+             const StreamerVariant& streamer) override;
+};
+
+}
@@ -50,6 +50,13 @@ GenerationConfig::GenerationConfig(const std::filesystem::path& json_path) {
     read_json_param(data, "echo", echo);
     // note that logprobs is not present in HF GenerationConfig
     read_json_param(data, "logprobs", logprobs);
+    // note that priority, deadline_ms and expected_new_tokens are not present in HF GenerationConfig
+    read_json_param(data, "priority", priority);
+    read_json_param(data, "deadline_ms", deadline_ms);
+    read_json_param(data, "expected_new_tokens", expected_new_tokens);
+    // note that regex and json_schema are not present in HF GenerationConfig
+    read_json_param(data, "regex", regex);
+    read_json_param(data, "json_schema", json_schema);
 
     // append EOS to stop_token_ids
     if (eos_token_id != -1)
@@ -96,6 +103,7 @@ void GenerationConfig::update_generation_config(const ov::AnyMap& config_map) {
     read_anymap_param(config_map, "num_return_sequences", num_return_sequences);
     read_anymap_param(config_map, "no_repeat_ngram_size", no_repeat_ngram_size);
     read_anymap_param(config_map, "stop_criteria", stop_criteria);
+    read_anymap_param(config_map, "prune_beams", prune_beams);
     read_anymap_param(config_map, "temperature", temperature);
     read_anymap_param(config_map, "top_p", top_p);
     read_anymap_param(config_map, "top_k", top_k);
@@ -104,6 +112,13 @@ void GenerationConfig::update_generation_config(const ov::AnyMap& config_map) {
     read_anymap_param(config_map, "eos_token_id", eos_token_id);
     read_anymap_param(config_map, "echo", echo);
     read_anymap_param(config_map, "logprobs", logprobs);
+    read_anymap_param(config_map, "priority", priority);
+    read_anymap_param(config_map, "deadline_ms", deadline_ms);
+    read_anymap_param(config_map, "expected_new_tokens", expected_new_tokens);
+    read_anymap_param(config_map, "streamer_queue_size", streamer_queue_size);
+    read_anymap_param(config_map, "regex", regex);
+    read_anymap_param(config_map, "json_schema", json_schema);
+    read_anymap_param(config_map, "adaptive_num_assistant_tokens", adaptive_num_assistant_tokens);
     read_anymap_param(config_map, "adapters", adapters);
 
     // TODO: add support of 'generator' property similar to Image generation
@@ -143,6 +158,10 @@ bool GenerationConfig::is_prompt_lookup() const {
     return (max_ngram_size > 0 && num_assistant_tokens > 0);
 }
 
+bool GenerationConfig::is_structured_output() const {
+    return !regex.empty() || !json_schema.empty();
+}
+
 void GenerationConfig::validate() const {
     OPENVINO_ASSERT(eos_token_id == -1 || stop_token_ids.find(eos_token_id) != stop_token_ids.end(),
         "'stop_token_ids' must contain 'eos_token_id'. Please, call 'set_eos_token_id' with 'eos_token_id' value");
@@ -189,6 +208,10 @@ void GenerationConfig::validate() const {
         OPENVINO_ASSERT(frequency_penalty >= -2.0f && frequency_penalty <= 2.0f, "frequence_penalty penalty must be a [-2; +2]");
         OPENVINO_ASSERT(presence_penalty >= -2.0f && presence_penalty <= 2.0f, "presence_penalty penalty must be a [-2; +2]");
     }
+    if (is_structured_output()) {
+        OPENVINO_ASSERT(regex.empty() || json_schema.empty(), "Parameters `regex` and `json_schema` are mutually exclusive in `GenerationConfig`");
+        OPENVINO_ASSERT(!is_beam_search() && !is_assisting_generation(), "Structured output is supported only for greedy decoding and multinomial sampling");
+    }
     if (is_assisting_generation()) {
         if (assistant_confidence_threshold != 0.f) {
             OPENVINO_ASSERT(num_assistant_tokens == 0, "Parameters `assistant_confidence_threshold` and `num_assistant_tokens` are mutually exclusive in `GenerationConfig`");
@@ -197,6 +220,10 @@ void GenerationConfig::validate() const {
             OPENVINO_ASSERT(num_assistant_tokens > 0, "Parameters `assistant_confidence_threshold` and `num_assistant_tokens` are mutually exclusive in `GenerationConfig`");
         };
     }
+    if (adaptive_num_assistant_tokens) {
+        OPENVINO_ASSERT(num_assistant_tokens > 0 && assistant_confidence_threshold == 0.f && !is_prompt_lookup(),
+                        "Parameter `adaptive_num_assistant_tokens` requires `num_assistant_tokens` in speculative decoding");
+    }
 }
 
 GenerationConfig beam_search() {
@@ -16,6 +16,10 @@ GenerationStatus GenerationHandleImpl::get_status() {
     return m_generation_stream->get_status();
 }
 
+RequestTimings GenerationHandleImpl::get_timings() {
+    return m_generation_stream->get_timings();
+}
+
 bool GenerationHandleImpl::can_read() {
     return !is_dropped() && m_generation_stream->can_read();
 }
@@ -28,6 +32,11 @@ void GenerationHandleImpl::drop() {
     m_generation_stream->drop();
 }
 
+void GenerationHandleImpl::set_callback(OutputsCallback callback) {
+    OPENVINO_ASSERT(!is_dropped(), "GenerationHandle cannot be used after it is dropped.");
+    m_generation_stream->set_callback(std::move(callback));
+}
+
 std::unordered_map<uint64_t, GenerationOutput> GenerationHandleImpl::back() {
     OPENVINO_ASSERT(!is_dropped(), "GenerationHandle cannot be used after it is dropped.");
     return m_generation_stream->back();
@@ -39,21 +48,7 @@ std::unordered_map<uint64_t, GenerationOutput> GenerationHandleImpl::read() {
 }
 
 void add_partial_result(std::unordered_map<uint64_t, GenerationOutput>& partial_results, std::unordered_map<uint64_t, GenerationOutput>& iteration_results) {
-    for (auto& iteration_result: iteration_results) {
-        auto partial_result_iter = partial_results.find(iteration_result.first);
-        if (partial_result_iter == partial_results.end()) {
-            partial_results.emplace(iteration_result.first, iteration_result.second);
-        } else {
-            auto generated_len = iteration_result.second.generated_ids.size();
-            OPENVINO_ASSERT(generated_len == iteration_result.second.generated_log_probs.size());
-            for (size_t i = 0; i < generated_len; ++i) {
-                partial_result_iter->second.generated_ids.push_back(iteration_result.second.generated_ids[i]);
-                partial_result_iter->second.generated_log_probs.push_back(iteration_result.second.generated_log_probs[i]);
-            }
-            partial_result_iter->second.score = iteration_result.second.score;
-            partial_result_iter->second.finish_reason = iteration_result.second.finish_reason;
-        }
-    }
+    GenerationStream::merge_outputs(partial_results, iteration_results);
 }
 
 std::vector<GenerationOutput> GenerationHandleImpl::read_all() {
@@ -4,16 +4,77 @@
 #pragma once
 #include <mutex>
 #include <atomic>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <functional>
 #include "openvino/genai/continuous_batching_pipeline.hpp"
 #include "openvino/genai/generation_handle.hpp"
 #include "synchronized_queue.hpp"
+#include "spsc_ring_buffer.hpp"
 
 namespace ov::genai {
 class GenerationStream {
     std::mutex m_mutex;
     GenerationStatus m_status = GenerationStatus::RUNNING;
+    // updated by the pipeline under m_mutex
+    RequestTimings m_timings;
     SynchronizedQueue<GenerationOutputs> m_output_queue;
 
+    // Lock-free buffering, used instead of m_output_queue once enabled by enable_ring_buffer
+    // The pipeline is the only producer and the handle is the only consumer, so outputs are passed via a ring buffer.
+    // When the ring buffer is full, outputs are appended to m_overflow_outputs under m_overflow_mutex until the consumer
+    // takes them, which keeps the order of outputs.
+    std::unique_ptr<SPSCRingBuffer<GenerationOutputs>> m_ring_buffer;
+    std::mutex m_overflow_mutex;
+    std::atomic<bool> m_has_overflow{false};
+    GenerationOutputs m_overflow_outputs;
+    // outputs already taken from the ring buffer, accessed only by the consumer; holds at most two entries: outputs of the latest
+    // step, which back() returns, and all older outputs merged together, so that it does not grow if only back() is called
+    std::deque<GenerationOutputs> m_consumer_outputs;
+
+    // if set, outputs are passed to the callback by the pipeline thread, bypassing any buffering
+    std::shared_ptr<OutputsCallback> m_callback;
+
+    static constexpr size_t MAX_NUM_SPINS = 64;
+    static constexpr std::chrono::microseconds MAX_SLEEP_TIME{1000};
+
+    // moves all outputs available to the consumer into m_consumer_outputs
+    bool _pull_ring_buffer() {
+        GenerationOutputs outputs;
+        while (m_ring_buffer->try_pop(outputs)) {
+            m_consumer_outputs.push_back(std::move(outputs));
+        }
+        if (m_has_overflow.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(m_overflow_mutex);
+            // outputs pushed to the ring buffer before the overflow are guaranteed to be visible under the lock
+            while (m_ring_buffer->try_pop(outputs)) {
+                m_consumer_outputs.push_back(std::move(outputs));
+            }
+            m_consumer_outputs.push_back(std::move(m_overflow_outputs));
+            m_overflow_outputs.clear();
+            m_has_overflow.store(false, std::memory_order_release);
+        }
+        while (m_consumer_outputs.size() > 2) {
+            merge_outputs(m_consumer_outputs[0], m_consumer_outputs[1]);
+            m_consumer_outputs.erase(m_consumer_outputs.begin() + 1);
+        }
+        return !m_consumer_outputs.empty();
+    }
+
+    // waits without a condition variable: spins first, since outputs typically arrive once per step, then backs off
+    void _wait_ring_buffer() {
+        std::chrono::microseconds sleep_time{1};
+        for (size_t num_spins = 0; !_pull_ring_buffer(); ++num_spins) {
+            if (num_spins < MAX_NUM_SPINS) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(sleep_time);
+                sleep_time = std::min(sleep_time * 2, MAX_SLEEP_TIME);
+            }
+        }
+    }
+
 public:
     using Ptr = std::shared_ptr<GenerationStream>;
 
@@ -24,21 +85,85 @@ public:
         return std::make_shared<GenerationStream>();
     }
 
+    /**
+     * Appends outputs of the current step of `src` to the outputs of the previous steps in `dst`.
+     */
+    static void merge_outputs(GenerationOutputs& dst, const GenerationOutputs& src) {
+        for (const auto& [sequence_id, output] : src) {
+            auto dst_it = dst.find(sequence_id);
+            if (dst_it == dst.end()) {
+                dst.emplace(sequence_id, output);
+                continue;
+            }
+            OPENVINO_ASSERT(output.generated_ids.size() == output.generated_log_probs.size());
+            auto& dst_output = dst_it->second;
+            dst_output.generated_ids.insert(dst_output.generated_ids.end(), output.generated_ids.begin(), output.generated_ids.end());
+            dst_output.generated_log_probs.insert(dst_output.generated_log_probs.end(), output.generated_log_probs.begin(), output.generated_log_probs.end());
+            dst_output.score = output.score;
+            dst_output.finish_reason = output.finish_reason;
+        }
+    }
+
+    /**
+     * Switches the stream to a lock-free ring buffer, so that pushing outputs does not take locks or wake up the reader,
+     * and read() returns outputs of all steps completed since the previous read, merged together.
+     * Must be called before any outputs are pushed.
+     * @param capacity Number of steps whose outputs can be buffered without falling back to a locked overflow storage.
+     */
+    void enable_ring_buffer(size_t capacity) {
+        OPENVINO_ASSERT(m_output_queue.empty(), "Ring buffer must be enabled before outputs are pushed to the stream");
+        m_ring_buffer = std::make_unique<SPSCRingBuffer<GenerationOutputs>>(capacity);
+    }
+
+    /**
+     * Sets a callback receiving outputs of each step instead of buffering them. The callback is called from the thread
+     * running the pipeline step, so it must be lightweight. Outputs buffered before the callback is set remain readable.
+     */
+    void set_callback(OutputsCallback callback) {
+        std::atomic_store(&m_callback, callback ? std::make_shared<OutputsCallback>(std::move(callback)) : nullptr);
+    }
+
     void push(GenerationOutputs outputs) {
-        m_output_queue.push(std::move(outputs));
+        if (auto callback = std::atomic_load(&m_callback)) {
+            (*callback)(std::move(outputs));
+            return;
+        }
+        if (!m_ring_buffer) {
+            m_output_queue.push(std::move(outputs));
+            return;
+        }
+        if (!m_has_overflow.load(std::memory_order_acquire) && m_ring_buffer->try_push(std::move(outputs)))
+            return;
+        std::lock_guard<std::mutex> lock(m_overflow_mutex);
+        // the consumer reads all overflowing outputs at once, so they are coalesced
+        merge_outputs(m_overflow_outputs, outputs);
+        m_has_overflow.store(true, std::memory_order_release);
     }
 
     // Retrieving vector of pairs <sequence_id, token_ids> as we can generate multiple outputs for a single prompt
     GenerationOutputs back() {
-        return m_output_queue.back();
+        if (!m_ring_buffer)
+            return m_output_queue.back();
+        _wait_ring_buffer();
+        return m_consumer_outputs.back();
     }
 
     GenerationOutputs read() {
-        return m_output_queue.pull();
+        if (!m_ring_buffer)
+            return m_output_queue.pull();
+        _wait_ring_buffer();
+        GenerationOutputs outputs = std::move(m_consumer_outputs.front());
+        m_consumer_outputs.pop_front();
+        for (; !m_consumer_outputs.empty(); m_consumer_outputs.pop_front()) {
+            merge_outputs(outputs, m_consumer_outputs.front());
+        }
+        return outputs;
     }
 
     bool can_read() {
-        return !m_output_queue.empty();
+        if (!m_ring_buffer)
+            return !m_output_queue.empty();
+        return !m_consumer_outputs.empty() || !m_ring_buffer->empty() || m_has_overflow.load(std::memory_order_acquire);
     }
 
     void set_generation_status(GenerationStatus status) {
@@ -55,5 +180,16 @@ public:
         std::lock_guard<std::mutex> lock(m_mutex);
         m_status = GenerationStatus::DROPPED_BY_HANDLE;
     }
+
+    template <typename Update>
+    void update_timings(const Update& update) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        update(m_timings);
+    }
+
+    RequestTimings get_timings() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_timings;
+    }
 };
 }
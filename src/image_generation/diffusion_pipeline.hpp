@@ -3,11 +3,18 @@
 
 #pragma once
 
+#include <chrono>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include "image_generation/schedulers/ischeduler.hpp"
 #include "openvino/genai/image_generation/generation_config.hpp"
+#include "openvino/genai/image_generation/image_generation_perf_metrics.hpp"
+#include "openvino/runtime/properties.hpp"
 
 #include "json_utils.hpp"
 namespace {
@@ -78,6 +85,10 @@ public:
 
     virtual void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale) = 0;
 
+    virtual void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) {
+        OPENVINO_THROW("Reshape to ranges of image sizes is not supported by this image generation pipeline");
+    }
+
     virtual void compile(const std::string& device, const ov::AnyMap& properties) = 0;
 
     virtual std::tuple<ov::Tensor, ov::Tensor, ov::Tensor, ov::Tensor> prepare_latents(ov::Tensor initial_image, const ImageGenerationConfig& generation_config) const = 0;
@@ -88,10 +99,44 @@ public:
 
     virtual ov::Tensor generate(const std::string& positive_prompt, ov::Tensor initial_image, ov::Tensor mask_image, const ov::AnyMap& properties) = 0;
 
+    virtual ov::Tensor generate_batch(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) {
+        OPENVINO_THROW("Generation for a batch of prompts is not supported by this image generation pipeline");
+    }
+
+    virtual std::vector<ov::Tensor> generate_pipelined(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) {
+        std::vector<ov::Tensor> images;
+        for (const std::string& positive_prompt : positive_prompts) {
+            // output tensors of decoder are overwritten by subsequent generations
+            ov::Tensor image = generate(positive_prompt, {}, {}, properties);
+            ov::Tensor image_copy(image.get_element_type(), image.get_shape());
+            image.copy_to(image_copy);
+            images.push_back(image_copy);
+        }
+        return images;
+    }
+
     virtual ov::Tensor decode(const ov::Tensor latent) = 0;
 
     virtual ~DiffusionPipeline() = default;
 
+    ImageGenerationPerfMetrics get_performance_metrics() {
+        // raw metrics may be appended by 'decode()' after the previous evaluation
+        m_perf_metrics.m_evaluated = false;
+        m_perf_metrics.evaluate_statistics();
+        return m_perf_metrics;
+    }
+
+    void set_load_time(float load_time_ms) {
+        m_perf_metrics.load_time = load_time_ms;
+    }
+
+    // runs a generation call of a public pipeline, so that performance metrics describe this call only
+    template <typename Function>
+    auto measure_generation(Function&& function) -> decltype(function()) {
+        m_perf_metrics.clean_up();
+        return measure(m_perf_metrics.raw_metrics.generate_durations, std::forward<Function>(function));
+    }
+
 protected:
     virtual void initialize_generation_config(const std::string& class_name) = 0;
 
@@ -99,6 +144,68 @@ protected:
 
     virtual void check_inputs(const ImageGenerationConfig& generation_config, ov::Tensor initial_image) const = 0;
 
+    // runs independent tasks, e.g. reading and compilation of submodels, concurrently and rethrows the first failure
+    static void run_in_parallel(const std::vector<std::function<void()>>& tasks) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks.size());
+        for (const auto& task : tasks) {
+            futures.push_back(std::async(std::launch::async, task));
+        }
+        // wait for all tasks before rethrowing, so that none of them outlives the pipeline members it initializes
+        std::exception_ptr exception;
+        for (auto& future : futures) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    // group size of dynamic activation quantization, which keeps per-group scales accurate for outlier channels of diffusion models
+    static constexpr uint64_t DYNAMIC_QUANTIZATION_GROUP_SIZE = 32;
+
+    // removes 'denoiser_quantization' from 'properties', which are passed to all submodels, and returns properties
+    // to compile the denoising model with, where the requested quantization is expressed by plugin hints
+    static ov::AnyMap extract_denoiser_properties(ov::AnyMap& properties) {
+        auto it = properties.find(ov::genai::denoiser_quantization.name());
+        if (it == properties.end())
+            return properties;
+
+        const DenoiserQuantization quantization = it->second.as<DenoiserQuantization>();
+        properties.erase(it);
+
+        ov::AnyMap denoiser_properties = properties;
+        if (quantization == DenoiserQuantization::INT8_DYNAMIC) {
+            // insert() keeps a group size explicitly passed by user
+            denoiser_properties.insert(ov::hint::dynamic_quantization_group_size(DYNAMIC_QUANTIZATION_GROUP_SIZE));
+        }
+        return denoiser_properties;
+    }
+
+    // removes 'vae_encoder_cache_size' from 'properties', which are passed to all submodels, and returns its value, 0 if absent
+    static size_t extract_vae_encoder_cache_size(ov::AnyMap& properties) {
+        auto it = properties.find(ov::genai::vae_encoder_cache_size.name());
+        if (it == properties.end())
+            return 0;
+
+        const size_t cache_size = it->second.as<size_t>();
+        properties.erase(it);
+        return cache_size;
+    }
+
+    // runs 'function' and appends its duration to 'durations', which are raw performance metrics
+    template <typename Function>
+    static auto measure(std::vector<MicroSeconds>& durations, Function&& function) -> decltype(function()) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = function();
+        durations.emplace_back(std::chrono::steady_clock::now() - start);
+        return result;
+    }
+
     void blend_latents(ov::Tensor image_latent, ov::Tensor noise, ov::Tensor mask, ov::Tensor latent, size_t inference_step) {
         OPENVINO_ASSERT(m_pipeline_type == PipelineType::INPAINTING, "'prepare_mask_latents' can be called for inpainting pipeline only");
         OPENVINO_ASSERT(image_latent.get_shape() == latent.get_shape(), "Shapes for current", latent.get_shape(), "and initial image latents ", image_latent.get_shape(), " must match");
@@ -135,6 +242,8 @@ protected:
     PipelineType m_pipeline_type;
     std::shared_ptr<IScheduler> m_scheduler;
     ImageGenerationConfig m_generation_config;
+    // collected by const methods as well
+    mutable ImageGenerationPerfMetrics m_perf_metrics;
 };
 
 } // namespace genai
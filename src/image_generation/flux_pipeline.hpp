@@ -22,21 +22,20 @@ ov::Tensor pack_latents(const ov::Tensor latents, size_t batch_size, size_t num_
 
     OPENVINO_ASSERT(latents.get_size() == permuted_latents.get_size(), "Incorrect target shape, tensors must have the same sizes");
 
-    float* src_data = latents.data<float>();
+    const float* src_data = latents.data<const float>();
     float* dst_data = permuted_latents.data<float>();
+    const size_t dst_pixel_stride = num_channels_latents * 4;
 
     // Permute to (0, 2, 4, 1, 3, 5)
+    // source rows are read sequentially, each pair of adjacent values is a (w3 = 0, 1) pair of a destination 2x2 patch
     for (size_t b = 0; b < batch_size; ++b) {
-        for (size_t h2 = 0; h2 < h_half; ++h2) {
-            for (size_t w2 = 0; w2 < w_half; ++w2) {
-                for (size_t c = 0; c < num_channels_latents; ++c) {
-                    for (size_t h3 = 0; h3 < 2; ++h3) {
-                        for (size_t w3 = 0; w3 < 2; ++w3) {
-                            size_t src_index = ((b * num_channels_latents + c) * h_half + h2) * 2 * w_half * 2 + (h3 * w_half + w2) * 2 + w3;
-                            size_t dst_index = ((b * h_half + h2) * w_half + w2) * num_channels_latents * 4 + (c * 4 + h3 * 2 + w3);
-
-                            dst_data[dst_index] = src_data[src_index];
-                        }
+        for (size_t c = 0; c < num_channels_latents; ++c) {
+            for (size_t h2 = 0; h2 < h_half; ++h2) {
+                for (size_t h3 = 0; h3 < 2; ++h3, src_data += width) {
+                    float* dst_row = dst_data + (b * h_half + h2) * w_half * dst_pixel_stride + c * 4 + h3 * 2;
+                    for (size_t w2 = 0; w2 < w_half; ++w2, dst_row += dst_pixel_stride) {
+                        dst_row[0] = src_data[w2 * 2];
+                        dst_row[1] = src_data[w2 * 2 + 1];
                     }
                 }
             }
@@ -64,21 +63,19 @@ ov::Tensor unpack_latents(const ov::Tensor& latents, size_t height, size_t width
 
     OPENVINO_ASSERT(latents.get_size() == permuted_latents.get_size(), "Incorrect target shape, tensors must have the same sizes");
 
-    const float* src_data = latents.data<float>();
+    const float* src_data = latents.data<const float>();
     float* dst_data = permuted_latents.data<float>();
 
     // Permutation to (0, 3, 1, 4, 2, 5)
+    // destination rows are written sequentially, each pair of adjacent values is a (w3 = 0, 1) pair of a source 2x2 patch
     for (size_t b = 0; b < batch_size; ++b) {
         for (size_t c4 = 0; c4 < c_quarter; ++c4) {
             for (size_t h2 = 0; h2 < h_half; ++h2) {
-                for (size_t h3 = 0; h3 < 2; ++h3) {
-                    for (size_t w2 = 0; w2 < w_half; ++w2) {
-                        for (size_t w3 = 0; w3 < 2; ++w3) {
-                            size_t reshaped_index = (((b * h_half + h2) * w_half + w2) * c_quarter + c4) * 4 + h3 * 2 + w3;
-                            size_t final_index = (b * c_quarter * height * width) + (c4 * height * width) + (h2 * 2 + h3) * width + (w2 * 2 + w3);
-
-                            dst_data[final_index] = src_data[reshaped_index];
-                        }
+                for (size_t h3 = 0; h3 < 2; ++h3, dst_data += width) {
+                    const float* src_row = src_data + (b * h_half + h2) * w_half * channels + c4 * 4 + h3 * 2;
+                    for (size_t w2 = 0; w2 < w_half; ++w2, src_row += channels) {
+                        dst_data[w2 * 2] = src_row[0];
+                        dst_data[w2 * 2 + 1] = src_row[1];
                     }
                 }
             }
@@ -92,12 +89,11 @@ ov::Tensor prepare_latent_image_ids(size_t batch_size, size_t height, size_t wid
     ov::Tensor latent_image_ids(ov::element::f32, {height * width, 3});
     auto* data = latent_image_ids.data<float>();
 
-    std::fill(data, data + height * width * 3, 0.0);
-
     for (size_t i = 0; i < height; ++i) {
-        for (size_t j = 0; j < width; ++j) {
-            data[(i * width + j) * 3 + 1] = static_cast<float>(i);
-            data[(i * width + j) * 3 + 2] = static_cast<float>(j);
+        for (size_t j = 0; j < width; ++j, data += 3) {
+            data[0] = 0.0f;
+            data[1] = static_cast<float>(i);
+            data[2] = static_cast<float>(j);
         }
     }
 
@@ -162,8 +158,9 @@ public:
     FluxPipeline(PipelineType pipeline_type,
                  const std::filesystem::path& root_dir,
                  const std::string& device,
-                 const ov::AnyMap& properties)
+                 ov::AnyMap properties)
         : DiffusionPipeline(pipeline_type) {
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(properties);
         const std::filesystem::path model_index_path = root_dir / "model_index.json";
         std::ifstream file(model_index_path);
         OPENVINO_ASSERT(file.is_open(), "Failed to open ", model_index_path);
@@ -173,26 +170,38 @@ public:
 
         set_scheduler(Scheduler::from_config(root_dir / "scheduler/scheduler_config.json"));
 
+        // submodels are independent, so they are read and compiled concurrently to reduce pipeline creation time
+        std::vector<std::function<void()>> tasks;
+
         const std::string text_encoder = data["text_encoder"][1].get<std::string>();
         if (text_encoder == "CLIPTextModel") {
-            m_clip_text_encoder = std::make_shared<CLIPTextModel>(root_dir / "text_encoder", device, properties);
+            tasks.push_back([&] () {
+                m_clip_text_encoder = std::make_shared<CLIPTextModel>(root_dir / "text_encoder", device, properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", text_encoder, "' text encoder type");
         }
 
         const std::string t5_text_encoder = data["text_encoder_2"][1].get<std::string>();
         if (t5_text_encoder == "T5EncoderModel") {
-            m_t5_text_encoder = std::make_shared<T5EncoderModel>(root_dir / "text_encoder_2", device, properties);
+            tasks.push_back([&] () {
+                m_t5_text_encoder = std::make_shared<T5EncoderModel>(root_dir / "text_encoder_2", device, properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", t5_text_encoder, "' text encoder type");
         }
 
         const std::string vae = data["vae"][1].get<std::string>();
         if (vae == "AutoencoderKL") {
+            // VAE encoder is not needed, hence not read and compiled, for text to image generation
             if (m_pipeline_type == PipelineType::TEXT_2_IMAGE)
-                m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, properties);
+                tasks.push_back([&] () {
+                    m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, properties);
+                });
             else if (m_pipeline_type == PipelineType::IMAGE_2_IMAGE || m_pipeline_type == PipelineType::INPAINTING) {
-                m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, properties);
+                tasks.push_back([&] () {
+                    m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, properties);
+                });
             } else {
                 OPENVINO_ASSERT("Unsupported pipeline type");
             }
@@ -202,11 +211,15 @@ public:
 
         const std::string transformer = data["transformer"][1].get<std::string>();
         if (transformer == "FluxTransformer2DModel") {
-            m_transformer = std::make_shared<FluxTransformer2DModel>(root_dir / "transformer", device, properties);
+            tasks.push_back([&] () {
+                m_transformer = std::make_shared<FluxTransformer2DModel>(root_dir / "transformer", device, denoiser_properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", transformer, "' Transformer type");
         }
 
+        run_in_parallel(tasks);
+
         // initialize generation config
         initialize_generation_config(data["_class_name"].get<std::string>());
     }
@@ -247,19 +260,27 @@ public:
     }
 
     void compile(const std::string& device, const ov::AnyMap& properties) override {
-        m_clip_text_encoder->compile(device, properties);
-        m_t5_text_encoder->compile(device, properties);
-        m_vae->compile(device, properties);
-        m_transformer->compile(device, properties);
+        ov::AnyMap submodel_properties = properties;
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(submodel_properties);
+        run_in_parallel({
+            [&] () { m_clip_text_encoder->compile(device, submodel_properties); },
+            [&] () { m_t5_text_encoder->compile(device, submodel_properties); },
+            [&] () { m_vae->compile(device, submodel_properties); },
+            [&] () { m_transformer->compile(device, denoiser_properties); }
+        });
     }
     
     void compute_hidden_states(const std::string& positive_prompt, const ImageGenerationConfig& generation_config) override {
         // encode_prompt
         std::string prompt_2_str = generation_config.prompt_2 != std::nullopt ? *generation_config.prompt_2 : positive_prompt;
 
-        m_clip_text_encoder->infer(positive_prompt, {}, false);
+        measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+            return m_clip_text_encoder->infer(positive_prompt, {}, false);
+        });
         ov::Tensor pooled_prompt_embeds = m_clip_text_encoder->get_output_tensor(1);
-        ov::Tensor prompt_embeds = m_t5_text_encoder->infer(prompt_2_str, "", false, generation_config.max_sequence_length);
+        ov::Tensor prompt_embeds = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder_2"], [&] {
+            return m_t5_text_encoder->infer(prompt_2_str, "", false, generation_config.max_sequence_length);
+        });
 
         pooled_prompt_embeds = numpy_utils::repeat(pooled_prompt_embeds, generation_config.num_images_per_prompt);
         prompt_embeds = numpy_utils::repeat(prompt_embeds, generation_config.num_images_per_prompt);
@@ -358,20 +379,29 @@ public:
         float* timestep_data = timestep.data<float>();
 
         for (size_t inference_step = 0; inference_step < timesteps.size(); ++inference_step) {
+            const auto iteration_start = std::chrono::steady_clock::now();
             timestep_data[0] = timesteps[inference_step] / 1000;
 
-            ov::Tensor noise_pred_tensor = m_transformer->infer(latents, timestep);
+            ov::Tensor noise_pred_tensor = measure(m_perf_metrics.raw_metrics.denoiser_inference_durations, [&] {
+                return m_transformer->infer(latents, timestep);
+            });
 
-            auto scheduler_step_result = m_scheduler->step(noise_pred_tensor, latents, inference_step, m_custom_generation_config.generator);
+            auto scheduler_step_result = measure(m_perf_metrics.raw_metrics.scheduler_step_durations, [&] {
+                return m_scheduler->step(noise_pred_tensor, latents, inference_step, m_custom_generation_config.generator);
+            });
             latents = scheduler_step_result["latent"];
 
             if (callback && callback(inference_step, timesteps.size(), latents)) {
                 return ov::Tensor(ov::element::u8, {});
             }
+
+            m_perf_metrics.raw_metrics.iteration_durations.emplace_back(std::chrono::steady_clock::now() - iteration_start);
         }
 
         latents = unpack_latents(latents, m_custom_generation_config.height, m_custom_generation_config.width, vae_scale_factor);
-        return m_vae->decode(latents);
+        return measure(m_perf_metrics.raw_metrics.vae_decoder_inference_durations, [&] {
+            return m_vae->decode(latents);
+        });
     }
 
     ov::Tensor decode(const ov::Tensor latent) override {
@@ -379,7 +409,9 @@ public:
                                                 m_custom_generation_config.height,
                                                 m_custom_generation_config.width,
                                                 m_vae->get_vae_scale_factor());
-        return m_vae->decode(unpacked_latent);
+        return measure(m_perf_metrics.raw_metrics.vae_decoder_inference_durations, [&] {
+            return m_vae->decode(unpacked_latent);
+        });
     }
 
 private:
@@ -5,6 +5,9 @@
 
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
+
+#include "openvino/core/parallel.hpp"
 
 #include "utils.hpp"
 
@@ -38,6 +41,51 @@ void CppStdGenerator::seed(size_t new_seed) {
     m_gen.seed(new_seed);
 }
 
+namespace {
+
+// Generates tensors row by row, each row of a batch with its own generator, so that every image of a batch matches
+// a single image generation with the same generator. Rows are independent, so they are generated in parallel
+class PerImageGenerator : public Generator {
+public:
+    explicit PerImageGenerator(std::vector<std::shared_ptr<Generator>> generators)
+        : m_generators(std::move(generators)) {
+        for (const auto& generator : m_generators) {
+            OPENVINO_ASSERT(generator, "Generator must not be nullptr");
+        }
+    }
+
+    float next() override {
+        OPENVINO_THROW("Per-image generators can be used to generate tensors only");
+    }
+
+    ov::Tensor randn_tensor(const ov::Shape& shape) override {
+        OPENVINO_ASSERT(!shape.empty() && shape[0] == m_generators.size(),
+            "Per-image generators require a tensor with a row per image, but ", shape, " shape is requested. ",
+            "Note, that per-image generators are not supported by image to image and inpainting pipelines");
+
+        ov::Shape row_shape = shape;
+        row_shape[0] = 1;
+
+        ov::Tensor rand_tensor(ov::element::f32, shape);
+        const size_t row_size = ov::shape_size(row_shape);
+        ov::parallel_for(m_generators.size(), [&] (size_t row) {
+            ov::Tensor rand_row = m_generators[row]->randn_tensor(row_shape);
+            std::memcpy(rand_tensor.data<float>() + row * row_size, rand_row.data<const float>(), row_size * sizeof(float));
+        });
+
+        return rand_tensor;
+    }
+
+    void seed(size_t new_seed) override {
+        OPENVINO_THROW("Per-image generators cannot be re-seeded with a single seed");
+    }
+
+private:
+    std::vector<std::shared_ptr<Generator>> m_generators;
+};
+
+} // namespace
+
 //
 // GenerationConfig
 //
@@ -67,9 +115,24 @@ void ImageGenerationConfig::update_generation_config(const ov::AnyMap& propertie
     read_anymap_param(properties, "adapters", adapters);
     read_anymap_param(properties, "max_sequence_length", max_sequence_length);
 
+    // per-image generators have higher priority than per-image seeds, and both have higher priority than 'generator'
+    std::vector<std::shared_ptr<Generator>> image_generators;
+    read_anymap_param(properties, "generators", image_generators);
+    if (image_generators.empty()) {
+        std::vector<size_t> image_rng_seeds;
+        read_anymap_param(properties, "rng_seeds", image_rng_seeds);
+        for (size_t image_rng_seed : image_rng_seeds) {
+            image_generators.push_back(std::make_shared<CppStdGenerator>(image_rng_seed));
+        }
+    }
+
     // 'generator' has higher priority than 'seed' parameter
     const bool have_generator_param = properties.find(ov::genai::generator.name()) != properties.end();
-    if (have_generator_param) {
+    if (!image_generators.empty()) {
+        OPENVINO_ASSERT(image_generators.size() == num_images_per_prompt,
+            "Number of per-image generators or seeds (", image_generators.size(), ") must match 'num_images_per_prompt' (", num_images_per_prompt, ")");
+        generator = std::make_shared<PerImageGenerator>(image_generators);
+    } else if (have_generator_param) {
         read_anymap_param(properties, "generator", generator);
     } else {
         read_anymap_param(properties, "rng_seed", rng_seed);
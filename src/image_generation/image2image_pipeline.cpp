@@ -1,6 +1,7 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
 #include <filesystem>
@@ -16,6 +17,7 @@ namespace ov {
 namespace genai {
 
 Image2ImagePipeline::Image2ImagePipeline(const std::filesystem::path& root_dir) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" || class_name == "LatentConsistencyModelPipeline") {
@@ -25,9 +27,11 @@ Image2ImagePipeline::Image2ImagePipeline(const std::filesystem::path& root_dir)
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 Image2ImagePipeline::Image2ImagePipeline(const std::filesystem::path& root_dir, const std::string& device, const ov::AnyMap& properties) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" || class_name == "LatentConsistencyModelPipeline") {
@@ -37,6 +41,7 @@ Image2ImagePipeline::Image2ImagePipeline(const std::filesystem::path& root_dir,
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 Image2ImagePipeline::Image2ImagePipeline(const InpaintingPipeline& pipe) {
@@ -110,18 +115,28 @@ void Image2ImagePipeline::reshape(const int num_images_per_prompt, const int hei
     m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
 }
 
+void Image2ImagePipeline::reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) {
+    m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
+}
+
 void Image2ImagePipeline::compile(const std::string& device, const ov::AnyMap& properties) {
     m_impl->compile(device, properties);
 }
 
 ov::Tensor Image2ImagePipeline::generate(const std::string& positive_prompt, ov::Tensor initial_image, const ov::AnyMap& properties) {
     OPENVINO_ASSERT(initial_image, "Initial image cannot be empty when passed to Image2ImagePipeline::generate");
-    return m_impl->generate(positive_prompt, initial_image, {}, properties);
+    return m_impl->measure_generation([&] {
+        return m_impl->generate(positive_prompt, initial_image, {}, properties);
+    });
 }
 
 ov::Tensor Image2ImagePipeline::decode(const ov::Tensor latent) {
     return m_impl->decode(latent);
 }
 
+ImageGenerationPerfMetrics Image2ImagePipeline::get_performance_metrics() {
+    return m_impl->get_performance_metrics();
+}
+
 }  // namespace genai
 }  // namespace ov
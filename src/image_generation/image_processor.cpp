@@ -4,6 +4,7 @@
 #include "image_generation/image_processor.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "openvino/core/model.hpp"
 #include "openvino/op/parameter.hpp"
@@ -42,11 +43,58 @@ void IImageProcessor::compile(std::shared_ptr<ov::Model> model) {
 }
 
 ImageProcessor::ImageProcessor(const std::string& device, bool do_normalize, bool do_binarize, bool gray_scale_source) :
-    IImageProcessor(device) {
-    auto image_processor_model = create_empty_model();
-    merge_image_preprocessing(image_processor_model, do_normalize, do_binarize, gray_scale_source);
+    IImageProcessor(device),
+    m_do_normalize(do_normalize),
+    m_gray_scale_source(gray_scale_source) {
+    OPENVINO_ASSERT(do_normalize ^ do_binarize, "Both binarize and normalize are not supported");
+
+    if (m_device != "CPU") {
+        auto image_processor_model = create_empty_model();
+        merge_image_preprocessing(image_processor_model, do_normalize, do_binarize, gray_scale_source);
+
+        compile(image_processor_model);
+    }
+}
+
+ov::Tensor ImageProcessor::execute(ov::Tensor image) {
+    if (m_device != "CPU") {
+        return IImageProcessor::execute(image);
+    }
+
+    // the same as a model built by merge_image_preprocessing: u8 NHWC image to f32 NCHW tensor
+    OPENVINO_ASSERT(image.get_element_type() == ov::element::u8 && image.get_shape().size() == 4, "Image must be u8 tensor in NHWC layout");
+    const ov::Shape shape = image.get_shape();
+    const size_t batch_size = shape[0], plane_size = shape[1] * shape[2], channels = shape[3];
+    OPENVINO_ASSERT(channels == (m_gray_scale_source ? 1 : 3), "Image must have ", m_gray_scale_source ? 1 : 3, " channels");
+
+    const uint8_t* image_data = image.data<const uint8_t>();
+
+    if (m_do_normalize) {
+        m_processed.set_shape({batch_size, channels, shape[1], shape[2]});
+        float* processed_data = m_processed.data<float>();
+
+        for (size_t b = 0; b < batch_size; ++b) {
+            const uint8_t* src = image_data + b * plane_size * channels;
+            float* dst = processed_data + b * plane_size * channels;
+            for (size_t c = 0; c < channels; ++c) {
+                for (size_t i = 0; i < plane_size; ++i) {
+                    dst[c * plane_size + i] = src[i * channels + c] / (255.0f / 2.0f) - 1.0f;
+                }
+            }
+        }
+    } else {
+        // binarized gray scale mask, RGB is converted to gray with BT.601 weights used by RGB -> GRAY color conversion
+        m_processed.set_shape({batch_size, 1, shape[1], shape[2]});
+        float* processed_data = m_processed.data<float>();
+
+        for (size_t i = 0; i < batch_size * plane_size; ++i) {
+            const uint8_t* pixel = image_data + i * channels;
+            const float gray = m_gray_scale_source ? pixel[0] : 0.299f * pixel[0] + 0.587f * pixel[1] + 0.114f * pixel[2];
+            processed_data[i] = gray / 255.0f >= 0.5f ? 1.0f : 0.0f;
+        }
+    }
 
-    compile(image_processor_model);
+    return m_processed;
 }
 
 void ImageProcessor::merge_image_preprocessing(std::shared_ptr<ov::Model> model, bool do_normalize, bool do_binarize, bool gray_scale_source) {
@@ -120,10 +168,26 @@ ImageResizer::ImageResizer(const std::string& device, ov::element::Type type, ov
     auto result = std::make_shared<ov::op::v0::Result>(interp);
     auto resize_model = std::make_shared<ov::Model>(ov::ResultVector{result}, ov::ParameterVector{image_parameter, target_spatial_shape});
 
-    m_request = utils::singleton_core().compile_model(resize_model, device).create_infer_request();
+    m_height_idx = height_idx;
+    m_width_idx = width_idx;
+    m_is_direct_nearest = device == "CPU" && type == ov::element::f32 && layout == ov::Layout("NCHW") &&
+        interpolation_mode == ov::op::v11::Interpolate::InterpolateMode::NEAREST;
+
+    if (!m_is_direct_nearest) {
+        m_request = utils::singleton_core().compile_model(resize_model, device).create_infer_request();
+    }
 }
 
 ov::Tensor ImageResizer::execute(ov::Tensor image, int64_t dst_height, int64_t dst_width) {
+    const ov::Shape& shape = image.get_shape();
+    if (static_cast<int64_t>(shape[m_height_idx]) == dst_height && static_cast<int64_t>(shape[m_width_idx]) == dst_width) {
+        return image;
+    }
+
+    if (m_is_direct_nearest) {
+        return resize_nearest(image, dst_height, dst_width);
+    }
+
     ov::Tensor target_spatial_tensor(ov::element::i64, ov::Shape{2});
     target_spatial_tensor.data<int64_t>()[0] = dst_height;
     target_spatial_tensor.data<int64_t>()[1] = dst_width;
@@ -135,6 +199,34 @@ ov::Tensor ImageResizer::execute(ov::Tensor image, int64_t dst_height, int64_t d
     return m_request.get_output_tensor();
 }
 
+ov::Tensor ImageResizer::resize_nearest(ov::Tensor image, int64_t dst_height, int64_t dst_width) {
+    // asymmetric coordinate transformation with floor rounding: src = floor(dst * src_size / dst_size)
+    const ov::Shape shape = image.get_shape();
+    const size_t num_planes = shape[0] * shape[1], src_height = shape[2], src_width = shape[3];
+    const size_t height = static_cast<size_t>(dst_height), width = static_cast<size_t>(dst_width);
+
+    m_resized.set_shape({shape[0], shape[1], height, width});
+    const float* image_data = image.data<const float>();
+    float* resized_data = m_resized.data<float>();
+
+    std::vector<size_t> src_x(width);
+    for (size_t x = 0; x < width; ++x) {
+        src_x[x] = x * src_width / width;
+    }
+
+    for (size_t plane = 0; plane < num_planes; ++plane) {
+        for (size_t y = 0; y < height; ++y) {
+            const float* src_row = image_data + (plane * src_height + y * src_height / height) * src_width;
+            float* dst_row = resized_data + (plane * height + y) * width;
+            for (size_t x = 0; x < width; ++x) {
+                dst_row[x] = src_row[src_x[x]];
+            }
+        }
+    }
+
+    return m_resized;
+}
+
 size_t ImageResizer::get_and_check_width_idx(const Layout& layout, const PartialShape& shape) {
     OPENVINO_ASSERT(ov::layout::has_width(layout), "Layout ", layout.to_string(), " doesn't have `width` dimension");
     OPENVINO_ASSERT(shape.rank().is_static(), "Can't get shape width index for shape with dynamic rank");
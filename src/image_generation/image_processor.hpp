@@ -30,20 +30,35 @@ class ImageProcessor : public IImageProcessor {
 public:
     explicit ImageProcessor(const std::string& device, bool do_normalize = true, bool do_binarize = false, bool gray_scale_source = false);
 
+    // on CPU images are processed directly without a model, which overhead is significant for small images
+    ov::Tensor execute(ov::Tensor image) override;
+
     static void merge_image_preprocessing(std::shared_ptr<ov::Model> model, bool do_normalize = true, bool do_binarize = false, bool gray_scale_source = false);
+
+private:
+    // binarization is done if normalization is not, the constructor checks they are exclusive
+    bool m_do_normalize, m_gray_scale_source;
+    // output of direct processing, reused by subsequent calls similar to output tensor of infer request
+    ov::Tensor m_processed{ov::element::f32, {}};
 };
 
 class ImageResizer {
 public:
     ImageResizer(const std::string& device, ov::element::Type type, ov::Layout layout, ov::op::v11::Interpolate::InterpolateMode interpolation_mode);
 
+    // resize to the same size returns the image itself, nearest resize of f32 NCHW images is done directly on CPU
     ov::Tensor execute(ov::Tensor image, int64_t dst_height, int64_t dst_width);
 
 private:
     size_t get_and_check_width_idx(const Layout& layout, const PartialShape& shape);
     size_t get_and_check_height_idx(const Layout& layout, const PartialShape& shape);
 
+    ov::Tensor resize_nearest(ov::Tensor image, int64_t dst_height, int64_t dst_width);
+
     ov::InferRequest m_request;
+    bool m_is_direct_nearest;
+    size_t m_height_idx, m_width_idx;
+    ov::Tensor m_resized{ov::element::f32, {}};
 };
 
 } // namespace genai
@@ -1,8 +1,12 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 
 #include "openvino/genai/image_generation/inpainting_pipeline.hpp"
@@ -13,10 +17,114 @@
 
 #include "utils.hpp"
 
+namespace {
+
+// crop sizes are multiples of 64 pixels, so that latents of the crop are divisible by UNet downsampling factor
+constexpr size_t MASK_CROP_ALIGNMENT = 64;
+
+struct CropRegion {
+    size_t top, left, height, width;
+};
+
+// aligns [begin, end) range of masked pixels extended by padding within [0, size)
+// returns false if aligned range cannot fit the dimension
+bool align_crop_range(size_t begin, size_t end, size_t padding, size_t size, size_t& crop_begin, size_t& crop_size) {
+    begin = begin > padding ? begin - padding : 0;
+    end = std::min(end + padding, size);
+
+    crop_size = (end - begin + MASK_CROP_ALIGNMENT - 1) / MASK_CROP_ALIGNMENT * MASK_CROP_ALIGNMENT;
+    if (crop_size > size)
+        crop_size = size - size % MASK_CROP_ALIGNMENT;
+    if (crop_size == 0)
+        return false;
+
+    // grow range symmetrically to the aligned size and shift it back into the image if needed
+    const size_t grow = crop_size > end - begin ? (crop_size - (end - begin)) / 2 : 0;
+    crop_begin = std::min(begin > grow ? begin - grow : 0, size - crop_size);
+    return true;
+}
+
+// computes a region to inpaint as a padded bounding box of masked pixels
+// returns false if mask is empty or the region covers the whole image
+bool get_mask_crop_region(ov::Tensor mask, size_t padding, CropRegion& region) {
+    const ov::Shape shape = mask.get_shape();
+    const size_t height = shape[1], width = shape[2], channels = shape[3];
+    const uint8_t* mask_data = mask.data<const uint8_t>();
+
+    // mask is binarized by 0.5 threshold within pipelines
+    size_t top = height, bottom = 0, left = width, right = 0;
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            if (mask_data[(y * width + x) * channels] >= 128) {
+                top = std::min(top, y);
+                bottom = std::max(bottom, y + 1);
+                left = std::min(left, x);
+                right = std::max(right, x + 1);
+            }
+        }
+    }
+
+    if (top >= bottom ||
+        !align_crop_range(top, bottom, padding, height, region.top, region.height) ||
+        !align_crop_range(left, right, padding, width, region.left, region.width))
+        return false;
+
+    return region.height < height || region.width < width;
+}
+
+ov::Tensor crop_image(ov::Tensor image, const CropRegion& region) {
+    const ov::Shape shape = image.get_shape();
+    const size_t width = shape[2], channels = shape[3];
+    ov::Tensor cropped(image.get_element_type(), {shape[0], region.height, region.width, channels});
+
+    const uint8_t* image_data = image.data<const uint8_t>();
+    uint8_t* cropped_data = cropped.data<uint8_t>();
+    const size_t row_size = region.width * channels;
+    for (size_t y = 0; y < region.height; ++y) {
+        std::memcpy(cropped_data + y * row_size, image_data + ((region.top + y) * width + region.left) * channels, row_size);
+    }
+
+    return cropped;
+}
+
+// pastes generated crops into copies of initial image, blending them by mask, so unmasked pixels are kept intact
+ov::Tensor composite_crop(ov::Tensor initial_image, ov::Tensor mask, ov::Tensor generated, const CropRegion& region) {
+    const ov::Shape shape = initial_image.get_shape();
+    const size_t num_images = generated.get_shape()[0], height = shape[1], width = shape[2], mask_channels = mask.get_shape()[3];
+    const size_t image_size = height * width * 3;
+    ov::Tensor image(ov::element::u8, {num_images, height, width, 3});
+
+    const uint8_t* initial_image_data = initial_image.data<const uint8_t>();
+    const uint8_t* mask_data = mask.data<const uint8_t>();
+    const uint8_t* generated_data = generated.data<const uint8_t>();
+    uint8_t* image_data = image.data<uint8_t>();
+
+    for (size_t n = 0; n < num_images; ++n, image_data += image_size, generated_data += region.height * region.width * 3) {
+        std::memcpy(image_data, initial_image_data, image_size);
+
+        for (size_t y = 0; y < region.height; ++y) {
+            for (size_t x = 0; x < region.width; ++x) {
+                const size_t pixel = (region.top + y) * width + region.left + x;
+                const float alpha = mask_data[pixel * mask_channels] / 255.0f;
+                for (size_t c = 0; c < 3; ++c) {
+                    const float original = initial_image_data[pixel * 3 + c];
+                    const float inpainted = generated_data[(y * region.width + x) * 3 + c];
+                    image_data[pixel * 3 + c] = static_cast<uint8_t>(std::lround(original + alpha * (inpainted - original)));
+                }
+            }
+        }
+    }
+
+    return image;
+}
+
+} // namespace
+
 namespace ov {
 namespace genai {
 
 InpaintingPipeline::InpaintingPipeline(const std::filesystem::path& root_dir) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" || 
@@ -28,9 +136,11 @@ InpaintingPipeline::InpaintingPipeline(const std::filesystem::path& root_dir) {
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 InpaintingPipeline::InpaintingPipeline(const std::filesystem::path& root_dir, const std::string& device, const ov::AnyMap& properties) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" ||
@@ -42,6 +152,7 @@ InpaintingPipeline::InpaintingPipeline(const std::filesystem::path& root_dir, co
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 InpaintingPipeline::InpaintingPipeline(const Image2ImagePipeline& pipe) {
@@ -115,6 +226,10 @@ void InpaintingPipeline::reshape(const int num_images_per_prompt, const int heig
     m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
 }
 
+void InpaintingPipeline::reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) {
+    m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
+}
+
 void InpaintingPipeline::compile(const std::string& device, const ov::AnyMap& properties) {
     m_impl->compile(device, properties);
 }
@@ -122,12 +237,45 @@ void InpaintingPipeline::compile(const std::string& device, const ov::AnyMap& pr
 ov::Tensor InpaintingPipeline::generate(const std::string& positive_prompt, ov::Tensor initial_image, ov::Tensor mask, const ov::AnyMap& properties) {
     OPENVINO_ASSERT(initial_image, "Initial image cannot be empty when passed to InpaintingPipeline::generate");
     OPENVINO_ASSERT(mask, "Mask image cannot be empty when passed to InpaintingPipeline::generate");
-    return m_impl->generate(positive_prompt, initial_image, mask, properties);
+
+    return m_impl->measure_generation([&] {
+        auto padding_mask_crop_iter = properties.find(ov::genai::padding_mask_crop.name());
+        if (padding_mask_crop_iter == properties.end())
+            return m_impl->generate(positive_prompt, initial_image, mask, properties);
+
+        const int padding = padding_mask_crop_iter->second.as<int>();
+        OPENVINO_ASSERT(padding >= 0, "'padding_mask_crop' must be non-negative");
+
+        const ov::Shape image_shape = initial_image.get_shape(), mask_shape = mask.get_shape();
+        OPENVINO_ASSERT(initial_image.get_element_type() == ov::element::u8 && image_shape.size() == 4 && image_shape[0] == 1 && image_shape[3] == 3,
+            "'padding_mask_crop' requires u8 initial image of [1, height, width, 3] shape");
+        OPENVINO_ASSERT(mask.get_element_type() == ov::element::u8 && mask_shape.size() == 4 && mask_shape[0] == 1 &&
+            mask_shape[1] == image_shape[1] && mask_shape[2] == image_shape[2],
+            "'padding_mask_crop' requires u8 mask image of the same size as initial image");
+
+        CropRegion region;
+        if (!get_mask_crop_region(mask, padding, region)) {
+            // nothing to gain from cropping
+            return m_impl->generate(positive_prompt, initial_image, mask, properties);
+        }
+
+        ov::AnyMap crop_properties = properties;
+        crop_properties[ov::genai::height.name()] = static_cast<int64_t>(region.height);
+        crop_properties[ov::genai::width.name()] = static_cast<int64_t>(region.width);
+
+        ov::Tensor generated = m_impl->generate(positive_prompt, crop_image(initial_image, region), crop_image(mask, region), crop_properties);
+        // empty image means that generation is cancelled by callback
+        return generated.get_size() == 0 ? generated : composite_crop(initial_image, mask, generated, region);
+    });
 }
 
 ov::Tensor InpaintingPipeline::decode(const ov::Tensor latent) {
     return m_impl->decode(latent);
 }
 
+ImageGenerationPerfMetrics InpaintingPipeline::get_performance_metrics() {
+    return m_impl->get_performance_metrics();
+}
+
 }  // namespace genai
 }  // namespace ov
@@ -3,8 +3,12 @@
 
 #include "openvino/genai/image_generation/autoencoder_kl.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <list>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
 
 #include "openvino/runtime/core.hpp"
 #include "openvino/core/preprocess/pre_post_process.hpp"
@@ -64,6 +68,183 @@ private:
     ov::Tensor m_mean, m_std;
 };
 
+// Outputs of the encoder model for recently encoded images with hashes of the images, the most recently used first.
+struct AutoencoderKL::EncoderCache {
+    explicit EncoderCache(size_t capacity) : capacity(capacity) {}
+
+    // returns a copy of the cached output, as encode() modifies it in place, or an empty tensor
+    ov::Tensor find(size_t hash) {
+        auto it = index.find(hash);
+        if (it == index.end())
+            return {};
+        entries.splice(entries.begin(), entries, it->second);
+        const ov::Tensor& cached = it->second->second;
+        ov::Tensor output(cached.get_element_type(), cached.get_shape());
+        cached.copy_to(output);
+        return output;
+    }
+
+    void add(size_t hash, const ov::Tensor& output) {
+        const size_t byte_size = output.get_byte_size();
+        if (byte_size > capacity || index.count(hash))
+            return;
+        while (size + byte_size > capacity) {
+            size -= entries.back().second.get_byte_size();
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        ov::Tensor cached(output.get_element_type(), output.get_shape());
+        output.copy_to(cached);
+        entries.emplace_front(hash, cached);
+        index.emplace(hash, entries.begin());
+        size += byte_size;
+    }
+
+    size_t capacity, size = 0;
+    std::list<std::pair<size_t, ov::Tensor>> entries;
+    std::unordered_map<size_t, std::list<std::pair<size_t, ov::Tensor>>::iterator> index;
+};
+
+namespace {
+
+// Hashes content and shape of an image, so that images of different resolutions do not share outputs
+size_t get_image_hash(const ov::Tensor& image) {
+    size_t hash = std::hash<std::string_view>{}(
+        std::string_view(static_cast<const char*>(image.data()), image.get_byte_size()));
+    for (size_t dim : image.get_shape()) {
+        hash ^= std::hash<size_t>{}(dim) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+// Starts of tiles of tile_size covering size with at least overlap between neighbors, the last tile ends at size
+std::vector<size_t> get_tile_starts(size_t size, size_t tile_size, size_t overlap) {
+    if (size <= tile_size) {
+        return {0};
+    }
+    const size_t stride = tile_size - overlap;
+    const size_t num_tiles = (size - tile_size + stride - 1) / stride + 1;
+    std::vector<size_t> starts(num_tiles);
+    for (size_t tile_idx = 0; tile_idx + 1 < num_tiles; ++tile_idx) {
+        starts[tile_idx] = tile_idx * stride;
+    }
+    starts.back() = size - tile_size;
+    return starts;
+}
+
+// Weight of a pixel at offset in a tile, which rises linearly over overlap pixels at sides with a neighboring tile
+float get_blend_weight(size_t offset, size_t tile_size, size_t overlap, bool has_prev, bool has_next) {
+    float weight = 1.0f;
+    if (has_prev && offset < overlap) {
+        weight = std::min(weight, (offset + 0.5f) / overlap);
+    }
+    if (has_next && offset + overlap >= tile_size) {
+        weight = std::min(weight, (tile_size - offset - 0.5f) / overlap);
+    }
+    return weight;
+}
+
+// Infers requests on overlapping tiles of input [N, C, H, W] of tile_size and blends outputs of the tiles, whose
+// spatial size is proportional to the tile size. Output layout is NHWC if nhwc_output, otherwise NCHW. Input tiles
+// beyond the input replicate its border, their outputs are cropped.
+ov::Tensor infer_tiled(std::vector<ov::InferRequest>& requests, const ov::Tensor& input, size_t tile_size, size_t tile_overlap, bool nhwc_output) {
+    const ov::Shape& input_shape = input.get_shape();
+    OPENVINO_ASSERT(input_shape.size() == 4 && input.get_element_type() == ov::element::f32, "Tiled VAE input must be f32 of NCHW layout");
+    const size_t batch_size = input_shape[0], channels = input_shape[1], height = input_shape[2], width = input_shape[3];
+    const std::vector<size_t> row_starts = get_tile_starts(height, tile_size, tile_overlap);
+    const std::vector<size_t> col_starts = get_tile_starts(width, tile_size, tile_overlap);
+
+    std::vector<ov::Tensor> tile_inputs(requests.size());
+    for (ov::Tensor& tile_input : tile_inputs) {
+        tile_input = ov::Tensor(ov::element::f32, {batch_size, channels, tile_size, tile_size});
+    }
+
+    ov::Tensor output;
+    std::vector<float> accumulated, weights;
+    size_t out_channels = 0, out_tile_size = 0, out_height = 0, out_width = 0, out_overlap = 0;
+
+    auto accumulate = [&](const ov::Tensor& tile_output, size_t row_idx, size_t col_idx) {
+        const ov::Shape& tile_shape = tile_output.get_shape();
+        if (!output) {
+            out_channels = nhwc_output ? tile_shape[3] : tile_shape[1];
+            out_tile_size = tile_shape[2];
+            out_height = height * out_tile_size / tile_size;
+            out_width = width * out_tile_size / tile_size;
+            out_overlap = tile_overlap * out_tile_size / tile_size;
+            output = nhwc_output ? ov::Tensor(tile_output.get_element_type(), {batch_size, out_height, out_width, out_channels})
+                                 : ov::Tensor(tile_output.get_element_type(), {batch_size, out_channels, out_height, out_width});
+            accumulated.assign(output.get_size(), 0.0f);
+            weights.assign(out_height * out_width, 0.0f);
+        }
+        const bool is_u8 = tile_output.get_element_type() == ov::element::u8;
+        const uint8_t* tile_u8 = is_u8 ? tile_output.data<uint8_t>() : nullptr;
+        const float* tile_f32 = is_u8 ? nullptr : tile_output.data<float>();
+
+        const size_t y0 = row_starts[row_idx] * out_tile_size / tile_size, x0 = col_starts[col_idx] * out_tile_size / tile_size;
+        const size_t tile_height = std::min(out_tile_size, out_height - y0), tile_width = std::min(out_tile_size, out_width - x0);
+        const size_t plane_size = out_height * out_width, tile_plane_size = out_tile_size * out_tile_size;
+        for (size_t y = 0; y < tile_height; ++y) {
+            const float weight_y = get_blend_weight(y, out_tile_size, out_overlap, row_idx > 0, row_idx + 1 < row_starts.size());
+            for (size_t x = 0; x < tile_width; ++x) {
+                const float weight = weight_y * get_blend_weight(x, out_tile_size, out_overlap, col_idx > 0, col_idx + 1 < col_starts.size());
+                const size_t pixel = (y0 + y) * out_width + x0 + x, tile_pixel = y * out_tile_size + x;
+                weights[pixel] += weight;
+                for (size_t batch = 0; batch < batch_size; ++batch) {
+                    for (size_t channel = 0; channel < out_channels; ++channel) {
+                        const size_t src = nhwc_output ? (batch * tile_plane_size + tile_pixel) * out_channels + channel
+                                                       : (batch * out_channels + channel) * tile_plane_size + tile_pixel;
+                        const size_t dst = nhwc_output ? (batch * plane_size + pixel) * out_channels + channel
+                                                       : (batch * out_channels + channel) * plane_size + pixel;
+                        accumulated[dst] += weight * (is_u8 ? tile_u8[src] : tile_f32[src]);
+                    }
+                }
+            }
+        }
+    };
+
+    const float* input_data = input.data<float>();
+    const size_t num_tiles = row_starts.size() * col_starts.size();
+    for (size_t first_tile = 0; first_tile < num_tiles; first_tile += requests.size()) {
+        const size_t num_batch_tiles = std::min(requests.size(), num_tiles - first_tile);
+        for (size_t request_idx = 0; request_idx < num_batch_tiles; ++request_idx) {
+            const size_t row_start = row_starts[(first_tile + request_idx) / col_starts.size()];
+            const size_t col_start = col_starts[(first_tile + request_idx) % col_starts.size()];
+            float* tile_data = tile_inputs[request_idx].data<float>();
+            for (size_t plane = 0; plane < batch_size * channels; ++plane) {
+                for (size_t y = 0; y < tile_size; ++y) {
+                    const float* src_row = input_data + (plane * height + std::min(row_start + y, height - 1)) * width;
+                    float* dst_row = tile_data + (plane * tile_size + y) * tile_size;
+                    const size_t num_copied = std::min(tile_size, width - col_start);
+                    std::copy_n(src_row + col_start, num_copied, dst_row);
+                    std::fill(dst_row + num_copied, dst_row + tile_size, src_row[width - 1]);
+                }
+            }
+            requests[request_idx].set_input_tensor(tile_inputs[request_idx]);
+            requests[request_idx].start_async();
+        }
+        for (size_t request_idx = 0; request_idx < num_batch_tiles; ++request_idx) {
+            requests[request_idx].wait();
+            accumulate(requests[request_idx].get_output_tensor(),
+                       (first_tile + request_idx) / col_starts.size(),
+                       (first_tile + request_idx) % col_starts.size());
+        }
+    }
+
+    const size_t plane_size = out_height * out_width;
+    for (size_t idx = 0; idx < accumulated.size(); ++idx) {
+        const size_t pixel = nhwc_output ? idx / out_channels % plane_size : idx % plane_size;
+        const float value = accumulated[idx] / weights[pixel];
+        if (output.get_element_type() == ov::element::u8) {
+            output.data<uint8_t>()[idx] = static_cast<uint8_t>(std::clamp(std::round(value), 0.0f, 255.0f));
+        } else {
+            output.data<float>()[idx] = value;
+        }
+    }
+    return output;
+}
+
+} // namespace
+
 size_t get_vae_scale_factor(const std::filesystem::path& vae_config_path) {
     std::ifstream file(vae_config_path);
     OPENVINO_ASSERT(file.is_open(), "Failed to open ", vae_config_path);
@@ -74,6 +255,15 @@ size_t get_vae_scale_factor(const std::filesystem::path& vae_config_path) {
     return std::pow(2, block_out_channels.size() - 1);
 }
 
+ov::Dimension get_latent_dimension(const ov::Dimension& image_dimension, size_t vae_scale_factor) {
+    // dynamic dimension has zero min length and negative max length
+    const int64_t min_length = image_dimension.get_min_length(), max_length = image_dimension.get_max_length();
+    const int64_t scale_factor = static_cast<int64_t>(vae_scale_factor);
+    OPENVINO_ASSERT(min_length % scale_factor == 0 && (max_length < 0 || max_length % scale_factor == 0),
+        "Both 'width' and 'height' must be divisible by ", vae_scale_factor);
+    return ov::Dimension(min_length / scale_factor, max_length < 0 ? -1 : max_length / scale_factor);
+}
+
 AutoencoderKL::Config::Config(const std::filesystem::path& config_path) {
     std::ifstream file(config_path);
     OPENVINO_ASSERT(file.is_open(), "Failed to open ", config_path);
@@ -182,13 +372,16 @@ AutoencoderKL::AutoencoderKL(const std::string& vae_encoder_model,
 AutoencoderKL::AutoencoderKL(const AutoencoderKL&) = default;
 
 AutoencoderKL& AutoencoderKL::reshape(int batch_size, int height, int width) {
+    // negative sizes are kept dynamic
+    return reshape(batch_size, ov::Dimension(height < 0 ? -1 : height), ov::Dimension(width < 0 ? -1 : width));
+}
+
+AutoencoderKL& AutoencoderKL::reshape(int batch_size, const ov::Dimension& height, const ov::Dimension& width) {
     OPENVINO_ASSERT(m_decoder_model, "Model has been already compiled. Cannot reshape already compiled model");
 
     const size_t vae_scale_factor = get_vae_scale_factor();
-
-    OPENVINO_ASSERT((height % vae_scale_factor == 0 || height < 0) &&
-            (width % vae_scale_factor == 0 || width < 0), "Both 'width' and 'height' must be divisible by ",
-            vae_scale_factor);
+    const ov::Dimension latent_height = get_latent_dimension(height, vae_scale_factor);
+    const ov::Dimension latent_width = get_latent_dimension(width, vae_scale_factor);
 
     if (m_encoder_model) {
         ov::PartialShape input_shape = m_encoder_model->input(0).get_partial_shape();
@@ -196,31 +389,75 @@ AutoencoderKL& AutoencoderKL::reshape(int batch_size, int height, int width) {
         m_encoder_model->reshape(idx_to_shape);
     }
 
-    height /= vae_scale_factor;
-    width /= vae_scale_factor;
-
     ov::PartialShape input_shape = m_decoder_model->input(0).get_partial_shape();
-    std::map<size_t, ov::PartialShape> idx_to_shape{{0, {batch_size, input_shape[1], height, width}}};
+    std::map<size_t, ov::PartialShape> idx_to_shape{{0, {batch_size, input_shape[1], latent_height, latent_width}}};
     m_decoder_model->reshape(idx_to_shape);
 
     return *this;
 }
 
+AutoencoderKL& AutoencoderKL::enable_tiling(size_t tile_size, size_t tile_overlap, size_t num_infer_requests) {
+    OPENVINO_ASSERT(m_decoder_model, "Model has been already compiled. Tiling must be enabled before compilation");
+
+    const size_t vae_scale_factor = get_vae_scale_factor();
+    OPENVINO_ASSERT(tile_size % vae_scale_factor == 0 && tile_overlap % vae_scale_factor == 0,
+        "Both tile size and tile overlap must be divisible by ", vae_scale_factor);
+    OPENVINO_ASSERT(tile_overlap < tile_size, "Tile overlap ", tile_overlap, " must be less than tile size ", tile_size);
+    OPENVINO_ASSERT(num_infer_requests > 0, "Number of infer requests must be positive");
+
+    m_tile_size = tile_size;
+    m_tile_overlap = tile_overlap;
+    m_num_tile_requests = num_infer_requests;
+
+    return *this;
+}
+
+AutoencoderKL& AutoencoderKL::enable_encoder_cache(size_t capacity) {
+    OPENVINO_ASSERT(m_encoder_model || m_encoder_request, "VAE encoder model is required to cache its outputs");
+    m_encoder_cache = capacity > 0 ? std::make_shared<EncoderCache>(capacity) : nullptr;
+    return *this;
+}
+
 AutoencoderKL& AutoencoderKL::compile(const std::string& device, const ov::AnyMap& properties) {
     OPENVINO_ASSERT(m_decoder_model, "Model has been already compiled. Cannot re-compile already compiled model");
     ov::Core core = utils::singleton_core();
 
+    const size_t vae_scale_factor = get_vae_scale_factor();
+    // tiles are encoded and decoded by models of the tile size, batch keeps the size set by reshape()
+    auto reshape_to_tile = [](const std::shared_ptr<ov::Model>& model, size_t tile_size) {
+        ov::PartialShape input_shape = model->input(0).get_partial_shape();
+        const ov::Dimension tile_dim(static_cast<ov::Dimension::value_type>(tile_size));
+        std::map<size_t, ov::PartialShape> idx_to_shape{{0, {input_shape[0], input_shape[1], tile_dim, tile_dim}}};
+        model->reshape(idx_to_shape);
+    };
+
+    auto create_infer_requests = [this](ov::CompiledModel& compiled_model, ov::InferRequest& request, std::vector<ov::InferRequest>& tile_requests) {
+        request = compiled_model.create_infer_request();
+        if (m_tile_size > 0) {
+            tile_requests = {request};
+            while (tile_requests.size() < m_num_tile_requests) {
+                tile_requests.push_back(compiled_model.create_infer_request());
+            }
+        }
+    };
+
     if (m_encoder_model) {
+        if (m_tile_size > 0) {
+            reshape_to_tile(m_encoder_model, m_tile_size);
+        }
         ov::CompiledModel encoder_compiled_model = core.compile_model(m_encoder_model, device, properties);
         ov::genai::utils::print_compiled_model_properties(encoder_compiled_model, "Auto encoder KL encoder model");
-        m_encoder_request = encoder_compiled_model.create_infer_request();
+        create_infer_requests(encoder_compiled_model, m_encoder_request, m_tile_encoder_requests);
         // release the original model
         m_encoder_model.reset();
     }
 
+    if (m_tile_size > 0) {
+        reshape_to_tile(m_decoder_model, m_tile_size / vae_scale_factor);
+    }
     ov::CompiledModel decoder_compiled_model = core.compile_model(m_decoder_model, device, properties);
     ov::genai::utils::print_compiled_model_properties(decoder_compiled_model, "Auto encoder KL decoder model");
-    m_decoder_request = decoder_compiled_model.create_infer_request();
+    create_infer_requests(decoder_compiled_model, m_decoder_request, m_tile_decoder_requests);
     // release the original model
     m_decoder_model.reset();
 
@@ -230,6 +467,11 @@ AutoencoderKL& AutoencoderKL::compile(const std::string& device, const ov::AnyMa
 ov::Tensor AutoencoderKL::decode(ov::Tensor latent) {
     OPENVINO_ASSERT(m_decoder_request, "VAE decoder model must be compiled first. Cannot infer non-compiled model");
 
+    if (m_tile_size > 0) {
+        const size_t vae_scale_factor = get_vae_scale_factor();
+        return infer_tiled(m_tile_decoder_requests, latent, m_tile_size / vae_scale_factor, m_tile_overlap / vae_scale_factor, true);
+    }
+
     m_decoder_request.set_input_tensor(latent);
     m_decoder_request.infer();
     return m_decoder_request.get_output_tensor();
@@ -238,10 +480,25 @@ ov::Tensor AutoencoderKL::decode(ov::Tensor latent) {
 ov::Tensor AutoencoderKL::encode(ov::Tensor image, std::shared_ptr<Generator> generator) {
     OPENVINO_ASSERT(m_encoder_request, "VAE encoder model must be compiled first. Cannot infer non-compiled model");
 
-    m_encoder_request.set_input_tensor(image);
-    m_encoder_request.infer();
+    ov::Tensor output, latent;
+    size_t image_hash = 0;
+    if (m_encoder_cache) {
+        image_hash = get_image_hash(image);
+        output = m_encoder_cache->find(image_hash);
+    }
 
-    ov::Tensor output = m_encoder_request.get_output_tensor(), latent;
+    if (!output) {
+        if (m_tile_size > 0) {
+            output = infer_tiled(m_tile_encoder_requests, image, m_tile_size, m_tile_overlap, false);
+        } else {
+            m_encoder_request.set_input_tensor(image);
+            m_encoder_request.infer();
+            output = m_encoder_request.get_output_tensor();
+        }
+        if (m_encoder_cache) {
+            m_encoder_cache->add(image_hash, output);
+        }
+    }
 
     ov::CompiledModel compiled_model = m_encoder_request.get_compiled_model();
     auto outputs = compiled_model.outputs();
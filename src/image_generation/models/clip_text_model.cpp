@@ -5,6 +5,7 @@
 
 #include <fstream>
 
+#include "image_generation/models/text_encoder_cache.hpp"
 #include "json_utils.hpp"
 #include "lora_helper.hpp"
 #include "utils.hpp"
@@ -108,12 +109,29 @@ CLIPTextModel& CLIPTextModel::compile(const std::string& device, const ov::AnyMa
 void CLIPTextModel::set_adapters(const std::optional<AdapterConfig>& adapters) {
     if (adapters) {
         m_adapter_controller.apply(m_request, *adapters);
+        // cached outputs may be computed with other adapters
+        if (m_cache)
+            m_cache->clear();
     }
 }
 
+CLIPTextModel& CLIPTextModel::set_cache_capacity(size_t capacity) {
+    if (!m_cache)
+        m_cache = std::make_shared<TextEncoderCache>(capacity);
+    m_cache->set_capacity(capacity);
+    return *this;
+}
+
 ov::Tensor CLIPTextModel::infer(const std::string& pos_prompt, const std::string& neg_prompt, bool do_classifier_free_guidance) {
     OPENVINO_ASSERT(m_request, "CLIP text encoder model must be compiled first. Cannot infer non-compiled model");
 
+    if (!m_cache)
+        m_cache = std::make_shared<TextEncoderCache>();
+
+    const std::string cache_key = TextEncoderCache::make_key(pos_prompt, neg_prompt, do_classifier_free_guidance);
+    if (m_cache->restore(m_request, cache_key))
+        return m_request.get_output_tensor(0);
+
     const int32_t pad_token_id = m_clip_tokenizer.get_pad_token_id();
     const size_t text_embedding_batch_size = do_classifier_free_guidance ? 2 : 1;
 
@@ -143,6 +161,7 @@ ov::Tensor CLIPTextModel::infer(const std::string& pos_prompt, const std::string
     // text embeddings
     m_request.set_tensor("input_ids", input_ids);
     m_request.infer();
+    m_cache->store(m_request, cache_key);
 
     return m_request.get_output_tensor(0);
 }
@@ -5,6 +5,7 @@
 
 #include <fstream>
 
+#include "image_generation/models/text_encoder_cache.hpp"
 #include "json_utils.hpp"
 #include "lora_helper.hpp"
 #include "utils.hpp"
@@ -71,9 +72,23 @@ T5EncoderModel& T5EncoderModel::compile(const std::string& device, const ov::Any
     return *this;
 }
 
+T5EncoderModel& T5EncoderModel::set_cache_capacity(size_t capacity) {
+    if (!m_cache)
+        m_cache = std::make_shared<TextEncoderCache>(capacity);
+    m_cache->set_capacity(capacity);
+    return *this;
+}
+
 ov::Tensor T5EncoderModel::infer(const std::string& pos_prompt, const std::string& neg_prompt, bool do_classifier_free_guidance, int max_sequence_length) {
     OPENVINO_ASSERT(m_request, "T5 encoder model must be compiled first. Cannot infer non-compiled model");
 
+    if (!m_cache)
+        m_cache = std::make_shared<TextEncoderCache>();
+
+    const std::string cache_key = TextEncoderCache::make_key(pos_prompt, neg_prompt, do_classifier_free_guidance, max_sequence_length);
+    if (m_cache->restore(m_request, cache_key))
+        return m_request.get_output_tensor(0);
+
     const int32_t pad_token_id = m_tokenizer.get_pad_token_id();
 
     auto perform_tokenization = [&](const std::string& prompt, ov::Tensor input_ids) {
@@ -116,6 +131,7 @@ ov::Tensor T5EncoderModel::infer(const std::string& pos_prompt, const std::strin
     // text embeddings
     m_request.set_tensor("input_ids", input_ids);
     m_request.infer();
+    m_cache->store(m_request, cache_key);
 
     return m_request.get_output_tensor(0);
 }
@@ -0,0 +1,100 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "openvino/runtime/infer_request.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * Cache of text encoder outputs computed for previous prompts, e.g. when only a seed or a number of inference steps
+ * changes between generate calls. A cache hit copies all cached outputs back to the output tensors of the request,
+ * so that 'get_output_tensor' of text encoders keeps working. The least recently used prompts are evicted, when
+ * the number of prompts exceeds capacity. Outputs depend on LoRA adapters, so the cache must be cleared once they are applied.
+ */
+class TextEncoderCache {
+    struct Entry {
+        std::string key;
+        std::vector<ov::Tensor> outputs;
+    };
+
+    size_t m_capacity;
+    // the most recently used entries first
+    std::list<Entry> m_entries;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4;
+
+    /**
+     * @param capacity Maximum number of cached prompts, 0 disables caching.
+     */
+    explicit TextEncoderCache(size_t capacity = DEFAULT_CAPACITY) : m_capacity(capacity) { }
+
+    static std::string make_key(const std::string& pos_prompt,
+                                const std::string& neg_prompt,
+                                bool do_classifier_free_guidance,
+                                int max_sequence_length = -1) {
+        // negative prompt is ignored w/o classifier-free guidance
+        return std::to_string(max_sequence_length) + '\0' + pos_prompt + '\0' +
+            (do_classifier_free_guidance ? "1" + neg_prompt : "0");
+    }
+
+    void set_capacity(size_t capacity) {
+        m_capacity = capacity;
+        if (m_entries.size() > m_capacity)
+            m_entries.resize(m_capacity);
+    }
+
+    void clear() {
+        m_entries.clear();
+    }
+
+    /**
+     * Sets outputs of the request to the cached outputs of the prompt.
+     * @return Whether outputs of the prompt are cached.
+     */
+    bool restore(ov::InferRequest& request, const std::string& key) {
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [&key] (const Entry& entry) {
+            return entry.key == key;
+        });
+        if (it == m_entries.end())
+            return false;
+
+        for (size_t idx = 0; idx < it->outputs.size(); ++idx) {
+            ov::Tensor output = request.get_output_tensor(idx);
+            it->outputs[idx].copy_to(output);
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return true;
+    }
+
+    /**
+     * Caches outputs of the request computed for the prompt.
+     */
+    void store(ov::InferRequest& request, const std::string& key) {
+        if (m_capacity == 0)
+            return;
+
+        Entry entry{key, {}};
+        for (size_t idx = 0; idx < request.get_compiled_model().outputs().size(); ++idx) {
+            ov::Tensor output = request.get_output_tensor(idx);
+            ov::Tensor cached_output(output.get_element_type(), output.get_shape());
+            output.copy_to(cached_output);
+            entry.outputs.push_back(cached_output);
+        }
+        m_entries.push_front(std::move(entry));
+        if (m_entries.size() > m_capacity)
+            m_entries.pop_back();
+    }
+};
+
+}  // namespace genai
+}  // namespace ov
@@ -4,9 +4,31 @@
 #include "openvino/genai/image_generation/unet2d_condition_model.hpp"
 #include "image_generation/models/unet_inference_dynamic.hpp"
 #include "image_generation/models/unet_inference_static_bs1.hpp"
+#include "image_generation/models/unet_inference_deep_cache.hpp"
 
 #include <fstream>
 
+#include <deque>
+#include <limits>
+
+#include "openvino/op/add.hpp"
+#include "openvino/op/avg_pool.hpp"
+#include "openvino/op/concat.hpp"
+#include "openvino/op/constant.hpp"
+#include "openvino/op/convert.hpp"
+#include "openvino/op/divide.hpp"
+#include "openvino/op/gather.hpp"
+#include "openvino/op/multiply.hpp"
+#include "openvino/op/parameter.hpp"
+#include "openvino/op/reshape.hpp"
+#include "openvino/op/round.hpp"
+#include "openvino/op/scaled_dot_product_attention.hpp"
+#include "openvino/op/shape_of.hpp"
+#include "openvino/op/split.hpp"
+#include "openvino/op/sqrt.hpp"
+#include "openvino/op/subtract.hpp"
+#include "openvino/op/transpose.hpp"
+
 #include "json_utils.hpp"
 #include "lora_helper.hpp"
 #include "utils.hpp"
@@ -15,6 +37,162 @@ namespace ov {
 namespace genai {
 
 size_t get_vae_scale_factor(const std::filesystem::path& vae_config_path);
+ov::Dimension get_latent_dimension(const ov::Dimension& image_dimension, size_t vae_scale_factor);
+
+namespace {
+
+// replaces 'sample' input with a half batch one, which is duplicated in graph, and applies guidance
+// noise_pred_uncond + guidance_scale * (noise_pred_text - noise_pred_uncond) to the model output
+void fuse_classifier_free_guidance(std::shared_ptr<ov::Model> model) {
+    auto sample = std::dynamic_pointer_cast<ov::op::v0::Parameter>(model->input("sample").get_node_shared_ptr());
+    OPENVINO_ASSERT(sample, "UNet 'sample' input must be a parameter");
+
+    ov::PartialShape sample_shape = sample->get_partial_shape();
+    if (sample_shape[0].is_static()) {
+        OPENVINO_ASSERT(sample_shape[0].get_length() % 2 == 0, "UNet batch size must be even to fuse classifier-free guidance");
+        sample_shape[0] = sample_shape[0].get_length() / 2;
+    }
+
+    auto guided_sample = std::make_shared<ov::op::v0::Parameter>(sample->get_element_type(), sample_shape);
+    guided_sample->set_friendly_name(sample->get_friendly_name());
+    guided_sample->output(0).set_names(sample->output(0).get_names());
+    sample->output(0).set_names({});
+
+    auto sample_cfg = std::make_shared<ov::op::v0::Concat>(ov::OutputVector{guided_sample, guided_sample}, 0);
+    sample->output(0).replace(sample_cfg);
+    model->replace_parameter(model->get_parameter_index(sample), guided_sample);
+
+    auto guidance_scale = std::make_shared<ov::op::v0::Parameter>(ov::element::f32, ov::PartialShape{1});
+    guidance_scale->set_friendly_name("guidance_scale");
+    guidance_scale->output(0).set_names({"guidance_scale"});
+    model->add_parameters({guidance_scale});
+
+    ov::Output<ov::Node> noise_pred = model->output(0).get_node()->input_value(0);
+    auto axis = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{}, 0);
+    auto noise_pred_split = std::make_shared<ov::op::v1::Split>(noise_pred, axis, 2);
+    auto noise_pred_uncond = noise_pred_split->output(0), noise_pred_text = noise_pred_split->output(1);
+
+    auto guidance = std::make_shared<ov::op::v1::Multiply>(
+        std::make_shared<ov::op::v1::Subtract>(noise_pred_text, noise_pred_uncond), guidance_scale);
+    auto guided_noise_pred = std::make_shared<ov::op::v1::Add>(noise_pred_uncond, guidance);
+
+    guided_noise_pred->output(0).set_names(noise_pred.get_names());
+    noise_pred.set_names({});
+    model->get_results()[0]->input(0).replace_source_output(guided_noise_pred);
+
+    model->validate_nodes_and_infer_types();
+}
+
+std::shared_ptr<ov::Node> make_i64_constant(const std::vector<int64_t>& values) {
+    return ov::op::v0::Constant::create(ov::element::i64, ov::Shape{values.size()}, values);
+}
+
+std::shared_ptr<ov::Node> gather_dimension(const ov::Output<ov::Node>& shape, int64_t index) {
+    return std::make_shared<ov::op::v8::Gather>(shape, make_i64_constant({index}), make_i64_constant({0}));
+}
+
+// cross-attention keys are projected from 'encoder_hidden_states' input just a few nodes above attention
+bool is_cross_attention(const std::shared_ptr<ov::Node>& attention) {
+    const size_t max_depth = 6;
+    std::deque<std::pair<std::shared_ptr<ov::Node>, size_t>> queue{{attention->get_input_node_shared_ptr(1), 0}};
+    while (!queue.empty()) {
+        auto [node, depth] = queue.front();
+        queue.pop_front();
+        if (ov::is_type<ov::op::v0::Parameter>(node))
+            return node->output(0).get_names().count("encoder_hidden_states") > 0;
+        if (depth < max_depth) {
+            for (const auto& input : node->input_values())
+                queue.emplace_back(input.get_node_shared_ptr(), depth + 1);
+        }
+    }
+    return false;
+}
+
+// merges each 'merge_factor' x 'merge_factor' window of latent tokens [B, heads, N, head_dim] into a single token,
+// where a grid of N tokens has the aspect ratio of 'sample' and is downsampled from it by a power of 2
+ov::Output<ov::Node> merge_tokens(const ov::Output<ov::Node>& tokens,
+                                  const ov::Output<ov::Node>& sample_height,
+                                  const ov::Output<ov::Node>& sample_width,
+                                  size_t merge_factor) {
+    const ov::PartialShape& tokens_shape = tokens.get_partial_shape();
+    const int64_t num_heads = tokens_shape[1].get_length(), head_dim = tokens_shape[3].get_length();
+
+    auto shape = std::make_shared<ov::op::v3::ShapeOf>(tokens);
+    auto batch_size = gather_dimension(shape, 0), num_tokens = gather_dimension(shape, 2);
+
+    // downsampling of the grid is sqrt(H * W / N), grid height is rounded up as by strided convolutions
+    auto ratio = std::make_shared<ov::op::v1::Divide>(std::make_shared<ov::op::v1::Multiply>(sample_height, sample_width), num_tokens);
+    auto downsampling = std::make_shared<ov::op::v0::Convert>(
+        std::make_shared<ov::op::v5::Round>(
+            std::make_shared<ov::op::v0::Sqrt>(std::make_shared<ov::op::v0::Convert>(ratio, ov::element::f32)),
+            ov::op::v5::Round::RoundMode::HALF_TO_EVEN),
+        ov::element::i64);
+    auto grid_height = std::make_shared<ov::op::v1::Divide>(
+        std::make_shared<ov::op::v1::Add>(sample_height, std::make_shared<ov::op::v1::Subtract>(downsampling, make_i64_constant({1}))),
+        downsampling);
+    auto grid_width = std::make_shared<ov::op::v1::Divide>(num_tokens, grid_height);
+
+    // [B, heads, N, head_dim] -> [B, heads * head_dim, grid_height, grid_width]
+    auto channels_first = std::make_shared<ov::op::v1::Transpose>(tokens, make_i64_constant({0, 1, 3, 2}));
+    auto grid_shape = std::make_shared<ov::op::v0::Concat>(
+        ov::OutputVector{batch_size, make_i64_constant({num_heads * head_dim}), grid_height, grid_width}, 0);
+    auto grid = std::make_shared<ov::op::v1::Reshape>(channels_first, grid_shape, false);
+
+    const ov::Shape window{merge_factor, merge_factor};
+    auto merged_grid = std::make_shared<ov::op::v1::AvgPool>(grid, ov::Strides(window), ov::Shape{0, 0}, ov::Shape{0, 0},
+                                                             window, true, ov::op::RoundingType::CEIL);
+
+    // [B, heads * head_dim, grid_height', grid_width'] -> [B, heads, N', head_dim]
+    auto merged_shape = std::make_shared<ov::op::v0::Concat>(
+        ov::OutputVector{batch_size, make_i64_constant({num_heads, head_dim, -1})}, 0);
+    auto merged = std::make_shared<ov::op::v1::Reshape>(merged_grid, merged_shape, false);
+    return std::make_shared<ov::op::v1::Transpose>(merged, make_i64_constant({0, 1, 3, 2}));
+}
+
+// token merging of self-attentions at the highest resolution with attention blocks, where attention cost is quadratic
+// in a number of latent tokens and dominates UNet inference: keys and values are merged by 'merge_factor' x 'merge_factor'
+// windows, while queries are kept, so attention output has all tokens and no unmerging is required
+void merge_self_attention_tokens(std::shared_ptr<ov::Model> model, size_t merge_factor) {
+    std::vector<std::shared_ptr<ov::Node>> attentions;
+    int64_t min_hidden_size = std::numeric_limits<int64_t>::max();
+
+    for (const auto& node : model->get_ordered_ops()) {
+        if (!ov::is_type<ov::op::v13::ScaledDotProductAttention>(node) || is_cross_attention(node))
+            continue;
+
+        // attention mask is applicable to the original number of tokens
+        const ov::PartialShape& key_shape = node->get_input_partial_shape(1);
+        if (node->get_input_size() > 3 || key_shape.rank().is_dynamic() || key_shape.size() != 4 ||
+            key_shape[1].is_dynamic() || key_shape[3].is_dynamic())
+            continue;
+
+        // the number of channels grows with downsampling of latent in UNet
+        const int64_t hidden_size = key_shape[1].get_length() * key_shape[3].get_length();
+        if (hidden_size < min_hidden_size) {
+            min_hidden_size = hidden_size;
+            attentions.clear();
+        }
+        if (hidden_size == min_hidden_size) {
+            attentions.push_back(node);
+        }
+    }
+
+    OPENVINO_ASSERT(!attentions.empty(), "Token merging requires UNet exported with ScaledDotProductAttention operations");
+
+    auto sample_shape = std::make_shared<ov::op::v3::ShapeOf>(model->input("sample"));
+    auto sample_height = gather_dimension(sample_shape, 2), sample_width = gather_dimension(sample_shape, 3);
+
+    for (const auto& attention : attentions) {
+        for (size_t input_idx : {1, 2}) {
+            auto merged = merge_tokens(attention->input_value(input_idx), sample_height, sample_width, merge_factor);
+            attention->input(input_idx).replace_source_output(merged);
+        }
+    }
+
+    model->validate_nodes_and_infer_types();
+}
+
+} // namespace
 
 UNet2DConditionModel::Config::Config(const std::filesystem::path& config_path) {
     std::ifstream file(config_path);
@@ -32,6 +210,9 @@ UNet2DConditionModel::UNet2DConditionModel(const std::filesystem::path& root_dir
     m_config(root_dir / "config.json") {
     ov::Core core = utils::singleton_core();
     m_model = core.read_model((root_dir / "openvino_model.xml").string());
+    if (std::filesystem::exists(root_dir / "openvino_model_shallow.xml")) {
+        m_shallow_model = core.read_model((root_dir / "openvino_model_shallow.xml").string());
+    }
     m_vae_scale_factor = get_vae_scale_factor(root_dir.parent_path() / "vae_decoder" / "config.json");
 }
 
@@ -74,14 +255,70 @@ UNet2DConditionModel& UNet2DConditionModel::reshape(int batch_size, int height,
     width /= m_vae_scale_factor;
 
     UNetInference::reshape(m_model, batch_size, height, width, tokenizer_model_max_length);
+    if (m_shallow_model) {
+        UNetInference::reshape(m_shallow_model, batch_size, height, width, tokenizer_model_max_length);
+    }
 
     return *this;
 }
 
+UNet2DConditionModel& UNet2DConditionModel::reshape(int batch_size, const ov::Dimension& height, const ov::Dimension& width, int tokenizer_model_max_length) {
+    OPENVINO_ASSERT(m_model, "Model has been already compiled. Cannot reshape already compiled model");
+
+    const ov::Dimension latent_height = get_latent_dimension(height, m_vae_scale_factor);
+    const ov::Dimension latent_width = get_latent_dimension(width, m_vae_scale_factor);
+
+    UNetInference::reshape(m_model, batch_size, latent_height, latent_width, tokenizer_model_max_length);
+    if (m_shallow_model) {
+        UNetInference::reshape(m_shallow_model, batch_size, latent_height, latent_width, tokenizer_model_max_length);
+    }
+
+    return *this;
+}
+
+UNet2DConditionModel& UNet2DConditionModel::enable_fused_guidance() {
+    OPENVINO_ASSERT(m_model, "Model has been already compiled. Cannot enable fused guidance for already compiled model");
+    OPENVINO_ASSERT(m_config.time_cond_proj_dim < 0, "Fused guidance is not applicable to LCM models, which embed guidance scale");
+    m_fused_guidance = true;
+    return *this;
+}
+
+UNet2DConditionModel& UNet2DConditionModel::enable_deep_cache(size_t cache_interval) {
+    OPENVINO_ASSERT(m_model, "Model has been already compiled. Cannot enable DeepCache for already compiled model");
+    OPENVINO_ASSERT(m_shallow_model, "DeepCache requires 'openvino_model_shallow.xml' UNet model");
+    OPENVINO_ASSERT(cache_interval > 0, "DeepCache interval must be positive");
+    m_deep_cache_interval = cache_interval;
+    return *this;
+}
+
+UNet2DConditionModel& UNet2DConditionModel::enable_token_merging(size_t merge_factor) {
+    OPENVINO_ASSERT(m_model, "Model has been already compiled. Cannot enable token merging for already compiled model");
+    OPENVINO_ASSERT(merge_factor > 1, "Token merging factor must be greater than 1");
+    m_token_merging_factor = merge_factor;
+    return *this;
+}
+
 UNet2DConditionModel& UNet2DConditionModel::compile(const std::string& device, const ov::AnyMap& properties) {
     OPENVINO_ASSERT(m_model, "Model has been already compiled. Cannot re-compile already compiled model");
 
-    if (device == "NPU") {
+    if (m_fused_guidance) {
+        OPENVINO_ASSERT(device != "NPU", "Fused guidance is not supported on NPU, which runs UNet with batch size 1");
+        // fused after reshape(), which sets batch size of the original model
+        fuse_classifier_free_guidance(m_model);
+    }
+
+    if (m_token_merging_factor > 0) {
+        merge_self_attention_tokens(m_model, m_token_merging_factor);
+        if (m_shallow_model) {
+            merge_self_attention_tokens(m_shallow_model, m_token_merging_factor);
+        }
+    }
+
+    if (m_deep_cache_interval > 0) {
+        OPENVINO_ASSERT(device != "NPU", "DeepCache is not supported on NPU");
+        OPENVINO_ASSERT(!m_fused_guidance, "DeepCache cannot be combined with fused guidance");
+        m_impl = std::make_shared<UNet2DConditionModel::UNetInferenceDeepCache>(m_shallow_model, m_deep_cache_interval);
+    } else if (device == "NPU") {
         m_impl = std::make_shared<UNet2DConditionModel::UNetInferenceStaticBS1>();
     } else {
         m_impl = std::make_shared<UNet2DConditionModel::UNetInferenceDynamic>();
@@ -96,8 +333,9 @@ UNet2DConditionModel& UNet2DConditionModel::compile(const std::string& device, c
         m_impl->compile(m_model, device, properties);
     }
 
-    // release the original model
+    // release the original models
     m_model.reset();
+    m_shallow_model.reset();
 
     return *this;
 }
@@ -19,8 +19,8 @@ public:
     // utility function to resize model given optional dimensions.
     static void reshape(std::shared_ptr<ov::Model> model,
                         std::optional<int> batch_size = {},
-                        std::optional<int> height = {},
-                        std::optional<int> width = {},
+                        std::optional<ov::Dimension> height = {},
+                        std::optional<ov::Dimension> width = {},
                         std::optional<int> tokenizer_model_max_length = {})
     {
         std::map<std::string, ov::PartialShape> name_to_shape;
@@ -0,0 +1,84 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "image_generation/models/unet_inference.hpp"
+#include "lora_helper.hpp"
+#include "utils.hpp"
+
+namespace ov {
+namespace genai {
+
+// DeepCache variant of UNetInference, see https://arxiv.org/abs/2312.00858
+// The full model is run every cache interval steps and exposes high-level features of its deep branch as 'cached_features'
+// output, while steps in between run a shallow model, which takes these features as input instead of computing them
+class UNet2DConditionModel::UNetInferenceDeepCache : public UNet2DConditionModel::UNetInference {
+public:
+    UNetInferenceDeepCache(std::shared_ptr<ov::Model> shallow_model, size_t cache_interval) :
+        m_shallow_model(shallow_model), m_cache_interval(cache_interval) {
+        OPENVINO_ASSERT(m_shallow_model, "Shallow UNet model is required for DeepCache");
+        OPENVINO_ASSERT(m_cache_interval > 0, "DeepCache interval must be positive");
+    }
+
+    virtual void compile(std::shared_ptr<ov::Model> model, const std::string& device, const ov::AnyMap& properties) override
+    {
+        ov::Core core = utils::singleton_core();
+
+        ov::CompiledModel compiled_model = core.compile_model(model, device, properties);
+        ov::genai::utils::print_compiled_model_properties(compiled_model, "UNet 2D Condition DeepCache full model");
+        m_full_request = compiled_model.create_infer_request();
+
+        ov::CompiledModel compiled_shallow_model = core.compile_model(m_shallow_model, device, properties);
+        ov::genai::utils::print_compiled_model_properties(compiled_shallow_model, "UNet 2D Condition DeepCache shallow model");
+        m_shallow_request = compiled_shallow_model.create_infer_request();
+
+        // release the original model
+        m_shallow_model.reset();
+    }
+
+    virtual void set_hidden_states(const std::string& tensor_name, ov::Tensor encoder_hidden_states) override
+    {
+        OPENVINO_ASSERT(m_full_request, "UNet model must be compiled first");
+        m_full_request.set_tensor(tensor_name, encoder_hidden_states);
+        m_shallow_request.set_tensor(tensor_name, encoder_hidden_states);
+
+        // hidden states are set before each denoising loop, whose first step must compute features
+        m_step = 0;
+    }
+
+    virtual void set_adapters(AdapterController& adapter_controller, const AdapterConfig& adapters) override
+    {
+        OPENVINO_THROW("LoRA adapters are not supported by DeepCache UNet");
+    }
+
+    virtual ov::Tensor infer(ov::Tensor sample, ov::Tensor timestep) override
+    {
+        OPENVINO_ASSERT(m_full_request, "UNet model must be compiled first. Cannot infer non-compiled model");
+
+        ov::InferRequest& request = m_step % m_cache_interval == 0 ? m_full_request : m_shallow_request;
+        ++m_step;
+
+        request.set_tensor("sample", sample);
+        request.set_tensor("timestep", timestep);
+
+        request.infer();
+
+        if (&request == &m_full_request) {
+            // shallow model reads features directly from the output of the full one, which stays intact until its next infer
+            m_shallow_request.set_tensor("cached_features", m_full_request.get_tensor("cached_features"));
+        }
+
+        return request.get_tensor("out_sample");
+    }
+
+private:
+    std::shared_ptr<ov::Model> m_shallow_model;
+    size_t m_cache_interval;
+    size_t m_step = 0;
+
+    ov::InferRequest m_full_request, m_shallow_request;
+};
+
+}  // namespace genai
+}  // namespace ov
@@ -63,22 +63,24 @@ public:
         char* pHiddenStates = (char *)encoder_hidden_states.data();
         size_t hidden_states_batch_stride_bytes = encoder_hidden_states.get_strides()[0];
 
+        auto bs1_hidden_states_shape = encoder_hidden_states.get_shape();
+        bs1_hidden_states_shape[0] = 1;
+
         for (int i = 0; i < m_native_batch_size; i++)
         {
-            auto hidden_states_bs1 = m_requests[i].get_tensor(tensor_name);
-
-            // wrap current pHiddenStates location as batch-1 tensor.
-            ov::Tensor bs1_wrapper(hidden_states_bs1.get_element_type(),
-                                   hidden_states_bs1.get_shape(),
+            // wrap current pHiddenStates location as batch-1 tensor and set it as input tensor w/o memory copy
+            ov::Tensor bs1_wrapper(encoder_hidden_states.get_element_type(),
+                                   bs1_hidden_states_shape,
                                    pHiddenStates,
                                    encoder_hidden_states.get_strides());
-
-            // copy it to infer request batch-1 tensor
-            bs1_wrapper.copy_to(hidden_states_bs1);
+            m_requests[i].set_tensor(tensor_name, bs1_wrapper);
 
             // increment pHiddenStates to start location of next batch (using stride)
             pHiddenStates += hidden_states_batch_stride_bytes;
         }
+
+        // wrappers don't own memory, so keep hidden states alive while they are used by infer requests
+        m_hidden_states[tensor_name] = encoder_hidden_states;
     }
 
     virtual void set_adapters(AdapterController& adapter_controller, const AdapterConfig& adapters) override {
@@ -99,9 +101,12 @@ public:
         char* pSample = (char*)sample.data();
         size_t sample_batch_stride_bytes = sample.get_strides()[0];
 
-        auto out_sample = ov::Tensor(sample.get_element_type(), sample.get_shape());
-        char* pOutSample = (char*)out_sample.data();
-        size_t out_sample_batch_stride_bytes = out_sample.get_strides()[0];
+        // output is reused across steps, as callers consume it before the next infer
+        if (!m_out_sample || m_out_sample.get_shape() != sample.get_shape()) {
+            m_out_sample = ov::Tensor(sample.get_element_type(), sample.get_shape());
+        }
+        char* pOutSample = (char*)m_out_sample.data();
+        size_t out_sample_batch_stride_bytes = m_out_sample.get_strides()[0];
 
         auto bs1_sample_shape = sample.get_shape();
         bs1_sample_shape[0] = 1;
@@ -117,7 +122,7 @@ public:
 
             // wrap a portion of out_sample tensor as a batch-1 tensor, as set this as output tensor.
             {
-                ov::Tensor bs1_wrapper(sample.get_element_type(), bs1_sample_shape, pOutSample, out_sample.get_strides());
+                ov::Tensor bs1_wrapper(sample.get_element_type(), bs1_sample_shape, pOutSample, m_out_sample.get_strides());
                 m_requests[i].set_tensor("out_sample", bs1_wrapper);
             }
 
@@ -134,11 +139,13 @@ public:
             m_requests[i].wait();
         }
 
-        return out_sample;
+        return m_out_sample;
     }
 
 private:
     std::vector<ov::InferRequest> m_requests;
+    std::map<std::string, ov::Tensor> m_hidden_states;
+    ov::Tensor m_out_sample;
     size_t m_native_batch_size = 0;
 };
 
@@ -0,0 +1,85 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "openvino/genai/image_generation/image_generation_perf_metrics.hpp"
+
+#include <numeric>
+
+namespace ov {
+namespace genai {
+
+MeanStdPair calc_mean_and_std(const std::vector<MicroSeconds>& durations);
+
+namespace {
+
+float calc_total_ms(const std::vector<MicroSeconds>& durations) {
+    return std::accumulate(durations.begin(), durations.end(), MicroSeconds(0)).count() / 1000.0f;
+}
+
+} // namespace
+
+float ImageGenerationPerfMetrics::get_load_time() {
+    return load_time;
+}
+
+float ImageGenerationPerfMetrics::get_generate_duration() {
+    evaluate_statistics();
+    return generate_duration;
+}
+
+std::map<std::string, float> ImageGenerationPerfMetrics::get_text_encoder_inference_duration() {
+    evaluate_statistics();
+    return text_encoder_inference_duration;
+}
+
+MeanStdPair ImageGenerationPerfMetrics::get_denoiser_inference_duration() {
+    evaluate_statistics();
+    return denoiser_inference_duration;
+}
+
+MeanStdPair ImageGenerationPerfMetrics::get_scheduler_step_duration() {
+    evaluate_statistics();
+    return scheduler_step_duration;
+}
+
+MeanStdPair ImageGenerationPerfMetrics::get_iteration_duration() {
+    evaluate_statistics();
+    return iteration_duration;
+}
+
+float ImageGenerationPerfMetrics::get_vae_encoder_inference_duration() {
+    evaluate_statistics();
+    return vae_encoder_inference_duration;
+}
+
+float ImageGenerationPerfMetrics::get_vae_decoder_inference_duration() {
+    evaluate_statistics();
+    return vae_decoder_inference_duration;
+}
+
+void ImageGenerationPerfMetrics::evaluate_statistics() {
+    if (m_evaluated) {
+        return;
+    }
+
+    generate_duration = calc_total_ms(raw_metrics.generate_durations);
+    text_encoder_inference_duration.clear();
+    for (const auto& [text_encoder, durations] : raw_metrics.text_encoder_inference_durations) {
+        text_encoder_inference_duration[text_encoder] = calc_total_ms(durations);
+    }
+    denoiser_inference_duration = calc_mean_and_std(raw_metrics.denoiser_inference_durations);
+    scheduler_step_duration = calc_mean_and_std(raw_metrics.scheduler_step_durations);
+    iteration_duration = calc_mean_and_std(raw_metrics.iteration_durations);
+    vae_encoder_inference_duration = calc_total_ms(raw_metrics.vae_encoder_inference_durations);
+    vae_decoder_inference_duration = calc_total_ms(raw_metrics.vae_decoder_inference_durations);
+    m_evaluated = true;
+}
+
+void ImageGenerationPerfMetrics::clean_up() {
+    const float kept_load_time = load_time;
+    *this = ImageGenerationPerfMetrics();
+    load_time = kept_load_time;
+}
+
+} // namespace genai
+} // namespace ov
@@ -139,56 +139,48 @@ std::map<std::string, ov::Tensor> DDIMScheduler::step(ov::Tensor noise_pred, ov:
     float alpha_prod_t_prev = (prev_timestep >= 0) ? m_alphas_cumprod[prev_timestep] : m_final_alpha_cumprod;
     float beta_prod_t = 1 - alpha_prod_t;
 
-    // compute predicted original sample from predicted noise also called
-    // "predicted x_0" of formula (12) from https://arxiv.org/pdf/2010.02502.pdf
-    std::vector<float> pred_original_sample, pred_epsilon;
-    float pos_val, pe_val;
-    for (size_t j = 0; j < noise_pred.get_size(); j++) {
+    // TODO: support m_config.thresholding
+    OPENVINO_ASSERT(!m_config.thresholding,
+                    "Parameter 'thresholding' is not supported. Please, add support.");
+    // TODO: support m_config.clip_sample
+    OPENVINO_ASSERT(!m_config.clip_sample,
+                    "Parameter 'clip_sample' is not supported. Please, add support.");
+
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    const float* noise_pred_data = noise_pred.data<const float>();
+    const float* latents_data = latents.data<const float>();
+    float* prev_sample_data = m_prev_sample.data<float>();
+
+    const float sqrt_alpha_prod_t = std::sqrt(alpha_prod_t), sqrt_beta_prod_t = std::sqrt(beta_prod_t);
+    const float sqrt_alpha_prod_t_prev = std::sqrt(alpha_prod_t_prev), sqrt_beta_prod_t_prev = std::sqrt(1 - alpha_prod_t_prev);
+
+    for (size_t j = 0; j < latents.get_size(); j++) {
+        // compute predicted original sample from predicted noise also called
+        // "predicted x_0" of formula (12) from https://arxiv.org/pdf/2010.02502.pdf
+        float pred_original_sample, pred_epsilon;
         switch (m_config.prediction_type) {
             case PredictionType::EPSILON:
-                pos_val = (latents.data<float>()[j] - std::sqrt(beta_prod_t) * noise_pred.data<float>()[j]) / std::sqrt(alpha_prod_t);
-                pe_val = noise_pred.data<float>()[j];
-                pred_original_sample.push_back(pos_val);
-                pred_epsilon.push_back(pe_val);
+                pred_original_sample = (latents_data[j] - sqrt_beta_prod_t * noise_pred_data[j]) / sqrt_alpha_prod_t;
+                pred_epsilon = noise_pred_data[j];
                 break;
             case PredictionType::SAMPLE:
-                pos_val = noise_pred.data<float>()[j];
-                pe_val = (latents.data<float>()[j] - std::sqrt(alpha_prod_t) * pos_val) / std::sqrt(beta_prod_t);
-                pred_original_sample.push_back(pos_val);
-                pred_epsilon.push_back(pe_val);
+                pred_original_sample = noise_pred_data[j];
+                pred_epsilon = (latents_data[j] - sqrt_alpha_prod_t * pred_original_sample) / sqrt_beta_prod_t;
                 break;
             case PredictionType::V_PREDICTION:
-                pos_val = std::sqrt(alpha_prod_t) * latents.data<float>()[j] - std::sqrt(beta_prod_t) * noise_pred.data<float>()[j];
-                pe_val = std::sqrt(alpha_prod_t) * noise_pred.data<float>()[j] + std::sqrt(beta_prod_t) * latents.data<float>()[j];
-                pred_original_sample.push_back(pos_val);
-                pred_epsilon.push_back(pe_val);
+                pred_original_sample = sqrt_alpha_prod_t * latents_data[j] - sqrt_beta_prod_t * noise_pred_data[j];
+                pred_epsilon = sqrt_alpha_prod_t * noise_pred_data[j] + sqrt_beta_prod_t * latents_data[j];
                 break;
             default:
                 OPENVINO_THROW("Unsupported value for 'PredictionType'");
         }
-    }
-
-    // TODO: support m_config.thresholding
-    OPENVINO_ASSERT(!m_config.thresholding,
-                    "Parameter 'thresholding' is not supported. Please, add support.");
-    // TODO: support m_config.clip_sample
-    OPENVINO_ASSERT(!m_config.clip_sample,
-                    "Parameter 'clip_sample' is not supported. Please, add support.");
 
-    // compute "direction pointing to x_t" of formula (12) from https://arxiv.org/pdf/2010.02502.pdf
-    std::vector<float> pred_sample_direction(pred_epsilon.size());
-    std::transform(pred_epsilon.begin(), pred_epsilon.end(), pred_sample_direction.begin(), [alpha_prod_t_prev](auto x) {
-        return std::sqrt(1 - alpha_prod_t_prev) * x;
-    });
-
-    // compute x_t without "random noise" of formula (12) from https://arxiv.org/pdf/2010.02502.pdf
-    ov::Tensor prev_sample(latents.get_element_type(), latents.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
-        prev_sample_data[i] = std::sqrt(alpha_prod_t_prev) * pred_original_sample[i] + pred_sample_direction[i];
+        // compute "direction pointing to x_t" and x_t without "random noise" of formula (12) from https://arxiv.org/pdf/2010.02502.pdf
+        prev_sample_data[j] = sqrt_alpha_prod_t_prev * pred_original_sample + sqrt_beta_prod_t_prev * pred_epsilon;
     }
 
-    std::map<std::string, ov::Tensor> result{{"latent", prev_sample}};
+    std::map<std::string, ov::Tensor> result{{"latent", m_prev_sample}};
 
     return result;
 }
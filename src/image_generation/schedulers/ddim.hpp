@@ -55,6 +55,9 @@ private:
 
     size_t m_num_inference_steps;
     std::vector<int64_t> m_timesteps;
+
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
 };
 
 } // namespace genai
@@ -0,0 +1,342 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "image_generation/schedulers/dpm_solver_multistep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+#include "image_generation/numpy_utils.hpp"
+#include "json_utils.hpp"
+
+namespace {
+
+// https://github.com/crowsonkb/k-diffusion/blob/v0.1.1.post1/k_diffusion/sampling.py#L17
+std::vector<float> convert_to_karras(float sigma_min, float sigma_max, size_t num_inference_steps) {
+    const float rho = 7.0f, min_inv_rho = std::pow(sigma_min, 1.0f / rho), max_inv_rho = std::pow(sigma_max, 1.0f / rho);
+
+    std::vector<float> ramp = ov::genai::numpy_utils::linspace<float>(0.0f, 1.0f, num_inference_steps, true);
+    std::vector<float> sigmas(num_inference_steps);
+    for (size_t i = 0; i < num_inference_steps; ++i) {
+        sigmas[i] = std::pow(max_inv_rho + ramp[i] * (min_inv_rho - max_inv_rho), rho);
+    }
+    return sigmas;
+}
+
+// interpolates a timestep of sigma in ascending log sigmas of training schedule
+float sigma_to_t(float sigma, const std::vector<float>& log_sigmas) {
+    const float log_sigma = std::log(std::max(sigma, 1e-10f));
+
+    size_t low_idx = 0;
+    for (size_t i = 0; i < log_sigmas.size(); ++i) {
+        if (log_sigma - log_sigmas[i] >= 0)
+            low_idx = i;
+    }
+    low_idx = std::min(low_idx, log_sigmas.size() - 2);
+    const size_t high_idx = low_idx + 1;
+
+    float w = (log_sigmas[low_idx] - log_sigma) / (log_sigmas[low_idx] - log_sigmas[high_idx]);
+    w = std::clamp(w, 0.0f, 1.0f);
+    return (1 - w) * low_idx + w * high_idx;
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+DPMSolverMultistepScheduler::Config::Config(const std::filesystem::path& scheduler_config_path) {
+    std::ifstream file(scheduler_config_path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", scheduler_config_path);
+
+    nlohmann::json data = nlohmann::json::parse(file);
+    using utils::read_json_param;
+
+    read_json_param(data, "num_train_timesteps", num_train_timesteps);
+    read_json_param(data, "beta_start", beta_start);
+    read_json_param(data, "beta_end", beta_end);
+    read_json_param(data, "beta_schedule", beta_schedule);
+    read_json_param(data, "trained_betas", trained_betas);
+    read_json_param(data, "solver_order", solver_order);
+    read_json_param(data, "prediction_type", prediction_type);
+    read_json_param(data, "algorithm_type", algorithm_type);
+    read_json_param(data, "solver_type", solver_type);
+    read_json_param(data, "lower_order_final", lower_order_final);
+    read_json_param(data, "euler_at_final", euler_at_final);
+    read_json_param(data, "use_karras_sigmas", use_karras_sigmas);
+    read_json_param(data, "final_sigmas_type", final_sigmas_type);
+    read_json_param(data, "timestep_spacing", timestep_spacing);
+    read_json_param(data, "steps_offset", steps_offset);
+    read_json_param(data, "rescale_betas_zero_snr", rescale_betas_zero_snr);
+}
+
+DPMSolverMultistepScheduler::DPMSolverMultistepScheduler(const std::filesystem::path& scheduler_config_path)
+    : DPMSolverMultistepScheduler(Config(scheduler_config_path)) {
+}
+
+DPMSolverMultistepScheduler::DPMSolverMultistepScheduler(const Config& scheduler_config)
+    : m_config(scheduler_config) {
+    OPENVINO_ASSERT(m_config.solver_order == 1 || m_config.solver_order == 2,
+        "DPMSolverMultistepScheduler supports 'solver_order' 1 and 2. Please, add support of other orders");
+
+    using numpy_utils::linspace;
+
+    std::vector<float> betas;
+    if (!m_config.trained_betas.empty()) {
+        betas = m_config.trained_betas;
+    } else if (m_config.beta_schedule == BetaSchedule::LINEAR) {
+        betas = linspace<float>(m_config.beta_start, m_config.beta_end, m_config.num_train_timesteps, true);
+    } else if (m_config.beta_schedule == BetaSchedule::SCALED_LINEAR) {
+        float start = std::sqrt(m_config.beta_start);
+        float end = std::sqrt(m_config.beta_end);
+        betas = linspace<float>(start, end, m_config.num_train_timesteps, true);
+        std::for_each(betas.begin(), betas.end(), [] (float & x) { x *= x; });
+    } else {
+        OPENVINO_THROW("'beta_schedule' must be one of 'LINEAR' or 'SCALED_LINEAR'. Please, add support of other types");
+    }
+
+    if (m_config.rescale_betas_zero_snr) {
+        using numpy_utils::rescale_zero_terminal_snr;
+        rescale_zero_terminal_snr(betas);
+    }
+
+    float alpha_cumprod = 1.0f;
+    for (float beta : betas) {
+        alpha_cumprod *= 1.0f - beta;
+        m_alphas_cumprod.push_back(alpha_cumprod);
+    }
+
+    if (m_config.rescale_betas_zero_snr) {
+        // close to 0 without being 0 so first sigma is not inf
+        m_alphas_cumprod.back() = std::pow(2, -24);
+    }
+
+    for (float alpha_cumprod : m_alphas_cumprod) {
+        m_log_sigmas.push_back(std::log(std::sqrt((1 - alpha_cumprod) / alpha_cumprod)));
+    }
+}
+
+void DPMSolverMultistepScheduler::set_timesteps(size_t num_inference_steps, float strength) {
+    m_timesteps.clear();
+    m_sigmas.clear();
+
+    const size_t num_train_timesteps = m_config.num_train_timesteps;
+
+    switch (m_config.timestep_spacing) {
+    case TimestepSpacing::LINSPACE: {
+        using numpy_utils::linspace;
+        std::vector<float> linspaced = linspace<float>(0.0f, static_cast<float>(num_train_timesteps - 1), num_inference_steps + 1, true);
+        for (auto it = linspaced.rbegin(); it != linspaced.rend() - 1; ++it) {
+            m_timesteps.push_back(static_cast<int64_t>(std::round(*it)));
+        }
+        break;
+    }
+    case TimestepSpacing::LEADING: {
+        const size_t step_ratio = num_train_timesteps / (num_inference_steps + 1);
+        for (size_t i = num_inference_steps; i > 0; --i) {
+            m_timesteps.push_back(i * step_ratio + m_config.steps_offset);
+        }
+        break;
+    }
+    case TimestepSpacing::TRAILING: {
+        const float step_ratio = static_cast<float>(num_train_timesteps) / num_inference_steps;
+        for (float i = num_train_timesteps; i > 0; i -= step_ratio) {
+            m_timesteps.push_back(static_cast<int64_t>(std::round(i)) - 1);
+        }
+        break;
+    }
+    default:
+        OPENVINO_THROW("Unsupported value for 'timestep_spacing'");
+    }
+
+    std::vector<float> sigmas(m_log_sigmas.size());
+    std::transform(m_log_sigmas.begin(), m_log_sigmas.end(), sigmas.begin(), [] (float log_sigma) { return std::exp(log_sigma); });
+
+    if (m_config.use_karras_sigmas) {
+        m_sigmas = convert_to_karras(sigmas.front(), sigmas.back(), num_inference_steps);
+        m_timesteps.resize(m_sigmas.size());
+        for (size_t i = 0; i < m_sigmas.size(); ++i) {
+            m_timesteps[i] = static_cast<int64_t>(std::round(sigma_to_t(m_sigmas[i], m_log_sigmas)));
+        }
+    } else {
+        using numpy_utils::interp;
+
+        std::vector<size_t> x_data_points(sigmas.size());
+        std::iota(x_data_points.begin(), x_data_points.end(), 0);
+        m_sigmas = interp(m_timesteps, x_data_points, sigmas);
+    }
+
+    switch (m_config.final_sigmas_type) {
+    case FinalSigmaType::SIGMA_MIN:
+        m_sigmas.push_back(sigmas.front());
+        break;
+    case FinalSigmaType::ZERO:
+        m_sigmas.push_back(0.0f);
+        break;
+    default:
+        OPENVINO_THROW("Unsupported value for 'final_sigmas_type'");
+    }
+
+    // apply 'strength' used in image generation
+    const size_t init_timestep = std::min<size_t>(num_inference_steps * strength, num_inference_steps);
+    m_begin_index = num_inference_steps - init_timestep;
+    m_schedule_timesteps = m_timesteps;
+    m_timesteps.erase(m_timesteps.begin(), m_timesteps.begin() + m_begin_index);
+
+    m_step_index = m_begin_index;
+    m_lower_order_nums = 0;
+    m_model_outputs.clear();
+    for (size_t i = 0; i < m_config.solver_order; ++i) {
+        m_model_outputs.emplace_back(ov::element::f32, ov::Shape{});
+    }
+}
+
+std::vector<int64_t> DPMSolverMultistepScheduler::get_timesteps() const {
+    return m_timesteps;
+}
+
+float DPMSolverMultistepScheduler::get_init_noise_sigma() const {
+    return 1.0f;
+}
+
+void DPMSolverMultistepScheduler::scale_model_input(ov::Tensor sample, size_t inference_step) {
+    return;
+}
+
+void DPMSolverMultistepScheduler::convert_model_output(ov::Tensor noise_pred, ov::Tensor latents) {
+    const float sigma = m_sigmas[m_step_index];
+    const float alpha_t = 1.0f / std::sqrt(sigma * sigma + 1.0f), sigma_t = sigma * alpha_t;
+
+    // data prediction is computed as model_output_scale * model_output + sample_scale * sample
+    float model_output_scale = 0.0f, sample_scale = 0.0f;
+    switch (m_config.prediction_type) {
+    case PredictionType::EPSILON:
+        model_output_scale = -sigma_t / alpha_t;
+        sample_scale = 1.0f / alpha_t;
+        break;
+    case PredictionType::SAMPLE:
+        model_output_scale = 1.0f;
+        sample_scale = 0.0f;
+        break;
+    case PredictionType::V_PREDICTION:
+        model_output_scale = -sigma_t;
+        sample_scale = alpha_t;
+        break;
+    default:
+        OPENVINO_THROW("Unsupported value for 'PredictionType'");
+    }
+
+    ov::Tensor& x0 = m_model_outputs.back();
+    x0.set_shape(latents.get_shape());
+
+    const float* model_output_data = noise_pred.data<const float>();
+    const float* sample_data = latents.data<const float>();
+    float* x0_data = x0.data<float>();
+    for (size_t i = 0; i < x0.get_size(); ++i) {
+        x0_data[i] = model_output_scale * model_output_data[i] + sample_scale * sample_data[i];
+    }
+}
+
+std::map<std::string, ov::Tensor> DPMSolverMultistepScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_shape() == latents.get_shape(), "Shapes of noise prediction and latents must match");
+
+    const size_t num_inference_steps = m_schedule_timesteps.size();
+    const bool is_lower_order_final = m_step_index == num_inference_steps - 1 &&
+        (m_config.euler_at_final || (m_config.lower_order_final && num_inference_steps < 15) || m_config.final_sigmas_type == FinalSigmaType::ZERO);
+
+    // the oldest data prediction slot is reused for the current one
+    std::rotate(m_model_outputs.begin(), m_model_outputs.begin() + 1, m_model_outputs.end());
+    convert_model_output(noise_pred, latents);
+
+    const bool is_first_order = m_config.solver_order == 1 || m_lower_order_nums < 1 || is_lower_order_final;
+    const bool is_sde = m_config.algorithm_type == DPMSolverAlgorithmType::SDE_DPMSOLVER_PLUS_PLUS;
+
+    // lambda = log(alpha) - log(sigma) = -log(sigma) in terms of sigmas of k-diffusion
+    const double sigma = m_sigmas[m_step_index + 1], sigma_s0 = m_sigmas[m_step_index];
+    const double alpha_t = 1.0 / std::sqrt(sigma * sigma + 1.0), sigma_t = sigma * alpha_t;
+    const double alpha_s0 = 1.0 / std::sqrt(sigma_s0 * sigma_s0 + 1.0), sigma_s0_t = sigma_s0 * alpha_s0;
+    const double h = std::log(sigma_s0) - std::log(sigma);
+
+    // x_t = sample_scale * sample + d0_scale * D0 + d1_scale * D1 + noise_scale * noise
+    // where D0 is the current data prediction and D1 = (D0 - previous data prediction) / r0
+    double sample_scale = 0.0, d0_scale = 0.0, d1_scale = 0.0, noise_scale = 0.0;
+    if (!is_sde) {
+        sample_scale = sigma_t / sigma_s0_t;
+        d0_scale = -alpha_t * std::expm1(-h);
+        if (!is_first_order) {
+            d1_scale = m_config.solver_type == DPMSolverType::MIDPOINT ? 0.5 * d0_scale : alpha_t * (std::expm1(-h) / h + 1.0);
+        }
+    } else {
+        sample_scale = sigma_t / sigma_s0_t * std::exp(-h);
+        d0_scale = -alpha_t * std::expm1(-2.0 * h);
+        noise_scale = sigma_t * std::sqrt(-std::expm1(-2.0 * h));
+        if (!is_first_order) {
+            d1_scale = m_config.solver_type == DPMSolverType::MIDPOINT ? 0.5 * d0_scale : alpha_t * (std::expm1(-2.0 * h) / (2.0 * h) + 1.0);
+        }
+    }
+
+    // D1 is expanded, so a step is a single pass over current and previous data predictions
+    float m0_scale = d0_scale, m1_scale = 0.0f;
+    if (!is_first_order) {
+        const double sigma_s1 = m_sigmas[m_step_index - 1];
+        const double r0 = (std::log(sigma_s1) - std::log(sigma_s0)) / h;
+        m0_scale += d1_scale / r0;
+        m1_scale = -d1_scale / r0;
+    }
+
+    ov::Tensor noise;
+    if (is_sde) {
+        noise = generator->randn_tensor(latents.get_shape());
+    }
+
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    const float* sample_data = latents.data<const float>();
+    const float* m0_data = m_model_outputs.back().data<const float>();
+    const float* m1_data = is_first_order ? nullptr : m_model_outputs[m_model_outputs.size() - 2].data<const float>();
+    const float* noise_data = is_sde ? noise.data<const float>() : nullptr;
+    float* prev_sample_data = m_prev_sample.data<float>();
+
+    for (size_t i = 0; i < m_prev_sample.get_size(); ++i) {
+        float prev_sample = sample_scale * sample_data[i] + m0_scale * m0_data[i];
+        if (m1_data)
+            prev_sample += m1_scale * m1_data[i];
+        if (noise_data)
+            prev_sample += noise_scale * noise_data[i];
+        prev_sample_data[i] = prev_sample;
+    }
+
+    if (m_lower_order_nums < m_config.solver_order)
+        ++m_lower_order_nums;
+    ++m_step_index;
+
+    return {{"latent", m_prev_sample}, {"denoised", m_model_outputs.back()}};
+}
+
+size_t DPMSolverMultistepScheduler::_index_for_timestep(int64_t timestep) const {
+    for (size_t i = 0; i < m_schedule_timesteps.size(); ++i) {
+        if (timestep == m_schedule_timesteps[i]) {
+            return i;
+        }
+    }
+
+    OPENVINO_THROW("Failed to find index for timestep ", timestep);
+}
+
+void DPMSolverMultistepScheduler::add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const {
+    const float sigma = m_sigmas[_index_for_timestep(latent_timestep)];
+    const float alpha_t = 1.0f / std::sqrt(sigma * sigma + 1.0f), sigma_t = sigma * alpha_t;
+
+    float * init_latent_data = init_latent.data<float>();
+    const float * noise_data = noise.data<float>();
+
+    for (size_t i = 0; i < init_latent.get_size(); ++i) {
+        init_latent_data[i] = alpha_t * init_latent_data[i] + sigma_t * noise_data[i];
+    }
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -157,30 +157,22 @@ std::map<std::string, ov::Tensor> EulerAncestralDiscreteScheduler::step(ov::Tens
     // latents - sample
     // inference_step
 
-    size_t timestep = m_timesteps[inference_step];
-
     if (m_step_index == -1)
         m_step_index = m_begin_index;
 
     float sigma = m_sigmas[m_step_index];
 
-    float* model_output_data = noise_pred.data<float>();
-    float* sample_data = latents.data<float>();
-
-    ov::Tensor pred_original_sample(noise_pred.get_element_type(), noise_pred.get_shape());
-    float* pred_original_sample_data = pred_original_sample.data<float>();
-
+    // compute predicted original sample (x_0) from sigma-scaled predicted noise as
+    // model_output_scale * model_output + sample_scale * sample
+    float model_output_scale = 0.0f, sample_scale = 0.0f;
     switch (m_config.prediction_type) {
     case PredictionType::EPSILON:
-        for (size_t i = 0; i < noise_pred.get_size(); ++i) {
-            pred_original_sample_data[i] = sample_data[i] - sigma * model_output_data[i];
-        }
+        model_output_scale = -sigma;
+        sample_scale = 1.0f;
         break;
     case PredictionType::V_PREDICTION:
-        for (size_t i = 0; i < noise_pred.get_size(); ++i) {
-            pred_original_sample_data[i] = model_output_data[i] * (-sigma / std::pow((std::pow(sigma, 2) + 1), 0.5)) +
-                                           (sample_data[i] / (std::pow(sigma, 2) + 1));
-        }
+        model_output_scale = -sigma / std::pow((std::pow(sigma, 2) + 1), 0.5);
+        sample_scale = 1.0f / (std::pow(sigma, 2) + 1);
         break;
     default:
         OPENVINO_THROW("Unsupported value for 'PredictionType': must be one of `epsilon`, or `v_prediction`");
@@ -192,20 +184,29 @@ std::map<std::string, ov::Tensor> EulerAncestralDiscreteScheduler::step(ov::Tens
     float sigma_down = std::sqrt(std::pow(sigma_to, 2) - std::pow(sigma_up, 2));
     float dt = sigma_down - sigma;
 
-    ov::Tensor prev_sample = ov::Tensor(latents.get_element_type(), latents.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
-
     ov::Tensor noise = generator->randn_tensor(noise_pred.get_shape());
-    const float* noise_data = noise.data<float>();
-
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
-        float derivative = (sample_data[i] - pred_original_sample_data[i]) / sigma;
-        prev_sample_data[i] = (sample_data[i] + derivative * dt) + noise_data[i] * sigma_up;
+    const float* noise_data = noise.data<const float>();
+
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    m_pred_original_sample.set_shape(latents.get_shape());
+    const float* model_output_data = noise_pred.data<const float>();
+    const float* sample_data = latents.data<const float>();
+    float* prev_sample_data = m_prev_sample.data<float>();
+    float* pred_original_sample_data = m_pred_original_sample.data<float>();
+
+    for (size_t i = 0; i < latents.get_size(); ++i) {
+        const float sample = sample_data[i];
+        const float pred_original_sample = model_output_scale * model_output_data[i] + sample_scale * sample;
+        pred_original_sample_data[i] = pred_original_sample;
+
+        float derivative = (sample - pred_original_sample) / sigma;
+        prev_sample_data[i] = (sample + derivative * dt) + noise_data[i] * sigma_up;
     }
 
     m_step_index++;
 
-    return {{"latent", prev_sample}, {"denoised", pred_original_sample}};
+    return {{"latent", m_prev_sample}, {"denoised", m_pred_original_sample}};
 }
 
 size_t EulerAncestralDiscreteScheduler::_index_for_timestep(int64_t timestep) const{
@@ -54,6 +54,9 @@ private:
     int m_step_index, m_begin_index;
     bool m_is_scale_input_called;
 
+    // outputs of steps, reused by following steps, which may update them in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}}, m_pred_original_sample{ov::element::f32, {}};
+
     size_t _index_for_timestep(int64_t timestep) const;
 };
 
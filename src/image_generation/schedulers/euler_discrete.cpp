@@ -208,12 +208,22 @@ void EulerDiscreteScheduler::set_timesteps(size_t num_inference_steps, float str
 }
 
 std::map<std::string, ov::Tensor> EulerDiscreteScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_shape() == latents.get_shape(), "Shapes of noise prediction and latents must match");
+    return fused_step(noise_pred.data<const float>(), nullptr, 1.0f, latents, inference_step);
+}
+
+std::map<std::string, ov::Tensor> EulerDiscreteScheduler::step_with_guidance(ov::Tensor noise_pred, float guidance_scale, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_size() == 2 * latents.get_size(), "Noise prediction must hold unconditional and text predictions of latents");
+    const float* noise_pred_uncond = noise_pred.data<const float>();
+    return fused_step(noise_pred_uncond, noise_pred_uncond + latents.get_size(), guidance_scale, latents, inference_step);
+}
+
+std::map<std::string, ov::Tensor> EulerDiscreteScheduler::fused_step(const float* noise_pred_uncond, const float* noise_pred_text, float guidance_scale,
+                                                                       ov::Tensor latents, size_t inference_step) {
     // noise_pred - model_output
     // latents - sample
     // inference_step
 
-    size_t timestep = m_timesteps[inference_step];
-
     if (m_step_index == -1)
         m_step_index = m_begin_index;
 
@@ -222,32 +232,21 @@ std::map<std::string, ov::Tensor> EulerDiscreteScheduler::step(ov::Tensor noise_
     float gamma = 0.0f;
     float sigma_hat = sigma * (gamma + 1);
 
-    float* model_output_data = noise_pred.data<float>();
-    float* sample_data = latents.data<float>();
-
-    ov::Tensor pred_original_sample(noise_pred.get_element_type(), noise_pred.get_shape());
-    float* pred_original_sample_data = pred_original_sample.data<float>();
-
-    ov::Tensor prev_sample(noise_pred.get_element_type(), noise_pred.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
-
-    // 1. compute predicted original sample (x_0) from sigma-scaled predicted noise
+    // 1. compute predicted original sample (x_0) from sigma-scaled predicted noise as
+    // model_output_scale * model_output + sample_scale * sample
+    float model_output_scale = 0.0f, sample_scale = 0.0f;
     switch (m_config.prediction_type) {
     case PredictionType::EPSILON:
-        for (size_t i = 0; i < noise_pred.get_size(); ++i) {
-            pred_original_sample_data[i] = sample_data[i] - model_output_data[i] * sigma_hat;
-        }
+        model_output_scale = -sigma_hat;
+        sample_scale = 1.0f;
         break;
     case PredictionType::SAMPLE:
-        for (size_t i = 0; i < noise_pred.get_size(); ++i) {
-            pred_original_sample_data[i] = model_output_data[i];
-        }
+        model_output_scale = 1.0f;
+        sample_scale = 0.0f;
         break;
     case PredictionType::V_PREDICTION:
-        for (size_t i = 0; i < noise_pred.get_size(); ++i) {
-            pred_original_sample_data[i] = model_output_data[i] * (-sigma / std::pow((std::pow(sigma, 2) + 1), 0.5)) +
-                                           (sample_data[i] / (std::pow(sigma, 2) + 1));
-        }
+        model_output_scale = -sigma / std::pow((std::pow(sigma, 2) + 1), 0.5);
+        sample_scale = 1.0f / (std::pow(sigma, 2) + 1);
         break;
     default:
         OPENVINO_THROW("Unsupported value for 'PredictionType'");
@@ -255,14 +254,26 @@ std::map<std::string, ov::Tensor> EulerDiscreteScheduler::step(ov::Tensor noise_
 
     float dt = m_sigmas[m_step_index + 1] - sigma_hat;
 
-    // 2. Convert to an ODE derivative
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
-        prev_sample_data[i] = ((sample_data[i] - pred_original_sample_data[i]) / sigma_hat) * dt + sample_data[i];
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    m_pred_original_sample.set_shape(latents.get_shape());
+    const float* sample_data = latents.data<const float>();
+    float* prev_sample_data = m_prev_sample.data<float>();
+    float* pred_original_sample_data = m_pred_original_sample.data<float>();
+
+    // 2. Convert to an ODE derivative, guidance is applied to model output on the fly
+    for (size_t i = 0; i < latents.get_size(); ++i) {
+        const float model_output = noise_pred_text ? noise_pred_uncond[i] + guidance_scale * (noise_pred_text[i] - noise_pred_uncond[i])
+                                                   : noise_pred_uncond[i];
+        const float sample = sample_data[i];
+        const float pred_original_sample = model_output_scale * model_output + sample_scale * sample;
+        pred_original_sample_data[i] = pred_original_sample;
+        prev_sample_data[i] = ((sample - pred_original_sample) / sigma_hat) * dt + sample;
     }
 
     m_step_index += 1;
 
-    return {{"latent", prev_sample}, {"denoised", pred_original_sample}};
+    return {{"latent", m_prev_sample}, {"denoised", m_pred_original_sample}};
 }
 
 std::vector<int64_t> EulerDiscreteScheduler::get_timesteps() const {
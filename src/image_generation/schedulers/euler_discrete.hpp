@@ -47,6 +47,8 @@ public:
 
     std::map<std::string, ov::Tensor> step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
 
+    std::map<std::string, ov::Tensor> step_with_guidance(ov::Tensor noise_pred, float guidance_scale, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
+
     void add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const override;
 
 private:
@@ -58,7 +60,14 @@ private:
 
     int m_step_index, m_begin_index;
 
+    // outputs of steps, reused by following steps, which may update them in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}}, m_pred_original_sample{ov::element::f32, {}};
+
     size_t _index_for_timestep(int64_t timestep) const;
+
+    // makes a step in a single pass over noise prediction, noise_pred_text is nullptr if guidance is not applied
+    std::map<std::string, ov::Tensor> fused_step(const float* noise_pred_uncond, const float* noise_pred_text, float guidance_scale,
+                                                 ov::Tensor latents, size_t inference_step);
 };
 
 } // namespace genai
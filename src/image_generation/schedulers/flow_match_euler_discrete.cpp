@@ -100,28 +100,39 @@ void FlowMatchEulerDiscreteScheduler::set_timesteps(size_t num_inference_steps,
 }
 
 std::map<std::string, ov::Tensor> FlowMatchEulerDiscreteScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_size() == latents.get_size(), "Sizes of noise prediction and latents must match");
+    return fused_step(noise_pred.data<const float>(), nullptr, 1.0f, latents);
+}
+
+std::map<std::string, ov::Tensor> FlowMatchEulerDiscreteScheduler::step_with_guidance(ov::Tensor noise_pred, float guidance_scale, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_size() == 2 * latents.get_size(), "Noise prediction must hold unconditional and text predictions of latents");
+    const float* noise_pred_uncond = noise_pred.data<const float>();
+    return fused_step(noise_pred_uncond, noise_pred_uncond + latents.get_size(), guidance_scale, latents);
+}
+
+std::map<std::string, ov::Tensor> FlowMatchEulerDiscreteScheduler::fused_step(const float* noise_pred_uncond, const float* noise_pred_text, float guidance_scale, ov::Tensor latents) {
     // noise_pred - model_output
     // latents - sample
-    // inference_step
-
-    const float* model_output_data = noise_pred.data<const float>();
-    const float* sample_data = latents.data<const float>();
 
     if (m_step_index == -1)
         init_step_index();
 
-    ov::Tensor prev_sample(latents.get_element_type(), latents.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    const float* sample_data = latents.data<const float>();
+    float* prev_sample_data = m_prev_sample.data<float>();
 
     float sigma_diff = m_sigmas[m_step_index + 1] - m_sigmas[m_step_index];
 
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
-        prev_sample_data[i] = sample_data[i] + sigma_diff * model_output_data[i];
+    for (size_t i = 0; i < latents.get_size(); ++i) {
+        const float model_output = noise_pred_text ? noise_pred_uncond[i] + guidance_scale * (noise_pred_text[i] - noise_pred_uncond[i])
+                                                   : noise_pred_uncond[i];
+        prev_sample_data[i] = sample_data[i] + sigma_diff * model_output;
     }
 
     m_step_index++;
 
-    return {{"latent", prev_sample}};
+    return {{"latent", m_prev_sample}};
 }
 
 std::vector<float> FlowMatchEulerDiscreteScheduler::get_float_timesteps() const {
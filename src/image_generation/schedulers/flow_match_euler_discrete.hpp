@@ -40,6 +40,8 @@ public:
 
     std::map<std::string, ov::Tensor> step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
 
+    std::map<std::string, ov::Tensor> step_with_guidance(ov::Tensor noise_pred, float guidance_scale, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
+
     void add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const override;
 
     float calculate_shift(size_t image_seq_len) override;
@@ -54,7 +56,13 @@ private:
     size_t m_step_index, m_begin_index;
     size_t m_num_inference_steps;
 
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
+
     void init_step_index();
+
+    // makes a step in a single pass over noise prediction, noise_pred_text is nullptr if guidance is not applied
+    std::map<std::string, ov::Tensor> fused_step(const float* noise_pred_uncond, const float* noise_pred_text, float guidance_scale, ov::Tensor latents);
     double sigma_to_t(double simga);
 };
 
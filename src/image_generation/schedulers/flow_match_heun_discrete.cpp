@@ -0,0 +1,169 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "image_generation/schedulers/flow_match_heun_discrete.hpp"
+
+#include <cmath>
+#include <fstream>
+
+#include "image_generation/numpy_utils.hpp"
+#include "json_utils.hpp"
+
+namespace ov {
+namespace genai {
+
+FlowMatchHeunDiscreteScheduler::Config::Config(const std::filesystem::path& scheduler_config_path) {
+    std::ifstream file(scheduler_config_path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", scheduler_config_path);
+
+    nlohmann::json data = nlohmann::json::parse(file);
+    using utils::read_json_param;
+
+    read_json_param(data, "num_train_timesteps", num_train_timesteps);
+    read_json_param(data, "shift", shift);
+    read_json_param(data, "use_dynamic_shifting", use_dynamic_shifting);
+    read_json_param(data, "base_shift", base_shift);
+    read_json_param(data, "max_shift", max_shift);
+    read_json_param(data, "base_image_seq_len", base_image_seq_len);
+    read_json_param(data, "max_image_seq_len", max_image_seq_len);
+}
+
+FlowMatchHeunDiscreteScheduler::FlowMatchHeunDiscreteScheduler(const std::filesystem::path& scheduler_config_path)
+    : FlowMatchHeunDiscreteScheduler(Config(scheduler_config_path)) {}
+
+FlowMatchHeunDiscreteScheduler::FlowMatchHeunDiscreteScheduler(const Config& scheduler_config)
+    : m_config(scheduler_config) {
+    const int32_t num_train_timesteps = m_config.num_train_timesteps;
+    const float shift = m_config.shift;
+
+    // sigmas of the first and the last training timesteps
+    m_sigma_max = 1.0f, m_sigma_min = 1.0f / num_train_timesteps;
+    if (!m_config.use_dynamic_shifting) {
+        m_sigma_min = shift * m_sigma_min / (1 + (shift - 1) * m_sigma_min);
+    }
+}
+
+void FlowMatchHeunDiscreteScheduler::set_timesteps(size_t num_inference_steps, float strength) {
+    OPENVINO_ASSERT(!m_config.use_dynamic_shifting,
+                    "Parameter 'use_dynamic_shifting' is not supported. Please, add support.");
+
+    const int32_t num_train_timesteps = m_config.num_train_timesteps;
+    const double shift = m_config.shift;
+
+    using numpy_utils::linspace;
+    std::vector<double> timesteps = linspace<double>(m_sigma_max * num_train_timesteps, m_sigma_min * num_train_timesteps, num_inference_steps, true);
+
+    std::vector<float> sigmas(timesteps.size());
+    for (size_t i = 0; i < sigmas.size(); ++i) {
+        const double sigma = timesteps[i] / num_train_timesteps;
+        sigmas[i] = shift * sigma / (1.0 + (shift - 1.0) * sigma);
+    }
+
+    interleave_timesteps(sigmas);
+}
+
+void FlowMatchHeunDiscreteScheduler::set_timesteps_with_sigma(std::vector<float> sigmas, float mu) {
+    const float shift = m_config.shift;
+
+    if (m_config.use_dynamic_shifting) {
+        float exp_mu = std::exp(mu);
+        for (size_t i = 0; i < sigmas.size(); ++i) {
+            sigmas[i] = exp_mu / (exp_mu + (1 / sigmas[i] - 1));
+        }
+    } else {
+        for (size_t i = 0; i < sigmas.size(); ++i) {
+            sigmas[i] = shift * sigmas[i] / (1 + (shift - 1) * sigmas[i]);
+        }
+    }
+
+    interleave_timesteps(sigmas);
+}
+
+void FlowMatchHeunDiscreteScheduler::interleave_timesteps(const std::vector<float>& sigmas) {
+    OPENVINO_ASSERT(!sigmas.empty(), "Number of inference steps must be positive");
+
+    m_sigmas.clear();
+    m_timesteps.clear();
+
+    for (size_t i = 0; i < sigmas.size(); ++i) {
+        const size_t repeats = i == 0 ? 1 : 2;
+        m_sigmas.insert(m_sigmas.end(), repeats, sigmas[i]);
+        m_timesteps.insert(m_timesteps.end(), repeats, sigmas[i] * m_config.num_train_timesteps);
+    }
+    m_sigmas.push_back(0.0f);
+
+    m_step_index = 0;
+    m_is_first_order = true;
+}
+
+std::map<std::string, ov::Tensor> FlowMatchHeunDiscreteScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_size() == latents.get_size(), "Sizes of noise prediction and latents must match");
+
+    const float* model_output_data = noise_pred.data<const float>();
+
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    float* prev_sample_data = m_prev_sample.data<float>();
+
+    // model predicts velocity, which is a derivative of sample w.r.t. sigma
+    if (m_is_first_order) {
+        m_dt = m_sigmas[m_step_index + 1] - m_sigmas[m_step_index];
+
+        m_sample.set_shape(latents.get_shape());
+        m_prev_derivative.set_shape(latents.get_shape());
+        const float* sample_data = latents.data<const float>();
+        float* saved_sample_data = m_sample.data<float>();
+        float* prev_derivative_data = m_prev_derivative.data<float>();
+
+        for (size_t i = 0; i < latents.get_size(); ++i) {
+            const float sample = sample_data[i], derivative = model_output_data[i];
+            saved_sample_data[i] = sample;
+            prev_derivative_data[i] = derivative;
+            prev_sample_data[i] = sample + m_dt * derivative;
+        }
+    } else {
+        // correct Euler step by averaging derivatives at its start and end
+        const float* sample_data = m_sample.data<const float>();
+        const float* prev_derivative_data = m_prev_derivative.data<const float>();
+
+        for (size_t i = 0; i < latents.get_size(); ++i) {
+            prev_sample_data[i] = sample_data[i] + m_dt * 0.5f * (prev_derivative_data[i] + model_output_data[i]);
+        }
+    }
+
+    m_is_first_order = !m_is_first_order;
+    m_step_index++;
+
+    return {{"latent", m_prev_sample}};
+}
+
+std::vector<float> FlowMatchHeunDiscreteScheduler::get_float_timesteps() const {
+    return m_timesteps;
+}
+
+float FlowMatchHeunDiscreteScheduler::get_init_noise_sigma() const {
+    return 1.0f;
+}
+
+void FlowMatchHeunDiscreteScheduler::scale_model_input(ov::Tensor sample, size_t inference_step) {
+    return;
+}
+
+void FlowMatchHeunDiscreteScheduler::add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const {
+    OPENVINO_THROW("Not implemented");
+}
+
+float FlowMatchHeunDiscreteScheduler::calculate_shift(size_t image_seq_len) {
+    size_t base_seq_len = m_config.base_image_seq_len;
+    size_t max_seq_len = m_config.max_image_seq_len;
+    float base_shift = m_config.base_shift;
+    float max_shift = m_config.max_shift;
+
+    float m = (max_shift - base_shift) / (max_seq_len - base_seq_len);
+    float b = base_shift - m * base_seq_len;
+    float mu = image_seq_len * m + b;
+    return mu;
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -0,0 +1,72 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "image_generation/schedulers/types.hpp"
+#include "image_generation/schedulers/ischeduler.hpp"
+
+namespace ov {
+namespace genai {
+
+// Heun's method for flow matching models: every step but the last one is followed by a correction step, which evaluates
+// the model at the predicted sample, so timesteps hold 2 * num_inference_steps - 1 model evaluations
+class FlowMatchHeunDiscreteScheduler : public IScheduler {
+public:
+    struct Config {
+        int32_t num_train_timesteps = 1000;
+        float shift = 1.0f;
+        bool use_dynamic_shifting = false;
+        float base_shift = 0.5f, max_shift = 1.15f;
+        int32_t base_image_seq_len = 256, max_image_seq_len = 4096;
+
+        Config() = default;
+        explicit Config(const std::filesystem::path& scheduler_config_path);
+    };
+
+    explicit FlowMatchHeunDiscreteScheduler(const std::filesystem::path& scheduler_config_path);
+    explicit FlowMatchHeunDiscreteScheduler(const Config& scheduler_config);
+
+    void set_timesteps(size_t num_inference_steps, float strength) override;
+
+    void set_timesteps_with_sigma(std::vector<float> sigma, float mu) override;
+
+    std::vector<float> get_float_timesteps() const override;
+
+    float get_init_noise_sigma() const override;
+
+    void scale_model_input(ov::Tensor sample, size_t inference_step) override;
+
+    std::map<std::string, ov::Tensor> step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
+
+    void add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const override;
+
+    float calculate_shift(size_t image_seq_len) override;
+
+private:
+    Config m_config;
+
+    std::vector<float> m_sigmas;
+    std::vector<float> m_timesteps;
+
+    float m_sigma_min, m_sigma_max;
+    size_t m_step_index = 0;
+
+    // state of the first order (Euler) step, which is corrected by the next one
+    bool m_is_first_order = true;
+    float m_dt = 0.0f;
+    ov::Tensor m_sample{ov::element::f32, {}}, m_prev_derivative{ov::element::f32, {}};
+
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
+
+    // duplicates sigmas and timesteps of inner steps, so that each of them is evaluated twice
+    void interleave_timesteps(const std::vector<float>& sigmas);
+};
+
+} // namespace genai
+} // namespace ov
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include <map>
+#include <string>
 
 #include "openvino/genai/image_generation/scheduler.hpp"
 #include "openvino/genai/image_generation/generation_config.hpp"
@@ -26,6 +27,25 @@ public:
     virtual std::map<std::string, ov::Tensor> step(
         ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) = 0;
 
+    /**
+     * Makes step() with classifier-free guidance applied to noise_pred [2 * N, ...], whose unconditional predictions
+     * are followed by text conditioned ones. Schedulers may fuse guidance into their step to avoid an extra pass.
+     */
+    virtual std::map<std::string, ov::Tensor> step_with_guidance(
+        ov::Tensor noise_pred, float guidance_scale, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+        ov::Shape guided_shape = noise_pred.get_shape();
+        guided_shape[0] /= 2;
+        m_guided_noise_pred.set_shape(guided_shape);
+
+        float* guided = m_guided_noise_pred.data<float>();
+        const float* noise_pred_uncond = noise_pred.data<const float>();
+        const float* noise_pred_text = noise_pred_uncond + m_guided_noise_pred.get_size();
+        for (size_t i = 0; i < m_guided_noise_pred.get_size(); ++i) {
+            guided[i] = noise_pred_uncond[i] + guidance_scale * (noise_pred_text[i] - noise_pred_uncond[i]);
+        }
+        return step(m_guided_noise_pred, latents, inference_step, generator);
+    }
+
     virtual void add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const = 0;
 
     virtual float calculate_shift(size_t image_seq_len) {
@@ -43,6 +63,10 @@ public:
     virtual std::vector<float> get_float_timesteps() const {
         OPENVINO_THROW("Scheduler doesn't support float timesteps");
     }
+
+private:
+    // guided noise prediction of step_with_guidance, reused by steps
+    ov::Tensor m_guided_noise_pred{ov::element::f32, {}};
 };
 
 } // namespace genai
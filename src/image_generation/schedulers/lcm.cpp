@@ -119,8 +119,8 @@ void LCMScheduler::set_timesteps(size_t num_inference_steps, float strength) {
 std::map<std::string, ov::Tensor> LCMScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
     ov::Shape shape = latents.get_shape();
     size_t batch_size = shape[0], latent_size = ov::shape_size(shape) / batch_size;
-    float* noise_pred_data = noise_pred.data<float>();
-    float* latents_data = latents.data<float>();
+    const float* noise_pred_data = noise_pred.data<const float>();
+    const float* latents_data = latents.data<const float>();
 
     // 1. get previous step value
     int64_t prev_step_index = inference_step + 1;
@@ -142,47 +142,44 @@ std::map<std::string, ov::Tensor> LCMScheduler::step(ov::Tensor noise_pred, ov::
     float c_out = scaled_timestep / std::sqrt((std::pow(scaled_timestep, 2) + std::pow(m_sigma_data, 2)));
 
     // 4. Compute the predicted original sample x_0 based on the model parameterization
-    std::vector<std::vector<float>> predicted_original_sample(batch_size);
-    // "epsilon" by default
-    if (m_config.prediction_type == PredictionType::EPSILON) {
-        for (std::size_t i = 0; i < batch_size; ++i) {
-            std::vector<float>& predicted_original_sample_l = predicted_original_sample[i];
-            predicted_original_sample_l.resize(latent_size);
+    OPENVINO_ASSERT(m_config.prediction_type == PredictionType::EPSILON, "LCMScheduler supports only 'epsilon' prediction type");
 
-            for (std::size_t j = 0; j < latent_size; ++j)
-                predicted_original_sample_l[j] = (latents_data[i * latent_size + j] -
-                    beta_prod_t_sqrt * noise_pred_data[i * latent_size + j]) / alpha_prod_t_sqrt;
-        }
-    }
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_denoised.set_shape(shape);
+    m_prev_sample.set_shape(shape);
+    float* denoised_data = m_denoised.data<float>();
+    float* prev_sample_data = m_prev_sample.data<float>();
 
-    // 5. Clip or threshold "predicted x_0"
     if (m_config.thresholding) {
+        // 5. Threshold "predicted x_0", which needs whole images
+        std::vector<float> predicted_original_sample(latent_size);
         for (std::size_t i = 0; i < batch_size; ++i) {
-            predicted_original_sample[i] = threshold_sample(predicted_original_sample[i]);
-        }
-    } else if (m_config.clip_sample) {
-        for (std::size_t i = 0; i < batch_size; ++i) {
-            for (float& value : predicted_original_sample[i]) {
-                value = std::clamp(value, - m_config.clip_sample_range, m_config.clip_sample_range);
-            }
+            for (std::size_t j = 0; j < latent_size; ++j)
+                predicted_original_sample[j] = (latents_data[i * latent_size + j] -
+                    beta_prod_t_sqrt * noise_pred_data[i * latent_size + j]) / alpha_prod_t_sqrt;
+
+            predicted_original_sample = threshold_sample(predicted_original_sample);
+
+            // 6. Denoise model output using boundary conditions
+            for (std::size_t j = 0; j < latent_size; ++j)
+                denoised_data[i * latent_size + j] = c_out * predicted_original_sample[j] + c_skip * latents_data[i * latent_size + j];
         }
-    }
+    } else {
+        for (std::size_t i = 0; i < batch_size * latent_size; ++i) {
+            float predicted_original_sample = (latents_data[i] - beta_prod_t_sqrt * noise_pred_data[i]) / alpha_prod_t_sqrt;
 
-    // 6. Denoise model output using boundary conditions
-    ov::Tensor denoised(latents.get_element_type(), shape);
-    float* denoised_data = denoised.data<float>();
-    for (std::size_t i = 0; i < batch_size; ++i) {
-        for (std::size_t j = 0; j < latent_size; ++j) {
-            denoised_data[i * latent_size + j] = c_out * predicted_original_sample[i][j] + c_skip * latents_data[i * latent_size + j];
+            // 5. Clip "predicted x_0"
+            if (m_config.clip_sample)
+                predicted_original_sample = std::clamp(predicted_original_sample, - m_config.clip_sample_range, m_config.clip_sample_range);
+
+            // 6. Denoise model output using boundary conditions
+            denoised_data[i] = c_out * predicted_original_sample + c_skip * latents_data[i];
         }
     }
 
     /// 7. Sample and inject noise z ~ N(0, I) for MultiStep Inference
     // Noise is not used on the final timestep of the timestep schedule.
     // This also means that noise is not used for one-step sampling.
-    ov::Tensor prev_sample(latents.get_element_type(), shape);
-    float* prev_sample_data = prev_sample.data<float>();
-
     if (inference_step != m_num_inference_steps - 1) {
         ov::Tensor rand_tensor = generator->randn_tensor(shape);
         const float * rand_tensor_data = rand_tensor.data<float>();
@@ -191,12 +188,12 @@ std::map<std::string, ov::Tensor> LCMScheduler::step(ov::Tensor noise_pred, ov::
             prev_sample_data[i] = alpha_prod_t_prev_sqrt * denoised_data[i] + beta_prod_t_prev_sqrt * rand_tensor_data[i];
         }
     } else {
-        std::copy_n(denoised_data, denoised.get_size(), prev_sample_data);
+        std::copy_n(denoised_data, m_denoised.get_size(), prev_sample_data);
     }
 
     return {
-        {"latent", prev_sample},
-        {"denoised", denoised}
+        {"latent", m_prev_sample},
+        {"denoised", m_denoised}
     };
 }
 
@@ -64,6 +64,9 @@ private:
 
     std::vector<int64_t> m_timesteps;
 
+    // outputs of steps, reused by following steps, which may update them in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}}, m_denoised{ov::element::f32, {}};
+
     std::vector<float> threshold_sample(const std::vector<float>& flat_sample);
 };
 
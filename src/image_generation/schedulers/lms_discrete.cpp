@@ -191,36 +191,39 @@ std::map<std::string, ov::Tensor> LMSDiscreteScheduler::step(ov::Tensor noise_pr
     const float sigma = m_sigmas[inference_step];
 
     // LMS step function:
-    std::vector<float> derivative;
-    derivative.reserve(latents.get_size());
+    // keep the list size within 4, the oldest derivative buffer is reused for the new one
+    size_t order = 4;
+    if (m_derivative_list.size() == order) {
+        m_derivative_list.splice(m_derivative_list.end(), m_derivative_list, m_derivative_list.begin());
+    } else {
+        m_derivative_list.emplace_back();
+    }
+    std::vector<float>& derivative = m_derivative_list.back();
+    derivative.resize(latents.get_size());
+
+    const float* noise_pred_data = noise_pred.data<const float>();
+    const float* latents_data = latents.data<const float>();
 
     for (size_t j = 0; j < latents.get_size(); j++) {
         // 1. compute predicted original sample (x_0) from sigma-scaled predicted noise
         float pred_latent = 0;
         switch (m_config.prediction_type) {
             case PredictionType::EPSILON:
-                pred_latent = latents.data<float>()[j] - sigma * noise_pred.data<float>()[j];
+                pred_latent = latents_data[j] - sigma * noise_pred_data[j];
                 break;
             case PredictionType::SAMPLE:
-                pred_latent = noise_pred.data<float>()[j];
+                pred_latent = noise_pred_data[j];
                 break;
             case PredictionType::V_PREDICTION:
                 // pred_original_sample = model_output * (-sigma / (sigma**2 + 1) ** 0.5) + (sample / (sigma**2 + 1))
-                pred_latent = noise_pred.data<float>()[j] * (-sigma / std::sqrt(sigma * sigma + 1.0f) + 
-                    latents.data<float>()[j] / (sigma * sigma + 1.0f));
+                pred_latent = noise_pred_data[j] * (-sigma / std::sqrt(sigma * sigma + 1.0f) + 
+                    latents_data[j] / (sigma * sigma + 1.0f));
                 break;
             default:
                 OPENVINO_THROW("Unsupported value for 'PredictionType'");
         }
         // 2. Convert to an ODE derivative
-        derivative.push_back((latents.data<float>()[j] - pred_latent) / sigma);
-    }
-
-    m_derivative_list.push_back(derivative);
-    // keep the list size within 4
-    size_t order = 4;
-    if (order < m_derivative_list.size()) {
-        m_derivative_list.pop_front();
+        derivative[j] = (latents_data[j] - pred_latent) / sigma;
     }
 
     // 3. Compute linear multistep coefficients
@@ -228,7 +231,7 @@ std::map<std::string, ov::Tensor> LMSDiscreteScheduler::step(ov::Tensor noise_pr
 
     std::vector<float> lms_coeffs(order);
     for (size_t curr_order = 0; curr_order < order; curr_order++) {
-        auto lms_derivative_functor = [order, curr_order, sigmas = this->m_sigmas, inference_step] (float tau) {
+        auto lms_derivative_functor = [order, curr_order, &sigmas = this->m_sigmas, inference_step] (float tau) {
             return lms_derivative(tau, order, curr_order, sigmas, inference_step);
         };
         // integrated_coeff = integrate.quad(lms_derivative, self.sigmas[t], self.sigmas[t + 1], epsrel=1e-4)[0]
@@ -237,10 +240,10 @@ std::map<std::string, ov::Tensor> LMSDiscreteScheduler::step(ov::Tensor noise_pr
 
     // 4. Compute previous sample based on the derivatives path
     // prev_sample = sample + sum(coeff * derivative for coeff, derivative in zip(lms_coeffs, reversed(self.derivatives)))
-    ov::Tensor prev_sample(latents.get_element_type(), latents.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
-    const float* latents_data = latents.data<const float>();
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
+    // latents may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(latents.get_shape());
+    float* prev_sample_data = m_prev_sample.data<float>();
+    for (size_t i = 0; i < m_prev_sample.get_size(); ++i) {
         float derivative_sum = 0.0f;
         auto derivative_it = m_derivative_list.begin();
         for (size_t curr_order = 0; curr_order < order; derivative_it++, curr_order++) {
@@ -249,7 +252,7 @@ std::map<std::string, ov::Tensor> LMSDiscreteScheduler::step(ov::Tensor noise_pr
         prev_sample_data[i] = latents_data[i] + derivative_sum;
     }
 
-    std::map<std::string, ov::Tensor> result{{"latent", prev_sample}};
+    std::map<std::string, ov::Tensor> result{{"latent", m_prev_sample}};
 
     return result;
 }
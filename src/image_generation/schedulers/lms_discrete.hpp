@@ -51,6 +51,9 @@ private:
     std::vector<int64_t> m_timesteps;
     std::list<std::vector<float>> m_derivative_list;
 
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
+
     int64_t _sigma_to_t(float sigma) const;
 };
 
@@ -161,10 +161,12 @@ std::map<std::string, ov::Tensor> PNDMScheduler::step_plms(ov::Tensor model_outp
     int prev_timestep = timestep - m_config.num_train_timesteps / m_num_inference_steps;
 
     if (m_counter != 1) {
+        // keep the last 3 model outputs, the buffer of the oldest one is reused for the new one
+        ov::Tensor ets_last(model_output.get_element_type(), {});
         if (m_ets.size() > 3) {
-            m_ets = std::vector<ov::Tensor>(m_ets.end() - 3, m_ets.end());
+            ets_last = m_ets.front();
+            m_ets.erase(m_ets.begin());
         }
-        ov::Tensor ets_last(model_output.get_element_type(), model_output.get_shape());
         model_output.copy_to(ets_last);
         m_ets.push_back(ets_last);
     } else {
@@ -246,14 +248,15 @@ ov::Tensor PNDMScheduler::get_prev_sample(ov::Tensor sample, size_t timestep, in
             OPENVINO_THROW("Unsupported value for 'PredictionType'");
     }
 
-    ov::Tensor prev_sample = ov::Tensor(model_output.get_element_type(), model_output.get_shape());
-    float* prev_sample_data = prev_sample.data<float>();
+    // sample may be m_prev_sample of the previous step, each element is read before it's overwritten
+    m_prev_sample.set_shape(sample.get_shape());
+    float* prev_sample_data = m_prev_sample.data<float>();
 
-    for (size_t i = 0; i < prev_sample.get_size(); ++i) {
+    for (size_t i = 0; i < m_prev_sample.get_size(); ++i) {
         prev_sample_data[i] = sample_coeff * sample_data[i] - (alpha_prod_t_prev - alpha_prod_t) * model_output_data[i] / model_output_denom_coeff;
     }
 
-    return prev_sample;
+    return m_prev_sample;
 }
 
 void PNDMScheduler::add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const {
@@ -59,6 +59,9 @@ private:
 
     ov::Tensor m_cur_sample;
 
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
+
     std::map<std::string, ov::Tensor> step_plms(ov::Tensor model_output, ov::Tensor sample, size_t timestep);
     ov::Tensor get_prev_sample(ov::Tensor sample, size_t timestep, int prev_timestep, ov::Tensor model_output);
 };
@@ -12,6 +12,9 @@
 #include "image_generation/schedulers/flow_match_euler_discrete.hpp"
 #include "image_generation/schedulers/pndm.hpp"
 #include "image_generation/schedulers/euler_ancestral_discrete.hpp"
+#include "image_generation/schedulers/dpm_solver_multistep.hpp"
+#include "image_generation/schedulers/unipc_multistep.hpp"
+#include "image_generation/schedulers/flow_match_heun_discrete.hpp"
 
 namespace ov {
 namespace genai {
@@ -44,6 +47,12 @@ std::shared_ptr<Scheduler> Scheduler::from_config(const std::filesystem::path& s
         scheduler = std::make_shared<PNDMScheduler>(scheduler_config_path);
     } else if (scheduler_type == Scheduler::Type::EULER_ANCESTRAL_DISCRETE) {
         scheduler = std::make_shared<EulerAncestralDiscreteScheduler>(scheduler_config_path);
+    } else if (scheduler_type == Scheduler::Type::DPM_SOLVER_MULTISTEP) {
+        scheduler = std::make_shared<DPMSolverMultistepScheduler>(scheduler_config_path);
+    } else if (scheduler_type == Scheduler::Type::UNIPC_MULTISTEP) {
+        scheduler = std::make_shared<UniPCMultistepScheduler>(scheduler_config_path);
+    } else if (scheduler_type == Scheduler::Type::FLOW_MATCH_HEUN_DISCRETE) {
+        scheduler = std::make_shared<FlowMatchHeunDiscreteScheduler>(scheduler_config_path);
     } else {
         OPENVINO_THROW("Unsupported scheduler type '", scheduler_type, ". Please, manually create scheduler via supported one");
     }
@@ -59,6 +59,12 @@ void read_json_param(const nlohmann::json& data, const std::string& name, Schedu
             param = Scheduler::PNDM;
         else if (scheduler_type_str == "EulerAncestralDiscreteScheduler")
             param = Scheduler::EULER_ANCESTRAL_DISCRETE;
+        else if (scheduler_type_str == "DPMSolverMultistepScheduler")
+            param = Scheduler::DPM_SOLVER_MULTISTEP;
+        else if (scheduler_type_str == "UniPCMultistepScheduler")
+            param = Scheduler::UNIPC_MULTISTEP;
+        else if (scheduler_type_str == "FlowMatchHeunDiscreteScheduler")
+            param = Scheduler::FLOW_MATCH_HEUN_DISCRETE;
         else if (!scheduler_type_str.empty()) {
             OPENVINO_THROW("Unsupported value for 'scheduler' ", scheduler_type_str);
         }
@@ -123,6 +129,48 @@ void read_json_param(const nlohmann::json& data, const std::string& name, Timest
     }
 }
 
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, DPMSolverAlgorithmType& param) {
+    if (data.contains(name) && data[name].is_string()) {
+        std::string algorithm_type = data[name].get<std::string>();
+        if (algorithm_type == "dpmsolver++")
+            param = DPMSolverAlgorithmType::DPMSOLVER_PLUS_PLUS;
+        else if (algorithm_type == "sde-dpmsolver++")
+            param = DPMSolverAlgorithmType::SDE_DPMSOLVER_PLUS_PLUS;
+        else if (!algorithm_type.empty()) {
+            OPENVINO_THROW("Unsupported value for 'algorithm_type' ", algorithm_type);
+        }
+    }
+}
+
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, DPMSolverType& param) {
+    if (data.contains(name) && data[name].is_string()) {
+        std::string solver_type = data[name].get<std::string>();
+        if (solver_type == "midpoint")
+            param = DPMSolverType::MIDPOINT;
+        else if (solver_type == "heun")
+            param = DPMSolverType::HEUN;
+        else if (!solver_type.empty()) {
+            OPENVINO_THROW("Unsupported value for 'solver_type' ", solver_type);
+        }
+    }
+}
+
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, UniPCSolverType& param) {
+    if (data.contains(name) && data[name].is_string()) {
+        std::string solver_type = data[name].get<std::string>();
+        if (solver_type == "bh1")
+            param = UniPCSolverType::BH1;
+        else if (solver_type == "bh2")
+            param = UniPCSolverType::BH2;
+        else if (!solver_type.empty()) {
+            OPENVINO_THROW("Unsupported value for 'solver_type' ", solver_type);
+        }
+    }
+}
+
 }  // namespace utils
 }  // namespace genai
 }  // namespace ov
@@ -137,6 +185,12 @@ std::ostream& operator<<(std::ostream& os, const ov::genai::Scheduler::Type& sch
         return os << "DDIMScheduler";
     case ov::genai::Scheduler::Type::EULER_DISCRETE:
         return os << "EulerDiscreteScheduler";
+    case ov::genai::Scheduler::Type::DPM_SOLVER_MULTISTEP:
+        return os << "DPMSolverMultistepScheduler";
+    case ov::genai::Scheduler::Type::UNIPC_MULTISTEP:
+        return os << "UniPCMultistepScheduler";
+    case ov::genai::Scheduler::Type::FLOW_MATCH_HEUN_DISCRETE:
+        return os << "FlowMatchHeunDiscreteScheduler";
     case ov::genai::Scheduler::Type::AUTO:
         return os << "AutoScheduler";
     default:
@@ -45,6 +45,21 @@ enum class TimestepType {
     CONTINUOUS
 };
 
+enum class DPMSolverAlgorithmType {
+    DPMSOLVER_PLUS_PLUS,
+    SDE_DPMSOLVER_PLUS_PLUS
+};
+
+enum class DPMSolverType {
+    MIDPOINT,
+    HEUN
+};
+
+enum class UniPCSolverType {
+    BH1,
+    BH2
+};
+
 namespace utils {
 
 template <>
@@ -68,6 +83,15 @@ void read_json_param(const nlohmann::json& data, const std::string& name, FinalS
 template <>
 void read_json_param(const nlohmann::json& data, const std::string& name, TimestepType& param);
 
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, DPMSolverAlgorithmType& param);
+
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, DPMSolverType& param);
+
+template <>
+void read_json_param(const nlohmann::json& data, const std::string& name, UniPCSolverType& param);
+
 }  // namespace utils
 }  // namespace genai
 }  // namespace ov
@@ -0,0 +1,331 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "image_generation/schedulers/unipc_multistep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+#include "image_generation/numpy_utils.hpp"
+#include "json_utils.hpp"
+
+namespace ov {
+namespace genai {
+
+UniPCMultistepScheduler::Config::Config(const std::filesystem::path& scheduler_config_path) {
+    std::ifstream file(scheduler_config_path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", scheduler_config_path);
+
+    nlohmann::json data = nlohmann::json::parse(file);
+    using utils::read_json_param;
+
+    read_json_param(data, "num_train_timesteps", num_train_timesteps);
+    read_json_param(data, "beta_start", beta_start);
+    read_json_param(data, "beta_end", beta_end);
+    read_json_param(data, "beta_schedule", beta_schedule);
+    read_json_param(data, "trained_betas", trained_betas);
+    read_json_param(data, "solver_order", solver_order);
+    read_json_param(data, "prediction_type", prediction_type);
+    read_json_param(data, "predict_x0", predict_x0);
+    read_json_param(data, "solver_type", solver_type);
+    read_json_param(data, "lower_order_final", lower_order_final);
+    read_json_param(data, "disable_corrector", disable_corrector);
+    read_json_param(data, "use_karras_sigmas", use_karras_sigmas);
+    read_json_param(data, "final_sigmas_type", final_sigmas_type);
+    read_json_param(data, "timestep_spacing", timestep_spacing);
+    read_json_param(data, "steps_offset", steps_offset);
+    read_json_param(data, "rescale_betas_zero_snr", rescale_betas_zero_snr);
+}
+
+UniPCMultistepScheduler::UniPCMultistepScheduler(const std::filesystem::path& scheduler_config_path)
+    : UniPCMultistepScheduler(Config(scheduler_config_path)) {
+}
+
+UniPCMultistepScheduler::UniPCMultistepScheduler(const Config& scheduler_config)
+    : m_config(scheduler_config) {
+    OPENVINO_ASSERT(m_config.solver_order == 1 || m_config.solver_order == 2,
+        "UniPCMultistepScheduler supports 'solver_order' 1 and 2. Please, add support of other orders");
+    OPENVINO_ASSERT(m_config.predict_x0, "Parameter 'predict_x0' must be true. Please, add support of noise prediction");
+    OPENVINO_ASSERT(!m_config.use_karras_sigmas, "Parameter 'use_karras_sigmas' is not supported. Please, add support.");
+
+    using numpy_utils::linspace;
+
+    std::vector<float> betas;
+    if (!m_config.trained_betas.empty()) {
+        betas = m_config.trained_betas;
+    } else if (m_config.beta_schedule == BetaSchedule::LINEAR) {
+        betas = linspace<float>(m_config.beta_start, m_config.beta_end, m_config.num_train_timesteps, true);
+    } else if (m_config.beta_schedule == BetaSchedule::SCALED_LINEAR) {
+        float start = std::sqrt(m_config.beta_start);
+        float end = std::sqrt(m_config.beta_end);
+        betas = linspace<float>(start, end, m_config.num_train_timesteps, true);
+        std::for_each(betas.begin(), betas.end(), [] (float & x) { x *= x; });
+    } else {
+        OPENVINO_THROW("'beta_schedule' must be one of 'LINEAR' or 'SCALED_LINEAR'. Please, add support of other types");
+    }
+
+    if (m_config.rescale_betas_zero_snr) {
+        using numpy_utils::rescale_zero_terminal_snr;
+        rescale_zero_terminal_snr(betas);
+    }
+
+    float alpha_cumprod = 1.0f;
+    for (float beta : betas) {
+        alpha_cumprod *= 1.0f - beta;
+        m_alphas_cumprod.push_back(alpha_cumprod);
+    }
+
+    if (m_config.rescale_betas_zero_snr) {
+        // close to 0 without being 0 so first sigma is not inf
+        m_alphas_cumprod.back() = std::pow(2, -24);
+    }
+}
+
+void UniPCMultistepScheduler::set_timesteps(size_t num_inference_steps, float strength) {
+    m_timesteps.clear();
+    m_sigmas.clear();
+
+    const size_t num_train_timesteps = m_config.num_train_timesteps;
+
+    switch (m_config.timestep_spacing) {
+    case TimestepSpacing::LINSPACE: {
+        using numpy_utils::linspace;
+        std::vector<float> linspaced = linspace<float>(0.0f, static_cast<float>(num_train_timesteps - 1), num_inference_steps + 1, true);
+        for (auto it = linspaced.rbegin(); it != linspaced.rend() - 1; ++it) {
+            m_timesteps.push_back(static_cast<int64_t>(std::round(*it)));
+        }
+        break;
+    }
+    case TimestepSpacing::LEADING: {
+        const size_t step_ratio = num_train_timesteps / (num_inference_steps + 1);
+        for (size_t i = num_inference_steps; i > 0; --i) {
+            m_timesteps.push_back(i * step_ratio + m_config.steps_offset);
+        }
+        break;
+    }
+    case TimestepSpacing::TRAILING: {
+        const float step_ratio = static_cast<float>(num_train_timesteps) / num_inference_steps;
+        for (float i = num_train_timesteps; i > 0; i -= step_ratio) {
+            m_timesteps.push_back(static_cast<int64_t>(std::round(i)) - 1);
+        }
+        break;
+    }
+    default:
+        OPENVINO_THROW("Unsupported value for 'timestep_spacing'");
+    }
+
+    std::vector<float> sigmas;
+    for (float alpha_cumprod : m_alphas_cumprod) {
+        sigmas.push_back(std::sqrt((1 - alpha_cumprod) / alpha_cumprod));
+    }
+
+    using numpy_utils::interp;
+
+    std::vector<size_t> x_data_points(sigmas.size());
+    std::iota(x_data_points.begin(), x_data_points.end(), 0);
+    m_sigmas = interp(m_timesteps, x_data_points, sigmas);
+
+    switch (m_config.final_sigmas_type) {
+    case FinalSigmaType::SIGMA_MIN:
+        m_sigmas.push_back(sigmas.front());
+        break;
+    case FinalSigmaType::ZERO:
+        m_sigmas.push_back(0.0f);
+        break;
+    default:
+        OPENVINO_THROW("Unsupported value for 'final_sigmas_type'");
+    }
+
+    // apply 'strength' used in image generation
+    const size_t init_timestep = std::min<size_t>(num_inference_steps * strength, num_inference_steps);
+    m_begin_index = num_inference_steps - init_timestep;
+    m_schedule_timesteps = m_timesteps;
+    m_timesteps.erase(m_timesteps.begin(), m_timesteps.begin() + m_begin_index);
+
+    m_step_index = m_begin_index;
+    m_lower_order_nums = m_this_order = 0;
+    m_has_last_sample = false;
+    m_model_outputs.clear();
+    for (size_t i = 0; i < m_config.solver_order; ++i) {
+        m_model_outputs.emplace_back(ov::element::f32, ov::Shape{});
+    }
+}
+
+std::vector<int64_t> UniPCMultistepScheduler::get_timesteps() const {
+    return m_timesteps;
+}
+
+float UniPCMultistepScheduler::get_init_noise_sigma() const {
+    return 1.0f;
+}
+
+void UniPCMultistepScheduler::scale_model_input(ov::Tensor sample, size_t inference_step) {
+    return;
+}
+
+double UniPCMultistepScheduler::get_b_h(double hh) const {
+    switch (m_config.solver_type) {
+    case UniPCSolverType::BH1:
+        return hh;
+    case UniPCSolverType::BH2:
+        return std::expm1(hh);
+    default:
+        OPENVINO_THROW("Unsupported value for 'solver_type'");
+    }
+}
+
+std::map<std::string, ov::Tensor> UniPCMultistepScheduler::step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) {
+    OPENVINO_ASSERT(noise_pred.get_shape() == latents.get_shape(), "Shapes of noise prediction and latents must match");
+
+    const size_t k = m_step_index, size = latents.get_size();
+    const float* sample_data = latents.data<const float>();
+
+    // lambda = log(alpha) - log(sigma) = -log(sigma) in terms of sigmas of k-diffusion
+    auto alpha_t_of = [] (double sigma) { return 1.0 / std::sqrt(sigma * sigma + 1.0); };
+
+    // 1. convert model output to data prediction
+    {
+        const double sigma = m_sigmas[k], alpha_t = alpha_t_of(sigma), sigma_t = sigma * alpha_t;
+        float model_output_scale = 0.0f, sample_scale = 0.0f;
+        switch (m_config.prediction_type) {
+        case PredictionType::EPSILON:
+            model_output_scale = -sigma_t / alpha_t;
+            sample_scale = 1.0f / alpha_t;
+            break;
+        case PredictionType::SAMPLE:
+            model_output_scale = 1.0f;
+            sample_scale = 0.0f;
+            break;
+        case PredictionType::V_PREDICTION:
+            model_output_scale = -sigma_t;
+            sample_scale = alpha_t;
+            break;
+        default:
+            OPENVINO_THROW("Unsupported value for 'PredictionType'");
+        }
+
+        m_model_output.set_shape(latents.get_shape());
+        const float* model_output_data = noise_pred.data<const float>();
+        float* x0_data = m_model_output.data<float>();
+        for (size_t i = 0; i < size; ++i) {
+            x0_data[i] = model_output_scale * model_output_data[i] + sample_scale * sample_data[i];
+        }
+    }
+
+    // 2. correct sample of the previous step using data prediction at the current one (UniC)
+    const bool use_corrector = k > 0 && m_has_last_sample &&
+        std::find(m_config.disable_corrector.begin(), m_config.disable_corrector.end(), k - 1) == m_config.disable_corrector.end();
+    if (use_corrector) {
+        const double sigma_t = m_sigmas[k], sigma_s0 = m_sigmas[k - 1];
+        const double alpha_t = alpha_t_of(sigma_t), alpha_s0 = alpha_t_of(sigma_s0);
+        const double h = std::log(sigma_s0) - std::log(sigma_t), hh = -h;
+        const double h_phi_1 = std::expm1(hh), b_h = get_b_h(hh);
+
+        // rhos are solutions of R * rhos = b, where R rows are powers of rks = [rk, 1]
+        double h_phi_k = h_phi_1 / hh - 1.0;
+        const double b_1 = h_phi_k / b_h;
+        h_phi_k = h_phi_k / hh - 0.5;
+        const double b_2 = h_phi_k * 2.0 / b_h;
+
+        double rho_t = 0.5, rho_1 = 0.0, rk = 1.0;
+        if (m_this_order == 2) {
+            rk = (std::log(sigma_s0) - std::log(m_sigmas[k - 2])) / h;
+            rho_1 = (b_1 - b_2) / (1.0 - rk);
+            rho_t = b_1 - rho_1;
+        }
+
+        // x_t = x_scale * x - alpha_t * (h_phi_1 * m0 + B(h) * (rho_1 * (m1 - m0) / rk + rho_t * (model_t - m0)))
+        const float x_scale = (sigma_t * alpha_t) / (sigma_s0 * alpha_s0);
+        const float m0_scale = -alpha_t * h_phi_1 + alpha_t * b_h * (rho_1 / rk + rho_t);
+        const float m1_scale = -alpha_t * b_h * rho_1 / rk;
+        const float model_t_scale = -alpha_t * b_h * rho_t;
+
+        const float* m0_data = m_model_outputs.back().data<const float>();
+        const float* m1_data = m_this_order == 2 ? m_model_outputs[m_model_outputs.size() - 2].data<const float>() : nullptr;
+        const float* model_t_data = m_model_output.data<const float>();
+        float* x_data = m_last_sample.data<float>();
+        for (size_t i = 0; i < size; ++i) {
+            float x_t = x_scale * x_data[i] + m0_scale * m0_data[i] + model_t_scale * model_t_data[i];
+            if (m1_data)
+                x_t += m1_scale * m1_data[i];
+            x_data[i] = x_t;
+        }
+    } else {
+        m_last_sample.set_shape(latents.get_shape());
+        latents.copy_to(m_last_sample);
+    }
+    m_has_last_sample = true;
+
+    // 3. the oldest data prediction slot is reused for the next step
+    std::rotate(m_model_outputs.begin(), m_model_outputs.begin() + 1, m_model_outputs.end());
+    std::swap(m_model_outputs.back(), m_model_output);
+
+    const size_t num_inference_steps = m_schedule_timesteps.size();
+    m_this_order = m_config.lower_order_final ? std::min(m_config.solver_order, num_inference_steps - k) : m_config.solver_order;
+    m_this_order = std::min(m_this_order, m_lower_order_nums + 1);
+
+    // 4. predict sample of the next step from corrected sample (UniP)
+    {
+        const double sigma_t = m_sigmas[k + 1], sigma_s0 = m_sigmas[k];
+        const double alpha_t = alpha_t_of(sigma_t), alpha_s0 = alpha_t_of(sigma_s0);
+        const double h = std::log(sigma_s0) - std::log(sigma_t), hh = -h;
+        const double h_phi_1 = std::expm1(hh);
+
+        // x_t = x_scale * x - alpha_t * (h_phi_1 * m0 + B(h) * 0.5 * (m1 - m0) / rk)
+        const float x_scale = (sigma_t * alpha_t) / (sigma_s0 * alpha_s0);
+        float m0_scale = -alpha_t * h_phi_1, m1_scale = 0.0f;
+        if (m_this_order == 2) {
+            const double b_h = get_b_h(hh);
+            const double rk = (std::log(sigma_s0) - std::log(m_sigmas[k - 1])) / h;
+            m0_scale += alpha_t * b_h * 0.5 / rk;
+            m1_scale = -alpha_t * b_h * 0.5 / rk;
+        }
+
+        // latents may be m_prev_sample of the previous step, but the predictor reads corrected m_last_sample only
+        m_prev_sample.set_shape(latents.get_shape());
+        const float* x_data = m_last_sample.data<const float>();
+        const float* m0_data = m_model_outputs.back().data<const float>();
+        const float* m1_data = m_this_order == 2 ? m_model_outputs[m_model_outputs.size() - 2].data<const float>() : nullptr;
+        float* prev_sample_data = m_prev_sample.data<float>();
+        for (size_t i = 0; i < size; ++i) {
+            float x_t = x_scale * x_data[i] + m0_scale * m0_data[i];
+            if (m1_data)
+                x_t += m1_scale * m1_data[i];
+            prev_sample_data[i] = x_t;
+        }
+    }
+
+    if (m_lower_order_nums < m_config.solver_order)
+        ++m_lower_order_nums;
+    ++m_step_index;
+
+    return {{"latent", m_prev_sample}, {"denoised", m_model_outputs.back()}};
+}
+
+size_t UniPCMultistepScheduler::_index_for_timestep(int64_t timestep) const {
+    for (size_t i = 0; i < m_schedule_timesteps.size(); ++i) {
+        if (timestep == m_schedule_timesteps[i]) {
+            return i;
+        }
+    }
+
+    OPENVINO_THROW("Failed to find index for timestep ", timestep);
+}
+
+void UniPCMultistepScheduler::add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const {
+    const float sigma = m_sigmas[_index_for_timestep(latent_timestep)];
+    const float alpha_t = 1.0f / std::sqrt(sigma * sigma + 1.0f), sigma_t = sigma * alpha_t;
+
+    float * init_latent_data = init_latent.data<float>();
+    const float * noise_data = noise.data<float>();
+
+    for (size_t i = 0; i < init_latent.get_size(); ++i) {
+        init_latent_data[i] = alpha_t * init_latent_data[i] + sigma_t * noise_data[i];
+    }
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -0,0 +1,81 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "image_generation/schedulers/types.hpp"
+#include "image_generation/schedulers/ischeduler.hpp"
+
+namespace ov {
+namespace genai {
+
+// UniPC (https://arxiv.org/abs/2302.04867): multistep predictor UniP followed by corrector UniC, which reuses
+// model output of the next step, so correction comes without extra model evaluations
+class UniPCMultistepScheduler : public IScheduler {
+public:
+    struct Config {
+        int32_t num_train_timesteps = 1000;
+        float beta_start = 0.0001f, beta_end = 0.02f;
+        BetaSchedule beta_schedule = BetaSchedule::LINEAR;
+        std::vector<float> trained_betas = {};
+        size_t solver_order = 2;
+        PredictionType prediction_type = PredictionType::EPSILON;
+        bool predict_x0 = true;
+        UniPCSolverType solver_type = UniPCSolverType::BH2;
+        bool lower_order_final = true;
+        std::vector<size_t> disable_corrector = {};
+        bool use_karras_sigmas = false;
+        FinalSigmaType final_sigmas_type = FinalSigmaType::ZERO;
+        TimestepSpacing timestep_spacing = TimestepSpacing::LINSPACE;
+        size_t steps_offset = 0;
+        bool rescale_betas_zero_snr = false;
+
+        Config() = default;
+        explicit Config(const std::filesystem::path& scheduler_config_path);
+    };
+
+    explicit UniPCMultistepScheduler(const std::filesystem::path& scheduler_config_path);
+    explicit UniPCMultistepScheduler(const Config& scheduler_config);
+
+    void set_timesteps(size_t num_inference_steps, float strength) override;
+
+    std::vector<std::int64_t> get_timesteps() const override;
+
+    float get_init_noise_sigma() const override;
+
+    void scale_model_input(ov::Tensor sample, size_t inference_step) override;
+
+    std::map<std::string, ov::Tensor> step(ov::Tensor noise_pred, ov::Tensor latents, size_t inference_step, std::shared_ptr<Generator> generator) override;
+
+    void add_noise(ov::Tensor init_latent, ov::Tensor noise, int64_t latent_timestep) const override;
+
+private:
+    Config m_config;
+
+    std::vector<float> m_alphas_cumprod, m_sigmas;
+    std::vector<int64_t> m_timesteps, m_schedule_timesteps;
+
+    size_t m_step_index = 0, m_begin_index = 0, m_lower_order_nums = 0, m_this_order = 0;
+
+    // data predictions of previous steps, the most recent one is the last
+    std::vector<ov::Tensor> m_model_outputs;
+    // data prediction of the current step, swapped with the oldest one of m_model_outputs after correction
+    ov::Tensor m_model_output{ov::element::f32, {}};
+    // corrected sample the predictor starts from, it's corrected at the next step
+    ov::Tensor m_last_sample{ov::element::f32, {}};
+    bool m_has_last_sample = false;
+    // output of steps, reused by following steps, which may update it in place
+    ov::Tensor m_prev_sample{ov::element::f32, {}};
+
+    // B(h) of the solver for hh = -h
+    double get_b_h(double hh) const;
+
+    size_t _index_for_timestep(int64_t timestep) const;
+};
+
+} // namespace genai
+} // namespace ov
@@ -119,8 +119,9 @@ public:
     StableDiffusion3Pipeline(PipelineType pipeline_type,
                              const std::filesystem::path& root_dir,
                              const std::string& device,
-                             const ov::AnyMap& properties) :
+                             ov::AnyMap properties) :
         DiffusionPipeline(pipeline_type) {
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(properties);
         const std::filesystem::path model_index_path = root_dir / "model_index.json";
         std::ifstream file(model_index_path);
         OPENVINO_ASSERT(file.is_open(), "Failed to open ", model_index_path);
@@ -137,18 +138,25 @@ public:
             updated_properties["INFERENCE_PRECISION_HINT"] = ov::element::f32;
         }
 
+        // submodels are independent, so they are read and compiled concurrently to reduce pipeline creation time
+        std::vector<std::function<void()>> tasks;
+
         const std::string text_encoder = data["text_encoder"][1].get<std::string>();
         if (text_encoder == "CLIPTextModelWithProjection") {
-            m_clip_text_encoder_1 =
-                std::make_shared<CLIPTextModelWithProjection>(root_dir / "text_encoder", device, updated_properties);
+            tasks.push_back([&] () {
+                m_clip_text_encoder_1 =
+                    std::make_shared<CLIPTextModelWithProjection>(root_dir / "text_encoder", device, updated_properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", text_encoder, "' text encoder type");
         }
 
         const std::string text_encoder_2 = data["text_encoder_2"][1].get<std::string>();
         if (text_encoder_2 == "CLIPTextModelWithProjection") {
-            m_clip_text_encoder_2 =
-                std::make_shared<CLIPTextModelWithProjection>(root_dir / "text_encoder_2", device, updated_properties);
+            tasks.push_back([&] () {
+                m_clip_text_encoder_2 =
+                    std::make_shared<CLIPTextModelWithProjection>(root_dir / "text_encoder_2", device, updated_properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", text_encoder_2, "' text encoder type");
         }
@@ -157,7 +165,9 @@ public:
         if (!text_encoder_3_json.is_null()) {
             const std::string text_encoder_3 = text_encoder_3_json.get<std::string>();
             if (text_encoder_3 == "T5EncoderModel") {
-                m_t5_text_encoder = std::make_shared<T5EncoderModel>(root_dir / "text_encoder_3", device, updated_properties);
+                tasks.push_back([&] () {
+                    m_t5_text_encoder = std::make_shared<T5EncoderModel>(root_dir / "text_encoder_3", device, updated_properties);
+                });
             } else {
                 OPENVINO_THROW("Unsupported '", text_encoder_3, "' text encoder type");
             }
@@ -165,17 +175,24 @@ public:
 
         const std::string transformer = data["transformer"][1].get<std::string>();
         if (transformer == "SD3Transformer2DModel") {
-            m_transformer = std::make_shared<SD3Transformer2DModel>(root_dir / "transformer", device, properties);
+            tasks.push_back([&] () {
+                m_transformer = std::make_shared<SD3Transformer2DModel>(root_dir / "transformer", device, denoiser_properties);
+            });
         } else {
             OPENVINO_THROW("Unsupported '", transformer, "' Transformer type");
         }
 
         const std::string vae = data["vae"][1].get<std::string>();
         if (vae == "AutoencoderKL") {
+            // VAE encoder is not needed, hence not read and compiled, for text to image generation
             if (m_pipeline_type == PipelineType::TEXT_2_IMAGE)
-                m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, updated_properties);
+                tasks.push_back([&] () {
+                    m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, updated_properties);
+                });
             else if (m_pipeline_type == PipelineType::IMAGE_2_IMAGE || m_pipeline_type == PipelineType::INPAINTING) {
-                m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, updated_properties);
+                tasks.push_back([&] () {
+                    m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, updated_properties);
+                });
             } else {
                 OPENVINO_ASSERT("Unsupported pipeline type");
             }
@@ -183,6 +200,8 @@ public:
             OPENVINO_THROW("Unsupported '", vae, "' VAE decoder type");
         }
 
+        run_in_parallel(tasks);
+
         // initialize generation config
         initialize_generation_config(data["_class_name"].get<std::string>());
 
@@ -247,15 +266,20 @@ public:
     }
 
     void compile(const std::string& device, const ov::AnyMap& properties) override {
-        update_adapters_from_properties(properties, m_generation_config.adapters);
-
-        m_clip_text_encoder_1->compile(device, properties);
-        m_clip_text_encoder_2->compile(device, properties);
+        ov::AnyMap submodel_properties = properties;
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(submodel_properties);
+        update_adapters_from_properties(submodel_properties, m_generation_config.adapters);
+
+        std::vector<std::function<void()>> tasks = {
+            [&] () { m_clip_text_encoder_1->compile(device, submodel_properties); },
+            [&] () { m_clip_text_encoder_2->compile(device, submodel_properties); },
+            [&] () { m_transformer->compile(device, denoiser_properties); },
+            [&] () { m_vae->compile(device, submodel_properties); }
+        };
         if (m_t5_text_encoder) {
-            m_t5_text_encoder->compile(device, properties);
+            tasks.push_back([&] () { m_t5_text_encoder->compile(device, submodel_properties); });
         }
-        m_transformer->compile(device, properties);
-        m_vae->compile(device, properties);
+        run_in_parallel(tasks);
     }
 
     void compute_hidden_states(const std::string& positive_prompt, const ImageGenerationConfig& generation_config) override {
@@ -274,14 +298,18 @@ public:
         std::string negative_prompt_3_str = generation_config.negative_prompt_3 != std::nullopt ? *generation_config.negative_prompt_3 : negative_prompt_1_str;
 
         // text_encoder_1_output - stores positive and negative pooled_prompt_embeds
-        ov::Tensor text_encoder_1_output = m_clip_text_encoder_1->infer(positive_prompt, negative_prompt_1_str, do_classifier_free_guidance(generation_config.guidance_scale));
+        ov::Tensor text_encoder_1_output = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+            return m_clip_text_encoder_1->infer(positive_prompt, negative_prompt_1_str, do_classifier_free_guidance(generation_config.guidance_scale));
+        });
 
         // text_encoder_1_hidden_state - stores positive and negative prompt_embeds
         size_t idx_hidden_state_1 = m_clip_text_encoder_1->get_config().num_hidden_layers + 1;
         ov::Tensor text_encoder_1_hidden_state = m_clip_text_encoder_1->get_output_tensor(idx_hidden_state_1);
 
         // text_encoder_2_output - stores positive and negative pooled_prompt_2_embeds
-        ov::Tensor text_encoder_2_output = m_clip_text_encoder_2->infer(prompt_2_str, negative_prompt_2_str, do_classifier_free_guidance(generation_config.guidance_scale));
+        ov::Tensor text_encoder_2_output = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder_2"], [&] {
+            return m_clip_text_encoder_2->infer(prompt_2_str, negative_prompt_2_str, do_classifier_free_guidance(generation_config.guidance_scale));
+        });
 
         // text_encoder_2_hidden_state - stores positive and negative prompt_2_embeds
         size_t idx_hidden_state_2 = m_clip_text_encoder_2->get_config().num_hidden_layers + 1;
@@ -289,10 +317,12 @@ public:
 
         ov::Tensor text_encoder_3_output;
         if (m_t5_text_encoder) {
-            text_encoder_3_output = m_t5_text_encoder->infer(prompt_3_str,
-                                                             negative_prompt_3_str,
-                                                             do_classifier_free_guidance(generation_config.guidance_scale),
-                                                             generation_config.max_sequence_length);
+            text_encoder_3_output = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder_3"], [&] {
+                return m_t5_text_encoder->infer(prompt_3_str,
+                                                negative_prompt_3_str,
+                                                do_classifier_free_guidance(generation_config.guidance_scale),
+                                                generation_config.max_sequence_length);
+            });
         } else {
             ov::Shape t5_prompt_embed_shape = {generation_config.num_images_per_prompt,
                                                m_clip_text_encoder_1->get_config().max_position_embeddings,
@@ -468,9 +498,8 @@ public:
         ov::Tensor latent_cfg(ov::element::f32, latent_shape_cfg);
 
         // 6. Denoising loop
-        ov::Tensor noisy_residual_tensor(ov::element::f32, {});
-
         for (size_t inference_step = 0; inference_step < timesteps.size(); ++inference_step) {
+            const auto iteration_start = std::chrono::steady_clock::now();
             // concat the same latent twice along a batch dimension in case of CFG
             if (batch_size_multiplier > 1) {
                 numpy_utils::batch_copy(latent, latent_cfg, 0, 0, generation_config.num_images_per_prompt);
@@ -481,40 +510,32 @@ public:
             }
 
             ov::Tensor timestep(ov::element::f32, {1}, &timesteps[inference_step]);
-            ov::Tensor noise_pred_tensor = m_transformer->infer(latent_cfg, timestep);
-
-            ov::Shape noise_pred_shape = noise_pred_tensor.get_shape();
-            noise_pred_shape[0] /= batch_size_multiplier;
-
-            if (batch_size_multiplier > 1) {
-                noisy_residual_tensor.set_shape(noise_pred_shape);
-
-                // perform guidance
-                float* noisy_residual = noisy_residual_tensor.data<float>();
-                const float* noise_pred_uncond = noise_pred_tensor.data<const float>();
-                const float* noise_pred_text = noise_pred_uncond + noisy_residual_tensor.get_size();
-
-                for (size_t i = 0; i < noisy_residual_tensor.get_size(); ++i) {
-                    noisy_residual[i] = noise_pred_uncond[i] +
-                                        generation_config.guidance_scale * (noise_pred_text[i] - noise_pred_uncond[i]);
-                }
-            } else {
-                noisy_residual_tensor = noise_pred_tensor;
-            }
-
-            auto scheduler_step_result = m_scheduler->step(noisy_residual_tensor, latent, inference_step, generation_config.generator);
+            ov::Tensor noise_pred_tensor = measure(m_perf_metrics.raw_metrics.denoiser_inference_durations, [&] {
+                return m_transformer->infer(latent_cfg, timestep);
+            });
+
+            // guidance is fused into a scheduler step to avoid an extra pass over noise prediction
+            auto scheduler_step_result = measure(m_perf_metrics.raw_metrics.scheduler_step_durations, [&] {
+                return batch_size_multiplier > 1 ?
+                    m_scheduler->step_with_guidance(noise_pred_tensor, generation_config.guidance_scale, latent, inference_step, generation_config.generator) :
+                    m_scheduler->step(noise_pred_tensor, latent, inference_step, generation_config.generator);
+            });
             latent = scheduler_step_result["latent"];
 
             if (callback && callback(inference_step, timesteps.size(), latent)) {
                 return ov::Tensor(ov::element::u8, {});
             }
+
+            m_perf_metrics.raw_metrics.iteration_durations.emplace_back(std::chrono::steady_clock::now() - iteration_start);
         }
 
         return decode(latent);
     }
 
     ov::Tensor decode(const ov::Tensor latent) override {
-        return m_vae->decode(latent);
+        return measure(m_perf_metrics.raw_metrics.vae_decoder_inference_durations, [&] {
+            return m_vae->decode(latent);
+        });
     }
 
 private:
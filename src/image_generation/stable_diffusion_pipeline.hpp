@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <filesystem>
+#include <future>
 
 #include "image_generation/diffusion_pipeline.hpp"
 #include "image_generation/numpy_utils.hpp"
@@ -20,6 +23,7 @@
 #include "json_utils.hpp"
 #include "lora_helper.hpp"
 #include "debug_utils.hpp"
+#include "tracing.hpp"
 #include "numpy_utils.hpp"
 
 namespace ov {
@@ -88,8 +92,10 @@ public:
         initialize_generation_config(data["_class_name"].get<std::string>());
     }
 
-    StableDiffusionPipeline(PipelineType pipeline_type, const std::filesystem::path& root_dir, const std::string& device, const ov::AnyMap& properties) :
+    StableDiffusionPipeline(PipelineType pipeline_type, const std::filesystem::path& root_dir, const std::string& device, ov::AnyMap properties) :
         StableDiffusionPipeline(pipeline_type) {
+        const size_t vae_encoder_cache_size = extract_vae_encoder_cache_size(properties);
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(properties);
         const std::filesystem::path model_index_path = root_dir / "model_index.json";
         std::ifstream file(model_index_path);
         OPENVINO_ASSERT(file.is_open(), "Failed to open ", model_index_path);
@@ -108,7 +114,7 @@ public:
 
         const std::string unet = data["unet"][1].get<std::string>();
         if (unet == "UNet2DConditionModel") {
-            m_unet = std::make_shared<UNet2DConditionModel>(root_dir / "unet", device, properties);
+            m_unet = std::make_shared<UNet2DConditionModel>(root_dir / "unet", device, denoiser_properties);
         } else {
             OPENVINO_THROW("Unsupported '", unet, "' UNet type");
         }
@@ -119,6 +125,9 @@ public:
                 m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, properties);
             else if (m_pipeline_type == PipelineType::IMAGE_2_IMAGE || m_pipeline_type == PipelineType::INPAINTING) {
                 m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, properties);
+                if (vae_encoder_cache_size > 0) {
+                    m_vae->enable_encoder_cache(vae_encoder_cache_size);
+                }
             } else {
                 OPENVINO_ASSERT("Unsupported pipeline type");
             }
@@ -161,7 +170,10 @@ public:
 
     void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale) override {
         check_image_size(height, width);
+        reshape(num_images_per_prompt, ov::Dimension(height < 0 ? -1 : height), ov::Dimension(width < 0 ? -1 : width), guidance_scale);
+    }
 
+    void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) override {
         const size_t batch_size_multiplier = m_unet->do_classifier_free_guidance(guidance_scale) ? 2 : 1;  // Unet accepts 2x batch in case of CFG
         m_clip_text_encoder->reshape(batch_size_multiplier);
         m_unet->reshape(num_images_per_prompt * batch_size_multiplier, height, width, m_clip_text_encoder->get_config().max_position_embeddings);
@@ -169,11 +181,17 @@ public:
     }
 
     void compile(const std::string& device, const ov::AnyMap& properties) override {
-        update_adapters_from_properties(properties, m_generation_config.adapters);
-
-        m_clip_text_encoder->compile(device, properties);
-        m_unet->compile(device, properties);
-        m_vae->compile(device, properties);
+        ov::AnyMap submodel_properties = properties;
+        const size_t vae_encoder_cache_size = extract_vae_encoder_cache_size(submodel_properties);
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(submodel_properties);
+        update_adapters_from_properties(submodel_properties, m_generation_config.adapters);
+
+        m_clip_text_encoder->compile(device, submodel_properties);
+        m_unet->compile(device, denoiser_properties);
+        m_vae->compile(device, submodel_properties);
+        if (vae_encoder_cache_size > 0 && m_pipeline_type != PipelineType::TEXT_2_IMAGE) {
+            m_vae->enable_encoder_cache(vae_encoder_cache_size);
+        }
     }
 
     void compute_hidden_states(const std::string& positive_prompt, const ImageGenerationConfig& generation_config) override {
@@ -181,8 +199,9 @@ public:
         const size_t batch_size_multiplier = m_unet->do_classifier_free_guidance(generation_config.guidance_scale) ? 2 : 1;  // Unet accepts 2x batch in case of CFG
 
         std::string negative_prompt = generation_config.negative_prompt != std::nullopt ? *generation_config.negative_prompt : std::string{};
-        ov::Tensor encoder_hidden_states = m_clip_text_encoder->infer(positive_prompt, negative_prompt,
-            batch_size_multiplier > 1);
+        ov::Tensor encoder_hidden_states = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+            return m_clip_text_encoder->infer(positive_prompt, negative_prompt, batch_size_multiplier > 1);
+        });
 
         // replicate encoder hidden state to UNet model
         if (generation_config.num_images_per_prompt == 1) {
@@ -210,6 +229,43 @@ public:
         }
     }
 
+    void compute_batched_hidden_states(const std::vector<std::string>& positive_prompts, const ImageGenerationConfig& generation_config) {
+        const auto& unet_config = m_unet->get_config();
+        const bool do_classifier_free_guidance = m_unet->do_classifier_free_guidance(generation_config.guidance_scale);
+        const size_t batch_size = positive_prompts.size() * generation_config.num_images_per_prompt;
+
+        std::string negative_prompt = generation_config.negative_prompt != std::nullopt ? *generation_config.negative_prompt : std::string{};
+        ov::Tensor encoder_hidden_states_batched;
+
+        // unconditional hidden states of all images are followed by text conditioned ones, as guidance expects
+        for (size_t p = 0; p < positive_prompts.size(); ++p) {
+            ov::Tensor encoder_hidden_states = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+                return m_clip_text_encoder->infer(positive_prompts[p], negative_prompt, do_classifier_free_guidance);
+            });
+
+            if (!encoder_hidden_states_batched) {
+                ov::Shape enc_shape = encoder_hidden_states.get_shape();
+                enc_shape[0] *= batch_size;
+                encoder_hidden_states_batched = ov::Tensor(encoder_hidden_states.get_element_type(), enc_shape);
+            }
+
+            for (size_t n = 0; n < generation_config.num_images_per_prompt; ++n) {
+                const size_t image_idx = p * generation_config.num_images_per_prompt + n;
+                numpy_utils::batch_copy(encoder_hidden_states, encoder_hidden_states_batched, 0, image_idx);
+                if (do_classifier_free_guidance) {
+                    numpy_utils::batch_copy(encoder_hidden_states, encoder_hidden_states_batched, 1, batch_size + image_idx);
+                }
+            }
+        }
+
+        m_unet->set_hidden_states("encoder_hidden_states", encoder_hidden_states_batched);
+
+        if (unet_config.time_cond_proj_dim >= 0) { // LCM
+            ov::Tensor timestep_cond = get_guidance_scale_embedding(generation_config.guidance_scale - 1.0f, unet_config.time_cond_proj_dim);
+            m_unet->set_hidden_states("timestep_cond", timestep_cond);
+        }
+    }
+
     std::tuple<ov::Tensor, ov::Tensor, ov::Tensor, ov::Tensor> prepare_latents(ov::Tensor initial_image, const ImageGenerationConfig& generation_config) const override {
         std::vector<int64_t> timesteps = m_scheduler->get_timesteps();
         OPENVINO_ASSERT(!timesteps.empty(), "Timesteps are not computed yet");
@@ -233,7 +289,9 @@ public:
             // - inpainting with strength < 1.0
             // - inpainting with non-specialized model
             if (!is_strength_max || return_image_latent) {
-                image_latent = m_vae->encode(proccesed_image, generation_config.generator);
+                image_latent = measure(m_perf_metrics.raw_metrics.vae_encoder_inference_durations, [&] {
+                    return m_vae->encode(proccesed_image, generation_config.generator);
+                });
 
                 // in case of image to image or inpaining with strength < 1.0, we need to initialize initial latent with image_latent
                 if (!is_strength_max) {
@@ -263,7 +321,7 @@ public:
     std::tuple<ov::Tensor, ov::Tensor> prepare_mask_latents(ov::Tensor mask_image, ov::Tensor processed_image, const ImageGenerationConfig& generation_config) {
         OPENVINO_ASSERT(m_pipeline_type == PipelineType::INPAINTING, "'prepare_mask_latents' can be called for inpainting pipeline only");
 
-        const size_t batch_size_multiplier = m_unet->do_classifier_free_guidance(generation_config.guidance_scale) ? 2 : 1;  // Unet accepts 2x batch in case of CFG
+        const size_t batch_size_multiplier = get_sample_batch_size_multiplier(generation_config);
         const size_t vae_scale_factor = m_vae->get_vae_scale_factor();
         ov::Shape target_shape = processed_image.get_shape();
 
@@ -291,7 +349,9 @@ public:
             }
 
             // encode masked image to latent scape
-            masked_image_latent = m_vae->encode(masked_image, generation_config.generator);
+            masked_image_latent = measure(m_perf_metrics.raw_metrics.vae_encoder_inference_durations, [&] {
+                return m_vae->encode(masked_image, generation_config.generator);
+            });
             masked_image_latent = numpy_utils::repeat(masked_image_latent, generation_config.num_images_per_prompt * batch_size_multiplier);
         }
 
@@ -307,6 +367,62 @@ public:
                         ov::Tensor initial_image,
                         ov::Tensor mask_image,
                         const ov::AnyMap& properties) override {
+        return generate(std::vector<std::string>{positive_prompt}, initial_image, mask_image, properties);
+    }
+
+    ov::Tensor generate_batch(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) override {
+        OPENVINO_ASSERT(!positive_prompts.empty(), "At least one prompt must be passed");
+        return generate(positive_prompts, {}, {}, properties);
+    }
+
+    std::vector<ov::Tensor> generate_pipelined(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) override {
+        std::vector<ov::Tensor> images;
+        std::future<ov::Tensor> decoded_image;
+
+        for (const std::string& positive_prompt : positive_prompts) {
+            ov::Tensor denoised = denoise({positive_prompt}, {}, {}, properties);
+
+            if (decoded_image.valid())
+                images.push_back(decoded_image.get());
+
+            if (!denoised) {
+                // generation is cancelled by callback
+                images.push_back(ov::Tensor(ov::element::u8, {}));
+                continue;
+            }
+
+            // VAE decoder reads latent and writes image in place, while the next denoising loop overwrites scheduler
+            // outputs, so decoding works on own copies
+            ov::Tensor latent(denoised.get_element_type(), denoised.get_shape());
+            denoised.copy_to(latent);
+            decoded_image = std::async(std::launch::async, [this, latent] {
+                ov::Tensor image = decode(latent);
+                ov::Tensor image_copy(image.get_element_type(), image.get_shape());
+                image.copy_to(image_copy);
+                return image_copy;
+            });
+        }
+
+        if (decoded_image.valid())
+            images.push_back(decoded_image.get());
+
+        return images;
+    }
+
+    ov::Tensor generate(const std::vector<std::string>& positive_prompts,
+                        ov::Tensor initial_image,
+                        ov::Tensor mask_image,
+                        const ov::AnyMap& properties) {
+        ov::Tensor denoised = denoise(positive_prompts, initial_image, mask_image, properties);
+        // empty latent means that generation is cancelled by callback
+        return denoised ? decode(denoised) : ov::Tensor(ov::element::u8, {});
+    }
+
+    // runs a denoising loop and returns the final latent, which is empty if generation is cancelled by callback
+    ov::Tensor denoise(const std::vector<std::string>& positive_prompts,
+                       ov::Tensor initial_image,
+                       ov::Tensor mask_image,
+                       const ov::AnyMap& properties) {
         using namespace numpy_utils;
         ImageGenerationConfig generation_config = m_generation_config;
         generation_config.update_generation_config(properties);
@@ -318,11 +434,17 @@ public:
             callback = callback_iter->second.as<std::function<bool(size_t, size_t, ov::Tensor&)>>();
         }
 
+        std::function<bool(size_t, size_t, ov::Tensor&)> preview_callback = nullptr;
+        auto preview_callback_iter = properties.find(ov::genai::preview_callback.name());
+        if (preview_callback_iter != properties.end()) {
+            preview_callback = preview_callback_iter->second.as<std::function<bool(size_t, size_t, ov::Tensor&)>>();
+        }
+
         // Stable Diffusion pipeline
         // see https://huggingface.co/docs/diffusers/using-diffusers/write_own_pipeline#deconstruct-the-stable-diffusion-pipeline
 
         const auto& unet_config = m_unet->get_config();
-        const size_t batch_size_multiplier = m_unet->do_classifier_free_guidance(generation_config.guidance_scale) ? 2 : 1;  // Unet accepts 2x batch in case of CFG
+        const size_t batch_size_multiplier = get_sample_batch_size_multiplier(generation_config);
         const size_t vae_scale_factor = m_vae->get_vae_scale_factor();
 
         if (generation_config.height < 0)
@@ -338,7 +460,19 @@ public:
         std::vector<std::int64_t> timesteps = m_scheduler->get_timesteps();
 
         // compute text encoders and set hidden states
-        compute_hidden_states(positive_prompt, generation_config);
+        if (positive_prompts.size() == 1) {
+            compute_hidden_states(positive_prompts[0], generation_config);
+        } else {
+            // prompts share a denoising loop, so their images are processed as a single batch
+            compute_batched_hidden_states(positive_prompts, generation_config);
+            generation_config.num_images_per_prompt *= positive_prompts.size();
+        }
+
+        if (m_unet->has_fused_guidance()) {
+            ov::Tensor guidance_scale(ov::element::f32, {1});
+            guidance_scale.data<float>()[0] = generation_config.guidance_scale;
+            m_unet->set_hidden_states("guidance_scale", guidance_scale);
+        }
 
         // preparate initial / image latents
         ov::Tensor latent, processed_image, image_latent, noise;
@@ -354,9 +488,17 @@ public:
         ov::Shape latent_shape_cfg = latent.get_shape();
         latent_shape_cfg[0] *= batch_size_multiplier;
 
-        ov::Tensor latent_cfg(ov::element::f32, latent_shape_cfg), denoised, noisy_residual_tensor(ov::element::f32, {}), latent_model_input;
+        ov::Tensor latent_cfg(ov::element::f32, latent_shape_cfg), denoised, latent_model_input = latent_cfg, latent_model_input_latent;
+
+        // mask and masked image latents don't change between steps, so they are concatenated once,
+        // while each step updates latent channels in place
+        if (is_inpainting_model()) {
+            latent_model_input = numpy_utils::concat(numpy_utils::concat(latent_cfg, mask, 1), masked_image_latent, 1);
+            latent_model_input_latent = ov::Tensor(latent_model_input, ov::Coordinate(latent_shape_cfg.size(), 0), ov::Coordinate(latent_shape_cfg));
+        }
 
         for (size_t inference_step = 0; inference_step < timesteps.size(); inference_step++) {
+            const auto iteration_start = std::chrono::steady_clock::now();
             numpy_utils::batch_copy(latent, latent_cfg, 0, 0, generation_config.num_images_per_prompt);
             // concat the same latent twice along a batch dimension in case of CFG
             if (batch_size_multiplier > 1) {
@@ -365,30 +507,29 @@ public:
 
             m_scheduler->scale_model_input(latent_cfg, inference_step);
 
-            ov::Tensor latent_model_input = is_inpainting_model() ? numpy_utils::concat(numpy_utils::concat(latent_cfg, mask, 1), masked_image_latent, 1) : latent_cfg;
-            ov::Tensor timestep(ov::element::i64, {1}, &timesteps[inference_step]);
-            ov::Tensor noise_pred_tensor = m_unet->infer(latent_model_input, timestep);
-
-            ov::Shape noise_pred_shape = noise_pred_tensor.get_shape();
-            noise_pred_shape[0] /= batch_size_multiplier;
- 
-            if (batch_size_multiplier > 1) {
-                noisy_residual_tensor.set_shape(noise_pred_shape);
-
-                // perform guidance
-                float* noisy_residual = noisy_residual_tensor.data<float>();
-                const float* noise_pred_uncond = noise_pred_tensor.data<const float>();
-                const float* noise_pred_text = noise_pred_uncond + noisy_residual_tensor.get_size();
+            if (is_inpainting_model()) {
+                latent_cfg.copy_to(latent_model_input_latent);
+            }
 
-                for (size_t i = 0; i < noisy_residual_tensor.get_size(); ++i) {
-                    noisy_residual[i] = noise_pred_uncond[i] +
-                        generation_config.guidance_scale * (noise_pred_text[i] - noise_pred_uncond[i]);
-                }
-            } else {
-                noisy_residual_tensor = noise_pred_tensor;
+            ov::Tensor timestep(ov::element::i64, {1}, &timesteps[inference_step]);
+            ov::Tensor noise_pred_tensor;
+            {
+                ScopedTrace trace("unet infer");
+                noise_pred_tensor = measure(m_perf_metrics.raw_metrics.denoiser_inference_durations, [&] {
+                    return m_unet->infer(latent_model_input, timestep);
+                });
             }
 
-            auto scheduler_step_result = m_scheduler->step(noisy_residual_tensor, latent, inference_step, generation_config.generator);
+            std::map<std::string, ov::Tensor> scheduler_step_result;
+            {
+                ScopedTrace trace("scheduler step");
+                // guidance is either applied by UNet or fused into a scheduler step to avoid an extra pass over noise prediction
+                scheduler_step_result = measure(m_perf_metrics.raw_metrics.scheduler_step_durations, [&] {
+                    return batch_size_multiplier > 1 ?
+                        m_scheduler->step_with_guidance(noise_pred_tensor, generation_config.guidance_scale, latent, inference_step, generation_config.generator) :
+                        m_scheduler->step(noise_pred_tensor, latent, inference_step, generation_config.generator);
+                });
+            }
             latent = scheduler_step_result["latent"];
 
             // in case of non-specialized inpainting model, we need manually mask current denoised latent and initial image latent
@@ -401,18 +542,73 @@ public:
             denoised = it != scheduler_step_result.end() ? it->second : latent;
 
             if (callback && callback(inference_step, timesteps.size(), denoised)) {
-                return ov::Tensor(ov::element::u8, {});
+                return ov::Tensor();
             }
+
+            if (preview_callback) {
+                ov::Tensor preview = decode_preview(denoised);
+                if (preview_callback(inference_step, timesteps.size(), preview)) {
+                    return ov::Tensor();
+                }
+            }
+
+            m_perf_metrics.raw_metrics.iteration_durations.emplace_back(std::chrono::steady_clock::now() - iteration_start);
         }
 
-        return decode(denoised);
+        return denoised;
     }
 
     ov::Tensor decode(const ov::Tensor latent) override {
-        return m_vae->decode(latent);
+        ScopedTrace trace("vae decode");
+        return measure(m_perf_metrics.raw_metrics.vae_decoder_inference_durations, [&] {
+            return m_vae->decode(latent);
+        });
     }
 
 protected:
+    // factors of a linear latent to RGB projection approximating VAE decoder, a row per latent channel followed by bias
+    // see latent_rgb_factors in ComfyUI latent formats
+    virtual std::vector<std::array<float, 3>> get_latent_rgb_factors() const {
+        return {{ 0.3512f,  0.2297f,  0.3227f},
+                { 0.3250f,  0.4974f,  0.2350f},
+                {-0.2829f,  0.1762f,  0.2721f},
+                {-0.2120f, -0.2616f, -0.7177f},
+                { 0.0f,     0.0f,     0.0f   }};
+    }
+
+    // approximates decode() by a linear projection of each latent pixel to RGB
+    ov::Tensor decode_preview(const ov::Tensor latent) const {
+        const std::vector<std::array<float, 3>> factors = get_latent_rgb_factors();
+        const ov::Shape latent_shape = latent.get_shape();
+        const size_t batch_size = latent_shape[0], channels = latent_shape[1], plane_size = latent_shape[2] * latent_shape[3];
+        OPENVINO_ASSERT(channels + 1 == factors.size(), "Preview is not supported for latents with ", channels, " channels");
+
+        ov::Tensor preview(ov::element::u8, {batch_size, latent_shape[2], latent_shape[3], 3});
+        const float* latent_data = latent.data<const float>();
+        uint8_t* preview_data = preview.data<uint8_t>();
+
+        for (size_t b = 0; b < batch_size; ++b, latent_data += channels * plane_size) {
+            for (size_t i = 0; i < plane_size; ++i, preview_data += 3) {
+                std::array<float, 3> rgb = factors[channels];
+                for (size_t c = 0; c < channels; ++c) {
+                    const float value = latent_data[c * plane_size + i];
+                    for (size_t k = 0; k < 3; ++k)
+                        rgb[k] += value * factors[c][k];
+                }
+                // map [-1, 1] to [0, 255] like VAE decoder postprocessing
+                for (size_t k = 0; k < 3; ++k)
+                    preview_data[k] = static_cast<uint8_t>(std::clamp(rgb[k] * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f);
+            }
+        }
+
+        return preview;
+    }
+
+    // Unet accepts 2x batch of samples in case of CFG, unless it duplicates samples in its graph
+    size_t get_sample_batch_size_multiplier(const ImageGenerationConfig& generation_config) const {
+        return m_unet->do_classifier_free_guidance(generation_config.guidance_scale) && !m_unet->has_fused_guidance() ? 2 : 1;
+    }
+
     bool is_inpainting_model() const {
         assert(m_unet != nullptr);
         assert(m_vae != nullptr);
@@ -485,6 +681,7 @@ protected:
         } else if (!is_classifier_free_guidance) {
             OPENVINO_ASSERT(generation_config.negative_prompt == std::nullopt, "Negative prompt is not used when guidance scale <= 1.0");
         }
+        OPENVINO_ASSERT(is_classifier_free_guidance || !m_unet->has_fused_guidance(), "UNet with fused guidance requires guidance scale > 1.0");
         OPENVINO_ASSERT(generation_config.negative_prompt_2 == std::nullopt, "Negative prompt 2 is not used by ", pipeline_name);
         OPENVINO_ASSERT(generation_config.negative_prompt_3 == std::nullopt, "Negative prompt 3 is not used by ", pipeline_name);
 
@@ -33,8 +33,10 @@ public:
         utils::read_json_param(data, "force_zeros_for_empty_prompt", m_force_zeros_for_empty_prompt);
     }
 
-    StableDiffusionXLPipeline(PipelineType pipeline_type, const std::filesystem::path& root_dir, const std::string& device, const ov::AnyMap& properties) :
+    StableDiffusionXLPipeline(PipelineType pipeline_type, const std::filesystem::path& root_dir, const std::string& device, ov::AnyMap properties) :
         StableDiffusionPipeline(pipeline_type) {
+        const size_t vae_encoder_cache_size = extract_vae_encoder_cache_size(properties);
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(properties);
         const std::filesystem::path model_index_path = root_dir / "model_index.json";
         std::ifstream file(model_index_path);
         OPENVINO_ASSERT(file.is_open(), "Failed to open ", model_index_path);
@@ -68,7 +70,7 @@ public:
 
         const std::string unet = data["unet"][1].get<std::string>();
         if (unet == "UNet2DConditionModel") {
-            m_unet = std::make_shared<UNet2DConditionModel>(root_dir / "unet", device, properties);
+            m_unet = std::make_shared<UNet2DConditionModel>(root_dir / "unet", device, denoiser_properties);
         } else {
             OPENVINO_THROW("Unsupported '", unet, "' UNet type");
         }
@@ -86,6 +88,9 @@ public:
                 m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_decoder", device, updated_properties);
             else if (m_pipeline_type == PipelineType::IMAGE_2_IMAGE || m_pipeline_type == PipelineType::INPAINTING) {
                 m_vae = std::make_shared<AutoencoderKL>(root_dir / "vae_encoder", root_dir / "vae_decoder", device, updated_properties);
+                if (vae_encoder_cache_size > 0) {
+                    m_vae->enable_encoder_cache(vae_encoder_cache_size);
+                }
             } else {
                 OPENVINO_ASSERT("Unsupported pipeline type");
             }
@@ -125,9 +130,8 @@ public:
         initialize_generation_config("StableDiffusionXLPipeline");
     }
 
-    void reshape(const int num_images_per_prompt, const int height, const int width, const float guidance_scale) override {
-        check_image_size(height, width);
-
+    // reshape to static image size is handled by the base class in terms of this method
+    void reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) override {
         const size_t batch_size_multiplier = m_unet->do_classifier_free_guidance(guidance_scale) ? 2 : 1;  // Unet accepts 2x batch in case of CFG
         m_clip_text_encoder->reshape(batch_size_multiplier);
         m_clip_text_encoder_with_projection->reshape(batch_size_multiplier);
@@ -136,12 +140,18 @@ public:
     }
 
     void compile(const std::string& device, const ov::AnyMap& properties) override {
-        update_adapters_from_properties(properties, m_generation_config.adapters);
-
-        m_clip_text_encoder->compile(device, properties);
-        m_clip_text_encoder_with_projection->compile(device, properties);
-        m_unet->compile(device, properties);
-        m_vae->compile(device, properties);
+        ov::AnyMap submodel_properties = properties;
+        const size_t vae_encoder_cache_size = extract_vae_encoder_cache_size(submodel_properties);
+        const ov::AnyMap denoiser_properties = extract_denoiser_properties(submodel_properties);
+        update_adapters_from_properties(submodel_properties, m_generation_config.adapters);
+
+        m_clip_text_encoder->compile(device, submodel_properties);
+        m_clip_text_encoder_with_projection->compile(device, submodel_properties);
+        m_unet->compile(device, denoiser_properties);
+        m_vae->compile(device, submodel_properties);
+        if (vae_encoder_cache_size > 0 && m_pipeline_type != PipelineType::TEXT_2_IMAGE) {
+            m_vae->enable_encoder_cache(vae_encoder_cache_size);
+        }
     }
 
     void compute_hidden_states(const std::string& positive_prompt, const ImageGenerationConfig& generation_config) override {
@@ -177,8 +187,12 @@ public:
         ov::Tensor encoder_hidden_states(ov::element::f32, {}), add_text_embeds(ov::element::f32, {});
 
         if (compute_negative_prompt) {
-            add_text_embeds = m_clip_text_encoder_with_projection->infer(positive_prompt, negative_prompt_1_str, batch_size_multiplier > 1);
-            m_clip_text_encoder->infer(prompt_2_str, negative_prompt_2_str, batch_size_multiplier > 1);
+            add_text_embeds = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder_2"], [&] {
+                return m_clip_text_encoder_with_projection->infer(positive_prompt, negative_prompt_1_str, batch_size_multiplier > 1);
+            });
+            measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+                return m_clip_text_encoder->infer(prompt_2_str, negative_prompt_2_str, batch_size_multiplier > 1);
+            });
 
             // prompt_embeds = prompt_embeds.hidden_states[-2]
             ov::Tensor encoder_hidden_states_1 = m_clip_text_encoder->get_output_tensor(idx_hidden_state_1);
@@ -186,8 +200,12 @@ public:
 
             encoder_hidden_states = numpy_utils::concat(encoder_hidden_states_1, encoder_hidden_states_2, -1);
         } else {
-            ov::Tensor add_text_embeds_positive = m_clip_text_encoder_with_projection->infer(positive_prompt, negative_prompt_1_str, false);
-            m_clip_text_encoder->infer(prompt_2_str, negative_prompt_2_str, false);
+            ov::Tensor add_text_embeds_positive = measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder_2"], [&] {
+                return m_clip_text_encoder_with_projection->infer(positive_prompt, negative_prompt_1_str, false);
+            });
+            measure(m_perf_metrics.raw_metrics.text_encoder_inference_durations["text_encoder"], [&] {
+                return m_clip_text_encoder->infer(prompt_2_str, negative_prompt_2_str, false);
+            });
 
             ov::Tensor encoder_hidden_states_1_positive = m_clip_text_encoder->get_output_tensor(idx_hidden_state_1);
             ov::Tensor encoder_hidden_states_2_positive = m_clip_text_encoder_with_projection->get_output_tensor(idx_hidden_state_2);
@@ -287,12 +305,26 @@ public:
         }
     }
 
+    ov::Tensor generate_batch(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) override {
+        OPENVINO_ASSERT(positive_prompts.size() == 1, "Generation for a batch of prompts is not supported by Stable Diffusion XL");
+        return generate(positive_prompts[0], {}, {}, properties);
+    }
+
     void set_lora_adapters(std::optional<AdapterConfig> adapters) override {
         m_clip_text_encoder->set_adapters(adapters);
         m_clip_text_encoder_with_projection->set_adapters(adapters);
         m_unet->set_adapters(adapters);
     }
 
+protected:
+    std::vector<std::array<float, 3>> get_latent_rgb_factors() const override {
+        return {{ 0.3651f,  0.4232f,  0.4341f},
+                {-0.2533f, -0.0042f,  0.1068f},
+                { 0.1076f,  0.1111f, -0.0362f},
+                {-0.3165f, -0.2492f, -0.2188f},
+                { 0.1084f, -0.0175f, -0.0011f}};
+    }
+
 private:
     void initialize_generation_config(const std::string& class_name) override {
         assert(m_unet != nullptr);
@@ -336,6 +368,7 @@ private:
         OPENVINO_ASSERT(generation_config.prompt_3 == std::nullopt, "Prompt 3 is not used by ", pipeline_name);
         OPENVINO_ASSERT(is_classifier_free_guidance || generation_config.negative_prompt == std::nullopt, "Negative prompt is not used when guidance scale <= 1.0");
         OPENVINO_ASSERT(is_classifier_free_guidance || generation_config.negative_prompt_2 == std::nullopt, "Negative prompt 2 is not used when guidance scale <= 1.0");
+        OPENVINO_ASSERT(is_classifier_free_guidance || !m_unet->has_fused_guidance(), "UNet with fused guidance requires guidance scale > 1.0");
         OPENVINO_ASSERT(generation_config.negative_prompt_3 == std::nullopt, "Negative prompt 3 is not used by ", pipeline_name);
 
         if ((m_pipeline_type == PipelineType::IMAGE_2_IMAGE || m_pipeline_type == PipelineType::INPAINTING) && initial_image) {
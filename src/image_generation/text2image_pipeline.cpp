@@ -1,6 +1,7 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
 #include <filesystem>
@@ -18,6 +19,7 @@ namespace ov {
 namespace genai {
 
 Text2ImagePipeline::Text2ImagePipeline(const std::filesystem::path& root_dir) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" || 
@@ -32,9 +34,11 @@ Text2ImagePipeline::Text2ImagePipeline(const std::filesystem::path& root_dir) {
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 Text2ImagePipeline::Text2ImagePipeline(const std::filesystem::path& root_dir, const std::string& device, const ov::AnyMap& properties) {
+    const auto load_start = std::chrono::steady_clock::now();
     const std::string class_name = get_class_name(root_dir);
 
     if (class_name == "StableDiffusionPipeline" ||
@@ -49,6 +53,7 @@ Text2ImagePipeline::Text2ImagePipeline(const std::filesystem::path& root_dir, co
     } else {
         OPENVINO_THROW("Unsupported text to image generation pipeline '", class_name, "'");
     }
+    m_impl->set_load_time(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - load_start).count());
 }
 
 Text2ImagePipeline::Text2ImagePipeline(const Image2ImagePipeline& pipe) {
@@ -181,17 +186,46 @@ void Text2ImagePipeline::reshape(const int num_images_per_prompt, const int heig
     m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
 }
 
+void Text2ImagePipeline::reshape(const int num_images_per_prompt, const ov::Dimension& height, const ov::Dimension& width, const float guidance_scale) {
+    m_impl->reshape(num_images_per_prompt, height, width, guidance_scale);
+}
+
 void Text2ImagePipeline::compile(const std::string& device, const ov::AnyMap& properties) {
     m_impl->compile(device, properties);
 }
 
 ov::Tensor Text2ImagePipeline::generate(const std::string& positive_prompt, const ov::AnyMap& properties) {
-    return m_impl->generate(positive_prompt, {}, {}, properties);
+    return m_impl->measure_generation([&] {
+        return m_impl->generate(positive_prompt, {}, {}, properties);
+    });
+}
+
+void Text2ImagePipeline::warmup(const ov::AnyMap& properties) {
+    ov::AnyMap warmup_properties = properties;
+    // a denoising step runs the same shapes as all the others
+    warmup_properties.insert(ov::genai::num_inference_steps(1));
+    m_impl->generate("Warmup", {}, {}, warmup_properties);
+}
+
+ov::Tensor Text2ImagePipeline::generate(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) {
+    return m_impl->measure_generation([&] {
+        return m_impl->generate_batch(positive_prompts, properties);
+    });
+}
+
+std::vector<ov::Tensor> Text2ImagePipeline::generate_pipelined(const std::vector<std::string>& positive_prompts, const ov::AnyMap& properties) {
+    return m_impl->measure_generation([&] {
+        return m_impl->generate_pipelined(positive_prompts, properties);
+    });
 }
 
 ov::Tensor Text2ImagePipeline::decode(const ov::Tensor latent) {
     return m_impl->decode(latent);
 }
 
+ImageGenerationPerfMetrics Text2ImagePipeline::get_performance_metrics() {
+    return m_impl->get_performance_metrics();
+}
+
 }  // namespace genai
 }  // namespace ov
@@ -0,0 +1,85 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+/**
+ * Memory budget for KV caches of several pipelines growing on demand, e.g. main and draft pipelines of speculative decoding.
+ * Instead of a fixed split, each pipeline reserves memory from the common budget when it grows its KV cache and returns it
+ * when it shrinks. A pipeline, which could not reserve enough memory, records its demand, so that other pipelines release
+ * unused blocks to it. Methods can be called from several threads at once.
+ */
+class KVCacheBudget {
+    std::mutex m_mutex;
+    size_t m_total_bytes;
+    size_t m_used_bytes = 0;
+    // number of bytes, which a consumer needed but failed to reserve at its last attempt
+    std::map<size_t, size_t> m_missing_bytes;
+
+public:
+    /**
+     * @param total_bytes Total size of all KV caches sharing the budget.
+     */
+    explicit KVCacheBudget(size_t total_bytes) : m_total_bytes(total_bytes) {}
+
+    /**
+     * Reserves up to max_bytes, but no more than currently available. If less than min_bytes is available, the shortage
+     * is recorded as demand of the consumer until its next reservation.
+     * @param consumer_id ID of a pipeline reserving memory.
+     * @param min_bytes Number of bytes the consumer needs to proceed without preemption.
+     * @param max_bytes Number of bytes the consumer would like to reserve.
+     * @param granularity Reserved number of bytes is a multiple of this value, e.g. the size of a KV cache block.
+     * @return Number of reserved bytes.
+     */
+    size_t reserve(size_t consumer_id, size_t min_bytes, size_t max_bytes, size_t granularity) {
+        OPENVINO_ASSERT(granularity > 0, "Granularity of KV cache budget reservation must be non-zero");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t reserved_bytes = std::min(max_bytes, m_total_bytes - m_used_bytes) / granularity * granularity;
+        m_used_bytes += reserved_bytes;
+        m_missing_bytes[consumer_id] = min_bytes > reserved_bytes ? min_bytes - reserved_bytes : 0;
+        return reserved_bytes;
+    }
+
+    /**
+     * Returns memory, which is not used by the consumer anymore, to the budget.
+     */
+    void release(size_t bytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        OPENVINO_ASSERT(bytes <= m_used_bytes, "Released ", bytes, " bytes of KV cache budget, while only ", m_used_bytes, " are reserved");
+        m_used_bytes -= bytes;
+    }
+
+    /**
+     * Clears demand of the consumer, once it does not need more memory.
+     */
+    void reset_demand(size_t consumer_id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_missing_bytes[consumer_id] = 0;
+    }
+
+    /**
+     * @return Number of bytes, which other consumers failed to reserve and the given consumer should release if possible.
+     */
+    size_t get_demand_of_others(size_t consumer_id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t missing_bytes = 0;
+        for (const auto& [id, bytes] : m_missing_bytes) {
+            if (id != consumer_id)
+                missing_bytes += bytes;
+        }
+        // memory which is already free is reserved by the demanding consumers themselves
+        size_t free_bytes = m_total_bytes - m_used_bytes;
+        return missing_bytes > free_bytes ? missing_bytes - free_bytes : 0;
+    }
+};
+
+}
@@ -15,15 +15,85 @@
 #include "llm_pipeline_static.hpp"
 #include "utils.hpp"
 #include "text_callback_streamer.hpp"
+#include "threaded_streamer.hpp"
+#include "cancellable_streamer.hpp"
 #include "openvino/genai/lora_adapter.hpp"
 #include "lora_helper.hpp"
 #include "speculative_decoding/speculative_decoding_impl.hpp"
 #include "sampler.hpp"
 #include "lm_encoding.hpp"
+#include "prefix_state_cache.hpp"
 
 namespace ov {
 namespace genai {
 
+struct ChatSnapshot::State {
+    struct KVCacheVariable {
+        std::string name;
+        // original element type of the variable, the data may be stored in a compressed type
+        ov::element::Type element_type;
+        ov::Tensor data;
+    };
+
+    ChatHistory history;
+    std::string templated_chat_history;
+    std::vector<int64_t> tokenized_chat_history;
+    utils::GenerationChatInputsType chat_input_type = utils::GenerationChatInputsType::UNDEF;
+    bool trust_encoded_history = true;
+    std::optional<int64_t> last_disappeared_token;
+    utils::HistoryRemoveManager kv_history_manager = {0, 0};
+    std::vector<KVCacheVariable> kv_cache;
+    // attention mask of the last inference, whose length is the length of KV cache
+    ov::Tensor attention_mask;
+};
+
+ChatSnapshot::ChatSnapshot(std::shared_ptr<const State> state) : m_state(std::move(state)) {}
+
+bool ChatSnapshot::empty() const {
+    return m_state == nullptr;
+}
+
+size_t ChatSnapshot::get_byte_size() const {
+    size_t byte_size = 0;
+    if (m_state) {
+        for (const auto& variable : m_state->kv_cache)
+            byte_size += variable.data.get_byte_size();
+    }
+    return byte_size;
+}
+
+namespace {
+
+ov::Tensor copy_to_host(const ov::Tensor& tensor) {
+    ov::Tensor host_tensor(tensor.get_element_type(), tensor.get_shape());
+    tensor.copy_to(host_tensor);
+    return host_tensor;
+}
+
+// stores f32 KV cache in f16 if compression is requested, other types are stored as is
+ov::Tensor save_kv_cache_variable(const ov::Tensor& kv_cache, bool compress) {
+    ov::Tensor host_kv_cache = copy_to_host(kv_cache);
+    if (!compress || host_kv_cache.get_element_type() != ov::element::f32)
+        return host_kv_cache;
+    ov::Tensor compressed_kv_cache(ov::element::f16, host_kv_cache.get_shape());
+    std::transform(host_kv_cache.data<const float>(), host_kv_cache.data<const float>() + host_kv_cache.get_size(),
+                   compressed_kv_cache.data<ov::float16>(), [] (float value) { return ov::float16(value); });
+    return compressed_kv_cache;
+}
+
+ov::Tensor restore_kv_cache_variable(const ov::Tensor& data, ov::element::Type element_type) {
+    if (data.get_element_type() == element_type)
+        return copy_to_host(data);
+    OPENVINO_ASSERT(data.get_element_type() == ov::element::f16 && element_type == ov::element::f32,
+                    "Unexpected element type ", data.get_element_type(), " of KV cache in chat snapshot");
+    ov::Tensor kv_cache(element_type, data.get_shape());
+    std::transform(data.data<const ov::float16>(), data.data<const ov::float16>() + data.get_size(), kv_cache.data<float>(),
+                   [] (ov::float16 value) { return static_cast<float>(value); });
+    return kv_cache;
+}
+
+}  // namespace
+
 class StatefulLLMPipeline final : public LLMPipelineImplBase {
 public:
     ov::InferRequest m_model_runner;
@@ -41,6 +111,14 @@ public:
     // If we use beam search sampling with chat mode we need to remove last answer of the model from kv cache and add best answer to history 
     // so, let's keep info about amount of tokens to trim from kv cache and amount of tokens to keep in history
     ov::genai::utils::HistoryRemoveManager m_kv_history_manager = {0, 0};
+    // whether chat turns tokenize only the new part of the templated history, see ov::genai::incremental_chat
+    bool m_is_incremental_chat = false;
+    // maximum number of prompt tokens per inference, 0 if a prompt is inferred at once, see ov::genai::prefill_chunk_size
+    size_t m_prefill_chunk_size = 0;
+    // KV cache states of previous prompts outside of chat, see ov::genai::prefix_state_cache_size
+    std::optional<PrefixStateCache> m_prefix_state_cache;
+    // kept alive, so that other pipelines reuse it, see ov::genai::share_compiled_model
+    std::shared_ptr<ov::CompiledModel> m_compiled_model;
 
     StatefulLLMPipeline(
         const ov::InferRequest& request,
@@ -75,14 +153,44 @@ public:
         ov::Core core;
         ov::CompiledModel compiled_model;
         auto [core_plugin_config, plugin_config] = ov::genai::utils::split_core_compile_config(config);
+        if (plugin_config.find(ov::genai::incremental_chat.name()) != plugin_config.end()) {
+            m_is_incremental_chat = plugin_config.at(ov::genai::incremental_chat.name()).as<bool>();
+            plugin_config.erase(ov::genai::incremental_chat.name());
+        }
+        if (plugin_config.find(ov::genai::prefill_chunk_size.name()) != plugin_config.end()) {
+            m_prefill_chunk_size = plugin_config.at(ov::genai::prefill_chunk_size.name()).as<size_t>();
+            plugin_config.erase(ov::genai::prefill_chunk_size.name());
+        }
+        size_t prefix_state_cache_capacity = 0;
+        if (plugin_config.find(ov::genai::prefix_state_cache_size.name()) != plugin_config.end()) {
+            prefix_state_cache_capacity = plugin_config.at(ov::genai::prefix_state_cache_size.name()).as<size_t>();
+            plugin_config.erase(ov::genai::prefix_state_cache_size.name());
+        }
+        bool share_compiled_model = false;
+        if (plugin_config.find(ov::genai::share_compiled_model.name()) != plugin_config.end()) {
+            share_compiled_model = plugin_config.at(ov::genai::share_compiled_model.name()).as<bool>();
+            plugin_config.erase(ov::genai::share_compiled_model.name());
+        }
+        if (plugin_config.find(ov::genai::max_concurrent_generations.name()) != plugin_config.end()) {
+            m_max_concurrent_generations = plugin_config.at(ov::genai::max_concurrent_generations.name()).as<size_t>();
+            OPENVINO_ASSERT(m_max_concurrent_generations > 0, "max_concurrent_generations must be positive");
+            plugin_config.erase(ov::genai::max_concurrent_generations.name());
+        }
         utils::slice_matmul_statefull_model(model);
         m_kv_cache_seq_length_axis = ov::genai::utils::get_seq_len_axis(model);
+        if (prefix_state_cache_capacity > 0)
+            m_prefix_state_cache.emplace(prefix_state_cache_capacity, m_kv_cache_seq_length_axis);
 
         if (auto filtered_plugin_config = extract_adapters_from_properties(plugin_config, &m_generation_config.adapters)) {
             m_generation_config.adapters->set_tensor_name_prefix("base_model.model.model.");
             m_adapter_controller = AdapterController(model, *m_generation_config.adapters, device);   // TODO: Make the prefix name configurable
+            OPENVINO_ASSERT(m_max_concurrent_generations == 1, "max_concurrent_generations is not supported with LoRA adapters");
             compiled_model = core.compile_model(model, device, *filtered_plugin_config);
             m_model_runner = compiled_model.create_infer_request();
+        } else if (share_compiled_model) {
+            m_compiled_model = utils::compile_shared_model(core, model, device, plugin_config);
+            compiled_model = *m_compiled_model;
+            m_model_runner = compiled_model.create_infer_request();
         } else {
             compiled_model = core.compile_model(model, device, plugin_config);
             m_model_runner = compiled_model.create_infer_request();
@@ -102,6 +210,18 @@ public:
         const ov::AnyMap& plugin_config
     ) : StatefulLLMPipeline{models_path, Tokenizer(models_path), device, plugin_config} {}
 
+    // shares the compiled model and settings of the pipeline, but not its KV cache and chat, see create_concurrent_pipeline()
+    StatefulLLMPipeline(
+        const StatefulLLMPipeline& pipeline,
+        const ov::InferRequest& request
+    ) : LLMPipelineImplBase(pipeline.m_tokenizer, pipeline.m_generation_config),
+        m_model_runner(request),
+        m_sampler(m_tokenizer) {
+        m_kv_cache_seq_length_axis = pipeline.m_kv_cache_seq_length_axis;
+        m_prefill_chunk_size = pipeline.m_prefill_chunk_size;
+        m_sampler.set_seed(m_generation_config.rng_seed);
+    }
+
     DecodedResults generate(
         StringInputs inputs,
         OptionalGenerationConfig generation_config,
@@ -142,55 +262,66 @@ public:
                 m_history.push_back({{"role", "user"}, {"content", prompt}});
                 constexpr bool add_generation_prompt = true;
                 auto new_templated_chat_history  = m_tokenizer.apply_chat_template(m_history, add_generation_prompt);
-                // Do not add special tokens in chat scenario to be aligned with HF.
-                auto new_chat_tokens = m_tokenizer.encode(new_templated_chat_history, ov::genai::add_special_tokens(false));
-                auto prev_chat_tokens = m_tokenizer.encode(m_templated_chat_history, ov::genai::add_special_tokens(false));
-
-                // some symbols combinations can be encoded by the tokenizer in different ways
-                // if we met sequence with such combination of symbols, we cannot correctly subtract the new history from the old history
-                // so let's check it out, find the trusted part and use it in on the next step
-                size_t trusted_history_length = 0;
-                if (!m_tokenized_chat_history.empty()) {
-                    std::set<int64_t> stop_tokens = config.stop_token_ids;
-                    trusted_history_length = ov::genai::utils::get_first_history_difference(prev_chat_tokens.input_ids, m_tokenized_chat_history, stop_tokens);
-                    m_trust_encoded_history = trusted_history_length == SIZE_MAX;
-                }
 
-                if (m_tokenized_chat_history.empty()) {
-                    encoded_input = new_chat_tokens;
-                } else if (trusted_history_length != SIZE_MAX || m_kv_history_manager.does_kv_cache_need_to_update()) {
-                    // does_kv_cache_need_to_update will be true here if beam search is activated
-                    // in beam search mode we want to remove all history about last model answer from kv cache and add the best answer directly
-                    // if we have difference in model answer and decoded answer it anyway will be less then entire history, so let's use data from m_kv_history_manager
-                    if (m_kv_history_manager.does_kv_cache_need_to_update()) {
-                        trusted_history_length = m_kv_history_manager.trusted_history_length;
-                    } else {
-                        m_kv_history_manager.num_tokens_to_remove_from_kv_cache = m_tokenized_chat_history.size() - trusted_history_length;
-                        // if prev generation was finished because of max len was reached, kv cache is missed one last token, let's keep it
-                        m_kv_history_manager.num_tokens_to_remove_from_kv_cache -= m_last_disappeared_token.has_value() ? 1 : 0;
+                // KV cache holds generated tokens as is, so in incremental mode only the tail added to the templated history is tokenized
+                // and appended, if the template keeps previous turns unchanged and the last answer does not need to be replaced
+                if (m_is_incremental_chat && !m_tokenized_chat_history.empty() && !m_kv_history_manager.does_kv_cache_need_to_update() &&
+                    new_templated_chat_history.compare(0, m_templated_chat_history.size(), m_templated_chat_history) == 0) {
+                    encoded_input = m_tokenizer.encode(new_templated_chat_history.substr(m_templated_chat_history.size()), ov::genai::add_special_tokens(false));
+                    m_templated_chat_history = new_templated_chat_history;
+                    std::copy_n(encoded_input.input_ids.data<int64_t>(), encoded_input.input_ids.get_size(),
+                                std::back_inserter(m_tokenized_chat_history));
+                } else {
+                    // Do not add special tokens in chat scenario to be aligned with HF.
+                    auto new_chat_tokens = m_tokenizer.encode(new_templated_chat_history, ov::genai::add_special_tokens(false));
+                    auto prev_chat_tokens = m_tokenizer.encode(m_templated_chat_history, ov::genai::add_special_tokens(false));
+
+                    // some symbols combinations can be encoded by the tokenizer in different ways
+                    // if we met sequence with such combination of symbols, we cannot correctly subtract the new history from the old history
+                    // so let's check it out, find the trusted part and use it in on the next step
+                    size_t trusted_history_length = 0;
+                    if (!m_tokenized_chat_history.empty()) {
+                        std::set<int64_t> stop_tokens = config.stop_token_ids;
+                        trusted_history_length = ov::genai::utils::get_first_history_difference(prev_chat_tokens.input_ids, m_tokenized_chat_history, stop_tokens);
+                        m_trust_encoded_history = trusted_history_length == SIZE_MAX;
                     }
 
-                    ov::Tensor new_tensor = ov::Tensor(new_chat_tokens.input_ids.get_element_type(),
-                                                       {1, new_chat_tokens.input_ids.get_shape().at(1) - trusted_history_length},
-                                                       new_chat_tokens.input_ids.data<int64_t>() + trusted_history_length);
+                    if (m_tokenized_chat_history.empty()) {
+                        encoded_input = new_chat_tokens;
+                    } else if (trusted_history_length != SIZE_MAX || m_kv_history_manager.does_kv_cache_need_to_update()) {
+                        // does_kv_cache_need_to_update will be true here if beam search is activated
+                        // in beam search mode we want to remove all history about last model answer from kv cache and add the best answer directly
+                        // if we have difference in model answer and decoded answer it anyway will be less then entire history, so let's use data from m_kv_history_manager
+                        if (m_kv_history_manager.does_kv_cache_need_to_update()) {
+                            trusted_history_length = m_kv_history_manager.trusted_history_length;
+                        } else {
+                            m_kv_history_manager.num_tokens_to_remove_from_kv_cache = m_tokenized_chat_history.size() - trusted_history_length;
+                            // if prev generation was finished because of max len was reached, kv cache is missed one last token, let's keep it
+                            m_kv_history_manager.num_tokens_to_remove_from_kv_cache -= m_last_disappeared_token.has_value() ? 1 : 0;
+                        }
 
-                    ov::Tensor new_attention_mask(ov::element::i64, new_tensor.get_shape());
-                    std::fill_n(new_attention_mask.data<int64_t>(), new_tensor.get_shape()[1], 1);
+                        ov::Tensor new_tensor = ov::Tensor(new_chat_tokens.input_ids.get_element_type(),
+                                                           {1, new_chat_tokens.input_ids.get_shape().at(1) - trusted_history_length},
+                                                           new_chat_tokens.input_ids.data<int64_t>() + trusted_history_length);
 
-                    encoded_input.input_ids = ov::Tensor(new_chat_tokens.input_ids.get_element_type(),
-                                                       {1, new_chat_tokens.input_ids.get_shape().at(1) - trusted_history_length});
-                    new_tensor.copy_to(encoded_input.input_ids);
-                    encoded_input.attention_mask = new_attention_mask;
-                    m_last_disappeared_token = std::nullopt;
-                } else {
-                    encoded_input = utils::subtract_chat_tokenized_inputs(new_chat_tokens, prev_chat_tokens);
-                }
-                m_templated_chat_history = new_templated_chat_history;
+                        ov::Tensor new_attention_mask(ov::element::i64, new_tensor.get_shape());
+                        std::fill_n(new_attention_mask.data<int64_t>(), new_tensor.get_shape()[1], 1);
 
-                m_tokenized_chat_history.clear();
-                m_tokenized_chat_history.reserve(new_chat_tokens.input_ids.get_size());
-                std::copy_n(new_chat_tokens.input_ids.data<int64_t>(), new_chat_tokens.input_ids.get_size(),
-                            std::back_inserter(m_tokenized_chat_history));
+                        encoded_input.input_ids = ov::Tensor(new_chat_tokens.input_ids.get_element_type(),
+                                                           {1, new_chat_tokens.input_ids.get_shape().at(1) - trusted_history_length});
+                        new_tensor.copy_to(encoded_input.input_ids);
+                        encoded_input.attention_mask = new_attention_mask;
+                        m_last_disappeared_token = std::nullopt;
+                    } else {
+                        encoded_input = utils::subtract_chat_tokenized_inputs(new_chat_tokens, prev_chat_tokens);
+                    }
+                    m_templated_chat_history = new_templated_chat_history;
+
+                    m_tokenized_chat_history.clear();
+                    m_tokenized_chat_history.reserve(new_chat_tokens.input_ids.get_size());
+                    std::copy_n(new_chat_tokens.input_ids.data<int64_t>(), new_chat_tokens.input_ids.get_size(),
+                                std::back_inserter(m_tokenized_chat_history));
+                }
 
                 // TODO: Forbid LoRA config change if we are in the chat mode, because it requires regenerating the history with LoRA applied
             } else {
@@ -298,6 +429,10 @@ public:
             (config.is_greedy_decoding() || config.is_multinomial()),
             "Currently streaming is possible only with batch size=1 and only for greedy or multinomial decoding");
 
+        if (streamer_ptr && config.streamer_queue_size > 0) {
+            streamer_ptr = std::make_shared<ThreadedStreamer>(streamer_ptr, config.streamer_queue_size);
+        }
+
         auto num_inputs = m_model_runner.get_compiled_model().inputs().size();
         OPENVINO_ASSERT(num_inputs == 4 || num_inputs == 3, "Model should have 3 or 4 inputs: "
                         "either (input_ids, attention_mask, beam_idx) or "
@@ -329,6 +464,28 @@ public:
             concatenated_attention_mask = attention_mask;
         }
 
+        // outside of chat KV cache is empty, so a cached state of a prompt sharing a prefix with the new one is restored, and only
+        // the rest of the prompt is inferred; states of adapters are not cached, and beam search may reorder the prompt state
+        std::vector<int64_t> prompt_ids;
+        const bool use_prefix_state_cache = m_prefix_state_cache && !is_chat_conversation && !m_adapter_controller && batch_size == 1 &&
+            !config.is_beam_search() && config.num_return_sequences == 1 &&
+            std::all_of(attention_mask.data<const int64_t>(), attention_mask.data<const int64_t>() + attention_mask.get_size(), [] (int64_t value) {
+                return value == 1;
+            });
+        if (use_prefix_state_cache) {
+            prompt_ids.assign(input_ids.data<const int64_t>(), input_ids.data<const int64_t>() + input_ids.get_size());
+            size_t num_cached_tokens = m_prefix_state_cache->restore(m_model_runner, prompt_ids);
+            if (num_cached_tokens > 0) {
+                kv_cache_len = num_cached_tokens;
+                input_ids = ov::Tensor(ov::element::i64, {1, prompt_ids.size() - num_cached_tokens});
+                std::copy(prompt_ids.begin() + num_cached_tokens, prompt_ids.end(), input_ids.data<int64_t>());
+                attention_mask = ov::Tensor(ov::element::i64, input_ids.get_shape());
+                std::fill_n(attention_mask.data<int64_t>(), attention_mask.get_size(), 1);
+                concatenated_attention_mask = ov::Tensor(ov::element::i64, {1, prompt_ids.size()});
+                std::fill_n(concatenated_attention_mask.data<int64_t>(), concatenated_attention_mask.get_size(), 1);
+            }
+        }
+
         size_t prev_attn_mask_size = concatenated_attention_mask.get_shape()[1];
 
         bool position_ids_available = (num_inputs == 4);
@@ -356,6 +513,8 @@ public:
             if (is_chat_conversation) {
                 ov::Tensor tokenized_chat_history = ov::Tensor(ov::element::i64, {1, m_tokenized_chat_history.size()}, m_tokenized_chat_history.data());
                 sequence_group = std::make_shared<SequenceGroup>(request_id, tokenized_chat_history, config, block_size, enable_prefix_caching);
+            } else if (use_prefix_state_cache) {
+                sequence_group = std::make_shared<SequenceGroup>(request_id, prompt_ids, config, block_size, enable_prefix_caching);
             } else {
                 size_t seq_len = input_ids.get_shape().at(1);
                 size_t batch_offset = request_id * seq_len;
@@ -375,17 +534,30 @@ public:
 
         ov::genai::EncodedResults result;
         std::tie(result, m_last_disappeared_token) = ov::genai::get_lm_encoded_results(m_model_runner, input_ids, concatenated_attention_mask,
-                                                                                       streamer_ptr, m_sampler, requests, position_ids, std::nullopt);
+                                                                                       streamer_ptr, m_sampler, requests, position_ids, std::nullopt,
+                                                                                       m_prefill_chunk_size);
 
         if (is_chat_conversation) {
+            const size_t num_answer_tokens_in_kv_cache = m_model_runner.get_tensor("attention_mask").get_shape()[1] - prev_attn_mask_size;
+            // the last generated token is not fed to the model, it gets to KV cache with the next prompt only if it is kept
+            // as m_last_disappeared_token, e.g. EOS is not kept, so history holds the same tokens as KV cache
+            const size_t num_kept_answer_tokens = num_answer_tokens_in_kv_cache + (m_last_disappeared_token.has_value() ? 1 : 0);
             // force remove from kv_cache last answer
-            if (config.is_beam_search() && m_chat_input_type != ov::genai::utils::GenerationChatInputsType::ENCODED_INPUTS) {
+            if ((config.is_beam_search() || num_kept_answer_tokens > result.tokens[0].size()) &&
+                m_chat_input_type != ov::genai::utils::GenerationChatInputsType::ENCODED_INPUTS) {
+                // tokens of a matched stop string are removed from the answer, but not from KV cache
                 m_kv_history_manager.trusted_history_length = m_tokenized_chat_history.size();
-                m_kv_history_manager.num_tokens_to_remove_from_kv_cache = m_model_runner.get_tensor("attention_mask").get_shape()[1] - prev_attn_mask_size;
+                m_kv_history_manager.num_tokens_to_remove_from_kv_cache = num_answer_tokens_in_kv_cache;
+                std::copy(result.tokens[0].begin(), result.tokens[0].end(), std::back_inserter(m_tokenized_chat_history));
+            } else {
+                std::copy_n(result.tokens[0].begin(), std::min(num_kept_answer_tokens, result.tokens[0].size()),
+                            std::back_inserter(m_tokenized_chat_history));
+                // KV cache was trimmed before this generation, if it was needed
+                m_kv_history_manager.reset();
             }
-
-            std::copy(result.tokens[0].begin(), result.tokens[0].end(), std::back_inserter(m_tokenized_chat_history));
         } else {
+            if (use_prefix_state_cache)
+                m_prefix_state_cache->store(m_model_runner, prompt_ids);
             reset_kv_state();
             m_last_disappeared_token = std::nullopt;
         }
@@ -425,6 +597,61 @@ public:
         m_templated_chat_history = m_tokenizer.apply_chat_template(m_history, add_generation_prompt);
     }
 
+    void start_chat(const ChatSnapshot& snapshot) override {
+        OPENVINO_ASSERT(!snapshot.empty(), "Chat cannot be started from an empty snapshot");
+        const ChatSnapshot::State& state = *snapshot.get_state();
+        reset_kv_state();
+
+        is_chat_conversation = true;
+        m_history = state.history;
+        m_templated_chat_history = state.templated_chat_history;
+        m_tokenized_chat_history = state.tokenized_chat_history;
+        m_chat_input_type = state.chat_input_type;
+        m_trust_encoded_history = state.trust_encoded_history;
+        m_last_disappeared_token = state.last_disappeared_token;
+        m_kv_history_manager = state.kv_history_manager;
+        if (state.kv_cache.empty())
+            return;
+
+        size_t num_restored_variables = 0;
+        for (auto& variable : m_model_runner.query_state()) {
+            if (m_adapter_controller && m_adapter_controller->has_state_name(variable.get_name()))
+                continue;
+            auto it = std::find_if(state.kv_cache.begin(), state.kv_cache.end(), [&variable] (const ChatSnapshot::State::KVCacheVariable& saved) {
+                return saved.name == variable.get_name();
+            });
+            OPENVINO_ASSERT(it != state.kv_cache.end(), "KV cache variable ", variable.get_name(), " is missing in chat snapshot, "
+                            "which was saved by a pipeline with another model");
+            variable.set_state(restore_kv_cache_variable(it->data, it->element_type));
+            ++num_restored_variables;
+        }
+        OPENVINO_ASSERT(num_restored_variables == state.kv_cache.size(), "Chat snapshot was saved by a pipeline with another model");
+        m_model_runner.set_tensor("attention_mask", copy_to_host(state.attention_mask));
+    }
+
+    ChatSnapshot save_chat(bool compress_kv_cache) override {
+        OPENVINO_ASSERT(is_chat_conversation, "Chat can be saved only between start_chat() and finish_chat()");
+        auto state = std::make_shared<ChatSnapshot::State>();
+        state->history = m_history;
+        state->templated_chat_history = m_templated_chat_history;
+        state->tokenized_chat_history = m_tokenized_chat_history;
+        state->chat_input_type = m_chat_input_type;
+        state->trust_encoded_history = m_trust_encoded_history;
+        state->last_disappeared_token = m_last_disappeared_token;
+        state->kv_history_manager = m_kv_history_manager;
+        // KV cache is filled by the first generate call of the chat
+        if (!m_tokenized_chat_history.empty()) {
+            for (auto& variable : m_model_runner.query_state()) {
+                if (m_adapter_controller && m_adapter_controller->has_state_name(variable.get_name()))
+                    continue;
+                ov::Tensor kv_cache = variable.get_state();
+                state->kv_cache.push_back({variable.get_name(), kv_cache.get_element_type(), save_kv_cache_variable(kv_cache, compress_kv_cache)});
+            }
+            state->attention_mask = copy_to_host(m_model_runner.get_tensor("attention_mask"));
+        }
+        return ChatSnapshot(state);
+    }
+
     void finish_chat() override {
         is_chat_conversation = false;
         m_trust_encoded_history = true;
@@ -438,6 +665,31 @@ public:
             m_tokenized_chat_history.clear();
         }
     }
+
+    void warmup(const WarmupConfig& config) override {
+        OPENVINO_ASSERT(!is_chat_conversation, "warmup() cannot be called during a chat");
+        LLMPipelineImplBase::warmup(config);
+    }
+
+    GenerationFuture<DecodedResults> generate_async(
+        StringInputs inputs,
+        const GenerationConfig& generation_config,
+        const StreamerVariant& streamer,
+        std::function<void(GenerationFuture<DecodedResults>)> on_completion
+    ) override {
+        OPENVINO_ASSERT(!is_chat_conversation, "generate_async() cannot be called during a chat");
+        return LLMPipelineImplBase::generate_async(std::move(inputs), generation_config, streamer, std::move(on_completion));
+    }
+
+    bool is_concurrent_generate_enabled() const override {
+        // chat keeps its history in KV cache of this pipeline
+        return m_max_concurrent_generations > 1 && !is_chat_conversation;
+    }
+
+protected:
+    std::unique_ptr<LLMPipelineImplBase> create_concurrent_pipeline() override {
+        return std::make_unique<StatefulLLMPipeline>(*this, m_model_runner.get_compiled_model().create_infer_request());
+    }
 };
 
 DecodedResults LLMPipeline::generate(
@@ -445,6 +697,8 @@ DecodedResults LLMPipeline::generate(
         OptionalGenerationConfig generation_config,
         StreamerVariant streamer
 ) {
+    if (m_pimpl->is_concurrent_generate_enabled())
+        return m_pimpl->generate_concurrently(inputs, generation_config, streamer);
     return m_pimpl->generate(inputs, generation_config, streamer);
 }
 
@@ -453,7 +707,7 @@ DecodedResults LLMPipeline::generate(StringInputs text, const ov::AnyMap& config
     GenerationConfig config = (config_arg.has_value()) ? *config_arg : get_generation_config();
     config.update_generation_config(config_map);
 
-    return m_pimpl->generate(text, config, utils::get_streamer_from_map(config_map));
+    return generate(text, config, utils::get_streamer_from_map(config_map));
 }
 
 EncodedResults LLMPipeline::generate(
@@ -461,6 +715,8 @@ EncodedResults LLMPipeline::generate(
     OptionalGenerationConfig generation_config,
     StreamerVariant streamer
 ) {
+    if (m_pimpl->is_concurrent_generate_enabled())
+        return m_pimpl->generate_concurrently(inputs, generation_config, streamer);
     return m_pimpl->generate(inputs, generation_config, streamer);
 }
 
@@ -469,7 +725,7 @@ EncodedResults LLMPipeline::generate(const EncodedInputs& inputs, const ov::AnyM
     GenerationConfig config = (config_arg.has_value()) ? *config_arg : get_generation_config();
     config.update_generation_config(config_map);
 
-    return m_pimpl->generate(inputs, config, utils::get_streamer_from_map(config_map));
+    return generate(inputs, config, utils::get_streamer_from_map(config_map));
 }
 
 std::pair<std::string, Any> streamer(StreamerVariant func) {
@@ -674,6 +930,10 @@ public:
     void finish_chat() override {
         m_impl.finish_chat();
     };
+
+    void warmup(const WarmupConfig& config) override {
+        m_impl.warmup(config);
+    }
 };
 
 /* 
@@ -715,9 +975,10 @@ ov::genai::LLMPipeline::LLMPipeline(
     const std::filesystem::path& models_path,
     const ov::genai::Tokenizer& tokenizer,
     const std::string& device,
-    const ov::AnyMap& properties
+    const ov::AnyMap& user_properties
 ){
     auto start_time = std::chrono::steady_clock::now();
+    const ov::AnyMap properties = utils::apply_expected_concurrency(user_properties, device, utils::get_model_weights_byte_size(models_path));
     if (properties.find(ov::genai::scheduler_config.name()) != properties.end()) {
         auto [plugin_config, scheduler_config] = utils::split_scheduler_config(properties);
         m_pimpl = std::make_unique<ContinuousBatchingAdapter>(models_path, tokenizer, scheduler_config, device, plugin_config);
@@ -733,17 +994,24 @@ ov::genai::LLMPipeline::LLMPipeline(
 ov::genai::LLMPipeline::LLMPipeline(
     const std::filesystem::path& models_path,
     const std::string& device,
-    const ov::AnyMap& config
+    const ov::AnyMap& user_config
 ){
     auto start_time = std::chrono::steady_clock::now();
+    ov::AnyMap config = utils::apply_expected_concurrency(user_config, device, utils::get_model_weights_byte_size(models_path));
+    const bool fast_startup = utils::extract_fast_startup(config, models_path);
 
-    if (config.find(ov::genai::scheduler_config.name()) != config.end()) {
-        auto [plugin_config, scheduler_config] = utils::split_scheduler_config(config);
-        m_pimpl = std::make_unique<ContinuousBatchingAdapter>(models_path, scheduler_config, device, plugin_config);
-    } else if (device == "NPU") {
+    if (device == "NPU" && config.find(ov::genai::scheduler_config.name()) == config.end()) {
         m_pimpl = std::make_unique<StaticLLMPipeline>(models_path, device, config);
     } else {
-        m_pimpl = std::make_unique<StatefulLLMPipeline>(models_path, device, config);
+        // with fast startup, the tokenizer is loaded while the LLM is compiled
+        const ov::AnyMap tokenizer_properties = fast_startup ? ov::AnyMap{ov::genai::deferred_load(true)} : ov::AnyMap{};
+        Tokenizer tokenizer(models_path, tokenizer_properties);
+        if (config.find(ov::genai::scheduler_config.name()) != config.end()) {
+            auto [plugin_config, scheduler_config] = utils::split_scheduler_config(config);
+            m_pimpl = std::make_unique<ContinuousBatchingAdapter>(models_path, tokenizer, scheduler_config, device, plugin_config);
+        } else {
+            m_pimpl = std::make_unique<StatefulLLMPipeline>(models_path, tokenizer, device, config);
+        }
     }
     auto stop_time = std::chrono::steady_clock::now();
     m_pimpl->m_load_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(stop_time - start_time).count();
@@ -757,7 +1025,8 @@ ov::genai::LLMPipeline::LLMPipeline(
     const ov::AnyMap& config,
     const ov::genai::GenerationConfig& generation_config
 ){
-    auto [core_properties, plugin_config] = ov::genai::utils::split_core_compile_config(config);
+    auto [core_properties, plugin_config] = ov::genai::utils::split_core_compile_config(
+        utils::apply_expected_concurrency(config, device, weights_tensor.get_byte_size()));
 
     auto start_time = std::chrono::steady_clock::now();
     if (plugin_config.find(ov::genai::scheduler_config.name()) != plugin_config.end()) {
@@ -810,10 +1079,121 @@ void ov::genai::LLMPipeline::start_chat(const std::string& system_message) {
     m_pimpl->start_chat(system_message);
 }
 
+void ov::genai::LLMPipeline::start_chat(const ChatSnapshot& snapshot) {
+    m_pimpl->start_chat(snapshot);
+}
+
+ov::genai::ChatSnapshot ov::genai::LLMPipeline::save_chat(bool compress_kv_cache) {
+    return m_pimpl->save_chat(compress_kv_cache);
+}
+
 void ov::genai::LLMPipeline::finish_chat() {
     m_pimpl->finish_chat();
 }
 
+void ov::genai::LLMPipeline::warmup(const WarmupConfig& config) {
+    m_pimpl->warmup(config);
+}
+
+void ov::genai::LLMPipelineImplBase::warmup(const WarmupConfig& config) {
+    // infer requests of tokenizer and detokenizer are compiled on first use as well
+    m_tokenizer.decode(m_tokenizer.encode("Warmup").input_ids);
+
+    GenerationConfig generation_config = m_generation_config;
+    generation_config.max_new_tokens = config.max_new_tokens;
+    generation_config.ignore_eos = true;
+    size_t seed = 0;
+    for (size_t batch_size : config.batch_sizes) {
+        for (size_t prompt_length : config.prompt_lengths) {
+            ov::Tensor input_ids = utils::create_warmup_input_ids(batch_size, prompt_length, seed++);
+            ov::Tensor attention_mask(ov::element::i64, input_ids.get_shape());
+            std::fill_n(attention_mask.data<int64_t>(), attention_mask.get_size(), 1);
+            generate(TokenizedInputs{input_ids, attention_mask}, generation_config, std::monostate{});
+        }
+    }
+}
+
+ov::genai::GenerationFuture<ov::genai::DecodedResults> ov::genai::LLMPipeline::generate_async(
+    StringInputs inputs,
+    OptionalGenerationConfig generation_config,
+    StreamerVariant streamer,
+    std::function<void(GenerationFuture<DecodedResults>)> on_completion
+) {
+    GenerationConfig config = generation_config.value_or(m_pimpl->m_generation_config);
+    // if eos_token_id was not provided in config forward from default config
+    if (config.eos_token_id == -1)
+        config.set_eos_token_id(m_pimpl->m_generation_config.eos_token_id);
+    config.validate();
+    return m_pimpl->generate_async(std::move(inputs), config, streamer, std::move(on_completion));
+}
+
+ov::genai::GenerationFuture<ov::genai::DecodedResults> ov::genai::LLMPipelineImplBase::generate_async(
+    StringInputs inputs,
+    const GenerationConfig& generation_config,
+    const StreamerVariant& streamer,
+    std::function<void(GenerationFuture<DecodedResults>)> on_completion
+) {
+    CircularBufferQueue<LLMPipelineImplBase*>& pipelines = get_concurrent_pipelines();
+    {
+        std::lock_guard<std::mutex> lock(m_async_mutex);
+        // each thread holds its own pipeline while running a generation, so that the queue waits for synchronous calls only
+        if (!m_async_executor)
+            m_async_executor = std::make_unique<AsyncExecutor>(m_max_concurrent_generations);
+    }
+
+    const bool is_streaming_supported = std::holds_alternative<std::string>(inputs) && generation_config.num_return_sequences == 1 &&
+        (generation_config.is_greedy_decoding() || generation_config.is_multinomial());
+    return m_async_executor->submit_generation<DecodedResults>(
+        [&pipelines, inputs = std::move(inputs), generation_config, streamer, is_streaming_supported](const std::shared_ptr<std::atomic<bool>>& is_cancelled) {
+            CircularBufferQueueElementGuard<LLMPipelineImplBase*> pipeline(&pipelines);
+            return pipeline.get()->generate(inputs, generation_config, make_cancellable_streamer(streamer, is_cancelled, is_streaming_supported));
+        },
+        std::move(on_completion));
+}
+
+ov::genai::CircularBufferQueue<ov::genai::LLMPipelineImplBase*>& ov::genai::LLMPipelineImplBase::get_concurrent_pipelines() {
+    std::lock_guard<std::mutex> lock(m_async_mutex);
+    if (!m_async_pipelines) {
+        // this pipeline serves the first generation, the others are created once generations overlap
+        auto create_pipeline = [this, is_first = true]() mutable -> LLMPipelineImplBase* {
+            if (is_first) {
+                is_first = false;
+                return this;
+            }
+            m_concurrent_pipelines.push_back(create_concurrent_pipeline());
+            return m_concurrent_pipelines.back().get();
+        };
+        m_async_pipelines = std::make_unique<CircularBufferQueue<LLMPipelineImplBase*>>(0, create_pipeline, m_max_concurrent_generations);
+    }
+    return *m_async_pipelines;
+}
+
+ov::genai::DecodedResults ov::genai::LLMPipelineImplBase::generate_concurrently(
+    StringInputs inputs,
+    OptionalGenerationConfig generation_config,
+    StreamerVariant streamer
+) {
+    // pipelines of the pool keep the generation config they were created with
+    GenerationConfig config = generation_config.value_or(m_generation_config);
+    CircularBufferQueueElementGuard<LLMPipelineImplBase*> pipeline(&get_concurrent_pipelines());
+    return pipeline.get()->generate(std::move(inputs), config, std::move(streamer));
+}
+
+ov::genai::EncodedResults ov::genai::LLMPipelineImplBase::generate_concurrently(
+    const EncodedInputs& inputs,
+    OptionalGenerationConfig generation_config,
+    StreamerVariant streamer
+) {
+    GenerationConfig config = generation_config.value_or(m_generation_config);
+    CircularBufferQueueElementGuard<LLMPipelineImplBase*> pipeline(&get_concurrent_pipelines());
+    return pipeline.get()->generate(inputs, config, std::move(streamer));
+}
+
+void ov::genai::LLMPipelineImplBase::stop_async_generations() {
+    std::lock_guard<std::mutex> lock(m_async_mutex);
+    m_async_executor.reset();
+}
+
 void ov::genai::LLMPipeline::set_generation_config(const GenerationConfig& config) {
     int64_t default_eos_token_id = m_pimpl->m_generation_config.eos_token_id;
     m_pimpl->m_generation_config = config;
@@ -824,4 +1204,8 @@ void ov::genai::LLMPipeline::set_generation_config(const GenerationConfig& confi
     m_pimpl->m_generation_config.validate();
 }
 
-ov::genai::LLMPipeline::~LLMPipeline() = default;
+ov::genai::LLMPipeline::~LLMPipeline() {
+    // threads of async generations use the pipeline, so they are stopped before it is destroyed
+    if (m_pimpl)
+        m_pimpl->stop_async_generations();
+}
@@ -3,9 +3,15 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "openvino/genai/llm_pipeline.hpp"
 #include "openvino/genai/tokenizer.hpp"
 #include "openvino/genai/streamer_base.hpp"
+#include "async_executor.hpp"
+#include "circular_buffer_queue.hpp"
 
 namespace ov {
 namespace genai {
@@ -32,6 +38,37 @@ public:
     virtual void start_chat(const std::string& system_message) = 0;
     virtual void finish_chat() = 0;
 
+    virtual void start_chat(const ChatSnapshot& snapshot) {
+        OPENVINO_THROW("Chat snapshots are supported by the stateful LLM pipeline only");
+    }
+
+    virtual ChatSnapshot save_chat(bool compress_kv_cache) {
+        OPENVINO_THROW("Chat snapshots are supported by the stateful LLM pipeline only");
+    }
+
+    // generates synthetic prompts of the configured shapes with the default generation config, results are discarded
+    virtual void warmup(const WarmupConfig& config);
+
+    // queues generation to threads of the pipeline, which are started on the first call
+    virtual GenerationFuture<DecodedResults> generate_async(
+        StringInputs inputs,
+        const GenerationConfig& generation_config,
+        const StreamerVariant& streamer,
+        std::function<void(GenerationFuture<DecodedResults>)> on_completion
+    );
+
+    // whether generate() calls from several threads run concurrently on pipelines of the pool instead of this one
+    virtual bool is_concurrent_generate_enabled() const {
+        return false;
+    }
+
+    // runs generate() of a free pipeline of the pool shared with async generations, waits if all of them are busy
+    DecodedResults generate_concurrently(StringInputs inputs, OptionalGenerationConfig generation_config, StreamerVariant streamer);
+    EncodedResults generate_concurrently(const EncodedInputs& inputs, OptionalGenerationConfig generation_config, StreamerVariant streamer);
+
+    // waits for running async generations and drops queued ones, must be called before destruction of derived classes
+    void stop_async_generations();
+
     virtual ~LLMPipelineImplBase() = default;
 
     Tokenizer m_tokenizer;
@@ -39,6 +76,26 @@ public:
     std::optional<AdapterController> m_adapter_controller;
 
     float m_load_time_ms  = 0;
+
+    // number of async generations, which run concurrently, see ov::genai::max_concurrent_generations
+    size_t m_max_concurrent_generations = 1;
+
+protected:
+    // creates a pipeline, which shares the compiled model with this one, but has its own generation state,
+    // called when more than one async generation runs concurrently
+    virtual std::unique_ptr<LLMPipelineImplBase> create_concurrent_pipeline() {
+        OPENVINO_THROW("Concurrent async generations are supported by the stateful LLM pipeline only");
+    }
+
+private:
+    // creates the pool of pipelines on first use
+    CircularBufferQueue<LLMPipelineImplBase*>& get_concurrent_pipelines();
+
+    std::mutex m_async_mutex;
+    // this pipeline serves the first concurrent generation, m_concurrent_pipelines serve the others
+    std::unique_ptr<CircularBufferQueue<LLMPipelineImplBase*>> m_async_pipelines;
+    std::vector<std::unique_ptr<LLMPipelineImplBase>> m_concurrent_pipelines;
+    std::unique_ptr<AsyncExecutor> m_async_executor;
 };
 
 }  // namespace genai
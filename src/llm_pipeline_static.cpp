@@ -3,8 +3,12 @@
 
 #include "llm_pipeline_static.hpp"
 
+#include <cstring>
 #include <fstream>
+#include <iostream>
+#include <numeric>
 #include <regex>
+#include <sstream>
 
 #include "openvino/pass/stateful_to_stateless.hpp"
 
@@ -26,6 +30,7 @@
 #include "text_callback_streamer.hpp"
 #include "json_utils.hpp"
 #include "utils.hpp"
+#include "prompt_lookup/ngram_index.hpp"
 
 namespace {
 
@@ -415,21 +420,22 @@ ov::genai::ModelConfigDesc get_modeldesc_from_json(const std::filesystem::path&
 void reshape_to_static(std::shared_ptr<ov::Model> model,
                        const uint32_t input_size,
                        const uint32_t kvcache_size,
-                       const KVAxesPosition& kv_axes_position) {
+                       const KVAxesPosition& kv_axes_position,
+                       const uint32_t batch_size = 1u) {
     std::map<std::string, ov::PartialShape> new_shapes;
     for (auto input : model->inputs()) {
         const auto& input_name = input.get_any_name();
         ov::PartialShape new_shape;
         if (input_name.find("input_ids") != std::string::npos) {
-            new_shape = ov::PartialShape({1, input_size});
+            new_shape = ov::PartialShape({batch_size, input_size});
         } else if (input_name.find("attention_mask") != std::string::npos) {
-            new_shape = ov::PartialShape({1, kvcache_size});
+            new_shape = ov::PartialShape({batch_size, kvcache_size});
         } else if (input_name.find("position_ids") != std::string::npos) {
-            new_shape = ov::PartialShape({1, input_size});
+            new_shape = ov::PartialShape({batch_size, input_size});
         } else {
             const auto& partial_shape = input.get_partial_shape();
             new_shape = partial_shape;
-            new_shape[kv_axes_position.batch] = 1;
+            new_shape[kv_axes_position.batch] = batch_size;
             new_shape[kv_axes_position.seq_len] = kvcache_size - input_size;
         }
         new_shapes.emplace(input_name, new_shape);
@@ -443,11 +449,6 @@ void fill_tensor(ov::Tensor tensor, T fill_val, size_t offset = 0u) {
     std::fill(tensor_data + offset, tensor_data + tensor.get_size(), fill_val);
 }
 
-void copy_with_offset(const ov::Tensor& orig, const std::size_t offset, ov::Tensor& padded) {
-    int64_t* orig_data = orig.data<int64_t>();
-    int64_t* padded_data = padded.data<int64_t>();
-    std::copy(orig_data, orig_data + orig.get_size(), padded_data + offset);
-}
 
 void merge_config_with(ov::AnyMap& lhs, const ov::AnyMap& rhs) {
     for (const auto& [key, value] : rhs) {
@@ -594,6 +595,32 @@ ov::Tensor make_tensor_slice(ov::Tensor tensor, size_t dim, size_t start_pos, si
     return ov::Tensor(tensor, start_shape, end_shape);
 }
 
+// NB: Slice of positions [start_pos, end_pos) along dim of a single batch row
+ov::Tensor make_row_tensor_slice(ov::Tensor tensor, size_t batch_dim, size_t row, size_t dim, size_t start_pos, size_t end_pos) {
+    ov::Shape start_shape(std::vector<size_t>(tensor.get_shape().size(), 0u));
+    start_shape[batch_dim] = row;
+    start_shape[dim] = start_pos;
+    ov::Shape end_shape = tensor.get_shape();
+    end_shape[batch_dim] = row + 1;
+    end_shape[dim] = end_pos;
+    return ov::Tensor(tensor, start_shape, end_shape);
+}
+
+// NB: Parses comma-separated prompt sizes of prefill buckets, e.g. "128,512", aligned to 64 and sorted
+std::vector<uint32_t> parse_prefill_buckets(const std::string& buckets_str) {
+    std::vector<uint32_t> buckets;
+    std::stringstream ss(buckets_str);
+    std::string bucket;
+    while (std::getline(ss, bucket, ',')) {
+        if (!bucket.empty()) {
+            buckets.push_back(align_to(static_cast<uint32_t>(std::stoul(bucket)), 64u));
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    return buckets;
+}
+
 void set_npuw_cache_dir(ov::AnyMap& config) {
     std::optional<std::string> cache_dir = get_option<std::string>(config, "CACHE_DIR");
     if (config.count("NPU_USE_NPUW") != 0u && cache_dir) {
@@ -632,6 +659,31 @@ void copy_columns_by_row_chunks(const ov::Tensor& src, ov::Tensor& dst) {
     }
 }
 
+// NB: Moves KV-cache of positions [src_begin, src_end) along kv_dim to the positions starting from
+// dst_begin <= src_begin within the same dense tensor, the ranges may overlap
+void move_kv_positions(ov::Tensor& tensor, size_t kv_dim, size_t src_begin, size_t src_end, size_t dst_begin) {
+    const auto shape = tensor.get_shape();
+    OPENVINO_ASSERT(dst_begin <= src_begin && src_begin <= src_end && src_end <= shape[kv_dim]);
+
+    const size_t num_rows = std::accumulate(shape.begin(), shape.begin() + kv_dim, size_t{1}, std::multiplies<size_t>());
+    const size_t position_byte_size = std::accumulate(shape.begin() + kv_dim + 1, shape.end(), size_t{1}, std::multiplies<size_t>())
+        * tensor.get_element_type().size();
+    const size_t row_byte_size = shape[kv_dim] * position_byte_size;
+
+    auto* data = static_cast<uint8_t*>(tensor.data());
+    for (size_t i = 0; i < num_rows; ++i) {
+        auto* row = data + i * row_byte_size;
+        std::memmove(row + dst_begin * position_byte_size, row + src_begin * position_byte_size,
+                     (src_end - src_begin) * position_byte_size);
+    }
+}
+
+int64_t argmax_at_position(const ov::Tensor& logits, size_t position) {
+    const size_t vocab_size = logits.get_shape().back();
+    const float* logits_data = logits.data<const float>() + position * vocab_size;
+    return std::max_element(logits_data, logits_data + vocab_size) - logits_data;
+}
+
 } // anonymous namespace
 
 namespace ov {
@@ -643,7 +695,7 @@ StaticLLMPipeline::StaticLLMPipeline(
     const std::string& device,
     const ov::AnyMap& config
 ) : LLMPipelineImplBase(tokenizer,
-                        utils::from_config_json_if_exists(models_path)) {
+                        utils::from_config_json_if_exists(models_path)), m_sampler(m_tokenizer) {
     auto properties = config;
     /* NB: Static LLM pipeline consists of two models,
        first to process the input prompt (prefill),
@@ -658,6 +710,9 @@ StaticLLMPipeline::StaticLLMPipeline(
            and generation precompiled blobs, that is "USE_BLOBS=YES" way.
     */
     const auto use_blobs = pop_or_default(properties, "USE_BLOBS", false);
+    const auto zero_copy_kvcache = pop_or_default(properties, "ZERO_COPY_KVCACHE", false);
+    m_kvcache_sliding_window = pop_or_default(properties, "KVCACHE_SLIDING_WINDOW", false);
+    m_num_attention_sinks = pop_int_and_cast(properties, "KVCACHE_ATTENTION_SINKS").value_or(4u);
     if (!use_blobs) {
         ModelConfigDesc model_desc = get_modeldesc_from_json(models_path / "config.json");
         auto model = genai::utils::singleton_core().read_model((models_path / "openvino_model.xml").string());
@@ -665,6 +720,9 @@ StaticLLMPipeline::StaticLLMPipeline(
     } else {
         setupAndImportModels(models_path, device, properties);
     }
+    if (zero_copy_kvcache) {
+        bind_prefill_kvcache_outputs();
+    }
     // Initialize tensors
     prepare_for_new_conversation();
 
@@ -688,7 +746,7 @@ StaticLLMPipeline::StaticLLMPipeline(
     const std::string& device,
     const ov::AnyMap& properties,
     const ov::genai::GenerationConfig& generation_config
-) : LLMPipelineImplBase(tokenizer, generation_config) {
+) : LLMPipelineImplBase(tokenizer, generation_config), m_sampler(m_tokenizer) {
     
     bool use_blobs = false;
     auto anyopt = get_option<bool>(properties, "USE_BLOBS");
@@ -699,7 +757,13 @@ StaticLLMPipeline::StaticLLMPipeline(
     OPENVINO_ASSERT(!use_blobs, "blobs cannot be used with model string and weights tensor");
 
     auto properties_ = properties;
+    const auto zero_copy_kvcache = pop_or_default(properties_, "ZERO_COPY_KVCACHE", false);
+    m_kvcache_sliding_window = pop_or_default(properties_, "KVCACHE_SLIDING_WINDOW", false);
+    m_num_attention_sinks = pop_int_and_cast(properties_, "KVCACHE_ATTENTION_SINKS").value_or(4u);
     setupAndCompileModels(model, device, model_desc, properties_);
+    if (zero_copy_kvcache) {
+        bind_prefill_kvcache_outputs();
+    }
 
     // Initialize tensors
     prepare_for_new_conversation();
@@ -737,17 +801,54 @@ void StaticLLMPipeline::setupAndCompileModels(
     ov::pass::StatefulToStateless().run_on_model(kvcache_model);
     // (3) Align u4 ZP constants
     align_u4_zp_constants(kvcache_model);
-    // (4) Clone the model - this will be prefill
+    // (4) Clone the model - this will be prefill,
+    //     in chunked mode it also takes KV-cache of the previous chunks as input
     auto prefill_model = kvcache_model->clone();
     prefill_model->set_friendly_name(kvcache_model->get_friendly_name() + "_prefill");
+    // NB: Smaller prefill models for short prompts are cloned before prefill model is reshaped
+    auto prefill_buckets = parse_prefill_buckets(pop_or_default<std::string>(properties, "PREFILL_BUCKETS", ""));
+    std::vector<std::shared_ptr<ov::Model>> prefill_bucket_models;
     // (5) Reshape both models to static shape
     const uint32_t kMaxPromptLen = align_to(pop_int_and_cast(properties, "MAX_PROMPT_LEN").value_or(1024u), 64u);
     const uint32_t kMinResponseLen = align_to(pop_int_and_cast(properties, "MIN_RESPONSE_LEN").value_or(128u), 64u);
+    // NB: Generate model verifies up to this number of prompt lookup candidates per inference in addition to the last token
+    const uint32_t kNumCandidates = pop_int_and_cast(properties, "PROMPT_LOOKUP_CANDIDATES").value_or(0u);
+    OPENVINO_ASSERT(kNumCandidates < kMinResponseLen, "\"PROMPT_LOOKUP_CANDIDATES\" must be less than \"MIN_RESPONSE_LEN\"");
+    // NB: Generate model decodes this number of prompts together, prefill model processes them one by one
+    m_batch_size = pop_int_and_cast(properties, "BATCH_SIZE").value_or(1u);
+    OPENVINO_ASSERT(m_batch_size > 0u, "\"BATCH_SIZE\" must be positive");
+
+    // NB: Prefill model processes the prompt by chunks of this number of tokens, the whole prompt at once if zero
+    m_prefill_chunk_size = align_to(pop_int_and_cast(properties, "PREFILL_CHUNK_SIZE").value_or(0u), 64u);
+    OPENVINO_ASSERT(m_prefill_chunk_size == 0u || kMaxPromptLen % m_prefill_chunk_size == 0u,
+                    "\"MAX_PROMPT_LEN\" must be a multiple of \"PREFILL_CHUNK_SIZE\"");
+    const bool use_chunked_prefill = m_prefill_chunk_size > 0u && m_prefill_chunk_size < kMaxPromptLen;
+    if (!use_chunked_prefill) {
+        m_prefill_chunk_size = 0u;
+    }
+    OPENVINO_ASSERT(!use_chunked_prefill || prefill_buckets.empty(),
+                    "\"PREFILL_BUCKETS\" cannot be used together with \"PREFILL_CHUNK_SIZE\"");
+    OPENVINO_ASSERT(!use_chunked_prefill || m_batch_size == 1u,
+                    "\"BATCH_SIZE\" cannot be used together with \"PREFILL_CHUNK_SIZE\"");
+    // NB: Prompts, which don't fit any smaller bucket, are processed by prefill model itself
+    prefill_buckets.erase(std::remove_if(prefill_buckets.begin(), prefill_buckets.end(),
+                                         [&](uint32_t bucket) { return bucket >= kMaxPromptLen; }),
+                          prefill_buckets.end());
+    for (const auto bucket : prefill_buckets) {
+        auto bucket_model = prefill_model->clone();
+        bucket_model->set_friendly_name(prefill_model->get_friendly_name() + "_" + std::to_string(bucket));
+        prefill_bucket_models.push_back(bucket_model);
+    }
 
     KVAxesPosition axes = get_kv_axes(model_desc.type);
     m_kvcache_desc = KVCacheDesc { kMaxPromptLen, kMaxPromptLen + kMinResponseLen, 0u, axes.seq_len, false};
-    reshape_to_static(prefill_model, m_kvcache_desc.max_prompt_size, m_kvcache_desc.max_prompt_size, axes);
-    reshape_to_static(kvcache_model, 1u, m_kvcache_desc.total_size, axes);
+    m_kv_batch_dim = axes.batch;
+    reshape_to_static(prefill_model, use_chunked_prefill ? m_prefill_chunk_size : m_kvcache_desc.max_prompt_size,
+                      m_kvcache_desc.max_prompt_size, axes);
+    for (size_t i = 0; i < prefill_bucket_models.size(); ++i) {
+        reshape_to_static(prefill_bucket_models[i], prefill_buckets[i], prefill_buckets[i], axes);
+    }
+    reshape_to_static(kvcache_model, 1u + kNumCandidates, m_kvcache_desc.total_size, axes, m_batch_size);
     // (6) Apply opt layout if applicable
     // NB: Try to apply opt transpose only for Llama-2-7b-chat-hf model
     if ( model_desc.name_or_path == "meta-llama/Llama-2-7b-chat-hf" ||
@@ -755,14 +856,27 @@ void StaticLLMPipeline::setupAndCompileModels(
         if (optimize_value_tensors(kvcache_model)) {
             // NB: Check if TransposeValueTensors transformation was applied
             m_kvcache_desc.v_tensors_transposed = true;
-            prefill_model = cvt_value_tensors_layout(prefill_model);
+            if (use_chunked_prefill) {
+                OPENVINO_ASSERT(optimize_value_tensors(prefill_model), "Failed to transpose value tensors of chunked prefill model");
+            } else {
+                prefill_model = cvt_value_tensors_layout(prefill_model);
+            }
+            for (auto& bucket_model : prefill_bucket_models) {
+                bucket_model = cvt_value_tensors_layout(bucket_model);
+            }
         }
     }
     // (7) Replace KV-cache tensors for the entire cache to tensors only for new token (before concat)
     kvcache_model = redirect_new_kv_to_output(kvcache_model);
+    if (use_chunked_prefill) {
+        prefill_model = redirect_new_kv_to_output(prefill_model);
+    }
     // (8) Convert kvcache tensors to fp16 precision
     kvcache_model = cvt_kvcache_to_fp16(kvcache_model);
     prefill_model = cvt_kvcache_to_fp16(prefill_model);
+    for (auto& bucket_model : prefill_bucket_models) {
+        bucket_model = cvt_kvcache_to_fp16(bucket_model);
+    }
     // (9) Compile both model
     auto prefill_config = pop_or_default(
         properties, "PREFILL_CONFIG", get_default_prefill_config(prefill_model, npudesc)
@@ -787,6 +901,12 @@ void StaticLLMPipeline::setupAndCompileModels(
     auto prefill_compiled_model = core.compile_model(prefill_model, device, prefill_config);
     m_prefill_request = prefill_compiled_model.create_infer_request();
     ov::genai::utils::print_compiled_model_properties(prefill_compiled_model, "Static LLM prefill compiled model");
+
+    // NB: With NPUW cache dir every bucket is compiled once and then loaded from its own cached blob
+    for (const auto& bucket_model : prefill_bucket_models) {
+        auto bucket_compiled_model = core.compile_model(bucket_model, device, prefill_config);
+        m_prefill_bucket_requests.push_back(bucket_compiled_model.create_infer_request());
+    }
 }
 
 void StaticLLMPipeline::setupAndImportModels(
@@ -795,10 +915,10 @@ void StaticLLMPipeline::setupAndImportModels(
     ov::AnyMap& properties) {
     /* To initialize pipeline in case when user passes "USE_BLOBS=YES",
        next steps are required:
-        1) Check that neither MAX_PROMPT_LEN nor MIN_RESPONSE_LEN is
-           exposed in the config. These parameters will be retrieved
-           from blobs
-        2) Import prefill model from model directory or specified path
+        1) Check that neither MAX_PROMPT_LEN, MIN_RESPONSE_LEN nor
+           PROMPT_LOOKUP_CANDIDATES is exposed in the config. These
+           parameters will be retrieved from blobs
+        2) Import prefill model and optional prefill buckets from model directory or specified path
         3) Import generate model from model directory or specified path
         4) Fill in m_kvcache_desc
     */
@@ -831,6 +951,10 @@ void StaticLLMPipeline::setupAndImportModels(
 
     };
 
+    auto get_input_ids_size = [](ov::CompiledModel& model) {
+        return static_cast<uint32_t>(model.input("input_ids").get_shape()[1]);
+    };
+
     auto get_kvcache_size = [](ov::CompiledModel& model) {
         for (auto input : model.inputs()) {
             const auto& input_name = input.get_any_name();
@@ -841,17 +965,39 @@ void StaticLLMPipeline::setupAndImportModels(
         OPENVINO_THROW("No attention_mask input is found! Such model isn't supported.");
     };
 
-    // (1) Check that neither MAX_PROMPT_LEN nor MIN_RESPONSE_LEN is
-    //     exposed in the config
+    // (1) Check that neither MAX_PROMPT_LEN, MIN_RESPONSE_LEN, PROMPT_LOOKUP_CANDIDATES,
+    //     PREFILL_CHUNK_SIZE nor PREFILL_BUCKETS is exposed in the config
     if (properties.count("MAX_PROMPT_LEN") ||
-        properties.count("MIN_RESPONSE_LEN")) {
-        OPENVINO_THROW("Neither \"MAX_PROMPT_LEN\" nor \"MIN_RESPONSE_LEN\""
+        properties.count("MIN_RESPONSE_LEN") ||
+        properties.count("PROMPT_LOOKUP_CANDIDATES") ||
+        properties.count("PREFILL_CHUNK_SIZE") ||
+        properties.count("PREFILL_BUCKETS") ||
+        properties.count("BATCH_SIZE")) {
+        OPENVINO_THROW("Neither \"MAX_PROMPT_LEN\" nor \"MIN_RESPONSE_LEN\" nor \"PROMPT_LOOKUP_CANDIDATES\""
+           " nor \"PREFILL_CHUNK_SIZE\" nor \"PREFILL_BUCKETS\" nor \"BATCH_SIZE\""
            " can be specified in \"USE_BLOBS=YES\" configuration!");
     }
     // (2) Import prefill model from model directory or specified path
     auto prefill_config = pop_or_default(properties, "PREFILL_CONFIG", ov::AnyMap());
     auto prefill_model = import_blob("prefill", prefill_config);
     m_prefill_request = prefill_model.create_infer_request();
+    // NB: Prefill buckets exported as openvino_prefill_<prompt size>.blob are optional
+    std::vector<uint32_t> prefill_buckets;
+    const std::regex bucket_blob_regex("openvino_prefill_([0-9]+)\\.blob");
+    for (const auto& entry : std::filesystem::directory_iterator(models_path)) {
+        std::smatch match;
+        const auto filename = entry.path().filename().string();
+        if (std::regex_match(filename, match, bucket_blob_regex)) {
+            prefill_buckets.push_back(static_cast<uint32_t>(std::stoul(match[1].str())));
+        }
+    }
+    std::sort(prefill_buckets.begin(), prefill_buckets.end());
+    for (const auto bucket : prefill_buckets) {
+        auto bucket_config = prefill_config;
+        pop_option(bucket_config, "BLOB_PATH");
+        auto bucket_model = import_blob("prefill_" + std::to_string(bucket), bucket_config);
+        m_prefill_bucket_requests.push_back(bucket_model.create_infer_request());
+    }
     // (3) Import generate model from model directory or specified path
     auto generate_config = pop_or_default(properties, "GENERATE_CONFIG", ov::AnyMap());
     auto generate_model = import_blob("generate", generate_config);
@@ -861,6 +1007,155 @@ void StaticLLMPipeline::setupAndImportModels(
     const uint32_t kMinResponseLen = get_kvcache_size(generate_model) - kMaxPromptLen;
     // FIXME For some models KV-cache dim != 2u
     m_kvcache_desc = KVCacheDesc { kMaxPromptLen, kMaxPromptLen + kMinResponseLen, 0u, 2u };
+    // NB: Prefill blob exported in chunked mode processes fewer tokens than its KV-cache holds
+    const uint32_t kPrefillInputLen = get_input_ids_size(prefill_model);
+    m_prefill_chunk_size = kPrefillInputLen < kMaxPromptLen ? kPrefillInputLen : 0u;
+    // FIXME For some models KV-cache batch dim != 0u
+    m_batch_size = static_cast<uint32_t>(generate_model.input("input_ids").get_shape()[0]);
+    m_kv_batch_dim = 0u;
+}
+
+void StaticLLMPipeline::bind_prefill_kvcache_outputs() {
+    /* NB: "ZERO_COPY_KVCACHE=YES" makes prefill model write its KV-cache outputs
+       directly into the first max_prompt_size positions of generate model KV-cache inputs,
+       so that no copy is needed between prefill and generation.
+       Prompt stays at its left-padded position, thus generated tokens are stored
+       starting from max_prompt_size position. Plugins, which don't accept strided
+       output tensors (e.g. for transposed v-tensors), keep the default copying.
+    */
+    if (m_prefill_chunk_size > 0u) {
+        // NB: Chunked prefill writes KV-cache of every chunk to generate model inputs itself
+        return;
+    }
+    if (m_batch_size > 1u) {
+        std::cerr << "[ WARNING ] ZERO_COPY_KVCACHE is not supported with BATCH_SIZE > 1, KV-cache will be copied\n";
+        return;
+    }
+    // Outputs: logits, ...
+    const auto kStartOutputKVCacheLayers = 1u;
+    const auto& kvcache_compiled = m_kvcache_request.get_compiled_model();
+    std::vector<std::string> bound_outputs;
+    try {
+        for (size_t i = kStartOutputKVCacheLayers; i < kvcache_compiled.outputs().size(); ++i) {
+            const auto& output_name = kvcache_compiled.outputs()[i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
+
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
+
+            auto kvcache_in_slice = make_tensor_slice(
+                m_kvcache_request.get_tensor(input_name), kv_dim, 0u, m_kvcache_desc.max_prompt_size
+            );
+            m_prefill_request.set_tensor(output_name, kvcache_in_slice);
+            bound_outputs.push_back(output_name);
+        }
+    } catch (const std::exception& ex) {
+        // NB: Restore own prefill outputs for the layers, which were already bound
+        for (const auto& output_name : bound_outputs) {
+            const auto prefill_out_tensor = m_prefill_request.get_tensor(output_name);
+            m_prefill_request.set_tensor(output_name,
+                ov::Tensor(prefill_out_tensor.get_element_type(), prefill_out_tensor.get_shape()));
+        }
+        std::cerr << "[ WARNING ] ZERO_COPY_KVCACHE is not supported by the device, KV-cache will be copied: "
+                  << ex.what() << "\n";
+        return;
+    }
+    m_zero_copy_kvcache = true;
+}
+
+void StaticLLMPipeline::infer_prefill_by_chunks(const int64_t* prompt_data, size_t prompt_len) {
+    const size_t chunk_size = m_prefill_chunk_size;
+    const size_t num_chunks = (prompt_len + chunk_size - 1) / chunk_size;
+    // NB: The first chunk is left-padded, so that the last prompt token is the last token of the last chunk
+    const size_t offset = num_chunks * chunk_size - prompt_len;
+    // NB: Attention mask of prefill model covers KV-cache of the previous chunks followed by the current chunk
+    const size_t past_size = m_kvcache_desc.max_prompt_size - chunk_size;
+    OPENVINO_ASSERT((num_chunks - 1) * chunk_size <= past_size);
+
+    auto* input_ids_data = m_prefill_request.get_tensor("input_ids").data<int64_t>();
+    auto* position_ids_data = m_prefill_request.get_tensor("position_ids").data<int64_t>();
+    auto* attention_mask_data = m_prefill_request.get_tensor("attention_mask").data<int64_t>();
+
+    // Outputs: logits, ...
+    const auto kStartOutputKVCacheLayers = 1u;
+    const auto& prefill_compiled = m_prefill_request.get_compiled_model();
+
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        const size_t chunk_begin = chunk * chunk_size;
+        // NB: Number of padding tokens at the beginning of the chunk
+        const size_t chunk_offset = chunk == 0 ? offset : 0u;
+
+        std::fill_n(input_ids_data, chunk_offset, m_tokenizer.get_pad_token_id());
+        std::copy_n(prompt_data + chunk_begin + chunk_offset - offset, chunk_size - chunk_offset, input_ids_data + chunk_offset);
+        std::fill_n(position_ids_data, chunk_offset, 0u);
+        std::iota(position_ids_data + chunk_offset, position_ids_data + chunk_size, chunk_begin + chunk_offset - offset);
+        std::fill_n(attention_mask_data + past_size, chunk_offset, 0u);
+        std::fill(attention_mask_data + past_size + chunk_offset, attention_mask_data + past_size + chunk_size, 1u);
+
+        m_prefill_request.infer();
+
+        ov::parallel_for(prefill_compiled.outputs().size() - 1, [&](size_t i) {
+            const auto& output_name = prefill_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
+
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
+
+            auto prefill_out_tensor = m_prefill_request.get_tensor(output_name);
+            auto prefill_out_slice = make_tensor_slice(prefill_out_tensor, kv_dim, chunk_offset, chunk_size);
+            // NB: Store KV-cache of the chunk for generate model...
+            auto kvcache_in_slice = make_tensor_slice(
+                m_kvcache_request.get_tensor(input_name), kv_dim, chunk_begin + chunk_offset - offset, chunk_begin + chunk_size - offset
+            );
+            // ... and for the next chunks
+            std::optional<ov::Tensor> prefill_in_slice;
+            if (chunk + 1 < num_chunks) {
+                prefill_in_slice = make_tensor_slice(
+                    m_prefill_request.get_tensor(input_name), kv_dim, chunk_begin, chunk_begin + chunk_size
+                );
+            }
+
+            if (kv_dim == 3u) {
+                copy_columns_by_row_chunks(prefill_out_slice, kvcache_in_slice);
+                if (prefill_in_slice) {
+                    copy_columns_by_row_chunks(prefill_out_tensor, *prefill_in_slice);
+                }
+            } else {
+                prefill_out_slice.copy_to(kvcache_in_slice);
+                if (prefill_in_slice) {
+                    prefill_out_tensor.copy_to(*prefill_in_slice);
+                }
+            }
+        });
+        std::fill(attention_mask_data + chunk_begin + chunk_offset, attention_mask_data + chunk_begin + chunk_size, 1u);
+    }
+}
+
+void StaticLLMPipeline::infer_prefill(ov::InferRequest& prefill_request, const int64_t* prompt_data, size_t prompt_len) {
+    auto padded_input_ids = prefill_request.get_tensor("input_ids");
+    const size_t offset = padded_input_ids.get_size() - prompt_len;
+    fill_tensor<int64_t>(padded_input_ids, m_tokenizer.get_pad_token_id());
+    std::copy_n(prompt_data, prompt_len, padded_input_ids.data<int64_t>() + offset);
+
+    auto padded_attention_mask = prefill_request.get_tensor("attention_mask");
+    fill_tensor<int64_t>(padded_attention_mask, 0u);
+    fill_tensor<int64_t>(padded_attention_mask, 1u, offset);
+
+    auto padded_position_ids = prefill_request.get_tensor("position_ids");
+    auto* padded_pos_data = padded_position_ids.data<int64_t>();
+    std::fill(padded_pos_data, padded_pos_data + offset, 0u);
+    std::iota(padded_pos_data + offset, padded_pos_data + padded_position_ids.get_size(), 0u);
+
+    prefill_request.infer();
+}
+
+ov::InferRequest& StaticLLMPipeline::select_prefill_request(size_t prompt_len) {
+    for (auto& request : m_prefill_bucket_requests) {
+        if (request.get_tensor("input_ids").get_size() >= prompt_len) {
+            return request;
+        }
+    }
+    return m_prefill_request;
 }
 
 void StaticLLMPipeline::start_chat(const std::string& system_message) {
@@ -892,19 +1187,28 @@ DecodedResults StaticLLMPipeline::generate(
 
     GenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
     std::string prompt;
+    std::vector<std::string> prompts;
     if (auto input_vector = std::get_if<std::vector<std::string>>(&inputs)) {
-        if (input_vector->size() > 1u) {
-            OPENVINO_THROW("Currently only batch size=1 is supported");
+        if (input_vector->size() > 1u && m_batch_size == 1u) {
+            OPENVINO_THROW("Currently only batch size=1 is supported. "
+                           "Set the \"BATCH_SIZE\" config option to decode several prompts together.");
         }
         OPENVINO_ASSERT(!input_vector->empty());
-        prompt = std::move(input_vector->front());
+        if (input_vector->size() > 1u) {
+            OPENVINO_ASSERT(!m_is_chat_conversation, "Chat mode is supported only for a single prompt");
+            prompts = std::move(*input_vector);
+        } else {
+            prompt = std::move(input_vector->front());
+        }
     } else {
         OPENVINO_ASSERT(std::holds_alternative<std::string>(inputs));
         prompt = std::get<std::string>(inputs);
     }
 
     ov::genai::TokenizedInputs tokenized_input;
-    if (m_is_chat_conversation) {
+    if (!prompts.empty()) {
+        tokenized_input = m_tokenizer.encode(prompts);
+    } else if (m_is_chat_conversation) {
         m_history.push_back({{"role", "user"}, {"content", prompt}});
         constexpr bool add_generation_prompt = true;
         prompt = m_tokenizer.apply_chat_template(m_history, add_generation_prompt);
@@ -955,8 +1259,9 @@ EncodedResults StaticLLMPipeline::generate(
         attention_mask = data->attention_mask;
     }
 
-    if (input_ids.get_shape().at(0) > 1u) {
-        OPENVINO_THROW("Currently only batch size=1 is supported");
+    if (input_ids.get_shape().at(0) > m_batch_size) {
+        OPENVINO_THROW("Currently only batch size up to " + std::to_string(m_batch_size) + " is supported. "
+                       + "Set the \"BATCH_SIZE\" config option to increase the limit.");
     }
 
     GenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
@@ -974,8 +1279,19 @@ EncodedResults StaticLLMPipeline::generate(
         streamer_ptr = std::make_shared<TextCallbackStreamer>(m_tokenizer, *callback);
     }
 
-    if (!config.is_greedy_decoding()) {
-        OPENVINO_THROW("Currently only greedy decoding is supported");
+    if (config.is_beam_search()) {
+        OPENVINO_THROW("Currently only greedy decoding and multinomial sampling are supported");
+    }
+    OPENVINO_ASSERT(config.num_return_sequences == 1u, "Currently only num_return_sequences=1 is supported");
+    // NB: Shared sampler applies logit processors, plain greedy decoding picks argmax of static logits directly
+    const bool use_sampler = config.is_multinomial() || config.repetition_penalty != 1.0f ||
+        config.presence_penalty != 0.0f || config.frequency_penalty != 0.0f || !config.stop_strings.empty();
+
+    // NB: Generate model with static batch decodes all prompts together
+    if (m_batch_size > 1u) {
+        OPENVINO_ASSERT(!streamer_ptr, "Streaming is possible only with \"BATCH_SIZE\"=1");
+        OPENVINO_ASSERT(!use_sampler, "Only greedy decoding without penalties is supported with \"BATCH_SIZE\" > 1");
+        return generate_batched(input_ids, attention_mask, config, start_time);
     }
 
     ov::Shape prompts_shape = input_ids.get_shape();
@@ -989,106 +1305,193 @@ EncodedResults StaticLLMPipeline::generate(
 
     // NB: Check if there is enough space in KV-cache to process input prompt
     auto prompt_len = input_ids.get_size();
-    if (prompt_len > m_kvcache_desc.max_prompt_size) {
+    if (prompt_len > m_kvcache_desc.max_prompt_size && !m_kvcache_sliding_window) {
         OPENVINO_THROW("Static LLM pipeline may only process prompts up to "
                        + std::to_string(m_kvcache_desc.max_prompt_size) + " tokens. "
-                       + "Set the \"MAX_PROMPT_LEN\" config option to increase the limit.");
+                       + "Set the \"MAX_PROMPT_LEN\" config option to increase the limit "
+                       + "or enable \"KVCACHE_SLIDING_WINDOW\".");
     }
+    // NB: In sliding window mode the prompt tail, which doesn't fit prefill model, is passed through generate model
+    const size_t prefill_len = std::min<size_t>(prompt_len, m_kvcache_desc.max_prompt_size);
+    const auto* prompt_data = input_ids.data<int64_t>();
 
     // NB: From the "generate" perspective, every call is treated as start of new conversation,
     // but if continuation is needed, prompt contains information about the entire conversation.
     prepare_for_new_conversation();
 
-    auto padded_input_ids = m_prefill_request.get_tensor("input_ids");
-    const size_t offset = padded_input_ids.get_size() - input_ids.get_size();
-    copy_with_offset(input_ids, offset, padded_input_ids);
-
-    auto padded_attention_mask = m_prefill_request.get_tensor("attention_mask");
-    fill_tensor<int64_t>(padded_attention_mask, 1u, offset);
-
-    auto padded_position_ids = m_prefill_request.get_tensor("position_ids");
-    auto* padded_pos_data = padded_position_ids.data<int64_t>();
-    std::iota(padded_pos_data + offset, padded_pos_data + padded_position_ids.get_size(), 0u);
+    // NB: The smallest prefill bucket, which fits the prompt, the main prefill model otherwise
+    auto& prefill_request = m_prefill_chunk_size > 0u ? m_prefill_request : select_prefill_request(prefill_len);
+    const size_t prefill_size = prefill_request.get_tensor("input_ids").get_size();
+    // NB: Sampler processes logits of a single position, which are passed to it as a view of the static output
+    SequenceGroup::Ptr sequence_group;
+    if (use_sampler) {
+        if (m_sampler.get_seed() != config.rng_seed) {
+            m_sampler.set_seed(config.rng_seed);
+        }
+        m_sampler.clear_request_info(0);
+        sequence_group = std::make_shared<SequenceGroup>(0, TokenIds(prompt_data, prompt_data + prompt_len), config, 1u, false);
+        sequence_group->set_sequence_group_ptr(sequence_group);
+        sequence_group->update_processed_tokens_num(prompt_len - 1);
+    }
+    auto sample_token = [&](const ov::Tensor& logits, size_t position) -> int64_t {
+        if (!sequence_group) {
+            return argmax_at_position(logits, position);
+        }
+        const size_t vocab_size = logits.get_shape().back();
+        ov::Tensor position_logits(ov::element::f32, {1u, 1u, vocab_size}, logits.data<float>() + position * vocab_size);
+        std::vector<SequenceGroup::Ptr> sequence_groups{sequence_group};
+        sequence_group->schedule_tokens(1);
+        m_sampler.sample(sequence_groups, position_logits);
+        // NB: Tokens of a matched stop string may be removed, generation is finished then and the token isn't fed anymore
+        const auto& generated_ids = (*sequence_group)[0]->get_generated_ids();
+        return generated_ids.empty() ? m_tokenizer.get_pad_token_id() : generated_ids.back();
+    };
+    // NB: Results and streamer follow generated ids of the sequence, since the sampler removes tokens of a matched stop string,
+    // tokens which may still become a part of a stop string are streamed only once they can't
+    size_t num_streamed_tokens = 0;
+    bool is_streamer_stopped = false;
+    auto stream_tokens = [&](size_t num_held_tokens) {
+        const auto& generated_ids = (*sequence_group)[0]->get_generated_ids();
+        for (; streamer_ptr && !is_streamer_stopped && num_streamed_tokens + num_held_tokens < generated_ids.size(); ++num_streamed_tokens) {
+            is_streamer_stopped = streamer_ptr->put(generated_ids[num_streamed_tokens]);
+        }
+    };
+    // NB: Returns whether streamer requested to stop generation
+    auto put_token = [&](int64_t token) -> bool {
+        if (!sequence_group) {
+            results.tokens[0].push_back(token);
+            return streamer_ptr && streamer_ptr->put(token);
+        }
+        results.tokens[0] = (*sequence_group)[0]->get_generated_ids();
+        stream_tokens(sequence_group->has_finished() ? 0u : sequence_group->get_stream_window_size());
+        return is_streamer_stopped;
+    };
+    // NB: Sampler finishes the sequence on EOS, stop strings and length limits
+    auto is_generation_finished = [&](int64_t token) {
+        return sequence_group ? sequence_group->has_finished() : token == config.eos_token_id && !config.ignore_eos;
+    };
 
-    m_prefill_request.infer();
-    raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
-    raw_perf_counters.m_batch_sizes.emplace_back(batch_size);
+    if (m_prefill_chunk_size > 0u) {
+        infer_prefill_by_chunks(prompt_data, prefill_len);
+    } else {
+        infer_prefill(prefill_request, prompt_data, prefill_len);
+    }
 
-    // NB: Now there are prompt_len tokens in KV-cache
-    m_kvcache_desc.num_stored_tokens += static_cast<uint32_t>(prompt_len);
-    int64_t last_token = utils::argmax(m_prefill_request.get_tensor("logits"), 0);
-    results.tokens[0].push_back(last_token);
-    if (streamer_ptr && streamer_ptr->put(last_token)) {
-        return results;
+    // NB: Now there are prefill_len tokens in KV-cache
+    m_kvcache_desc.num_stored_tokens += static_cast<uint32_t>(prefill_len);
+    int64_t last_token = m_tokenizer.get_pad_token_id();
+    bool is_finished = false;
+    if (prefill_len == prompt_len) {
+        const auto prefill_logits = prefill_request.get_tensor("logits");
+        last_token = sample_token(prefill_logits, prefill_logits.get_shape().at(1) - 1);
+        is_finished = is_generation_finished(last_token);
+        raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
+        raw_perf_counters.m_batch_sizes.emplace_back(batch_size);
+        if (put_token(last_token)) {
+            return results;
+        }
     }
 
     // Outputs: logits, ...
     const auto kStartOutputKVCacheLayers = 1u;
-    // NB: Copy KV-cache tensors from prefill model to kvcache model
     const auto& kvcache_compiled = m_kvcache_request.get_compiled_model();
 
-    ov::parallel_for(kvcache_compiled.outputs().size() - 1, [&](size_t i) {
-        const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
-        const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
+    // NB: Only outputs of the main prefill model are bound to generate model inputs
+    const bool zero_copy_kvcache = m_zero_copy_kvcache && &prefill_request == &m_prefill_request;
+    // NB: Position in KV-cache inputs, where KV-cache of the next generated tokens is written.
+    // In zero-copy mode prefill has already written the prompt to [max_prompt_size - prefill_len, max_prompt_size)
+    size_t kv_write_pos = zero_copy_kvcache ? m_kvcache_desc.max_prompt_size : m_kvcache_desc.num_stored_tokens;
+    // NB: Position of the first token in KV-cache inputs, i.e. of the first attention sink
+    const size_t kv_begin = kv_write_pos - m_kvcache_desc.num_stored_tokens;
+
+    // NB: Copy KV-cache tensors from prefill model to kvcache model,
+    // chunked prefill has already copied KV-cache of every chunk
+    if (!zero_copy_kvcache && m_prefill_chunk_size == 0u) {
+        ov::parallel_for(kvcache_compiled.outputs().size() - 1, [&](size_t i) {
+            const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
 
-        const auto kv_dim = (output_name.find("value") != std::string::npos &&
-            m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
 
-        auto prefill_out_tensor = m_prefill_request.get_tensor(output_name);
-        auto prefill_out_slice = make_tensor_slice(
-            prefill_out_tensor, kv_dim, m_kvcache_desc.max_prompt_size - m_kvcache_desc.num_stored_tokens, m_kvcache_desc.max_prompt_size
-        );
+            auto prefill_out_tensor = prefill_request.get_tensor(output_name);
+            auto prefill_out_slice = make_tensor_slice(
+                prefill_out_tensor, kv_dim, prefill_size - m_kvcache_desc.num_stored_tokens, prefill_size
+            );
 
-        auto kvcache_in_tensor = m_kvcache_request.get_tensor(input_name);
-        fill_tensor<ov::float16>(kvcache_in_tensor, 0);
+            auto kvcache_in_tensor = m_kvcache_request.get_tensor(input_name);
+            fill_tensor<ov::float16>(kvcache_in_tensor, 0);
 
-        auto kvcache_in_slice = make_tensor_slice(
-            kvcache_in_tensor, kv_dim, 0u, m_kvcache_desc.num_stored_tokens
-        );
+            auto kvcache_in_slice = make_tensor_slice(
+                kvcache_in_tensor, kv_dim, 0u, m_kvcache_desc.num_stored_tokens
+            );
 
-        if (kv_dim == 3u) {
-            copy_columns_by_row_chunks(prefill_out_slice, kvcache_in_slice);
-        } else {
-            prefill_out_slice.copy_to(kvcache_in_slice);
-        }
-    });
+            if (kv_dim == 3u) {
+                copy_columns_by_row_chunks(prefill_out_slice, kvcache_in_slice);
+            } else {
+                prefill_out_slice.copy_to(kvcache_in_slice);
+            }
+        });
+    }
 
     auto* input_ids_data = m_kvcache_request.get_tensor("input_ids").data<int64_t>();
     auto* position_ids_data = m_kvcache_request.get_tensor("position_ids").data<int64_t>();
     auto* attention_mask_data = m_kvcache_request.get_tensor("attention_mask").data<int64_t>();
 
-    // NB: Fill attention mask in the correct format [1, 1 ... 1, 0, 0 ... 0, 1]
-    std::fill(attention_mask_data, attention_mask_data + m_kvcache_desc.num_stored_tokens - 1u, 1u);
-    attention_mask_data[m_kvcache_desc.total_size - 1] = 1u;
-
-    const size_t max_tokens = config.get_max_new_tokens(prompt_len);
-    for (int i = 0; i < max_tokens - 1; ++i) {
-        input_ids_data[0] = last_token;
-        position_ids_data[0] = m_kvcache_desc.num_stored_tokens;
-        attention_mask_data[m_kvcache_desc.num_stored_tokens - 1] = 1u;
-
-        m_kvcache_request.infer();
-        m_kvcache_desc.num_stored_tokens += 1;
+    // NB: Generate model processes the last token followed by up to (num_input_tokens - 1) prompt lookup candidates,
+    // whose KV-cache occupies the last num_input_tokens positions of attention mask
+    const size_t num_input_tokens = m_kvcache_request.get_tensor("input_ids").get_size();
+    const size_t num_candidates = config.is_prompt_lookup() && !use_sampler ? std::min(config.num_assistant_tokens, num_input_tokens - 1) : 0u;
+    const size_t new_tokens_offset = m_kvcache_desc.total_size - num_input_tokens;
+    NGramIndex ngram_index(std::max<size_t>(config.max_ngram_size, 1u));
+    if (num_candidates > 0) {
+        for (size_t i = 0; i < prompt_len; ++i) {
+            ngram_index.append(prompt_data[i]);
+        }
+        if (prefill_len == prompt_len) {
+            ngram_index.append(last_token);
+        }
+    }
+    if (m_kvcache_sliding_window) {
+        OPENVINO_ASSERT(kv_begin + m_num_attention_sinks + num_input_tokens < new_tokens_offset,
+                        "KV-cache of ", new_tokens_offset - kv_begin, " tokens is too small to keep ",
+                        m_num_attention_sinks, " attention sinks in sliding window mode");
+    }
 
-        last_token = utils::argmax(m_kvcache_request.get_tensor("logits"), 0);
-        results.tokens[0].push_back(last_token);
+    // NB: Fill attention mask in the correct format [1, 1 ... 1, 0, 0 ... 0, 1 ... 1, 0 ... 0]
+    std::fill(attention_mask_data + kv_begin, attention_mask_data + kv_write_pos, 1u);
 
-        raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
-        raw_perf_counters.m_batch_sizes.emplace_back(batch_size);
-        if (streamer_ptr && streamer_ptr->put(last_token)) {
-            break;
+    // NB: Makes room for KV-cache of num_tokens new tokens, in sliding window mode the oldest tokens
+    // following attention sinks are evicted, returns false if KV-cache is full otherwise
+    auto reserve_kvcache = [&](size_t num_tokens) {
+        if (kv_write_pos + num_tokens <= new_tokens_offset) {
+            return true;
         }
-
-        if (last_token == config.eos_token_id && !config.ignore_eos) {
-            break;
+        if (!m_kvcache_sliding_window) {
+            return false;
         }
+        // NB: Evict at least 1/8 of the window at once, so that KV-cache isn't shifted for every new token
+        const size_t kv_window_begin = kv_begin + m_num_attention_sinks;
+        const size_t num_evicted = std::min(std::max(kv_write_pos + num_tokens - new_tokens_offset,
+                                                     (new_tokens_offset - kv_window_begin) / 8u),
+                                            kv_write_pos - kv_window_begin);
+        ov::parallel_for(kvcache_compiled.outputs().size() - 1, [&](size_t i) {
+            const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
 
-        // NB: KV-cache is full, further generation is impossible
-        if (m_kvcache_desc.num_stored_tokens == m_kvcache_desc.total_size) {
-            break;
-        }
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
 
-        // NB: Write KV-cache for the new token to the correct input position for the next iteration
+            auto kvcache_in_tensor = m_kvcache_request.get_tensor(input_name);
+            move_kv_positions(kvcache_in_tensor, kv_dim, kv_window_begin + num_evicted, kv_write_pos, kv_window_begin);
+        });
+        std::fill(attention_mask_data + kv_write_pos - num_evicted, attention_mask_data + kv_write_pos, 0u);
+        kv_write_pos -= num_evicted;
+        return true;
+    };
+
+    // NB: Writes KV-cache for the valid input tokens to the correct input positions for the next iteration
+    auto store_kvcache = [&](size_t num_valid_tokens) {
         for (int i = 0; i < kvcache_compiled.outputs().size() - 1; ++i) {
             const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
             std::string input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
@@ -1096,14 +1499,106 @@ EncodedResults StaticLLMPipeline::generate(
             const auto kv_dim = (output_name.find("value") != std::string::npos &&
                 m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
 
+            auto kvcache_out_slice = make_tensor_slice(
+                m_kvcache_request.get_tensor(output_name), kv_dim, 0u, num_valid_tokens
+            );
             auto kvcache_in_tensor = m_kvcache_request.get_tensor(input_name);
             auto kvcache_in_slice = make_tensor_slice(
-                kvcache_in_tensor, kv_dim, m_kvcache_desc.num_stored_tokens - 1, m_kvcache_desc.num_stored_tokens
+                kvcache_in_tensor, kv_dim, kv_write_pos, kv_write_pos + num_valid_tokens
             );
-            m_kvcache_request.get_tensor(output_name).copy_to(kvcache_in_slice);
+            if (kv_dim == 3u) {
+                copy_columns_by_row_chunks(kvcache_out_slice, kvcache_in_slice);
+            } else {
+                kvcache_out_slice.copy_to(kvcache_in_slice);
+            }
         }
+        std::fill(attention_mask_data + kv_write_pos,
+                  attention_mask_data + kv_write_pos + num_valid_tokens, 1u);
+        kv_write_pos += num_valid_tokens;
+        m_kvcache_desc.num_stored_tokens += static_cast<uint32_t>(num_valid_tokens);
+    };
+
+    // NB: Pass the rest of the prompt through generate model by chunks of num_input_tokens tokens
+    for (size_t pos = prefill_len; pos < prompt_len; ) {
+        const size_t chunk_size = std::min(num_input_tokens, prompt_len - pos);
+        std::copy_n(prompt_data + pos, chunk_size, input_ids_data);
+        std::fill(input_ids_data + chunk_size, input_ids_data + num_input_tokens, m_tokenizer.get_pad_token_id());
+        for (size_t i = 0; i < num_input_tokens; ++i) {
+            position_ids_data[i] = m_kvcache_desc.num_stored_tokens + i;
+            attention_mask_data[new_tokens_offset + i] = i < chunk_size ? 1u : 0u;
+        }
+
+        m_kvcache_request.infer();
+        pos += chunk_size;
+        if (pos == prompt_len) {
+            last_token = sample_token(m_kvcache_request.get_tensor("logits"), chunk_size - 1);
+            is_finished = is_generation_finished(last_token);
+            raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
+            raw_perf_counters.m_batch_sizes.emplace_back(batch_size);
+            if (num_candidates > 0) {
+                ngram_index.append(last_token);
+            }
+            if (put_token(last_token)) {
+                return results;
+            }
+        }
+        reserve_kvcache(chunk_size);
+        store_kvcache(chunk_size);
     }
 
+    const size_t max_tokens = config.get_max_new_tokens(prompt_len);
+    while (!is_finished && results.tokens[0].size() < max_tokens) {
+        TokenIds candidates = num_candidates > 0 ? ngram_index.find_candidates(num_candidates) : TokenIds{};
+        // NB: Each candidate accepted produces one more token, which must not exceed max_tokens
+        candidates.resize(std::min(candidates.size(), max_tokens - results.tokens[0].size() - 1));
+
+        input_ids_data[0] = last_token;
+        std::copy(candidates.begin(), candidates.end(), input_ids_data + 1);
+        std::fill(input_ids_data + 1 + candidates.size(), input_ids_data + num_input_tokens, m_tokenizer.get_pad_token_id());
+        for (size_t i = 0; i < num_input_tokens; ++i) {
+            position_ids_data[i] = m_kvcache_desc.num_stored_tokens + i;
+            attention_mask_data[new_tokens_offset + i] = i <= candidates.size() ? 1u : 0u;
+        }
+
+        m_kvcache_request.infer();
+
+        // NB: Input tokens are valid up to the first rejected candidate, each of them produces a new token
+        const auto logits = m_kvcache_request.get_tensor("logits");
+        size_t num_valid_tokens = 0;
+        while (!is_finished && num_valid_tokens <= candidates.size()) {
+            last_token = sample_token(logits, num_valid_tokens);
+            const bool is_rejected = num_valid_tokens == candidates.size() || candidates[num_valid_tokens] != last_token;
+            ++num_valid_tokens;
+            if (num_candidates > 0) {
+                ngram_index.append(last_token);
+            }
+
+            raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
+            raw_perf_counters.m_batch_sizes.emplace_back(batch_size);
+            if (put_token(last_token)) {
+                is_finished = true;
+            }
+
+            if (is_generation_finished(last_token)) {
+                is_finished = true;
+            }
+
+            if (is_rejected) {
+                break;
+            }
+        }
+
+        // NB: KV-cache is full, further generation is impossible
+        if (is_finished || !reserve_kvcache(num_valid_tokens)) {
+            break;
+        }
+        store_kvcache(num_valid_tokens);
+    }
+    if (sequence_group) {
+        // NB: Tokens held for stop strings are streamed, if generation stops before the sequence finishes, e.g. on full KV-cache
+        stream_tokens(0u);
+        m_sampler.clear_request_info(sequence_group->get_request_id());
+    }
     if (streamer_ptr) {
         streamer_ptr->end();
     }
@@ -1118,5 +1613,166 @@ EncodedResults StaticLLMPipeline::generate(
     return results;
 }
 
+EncodedResults StaticLLMPipeline::generate_batched(
+    const ov::Tensor& input_ids,
+    const ov::Tensor& attention_mask,
+    const GenerationConfig& config,
+    std::chrono::steady_clock::time_point start_time
+) {
+    const size_t num_prompts = input_ids.get_shape().at(0);
+    const size_t padded_prompt_len = input_ids.get_shape().at(1);
+    ov::genai::EncodedResults results;
+    auto& raw_perf_counters = results.perf_metrics.raw_metrics;
+    results.scores.assign(num_prompts, 0.0f);
+    results.tokens.resize(num_prompts);
+
+    prepare_for_new_conversation();
+
+    // Outputs: logits, ...
+    const auto kStartOutputKVCacheLayers = 1u;
+    const auto& kvcache_compiled = m_kvcache_request.get_compiled_model();
+
+    auto* input_ids_data = m_kvcache_request.get_tensor("input_ids").data<int64_t>();
+    auto* position_ids_data = m_kvcache_request.get_tensor("position_ids").data<int64_t>();
+    auto* attention_mask_data = m_kvcache_request.get_tensor("attention_mask").data<int64_t>();
+
+    // NB: Each row of generate model processes its last token, prompt lookup candidates aren't used in batched mode
+    const size_t num_input_tokens = m_kvcache_request.get_tensor("input_ids").get_shape().at(1);
+    const size_t new_tokens_offset = m_kvcache_desc.total_size - num_input_tokens;
+
+    std::vector<int64_t> last_tokens(m_batch_size, m_tokenizer.get_pad_token_id());
+    // NB: Number of tokens in KV-cache of each row, which is also the position of the next token
+    std::vector<size_t> num_stored_tokens(m_batch_size, 0u);
+    std::vector<size_t> max_tokens(m_batch_size, 0u);
+    std::vector<bool> is_active(m_batch_size, false);
+
+    // NB: Prefill prompts one by one and copy their KV-cache to the corresponding rows of generate model inputs
+    for (size_t row = 0; row < num_prompts; ++row) {
+        std::vector<int64_t> prompt;
+        const auto* row_input_ids = input_ids.data<int64_t>() + row * padded_prompt_len;
+        const auto* row_attention_mask = attention_mask.data<int64_t>() + row * padded_prompt_len;
+        for (size_t i = 0; i < padded_prompt_len; ++i) {
+            if (row_attention_mask[i] != 0) {
+                prompt.push_back(row_input_ids[i]);
+            }
+        }
+        OPENVINO_ASSERT(!prompt.empty(), "Prompt ", row, " is empty");
+        if (prompt.size() > m_kvcache_desc.max_prompt_size) {
+            OPENVINO_THROW("Static LLM pipeline may only process prompts up to "
+                           + std::to_string(m_kvcache_desc.max_prompt_size) + " tokens. "
+                           + "Set the \"MAX_PROMPT_LEN\" config option to increase the limit.");
+        }
+
+        auto& prefill_request = select_prefill_request(prompt.size());
+        const size_t prefill_size = prefill_request.get_tensor("input_ids").get_size();
+        infer_prefill(prefill_request, prompt.data(), prompt.size());
+
+        last_tokens[row] = utils::argmax(prefill_request.get_tensor("logits"), 0);
+        results.tokens[row].push_back(last_tokens[row]);
+        num_stored_tokens[row] = prompt.size();
+        max_tokens[row] = config.get_max_new_tokens(prompt.size());
+
+        ov::parallel_for(kvcache_compiled.outputs().size() - 1, [&](size_t i) {
+            const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
+
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
+
+            auto prefill_out_slice = make_tensor_slice(
+                prefill_request.get_tensor(output_name), kv_dim, prefill_size - prompt.size(), prefill_size
+            );
+            auto kvcache_in_slice = make_row_tensor_slice(
+                m_kvcache_request.get_tensor(input_name), m_kv_batch_dim, row, kv_dim, 0u, prompt.size()
+            );
+            if (kv_dim == 3u) {
+                copy_columns_by_row_chunks(prefill_out_slice, kvcache_in_slice);
+            } else {
+                prefill_out_slice.copy_to(kvcache_in_slice);
+            }
+        });
+        std::fill_n(attention_mask_data + row * m_kvcache_desc.total_size, prompt.size(), 1u);
+
+        is_active[row] = results.tokens[row].size() < max_tokens[row] &&
+            (last_tokens[row] != config.eos_token_id || config.ignore_eos);
+    }
+    raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
+    raw_perf_counters.m_batch_sizes.emplace_back(num_prompts);
+
+    while (std::find(is_active.begin(), is_active.end(), true) != is_active.end()) {
+        // NB: Finished and unused rows are still computed, but their outputs are ignored
+        for (size_t row = 0; row < m_batch_size; ++row) {
+            auto* row_input_ids = input_ids_data + row * num_input_tokens;
+            auto* row_position_ids = position_ids_data + row * num_input_tokens;
+            auto* row_attention_mask = attention_mask_data + row * m_kvcache_desc.total_size;
+            row_input_ids[0] = last_tokens[row];
+            std::fill(row_input_ids + 1, row_input_ids + num_input_tokens, m_tokenizer.get_pad_token_id());
+            for (size_t i = 0; i < num_input_tokens; ++i) {
+                row_position_ids[i] = num_stored_tokens[row] + i;
+                row_attention_mask[new_tokens_offset + i] = i == 0 ? 1u : 0u;
+            }
+        }
+
+        m_kvcache_request.infer();
+
+        const auto logits = m_kvcache_request.get_tensor("logits");
+        size_t num_active_rows = 0;
+        for (size_t row = 0; row < m_batch_size; ++row) {
+            if (!is_active[row]) {
+                continue;
+            }
+            ++num_active_rows;
+            last_tokens[row] = argmax_at_position(logits, row * num_input_tokens);
+            results.tokens[row].push_back(last_tokens[row]);
+            // NB: Row is finished, if KV-cache of its input token can't be stored for the next iteration
+            is_active[row] = results.tokens[row].size() < max_tokens[row] &&
+                (last_tokens[row] != config.eos_token_id || config.ignore_eos) &&
+                num_stored_tokens[row] + 1u <= new_tokens_offset;
+        }
+        raw_perf_counters.m_new_token_times.emplace_back(std::chrono::steady_clock::now());
+        raw_perf_counters.m_batch_sizes.emplace_back(num_active_rows);
+
+        // NB: Write KV-cache of the input tokens of active rows to the correct input positions for the next iteration
+        ov::parallel_for(kvcache_compiled.outputs().size() - 1, [&](size_t i) {
+            const auto& output_name = kvcache_compiled.outputs()[kStartOutputKVCacheLayers + i].get_any_name();
+            const auto  input_name = std::regex_replace(output_name, std::regex("present"), "past_key_values");
+
+            const auto kv_dim = (output_name.find("value") != std::string::npos &&
+                m_kvcache_desc.v_tensors_transposed) ? 3u : m_kvcache_desc.seq_len;
+
+            auto kvcache_out_tensor = m_kvcache_request.get_tensor(output_name);
+            auto kvcache_in_tensor = m_kvcache_request.get_tensor(input_name);
+            for (size_t row = 0; row < m_batch_size; ++row) {
+                if (!is_active[row]) {
+                    continue;
+                }
+                auto kvcache_out_slice = make_row_tensor_slice(kvcache_out_tensor, m_kv_batch_dim, row, kv_dim, 0u, 1u);
+                auto kvcache_in_slice = make_row_tensor_slice(
+                    kvcache_in_tensor, m_kv_batch_dim, row, kv_dim, num_stored_tokens[row], num_stored_tokens[row] + 1u
+                );
+                if (kv_dim == 3u) {
+                    copy_columns_by_row_chunks(kvcache_out_slice, kvcache_in_slice);
+                } else {
+                    kvcache_out_slice.copy_to(kvcache_in_slice);
+                }
+            }
+        });
+        for (size_t row = 0; row < m_batch_size; ++row) {
+            if (is_active[row]) {
+                attention_mask_data[row * m_kvcache_desc.total_size + num_stored_tokens[row]] = 1u;
+                ++num_stored_tokens[row];
+            }
+        }
+    }
+
+    auto stop_time = std::chrono::steady_clock::now();
+    auto& metrics = results.perf_metrics;
+    metrics.num_input_tokens = num_prompts * padded_prompt_len;
+    metrics.load_time = this->m_load_time_ms;
+    metrics.raw_metrics.generate_durations.emplace_back(PerfMetrics::get_microsec(stop_time - start_time));
+    metrics.evaluate_statistics(start_time);
+    return results;
+}
+
 }  // namespace genai
 }  // namespace ov
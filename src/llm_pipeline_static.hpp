@@ -6,6 +6,7 @@
 #include <filesystem>
 
 #include "llm_pipeline_base.hpp"
+#include "sampler.hpp"
 
 namespace ov {
 namespace genai {
@@ -67,6 +68,16 @@ public:
     void finish_chat() override;
 private:
     void prepare_for_new_conversation();
+    void bind_prefill_kvcache_outputs();
+    void infer_prefill_by_chunks(const int64_t* prompt_data, size_t prompt_len);
+    ov::InferRequest& select_prefill_request(size_t prompt_len);
+    void infer_prefill(ov::InferRequest& prefill_request, const int64_t* prompt_data, size_t prompt_len);
+    EncodedResults generate_batched(
+        const ov::Tensor& input_ids,
+        const ov::Tensor& attention_mask,
+        const GenerationConfig& config,
+        std::chrono::steady_clock::time_point start_time
+    );
 
 private:
     struct KVCacheDesc {
@@ -80,6 +91,19 @@ private:
     KVCacheDesc m_kvcache_desc;
     ov::InferRequest m_kvcache_request;
     ov::InferRequest m_prefill_request;
+    Sampler m_sampler;
+    // prefill models for prompts shorter than max_prompt_size, ascending by prompt size
+    std::vector<ov::InferRequest> m_prefill_bucket_requests;
+    // prefill KV-cache outputs are views of kvcache model inputs
+    bool m_zero_copy_kvcache = false;
+    // prefill model processes prompt by chunks of this size and appends their KV-cache, 0 if it processes whole prompt
+    uint32_t m_prefill_chunk_size = 0u;
+    // the oldest tokens following m_num_attention_sinks first ones are evicted from full KV-cache
+    bool m_kvcache_sliding_window = false;
+    uint32_t m_num_attention_sinks = 4u;
+    // generate model decodes up to m_batch_size prompts together, KV-cache rows are along m_kv_batch_dim
+    uint32_t m_batch_size = 1u;
+    uint32_t m_kv_batch_dim = 0u;
 
     bool m_is_chat_conversation = false;
     ChatHistory m_history;
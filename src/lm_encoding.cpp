@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <numeric>
 #include <random>
@@ -49,6 +50,20 @@ void update_attention_mask_with_beams(ov::Tensor&& attention_mask, std::vector<i
     }
 }
 
+// copies columns [begin, end) of each row of a tensor of shape [batch, length, ...]
+ov::Tensor slice_columns(const ov::Tensor& tensor, size_t begin, size_t end) {
+    ov::Shape shape = tensor.get_shape();
+    const size_t num_rows = shape.at(0), row_length = shape.at(1);
+    const size_t column_byte_size = tensor.get_byte_size() / (num_rows * row_length);
+    shape[1] = end - begin;
+    ov::Tensor slice(tensor.get_element_type(), shape);
+    const auto src = static_cast<const uint8_t*>(tensor.data());
+    auto dst = static_cast<uint8_t*>(slice.data());
+    for (size_t row = 0; row < num_rows; ++row) {
+        std::memcpy(dst + row * shape[1] * column_byte_size, src + (row * row_length + begin) * column_byte_size, shape[1] * column_byte_size);
+    }
+    return slice;
+}
 
 std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
     ov::InferRequest& m_llm,
@@ -58,7 +73,8 @@ std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
     Sampler& sampler,
     std::vector<SequenceGroup::Ptr> sequence_groups,
     std::optional<ov::Tensor> position_ids,
-    std::optional<EmbeddingsModel> m_embedding
+    std::optional<EmbeddingsModel> m_embedding,
+    size_t prefill_chunk_size
 ) {
     std::vector<GenerationHandle> generations;
     for (SequenceGroup::Ptr sequence_group : sequence_groups) {
@@ -68,23 +84,54 @@ std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
     }
 
     auto active_sequence_groups{sequence_groups};
+    // finished groups leave the batch at once: beam_idx of the next step gathers KV cache rows of the remaining sequences only,
+    // so the batch, its attention mask and KV cache shrink instead of carrying finished rows until the longest group is done
+    auto drop_finished_sequence_groups = [&active_sequence_groups] () {
+        auto removed_it = std::remove_if(active_sequence_groups.begin(),
+            active_sequence_groups.end(),
+            [](SequenceGroup::Ptr sg) -> bool {
+                return sg->has_finished() || sg->out_of_memory() || sg->handle_dropped();
+            });
+        active_sequence_groups.erase(removed_it, active_sequence_groups.end());
+    };
 
     ov::Shape prompts_shape = input_ids.get_shape();
     const size_t batch_size = prompts_shape[0];
 
     EncodedResults results;
-    
-    m_llm.set_tensor(m_embedding.has_value() ? "inputs_embeds" : "input_ids", input_ids);
-    m_llm.set_tensor("attention_mask", attention_mask);
-    if (position_ids.has_value())
-        m_llm.set_tensor("position_ids", *position_ids);
+    const std::string input_name = m_embedding.has_value() ? "inputs_embeds" : "input_ids";
+    const size_t prompt_len = prompts_shape[1];
 
     ov::Tensor beam_idx = ov::Tensor(ov::element::i32, {batch_size});
     std::fill_n(beam_idx.data<int32_t>(), batch_size, 0);
     m_llm.set_tensor("beam_idx", beam_idx);
 
     // "Prompt" phase
-    m_llm.infer();
+    if (prefill_chunk_size == 0 || prompt_len <= prefill_chunk_size) {
+        m_llm.set_tensor(input_name, input_ids);
+        m_llm.set_tensor("attention_mask", attention_mask);
+        if (position_ids.has_value())
+            m_llm.set_tensor("position_ids", *position_ids);
+        m_llm.infer();
+    } else {
+        // each chunk of the prompt attends to KV cache of previous chat turns and previous chunks, which precede it in attention mask;
+        // logits of the last chunk are used
+        const size_t kv_cache_len = attention_mask.get_shape().at(1) - prompt_len;
+        for (size_t begin = 0; begin < prompt_len; begin += prefill_chunk_size) {
+            const size_t end = std::min(begin + prefill_chunk_size, prompt_len);
+            m_llm.set_tensor(input_name, slice_columns(input_ids, begin, end));
+            m_llm.set_tensor("attention_mask", slice_columns(attention_mask, 0, kv_cache_len + end));
+            if (position_ids.has_value())
+                m_llm.set_tensor("position_ids", slice_columns(*position_ids, begin, end));
+            m_llm.infer();
+            if (begin == 0) {
+                // the next chunks keep KV cache rows of the prompts in place
+                ov::Tensor identity_beam_idx(ov::element::i32, {batch_size});
+                std::iota(identity_beam_idx.data<int32_t>(), identity_beam_idx.data<int32_t>() + batch_size, 0);
+                m_llm.set_tensor("beam_idx", identity_beam_idx);
+            }
+        }
+    }
     auto logits = m_llm.get_tensor("logits");
 
     int64_t sequence_len = logits.get_shape().at(1);
@@ -98,6 +145,13 @@ std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
         beam_offets.insert({sequence_groups.at(i)->get_request_id(), i});
 
     sampler.sample(sequence_groups, logits);
+    drop_finished_sequence_groups();
+
+    // embeddings of generated tokens are written directly to a tensor reused by all steps and passed to the language model as is,
+    // if the language model accepts the output type of the embeddings model
+    ov::Tensor decode_embeds;
+    if (m_embedding.has_value() && m_embedding->get_output_element_type() == m_llm.get_compiled_model().input("inputs_embeds").get_element_type())
+        decode_embeds = ov::Tensor(m_embedding->get_output_element_type(), {batch_size, 1, prompts_shape.at(2)});
 
     while (!active_sequence_groups.empty()) {
         size_t total_num_tokens = 0;
@@ -134,12 +188,18 @@ std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
             }
         }
 
-        for (size_t i = 0; i < active_sequence_groups.size(); i++) {
-            beam_offets[active_sequence_groups.at(i)->get_request_id()] = 
-                i == 0 ? 0 : (active_sequence_groups.at(i - 1)->num_running_seqs() + beam_offets[i - 1]);
+        // rows of the groups in the batch being inferred, from which the next step gathers their KV cache
+        size_t row_offset = 0;
+        for (auto& sequence_group : active_sequence_groups) {
+            beam_offets[sequence_group->get_request_id()] = row_offset;
+            row_offset += sequence_group->num_running_seqs();
         }
 
-        if (m_embedding.has_value()) {
+        if (decode_embeds) {
+            decode_embeds.set_shape({total_num_tokens, 1, decode_embeds.get_shape().at(2)});
+            m_embedding->infer(new_input_ids, decode_embeds);
+            m_llm.set_tensor("inputs_embeds", decode_embeds);
+        } else if (m_embedding.has_value()) {
             const ov::Tensor& embed_prompt_tensor = (*m_embedding).infer(new_input_ids);
             m_llm.set_tensor("inputs_embeds", embed_prompt_tensor);
         } else {
@@ -156,13 +216,7 @@ std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(
 
         m_llm.infer();
         sampler.sample(active_sequence_groups, m_llm.get_tensor("logits"));
-        
-        auto removed_it = std::remove_if(active_sequence_groups.begin(), 
-            active_sequence_groups.end(),
-            [](SequenceGroup::Ptr sg) -> bool {
-                return sg->has_finished() || sg->out_of_memory() || sg->handle_dropped();
-            });
-        active_sequence_groups.erase(removed_it, active_sequence_groups.end());
+        drop_finished_sequence_groups();
     }
 
     for (auto& sequence_group : sequence_groups) {
@@ -8,9 +8,14 @@
 namespace ov {
 namespace genai {
 
+/**
+ * @param prefill_chunk_size Maximum number of prompt tokens per inference of the prompt phase, so that peak memory of activations
+ * does not grow with a prompt length; 0 to infer the whole prompt at once.
+ */
 std::pair<EncodedResults, std::optional<int64_t>> get_lm_encoded_results(ov::InferRequest& m_llm, const ov::Tensor& input_ids, const ov::Tensor& attention_mask,
                                                                          const std::shared_ptr<StreamerBase>& streamer_ptr, Sampler& sampler, std::vector<SequenceGroup::Ptr> sequence_groups,
-                                                                         std::optional<ov::Tensor> position_ids, std::optional<EmbeddingsModel> m_embedding);
+                                                                         std::optional<ov::Tensor> position_ids, std::optional<EmbeddingsModel> m_embedding,
+                                                                         size_t prefill_chunk_size = 0);
 
 }
 }
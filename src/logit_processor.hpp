@@ -5,8 +5,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "openvino/genai/generation_config.hpp"
+#include "structured_output/structured_output_grammar.hpp"
 
 struct Token {
     float m_log_prob = 0.;
@@ -155,30 +157,215 @@ protected:
 };
 
 
+// Fused equivalent of TemperatureLogitTransform followed by TopPFilter and / or TopKFilter.
+// Instead of materializing and sorting all tokens of the vocabulary, probabilities are bucketed by the leading bits
+// of their float representation (which are ordered as values for non-negative floats), so that a single histogram pass
+// selects the bucket, where top_p probability mass or top_k tokens are reached. Only tokens from this bucket and
+// the ones above are gathered and sorted.
+class FusedTemperatureTopPTopKTransform : public ILogitTransformer {
+public:
+    FusedTemperatureTopPTopKTransform(double temperature, double top_p, size_t top_k) :
+        m_temperature(temperature), m_top_p(top_p), m_top_k(top_k) {}
+
+    void apply(Logits& logits) override {
+        OPENVINO_ASSERT(!logits.is_vector_initialized(), "Logits vector already initialized");
+        float* data = logits.m_data;
+        const size_t size = logits.m_size;
+
+        float max_logit = -std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < size; i++) {
+            max_logit = std::max(max_logit, data[i]);
+        }
+
+        // unnormalized probabilities, normalization is applied to the selected tokens only
+        const float inv_temperature = 1.0f / m_temperature;
+        float norm_sum = 0.0f;
+        for (size_t i = 0; i < size; i++) {
+            data[i] = expf((data[i] - max_logit) * inv_temperature);
+            norm_sum += data[i];
+        }
+
+        const bool use_top_p = m_top_p < 1.0;
+        const bool use_top_k = m_top_k < size;
+        if (!use_top_p && !use_top_k) {
+            for (size_t i = 0; i < size; i++) {
+                data[i] /= norm_sum;
+            }
+            return;
+        }
+
+        // probabilities are in [0, 1], so the buckets below cover all of them
+        std::fill(m_bucket_counts.begin(), m_bucket_counts.end(), 0);
+        std::fill(m_bucket_masses.begin(), m_bucket_masses.end(), 0.0f);
+        for (size_t i = 0; i < size; i++) {
+            size_t bucket = get_bucket(data[i]);
+            m_bucket_counts[bucket] += 1;
+            m_bucket_masses[bucket] += data[i];
+        }
+
+        const float top_p_mass = static_cast<float>(m_top_p) * norm_sum;
+        size_t threshold_bucket = 0, num_candidates = 0;
+        float candidates_mass = 0.0f;
+        for (size_t bucket = NUM_BUCKETS; bucket-- > 0; ) {
+            num_candidates += m_bucket_counts[bucket];
+            candidates_mass += m_bucket_masses[bucket];
+            if ((use_top_k && num_candidates >= m_top_k) || (use_top_p && candidates_mass > top_p_mass)) {
+                threshold_bucket = bucket;
+                break;
+            }
+        }
+
+        logits.m_vector.reserve(num_candidates);
+        for (size_t i = 0; i < size; i++) {
+            if (get_bucket(data[i]) >= threshold_bucket)
+                logits.m_vector.emplace_back(data[i] / norm_sum, i);
+        }
+        std::sort(logits.m_vector.begin(), logits.m_vector.end(), [](const Token& lhs, const Token& rhs) {return lhs.m_log_prob > rhs.m_log_prob; });
+
+        size_t new_size = logits.m_vector.size();
+        if (use_top_p) {
+            float probability_sum = 0.0f;
+            for (size_t i = 0; i < logits.m_vector.size(); i++) {
+                probability_sum += logits.m_vector[i].m_log_prob;
+                if (probability_sum > m_top_p) {
+                    new_size = i + 1;
+                    break;
+                }
+            }
+        }
+        if (use_top_k) {
+            new_size = std::min(new_size, m_top_k);
+        }
+        logits.resize(new_size);
+    }
+
+protected:
+    // exponent and 2 leading bits of mantissa, the largest bucket of 1.0f is 0x3F800000 >> 21 = 508
+    static constexpr size_t BUCKET_SHIFT = 21;
+    static constexpr size_t NUM_BUCKETS = 512;
+
+    static size_t get_bucket(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        // NaN goes to the top bucket
+        return std::min<size_t>(bits >> BUCKET_SHIFT, NUM_BUCKETS - 1);
+    }
+
+    float m_temperature = 0.f;
+    double m_top_p = 1.f;
+    size_t m_top_k = std::numeric_limits<size_t>::max();
+    // histogram scratch buffers, reused across tokens
+    std::vector<uint32_t> m_bucket_counts = std::vector<uint32_t>(NUM_BUCKETS);
+    std::vector<float> m_bucket_masses = std::vector<float>(NUM_BUCKETS);
+};
+
+
+/**
+ * Occurrences of tokens in a prompt and generated tokens of a request. Tokens are stored densely in insertion order and found via
+ * an open-addressing table, so that updates are O(1) and penalties are applied by a single pass over the touched tokens only.
+ */
+class TokenOccurrences {
+    static constexpr int32_t EMPTY_SLOT = -1;
+
+    // structure of arrays, so that penalties are applied as a gather / scatter over logits
+    std::vector<int64_t> m_token_ids;
+    std::vector<uint32_t> m_generated_counts;
+    std::vector<uint8_t> m_is_in_prompt;
+    int64_t m_max_token_id = -1;
+
+    // indices of tokens in m_token_ids, linear probing over power of two capacity
+    std::vector<int32_t> m_slots = std::vector<int32_t>(16, EMPTY_SLOT);
+
+    size_t find_slot(int64_t token_id) const {
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = static_cast<size_t>(static_cast<uint64_t>(token_id) * 0x9E3779B97F4A7C15ull) & mask;
+        while (m_slots[slot] != EMPTY_SLOT && m_token_ids[m_slots[slot]] != token_id)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    size_t get_or_insert(int64_t token_id) {
+        OPENVINO_ASSERT(token_id >= 0, "input_ids token out of bounds");
+        size_t slot = find_slot(token_id);
+        if (m_slots[slot] != EMPTY_SLOT)
+            return m_slots[slot];
+        m_slots[slot] = static_cast<int32_t>(m_token_ids.size());
+        m_token_ids.push_back(token_id);
+        m_generated_counts.push_back(0);
+        m_is_in_prompt.push_back(0);
+        m_max_token_id = std::max(m_max_token_id, token_id);
+        // load factor is kept below 1/2
+        if (2 * m_token_ids.size() > m_slots.size()) {
+            m_slots.assign(2 * m_slots.size(), EMPTY_SLOT);
+            for (size_t idx = 0; idx < m_token_ids.size(); ++idx)
+                m_slots[find_slot(m_token_ids[idx])] = static_cast<int32_t>(idx);
+        }
+        return m_token_ids.size() - 1;
+    }
+
+public:
+    void add_prompt_token(int64_t token_id) {
+        m_is_in_prompt[get_or_insert(token_id)] = 1;
+    }
+
+    void add_generated_token(int64_t token_id) {
+        ++m_generated_counts[get_or_insert(token_id)];
+    }
+
+    void remove_generated_token(int64_t token_id) {
+        size_t slot = find_slot(token_id);
+        OPENVINO_ASSERT(m_slots[slot] != EMPTY_SLOT && m_generated_counts[m_slots[slot]] > 0);
+        // the entry is kept with zero count, since tokens are usually generated again after removal
+        --m_generated_counts[m_slots[slot]];
+    }
+
+    size_t get_generated_count(int64_t token_id) const {
+        size_t slot = find_slot(token_id);
+        return m_slots[slot] == EMPTY_SLOT ? 0 : m_generated_counts[m_slots[slot]];
+    }
+
+    size_t size() const {
+        return m_token_ids.size();
+    }
+
+    const int64_t* token_ids() const {
+        return m_token_ids.data();
+    }
+
+    const uint32_t* generated_counts() const {
+        return m_generated_counts.data();
+    }
+
+    const uint8_t* is_in_prompt() const {
+        return m_is_in_prompt.data();
+    }
+
+    void check_bounds(size_t vocab_size) const {
+        OPENVINO_ASSERT(m_max_token_id < static_cast<int64_t>(vocab_size), "input_ids token out of bounds");
+    }
+};
+
 class IPenaltyTransformer : public ILogitTransformer {
 public:
-    void set_unique_generated_token_ids(const std::shared_ptr<std::map<int64_t, size_t>>& unique_generated_token_ids) {
-        if (unique_generated_token_ids != nullptr) {
-            m_unique_generated_token_ids = unique_generated_token_ids;
+    void set_token_occurrences(const std::shared_ptr<TokenOccurrences>& token_occurrences) {
+        if (token_occurrences != nullptr) {
+            m_token_occurrences = token_occurrences;
         } else {
-            m_unique_generated_token_ids = std::shared_ptr<std::map<int64_t, size_t>>(new std::map<int64_t, size_t>);
+            m_token_occurrences = std::make_shared<TokenOccurrences>();
         }
     }
 
     void extract_generated_tokens(const TokenIds& input_ids) {
-        set_unique_generated_token_ids(m_unique_generated_token_ids);
+        if (m_token_occurrences == nullptr)
+            set_token_occurrences(nullptr);
 
         for (const auto& input_id : input_ids) {
-            if (m_unique_generated_token_ids->count(input_id)) {
-                m_unique_generated_token_ids->at(input_id)++;
-            } else {
-                m_unique_generated_token_ids->insert({input_id, 1});
-            }
+            m_token_occurrences->add_generated_token(input_id);
         }
     }
 
 protected:
-    std::shared_ptr<std::map<int64_t, size_t>> m_unique_generated_token_ids = nullptr;
+    std::shared_ptr<TokenOccurrences> m_token_occurrences = nullptr;
     double m_penalty = 0.f;
 };
 
@@ -189,47 +376,24 @@ public:
     };
 
     void apply(Logits& logits) override {
-        size_t vocab_size = logits.m_size;
-        for (const auto& prompt_id : *m_unique_prompt_token_ids) {
-            OPENVINO_ASSERT((prompt_id >= 0) && (prompt_id < vocab_size), "input_ids token out of bounds");
-            if (logits.m_data[prompt_id] >= 0) {
-                logits.m_data[prompt_id] /= m_penalty;
-            } else {
-                logits.m_data[prompt_id] *= m_penalty;
-            };
-        }
-        for (const auto& input_id_pair : *m_unique_generated_token_ids) {
-            const auto& input_id = input_id_pair.first;
-            if (1 == m_unique_prompt_token_ids->count(input_id)) {
-                // repetition_penalty was already accounted by the for
-                // loop above.
-                continue;
-            }
-            OPENVINO_ASSERT((input_id >= 0) && (input_id < vocab_size), "input_ids token out of bounds");
-            if (logits.m_data[input_id] >= 0) {
-                logits.m_data[input_id] /= m_penalty;
-            } else {
-                logits.m_data[input_id] *= m_penalty;
-            };
+        m_token_occurrences->check_bounds(logits.m_size);
+        const size_t num_tokens = m_token_occurrences->size();
+        const int64_t* token_ids = m_token_occurrences->token_ids();
+        const uint32_t* generated_counts = m_token_occurrences->generated_counts();
+        const uint8_t* is_in_prompt = m_token_occurrences->is_in_prompt();
+        const float penalty = m_penalty, inv_penalty = 1.0f / m_penalty;
+        // each token is penalized once, whether it occurs in the prompt, in generated tokens or in both
+        for (size_t idx = 0; idx < num_tokens; ++idx) {
+            float& logit = logits.m_data[token_ids[idx]];
+            const float scale = (is_in_prompt[idx] || generated_counts[idx] > 0) ? (logit >= 0 ? inv_penalty : penalty) : 1.0f;
+            logit *= scale;
         }
     }
 
     void apply(Logits& logits, const TokenIds& input_ids) {
-        set_unique_prompt_token_ids(nullptr);
         extract_generated_tokens(input_ids);
         apply(logits);
     }
-
-    void set_unique_prompt_token_ids(const std::shared_ptr<std::set<int64_t>>& unique_prompt_token_ids) {
-        if (unique_prompt_token_ids != nullptr) {
-            m_unique_prompt_token_ids = unique_prompt_token_ids;
-        } else {
-            m_unique_prompt_token_ids = std::shared_ptr<std::set<int64_t>>(new std::set<int64_t>);
-        }
-    }
-
-protected:
-    std::shared_ptr<std::set<int64_t>> m_unique_prompt_token_ids = nullptr;
 };
 
 class EOSPenaltyTransform : public ILogitTransformer {
@@ -254,6 +418,102 @@ protected:
     std::set<int64_t> m_stop_token_ids;
 };
 
+class StructuredOutputTransform : public ILogitTransformer {
+public:
+    StructuredOutputTransform(std::shared_ptr<ov::genai::StructuredOutputGrammar> grammar, const std::set<int64_t>& stop_token_ids) :
+        m_grammar(std::move(grammar)), m_stop_token_ids(stop_token_ids) {}
+
+    /**
+     * Selects a sequence, whose next token logits are processed by the following apply() calls.
+     * @param sequence_id ID of the sequence.
+     * @param generated_ids Tokens generated by the sequence.
+     * @param num_tokens Number of first generated tokens preceding the token to sample.
+     */
+    void set_sequence(uint64_t sequence_id, const TokenIds& generated_ids, size_t num_tokens) {
+        m_state = get_state(sequence_id, generated_ids, num_tokens);
+    }
+
+    /**
+     * Computes the mask of tokens allowed after all generated tokens of a sequence, so that the next apply() does not wait for it.
+     */
+    void prefetch(uint64_t sequence_id, const TokenIds& generated_ids) {
+        int32_t state = get_state(sequence_id, generated_ids, generated_ids.size());
+        if (state != ov::genai::RegexAutomaton::DEAD_STATE)
+            m_grammar->get_mask(state);
+    }
+
+    void apply(Logits& logits) override {
+        // Since structured output is applied early, the token vector is not initialized yet
+        // and we can assume element order match token ids.
+        OPENVINO_ASSERT(!logits.is_vector_initialized(), "Structured output must be applied to logits of the whole vocabulary");
+        std::vector<std::pair<int64_t, float>> stop_token_logits;
+        for (auto stop_token_id : m_stop_token_ids)
+            if (stop_token_id >= 0 && static_cast<size_t>(stop_token_id) < logits.m_size)
+                stop_token_logits.emplace_back(stop_token_id, logits.m_data[stop_token_id]);
+
+        const float min_logit = -std::numeric_limits<float>::infinity();
+        bool is_any_token_allowed = false;
+        if (m_state != ov::genai::RegexAutomaton::DEAD_STATE) {
+            const auto mask = m_grammar->get_mask(m_state);
+            const uint64_t* words = mask->data();
+            const size_t num_masked = std::min(logits.m_size, m_grammar->get_vocab_size());
+            for (size_t word_idx = 0; word_idx * 64 < num_masked; ++word_idx) {
+                const uint64_t word = words[word_idx];
+                is_any_token_allowed |= word != 0;
+                const size_t begin = word_idx * 64, end = std::min(begin + 64, num_masked);
+                if (word == ~uint64_t(0) && end - begin == 64)
+                    continue;
+                // branchless, so that the loop is vectorized
+                for (size_t i = begin; i < end; ++i)
+                    logits.m_data[i] = (word >> (i - begin)) & 1 ? logits.m_data[i] : min_logit;
+            }
+            std::fill(logits.m_data + num_masked, logits.m_data + logits.m_size, min_logit);
+        } else {
+            std::fill(logits.m_data, logits.m_data + logits.m_size, min_logit);
+        }
+
+        // stop tokens are allowed once the whole text is matched, or if nothing else can be generated
+        if (m_grammar->is_accepting(m_state) || !is_any_token_allowed) {
+            for (const auto& [stop_token_id, logit] : stop_token_logits)
+                logits.m_data[stop_token_id] = logit;
+        }
+    }
+
+protected:
+    // automaton states after each generated token of a sequence, states[0] is the initial state
+    struct SequenceStates {
+        TokenIds token_ids;
+        std::vector<int32_t> states;
+    };
+
+    std::shared_ptr<ov::genai::StructuredOutputGrammar> m_grammar;
+    std::set<int64_t> m_stop_token_ids;
+    std::map<uint64_t, SequenceStates> m_sequence_states;
+    int32_t m_state = 0;
+
+    // reuses states of the longest common prefix with tokens seen for the sequence previously,
+    // so that only new tokens are processed, while removed tokens (e.g. rejected candidates) are handled as well
+    int32_t get_state(uint64_t sequence_id, const TokenIds& generated_ids, size_t num_tokens) {
+        OPENVINO_ASSERT(num_tokens <= generated_ids.size());
+        auto& sequence_states = m_sequence_states[sequence_id];
+        if (sequence_states.states.empty())
+            sequence_states.states.push_back(m_grammar->get_initial_state());
+        size_t num_common = std::min(sequence_states.token_ids.size(), num_tokens);
+        num_common = std::mismatch(sequence_states.token_ids.begin(), sequence_states.token_ids.begin() + num_common, generated_ids.begin()).first -
+                     sequence_states.token_ids.begin();
+        sequence_states.token_ids.resize(num_common);
+        sequence_states.states.resize(num_common + 1);
+        for (size_t i = num_common; i < num_tokens; ++i) {
+            const int64_t token_id = generated_ids[i];
+            // stop tokens finish generation, so they do not change the state
+            int32_t state = m_stop_token_ids.count(token_id) ? sequence_states.states.back() : m_grammar->advance(sequence_states.states.back(), token_id);
+            sequence_states.token_ids.push_back(token_id);
+            sequence_states.states.push_back(state);
+        }
+        return sequence_states.states.back();
+    }
+};
+
 class FrequencyPenaltyTransform : public IPenaltyTransformer {
 public:
     FrequencyPenaltyTransform(double value) {
@@ -261,15 +521,15 @@ public:
     };
 
     void apply(Logits& logits) override {
-        size_t vocab_size = logits.m_size;
-        for (const auto& input_id_pair : *m_unique_generated_token_ids) {
-            const auto& input_id = input_id_pair.first;
-            OPENVINO_ASSERT((input_id >= 0) && (input_id < vocab_size), "input_ids token out of bounds");
-            if (logits.m_data[input_id] >= 0) {
-                logits.m_data[input_id] -= m_penalty * input_id_pair.second;
-            } else {
-                logits.m_data[input_id] += m_penalty * input_id_pair.second;
-            };
+        m_token_occurrences->check_bounds(logits.m_size);
+        const size_t num_tokens = m_token_occurrences->size();
+        const int64_t* token_ids = m_token_occurrences->token_ids();
+        const uint32_t* generated_counts = m_token_occurrences->generated_counts();
+        const float penalty = m_penalty;
+        for (size_t idx = 0; idx < num_tokens; ++idx) {
+            float& logit = logits.m_data[token_ids[idx]];
+            const float delta = penalty * generated_counts[idx];
+            logit += logit >= 0 ? -delta : delta;
         }
     }
 
@@ -286,15 +546,15 @@ public:
     };
 
     void apply(Logits& logits) override {
-        size_t vocab_size = logits.m_size;
-        for (const auto& input_id_pair : *m_unique_generated_token_ids) {
-            const auto& input_id = input_id_pair.first;
-            OPENVINO_ASSERT((input_id >= 0) && (input_id < vocab_size), "input_ids token out of bounds");
-            if (logits.m_data[input_id] >= 0) {
-                logits.m_data[input_id] -= m_penalty;
-            } else {
-                logits.m_data[input_id] += m_penalty;
-            };
+        m_token_occurrences->check_bounds(logits.m_size);
+        const size_t num_tokens = m_token_occurrences->size();
+        const int64_t* token_ids = m_token_occurrences->token_ids();
+        const uint32_t* generated_counts = m_token_occurrences->generated_counts();
+        const float penalty = m_penalty;
+        for (size_t idx = 0; idx < num_tokens; ++idx) {
+            float& logit = logits.m_data[token_ids[idx]];
+            const float delta = generated_counts[idx] > 0 ? penalty : 0.0f;
+            logit += logit >= 0 ? -delta : delta;
         }
     }
 
@@ -311,19 +571,31 @@ class LogitProcessor {
 protected:
     std::vector<std::shared_ptr<LogitTransformers::ILogitTransformer>> m_logit_transformers;
     
-    std::shared_ptr<std::map<int64_t, size_t>> m_unique_generated_token_ids = std::shared_ptr<std::map<int64_t, size_t>>(new std::map<int64_t, size_t>);
-    std::shared_ptr<std::set<int64_t>> m_unique_prompt_token_ids = std::shared_ptr<std::set<int64_t>>(new std::set<int64_t>);
+    // shared by all penalty transformers of the request
+    std::shared_ptr<LogitTransformers::TokenOccurrences> m_token_occurrences = std::make_shared<LogitTransformers::TokenOccurrences>();
     size_t m_generated_tokens = 0;
 
     // speculative decoding parameters
     float m_assistant_confidence_threshold = 0.f;
 
+    // per-request scratch buffers reused across tokens, so that sampling of a token does not allocate
+    // buffer of candidate tokens lent to Logits by apply() and returned by release_candidates()
+    std::vector<Token> m_candidates_buffer;
+    std::vector<double> m_cumulative_weights_buffer;
+
+    std::shared_ptr<LogitTransformers::StructuredOutputTransform> m_structured_output_transform;
 
 public:
+    /**
+     * @param sampling_params Generation config of the request.
+     * @param input_ids Prompt of the request.
+     * @param structured_output_grammar Grammar compiled from GenerationConfig::regex or GenerationConfig::json_schema, if set.
+     */
     LogitProcessor(const ov::genai::GenerationConfig& sampling_params,
-                   const LogitTransformers::TokenIds& input_ids) {
+                   const LogitTransformers::TokenIds& input_ids,
+                   std::shared_ptr<ov::genai::StructuredOutputGrammar> structured_output_grammar = nullptr) {
         for (const auto& input_id : input_ids) {
-            m_unique_prompt_token_ids->insert(input_id);
+            m_token_occurrences->add_prompt_token(input_id);
         }
 
         if (sampling_params.min_new_tokens > 0) {
@@ -332,35 +604,40 @@ public:
             );
         }
 
+        if (structured_output_grammar) {
+            m_structured_output_transform = std::make_shared<LogitTransformers::StructuredOutputTransform>(structured_output_grammar, sampling_params.stop_token_ids);
+            m_logit_transformers.push_back(m_structured_output_transform);
+        }
+
         if (sampling_params.is_multinomial() || sampling_params.is_greedy_decoding()) {
             if (sampling_params.repetition_penalty != 1.0f) {
                 std::shared_ptr<LogitTransformers::RepetitionPenaltyTransform> transformer = 
                     std::shared_ptr<LogitTransformers::RepetitionPenaltyTransform>(new LogitTransformers::RepetitionPenaltyTransform(sampling_params.repetition_penalty));
-                transformer->set_unique_prompt_token_ids(m_unique_prompt_token_ids);
-                transformer->set_unique_generated_token_ids(m_unique_generated_token_ids);
+                transformer->set_token_occurrences(m_token_occurrences);
                 m_logit_transformers.push_back(transformer);
             }
             if (sampling_params.presence_penalty != 0.0f) {
                 std::shared_ptr<LogitTransformers::PresencePenaltyTransform> transformer = 
                     std::shared_ptr<LogitTransformers::PresencePenaltyTransform>(new LogitTransformers::PresencePenaltyTransform(sampling_params.presence_penalty)); 
-                transformer->set_unique_generated_token_ids(m_unique_generated_token_ids);
+                transformer->set_token_occurrences(m_token_occurrences);
                 m_logit_transformers.push_back(transformer);
                 
             }
             if (sampling_params.frequency_penalty != 0.0f) {
                 std::shared_ptr<LogitTransformers::FrequencyPenaltyTransform> transformer = 
                     std::shared_ptr<LogitTransformers::FrequencyPenaltyTransform>(new LogitTransformers::FrequencyPenaltyTransform(sampling_params.frequency_penalty));
-                transformer->set_unique_generated_token_ids(m_unique_generated_token_ids);
+                transformer->set_token_occurrences(m_token_occurrences);
                 m_logit_transformers.push_back(transformer);
             }
 
             if (sampling_params.is_multinomial()) {
-                m_logit_transformers.emplace_back(new LogitTransformers::TemperatureLogitTransform(sampling_params.temperature));
-                if (sampling_params.top_p != 1.0f) {
-                    m_logit_transformers.emplace_back(new LogitTransformers::TopPFilter(sampling_params.top_p));
-                }
-                if (sampling_params.top_k > 0 && sampling_params.top_k < std::numeric_limits<size_t>::max()) {
-                    m_logit_transformers.emplace_back(new LogitTransformers::TopKFilter(sampling_params.top_k));
+                bool use_top_p = sampling_params.top_p != 1.0f;
+                bool use_top_k = sampling_params.top_k > 0 && sampling_params.top_k < std::numeric_limits<size_t>::max();
+                if (use_top_p || use_top_k) {
+                    m_logit_transformers.emplace_back(new LogitTransformers::FusedTemperatureTopPTopKTransform(
+                        sampling_params.temperature, use_top_p ? sampling_params.top_p : 1.0, use_top_k ? sampling_params.top_k : std::numeric_limits<size_t>::max()));
+                } else {
+                    m_logit_transformers.emplace_back(new LogitTransformers::TemperatureLogitTransform(sampling_params.temperature));
                 }
             }
             if (sampling_params.assistant_confidence_threshold > 0) {
@@ -369,11 +646,33 @@ public:
         }
     }
 
+    bool has_structured_output() const {
+        return m_structured_output_transform != nullptr;
+    }
+
+    /**
+     * Selects a sequence, whose next token logits are processed by the following apply() calls, when structured output is used.
+     * @param sequence_id ID of the sequence.
+     * @param generated_ids Tokens generated by the sequence.
+     * @param num_tokens Number of first generated tokens preceding the token to sample.
+     */
+    void set_structured_output_sequence(uint64_t sequence_id, const LogitTransformers::TokenIds& generated_ids, size_t num_tokens) {
+        m_structured_output_transform->set_sequence(sequence_id, generated_ids, num_tokens);
+    }
+
+    void prefetch_structured_output_mask(uint64_t sequence_id, const LogitTransformers::TokenIds& generated_ids) {
+        m_structured_output_transform->prefetch(sequence_id, generated_ids);
+    }
+
     float get_assistant_confidence_threshold() {
         return m_assistant_confidence_threshold;
     }
 
     void apply(Logits& logits) {
+        if (!logits.is_vector_initialized() && logits.m_vector.capacity() == 0) {
+            m_candidates_buffer.clear();
+            logits.m_vector.swap(m_candidates_buffer);
+        }
         for (const auto& transformer : m_logit_transformers) {
             if (transformer->is_applicable(m_generated_tokens)) {
                 transformer->apply(logits);
@@ -381,6 +680,19 @@ public:
         }
     }
 
+    /**
+     * Takes back the candidates buffer lent to logits by apply(), once sampling from the logits is done.
+     * @param logits Logits passed to apply() before.
+     */
+    void release_candidates(Logits& logits) {
+        m_candidates_buffer.swap(logits.m_vector);
+        logits.m_vector.clear();
+    }
+
+    std::vector<double>& get_cumulative_weights_buffer() {
+        return m_cumulative_weights_buffer;
+    }
+
     void update_generated_len(size_t updated_len) {
         m_generated_tokens = updated_len;
     }
@@ -390,17 +702,11 @@ public:
     }
 
     void register_new_generated_token(int64_t new_token_id) {
-        auto it = m_unique_generated_token_ids->find(new_token_id);
-        if (it == m_unique_generated_token_ids->end()) {
-            m_unique_generated_token_ids->insert({new_token_id, 1});
-        } else {
-            it->second++;
-        }
+        m_token_occurrences->add_generated_token(new_token_id);
     }
 
     void decrease_generated_token_occurance(int64_t token_id) {
-        OPENVINO_ASSERT(m_unique_generated_token_ids->count(token_id) > 0);
-        m_unique_generated_token_ids->at(token_id)--;
+        m_token_occurrences->remove_generated_token(token_id);
     }
 
 };
@@ -2,6 +2,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <numeric>
 #include <set>
 #include <map>
 #include <string>
@@ -10,6 +15,18 @@
 #include <regex>
 #include <optional>
 
+#ifdef _WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 #include "openvino/op/add.hpp"
 #include "openvino/op/multiply.hpp"
 #include "openvino/op/matmul.hpp"
@@ -19,10 +36,14 @@
 #include "openvino/op/concat.hpp"
 #include "openvino/op/reshape.hpp"
 #include "openvino/op/broadcast.hpp"
+#include "openvino/op/gather.hpp"
+#include "openvino/op/shape_of.hpp"
 #include "openvino/op/read_value.hpp"
 #include "openvino/op/assign.hpp"
 #include "openvino/op/transpose.hpp"
+#include "openvino/op/unsqueeze.hpp"
 #include "openvino/op/util/variable.hpp"
+#include "openvino/core/parallel.hpp"
 #include "openvino/pass/pattern/matcher.hpp"
 #include "openvino/pass/pattern/op/wrap_type.hpp"
 #include "openvino/pass/graph_rewrite.hpp"
@@ -50,9 +71,78 @@ using NodePtr = std::shared_ptr<ov::Node>;
 using ov::NodeVector;
 using namespace ov::op;
 
-// FIXME: Use ov::AlignedBuffer instead of std::vector. ov::AlignedBuffer is not available in public OV API
-using Buffer = std::vector<char>;
-using BufferPtr = std::shared_ptr<Buffer>;
+// Read-only view of a whole file mapped to memory, the mapping is released when the last holder is destroyed.
+// Pages are mapped copy-on-write, so accidental modifications of the data never reach the file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& filename) {
+#ifdef _WIN32
+        m_file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        OPENVINO_ASSERT(m_file != INVALID_HANDLE_VALUE, "Cannot open file with LoRA weights: ", filename);
+
+        LARGE_INTEGER filesize;
+        OPENVINO_ASSERT(GetFileSizeEx(m_file, &filesize), "Cannot get size of file with LoRA weights: ", filename);
+        m_size = static_cast<size_t>(filesize.QuadPart);
+        OPENVINO_ASSERT(m_size > 0, "File with LoRA weights is empty: ", filename);
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        OPENVINO_ASSERT(m_mapping != nullptr, "Cannot map file with LoRA weights: ", filename);
+        m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0));
+        OPENVINO_ASSERT(m_data != nullptr, "Cannot map file with LoRA weights: ", filename);
+#else
+        m_file = open(filename.c_str(), O_RDONLY);
+        OPENVINO_ASSERT(m_file != -1, "Cannot open file with LoRA weights: ", filename);
+
+        struct stat file_stat;
+        OPENVINO_ASSERT(fstat(m_file, &file_stat) == 0, "Cannot get size of file with LoRA weights: ", filename);
+        m_size = static_cast<size_t>(file_stat.st_size);
+        OPENVINO_ASSERT(m_size > 0, "File with LoRA weights is empty: ", filename);
+
+        void* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_file, 0);
+        OPENVINO_ASSERT(data != MAP_FAILED, "Cannot map file with LoRA weights: ", filename);
+        m_data = static_cast<char*>(data);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+#else
+        if (m_data)
+            munmap(m_data, m_size);
+        if (m_file != -1)
+            close(m_file);
+#endif
+    }
+
+    char* data() const {
+        return m_data;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+using MappedFilePtr = std::shared_ptr<MappedFile>;
 using ConstantVector = std::vector<std::shared_ptr<v0::Constant>>;
 
 
@@ -75,21 +165,11 @@ using LoRAPartsParser = LoRAParts<std::function<std::optional<std::string>(const
 using LoRATensors = std::map<std::string, LoRAWeight>;
 
 
-// Read binary file to memory.
-BufferPtr read_file_helper(const std::filesystem::path& filename) {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    OPENVINO_ASSERT(file.is_open(), "Cannot open file with LoRA weights: ", filename);
-
-    size_t filesize = file.tellg();
-    auto buffer = std::make_shared<Buffer>(filesize);
-    file.seekg(0, std::ios::beg);
-    // TODO: Use mmapped AlignedBuffer as ov::Core::read_model can do, necessary functionality is not available in public OV API.
-    // LoRA files do not usually have huge size in comparison to the base models, but it can vary depending on adapter,
-    // and using mmap will help to optimize memory consumption and could be critical
-    // when the application at the edge of available memory that is not really uncommon for applications dealing with LLMs.
-    file.read(&(*buffer)[0], filesize);
-
-    return buffer;
+// Maps binary file to memory, so that LoRA weights are paged in on demand and shared with the page cache
+// instead of being copied to heap. Usually LoRA files are small in comparison to the base models, but their size varies
+// and many adapters can be loaded by a single application, which may be at the edge of available memory.
+MappedFilePtr read_file_helper(const std::filesystem::path& filename) {
+    return std::make_shared<MappedFile>(filename);
 }
 
 
@@ -122,16 +202,16 @@ struct AutoSafetensor: public safetensors_File {
 
 
 // Reads a file with a given filename expecting Safetensors file format.
-// The data is read to a solid memory block and the function returns a map of OV Constants allocated on top of that block.
+// The file is mapped to a solid memory block and the function returns a map of OV Constants allocated on top of that block.
 // The key in the map is a tensor name and the Constant uses a region of memory from the memory block.
 // Each Constant holds a shared pointer to the block in the runtime info.
-// The memory block will be deallocated when the last Constant is destroyed.
+// The memory block will be unmapped when the last Constant is destroyed.
 ConstantMap read_safetensors(const std::filesystem::path& filename) {
     auto buffer = read_file_helper(filename);
     AutoSafetensor safe_tensors_file{};
 
     OPENVINO_ASSERT(
-        safetensors_file_init(&(*buffer)[0], buffer->size(), &safe_tensors_file) == nullptr,
+        safetensors_file_init(buffer->data(), buffer->size(), &safe_tensors_file) == nullptr,
         "Cannot parse ", filename, " as a Safetensors file format. Safetensors file format is supported only"
     );
 
@@ -163,7 +243,7 @@ struct RegexParser {
     std::regex pattern;
     size_t capture_index;
     RegexParser (const std::string& pattern, size_t capture_index) : pattern(pattern), capture_index(capture_index) {}
-    std::optional<std::string> operator() (const std::string& name) {
+    std::optional<std::string> operator() (const std::string& name) const {
         std::smatch match;
         if(std::regex_match(name, match, pattern)) {
             return match[capture_index];
@@ -174,12 +254,14 @@ struct RegexParser {
 
 
 // Default LoRA tensor name patterns observed in the existing LoRA adapters, captures the prefix that should correspond to a layer name in the base model
-LoRAPartsParser default_lora_patterns () {
-    return LoRAPartsParser(
+// Patterns are compiled once and shared by all adapter loads
+const LoRAPartsParser& default_lora_patterns () {
+    static const LoRAPartsParser patterns(
         RegexParser(R"((.*)\.alpha)", 1),
         RegexParser(R"((.*)\.(lora_(A|down)\.weight))", 1),
         RegexParser(R"((.*)\.(lora_(B|up)\.weight))", 1)
     );
+    return patterns;
 }
 
 
@@ -241,7 +323,8 @@ struct LoRAParameters {
     ov::Dimension rank;         // accumulated LoRA rank, could be dynamic if rank is not known or DYNAMIC mode is applied
     ov::element::Type type;     // element type of a tensor that will be applied to the model, negotiated based on multiple LoRA adapters
     bool fine_grained_alpha;    // use 1D tensor of the same rank for alpha instead of a scalar to blend multiple weighted LoRAs
-    // TODO: flag to have various alphas over the batch
+    bool alpha_per_row;         // alpha has a dynamic number of rows instead of a single one to have various alphas over the batch
+    bool quantized_weights;     // A and B are int8 tensors quantized by groups with f32 scales
 };
 
 using LoRAParametersGetter = std::function<std::optional<LoRAParameters>(NodePtr node)>;
@@ -323,6 +406,8 @@ struct LoRAParametersByWeightGetter {
     std::vector<LoRAWeightGetter> weight_getter;
     bool dynamic_lora_rank = true;
     bool fine_grained_alpha = true;
+    bool alpha_per_row = false;
+    bool quantized_weights = false;
     ov::element::Type type;
 
     std::optional<LoRAParameters> operator() (NodePtr node) const {
@@ -359,6 +444,8 @@ struct LoRAParametersByWeightGetter {
         result.rank = rank;
         result.type = type;
         result.fine_grained_alpha = fine_grained_alpha;
+        result.alpha_per_row = alpha_per_row;
+        result.quantized_weights = quantized_weights;
         return result;
     }
 };
@@ -389,16 +476,34 @@ void deduce_input_output_dims(NodePtr node, ov::Dimension& input_dim, ov::Dimens
 using LoRAVarMap = std::map<std::string, LoRAVarIDs>;
 
 
+// Variables with scales of quantized A and B
+struct LoRAScaleVarIDs {
+    ov::op::util::VariableInfo A, B;
+};
+
+using LoRAScaleVarMap = std::map<std::string, LoRAScaleVarIDs>;
+
+
+// Number of elements of quantized A and B sharing a scale. A [rank, input_dim] is grouped along input_dim and
+// B [output_dim, rank] along output_dim, so that A and B of multiple adapters are concatenated along rank with their scales.
+constexpr int64_t LORA_QUANTIZATION_GROUP_SIZE = 64;
+
+int64_t get_quantization_num_groups(const ov::Dimension& dim) {
+    return dim.get_length() % LORA_QUANTIZATION_GROUP_SIZE == 0 ? dim.get_length() / LORA_QUANTIZATION_GROUP_SIZE : 1;
+}
+
+
 // Creates ReadValue and Assign nodes to inject LoRA tensors as variables for a given node but
 // doesn't connect them to the model returning as LoRANode instance.
 struct LoRAWeightStateGetter {
     LoRAParametersGetter params_getter;
     std::shared_ptr<ov::Model> model;
     LoRAVarMap& variable_ids;
+    LoRAScaleVarMap& scale_variable_ids;
     // TODO: Use variable indices instead of variable_id for faster search for a state tensor
 
-    LoRAWeightStateGetter (const LoRAParametersGetter& params_getter, std::shared_ptr<ov::Model> model, LoRAVarMap& variable_ids) :
-        params_getter(params_getter), model(model), variable_ids(variable_ids) {}
+    LoRAWeightStateGetter (const LoRAParametersGetter& params_getter, std::shared_ptr<ov::Model> model, LoRAVarMap& variable_ids, LoRAScaleVarMap& scale_variable_ids) :
+        params_getter(params_getter), model(model), variable_ids(variable_ids), scale_variable_ids(scale_variable_ids) {}
 
     std::optional<LoRANode> operator() (NodePtr node) const {
         if(auto params = params_getter(node)) {
@@ -416,14 +521,14 @@ struct LoRAWeightStateGetter {
             //indices.A = model->get_variables().size();
             var_ids.A = ov::op::util::VariableInfo{
                 ov::PartialShape{params->rank, input_dim},  // Will be used with transpose_b == true
-                params->type,
+                params->quantized_weights ? ov::element::i8 : params->type,
                 variable_id_prefix + ".A"
             };
             result.A = add_variable(var_ids.A);
             // FIXME: No guarantees on ordering of state in InferRequest makes impossible using indices of variables later, forced to use variable_id instead
             //indices.A = model->get_variables().size();
             var_ids.alpha = ov::op::util::VariableInfo{
-                params->fine_grained_alpha ? ov::PartialShape{1, params->rank} : ov::PartialShape{},
+                params->fine_grained_alpha ? ov::PartialShape{params->alpha_per_row ? ov::Dimension::dynamic() : ov::Dimension(1), params->rank} : ov::PartialShape{},
                 ov::element::f32,   // alpha is always f32 because it is set from host as float data type
                 variable_id_prefix + ".alpha"
             };
@@ -432,17 +537,53 @@ struct LoRAWeightStateGetter {
             //indices.B = model->get_variables().size();
             var_ids.B = ov::op::util::VariableInfo{
                 ov::PartialShape{output_dim, params->rank},  // Will be used with transpose_b == true
-                params->type,
+                params->quantized_weights ? ov::element::i8 : params->type,
                 variable_id_prefix + ".B"
             };
             result.B = add_variable(var_ids.B);
             variable_ids.emplace(name, var_ids);
+
+            if(params->quantized_weights) {
+                LoRAScaleVarIDs scale_var_ids;
+                const int64_t input_groups = get_quantization_num_groups(input_dim), output_groups = get_quantization_num_groups(output_dim);
+                scale_var_ids.A = ov::op::util::VariableInfo{
+                    ov::PartialShape{params->rank, input_groups},
+                    ov::element::f32,
+                    variable_id_prefix + ".A_scale"
+                };
+                result.A = dequantize(result.A, add_variable(scale_var_ids.A), 1, input_groups, input_dim.get_length(), params->type);
+                scale_var_ids.B = ov::op::util::VariableInfo{
+                    ov::PartialShape{output_groups, params->rank},
+                    ov::element::f32,
+                    variable_id_prefix + ".B_scale"
+                };
+                result.B = dequantize(result.B, add_variable(scale_var_ids.B), 0, output_groups, output_dim.get_length(), params->type);
+                scale_variable_ids.emplace(name, scale_var_ids);
+            }
             return result;
         } else {
             return std::nullopt;
         }
     }
 
+    // Dequantizes int8 weights [rows, cols] to `type` with `num_groups` scales along `group_axis` of size `dim` for each element of the other axis
+    static NodePtr dequantize(NodePtr weights, NodePtr scales, size_t group_axis, int64_t num_groups, int64_t dim, ov::element::Type type) {
+        auto shape = std::make_shared<v3::ShapeOf>(weights);
+        auto other_dim = std::make_shared<v8::Gather>(
+            shape,
+            v0::Constant::create(ov::element::i64, ov::Shape{1}, {1 - group_axis}),
+            v0::Constant::create(ov::element::i64, ov::Shape{}, {0}));
+        auto groups = v0::Constant::create(ov::element::i64, ov::Shape{2}, std::vector<int64_t>{num_groups, dim / num_groups});
+        auto grouped_shape = std::make_shared<v0::Concat>(
+            group_axis == 0 ? ov::OutputVector{groups, other_dim} : ov::OutputVector{other_dim, groups}, 0);
+
+        auto grouped = std::make_shared<v1::Reshape>(std::make_shared<v0::Convert>(weights, ov::element::f32), grouped_shape, false);
+        auto scales_axis = v0::Constant::create(ov::element::i64, ov::Shape{1}, {group_axis + 1});
+        auto dequantized = std::make_shared<v1::Multiply>(grouped, std::make_shared<v0::Unsqueeze>(scales, scales_axis));
+        NodePtr result = std::make_shared<v1::Reshape>(dequantized, shape, false);
+        return type == ov::element::f32 ? result : std::make_shared<v0::Convert>(result, type);
+    }
+
     NodePtr add_variable(const ov::op::util::VariableInfo& variable_info) const {
         auto variable = std::make_shared<ov::op::util::Variable>(variable_info);
         model->add_variables({variable});
@@ -534,6 +675,13 @@ NodePtr tensors_multiplication(NodePtr input, const NodeVector multipliers, ov::
         }
         if(input) {
             if(i == alpha_pos) {
+                const auto input_rank = input->get_output_partial_shape(0).rank().get_length();
+                if(!transpose_in_end && normalized->get_output_partial_shape(0)[0].is_dynamic() && input_rank > 2) {
+                    // alpha rows [rows, rank] are aligned with the leading dimension of activations [rows, ..., rank]
+                    std::vector<int64_t> axes(input_rank - 2);
+                    std::iota(axes.begin(), axes.end(), 1);
+                    normalized = std::make_shared<v0::Unsqueeze>(normalized, v0::Constant::create(ov::element::i64, ov::Shape{axes.size()}, axes));
+                }
                 // TODO: Apply alpha multiplication separately
                 input = std::make_shared<v1::Multiply>(input, normalized);
             } else {
@@ -676,6 +824,96 @@ private:
 };
 
 
+// Keeps values for a limited number of recently used keys, the least recently used value is evicted first.
+template <typename Key, typename Value>
+class RecentlyUsedCache {
+public:
+    explicit RecentlyUsedCache(size_t capacity) : capacity(capacity) {}
+
+    // Returns nullptr if there is no value for a given key
+    Value* find(const Key& key) {
+        auto it = std::find_if(entries.begin(), entries.end(), [&key](const std::pair<Key, Value>& entry) { return entry.first == key; });
+        if(it == entries.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it);
+        return &entries.front().second;
+    }
+
+    Value& insert(Key key, Value value) {
+        entries.emplace_front(std::move(key), std::move(value));
+        if(entries.size() > capacity) {
+            entries.pop_back();
+        }
+        return entries.front().second;
+    }
+
+private:
+    std::list<std::pair<Key, Value>> entries;
+    size_t capacity;
+};
+
+
+// Fuses LoRA tensors `adapter` = {alpha, B, A} into weights of a layer writing W + alpha * B x A to `output`.
+// Weights are given by a weights input of the layer, which may be a decompression Convert of `weights_constant`.
+// Fusion models are compiled once per signature of inputs and stashed into `fusers` cache.
+void fuse_lora_weights(
+    InferRequestSignatureCache& fusers,
+    const ov::Output<ov::Node>& weights_input,
+    NodePtr weights_convert,
+    const std::shared_ptr<v0::Constant>& weights_constant,
+    const ConstantVector& adapter,
+    ov::Tensor output
+) {
+    // TODO: Define hash function on vector<tuple<element_type, PartialShape>> to make it C++ish
+    auto signature_push_back = [](InferRequestSignatureCache::Signature& signature, ov::Output<ov::Node> input) {
+        signature += "(el: " + input.get_element_type().get_type_name() + ", shape: " + input.get_partial_shape().to_string() + ")";
+    };
+    InferRequestSignatureCache::Signature signature;
+    signature_push_back(signature, weights_input);
+    for(auto multiplier : adapter) {
+        signature_push_back(signature, multiplier);
+    }
+
+    if(!fusers.exist(signature)) {
+        // Build a small model for weight and LoRA fusion, and stash it into `fusers` cache.
+        ov::ParameterVector parameters;
+        auto target_parameter = std::make_shared<v0::Parameter>(weights_constant->get_element_type(), weights_constant->get_output_partial_shape(0));
+        parameters.push_back(target_parameter);   // original weights input is one of the parameters
+        ov::Output<ov::Node> target = weights_convert ? weights_convert->clone_with_new_inputs({target_parameter}) : target_parameter;
+        for(auto multiplier : adapter) {
+            parameters.push_back(std::make_shared<v0::Parameter>(multiplier->get_output_element_type(0), multiplier->get_output_partial_shape(0)));
+        }
+        auto result = std::make_shared<v0::Result>(tensors_multiplication(nullptr, NodeVector{parameters.begin() + 1, parameters.end()}, target, false, 1, false));
+        ov::ResultVector results{result};
+        fusers.insert(signature, results, parameters);
+    }
+
+    ov::TensorVector outputs{output};
+    // set input constants
+    ov::TensorVector inputs;
+    inputs.reserve(1 + adapter.size());
+    inputs.push_back(weights_constant->get_tensor_view());
+    for(size_t i = 0; i < adapter.size(); ++i) {
+        inputs.push_back(adapter[i]->get_tensor_view());
+    }
+    fusers.evaluate(signature, inputs, outputs);
+}
+
+
+// Weights of a layer fused with LoRA adapters, which are kept to fuse other adapters or alphas later
+struct FusedLoRAWeight {
+    std::string name;
+    ov::Output<ov::Node> weights_input;
+    NodePtr weights_convert;
+    std::shared_ptr<v0::Constant> weights_constant;
+    // constant that replaced weights input in the model
+    std::shared_ptr<v0::Constant> fused;
+    // LoRA tensors fused last time
+    LoRAWeight lora_weight;
+};
+
+
 // Transformation that modifies existing weights in the base model fusing an arbitrary number of LoRA adapters.
 // This is one-way LoRA fusion that cannot be undone.
 // By default it uses CPU plugin to modify the base model weights.
@@ -684,55 +922,33 @@ private:
 // But it will work well if all plugins equally support fp-compressed weights and can unpack them on-line.
 class LoRAFuseTransform : public LoRATransformBase {
 
-    InferRequestSignatureCache fusers;
-
-    void signature_push_back(InferRequestSignatureCache::Signature& signature, ov::Output<ov::Node> input) const {
-        // TODO: Define hash function on vector<tuple<element_type, PartialShape>> to make it C++ish
-        signature += "(el: " + input.get_element_type().get_type_name() + ", shape: " + input.get_partial_shape().to_string() + ")";
-    }
+    InferRequestSignatureCache& fusers;
+    // if not nullptr, collects fused weights
+    std::vector<FusedLoRAWeight>* fused_weights;
 
 public:
 
     OPENVINO_RTTI("LoRAFuseTransform");
 
-    LoRAFuseTransform(const LoRAWeightByNodeGetter& lora_weight_getter, const std::string& device_for_fusion = "CPU") :
+    LoRAFuseTransform(const LoRAWeightByNodeGetter& lora_weight_getter, InferRequestSignatureCache& fusers, std::vector<FusedLoRAWeight>* fused_weights = nullptr) :
         LoRATransformBase(lora_weight_getter),
-        fusers(device_for_fusion)
+        fusers(fusers),
+        fused_weights(fused_weights)
     {}
 
     bool apply (NodePtr node, const LoRANode& lora_weight) override {
         auto weights_input = node->input_value(1);
-        auto weights_input_type = weights_input.get_element_type();
         auto weights_convert = decompression_convert(weights_input.get_node_shared_ptr());
-        auto weights_constant = weights_convert ? weights_convert->input_value(0) : weights_input;
-        ConstantVector adapter = {
+        auto weights_constant = std::dynamic_pointer_cast<v0::Constant>((weights_convert ? weights_convert->input_value(0) : weights_input).get_node_shared_ptr());
+        LoRAWeight adapter(
             std::dynamic_pointer_cast<v0::Constant>(lora_weight.alpha),
-            std::dynamic_pointer_cast<v0::Constant>(lora_weight.B),
-            std::dynamic_pointer_cast<v0::Constant>(lora_weight.A)};
-        InferRequestSignatureCache::Signature signature;
-        signature_push_back(signature, weights_input);
-        for(auto multiplier : adapter) {
-            signature_push_back(signature, multiplier);
-        }
+            std::dynamic_pointer_cast<v0::Constant>(lora_weight.A),
+            std::dynamic_pointer_cast<v0::Constant>(lora_weight.B));
 
         // TODO: In case when compressed repacking of newly created weights is retained,
         // replace weights_input by weigths_constant to keep decompression Convert in the model.
         auto consumers = weights_input.get_target_inputs();
 
-        if(!fusers.exist(signature)) {
-            // Build a small model for weight and LoRA fusion, and stash it into `fusers` cache.
-            ov::ParameterVector parameters;
-            auto target_parameter = std::make_shared<v0::Parameter>(weights_constant.get_element_type(), weights_constant.get_partial_shape());
-            parameters.push_back(target_parameter);   // original weights input is one of the parameters
-            ov::Output<ov::Node> target = weights_convert ? weights_convert->clone_with_new_inputs({target_parameter}) : target_parameter;
-            for(auto multiplier : adapter) {
-                parameters.push_back(std::make_shared<v0::Parameter>(multiplier->get_output_element_type(0), multiplier->get_output_partial_shape(0)));
-            }
-            auto result = std::make_shared<v0::Result>(tensors_multiplication(nullptr, NodeVector{parameters.begin() + 1, parameters.end()}, target, false, 1, false));
-            ov::ResultVector results{result};
-            fusers.insert(signature, results, parameters);
-        }
-
         // Newly created constants in the next line are not mmaped unlike original weights, so it will inflate required memory
         // eventually allocating up to 2x of the base model size.
         // 2X is due to usually applied compression in the base model that is not retained in the current version of this code.
@@ -740,20 +956,14 @@ public:
         // FIXME: Provide a way for postponed weight repacking that will be triggered by the plugin in compile_model call for the base model.
         // Constant sub-expression can be a solution, but it requires improvements inside plugins, because currently it works extremely slow.
         auto replacement_const = std::make_shared<v0::Constant>(weights_input.get_element_type(), weights_input.get_shape());
-
-        ov::TensorVector outputs{replacement_const->get_tensor_view()};
-        // set input constants
-        ov::TensorVector inputs;
-        inputs.reserve(1 + adapter.size());
-        inputs.push_back(std::dynamic_pointer_cast<v0::Constant>(weights_constant.get_node_shared_ptr())->get_tensor_view());
-        for(size_t i = 0; i < adapter.size(); ++i) {
-            inputs.push_back(adapter[i]->get_tensor_view());
-        }
-        fusers.evaluate(signature, inputs, outputs);
+        fuse_lora_weights(fusers, weights_input, weights_convert, weights_constant, {adapter.alpha, adapter.B, adapter.A}, replacement_const->get_tensor_view());
 
         for (auto consumer : consumers) {
             consumer.replace_source_output(replacement_const->output(0));
         }
+        if(fused_weights) {
+            fused_weights->push_back(FusedLoRAWeight{node->get_friendly_name(), weights_input, weights_convert, weights_constant, replacement_const, adapter});
+        }
         return true;
     }
 };
@@ -859,16 +1069,83 @@ bool operator< (const Adapter& a, const Adapter& b) {
 }
 
 
+// State tensors of A and B of a layer, with scales if A and B are quantized
+struct LoRAWeightStateTensors {
+    ov::Tensor A, B, A_scale, B_scale;
+};
+
+
+// Quantizes 2D f32 weights to int8 with a scale per group of elements along `group_axis`, there are `num_groups` groups
+// for each element of the other axis. Returns quantized weights and scales of the same shape as weights except `group_axis`.
+std::pair<ov::Tensor, ov::Tensor> quantize_by_groups(const ov::Tensor& weights, size_t group_axis, size_t num_groups) {
+    const ov::Shape& shape = weights.get_shape();
+    const size_t num_cols = shape[1], group_size = shape[group_axis] / num_groups;
+    ov::Shape scales_shape = shape;
+    scales_shape[group_axis] = num_groups;
+
+    ov::Tensor quantized(ov::element::i8, shape), scales(ov::element::f32, scales_shape);
+    const float* weights_data = weights.data<const float>();
+    int8_t* quantized_data = quantized.data<int8_t>();
+    float* scales_data = scales.data<float>();
+
+    for(size_t i = 0; i < scales_shape[0]; ++i) {
+        for(size_t j = 0; j < scales_shape[1]; ++j) {
+            auto index = [&](size_t k) {
+                return group_axis == 0 ? (i * group_size + k) * num_cols + j : i * num_cols + j * group_size + k;
+            };
+            float max_abs = 0.0f;
+            for(size_t k = 0; k < group_size; ++k) {
+                max_abs = std::max(max_abs, std::abs(weights_data[index(k)]));
+            }
+            const float scale = max_abs / 127.0f;
+            scales_data[i * scales_shape[1] + j] = scale;
+            for(size_t k = 0; k < group_size; ++k) {
+                quantized_data[index(k)] = scale > 0.0f ? static_cast<int8_t>(std::round(weights_data[index(k)] / scale)) : 0;
+            }
+        }
+    }
+    return {quantized, scales};
+}
+
+
 struct AdapterControllerImpl {
     LoRAVarMap variable_ids;
+    // Scales of quantized A and B, which are empty if weights are not quantized
+    LoRAScaleVarMap scale_variable_ids;
     std::unordered_set<std::string> variable_names;
     AdapterConfig current_config;
+    // Adapters which A and B are kept in state tensors for MODE_HOT_SWAP, in the order of concatenation
+    std::vector<Adapter> preloaded_adapters;
     bool need_full_apply = true;
+    // Variables of LoRA layers in the order of variable_ids, which is the order of per-layer vectors below
+    std::vector<const LoRAVarMap::value_type*> layers;
+    // LoRA tensors of each adapter for each layer, std::nullopt if an adapter is not applicable to a layer
+    std::map<Adapter, std::vector<std::optional<LoRANode>>> adapter_layer_tensors;
+    // State tensors of layers prepared for recently used configs, switching back to them only sets the state. Tensors are never
+    // modified after they are prepared, so a new config is prepared aside while the state keeps tensors of the previous one.
+    // A and B depend on a list of adapters only, while alphas depend on their values as well.
+    static constexpr size_t MAX_CACHED_STATES = 4;
+    RecentlyUsedCache<std::vector<Adapter>, std::vector<LoRAWeightStateTensors>> weight_states{MAX_CACHED_STATES};
+    RecentlyUsedCache<std::pair<std::vector<Adapter>, std::vector<float>>, std::vector<ov::Tensor>> alpha_states{MAX_CACHED_STATES};
+    // Guards evaluators used by preparation of layers in parallel
+    std::mutex lora_state_evaluators_mutex;
+    // Layers fused in MODE_FUSE with their original weights, collected only if AdapterConfig::get_fused_weights_update is set
+    std::vector<FusedLoRAWeight> fused_weights;
+    bool is_fused_weights_update_enabled = false;
+    // Fusion models are kept to fuse other configs
+    InferRequestSignatureCache lora_fusers;
+    // Element type of A and B negotiated among adapters at the initialization
+    ov::element::Type lora_tensor_type;
+    // Ranks of preloaded adapters concatenated in each layer, zero for adapters not applicable to a layer
+    std::vector<std::vector<size_t>> row_alpha_layouts;
+    // Alphas of preloaded adapters and a number of rows for each group of rows set by the last apply_to_row_groups
+    std::vector<std::pair<std::vector<float>, size_t>> row_alphas;
     InferRequestSignatureCache lora_state_evaluators;
 
     AdapterControllerImpl(std::shared_ptr<ov::Model> model, const AdapterConfig& config) :
         current_config(config),  // FIXME: Compare current and passed configs and change incrementally
-        lora_state_evaluators("CPU")    // FIXME: Try to run on the same device that is used for model inference
+        lora_state_evaluators("CPU"),    // FIXME: Try to run on the same device that is used for model inference
+        lora_fusers("CPU")
     {
         LoRAParametersByWeightGetter params_getter;
         params_getter.type = ov::element::dynamic;
@@ -916,21 +1193,32 @@ struct AdapterControllerImpl {
 
         ov::pass::Manager pm;
         auto mode = current_config.get_mode();
-        if(mode == AdapterConfig::MODE_DYNAMIC || mode == AdapterConfig::MODE_STATIC_RANK || mode == AdapterConfig::MODE_AUTO) {
+        if(mode == AdapterConfig::MODE_HOT_SWAP) {
+            preloaded_adapters = current_config.get_adapters();
+        }
+        if(is_state_mode(mode)) {
             // State mode
             params_getter.dynamic_lora_rank = (mode != AdapterConfig::MODE_STATIC_RANK);
-            pm.register_pass<LoRASeparateTransform>(LoRAWeightStateGetter(params_getter, model, variable_ids));
+            params_getter.alpha_per_row = (mode == AdapterConfig::MODE_HOT_SWAP);
+            params_getter.quantized_weights = config.get_weights_quantization();
+            pm.register_pass<LoRASeparateTransform>(LoRAWeightStateGetter(params_getter, model, variable_ids, scale_variable_ids));
         } else if(mode == AdapterConfig::MODE_STATIC) {
             // Separate constant mode
             pm.register_pass<LoRASeparateTransform>(weight_as_constant);
         } else if(mode == AdapterConfig::MODE_FUSE) {
             // Fuse mode
-            pm.register_pass<LoRAFuseTransform>(weight_as_constant);
+            is_fused_weights_update_enabled = config.get_fused_weights_update();
+            pm.register_pass<LoRAFuseTransform>(weight_as_constant, lora_fusers, is_fused_weights_update_enabled ? &fused_weights : nullptr);
         } else {
             OPENVINO_THROW("Unrecognized AdapterConfig::Mode was used: ", mode);
         }
 
         pm.run_passes(model);
+        lora_tensor_type = params_getter.type;
+
+        for(const auto& var: variable_ids) {
+            layers.push_back(&var);
+        }
 
         // Collect all variable names to quickly detect which state tensor belongs to this adapter controller later
         for(const auto& var: variable_ids) {
@@ -938,12 +1226,38 @@ struct AdapterControllerImpl {
             variable_names.insert(var.second.B.variable_id);
             variable_names.insert(var.second.alpha.variable_id);
         }
+        for(const auto& var: scale_variable_ids) {
+            variable_names.insert(var.second.A.variable_id);
+            variable_names.insert(var.second.B.variable_id);
+        }
     }
 
     static std::shared_ptr<Adapter::Impl> get_adapter_impl(const Adapter& adapter) {
         return adapter.m_pimpl;
     }
 
+    static bool is_state_mode(AdapterConfig::Mode mode) {
+        return mode == AdapterConfig::MODE_AUTO || mode == AdapterConfig::MODE_DYNAMIC || mode == AdapterConfig::MODE_STATIC_RANK || mode == AdapterConfig::MODE_HOT_SWAP;
+    }
+
+    // Expresses a config as alphas of all preloaded adapters, adapters which are not selected get zero alpha,
+    // so the list of adapters never changes and switching between them doesn't require new A and B state tensors
+    AdapterConfig to_preloaded_config(const AdapterConfig& config) {
+        const auto& selected_adapters = config.get_adapters();
+        for(const auto& adapter: selected_adapters) {
+            OPENVINO_ASSERT(
+                std::find(preloaded_adapters.begin(), preloaded_adapters.end(), adapter) != preloaded_adapters.end(),
+                "AdapterConfig::MODE_HOT_SWAP allows to select only adapters that were passed at the initialization");
+        }
+
+        AdapterConfig preloaded_config(config.get_mode());
+        for(const auto& adapter: preloaded_adapters) {
+            const bool is_selected = std::find(selected_adapters.begin(), selected_adapters.end(), adapter) != selected_adapters.end();
+            preloaded_config.add(adapter, is_selected ? config.get_alpha(adapter) : 0.0f);
+        }
+        return preloaded_config;
+    }
+
     struct ConfigChanged {
         bool mode = false;
         bool alpha = false;
@@ -968,7 +1282,7 @@ struct AdapterControllerImpl {
             diff.alpha = true;
         } else {
             for(auto const& adapter: adapters1) {
-                diff.alpha = config1.get_alpha(adapter) != config2.get_alpha(adapter);
+                diff.alpha = diff.alpha || config1.get_alpha(adapter) != config2.get_alpha(adapter);
             }
         }
         return diff;
@@ -977,13 +1291,23 @@ struct AdapterControllerImpl {
     void apply (ov::InferRequest& infer_request, std::optional<AdapterConfig> config) {
         // FIXME: If a part of LoRA state tensors are not set here, then need to carefully reset state in LLMPipeline where global reset is called after the generation
         ConfigChanged diff;
+        if(!row_alphas.empty()) {
+            // alphas set per rows are replaced by alphas of the current config
+            row_alphas.clear();
+            diff.alpha = true;
+        }
+        if(config && current_config.get_mode() == AdapterConfig::MODE_HOT_SWAP) {
+            config = to_preloaded_config(*config);
+        }
         if(config) {
+            const bool alpha_changed = diff.alpha;
             diff = compare_configs(current_config, *config);
+            diff.alpha = diff.alpha || alpha_changed;
             OPENVINO_ASSERT(
                 !diff.mode || config->get_mode() == AdapterConfig::MODE_AUTO,  // MODE_AUTO in this call means that mode is not changed
                 "AdapterConfig::mode cannot be changed and should be configured once for a model at the initialization");
             OPENVINO_ASSERT(
-                config->get_mode() == AdapterConfig::MODE_AUTO || config->get_mode() == AdapterConfig::MODE_DYNAMIC || config->get_mode() == AdapterConfig::MODE_STATIC_RANK || (!diff.alpha && !diff.adapter),
+                is_state_mode(config->get_mode()) || (!diff.alpha && !diff.adapter),
                 "Cannot change adapters and/or the alphas when not one of the dynamic modes are used.");
             current_config.update(*config);
         }
@@ -999,46 +1323,318 @@ struct AdapterControllerImpl {
         }
     }
 
+    void apply_to_row_groups(ov::InferRequest& infer_request, const std::vector<std::pair<std::optional<AdapterConfig>, size_t>>& row_configs) {
+        OPENVINO_ASSERT(current_config.get_mode() == AdapterConfig::MODE_HOT_SWAP,
+            "Adapters per groups of batch rows are supported for AdapterConfig::MODE_HOT_SWAP only");
+        if(need_full_apply) {
+            need_full_apply = false;
+            set_new_adapter_tensors(infer_request);
+        }
+
+        // consecutive groups with the same alphas are merged to a single group
+        std::vector<std::pair<std::vector<float>, size_t>> new_row_alphas;
+        size_t num_rows = 0;
+        for(const auto& [config, rows] : row_configs) {
+            if(rows == 0) {
+                continue;
+            }
+            std::vector<float> alphas(preloaded_adapters.size(), 0.0f);
+            if(config) {
+                const AdapterConfig preloaded_config = to_preloaded_config(*config);
+                for(size_t i = 0; i < preloaded_adapters.size(); ++i) {
+                    alphas[i] = preloaded_config.get_alpha(preloaded_adapters[i]);
+                }
+            }
+            if(!new_row_alphas.empty() && new_row_alphas.back().first == alphas) {
+                new_row_alphas.back().second += rows;
+            } else {
+                new_row_alphas.emplace_back(std::move(alphas), rows);
+            }
+            num_rows += rows;
+        }
+        if(new_row_alphas == row_alphas) {
+            return;
+        }
+        row_alphas = std::move(new_row_alphas);
+
+        if(row_alpha_layouts.empty()) {
+            row_alpha_layouts.assign(layers.size(), std::vector<size_t>(preloaded_adapters.size(), 0));
+            for(size_t i = 0; i < preloaded_adapters.size(); ++i) {
+                const auto& layer_tensors = get_layer_tensors(preloaded_adapters[i]);
+                for(size_t layer_index = 0; layer_index < layers.size(); ++layer_index) {
+                    if(layer_tensors[layer_index]) {
+                        row_alpha_layouts[layer_index][i] = get_lora_rank(*layer_tensors[layer_index]);
+                    }
+                }
+            }
+        }
+
+        auto state = infer_request.query_state();
+        const auto state_name_to_index = get_state_indices(state);
+
+        for(size_t layer_index = 0; layer_index < layers.size(); ++layer_index) {
+            const auto& ranks = row_alpha_layouts[layer_index];
+            const size_t total_rank = std::accumulate(ranks.begin(), ranks.end(), size_t(0));
+            ov::Tensor alpha(ov::element::f32, {num_rows, total_rank});
+            float* alpha_data = alpha.data<float>();
+            for(const auto& [alphas, rows] : row_alphas) {
+                // the first row of a group is filled by alphas broadcasted over ranks of each adapter and copied to other rows
+                float* group_data = alpha_data;
+                for(size_t i = 0; i < alphas.size(); ++i) {
+                    alpha_data = std::fill_n(alpha_data, ranks[i], alphas[i]);
+                }
+                for(size_t row = 1; row < rows; ++row) {
+                    alpha_data = std::copy_n(group_data, total_rank, alpha_data);
+                }
+            }
+            state[state_name_to_index.at(layers[layer_index]->second.alpha.variable_id)].set_state(alpha);
+        }
+    }
+
     bool has_state_name(const std::string& name) {
         return variable_names.count(name);
     }
 
+    void update_fused_weights(const AdapterConfig& config) {
+        OPENVINO_ASSERT(current_config.get_mode() == AdapterConfig::MODE_FUSE, "Fused weights can be updated in AdapterConfig::MODE_FUSE only");
+        OPENVINO_ASSERT(is_fused_weights_update_enabled,
+            "Fused weights can be updated only if AdapterConfig::set_fused_weights_update(true) is set at the initialization");
+        OPENVINO_ASSERT(
+            config.get_mode() == AdapterConfig::MODE_AUTO || config.get_mode() == AdapterConfig::MODE_FUSE,
+            "AdapterConfig::mode cannot be changed and should be configured once for a model at the initialization");
+        const AdapterConfig previous_config = current_config;
+        current_config.update(config);
+
+        std::vector<LoRAWeightGetter> weight_getters;
+        std::vector<LoRAWeightGetter> previous_weight_getters;
+        for(const auto& adapter: current_config.get_adapters()) {
+            weight_getters.emplace_back(LoRAWeightGetterDefault(&get_adapter_impl(adapter)->tensors, current_config.get_tensor_name_prefix().value_or("")));
+        }
+        for(const auto& adapter: previous_config.get_adapters()) {
+            previous_weight_getters.emplace_back(LoRAWeightGetterDefault(&get_adapter_impl(adapter)->tensors, previous_config.get_tensor_name_prefix().value_or("")));
+        }
+
+        // adapters with their alphas applicable to a layer, only layers where they differ between configs are fused again
+        auto applicable_adapters = [](const AdapterConfig& config, const std::vector<LoRAWeightGetter>& weight_getters, const std::string& name) {
+            std::vector<std::pair<Adapter, float>> result;
+            const auto& adapters = config.get_adapters();
+            for(size_t i = 0; i < adapters.size(); ++i) {
+                if(weight_getters[i](name)) {
+                    result.emplace_back(adapters[i], config.get_alpha(adapters[i]));
+                }
+            }
+            return result;
+        };
+
+        for(auto& fused_weight: fused_weights) {
+            if(applicable_adapters(current_config, weight_getters, fused_weight.name) == applicable_adapters(previous_config, previous_weight_getters, fused_weight.name)) {
+                continue;
+            }
+
+            LoRAParts<ov::Tensor> lora_placeholder{
+                ov::Tensor(ov::element::f32, Shape{0}),
+                ov::Tensor(lora_tensor_type, ov::Shape{0}),
+                ov::Tensor(lora_tensor_type, ov::Shape{0})
+            };
+            auto lora_tensors = prepare_lora_tensors(fused_weight.name, weight_getters, lora_placeholder, /*set_empty_tensors=*/false, /*alpha_only=*/false);
+            if(lora_tensors.alpha) {
+                fused_weight.lora_weight = LoRAWeight(
+                    std::make_shared<v0::Constant>(lora_tensors.alpha),
+                    std::make_shared<v0::Constant>(lora_tensors.A),
+                    std::make_shared<v0::Constant>(lora_tensors.B));
+            } else {
+                // no adapters for the layer, original weights are restored by fusing the last adapters with zero alpha
+                auto zero_alpha = v0::Constant::create(ov::element::f32, fused_weight.lora_weight.alpha->get_shape(), {0.0f});
+                fused_weight.lora_weight.alpha = zero_alpha;
+            }
+            fuse_lora_weights(lora_fusers, fused_weight.weights_input, fused_weight.weights_convert, fused_weight.weights_constant,
+                {fused_weight.lora_weight.alpha, fused_weight.lora_weight.B, fused_weight.lora_weight.A}, fused_weight.fused->get_tensor_view());
+        }
+    }
+
     void set_new_adapter_alphas (ov::InferRequest& infer_request) {
         set_new_adapter_tensors(infer_request, /*alpha_only=*/true);
     }
 
     void set_new_adapter_tensors (ov::InferRequest& infer_request, bool alpha_only = false) {
-        if(current_config.get_mode() != AdapterConfig::MODE_AUTO && current_config.get_mode() != AdapterConfig::MODE_DYNAMIC && current_config.get_mode() != AdapterConfig::MODE_STATIC_RANK ) {
+        if(!is_state_mode(current_config.get_mode())) {
             return;
         }
 
-        std::vector<LoRAWeightGetter> weight_getters;
         const auto& adapters = current_config.get_adapters();
-        weight_getters.reserve(adapters.size());
+        std::vector<float> alphas;
+        std::vector<const std::vector<std::optional<LoRANode>>*> tensors_per_adapter;
         for(const auto& adapter: adapters) {
-            weight_getters.emplace_back(LoRAWeightGetterDefault(&get_adapter_impl(adapter)->tensors, current_config.get_tensor_name_prefix().value_or("")));
+            alphas.push_back(current_config.get_alpha(adapter));
+            tensors_per_adapter.push_back(&get_layer_tensors(adapter));
+        }
+
+        // Prepare all tensors before the state is changed, so that a failure leaves the state of the previous config
+        std::vector<ov::Tensor>* alpha_tensors = alpha_states.find({adapters, alphas});
+        if(!alpha_tensors) {
+            alpha_tensors = &alpha_states.insert({adapters, alphas}, prepare_alpha_tensors(alphas, tensors_per_adapter));
+        }
+        std::vector<LoRAWeightStateTensors>* weight_tensors = nullptr;
+        if(!alpha_only) {
+            weight_tensors = weight_states.find(adapters);
+            if(!weight_tensors) {
+                weight_tensors = &weight_states.insert(adapters, prepare_weight_tensors(tensors_per_adapter));
+            }
         }
 
         auto state = infer_request.query_state();
 
         // TODO: Forced to use variable_id instead of index to address the state tensors, require the same order for state as for variables from plugins
+        const auto state_name_to_index = get_state_indices(state);
+
+        for(size_t layer_index = 0; layer_index < layers.size(); ++layer_index) {
+            const LoRAVarIDs& lora_var_ids = layers[layer_index]->second;
+            state[state_name_to_index.at(lora_var_ids.alpha.variable_id)].set_state((*alpha_tensors)[layer_index]);
+            if(weight_tensors) {
+                const LoRAWeightStateTensors& layer_tensors = (*weight_tensors)[layer_index];
+                state[state_name_to_index.at(lora_var_ids.A.variable_id)].set_state(layer_tensors.A);
+                state[state_name_to_index.at(lora_var_ids.B.variable_id)].set_state(layer_tensors.B);
+                if(layer_tensors.A_scale) {
+                    const LoRAScaleVarIDs& scale_var_ids = scale_variable_ids.at(layers[layer_index]->first);
+                    state[state_name_to_index.at(scale_var_ids.A.variable_id)].set_state(layer_tensors.A_scale);
+                    state[state_name_to_index.at(scale_var_ids.B.variable_id)].set_state(layer_tensors.B_scale);
+                }
+            }
+        }
+    }
 
-        // Convert LoRAVarIDs to LoRAIndices to speedup search for state with a given name
-        // TODO: If state order is stable, then the mapping should be done once for a given infer request, TODO: cache it based on the infer request
+    // Convert LoRAVarIDs to LoRAIndices to speedup search for state with a given name
+    // FIXME: Remove this mapping when the order of state will be the same as the order of variables
+    static std::map<std::string, size_t> get_state_indices(const std::vector<VariableState>& state) {
         std::map<std::string, size_t> state_name_to_index;
         for(size_t i = 0; i < state.size(); ++i) {
-            auto name = state[i].get_name();
-            state_name_to_index[name] = i;
+            state_name_to_index[state[i].get_name()] = i;
+        }
+        return state_name_to_index;
+    }
+
+    static size_t get_lora_rank(const LoRANode& lora_tensors) {
+        return lora_tensors.A->get_output_partial_shape(0)[0].get_length();
+    }
+
+    // Looks up LoRA tensors of an adapter for all layers once, so that switching between configs doesn't match tensor names again
+    const std::vector<std::optional<LoRANode>>& get_layer_tensors(const Adapter& adapter) {
+        auto it = adapter_layer_tensors.find(adapter);
+        if(it == adapter_layer_tensors.end()) {
+            LoRAWeightGetterDefault weight_getter(&get_adapter_impl(adapter)->tensors, current_config.get_tensor_name_prefix().value_or(""));
+            std::vector<std::optional<LoRANode>> layer_tensors;
+            layer_tensors.reserve(layers.size());
+            for(const auto& layer: layers) {
+                layer_tensors.push_back(weight_getter(layer->first));
+            }
+            it = adapter_layer_tensors.emplace(adapter, std::move(layer_tensors)).first;
+        }
+        return it->second;
+    }
+
+    // Broadcasts alpha of each adapter to its rank, layers are independent and prepared in parallel
+    std::vector<ov::Tensor> prepare_alpha_tensors(
+        const std::vector<float>& alphas,
+        const std::vector<const std::vector<std::optional<LoRANode>>*>& tensors_per_adapter
+    ) {
+        std::vector<ov::Tensor> alpha_tensors(layers.size());
+        ov::parallel_for(layers.size(), [&](size_t layer_index) {
+            size_t total_rank = 0;
+            for(const auto* layer_tensors: tensors_per_adapter) {
+                if(const auto& lora_tensors = (*layer_tensors)[layer_index]) {
+                    total_rank += get_lora_rank(*lora_tensors);
+                }
+            }
+            ov::Tensor alpha(layers[layer_index]->second.alpha.data_type, {1, total_rank});
+            float* alpha_data = alpha.data<float>();
+            for(size_t i = 0; i < tensors_per_adapter.size(); ++i) {
+                if(const auto& lora_tensors = (*tensors_per_adapter[i])[layer_index]) {
+                    alpha_data = std::fill_n(alpha_data, get_lora_rank(*lora_tensors), alphas[i]);
+                }
+            }
+            alpha_tensors[layer_index] = alpha;
+        });
+        return alpha_tensors;
+    }
+
+    // Concatenates A and B of adapters along LoRA rank and quantizes them if required, layers are independent and prepared in parallel
+    std::vector<LoRAWeightStateTensors> prepare_weight_tensors(const std::vector<const std::vector<std::optional<LoRANode>>*>& tensors_per_adapter) {
+        std::vector<LoRAWeightStateTensors> weight_tensors(layers.size());
+        ov::parallel_for(layers.size(), [&](size_t layer_index) {
+            const LoRAVarIDs& lora_var_ids = layers[layer_index]->second;
+            auto scale_var_ids = scale_variable_ids.find(layers[layer_index]->first);
+            const bool is_quantized = scale_var_ids != scale_variable_ids.end();
+            std::vector<LoRAWeight> inputs;
+            for(const auto* layer_tensors: tensors_per_adapter) {
+                if(const auto& lora_tensors = (*layer_tensors)[layer_index]) {
+                    inputs.emplace_back(alpha_as_constant(0.0f),
+                                        std::dynamic_pointer_cast<v0::Constant>(lora_tensors->A),
+                                        std::dynamic_pointer_cast<v0::Constant>(lora_tensors->B));
+                }
+            }
+
+            // quantized weights are concatenated in f32 first
+            LoRAParts<ov::Tensor> outputs{
+                ov::Tensor(lora_var_ids.alpha.data_type, dynamic_to_static(lora_var_ids.alpha.data_shape)),
+                ov::Tensor(is_quantized ? ov::element::f32 : lora_var_ids.A.data_type, dynamic_to_static(lora_var_ids.A.data_shape)),
+                ov::Tensor(is_quantized ? ov::element::f32 : lora_var_ids.B.data_type, dynamic_to_static(lora_var_ids.B.data_shape))
+            };
+            LoRAParts<ov::Tensor> concatenated;
+            if(inputs.empty()) {
+                concatenated = empty_adapters(inputs, outputs);
+            } else if(!concat_adapters_on_host(inputs, outputs)) {
+                // element types differ from the state ones, conversion is done by an evaluator shared by all layers
+                std::lock_guard<std::mutex> lock(lora_state_evaluators_mutex);
+                concatenated = concat_adapters(inputs, outputs, /*alpha_only=*/false);
+            } else {
+                concatenated = outputs;
+            }
+
+            LoRAWeightStateTensors& layer_tensors = weight_tensors[layer_index];
+            if(is_quantized) {
+                const size_t input_groups = scale_var_ids->second.A.data_shape[1].get_length();
+                const size_t output_groups = scale_var_ids->second.B.data_shape[0].get_length();
+                std::tie(layer_tensors.A, layer_tensors.A_scale) = quantize_by_groups(concatenated.A, 1, input_groups);
+                std::tie(layer_tensors.B, layer_tensors.B_scale) = quantize_by_groups(concatenated.B, 0, output_groups);
+            } else {
+                layer_tensors.A = concatenated.A;
+                layer_tensors.B = concatenated.B;
+            }
+        });
+        return weight_tensors;
+    }
+
+    // Copies A and B of adapters to outputs if they have the same element types, returns false otherwise
+    static bool concat_adapters_on_host(const std::vector<LoRAWeight>& inputs, LoRAParts<ov::Tensor>& outputs) {
+        size_t total_rank = 0;
+        for(const auto& input: inputs) {
+            if(input.A->get_element_type() != outputs.A.get_element_type() || input.B->get_element_type() != outputs.B.get_element_type()) {
+                return false;
+            }
+            total_rank += input.A->get_shape()[0];
         }
 
-        for(const auto& lora_var_ids : variable_ids) {
-            // FIXME: Remove this mapping when the order of state will be the same as the order of variables
-            LoRAIndices lora_indices;
-            lora_indices.alpha = state_name_to_index.at(lora_var_ids.second.alpha.variable_id);
-            lora_indices.A = state_name_to_index.at(lora_var_ids.second.A.variable_id);
-            lora_indices.B = state_name_to_index.at(lora_var_ids.second.B.variable_id);
-            set_lora_tensors(state, lora_var_ids.first, lora_var_ids.second, lora_indices, weight_getters, alpha_only);
+        // A is [rank, input_dim] and B is [output_dim, rank], possibly with trailing unit dimensions of pointwise convolutions
+        const size_t input_dim = ov::shape_size(inputs.front().A->get_shape()) / inputs.front().A->get_shape()[0];
+        const size_t output_dim = inputs.front().B->get_shape()[0];
+        outputs.A.set_shape({total_rank, input_dim});
+        outputs.B.set_shape({output_dim, total_rank});
+
+        const size_t element_size = outputs.B.get_element_type().size();
+        char* A_data = static_cast<char*>(outputs.A.data());
+        char* B_data = static_cast<char*>(outputs.B.data());
+        for(const auto& input: inputs) {
+            const size_t rank = input.A->get_shape()[0];
+            std::memcpy(A_data, input.A->get_data_ptr(), input.A->get_byte_size());
+            A_data += input.A->get_byte_size();
+
+            const char* input_B_data = static_cast<const char*>(input.B->get_data_ptr());
+            for(size_t row = 0; row < output_dim; ++row) {
+                std::memcpy(B_data + row * total_rank * element_size, input_B_data + row * rank * element_size, rank * element_size);
+            }
+            B_data += rank * element_size;
         }
+        return true;
     }
 
      std::vector<LoRAWeight> collect_applicable_tensors (const std::string& lora_name, const std::vector<LoRAWeightGetter>& weight_getters) {
@@ -1227,28 +1823,6 @@ struct AdapterControllerImpl {
         return shape;
     }
 
-    void set_lora_tensors(
-        std::vector<VariableState>& state,
-        const std::string& name,
-        const LoRAVarIDs& lora_var_ids,
-        const LoRAIndices& lora_indices,
-        const std::vector<LoRAWeightGetter>& weight_getters,
-        bool alpha_only
-    ) {
-        LoRAParts<ov::Tensor> lora_state_tensors{
-            ov::Tensor(lora_var_ids.alpha.data_type, dynamic_to_static(lora_var_ids.alpha.data_shape)),
-            alpha_only ? ov::Tensor() : ov::Tensor(lora_var_ids.A.data_type, dynamic_to_static(lora_var_ids.A.data_shape)),
-            alpha_only ? ov::Tensor() : ov::Tensor(lora_var_ids.B.data_type, dynamic_to_static(lora_var_ids.B.data_shape))
-        };
-        auto new_tensors = prepare_lora_tensors(name, weight_getters, lora_state_tensors, /*set_empty_adapters=*/true, alpha_only);
-
-        state[lora_indices.alpha].set_state(new_tensors.alpha);
-        if(!alpha_only) {
-            state[lora_indices.A].set_state(new_tensors.A);
-            state[lora_indices.B].set_state(new_tensors.B);
-        }
-    }
-
     LoRAParts<ov::Tensor> prepare_lora_tensors (
         const std::string& name,
         const std::vector<LoRAWeightGetter>& weight_getters,
@@ -1315,6 +1889,18 @@ void AdapterController::apply(ov::InferRequest& request, const std::optional<Ada
 }
 
 
+void AdapterController::apply_to_row_groups(ov::InferRequest& request, const std::vector<std::pair<std::optional<AdapterConfig>, size_t>>& row_configs) {
+    OPENVINO_ASSERT(m_pimpl, "Adapters per groups of batch rows are applied but AdapterController was not configured to use adapters");
+    m_pimpl->apply_to_row_groups(request, row_configs);
+}
+
+
+void AdapterController::update_fused_weights(const AdapterConfig& config) {
+    OPENVINO_ASSERT(m_pimpl, "Fused weights are updated but AdapterController was not configured to use adapters");
+    m_pimpl->update_fused_weights(config);
+}
+
+
 bool AdapterController::has_state_name(const std::string& name) {
     return m_pimpl->has_state_name(name);
 }
@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <regex>
 #include <algorithm>
+#include <mutex>
 
 #include "lora_names_mapping.hpp"
 
@@ -50,60 +51,106 @@ std::string join(const std::vector<std::string>& parts, char delimiter) {
 }
 
 
-std::string _convert_unet_lora_key(const std::string& key) {
-    std::string diffusers_name = key;
+using Replacements = std::vector<std::pair<std::regex, std::string>>;
+
 
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("lora.unet"), "lora_unet");
+// Applies replacements in order, patterns are compiled once because std::regex construction dominates name mapping time
+std::string replace_all(std::string name, const Replacements& replacements) {
+    for(const auto& replacement: replacements) {
+        name = std::regex_replace(name, replacement.first, replacement.second);
+    }
+    return name;
+}
+
+
+std::string _convert_unet_lora_key(const std::string& key) {
+    static const std::regex lora_unet_pattern("lora.unet");
+    std::string diffusers_name = std::regex_replace(key, lora_unet_pattern, "lora_unet");
 
     if(key.find("lora_unet") != 0) {
         return key;
     }
 
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("_"), ".");
-
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("input\\.blocks"), "down_blocks");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("down\\.blocks"), "down_blocks");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("middle\\.block"), "mid_block");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("mid\\.block"), "mid_block");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("output\\.blocks"), "up_blocks");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("up\\.blocks"), "up_blocks");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("transformer\\.blocks"), "transformer_blocks");
-    // Original patterns in HF are different for the next block, because 'lora' suffix is already processed
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("to\\.q"), "to_q");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("to\\.k"), "to_k");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("to\\.v"), "to_v");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("to\\.out\\.0"), "to_out");
-
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("proj\\.in"), "proj_in");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("proj\\.out"), "proj_out");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("emb\\.layers"), "time_emb_proj");
+    static const Replacements block_replacements = [] {
+        Replacements replacements;
+        for(const auto& [pattern, replacement]: std::vector<std::pair<const char*, const char*>>{
+            {"_", "."},
+            {"input\\.blocks", "down_blocks"},
+            {"down\\.blocks", "down_blocks"},
+            {"middle\\.block", "mid_block"},
+            {"mid\\.block", "mid_block"},
+            {"output\\.blocks", "up_blocks"},
+            {"up\\.blocks", "up_blocks"},
+            {"transformer\\.blocks", "transformer_blocks"},
+            // Original patterns in HF are different for the next block, because 'lora' suffix is already processed
+            {"to\\.q", "to_q"},
+            {"to\\.k", "to_k"},
+            {"to\\.v", "to_v"},
+            {"to\\.out\\.0", "to_out"},
+            {"proj\\.in", "proj_in"},
+            {"proj\\.out", "proj_out"},
+            {"emb\\.layers", "time_emb_proj"}}) {
+            replacements.emplace_back(std::regex(pattern), replacement);
+        }
+        return replacements;
+    }();
+    diffusers_name = replace_all(diffusers_name, block_replacements);
 
     // Regex match for SDXL specific conversions
     if (diffusers_name.find("emb") != std::string::npos && diffusers_name.find("time.emb.proj") == std::string::npos) {
-        diffusers_name = std::regex_replace(diffusers_name, std::regex("\\.\\d+(?=\\D*$)"), "");
+        static const std::regex last_index_pattern("\\.\\d+(?=\\D*$)");
+        diffusers_name = std::regex_replace(diffusers_name, last_index_pattern, "");
     }
 
     if (diffusers_name.find(".in.") != std::string::npos) {
-        diffusers_name = std::regex_replace(diffusers_name, std::regex("in\\.layers\\.2"), "conv1");
+        static const std::regex conv1_pattern("in\\.layers\\.2");
+        diffusers_name = std::regex_replace(diffusers_name, conv1_pattern, "conv1");
     }
 
     if (diffusers_name.find(".out.") != std::string::npos) {
-        diffusers_name = std::regex_replace(diffusers_name, std::regex("out\\.layers\\.3"), "conv2");
+        static const std::regex conv2_pattern("out\\.layers\\.3");
+        diffusers_name = std::regex_replace(diffusers_name, conv2_pattern, "conv2");
     }
 
     if (diffusers_name.find("downsamplers") != std::string::npos || diffusers_name.find("upsamplers") != std::string::npos) {
-        diffusers_name = std::regex_replace(diffusers_name, std::regex("op"), "conv");
+        static const std::regex op_pattern("op");
+        diffusers_name = std::regex_replace(diffusers_name, op_pattern, "conv");
     }
 
     if (diffusers_name.find("skip") != std::string::npos) {
-        diffusers_name = std::regex_replace(diffusers_name, std::regex("skip\\.connection"), "conv_shortcut");
+        static const std::regex skip_pattern("skip\\.connection");
+        diffusers_name = std::regex_replace(diffusers_name, skip_pattern, "conv_shortcut");
     }
 
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("lora.unet"), "lora_unet");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("lora.te"), "lora_te");
-    diffusers_name = std::regex_replace(diffusers_name, std::regex("base.model"), "base_model");
+    static const Replacements prefix_replacements = [] {
+        Replacements replacements;
+        replacements.emplace_back(std::regex("lora.unet"), "lora_unet");
+        replacements.emplace_back(std::regex("lora.te"), "lora_te");
+        replacements.emplace_back(std::regex("base.model"), "base_model");
+        return replacements;
+    }();
+    return replace_all(diffusers_name, prefix_replacements);
+}
+
+
+// Memoized _convert_unet_lora_key: adapters of the same model family share tensor names, so repeated loads
+// of the same or similar adapters skip regex processing for already seen names
+std::string convert_unet_lora_key(const std::string& key) {
+    static std::unordered_map<std::string, std::string> converted_keys;
+    static std::mutex converted_keys_mutex;
+
+    {
+        std::lock_guard<std::mutex> lock(converted_keys_mutex);
+        auto it = converted_keys.find(key);
+        if(it != converted_keys.end()) {
+            return it->second;
+        }
+    }
 
-    return diffusers_name;
+    std::string converted_key = _convert_unet_lora_key(key);
+    std::lock_guard<std::mutex> lock(converted_keys_mutex);
+    converted_keys.emplace(key, converted_key);
+    return converted_key;
 }
 
 }
@@ -328,7 +375,7 @@ NameMap maybe_map_non_diffusers_lora_to_diffusers(const std::set<std::string>& k
         if(new_keys.end() != it) {
             new_key = it->second;
         }
-        new_key = _convert_unet_lora_key(new_key);
+        new_key = convert_unet_lora_key(new_key);
         new_keys[key] = new_key;
     }
     return new_keys;
@@ -0,0 +1,76 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "medusa/continuous_batching_for_medusa.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+namespace ov::genai {
+
+void ContinuousBatchingPipeline::ContinuousBatchingForMedusaImpl::step() {
+    Scheduler::Output scheduler_output;
+    if (!_launch_step(scheduler_output))
+        return;
+
+    // rows of "medusa_tokens" computed for each scheduled sequence: { sequence_id, { first position, first row, number of rows } }
+    std::map<uint64_t, std::tuple<size_t, size_t, size_t>> scheduled_rows;
+    size_t row = 0;
+    for (size_t sequence_group_id : scheduler_output.m_scheduled_sequence_groups_ids) {
+        const auto& sequence_group = m_requests[sequence_group_id];
+        const size_t num_scheduled_tokens = sequence_group->get_num_scheduled_tokens();
+        for (const auto& sequence : sequence_group->get_running_sequences()) {
+            scheduled_rows[sequence->get_id()] = {sequence_group->get_num_processed_tokens(), row, num_scheduled_tokens};
+            row += num_scheduled_tokens;
+        }
+    }
+
+    _complete_step(scheduler_output);
+
+    // heads continue the token sampled at this step, so they are taken at the position of the last accepted token;
+    // rejected candidates and prompt chunks not followed by a sampled token are skipped
+    const ov::Tensor medusa_tokens = m_model_runner->get_infer_request().get_tensor("medusa_tokens");
+    const size_t num_heads = medusa_tokens.get_shape().back();
+    const int64_t* medusa_tokens_data = medusa_tokens.data<const int64_t>();
+    m_head_tokens.clear();
+    for (const auto& request : m_requests) {
+        for (const auto& sequence : request->get_running_sequences()) {
+            auto it = scheduled_rows.find(sequence->get_id());
+            if (it == scheduled_rows.end() || sequence->get_generated_len() == 0)
+                continue;
+            const auto [first_position, first_row, num_rows] = it->second;
+            const size_t last_position = request->get_prompt_len() + sequence->get_generated_len() - 2;
+            if (last_position < first_position || last_position >= first_position + num_rows)
+                continue;
+            const int64_t* head_tokens = medusa_tokens_data + (first_row + last_position - first_position) * num_heads;
+            m_head_tokens[sequence->get_id()] = TokenIds(head_tokens, head_tokens + num_heads);
+        }
+    }
+}
+
+void ContinuousBatchingPipeline::ContinuousBatchingForMedusaImpl::generate_candidates() {
+    for (auto& request : m_requests) {
+        const auto& sampling_params = request->get_sampling_parameters();
+        size_t max_validation_len = 0;
+        for (auto& running_sequence : request->get_running_sequences()) {
+            auto it = m_head_tokens.find(running_sequence->get_id());
+            if (it == m_head_tokens.end())
+                continue;
+            const TokenIds& head_tokens = it->second;
+
+            // all heads are used, unless num_assistant_tokens limits them
+            const auto generated_len = running_sequence->get_generated_len();
+            const auto left_generated_len = std::min(sampling_params.max_new_tokens, sampling_params.max_length) - generated_len - 1;
+            const size_t num_heads = sampling_params.num_assistant_tokens > 0 ? std::min(sampling_params.num_assistant_tokens, head_tokens.size()) : head_tokens.size();
+            const size_t num_candidates = std::min(num_heads, left_generated_len);
+
+            for (size_t i = 0; i < num_candidates; ++i) {
+                running_sequence->append_token(head_tokens[i], 0);
+            }
+            max_validation_len = std::max(max_validation_len, num_candidates);
+        }
+        request->set_num_validated_tokens(max_validation_len);
+    }
+    m_head_tokens.clear();
+}
+}
@@ -0,0 +1,38 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "prompt_lookup/continuous_batching_for_prompt_lookup.hpp"
+
+namespace ov::genai {
+/**
+ * Validation pipeline, whose candidates are predicted by Medusa heads attached to the model by utils::apply_medusa_heads_transformation.
+ * Each step computes both logits validating candidates of the previous step and the most probable tokens of each head after the last
+ * accepted token, which become candidates of the next step, so that no separate draft model is inferred.
+ */
+class ContinuousBatchingPipeline::ContinuousBatchingForMedusaImpl : public ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl {
+public:
+    ContinuousBatchingForMedusaImpl(
+        const std::shared_ptr<ov::Model>& model,
+        const Tokenizer& tokenizer,
+        const SchedulerConfig& scheduler_config,
+        const std::string& device,
+        const ov::AnyMap& properties,
+        const ov::genai::GenerationConfig& generation_config) :
+    ContinuousBatchingForPromptLookupImpl{ model,
+                                           tokenizer,
+                                           scheduler_config,
+                                           device,
+                                           properties,
+                                           generation_config } {};
+
+    void generate_candidates() override;
+
+    void step() override;
+
+protected:
+    // { sequence_id, tokens predicted by Medusa heads after the last token of the sequence at the previous step }
+    std::map<uint64_t, TokenIds> m_head_tokens;
+};
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "medusa/medusa_impl.hpp"
+#include "utils/paged_attention_transformations.hpp"
+
+namespace ov::genai {
+
+ContinuousBatchingPipeline::MedusaImpl::MedusaImpl(const std::shared_ptr<ov::Model>& model,
+                                                   const std::shared_ptr<ov::Model>& heads_model,
+                                                   const Tokenizer& tokenizer,
+                                                   const SchedulerConfig& scheduler_config,
+                                                   const std::string& device,
+                                                   const ov::AnyMap& properties,
+                                                   const ov::genai::GenerationConfig& generation_config) {
+    OPENVINO_ASSERT(scheduler_config.device_top_k == 0, "SchedulerConfig::device_top_k is not supported with Medusa heads");
+    m_tokenizer = tokenizer;
+    utils::apply_medusa_heads_transformation(model, heads_model);
+    m_pipeline = std::make_shared<ContinuousBatchingForMedusaImpl>(model, tokenizer, scheduler_config, device, properties, generation_config);
+}
+
+void ContinuousBatchingPipeline::MedusaImpl::_check_sampling_params(const GenerationConfig& sampling_params) const {
+    OPENVINO_ASSERT(!sampling_params.is_beam_search(), "Beam search is not supported with Medusa heads");
+    OPENVINO_ASSERT(!sampling_params.is_prompt_lookup(), "Medusa heads and prompt lookup decoding are mutually excluded");
+}
+
+}
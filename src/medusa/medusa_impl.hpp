@@ -0,0 +1,33 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "prompt_lookup/prompt_lookup_impl.hpp"
+#include "medusa/continuous_batching_for_medusa.hpp"
+
+namespace ov::genai {
+
+/**
+ * Speculative decoding, whose candidates are predicted by Medusa heads on top of hidden states of the model instead of a draft model.
+ * Steps, validation and SpeculativeDecodingMetrics are shared with prompt lookup decoding.
+ */
+class ContinuousBatchingPipeline::MedusaImpl : public ContinuousBatchingPipeline::PromptLookupImpl {
+protected:
+    void _check_sampling_params(const GenerationConfig& sampling_params) const override;
+
+public:
+    /**
+     * @param model Model to be extended with the heads.
+     * @param heads_model Medusa heads, see utils::apply_medusa_heads_transformation.
+     */
+    MedusaImpl(const std::shared_ptr<ov::Model>& model,
+               const std::shared_ptr<ov::Model>& heads_model,
+               const Tokenizer& tokenizer,
+               const SchedulerConfig& scheduler_config,
+               const std::string& device,
+               const ov::AnyMap& properties,
+               const ov::genai::GenerationConfig& generation_config);
+};
+
+}
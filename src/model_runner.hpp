@@ -5,8 +5,12 @@
 
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 
 #include <openvino/runtime/infer_request.hpp>
+#include <openvino/runtime/remote_context.hpp>
+
+#include "openvino/genai/lora_adapter.hpp"
 
 #include "debug_utils.hpp"
 #include "sequence_group.hpp"
@@ -14,6 +18,8 @@
 #include "timer.hpp"
 
 #include "attention_output.hpp"
+#include "sparse_decode.hpp"
+#include "visual_language/embedding_model.hpp"
 
 namespace ov::genai {
 
@@ -32,6 +38,42 @@ class ModelRunner {
     AttentionScoresForEachSubsequence m_last_attention_scores;
     size_t m_num_decoder_layers, m_block_size;
     bool m_collect_attention_scores;
+
+    // Persistent storage for input tensors reused across `forward` calls. Each storage grows geometrically
+    // and inputs are passed to the infer request as ROI views, so in a steady state inputs don't require allocations.
+    ov::Tensor m_input_ids_storage, m_position_ids_storage, m_past_lens_storage, m_subsequence_begins_storage, m_block_indices_begins_storage;
+    ov::Tensor m_max_context_len{ov::element::i32, {}};
+    // next prompt token of each scheduled token, if the model computes log probabilities of prompt tokens on device
+    bool m_has_prompt_log_probs_indices = false;
+    ov::Tensor m_prompt_log_probs_indices_storage;
+    // set if the model takes embeddings instead of token IDs, e.g. a language model of a VLM
+    bool m_has_inputs_embeds = false;
+    size_t m_hidden_size = 0;
+    EmbeddingsModel m_embedding;
+    ov::Tensor m_inputs_embeds_storage, m_embedded_ids_storage;
+    // positions in inputs_embeds of tokens embedded by m_embedding
+    std::vector<size_t> m_embedded_positions;
+    // applies adapters selected by each sequence group to its scheduled tokens
+    AdapterController m_adapter_controller;
+    std::vector<std::pair<std::optional<AdapterConfig>, size_t>> m_adapters_per_tokens;
+    // runners of additional infer requests of a model compiled with several streams, which infer sub-batches of a step
+    // concurrently with m_request, see SchedulerConfig::num_inference_streams
+    std::vector<std::shared_ptr<ModelRunner>> m_sub_batch_runners;
+    // set if the model has block_indices input per decoder layer, i.e. per-layer KV cache control
+    bool m_has_per_layer_block_indices = false;
+    // selects blocks attended by decode steps of long sequences, see SchedulerConfig::sparse_decode_block_budget
+    std::shared_ptr<SparseDecodeSelector> m_sparse_decode;
+    // number of sub-batches the current step is split into, the first one is inferred by m_request
+    size_t m_num_sub_batches = 1;
+    ov::Tensor m_logits_storage;
+
+    static ov::Tensor _get_input_view(ov::Tensor& storage, const ov::element::Type& element_type, size_t size) {
+        if (!storage || storage.get_size() < size) {
+            size_t capacity = storage ? storage.get_size() : 0;
+            storage = ov::Tensor(element_type, {std::max(size, 2 * capacity)});
+        }
+        return ov::Tensor(storage, ov::Coordinate{0}, ov::Coordinate{size});
+    }
 public:
     /**
      * Constructs the ModelRunner.
@@ -47,6 +89,68 @@ public:
         m_num_decoder_layers(num_decoder_layers),
         m_collect_attention_scores(collect_attention_scores) {
         OPENVINO_ASSERT(m_num_decoder_layers != 0, "num_decoder_layers must be non-zero");
+        for (const auto& input : m_request.get_compiled_model().inputs()) {
+            if (input.get_names().count("prompt_log_probs_indices") > 0)
+                m_has_prompt_log_probs_indices = true;
+            if (input.get_names().count("block_indices.0") > 0)
+                m_has_per_layer_block_indices = true;
+            if (input.get_names().count("inputs_embeds") > 0) {
+                m_has_inputs_embeds = true;
+                m_hidden_size = input.get_partial_shape().rbegin()->get_length();
+            }
+        }
+    }
+
+    /**
+     * Sets the model computing embeddings of token IDs for a model taking `inputs_embeds` instead of `input_ids`.
+     * Prompts of sequence groups with prompt embeddings take them instead, other tokens are embedded by this model.
+     * @param embedding The embeddings model corresponding to the LLM.
+     */
+    void set_embedding_model(const EmbeddingsModel& embedding) {
+        OPENVINO_ASSERT(m_has_inputs_embeds, "Embeddings model is set for LLM without 'inputs_embeds' input");
+        m_embedding = embedding;
+    }
+
+    /**
+     * Sets the adapter controller of the LLM, so that tokens of each sequence group are processed with adapters from its generation config.
+     * @param adapter_controller The adapter controller configured with AdapterConfig::MODE_HOT_SWAP.
+     */
+    void set_adapter_controller(const AdapterController& adapter_controller) {
+        m_adapter_controller = adapter_controller;
+    }
+
+    /**
+     * Enables sparse attention of decode steps, the model must be transformed by apply_sparse_decode_queries_transformation
+     * with per-layer KV cache control.
+     * @param sparse_decode The selector of attended KV cache blocks.
+     */
+    void set_sparse_decode_selector(std::shared_ptr<SparseDecodeSelector> sparse_decode) {
+        OPENVINO_ASSERT(m_has_per_layer_block_indices, "Sparse decoding requires a model with per-layer block_indices inputs");
+        m_sparse_decode = std::move(sparse_decode);
+    }
+
+    /**
+     * Binds "logits" and attention score outputs of the infer request to host tensors of a remote context, e.g. USM host memory
+     * of GPU, so that results of each step are written there directly and read by the host without a copy. Shapes are updated
+     * by the plugin each step, which reallocates a tensor only if it is too small.
+     * @param context Remote context of the device the model is compiled for.
+     * @param max_num_logits_rows Number of rows of logits the tensor is allocated for, e.g. the maximum number of scheduled sequences.
+     * @param max_num_scored_tokens Number of attention scores of a layer the tensors are allocated for, e.g. the number of tokens in KV cache.
+     */
+    void set_host_output_tensors(ov::RemoteContext context, size_t max_num_logits_rows, size_t max_num_scored_tokens) {
+        for (const auto& output : m_request.get_compiled_model().outputs()) {
+            const ov::PartialShape& shape = output.get_partial_shape();
+            if (output.get_names().count("logits") > 0) {
+                // logits are [num_rows, 1, vocab_size] at decode steps
+                OPENVINO_ASSERT(shape.rank().is_static() && shape.rbegin()->is_static(), "Vocabulary size of logits must be static");
+                ov::Shape logits_shape(shape.size(), 1);
+                logits_shape.front() = max_num_logits_rows;
+                logits_shape.back() = shape.rbegin()->get_length();
+                m_request.set_tensor(output, context.create_host_tensor(output.get_element_type(), logits_shape));
+            } else if (m_collect_attention_scores && output.get_any_name().find("scores.") == 0) {
+                m_request.set_tensor(output, context.create_host_tensor(output.get_element_type(), {max_num_scored_tokens}));
+            }
+        }
     }
 
     /**
@@ -56,6 +160,30 @@ public:
         return m_request;
     }
 
+    /**
+     * @return All infer requests this ModelRunner is handling, which share KV cache tensors; the first one is `get_infer_request()`.
+     */
+    std::vector<ov::InferRequest> get_infer_requests() const {
+        std::vector<ov::InferRequest> requests{m_request};
+        for (const auto& sub_batch_runner : m_sub_batch_runners)
+            requests.push_back(sub_batch_runner->m_request);
+        return requests;
+    }
+
+    /**
+     * Sets additional infer requests of the same compiled model, so that scheduled sequence groups are split into sub-batches
+     * with balanced numbers of tokens, which are inferred concurrently. KV cache tensors must be set to all requests.
+     * @param requests Infer requests other than the one passed to the constructor.
+     */
+    void set_sub_batch_requests(const std::vector<ov::InferRequest>& requests) {
+        // other outputs, e.g. attention scores or device-side sampling results, are read from the main request only
+        OPENVINO_ASSERT(m_request.get_compiled_model().outputs().size() == 1 && !m_has_inputs_embeds,
+                        "Inference of sub-batches by several streams is supported only for models with the single 'logits' output, which take 'input_ids'");
+        m_sub_batch_runners.clear();
+        for (const auto& request : requests)
+            m_sub_batch_runners.push_back(std::make_shared<ModelRunner>(request, m_block_size, m_num_decoder_layers));
+    }
+
     /**
      * @return A map of sequence IDs to vectors of ov::Tensor per-token attention scores. Each vector element is associated with its own
      * decoder layer, in order of their execution in the model. Each ov::Tensor has a shape of {N_k}, where N_k is the length of
@@ -73,13 +201,114 @@ public:
      * @return An ov::Tensor with next-token logit scores for each sequence processed during this `forward` call.
      */
     ov::Tensor forward(const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output) {
-        size_t num_sequence_groups = scheduler_output.m_scheduled_sequence_groups_ids.size();
+        forward_async(sequence_groups, scheduler_output);
+        return wait_forward(sequence_groups, scheduler_output);
+    }
+
+    /**
+     * Prepares inputs in the same manner as `forward` and starts the inference asynchronously, so the caller can perform
+     * CPU work which does not depend on the results, while the device is busy. Must be followed by a `wait_forward` call
+     * with the same arguments.
+     * @param sequence_groups A vector of pointers to sequence groups to be processed during this `forward` call
+     * @param scheduler_output The scheduler output struct with information on the specifics of the token scheduling during this forward call
+     */
+    void forward_async(const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output) {
+        std::vector<size_t> sub_batch_ends = _split_into_sub_batches(sequence_groups, scheduler_output);
+        m_num_sub_batches = sub_batch_ends.size();
+        if (m_sparse_decode)
+            m_sparse_decode->select_blocks(m_request, sequence_groups, scheduler_output);
+        for (size_t i = 1; i < m_num_sub_batches; ++i)
+            m_sub_batch_runners[i - 1]->_forward_async(sequence_groups, scheduler_output, sub_batch_ends[i - 1], sub_batch_ends[i]);
+        _forward_async(sequence_groups, scheduler_output, 0, sub_batch_ends[0]);
+    }
+
+    /**
+     * Waits for the inference started by `forward_async`.
+     * @param sequence_groups A vector of pointers to sequence groups passed to `forward_async`
+     * @param scheduler_output The scheduler output struct passed to `forward_async`
+     * @return An ov::Tensor with next-token logit scores for each sequence processed during this `forward` call.
+     */
+    ov::Tensor wait_forward(const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output) {
+        {
+            static thread_local ManualTimer timer("pure generate inference");
+            timer.start();
+            m_request.wait();
+            for (size_t i = 1; i < m_num_sub_batches; ++i)
+                m_sub_batch_runners[i - 1]->m_request.wait();
+            timer.end();
+        }
+
+        if (m_collect_attention_scores) {
+            _collect_attention_scores(sequence_groups, scheduler_output);
+        }
+        if (m_sparse_decode) {
+            m_sparse_decode->collect_queries(m_request, sequence_groups, scheduler_output);
+        }
+
+        // return logits
+        if (m_num_sub_batches > 1)
+            return _concat_sub_batch_logits();
+        return m_request.get_tensor("logits");
+    }
+
+private:
+    // splits scheduled sequence groups into contiguous ranges with balanced numbers of tokens, one per infer request at most,
+    // so that logits of the ranges stacked together follow the order of scheduled groups; returns ends of the ranges
+    std::vector<size_t> _split_into_sub_batches(const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output) const {
+        const auto& scheduled_ids = scheduler_output.m_scheduled_sequence_groups_ids;
+        const size_t num_sub_batches = std::min(m_sub_batch_runners.size() + 1, scheduled_ids.size());
+        if (num_sub_batches <= 1)
+            return {scheduled_ids.size()};
+
+        std::vector<size_t> num_tokens(scheduled_ids.size());
+        size_t total_num_tokens = 0;
+        for (size_t i = 0; i < scheduled_ids.size(); ++i) {
+            SequenceGroup::CPtr sequence_group = sequence_groups[scheduled_ids[i]];
+            num_tokens[i] = sequence_group->get_num_scheduled_tokens() * sequence_group->num_running_seqs();
+            total_num_tokens += num_tokens[i];
+        }
+
+        std::vector<size_t> sub_batch_ends;
+        size_t num_accumulated_tokens = 0;
+        for (size_t i = 0; i + 1 < scheduled_ids.size() && sub_batch_ends.size() + 1 < num_sub_batches; ++i) {
+            num_accumulated_tokens += num_tokens[i];
+            // a range ends once it reaches its share of tokens or when each of the remaining ranges can get a single group only
+            const size_t num_remaining_groups = scheduled_ids.size() - i - 1, num_remaining_sub_batches = num_sub_batches - sub_batch_ends.size() - 1;
+            if (num_accumulated_tokens * num_sub_batches >= total_num_tokens * (sub_batch_ends.size() + 1) || num_remaining_groups == num_remaining_sub_batches)
+                sub_batch_ends.push_back(i + 1);
+        }
+        sub_batch_ends.push_back(scheduled_ids.size());
+        return sub_batch_ends;
+    }
+
+    // logits of each token are a row of vocabulary size, so rows of sub-batches are stacked as if a single request inferred them
+    ov::Tensor _concat_sub_batch_logits() {
+        std::vector<ov::Tensor> sub_batch_logits{m_request.get_tensor("logits")};
+        for (size_t i = 1; i < m_num_sub_batches; ++i)
+            sub_batch_logits.push_back(m_sub_batch_runners[i - 1]->m_request.get_tensor("logits"));
+        const ov::element::Type element_type = sub_batch_logits[0].get_element_type();
+        const size_t vocab_size = sub_batch_logits[0].get_shape().back();
+        size_t total_size = 0;
+        for (const auto& logits : sub_batch_logits)
+            total_size += logits.get_size();
+
+        ov::Tensor logits = _get_input_view(m_logits_storage, element_type, total_size);
+        uint8_t* logits_data = static_cast<uint8_t*>(logits.data());
+        for (const auto& sub_batch : sub_batch_logits) {
+            std::memcpy(logits_data, sub_batch.data(), sub_batch.get_byte_size());
+            logits_data += sub_batch.get_byte_size();
+        }
+        return ov::Tensor(element_type, {total_size / vocab_size, 1, vocab_size}, logits.data());
+    }
+
+    // prepares inputs for scheduled sequence groups in range [begin, end) and starts the inference of m_request
+    void _forward_async(const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output, size_t begin, size_t end) {
         size_t batch_size_in_sequences = 0;
         size_t total_num_tokens = 0, total_num_blocks = 0;
         size_t max_context_len_val = 0;
 
         // compute aggregated values
-        for (size_t i = 0; i < num_sequence_groups; ++i) {
+        for (size_t i = begin; i < end; ++i) {
             size_t seq_group_id = scheduler_output.m_scheduled_sequence_groups_ids[i];
             SequenceGroup::CPtr sequence_group = sequence_groups[seq_group_id];
             size_t num_sequences = sequence_group->num_running_seqs();
@@ -88,23 +317,35 @@ public:
             total_num_blocks += sequence_group->get_num_blocks() * num_sequences;
             max_context_len_val = std::max(max_context_len_val, sequence_group->get_context_len());
         }
+        // sub-batches are not used with sparse decoding, so that all scheduled sequences are inferred by m_request
+        if (m_sparse_decode)
+            total_num_blocks -= m_sparse_decode->get_num_skipped_blocks();
 
         ov::Tensor
-            input_ids(ov::element::i64, {total_num_tokens}),
-            position_ids(ov::element::i64, {total_num_tokens}),
+            input_ids = _get_input_view(m_input_ids_storage, ov::element::i64, total_num_tokens),
+            position_ids = _get_input_view(m_position_ids_storage, ov::element::i64, total_num_tokens),
+            prompt_log_probs_indices = m_has_prompt_log_probs_indices ?
+                _get_input_view(m_prompt_log_probs_indices_storage, ov::element::i64, total_num_tokens) : ov::Tensor{},
+            inputs_embeds = m_has_inputs_embeds ?
+                ov::Tensor(ov::element::f32, {total_num_tokens, m_hidden_size},
+                    _get_input_view(m_inputs_embeds_storage, ov::element::f32, total_num_tokens * m_hidden_size).data()) : ov::Tensor{},
             // PA specific parameters
-            past_lens(ov::element::i32, {batch_size_in_sequences}),
-            subsequence_begins(ov::element::i32, {batch_size_in_sequences + 1}),
+            past_lens = _get_input_view(m_past_lens_storage, ov::element::i32, batch_size_in_sequences),
+            subsequence_begins = _get_input_view(m_subsequence_begins_storage, ov::element::i32, batch_size_in_sequences + 1),
             // block_indices are handled in a special fashion below
-            block_indices_begins(ov::element::i32, {batch_size_in_sequences + 1}),
-            max_context_len(ov::element::i32, {});
+            block_indices_begins = _get_input_view(m_block_indices_begins_storage, ov::element::i32, batch_size_in_sequences + 1),
+            max_context_len = m_max_context_len;
 
         max_context_len.data<int32_t>()[0] = max_context_len_val;
 
         // get raw pointers to copy to
         int64_t
             * input_ids_data = input_ids.data<int64_t>(),
-            * position_ids_data = position_ids.data<int64_t>();
+            * position_ids_data = position_ids.data<int64_t>(),
+            * prompt_log_probs_indices_data = m_has_prompt_log_probs_indices ? prompt_log_probs_indices.data<int64_t>() : nullptr;
+        float * inputs_embeds_data = m_has_inputs_embeds ? inputs_embeds.data<float>() : nullptr;
+        m_embedded_positions.clear();
+        size_t token_offset = 0;
         int32_t 
             * past_lens_data = past_lens.data<int32_t>(),
             * subsequence_begins_data = subsequence_begins.data<int32_t>(),
@@ -114,7 +355,9 @@ public:
         subsequence_begins_data[0] = 0;
         block_indices_begins_data[0] = 0;
 
-        for (size_t i = 0; i < num_sequence_groups; ++i) {
+        m_adapters_per_tokens.clear();
+
+        for (size_t i = begin; i < end; ++i) {
             size_t seq_group_id = scheduler_output.m_scheduled_sequence_groups_ids[i];
             SequenceGroup::CPtr sequence_group = sequence_groups[seq_group_id];
             std::vector<Sequence::CPtr> running_sequences = sequence_group->get_running_sequences();
@@ -126,6 +369,9 @@ public:
             // context_len corresponds to first token within subgroup of scheduled tokens
             size_t group_context_len = group_position_id;
 
+            if (m_adapter_controller)
+                m_adapters_per_tokens.emplace_back(sequence_group->get_sampling_parameters().adapters, num_running_sequences * num_scheduled_tokens);
+
             for (size_t seq_id = 0; seq_id < num_running_sequences; ++seq_id) {
                 Sequence::CPtr sequence = running_sequences[seq_id];
 
@@ -136,19 +382,43 @@ public:
                         sequence->get_generated_ids()[position_id - sequence_group->get_prompt_len()];
 
                     position_ids_data[token_id] = position_id;
+
+                    // prompt embeddings are copied as is, other tokens are embedded below
+                    if (inputs_embeds_data) {
+                        const ov::Tensor& prompt_embeds = sequence_group->get_prompt_embeds();
+                        if (prompt_embeds && position_id < sequence_group->get_prompt_len()) {
+                            std::copy_n(prompt_embeds.data<float>() + position_id * m_hidden_size, m_hidden_size,
+                                        inputs_embeds_data + (token_offset + token_id) * m_hidden_size);
+                        } else {
+                            m_embedded_positions.push_back(token_offset + token_id);
+                        }
+                    }
+
+                    // log probabilities are gathered for the next prompt token, other positions are ignored
+                    if (prompt_log_probs_indices_data)
+                        prompt_log_probs_indices_data[token_id] = position_id + 1 < sequence_group->get_prompt_len() ?
+                            sequence_group->get_prompt_ids()[position_id + 1] : 0;
                 }
 
                 size_t expected_kv_cache_size = sequence_group->get_num_processed_tokens() - sequence_group->get_num_evicted_tokens();
+                size_t num_blocks = (sequence_group->get_context_len()  - sequence_group->get_num_evicted_tokens() +  m_block_size - 1) / m_block_size;
+                // attended blocks except the last one are full, so the current token is written at the same offset of the last block
+                if (const auto* selected_blocks = m_sparse_decode ? m_sparse_decode->get_selected_blocks(sequence->get_id()) : nullptr) {
+                    num_blocks = selected_blocks->front().size();
+                    expected_kv_cache_size = (num_blocks - 1) * m_block_size + expected_kv_cache_size % m_block_size;
+                }
                 past_lens_data[0] = expected_kv_cache_size;
 
                 subsequence_begins_data[1] = subsequence_begins_data[0] + num_scheduled_tokens;
 
-                size_t num_blocks = (sequence_group->get_context_len()  - sequence_group->get_num_evicted_tokens() +  m_block_size - 1) / m_block_size;
                 block_indices_begins_data[1] = block_indices_begins_data[0] + num_blocks;
 
                 // apply strides to shift to a next sequence
                 input_ids_data += num_scheduled_tokens;
                 position_ids_data += num_scheduled_tokens;
+                token_offset += num_scheduled_tokens;
+                if (prompt_log_probs_indices_data)
+                    prompt_log_probs_indices_data += num_scheduled_tokens;
                 past_lens_data += 1;
                 subsequence_begins_data += 1;
                 block_indices_begins_data += 1;
@@ -156,18 +426,28 @@ public:
         }
 
         // typical LLM parameters
-        m_request.set_tensor("input_ids", input_ids);
+        if (m_has_inputs_embeds) {
+            _embed_tokens(input_ids, inputs_embeds);
+            m_request.set_tensor("inputs_embeds", inputs_embeds);
+        } else {
+            m_request.set_tensor("input_ids", input_ids);
+        }
         m_request.set_tensor("position_ids", position_ids);
+        if (m_has_prompt_log_probs_indices)
+            m_request.set_tensor("prompt_log_probs_indices", prompt_log_probs_indices);
 
         // PA specific parameters
         m_request.set_tensor("past_lens", past_lens);
         m_request.set_tensor("subsequence_begins", subsequence_begins);
 
-        _set_block_indices(m_request, sequence_groups, scheduler_output, total_num_blocks);
+        _set_block_indices(m_request, sequence_groups, scheduler_output, begin, end, total_num_blocks);
 
         m_request.set_tensor("block_indices_begins", block_indices_begins);
         m_request.set_tensor("max_context_len", max_context_len);
 
+        if (m_adapter_controller)
+            m_adapter_controller.apply_to_row_groups(m_request, m_adapters_per_tokens);
+
         // print_tensor("input_ids", input_ids);
         // print_tensor("position_ids", position_ids);
 
@@ -177,28 +457,36 @@ public:
         // print_tensor("block_indices_begins", block_indices_begins);
         // print_tensor("max_context_len", max_context_len);
 
-        {
-            static ManualTimer timer("pure generate inference");
-            timer.start();
-            m_request.infer();
-            timer.end();
-        }
+        m_request.start_async();
+    }
 
-        if (m_collect_attention_scores) {
-            _collect_attention_scores(sequence_groups, scheduler_output);
+    // embeds tokens at m_embedded_positions by a single infer of the embeddings model
+    void _embed_tokens(const ov::Tensor& input_ids, const ov::Tensor& inputs_embeds) {
+        if (m_embedded_positions.empty())
+            return;
+        OPENVINO_ASSERT(m_embedding.get_output_element_type() == ov::element::f32,
+                        "Embeddings model for continuous batching must have f32 output");
+        const size_t num_embedded = m_embedded_positions.size();
+        ov::Tensor embedded_ids = _get_input_view(m_embedded_ids_storage, ov::element::i64, num_embedded);
+        const int64_t* input_ids_data = input_ids.data<int64_t>();
+        int64_t* embedded_ids_data = embedded_ids.data<int64_t>();
+        for (size_t i = 0; i < num_embedded; ++i)
+            embedded_ids_data[i] = input_ids_data[m_embedded_positions[i]];
+
+        const ov::Tensor embeddings = m_embedding.infer(ov::Tensor(ov::element::i64, {1, num_embedded}, embedded_ids_data));
+        const float* embeddings_data = embeddings.data<float>();
+        float* inputs_embeds_data = inputs_embeds.data<float>();
+        for (size_t i = 0; i < num_embedded; ++i) {
+            std::copy_n(embeddings_data + i * m_hidden_size, m_hidden_size,
+                        inputs_embeds_data + m_embedded_positions[i] * m_hidden_size);
         }
-
-        // return logits
-        return m_request.get_tensor("logits");
     }
 
-private:
     void _set_block_indices(ov::InferRequest& infer_request, const std::vector<SequenceGroup::Ptr> & sequence_groups, const Scheduler::Output& scheduler_output,
-                            size_t total_num_blocks) {
-        size_t num_sequence_groups = scheduler_output.m_scheduled_sequence_groups_ids.size();
+                            size_t begin, size_t end, size_t total_num_blocks) {
         std::vector<std::string> tensor_names = {"block_indices"};
 
-        if (m_collect_attention_scores) {
+        if (m_has_per_layer_block_indices) {
             tensor_names.resize(m_num_decoder_layers);
             for (size_t i = 0; i < tensor_names.size(); i++) {
                 tensor_names[i] = std::string("block_indices.") + std::to_string(i);
@@ -210,7 +498,7 @@ private:
         }
 
         size_t block_offset = 0;
-        for (size_t i = 0; i < num_sequence_groups; ++i) {
+        for (size_t i = begin; i < end; ++i) {
             size_t seq_group_id = scheduler_output.m_scheduled_sequence_groups_ids[i];
             SequenceGroup::CPtr sequence_group = sequence_groups[seq_group_id];
             std::vector<Sequence::CPtr> running_sequences = sequence_group->get_running_sequences();
@@ -221,14 +509,19 @@ private:
 
                 size_t num_blocks = (sequence_group->get_context_len()  - sequence_group->get_num_evicted_tokens() +  m_block_size - 1) / m_block_size;
                 const auto & kv_blocks = scheduler_output.m_block_tables.at(sequence->get_id());
+                const auto* selected_blocks = m_sparse_decode ? m_sparse_decode->get_selected_blocks(sequence->get_id()) : nullptr;
+                if (selected_blocks)
+                    num_blocks = selected_blocks->front().size();
 
                 for (size_t layer_idx = 0; layer_idx < tensor_names.size(); layer_idx++) {
                     auto input_tensor = infer_request.get_tensor(tensor_names[layer_idx]);
                     auto block_indices_data = input_tensor.data<int32_t>() + block_offset;
-                    for (size_t block_id = 0; block_id < num_blocks; ++block_id)
+                    for (size_t block_id = 0; block_id < num_blocks; ++block_id) {
                         // In case no cache eviction is requested, all per-layer block tables are expected to be identical
                         // at all times
-                        block_indices_data[block_id] = kv_blocks[layer_idx][block_id]->get_index();
+                        const size_t logical_block_id = selected_blocks ? (*selected_blocks)[layer_idx][block_id] : block_id;
+                        block_indices_data[block_id] = kv_blocks[layer_idx][logical_block_id]->get_index();
+                    }
                 }
 
                 block_offset += num_blocks;
@@ -0,0 +1,74 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace ov::genai {
+
+// Unbounded multiple producers / single consumer queue, where producers never block each other or the consumer.
+// Based on the non-intrusive MPSC node-based queue by Dmitry Vyukov:
+// https://www.1024cores.net/home/lock-free-algorithms/queues/non-intrusive-mpsc-node-based-queue
+// T must be default constructible.
+template <typename T>
+class MPSCQueue
+{
+    struct Node {
+        std::atomic<Node*> m_next{nullptr};
+        T m_value;
+    };
+
+    // the most recently pushed node, shared by producers
+    std::atomic<Node*> m_head;
+    // already consumed node preceding the oldest element, owned by the consumer
+    Node* m_tail;
+    std::atomic<size_t> m_size{0};
+
+public:
+    MPSCQueue() : m_head(new Node), m_tail(m_head.load()) { }
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    ~MPSCQueue() {
+        T value;
+        while (try_pop(value)) { }
+        delete m_tail;
+    }
+
+    // can be called from any thread
+    void push(T value) {
+        Node* node = new Node;
+        node->m_value = std::move(value);
+        // size is increased before the element is published, so it is never less than the number of poppable elements
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        Node* prev_head = m_head.exchange(node, std::memory_order_acq_rel);
+        prev_head->m_next.store(node, std::memory_order_release);
+    }
+
+    // must be called from a single consumer thread at a time
+    // returns false if the queue is empty or the oldest element is being published by a producer at the moment
+    bool try_pop(T& value) {
+        Node* next = m_tail->m_next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+        value = std::move(next->m_value);
+        next->m_value = T{};
+        delete m_tail;
+        m_tail = next;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // approximate number of elements, can be called from any thread
+    size_t size() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
+
+}
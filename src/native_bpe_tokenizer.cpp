@@ -0,0 +1,349 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "native_bpe_tokenizer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+enum class CharClass { LETTER, DIGIT, SPACE, OTHER };
+
+CharClass get_char_class(char c) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        return CharClass::LETTER;
+    if (c >= '0' && c <= '9')
+        return CharClass::DIGIT;
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r')
+        return CharClass::SPACE;
+    return CharClass::OTHER;
+}
+
+// splits ASCII text by GPT-2 pattern 's|'t|'re|'ve|'m|'ll|'d| ?\p{L}+| ?\p{N}+| ?[^\s\p{L}\p{N}]+|\s+(?!\S)|\s+
+std::vector<std::string> pre_tokenize(const std::string& text) {
+    static const std::string contractions[] = {"s", "t", "re", "ve", "m", "ll", "d"};
+    std::vector<std::string> words;
+    const size_t size = text.size();
+    auto get_run_end = [&] (size_t begin, CharClass char_class) {
+        while (begin < size && get_char_class(text[begin]) == char_class)
+            ++begin;
+        return begin;
+    };
+
+    for (size_t begin = 0; begin < size;) {
+        size_t end = begin;
+        if (text[begin] == '\'') {
+            for (const auto& contraction : contractions) {
+                if (text.compare(begin + 1, contraction.size(), contraction) == 0) {
+                    end = begin + 1 + contraction.size();
+                    break;
+                }
+            }
+        }
+        if (end == begin) {
+            const CharClass char_class = get_char_class(text[begin]);
+            if (char_class != CharClass::SPACE) {
+                end = get_run_end(begin, char_class);
+            } else if (text[begin] == ' ' && begin + 1 < size && get_char_class(text[begin + 1]) != CharClass::SPACE) {
+                end = get_run_end(begin + 1, get_char_class(text[begin + 1]));
+            } else {
+                end = get_run_end(begin, CharClass::SPACE);
+                // the last space of a run followed by a non-space starts the next word
+                if (end < size && end - begin > 1)
+                    --end;
+            }
+        }
+        words.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return words;
+}
+
+void append_utf8(std::string& text, uint32_t code_point) {
+    if (code_point < 0x80) {
+        text.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+// decodes UTF-8 text of a token, returns std::nullopt if it is not valid
+std::optional<std::vector<uint32_t>> get_code_points(const std::string& text) {
+    std::vector<uint32_t> code_points;
+    for (size_t i = 0; i < text.size();) {
+        const uint8_t lead = text[i];
+        const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size())
+            return std::nullopt;
+        uint32_t code_point = length == 1 ? lead : lead & (0x7F >> length);
+        for (size_t j = 1; j < length; ++j)
+            code_point = (code_point << 6) | (static_cast<uint8_t>(text[i + j]) & 0x3F);
+        code_points.push_back(code_point);
+        i += length;
+    }
+    return code_points;
+}
+
+// replaces each maximal invalid UTF-8 subsequence by U+FFFD like String::from_utf8_lossy used by HF tokenizers
+std::string to_valid_utf8(const std::string& bytes) {
+    std::string text;
+    text.reserve(bytes.size());
+    auto is_continuation = [&] (size_t i, uint8_t min = 0x80, uint8_t max = 0xBF) {
+        if (i >= bytes.size())
+            return false;
+        const uint8_t byte = bytes[i];
+        return byte >= min && byte <= max;
+    };
+    for (size_t i = 0; i < bytes.size();) {
+        const uint8_t lead = bytes[i];
+        size_t length = 0;
+        uint8_t min = 0x80, max = 0xBF;
+        if (lead < 0x80) {
+            text.push_back(bytes[i++]);
+            continue;
+        } else if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            min = lead == 0xE0 ? 0xA0 : 0x80;
+            max = lead == 0xED ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            min = lead == 0xF0 ? 0x90 : 0x80;
+            max = lead == 0xF4 ? 0x8F : 0xBF;
+        }
+        size_t valid_length = length == 0 ? 0 : 1;
+        while (valid_length > 0 && valid_length < length &&
+               is_continuation(i + valid_length, valid_length == 1 ? min : 0x80, valid_length == 1 ? max : 0xBF))
+            ++valid_length;
+        if (length > 0 && valid_length == length) {
+            text.append(bytes, i, length);
+            i += length;
+        } else {
+            text.append("\xef\xbf\xbd");
+            i += std::max<size_t>(valid_length, 1);
+        }
+    }
+    return text;
+}
+
+void replace_all(std::string& text, const std::string& from, const std::string& to) {
+    for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size()))
+        text.replace(pos, from.size(), to);
+}
+
+// mirrors clean_up_tokenization() of HF transformers
+void clean_up_tokenization_spaces(std::string& text) {
+    const std::pair<std::string, std::string> replacements[] = {
+        {" .", "."}, {" ?", "?"}, {" !", "!"}, {" ,", ","}, {" ' ", "'"},
+        {" n't", "n't"}, {" 'm", "'m"}, {" 's", "'s"}, {" 've", "'ve"}, {" 're", "'re"}
+    };
+    for (const auto& [from, to] : replacements)
+        replace_all(text, from, to);
+}
+
+bool is_null_or_empty(const nlohmann::json& data, const std::string& name) {
+    return !data.contains(name) || data[name].is_null() || (data[name].is_string() && data[name].get<std::string>().empty());
+}
+
+bool is_false_or_missing(const nlohmann::json& data, const std::string& name) {
+    return !data.contains(name) || data[name].is_null() || (data[name].is_boolean() && !data[name].get<bool>());
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+NativeBPETokenizer::NativeBPETokenizer() {
+    // byte-level alphabet of GPT-2: printable bytes represent themselves, others are shifted to code points from 256
+    std::vector<uint32_t> code_points(256, 0);
+    uint32_t num_shifted = 0;
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        const bool is_printable = (byte >= 33 && byte <= 126) || (byte >= 161 && byte <= 172) || (byte >= 174 && byte <= 255);
+        code_points[byte] = is_printable ? byte : 256 + num_shifted++;
+    }
+    m_char_bytes.assign(256 + num_shifted, -1);
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        append_utf8(m_byte_chars[byte], code_points[byte]);
+        m_char_bytes[code_points[byte]] = static_cast<int>(byte);
+    }
+}
+
+std::unique_ptr<NativeBPETokenizer> NativeBPETokenizer::from_tokenizer_json(const std::filesystem::path& models_path) {
+    std::ifstream file(models_path / "tokenizer.json");
+    if (!file.is_open())
+        return nullptr;
+    nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+    if (data.is_discarded() || !data.contains("model"))
+        return nullptr;
+
+    const auto& model = data["model"];
+    if (!model.contains("type") || model["type"] != "BPE" || !model.contains("vocab") || !model["vocab"].is_object() ||
+        !model.contains("merges") || !model["merges"].is_array() || !is_null_or_empty(model, "dropout") ||
+        !is_null_or_empty(model, "continuing_subword_prefix") || !is_null_or_empty(model, "end_of_word_suffix") ||
+        !is_false_or_missing(model, "byte_fallback") || !is_false_or_missing(model, "ignore_merges"))
+        return nullptr;
+    if (!is_null_or_empty(data, "normalizer") || !is_null_or_empty(data, "truncation") || !is_null_or_empty(data, "padding"))
+        return nullptr;
+    const auto& pre_tokenizer = data.value("pre_tokenizer", nlohmann::json());
+    if (!pre_tokenizer.is_object() || pre_tokenizer.value("type", "") != "ByteLevel" || pre_tokenizer.value("add_prefix_space", false) ||
+        !pre_tokenizer.value("use_regex", true))
+        return nullptr;
+    const auto& decoder = data.value("decoder", nlohmann::json());
+    if (!decoder.is_object() || decoder.value("type", "") != "ByteLevel")
+        return nullptr;
+    const auto& post_processor = data.value("post_processor", nlohmann::json());
+    if (!post_processor.is_null() && (!post_processor.is_object() || post_processor.value("type", "") != "ByteLevel"))
+        return nullptr;
+
+    std::unique_ptr<NativeBPETokenizer> tokenizer(new NativeBPETokenizer());
+    for (const auto& [text, id] : model["vocab"].items()) {
+        const int64_t token_id = id.get<int64_t>();
+        if (token_id < 0)
+            return nullptr;
+        tokenizer->m_vocab[text] = token_id;
+        if (static_cast<size_t>(token_id) >= tokenizer->m_token_texts.size())
+            tokenizer->m_token_texts.resize(token_id + 1);
+        tokenizer->m_token_texts[token_id] = text;
+    }
+    size_t rank = 0;
+    for (const auto& merge : model["merges"]) {
+        if (merge.is_string()) {
+            const std::string pair = merge.get<std::string>();
+            if (std::count(pair.begin(), pair.end(), ' ') != 1)
+                return nullptr;
+            tokenizer->m_merge_ranks.emplace(pair, rank++);
+        } else if (merge.is_array() && merge.size() == 2) {
+            tokenizer->m_merge_ranks.emplace(merge[0].get<std::string>() + " " + merge[1].get<std::string>(), rank++);
+        } else {
+            return nullptr;
+        }
+    }
+    for (const auto& added_token : data.value("added_tokens", nlohmann::json::array())) {
+        if (!added_token.contains("id") || !added_token.contains("content"))
+            return nullptr;
+        tokenizer->m_added_tokens[added_token["id"].get<int64_t>()] = {added_token["content"].get<std::string>(), added_token.value("special", false)};
+    }
+
+    std::ifstream config_file(models_path / "tokenizer_config.json");
+    if (config_file.is_open()) {
+        nlohmann::json config = nlohmann::json::parse(config_file, nullptr, false);
+        if (!config.is_discarded() && config.contains("clean_up_tokenization_spaces") && config["clean_up_tokenization_spaces"].is_boolean())
+            tokenizer->m_clean_up_tokenization_spaces = config["clean_up_tokenization_spaces"].get<bool>();
+    }
+    return tokenizer;
+}
+
+bool NativeBPETokenizer::bpe(const std::string& word, std::vector<int64_t>& token_ids) const {
+    std::vector<std::string> symbols;
+    symbols.reserve(word.size());
+    for (unsigned char byte : word)
+        symbols.push_back(m_byte_chars[byte]);
+
+    std::string pair;
+    while (symbols.size() > 1) {
+        size_t best_rank = std::numeric_limits<size_t>::max(), best_position = 0;
+        for (size_t i = 0; i + 1 < symbols.size(); ++i) {
+            pair.assign(symbols[i]).append(" ").append(symbols[i + 1]);
+            auto it = m_merge_ranks.find(pair);
+            if (it != m_merge_ranks.end() && it->second < best_rank) {
+                best_rank = it->second;
+                best_position = i;
+            }
+        }
+        if (best_rank == std::numeric_limits<size_t>::max())
+            break;
+
+        // all occurrences of the best pair are merged from left to right
+        const std::string left = symbols[best_position], right = symbols[best_position + 1];
+        std::vector<std::string> merged_symbols;
+        merged_symbols.reserve(symbols.size());
+        for (size_t i = 0; i < symbols.size();) {
+            if (i + 1 < symbols.size() && symbols[i] == left && symbols[i + 1] == right) {
+                merged_symbols.push_back(left + right);
+                i += 2;
+            } else {
+                merged_symbols.push_back(std::move(symbols[i++]));
+            }
+        }
+        symbols = std::move(merged_symbols);
+    }
+
+    for (const auto& symbol : symbols) {
+        auto it = m_vocab.find(symbol);
+        if (it == m_vocab.end())
+            return false;
+        token_ids.push_back(it->second);
+    }
+    return true;
+}
+
+std::optional<std::vector<int64_t>> NativeBPETokenizer::encode(const std::string& text) const {
+    // character classes of the pre-tokenizer are implemented for ASCII only
+    if (text.empty() || std::any_of(text.begin(), text.end(), [] (char c) { return static_cast<unsigned char>(c) >= 0x80; }))
+        return std::nullopt;
+    // added tokens are split out of the text before pre-tokenization
+    for (const auto& [id, added_token] : m_added_tokens) {
+        if (!added_token.content.empty() && text.find(added_token.content) != std::string::npos)
+            return std::nullopt;
+    }
+
+    std::vector<int64_t> token_ids;
+    for (const auto& word : pre_tokenize(text)) {
+        if (!bpe(word, token_ids))
+            return std::nullopt;
+    }
+    return token_ids;
+}
+
+std::optional<std::string> NativeBPETokenizer::decode(const std::vector<int64_t>& tokens, bool skip_special_tokens) const {
+    std::string bytes;
+    for (int64_t token_id : tokens) {
+        std::string token_text;
+        auto added_it = m_added_tokens.find(token_id);
+        if (added_it != m_added_tokens.end()) {
+            if (added_it->second.special && skip_special_tokens)
+                continue;
+            token_text = added_it->second.content;
+        } else if (token_id >= 0 && static_cast<size_t>(token_id) < m_token_texts.size() && !m_token_texts[token_id].empty()) {
+            token_text = m_token_texts[token_id];
+        } else {
+            return std::nullopt;
+        }
+
+        // like ByteLevel decoder, a token having characters out of the byte-level alphabet is kept as is
+        auto code_points = get_code_points(token_text);
+        bool is_byte_level = code_points.has_value();
+        std::string token_bytes;
+        for (size_t i = 0; is_byte_level && i < code_points->size(); ++i) {
+            const uint32_t code_point = (*code_points)[i];
+            is_byte_level = code_point < m_char_bytes.size() && m_char_bytes[code_point] >= 0;
+            if (is_byte_level)
+                token_bytes.push_back(static_cast<char>(m_char_bytes[code_point]));
+        }
+        bytes.append(is_byte_level ? token_bytes : token_text);
+    }
+
+    std::string text = to_valid_utf8(bytes);
+    if (m_clean_up_tokenization_spaces)
+        clean_up_tokenization_spaces(text);
+    return text;
+}
+
+int64_t NativeBPETokenizer::get_byte_token_id(uint8_t byte) const {
+    auto it = m_vocab.find(m_byte_chars[byte]);
+    return it == m_vocab.end() ? -1 : it->second;
+}
+
+}  // namespace genai
+}  // namespace ov
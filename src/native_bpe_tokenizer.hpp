@@ -0,0 +1,71 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ov {
+namespace genai {
+
+/**
+ * Byte-level BPE tokenizer (GPT-2 like) implemented in C++ from tokenizer.json, used instead of OV tokenizer and detokenizer
+ * models to avoid a model inference on short inputs. Only tokenizers, whose pipeline is fully described by the vocabulary and
+ * merges are supported: no normalizer, ByteLevel pre-tokenizer with the default regex, ByteLevel decoder and no post-processor
+ * adding tokens. Inputs, which are not handled natively (e.g. non-ASCII text, added tokens in text), are reported by std::nullopt,
+ * so that a caller falls back to OV models. Methods can be called from several threads at once.
+ */
+class NativeBPETokenizer {
+public:
+    /**
+     * @return Tokenizer read from models_path / tokenizer.json or nullptr if the file is missing or describes an unsupported tokenizer.
+     */
+    static std::unique_ptr<NativeBPETokenizer> from_tokenizer_json(const std::filesystem::path& models_path);
+
+    /**
+     * @return Token IDs of the text or std::nullopt if the text has to be tokenized by OV tokenizer.
+     */
+    std::optional<std::vector<int64_t>> encode(const std::string& text) const;
+
+    /**
+     * @return Text of the tokens or std::nullopt if the tokens have to be decoded by OV detokenizer.
+     */
+    std::optional<std::string> decode(const std::vector<int64_t>& tokens, bool skip_special_tokens) const;
+
+    /**
+     * @return ID of the token, whose text is the given single byte, -1 if there is no such token.
+     */
+    int64_t get_byte_token_id(uint8_t byte) const;
+
+private:
+    struct AddedToken {
+        std::string content;
+        bool special;
+    };
+
+    std::unordered_map<std::string, int64_t> m_vocab;
+    // UTF-8 encoded byte-level text of tokens by ID, empty for gaps in IDs
+    std::vector<std::string> m_token_texts;
+    // rank of a merge by "left right" key, merges with smaller ranks are applied first
+    std::unordered_map<std::string, size_t> m_merge_ranks;
+    std::unordered_map<int64_t, AddedToken> m_added_tokens;
+    // UTF-8 encoded byte-level character of each byte
+    std::array<std::string, 256> m_byte_chars;
+    // byte by code point of byte-level characters, -1 for code points, which do not represent bytes
+    std::vector<int> m_char_bytes;
+    bool m_clean_up_tokenization_spaces = false;
+
+    NativeBPETokenizer();
+
+    // appends IDs of BPE tokens of a pre-tokenized word, returns false if some of them are missing in the vocabulary
+    bool bpe(const std::string& word, std::vector<int64_t>& token_ids) const;
+};
+
+}  // namespace genai
+}  // namespace ov
@@ -6,6 +6,7 @@
 #include <tuple>
 #include <numeric>
 #include <cmath>
+#include <algorithm>
 
 namespace ov {
 namespace genai {
@@ -30,6 +31,115 @@ ov::genai::MeanStdPair calc_mean_and_std(const std::vector<ov::genai::MicroSecon
     return {mean, std};
 }
 
+namespace {
+
+// Relative width of histogram buckets of DurationStatistics: a bucket [base^(i-1), base^i) microseconds is represented
+// by its geometric middle, which differs from any value of the bucket by less than 1%.
+constexpr double BUCKET_BASE = 1.02;
+// The last bucket starts at ~2.7 hours and collects all longer durations.
+constexpr size_t NUM_BUCKETS = 1164;
+
+size_t get_bucket_index(float duration_us) {
+    if (duration_us <= 1.0f) {
+        return 0;
+    }
+    const size_t index = 1 + static_cast<size_t>(std::log(duration_us) / std::log(BUCKET_BASE));
+    return std::min(index, NUM_BUCKETS - 1);
+}
+
+}  // namespace
+
+void DurationStatistics::add(MicroSeconds duration) {
+    const float value = duration.count();
+    if (m_buckets.empty()) {
+        m_buckets.resize(NUM_BUCKETS, 0);
+        m_min = m_max = value;
+    }
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    m_buckets[get_bucket_index(value)]++;
+
+    // Welford's online algorithm
+    m_count++;
+    const double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+void DurationStatistics::add(const std::vector<MicroSeconds>& durations) {
+    for (const auto& duration : durations) {
+        add(duration);
+    }
+}
+
+void DurationStatistics::merge(const DurationStatistics& other) {
+    if (other.m_count == 0) {
+        return;
+    }
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+    // Chan's formula to combine mean and variance of two sets
+    const size_t count = m_count + other.m_count;
+    const double delta = other.m_mean - m_mean;
+    m_mean += delta * other.m_count / count;
+    m_m2 += other.m_m2 + delta * delta * m_count * other.m_count / count;
+    m_count = count;
+
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+}
+
+MeanStdPair DurationStatistics::get_mean_std() const {
+    if (m_count == 0) {
+        return {-1, -1};
+    }
+    // Statistics are accumulated in microseconds and are returned in milliseconds.
+    return {static_cast<float>(m_mean / 1000.0), static_cast<float>(std::sqrt(m_m2 / m_count) / 1000.0)};
+}
+
+float DurationStatistics::get_percentile(float percentile) const {
+    OPENVINO_ASSERT(percentile >= 0.0f && percentile <= 100.0f, "Percentile must be in [0, 100] range, got ", percentile);
+    if (m_count == 0) {
+        return -1.0f;
+    }
+    // nearest rank of the percentile among sorted durations
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count)));
+    uint64_t cumulative_count = 0;
+    size_t index = 0;
+    for (; index < NUM_BUCKETS - 1; ++index) {
+        cumulative_count += m_buckets[index];
+        if (cumulative_count >= rank)
+            break;
+    }
+    const double middle = index == 0 ? 1.0 : std::pow(BUCKET_BASE, index - 0.5);
+    return static_cast<float>(std::clamp<double>(middle, m_min, m_max) / 1000.0);
+}
+
+DurationPercentiles DurationStatistics::get_percentiles() const {
+    return {get_percentile(50.0f), get_percentile(90.0f), get_percentile(99.0f)};
+}
+
+MeanStdPair calc_mean_and_std(const DurationStatistics& folded, const std::vector<MicroSeconds>& durations) {
+    // keeps exact statistics of metrics, which were never folded
+    if (folded.get_count() == 0) {
+        return calc_mean_and_std(durations);
+    }
+    DurationStatistics statistics = folded;
+    statistics.add(durations);
+    return statistics.get_mean_std();
+}
+
+DurationPercentiles calc_percentiles(const DurationStatistics& folded, const std::vector<MicroSeconds>& durations) {
+    DurationStatistics statistics = folded;
+    statistics.add(durations);
+    return statistics.get_percentiles();
+}
+
 float PerfMetrics::get_load_time() {
     return load_time;
 }
@@ -79,6 +189,21 @@ MeanStdPair PerfMetrics::get_detokenization_duration() {
     return detokenization_duration;
 }
 
+DurationPercentiles PerfMetrics::get_ttft_percentiles() {
+    evaluate_statistics();
+    return ttft_percentiles;
+}
+
+DurationPercentiles PerfMetrics::get_tpot_percentiles() {
+    evaluate_statistics();
+    return tpot_percentiles;
+}
+
+DurationPercentiles PerfMetrics::get_ipot_percentiles() {
+    evaluate_statistics();
+    return ipot_percentiles;
+}
+
 MeanStdPair PerfMetrics::get_inference_duration() {
     evaluate_statistics();
     return inference_duration;
@@ -93,7 +218,8 @@ void PerfMetrics::evaluate_statistics(std::optional<TimePoint> start_time) {
         return;
     }
     // If start_item is specified then recalculate durations according to start times and calculate statistics only after that.
-    if (start_time.has_value()) {
+    // Token times are dropped by fold_raw_metrics(), then statistics are evaluated from folded durations.
+    if (start_time.has_value() && !raw_metrics.m_new_token_times.empty()) {
         auto start_time_val = *start_time;
         auto& tok_times = raw_metrics.m_new_token_times;
         auto& batch_sizes = raw_metrics.m_batch_sizes;
@@ -116,14 +242,18 @@ void PerfMetrics::evaluate_statistics(std::optional<TimePoint> start_time) {
     }
     
     // calc_mean_and_std will convert microsecond to milliseconds.
-    tpot = calc_mean_and_std(raw_metrics.m_durations);
-    ipot = calc_mean_and_std(raw_metrics.m_token_infer_durations);
-    ttft = calc_mean_and_std(raw_metrics.m_times_to_first_token);
+    tpot = calc_mean_and_std(raw_metrics.m_folded_durations, raw_metrics.m_durations);
+    ipot = calc_mean_and_std(raw_metrics.m_folded_token_infer_durations, raw_metrics.m_token_infer_durations);
+    ttft = calc_mean_and_std(raw_metrics.m_folded_times_to_first_token, raw_metrics.m_times_to_first_token);
+
+    generate_duration = calc_mean_and_std(raw_metrics.folded_generate_durations, raw_metrics.generate_durations);
+    tokenization_duration = calc_mean_and_std(raw_metrics.folded_tokenization_durations, raw_metrics.tokenization_durations);
+    detokenization_duration = calc_mean_and_std(raw_metrics.folded_detokenization_durations, raw_metrics.detokenization_durations);
+    inference_duration = calc_mean_and_std(raw_metrics.m_folded_inference_durations, raw_metrics.m_inference_durations);
 
-    generate_duration = calc_mean_and_std(raw_metrics.generate_durations);
-    tokenization_duration = calc_mean_and_std(raw_metrics.tokenization_durations);
-    detokenization_duration = calc_mean_and_std(raw_metrics.detokenization_durations);
-    inference_duration = calc_mean_and_std(raw_metrics.m_inference_durations);
+    tpot_percentiles = calc_percentiles(raw_metrics.m_folded_durations, raw_metrics.m_durations);
+    ipot_percentiles = calc_percentiles(raw_metrics.m_folded_token_infer_durations, raw_metrics.m_token_infer_durations);
+    ttft_percentiles = calc_percentiles(raw_metrics.m_folded_times_to_first_token, raw_metrics.m_times_to_first_token);
 
     // tokens per second
     throughput = {1000.0f / tpot.mean, (tpot.std * 1000.0f) / (tpot.mean * tpot.mean)};
@@ -160,12 +290,44 @@ PerfMetrics PerfMetrics::operator+(const PerfMetrics& right) const {
     new_detok_durations.insert(new_detok_durations.end(), right_detok_durations.begin(), right_detok_durations.end());
     new_gen_durations.insert(new_gen_durations.end(), right_gen_durations.begin(), right_gen_durations.end());
 
+    // Merge statistics of folded durations.
+    res.raw_metrics.folded_generate_durations.merge(right.raw_metrics.folded_generate_durations);
+    res.raw_metrics.folded_tokenization_durations.merge(right.raw_metrics.folded_tokenization_durations);
+    res.raw_metrics.folded_detokenization_durations.merge(right.raw_metrics.folded_detokenization_durations);
+    res.raw_metrics.m_folded_times_to_first_token.merge(right.raw_metrics.m_folded_times_to_first_token);
+    res.raw_metrics.m_folded_durations.merge(right.raw_metrics.m_folded_durations);
+    res.raw_metrics.m_folded_token_infer_durations.merge(right.raw_metrics.m_folded_token_infer_durations);
+    res.raw_metrics.m_folded_inference_durations.merge(right.raw_metrics.m_folded_inference_durations);
+
     res.num_generated_tokens += right.num_generated_tokens;
     res.num_input_tokens += right.num_input_tokens;
     res.m_evaluated = false;
+
+    res.streaming_statistics = streaming_statistics || right.streaming_statistics;
+    if (res.streaming_statistics) {
+        res.fold_raw_metrics();
+    }
     return res;
 }
 
+void PerfMetrics::fold_raw_metrics() {
+    auto fold = [](DurationStatistics& folded, std::vector<MicroSeconds>& durations) {
+        folded.add(durations);
+        // release memory as well
+        std::vector<MicroSeconds>().swap(durations);
+    };
+    fold(raw_metrics.folded_generate_durations, raw_metrics.generate_durations);
+    fold(raw_metrics.folded_tokenization_durations, raw_metrics.tokenization_durations);
+    fold(raw_metrics.folded_detokenization_durations, raw_metrics.detokenization_durations);
+    fold(raw_metrics.m_folded_times_to_first_token, raw_metrics.m_times_to_first_token);
+    fold(raw_metrics.m_folded_durations, raw_metrics.m_durations);
+    fold(raw_metrics.m_folded_token_infer_durations, raw_metrics.m_token_infer_durations);
+    fold(raw_metrics.m_folded_inference_durations, raw_metrics.m_inference_durations);
+
+    std::vector<TimePoint>().swap(raw_metrics.m_new_token_times);
+    std::vector<size_t>().swap(raw_metrics.m_batch_sizes);
+}
+
 PerfMetrics& PerfMetrics::operator+=(const PerfMetrics& right) {
     *this = *this + right;
     return *this;
@@ -0,0 +1,116 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ov::genai {
+
+/**
+ * Counter-based random number generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+ * Random numbers are a pure function of a key and a 128-bit counter, so a stream is addressed by its coordinates instead of
+ * the history of previous draws: the key is derived from a seed and a stream (request) ID, while the counter holds a sequence ID,
+ * a token position and an index of a draw at this position. Draws of a sequence at a position therefore do not depend on
+ * other streams, the order streams are processed in or the thread they are processed by.
+ * Satisfies UniformRandomBitGenerator, so it can be used with standard distributions.
+ */
+class PhiloxGenerator {
+    static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53, MULTIPLIER_1 = 0xCD9E8D57;
+    static constexpr uint32_t WEYL_0 = 0x9E3779B9, WEYL_1 = 0xBB67AE85;
+    static constexpr size_t NUM_ROUNDS = 10;
+
+    std::array<uint32_t, 2> m_key;
+    // { draw block, sequence ID, position } of the current block, the last word is reserved for the high part of the draw block
+    std::array<uint32_t, 4> m_counter = {0, 0, 0, 0};
+    std::array<uint32_t, 4> m_block;
+    size_t m_block_offset = m_block.size();
+
+    static uint64_t mix(uint64_t value) {
+        // splitmix64 finalizer, spreads close seeds and stream IDs over the whole key space
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+public:
+    using result_type = uint32_t;
+
+    /**
+     * Philox4x32-10 bijection, i.e. a block of 4 random numbers for the given counter and key.
+     */
+    static constexpr std::array<uint32_t, 4> generate_block(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+        for (size_t round = 0; round < NUM_ROUNDS; ++round) {
+            const uint64_t product_0 = uint64_t(MULTIPLIER_0) * counter[0], product_1 = uint64_t(MULTIPLIER_1) * counter[2];
+            counter = {
+                uint32_t(product_1 >> 32) ^ counter[1] ^ key[0], uint32_t(product_1),
+                uint32_t(product_0 >> 32) ^ counter[3] ^ key[1], uint32_t(product_0)
+            };
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+        return counter;
+    }
+
+    /**
+     * @param seed Seed shared by all streams.
+     * @param stream_id ID of an independent stream, e.g. request ID.
+     */
+    PhiloxGenerator(uint64_t seed, uint64_t stream_id) {
+        const uint64_t key = mix(seed ^ mix(stream_id));
+        m_key = {uint32_t(key), uint32_t(key >> 32)};
+    }
+
+    /**
+     * Moves the generator to the first draw of the given sequence at the given token position.
+     * @param sequence_id ID of a sequence within the stream, e.g. Sequence::get_grouped_id().
+     * @param position Position of a token being sampled.
+     * @param first_draw_block Index of the first block of draws, so that draws for different purposes at the same position,
+     * e.g. sampling and acceptance of a candidate, do not overlap.
+     */
+    void set_position(uint64_t sequence_id, uint64_t position, uint64_t first_draw_block = 0) {
+        m_counter = {uint32_t(first_draw_block), uint32_t(sequence_id), uint32_t(position), uint32_t(first_draw_block >> 32)};
+        m_block_offset = m_block.size();
+    }
+
+    result_type operator()() {
+        if (m_block_offset == m_block.size()) {
+            m_block = generate_block(m_counter, m_key);
+            m_block_offset = 0;
+            if (++m_counter[0] == 0)
+                ++m_counter[3];
+        }
+        return m_block[m_block_offset++];
+    }
+
+    static constexpr result_type min() {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+};
+
+// known-answer vectors of Philox4x32-10 from the Random123 reference implementation
+static_assert([] {
+    constexpr std::array<std::array<uint32_t, 4>, 3> counters = {{
+        {0, 0, 0, 0}, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}};
+    constexpr std::array<std::array<uint32_t, 2>, 3> keys = {{{0, 0}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}}};
+    constexpr std::array<std::array<uint32_t, 4>, 3> blocks = {{
+        {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+        {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const auto block = PhiloxGenerator::generate_block(counters[i], keys[i]);
+        for (size_t j = 0; j < block.size(); ++j)
+            if (block[j] != blocks[i][j])
+                return false;
+    }
+    return true;
+}(), "PhiloxGenerator does not match known-answer vectors of Philox4x32-10");
+
+}
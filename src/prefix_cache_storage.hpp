@@ -0,0 +1,240 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+
+#include "openvino/runtime/tensor.hpp"
+
+#include "device_config.hpp"
+#include "cache_manager.hpp"
+#include "prefix_tree.hpp"
+
+namespace ov::genai {
+
+/**
+ * @brief Persistent storage of prefix cached KV blocks, which allows to reuse them after the pipeline restart.
+ * Blocks are stored in a single file together with the prefix tree nodes describing their contents. The file name
+ * is derived from the fingerprint of the whole model including its weights and from KV cache layout (precision, block size and shapes),
+ * so that pipelines with different models or incompatible caches never share the same file. The key is also recorded in the file header,
+ * and a file with another key is ignored, so a collision of file names does not load blocks of another model. At startup only the index is read, while the block contents are loaded
+ * lazily, when a prompt matches to them.
+ *
+ * Block hashes are computed from token IDs by Sequence::get_hash, which doesn't depend on the platform or build.
+ */
+class PrefixCacheStorage {
+    static constexpr char MAGIC[] = "OVGENAI_PREFIX_CACHE";
+    static constexpr uint32_t VERSION = 3;
+
+    struct Record {
+        PrefixTree::BlockInfo info;
+        uint64_t data_offset;
+    };
+
+    std::filesystem::path m_file_path;
+    std::string m_key;
+    size_t m_num_layers;
+    size_t m_max_num_blocks;
+    ov::Tensor m_key_block, m_value_block;
+    std::vector<Record> m_records;
+    std::unordered_map<size_t, size_t> m_hash_to_record_idx;
+    std::ifstream m_file;
+
+    template <typename T>
+    static void _write(std::ostream& stream, const T& value) {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static T _read(std::istream& stream) {
+        T value{};
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    static void _write_string(std::ostream& stream, const std::string& value) {
+        _write<uint64_t>(stream, value.size());
+        stream.write(value.data(), value.size());
+    }
+
+    static std::string _read_string(std::istream& stream) {
+        std::string value(_read<uint64_t>(stream), '\0');
+        stream.read(value.data(), value.size());
+        return value;
+    }
+
+    size_t _get_block_byte_size() const {
+        return m_num_layers * (m_key_block.get_byte_size() + m_value_block.get_byte_size());
+    }
+
+    void _read_index() {
+        m_file.open(m_file_path, std::ios::binary);
+        if (!m_file.is_open())
+            return;
+
+        bool is_compatible = _read_string(m_file) == MAGIC && _read<uint32_t>(m_file) == VERSION && _read_string(m_file) == m_key &&
+                             _read<uint64_t>(m_file) == _get_block_byte_size();
+        size_t num_records = is_compatible ? _read<uint64_t>(m_file) : 0;
+        for (size_t record_idx = 0; record_idx < num_records && m_file.good(); ++record_idx) {
+            Record record;
+            record.info.hash = _read<uint64_t>(m_file);
+            record.info.has_parent = _read<uint8_t>(m_file) != 0;
+            record.info.parent_hash = _read<uint64_t>(m_file);
+            record.info.tokens.resize(_read<uint64_t>(m_file));
+            m_file.read(reinterpret_cast<char*>(record.info.tokens.data()), record.info.tokens.size() * sizeof(int64_t));
+            m_records.push_back(std::move(record));
+        }
+
+        uint64_t data_offset = m_file.tellg();
+        if (!m_file.good() || !is_compatible) {
+            // file of other layout or corrupted one is ignored and overwritten once the pipeline is destroyed
+            m_records.clear();
+            m_file.close();
+            return;
+        }
+        for (size_t record_idx = 0; record_idx < m_records.size(); ++record_idx) {
+            m_records[record_idx].data_offset = data_offset + record_idx * _get_block_byte_size();
+            m_hash_to_record_idx[m_records[record_idx].info.hash] = record_idx;
+        }
+    }
+
+    void _read_block_data(const Record& record, std::vector<char>& data) {
+        data.resize(_get_block_byte_size());
+        m_file.seekg(record.data_offset);
+        m_file.read(data.data(), data.size());
+        OPENVINO_ASSERT(m_file.good(), "Failed to read KV cache block from ", m_file_path);
+    }
+
+public:
+    /**
+     * Constructs the PrefixCacheStorage and reads the index of blocks stored by the previous runs.
+     * @param dir Directory where the file with stored blocks is located.
+     * @param model_fingerprint Fingerprint of the whole model, which KV cache is stored, see utils::get_model_fingerprint.
+     * @param device_config The device configuration defining KV cache layout.
+     * @param max_num_blocks Maximum number of KV cache blocks to be stored.
+     */
+    PrefixCacheStorage(const std::filesystem::path& dir, const std::string& model_fingerprint, const DeviceConfig& device_config, size_t max_num_blocks) :
+        m_num_layers(device_config.get_num_layers()), m_max_num_blocks(max_num_blocks) {
+        ov::Shape key_block_shape = device_config.get_key_cache_shape(), value_block_shape = device_config.get_value_cache_shape();
+        key_block_shape[0] = value_block_shape[0] = 1;
+        m_key_block = ov::Tensor(device_config.get_key_cache_precision(), key_block_shape);
+        m_value_block = ov::Tensor(device_config.get_value_cache_precision(), value_block_shape);
+
+        m_key = model_fingerprint + "_" + device_config.get_key_cache_precision().get_type_name() + "_" + device_config.get_value_cache_precision().get_type_name() +
+                "_" + std::to_string(device_config.get_key_cache_group_size()) + "_" + std::to_string(device_config.get_value_cache_group_size()) +
+                "_" + std::to_string(device_config.get_block_size()) +
+                "_" + std::to_string(m_num_layers) + "_" + key_block_shape.to_string() + "_" + value_block_shape.to_string();
+        std::filesystem::create_directories(dir);
+        m_file_path = dir / ("prefix_cache_" + std::to_string(std::hash<std::string>{}(m_key)) + ".bin");
+
+        _read_index();
+    }
+
+    /**
+     * @return Descriptions of the stored blocks, in which each block is described after the block preceding it in a prefix.
+     */
+    std::vector<PrefixTree::BlockInfo> get_blocks() const {
+        std::vector<PrefixTree::BlockInfo> blocks;
+        blocks.reserve(m_records.size());
+        for (const auto& record : m_records) {
+            blocks.push_back(record.info);
+        }
+        return blocks;
+    }
+
+    /**
+     * Loads contents of the stored blocks into KV cache.
+     * @param blocks_to_load Hashes of the stored blocks together with the per-layer indices of KV cache blocks to load them into.
+     * @param cache_manager KV cache to load the blocks into.
+     */
+    void load(const std::vector<std::pair<size_t, std::vector<size_t>>>& blocks_to_load, CacheManager& cache_manager) {
+        std::vector<char> data;
+        for (const auto& [hash, block_ids] : blocks_to_load) {
+            auto it = m_hash_to_record_idx.find(hash);
+            OPENVINO_ASSERT(it != m_hash_to_record_idx.end() && block_ids.size() == m_num_layers, "Internal error - block is not found in prefix cache storage");
+            _read_block_data(m_records[it->second], data);
+
+            const char* layer_data = data.data();
+            for (size_t decoder_layer_id = 0; decoder_layer_id < m_num_layers; ++decoder_layer_id) {
+                std::memcpy(m_key_block.data(), layer_data, m_key_block.get_byte_size());
+                layer_data += m_key_block.get_byte_size();
+                std::memcpy(m_value_block.data(), layer_data, m_value_block.get_byte_size());
+                layer_data += m_value_block.get_byte_size();
+                cache_manager.write_block(decoder_layer_id, block_ids[decoder_layer_id], m_key_block, m_value_block);
+            }
+        }
+    }
+
+    /**
+     * Stores blocks present in KV cache, as well as not yet loaded blocks of the previous runs, replacing the file contents.
+     * @param cached_blocks Descriptions of the blocks in KV cache together with their per-layer indices, where each block is
+     * described after the block preceding it in a prefix.
+     * @param cache_manager KV cache to read the blocks from.
+     */
+    void save(const std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>>& cached_blocks, const CacheManager& cache_manager) {
+        std::unordered_set<size_t> saved_hashes;
+        std::vector<const Record*> previous_records;
+        for (const auto& [info, block_ids] : cached_blocks) {
+            saved_hashes.insert(info.hash);
+        }
+        for (const auto& record : m_records) {
+            if (saved_hashes.size() + previous_records.size() >= m_max_num_blocks)
+                break;
+            if (saved_hashes.count(record.info.hash) == 0)
+                previous_records.push_back(&record);
+        }
+        size_t num_cached_blocks = std::min(cached_blocks.size(), m_max_num_blocks);
+
+        std::filesystem::path tmp_file_path = m_file_path;
+        tmp_file_path += ".tmp";
+        std::ofstream file(tmp_file_path, std::ios::binary | std::ios::trunc);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", tmp_file_path, " for writing");
+
+        _write_string(file, MAGIC);
+        _write<uint32_t>(file, VERSION);
+        _write_string(file, m_key);
+        _write<uint64_t>(file, _get_block_byte_size());
+        _write<uint64_t>(file, num_cached_blocks + previous_records.size());
+        auto write_info = [&file] (const PrefixTree::BlockInfo& info) {
+            _write<uint64_t>(file, info.hash);
+            _write<uint8_t>(file, info.has_parent);
+            _write<uint64_t>(file, info.parent_hash);
+            _write<uint64_t>(file, info.tokens.size());
+            file.write(reinterpret_cast<const char*>(info.tokens.data()), info.tokens.size() * sizeof(int64_t));
+        };
+        for (size_t block_idx = 0; block_idx < num_cached_blocks; ++block_idx) {
+            write_info(cached_blocks[block_idx].first);
+        }
+        for (const Record* record : previous_records) {
+            write_info(record->info);
+        }
+
+        for (size_t block_idx = 0; block_idx < num_cached_blocks; ++block_idx) {
+            const auto& block_ids = cached_blocks[block_idx].second;
+            for (size_t decoder_layer_id = 0; decoder_layer_id < m_num_layers; ++decoder_layer_id) {
+                cache_manager.read_block(decoder_layer_id, block_ids[decoder_layer_id], m_key_block, m_value_block);
+                file.write(static_cast<const char*>(m_key_block.data()), m_key_block.get_byte_size());
+                file.write(static_cast<const char*>(m_value_block.data()), m_value_block.get_byte_size());
+            }
+        }
+        std::vector<char> data;
+        for (const Record* record : previous_records) {
+            _read_block_data(*record, data);
+            file.write(data.data(), data.size());
+        }
+
+        file.close();
+        OPENVINO_ASSERT(file.good(), "Failed to write ", tmp_file_path);
+        m_file.close();
+        std::filesystem::rename(tmp_file_path, m_file_path);
+    }
+};
+
+}
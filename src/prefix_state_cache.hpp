@@ -0,0 +1,124 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "openvino/runtime/infer_request.hpp"
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+/**
+ * Cache of KV cache states of a stateful model computed for previous prompts, e.g. a long system prompt shared by requests.
+ * A new prompt restores the state of the cached prompt with the longest common prefix, trimmed to this prefix, so that only
+ * the remaining tokens are prefilled. The least recently used prompts are evicted, when the number of prompts exceeds capacity.
+ * All state variables of the model are cached, so the model must not have other states than KV cache, e.g. of LoRA adapters.
+ */
+class PrefixStateCache {
+    struct Variable {
+        std::string name;
+        ov::Tensor state;
+    };
+
+    struct Entry {
+        std::vector<int64_t> tokens;
+        std::vector<Variable> variables;
+    };
+
+    size_t m_capacity;
+    size_t m_seq_length_axis;
+    // the most recently used entries first
+    std::list<Entry> m_entries;
+
+    // non-owning view of first length tokens of a KV cache state
+    ov::Tensor get_prefix_view(const ov::Tensor& state, size_t length) const {
+        ov::Shape shape = state.get_shape();
+        OPENVINO_ASSERT(shape.at(m_seq_length_axis) >= length, "KV cache state holds ", shape.at(m_seq_length_axis), " tokens, while ", length, " are requested");
+        shape[m_seq_length_axis] = length;
+        return ov::Tensor(state, ov::Coordinate(shape.size(), 0), ov::Coordinate(shape));
+    }
+
+    // copies first length tokens of a KV cache state to host memory
+    ov::Tensor slice_state(const ov::Tensor& state, size_t length) const {
+        ov::Tensor view = get_prefix_view(state, length);
+        ov::Tensor sliced_state(state.get_element_type(), view.get_shape());
+        view.copy_to(sliced_state);
+        return sliced_state;
+    }
+
+    static size_t get_common_prefix_length(const std::vector<int64_t>& lhs, const std::vector<int64_t>& rhs) {
+        size_t length = std::min(lhs.size(), rhs.size());
+        return std::mismatch(lhs.begin(), lhs.begin() + length, rhs.begin()).first - lhs.begin();
+    }
+
+public:
+    /**
+     * @param capacity Maximum number of cached prompts.
+     * @param seq_length_axis Axis of KV cache states, along which tokens are stored.
+     */
+    PrefixStateCache(size_t capacity, size_t seq_length_axis) : m_capacity(capacity), m_seq_length_axis(seq_length_axis) {
+        OPENVINO_ASSERT(capacity > 0, "Capacity of prefix state cache must be non-zero");
+    }
+
+    /**
+     * Sets KV cache state of the request to the longest cached prefix of the prompt. The last prompt token is never restored,
+     * since its logits are needed to start generation.
+     * @param request Request of a stateful model with a batch of a single prompt, whose state is reset.
+     * @param prompt Token IDs of the prompt.
+     * @return Number of first prompt tokens, whose KV cache is restored, 0 if no cached prompt shares a prefix with the prompt.
+     */
+    size_t restore(ov::InferRequest& request, const std::vector<int64_t>& prompt) {
+        auto best_it = m_entries.end();
+        size_t best_length = 0;
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            size_t length = std::min(get_common_prefix_length(it->tokens, prompt), prompt.size() - 1);
+            if (length > best_length) {
+                best_length = length;
+                best_it = it;
+            }
+        }
+        if (best_length == 0)
+            return 0;
+
+        for (auto& state : request.query_state()) {
+            auto variable_it = std::find_if(best_it->variables.begin(), best_it->variables.end(), [&state] (const Variable& variable) {
+                return variable.name == state.get_name();
+            });
+            OPENVINO_ASSERT(variable_it != best_it->variables.end(), "State ", state.get_name(), " is missing in prefix state cache");
+            // a copy is passed, so that the cached state never aliases memory of the variable
+            state.set_state(slice_state(variable_it->state, best_length));
+        }
+        m_entries.splice(m_entries.begin(), m_entries, best_it);
+        return best_length;
+    }
+
+    /**
+     * Caches KV cache state of the prompt, which is followed by generated tokens in the state of the request.
+     * @param request Request of a stateful model with a batch of a single sequence.
+     * @param prompt Token IDs of the prompt.
+     */
+    void store(ov::InferRequest& request, const std::vector<int64_t>& prompt) {
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [&prompt] (const Entry& entry) {
+            return entry.tokens == prompt;
+        });
+        if (it != m_entries.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return;
+        }
+
+        Entry entry{prompt, {}};
+        for (auto& state : request.query_state())
+            entry.variables.push_back({state.get_name(), slice_state(state.get_state(), prompt.size())});
+        m_entries.push_front(std::move(entry));
+        if (m_entries.size() > m_capacity)
+            m_entries.pop_back();
+    }
+};
+
+}
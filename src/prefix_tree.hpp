@@ -0,0 +1,249 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include "openvino/core/except.hpp"
+#include "sequence_group.hpp"
+
+namespace ov::genai {
+
+/**
+ * @brief Radix tree over token IDs of the sequences contents with a granularity of a KV cache block.
+ * Each node corresponds to the contents of a single KV cache block (up to `block_size` tokens), so that a path from the root
+ * to a node spells out the prefix whose KV cache values are stored in the blocks with the node's hash.
+ * The tree does not own the KV cache blocks - it only points to their hashes, which can be looked up in the BlockAllocator.
+ * Entries may therefore become stale, when the corresponding blocks are overwritten - such nodes are expected to be removed by
+ * the user via `erase` as soon as it happens.
+ */
+class PrefixTree {
+public:
+    class Node {
+        friend class PrefixTree;
+        TokenIds m_tokens;
+        size_t m_hash;
+        // time of the last access to the node or to any of its descendants
+        std::chrono::time_point<std::chrono::steady_clock> m_last_access;
+        Node* m_parent;
+        std::vector<std::shared_ptr<Node>> m_children;
+    public:
+        Node(TokenIds tokens, size_t hash, Node* parent) :
+            m_tokens(std::move(tokens)), m_hash(hash), m_last_access(std::chrono::steady_clock::now()), m_parent(parent) { }
+
+        size_t get_hash() const {
+            return m_hash;
+        }
+
+        size_t get_num_tokens() const {
+            return m_tokens.size();
+        }
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    struct Match {
+        NodePtr node;
+        // number of leading tokens of the node which match to the looked up tokens
+        size_t num_matched_tokens;
+    };
+
+    // description of a single node, which is sufficient to rebuild the tree
+    struct BlockInfo {
+        size_t hash;
+        // hash of the parent node, if the node is not attached directly to the root
+        bool has_parent;
+        size_t parent_hash;
+        TokenIds tokens;
+    };
+
+    /**
+     * Constructs the PrefixTree.
+     * @param block_size The size of an individual KV cache block in tokens.
+     * @param max_num_nodes Maximum number of nodes in the tree. Once exceeded, the least recently used leaves are evicted.
+     */
+    PrefixTree(size_t block_size, size_t max_num_nodes) :
+        m_root(TokenIds{}, 0, nullptr), m_block_size(block_size), m_max_num_nodes(max_num_nodes) {
+        OPENVINO_ASSERT(block_size > 0, "block_size must be non-zero");
+        OPENVINO_ASSERT(max_num_nodes > 0, "max_num_nodes must be non-zero");
+    }
+
+    /**
+     * Adds a child node to a given parent node, or updates the existing child with the same contents.
+     * @param parent The node to which the new node is attached. nullptr stands for the root of the tree.
+     * @param begin Iterator to the first token of the block contents.
+     * @param end Iterator past the last token of the block contents. At most `block_size` tokens are expected.
+     * @param hash The hash of the KV cache blocks storing the contents.
+     * @return The inserted node.
+     */
+    NodePtr insert(const NodePtr& parent, TokenIds::const_iterator begin, TokenIds::const_iterator end, size_t hash) {
+        OPENVINO_ASSERT(begin < end && static_cast<size_t>(end - begin) <= m_block_size);
+        Node* parent_node = parent ? parent.get() : &m_root;
+        for (const auto& child : parent_node->m_children) {
+            if (child->m_hash == hash && std::equal(begin, end, child->m_tokens.begin(), child->m_tokens.end())) {
+                _touch(child.get());
+                return child;
+            }
+        }
+
+        auto node = std::make_shared<Node>(TokenIds(begin, end), hash, parent_node);
+        parent_node->m_children.push_back(node);
+        ++m_num_nodes;
+        _touch(node.get());
+
+        while (m_num_nodes > m_max_num_nodes) {
+            Node* lru_leaf = _get_lru_leaf();
+            if (lru_leaf == node.get())
+                break;
+            _erase(lru_leaf);
+        }
+        return node;
+    }
+
+    /**
+     * Finds the longest prefix of the tokens stored in the tree within a single traversal.
+     * @param tokens The tokens to be looked up.
+     * @return Matched nodes along the path from the root. All nodes, but the last one, match `block_size` tokens each.
+     * The last node may match only a part of its contents, if the tokens diverge from the stored ones inside of a block.
+     */
+    std::vector<Match> match(const TokenIds& tokens) {
+        std::vector<Match> matches;
+        Node* node = &m_root;
+        size_t offset = 0;
+        while (offset < tokens.size()) {
+            size_t num_remaining_tokens = std::min(m_block_size, tokens.size() - offset);
+            NodePtr best_child = nullptr;
+            size_t best_num_matched_tokens = 0;
+            for (const auto& child : node->m_children) {
+                size_t max_num_tokens = std::min(num_remaining_tokens, child->m_tokens.size());
+                size_t num_matched_tokens = std::mismatch(child->m_tokens.begin(), child->m_tokens.begin() + max_num_tokens,
+                                                          tokens.begin() + offset).first - child->m_tokens.begin();
+                // on ties prefer nodes matching entirely, whose blocks do not have to be copied before being appended to
+                bool is_exact_match = num_matched_tokens == child->m_tokens.size();
+                if (num_matched_tokens > best_num_matched_tokens ||
+                    (best_child && num_matched_tokens == best_num_matched_tokens && is_exact_match)) {
+                    best_child = child;
+                    best_num_matched_tokens = num_matched_tokens;
+                    if (num_matched_tokens == m_block_size)
+                        break;
+                }
+            }
+            if (!best_child)
+                break;
+
+            _touch(best_child.get());
+            matches.push_back({best_child, best_num_matched_tokens});
+            if (best_num_matched_tokens < m_block_size)
+                break;
+            node = best_child.get();
+            offset += m_block_size;
+        }
+        return matches;
+    }
+
+    /**
+     * Removes a node with all its descendants from the tree.
+     * @param node The node to be removed. Nodes which were already removed are ignored.
+     */
+    void erase(const NodePtr& node) {
+        if (node && node->m_parent)
+            _erase(node.get());
+    }
+
+    /**
+     * @return Descriptions of the nodes containing `block_size` tokens, given in the order of the tree traversal,
+     * so that each node is described after its parent.
+     */
+    std::vector<BlockInfo> get_full_blocks() const {
+        std::vector<BlockInfo> blocks;
+        std::vector<const Node*> nodes_to_visit{&m_root};
+        while (!nodes_to_visit.empty()) {
+            const Node* node = nodes_to_visit.back();
+            nodes_to_visit.pop_back();
+            for (const auto& child : node->m_children) {
+                if (child->m_tokens.size() != m_block_size)
+                    continue;
+                blocks.push_back({child->m_hash, node != &m_root, node->m_hash, child->m_tokens});
+                nodes_to_visit.push_back(child.get());
+            }
+        }
+        return blocks;
+    }
+
+    /**
+     * Adds nodes described by `get_full_blocks` of another tree. Nodes whose parents are not found are skipped.
+     * @param blocks Descriptions of the nodes, where each node is described after its parent.
+     */
+    void insert_blocks(const std::vector<BlockInfo>& blocks) {
+        std::unordered_map<size_t, NodePtr> inserted_nodes;
+        for (const auto& block : blocks) {
+            NodePtr parent = nullptr;
+            if (block.has_parent) {
+                auto parent_it = inserted_nodes.find(block.parent_hash);
+                if (parent_it == inserted_nodes.end())
+                    continue;
+                parent = parent_it->second;
+            }
+            if (block.tokens.empty() || block.tokens.size() > m_block_size)
+                continue;
+            inserted_nodes[block.hash] = insert(parent, block.tokens.begin(), block.tokens.end(), block.hash);
+        }
+    }
+
+    /**
+     * @return Number of nodes currently in the tree.
+     */
+    size_t num_nodes() const {
+        return m_num_nodes;
+    }
+
+private:
+    Node m_root;
+    size_t m_block_size;
+    size_t m_max_num_nodes;
+    size_t m_num_nodes = 0;
+
+    void _touch(Node* node) {
+        auto timestamp = std::chrono::steady_clock::now();
+        for (; node != nullptr; node = node->m_parent)
+            node->m_last_access = timestamp;
+    }
+
+    Node* _get_lru_leaf() {
+        // since each node is at least as recent as its descendants, the least recently used leaf can be found
+        // by descending into the least recently used subtree at each level
+        Node* node = &m_root;
+        while (!node->m_children.empty()) {
+            node = std::min_element(node->m_children.begin(), node->m_children.end(), [](const NodePtr& lhs, const NodePtr& rhs) {
+                return lhs->m_last_access < rhs->m_last_access;
+            })->get();
+        }
+        return node;
+    }
+
+    // detaches all descendants from their parents, so that nodes still referenced outside of the tree are recognized as removed
+    static size_t _detach_subtree(Node* node) {
+        size_t size = 1;
+        for (const auto& child : node->m_children) {
+            size += _detach_subtree(child.get());
+            child->m_parent = nullptr;
+        }
+        return size;
+    }
+
+    void _erase(Node* node) {
+        OPENVINO_ASSERT(node != &m_root);
+        m_num_nodes -= _detach_subtree(node);
+        auto& siblings = node->m_parent->m_children;
+        auto it = std::find_if(siblings.begin(), siblings.end(), [node](const NodePtr& sibling) { return sibling.get() == node; });
+        OPENVINO_ASSERT(it != siblings.end(), "internal error - node is not found among children of its parent");
+        node->m_parent = nullptr;
+        siblings.erase(it);
+    }
+};
+
+}
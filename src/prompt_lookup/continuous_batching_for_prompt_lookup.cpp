@@ -3,6 +3,8 @@
 
 #include "continuous_batching_for_prompt_lookup.hpp"
 
+#include <set>
+
 namespace ov::genai {
 
 std::map<uint64_t, ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::SequenceLen>
@@ -17,60 +19,44 @@ ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::get_generated
     return result;
 }
 
-TokenIds ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::generate_candidates(const TokenIds& input_ids, size_t num_pred_tokens, size_t max_ngram_size) {
-    if (num_pred_tokens == 0) {
-        return std::vector<int64_t>{};
+void ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::generate_candidates() {
+    // indices of finished or dropped sequences are released
+    std::set<uint64_t> running_sequence_ids;
+    for (auto& request : m_requests) {
+        for (auto& running_sequence : request->get_running_sequences())
+            running_sequence_ids.insert(running_sequence->get_id());
     }
-
-    const size_t input_length = input_ids.size();
-
-    for (int32_t ngram_size = max_ngram_size; ngram_size > 0; ngram_size--) {
-        // extract last ngram_size tokens as search ngram
-        std::vector<int64_t> ngram = std::vector<int64_t>{input_ids.cend() - ngram_size, input_ids.cend()};
-
-        // find ngram match in input_ids
-        size_t ngram_i = 0;
-        for (size_t input_i = 0; input_i < input_length - ngram_size; input_i++) {
-            if (ngram[ngram_i] != input_ids[input_i]) {
-                ngram_i = 0;
-                continue;
-            }
-
-            ngram_i++;
-
-            if (ngram_i < ngram_size) {
-                continue;
-            }
-
-            // match found with the end at input_i
-            size_t avaliable_num_pred = std::min(input_length - (input_i + 1), num_pred_tokens);
-
-            // return candidates with length of avaliable_num_pred
-            return std::vector<int64_t>{input_ids.cbegin() + input_i + 1,
-                                        input_ids.cbegin() + input_i + 1 + avaliable_num_pred};
-        }
+    for (auto it = m_ngram_indices.begin(); it != m_ngram_indices.end();) {
+        it = running_sequence_ids.count(it->first) ? std::next(it) : m_ngram_indices.erase(it);
     }
 
-    return std::vector<int64_t>{};
-}
-
-void ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::generate_candidates() {
     for (auto& request : m_requests) {
-        const auto prompt = request->get_prompt_ids();
+        const auto& prompt = request->get_prompt_ids();
         size_t max_validation_len = 0;
         for (auto& running_sequence : request->get_running_sequences()) {
-            const auto generated_tokens = running_sequence->get_generated_ids();
-            TokenIds full_input_ids = prompt;
-            full_input_ids.insert(full_input_ids.end(), generated_tokens.begin(), generated_tokens.end());
+            const auto& generated_tokens = running_sequence->get_generated_ids();
 
             size_t min_num_assistant_tokens = 0;
-            const auto sampling_params = request->get_sampling_parameters();
+            const auto& sampling_params = request->get_sampling_parameters();
             {
                 const auto generated_len = running_sequence->get_generated_len();
                 const auto left_generated_len = std::min(sampling_params.max_new_tokens, sampling_params.max_length) - generated_len - 1;
                 min_num_assistant_tokens = std::min(sampling_params.num_assistant_tokens, left_generated_len);
             }
-            TokenIds candidates = generate_candidates(full_input_ids, min_num_assistant_tokens, sampling_params.max_ngram_size);
+
+            // candidates appended on the previous step are not indexed, so indexed tokens are only extended by accepted
+            // and newly sampled ones; the index is truncated in case a sequence became shorter than it
+            auto it = m_ngram_indices.find(running_sequence->get_id());
+            if (it == m_ngram_indices.end())
+                it = m_ngram_indices.emplace(running_sequence->get_id(), NGramIndex(sampling_params.max_ngram_size)).first;
+            NGramIndex& ngram_index = it->second;
+            const size_t full_len = prompt.size() + generated_tokens.size();
+            if (ngram_index.size() > full_len)
+                ngram_index.truncate(full_len);
+            for (size_t position = ngram_index.size(); position < full_len; ++position)
+                ngram_index.append(position < prompt.size() ? prompt[position] : generated_tokens[position - prompt.size()]);
+
+            TokenIds candidates = ngram_index.find_candidates(min_num_assistant_tokens);
 
             if (!candidates.empty()) {
                 for (const auto& candidate : candidates) {
@@ -82,4 +68,4 @@ void ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl::generate
         request->set_num_validated_tokens(max_validation_len);
     }
 }
-}
\ No newline at end of file
+}
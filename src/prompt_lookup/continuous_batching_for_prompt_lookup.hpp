@@ -6,6 +6,7 @@
 #include "openvino/genai/continuous_batching_pipeline.hpp"
 
 #include "continuous_batching_impl.hpp"
+#include "prompt_lookup/ngram_index.hpp"
 
 namespace ov::genai {
 class ContinuousBatchingPipeline::ContinuousBatchingForPromptLookupImpl : public ContinuousBatchingPipeline::ContinuousBatchingImpl {
@@ -26,15 +27,20 @@ public:
                             device,
                             properties,
                             generation_config,
-                            true } {};
+                            true } {
+        // blocks freed by rollback of rejected candidates are needed again by the candidates of the next step
+        m_scheduler->set_num_reserved_tail_blocks(NUM_RESERVED_TAIL_BLOCKS);
+    };
                             
-    void generate_candidates();
+    // appends candidates to running sequences to be validated by the next step
+    virtual void generate_candidates();
 
     // { generated_len, validation_len }
     using SequenceLen = std::pair<uint64_t, uint64_t>;
     std::map<uint64_t, SequenceLen> get_generated_request_len();
 
 protected:
-    TokenIds generate_candidates(const TokenIds& input_ids, size_t num_pred_tokens, size_t max_ngram_size);
+    // { sequence_id, index of prompt and generated tokens }, updated by tokens accepted since the previous step
+    std::map<uint64_t, NGramIndex> m_ngram_indices;
 };
 }
\ No newline at end of file
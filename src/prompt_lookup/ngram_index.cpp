@@ -0,0 +1,75 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "prompt_lookup/ngram_index.hpp"
+
+#include <algorithm>
+
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+NGramIndex::NGramIndex(size_t max_ngram_size) : m_max_ngram_size(max_ngram_size) {
+    OPENVINO_ASSERT(m_max_ngram_size > 0, "max_ngram_size must be positive");
+}
+
+void NGramIndex::get_hashes(size_t end_position, std::vector<uint64_t>& hashes) const {
+    hashes.clear();
+    uint64_t hash = 0;
+    // n-grams are hashed from their last token backwards, so that hashes of all sizes are computed by a single pass
+    for (size_t ngram_size = 1; ngram_size <= std::min(m_max_ngram_size, end_position + 1); ++ngram_size) {
+        hash = (hash ^ static_cast<uint64_t>(m_tokens[end_position + 1 - ngram_size])) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+        // hashes of n-grams of different sizes must not collide with each other systematically
+        hashes.push_back(hash ^ (ngram_size * 0xBF58476D1CE4E5B9ull));
+    }
+}
+
+void NGramIndex::append(int64_t token_id) {
+    m_tokens.push_back(token_id);
+    std::vector<uint64_t> hashes;
+    get_hashes(m_tokens.size() - 1, hashes);
+    for (uint64_t hash : hashes)
+        m_first_occurrences.emplace(hash, m_tokens.size() - 1);
+}
+
+void NGramIndex::truncate(size_t length) {
+    OPENVINO_ASSERT(length <= m_tokens.size());
+    std::vector<uint64_t> hashes;
+    for (size_t position = m_tokens.size(); position-- > length;) {
+        get_hashes(position, hashes);
+        for (uint64_t hash : hashes) {
+            auto it = m_first_occurrences.find(hash);
+            if (it != m_first_occurrences.end() && it->second == position)
+                m_first_occurrences.erase(it);
+        }
+    }
+    m_tokens.resize(length);
+}
+
+TokenIds NGramIndex::find_candidates(size_t num_pred_tokens) const {
+    const size_t length = m_tokens.size();
+    if (num_pred_tokens == 0 || length < 2)
+        return {};
+
+    std::vector<uint64_t> hashes;
+    get_hashes(length - 1, hashes);
+    for (size_t ngram_size = hashes.size(); ngram_size > 0; --ngram_size) {
+        auto it = m_first_occurrences.find(hashes[ngram_size - 1]);
+        if (it == m_first_occurrences.end())
+            continue;
+        // the first occurrence is the earliest one, so if it overlaps with the last n-gram, no other occurrence is before it
+        const size_t match_end = it->second;
+        if (match_end + ngram_size >= length)
+            continue;
+        // hashes may collide, tokens are compared explicitly
+        if (!std::equal(m_tokens.end() - ngram_size, m_tokens.end(), m_tokens.begin() + (match_end + 1 - ngram_size)))
+            continue;
+
+        const size_t num_available = std::min(length - (match_end + 1), num_pred_tokens);
+        return TokenIds(m_tokens.begin() + match_end + 1, m_tokens.begin() + match_end + 1 + num_available);
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "sequence_group.hpp"
+
+namespace ov::genai {
+
+/**
+ * Index of n-grams of a growing token sequence for prompt lookup decoding. For each n-gram of up to max_ngram_size tokens
+ * the position of its first occurrence is stored by a hash of its tokens. Tokens are indexed incrementally as they are appended,
+ * so that looking up a continuation of the last n-gram does not depend on the length of the sequence.
+ */
+class NGramIndex {
+    size_t m_max_ngram_size;
+    TokenIds m_tokens;
+    // { hash of n-gram, position of the last token of its first occurrence }
+    std::unordered_map<uint64_t, size_t> m_first_occurrences;
+
+    // hashes of n-grams of sizes 1..max_ngram_size ending at the given position, in the order of sizes
+    void get_hashes(size_t end_position, std::vector<uint64_t>& hashes) const;
+
+public:
+    /**
+     * @param max_ngram_size Maximum size of n-grams being looked up.
+     */
+    explicit NGramIndex(size_t max_ngram_size);
+
+    size_t size() const {
+        return m_tokens.size();
+    }
+
+    size_t get_max_ngram_size() const {
+        return m_max_ngram_size;
+    }
+
+    /**
+     * Appends a token and indexes all n-grams ending at it.
+     */
+    void append(int64_t token_id);
+
+    /**
+     * Removes the last tokens together with n-grams first occurring at them.
+     * @param length New number of tokens, not greater than size().
+     */
+    void truncate(size_t length);
+
+    /**
+     * Finds the first occurrence of the longest n-gram ending the sequence, which does not overlap with the end of the sequence,
+     * and returns tokens following it.
+     * @param num_pred_tokens Maximum number of tokens to return.
+     * @return Continuation of the matched n-gram or an empty vector if none of n-grams occurs earlier.
+     */
+    TokenIds find_candidates(size_t num_pred_tokens) const;
+};
+
+}
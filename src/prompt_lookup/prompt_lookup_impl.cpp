@@ -8,11 +8,15 @@ namespace ov::genai {
 template<class... Ts> struct overloaded : Ts... {using Ts::operator()...;};
 template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
+void ContinuousBatchingPipeline::PromptLookupImpl::_check_sampling_params(const GenerationConfig& sampling_params) const {
+    OPENVINO_ASSERT(sampling_params.is_prompt_lookup(), "`max_ngram_size` && `num_assistant_tokens` should be specified for `prompt lookup decoding`");
+}
+
 GenerationHandle
 ContinuousBatchingPipeline::PromptLookupImpl::add_request(uint64_t request_id,
                                                           const ov::Tensor& input_ids,
                                                           ov::genai::GenerationConfig sampling_params) {
-    OPENVINO_ASSERT(sampling_params.is_prompt_lookup(), "`max_ngram_size` && `num_assistant_tokens` should be specified for `prompt lookup decoding`");
+    _check_sampling_params(sampling_params);
     return m_pipeline->add_request(request_id, input_ids, sampling_params);
 };
 
@@ -20,7 +24,7 @@ GenerationHandle
 ContinuousBatchingPipeline::PromptLookupImpl::add_request(uint64_t request_id,
                                                           const std::string& prompt,
                                                           ov::genai::GenerationConfig sampling_params) {
-    OPENVINO_ASSERT(sampling_params.is_prompt_lookup(), "`max_ngram_size` && `num_assistant_tokens` should be specified for `prompt lookup decoding`");
+    _check_sampling_params(sampling_params);
     return m_pipeline->add_request(request_id, prompt, sampling_params);
 }
 
@@ -29,6 +33,10 @@ bool ContinuousBatchingPipeline::PromptLookupImpl::has_non_finished_requests() {
 }
 
 void ContinuousBatchingPipeline::PromptLookupImpl::step() {
+    SpeculativeDecodingMetrics::StepInfo step_info;
+    const auto step_start = std::chrono::steady_clock::now();
+    step_info.start_time = step_info.draft_start_time = m_sd_metrics.get_timeline_time(step_start);
+
     ManualTimer candidates_timer("prompt_lookup_decoding: generate_candidates()");
     candidates_timer.start();
     m_pipeline->generate_candidates();
@@ -37,11 +45,13 @@ void ContinuousBatchingPipeline::PromptLookupImpl::step() {
     auto generated_len_before = m_pipeline->get_generated_request_len();
 
     ManualTimer main_timer("prompt_lookup_decoding: step()");
+    step_info.main_start_time = m_sd_metrics.get_timeline_time(std::chrono::steady_clock::now());
     main_timer.start();
     m_pipeline->step();
     main_timer.end();
     m_sd_metrics.main_duration += main_timer.get_duration();
     m_pipeline_metrics = m_pipeline->get_metrics();
+    _publish_metrics();
     auto generated_len_after = m_pipeline->get_generated_request_len();
 
     for (const auto request : generated_len_before) {
@@ -59,14 +69,20 @@ void ContinuousBatchingPipeline::PromptLookupImpl::step() {
             num_matches = (present_req_len - prev_full_req_len - 1);
             acceptance_rate = static_cast<float>(num_matches) / static_cast<float>(prev_validation_len);
         }        
+        step_info.num_proposed_tokens += prev_validation_len;
+        step_info.num_accepted_tokens += num_matches;
+        step_info.num_rolled_back_tokens += prev_validation_len - std::min(num_matches, prev_validation_len);
         m_sd_metrics.update_acceptance_rate(request_id, acceptance_rate * 100);
         m_sd_metrics.update_draft_accepted_tokens(request_id, num_matches);
     }
 
-    if (generated_len_after.empty() && 0) {
-        m_sd_metrics.print(true);
-        m_sd_metrics.clean_up();
-    }
+    // candidates are looked up in a prompt, so the draft step is a single lookup without a model and KV cache
+    step_info.num_requests = generated_len_before.size();
+    step_info.num_draft_steps = 1;
+    step_info.draft_duration = candidates_timer.get_duration();
+    step_info.main_duration = main_timer.get_duration();
+    step_info.duration = std::chrono::duration<float>(std::chrono::steady_clock::now() - step_start).count();
+    m_sd_metrics.add_step(step_info);
 }
 
 std::vector<EncodedGenerationResult>
@@ -95,7 +111,7 @@ ContinuousBatchingPipeline::PromptLookupImpl::generate(const std::vector<ov::Ten
     std::vector<GenerationHandle> main_generations;
     for (size_t request_id = 0; request_id < input_ids.size(); ++request_id) {
         OPENVINO_ASSERT(1 == input_ids[request_id].get_shape().at(0), "Use multiple tensors to pass a batch.");   
-        OPENVINO_ASSERT(sampling_params[request_id].is_prompt_lookup(), "`max_ngram_size` && `num_assistant_tokens` should be specified for `prompt lookup decoding`"); 
+        _check_sampling_params(sampling_params[request_id]);
         main_generations.push_back(m_pipeline->add_request(request_id, input_ids[request_id], sampling_params[request_id]));
     }
 
@@ -142,12 +158,14 @@ ContinuousBatchingPipeline::PromptLookupImpl::generate(const std::vector<ov::Ten
             result.m_scores.push_back(generation_output.score);
         }
         result.m_status = generation->get_status();
+        result.m_timings = generation->get_timings();
         results.push_back(std::move(result));
     }
 
     OPENVINO_ASSERT(results.size() == input_ids.size());
     generate_timer.end();
     m_sd_metrics.total_duration = generate_timer.get_duration();
+    m_sd_metrics.write_timeline_if_requested();
 
     return results;
 }
@@ -15,7 +15,13 @@ class ContinuousBatchingPipeline::PromptLookupImpl : public ContinuousBatchingPi
 protected:
     std::shared_ptr<ContinuousBatchingForPromptLookupImpl> m_pipeline;
     SpeculativeDecodingMetrics m_sd_metrics;
-    
+
+    // used by pipelines, which propose candidates in another way than prompt lookup and create m_pipeline themselves, e.g. MedusaImpl
+    PromptLookupImpl() = default;
+
+    // throws if a request cannot be processed by the pipeline
+    virtual void _check_sampling_params(const GenerationConfig& sampling_params) const;
+
 public:
     PromptLookupImpl(const std::shared_ptr<ov::Model>& model,
                      const Tokenizer& tokenizer,
@@ -3,6 +3,8 @@
 
 #include "sampler.hpp"
 
+#include "openvino/core/parallel.hpp"
+
 namespace ov::genai {
 // Modified Knuth–Morris–Pratt algorithm which returns tokens following after every needle occurrence in haystack
 std::vector<int64_t> kmp_search(const std::vector<int64_t>& haystack, const std::vector<int64_t>& needle) {
@@ -67,6 +69,53 @@ std::vector<Token> log_softmax(const ov::Tensor& logits, size_t batch_idx) {
     return tokens;
 }
 
+/**
+ * Selects top_k tokens of the last position of a beam by log probability, without materializing log probabilities of the whole vocabulary.
+ * @param logits Logits of shape [batch, seq_len, vocab_size].
+ * @param batch_idx Index of the beam in the batch.
+ * @param penalties Values subtracted from log probabilities of tokens (infinity bans a token), of vocab_size length.
+ * @param top_k Number of tokens to select.
+ * @param top_tokens Filled with selected tokens sorted by log probability in descending order.
+ */
+void select_top_log_probs(const ov::Tensor& logits, size_t batch_idx, const std::vector<float>& penalties, size_t top_k, std::vector<Token>& top_tokens) {
+    ov::Shape shape = logits.get_shape();
+    OPENVINO_ASSERT(shape.size() == 3);
+    size_t batch = shape[0], seq_len = shape[1], vocab_size = shape[2];
+    OPENVINO_ASSERT(batch_idx < batch, "Logits batch size doesn't match the number of beams");
+    OPENVINO_ASSERT(penalties.size() >= vocab_size);
+
+    const float* beam_logits = logits.data<const float>() + batch_idx * seq_len * vocab_size + (seq_len - 1) * vocab_size;
+    // plain reductions over contiguous logits, no per-token objects are created
+    float max_logit = -std::numeric_limits<float>::infinity();
+    for (size_t idx = 0; idx < vocab_size; ++idx)
+        max_logit = std::max(max_logit, beam_logits[idx]);
+    float sum_exp = 0.0f;
+    for (size_t idx = 0; idx < vocab_size; ++idx)
+        sum_exp += std::exp(beam_logits[idx] - max_logit);
+    const float log_norm = max_logit + std::log(sum_exp);
+
+    // min-heap of the best tokens, most of the tokens are rejected by a single comparison with its top
+    auto greater_log_prob = [] (const Token& left, const Token& right) {
+        return left.m_log_prob > right.m_log_prob;
+    };
+    top_tokens.clear();
+    top_k = std::min(top_k, vocab_size);
+    for (size_t idx = 0; idx < vocab_size; ++idx) {
+        const float value = beam_logits[idx] - penalties[idx];
+        if (top_tokens.size() < top_k) {
+            top_tokens.emplace_back(value, int64_t(idx));
+            std::push_heap(top_tokens.begin(), top_tokens.end(), greater_log_prob);
+        } else if (value > top_tokens.front().m_log_prob) {
+            std::pop_heap(top_tokens.begin(), top_tokens.end(), greater_log_prob);
+            top_tokens.back() = Token(value, int64_t(idx));
+            std::push_heap(top_tokens.begin(), top_tokens.end(), greater_log_prob);
+        }
+    }
+    std::sort_heap(top_tokens.begin(), top_tokens.end(), greater_log_prob);
+    for (Token& token : top_tokens)
+        token.m_log_prob -= log_norm;
+}
+
 std::vector<int64_t> wrap_tokens(const std::vector<int64_t>& tokens, const std::vector<int64_t>& prefix_tokens, const std::vector<int64_t>& suffix_tokens) {
     std::vector<int64_t> all_tokens = prefix_tokens;
     all_tokens.insert(all_tokens.end(), tokens.begin(), tokens.end());
@@ -313,32 +362,46 @@ void Sampler::GroupBeamSearcher::select_next_tokens(const ov::Tensor& logits,
         if (group.done)
             continue;
 
-        std::vector<Beam> candidates;
+        std::vector<Beam>& candidates = m_candidates;
+        candidates.clear();
         candidates.reserve(group_size * 2 * group_size);
+        const size_t vocab_size = logits.get_shape().back();
+        if (m_penalties.size() < vocab_size)
+            m_penalties.resize(vocab_size, 0.0f);
         for (const Beam& beam : group.ongoing) {
-            std::vector<Token> tokens = log_softmax(logits, beam.m_global_beam_idx);
+            // penalties are sparse, so only touched entries are reset after the beam is processed
+            auto add_penalty = [this] (int64_t token_id, float penalty) {
+                if (m_penalties[token_id] == 0.0f)
+                    m_penalized_tokens.push_back(token_id);
+                m_penalties[token_id] += penalty;
+            };
 
             // apply diversity penalty
             for (auto prev_group_id = 0; prev_group_id < group_id; ++prev_group_id) {
                 for (const Beam& prev_beam : child_beams_per_group[prev_group_id]) {
-                    tokens[prev_beam.m_token_id].m_log_prob -= m_parameters.diversity_penalty;
+                    add_penalty(prev_beam.m_token_id, m_parameters.diversity_penalty);
                 }
             }
 
             // apply n_gramm
-            std::vector<int64_t> full_text{m_sequence_group->get_prompt_ids()};
-            full_text.insert(full_text.end(), beam.m_sequence->get_generated_ids().begin(), beam.m_sequence->get_generated_ids().end());
-            if (full_text.size() > 1 && full_text.size() >= m_parameters.no_repeat_ngram_size) {
+            const auto& generated_ids = beam.m_sequence->get_generated_ids();
+            const size_t full_text_size = m_sequence_group->get_prompt_ids().size() + generated_ids.size();
+            if (full_text_size > 1 && full_text_size >= m_parameters.no_repeat_ngram_size) {
+                std::vector<int64_t>& full_text = m_full_text;
+                full_text.assign(m_sequence_group->get_prompt_ids().begin(), m_sequence_group->get_prompt_ids().end());
+                full_text.insert(full_text.end(), generated_ids.begin(), generated_ids.end());
                 auto tail_start = full_text.end() - ptrdiff_t(m_parameters.no_repeat_ngram_size) + 1;
                 for (int64_t banned_token : kmp_search(full_text, {tail_start, full_text.end()})) {
-                    tokens[banned_token].m_log_prob = -std::numeric_limits<float>::infinity();
+                    add_penalty(banned_token, std::numeric_limits<float>::infinity());
                 }
             }
 
-            // sort tokens
-            std::sort(tokens.begin(), tokens.end(), [](Token left, Token right) {
-                return left.m_log_prob > right.m_log_prob;  // Most probable tokens in front
-            });
+            // only 2 * group_size most probable tokens can be selected, so others are not sorted
+            std::vector<Token>& tokens = m_top_tokens;
+            select_top_log_probs(logits, beam.m_global_beam_idx, m_penalties, 2 * group_size, tokens);
+            for (int64_t token_id : m_penalized_tokens)
+                m_penalties[token_id] = 0.0f;
+            m_penalized_tokens.clear();
 
             size_t add_count = 0;
             for (Token token : tokens) {
@@ -406,6 +469,18 @@ void Sampler::GroupBeamSearcher::select_next_tokens(const ov::Tensor& logits,
             }
         }
 
+        // drop children, which cannot replace finished beams, so that their KV cache is freed at this step
+        if (m_parameters.prune_beams) {
+            const size_t max_new_tokens = m_parameters.get_max_new_tokens(m_sequence_group->get_prompt_len());
+            auto& child_beams = child_beams_per_group[group_id];
+            child_beams.erase(std::remove_if(child_beams.begin(), child_beams.end(), [&] (const Beam& child_beam) {
+                if (!group.is_hopeless(child_beam, max_new_tokens, m_parameters))
+                    return false;
+                --parent_2_num_childs_map[child_beam.m_sequence->get_id()];
+                return true;
+            }), child_beams.end());
+        }
+
         // check whether group has finished
         group.is_done(m_parameters);
 
@@ -425,6 +500,9 @@ void Sampler::GroupBeamSearcher::select_next_tokens(const ov::Tensor& logits,
         }
     }
 
+    // candidates keep references to sequences, which may be removed
+    m_candidates.clear();
+
     // fork child sequences for non-finished groups
 
     for (size_t group_id = 0; group_id < m_groups.size(); ++group_id) {
@@ -483,55 +561,65 @@ Logits Sampler::_get_logit_vector(ov::Tensor logits, size_t batch_idx, size_t to
 Token Sampler::_greedy_sample(const Logits& logits, size_t top_logprobs) const {
     // For greedy sampling we do not expect sorting or shrinking considered tokens
     // so we can operate directly on the data buffer
-    size_t m = std::max(size_t(1), top_logprobs); // ensure m is at least 1
-    std::vector<float> top_values(m, -std::numeric_limits<float>::infinity());
-    std::vector<size_t> top_indexes(m, 0);
-
-    for (size_t i = 0; i < logits.m_size; ++i) {
-        if (logits.m_data[i] > top_values.back()) {
-            top_values.back() = logits.m_data[i];
-            top_indexes.back() = i;
-
-            for (size_t j = top_values.size() - 1; j > 0 && top_values[j] > top_values[j - 1]; --j) {
-                std::swap(top_values[j], top_values[j - 1]);
-                std::swap(top_indexes[j], top_indexes[j - 1]);
+    const float* data = logits.m_data;
+    float max_value = -std::numeric_limits<float>::infinity();
+    size_t max_index = 0;
+
+    if (!top_logprobs) {
+        for (size_t i = 0; i < logits.m_size; ++i) {
+            if (data[i] > max_value) {
+                max_value = data[i];
+                max_index = i;
             }
         }
+        return Token(0.0f, max_index);
     }
 
-    size_t max_index = top_indexes.front();
-    float max_value = 0.0;
-
-    if (top_logprobs) {
-        // apply log softmax to max value
-        max_value = top_values.front();
-        float log_sum = std::log(std::accumulate(
-            logits.m_data, logits.m_data + logits.m_size, 0.0f, [max_value](float accumulated, float to_add) {
-                return accumulated + std::exp(to_add - max_value);
-        }));
-        max_value = -log_sum;
+    // only the log probability of the selected token is returned (see GenerationConfig::logprobs), so log-sum-exp is accumulated
+    // in the same pass as argmax: the sum is rescaled to a new maximum, which happens a few times per vocabulary
+    // tokens masked by -inf are skipped, since they add nothing, while exp(-inf - (-inf)) is NaN
+    const float masked_value = -std::numeric_limits<float>::infinity();
+    float sum_exp = 0.0f;
+    for (size_t i = 0; i < logits.m_size; ++i) {
+        if (data[i] > max_value) {
+            sum_exp = sum_exp * std::exp(max_value - data[i]) + 1.0f;
+            max_value = data[i];
+            max_index = i;
+        } else if (data[i] != masked_value) {
+            sum_exp += std::exp(data[i] - max_value);
+        }
     }
-
-    return Token(max_value, max_index);
+    // log softmax of the maximum
+    return Token(-std::log(sum_exp), max_index);
 }
 
-std::vector<Token> Sampler::_multinomial_sample(const Logits& logits, size_t num_tokens_per_sequence) {
-    // If top_p or top_k was applied we use sorted vector, if not we go with original buffer.
-    std::vector<float> multinomial_weights;
-    multinomial_weights.reserve(logits.m_size);
-    if (logits.is_vector_initialized())
-        for (auto& logit: logits.m_vector) multinomial_weights.emplace_back(logit.m_log_prob);
-    else
-        multinomial_weights.assign(logits.m_data, logits.m_data + logits.m_size);
+std::vector<Token> Sampler::_multinomial_sample(const Logits& logits, size_t num_tokens_per_sequence, PhiloxGenerator& rng_engine,
+                                                std::vector<double>& cumulative_weights) {
+    // weights are probabilities of either all tokens of the vocabulary or candidates left by top_p / top_k filters
+    // cumulative weights are kept in a buffer reused across tokens, so that sampling does not allocate
+    cumulative_weights.resize(logits.m_size);
+    double weights_sum = 0.0;
+    if (logits.is_vector_initialized()) {
+        for (size_t i = 0; i < logits.m_size; ++i) {
+            weights_sum += logits.m_vector[i].m_log_prob;
+            cumulative_weights[i] = weights_sum;
+        }
+    } else {
+        for (size_t i = 0; i < logits.m_size; ++i) {
+            weights_sum += logits.m_data[i];
+            cumulative_weights[i] = weights_sum;
+        }
+    }
 
-    // std::discrete_distribution returns corrupted results when applied to log probabilities
-    // which result returning NAN only logprobs.
-    // so log() is applied after this line
-    auto dist = std::discrete_distribution<size_t>(multinomial_weights.begin(), multinomial_weights.end()); // equivalent to multinomial with number of trials == 1
+    // equivalent to multinomial with number of trials == 1
+    auto dist = std::uniform_real_distribution<double>(0.0, weights_sum);
 
     std::vector<Token> out_tokens;
+    out_tokens.reserve(num_tokens_per_sequence);
     for (size_t token_idx = 0; token_idx < num_tokens_per_sequence; ++token_idx) {
-        size_t element_to_pick = dist(rng_engine);
+        // the first token with cumulative weight above the drawn value has non-zero weight
+        auto it = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), dist(rng_engine));
+        size_t element_to_pick = std::min<size_t>(std::distance(cumulative_weights.begin(), it), logits.m_size - 1);
         if (logits.is_vector_initialized()) {
             auto logit = logits.m_vector[element_to_pick];
             logit.m_log_prob = std::log(logit.m_log_prob);
@@ -543,6 +631,20 @@ std::vector<Token> Sampler::_multinomial_sample(const Logits& logits, size_t num
     return out_tokens;
 }
 
+const std::string& Sampler::_get_token_text(int64_t token_id) {
+    {
+        std::lock_guard<std::mutex> lock(m_token_texts_mutex);
+        auto it = m_token_texts.find(token_id);
+        if (it != m_token_texts.end())
+            return it->second;
+    }
+    // decoded without the lock, so that parallel sampling is not serialized by the tokenizer
+    std::string text = m_tokenizer.decode(TokenIds{token_id});
+    std::lock_guard<std::mutex> lock(m_token_texts_mutex);
+    // references to elements of unordered_map stay valid on insertion
+    return m_token_texts.emplace(token_id, std::move(text)).first->second;
+}
+
 std::vector<int64_t> Sampler::_try_finish_generation(SequenceGroup::Ptr & sequence_group) {
     auto sampling_params = sequence_group->get_sampling_parameters();
     std::vector<int64_t> dropped_seq_ids;
@@ -565,7 +667,12 @@ std::vector<int64_t> Sampler::_try_finish_generation(SequenceGroup::Ptr & sequen
 
         if (!sampling_params.stop_strings.empty()) {
             auto& stop_strings = m_stop_strings.at(sequence_group->get_request_id());
-            auto match_result = match_stop_string(m_tokenizer, running_sequence->get_generated_ids(), stop_strings, sampling_params.include_stop_str_in_output);
+            const auto& automaton = m_stop_string_automata.at(sequence_group->get_request_id());
+            const auto& generated_ids = running_sequence->get_generated_ids();
+            // the exact match decodes tokens, so it's skipped when texts of single tokens do not contain any stop string
+            if (!automaton.may_match(generated_ids, stop_strings.first, [this](int64_t token_id) -> const std::string& { return _get_token_text(token_id); }))
+                continue;
+            auto match_result = match_stop_string(m_tokenizer, generated_ids, stop_strings, sampling_params.include_stop_str_in_output);
             if (match_result.is_matched) {
                 running_sequence->remove_last_tokens(match_result.to_remove);
 
@@ -662,7 +769,8 @@ bool Sampler::validate_candidate(
     Token& sampled_token,
     bool& is_extend_sequence,
     size_t& max_removed_tokens,
-    bool do_sample) {
+    bool do_sample,
+    PhiloxGenerator& rng_engine) {
     OPENVINO_ASSERT(token_idx > 0);
     const auto& generated_tokens = running_sequence->get_generated_ids();
     auto it_token_id = generated_tokens.rbegin();
@@ -679,7 +787,11 @@ bool Sampler::validate_candidate(
         float p_i = std::exp(*it_log_prob),
                 q_i = std::exp(sampled_token.m_log_prob),
                 probability_ratio = p_i / q_i;
-        
+
+        // acceptance depends only on the request, the sequence and the position of the candidate, while its draws are
+        // disjoint from draws sampling a token at the same position
+        constexpr uint64_t ACCEPTANCE_DRAW_BLOCK = uint64_t{1} << 32;
+        rng_engine.set_position(running_sequence->get_grouped_id(), running_sequence->get_generated_len() - token_idx, ACCEPTANCE_DRAW_BLOCK);
         auto dist = std::uniform_int_distribution<>(0, 100); // equivalent to multinomial with number of trials == 1
         float r_i = dist(rng_engine);
         r_i /= 100;
@@ -743,15 +855,181 @@ process_stop_strings(const std::set<std::string>& stop_strings, Tokenizer& token
     return result;
 }
 
+void Sampler::_sample_sequence_group(SequenceGroup::Ptr sequence_group, ov::Tensor sequence_group_logits, ov::Tensor sequence_group_logits_indices,
+                                     bool is_validation_mode_enabled, SamplerOutput& sampler_output) {
+    size_t num_running_sequences = sequence_group->num_running_seqs();
+    size_t actual_seq_len = sequence_group->get_num_scheduled_tokens(); // points to a token which needs to be sampled
+    const ov::genai::GenerationConfig& sampling_params = sequence_group->get_sampling_parameters();
+
+    const auto request_id = sequence_group->get_request_id();
+    auto& stop_strings = m_stop_strings.at(request_id);
+    auto& logit_processor = m_logit_processors.at(request_id);
+    PhiloxGenerator& rng_engine = m_rng_engines.at(request_id);
+    // maps positions of candidates selected on device to token IDs, layout of the indices is the same as of logits
+    auto map_to_token_id = [&sequence_group_logits_indices] (Token& token, size_t batch_idx, size_t token_offset) {
+        if (!sequence_group_logits_indices)
+            return;
+        ov::Shape shape = sequence_group_logits_indices.get_shape();
+        size_t seq_len = shape[1], num_candidates = shape[2];
+        const int32_t* indices_data = sequence_group_logits_indices.data<int32_t>() + (batch_idx * seq_len + seq_len - token_offset - 1) * num_candidates;
+        token.m_index = indices_data[token.m_index];
+    };
+    size_t max_removed_tokens_per_request = 0, min_generated_len = std::numeric_limits<size_t>::max(), updated_validation_len = 0;
+    if (sequence_group->requires_sampling()) {
+        // get number of token to be validated
+        auto num_tokens_to_process = sequence_group->get_num_tokens_to_validate();
+        if (num_tokens_to_process > actual_seq_len - 1) {
+            auto delta = num_tokens_to_process - (actual_seq_len - 1);
+            updated_validation_len = std::max(updated_validation_len, delta);
+            num_tokens_to_process -= delta;
+        }
+        if (sampling_params.is_greedy_decoding() || sampling_params.is_multinomial()) {
+            std::vector<Sequence::Ptr> running_sequences = sequence_group->get_running_sequences();
+            if (sampling_params.is_greedy_decoding()) {
+                OPENVINO_ASSERT(num_running_sequences == 1);
+            }
+            for (size_t running_sequence_id = 0; running_sequence_id < num_running_sequences; ++running_sequence_id) {
+                auto& running_sequence = running_sequences[running_sequence_id];
+                bool is_validation_passed = true;
+                // make `num_tokens_to_process` iteration to validate a candidate generated by `draft_model` + 1 iteration to generate one more token by `main_model`
+                for (size_t i = 0; i <= num_tokens_to_process; ++i) {
+                    // calculate token offset from the end of logit
+                    size_t token_offset = num_tokens_to_process - i;
+                    // max counter of needed to be sampled tokens
+                    OPENVINO_ASSERT(running_sequence->get_generated_len() >= token_offset);
+                    size_t generated_and_verified_len = running_sequence->get_generated_len() - token_offset;
+                    OPENVINO_ASSERT(sampling_params.max_new_tokens >= generated_and_verified_len);
+                    size_t max_num_sampled_token = sampling_params.max_new_tokens - generated_and_verified_len;
+                    if (max_num_sampled_token == 0) {
+                        stop_sample_tokens(running_sequence, token_offset, max_num_sampled_token, max_removed_tokens_per_request);
+                        break;
+                    }
+                    
+                    // do sampling only for token validation/generation.
+                    // continue in case of extending draft model sequences by main model generated tokens which
+                    // should be taken to KV cache without validation
+                    if (!is_validation_mode_enabled && token_offset > 0) {
+                        continue;
+                    }
+
+                    auto logit_vector = _get_logit_vector(sequence_group_logits, running_sequence_id, token_offset);
+                    if (logit_processor.has_structured_output())
+                        logit_processor.set_structured_output_sequence(running_sequence->get_id(), running_sequence->get_generated_ids(), generated_and_verified_len);
+                    logit_processor.apply(logit_vector);
+
+                    Token sampled_token;
+                    bool is_generate_n_tokens = false;
+                    if (sampling_params.is_greedy_decoding()) {
+                        sampled_token = { _greedy_sample(logit_vector, sampling_params.logprobs) };
+                        if (sequence_group_logits_indices && sampling_params.logprobs) {
+                            // candidates selected on device are already log probabilities over the whole vocabulary
+                            sampled_token.m_log_prob = logit_vector.m_data[sampled_token.m_index];
+                        }
+                        map_to_token_id(sampled_token, running_sequence_id, token_offset);
+                    } else {
+                        // is_multinomial()
+                        is_generate_n_tokens = sequence_group->num_total_seqs() == 1;
+                        const size_t num_tokens_per_sequence = is_generate_n_tokens ? sampling_params.num_return_sequences : 1;
+                        is_generate_n_tokens &= (num_tokens_per_sequence > 1);
+                        // random numbers depend only on the request, the sequence and the position of the sampled token
+                        rng_engine.set_position(running_sequence->get_grouped_id(), generated_and_verified_len);
+                        auto sampled_token_ids = _multinomial_sample(logit_vector, num_tokens_per_sequence, rng_engine, logit_processor.get_cumulative_weights_buffer());
+                        for (auto& token : sampled_token_ids)
+                            map_to_token_id(token, running_sequence_id, token_offset);
+                        OPENVINO_ASSERT(sampled_token_ids.size(), num_tokens_per_sequence);
+                        // to create n sequence just in case of `sequence_group->num_total_seqs() == 1` and `sampling_params.num_return_sequences > 1`
+                        if (is_generate_n_tokens) {
+                            const auto forked_seq_ids = create_n_forked_sequences(sequence_group, logit_processor, sampled_token_ids);
+                            sampler_output.m_forked_sequences.insert({running_sequences[0]->get_id(), forked_seq_ids});
+                        }
+                        sampled_token = sampled_token_ids.front();
+                        // make `_speculative_sampling` in case of previous token was not accepted in speculative decoding
+                        if (!is_validation_passed) {
+                            float p_prime = get_p_prime(running_sequence, sampled_token, token_offset + 1);
+                            max_removed_tokens_per_request = std::max(max_removed_tokens_per_request, token_offset);
+                            // update prob only in case candidate prob > sampled token prob
+                            if (p_prime > 0.f) {
+                                auto prob = std::exp(sampled_token.m_log_prob);
+                                prob /= p_prime;
+                                sampled_token.m_log_prob = std::log(prob);
+                            }
+                        }
+                    }
+                    logit_processor.release_candidates(logit_vector);
+                    // flag to add sampled token to generated sequence or extend logit processors only
+                    bool is_extend_sequence = token_offset == 0 || is_generate_n_tokens || !is_validation_passed;
+                    if (is_validation_mode_enabled && !is_extend_sequence) {
+                        is_validation_passed = validate_candidate(running_sequences[running_sequence_id], token_offset, sampled_token,
+                                                                  is_extend_sequence, max_removed_tokens_per_request, sampling_params.do_sample, rng_engine);
+                        // doing resample in case of non accepted tokens in specualtive sampling
+                        if (!is_validation_passed && sampling_params.do_sample) {
+                            continue;
+                        }
+                        // update log prob just while validation process
+                        if (!is_extend_sequence) {
+                            OPENVINO_ASSERT(generated_and_verified_len < running_sequences[running_sequence_id]->get_generated_len());
+                            running_sequence->update_generated_log_prob(generated_and_verified_len, sampled_token.m_log_prob);
+                        }
+                    }
+                    register_new_token(sampled_token, running_sequences[running_sequence_id], logit_processor, is_extend_sequence, is_validation_mode_enabled);
+                    // to exit from sampling in case of failed token validation
+                    if (!is_validation_passed) {
+                        break;
+                    }
+                }
+                min_generated_len = std::min(min_generated_len, running_sequence->get_generated_len());
+            }
+            align_all_sequence_len(sequence_group, min_generated_len, logit_processor);
+            for (const auto& dropped_seq_id : _try_finish_generation(sequence_group)) {
+                sampler_output.m_dropped_sequences.push_back(dropped_seq_id);
+            }
+        } else if (sampling_params.is_beam_search()) {
+            // current algorithm already adds new tokens to running sequences and
+            m_beam_search_info.at(request_id).select_next_tokens(sequence_group_logits, sampler_output, stop_strings);
+
+            // check max length stop criteria
+            std::vector<Sequence::Ptr> running_sequences = sequence_group->get_running_sequences();
+            if (!sequence_group->has_finished() &&
+                running_sequences[0]->get_generated_len() == sampling_params.max_new_tokens) {
+                // stop sequence by max_new_tokens
+                m_beam_search_info.at(request_id).finalize(sampler_output);
+            }
+        }
+        // Notify handle after sampling is done. 
+        // For non-streaming this is effective only when the generation is finished.
+        OPENVINO_ASSERT(num_tokens_to_process >= max_removed_tokens_per_request);
+        sequence_group->notify_handle();
+    } else {
+        // we are in prompt processing phase when prompt is split into chunks and processed step by step
+    }
+
+    // NOTE: it should be before 'get_num_scheduled_tokens' is used
+    // update internal state of sequence group to reset scheduler tokens and update currently processed ones
+    auto min_validated_tokens = sequence_group->get_num_tokens_to_validate() - max_removed_tokens_per_request;
+    sequence_group->finish_iteration();
+    // decrease sequence_group context in case of candidates generated by draft_model were not accepted by main_model
+    if (max_removed_tokens_per_request) {
+        auto min_processed_tokens = sequence_group->get_prompt_len() + min_generated_len - 1;
+        sequence_group->update_processed_tokens_num(min_processed_tokens);
+        logit_processor.update_generated_len(min_processed_tokens);
+    }
+    if (updated_validation_len) {
+        sequence_group->set_num_validated_tokens(updated_validation_len);
+    }
+}
+
 SamplerOutput Sampler::sample(std::vector<SequenceGroup::Ptr> & sequence_groups,
                               ov::Tensor logits,
-                              bool is_validation_mode_enabled) {
+                              bool is_validation_mode_enabled,
+                              const ov::Tensor& logits_indices) {
     const float * logits_data = logits.data<float>();
     ov::Shape logits_shape = logits.get_shape();
     OPENVINO_ASSERT(logits_shape.size() == 3);
     size_t batch_seq_len = logits_shape[1], vocab_size = logits_shape[2];
 
-    SamplerOutput sampler_output;
+    // per-request state is created upfront, so that groups can be sampled concurrently
+    std::vector<SequenceGroup::Ptr> scheduled_sequence_groups;
+    std::vector<ov::Tensor> sequence_groups_logits, sequence_groups_logits_indices;
     for (size_t sequence_group_id = 0, currently_processed_tokens = 0; sequence_group_id < sequence_groups.size(); ++sequence_group_id) {
         SequenceGroup::Ptr sequence_group = sequence_groups[sequence_group_id];
         if (!sequence_group->is_scheduled())
@@ -764,162 +1042,133 @@ SamplerOutput Sampler::sample(std::vector<SequenceGroup::Ptr> & sequence_groups,
 
         const auto request_id = sequence_group->get_request_id();
         if (!m_logit_processors.count(request_id)) {
-            m_logit_processors.insert({request_id, LogitProcessor(sampling_params, sequence_group->get_prompt_ids())});
+            auto structured_output_grammar = sampling_params.is_structured_output() ? _get_structured_output_grammar(sampling_params, vocab_size) : nullptr;
+            m_logit_processors.insert({request_id, LogitProcessor(sampling_params, sequence_group->get_prompt_ids(), structured_output_grammar)});
         }
         if (!m_stop_strings.count(request_id)) {
             auto processed_stop_string = process_stop_strings(sampling_params.stop_strings, m_tokenizer);
             m_stop_strings.insert({request_id, processed_stop_string});
+            m_stop_string_automata.emplace(request_id, StopStringAutomaton(processed_stop_string.second));
             sequence_group->set_stream_window_size(processed_stop_string.first);
         }
-        auto& stop_strings = m_stop_strings.at(request_id);
-        auto& logit_processor = m_logit_processors.at(request_id);
-        const void * sequence_group_logits_data = logits_data + vocab_size * currently_processed_tokens;
-        ov::Tensor sequence_group_logits(ov::element::f32, ov::Shape{num_running_sequences, actual_seq_len, vocab_size}, (void *)sequence_group_logits_data);
-        size_t max_removed_tokens_per_request = 0, min_generated_len = std::numeric_limits<size_t>::max(), updated_validation_len = 0;
-        if (sequence_group->requires_sampling()) {
-            // get number of token to be validated
-            auto num_tokens_to_process = sequence_group->get_num_tokens_to_validate();
-            if (num_tokens_to_process > actual_seq_len - 1) {
-                auto delta = num_tokens_to_process - (actual_seq_len - 1);
-                updated_validation_len = std::max(updated_validation_len, delta);
-                num_tokens_to_process -= delta;
-            }
-            if (sampling_params.is_greedy_decoding() || sampling_params.is_multinomial()) {
-                std::vector<Sequence::Ptr> running_sequences = sequence_group->get_running_sequences();
-                if (sampling_params.is_greedy_decoding()) {
-                    OPENVINO_ASSERT(num_running_sequences == 1);
-                }
-                for (size_t running_sequence_id = 0; running_sequence_id < num_running_sequences; ++running_sequence_id) {
-                    auto& running_sequence = running_sequences[running_sequence_id];
-                    bool is_validation_passed = true;
-                    // make `num_tokens_to_process` iteration to validate a candidate generated by `draft_model` + 1 iteration to generate one more token by `main_model`
-                    for (size_t i = 0; i <= num_tokens_to_process; ++i) {
-                        // calculate token offset from the end of logit
-                        size_t token_offset = num_tokens_to_process - i;
-                        // max counter of needed to be sampled tokens
-                        OPENVINO_ASSERT(running_sequence->get_generated_len() >= token_offset);
-                        size_t generated_and_verified_len = running_sequence->get_generated_len() - token_offset;
-                        OPENVINO_ASSERT(sampling_params.max_new_tokens >= generated_and_verified_len);
-                        size_t max_num_sampled_token = sampling_params.max_new_tokens - generated_and_verified_len;
-                        if (max_num_sampled_token == 0) {
-                            stop_sample_tokens(running_sequence, token_offset, max_num_sampled_token, max_removed_tokens_per_request);
-                            break;
-                        }
-                        
-                        // do sampling only for token validation/generation.
-                        // continue in case of extending draft model sequences by main model generated tokens which
-                        // should be taken to KV cache without validation
-                        if (!is_validation_mode_enabled && token_offset > 0) {
-                            continue;
-                        }
-
-                        auto logit_vector = _get_logit_vector(sequence_group_logits, running_sequence_id, token_offset);
-                        logit_processor.apply(logit_vector);
-
-                        Token sampled_token;
-                        bool is_generate_n_tokens = false;
-                        if (sampling_params.is_greedy_decoding()) {
-                            sampled_token = { _greedy_sample(logit_vector, sampling_params.logprobs) };
-                        } else {
-                            // is_multinomial()
-                            is_generate_n_tokens = sequence_group->num_total_seqs() == 1;
-                            const size_t num_tokens_per_sequence = is_generate_n_tokens ? sampling_params.num_return_sequences : 1;
-                            is_generate_n_tokens &= (num_tokens_per_sequence > 1);
-                            auto sampled_token_ids = _multinomial_sample(logit_vector, num_tokens_per_sequence);
-                            OPENVINO_ASSERT(sampled_token_ids.size(), num_tokens_per_sequence);
-                            // to create n sequence just in case of `sequence_group->num_total_seqs() == 1` and `sampling_params.num_return_sequences > 1`
-                            if (is_generate_n_tokens) {
-                                const auto forked_seq_ids = create_n_forked_sequences(sequence_group, logit_processor, sampled_token_ids);
-                                sampler_output.m_forked_sequences.insert({running_sequences[0]->get_id(), forked_seq_ids});
-                            }
-                            sampled_token = sampled_token_ids.front();
-                            // make `_speculative_sampling` in case of previous token was not accepted in speculative decoding
-                            if (!is_validation_passed) {
-                                float p_prime = get_p_prime(running_sequence, sampled_token, token_offset + 1);
-                                max_removed_tokens_per_request = std::max(max_removed_tokens_per_request, token_offset);
-                                // update prob only in case candidate prob > sampled token prob
-                                if (p_prime > 0.f) {
-                                    auto prob = std::exp(sampled_token.m_log_prob);
-                                    prob /= p_prime;
-                                    sampled_token.m_log_prob = std::log(prob);
-                                }
-                            }
-                        }
-                        // flag to add sampled token to generated sequence or extend logit processors only
-                        bool is_extend_sequence = token_offset == 0 || is_generate_n_tokens || !is_validation_passed;
-                        if (is_validation_mode_enabled && !is_extend_sequence) {
-                            is_validation_passed = validate_candidate(running_sequences[running_sequence_id], token_offset, sampled_token,
-                                                                      is_extend_sequence, max_removed_tokens_per_request, sampling_params.do_sample);
-                            // doing resample in case of non accepted tokens in specualtive sampling
-                            if (!is_validation_passed && sampling_params.do_sample) {
-                                continue;
-                            }
-                            // update log prob just while validation process
-                            if (!is_extend_sequence) {
-                                OPENVINO_ASSERT(generated_and_verified_len < running_sequences[running_sequence_id]->get_generated_len());
-                                running_sequence->update_generated_log_prob(generated_and_verified_len, sampled_token.m_log_prob);
-                            }
-                        }
-                        register_new_token(sampled_token, running_sequences[running_sequence_id], logit_processor, is_extend_sequence, is_validation_mode_enabled);
-                        // to exit from sampling in case of failed token validation
-                        if (!is_validation_passed) {
-                            break;
-                        }
-                    }
-                    min_generated_len = std::min(min_generated_len, running_sequence->get_generated_len());
-                }
-                align_all_sequence_len(sequence_group, min_generated_len, logit_processor);
-                for (const auto& dropped_seq_id : _try_finish_generation(sequence_group)) {
-                    sampler_output.m_dropped_sequences.push_back(dropped_seq_id);
-                }
-            } else if (sampling_params.is_beam_search()) {
-                uint64_t request_id = sequence_group->get_request_id();
-
-                // create beam search info if we are on the first generate
-                if (m_beam_search_info.find(request_id) == m_beam_search_info.end()) {
-                    m_beam_search_info.emplace(request_id, GroupBeamSearcher(sequence_group, m_tokenizer));
-                }
-
-                // current algorithm already adds new tokens to running sequences and
-                m_beam_search_info.at(request_id).select_next_tokens(sequence_group_logits, sampler_output, stop_strings);
-
-                // check max length stop criteria
-                std::vector<Sequence::Ptr> running_sequences = sequence_group->get_running_sequences();
-                if (!sequence_group->has_finished() &&
-                    running_sequences[0]->get_generated_len() == sampling_params.max_new_tokens) {
-                    // stop sequence by max_new_tokens
-                    m_beam_search_info.at(request_id).finalize(sampler_output);
-                }
-            }
-            // Notify handle after sampling is done. 
-            // For non-streaming this is effective only when the generation is finished.
-            OPENVINO_ASSERT(num_tokens_to_process >= max_removed_tokens_per_request);
-            sequence_group->notify_handle();
-        } else {
-            // we are in prompt processing phase when prompt is split into chunks and processed step by step
+        if (!m_rng_engines.count(request_id)) {
+            m_rng_engines.emplace(request_id, PhiloxGenerator(seed, request_id));
         }
-
-        // NOTE: it should be before 'get_num_scheduled_tokens' is used
-        // update internal state of sequence group to reset scheduler tokens and update currently processed ones
-        auto min_validated_tokens = sequence_group->get_num_tokens_to_validate() - max_removed_tokens_per_request;
-        sequence_group->finish_iteration();
-        // decrease sequence_group context in case of candidates generated by draft_model were not accepted by main_model
-        if (max_removed_tokens_per_request) {
-            auto min_processed_tokens = sequence_group->get_prompt_len() + min_generated_len - 1;
-            sequence_group->update_processed_tokens_num(min_processed_tokens);
-            logit_processor.update_generated_len(min_processed_tokens);
+        // create beam search info if we are on the first generate
+        if (sampling_params.is_beam_search() && sequence_group->requires_sampling() &&
+            m_beam_search_info.find(request_id) == m_beam_search_info.end()) {
+            m_beam_search_info.emplace(request_id, GroupBeamSearcher(sequence_group, m_tokenizer));
         }
-        if (updated_validation_len) {
-            sequence_group->set_num_validated_tokens(updated_validation_len);
+
+        const void * sequence_group_logits_data = logits_data + vocab_size * currently_processed_tokens;
+        scheduled_sequence_groups.push_back(sequence_group);
+        sequence_groups_logits.emplace_back(ov::element::f32, ov::Shape{num_running_sequences, actual_seq_len, vocab_size}, (void *)sequence_group_logits_data);
+        sequence_groups_logits_indices.emplace_back();
+        if (logits_indices) {
+            int32_t* sequence_group_logits_indices_data = logits_indices.data<int32_t>() + vocab_size * currently_processed_tokens;
+            sequence_groups_logits_indices.back() = ov::Tensor(ov::element::i32, ov::Shape{num_running_sequences, actual_seq_len, vocab_size}, sequence_group_logits_indices_data);
         }
 
         // accumulate a number of processed tokens
         currently_processed_tokens += padded_amount_of_processed_tokens * num_running_sequences;
     }
 
+    SamplerOutput sampler_output;
+    if (!m_is_parallel_sampling || scheduled_sequence_groups.size() < 2) {
+        for (size_t i = 0; i < scheduled_sequence_groups.size(); ++i) {
+            _sample_sequence_group(scheduled_sequence_groups[i], sequence_groups_logits[i], sequence_groups_logits_indices[i], is_validation_mode_enabled, sampler_output);
+        }
+        return sampler_output;
+    }
+
+    // groups are independent from each other, outputs are merged in the order of groups to keep them deterministic
+    std::vector<SamplerOutput> sequence_groups_outputs(scheduled_sequence_groups.size());
+    ov::parallel_for(scheduled_sequence_groups.size(), [&](size_t i) {
+        _sample_sequence_group(scheduled_sequence_groups[i], sequence_groups_logits[i], sequence_groups_logits_indices[i], is_validation_mode_enabled, sequence_groups_outputs[i]);
+    });
+    for (auto& sequence_group_output : sequence_groups_outputs) {
+        sampler_output.m_dropped_sequences.insert(sampler_output.m_dropped_sequences.end(),
+                                                  sequence_group_output.m_dropped_sequences.begin(),
+                                                  sequence_group_output.m_dropped_sequences.end());
+        for (auto& forked_sequences : sequence_group_output.m_forked_sequences) {
+            auto& child_ids = sampler_output.m_forked_sequences[forked_sequences.first];
+            child_ids.splice(child_ids.end(), forked_sequences.second);
+        }
+    }
     return sampler_output;
 }
 
+std::list<Sampler::StructuredOutput>::iterator Sampler::_find_structured_output(const std::string& regex) {
+    auto it = std::find_if(m_structured_outputs.begin(), m_structured_outputs.end(), [&] (const StructuredOutput& structured_output) {
+        return structured_output.regex == regex;
+    });
+    if (it != m_structured_outputs.end())
+        m_structured_outputs.splice(m_structured_outputs.begin(), m_structured_outputs, it);
+    return it;
+}
+
+std::shared_ptr<const RegexAutomaton> Sampler::_compile_structured_output(const std::string& regex) {
+    {
+        std::lock_guard<std::mutex> lock(m_structured_outputs_mutex);
+        auto it = _find_structured_output(regex);
+        if (it != m_structured_outputs.end())
+            return it->automaton;
+    }
+    // compiled without the lock, so that threads adding requests with other expressions are not blocked
+    auto automaton = std::make_shared<const RegexAutomaton>(regex);
+    std::lock_guard<std::mutex> lock(m_structured_outputs_mutex);
+    auto it = _find_structured_output(regex);
+    if (it != m_structured_outputs.end())
+        return it->automaton;
+    m_structured_outputs.push_front(StructuredOutput{regex, automaton, nullptr});
+    if (m_structured_outputs.size() > MAX_NUM_STRUCTURED_OUTPUTS)
+        m_structured_outputs.pop_back();
+    return automaton;
+}
+
+void Sampler::compile_structured_output(const GenerationConfig& sampling_params) {
+    _compile_structured_output(sampling_params.regex.empty() ? json_schema_to_regex(sampling_params.json_schema) : sampling_params.regex);
+}
+
+std::shared_ptr<StructuredOutputGrammar> Sampler::_get_structured_output_grammar(const GenerationConfig& sampling_params, size_t vocab_size) {
+    const std::string regex = sampling_params.regex.empty() ? json_schema_to_regex(sampling_params.json_schema) : sampling_params.regex;
+    // normally the expression is already compiled by compile_structured_output when the request is added
+    auto automaton = _compile_structured_output(regex);
+    std::lock_guard<std::mutex> lock(m_structured_outputs_mutex);
+    auto it = _find_structured_output(regex);
+    if (it != m_structured_outputs.end() && it->grammar)
+        return it->grammar;
+    if (!m_structured_output_vocabulary)
+        m_structured_output_vocabulary = std::make_shared<TokenVocabulary>(m_tokenizer, vocab_size);
+    auto grammar = std::make_shared<StructuredOutputGrammar>(automaton, m_structured_output_vocabulary);
+    if (it != m_structured_outputs.end())
+        it->grammar = grammar;
+    return grammar;
+}
+
+void Sampler::prefetch_structured_output_masks(const std::vector<SequenceGroup::Ptr>& sequence_groups) {
+    std::vector<std::pair<LogitProcessor*, Sequence::Ptr>> sequences;
+    for (const auto& sequence_group : sequence_groups) {
+        auto it = m_logit_processors.find(sequence_group->get_request_id());
+        // processors are created by the first sampling of a request, so nothing is known about new requests yet
+        if (!sequence_group->is_scheduled() || !sequence_group->requires_sampling() || it == m_logit_processors.end() || !it->second.has_structured_output())
+            continue;
+        for (const auto& sequence : sequence_group->get_running_sequences())
+            sequences.emplace_back(&it->second, sequence);
+    }
+    // sequences of the same request share the processor, so they are processed by the same thread
+    std::stable_sort(sequences.begin(), sequences.end(), [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    std::vector<size_t> begins;
+    for (size_t i = 0; i < sequences.size(); ++i)
+        if (i == 0 || sequences[i].first != sequences[i - 1].first)
+            begins.push_back(i);
+    begins.push_back(sequences.size());
+    ov::parallel_for(begins.size() - 1, [&] (size_t processor_idx) {
+        for (size_t i = begins[processor_idx]; i < begins[processor_idx + 1]; ++i)
+            sequences[i].first->prefetch_structured_output_mask(sequences[i].second->get_id(), sequences[i].second->get_generated_ids());
+    });
+}
+
 LogitProcessor& Sampler::get_logit_processor(uint64_t request_id) {
     OPENVINO_ASSERT(m_logit_processors.count(request_id));
     return m_logit_processors.at(request_id);
@@ -932,6 +1181,8 @@ void Sampler::create_logit_processor(uint64_t request_id, const GenerationConfig
 
 void Sampler::clear_request_info(uint64_t request_id) { 
     m_beam_search_info.erase(request_id);
+    m_rng_engines.erase(request_id);
+    m_stop_string_automata.erase(request_id);
     m_logit_processors.erase(request_id);
     m_stop_strings.erase(request_id);
 }
@@ -955,6 +1206,20 @@ int64_t Sampler::GroupBeamSearcher::Group::finish(Beam beam, const ov::genai::Ge
     return preeempted_sequence_id;
 }
 
+bool Sampler::GroupBeamSearcher::Group::is_hopeless(const Beam& beam, size_t max_new_tokens,
+                                                    const ov::genai::GenerationConfig& sampling_params) const {
+    const size_t group_size = sampling_params.num_beams / sampling_params.num_beam_groups;
+    if (min_heap.size() < group_size)
+        return false;
+
+    // log probabilities only decrease the sum, so the score is bounded by the current sum divided by the largest length penalty,
+    // which is reached at the longest length for positive penalty (+1 for EOS counted by finish()) and the current length otherwise
+    const size_t generated_len = beam.get_generated_len() + 1;
+    const size_t bound_len = sampling_params.length_penalty > 0.0f ? std::max(generated_len, max_new_tokens) + 1 : generated_len;
+    const float highest_attainable_score = beam.m_score / std::pow(float(bound_len), sampling_params.length_penalty);
+    return highest_attainable_score < min_heap.front().m_score;
+}
+
 void Sampler::GroupBeamSearcher::Group::is_done(const ov::genai::GenerationConfig& sampling_params) {
     assert(sampling_params.num_beams % sampling_params.num_beam_groups == 0 &&
         "number of beams should be divisible by number of groups");
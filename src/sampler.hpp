@@ -9,6 +9,8 @@
 #include <cstdlib>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <algorithm>
 #include <cmath>
 #include <random>
@@ -17,8 +19,12 @@
 #include "openvino/runtime/tensor.hpp"
 
 #include "logit_processor.hpp"
+#include "philox_generator.hpp"
 #include "scheduler.hpp"
 #include "sequence_group.hpp"
+#include "stop_string_automaton.hpp"
+#include "structured_output/json_schema.hpp"
+#include "structured_output/structured_output_grammar.hpp"
 
 namespace ov::genai {
 // Handle stop_token_ids
@@ -45,21 +51,56 @@ class Sampler {
 
     Logits _get_logit_vector(ov::Tensor logits, size_t batch_idx, size_t token_idx);
     Token _greedy_sample(const Logits& logits, size_t top_logprobs) const;
-    std::vector<Token> _multinomial_sample(const Logits& logits, size_t num_tokens_per_sequence);
+    std::vector<Token> _multinomial_sample(const Logits& logits, size_t num_tokens_per_sequence, PhiloxGenerator& rng_engine,
+                                           std::vector<double>& cumulative_weights);
     std::vector<int64_t> _try_finish_generation(SequenceGroup::Ptr & sequence_group);
+    // samples next tokens of a single scheduled sequence group, whose per-request state is already created
+    void _sample_sequence_group(SequenceGroup::Ptr sequence_group, ov::Tensor sequence_group_logits, ov::Tensor sequence_group_logits_indices,
+                                bool is_validation_mode_enabled, SamplerOutput& sampler_output);
 
     bool validate_candidate(Sequence::Ptr running_sequence, size_t& token_idx, Token& sampled_token,
-                            bool& is_extend_sequence, size_t& max_removed_tokens, bool do_sample);
+                            bool& is_extend_sequence, size_t& max_removed_tokens, bool do_sample, PhiloxGenerator& rng_engine);
 
     // request ID => beam search tracking information
     std::map<uint64_t, GroupBeamSearcher> m_beam_search_info;
 
-    std::mt19937 rng_engine;
-    size_t seed = rng_engine.default_seed;
+    size_t seed = std::mt19937::default_seed;
+    // whether sequence groups are sampled concurrently
+    bool m_is_parallel_sampling = false;
+    // { request_id, rng_engine }, each request has its own random stream derived from the seed and addressed by sequence and token position,
+    // so that sampled tokens do not depend on other requests in a batch
+    std::map<uint64_t, PhiloxGenerator> m_rng_engines;
     // { request_id, logit_processor }
     std::map<uint64_t, LogitProcessor> m_logit_processors;
     // { request_id, { max_encoded_len, { stop_strings }}}
     std::map<int64_t, std::pair<size_t, std::set<std::string>>> m_stop_strings;
+    // { request_id, automaton filtering out steps which cannot match stop strings }
+    std::map<int64_t, StopStringAutomaton> m_stop_string_automata;
+    // texts of single tokens, shared by all requests, each token is detokenized once
+    std::unordered_map<int64_t, std::string> m_token_texts;
+    std::mutex m_token_texts_mutex;
+
+    const std::string& _get_token_text(int64_t token_id);
+
+    // vocabulary decoded once on the first request with structured output
+    std::shared_ptr<TokenVocabulary> m_structured_output_vocabulary;
+    struct StructuredOutput {
+        std::string regex;
+        std::shared_ptr<const RegexAutomaton> automaton;
+        // created by the first sampling, since the vocabulary needs the size of logits
+        std::shared_ptr<StructuredOutputGrammar> grammar;
+    };
+    // the most recently used expressions first, so that token masks are shared by requests with the same schema;
+    // grammars of evicted expressions are kept alive by logit processors of running requests
+    static constexpr size_t MAX_NUM_STRUCTURED_OUTPUTS = 64;
+    std::list<StructuredOutput> m_structured_outputs;
+    std::mutex m_structured_outputs_mutex;
+
+    // finds the cached expression and moves it to the front, must be called with m_structured_outputs_mutex locked
+    std::list<StructuredOutput>::iterator _find_structured_output(const std::string& regex);
+    // returns the cached automaton of the expression or compiles it, must be called with m_structured_outputs_mutex unlocked
+    std::shared_ptr<const RegexAutomaton> _compile_structured_output(const std::string& regex);
+    std::shared_ptr<StructuredOutputGrammar> _get_structured_output_grammar(const GenerationConfig& sampling_params, size_t vocab_size);
 
     Tokenizer m_tokenizer;
 
@@ -67,15 +108,40 @@ public:
     Sampler() = default;
     Sampler(Tokenizer & tokenizer) : m_tokenizer(tokenizer) {};
 
-    SamplerOutput sample(std::vector<SequenceGroup::Ptr> & sequence_groups, ov::Tensor logits, bool is_validation_mode_enabled = false);
+    /**
+     * Samples next tokens of scheduled sequence groups.
+     * @param sequence_groups Sequence groups, only scheduled ones are processed.
+     * @param logits Logits of shape [batch, seq_len, vocab_size].
+     * @param is_validation_mode_enabled Whether candidates proposed by a draft model are validated.
+     * @param logits_indices If not empty, logits contain only the candidates selected on device and this tensor of the same shape
+     * contains their token IDs.
+     */
+    SamplerOutput sample(std::vector<SequenceGroup::Ptr> & sequence_groups, ov::Tensor logits, bool is_validation_mode_enabled = false,
+                         const ov::Tensor& logits_indices = {});
     void set_seed(size_t new_seed) {
-        rng_engine.seed(new_seed);
         seed = new_seed;
+        m_rng_engines.clear();
+    }
+    void set_parallel_sampling(bool is_parallel_sampling) {
+        m_is_parallel_sampling = is_parallel_sampling;
     }
     size_t get_seed() { return seed; }
 
     void clear_request_info(uint64_t request_id);
 
+    /**
+     * Compiles the regular expression of a request with structured output, so that a new expression is compiled
+     * when the request is added rather than by `sample`. Can be called from any thread.
+     */
+    void compile_structured_output(const GenerationConfig& sampling_params);
+
+    /**
+     * Computes masks of tokens allowed by structured output for the next tokens of running sequences, so that it can be done
+     * while the device is busy with inference.
+     * @param sequence_groups Sequence groups, only scheduled ones which are sampled after the current step are processed.
+     */
+    void prefetch_structured_output_masks(const std::vector<SequenceGroup::Ptr>& sequence_groups);
+
     LogitProcessor& get_logit_processor(uint64_t request_id);
     void create_logit_processor(uint64_t request_id, const GenerationConfig& sampling_parameters, const TokenIds& prompt);
 
@@ -113,12 +179,21 @@ class Sampler::GroupBeamSearcher {
 
         int64_t finish(Beam beam, const ov::genai::GenerationConfig& sampling_params);
         void is_done(const ov::genai::GenerationConfig& sampling_params);
+        // whether no continuation of the beam can be selected over finished beams, see GenerationConfig::prune_beams
+        bool is_hopeless(const Beam& beam, size_t max_new_tokens, const ov::genai::GenerationConfig& sampling_params) const;
     };
 
     SequenceGroup::Ptr m_sequence_group;
     ov::genai::GenerationConfig m_parameters;
     std::vector<Group> m_groups;
     Tokenizer m_tokenizer;
+
+    // buffers reused across steps, so that selection of next tokens does not allocate proportionally to vocabulary size
+    std::vector<float> m_penalties;
+    std::vector<int64_t> m_penalized_tokens;
+    std::vector<Token> m_top_tokens;
+    std::vector<Beam> m_candidates;
+    std::vector<int64_t> m_full_text;
 public:
     explicit GroupBeamSearcher(SequenceGroup::Ptr sequence_group, Tokenizer tokenizer);
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstdlib>
+#include <set>
 #include <vector>
 
 #include "openvino/genai/scheduler_config.hpp"
@@ -19,6 +20,18 @@ class Scheduler {
     SchedulerConfig m_config;
     BlockManager m_block_manager;
     friend class CacheStateDumper;
+    friend class BinaryCacheStateDumper;
+
+    // current limit of prompt tokens per step in dynamic split fuse mode
+    size_t m_prefill_token_budget;
+    // whether the prefill token budget limited the number of prompt tokens scheduled during the last step
+    bool m_is_prefill_limited_by_budget = false;
+    // number of preemptions during the lifetime of the scheduler, reported by pipeline metrics
+    size_t m_num_preemptions = 0;
+    // IDs of requests preempted by the last `schedule` call
+    std::set<uint64_t> m_preempted_request_ids;
+    // numbers of finished sequence groups and of tokens generated by them for OutputLengthEstimate::HISTORICAL_AVERAGE
+    size_t m_num_finished_sequence_groups = 0, m_num_finished_generated_tokens = 0;
 
 public:
     struct Output {
@@ -34,17 +47,36 @@ public:
         bool is_prompt = false;
         // current cache usage
         float m_cache_usage = 0.0;
+        // per-layer maps of device -> host blocks copies for swapped out groups, which need to be performed by CacheManager
+        std::vector<std::map<size_t, size_t>> m_block_swap_out_map;
+        // per-layer maps of host -> device blocks copies for swapped in groups, which need to be performed by CacheManager
+        std::vector<std::map<size_t, size_t>> m_block_swap_in_map;
+        // per-layer maps of host -> device blocks copies for swapped out groups, which are not scheduled at the current step,
+        // but are expected to be scheduled at the next ones; these copies can be performed by CacheManager asynchronously
+        std::vector<std::map<size_t, size_t>> m_block_prefetch_map;
+        // hashes of blocks restored from persistent prefix cache storage together with per-layer indices of KV cache blocks,
+        // which contents need to be loaded from the storage
+        std::vector<std::pair<size_t, std::vector<size_t>>> m_persistent_blocks_to_load;
     };
 
     explicit Scheduler(size_t block_size, const SchedulerConfig & config = {}, size_t num_layers = 1, bool can_use_partial_preemption = true) :
             m_can_use_partial_preemption(can_use_partial_preemption),
             m_config(config),
-            m_block_manager(m_config.num_kv_blocks, m_config.enable_prefix_caching, block_size, num_layers) {
+            m_block_manager(m_config.initial_num_kv_blocks > 0 ? std::min(m_config.initial_num_kv_blocks, m_config.num_kv_blocks) : m_config.num_kv_blocks,
+                            m_config.enable_prefix_caching, block_size, num_layers, m_config.num_swap_blocks, m_config.enable_lazy_copy_on_write),
+            m_prefill_token_budget(_get_max_prefill_token_budget()) {
         OPENVINO_ASSERT(num_layers != 0, "num_layers must be non-zero");
+        OPENVINO_ASSERT(m_config.target_step_latency_ms >= 0.0f, "target_step_latency_ms must be non-negative");
+        OPENVINO_ASSERT(m_config.admission_watermark >= 0.0f && m_config.admission_watermark < 1.0f, "admission_watermark must be in [0, 1) range");
     }
 
     Output schedule(std::vector<SequenceGroup::Ptr>& sequence_groups) {
         Output scheduler_output;
+        m_preempted_request_ids.clear();
+
+        // scheduling logic below treats groups located earlier in the vector as the ones with higher priority
+        // (they are scheduled first and preempted last), so reorder groups according to the policy first
+        _apply_scheduling_policy(sequence_groups);
 
         if (m_config.dynamic_split_fuse) {
             // deepspeed-mii case
@@ -64,8 +96,19 @@ public:
             }
         }
 
+        // ModelRunner and Sampler must process scheduled groups in the same order, while generation and prompt phases
+        // can be scheduled in different order comparing to order of groups within the vector
+        std::sort(scheduler_output.m_scheduled_sequence_groups_ids.begin(), scheduler_output.m_scheduled_sequence_groups_ids.end());
+
+        // bring swapped out groups back to device KV cache in advance, while current step is being executed
+        _prefetch_swapped_sequence_groups(sequence_groups, scheduler_output);
+
+        // swapped in blocks of host memory can be reused only by the next steps, when their contents are already copied
+        m_block_manager.release_swapped_in_blocks();
+
         _clear_waiting_sequences(sequence_groups);
-        scheduler_output.m_cache_usage = m_block_manager.get_used_percentage();
+        // KV cache usage is reported relative to its max size, which may be larger than the currently allocated one
+        scheduler_output.m_cache_usage = m_block_manager.get_used_percentage() * m_block_manager.get_total_number_of_kv_blocks() / m_config.num_kv_blocks;
 
         return scheduler_output;
     }
@@ -75,6 +118,16 @@ public:
             m_block_manager.free_empty_physical_blocks(seq_group);
     }
 
+    /**
+     * Sets the number of KV cache blocks, which a sequence keeps after its tokens are rolled back, e.g. by speculative decoding.
+     * Reserved blocks are released as soon as KV cache is not enough for scheduled tokens. Not used with cache eviction, which
+     * frees blocks by their logical indices.
+     * @param num_reserved_tail_blocks Maximum number of reserved blocks per sequence.
+     */
+    void set_num_reserved_tail_blocks(size_t num_reserved_tail_blocks) {
+        m_block_manager.set_num_reserved_tail_blocks(m_config.use_cache_eviction ? 0 : num_reserved_tail_blocks);
+    }
+
     const std::vector<BlocksPerLayer>& get_block_tables(const Sequence& seq) const {
         return m_block_manager.get_block_tables(seq.get_id());
     }
@@ -99,15 +152,229 @@ public:
         m_block_manager.restore_cached_blocks(sequence_group);
     }
 
+    /**
+     * Estimates the number of KV cache blocks needed to process the next step of all given sequence groups without preemption,
+     * assuming that blocks are not shared.
+     * @param sequence_groups Sequence groups to be processed.
+     * @return Number of KV cache blocks (per layer).
+     */
+    size_t get_num_required_kv_blocks(const std::vector<SequenceGroup::Ptr>& sequence_groups) const {
+        size_t num_blocks = 0;
+        for (const auto& sequence_group : sequence_groups) {
+            if (sequence_group->has_finished() || sequence_group->out_of_memory())
+                continue;
+            size_t num_tokens = std::max(sequence_group->get_prompt_len(), sequence_group->get_context_len()) + 1;
+            size_t num_seqs = std::max<size_t>(1, sequence_group->num_running_seqs());
+            num_blocks += num_seqs * ((num_tokens + get_block_size() - 1) / get_block_size());
+        }
+        return num_blocks;
+    }
+
+    /**
+     * Accounts the number of tokens generated by a finished sequence group in the average output length predicted by
+     * OutputLengthEstimate::HISTORICAL_AVERAGE.
+     */
+    void register_finished_sequence_group(const SequenceGroup::CPtr& sequence_group) {
+        size_t generated_len = 0;
+        for (const auto& sequence : sequence_group->get_sequences())
+            generated_len = std::max(generated_len, sequence->get_generated_len());
+        ++m_num_finished_sequence_groups;
+        m_num_finished_generated_tokens += generated_len;
+    }
+
+    size_t get_total_number_of_kv_blocks() const {
+        return m_block_manager.get_total_number_of_kv_blocks();
+    }
+
+    size_t get_num_free_kv_blocks() const {
+        return m_block_manager.num_free_blocks();
+    }
+
+    size_t get_num_cached_kv_blocks() const {
+        return m_block_manager.num_cached_blocks();
+    }
+
+    size_t get_num_prefix_cache_queried_tokens() const {
+        return m_block_manager.get_num_prefix_cache_queried_tokens();
+    }
+
+    size_t get_num_prefix_cache_hit_tokens() const {
+        return m_block_manager.get_num_prefix_cache_hit_tokens();
+    }
+
+    size_t get_num_preemptions() const {
+        return m_num_preemptions;
+    }
+
+    const std::set<uint64_t>& get_preempted_request_ids() const {
+        return m_preempted_request_ids;
+    }
+
+    /**
+     * Preempts a sequence group on demand of another pipeline, e.g. when the main model of speculative decoding preempts the same
+     * request: KV cache blocks of its sequences are freed and all its tokens are recomputed, when it is scheduled again.
+     * Swapped out groups and groups without processed tokens are left as they are.
+     */
+    void preempt_fully(const SequenceGroup::Ptr& sequence_group) {
+        if (sequence_group->get_num_processed_tokens() == 0 || m_block_manager.is_swapped_out(sequence_group))
+            return;
+        ++m_num_preemptions;
+        sequence_group->register_preemption();
+        for (const auto& sequence : sequence_group->get_not_finished_sequences()) {
+            if (m_block_manager.has_block_table(sequence->get_id()))
+                m_block_manager.free_sequence(sequence->get_id());
+        }
+        sequence_group->preempt_tokens(sequence_group->get_num_processed_tokens());
+        if (sequence_group->get_num_evicted_tokens() != 0)
+            sequence_group->reset_eviction_token_count();
+        sequence_group->set_waiting();
+    }
+
+    size_t get_min_number_of_kv_blocks() const {
+        return m_block_manager.get_min_number_of_kv_blocks();
+    }
+
+    void resize_kv_cache(size_t num_blocks) {
+        m_block_manager.resize(num_blocks);
+    }
+
+    size_t get_num_prefix_cached_tokens(const TokenIds& tokens) {
+        return m_block_manager.get_num_prefix_cached_tokens(tokens);
+    }
+
+    void add_persistent_blocks(const std::vector<PrefixTree::BlockInfo>& blocks) {
+        m_block_manager.add_persistent_blocks(blocks);
+    }
+
+    std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> get_prefix_cached_blocks() {
+        return m_block_manager.get_prefix_cached_blocks();
+    }
+
+    std::vector<std::pair<PrefixTree::BlockInfo, std::vector<size_t>>> get_prefix_cached_blocks(const TokenIds& tokens) {
+        return m_block_manager.get_prefix_cached_blocks(tokens);
+    }
+
+    std::vector<std::pair<size_t, std::vector<size_t>>> import_prefix_cached_blocks(const std::vector<PrefixTree::BlockInfo>& blocks) {
+        return m_block_manager.import_prefix_cached_blocks(blocks);
+    }
+
     const SchedulerConfig& get_config() const {
         return m_config;
     }
 
+    /**
+     * Adjusts the number of prompt tokens scheduled per step, if SchedulerConfig::target_step_latency_ms is set.
+     * @param step_latency_ms Measured duration of the last step.
+     */
+    void register_step_latency(float step_latency_ms) {
+        if (m_config.target_step_latency_ms == 0.0f || !m_config.dynamic_split_fuse)
+            return;
+
+        // multiplicative decrease once the target is exceeded, additive increase while prompts are throttled by the budget
+        const size_t min_budget = std::min(get_block_size(), _get_max_prefill_token_budget()), max_budget = _get_max_prefill_token_budget();
+        if (step_latency_ms > m_config.target_step_latency_ms) {
+            m_prefill_token_budget = std::max(min_budget, m_prefill_token_budget * 3 / 4);
+        } else if (m_is_prefill_limited_by_budget) {
+            m_prefill_token_budget = std::min(max_budget, m_prefill_token_budget + get_block_size());
+        }
+    }
+
+    /**
+     * @return Current limit of prompt tokens scheduled per step in dynamic split fuse mode.
+     */
+    size_t get_prefill_token_budget() const {
+        return m_prefill_token_budget;
+    }
+
     void free_blocks_from_sequence(size_t seq_id, const std::vector<std::set<size_t>>& per_layer_logical_block_indices_to_free) {
         m_block_manager.free_blocks_from_sequence(seq_id, per_layer_logical_block_indices_to_free);
     }
 
 private:
+    void _apply_scheduling_policy(std::vector<SequenceGroup::Ptr>& sequence_groups) const {
+        // sequence_groups are kept in arrival order by pipeline
+        if (m_config.scheduling_policy == SchedulingPolicy::FCFS)
+            return;
+
+        // stable sort is used to keep arrival order within groups of equal priority / deadline
+        if (m_config.scheduling_policy == SchedulingPolicy::PRIORITY) {
+            std::stable_sort(sequence_groups.begin(), sequence_groups.end(), [] (const SequenceGroup::CPtr& lhs, const SequenceGroup::CPtr& rhs) {
+                return lhs->get_sampling_parameters().priority > rhs->get_sampling_parameters().priority;
+            });
+        } else if (m_config.scheduling_policy == SchedulingPolicy::EARLIEST_DEADLINE_FIRST) {
+            std::stable_sort(sequence_groups.begin(), sequence_groups.end(), [] (const SequenceGroup::CPtr& lhs, const SequenceGroup::CPtr& rhs) {
+                return lhs->get_deadline() < rhs->get_deadline();
+            });
+        }
+    }
+
+    bool _reserves_blocks_on_admission() const {
+        return m_config.output_length_estimate != OutputLengthEstimate::NONE || m_config.admission_watermark > 0.0f;
+    }
+
+    // number of KV cache blocks (per layer), which a sequence group is predicted to occupy by the end of its generation
+    size_t _get_expected_num_blocks(const SequenceGroup::CPtr& sequence_group) const {
+        const GenerationConfig& sampling_params = sequence_group->get_sampling_parameters();
+        const size_t block_size = get_block_size(), prompt_len = sequence_group->get_prompt_len();
+        const size_t max_new_tokens = sampling_params.get_max_new_tokens(prompt_len);
+
+        size_t num_new_tokens = 0;
+        if (sampling_params.expected_new_tokens > 0) {
+            num_new_tokens = sampling_params.expected_new_tokens;
+        } else if (m_config.output_length_estimate == OutputLengthEstimate::MAX_NEW_TOKENS ||
+                   (m_config.output_length_estimate == OutputLengthEstimate::HISTORICAL_AVERAGE && m_num_finished_sequence_groups == 0)) {
+            num_new_tokens = max_new_tokens;
+        } else if (m_config.output_length_estimate == OutputLengthEstimate::HISTORICAL_AVERAGE) {
+            num_new_tokens = (m_num_finished_generated_tokens + m_num_finished_sequence_groups - 1) / m_num_finished_sequence_groups;
+        }
+        // max_new_tokens is SIZE_MAX, if neither max_new_tokens nor max_length is set
+        num_new_tokens = std::min({num_new_tokens, max_new_tokens, m_config.num_kv_blocks * block_size});
+
+        // sequences forked from the prompt share its blocks, while generated tokens of each sequence take their own ones
+        const size_t num_seqs = std::max(sequence_group->num_running_seqs(),
+                                         sampling_params.is_beam_search() ? sampling_params.num_beams : sampling_params.num_return_sequences);
+        const size_t num_blocks = (prompt_len + block_size - 1) / block_size + num_seqs * ((num_new_tokens + block_size - 1) / block_size);
+        return std::min(num_blocks, m_config.num_kv_blocks);
+    }
+
+    // number of KV cache blocks (per layer), which sequence groups being processed are predicted to take in addition to their current ones
+    size_t _get_num_reserved_blocks(const std::vector<SequenceGroup::Ptr>& sequence_groups) {
+        size_t num_reserved_blocks = 0;
+        for (const auto& sequence_group : sequence_groups) {
+            if (sequence_group->has_finished() || sequence_group->out_of_memory() || !sequence_group->is_admitted() ||
+                m_block_manager.is_swapped_out(sequence_group))
+                continue;
+            const size_t num_expected_blocks = _get_expected_num_blocks(sequence_group);
+            const size_t num_occupied_blocks = m_block_manager.get_number_of_blocks_occupied_by_sequence(sequence_group);
+            num_reserved_blocks += num_expected_blocks > num_occupied_blocks ? num_expected_blocks - num_occupied_blocks : 0;
+        }
+        return num_reserved_blocks;
+    }
+
+    // whether the prompt of a sequence group, which is not admitted yet, can be scheduled: KV cache of the max size must fit blocks, which
+    // the group is predicted to take, in addition to used blocks, reserved ones and the watermark; blocks of the admitted group are reserved.
+    // Groups with prompts restored from the prefix cache are admitted too, though some of their tokens are already processed
+    bool _admit(const SequenceGroup::Ptr& sequence_group, size_t& num_reserved_blocks) const {
+        if (sequence_group->is_admitted())
+            return true;
+        if (!_reserves_blocks_on_admission()) {
+            sequence_group->set_admitted();
+            return true;
+        }
+
+        const size_t num_used_blocks = m_block_manager.get_total_number_of_kv_blocks() - m_block_manager.num_free_blocks();
+        const size_t num_expected_blocks = _get_expected_num_blocks(sequence_group);
+        const size_t num_watermark_blocks = static_cast<size_t>(m_config.admission_watermark * m_config.num_kv_blocks);
+        // a group, which does not fit even an empty KV cache, is not blocked forever
+        if (num_used_blocks + num_reserved_blocks > 0 &&
+            num_used_blocks + num_reserved_blocks + num_watermark_blocks + num_expected_blocks > m_config.num_kv_blocks)
+            return false;
+
+        num_reserved_blocks += num_expected_blocks;
+        sequence_group->set_admitted();
+        return true;
+    }
+
     static size_t _num_running_sequence_groups(const std::vector<SequenceGroup::Ptr>& sequence_groups) {
         size_t num_running = 0;
         for (const SequenceGroup::CPtr& seq_group : sequence_groups) {
@@ -172,11 +439,90 @@ private:
         return m_block_manager.num_free_blocks() > prev_blocks_count;
     }
 
-    static size_t _get_low_priority_sequence_group_id(const std::vector<SequenceGroup::Ptr>& sequence_groups) {
+    bool _can_preempt_by_swap(SequenceGroup::Ptr sequence_group) {
+        // only groups in generation phase are swapped, as partially processed prompts are cheap to recompute
+        return m_config.preemption_mode == PreemptionMode::SWAP && !m_config.enable_prefix_caching &&
+               sequence_group->can_generate_tokens() && m_block_manager.can_swap_out(sequence_group);
+    }
+
+    static void _merge_block_swap_map(std::vector<std::map<size_t, size_t>>& dst, const std::vector<std::map<size_t, size_t>>& src) {
+        dst.resize(src.size());
+        for (size_t layer_idx = 0; layer_idx < src.size(); ++layer_idx) {
+            dst[layer_idx].insert(src[layer_idx].begin(), src[layer_idx].end());
+        }
+    }
+
+    bool _preempt_by_swap(SequenceGroup::Ptr sequence_group, Output& scheduler_output) {
+        size_t prev_blocks_count = m_block_manager.num_free_blocks();
+        _merge_block_swap_map(scheduler_output.m_block_swap_out_map, m_block_manager.swap_out(sequence_group));
+        sequence_group->set_waiting();
+        return m_block_manager.num_free_blocks() > prev_blocks_count;
+    }
+
+    bool _preempt(SequenceGroup::Ptr sequence_group, size_t blocks_needed, Output& scheduler_output) {
+        ++m_num_preemptions;
+        m_preempted_request_ids.insert(sequence_group->get_request_id());
+        sequence_group->register_preemption();
+        if (_can_preempt_by_swap(sequence_group)) {
+            return _preempt_by_swap(sequence_group, scheduler_output);
+        }
+        return _preempt_by_recompute(sequence_group, blocks_needed);
+    }
+
+    void _restore_persistent_blocks(const SequenceGroup::Ptr& sequence_group, Output& scheduler_output) {
+        if (!m_config.enable_prefix_caching || m_config.prefix_cache_dir.empty())
+            return;
+        auto blocks_to_load = m_block_manager.restore_persistent_blocks(sequence_group);
+        scheduler_output.m_persistent_blocks_to_load.insert(scheduler_output.m_persistent_blocks_to_load.end(),
+                                                            std::make_move_iterator(blocks_to_load.begin()), std::make_move_iterator(blocks_to_load.end()));
+    }
+
+    // returns false if the last block restored from prefix cache has to be copied before the prompt is appended to it, but KV cache is exhausted
+    bool _copy_on_write_restored_block(const SequenceGroup::Ptr& sequence_group, Output& scheduler_output) {
+        if (!m_config.enable_prefix_caching || !m_block_manager.needs_copy_on_write(sequence_group))
+            return true;
+        if (!m_block_manager.can_allocate_blocks(1))
+            return false;
+        for (const auto& src_dst : m_block_manager.copy_on_write_restored_block(sequence_group)) {
+            for (const auto dst_index : src_dst.second)
+                scheduler_output.m_block_copy_map[src_dst.first].push_back(dst_index);
+        }
+        return true;
+    }
+
+    size_t _get_max_prefill_token_budget() const {
+        return m_config.max_num_prefill_tokens > 0 ? std::min(m_config.max_num_prefill_tokens, m_config.max_num_batched_tokens) : m_config.max_num_batched_tokens;
+    }
+
+    void _prefetch_swapped_sequence_groups(const std::vector<SequenceGroup::Ptr>& sequence_groups, Output& scheduler_output) {
+        if (m_config.preemption_mode != PreemptionMode::SWAP)
+            return;
+
+        // keep a free block for each running sequence, so the next generation step does not preempt prefetched groups back
+        size_t num_reserved_blocks = 0;
+        for (const auto& sequence_group : sequence_groups) {
+            if (!sequence_group->has_finished() && !m_block_manager.is_swapped_out(sequence_group))
+                num_reserved_blocks += sequence_group->num_running_seqs();
+        }
+
+        for (const auto& sequence_group : sequence_groups) {
+            if (sequence_group->has_finished() || sequence_group->is_waiting() || !m_block_manager.is_swapped_out(sequence_group))
+                continue;
+
+            if (!m_block_manager.can_swap_in(sequence_group, num_reserved_blocks))
+                break;
+
+            _merge_block_swap_map(scheduler_output.m_block_prefetch_map, m_block_manager.swap_in(sequence_group));
+            num_reserved_blocks += sequence_group->num_running_seqs();
+        }
+    }
+
+    size_t _get_low_priority_sequence_group_id(const std::vector<SequenceGroup::Ptr>& sequence_groups) {
         for (size_t seq_group_id = 0, num_groups = sequence_groups.size(); seq_group_id < num_groups; ++seq_group_id) {
             size_t group_idx = num_groups - seq_group_id - 1;
             SequenceGroup::CPtr sequence_group = sequence_groups[group_idx];
-            if (sequence_group->get_num_processed_tokens() > 0) {
+            // swapped out groups don't have KV blocks on device anymore
+            if (sequence_group->get_num_processed_tokens() > 0 && !m_block_manager.is_swapped_out(sequence_group)) {
                 // we are here, because current sequence group has some reserved KV blocks in block manager
                 // which can be freed
                 return group_idx;
@@ -186,9 +532,18 @@ private:
         return std::numeric_limits<size_t>::max();
     }
 
-    void _apply_preemption(size_t sequence_group_id, const std::vector<SequenceGroup::Ptr>& sequence_groups) {
+    // reserved tail blocks are the first to be given up, before any group is preempted or a prompt waits for KV cache
+    void _release_reserved_tail_blocks_if_needed(const std::vector<SequenceGroup::Ptr>& sequence_groups, size_t num_required_blocks) {
+        if (m_block_manager.can_allocate_blocks(num_required_blocks) || !m_block_manager.has_reserved_tail_blocks(sequence_groups))
+            return;
+        for (const auto& sequence_group : sequence_groups)
+            m_block_manager.free_reserved_tail_blocks(sequence_group);
+    }
+
+    void _apply_preemption(size_t sequence_group_id, const std::vector<SequenceGroup::Ptr>& sequence_groups, Output& scheduler_output) {
         SequenceGroup::Ptr sequence_group = sequence_groups[sequence_group_id];
 
+        _release_reserved_tail_blocks_if_needed(sequence_groups, m_block_manager.required_blocks_count(sequence_group));
         // check whether current sequence requires a new slot / block
         while (!m_block_manager.can_append_slots(sequence_group)) {
             // let's run a sequence for eviction
@@ -199,7 +554,7 @@ private:
                 break;
             }
             size_t blocks_needed = m_block_manager.required_blocks_count(sequence_group);
-            if (!_preempt_by_recompute(sequence_groups[evicted_sequence_group_id], blocks_needed)){
+            if (!_preempt(sequence_groups[evicted_sequence_group_id], blocks_needed, scheduler_output)){
                 break;
             }
         }
@@ -213,7 +568,13 @@ private:
         //    we can slice prompt on chunks and schedule only portion of each prompt instead of
         //    greedy scheduling of prompt with higher priority
         // 2. The mechanism below performs greedy scheduling of high priority prompts
+        // 3. Prompt tokens are additionally limited by the prefill token budget and the chunk size, so that
+        //    long prompts do not occupy whole steps and latency of generation phase stays stable
 
+        m_is_prefill_limited_by_budget = false;
+        size_t num_scheduled_prefill_tokens = 0;
+        size_t num_reserved_blocks = _reserves_blocks_on_admission() ? _get_num_reserved_blocks(sequence_groups) : 0;
+        bool is_admission_blocked = false;
         for (size_t sequence_group_id = 0; sequence_group_id < sequence_groups.size(); ++sequence_group_id) {
             SequenceGroup::Ptr sequence_group = sequence_groups[sequence_group_id];
             if (!sequence_group->can_generate_tokens() && !sequence_group->is_waiting()) {
@@ -223,12 +584,31 @@ private:
                 Sequence::Ptr sequence = (*sequence_group)[0];
                 uint64_t seq_id = sequence->get_id();
 
+                // new groups are not admitted ahead of a group waiting for KV cache, while admitted ones continue their prompts
+                if (!sequence_group->is_admitted() && (is_admission_blocked || !_admit(sequence_group, num_reserved_blocks))) {
+                    is_admission_blocked = true;
+                    continue;
+                }
+
+                _restore_persistent_blocks(sequence_group, scheduler_output);
+                if (!_copy_on_write_restored_block(sequence_group, scheduler_output))
+                    continue;
+
                 size_t num_tokens_in_megabatch = m_config.max_num_batched_tokens - scheduler_output.m_total_num_scheduled_tokens;
                 size_t num_available_tokens = sequence_group->get_num_available_tokens_for_batching();
 
                 // apply megabatch limitations
                 size_t num_scheduled_tokens = std::min(num_tokens_in_megabatch, num_available_tokens);
 
+                // apply prefill budget and chunk size limitations
+                size_t num_prefill_tokens_left = m_prefill_token_budget > num_scheduled_prefill_tokens ? m_prefill_token_budget - num_scheduled_prefill_tokens : 0;
+                if (num_scheduled_tokens > num_prefill_tokens_left) {
+                    num_scheduled_tokens = num_prefill_tokens_left;
+                    m_is_prefill_limited_by_budget = true;
+                }
+                if (m_config.max_prefill_chunk_size > 0)
+                    num_scheduled_tokens = std::min(num_scheduled_tokens, m_config.max_prefill_chunk_size);
+
                 // apply KV cache limitations
                 size_t block_size = get_block_size();
                 size_t currently_allocated_token_slots = sequence_group->get_num_blocks() * block_size;
@@ -243,11 +623,13 @@ private:
                 num_scheduled_tokens = std::min(num_scheduled_tokens, available_slots + num_scheduled_blocks * block_size);
 
                 if (num_scheduled_tokens > 0) {
-                    // allocate KV blocks if required
+                    // allocate KV blocks if required, they are not reserved anymore
                     if (num_scheduled_blocks > 0)
-                        m_block_manager.allocate(sequence, num_scheduled_blocks, sequence_group->get_prompt_ids());
+                        m_block_manager.allocate(sequence, num_scheduled_blocks, sequence_group->get_prompt_cache_ids());
+                    num_reserved_blocks -= std::min(num_reserved_blocks, num_scheduled_blocks);
                     // and schedule tokens
                     sequence_group->schedule_tokens(num_scheduled_tokens);
+                    num_scheduled_prefill_tokens += num_scheduled_tokens;
 
                     // add information to scheduler_output
                     {
@@ -274,6 +656,14 @@ private:
             //         keep latencies for sequence groups of high priority
             if (sequence_group->can_generate_tokens() && !sequence_group->is_waiting()) {
                 OPENVINO_ASSERT(!sequence_group->has_finished());
+
+                if (m_block_manager.is_swapped_out(sequence_group)) {
+                    // swapped out groups are resumed only when KV cache has enough free blocks without preemption of other groups
+                    if (!m_block_manager.can_swap_in(sequence_group))
+                        continue;
+                    _merge_block_swap_map(scheduler_output.m_block_swap_in_map, m_block_manager.swap_in(sequence_group));
+                }
+
                 size_t num_running_seqs = sequence_group->num_running_seqs();
                 size_t num_tokens_in_megabatch = m_config.max_num_batched_tokens - scheduler_output.m_total_num_scheduled_tokens;
                 size_t available_tokens_per_seq_in_megabatch = num_tokens_in_megabatch / num_running_seqs;
@@ -289,7 +679,7 @@ private:
                 size_t num_scheduled_tokens_per_seq = std::min(available_tokens_per_seq_in_megabatch, num_available_tokens_per_seq);
                 sequence_group->schedule_tokens(num_scheduled_tokens_per_seq);
 
-                _apply_preemption(sequence_group_id, sequence_groups);
+                _apply_preemption(sequence_group_id, sequence_groups, scheduler_output);
 
                 // if we can't preemt any more sequences, clear scheduled tokens and move to next sequence
                 if (!m_block_manager.can_append_slots(sequence_group)){
@@ -341,6 +731,7 @@ private:
 
         // TODO: it currently does not handle beam search, where beam width should contribute to total number of "num running sequences"
         size_t num_running_sequence_groups = _num_running_sequence_groups(sequence_groups);
+        size_t num_reserved_blocks = _reserves_blocks_on_admission() ? _get_num_reserved_blocks(sequence_groups) : 0;
 
         for (size_t sequence_group_id = 0; sequence_group_id < sequence_groups.size(); ++sequence_group_id) {
             SequenceGroup::Ptr sequence_group = sequence_groups[sequence_group_id];
@@ -352,6 +743,7 @@ private:
                 // here we also assume that sequence must be scheduler in a single shot and has no already generated context
                 if (!m_config.enable_prefix_caching)
                     OPENVINO_ASSERT(sequence_group->get_context_len() == 0);
+                _restore_persistent_blocks(sequence_group, scheduler_output);
                 size_t num_available_tokens_in_megabatch = m_config.max_num_batched_tokens - scheduler_output.m_total_num_scheduled_tokens;
                 size_t sequence_len = sequence_group->get_num_available_tokens_for_batching();
 
@@ -368,10 +760,16 @@ private:
                     break;
 
                 // apply KV cache limitations
+                if (!_copy_on_write_restored_block(sequence_group, scheduler_output))
+                    break;
                 size_t block_size = get_block_size();
                 const size_t num_required_blocks = (sequence_len + block_size - 1) / block_size;
+                _release_reserved_tail_blocks_if_needed(sequence_groups, num_required_blocks);
                 if (!m_block_manager.can_allocate_blocks(num_required_blocks))
                     break;
+                if (!_admit(sequence_group, num_reserved_blocks))
+                    break;
+                num_reserved_blocks -= std::min(num_reserved_blocks, num_required_blocks);
 
                 // add scheduling information
                 {
@@ -1,7 +1,6 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
-#include <string_view>
 #include "sequence_group.hpp"
 
 namespace ov {
@@ -9,33 +8,35 @@ namespace genai {
 
 std::mutex Sequence::m_counter_mutex;
 
-size_t Sequence::_make_hash(size_t content_length) {
-        auto sequence_group = get_sequence_group_ptr();
-        auto block_size = sequence_group->get_block_size();
-        size_t block_start_idx = content_length - (content_length % block_size);
-        if (block_start_idx == content_length) {
-            block_start_idx -= block_size;
-        }
+// pools are never destroyed, so that sequences owned by static objects can return their buffers at exit
+BufferPool<int64_t>& Sequence::_token_ids_pool() {
+    static auto* pool = new BufferPool<int64_t>(4096, 1 << 16);
+    return *pool;
+}
 
-        // hash of current block depends on prefix hashes
-        std::vector<int64_t> content;
-        size_t prefix_hashes_needed_count = block_start_idx / block_size;
-        OPENVINO_ASSERT(prefix_hashes_needed_count <= m_prefix_hashes.size()); 
-        content.insert(content.end(), m_prefix_hashes.begin(), m_prefix_hashes.begin() + prefix_hashes_needed_count);
-
-        // get tokens corresponding to current block
-        const auto prompt_ids = sequence_group->get_prompt_ids();
-        OPENVINO_ASSERT(content_length <= prompt_ids.size() + m_generated_ids.size());
-        if (block_start_idx < prompt_ids.size()) {
-            content.insert(content.end(), prompt_ids.begin() + block_start_idx, prompt_ids.begin() + std::min(prompt_ids.size(), content_length));
-        }
-        if (content_length > prompt_ids.size()) {
-            size_t start = block_start_idx < prompt_ids.size() ? 0 : block_start_idx - prompt_ids.size();
-            content.insert(content.end(), m_generated_ids.begin() + start, m_generated_ids.begin() + content_length - prompt_ids.size());
-        }
-        const char* data = reinterpret_cast<const char*>(content.data());
-        std::size_t size = content.size() * sizeof(content[0]);
-        return std::hash<std::string_view>{}(std::string_view(data, size));
+BufferPool<float>& Sequence::_log_probs_pool() {
+    static auto* pool = new BufferPool<float>(4096, 1 << 16);
+    return *pool;
+}
+
+void Sequence::_invalidate_hashes(size_t prompt_len, size_t block_size) {
+    const size_t valid_len = prompt_len + m_min_generated_len_since_hashing;
+    if (m_prefix_hashes.size() > valid_len / block_size) {
+        m_prefix_hashes.resize(valid_len / block_size);
+    }
+    const size_t block_start = m_prefix_hashes.size() * block_size;
+    if (m_partial_hash_end > valid_len) {
+        m_partial_hasher = TokenHasher(m_prefix_hashes.empty() ? 0 : m_prefix_hashes.back());
+        m_partial_hash_end = block_start;
+    }
+    m_min_generated_len_since_hashing = m_generated_ids->size();
+}
+
+void Sequence::_extend_partial_hash(const TokenIds& prompt_ids, size_t content_length) {
+    for (; m_partial_hash_end < content_length; ++m_partial_hash_end) {
+        m_partial_hasher.update(m_partial_hash_end < prompt_ids.size() ? prompt_ids[m_partial_hash_end]
+                                                                       : (*m_generated_ids)[m_partial_hash_end - prompt_ids.size()]);
+    }
 }
 
 // Each KV block can be uniquely identified by 
@@ -47,17 +48,35 @@ size_t Sequence::get_hash(size_t content_length) {
     OPENVINO_ASSERT(sequence_group, "Hash computation requires setting of sequence_group ptr.");
     auto content_len = content_length == 0 ? sequence_group->get_context_len() : content_length;
     auto block_size = sequence_group->get_block_size();
-    size_t cur_content = block_size * (m_prefix_hashes.size() + 1);
-    while (cur_content <= content_len)
-    {
-        m_prefix_hashes.push_back(_make_hash(cur_content));
-        cur_content += block_size;
+    const auto& prompt_ids = sequence_group->get_prompt_cache_ids();
+    OPENVINO_ASSERT(content_len <= prompt_ids.size() + m_generated_ids->size());
+    _invalidate_hashes(prompt_ids.size(), block_size);
+
+    // full blocks are hashed once, each continues the hash state of the previous one
+    for (size_t block_end = block_size * (m_prefix_hashes.size() + 1); block_end <= content_len; block_end += block_size) {
+        _extend_partial_hash(prompt_ids, block_end);
+        m_prefix_hashes.push_back(m_partial_hasher.digest());
+        m_partial_hasher = TokenHasher(m_prefix_hashes.back());
     }
     if (content_len % block_size == 0) {
         return m_prefix_hashes[content_len / block_size - 1];
     }
-    
-    return _make_hash(content_len);
+
+    const size_t block_idx = content_len / block_size, block_start = block_idx * block_size;
+    if (block_idx < m_prefix_hashes.size()) {
+        // part of a block, whose full hash is already known
+        TokenHasher hasher(block_idx == 0 ? 0 : m_prefix_hashes[block_idx - 1]);
+        for (size_t position = block_start; position < content_len; ++position) {
+            hasher.update(position < prompt_ids.size() ? prompt_ids[position] : (*m_generated_ids)[position - prompt_ids.size()]);
+        }
+        return hasher.digest();
+    }
+    if (m_partial_hash_end > content_len) {
+        m_partial_hasher = TokenHasher(block_idx == 0 ? 0 : m_prefix_hashes[block_idx - 1]);
+        m_partial_hash_end = block_start;
+    }
+    _extend_partial_hash(prompt_ids, content_len);
+    return m_partial_hasher.digest();
 }
 }  // namespace genai
 }  // namespace ov
\ No newline at end of file
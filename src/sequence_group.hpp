@@ -3,14 +3,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <set>
 #include <cstdlib>
+#include <chrono>
+#include <optional>
 #include <string_view>
 
 #include "openvino/genai/generation_handle.hpp"
 #include "openvino/genai/generation_config.hpp"
 #include "generation_stream.hpp"
+#include "token_hasher.hpp"
+#include "buffer_pool.hpp"
 
 namespace ov::genai {
 enum class SequenceStatus {
@@ -32,18 +37,37 @@ class Sequence {
         return m_counter++;
     }
 
-    TokenIds m_generated_ids;
-    LogProbs m_generated_log_probs;
+    // pooled buffers, generated ids are shared with forked sequences until either of them modifies them
+    BufferPool<int64_t>::Ptr m_generated_ids = _token_ids_pool().acquire();
+    BufferPool<float>::Ptr m_generated_log_probs = _log_probs_pool().acquire();
     uint64_t m_grouped_id;
     uint64_t m_id = _get_next_global_sequence_id();
     SequenceStatus m_status = SequenceStatus::RUNNING;
     GenerationFinishReason m_finish_reason = GenerationFinishReason::NONE;
     float m_cumulative_log_prob = 0.0f;
+    // hashes of full KV cache blocks
     std::vector<int64_t> m_prefix_hashes;
+    // hash state of the block following the full ones, which covers tokens up to m_partial_hash_end
+    TokenHasher m_partial_hasher;
+    size_t m_partial_hash_end = 0;
+    // the smallest number of generated tokens since the last hashing, generated tokens after it were removed
+    size_t m_min_generated_len_since_hashing = 0;
     std::weak_ptr<SequenceGroup> m_sequence_group;
     static std::mutex m_counter_mutex;
 
-    size_t _make_hash(size_t content_length);
+    static BufferPool<int64_t>& _token_ids_pool();
+    static BufferPool<float>& _log_probs_pool();
+
+    TokenIds& _get_mutable_generated_ids() {
+        if (m_generated_ids.use_count() > 1)
+            m_generated_ids = _token_ids_pool().acquire(*m_generated_ids);
+        return *m_generated_ids;
+    }
+
+    // drops hashes, which cover removed tokens
+    void _invalidate_hashes(size_t prompt_len, size_t block_size);
+    // continues the partial block hash up to the given content length
+    void _extend_partial_hash(const TokenIds& prompt_ids, size_t content_length);
 public:
     using Ptr = std::shared_ptr<Sequence>;
     using CPtr = std::shared_ptr<const Sequence>;
@@ -111,29 +135,31 @@ public:
     // appends new tokens to a generated part
     void append_token(int64_t token_id, float log_prob) {
         m_cumulative_log_prob += log_prob;
-        m_generated_log_probs.push_back(log_prob);
-        m_generated_ids.push_back(token_id);
+        m_generated_log_probs->push_back(log_prob);
+        _get_mutable_generated_ids().push_back(token_id);
     }
 
     // removes n last tokens and updates cumulative log prob
     // used to remove stop_string from the output
     void remove_last_tokens(int n) {
-        OPENVINO_ASSERT(m_generated_ids.size() >= n, "Cannot remove more tokens than has been generated");
+        OPENVINO_ASSERT(m_generated_ids->size() >= n, "Cannot remove more tokens than has been generated");
+        TokenIds& generated_ids = _get_mutable_generated_ids();
         for (int i = 0; i < n; i++) {
-            m_cumulative_log_prob -= m_generated_log_probs.back();
-            m_generated_log_probs.pop_back();
-            m_generated_ids.pop_back();
+            m_cumulative_log_prob -= m_generated_log_probs->back();
+            m_generated_log_probs->pop_back();
+            generated_ids.pop_back();
         }
+        m_min_generated_len_since_hashing = std::min(m_min_generated_len_since_hashing, generated_ids.size());
     }
 
     GenerationOutput get_last_generation_output(size_t token_cnt = 1, size_t num_token_to_ignore = 0) {
         GenerationOutput output;
         if (token_cnt > 0) {
-            OPENVINO_ASSERT(m_generated_ids.size());
+            OPENVINO_ASSERT(m_generated_ids->size());
             output.score = get_cumulative_log_probs();
 
-            auto generated_token_id = get_generated_ids();
-            auto generated_log_probs = get_generated_log_probs();
+            const auto& generated_token_id = get_generated_ids();
+            const auto& generated_log_probs = get_generated_log_probs();
 
             OPENVINO_ASSERT(get_generated_len() >= token_cnt);
             if (get_generated_len() > num_token_to_ignore) {
@@ -152,15 +178,15 @@ public:
     }
 
     size_t get_generated_len() const {
-        return m_generated_ids.size();
+        return m_generated_ids->size();
     }
 
     const TokenIds & get_generated_ids() const {
-        return m_generated_ids;
+        return *m_generated_ids;
     }
 
     const LogProbs & get_generated_log_probs() const {
-        return m_generated_log_probs;
+        return *m_generated_log_probs;
     }
 
     float get_cumulative_log_probs() const {
@@ -168,8 +194,8 @@ public:
     }
 
     void update_generated_log_prob(size_t idx, float log_prob) {
-        OPENVINO_ASSERT(idx < m_generated_log_probs.size());
-        m_generated_log_probs[idx] = log_prob;
+        OPENVINO_ASSERT(idx < m_generated_log_probs->size());
+        (*m_generated_log_probs)[idx] = log_prob;
     }
 
     float get_beam_search_score(const ov::genai::GenerationConfig& sampling_params) const {
@@ -191,6 +217,7 @@ public:
     // Each KV block can be uniquely identified by
     // the tokens within the block and the tokens in the prefix before the block.
     // hash(prefix tokens + block tokens) <--> KV Block
+    // Block hashes are chained: a block hash continues the hash of the previous block, so only new tokens are hashed.
     size_t get_hash(size_t content_length = 0);
 };
 
@@ -204,6 +231,10 @@ class SequenceGroup {
     ov::genai::GenerationConfig m_sampling_params;
     std::size_t m_block_size;
     TokenIds m_prompt_ids;
+    // embeddings of the prompt of shape [1, prompt_len, hidden_size], set if they are not computed from m_prompt_ids
+    ov::Tensor m_prompt_embeds;
+    // identify prompt positions for prefix caching instead of m_prompt_ids, if m_prompt_embeds is set
+    TokenIds m_prompt_cache_ids;
     std::vector<float> m_prompt_log_probs;
     GenerationStream::Ptr m_generation_stream;
     bool m_enable_prefix_caching;
@@ -223,9 +254,24 @@ class SequenceGroup {
     size_t m_num_validation_tokens = 0;
     // flag to enable/disable token generation, e.g. in speculative decoding scenario
     bool m_is_gen_paused = false;
+    // whether the group passed admission control of the scheduler, see SchedulerConfig::admission_watermark
+    bool m_is_admitted = false;
 
     size_t m_num_streamed_tokens = 0, m_stream_window_size = 0;
 
+    // moment of time when request was added to the pipeline, used by deadline-aware scheduling
+    std::chrono::steady_clock::time_point m_arrival_time = std::chrono::steady_clock::now();
+
+    // bookkeeping of RequestTimings, which are stored in the generation stream
+    bool m_was_scheduled = false;
+    std::optional<std::chrono::steady_clock::time_point> m_last_token_time;
+    // the moment of the first of preemptions, which are not recovered yet, and the number of processed tokens before it
+    std::optional<std::chrono::steady_clock::time_point> m_preemption_time;
+    size_t m_num_processed_tokens_before_preemption = 0;
+
+    static float _milliseconds_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    }
 
     SequenceGroup(uint64_t request_id, const ov::genai::GenerationConfig& sampling_params, std::size_t block_size, bool enable_prefix_caching)
         : m_request_id(request_id),
@@ -389,6 +435,20 @@ public:
         return m_request_id;
     }
 
+    std::chrono::steady_clock::time_point get_arrival_time() const {
+        return m_arrival_time;
+    }
+
+    /**
+     * @return The point of time by which the request is expected to be processed according to GenerationConfig::deadline_ms,
+     * or the maximum time point if the request has no deadline.
+     */
+    std::chrono::steady_clock::time_point get_deadline() const {
+        if (m_sampling_params.deadline_ms == 0)
+            return std::chrono::steady_clock::time_point::max();
+        return m_arrival_time + std::chrono::milliseconds(m_sampling_params.deadline_ms);
+    }
+
     size_t get_num_scheduled_tokens() const {
         return m_num_scheduled_tokens;
     }
@@ -427,6 +487,70 @@ public:
     void preempt_tokens(size_t num_preempt_tokens) {
         OPENVINO_ASSERT(num_preempt_tokens <= m_num_processed_tokens);
         m_num_processed_tokens -= num_preempt_tokens;
+        m_generation_stream->update_timings([num_preempt_tokens] (RequestTimings& timings) {
+            timings.num_recomputed_tokens += num_preempt_tokens;
+        });
+    }
+
+    /**
+     * Registers timings of the request taken by a pipeline step from the queue of added requests.
+     */
+    void register_dequeue() {
+        const float queue_wait_ms = _milliseconds_between(m_arrival_time, std::chrono::steady_clock::now());
+        m_generation_stream->update_timings([queue_wait_ms] (RequestTimings& timings) {
+            timings.queue_wait_ms = queue_wait_ms;
+        });
+    }
+
+    /**
+     * Registers timings of preemption of the request, must be called before its processed tokens are preempted.
+     */
+    void register_preemption() {
+        if (!m_preemption_time) {
+            m_preemption_time = std::chrono::steady_clock::now();
+            m_num_processed_tokens_before_preemption = m_num_processed_tokens;
+        }
+        m_generation_stream->update_timings([] (RequestTimings& timings) {
+            ++timings.num_preemptions;
+        });
+    }
+
+    /**
+     * Registers timings of a step, which processed the request.
+     * @param step_start_time The moment the step was launched.
+     * @param is_prefill Whether the step processed prompt tokens.
+     * @param generates_tokens Whether the step generated tokens.
+     */
+    void register_step(std::chrono::steady_clock::time_point step_start_time, bool is_prefill, bool generates_tokens) {
+        const auto now = std::chrono::steady_clock::now();
+        const bool is_first_schedule = !m_was_scheduled;
+        m_was_scheduled = true;
+
+        float preemption_loss_ms = 0.0f;
+        if (m_preemption_time && m_num_processed_tokens >= m_num_processed_tokens_before_preemption) {
+            preemption_loss_ms = _milliseconds_between(*m_preemption_time, now);
+            m_preemption_time.reset();
+        }
+
+        float token_interval_ms = 0.0f;
+        if (generates_tokens && m_last_token_time)
+            token_interval_ms = _milliseconds_between(*m_last_token_time, now);
+
+        m_generation_stream->update_timings([&] (RequestTimings& timings) {
+            if (is_first_schedule)
+                timings.time_to_first_schedule_ms = _milliseconds_between(m_arrival_time, step_start_time);
+            if (is_prefill)
+                ++timings.num_prefill_steps;
+            timings.preemption_loss_ms += preemption_loss_ms;
+            if (generates_tokens) {
+                if (m_last_token_time)
+                    timings.token_intervals_ms.push_back(token_interval_ms);
+                else
+                    timings.ttft_ms = _milliseconds_between(m_arrival_time, now);
+            }
+        });
+        if (generates_tokens)
+            m_last_token_time = now;
     }
 
     // returns context length taking into account scheduled tokens
@@ -466,6 +590,10 @@ public:
         m_stream_window_size = k;
     }
 
+    size_t get_stream_window_size() const {
+        return m_stream_window_size;
+    }
+
     size_t get_num_available_tokens_for_batching() const {
         OPENVINO_ASSERT(!has_finished(), "Internal error: this function cannot be called on finished sequence group");
         OPENVINO_ASSERT(get_num_scheduled_tokens() == 0, "Internal error: this function cannot be called when we are already in scheduling phase");
@@ -502,6 +630,36 @@ public:
         return m_prompt_ids;
     }
 
+    /**
+     * Sets embeddings of the prompt, e.g. with embeddings of images merged by a VLM, which are passed to the model instead of
+     * embeddings of prompt IDs. Image positions share placeholder token IDs, so prefix caching identifies prompt positions
+     * by hashes of their embeddings, which are the same for the same tokens and images.
+     * @param prompt_embeds Tensor of shape [1, prompt_len, hidden_size] and f32 element type.
+     */
+    void set_prompt_embeds(const ov::Tensor& prompt_embeds) {
+        OPENVINO_ASSERT(prompt_embeds.get_shape().size() == 3 && prompt_embeds.get_shape().at(1) == get_prompt_len(),
+                        "Prompt embeddings must have shape [1, prompt_len, hidden_size]");
+        m_prompt_embeds = prompt_embeds;
+        const size_t row_byte_size = prompt_embeds.get_byte_size() / get_prompt_len();
+        const char* data = static_cast<const char*>(prompt_embeds.data());
+        m_prompt_cache_ids.resize(get_prompt_len());
+        for (size_t position = 0; position < get_prompt_len(); ++position) {
+            m_prompt_cache_ids[position] = static_cast<int64_t>(
+                std::hash<std::string_view>{}(std::string_view(data + position * row_byte_size, row_byte_size)));
+        }
+    }
+
+    const ov::Tensor& get_prompt_embeds() const {
+        return m_prompt_embeds;
+    }
+
+    /**
+     * @return Values identifying prompt positions for prefix caching: prompt IDs or hashes of prompt embeddings, if set.
+     */
+    const TokenIds& get_prompt_cache_ids() const {
+        return m_prompt_embeds ? m_prompt_cache_ids : m_prompt_ids;
+    }
+
     void append_prompt_log_prob(float log_prob) {
         m_prompt_log_probs.push_back(log_prob);
     }
@@ -542,6 +700,14 @@ public:
         }
     }
 
+    bool is_admitted() const {
+        return m_is_admitted;
+    }
+
+    void set_admitted() {
+        m_is_admitted = true;
+    }
+
     void set_waiting() {
         for (size_t seq_id = 0; seq_id < m_sequences.size(); ++seq_id) {
             if (m_sequences[seq_id]->is_running()) {
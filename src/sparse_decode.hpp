@@ -0,0 +1,210 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include <openvino/runtime/infer_request.hpp>
+
+#include "cache_manager.hpp"
+#include "scheduler.hpp"
+#include "sequence_group.hpp"
+
+namespace ov::genai {
+
+/**
+ * Selects KV cache blocks attended by decode steps of long sequences (Quest-like sparse attention). Keys of each full block are
+ * summarized by per-channel minimums and maximums, so that sum_d max(q_d * min_d, q_d * max_d) bounds the attention score of
+ * a query q for any key of the block. The query of the current token is not known before inference, so the query of the previous
+ * token of the sequence, which is returned by the model transformed by apply_sparse_decode_queries_transformation, stands for it.
+ * The first block (attention sink) and the last block, which receives the key of the current token, are always attended.
+ */
+class SparseDecodeSelector {
+    std::shared_ptr<CacheManager> m_cache_manager;
+    size_t m_block_size, m_num_layers, m_block_budget, m_num_kv_heads, m_head_size;
+    // sequence ID -> layer -> summaries of full logical blocks, 2 * num_kv_heads * head_size values each
+    std::map<uint64_t, std::vector<std::vector<std::vector<float>>>> m_key_summaries;
+    // sequence ID -> layer -> query of the last processed token, num_heads * head_size values
+    std::map<uint64_t, std::vector<std::vector<float>>> m_last_queries;
+    // sequence ID -> layer -> ascending logical indices of blocks attended by the current step
+    std::map<uint64_t, std::vector<std::vector<size_t>>> m_selected_blocks;
+    // number of blocks of the current step, which are not attended
+    size_t m_num_skipped_blocks = 0;
+    std::vector<int64_t> m_query_indices;
+
+    // whether the next step of a sequence with a given number of cached tokens attends to more blocks than the budget
+    bool _exceeds_budget(size_t num_cached_tokens) const {
+        return num_cached_tokens / m_block_size + 1 > m_block_budget;
+    }
+
+    std::vector<size_t> _select_layer_blocks(size_t num_full_blocks, const std::vector<std::vector<float>>& summaries,
+                                             const std::vector<float>& query) const {
+        const size_t num_heads = query.size() / m_head_size, group_size = num_heads / m_num_kv_heads;
+        std::vector<float> scores(num_full_blocks, 0.0f);
+        for (size_t block = 1; block < num_full_blocks; ++block) {
+            const float* min_data = summaries[block].data();
+            const float* max_data = min_data + m_num_kv_heads * m_head_size;
+            // a block is kept, if any head may attend to it
+            float score = std::numeric_limits<float>::lowest();
+            for (size_t head = 0; head < num_heads; ++head) {
+                const float* q = query.data() + head * m_head_size;
+                const size_t kv_offset = (head / group_size) * m_head_size;
+                float bound = 0.0f;
+                for (size_t channel = 0; channel < m_head_size; ++channel)
+                    bound += std::max(q[channel] * min_data[kv_offset + channel], q[channel] * max_data[kv_offset + channel]);
+                score = std::max(score, bound);
+            }
+            scores[block] = score;
+        }
+
+        // the sink and the last block take 2 blocks of the budget
+        std::vector<size_t> candidates(num_full_blocks - 1);
+        std::iota(candidates.begin(), candidates.end(), 1);
+        const size_t num_selected = m_block_budget - 2;
+        std::partial_sort(candidates.begin(), candidates.begin() + num_selected, candidates.end(),
+                          [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+        std::vector<size_t> selected{0};
+        selected.insert(selected.end(), candidates.begin(), candidates.begin() + num_selected);
+        std::sort(selected.begin(), selected.end());
+        selected.push_back(num_full_blocks);
+        return selected;
+    }
+
+    template <typename T>
+    static void _copy_query(const T* src, std::vector<float>& dst) {
+        for (size_t i = 0; i < dst.size(); ++i)
+            dst[i] = static_cast<float>(src[i]);
+    }
+
+public:
+    SparseDecodeSelector(std::shared_ptr<CacheManager> cache_manager, const DeviceConfig& device_config, size_t block_budget) :
+        m_cache_manager(std::move(cache_manager)),
+        m_block_size(device_config.get_block_size()),
+        m_num_layers(device_config.get_num_layers()),
+        m_block_budget(block_budget),
+        m_num_kv_heads(device_config.get_key_cache_shape()[1]),
+        m_head_size(device_config.get_key_cache_shape()[3]) {
+        OPENVINO_ASSERT(m_block_budget >= 2, "SchedulerConfig::sparse_decode_block_budget must be at least 2 to keep the first and the last blocks");
+        OPENVINO_ASSERT(device_config.get_device().find("CPU") != std::string::npos, "SchedulerConfig::sparse_decode_block_budget is supported on CPU only");
+        const ov::element::Type key_type = device_config.get_key_cache_precision();
+        OPENVINO_ASSERT(key_type == ov::element::f32 || key_type == ov::element::f16 || key_type == ov::element::bf16,
+                        "SchedulerConfig::sparse_decode_block_budget requires key cache of f32, f16 or bf16 precision, while it is ", key_type);
+    }
+
+    /**
+     * Selects blocks attended by decode steps of scheduled sequences exceeding the budget and sets "sparse_decode_query_indices"
+     * input of the request to the last scheduled token of each running sequence. Summaries of blocks filled since the previous step
+     * are computed here, KV cache must be up to date with the scheduler output.
+     */
+    void select_blocks(ov::InferRequest& request, const std::vector<SequenceGroup::Ptr>& sequence_groups, const Scheduler::Output& scheduler_output) {
+        m_selected_blocks.clear();
+        m_num_skipped_blocks = 0;
+        m_query_indices.clear();
+        std::set<uint64_t> scheduled_sequence_ids;
+        size_t token_offset = 0;
+        for (size_t seq_group_id : scheduler_output.m_scheduled_sequence_groups_ids) {
+            SequenceGroup::CPtr sequence_group = sequence_groups[seq_group_id];
+            const size_t num_scheduled_tokens = sequence_group->get_num_scheduled_tokens();
+            const size_t num_cached_tokens = sequence_group->get_num_processed_tokens();
+            for (Sequence::CPtr sequence : sequence_group->get_running_sequences()) {
+                const uint64_t sequence_id = sequence->get_id();
+                scheduled_sequence_ids.insert(sequence_id);
+                token_offset += num_scheduled_tokens;
+                m_query_indices.push_back(static_cast<int64_t>(token_offset - 1));
+
+                // prompts attend to all blocks, as well as sequences forked from others, whose queries are not collected yet
+                auto queries_it = m_last_queries.find(sequence_id);
+                if (num_scheduled_tokens != 1 || !_exceeds_budget(num_cached_tokens) || queries_it == m_last_queries.end())
+                    continue;
+
+                const size_t num_full_blocks = num_cached_tokens / m_block_size;
+                const auto& block_tables = scheduler_output.m_block_tables.at(sequence_id);
+                auto& summaries = m_key_summaries[sequence_id];
+                summaries.resize(m_num_layers);
+                auto& selected = m_selected_blocks[sequence_id];
+                selected.resize(m_num_layers);
+                ov::parallel_for(m_num_layers, [&](size_t layer) {
+                    auto& layer_summaries = summaries[layer];
+                    for (size_t block = layer_summaries.size(); block < num_full_blocks; ++block) {
+                        std::vector<float> summary(2 * m_num_kv_heads * m_head_size);
+                        m_cache_manager->compute_key_summary(layer, block_tables[layer][block]->get_index(), summary.data());
+                        layer_summaries.push_back(std::move(summary));
+                    }
+                    selected[layer] = _select_layer_blocks(num_full_blocks, layer_summaries, queries_it->second[layer]);
+                });
+                m_num_skipped_blocks += num_full_blocks + 1 - m_block_budget;
+            }
+        }
+
+        // finished and preempted sequences start over
+        for (auto it = m_key_summaries.begin(); it != m_key_summaries.end();)
+            it = scheduled_sequence_ids.count(it->first) ? std::next(it) : m_key_summaries.erase(it);
+        for (auto it = m_last_queries.begin(); it != m_last_queries.end();)
+            it = scheduled_sequence_ids.count(it->first) ? std::next(it) : m_last_queries.erase(it);
+
+        request.set_tensor("sparse_decode_query_indices", ov::Tensor(ov::element::i64, {m_query_indices.size()}, m_query_indices.data()));
+    }
+
+    /**
+     * @return Logical indices of blocks of each layer attended by the current step of a sequence, whose last element is the last
+     * block of the sequence, or nullptr if the step attends to all blocks.
+     */
+    const std::vector<std::vector<size_t>>* get_selected_blocks(uint64_t sequence_id) const {
+        auto it = m_selected_blocks.find(sequence_id);
+        return it == m_selected_blocks.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @return Total number of blocks of scheduled sequences, which are not attended by the current step.
+     */
+    size_t get_num_skipped_blocks() const {
+        return m_num_skipped_blocks;
+    }
+
+    /**
+     * Keeps queries of the last tokens of running sequences, which may exceed the budget at the next step, after inference
+     * of the request passed to select_blocks.
+     */
+    void collect_queries(ov::InferRequest& request, const std::vector<SequenceGroup::Ptr>& sequence_groups, const Scheduler::Output& scheduler_output) {
+        std::vector<ov::Tensor> queries(m_num_layers);
+        for (size_t layer = 0; layer < m_num_layers; ++layer)
+            queries[layer] = request.get_tensor("queries." + std::to_string(layer));
+        const size_t query_size = queries[0].get_shape()[1];
+
+        size_t row = 0;
+        for (size_t seq_group_id : scheduler_output.m_scheduled_sequence_groups_ids) {
+            SequenceGroup::CPtr sequence_group = sequence_groups[seq_group_id];
+            const size_t num_cached_tokens = sequence_group->get_num_processed_tokens() + sequence_group->get_num_scheduled_tokens();
+            for (Sequence::CPtr sequence : sequence_group->get_running_sequences()) {
+                const size_t sequence_row = row++;
+                if (!_exceeds_budget(num_cached_tokens))
+                    continue;
+                auto& last_queries = m_last_queries[sequence->get_id()];
+                last_queries.resize(m_num_layers);
+                for (size_t layer = 0; layer < m_num_layers; ++layer) {
+                    auto& query = last_queries[layer];
+                    query.resize(query_size);
+                    const ov::element::Type type = queries[layer].get_element_type();
+                    if (type == ov::element::f32) {
+                        _copy_query(queries[layer].data<float>() + sequence_row * query_size, query);
+                    } else if (type == ov::element::f16) {
+                        _copy_query(queries[layer].data<ov::float16>() + sequence_row * query_size, query);
+                    } else if (type == ov::element::bf16) {
+                        _copy_query(queries[layer].data<ov::bfloat16>() + sequence_row * query_size, query);
+                    } else {
+                        OPENVINO_THROW("Unsupported element type of queries: ", type);
+                    }
+                }
+            }
+        }
+    }
+};
+
+}
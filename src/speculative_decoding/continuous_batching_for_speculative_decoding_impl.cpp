@@ -18,6 +18,8 @@ ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::Contin
     m_generation_config = generation_config;
     m_is_validation_mode_enabled = is_validation_mode_enabled;
     init(model, scheduler_config, plugin_config, device_config, core);
+    // blocks freed by rollback of rejected candidates are needed again by the candidates of the next step
+    m_scheduler->set_num_reserved_tail_blocks(NUM_RESERVED_TAIL_BLOCKS);
 }
 
 void
@@ -43,6 +45,15 @@ void ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::f
     }
 }
 
+void ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::preempt_requests(const std::set<uint64_t>& request_ids) {
+    if (request_ids.empty())
+        return;
+    for (const auto& request : m_requests) {
+        if (request_ids.count(request->get_request_id()))
+            m_scheduler->preempt_fully(request);
+    }
+}
+
 GeneratedRequests
 ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::get_generated_requests() {
     GeneratedRequests result;
@@ -231,6 +242,14 @@ ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::update
             auto& logit_processor = m_sampler->get_logit_processor(request_id);
             std::tie(min_generated_tokens, min_candidate_len) = get_prefix_len(running_sequences, candidates);
 
+            // a draft model running ahead already continues validated tokens, so tokens drafted for the next step are kept
+            if (m_is_pipelined && !m_is_validation_mode_enabled && min_generated_tokens == min_candidate_len &&
+                running_sequences.front()->get_generated_len() > min_candidate_len) {
+                const size_t max_new_tokens = request->get_sampling_parameters().max_new_tokens;
+                request->pause_generation(running_sequences.front()->get_generated_len() + 1 >= max_new_tokens);
+                break;
+            }
+
             for (auto& running_sequence : running_sequences) {
                 if (!candidates.count(running_sequence->get_grouped_id())) {
                     continue;
@@ -258,18 +277,25 @@ ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::update
                      updated_context_len = min_candidate_len + prompt_len,
                      max_new_tokens = request->get_sampling_parameters().max_new_tokens;
         size_t generated_len = request->get_context_len() >= request->get_prompt_len() ? request->get_context_len() - request->get_prompt_len() + 1 : 0;
-        if (generated_len > 0 && result.removed_tokens_cnt > 0) {
-            request->update_processed_tokens_num(num_processed_tokens - result.removed_tokens_cnt + 1);
+        // a request preempted in this pipeline has not processed the removed tokens yet
+        if (generated_len > 0 && result.removed_tokens_cnt > 0 && num_processed_tokens >= result.removed_tokens_cnt) {
+            const size_t updated_num_processed_tokens = num_processed_tokens - result.removed_tokens_cnt + 1;
+            request->update_processed_tokens_num(updated_num_processed_tokens);
+            // blocks beyond the updated context are freed by the next scheduling
+            const size_t block_size = m_scheduler->get_block_size();
+            result.removed_blocks_cnt = running_sequences.size() *
+                ((num_processed_tokens + block_size - 1) / block_size - (updated_num_processed_tokens + block_size - 1) / block_size);
         }
         if (result.inserted_tokens_cnt > 0 && result.removed_tokens_cnt == 0) {
             request->set_num_validated_tokens(result.inserted_tokens_cnt);
         }
-        // to pause `draft_model` generation in case of `generated_len >= max_new_tokens - 1` to generate last token by `main_model`
+        // to pause `draft_model` generation in case of `generated_len + 1 >= max_new_tokens` to generate last token by `main_model`,
+        // which is not written as `max_new_tokens - 1` to avoid underflow for max_new_tokens == 0
         if (!m_is_validation_mode_enabled) {
             bool pause_gen_status = false;
             generated_len -= result.removed_tokens_cnt;
             generated_len += result.inserted_tokens_cnt;
-            if (generated_len >= max_new_tokens - 1 || generated_len != 0 && result.inserted_tokens_cnt == 0) {
+            if (generated_len + 1 >= max_new_tokens || generated_len != 0 && result.inserted_tokens_cnt == 0) {
                 pause_gen_status = true;
             }
             request->pause_generation(pause_gen_status);
@@ -281,17 +307,16 @@ ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::update
 
 void
 ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::pull_awaiting_requests(bool is_pause_request) {
-    std::lock_guard<std::mutex> lock{m_awaiting_requests_mutex};
-    if (is_pause_request) {
-        for (auto& awaiting_request : m_awaiting_requests) {
+    SequenceGroup::Ptr awaiting_request;
+    while (m_awaiting_requests.try_pop(awaiting_request)) {
+        if (is_pause_request) {
             awaiting_request->pause_generation(true);
         }
+        m_requests.push_back(std::move(awaiting_request));
     }
-    m_requests.insert(m_requests.end(), m_awaiting_requests.begin(), m_awaiting_requests.end());
-    m_awaiting_requests.clear();
 }
 
-void ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::multistep() {
+size_t ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::multistep() {
     bool to_generate = true;
     size_t generated_tokens_cnt = 0;
     // cycle to generate several tokens per one iteration for speculative decoding case
@@ -307,11 +332,12 @@ void ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::m
                 // generate only one token in case of non speculative decoding
                 request->pause_generation(true);
             } else if (request->get_num_processed_tokens() >= request->get_prompt_len() &&
-                (request->get_num_processed_tokens() - request->get_prompt_len() + 1) >= sampling_params.max_new_tokens - 1) {
+                (request->get_num_processed_tokens() - request->get_prompt_len() + 2) >= sampling_params.max_new_tokens) {
                 request->pause_generation(true);
             } else if (request->get_num_processed_tokens() == 0 && sampling_params.num_return_sequences > 1) {
                 request->pause_generation(true);
-            } else if (sampling_params.num_assistant_tokens <= generated_tokens_cnt && sampling_params.assistant_confidence_threshold == 0.f) {
+            } else if (sampling_params.assistant_confidence_threshold == 0.f && generated_tokens_cnt >= (m_draft_lengths.count(request->get_request_id()) ?
+                       m_draft_lengths.at(request->get_request_id()) : sampling_params.num_assistant_tokens)) {
                 request->pause_generation(true);
             } else if (sampling_params.max_new_tokens == 0) {
                 request->pause_generation(true);
@@ -321,5 +347,6 @@ void ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl::m
             to_generate |= request->can_generate_tokens();
         }
     }
+    return generated_tokens_cnt;
 }
 }
\ No newline at end of file
@@ -9,6 +9,12 @@
 #include "speculative_decoding/update_request_structs.hpp"
 
 namespace ov::genai {
+/**
+ * Continuous batching pipeline of a draft or a main model of speculative decoding.
+ * Candidates of a sequence form a single chain of tokens appended to the sequence. Tree speculation is not supported: PagedAttention
+ * attends causally to all previous tokens of a subsequence and has no input for a custom attention mask, so several draft branches
+ * cannot be validated as a tree within one sequence.
+ */
 class ContinuousBatchingPipeline::ContinuousBatchingForSpeculativeDecodingImpl : public ContinuousBatchingPipeline::ContinuousBatchingImpl {
 public:
     ContinuousBatchingForSpeculativeDecodingImpl() = default;
@@ -23,7 +29,27 @@ public:
                                                  const ov::AnyMap& plugin_config,
                                                  bool is_validation_mode_enabled);
 
-    void multistep();
+    /**
+     * Generates candidates by several steps of the model.
+     * @return Number of performed steps.
+     */
+    size_t multistep();
+
+    /**
+     * Overrides GenerationConfig::num_assistant_tokens of requests for the next multistep() calls.
+     * @param draft_lengths { request_id, number of tokens to draft }, other requests use their generation config.
+     */
+    void set_draft_lengths(const std::map<uint64_t, size_t>& draft_lengths) {
+        m_draft_lengths = draft_lengths;
+    }
+
+    /**
+     * Sets whether the draft model runs ahead of the main model, so that draft sequences agreeing with validated tokens
+     * keep tokens drafted beyond them in update_request().
+     */
+    void set_pipelined(bool is_pipelined) {
+        m_is_pipelined = is_pipelined;
+    }
 
     void finish_request(int64_t request_id = -1);
     void pull_awaiting_requests(bool is_pause_request = false);
@@ -32,7 +58,23 @@ public:
 
     UpdateRequestResult init_request_by_candidate(uint64_t request_id, const GeneratedSequences& candidates);
 
+    /**
+     * @return IDs of requests preempted by the scheduler during the last step.
+     */
+    const std::set<uint64_t>& get_preempted_request_ids() const {
+        return m_scheduler->get_preempted_request_ids();
+    }
+
+    /**
+     * Preempts requests preempted by the other pipeline of speculative decoding, so that a request does not keep KV cache blocks
+     * in one pipeline, while it waits for blocks in the other one. Their tokens are recomputed, when they are scheduled again.
+     */
+    void preempt_requests(const std::set<uint64_t>& request_ids);
+
 protected:
+    std::map<uint64_t, size_t> m_draft_lengths;
+    bool m_is_pipelined = false;
+
     void finish_request(SequenceGroup::Ptr request);
     void _pull_awaiting_requests() override {};
 };
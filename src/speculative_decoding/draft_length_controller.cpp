@@ -0,0 +1,109 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "speculative_decoding/draft_length_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ov::genai {
+
+namespace {
+
+// weight of the previous statistics, so that the estimation follows changes of acceptance within a generation
+const float DECAY = 0.9f;
+// prior counts of accepted and rejected tokens, so that requests start drafting optimistically
+const float PRIOR_ACCEPTED = 2.f, PRIOR_REJECTED = 1.f;
+// a draft of a fully predictable text would be infinitely long otherwise
+const float MAX_ACCEPTANCE_PROBABILITY = 0.99f;
+
+// expected number of tokens produced by a main model step validating `draft_length` tokens
+float get_expected_num_tokens(float acceptance_probability, size_t draft_length) {
+    return (1.f - std::pow(acceptance_probability, static_cast<float>(draft_length + 1))) / (1.f - acceptance_probability);
+}
+
+}  // namespace
+
+float DraftLengthController::get_acceptance_probability(const RequestStatistics& statistics) const {
+    return std::min(statistics.accepted / (statistics.accepted + statistics.rejected), MAX_ACCEPTANCE_PROBABILITY);
+}
+
+void DraftLengthController::add_request(uint64_t request_id, size_t max_draft_length) {
+    m_requests[request_id] = {PRIOR_ACCEPTED, PRIOR_REJECTED, std::max<size_t>(max_draft_length, 1)};
+}
+
+void DraftLengthController::remove_request(uint64_t request_id) {
+    m_requests.erase(request_id);
+}
+
+void DraftLengthController::update_acceptance(uint64_t request_id, size_t num_drafted_tokens, size_t num_accepted_tokens) {
+    auto it = m_requests.find(request_id);
+    if (it == m_requests.end() || num_drafted_tokens == 0)
+        return;
+    // tokens are validated left to right and the first rejected one stops validation, so tokens after it are not observed
+    RequestStatistics& statistics = it->second;
+    statistics.accepted = DECAY * statistics.accepted + static_cast<float>(num_accepted_tokens);
+    statistics.rejected = DECAY * statistics.rejected + (num_accepted_tokens < num_drafted_tokens ? 1.f : 0.f);
+}
+
+void DraftLengthController::update_durations(float draft_step_duration, float main_step_duration) {
+    if (!m_has_durations) {
+        m_draft_step_duration = draft_step_duration;
+        m_main_step_duration = main_step_duration;
+        m_has_durations = true;
+        return;
+    }
+    m_draft_step_duration = DECAY * m_draft_step_duration + (1.f - DECAY) * draft_step_duration;
+    m_main_step_duration = DECAY * m_main_step_duration + (1.f - DECAY) * main_step_duration;
+}
+
+std::map<uint64_t, size_t> DraftLengthController::get_draft_lengths() const {
+    std::map<uint64_t, size_t> draft_lengths;
+    if (!m_has_durations || m_main_step_duration <= 0.f) {
+        // costs are not measured yet
+        for (const auto& [request_id, statistics] : m_requests)
+            draft_lengths[request_id] = statistics.max_draft_length;
+        return draft_lengths;
+    }
+
+    const float cost_ratio = m_draft_step_duration / m_main_step_duration;
+    auto get_step_cost = [cost_ratio] (size_t draft_length) {
+        return 1.f + cost_ratio * static_cast<float>(draft_length);
+    };
+
+    // per-request optimum, as if the request was alone in the batch
+    size_t max_draft_length = 1;
+    for (const auto& [request_id, statistics] : m_requests) {
+        const float acceptance_probability = get_acceptance_probability(statistics);
+        size_t best_draft_length = 1;
+        float best_throughput = 0.f;
+        for (size_t draft_length = 1; draft_length <= statistics.max_draft_length; ++draft_length) {
+            float throughput = get_expected_num_tokens(acceptance_probability, draft_length) / get_step_cost(draft_length);
+            if (throughput > best_throughput) {
+                best_throughput = throughput;
+                best_draft_length = draft_length;
+            }
+        }
+        draft_lengths[request_id] = best_draft_length;
+        max_draft_length = std::max(max_draft_length, best_draft_length);
+    }
+
+    // requests share draft steps, so the longest draft is limited to maximize tokens of the whole batch per second
+    size_t best_batch_draft_length = max_draft_length;
+    float best_batch_throughput = 0.f;
+    for (size_t batch_draft_length = 1; batch_draft_length <= max_draft_length; ++batch_draft_length) {
+        float num_tokens = 0.f;
+        for (const auto& [request_id, statistics] : m_requests)
+            num_tokens += get_expected_num_tokens(get_acceptance_probability(statistics), std::min(draft_lengths[request_id], batch_draft_length));
+        float throughput = num_tokens / get_step_cost(batch_draft_length);
+        if (throughput > best_batch_throughput) {
+            best_batch_throughput = throughput;
+            best_batch_draft_length = batch_draft_length;
+        }
+    }
+    for (auto& [request_id, draft_length] : draft_lengths)
+        draft_length = std::min(draft_length, best_batch_draft_length);
+    return draft_lengths;
+}
+
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace ov::genai {
+
+/**
+ * Chooses the number of tokens drafted per step for requests with GenerationConfig::adaptive_num_assistant_tokens.
+ * Each drafted token is assumed to be accepted with a per-request probability `a`, estimated from recent validation results,
+ * so that drafting `k` tokens yields (1 - a^(k+1)) / (1 - a) tokens per main model step (accepted ones and the token sampled by
+ * the main model) at the cost of `k` draft model steps and one main model step. A draft length maximizing accepted tokens per second
+ * is chosen for each request, then the longest draft of the batch is limited, because all requests wait for the last draft step.
+ */
+class DraftLengthController {
+    struct RequestStatistics {
+        // exponentially decayed numbers of accepted and rejected draft tokens
+        float accepted, rejected;
+        size_t max_draft_length;
+    };
+
+    // { request_id, statistics }
+    std::map<uint64_t, RequestStatistics> m_requests;
+    // exponentially averaged durations of a single draft model step and a single main model step
+    float m_draft_step_duration = 0.f, m_main_step_duration = 0.f;
+    bool m_has_durations = false;
+
+    float get_acceptance_probability(const RequestStatistics& statistics) const;
+
+public:
+    /**
+     * @param request_id Request ID.
+     * @param max_draft_length Maximum number of drafted tokens, i.e. GenerationConfig::num_assistant_tokens.
+     */
+    void add_request(uint64_t request_id, size_t max_draft_length);
+
+    void remove_request(uint64_t request_id);
+
+    bool has_request(uint64_t request_id) const {
+        return m_requests.count(request_id) > 0;
+    }
+
+    /**
+     * @param request_id Request ID.
+     * @param num_drafted_tokens Number of tokens drafted by the last step.
+     * @param num_accepted_tokens Number of them accepted by the main model.
+     */
+    void update_acceptance(uint64_t request_id, size_t num_drafted_tokens, size_t num_accepted_tokens);
+
+    /**
+     * @param draft_step_duration Duration of a single draft model step.
+     * @param main_step_duration Duration of a main model step.
+     */
+    void update_durations(float draft_step_duration, float main_step_duration);
+
+    /**
+     * @return { request_id, draft length } for all added requests.
+     */
+    std::map<uint64_t, size_t> get_draft_lengths() const;
+};
+
+}
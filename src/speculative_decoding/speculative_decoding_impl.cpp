@@ -1,6 +1,8 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <future>
+
 #include "text_callback_streamer.hpp"
 #include "speculative_decoding_impl.hpp"
 #include "utils.hpp"
@@ -35,21 +37,39 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::SpeculativeDecodingImpl(con
     auto main_scheduler_config = main_model_desc.scheduler_config;
     auto main_device = main_model_desc.device;
 
+    OPENVINO_ASSERT(main_model_desc.scheduler_config.device_top_k == 0 && draft_model_desc.scheduler_config.device_top_k == 0,
+                    "SchedulerConfig::device_top_k is not supported with speculative decoding");
+    // draft and main requests must proceed in lockstep
+    OPENVINO_ASSERT(!main_model_desc.scheduler_config.coalesce_identical_prompts && !draft_model_desc.scheduler_config.coalesce_identical_prompts,
+                    "SchedulerConfig::coalesce_identical_prompts is not supported with speculative decoding");
     utils::apply_paged_attention_transformations(main_model, main_model_desc.scheduler_config.use_cache_eviction);
     utils::apply_paged_attention_transformations(draft_model, main_model_desc.scheduler_config.use_cache_eviction);
+    if (draft_model_desc.num_early_exit_layers > 0) {
+        // The early-exit draft keeps its own KV cache of the kept layers instead of sharing the main model's blocks:
+        // - it drafts up to num_assistant_tokens positions ahead of the main model, which the main BlockManager has not allocated,
+        //   while draft sequences get block tables from the draft Scheduler and are preempted and rolled back by it independently;
+        // - in pipelined mode the draft and the main model would write the same positions of shared blocks concurrently.
+        // Sharing needs the candidates to be drafted on block tables of the main pipeline, like Medusa heads do, rather than by a draft pipeline.
+        utils::apply_early_exit_transformation(draft_model, draft_model_desc.num_early_exit_layers);
+    }
 
     std::string draft_device = draft_model_desc.device.empty() ? main_model_desc.device : draft_model_desc.device;
 
     bool is_scheduler_undefined = draft_model_desc.scheduler_config == SchedulerConfig();
+    // KV caches growing on demand share cache_size instead of splitting it in advance
+    bool is_kv_cache_budget_shared = is_scheduler_undefined && main_scheduler_config.initial_num_kv_blocks > 0 &&
+                                     main_scheduler_config.num_kv_blocks == 0 && main_scheduler_config.cache_size > 0;
 
     ov::genai::SchedulerConfig main_scheduler_config_updated = main_scheduler_config,
                                draft_scheduler_config = is_scheduler_undefined ? main_scheduler_config : draft_model_desc.scheduler_config;
-    if (is_scheduler_undefined) {
-        // split KV cache to 2 caches for main and draft models
-        size_t main_model_hidden_size = utils::get_hidden_size(main_model),
-               draft_model_hidden_size = utils::get_hidden_size(draft_model);
-        auto k = static_cast<float>(draft_model_hidden_size) / (main_model_hidden_size + draft_model_hidden_size);
-
+    // KV cache is split to 2 caches for main and draft models
+    // proportionally to KV cache size of a token, which is (hidden size) x (number of decoder layers)
+    size_t main_model_hidden_size = utils::get_hidden_size(main_model) * utils::get_num_decoder_layers(main_model),
+           draft_model_hidden_size = utils::get_hidden_size(draft_model) * utils::get_num_decoder_layers(draft_model);
+    auto k = static_cast<float>(draft_model_hidden_size) / (main_model_hidden_size + draft_model_hidden_size);
+    // automatically sized caches are split by memory measured at creation of each of them instead, see below
+    bool is_cache_size_automatic = main_scheduler_config.cache_size == 0 && main_scheduler_config.num_kv_blocks == 0;
+    if (is_scheduler_undefined && !is_kv_cache_budget_shared && !is_cache_size_automatic) {
         size_t main_cache_size = std::ceil(main_scheduler_config.cache_size * (1.f - k)),
                draft_cache_size = main_scheduler_config.cache_size - main_cache_size;
         OPENVINO_ASSERT(main_cache_size > 0, "KV cache model cache size should be > 0");
@@ -67,6 +87,13 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::SpeculativeDecodingImpl(con
     DeviceConfig main_device_config(core, main_scheduler_config_updated, main_device, compile_properties),
                  draft_device_config(core, draft_scheduler_config, draft_device, draft_properties);
 
+    const bool is_memory_shared = main_device == draft_device ||
+                                  (main_device.find("GPU") == std::string::npos && draft_device.find("GPU") == std::string::npos);
+    if (main_device_config.is_cache_size_automatic() && draft_device_config.is_cache_size_automatic() && is_memory_shared) {
+        // main cache is created first, so it takes its share of free memory, while the draft cache takes the rest
+        main_device_config.set_cache_memory_share(1.f - k);
+    }
+
     utils::set_kv_cache_type_and_shape(main_model, main_device_config);
     utils::set_kv_cache_type_and_shape(draft_model, draft_device_config);
 
@@ -87,6 +114,16 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::SpeculativeDecodingImpl(con
     m_draft_pipeline = std::make_shared<ContinuousBatchingForSpeculativeDecodingImpl>(core,
         draft_model, draft_model_tokenizer, draft_model_desc.generation_config,
         draft_device_config, draft_scheduler_config, draft_device, draft_properties, false);
+
+    if (is_kv_cache_budget_shared) {
+        // each of the pipelines may grow up to the whole cache_size, as long as the other one does not use it
+        auto kv_cache_budget = std::make_shared<KVCacheBudget>(main_scheduler_config.cache_size * 1024 * 1024 * 1024);
+        m_main_pipeline->set_kv_cache_budget(kv_cache_budget, 0);
+        m_draft_pipeline->set_kv_cache_budget(kv_cache_budget, 1);
+    }
+
+    m_is_pipelined = main_scheduler_config.enable_pipelined_speculative_decoding;
+    m_draft_pipeline->set_pipelined(m_is_pipelined);
 }
 
 GenerationHandle
@@ -97,6 +134,8 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::add_request(uint64_t reques
     std::lock_guard<std::mutex> lock(m_draft_generations_mutex);
     auto draft_sampling_params = sampling_params;
     draft_sampling_params.ignore_eos = true;
+    if (sampling_params.adaptive_num_assistant_tokens)
+        m_draft_length_controller.add_request(request_id, sampling_params.num_assistant_tokens);
     m_draft_generations.insert({request_id, m_draft_pipeline->add_request(request_id, input_ids, draft_sampling_params)});
     return m_main_pipeline->add_request(request_id, input_ids, sampling_params);
 };
@@ -109,6 +148,8 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::add_request(uint64_t reques
     std::lock_guard<std::mutex> lock(m_draft_generations_mutex);
     auto draft_sampling_params = sampling_params;
     draft_sampling_params.ignore_eos = true;
+    if (sampling_params.adaptive_num_assistant_tokens)
+        m_draft_length_controller.add_request(request_id, sampling_params.num_assistant_tokens);
     m_draft_generations.insert({request_id, m_draft_pipeline->add_request(request_id, prompt, draft_sampling_params)});
     return m_main_pipeline->add_request(request_id, prompt, sampling_params);
 }
@@ -136,13 +177,26 @@ void ContinuousBatchingPipeline::SpeculativeDecodingImpl::step() {
     m_draft_pipeline->pull_awaiting_requests(true);
     m_main_pipeline->pull_awaiting_requests();
 
+    SpeculativeDecodingMetrics::StepInfo step_info;
+    const auto step_start = std::chrono::steady_clock::now();
+    step_info.start_time = step_info.draft_start_time = m_sd_metrics.get_timeline_time(step_start);
+
+    if (m_is_pipelined) {
+        pipelined_step(step_info);
+        step_info.duration = std::chrono::duration<float>(std::chrono::steady_clock::now() - step_start).count();
+        m_sd_metrics.add_step(step_info);
+        return;
+    }
+
     // generate candidates by draft model
     ManualTimer draft_timer("speculative_decoding: draft_model: multistep()");
+    m_draft_pipeline->set_draft_lengths(m_draft_length_controller.get_draft_lengths());
     draft_timer.start();
-    m_draft_pipeline->multistep();
+    size_t num_draft_steps = m_draft_pipeline->multistep();
     draft_timer.end();
     m_sd_metrics.draft_duration += draft_timer.get_duration();
     m_pipeline_metrics = m_main_pipeline->get_metrics();
+    _publish_metrics();
 
     // to generate num_matches statistic
     std::map<int64_t, UpdateRequestResult> update_sequence_info;
@@ -154,16 +208,24 @@ void ContinuousBatchingPipeline::SpeculativeDecodingImpl::step() {
     }
 
     ManualTimer main_timer("speculative_decoding: main_model: step()");
+    step_info.main_start_time = m_sd_metrics.get_timeline_time(std::chrono::steady_clock::now());
     main_timer.start();
     m_main_pipeline->step();
     main_timer.end();
     m_sd_metrics.main_duration += main_timer.get_duration();
     m_pipeline_metrics = m_main_pipeline->get_metrics();
+    _publish_metrics();
+    // blocks of requests preempted by the main model are freed in the draft model too, e.g. for the main model within the shared budget
+    m_draft_pipeline->preempt_requests(m_main_pipeline->get_preempted_request_ids());
+    if (num_draft_steps > 0)
+        m_draft_length_controller.update_durations(draft_timer.get_duration() / num_draft_steps, main_timer.get_duration());
 
     auto main_generated_requests = m_main_pipeline->get_generated_requests();
     for (const auto& checked_sequence : main_generated_requests) {
         auto update_result = m_draft_pipeline->update_request(checked_sequence.first, checked_sequence.second, true);
         update_sequence_info[checked_sequence.first].removed_tokens_cnt = update_result.removed_tokens_cnt;
+        step_info.num_rolled_back_tokens += update_result.removed_tokens_cnt;
+        step_info.num_rolled_back_kv_blocks += update_result.removed_blocks_cnt;
     }
 
     // finish draft request if the generation was completed
@@ -173,20 +235,109 @@ void ContinuousBatchingPipeline::SpeculativeDecodingImpl::step() {
             m_draft_pipeline->finish_request(request_id);
             // remove draft_generation_handle from queue
             m_draft_generations.erase(request_id);
+            m_draft_length_controller.remove_request(request_id);
         }
         auto updated_seq_info = update_sequence_info[request_id];
         // several prompt phase
         if (updated_seq_info.inserted_tokens_cnt == 0) {
             continue;
         }
+        step_info.num_proposed_tokens += updated_seq_info.inserted_tokens_cnt;
+        step_info.num_accepted_tokens += updated_seq_info.inserted_tokens_cnt - updated_seq_info.removed_tokens_cnt;
         float acceptance_rate = 1 - static_cast<float>(updated_seq_info.removed_tokens_cnt) / updated_seq_info.inserted_tokens_cnt;
         m_sd_metrics.update_acceptance_rate(request_id, acceptance_rate * 100);
         m_sd_metrics.update_draft_accepted_tokens(request_id, (updated_seq_info.inserted_tokens_cnt - updated_seq_info.removed_tokens_cnt));
+        m_draft_length_controller.update_acceptance(request_id, updated_seq_info.inserted_tokens_cnt,
+                                                    updated_seq_info.inserted_tokens_cnt - updated_seq_info.removed_tokens_cnt);
     }
 
-    if (main_generated_requests.empty() && 0) {
-        m_sd_metrics.print(true);
-        m_sd_metrics.clean_up();
+    step_info.num_requests = draft_generated_requests.size();
+    step_info.num_draft_steps = num_draft_steps;
+    step_info.draft_duration = draft_timer.get_duration();
+    step_info.main_duration = main_timer.get_duration();
+    step_info.duration = std::chrono::duration<float>(std::chrono::steady_clock::now() - step_start).count();
+    m_sd_metrics.add_step(step_info);
+}
+
+void ContinuousBatchingPipeline::SpeculativeDecodingImpl::pipelined_step(SpeculativeDecodingMetrics::StepInfo& step_info) {
+    // the main model validates candidates inserted by the previous step, while the draft model continues its own sequences, i.e.
+    // drafts the next candidates assuming that the current ones and the token sampled by the main model after them are accepted
+    m_draft_pipeline->set_draft_lengths(m_draft_length_controller.get_draft_lengths());
+    ManualTimer draft_timer("speculative_decoding: draft_model: multistep()");
+    std::future<size_t> num_draft_steps = std::async(std::launch::async, [this, &draft_timer] {
+        draft_timer.start();
+        size_t num_steps = m_draft_pipeline->multistep();
+        draft_timer.end();
+        return num_steps;
+    });
+
+    ManualTimer main_timer("speculative_decoding: main_model: step()");
+    step_info.main_start_time = step_info.draft_start_time;
+    main_timer.start();
+    try {
+        m_main_pipeline->step();
+    } catch (...) {
+        num_draft_steps.wait();
+        throw;
+    }
+    main_timer.end();
+    const size_t num_steps = num_draft_steps.get();
+    // preempted after the draft model finished its steps, since it runs in another thread
+    m_draft_pipeline->preempt_requests(m_main_pipeline->get_preempted_request_ids());
+    m_sd_metrics.draft_duration += draft_timer.get_duration();
+    m_sd_metrics.main_duration += main_timer.get_duration();
+    m_pipeline_metrics = m_main_pipeline->get_metrics();
+    _publish_metrics();
+    step_info.num_draft_steps = num_steps;
+    step_info.draft_duration = draft_timer.get_duration();
+    step_info.main_duration = main_timer.get_duration();
+    if (num_steps > 0)
+        m_draft_length_controller.update_durations(draft_timer.get_duration() / num_steps, main_timer.get_duration());
+
+    auto get_generated_len = [] (const GeneratedSequences& sequences) -> size_t {
+        return sequences.empty() ? 0 : sequences.begin()->second.token_ids.size();
+    };
+
+    // draft sequences diverged from validated tokens are rolled back to them, the others keep tokens drafted ahead
+    auto main_generated_requests = m_main_pipeline->get_generated_requests();
+    step_info.num_requests = main_generated_requests.size();
+    for (const auto& checked_sequence : main_generated_requests) {
+        auto update_result = m_draft_pipeline->update_request(checked_sequence.first, checked_sequence.second, true);
+        step_info.num_rolled_back_tokens += update_result.removed_tokens_cnt;
+        step_info.num_rolled_back_kv_blocks += update_result.removed_blocks_cnt;
+    }
+
+    for (const auto& [request_id, pending_candidates] : m_pending_candidates) {
+        const auto [num_inserted_tokens, prev_generated_len] = pending_candidates;
+        if (num_inserted_tokens == 0)
+            continue;
+        // the main model appends accepted candidates and one token sampled by itself
+        size_t num_accepted_tokens = num_inserted_tokens;
+        if (main_generated_requests.count(request_id)) {
+            const size_t generated_len = get_generated_len(main_generated_requests.at(request_id));
+            num_accepted_tokens = generated_len > prev_generated_len ? std::min(generated_len - prev_generated_len - 1, num_inserted_tokens) : 0;
+        }
+        step_info.num_proposed_tokens += num_inserted_tokens;
+        step_info.num_accepted_tokens += num_accepted_tokens;
+        m_sd_metrics.update_acceptance_rate(request_id, 100.f * num_accepted_tokens / num_inserted_tokens);
+        m_sd_metrics.update_draft_accepted_tokens(request_id, num_accepted_tokens);
+        m_draft_length_controller.update_acceptance(request_id, num_inserted_tokens, num_accepted_tokens);
+    }
+    m_pending_candidates.clear();
+
+    // put candidates drafted ahead to model KV cache to be validated by the next step
+    for (const auto& candidate : m_draft_pipeline->get_generated_requests()) {
+        const auto request_id = candidate.first;
+        if (!main_generated_requests.count(request_id)) {
+            // finish draft request if the generation was completed
+            m_draft_pipeline->finish_request(request_id);
+            m_draft_generations.erase(request_id);
+            m_draft_length_controller.remove_request(request_id);
+            continue;
+        }
+        const size_t generated_len = get_generated_len(main_generated_requests.at(request_id));
+        auto update_result = m_main_pipeline->update_request(request_id, candidate.second, false);
+        m_pending_candidates.insert({request_id, {update_result.inserted_tokens_cnt, generated_len}});
     }
 }
 
@@ -223,6 +374,8 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::generate(const std::vector<
         // set the parameters do not stop draft generation without stopping of the same request for main pipeline
         draft_sampling_params.ignore_eos = true;
         std::lock_guard<std::mutex> lock(m_draft_generations_mutex);
+        if (sampling_params[request_id].adaptive_num_assistant_tokens)
+            m_draft_length_controller.add_request(request_id, sampling_params[request_id].num_assistant_tokens);
         m_draft_generations.insert({request_id, m_draft_pipeline->add_request(request_id, input_ids[request_id], draft_sampling_params)});
     }
 
@@ -267,11 +420,13 @@ ContinuousBatchingPipeline::SpeculativeDecodingImpl::generate(const std::vector<
             result.m_scores.push_back(generation_output.score);
         }
         result.m_status = generation->get_status();
+        result.m_timings = generation->get_timings();
         results.push_back(std::move(result));
     }
 
     OPENVINO_ASSERT(results.size() == input_ids.size());
     generate_timer.end();
+    m_sd_metrics.write_timeline_if_requested();
     return results;
 }
 
@@ -6,6 +6,7 @@
 #include "openvino/genai/continuous_batching_pipeline.hpp"
 #include "continuous_batching_impl.hpp"
 #include "continuous_batching_for_speculative_decoding_impl.hpp"
+#include "speculative_decoding/draft_length_controller.hpp"
 #include "speculative_decoding/speculative_decoding_metrics.hpp"
 
 namespace ov::genai {
@@ -17,6 +18,8 @@ struct ModelDesc {
     ov::genai::GenerationConfig generation_config;
     std::shared_ptr<ov::Model> model = nullptr;
     ov::genai::Tokenizer tokenizer;
+    // if non-zero, only this number of first decoder layers of the model is used, followed by its final norm and LM head
+    size_t num_early_exit_layers = 0;
 
     ModelDesc(const std::shared_ptr<ov::Model>& model,
               const ov::genai::Tokenizer& tokenizer,
@@ -41,6 +44,14 @@ protected:
     // Mutex protecting access to m_draft_generations, so add_request and step methods can be called from different threads
     std::mutex m_draft_generations_mutex;
     std::map<uint64_t, GenerationHandle> m_draft_generations;
+    // draft lengths of requests with GenerationConfig::adaptive_num_assistant_tokens, protected by m_draft_generations_mutex as well
+    DraftLengthController m_draft_length_controller;
+    // whether draft candidates of the next step are generated while the main model validates the current ones
+    bool m_is_pipelined = false;
+    // { request_id, { number of candidates inserted to the main model, number of tokens generated before them } }, in pipelined mode
+    std::map<uint64_t, std::pair<size_t, size_t>> m_pending_candidates;
+
+    void pipelined_step(SpeculativeDecodingMetrics::StepInfo& step_info);
     
 public:
     SpeculativeDecodingImpl(const ov::genai::ModelDesc& main_model_desc, const ov::genai::ModelDesc& draft_model_desc);
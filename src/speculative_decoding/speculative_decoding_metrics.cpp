@@ -1,7 +1,10 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdlib>
+#include <fstream>
 #include <numeric>
+#include <nlohmann/json.hpp>
 
 #include "speculative_decoding/speculative_decoding_metrics.hpp"
 #include "openvino/runtime/exception.hpp"
@@ -145,6 +148,78 @@ void SpeculativeDecodingMetrics::print(bool is_printing_per_request) {
 
 }
 
+float SpeculativeDecodingMetrics::get_timeline_time(std::chrono::steady_clock::time_point time_point) const {
+    return std::chrono::duration<float>(time_point - m_timeline_origin).count();
+}
+
+void SpeculativeDecodingMetrics::add_step(const StepInfo& step) {
+    if (m_is_recording_steps)
+        m_steps.push_back(step);
+}
+
+const std::vector<SpeculativeDecodingMetrics::StepInfo>& SpeculativeDecodingMetrics::get_steps() const {
+    return m_steps;
+}
+
+void SpeculativeDecodingMetrics::write_timeline(const std::filesystem::path& path) const {
+    // trace events use microseconds
+    auto to_us = [] (float seconds) {
+        return static_cast<int64_t>(seconds * 1e6f);
+    };
+    nlohmann::ordered_json events = nlohmann::ordered_json::array(), steps = nlohmann::ordered_json::array();
+    const std::pair<int, const char*> threads[] = {{0, "step"}, {1, "draft model"}, {2, "main model"}};
+    for (const auto& [tid, name] : threads) {
+        events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", tid}, {"args", {{"name", name}}}});
+    }
+    for (size_t step_id = 0; step_id < m_steps.size(); ++step_id) {
+        const StepInfo& step = m_steps[step_id];
+        nlohmann::ordered_json counts = {
+            {"num_requests", step.num_requests},
+            {"num_draft_steps", step.num_draft_steps},
+            {"num_proposed_tokens", step.num_proposed_tokens},
+            {"num_accepted_tokens", step.num_accepted_tokens},
+            {"num_rolled_back_tokens", step.num_rolled_back_tokens},
+            {"num_rolled_back_kv_blocks", step.num_rolled_back_kv_blocks}
+        };
+        events.push_back({{"name", "step " + std::to_string(step_id)}, {"ph", "X"}, {"pid", 0}, {"tid", 0},
+                          {"ts", to_us(step.start_time)}, {"dur", to_us(step.duration)}, {"args", counts}});
+        events.push_back({{"name", "draft"}, {"ph", "X"}, {"pid", 0}, {"tid", 1},
+                          {"ts", to_us(step.draft_start_time)}, {"dur", to_us(step.draft_duration)}});
+        events.push_back({{"name", "main"}, {"ph", "X"}, {"pid", 0}, {"tid", 2},
+                          {"ts", to_us(step.main_start_time)}, {"dur", to_us(step.main_duration)}});
+        events.push_back({{"name", "tokens"}, {"ph", "C"}, {"pid", 0}, {"ts", to_us(step.start_time)},
+                          {"args", {{"proposed", step.num_proposed_tokens}, {"accepted", step.num_accepted_tokens},
+                                    {"rolled back", step.num_rolled_back_tokens}}}});
+        events.push_back({{"name", "requests"}, {"ph", "C"}, {"pid", 0}, {"ts", to_us(step.start_time)},
+                          {"args", {{"requests", step.num_requests}}}});
+
+        nlohmann::ordered_json record = {
+            {"start_time", step.start_time},
+            {"duration", step.duration},
+            {"draft_start_time", step.draft_start_time},
+            {"draft_duration", step.draft_duration},
+            {"main_start_time", step.main_start_time},
+            {"main_duration", step.main_duration}
+        };
+        record.update(counts);
+        steps.push_back(record);
+    }
+
+    std::ofstream file(path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", path.string(), " to write speculative decoding timeline");
+    file << nlohmann::ordered_json{{"traceEvents", events}, {"displayTimeUnit", "ms"}, {"steps", steps}}.dump(1);
+}
+
+const char* SpeculativeDecodingMetrics::get_timeline_path() {
+    const char* timeline_path = std::getenv("OPENVINO_GENAI_SD_TIMELINE");
+    return timeline_path != nullptr && timeline_path[0] != '\0' ? timeline_path : nullptr;
+}
+
+void SpeculativeDecodingMetrics::write_timeline_if_requested() const {
+    if (const char* timeline_path = get_timeline_path())
+        write_timeline(timeline_path);
+}
+
 void SpeculativeDecodingMetrics::clean_up() {
     m_acceptance_rate.clear();
     m_draft_accepted_tokens.clear();
@@ -152,6 +227,8 @@ void SpeculativeDecodingMetrics::clean_up() {
     draft_duration = 0;
     main_duration = 0;
     total_duration = 0;
+    m_steps.clear();
+    m_timeline_origin = std::chrono::steady_clock::now();
 }
 
 }
\ No newline at end of file
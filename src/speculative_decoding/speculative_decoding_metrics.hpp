@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <chrono>
+#include <filesystem>
 #include <map>
 
 namespace ov::genai {
@@ -17,6 +18,26 @@ class SpeculativeDecodingMetrics {
     std::map<int64_t, size_t> m_draft_accepted_tokens;
     std::map<int64_t, size_t> m_generated_len;
 
+public:
+    // a single step of speculative decoding, times are in seconds since the timeline origin, durations are in seconds
+    struct StepInfo {
+        float start_time = 0, duration = 0;
+        float draft_start_time = 0, draft_duration = 0;
+        float main_start_time = 0, main_duration = 0;
+        size_t num_requests = 0, num_draft_steps = 0;
+        // candidates inserted to the main model, validated by it and removed from the draft model after validation
+        size_t num_proposed_tokens = 0, num_accepted_tokens = 0, num_rolled_back_tokens = 0, num_rolled_back_kv_blocks = 0;
+    };
+
+private:
+    std::chrono::steady_clock::time_point m_timeline_origin = std::chrono::steady_clock::now();
+    // steps are recorded only if the timeline is requested, since their number grows with every step of a long-running pipeline
+    bool m_is_recording_steps = get_timeline_path() != nullptr;
+    std::vector<StepInfo> m_steps;
+
+    // path given by OPENVINO_GENAI_SD_TIMELINE environment variable or nullptr if it is not set
+    static const char* get_timeline_path();
+
 public:
     float draft_duration = 0, main_duration = 0, total_duration = 0;
 
@@ -41,6 +62,34 @@ public:
     void print_acceptance_rates();
     void print(bool is_printing_per_request = false);
 
+    /**
+     * @return Seconds passed since the timeline origin, i.e. creation of the metrics or the last clean_up.
+     */
+    float get_timeline_time(std::chrono::steady_clock::time_point time_point) const;
+    // does nothing unless steps are recorded, see set_recording_steps
+    void add_step(const StepInfo& step);
+    const std::vector<StepInfo>& get_steps() const;
+
+    /**
+     * Enables recording of steps, which is enabled by default only if OPENVINO_GENAI_SD_TIMELINE environment variable is set.
+     */
+    void set_recording_steps(bool is_recording_steps) {
+        m_is_recording_steps = is_recording_steps;
+    }
+
+    /**
+     * Writes the timeline of steps to a JSON file in Chrome trace event format, which can be opened by chrome://tracing or Perfetto.
+     * Steps, draft and main model inference are duration events, token counts and number of requests are counter events,
+     * while "steps" array holds records of all steps as they are.
+     * @param path Path to the file to be written.
+     */
+    void write_timeline(const std::filesystem::path& path) const;
+
+    /**
+     * Writes the timeline to a file given by OPENVINO_GENAI_SD_TIMELINE environment variable, does nothing if it is not set.
+     */
+    void write_timeline_if_requested() const;
+
     void clean_up();
 };
 }
\ No newline at end of file
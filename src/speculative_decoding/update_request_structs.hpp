@@ -19,6 +19,8 @@ struct GeneratedSequence {
 
 struct UpdateRequestResult {
     size_t inserted_tokens_cnt, removed_tokens_cnt;
+    // number of KV cache blocks of all sequences, which are not needed anymore after tokens are removed
+    size_t removed_blocks_cnt = 0;
 
     UpdateRequestResult(size_t to_insert = 0, size_t to_remove = 0) :
         inserted_tokens_cnt(to_insert),
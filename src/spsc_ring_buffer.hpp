@@ -0,0 +1,66 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <utility>
+
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+// Bounded single producer / single consumer queue, where neither side ever blocks or takes a lock.
+// T must be default constructible.
+template <typename T>
+class SPSCRingBuffer
+{
+    std::vector<T> m_slots;
+    // positions grow monotonically and are mapped to slots modulo capacity
+    // indices are kept on different cache lines, so that the producer and the consumer do not invalidate each other's cache
+    alignas(64) std::atomic<size_t> m_read_pos{0};
+    alignas(64) std::atomic<size_t> m_write_pos{0};
+
+public:
+    explicit SPSCRingBuffer(size_t capacity) : m_slots(capacity) {
+        OPENVINO_ASSERT(capacity > 0, "Ring buffer capacity must be non-zero");
+    }
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    // must be called from the producer thread only
+    // returns false if the buffer is full, the value is moved from only if it is pushed, so that the caller can store it elsewhere
+    bool try_push(T&& value) {
+        size_t write_pos = m_write_pos.load(std::memory_order_relaxed);
+        if (write_pos - m_read_pos.load(std::memory_order_acquire) == m_slots.size())
+            return false;
+        m_slots[write_pos % m_slots.size()] = std::move(value);
+        m_write_pos.store(write_pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // must be called from the consumer thread only
+    // returns false if the buffer is empty
+    bool try_pop(T& value) {
+        size_t read_pos = m_read_pos.load(std::memory_order_relaxed);
+        if (read_pos == m_write_pos.load(std::memory_order_acquire))
+            return false;
+        T& slot = m_slots[read_pos % m_slots.size()];
+        value = std::move(slot);
+        slot = T{};
+        m_read_pos.store(read_pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // can be called from any thread
+    bool empty() const {
+        return m_read_pos.load(std::memory_order_acquire) == m_write_pos.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return m_slots.size();
+    }
+};
+
+}
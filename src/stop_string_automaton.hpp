@@ -0,0 +1,121 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ov::genai {
+
+// Aho-Corasick automaton over bytes of stop strings, which tells whether the text of the last generated tokens may
+// contain a stop string. It's used as a filter in front of the exact match, which detokenizes a window of tokens.
+// Texts of tokens decoded one by one may differ from the text of the decoded window by whitespaces only (e.g. SentencePiece
+// leading spaces or cleaned up spaces before punctuation), so whitespaces are skipped both in stop strings and in token texts.
+class StopStringAutomaton {
+    static constexpr size_t ALPHABET_SIZE = 256;
+
+    // transitions of the deterministic automaton, state 0 is the root
+    std::vector<std::array<int32_t, ALPHABET_SIZE>> m_transitions;
+    // whether a state ends (with a suffix link chain) any stop string
+    std::vector<bool> m_is_terminal;
+    // stop strings consisting of whitespaces only cannot be filtered
+    bool m_is_enabled = false;
+
+    static bool is_whitespace(unsigned char byte) {
+        return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r' || byte == '\v' || byte == '\f';
+    }
+
+    int32_t add_state() {
+        m_transitions.emplace_back();
+        m_transitions.back().fill(-1);
+        m_is_terminal.push_back(false);
+        return static_cast<int32_t>(m_transitions.size() - 1);
+    }
+
+public:
+    StopStringAutomaton() = default;
+
+    explicit StopStringAutomaton(const std::set<std::string>& stop_strings) {
+        add_state();
+        m_is_enabled = !stop_strings.empty();
+        for (const auto& stop_string : stop_strings) {
+            int32_t state = 0;
+            for (unsigned char byte : stop_string) {
+                if (is_whitespace(byte))
+                    continue;
+                if (m_transitions[state][byte] < 0) {
+                    int32_t next_state = add_state();
+                    m_transitions[state][byte] = next_state;
+                }
+                state = m_transitions[state][byte];
+            }
+            if (state == 0) {
+                m_is_enabled = false;
+                return;
+            }
+            m_is_terminal[state] = true;
+        }
+
+        // breadth-first construction of suffix links, which are folded into transitions
+        std::vector<int32_t> suffix_links(m_transitions.size(), 0);
+        std::queue<int32_t> states;
+        for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+            int32_t& next_state = m_transitions[0][byte];
+            if (next_state < 0) {
+                next_state = 0;
+            } else {
+                suffix_links[next_state] = 0;
+                states.push(next_state);
+            }
+        }
+        while (!states.empty()) {
+            int32_t state = states.front();
+            states.pop();
+            m_is_terminal[state] = m_is_terminal[state] || m_is_terminal[suffix_links[state]];
+            for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+                int32_t& next_state = m_transitions[state][byte];
+                if (next_state < 0) {
+                    next_state = m_transitions[suffix_links[state]][byte];
+                } else {
+                    suffix_links[next_state] = m_transitions[suffix_links[state]][byte];
+                    states.push(next_state);
+                }
+            }
+        }
+    }
+
+    /**
+     * @param tokens Generated tokens.
+     * @param window_size Number of last tokens, which the exact match decodes.
+     * @param get_token_text Callable returning a text of a single token.
+     * @return False if the last window_size tokens certainly do not contain any stop string, true if the exact match is needed.
+     */
+    template <typename GetTokenText>
+    bool may_match(const std::vector<int64_t>& tokens, size_t window_size, GetTokenText&& get_token_text) const {
+        if (!m_is_enabled)
+            return true;
+        size_t begin = tokens.size() > window_size ? tokens.size() - window_size : 0;
+        int32_t state = 0;
+        for (size_t i = begin; i < tokens.size(); ++i) {
+            const std::string& text = get_token_text(tokens[i]);
+            // incomplete UTF-8 sequences decoded alone are replaced by U+FFFD, while they are valid within the window
+            if (text.find("\xEF\xBF\xBD") != std::string::npos)
+                return true;
+            for (unsigned char byte : text) {
+                if (is_whitespace(byte))
+                    continue;
+                state = m_transitions[state][byte];
+                if (m_is_terminal[state])
+                    return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
@@ -0,0 +1,180 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "structured_output/json_schema.hpp"
+
+#include <cstring>
+#include <limits>
+#include <set>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+namespace {
+
+// a single optional space is allowed between JSON tokens, so that a model is not able to loop on whitespaces
+const std::string WHITESPACE = "[ ]?";
+const std::string STRING_CHARACTER = R"(([^"\\\x00-\x1F]|\\["\\/bfnrt]|\\u[0-9a-fA-F]{4}))";
+const std::string INTEGER = R"(-?(0|[1-9][0-9]*))";
+const std::string NUMBER = R"(-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?)";
+// $ref chains and nesting deeper than this are treated as recursive schemas, which cannot be expressed by a regular expression
+const size_t MAX_DEPTH = 32;
+
+std::string escape_regex(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (std::strchr("\\^$.|?*+()[]{}", c) != nullptr && c != '\0')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+std::string alternation(const std::vector<std::string>& branches) {
+    OPENVINO_ASSERT(!branches.empty(), "JSON schema alternatives must not be empty");
+    std::string result = "(";
+    for (size_t i = 0; i < branches.size(); ++i)
+        result += (i > 0 ? "|" : "") + branches[i];
+    return result + ")";
+}
+
+std::string repetition(const std::string& regex, size_t min, size_t max) {
+    if (max == std::numeric_limits<size_t>::max())
+        return "(" + regex + "){" + std::to_string(min) + ",}";
+    return "(" + regex + "){" + std::to_string(min) + "," + std::to_string(max) + "}";
+}
+
+class JSONSchemaConverter {
+    const nlohmann::ordered_json& m_root;
+
+    const nlohmann::ordered_json& resolve_reference(const std::string& reference) const {
+        OPENVINO_ASSERT(!reference.empty() && reference[0] == '#', "Only local $ref are supported in JSON schema, got '", reference, "'");
+        const nlohmann::ordered_json::json_pointer pointer(reference.substr(1));
+        OPENVINO_ASSERT(m_root.contains(pointer), "Unresolved $ref '", reference, "' in JSON schema");
+        return m_root.at(pointer);
+    }
+
+    std::string convert_string(const nlohmann::ordered_json& schema) const {
+        if (schema.contains("pattern")) {
+            std::string pattern = schema["pattern"].get<std::string>();
+            // the pattern is matched against the whole string value
+            return "\"(" + pattern + ")\"";
+        }
+        size_t min_length = schema.value("minLength", size_t(0));
+        size_t max_length = schema.value("maxLength", std::numeric_limits<size_t>::max());
+        if (min_length == 0 && max_length == std::numeric_limits<size_t>::max())
+            return "\"" + STRING_CHARACTER + "*\"";
+        return "\"" + repetition(STRING_CHARACTER, min_length, max_length) + "\"";
+    }
+
+    std::string convert_array(const nlohmann::ordered_json& schema, size_t depth) const {
+        OPENVINO_ASSERT(schema.contains("items"), "JSON schema of an array must define 'items'");
+        std::string item = convert(schema["items"], depth + 1);
+        size_t min_items = schema.value("minItems", size_t(0));
+        size_t max_items = schema.value("maxItems", std::numeric_limits<size_t>::max());
+        OPENVINO_ASSERT(min_items <= max_items, "minItems must not be greater than maxItems in JSON schema");
+        if (max_items == 0)
+            return "\\[" + WHITESPACE + "\\]";
+        std::string separated_item = "," + WHITESPACE + item;
+        size_t min_rest = min_items > 0 ? min_items - 1 : 0;
+        size_t max_rest = max_items == std::numeric_limits<size_t>::max() ? max_items : max_items - 1;
+        std::string items = item + repetition(separated_item, min_rest, max_rest);
+        if (min_items == 0)
+            items = "(" + items + ")?";
+        return "\\[" + WHITESPACE + items + WHITESPACE + "\\]";
+    }
+
+    std::string convert_object(const nlohmann::ordered_json& schema, size_t depth) const {
+        std::vector<std::string> properties;
+        std::vector<bool> is_required;
+        std::set<std::string> required;
+        if (schema.contains("required"))
+            required = schema["required"].get<std::set<std::string>>();
+        if (schema.contains("properties")) {
+            for (const auto& [name, property_schema] : schema["properties"].items()) {
+                properties.push_back(escape_regex(nlohmann::ordered_json(name).dump()) + WHITESPACE + ":" + WHITESPACE + convert(property_schema, depth + 1));
+                is_required.push_back(required.count(name) > 0);
+            }
+        }
+        // properties starting from i-th, preceded by an already emitted property (with_comma) or not (without_comma);
+        // optional properties may be skipped, so a comma is emitted only between two emitted properties
+        std::vector<std::string> with_comma(properties.size() + 1), without_comma(properties.size() + 1);
+        for (size_t i = properties.size(); i-- > 0;) {
+            std::string separated = "," + WHITESPACE + properties[i];
+            with_comma[i] = (is_required[i] ? separated : "(" + separated + ")?") + with_comma[i + 1];
+            std::string first = properties[i] + with_comma[i + 1];
+            without_comma[i] = is_required[i] ? first : alternation({first, without_comma[i + 1]});
+        }
+        return "\\{" + WHITESPACE + without_comma[0] + WHITESPACE + "\\}";
+    }
+
+    std::string convert_type(const nlohmann::ordered_json& schema, const std::string& type, size_t depth) const {
+        if (type == "string")
+            return convert_string(schema);
+        if (type == "integer")
+            return INTEGER;
+        if (type == "number")
+            return NUMBER;
+        if (type == "boolean")
+            return "(true|false)";
+        if (type == "null")
+            return "null";
+        if (type == "array")
+            return convert_array(schema, depth);
+        if (type == "object")
+            return convert_object(schema, depth);
+        OPENVINO_THROW("Unsupported type '", type, "' in JSON schema");
+    }
+
+public:
+    explicit JSONSchemaConverter(const nlohmann::ordered_json& root) : m_root(root) {}
+
+    std::string convert(const nlohmann::ordered_json& schema, size_t depth = 0) const {
+        OPENVINO_ASSERT(depth < MAX_DEPTH, "JSON schema is too deep or recursive");
+        OPENVINO_ASSERT(schema.is_object(), "JSON schema must be an object, got ", schema.dump());
+        if (schema.contains("$ref"))
+            return convert(resolve_reference(schema["$ref"].get<std::string>()), depth + 1);
+        if (schema.contains("const"))
+            return escape_regex(schema["const"].dump());
+        if (schema.contains("enum")) {
+            std::vector<std::string> values;
+            for (const auto& value : schema["enum"])
+                values.push_back(escape_regex(value.dump()));
+            return alternation(values);
+        }
+        for (const char* keyword : {"anyOf", "oneOf"}) {
+            if (schema.contains(keyword)) {
+                std::vector<std::string> branches;
+                for (const auto& branch : schema[keyword])
+                    branches.push_back(convert(branch, depth + 1));
+                return alternation(branches);
+            }
+        }
+        if (schema.contains("type")) {
+            const auto& type = schema["type"];
+            if (type.is_string())
+                return convert_type(schema, type.get<std::string>(), depth);
+            std::vector<std::string> branches;
+            for (const auto& single_type : type)
+                branches.push_back(convert_type(schema, single_type.get<std::string>(), depth));
+            return alternation(branches);
+        }
+        if (schema.contains("properties"))
+            return convert_object(schema, depth);
+        if (schema.contains("items"))
+            return convert_array(schema, depth);
+        OPENVINO_THROW("JSON schema must define one of 'type', 'enum', 'const', 'anyOf', 'oneOf' or '$ref', got ", schema.dump());
+    }
+};
+
+}  // namespace
+
+std::string json_schema_to_regex(const std::string& json_schema) {
+    nlohmann::ordered_json schema = nlohmann::ordered_json::parse(json_schema);
+    return JSONSchemaConverter(schema).convert(schema);
+}
+
+}
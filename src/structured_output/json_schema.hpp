@@ -0,0 +1,20 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+
+namespace ov::genai {
+
+/**
+ * Converts JSON schema to a regular expression matching compact JSON documents valid against the schema, which is accepted by RegexAutomaton.
+ * Supported keywords: type (object, array, string, integer, number, boolean, null or a list of them), properties, required, items,
+ * minItems, maxItems, minLength, maxLength, pattern, enum, const, anyOf, oneOf and local $ref.
+ * Properties of objects are generated in the order they are declared, additional properties are not generated.
+ * @param json_schema JSON schema serialized to a string.
+ * @return Regular expression.
+ */
+std::string json_schema_to_regex(const std::string& json_schema);
+
+}
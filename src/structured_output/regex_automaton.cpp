@@ -0,0 +1,414 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "structured_output/regex_automaton.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <limits>
+#include <map>
+#include <queue>
+
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+namespace {
+
+using ByteSet = std::bitset<256>;
+
+// Thompson's construction: each state has either epsilon edges or a single edge over a set of bytes
+struct NFA {
+    // nested counted repetitions multiply the number of states, e.g. ((a{1000}){1000}){1000}, so it is bounded before DFA is built
+    static constexpr size_t MAX_NUM_STATES = 100000;
+
+    struct State {
+        std::vector<size_t> epsilon_edges;
+        ByteSet bytes;
+        size_t next = std::numeric_limits<size_t>::max();
+    };
+    std::vector<State> states;
+
+    size_t add_state() {
+        OPENVINO_ASSERT(states.size() < MAX_NUM_STATES, "Regular expression requires more than ", MAX_NUM_STATES, " NFA states");
+        states.emplace_back();
+        return states.size() - 1;
+    }
+};
+
+// a part of NFA with a single entry and a single exit state, the exit state has no outgoing edges yet
+struct Fragment {
+    size_t start, end;
+};
+
+class RegexParser {
+    static constexpr size_t MAX_REPETITIONS = 1000;
+    static constexpr size_t INFINITE_REPETITIONS = std::numeric_limits<size_t>::max();
+
+    const std::string& m_pattern;
+    size_t m_pos = 0;
+    NFA& m_nfa;
+
+    bool at_end() const {
+        return m_pos >= m_pattern.size();
+    }
+
+    char peek() const {
+        return m_pattern[m_pos];
+    }
+
+    char get() {
+        OPENVINO_ASSERT(!at_end(), "Unexpected end of regular expression '", m_pattern, "'");
+        return m_pattern[m_pos++];
+    }
+
+    void expect(char c) {
+        OPENVINO_ASSERT(!at_end() && peek() == c, "Expected '", c, "' at position ", m_pos, " of regular expression '", m_pattern, "'");
+        ++m_pos;
+    }
+
+    Fragment empty() {
+        size_t state = m_nfa.add_state();
+        return {state, state};
+    }
+
+    Fragment bytes(const ByteSet& bytes) {
+        size_t start = m_nfa.add_state(), end = m_nfa.add_state();
+        m_nfa.states[start].bytes = bytes;
+        m_nfa.states[start].next = end;
+        return {start, end};
+    }
+
+    void append(Fragment& fragment, const Fragment& other) {
+        m_nfa.states[fragment.end].epsilon_edges.push_back(other.start);
+        fragment.end = other.end;
+    }
+
+    static ByteSet range(uint8_t first, uint8_t last) {
+        ByteSet result;
+        for (size_t byte = first; byte <= last; ++byte)
+            result.set(byte);
+        return result;
+    }
+
+    static uint8_t parse_hex_digit(char c) {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        OPENVINO_THROW("Invalid hexadecimal digit '", c, "' in regular expression");
+    }
+
+    // parses an escape sequence after '\', which stands for a set of bytes
+    ByteSet parse_escape() {
+        char c = get();
+        switch (c) {
+        case 'd': return range('0', '9');
+        case 'D': return ~range('0', '9');
+        case 'w': return range('a', 'z') | range('A', 'Z') | range('0', '9') | range('_', '_');
+        case 'W': return ~(range('a', 'z') | range('A', 'Z') | range('0', '9') | range('_', '_'));
+        case 's': return range(' ', ' ') | range('\t', '\r');
+        case 'S': return ~(range(' ', ' ') | range('\t', '\r'));
+        case 'n': return range('\n', '\n');
+        case 't': return range('\t', '\t');
+        case 'r': return range('\r', '\r');
+        case 'f': return range('\f', '\f');
+        case 'v': return range('\v', '\v');
+        case '0': return range(0, 0);
+        case 'x': {
+            uint8_t high = parse_hex_digit(get());
+            uint8_t low = parse_hex_digit(get());
+            uint8_t byte = high * 16 + low;
+            return range(byte, byte);
+        }
+        default:
+            OPENVINO_ASSERT(!std::isalnum(static_cast<unsigned char>(c)), "Unsupported escape sequence '\\", c, "' in regular expression '", m_pattern, "'");
+            return range(c, c);
+        }
+    }
+
+    ByteSet parse_class() {
+        bool is_negated = !at_end() && peek() == '^';
+        if (is_negated)
+            ++m_pos;
+        ByteSet result;
+        for (bool is_first = true; ; is_first = false) {
+            OPENVINO_ASSERT(!at_end(), "Unterminated character class in regular expression '", m_pattern, "'");
+            if (!is_first && peek() == ']')
+                break;
+            ByteSet item;
+            uint8_t first = get();
+            if (first == '\\') {
+                item = parse_escape();
+                // a range starts only from a single character
+                if (item.count() != 1) {
+                    result |= item;
+                    continue;
+                }
+                for (size_t byte = 0; byte < item.size(); ++byte)
+                    if (item.test(byte))
+                        first = byte;
+            }
+            OPENVINO_ASSERT(first < 0x80, "Non-ASCII characters in character classes are not supported in regular expression '", m_pattern, "'");
+            uint8_t last = first;
+            if (m_pos + 1 < m_pattern.size() && peek() == '-' && m_pattern[m_pos + 1] != ']') {
+                ++m_pos;
+                last = get();
+                if (last == '\\') {
+                    ByteSet last_item = parse_escape();
+                    OPENVINO_ASSERT(last_item.count() == 1, "Invalid range in character class of regular expression '", m_pattern, "'");
+                    for (size_t byte = 0; byte < last_item.size(); ++byte)
+                        if (last_item.test(byte))
+                            last = byte;
+                }
+                OPENVINO_ASSERT(first <= last && last < 0x80, "Invalid range in character class of regular expression '", m_pattern, "'");
+            }
+            result |= range(first, last);
+        }
+        expect(']');
+        return is_negated ? ~result : result;
+    }
+
+    Fragment parse_atom() {
+        char c = get();
+        switch (c) {
+        case '(': {
+            if (m_pos + 1 < m_pattern.size() && peek() == '?' && m_pattern[m_pos + 1] == ':')
+                m_pos += 2;
+            Fragment fragment = parse_alternation();
+            expect(')');
+            return fragment;
+        }
+        case '[':
+            return bytes(parse_class());
+        case '.':
+            return bytes(~range('\n', '\n'));
+        case '\\':
+            return bytes(parse_escape());
+        case '^':
+        case '$':
+            return empty();
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case ')':
+            OPENVINO_THROW("Unexpected '", c, "' at position ", m_pos - 1, " of regular expression '", m_pattern, "'");
+        default:
+            return bytes(range(c, c));
+        }
+    }
+
+    size_t parse_number() {
+        OPENVINO_ASSERT(!at_end() && std::isdigit(static_cast<unsigned char>(peek())), "Expected a number at position ", m_pos, " of regular expression '", m_pattern, "'");
+        size_t number = 0;
+        while (!at_end() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            number = number * 10 + (get() - '0');
+            OPENVINO_ASSERT(number <= MAX_REPETITIONS, "Too many repetitions in regular expression '", m_pattern, "'");
+        }
+        return number;
+    }
+
+    // parses an optional quantifier, returns {min, max} number of repetitions
+    std::pair<size_t, size_t> parse_quantifier() {
+        if (at_end())
+            return {1, 1};
+        switch (peek()) {
+        case '*': ++m_pos; return {0, INFINITE_REPETITIONS};
+        case '+': ++m_pos; return {1, INFINITE_REPETITIONS};
+        case '?': ++m_pos; return {0, 1};
+        case '{': {
+            ++m_pos;
+            size_t min = parse_number(), max = min;
+            if (!at_end() && peek() == ',') {
+                ++m_pos;
+                max = !at_end() && peek() == '}' ? INFINITE_REPETITIONS : parse_number();
+            }
+            expect('}');
+            OPENVINO_ASSERT(min <= max, "Invalid repetition range in regular expression '", m_pattern, "'");
+            return {min, max};
+        }
+        default:
+            return {1, 1};
+        }
+    }
+
+    Fragment parse_repetition() {
+        size_t atom_begin = m_pos;
+        Fragment atom = parse_atom();
+        auto [min, max] = parse_quantifier();
+        if (min == 1 && max == 1)
+            return atom;
+        size_t quantifier_end = m_pos;
+
+        // each repetition is a separate copy of the atom, so the atom is parsed again
+        auto copy_atom = [&] () {
+            m_pos = atom_begin;
+            return parse_atom();
+        };
+        Fragment result = empty();
+        for (size_t i = 0; i < min; ++i)
+            append(result, i == 0 ? atom : copy_atom());
+        if (max == INFINITE_REPETITIONS) {
+            Fragment loop = min == 0 ? atom : copy_atom();
+            Fragment star = empty();
+            m_nfa.states[star.start].epsilon_edges.push_back(loop.start);
+            m_nfa.states[loop.end].epsilon_edges.push_back(star.start);
+            append(result, star);
+        } else {
+            for (size_t i = min; i < max; ++i) {
+                Fragment optional = i == 0 ? atom : copy_atom();
+                size_t end = m_nfa.add_state();
+                m_nfa.states[optional.end].epsilon_edges.push_back(end);
+                m_nfa.states[result.end].epsilon_edges.push_back(optional.start);
+                m_nfa.states[result.end].epsilon_edges.push_back(end);
+                result.end = end;
+            }
+        }
+        m_pos = quantifier_end;
+        return result;
+    }
+
+    Fragment parse_concatenation() {
+        Fragment result = empty();
+        while (!at_end() && peek() != '|' && peek() != ')')
+            append(result, parse_repetition());
+        return result;
+    }
+
+    Fragment parse_alternation() {
+        Fragment first = parse_concatenation();
+        if (at_end() || peek() != '|')
+            return first;
+        Fragment result{m_nfa.add_state(), m_nfa.add_state()};
+        auto add_branch = [&] (const Fragment& branch) {
+            m_nfa.states[result.start].epsilon_edges.push_back(branch.start);
+            m_nfa.states[branch.end].epsilon_edges.push_back(result.end);
+        };
+        add_branch(first);
+        while (!at_end() && peek() == '|') {
+            ++m_pos;
+            add_branch(parse_concatenation());
+        }
+        return result;
+    }
+
+public:
+    RegexParser(const std::string& pattern, NFA& nfa) : m_pattern(pattern), m_nfa(nfa) {}
+
+    Fragment parse() {
+        Fragment fragment = parse_alternation();
+        OPENVINO_ASSERT(at_end(), "Unexpected '", peek(), "' at position ", m_pos, " of regular expression '", m_pattern, "'");
+        return fragment;
+    }
+};
+
+std::vector<size_t> get_epsilon_closure(const NFA& nfa, std::vector<size_t> states) {
+    std::vector<bool> is_visited(nfa.states.size(), false);
+    std::vector<size_t> stack = states;
+    for (size_t state : states)
+        is_visited[state] = true;
+    while (!stack.empty()) {
+        size_t state = stack.back();
+        stack.pop_back();
+        for (size_t next_state : nfa.states[state].epsilon_edges) {
+            if (!is_visited[next_state]) {
+                is_visited[next_state] = true;
+                states.push_back(next_state);
+                stack.push_back(next_state);
+            }
+        }
+    }
+    std::sort(states.begin(), states.end());
+    return states;
+}
+
+}  // namespace
+
+RegexAutomaton::RegexAutomaton(const std::string& pattern, size_t max_num_states) {
+    NFA nfa;
+    Fragment fragment = RegexParser(pattern, nfa).parse();
+
+    // subset construction, DFA states are identified by sorted sets of NFA states
+    std::map<std::vector<size_t>, int32_t> state_ids;
+    std::vector<std::vector<size_t>> dfa_states;
+    std::vector<std::array<int32_t, ALPHABET_SIZE>> transitions;
+    auto get_state_id = [&] (std::vector<size_t> nfa_states) {
+        auto [it, is_inserted] = state_ids.emplace(std::move(nfa_states), static_cast<int32_t>(dfa_states.size()));
+        if (is_inserted) {
+            OPENVINO_ASSERT(dfa_states.size() < max_num_states, "Regular expression '", pattern, "' requires more than ", max_num_states, " automaton states");
+            dfa_states.push_back(it->first);
+            transitions.emplace_back();
+            transitions.back().fill(DEAD_STATE);
+        }
+        return it->second;
+    };
+    get_state_id(get_epsilon_closure(nfa, {fragment.start}));
+    for (size_t state_id = 0; state_id < dfa_states.size(); ++state_id) {
+        // bytes leading to the same set of NFA states share the epsilon closure
+        std::map<std::vector<size_t>, int32_t> next_state_ids;
+        for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+            std::vector<size_t> next_nfa_states;
+            for (size_t nfa_state : dfa_states[state_id])
+                if (nfa.states[nfa_state].bytes.test(byte))
+                    next_nfa_states.push_back(nfa.states[nfa_state].next);
+            if (next_nfa_states.empty())
+                continue;
+            auto it = next_state_ids.find(next_nfa_states);
+            if (it == next_state_ids.end())
+                it = next_state_ids.emplace(next_nfa_states, get_state_id(get_epsilon_closure(nfa, next_nfa_states))).first;
+            transitions[state_id][byte] = it->second;
+        }
+    }
+
+    // states which lead to an accepting one, found by a backward traversal
+    const size_t num_states = dfa_states.size();
+    std::vector<bool> is_accepting(num_states), is_alive(num_states, false);
+    std::vector<std::vector<int32_t>> reverse_edges(num_states);
+    std::queue<int32_t> alive_states;
+    for (size_t state_id = 0; state_id < num_states; ++state_id) {
+        is_accepting[state_id] = std::binary_search(dfa_states[state_id].begin(), dfa_states[state_id].end(), fragment.end);
+        if (is_accepting[state_id]) {
+            is_alive[state_id] = true;
+            alive_states.push(state_id);
+        }
+        for (int32_t next_state : transitions[state_id])
+            if (next_state != DEAD_STATE)
+                reverse_edges[next_state].push_back(state_id);
+    }
+    while (!alive_states.empty()) {
+        int32_t state_id = alive_states.front();
+        alive_states.pop();
+        for (int32_t prev_state : reverse_edges[state_id]) {
+            if (!is_alive[prev_state]) {
+                is_alive[prev_state] = true;
+                alive_states.push(prev_state);
+            }
+        }
+    }
+    OPENVINO_ASSERT(is_alive[0], "Regular expression '", pattern, "' does not match any text");
+
+    // renumbering keeps the initial state first
+    std::vector<int32_t> new_ids(num_states, DEAD_STATE);
+    for (size_t state_id = 0; state_id < num_states; ++state_id) {
+        if (is_alive[state_id]) {
+            new_ids[state_id] = static_cast<int32_t>(m_transitions.size());
+            m_transitions.emplace_back();
+            m_is_accepting.push_back(is_accepting[state_id]);
+        }
+    }
+    for (size_t state_id = 0; state_id < num_states; ++state_id) {
+        if (!is_alive[state_id])
+            continue;
+        auto& state_transitions = m_transitions[new_ids[state_id]];
+        for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+            int32_t next_state = transitions[state_id][byte];
+            state_transitions[byte] = next_state == DEAD_STATE ? DEAD_STATE : new_ids[next_state];
+        }
+    }
+}
+
+}
@@ -0,0 +1,57 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ov::genai {
+
+/**
+ * Deterministic finite automaton over bytes, which accepts UTF-8 encoded texts fully matched by a regular expression.
+ * Supported syntax: literals, escapes (\d, \w, \s, \xHH and escaped metacharacters), character classes of ASCII characters,
+ * '.', groups, alternation and quantifiers (*, +, ?, {n}, {n,}, {n,m}). Anchors '^' and '$' are ignored, since the whole text is matched.
+ * States from which no accepting state is reachable are removed, so that any text leading to a valid state can be completed.
+ */
+class RegexAutomaton {
+    static constexpr size_t ALPHABET_SIZE = 256;
+
+    std::vector<std::array<int32_t, ALPHABET_SIZE>> m_transitions;
+    std::vector<bool> m_is_accepting;
+
+public:
+    static constexpr int32_t DEAD_STATE = -1;
+
+    /**
+     * @param pattern Regular expression.
+     * @param max_num_states Limit of the number of automaton states, exceeding it throws an exception.
+     */
+    explicit RegexAutomaton(const std::string& pattern, size_t max_num_states = 10000);
+
+    int32_t get_initial_state() const {
+        return 0;
+    }
+
+    int32_t next(int32_t state, uint8_t byte) const {
+        return m_transitions[state][byte];
+    }
+
+    int32_t next(int32_t state, const std::string& text) const {
+        for (size_t i = 0; i < text.size() && state != DEAD_STATE; ++i)
+            state = m_transitions[state][static_cast<uint8_t>(text[i])];
+        return state;
+    }
+
+    bool is_accepting(int32_t state) const {
+        return m_is_accepting[state];
+    }
+
+    size_t get_num_states() const {
+        return m_transitions.size();
+    }
+};
+
+}
@@ -0,0 +1,99 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "structured_output/structured_output_grammar.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace ov::genai {
+
+TokenVocabulary::TokenVocabulary(Tokenizer& tokenizer, size_t vocab_size) {
+    // tokens decoded alone may lose leading spaces (e.g. SentencePiece), so each token is decoded after a reference token,
+    // whose text is then cut off
+    const auto reference_ids = tokenizer.encode("a", {{"add_special_tokens", false}}).input_ids;
+    const bool has_reference = reference_ids.get_size() > 0;
+    const int64_t reference_id = has_reference ? reference_ids.data<int64_t>()[reference_ids.get_size() - 1] : 0;
+    const std::string reference_text = has_reference ? tokenizer.decode(std::vector<int64_t>{reference_id}) : "";
+
+    const size_t batch_size = 4096;
+    m_texts.reserve(vocab_size);
+    for (size_t begin = 0; begin < vocab_size; begin += batch_size) {
+        std::vector<std::vector<int64_t>> batch;
+        for (size_t token_id = begin; token_id < std::min(begin + batch_size, vocab_size); ++token_id)
+            batch.push_back(has_reference ? std::vector<int64_t>{reference_id, static_cast<int64_t>(token_id)} : std::vector<int64_t>{static_cast<int64_t>(token_id)});
+        for (auto& text : tokenizer.decode(batch)) {
+            if (has_reference && text.compare(0, reference_text.size(), reference_text) == 0)
+                text.erase(0, reference_text.size());
+            m_texts.push_back(std::move(text));
+        }
+    }
+
+    m_sorted_token_ids.resize(vocab_size);
+    std::iota(m_sorted_token_ids.begin(), m_sorted_token_ids.end(), 0);
+    std::sort(m_sorted_token_ids.begin(), m_sorted_token_ids.end(), [this] (int64_t lhs, int64_t rhs) {
+        return m_texts[lhs] < m_texts[rhs];
+    });
+    m_common_prefix_lengths.resize(vocab_size, 0);
+    for (size_t i = 1; i < vocab_size; ++i) {
+        const std::string& previous = m_texts[m_sorted_token_ids[i - 1]];
+        const std::string& current = m_texts[m_sorted_token_ids[i]];
+        size_t length = std::min(previous.size(), current.size());
+        m_common_prefix_lengths[i] = std::mismatch(previous.begin(), previous.begin() + length, current.begin()).first - previous.begin();
+    }
+}
+
+StructuredOutputGrammar::StructuredOutputGrammar(std::shared_ptr<const RegexAutomaton> automaton, std::shared_ptr<const TokenVocabulary> vocabulary) :
+    m_automaton(std::move(automaton)), m_vocabulary(std::move(vocabulary)), m_masks(m_automaton->get_num_states()) {}
+
+std::shared_ptr<const StructuredOutputGrammar::Mask> StructuredOutputGrammar::get_mask(int32_t state) {
+    OPENVINO_ASSERT(state != RegexAutomaton::DEAD_STATE, "Mask of tokens is not defined for the dead state");
+    {
+        std::lock_guard<std::mutex> lock(m_masks_mutex);
+        if (m_masks[state])
+            return m_masks[state];
+    }
+    // computed without the lock, so that masks of different states are computed concurrently; a concurrent computation
+    // of the same state produces the same mask
+    auto mask = std::make_shared<const Mask>(compute_mask(state));
+    std::lock_guard<std::mutex> lock(m_masks_mutex);
+    if (!m_masks[state])
+        m_masks[state] = mask;
+    return m_masks[state];
+}
+
+StructuredOutputGrammar::Mask StructuredOutputGrammar::compute_mask(int32_t state) const {
+    const auto& sorted_token_ids = m_vocabulary->get_sorted_token_ids();
+    const auto& common_prefix_lengths = m_vocabulary->get_common_prefix_lengths();
+    Mask mask((m_vocabulary->size() + 63) / 64, 0);
+
+    // states[d] is the state after d bytes of the previous text, so a common prefix with the previous text is not walked again
+    std::vector<int32_t> states{state};
+    // length of the shortest prefix of the previous text leading to the dead state, all texts sharing it are skipped
+    size_t dead_prefix_length = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < sorted_token_ids.size(); ++i) {
+        const size_t common_prefix_length = common_prefix_lengths[i];
+        if (common_prefix_length >= dead_prefix_length)
+            continue;
+        dead_prefix_length = std::numeric_limits<size_t>::max();
+        const std::string& text = m_vocabulary->get_text(sorted_token_ids[i]);
+        states.resize(common_prefix_length + 1);
+        int32_t current_state = states.back();
+        for (size_t position = common_prefix_length; position < text.size(); ++position) {
+            current_state = m_automaton->next(current_state, static_cast<uint8_t>(text[position]));
+            if (current_state == RegexAutomaton::DEAD_STATE) {
+                dead_prefix_length = position + 1;
+                break;
+            }
+            states.push_back(current_state);
+        }
+        if (current_state != RegexAutomaton::DEAD_STATE && !text.empty()) {
+            const int64_t token_id = sorted_token_ids[i];
+            mask[token_id / 64] |= uint64_t(1) << (token_id % 64);
+        }
+    }
+    return mask;
+}
+
+}
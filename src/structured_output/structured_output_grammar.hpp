@@ -0,0 +1,102 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "openvino/genai/tokenizer.hpp"
+#include "structured_output/regex_automaton.hpp"
+
+namespace ov::genai {
+
+/**
+ * Texts of all tokens of a vocabulary, sorted lexicographically, so that tokens sharing a prefix are processed together.
+ */
+class TokenVocabulary {
+    std::vector<std::string> m_texts;
+    // token IDs in lexicographical order of texts
+    std::vector<int64_t> m_sorted_token_ids;
+    // length of the common prefix of i-th and (i-1)-th texts in the sorted order
+    std::vector<size_t> m_common_prefix_lengths;
+
+public:
+    /**
+     * @param tokenizer Tokenizer to decode tokens with.
+     * @param vocab_size Number of tokens, i.e. the size of logits.
+     */
+    TokenVocabulary(Tokenizer& tokenizer, size_t vocab_size);
+
+    size_t size() const {
+        return m_texts.size();
+    }
+
+    const std::string& get_text(int64_t token_id) const {
+        return m_texts[token_id];
+    }
+
+    const std::vector<int64_t>& get_sorted_token_ids() const {
+        return m_sorted_token_ids;
+    }
+
+    const std::vector<size_t>& get_common_prefix_lengths() const {
+        return m_common_prefix_lengths;
+    }
+};
+
+/**
+ * Regular expression compiled to an automaton together with bitmasks of tokens allowed in its states.
+ * A mask is computed once per state on the first request and shared by all sequences and requests using the same expression.
+ * Methods can be called from several threads at once.
+ */
+class StructuredOutputGrammar {
+public:
+    // bit i of word i / 64 is set if token i is allowed
+    using Mask = std::vector<uint64_t>;
+
+    /**
+     * @param automaton Automaton of a regular expression, which the whole generated text must match.
+     * @param vocabulary Vocabulary of the model.
+     */
+    StructuredOutputGrammar(std::shared_ptr<const RegexAutomaton> automaton, std::shared_ptr<const TokenVocabulary> vocabulary);
+
+    int32_t get_initial_state() const {
+        return m_automaton->get_initial_state();
+    }
+
+    /**
+     * @return State after the token is generated in the given state or RegexAutomaton::DEAD_STATE if the token is not allowed.
+     */
+    int32_t advance(int32_t state, int64_t token_id) const {
+        if (state == RegexAutomaton::DEAD_STATE || token_id < 0 || static_cast<size_t>(token_id) >= m_vocabulary->size())
+            return RegexAutomaton::DEAD_STATE;
+        return m_automaton->next(state, m_vocabulary->get_text(token_id));
+    }
+
+    bool is_accepting(int32_t state) const {
+        return state != RegexAutomaton::DEAD_STATE && m_automaton->is_accepting(state);
+    }
+
+    size_t get_vocab_size() const {
+        return m_vocabulary->size();
+    }
+
+    /**
+     * @return Mask of tokens, whose text keeps the generated text matchable in the given state. Tokens with empty text are never allowed,
+     * stop tokens are handled by a caller.
+     */
+    std::shared_ptr<const Mask> get_mask(int32_t state);
+
+private:
+    std::shared_ptr<const RegexAutomaton> m_automaton;
+    std::shared_ptr<const TokenVocabulary> m_vocabulary;
+    std::vector<std::shared_ptr<const Mask>> m_masks;
+    std::mutex m_masks_mutex;
+
+    Mask compute_mask(int32_t state) const;
+};
+
+}
@@ -11,42 +11,44 @@ TextCallbackStreamer::TextCallbackStreamer(const Tokenizer& tokenizer, std::func
     on_finalized_subword_callback = callback;
 }
 
+std::string TextCallbackStreamer::decode(size_t begin, size_t end) {
+    if (begin == end)
+        return {};
+    return m_tokenizer.decode(std::vector<int64_t>(m_tokens_cache.begin() + begin, m_tokens_cache.begin() + end));
+}
+
 bool TextCallbackStreamer::put(int64_t token) {
-    std::stringstream res;
     m_tokens_cache.push_back(token);
-    std::string text = m_tokenizer.decode(m_tokens_cache);
-    if (!text.empty() && '\n' == text.back() && text.size() > print_len) {
-        // Flush the cache after the new line symbol
-        res << std::string_view{text.data() + print_len, text.size() - print_len};
-        m_tokens_cache.clear();
-        print_len = 0;
-        return on_finalized_subword_callback(res.str());
-    }
+    // only the window of the last printed and pending tokens is decoded, so the cost per token does not grow with the printed text
+    std::string text = decode(0, m_tokens_cache.size());
 
     constexpr char replacement[] = "\xef\xbf\xbd";  // MSVC with /utf-8 fails to compile � directly with newline in string literal error.
     if (text.size() >= 3 && text.compare(text.size() - 3, 3, replacement) == 0) {
-        // Don't print incomplete text
-        return on_finalized_subword_callback(res.str());
-    } else if (text.size() > print_len) {
+        // Don't print incomplete text, pending tokens end in the middle of a multi-byte UTF-8 character
+        return on_finalized_subword_callback("");
+    } else if (text.size() <= m_printed_text.size()) {
         // It is possible to have a shorter text after adding new token.
         // Print to output only if text length is increaesed.
-        res << std::string_view{text.data() + print_len, text.size() - print_len} << std::flush;
-        print_len = text.size();
+        return on_finalized_subword_callback("");
     }
 
-    return on_finalized_subword_callback(res.str());
+    std::string new_text = text.substr(m_printed_text.size());
+    // printed tokens preceding the new ones are dropped, the new ones become the context of the next window
+    m_tokens_cache.erase(m_tokens_cache.begin(), m_tokens_cache.begin() + m_read_offset);
+    m_read_offset = m_tokens_cache.size();
+    m_printed_text = decode(0, m_read_offset);
+    return on_finalized_subword_callback(new_text);
 }
 
 void TextCallbackStreamer::end() {
-    std::stringstream res;
-    std::string text = m_tokenizer.decode(m_tokens_cache);
-    if (text.size() <= print_len)
-        return ;
-    res << std::string_view{text.data() + print_len, text.size() - print_len} << std::flush;
+    std::string text = decode(0, m_tokens_cache.size());
+    std::string printed_text = std::move(m_printed_text);
     m_tokens_cache.clear();
-    print_len = 0;
-    on_finalized_subword_callback(res.str());
-    return;
+    m_read_offset = 0;
+    m_printed_text.clear();
+    if (text.size() <= printed_text.size())
+        return;
+    on_finalized_subword_callback(text.substr(printed_text.size()));
 }
 
 ov::genai::StreamerBase::~StreamerBase() = default;
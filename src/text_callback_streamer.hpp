@@ -20,8 +20,15 @@ public:
 
 protected:
     Tokenizer m_tokenizer;
+    // tokens of the decoding window: [0, m_read_offset) are printed already and give context to decode following tokens,
+    // e.g. leading spaces of SentencePiece tokens, [m_read_offset, size) are pending
     std::vector<int64_t> m_tokens_cache;
-    size_t print_len = 0;
+    size_t m_read_offset = 0;
+    // decoded text of printed tokens of the window
+    std::string m_printed_text;
+
+private:
+    std::string decode(size_t begin, size_t end);
 };
 
 }  // namespace genai
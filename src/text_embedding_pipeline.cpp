@@ -0,0 +1,238 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "openvino/genai/text_embedding_pipeline.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+
+#include "openvino/op/constant.hpp"
+#include "openvino/op/convert.hpp"
+#include "openvino/op/divide.hpp"
+#include "openvino/op/maximum.hpp"
+#include "openvino/op/multiply.hpp"
+#include "openvino/op/normalize_l2.hpp"
+#include "openvino/op/reduce_sum.hpp"
+#include "openvino/op/result.hpp"
+#include "openvino/op/slice.hpp"
+#include "openvino/op/squeeze.hpp"
+#include "openvino/op/unsqueeze.hpp"
+#include "openvino/runtime/core.hpp"
+
+#include "utils.hpp"
+
+namespace ov {
+namespace genai {
+
+namespace {
+
+std::shared_ptr<ov::op::v0::Parameter> find_parameter(const std::shared_ptr<ov::Model>& model, const std::string& name) {
+    for (const auto& parameter : model->get_parameters()) {
+        if (parameter->get_output_tensor(0).get_names().count(name))
+            return parameter;
+    }
+    return nullptr;
+}
+
+// replaces outputs of the model by "embeddings" output of shape [batch, hidden_size] pooled from the last hidden state
+std::shared_ptr<ov::Model> append_pooling(const std::shared_ptr<ov::Model>& model, PoolingType pooling_type, bool normalize) {
+    const ov::Output<ov::Node> hidden_state = model->output(0);  // [batch, seq_len, hidden_size]
+    const ov::element::Type hidden_type = hidden_state.get_element_type();
+    auto seq_axis = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, 1);
+
+    ov::Output<ov::Node> embeddings;
+    if (pooling_type == PoolingType::CLS) {
+        auto start = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, 0);
+        auto stop = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, 1);
+        auto step = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, 1);
+        auto first_token_state = std::make_shared<ov::op::v8::Slice>(hidden_state, start, stop, step, seq_axis);
+        embeddings = std::make_shared<ov::op::v0::Squeeze>(first_token_state, seq_axis);
+    } else {
+        auto attention_mask = find_parameter(model, "attention_mask");
+        OPENVINO_ASSERT(attention_mask, "Mean pooling requires 'attention_mask' input of the model");
+        auto mask = std::make_shared<ov::op::v0::Convert>(attention_mask, hidden_type);
+        auto hidden_axis = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, -1);
+        auto expanded_mask = std::make_shared<ov::op::v0::Unsqueeze>(mask, hidden_axis);  // [batch, seq_len, 1]
+        auto masked_state = std::make_shared<ov::op::v1::Multiply>(hidden_state, expanded_mask);
+        auto state_sum = std::make_shared<ov::op::v1::ReduceSum>(masked_state, seq_axis, false);
+        auto num_tokens = std::make_shared<ov::op::v1::ReduceSum>(expanded_mask, seq_axis, false);  // [batch, 1]
+        auto min_num_tokens = std::make_shared<ov::op::v0::Constant>(hidden_type, ov::Shape{}, 1e-9f);
+        embeddings = std::make_shared<ov::op::v1::Divide>(state_sum, std::make_shared<ov::op::v1::Maximum>(num_tokens, min_num_tokens));
+    }
+
+    if (normalize) {
+        auto axes = std::make_shared<ov::op::v0::Constant>(ov::element::i64, ov::Shape{1}, 1);
+        embeddings = std::make_shared<ov::op::v0::NormalizeL2>(embeddings, axes, 1e-12f, ov::op::EpsMode::MAX);
+    }
+    if (hidden_type != ov::element::f32) {
+        embeddings = std::make_shared<ov::op::v0::Convert>(embeddings, ov::element::f32);
+    }
+
+    auto result = std::make_shared<ov::op::v0::Result>(embeddings);
+    result->output(0).set_names({"embeddings"});
+    return std::make_shared<ov::Model>(ov::ResultVector{result}, model->get_parameters(), "text_embedding_model");
+}
+
+}  // namespace
+
+class TextEmbeddingPipeline::TextEmbeddingPipelineImpl {
+public:
+    Tokenizer m_tokenizer;
+    ov::InferRequest m_request;
+    size_t m_embedding_size = 0;
+    size_t m_batch_token_budget = 8192;
+    size_t m_max_length = 0;
+    bool m_has_token_type_ids = false;
+    // the infer request is shared by concurrent embed() calls
+    std::mutex m_mutex;
+
+    TextEmbeddingPipelineImpl(const std::filesystem::path& models_path, const std::string& device, const ov::AnyMap& properties)
+        : m_tokenizer(models_path) {
+        ov::AnyMap compile_properties = properties;
+        PoolingType pooling = PoolingType::CLS;
+        bool normalize = true;
+        if (auto it = compile_properties.find(pooling_type.name()); it != compile_properties.end()) {
+            pooling = it->second.as<PoolingType>();
+            compile_properties.erase(it);
+        }
+        if (auto it = compile_properties.find(normalize_embeddings.name()); it != compile_properties.end()) {
+            normalize = it->second.as<bool>();
+            compile_properties.erase(it);
+        }
+        if (auto it = compile_properties.find(embedding_batch_token_budget.name()); it != compile_properties.end()) {
+            m_batch_token_budget = it->second.as<size_t>();
+            OPENVINO_ASSERT(m_batch_token_budget > 0, "embedding_batch_token_budget must be positive");
+            compile_properties.erase(it);
+        }
+        if (auto it = compile_properties.find(embedding_max_length.name()); it != compile_properties.end()) {
+            m_max_length = it->second.as<size_t>();
+            compile_properties.erase(it);
+        }
+
+        ov::Core core = utils::singleton_core();
+        std::shared_ptr<ov::Model> model = core.read_model(models_path / "openvino_model.xml");
+        OPENVINO_ASSERT(find_parameter(model, "input_ids"), "Text embedding model must have 'input_ids' input");
+        m_has_token_type_ids = find_parameter(model, "token_type_ids") != nullptr;
+        const ov::PartialShape hidden_shape = model->output(0).get_partial_shape();
+        OPENVINO_ASSERT(hidden_shape.rank().get_length() == 3 && hidden_shape[2].is_static(),
+                        "The first output of text embedding model must be the last hidden state of shape [batch, seq_len, hidden_size]");
+        m_embedding_size = hidden_shape[2].get_length();
+
+        ov::CompiledModel compiled_model = core.compile_model(append_pooling(model, pooling, normalize), device, compile_properties);
+        utils::print_compiled_model_properties(compiled_model, "Text embedding model");
+        m_request = compiled_model.create_infer_request();
+    }
+
+    void embed(const std::vector<std::string>& texts, ov::Tensor& embeddings) {
+        OPENVINO_ASSERT(embeddings.get_element_type() == ov::element::f32 && embeddings.get_shape() == ov::Shape{texts.size(), m_embedding_size},
+                        "Embeddings tensor must be f32 of shape [", texts.size(), ", ", m_embedding_size, "], while it is ",
+                        embeddings.get_element_type(), " of shape ", embeddings.get_shape());
+        if (texts.empty())
+            return;
+
+        const std::vector<std::vector<int64_t>> token_ids = tokenize(texts);
+        // texts of similar lengths are batched together, so that batches are padded little
+        std::vector<size_t> order(texts.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&token_ids](size_t lhs, size_t rhs) {
+            return token_ids[lhs].size() < token_ids[rhs].size();
+        });
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t begin = 0; begin < order.size();) {
+            // the last text of a batch is the longest one, which the batch is padded to
+            size_t end = begin + 1;
+            while (end < order.size() && (end - begin + 1) * token_ids[order[end]].size() <= m_batch_token_budget)
+                ++end;
+            infer_batch(token_ids, order, begin, end, embeddings.data<float>());
+            begin = end;
+        }
+    }
+
+private:
+    // token IDs of each text without padding, truncated to m_max_length
+    std::vector<std::vector<int64_t>> tokenize(const std::vector<std::string>& texts) {
+        std::vector<std::string> prompts = texts;
+        const TokenizedInputs tokenized = m_tokenizer.encode(prompts);
+        const size_t padded_length = tokenized.input_ids.get_shape()[1];
+        const int64_t* input_ids = tokenized.input_ids.data<const int64_t>();
+        const int64_t* attention_mask = tokenized.attention_mask.data<const int64_t>();
+
+        std::vector<std::vector<int64_t>> token_ids(texts.size());
+        for (size_t text_idx = 0; text_idx < texts.size(); ++text_idx) {
+            // positions of padding depend on padding side of the tokenizer
+            for (size_t position = text_idx * padded_length; position < (text_idx + 1) * padded_length; ++position) {
+                if (attention_mask[position] != 0)
+                    token_ids[text_idx].push_back(input_ids[position]);
+            }
+            if (m_max_length > 0 && token_ids[text_idx].size() > m_max_length)
+                token_ids[text_idx].resize(m_max_length);
+        }
+        return token_ids;
+    }
+
+    // infers texts order[begin:end] right padded to the longest one and copies their embeddings to rows of output
+    void infer_batch(const std::vector<std::vector<int64_t>>& token_ids, const std::vector<size_t>& order, size_t begin, size_t end, float* output) {
+        const size_t batch_size = end - begin, length = std::max<size_t>(1, token_ids[order[end - 1]].size());
+        ov::Tensor input_ids(ov::element::i64, {batch_size, length}), attention_mask(ov::element::i64, {batch_size, length});
+        std::fill_n(input_ids.data<int64_t>(), input_ids.get_size(), std::max<int64_t>(0, m_tokenizer.get_pad_token_id()));
+        std::fill_n(attention_mask.data<int64_t>(), attention_mask.get_size(), 0);
+        for (size_t row = 0; row < batch_size; ++row) {
+            const std::vector<int64_t>& text_token_ids = token_ids[order[begin + row]];
+            std::copy(text_token_ids.begin(), text_token_ids.end(), input_ids.data<int64_t>() + row * length);
+            std::fill_n(attention_mask.data<int64_t>() + row * length, text_token_ids.size(), 1);
+        }
+
+        m_request.set_tensor("input_ids", input_ids);
+        m_request.set_tensor("attention_mask", attention_mask);
+        if (m_has_token_type_ids) {
+            ov::Tensor token_type_ids(ov::element::i64, {batch_size, length});
+            std::fill_n(token_type_ids.data<int64_t>(), token_type_ids.get_size(), 0);
+            m_request.set_tensor("token_type_ids", token_type_ids);
+        }
+        m_request.infer();
+
+        const float* batch_embeddings = m_request.get_tensor("embeddings").data<const float>();
+        for (size_t row = 0; row < batch_size; ++row)
+            std::copy_n(batch_embeddings + row * m_embedding_size, m_embedding_size, output + order[begin + row] * m_embedding_size);
+    }
+};
+
+TextEmbeddingPipeline::TextEmbeddingPipeline(const std::filesystem::path& models_path, const std::string& device, const ov::AnyMap& properties)
+    : m_impl(std::make_unique<TextEmbeddingPipelineImpl>(models_path, device, properties)) {}
+
+TextEmbeddingPipeline::~TextEmbeddingPipeline() = default;
+
+void TextEmbeddingPipeline::embed(const std::vector<std::string>& texts, ov::Tensor& embeddings) {
+    m_impl->embed(texts, embeddings);
+}
+
+std::vector<std::vector<float>> TextEmbeddingPipeline::embed_documents(const std::vector<std::string>& texts) {
+    ov::Tensor embeddings(ov::element::f32, {texts.size(), m_impl->m_embedding_size});
+    m_impl->embed(texts, embeddings);
+
+    std::vector<std::vector<float>> results(texts.size());
+    const float* data = embeddings.data<const float>();
+    for (size_t text_idx = 0; text_idx < texts.size(); ++text_idx)
+        results[text_idx].assign(data + text_idx * m_impl->m_embedding_size, data + (text_idx + 1) * m_impl->m_embedding_size);
+    return results;
+}
+
+std::vector<float> TextEmbeddingPipeline::embed_query(const std::string& text) {
+    std::vector<float> result(m_impl->m_embedding_size);
+    ov::Tensor embedding(ov::element::f32, {1, m_impl->m_embedding_size}, result.data());
+    m_impl->embed({text}, embedding);
+    return result;
+}
+
+size_t TextEmbeddingPipeline::get_embedding_size() const {
+    return m_impl->m_embedding_size;
+}
+
+Tokenizer TextEmbeddingPipeline::get_tokenizer() const {
+    return m_impl->m_tokenizer;
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -0,0 +1,108 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "threaded_streamer.hpp"
+
+#include "openvino/core/except.hpp"
+
+namespace ov {
+namespace genai {
+
+ThreadedStreamer::ThreadedStreamer(std::shared_ptr<StreamerBase> streamer, size_t queue_size) :
+    m_streamer(std::move(streamer)), m_queue_size(queue_size) {
+    OPENVINO_ASSERT(m_streamer != nullptr, "ThreadedStreamer requires a streamer to wrap");
+    OPENVINO_ASSERT(m_queue_size > 0, "ThreadedStreamer requires a non-zero queue size");
+    m_worker = std::thread(&ThreadedStreamer::worker, this);
+}
+
+ThreadedStreamer::~ThreadedStreamer() {
+    // generation was interrupted before end(), e.g. by an exception: drop queued tokens and do not flush the wrapped streamer
+    if (m_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+            m_aborted = true;
+            m_finished = true;
+        }
+        m_not_empty.notify_one();
+        m_worker.join();
+    }
+}
+
+void ThreadedStreamer::worker() {
+    while (true) {
+        int64_t token;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [this] { return !m_tokens.empty() || m_finished; });
+            if (m_tokens.empty() || m_stopped) {
+                m_tokens.clear();
+                break;
+            }
+            token = m_tokens.front();
+            m_tokens.pop_front();
+        }
+        m_not_full.notify_one();
+
+        try {
+            if (m_streamer->put(token)) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+                m_not_full.notify_one();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exception = std::current_exception();
+            m_stopped = true;
+            m_not_full.notify_one();
+        }
+    }
+
+    bool flush;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        flush = m_exception == nullptr && !m_aborted;
+    }
+    if (flush) {
+        try {
+            m_streamer->end();
+        } catch (...) {
+            m_exception = std::current_exception();
+        }
+    }
+}
+
+void ThreadedStreamer::rethrow_if_failed() {
+    // the exception is kept, so that the worker does not flush the failed streamer by end()
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+bool ThreadedStreamer::put(int64_t token) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this] { return m_tokens.size() < m_queue_size || m_stopped; });
+        rethrow_if_failed();
+        if (m_stopped)
+            return true;
+        m_tokens.push_back(token);
+    }
+    m_not_empty.notify_one();
+    return false;
+}
+
+void ThreadedStreamer::end() {
+    if (!m_worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_not_empty.notify_one();
+    m_worker.join();
+    // the worker is joined, so the exception is not accessed concurrently
+    rethrow_if_failed();
+}
+
+}  // namespace genai
+}  // namespace ov
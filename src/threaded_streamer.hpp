@@ -0,0 +1,52 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "openvino/genai/streamer_base.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * @brief Streamer, which passes tokens to the wrapped streamer from a dedicated thread, so that slow callbacks (detokenization,
+ * printing, network) overlap with generation. put() waits only when the queue of `queue_size` tokens is full. Once the wrapped
+ * streamer requests to stop, the next put() returns true and the remaining queued tokens are dropped. Exceptions thrown by
+ * the wrapped streamer are rethrown by the next put() or end().
+ */
+class ThreadedStreamer : public StreamerBase {
+public:
+    ThreadedStreamer(std::shared_ptr<StreamerBase> streamer, size_t queue_size);
+    ~ThreadedStreamer() override;
+
+    bool put(int64_t token) override;
+    void end() override;
+
+private:
+    void worker();
+    void rethrow_if_failed();
+
+    std::shared_ptr<StreamerBase> m_streamer;
+    size_t m_queue_size;
+
+    std::deque<int64_t> m_tokens;
+    bool m_finished = false;
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty, m_not_full;
+
+    bool m_stopped = false;
+    // destroyed before end()
+    bool m_aborted = false;
+    std::exception_ptr m_exception;
+    std::thread m_worker;
+};
+
+}  // namespace genai
+}  // namespace ov
@@ -7,14 +7,19 @@
 #include <chrono>
 #include <iostream>
 
+#include "tracing.hpp"
+
 class ManualTimer {
     double m_total;
     decltype(std::chrono::steady_clock::now()) m_start;
     std::string m_title;
+    // intervals are also recorded to a trace, if tracing is enabled
+    const char* m_trace_name;
 public:
     ManualTimer(const std::string& title) :
         m_total(0.),
-        m_title(title) {
+        m_title(title),
+        m_trace_name(ov::genai::Tracer::is_enabled() ? ov::genai::Tracer::intern(title) : nullptr) {
     }
 
     void start() {
@@ -24,6 +29,8 @@ public:
     void end() {
         auto m_end = std::chrono::steady_clock::now();
         m_total += std::chrono::duration<double, std::milli>(m_end - m_start).count();
+        if (m_trace_name)
+            ov::genai::Tracer::record(m_trace_name, m_start, m_end);
     }
 
     float get_duration() const {
@@ -0,0 +1,56 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+
+namespace ov::genai {
+
+/**
+ * @brief Streaming 64-bit hash of token IDs, which follows xxHash64 rounds for 8-byte lanes. Tokens are added one by one
+ * without allocations, so a hash of a prefix can be extended by next tokens. Hashes are the same on all platforms.
+ */
+class TokenHasher {
+    static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+    uint64_t m_state;
+    uint64_t m_num_tokens = 0;
+
+    static uint64_t rotl(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+public:
+    /**
+     * @param seed Hash of the preceding content, e.g. of the previous KV cache block.
+     */
+    explicit TokenHasher(uint64_t seed = 0) : m_state(seed + PRIME_5) {}
+
+    void update(int64_t token_id) {
+        m_state ^= rotl(static_cast<uint64_t>(token_id) * PRIME_2, 31) * PRIME_1;
+        m_state = rotl(m_state, 27) * PRIME_1 + PRIME_4;
+        ++m_num_tokens;
+    }
+
+    uint64_t get_num_tokens() const {
+        return m_num_tokens;
+    }
+
+    // doesn't change the state, so more tokens can be added after
+    uint64_t digest() const {
+        uint64_t hash = m_state + m_num_tokens * sizeof(int64_t);
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+};
+
+}  // namespace ov::genai
@@ -0,0 +1,83 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openvino/genai/tokenizer.hpp"
+#include "openvino/core/except.hpp"
+
+namespace ov::genai {
+
+/**
+ * Bounded cache of token IDs of recently encoded single prompts, e.g. shared system prompts or stop strings of requests.
+ * Only exact matches of a text and tokenization mode are reused, since tokens of a prefix may merge with following text.
+ * The least recently used texts are evicted, when the number of texts exceeds capacity. Methods can be called from several threads at once.
+ */
+class TokenizationCache {
+    struct Entry {
+        std::string key;
+        std::vector<int64_t> token_ids;
+    };
+
+    size_t m_capacity;
+    std::mutex m_mutex;
+    // the most recently used entries first
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    TokenizationCacheMetrics m_metrics;
+
+    static std::string get_key(const std::string& text, bool add_special_tokens) {
+        return std::string(1, add_special_tokens ? '1' : '0') + text;
+    }
+
+public:
+    /**
+     * @param capacity Maximum number of cached texts.
+     */
+    explicit TokenizationCache(size_t capacity) : m_capacity(capacity) {
+        OPENVINO_ASSERT(capacity > 0, "Capacity of tokenization cache must be non-zero");
+    }
+
+    /**
+     * @return Token IDs of the text or std::nullopt if the text is not cached.
+     */
+    std::optional<std::vector<int64_t>> find(const std::string& text, bool add_special_tokens) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(get_key(text, add_special_tokens));
+        if (it == m_index.end()) {
+            ++m_metrics.misses;
+            return std::nullopt;
+        }
+        ++m_metrics.hits;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->token_ids;
+    }
+
+    void insert(const std::string& text, bool add_special_tokens, std::vector<int64_t> token_ids) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string key = get_key(text, add_special_tokens);
+        if (m_index.find(key) != m_index.end())
+            return;
+        m_entries.push_front({key, std::move(token_ids)});
+        m_index.emplace(std::move(key), m_entries.begin());
+        if (m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().key);
+            m_entries.pop_back();
+        }
+    }
+
+    TokenizationCacheMetrics get_metrics() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+};
+
+}
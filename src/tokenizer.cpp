@@ -1,9 +1,15 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
 #include <jinja2cpp/template.h>
 #include <jinja2cpp/template_env.h>
 #include <jinja2cpp/user_callable.h>
@@ -15,6 +21,8 @@
 #include "openvino/genai/tokenizer.hpp"
 
 #include "make_tokenizer_stateful.hpp"
+#include "native_bpe_tokenizer.hpp"
+#include "tokenization_cache.hpp"
 #include "tokenizers_path.hpp"
 #include "circular_buffer_queue.hpp"
 #include "json_utils.hpp"
@@ -80,6 +88,35 @@ ov::Core get_core_singleton() {
     return core;
 }
 
+// widespread chat templates, which are rendered by string concatenation instead of jinja2cpp
+enum class ChatTemplateKind { JINJA, CHATML, LLAMA_3 };
+
+constexpr char chatml_template[] =
+    "{% for message in messages %}{{'<|im_start|>' + message['role'] + '\n' + message['content'] + '<|im_end|>' + '\n'}}{% endfor %}"
+    "{% if add_generation_prompt %}{{ '<|im_start|>assistant\n' }}{% endif %}";
+
+constexpr char llama_3_template[] =
+    "{% set loop_messages = messages %}{% for message in loop_messages %}{% set content = '<|start_header_id|>' + message['role'] + "
+    "'<|end_header_id|>\n\n'+ message['content'] | trim + '<|eot_id|>' %}{% if loop.index0 == 0 %}{% set content = bos_token + content %}"
+    "{% endif %}{{ content }}{% endfor %}{% if add_generation_prompt %}{{ '<|start_header_id|>assistant<|end_header_id|>\n\n' }}{% endif %}";
+
+// chat template parsed once and reused by subsequent apply_chat_template calls
+struct CompiledChatTemplate {
+    ChatTemplateKind kind = ChatTemplateKind::JINJA;
+    jinja2::TemplateEnv env;
+    jinja2::Template tpl{&env};
+    // jinja2cpp does not guarantee that a template can be rendered from several threads at once
+    std::mutex render_mutex;
+};
+
+std::string trim_whitespaces(const std::string& text) {
+    constexpr char whitespaces[] = " \t\n\r\v\f";
+    const size_t begin = text.find_first_not_of(whitespaces);
+    if (begin == std::string::npos)
+        return "";
+    return text.substr(begin, text.find_last_not_of(whitespaces) - begin + 1);
+}
+
 }  // namespace
 
 namespace ov {
@@ -92,6 +129,12 @@ public:
     
     std::unique_ptr<CircularBufferQueue<ov::InferRequest>> m_ireq_queue_tokenizer;
     std::unique_ptr<CircularBufferQueue<ov::InferRequest>> m_ireq_queue_detokenizer;
+    // requests reserved for short sequences, see ov::genai::streaming_detokenizer_infer_requests
+    std::unique_ptr<CircularBufferQueue<ov::InferRequest>> m_ireq_queue_streaming_detokenizer;
+    static constexpr size_t MAX_STREAMING_DECODE_TOKENS = 16;
+    size_t m_num_tokenizer_requests = 1;
+    // batches are split across idle tokenizer infer requests, if each of them gets at least this number of prompts
+    static constexpr size_t MIN_PARALLEL_SHARD_SIZE = 16;
     // To change the adding special tokens mode we use a statefull subgraph, 
     // this flag holds the current state value of the CompiledModel.
     bool m_add_special_tokens = true;
@@ -108,7 +151,18 @@ public:
 
     std::string m_chat_template = {};
 
-    void set_state_if_necessary(CircularBufferQueueElementGuard<ov::InferRequest>& infer_request_guard, const ov::AnyMap& params) {
+    // parsed chat templates by their text, so that a template is not parsed on every apply_chat_template call
+    mutable std::unordered_map<std::string, std::shared_ptr<CompiledChatTemplate>> m_compiled_chat_templates;
+    mutable std::mutex m_compiled_chat_templates_mutex;
+    static constexpr size_t MAX_COMPILED_CHAT_TEMPLATES = 16;
+
+    // optional C++ implementation used instead of OV models for supported inputs, see ov::genai::native_tokenizer
+    std::unique_ptr<NativeBPETokenizer> m_native_tokenizer;
+    // token IDs of recently encoded prompts, see ov::genai::tokenization_cache_size
+    std::unique_ptr<TokenizationCache> m_tokenization_cache;
+
+    // force sets states even if requested modes match the stored ones, e.g. when several requests are prepared concurrently
+    void set_state_if_necessary(CircularBufferQueueElementGuard<ov::InferRequest>& infer_request_guard, const ov::AnyMap& params, bool force = false) {
         bool add_special_tokens_flag = m_add_special_tokens;
         bool skip_special_tokens_flag = m_skip_special_tokens;
         ov::genai::utils::read_anymap_param(params, add_special_tokens.name(), add_special_tokens_flag);
@@ -117,7 +171,7 @@ public:
         // If user requested add_special_tokens mode different from the current one,
         // need to set state variable.
         // If requested mode matches the stored state set, then don't touch states.
-        if (add_special_tokens_flag == m_add_special_tokens && skip_special_tokens_flag == m_skip_special_tokens) {
+        if (!force && add_special_tokens_flag == m_add_special_tokens && skip_special_tokens_flag == m_skip_special_tokens) {
             return;
         }
         if (m_older_than_24_5) {
@@ -142,8 +196,11 @@ public:
                 state.set_state(skip_special_tensor);
             }
         }
-        m_add_special_tokens = add_special_tokens_flag;
-        m_skip_special_tokens = skip_special_tokens_flag;
+        // concurrent callers update stored modes themselves
+        if (!force) {
+            m_add_special_tokens = add_special_tokens_flag;
+            m_skip_special_tokens = skip_special_tokens_flag;
+        }
     }
 
     TokenizerImpl() = default;
@@ -173,7 +230,14 @@ public:
             ov_detokenizer = core.read_model(models_path / "openvino_detokenizer.xml");
         }
 
-        setupTokenizer(std::make_pair(ov_tokenizer, ov_detokenizer), properties);
+        ov::AnyMap compile_properties = properties;
+        bool use_native_tokenizer = false;
+        if (compile_properties.find(native_tokenizer.name()) != compile_properties.end()) {
+            use_native_tokenizer = compile_properties.at(native_tokenizer.name()).as<bool>();
+            compile_properties.erase(native_tokenizer.name());
+        }
+
+        setupTokenizer(std::make_pair(ov_tokenizer, ov_detokenizer), compile_properties);
 
         // If special tokens were not found from IR, try to read them from config.
         // This will be triggered only for IRs older than 2024.3.
@@ -189,13 +253,70 @@ public:
         if (m_chat_template.empty()) {
             m_chat_template = chat_template_from_tokenizer_json_if_exists(models_path);
         }
+
+        if (use_native_tokenizer) {
+            auto native = NativeBPETokenizer::from_tokenizer_json(models_path);
+            // probes are encoded by OV models without the cache
+            auto tokenization_cache = std::move(m_tokenization_cache);
+            if (native && is_consistent_with_ov_models(*native))
+                m_native_tokenizer = std::move(native);
+            m_tokenization_cache = std::move(tokenization_cache);
+        }
+    }
+
+    // checks that the native tokenizer reproduces results of OV models, e.g. that both are converted from the same tokenizer
+    bool is_consistent_with_ov_models(const NativeBPETokenizer& native) {
+        const std::string probes[] = {
+            "Hello world", "  multiple   spaces\n\nand\tnew lines ", "It's 2024, isn't it? Numbers: 1234567890!",
+            "don't 'quote' me ... ;-) they're we've I'm you'll he'd", "x"
+        };
+        for (const auto& probe : probes) {
+            auto token_ids = native.encode(probe);
+            if (!token_ids)
+                return false;
+            if (m_tokenizer) {
+                auto input_ids = encode(probe).input_ids;
+                if (!std::equal(token_ids->begin(), token_ids->end(), input_ids.data<const int64_t>(), input_ids.data<const int64_t>() + input_ids.get_size()))
+                    return false;
+            }
+            if (m_detokenizer) {
+                if (m_eos_token_id != -1)
+                    token_ids->push_back(m_eos_token_id);
+                // an incomplete multi-byte character is decoded to U+FFFD
+                const int64_t partial_char_id = native.get_byte_token_id(0xE4);
+                if (partial_char_id != -1)
+                    token_ids->push_back(partial_char_id);
+                for (bool skip : {true, false}) {
+                    if (native.decode(*token_ids, skip) != decode(*token_ids, {ov::genai::skip_special_tokens(skip)}))
+                        return false;
+                }
+            }
+        }
+        return true;
     }
     
 
-    void setupTokenizer(const std::pair<std::shared_ptr<ov::Model>, std::shared_ptr<ov::Model>>& models,  const ov::AnyMap& properties) {
+    void setupTokenizer(const std::pair<std::shared_ptr<ov::Model>, std::shared_ptr<ov::Model>>& models,  const ov::AnyMap& user_properties) {
         auto [ov_tokenizer, ov_detokenizer] = models;
         OPENVINO_ASSERT(ov_tokenizer || ov_detokenizer, "Neither tokenizer nor detokenzier models were provided");
 
+        ov::AnyMap properties = user_properties;
+        size_t cache_size = 0;
+        if (properties.find(tokenization_cache_size.name()) != properties.end()) {
+            cache_size = properties.at(tokenization_cache_size.name()).as<size_t>();
+            properties.erase(tokenization_cache_size.name());
+        }
+        size_t max_infer_requests = 0;
+        if (properties.find(tokenizer_max_infer_requests.name()) != properties.end()) {
+            max_infer_requests = properties.at(tokenizer_max_infer_requests.name()).as<size_t>();
+            properties.erase(tokenizer_max_infer_requests.name());
+        }
+        size_t num_streaming_requests = 0;
+        if (properties.find(streaming_detokenizer_infer_requests.name()) != properties.end()) {
+            num_streaming_requests = properties.at(streaming_detokenizer_infer_requests.name()).as<size_t>();
+            properties.erase(streaming_detokenizer_infer_requests.name());
+        }
+
         auto core = get_core_singleton();
         std::string device = "CPU"; // only CPU is supported for now
         
@@ -204,6 +325,17 @@ public:
         // Saving IR version was added only in 24.5, so if it's empty, then it's older than 24.5
         m_older_than_24_5 = version_str.empty();
 
+        // the detokenizer is compiled in background, while the tokenizer is compiled by this thread
+        std::future<ov::CompiledModel> detokenizer_compilation;
+        if (ov_detokenizer) {
+            detokenizer_compilation = std::async(std::launch::async, [&core, &ov_detokenizer, &device, &properties] () {
+                ov::pass::Manager manager_detok;
+                manager_detok.register_pass<MakeVocabDecoderSatateful>();
+                manager_detok.run_passes(ov_detokenizer);
+                return core.compile_model(ov_detokenizer, device, properties);
+            });
+        }
+
         if (ov_tokenizer) {
             ov::pass::Manager manager;
             manager.register_pass<MakeCombineSegmentsSatateful>();
@@ -211,25 +343,30 @@ public:
             m_tokenizer = core.compile_model(ov_tokenizer, device, properties);
             ov::genai::utils::print_compiled_model_properties(m_tokenizer, "OV Tokenizer");
 
+            m_num_tokenizer_requests = m_tokenizer.get_property(ov::optimal_number_of_infer_requests);
             m_ireq_queue_tokenizer = std::make_unique<CircularBufferQueue<ov::InferRequest>>(
-                m_tokenizer.get_property(ov::optimal_number_of_infer_requests),
+                m_num_tokenizer_requests,
                 [this]() -> ov::InferRequest {
                     return std::move(this->m_tokenizer.create_infer_request());
-                });
+                }, max_infer_requests);
         }
 
         if (ov_detokenizer) {
-            ov::pass::Manager manager_detok;
-            manager_detok.register_pass<MakeVocabDecoderSatateful>();
-            manager_detok.run_passes(ov_detokenizer);
-            m_detokenizer = core.compile_model(ov_detokenizer, device, properties);
+            m_detokenizer = detokenizer_compilation.get();
             ov::genai::utils::print_compiled_model_properties(m_detokenizer, "OV Detokenizer");
 
             m_ireq_queue_detokenizer = std::make_unique<CircularBufferQueue<ov::InferRequest>>(
                 m_detokenizer.get_property(ov::optimal_number_of_infer_requests),
                 [this]() -> ov::InferRequest {
                     return std::move(this->m_detokenizer.create_infer_request());
-                });
+                }, max_infer_requests);
+            if (num_streaming_requests > 0) {
+                m_ireq_queue_streaming_detokenizer = std::make_unique<CircularBufferQueue<ov::InferRequest>>(
+                    num_streaming_requests,
+                    [this]() -> ov::InferRequest {
+                        return std::move(this->m_detokenizer.create_infer_request());
+                    });
+            }
         }
         
         // Initialize tokenizer's cache to save time later.
@@ -256,6 +393,10 @@ public:
             if (m_eos_token_id != -1)
                 m_eos_token = decode(std::vector{m_eos_token_id});
         }
+
+        // created after warm up, so that it is not counted in metrics
+        if (cache_size > 0)
+            m_tokenization_cache = std::make_unique<TokenizationCache>(cache_size);
     }
 
     // load special tokens ids from config.json
@@ -387,21 +528,108 @@ public:
         OPENVINO_ASSERT(m_ireq_queue_tokenizer, "Either openvino_tokenizer.xml was not provided or it was not loaded correctly. "
                                                 "Tokenizer::encode is not available");
 
+        bool add_special_tokens_flag = m_add_special_tokens;
+        ov::genai::utils::read_anymap_param(tokenization_params, add_special_tokens.name(), add_special_tokens_flag);
+        if (m_tokenization_cache) {
+            if (auto token_ids = m_tokenization_cache->find(prompt, add_special_tokens_flag))
+                return make_tokenized_inputs(*token_ids);
+        }
+
+        // byte-level BPE post-processor does not add special tokens, so add_special_tokens does not change the result
+        if (m_native_tokenizer && is_native_compatible(tokenization_params, add_special_tokens.name())) {
+            if (auto token_ids = m_native_tokenizer->encode(prompt)) {
+                if (m_tokenization_cache)
+                    m_tokenization_cache->insert(prompt, add_special_tokens_flag, *token_ids);
+                return make_tokenized_inputs(*token_ids);
+            }
+        }
+
         CircularBufferQueueElementGuard<ov::InferRequest> infer_request_guard(this->m_ireq_queue_tokenizer.get());
         set_state_if_necessary(infer_request_guard, tokenization_params);
         size_t batch_size = 1;
         infer_request_guard.get().set_input_tensor(ov::Tensor{ov::element::string, {batch_size}, &prompt});
         infer_request_guard.get().start_async();
         infer_request_guard.get().wait();
-        return get_copied_results(
+        TokenizedInputs result = get_copied_results(
             infer_request_guard.get().get_tensor("input_ids"),
             infer_request_guard.get().get_tensor("attention_mask")
         );
+        if (m_tokenization_cache) {
+            const int64_t* input_ids_data = result.input_ids.data<const int64_t>();
+            m_tokenization_cache->insert(prompt, add_special_tokens_flag, std::vector<int64_t>(input_ids_data, input_ids_data + result.input_ids.get_size()));
+        }
+        return result;
+    }
+
+    // inputs of a single prompt without padding
+    static TokenizedInputs make_tokenized_inputs(const std::vector<int64_t>& token_ids) {
+        ov::Tensor input_ids(ov::element::i64, {1, token_ids.size()});
+        std::copy(token_ids.begin(), token_ids.end(), input_ids.data<int64_t>());
+        ov::Tensor attention_mask(ov::element::i64, input_ids.get_shape());
+        std::fill_n(attention_mask.data<int64_t>(), attention_mask.get_size(), 1);
+        return {input_ids, attention_mask};
+    }
+
+    TokenizedInputs encode_in_parallel(std::vector<std::string>& prompts, const ov::AnyMap& tokenization_params, size_t num_shards) {
+        // shards of prompts of similar length are padded less
+        std::vector<size_t> order(prompts.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&prompts] (size_t lhs, size_t rhs) {
+            return prompts[lhs].size() < prompts[rhs].size();
+        });
+
+        // each shard acquires its own infer request, so that a shard never waits for another one to release a request
+        const size_t shard_size = (prompts.size() + num_shards - 1) / num_shards;
+        std::vector<std::future<TokenizedInputs>> shard_results;
+        for (size_t begin = 0; begin < prompts.size(); begin += shard_size) {
+            const size_t end = std::min(begin + shard_size, prompts.size());
+            shard_results.push_back(std::async(std::launch::async, [this, &prompts, &order, &tokenization_params, begin, end] () {
+                std::vector<std::string> shard_prompts;
+                for (size_t i = begin; i < end; ++i)
+                    shard_prompts.push_back(prompts[order[i]]);
+                CircularBufferQueueElementGuard<ov::InferRequest> infer_request_guard(this->m_ireq_queue_tokenizer.get());
+                set_state_if_necessary(infer_request_guard, tokenization_params, true);
+                infer_request_guard.get().set_input_tensor(ov::Tensor{ov::element::string, {shard_prompts.size()}, shard_prompts.data()});
+                infer_request_guard.get().infer();
+                return get_copied_results(
+                    infer_request_guard.get().get_tensor("input_ids"),
+                    infer_request_guard.get().get_tensor("attention_mask")
+                );
+            }));
+        }
+
+        std::vector<TokenizedInputs> shards;
+        size_t max_length = 0;
+        for (auto& shard_result : shard_results) {
+            shards.push_back(shard_result.get());
+            max_length = std::max(max_length, shards.back().input_ids.get_shape().at(1));
+        }
+        ov::genai::utils::read_anymap_param(tokenization_params, add_special_tokens.name(), m_add_special_tokens);
+        ov::genai::utils::read_anymap_param(tokenization_params, skip_special_tokens.name(), m_skip_special_tokens);
+
+        // shards are right padded to the longest shard and rows are put back to the order of prompts
+        ov::Tensor input_ids(ov::element::i64, {prompts.size(), max_length});
+        ov::Tensor attention_mask(ov::element::i64, {prompts.size(), max_length});
+        std::fill_n(input_ids.data<int64_t>(), input_ids.get_size(), m_pad_token_id);
+        std::fill_n(attention_mask.data<int64_t>(), attention_mask.get_size(), 0);
+        size_t row = 0;
+        for (const auto& shard : shards) {
+            const size_t num_rows = shard.input_ids.get_shape().at(0), length = shard.input_ids.get_shape().at(1);
+            for (size_t i = 0; i < num_rows; ++i, ++row) {
+                std::copy_n(shard.input_ids.data<const int64_t>() + i * length, length, input_ids.data<int64_t>() + order[row] * max_length);
+                std::copy_n(shard.attention_mask.data<const int64_t>() + i * length, length, attention_mask.data<int64_t>() + order[row] * max_length);
+            }
+        }
+        return pad_left(input_ids, attention_mask);
     }
 
     TokenizedInputs encode(std::vector<std::string>& prompts, const ov::AnyMap& tokenization_params = {}) {
         OPENVINO_ASSERT(m_ireq_queue_tokenizer, "Either openvino_tokenizer.xml was not provided or it was not loaded correctly. "
                                                 "Tokenizer::encode is not available");
+        const size_t num_shards = std::min(m_num_tokenizer_requests, prompts.size() / MIN_PARALLEL_SHARD_SIZE);
+        if (num_shards > 1)
+            return encode_in_parallel(prompts, tokenization_params, num_shards);
+
         TokenizedInputs unpadded;
         {
             CircularBufferQueueElementGuard<ov::InferRequest> infer_request_guard(this->m_ireq_queue_tokenizer.get());
@@ -428,11 +656,30 @@ public:
         return {input_ids_, attention_mask_};
     }
 
+    // whether parameters of encode / decode call are supported by the native tokenizer
+    static bool is_native_compatible(const ov::AnyMap& params, const std::string& allowed_name) {
+        return std::all_of(params.begin(), params.end(), [&allowed_name] (const auto& param) { return param.first == allowed_name; });
+    }
+
+    std::optional<std::string> decode_natively(const std::vector<int64_t>& tokens, const ov::AnyMap& detokenization_params) {
+        if (!m_native_tokenizer || !is_native_compatible(detokenization_params, skip_special_tokens.name()))
+            return std::nullopt;
+        bool skip_special_tokens_flag = m_skip_special_tokens;
+        ov::genai::utils::read_anymap_param(detokenization_params, skip_special_tokens.name(), skip_special_tokens_flag);
+        return m_native_tokenizer->decode(tokens, skip_special_tokens_flag);
+    }
+
     std::string decode(std::vector<int64_t> tokens, const ov::AnyMap& detokenization_params = {}) {
         OPENVINO_ASSERT(m_detokenizer, "Detokenize model has not been provided. Tokenizer::decode is not available");
-
-        CircularBufferQueueElementGuard<ov::InferRequest> infer_request_guard(this->m_ireq_queue_detokenizer.get());
-        set_state_if_necessary(infer_request_guard, detokenization_params);
+        if (auto text = decode_natively(tokens, detokenization_params))
+            return *text;
+
+        // short sequences decoded by streamers and stop strings matching do not wait for requests busy with batches
+        const bool is_streaming = m_ireq_queue_streaming_detokenizer && tokens.size() <= MAX_STREAMING_DECODE_TOKENS;
+        CircularBufferQueueElementGuard<ov::InferRequest> infer_request_guard(
+            is_streaming ? m_ireq_queue_streaming_detokenizer.get() : m_ireq_queue_detokenizer.get());
+        // stored modes are tracked for the main pool only
+        set_state_if_necessary(infer_request_guard, detokenization_params, is_streaming);
         size_t batch_size = 1;
         infer_request_guard.get().set_input_tensor(ov::Tensor{ov::element::i64, {batch_size, tokens.size()}, tokens.data()});
         infer_request_guard.get().start_async();
@@ -458,6 +705,17 @@ public:
 
     std::vector<std::string> decode(std::vector<std::vector<int64_t>> lines, const ov::AnyMap& detokenization_params = {}) {
         OPENVINO_ASSERT(m_detokenizer, "Detokenize model has not been provided. Tokenizer::decode is not available");
+        if (m_native_tokenizer) {
+            std::vector<std::string> texts;
+            for (const auto& line : lines) {
+                auto text = decode_natively(line, detokenization_params);
+                if (!text)
+                    break;
+                texts.push_back(std::move(*text));
+            }
+            if (texts.size() == lines.size())
+                return texts;
+        }
 
         auto compare_lengths = [](const std::vector<int64_t>& a, const std::vector<int64_t>& b) {
             return a.size() < b.size();
@@ -527,17 +785,32 @@ public:
     std::string apply_chat_template(ChatHistory history,
                                     bool add_generation_prompt,
                                     const std::string& chat_template) const {
-        std::string chat_tpl = chat_template.empty() ? m_chat_template : patch_chat_template(chat_template);
+        const std::string& chat_tpl = chat_template.empty() ? m_chat_template : chat_template;
         OPENVINO_ASSERT(!chat_tpl.empty(),
                         "Chat template wasn't found. This may indicate that the model wasn't trained for chat scenario."
                         " Please add 'chat_template' to tokenizer_config.json to use the model in chat scenario."
                         " For more information see the section Troubleshooting in README.md");
-        jinja2::TemplateEnv env;
-        env.GetSettings().lstripBlocks = true;
-        env.GetSettings().trimBlocks = true;
-        jinja2::Template tpl(&env);
-        tpl.Load(chat_tpl);
-        
+        auto compiled_template = get_compiled_chat_template(chat_tpl);
+
+        if (compiled_template->kind == ChatTemplateKind::CHATML) {
+            std::string result;
+            for (const auto& message : history)
+                result += "<|im_start|>" + message.at("role") + "\n" + message.at("content") + "<|im_end|>\n";
+            if (add_generation_prompt)
+                result += "<|im_start|>assistant\n";
+            return result;
+        } else if (compiled_template->kind == ChatTemplateKind::LLAMA_3) {
+            std::string result;
+            for (size_t i = 0; i < history.size(); ++i) {
+                if (i == 0)
+                    result += m_bos_token;
+                result += "<|start_header_id|>" + history[i].at("role") + "<|end_header_id|>\n\n" + trim_whitespaces(history[i].at("content")) + "<|eot_id|>";
+            }
+            if (add_generation_prompt)
+                result += "<|start_header_id|>assistant<|end_header_id|>\n\n";
+            return result;
+        }
+
         jinja2::UserCallable slice_callable = jinja2::MakeCallable(
             [](const jinja2::GenericList& messages, const size_t& start) {
                 jinja2::ValuesList result;
@@ -571,7 +844,8 @@ public:
         };
 
         try {
-            return tpl.RenderAsString(params).value();
+            std::lock_guard<std::mutex> lock(compiled_template->render_mutex);
+            return compiled_template->tpl.RenderAsString(params).value();
         } catch (const std::exception& error) {
             OPENVINO_THROW("Chat template for the current model is not supported by Jinja2Cpp. "
                            "Please apply template manually to your prompt before calling generate. "
@@ -579,13 +853,56 @@ public:
         }
     }
 
+    // parses the template on the first use, templates are cached by their text before patching
+    std::shared_ptr<CompiledChatTemplate> get_compiled_chat_template(const std::string& chat_template) const {
+        std::lock_guard<std::mutex> lock(m_compiled_chat_templates_mutex);
+        auto it = m_compiled_chat_templates.find(chat_template);
+        if (it != m_compiled_chat_templates.end())
+            return it->second;
+
+        if (m_compiled_chat_templates.size() >= MAX_COMPILED_CHAT_TEMPLATES)
+            m_compiled_chat_templates.clear();
+        auto compiled_template = std::make_shared<CompiledChatTemplate>();
+        // patching is idempotent, so already patched templates give the same result
+        const std::string patched_template = patch_chat_template(chat_template);
+        if (patched_template == patch_chat_template(chatml_template)) {
+            compiled_template->kind = ChatTemplateKind::CHATML;
+        } else if (patched_template == patch_chat_template(llama_3_template)) {
+            compiled_template->kind = ChatTemplateKind::LLAMA_3;
+        } else {
+            compiled_template->env.GetSettings().lstripBlocks = true;
+            compiled_template->env.GetSettings().trimBlocks = true;
+            compiled_template->tpl.Load(patched_template);
+        }
+        m_compiled_chat_templates.emplace(chat_template, compiled_template);
+        return compiled_template;
+    }
+
     void set_chat_template(const std::string& chat_template) {
         m_chat_template = patch_chat_template(chat_template);
     }
 };
 
 Tokenizer::Tokenizer(const std::filesystem::path& tokenizer_path, const ov::AnyMap& properties) {
-    m_pimpl = std::make_shared<TokenizerImpl>(tokenizer_path, properties);
+    ov::AnyMap tokenizer_properties = properties;
+    bool is_deferred = false;
+    if (tokenizer_properties.find(deferred_load.name()) != tokenizer_properties.end()) {
+        is_deferred = tokenizer_properties.at(deferred_load.name()).as<bool>();
+        tokenizer_properties.erase(deferred_load.name());
+    }
+
+    if (is_deferred) {
+        m_deferred_pimpl = std::async(std::launch::async, [tokenizer_path, tokenizer_properties] () {
+            return std::make_shared<TokenizerImpl>(tokenizer_path, tokenizer_properties);
+        }).share();
+    } else {
+        m_pimpl = std::make_shared<TokenizerImpl>(tokenizer_path, tokenizer_properties);
+    }
+}
+
+const std::shared_ptr<Tokenizer::TokenizerImpl>& Tokenizer::get_pimpl() const {
+    // shared_future::get() is safe to call concurrently and rethrows an error of loading on each call
+    return m_deferred_pimpl.valid() ? m_deferred_pimpl.get() : m_pimpl;
 }
 
 Tokenizer::Tokenizer(
@@ -621,17 +938,17 @@ Tokenizer::Tokenizer(const std::string& model_str, ov::Tensor& weights_tensor, c
 
 TokenizedInputs Tokenizer::encode(const std::string prompt, const ov::AnyMap& tokenization_params) {
     check_arguments(tokenization_params, {ov::genai::add_special_tokens.name()});
-    return m_pimpl->encode(std::move(prompt), tokenization_params);
+    return get_pimpl()->encode(std::move(prompt), tokenization_params);
 }
 
 TokenizedInputs Tokenizer::encode(std::vector<std::string>& prompts, const ov::AnyMap& tokenization_params) {
     check_arguments(tokenization_params, {ov::genai::add_special_tokens.name()});
-    return m_pimpl->encode(prompts, tokenization_params);
+    return get_pimpl()->encode(prompts, tokenization_params);
 }
 
 TokenizedInputs Tokenizer::encode(std::vector<std::string>&& prompts, const ov::AnyMap& tokenization_params) {
     check_arguments(tokenization_params, {ov::genai::add_special_tokens.name()});
-    return m_pimpl->encode(prompts, tokenization_params);
+    return get_pimpl()->encode(prompts, tokenization_params);
 }
 
 TokenizedInputs Tokenizer::encode(std::initializer_list<std::string>& text, const ov::AnyMap& tokenization_params) {
@@ -641,52 +958,74 @@ TokenizedInputs Tokenizer::encode(std::initializer_list<std::string>& text, cons
 
 std::string Tokenizer::decode(std::vector<int64_t> tokens, const ov::AnyMap& detokenization_params) {
     check_arguments(detokenization_params, {ov::genai::skip_special_tokens.name()});
-    return m_pimpl->decode(tokens, detokenization_params);
+    return get_pimpl()->decode(tokens, detokenization_params);
 }
 
 std::vector<std::string> Tokenizer::decode(ov::Tensor tokens, const ov::AnyMap& detokenization_params) {
     check_arguments(detokenization_params, {ov::genai::skip_special_tokens.name()});
-    return m_pimpl->decode(tokens, detokenization_params);
+    return get_pimpl()->decode(tokens, detokenization_params);
 }
 
 std::vector<std::string> Tokenizer::decode(std::vector<std::vector<int64_t>> lines, const ov::AnyMap& detokenization_params) {
     check_arguments(detokenization_params, {ov::genai::skip_special_tokens.name()});
-    return m_pimpl->decode(lines, detokenization_params);
+    return get_pimpl()->decode(lines, detokenization_params);
 }
 
 
 int64_t Tokenizer::get_bos_token_id() const {
-    return m_pimpl->m_bos_token_id;
+    return get_pimpl()->m_bos_token_id;
 }
 
 int64_t Tokenizer::get_eos_token_id() const {
-    return m_pimpl->m_eos_token_id;
+    return get_pimpl()->m_eos_token_id;
 }
 
 int64_t Tokenizer::get_pad_token_id() const {
-    return m_pimpl->m_pad_token_id;
+    return get_pimpl()->m_pad_token_id;
 }
 
 std::string Tokenizer::get_pad_token() const {
-    return m_pimpl->m_pad_token;
+    return get_pimpl()->m_pad_token;
+}
+
+TokenizerInferRequestsMetrics Tokenizer::get_infer_requests_metrics() const {
+    TokenizerInferRequestsMetrics metrics;
+    std::chrono::steady_clock::duration total_wait_time{0};
+    for (auto* queue : {get_pimpl()->m_ireq_queue_tokenizer.get(), get_pimpl()->m_ireq_queue_detokenizer.get(),
+                        get_pimpl()->m_ireq_queue_streaming_detokenizer.get()}) {
+        if (!queue)
+            continue;
+        metrics.num_waits += queue->get_num_waits();
+        total_wait_time += queue->get_total_wait_time();
+    }
+    if (get_pimpl()->m_ireq_queue_tokenizer)
+        metrics.num_tokenizer_requests = get_pimpl()->m_ireq_queue_tokenizer->size();
+    if (get_pimpl()->m_ireq_queue_detokenizer)
+        metrics.num_detokenizer_requests = get_pimpl()->m_ireq_queue_detokenizer->size();
+    metrics.total_wait_ms = std::chrono::duration<float, std::milli>(total_wait_time).count();
+    return metrics;
+}
+
+TokenizationCacheMetrics Tokenizer::get_tokenization_cache_metrics() const {
+    return get_pimpl()->m_tokenization_cache ? get_pimpl()->m_tokenization_cache->get_metrics() : TokenizationCacheMetrics{};
 }
 
 std::string Tokenizer::get_bos_token() const {
-    return m_pimpl->m_bos_token;
+    return get_pimpl()->m_bos_token;
 }
 
 std::string Tokenizer::get_eos_token() const {
-    return m_pimpl->m_eos_token;
+    return get_pimpl()->m_eos_token;
 }
 
 std::string Tokenizer::apply_chat_template(ChatHistory history,
                                            bool add_generation_prompt,
                                            const std::string& chat_template) const {
-    return m_pimpl->apply_chat_template(history, add_generation_prompt, chat_template);
+    return get_pimpl()->apply_chat_template(history, add_generation_prompt, chat_template);
 }
 
 void Tokenizer::set_chat_template(const std::string& chat_template) {
-    m_pimpl->set_chat_template(chat_template);
+    get_pimpl()->set_chat_template(chat_template);
 }
 
 Tokenizer::~Tokenizer() = default;
@@ -0,0 +1,126 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "tracing.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "openvino/core/except.hpp"
+#include "json_utils.hpp"
+
+namespace {
+
+using ov::genai::Tracer;
+
+// events per thread, the oldest ones are overwritten
+constexpr size_t TRACE_BUFFER_CAPACITY = 1 << 16;
+
+struct TraceEvent {
+    const char* name;
+    Tracer::Clock::time_point start, end;
+};
+
+struct ThreadTraceBuffer {
+    // taken by the owning thread for each event and by write() only, so it's not contended while recording
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    size_t num_recorded = 0;
+    size_t thread_index;
+
+    explicit ThreadTraceBuffer(size_t thread_index) : events(TRACE_BUFFER_CAPACITY), thread_index(thread_index) {}
+};
+
+struct TraceRegistry {
+    std::string path;
+    Tracer::Clock::time_point origin = Tracer::Clock::now();
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    std::set<std::string> names;
+
+    TraceRegistry() {
+        const char* trace_path = std::getenv("OPENVINO_GENAI_TRACE");
+        if (trace_path != nullptr && trace_path[0] != '\0') {
+            path = trace_path;
+            std::atexit([] {
+                try {
+                    Tracer::write(registry().path);
+                } catch (const std::exception& error) {
+                    std::cerr << "Failed to write OpenVINO GenAI trace: " << error.what() << std::endl;
+                }
+            });
+        }
+    }
+
+    // never destroyed, so that threads finishing after static destructors and atexit handler can still record
+    static TraceRegistry& registry() {
+        static TraceRegistry* instance = new TraceRegistry();
+        return *instance;
+    }
+};
+
+ThreadTraceBuffer& get_thread_buffer() {
+    thread_local std::shared_ptr<ThreadTraceBuffer> buffer = [] {
+        TraceRegistry& registry = TraceRegistry::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.push_back(std::make_shared<ThreadTraceBuffer>(registry.buffers.size()));
+        return registry.buffers.back();
+    }();
+    return *buffer;
+}
+
+}  // namespace
+
+namespace ov::genai {
+
+bool Tracer::is_enabled() {
+    static const bool enabled = !TraceRegistry::registry().path.empty();
+    return enabled;
+}
+
+const char* Tracer::intern(const std::string& name) {
+    TraceRegistry& registry = TraceRegistry::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.names.insert(name).first->c_str();
+}
+
+void Tracer::record(const char* name, Clock::time_point start, Clock::time_point end) {
+    ThreadTraceBuffer& buffer = get_thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.num_recorded % TRACE_BUFFER_CAPACITY] = {name, start, end};
+    ++buffer.num_recorded;
+}
+
+void Tracer::write(const std::filesystem::path& path) {
+    TraceRegistry& registry = TraceRegistry::registry();
+    auto to_us = [&registry](Clock::time_point time) {
+        return std::chrono::duration<double, std::micro>(time - registry.origin).count();
+    };
+
+    nlohmann::json events = nlohmann::json::array();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", buffer->thread_index},
+                          {"args", {{"name", "thread " + std::to_string(buffer->thread_index)}}}});
+        const size_t num_events = std::min(buffer->num_recorded, TRACE_BUFFER_CAPACITY);
+        for (size_t i = buffer->num_recorded - num_events; i < buffer->num_recorded; ++i) {
+            const TraceEvent& event = buffer->events[i % TRACE_BUFFER_CAPACITY];
+            events.push_back({{"name", event.name}, {"ph", "X"}, {"pid", 0}, {"tid", buffer->thread_index},
+                              {"ts", to_us(event.start)}, {"dur", to_us(event.end) - to_us(event.start)}});
+        }
+    }
+
+    std::ofstream file(path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", path.string(), " to write trace");
+    file << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump();
+}
+
+}  // namespace ov::genai
@@ -0,0 +1,50 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace ov::genai {
+
+// Timeline of scoped events of all pipelines, which is written in Chrome trace event format, readable by chrome://tracing
+// and Perfetto UI. Tracing is enabled by OPENVINO_GENAI_TRACE environment variable set to a path of JSON file, which is
+// written at process exit. Each thread records events to its own ring buffer, which keeps the latest events only, so
+// tracing may stay enabled in long running services. When tracing is disabled, recording costs a single branch.
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static bool is_enabled();
+
+    // returns a pointer to a copy of `name`, which lives until process exit and can be passed to record()
+    static const char* intern(const std::string& name);
+
+    // `name` must outlive the tracer, e.g. be a string literal or a result of intern()
+    static void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // writes events recorded so far by all threads
+    static void write(const std::filesystem::path& path);
+};
+
+// Records an event spanning the lifetime of the object
+class ScopedTrace {
+    const char* m_name;
+    Tracer::Clock::time_point m_start;
+public:
+    explicit ScopedTrace(const char* name) : m_name(Tracer::is_enabled() ? name : nullptr) {
+        if (m_name)
+            m_start = Tracer::Clock::now();
+    }
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    ~ScopedTrace() {
+        if (m_name)
+            Tracer::record(m_name, m_start, Tracer::Clock::now());
+    }
+};
+
+}  // namespace ov::genai
@@ -3,15 +3,37 @@
 
 #include "utils.hpp"
 
+#include <cmath>
 #include <fstream>
-
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <unistd.h>
+#endif
+
+#include "openvino/core/attribute_visitor.hpp"
 #include "openvino/op/add.hpp"
+#include "openvino/op/constant.hpp"
 #include "openvino/op/divide.hpp"
 #include "openvino/op/multiply.hpp"
 #include "openvino/op/matmul.hpp"
 #include "openvino/op/slice.hpp"
 #include "openvino/op/tanh.hpp"
 #include "openvino/op/transpose.hpp"
+#include "openvino/runtime/intel_gpu/properties.hpp"
 
 #include "sampler.hpp"
 
@@ -236,6 +258,142 @@ std::pair<ov::AnyMap, SchedulerConfig> split_scheduler_config(const ov::AnyMap&
     return {plugin_config, scheduler_config};
 };
 
+ov::AnyMap apply_expected_concurrency(const ov::AnyMap& properties, const std::string& device, size_t model_byte_size) {
+    auto it = properties.find(ov::genai::expected_concurrency.name());
+    if (it == properties.end())
+        return properties;
+    ov::AnyMap config = properties;
+    const size_t concurrency = it->second.as<size_t>();
+    config.erase(ov::genai::expected_concurrency.name());
+    // a single request is served by the stateful pipeline with the lowest per-step overhead, NPU has its own static pipeline
+    if (concurrency <= 1 || device == "NPU" || config.find(ov::genai::scheduler_config.name()) != config.end())
+        return config;
+
+    constexpr double GB = 1024.0 * 1024.0 * 1024.0;
+    const double model_gb = model_byte_size / GB;
+    const bool is_gpu = device.find("GPU") != std::string::npos;
+
+    SchedulerConfig scheduler_config;
+    scheduler_config.max_num_seqs = concurrency;
+    scheduler_config.dynamic_split_fuse = true;
+    // GPU is saturated by a larger number of tokens per step than CPU, which is compute bound already on short prompts of large models
+    scheduler_config.max_num_batched_tokens = is_gpu ? 2048 : (model_gb > 4.0 ? 256 : 512);
+    // each running sequence needs a token per step in generation phase
+    scheduler_config.max_num_batched_tokens = std::max(scheduler_config.max_num_batched_tokens, concurrency);
+
+    // KV cache size per token and size of weights both grow with the number of layers and the hidden size, so weights are used
+    // as a proxy of KV cache per token; 1/8 of weights per request fits a few thousand tokens of context for typical decoder models
+    double cache_gb = std::max(1.0, std::ceil(model_gb * concurrency / 8.0));
+    if (is_gpu) {
+        try {
+            const double device_gb = utils::singleton_core().get_property(device, ov::intel_gpu::device_total_mem_size) / GB;
+            // leave some device memory to activations of the model
+            cache_gb = std::min(cache_gb, std::max(1.0, std::floor(0.9 * device_gb - model_gb)));
+        } catch (const ov::Exception&) {
+            // total memory is not reported by the device, the estimation is used as is
+        }
+    }
+    scheduler_config.cache_size = static_cast<size_t>(cache_gb);
+
+    config[ov::genai::scheduler_config.name()] = scheduler_config;
+    return config;
+}
+
+ov::Tensor create_warmup_input_ids(size_t batch_size, size_t prompt_length, size_t seed) {
+    ov::Tensor input_ids(ov::element::i64, {batch_size, prompt_length});
+    int64_t* data = input_ids.data<int64_t>();
+    // ids below 1000 are valid for any vocabulary, 0 is skipped as it is often a special token
+    for (size_t row = 0; row < batch_size; ++row) {
+        for (size_t position = 0; position < prompt_length; ++position) {
+            data[row * prompt_length + position] = 1 + static_cast<int64_t>((seed * 7919 + row * 104729 + position * 31) % 997);
+        }
+    }
+    return input_ids;
+}
+
+namespace {
+
+size_t get_available_host_memory() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    OPENVINO_ASSERT(GlobalMemoryStatusEx(&status), "Failed to query available host memory");
+    return static_cast<size_t>(status.ullAvailPhys);
+#elif defined(__APPLE__)
+    vm_statistics64_data_t statistics;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    OPENVINO_ASSERT(host_statistics64(mach_host_self(), HOST_VM_INFO64, reinterpret_cast<host_info64_t>(&statistics), &count) == KERN_SUCCESS,
+                    "Failed to query available host memory");
+    // inactive pages are reclaimed by the OS on demand
+    return static_cast<size_t>(statistics.free_count + statistics.inactive_count) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    // MemAvailable also counts page cache and other reclaimable memory, unlike MemFree
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        size_t kilobytes = 0;
+        if (fields >> name >> kilobytes && name == "MemAvailable:")
+            return kilobytes * 1024;
+    }
+    OPENVINO_THROW("Failed to query available host memory from /proc/meminfo");
+#endif
+}
+
+}  // namespace
+
+size_t get_available_memory(ov::Core& core, const std::string& device) {
+    if (device.find("GPU") == std::string::npos)
+        return get_available_host_memory();
+    const size_t total_bytes = core.get_property(device, ov::intel_gpu::device_total_mem_size);
+    size_t allocated_bytes = 0;
+    // allocations of all kinds are counted, including host ones, since integrated GPUs share memory with the host
+    for (const auto& [allocation_type, num_bytes] : core.get_property(device, ov::intel_gpu::memory_statistics))
+        allocated_bytes += num_bytes;
+    return total_bytes > allocated_bytes ? total_bytes - allocated_bytes : 0;
+}
+
+bool extract_fast_startup(ov::AnyMap& properties, const std::filesystem::path& models_path) {
+    auto it = properties.find(ov::genai::fast_startup.name());
+    if (it == properties.end())
+        return false;
+    const bool fast_startup = it->second.as<bool>();
+    properties.erase(it);
+    if (!fast_startup || properties.find(ov::cache_dir.name()) != properties.end())
+        return fast_startup;
+
+    // a warm cache is imported even from a read-only directory, while a cold one is used only if it can be filled
+    const std::filesystem::path cache_dir = models_path / "openvino_model_cache";
+    std::error_code error_code;
+    const bool is_warm = std::filesystem::is_directory(cache_dir, error_code) && !std::filesystem::is_empty(cache_dir, error_code) && !error_code;
+    if (!is_warm) {
+        std::filesystem::create_directories(cache_dir, error_code);
+        const std::filesystem::path probe_path = cache_dir / ".write_probe";
+        const bool is_writable = !error_code && std::ofstream(probe_path).good();
+        std::filesystem::remove(probe_path, error_code);
+        if (!is_writable)
+            return fast_startup;
+    }
+    properties[ov::cache_dir.name()] = cache_dir.string();
+    return fast_startup;
+}
+
+size_t get_model_weights_byte_size(const std::filesystem::path& models_path) {
+    std::error_code error_code;
+    const auto byte_size = std::filesystem::file_size(models_path / "openvino_model.bin", error_code);
+    return error_code ? 0 : static_cast<size_t>(byte_size);
+}
+
+size_t get_model_weights_byte_size(const std::shared_ptr<ov::Model>& model) {
+    size_t byte_size = 0;
+    for (const auto& op : model->get_ordered_ops()) {
+        if (auto constant = std::dynamic_pointer_cast<ov::op::v0::Constant>(op))
+            byte_size += constant->get_byte_size();
+    }
+    return byte_size;
+}
+
 std::shared_ptr<ov::Model> read_model_with_config(const std::filesystem::path& models_path, const ov::AnyMap& properties) {
     auto [core_properties, compile_properties] = split_core_compile_config(properties);
     ov::Core core;
@@ -308,6 +466,227 @@ ov::Core singleton_core() {
     return core;
 }
 
+std::vector<std::string> split_model_between_devices(ov::Core& core,
+                                                     const std::shared_ptr<ov::Model>& model,
+                                                     const std::vector<std::string>& devices,
+                                                     const ov::AnyMap& properties,
+                                                     size_t num_decoder_layers) {
+    std::string hetero_device = "HETERO:";
+    for (size_t i = 0; i < devices.size(); ++i)
+        hetero_device += (i > 0 ? "," : "") + devices[i];
+    ov::AnyMap query_properties = properties;
+    query_properties[ov::hint::model_distribution_policy.name()] =
+        std::set<ov::hint::ModelDistributionPolicy>{ov::hint::ModelDistributionPolicy::PIPELINE_PARALLEL};
+    const ov::SupportedOpsMap placement = core.query_model(model, hetero_device, query_properties);
+
+    for (const auto& op : model->get_ops()) {
+        auto it = placement.find(op->get_friendly_name());
+        OPENVINO_ASSERT(it != placement.end(), "Operation ", op->get_friendly_name(), " is not supported by ", hetero_device);
+        op->get_rt_info()["affinity"] = it->second;
+    }
+
+    const std::string key_cache_prefix = "key_cache.";
+    std::vector<std::string> layer_devices(num_decoder_layers);
+    for (const auto& parameter : model->get_parameters()) {
+        const std::string& name = parameter->get_output_tensor(0).get_any_name();
+        if (name.compare(0, key_cache_prefix.size(), key_cache_prefix) != 0)
+            continue;
+        const size_t decoder_layer_id = std::stoul(name.substr(key_cache_prefix.size()));
+        const auto consumers = parameter->output(0).get_target_inputs();
+        OPENVINO_ASSERT(decoder_layer_id < num_decoder_layers && !consumers.empty(), "Unexpected KV cache input ", name);
+        layer_devices[decoder_layer_id] = placement.at(consumers.begin()->get_node()->get_friendly_name());
+    }
+    return layer_devices;
+}
+
+namespace {
+
+void hash_combine(size_t& hash, size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+void hash_combine(size_t& hash, std::string_view value) {
+    hash_combine(hash, std::hash<std::string_view>{}(value));
+}
+
+void hash_rt_info(size_t& hash, const ov::RTMap& rt_info) {
+    for (const auto& [name, value] : rt_info) {
+        hash_combine(hash, name);
+        try {
+            hash_combine(hash, value.as<std::string>());
+        } catch (const ov::Exception&) {
+            // values, which cannot be printed, are identified by their names only
+        }
+    }
+}
+
+size_t get_model_hash(const std::shared_ptr<const ov::Model>& model);
+
+// hashes attributes of an operation visited by ov::Node::visit_attributes
+class AttributeHasher : public ov::AttributeVisitor {
+    size_t& m_hash;
+
+    template <typename T>
+    void _hash_value(const std::string& name, const T& value) {
+        hash_combine(m_hash, name);
+        hash_combine(m_hash, std::hash<T>{}(value));
+    }
+
+    template <typename T>
+    void _hash_values(const std::string& name, const std::vector<T>& values) {
+        hash_combine(m_hash, name);
+        hash_combine(m_hash, values.size());
+        for (const auto& value : values)
+            hash_combine(m_hash, std::hash<T>{}(value));
+    }
+
+public:
+    explicit AttributeHasher(size_t& hash) : m_hash(hash) {}
+
+    void on_adapter(const std::string& name, ov::ValueAccessor<void>& adapter) override {
+        // attributes of other types are identified by their names and types only
+        hash_combine(m_hash, name);
+        hash_combine(m_hash, adapter.get_type_info().name);
+    }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::string>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<bool>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<int8_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<int16_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<int32_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<int64_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<uint8_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<uint16_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<uint32_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<uint64_t>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<float>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<double>& adapter) override { _hash_value(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<int8_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<int16_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<int32_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<int64_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<uint8_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<uint16_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<uint32_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<uint64_t>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<float>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<double>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::vector<std::string>>& adapter) override { _hash_values(name, adapter.get()); }
+    void on_adapter(const std::string& name, ov::ValueAccessor<std::shared_ptr<ov::Model>>& adapter) override {
+        // bodies of operations like Loop or If
+        hash_combine(m_hash, name);
+        hash_combine(m_hash, get_model_hash(adapter.get()));
+    }
+};
+
+// hashes the whole graph: types, attributes and runtime info of operations, edges between them, types, shapes and names of their
+// outputs and all data of constants, so that only identical models get the same hash
+size_t get_model_hash(const std::shared_ptr<const ov::Model>& model) {
+    size_t hash = 0;
+    AttributeHasher attribute_hasher(hash);
+    hash_rt_info(hash, model->get_rt_info());
+
+    std::unordered_map<const ov::Node*, size_t> op_indices;
+    for (const auto& op : model->get_ordered_ops()) {
+        op_indices.emplace(op.get(), op_indices.size());
+        hash_combine(hash, op->get_type_info().name);
+        hash_combine(hash, op->get_type_info().get_version());
+        for (const auto& input : op->inputs()) {
+            const auto source = input.get_source_output();
+            hash_combine(hash, op_indices.at(source.get_node()));
+            hash_combine(hash, source.get_index());
+        }
+        for (const auto& output : op->outputs()) {
+            hash_combine(hash, output.get_element_type().get_type_name());
+            hash_combine(hash, output.get_partial_shape().to_string());
+            // tensor names are unordered
+            size_t names_hash = 0;
+            for (const auto& name : output.get_names())
+                names_hash += std::hash<std::string>{}(name);
+            hash_combine(hash, names_hash);
+        }
+        hash_rt_info(hash, op->get_rt_info());
+
+        if (auto constant = ov::as_type_ptr<ov::op::v0::Constant>(op)) {
+            // data is hashed directly, since visiting attributes of a constant resets its cached state
+            hash_combine(hash, std::string_view(static_cast<const char*>(constant->get_data_ptr()), constant->get_byte_size()));
+        } else {
+            op->visit_attributes(attribute_hasher);
+        }
+    }
+    // order of parameters and results defines indices of model inputs and outputs
+    for (const auto& parameter : model->get_parameters())
+        hash_combine(hash, op_indices.at(parameter.get()));
+    for (const auto& result : model->get_results())
+        hash_combine(hash, op_indices.at(result.get()));
+    return hash;
+}
+
+}  // namespace
+
+std::string get_model_fingerprint(const std::shared_ptr<const ov::Model>& model) {
+    return model->get_friendly_name() + "_" + std::to_string(get_model_hash(model));
+}
+
+std::shared_ptr<ov::CompiledModel> compile_shared_model(ov::Core& core,
+                                                        const std::shared_ptr<ov::Model>& model,
+                                                        const std::string& device,
+                                                        const ov::AnyMap& properties) {
+    std::string key = get_model_fingerprint(model) + "|" + device;
+    for (const auto& [name, value] : properties) {
+        try {
+            key += "|" + name + "=" + value.as<std::string>();
+        } catch (const ov::Exception&) {
+            // values, which cannot be compared, make the compiled model private
+            return std::make_shared<ov::CompiledModel>(core.compile_model(model, device, properties));
+        }
+    }
+
+    using SharedCompiledModel = std::shared_future<std::weak_ptr<ov::CompiledModel>>;
+    static std::mutex mutex;
+    static std::map<std::string, SharedCompiledModel> compiled_models;
+    while (true) {
+        // the lock is held only to look up the model, so that different models are compiled concurrently, while pipelines
+        // created concurrently for the same model wait for a single compilation
+        std::promise<std::weak_ptr<ov::CompiledModel>> promise;
+        SharedCompiledModel shared_compiled_model;
+        bool is_compiled_by_this_thread = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = compiled_models.begin(); it != compiled_models.end();) {
+                bool is_expired = it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready && it->second.get().expired();
+                it = is_expired ? compiled_models.erase(it) : std::next(it);
+            }
+            auto it = compiled_models.find(key);
+            if (it == compiled_models.end()) {
+                it = compiled_models.emplace(key, promise.get_future().share()).first;
+                is_compiled_by_this_thread = true;
+            }
+            shared_compiled_model = it->second;
+        }
+
+        if (!is_compiled_by_this_thread) {
+            // rethrows the exception of a failed compilation
+            if (auto compiled_model = shared_compiled_model.get().lock())
+                return compiled_model;
+            // the model was destroyed after its compilation, so the expired entry is replaced by the next iteration
+            continue;
+        }
+
+        try {
+            auto compiled_model = std::make_shared<ov::CompiledModel>(core.compile_model(model, device, properties));
+            promise.set_value(compiled_model);
+            return compiled_model;
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                compiled_models.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+}
+
 size_t get_first_history_difference(const ov::Tensor& encoded_history, const std::vector<int64_t> tokenized_history, std::set<int64_t> stop_tokens) {
     size_t idx = 0;
     auto encoded_history_data = encoded_history.data<int64_t>();
@@ -369,11 +748,12 @@ void trim_kv_cache(ov::InferRequest request, uint64_t remove_from_end, size_t se
         auto shape = old_tensor.get_shape();
         shape[seq_length_axis] -= remove_from_end;
 
-        ov::Coordinate new_shape_begin{0, 0, 0, 0};
+        ov::Coordinate new_shape_begin(shape.size(), 0);
         ov::Coordinate new_shape_end{shape};
 
         auto trimmed_tensor = ov::Tensor(old_tensor, new_shape_begin, new_shape_end);
 
+        // the view is copied, since get_state may return the internal buffer of the variable, which set_state overwrites
         ov::Tensor new_tensor(old_tensor.get_element_type(), shape);
         trimmed_tensor.copy_to(new_tensor);
 
@@ -102,6 +102,40 @@ ProcessorConfig from_any_map(
 std::pair<ov::AnyMap, ov::AnyMap> split_core_compile_config(const ov::AnyMap& properties);
 std::pair<ov::AnyMap, SchedulerConfig> split_scheduler_config(const ov::AnyMap& properties);
 
+/**
+ * Replaces ov::genai::expected_concurrency property by ov::genai::scheduler_config chosen by a cost model, if more than one
+ * concurrent request is expected, so that LLMPipeline selects continuous batching backend. Properties without expected_concurrency
+ * or with an explicit scheduler_config are returned as is.
+ * @param device Device the model is compiled for.
+ * @param model_byte_size Size of model weights, 0 if unknown.
+ */
+ov::AnyMap apply_expected_concurrency(const ov::AnyMap& properties, const std::string& device, size_t model_byte_size);
+
+/**
+ * @return input_ids of shape [batch_size, prompt_length] for warmup, whose rows start differently for different rows and seeds,
+ * so that prompts of warmup are prefilled in full instead of being found in prefix cache.
+ */
+ov::Tensor create_warmup_input_ids(size_t batch_size, size_t prompt_length, size_t seed);
+
+/**
+ * Removes ov::genai::fast_startup from properties and, if it is true, sets ov::cache_dir to `openvino_model_cache` directory next to
+ * the models, unless ov::cache_dir is already set or the directory neither contains a cache nor can be created.
+ * @return Value of ov::genai::fast_startup, false if it is not set.
+ */
+bool extract_fast_startup(ov::AnyMap& properties, const std::filesystem::path& models_path);
+
+// size of openvino_model.bin in the directory, 0 if it does not exist
+size_t get_model_weights_byte_size(const std::filesystem::path& models_path);
+
+// total size of constants of the model
+size_t get_model_weights_byte_size(const std::shared_ptr<ov::Model>& model);
+
+/**
+ * @return Memory, which is currently free for new allocations of the device: device memory not allocated by the GPU plugin
+ * or host memory available to the process on CPU.
+ */
+size_t get_available_memory(ov::Core& core, const std::string& device);
+
 std::shared_ptr<ov::Model> read_model_with_config(const std::filesystem::path& models_path, const ov::AnyMap& properties);
 
 ov::genai::TokenizedInputs subtract_chat_tokenized_inputs(const ov::genai::TokenizedInputs& minuend, const ov::genai::TokenizedInputs& subtrahend);
@@ -110,6 +144,29 @@ void slice_matmul_statefull_model(std::shared_ptr<ov::Model> model);
 
 ov::Core singleton_core();
 
+/**
+ * Splits the model into consecutive parts placed on the given devices by HETERO pipeline parallelism according to their memory,
+ * and pins the placement by affinities of operations, so that the compiled model matches the returned layer placement.
+ * @return Device of each decoder layer, i.e. of the paged attention operation reading `key_cache.<layer>`.
+ */
+std::vector<std::string> split_model_between_devices(ov::Core& core,
+                                                     const std::shared_ptr<ov::Model>& model,
+                                                     const std::vector<std::string>& devices,
+                                                     const ov::AnyMap& properties,
+                                                     size_t num_decoder_layers);
+
+// identifies a model by a hash of the whole graph including all weights, since model names are not unique
+std::string get_model_fingerprint(const std::shared_ptr<const ov::Model>& model);
+
+/**
+ * Compiles the model or returns the model, which is compiled for the same device and properties by another pipeline and
+ * is still alive, see ov::genai::share_compiled_model. Models are compared by fingerprints of their whole graphs.
+ */
+std::shared_ptr<ov::CompiledModel> compile_shared_model(ov::Core& core,
+                                                        const std::shared_ptr<ov::Model>& model,
+                                                        const std::string& device,
+                                                        const ov::AnyMap& properties);
+
 template <typename T>
 void read_rt_info(std::shared_ptr<ov::Model>& model, const char* name, T& value);
 
@@ -0,0 +1,126 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "utils/numa_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+namespace ov {
+namespace genai {
+namespace utils {
+
+namespace {
+
+// max number of threads touching memory of a single NUMA node, beyond that memory bandwidth is saturated anyway
+constexpr size_t MAX_NUM_THREADS_PER_NODE = 8;
+
+// parses lists like "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string& cpu_list) {
+    std::vector<int> cpus;
+    std::stringstream stream(cpu_list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n")
+            continue;
+        size_t dash_pos = range.find('-');
+        int first = std::stoi(range.substr(0, dash_pos));
+        int last = dash_pos == std::string::npos ? first : std::stoi(range.substr(dash_pos + 1));
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+void bind_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpu_set);
+    }
+    // failure only results in a less optimal pages placement
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#else
+    (void)cpus;
+#endif
+}
+
+// zeroes the `thread_idx`-th of `num_threads` equal slices of each tensor
+void zero_slices(const std::vector<ov::Tensor>& tensors, size_t thread_idx, size_t num_threads) {
+    for (const auto& tensor : tensors) {
+        size_t slice_size = (tensor.get_byte_size() + num_threads - 1) / num_threads;
+        size_t begin = std::min(tensor.get_byte_size(), thread_idx * slice_size);
+        size_t end = std::min(tensor.get_byte_size(), begin + slice_size);
+        std::memset(static_cast<char*>(tensor.data()) + begin, 0, end - begin);
+    }
+}
+
+}  // namespace
+
+std::vector<std::vector<int>> get_numa_node_cpus() {
+    std::vector<std::vector<int>> node_cpus;
+#ifdef __linux__
+    for (size_t node_idx = 0; ; ++node_idx) {
+        std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(node_idx) + "/cpulist");
+        if (!cpu_list_file.is_open())
+            break;
+        std::string cpu_list;
+        std::getline(cpu_list_file, cpu_list);
+        auto cpus = parse_cpu_list(cpu_list);
+        // nodes without CPUs (e.g. memory expanders) are not used for first touch
+        if (!cpus.empty())
+            node_cpus.push_back(std::move(cpus));
+    }
+#endif
+    return node_cpus;
+}
+
+void parallel_first_touch(const std::vector<std::vector<ov::Tensor>>& tensor_groups, bool interleave_numa_nodes) {
+    std::vector<std::vector<int>> node_cpus;
+    if (interleave_numa_nodes)
+        node_cpus = get_numa_node_cpus();
+    if (node_cpus.size() < 2) {
+        // a single group of unbound threads
+        size_t num_cpus = std::max(1u, std::thread::hardware_concurrency());
+        node_cpus = {std::vector<int>(num_cpus, -1)};
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t node_idx = 0; node_idx < node_cpus.size(); ++node_idx) {
+        std::vector<ov::Tensor> node_tensors;
+        for (size_t group_idx = node_idx; group_idx < tensor_groups.size(); group_idx += node_cpus.size()) {
+            node_tensors.insert(node_tensors.end(), tensor_groups[group_idx].begin(), tensor_groups[group_idx].end());
+        }
+        if (node_tensors.empty())
+            continue;
+
+        const auto& cpus = node_cpus[node_idx];
+        bool is_bound = node_cpus.size() > 1;
+        size_t num_threads = std::min(cpus.size(), MAX_NUM_THREADS_PER_NODE);
+        for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+            threads.emplace_back([node_tensors, &cpus, is_bound, thread_idx, num_threads] {
+                if (is_bound)
+                    bind_current_thread(cpus);
+                zero_slices(node_tensors, thread_idx, num_threads);
+            });
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace utils
+}  // namespace genai
+}  // namespace ov
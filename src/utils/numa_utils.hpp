@@ -0,0 +1,29 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+
+#include "openvino/runtime/tensor.hpp"
+
+namespace ov {
+namespace genai {
+namespace utils {
+
+/**
+ * @return Logical CPU indices of each NUMA node of the host. Empty if NUMA topology is not available on the platform.
+ */
+std::vector<std::vector<int>> get_numa_node_cpus();
+
+/**
+ * Zeroes host tensors by several threads at once, so that their memory pages are allocated by the OS in parallel ("first touch").
+ * @param tensor_groups Groups of host tensors to be zeroed, e.g. key and value caches of a single layer.
+ * @param interleave_numa_nodes If true and the host has several NUMA nodes, tensors of the i-th group are touched by threads bound to
+ * the (i % num_nodes)-th node, so that their pages are placed on that node and groups are spread evenly over all nodes.
+ */
+void parallel_first_touch(const std::vector<std::vector<ov::Tensor>>& tensor_groups, bool interleave_numa_nodes);
+
+}  // namespace utils
+}  // namespace genai
+}  // namespace ov
@@ -3,8 +3,26 @@
 
 #include "utils/paged_attention_transformations.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "openvino/pass/manager.hpp"
 #include "openvino/pass/sdpa_to_paged_attention.hpp"
+#include "openvino/op/add.hpp"
+#include "openvino/op/concat.hpp"
+#include "openvino/op/constant.hpp"
+#include "openvino/op/convert.hpp"
+#include "openvino/op/gather.hpp"
+#include "openvino/op/gather_elements.hpp"
+#include "openvino/op/log_softmax.hpp"
+#include "openvino/op/matmul.hpp"
+#include "openvino/op/parameter.hpp"
+#include "openvino/op/reshape.hpp"
+#include "openvino/op/result.hpp"
+#include "openvino/op/shape_of.hpp"
+#include "openvino/op/squeeze.hpp"
+#include "openvino/op/topk.hpp"
+#include "openvino/op/unsqueeze.hpp"
 
 namespace ov {
 namespace genai {
@@ -26,6 +44,109 @@ size_t get_hidden_size(const std::shared_ptr<ov::Model> model) {
     return num_kv_heads * head_size;
 }
 
+size_t get_num_decoder_layers(const std::shared_ptr<ov::Model> model) {
+    size_t num_layers = 0;
+    for (const auto& parameter : model->get_parameters()) {
+        if (parameter->get_friendly_name().find("key_cache.") == 0)
+            ++num_layers;
+    }
+    return num_layers;
+}
+
+void apply_early_exit_transformation(std::shared_ptr<ov::Model> model, size_t num_layers) {
+    {
+        const auto ordered_ops = model->get_ordered_ops();
+        std::vector<std::shared_ptr<ov::Node>> attention_ops;
+        for (const auto& node : ordered_ops) {
+            if (std::string(node->get_type_name()) == "PagedAttentionExtension")
+                attention_ops.push_back(node);
+        }
+        OPENVINO_ASSERT(num_layers > 0 && num_layers < attention_ops.size(),
+                        "Number of early exit layers must be in [1, ", attention_ops.size() - 1, "], got ", num_layers);
+
+        // index of the last decoder layer each node depends on, -1 for nodes, which do not depend on attention
+        std::unordered_map<const ov::Node*, int64_t> layer_ids;
+        for (size_t layer_id = 0; layer_id < attention_ops.size(); ++layer_id)
+            layer_ids[attention_ops[layer_id].get()] = layer_id;
+        for (const auto& node : ordered_ops) {
+            int64_t layer_id = layer_ids.count(node.get()) ? layer_ids[node.get()] : -1;
+            for (const auto& input : node->input_values())
+                layer_id = std::max(layer_id, layer_ids[input.get_node()]);
+            layer_ids[node.get()] = layer_id;
+        }
+
+        std::unordered_set<const ov::Node*> first_removed_layer_ancestors;
+        std::vector<const ov::Node*> stack{attention_ops[num_layers].get()};
+        while (!stack.empty()) {
+            const ov::Node* node = stack.back();
+            stack.pop_back();
+            for (const auto& input : node->input_values()) {
+                if (first_removed_layer_ancestors.insert(input.get_node()).second)
+                    stack.push_back(input.get_node());
+            }
+        }
+
+        // the hidden state entering the first removed layer is added to its attention output by the residual connection
+        ov::Output<ov::Node> hidden_state;
+        for (const auto& node : ordered_ops) {
+            if (!ov::is_type<ov::op::v1::Add>(node) || hidden_state.get_node())
+                continue;
+            for (size_t i = 0; i < 2; ++i) {
+                ov::Output<ov::Node> attention_output = node->input_value(i), residual = node->input_value(1 - i);
+                if (layer_ids[attention_output.get_node()] == static_cast<int64_t>(num_layers) &&
+                    layer_ids[residual.get_node()] == static_cast<int64_t>(num_layers) - 1 &&
+                    first_removed_layer_ancestors.count(residual.get_node())) {
+                    hidden_state = residual;
+                    break;
+                }
+            }
+        }
+        OPENVINO_ASSERT(hidden_state.get_node(), "Failed to find the hidden state after decoder layer ", num_layers - 1);
+
+        // residual connections of the removed layers lead to the last hidden state consumed by the final norm
+        ov::Output<ov::Node> last_hidden_state = hidden_state;
+        for (bool is_found = true; is_found;) {
+            is_found = false;
+            for (const auto& target_input : last_hidden_state.get_target_inputs()) {
+                ov::Node* node = target_input.get_node();
+                if (!ov::is_type<ov::op::v1::Add>(node) || layer_ids[node->input_value(1 - target_input.get_index()).get_node()] < 0)
+                    continue;
+                last_hidden_state = node->output(0);
+                is_found = true;
+                break;
+            }
+        }
+        OPENVINO_ASSERT(layer_ids[last_hidden_state.get_node()] == static_cast<int64_t>(attention_ops.size()) - 1,
+                        "Failed to find the hidden state after the last decoder layer");
+
+        // other outputs of removed layers (e.g. attention scores) are removed with them
+        const ov::ResultVector results = model->get_results();
+        for (const auto& result : results) {
+            if (result->get_output_tensor(0).get_names().count("logits") == 0 && layer_ids[result.get()] >= static_cast<int64_t>(num_layers))
+                model->remove_result(result);
+        }
+        last_hidden_state.replace(hidden_state);
+    }
+
+    // removed nodes are released once the scope is left, so that KV cache inputs of the removed layers have no consumers
+    const ov::ParameterVector parameters = model->get_parameters();
+    for (const auto& parameter : parameters) {
+        const auto& name = parameter->get_friendly_name();
+        const bool is_layer_input = name.find("key_cache.") == 0 || name.find("value_cache.") == 0 || name.find("block_indices.") == 0;
+        if (is_layer_input && parameter->get_output_target_inputs(0).empty())
+            model->remove_parameter(parameter);
+    }
+    OPENVINO_ASSERT(get_num_decoder_layers(model) == num_layers, "KV cache inputs of removed decoder layers are still used by the model");
+    for (size_t layer_id = 0; layer_id < num_layers; ++layer_id) {
+        const std::string name = "key_cache." + std::to_string(layer_id);
+        bool is_found = false;
+        for (const auto& parameter : model->get_parameters())
+            is_found |= parameter->get_friendly_name() == name;
+        OPENVINO_ASSERT(is_found, "Early exit model must keep KV cache inputs of the first layers, ", name, " is not found");
+    }
+    model->validate_nodes_and_infer_types();
+}
+
 void apply_paged_attention_transformations(std::shared_ptr<ov::Model> model, bool per_layer_cache_control) {
     const ov::op::util::VariableVector& variables = model->get_variables();
     OPENVINO_ASSERT(!variables.empty(), "Model is supposed to be stateful");
@@ -35,6 +156,134 @@ void apply_paged_attention_transformations(std::shared_ptr<ov::Model> model, boo
     ov::pass::SDPAToPagedAttention(use_block_indices_inputs, use_score_outputs).run_on_model(model);
 }
 
+void apply_top_k_logits_transformation(std::shared_ptr<ov::Model> model, size_t top_k, bool apply_log_softmax) {
+    OPENVINO_ASSERT(top_k > 0, "Number of device-side logits candidates must be non-zero");
+    std::shared_ptr<ov::op::v0::Result> logits_result;
+    for (const auto& result : model->get_results()) {
+        if (result->get_output_tensor(0).get_names().count("logits") > 0)
+            logits_result = result;
+    }
+    OPENVINO_ASSERT(logits_result, "Model does not have \"logits\" output");
+
+    ov::Output<ov::Node> logits = logits_result->input_value(0);
+    ov::Output<ov::Node> values = logits;
+    if (apply_log_softmax) {
+        values = std::make_shared<ov::op::v5::LogSoftmax>(logits, -1);
+    }
+    auto k = ov::op::v0::Constant::create(ov::element::i64, ov::Shape{}, {static_cast<int64_t>(top_k)});
+    auto top_k_node = std::make_shared<ov::op::v11::TopK>(values, k, -1, ov::op::TopKMode::MAX, ov::op::TopKSortType::SORT_VALUES, ov::element::i32);
+
+    // tensor names are moved to the new outputs, so that inference code keeps using "logits"
+    logits.get_tensor().set_names({});
+    top_k_node->output(0).get_tensor().set_names({"logits"});
+    top_k_node->output(1).get_tensor().set_names({"logits_indices"});
+    logits_result->input(0).replace_source_output(top_k_node->output(0));
+
+    auto indices_result = std::make_shared<ov::op::v0::Result>(top_k_node->output(1));
+    indices_result->set_friendly_name("logits_indices");
+    model->add_results({indices_result});
+    model->validate_nodes_and_infer_types();
+}
+
+void apply_prompt_log_probs_transformation(std::shared_ptr<ov::Model> model) {
+    std::shared_ptr<ov::op::v0::Result> logits_result;
+    for (const auto& result : model->get_results()) {
+        if (result->get_output_tensor(0).get_names().count("logits") > 0)
+            logits_result = result;
+    }
+    OPENVINO_ASSERT(logits_result, "Model does not have \"logits\" output");
+
+    ov::Output<ov::Node> logits = logits_result->input_value(0);
+    auto log_probs = std::make_shared<ov::op::v5::LogSoftmax>(logits, -1);
+
+    // rows of logits are flattened to [total_num_tokens, vocab_size], the same order as input_ids
+    auto logits_shape = std::make_shared<ov::op::v3::ShapeOf>(logits, ov::element::i64);
+    auto vocab_size = std::make_shared<ov::op::v8::Gather>(logits_shape,
+        ov::op::v0::Constant::create(ov::element::i64, ov::Shape{1}, {-1}), ov::op::v0::Constant::create(ov::element::i64, ov::Shape{}, {0}));
+    auto flat_shape = std::make_shared<ov::op::v0::Concat>(
+        ov::OutputVector{ov::op::v0::Constant::create(ov::element::i64, ov::Shape{1}, {-1}), vocab_size}, 0);
+    auto flat_log_probs = std::make_shared<ov::op::v1::Reshape>(log_probs, flat_shape, false);
+
+    auto indices = std::make_shared<ov::op::v0::Parameter>(ov::element::i64, ov::PartialShape{ov::Dimension::dynamic()});
+    indices->set_friendly_name("prompt_log_probs_indices");
+    indices->get_output_tensor(0).set_names({"prompt_log_probs_indices"});
+    auto axis = ov::op::v0::Constant::create(ov::element::i64, ov::Shape{1}, {1});
+    auto gathered = std::make_shared<ov::op::v6::GatherElements>(flat_log_probs, std::make_shared<ov::op::v0::Unsqueeze>(indices, axis), 1);
+    auto prompt_log_probs = std::make_shared<ov::op::v0::Squeeze>(gathered, axis);
+    prompt_log_probs->get_output_tensor(0).set_names({"prompt_log_probs"});
+
+    auto prompt_log_probs_result = std::make_shared<ov::op::v0::Result>(prompt_log_probs);
+    prompt_log_probs_result->set_friendly_name("prompt_log_probs");
+    model->add_parameters({indices});
+    model->add_results({prompt_log_probs_result});
+    model->validate_nodes_and_infer_types();
+}
+
+void apply_sparse_decode_queries_transformation(std::shared_ptr<ov::Model> model) {
+    auto indices = std::make_shared<ov::op::v0::Parameter>(ov::element::i64, ov::PartialShape{ov::Dimension::dynamic()});
+    indices->set_friendly_name("sparse_decode_query_indices");
+    indices->get_output_tensor(0).set_names({"sparse_decode_query_indices"});
+    auto axis = ov::op::v0::Constant::create(ov::element::i64, ov::Shape{}, {0});
+
+    ov::ResultVector query_results;
+    for (const auto& node : model->get_ordered_ops()) {
+        if (std::string(node->get_type_name()) != "PagedAttentionExtension")
+            continue;
+        // the layer is identified by its key cache input, query is the first input of shape [num_tokens, num_heads * head_size]
+        const std::string key_cache_name = node->get_input_node_ptr(3)->get_friendly_name();
+        OPENVINO_ASSERT(key_cache_name.find("key_cache.") == 0, "Failed to find key cache input of ", node->get_friendly_name());
+        const std::string name = "queries." + key_cache_name.substr(std::string("key_cache.").size());
+
+        auto queries = std::make_shared<ov::op::v8::Gather>(node->input_value(0), indices, axis);
+        queries->get_output_tensor(0).set_names({name});
+        auto result = std::make_shared<ov::op::v0::Result>(queries);
+        result->set_friendly_name(name);
+        query_results.push_back(result);
+    }
+    OPENVINO_ASSERT(!query_results.empty(), "Model does not have PagedAttention operations");
+    model->add_parameters({indices});
+    model->add_results(query_results);
+    model->validate_nodes_and_infer_types();
+}
+
+void apply_medusa_heads_transformation(std::shared_ptr<ov::Model> model, const std::shared_ptr<ov::Model>& heads_model) {
+    OPENVINO_ASSERT(heads_model->get_parameters().size() == 1 && heads_model->get_results().size() == 1,
+                    "Medusa heads model must have a single input of hidden states and a single output of logits");
+    std::shared_ptr<ov::op::v0::Result> logits_result;
+    for (const auto& result : model->get_results()) {
+        if (result->get_output_tensor(0).get_names().count("logits") > 0)
+            logits_result = result;
+    }
+    OPENVINO_ASSERT(logits_result, "Model does not have \"logits\" output");
+
+    // LM head is a MatMul of the hidden state, possibly followed by element-wise operations, e.g. scaling or conversion
+    ov::Output<ov::Node> lm_head = logits_result->input_value(0);
+    while (!ov::is_type<ov::op::v0::MatMul>(lm_head.get_node())) {
+        OPENVINO_ASSERT(lm_head.get_node()->get_input_size() > 0, "Failed to find LM head of the model");
+        lm_head = lm_head.get_node()->input_value(0);
+    }
+    ov::Output<ov::Node> hidden_state = lm_head.get_node()->input_value(0);
+
+    // nodes of the cloned heads model become a part of the model
+    const auto heads = heads_model->clone();
+    const auto hidden_state_parameter = heads->get_parameters()[0];
+    if (hidden_state.get_element_type() != hidden_state_parameter->get_element_type())
+        hidden_state = std::make_shared<ov::op::v0::Convert>(hidden_state, hidden_state_parameter->get_element_type());
+    hidden_state_parameter->output(0).replace(hidden_state);
+    ov::Output<ov::Node> heads_logits = heads->get_results()[0]->input_value(0);
+
+    // only the most probable token of each head is a candidate, so that logits of heads are not read back to host
+    auto k = ov::op::v0::Constant::create(ov::element::i64, ov::Shape{}, {1});
+    auto top_k_node = std::make_shared<ov::op::v11::TopK>(heads_logits, k, -1, ov::op::TopKMode::MAX, ov::op::TopKSortType::NONE, ov::element::i64);
+    auto medusa_tokens = std::make_shared<ov::op::v0::Squeeze>(top_k_node->output(1), ov::op::v0::Constant::create(ov::element::i64, ov::Shape{1}, {-1}));
+    medusa_tokens->get_output_tensor(0).set_names({"medusa_tokens"});
+
+    auto medusa_tokens_result = std::make_shared<ov::op::v0::Result>(medusa_tokens);
+    medusa_tokens_result->set_friendly_name("medusa_tokens");
+    model->add_results({medusa_tokens_result});
+    model->validate_nodes_and_infer_types();
+}
+
 void set_kv_cache_type_and_shape(std::shared_ptr<ov::Model> model, DeviceConfig& device_config) {
     const ov::ParameterVector& parameters = model->get_parameters();
 
@@ -63,8 +312,8 @@ void set_kv_cache_type_and_shape(std::shared_ptr<ov::Model> model, DeviceConfig&
     device_config.set_model_params(num_kv_heads, head_size, num_layers);
 
     for (auto it_k = key_cache_params.begin(), it_v = value_cache_params.begin(); it_k != key_cache_params.end();++it_k, ++it_v) {
-        it_k->second->set_element_type(device_config.get_cache_precision());
-        it_v->second->set_element_type(device_config.get_cache_precision());
+        it_k->second->set_element_type(device_config.get_key_cache_precision());
+        it_v->second->set_element_type(device_config.get_value_cache_precision());
         // TODO: CVS-145270
         it_k->second->set_partial_shape(to_partial_with_dyn_0_dim(device_config.get_key_cache_shape()));
         it_v->second->set_partial_shape(to_partial_with_dyn_0_dim(device_config.get_value_cache_shape()));
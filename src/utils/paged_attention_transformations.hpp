@@ -23,8 +23,55 @@ void apply_paged_attention_transformations(std::shared_ptr<ov::Model> model, Dev
 
 void apply_paged_attention_transformations(std::shared_ptr<ov::Model> model, bool per_layer_cache_control = false);
 
+/** Replaces the full vocabulary "logits" output of the model with `top_k` highest values computed on device, so that only them are
+ * read back to host. The "logits" output then has shape [batch, seq_len, top_k] with values sorted in descending order and
+ * "logits_indices" output holds the corresponding token IDs.
+ * @param model Pointer to the ov::Model with "logits" output.
+ * @param top_k Number of candidates per token.
+ * @param apply_log_softmax If true, log-softmax over the whole vocabulary is applied before the selection, so that values are log probabilities.
+ */
+void apply_top_k_logits_transformation(std::shared_ptr<ov::Model> model, size_t top_k, bool apply_log_softmax = true);
+
+/** Extends the model to compute log probabilities of given tokens on device from the "logits" output. The model gets
+ * "prompt_log_probs_indices" input of shape [total_num_tokens], which holds a token ID for each row of logits (i.e. the next prompt token),
+ * and "prompt_log_probs" output of the same shape with log-softmax of logits gathered at these IDs. The "logits" output is not changed.
+ * @param model Pointer to the ov::Model with "logits" output.
+ */
+void apply_prompt_log_probs_transformation(std::shared_ptr<ov::Model> model);
+
+/** Exposes queries of PagedAttention operations of a model transformed by apply_paged_attention_transformations, so that
+ * the host can estimate attention of the next decode step. The model gets "sparse_decode_query_indices" input of shape [num_rows],
+ * which holds indices of tokens in the batch, and "queries.<layer>" output of shape [num_rows, num_heads * head_size] per decoder layer
+ * with queries of these tokens, so that queries of the other tokens are not read back to host.
+ * @param model Pointer to the ov::Model transformed by apply_paged_attention_transformations.
+ */
+void apply_sparse_decode_queries_transformation(std::shared_ptr<ov::Model> model);
+
+/** Turns a model transformed by apply_paged_attention_transformations into an early-exit model, which passes the hidden state after
+ * the given number of first decoder layers directly to the final norm and LM head. Layers are detected by PagedAttention operations,
+ * residual connections - by Add operations of the hidden state and an output of attention or MLP. KV cache inputs of the removed
+ * layers are removed from the model, so that only the kept layers have KV cache.
+ * @param model Pointer to the ov::Model representing one of the supported LLM architectures.
+ * @param num_layers Number of first decoder layers to keep, must be less than the number of decoder layers of the model.
+ */
+void apply_early_exit_transformation(std::shared_ptr<ov::Model> model, size_t num_layers);
+
+/** Attaches Medusa heads to the model, so that candidates for speculative decoding are predicted in the same forward pass.
+ * The heads get the hidden state, which is the input of the LM head, and the most probable token of each head is returned by
+ * "medusa_tokens" output of shape [..., num_heads], whose leading dimensions are the same as of "logits". The "logits" output is not changed.
+ * @param model Pointer to the ov::Model with "logits" output.
+ * @param heads_model Model with a single input of hidden states of shape [..., hidden_size] and a single output of logits
+ * of shape [..., num_heads, vocab_size], where head i predicts the token (i + 2) positions after the input one.
+ */
+void apply_medusa_heads_transformation(std::shared_ptr<ov::Model> model, const std::shared_ptr<ov::Model>& heads_model);
+
 size_t get_hidden_size(const std::shared_ptr<ov::Model> model);
 
+/**
+ * @return Number of decoder layers of a model transformed by apply_paged_attention_transformations, i.e. number of its KV caches.
+ */
+size_t get_num_decoder_layers(const std::shared_ptr<ov::Model> model);
+
 void set_kv_cache_type_and_shape(std::shared_ptr<ov::Model> model, DeviceConfig& device_config);
 
 }  // namespace utils
@@ -4,7 +4,32 @@
 // Based on clip.cpp
 
 #include "clip.hpp"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+
+#include "openvino/core/parallel.hpp"
+
+namespace {
+
+// source pixels and the offset between them, which interpolate an output pixel along one axis
+struct ResizeTap {
+    int index;
+    float offset;
+};
+
+// output rows are split into contiguous bands processed in parallel, each band reuses its horizontal passes
+template <typename F>
+void parallel_for_row_bands(int n_rows, F&& process_band) {
+    constexpr int band_height = 32;
+    const int n_bands = (n_rows + band_height - 1) / band_height;
+    ov::parallel_for(static_cast<size_t>(n_bands), [&](size_t band) {
+        const int begin = static_cast<int>(band) * band_height;
+        process_band(begin, std::min(begin + band_height, n_rows));
+    });
+}
+
+}  // namespace
 
 // Linear interpolation between two points
 static float clip_lerp(float s, float e, float t) {
@@ -20,30 +45,34 @@ static void bilinear_resize(const clip_image_u8& src, clip_image_u8& dst, int ta
     float x_ratio = static_cast<float>(src.nx - 1) / target_width;
     float y_ratio = static_cast<float>(src.ny - 1) / target_height;
 
-    for (int y = 0; y < target_height; y++) {
-        for (int x = 0; x < target_width; x++) {
-            float px = x_ratio * x;
+    // columns are the same for all rows
+    std::vector<ResizeTap> x_taps(target_width);
+    for (int x = 0; x < target_width; x++) {
+        float px = x_ratio * x;
+        int x_floor = static_cast<int>(px);
+        x_taps[x] = {x_floor, px - x_floor};
+    }
+
+    parallel_for_row_bands(target_height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
             float py = y_ratio * y;
-            int x_floor = static_cast<int>(px);
             int y_floor = static_cast<int>(py);
-            float x_lerp = px - x_floor;
             float y_lerp = py - y_floor;
-
-            for (int c = 0; c < 3; c++) {
-                float top = clip_lerp(
-                    static_cast<float>(src.buf[3 * (y_floor * src.nx + x_floor) + c]),
-                    static_cast<float>(src.buf[3 * (y_floor * src.nx + (x_floor + 1)) + c]),
-                    x_lerp
-                );
-                float bottom = clip_lerp(
-                    static_cast<float>(src.buf[3 * ((y_floor + 1) * src.nx + x_floor) + c]),
-                    static_cast<float>(src.buf[3 * ((y_floor + 1) * src.nx + (x_floor + 1)) + c]),
-                    x_lerp
-                );
-                dst.buf[3 * (y * target_width + x) + c] = static_cast<uint8_t>(clip_lerp(top, bottom, y_lerp));
+            const uint8_t* top_row = src.buf.data() + 3 * y_floor * src.nx;
+            const uint8_t* bottom_row = top_row + 3 * src.nx;
+            uint8_t* dst_row = dst.buf.data() + 3 * y * target_width;
+
+            for (int x = 0; x < target_width; x++) {
+                const int left = 3 * x_taps[x].index;
+                const float x_lerp = x_taps[x].offset;
+                for (int c = 0; c < 3; c++) {
+                    float top = clip_lerp(top_row[left + c], top_row[left + 3 + c], x_lerp);
+                    float bottom = clip_lerp(bottom_row[left + c], bottom_row[left + 3 + c], x_lerp);
+                    dst_row[3 * x + c] = static_cast<uint8_t>(clip_lerp(top, bottom, y_lerp));
+                }
             }
         }
-    }
+    });
 }
 
 template<typename NUM>
@@ -51,6 +80,18 @@ NUM clip(NUM x, NUM lower, NUM upper) {
     return std::max(lower, std::min(x, upper));
 }
 
+// Cubic interpolation of p(-1), p(0), p(1), p(2) at d in [0, 1)
+static inline float cubic_interpolate(float p0, float p1, float p2, float p3, float d) {
+    float d0 = p0 - p1;
+    float d2 = p2 - p1;
+    float d3 = p3 - p1;
+    float a0 = p1;
+    float a1 = -1.0 / 3 * d0 + d2 - 1.0 / 6 * d3;
+    float a2 =  1.0 / 2 * d0 +      1.0 / 2 * d2;
+    float a3 = -1.0 / 6 * d0 -      1.0 / 2 * d2 + 1.0 / 6 * d3;
+    return a0 + a1 * d + a2 * d * d + a3 * d * d * d;
+}
+
 void bicubic_resize(const clip_image_u8 &img, clip_image_u8 &dst, int target_width, int target_height) {
     const int nx = img.nx;
     const int ny = img.ny;
@@ -59,57 +100,66 @@ void bicubic_resize(const clip_image_u8 &img, clip_image_u8 &dst, int target_wid
     dst.ny = target_height;
     dst.buf.resize(3 * target_width * target_height);
 
-    float Cc;
-    float C[5];
-    float d0, d2, d3, a0, a1, a2, a3;
-    int i, j, k, jj;
-    int x, y;
-    float dx, dy;
-    float tx, ty;
-
-    tx = (float)nx / (float)target_width;
-    ty = (float)ny / (float)target_height;
+    const float tx = (float)nx / (float)target_width;
+    const float ty = (float)ny / (float)target_height;
 
     // Bicubic interpolation; adapted from ViT.cpp, inspired from :
     //    -> https://github.com/yglukhov/bicubic-interpolation-image-processing/blob/master/libimage.c#L36
     //    -> https://en.wikipedia.org/wiki/Bicubic_interpolation
+    // The interpolation is separable: each source row is interpolated horizontally once for all output columns, so
+    // that output rows combine 4 interpolated rows. Source columns of output columns are precomputed.
+    std::vector<ResizeTap> x_taps(target_width);
+    std::vector<int> x_indices(4 * target_width);
+    for (int j = 0; j < target_width; j++) {
+        const int x = (int)(tx * j);
+        x_taps[j] = {x, tx * j - x};
+        for (int m = 0; m < 4; m++) {
+            x_indices[4 * j + m] = 3 * clip(x - 1 + m, 0, nx - 1);
+        }
+    }
 
-    for (i = 0; i < target_height; i++) {
-        for (j = 0; j < target_width; j++) {
-            x = (int)(tx * j);
-            y = (int)(ty * i);
-
-            dx = tx * j - x;
-            dy = ty * i - y;
-
-            for (k = 0; k < 3; k++) {
-                for (jj = 0; jj <= 3; jj++) {
-                    d0 = img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x - 1, 0, nx - 1)) * 3 + k] - img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x, 0, nx - 1)) * 3 + k];
-                    d2 = img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x + 1, 0, nx - 1)) * 3 + k] - img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x, 0, nx - 1)) * 3 + k];
-                    d3 = img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x + 2, 0, nx - 1)) * 3 + k] - img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x, 0, nx - 1)) * 3 + k];
-                    a0 = img.buf[(clip(y - 1 + jj, 0, ny - 1) * nx + clip(x, 0, nx - 1)) * 3 + k];
-
-                    a1 = -1.0 / 3 * d0 + d2 - 1.0 / 6 * d3;
-                    a2 =  1.0 / 2 * d0 +      1.0 / 2 * d2;
-                    a3 = -1.0 / 6 * d0 -      1.0 / 2 * d2 + 1.0 / 6 * d3;
-
-                    C[jj] = a0 + a1 * dx + a2 * dx * dx + a3 * dx * dx * dx;
-
-                    d0 = C[0] - C[1];
-                    d2 = C[2] - C[1];
-                    d3 = C[3] - C[1];
-                    a0 = C[1];
-                    a1 = -1.0 / 3 * d0 + d2 - 1.0 / 6 * d3;
-                    a2 =  1.0 / 2 * d0 +      1.0 / 2 * d2;
-                    a3 = -1.0 / 6 * d0 -      1.0 / 2 * d2 + 1.0 / 6 * d3;
-                    Cc = a0 + a1 * dy + a2 * dy * dy + a3 * dy * dy * dy;
-
-                    const uint8_t Cc2 = std::min(std::max(std::round(Cc), 0.0f), 255.0f);
-                    dst.buf[(i * target_width + j) * 3 + k] = float(Cc2);
+    const int row_size = 3 * target_width;
+    parallel_for_row_bands(target_height, [&](int begin, int end) {
+        // horizontally interpolated source rows, source row r is kept in slot r % 4
+        std::vector<float> rows(4 * row_size);
+        int cached_rows[4] = {-1, -1, -1, -1};
+        const float* C[4];
+
+        for (int i = begin; i < end; i++) {
+            const int y = (int)(ty * i);
+            const float dy = ty * i - y;
+
+            for (int jj = 0; jj <= 3; jj++) {
+                const int source_row = clip(y - 1 + jj, 0, ny - 1);
+                float* row = rows.data() + (source_row % 4) * row_size;
+                C[jj] = row;
+                if (cached_rows[source_row % 4] == source_row) {
+                    continue;
                 }
+                cached_rows[source_row % 4] = source_row;
+
+                const uint8_t* src_row = img.buf.data() + 3 * source_row * nx;
+                for (int j = 0; j < target_width; j++) {
+                    const int* x_index = x_indices.data() + 4 * j;
+                    const float dx = x_taps[j].offset;
+                    for (int k = 0; k < 3; k++) {
+                        row[3 * j + k] = cubic_interpolate(src_row[x_index[0] + k],
+                                                           src_row[x_index[1] + k],
+                                                           src_row[x_index[2] + k],
+                                                           src_row[x_index[3] + k],
+                                                           dx);
+                    }
+                }
+            }
+
+            // contiguous rows are combined element-wise, which the compiler vectorizes
+            uint8_t* dst_row = dst.buf.data() + i * row_size;
+            for (int e = 0; e < row_size; e++) {
+                const float Cc = cubic_interpolate(C[0][e], C[1][e], C[2][e], C[3][e], dy);
+                dst_row[e] = std::min(std::max(std::round(Cc), 0.0f), 255.0f);
             }
         }
-    }
+    });
 }
 
 // llava-1.6 type of resize_and_pad (black)
@@ -188,73 +238,39 @@ std::pair<int, int> select_best_resolution(const std::pair<int, int> & original_
 
 // returns the normalized float tensor for llava-1.5, for spatial_unpad with anyres processing for llava-1.6 it returns the normalized image patch tensors as a vector
 clip_image_f32 clip_image_preprocess(clip_ctx& ctx, const clip_image_u8& img) {
-    bool pad_to_square = true;
-
-    clip_image_u8 temp;  // we will keep the input image data here temporarily
-    temp.nx = img.nx;
-    temp.ny = img.ny;
-    temp.buf.resize(img.buf.size());
-    memcpy(temp.buf.data(), img.buf.data(), temp.buf.size());
-
-
-    const int nx = temp.nx;
-    const int ny = temp.ny;
-
-    const int nx2 = temp.nx;
-    const int ny2 = temp.ny;
-
     clip_image_f32 res;
-    res.nx = nx2;
-    res.ny = ny2;
-    res.buf.resize(3 * nx2 * ny2);
-
-    const int nx3 = nx;
-    const int ny3 = ny;
+    res.nx = img.nx;
+    res.ny = img.ny;
+    res.buf.resize(3 * img.nx * img.ny);
+    clip_image_preprocess_region(ctx, img, 0, 0, img.nx, img.ny, res.buf.data());
+    return res;
+}
 
+void clip_image_preprocess_region(const clip_ctx& ctx, const clip_image_u8& img, int x0, int y0, int nx, int ny, float* dst) {
     const auto& m3 = ctx.image_mean; // {0.48145466f, 0.4578275f, 0.40821073f};
     const auto& s3 = ctx.image_std;  // {0.26862954f, 0.26130258f, 0.27577711f};
 
-    for (int y = 0; y < ny3; y++) {
-        for (int x = 0; x < nx3; x++) {
-            for (int c = 0; c < 3; c++) {
-                // linear interpolation
-                const float sx = x;
-                const float sy = y;
-
-                const int x0 = std::max(0, (int)std::floor(sx));
-                const int y0 = std::max(0, (int)std::floor(sy));
-
-                const int x1 = std::min(x0 + 1, nx - 1);
-                const int y1 = std::min(y0 + 1, ny - 1);
-
-                const float dx = sx - x0;
-                const float dy = sy - y0;
-
-                const int j00 = 3 * (y0 * nx + x0) + c;
-                const int j01 = 3 * (y0 * nx + x1) + c;
-                const int j10 = 3 * (y1 * nx + x0) + c;
-                const int j11 = 3 * (y1 * nx + x1) + c;
-
-                const float v00 = temp.buf[j00];
-                const float v01 = temp.buf[j01];
-                const float v10 = temp.buf[j10];
-                const float v11 = temp.buf[j11];
-
-                const float v0 = v00 * (1.0f - dx) + v01 * dx;
-                const float v1 = v10 * (1.0f - dx) + v11 * dx;
-
-                const float v = v0 * (1.0f - dy) + v1 * dy;
-
-                const uint8_t v2 = std::min(std::max(std::round(v), 0.0f), 255.0f);
-
-                //rgb hwc ->chw
-                const int i = (y * nx3 + x) + c * nx3 * ny3;
+    // normalized values of all 256 intensities of each channel
+    float lut[3][256];
+    for (int c = 0; c < 3; c++) {
+        for (int v = 0; v < 256; v++) {
+            lut[c][v] = ((float(v) / 255.0f) - m3[c]) / s3[c];
+        }
+    }
 
-                res.buf[i] = ((float(v2) / 255.0f) - m3[c]) / s3[c];
+    // rgb hwc -> chw
+    const int plane_size = nx * ny;
+    parallel_for_row_bands(ny, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const uint8_t* src_row = img.buf.data() + 3 * ((y0 + y) * img.nx + x0);
+            for (int c = 0; c < 3; c++) {
+                float* dst_row = dst + c * plane_size + y * nx;
+                for (int x = 0; x < nx; x++) {
+                    dst_row[x] = lut[c][src_row[3 * x + c]];
+                }
             }
         }
-    }
-    return res;
+    });
 }
 
 std::vector<clip_image_u8> get_image_patches(
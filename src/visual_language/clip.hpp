@@ -35,6 +35,9 @@ void bicubic_resize(const clip_image_u8& img, clip_image_u8& dst, int target_wid
 /** preprocess img and store the result in res_imgs, pad_to_square may be overridden to false depending on model configuration */
 clip_image_f32 clip_image_preprocess(struct clip_ctx& ctx, const clip_image_u8& img);
 
+/** normalizes the region [x, x + width) x [y, y + height) of img into dst of CHW layout, which holds 3 * width * height values */
+void clip_image_preprocess_region(const struct clip_ctx& ctx, const clip_image_u8& img, int x, int y, int width, int height, float* dst);
+
 std::vector<clip_image_u8> get_image_patches(
     const clip_image_u8& image, 
     const std::vector<std::pair<int, int>>& image_grid_pinpoints,
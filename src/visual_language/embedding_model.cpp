@@ -1,18 +1,60 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
 #include "openvino/runtime/core.hpp"
+#include "openvino/core/parallel.hpp"
 #include "openvino/core/preprocess/pre_post_process.hpp"
+#include "openvino/op/convert.hpp"
 #include "openvino/op/multiply.hpp"
+#include "openvino/op/subtract.hpp"
 #include "openvino/op/constant.hpp"
+#include "openvino/op/util/gather_base.hpp"
 
 #include "utils.hpp"
 
 #include "embedding_model.hpp"
 
+namespace {
+
+std::shared_ptr<ov::Node> skip_convert(std::shared_ptr<ov::Node> node) {
+    while (ov::is_type<ov::op::v0::Convert>(node))
+        node = node->get_input_node_shared_ptr(0);
+    return node;
+}
+
+// values of a decompression scale or zero point, which must be either a scalar or one value per row of the table
+std::optional<std::vector<float>> get_row_values(const std::shared_ptr<ov::Node>& node, size_t num_rows) {
+    auto constant = ov::as_type_ptr<ov::op::v0::Constant>(skip_convert(node));
+    if (!constant)
+        return std::nullopt;
+    const ov::Shape& shape = constant->get_shape();
+    const bool is_scalar = ov::shape_size(shape) == 1;
+    const bool is_per_row = shape.size() == 2 && shape[0] == num_rows && shape[1] == 1;
+    if (!is_scalar && !is_per_row)
+        return std::nullopt;
+    return constant->cast_vector<float>();
+}
+
+template <typename T>
+void gather_rows(const T* weights, size_t hidden_size, const std::vector<size_t>& rows,
+                 const std::vector<float>& scales, const std::vector<float>& zero_points, float scale_emb, float* embeddings) {
+    ov::parallel_for(rows.size(), [&](size_t i) {
+        const size_t row = rows[i];
+        const float scale = scale_emb * (scales.empty() ? 1.0f : scales[scales.size() == 1 ? 0 : row]);
+        const float zero_point = zero_points.empty() ? 0.0f : zero_points[zero_points.size() == 1 ? 0 : row];
+        const T* src = weights + row * hidden_size;
+        float* dst = embeddings + i * hidden_size;
+        for (size_t j = 0; j < hidden_size; ++j)
+            dst[j] = (static_cast<float>(src[j]) - zero_point) * scale;
+    });
+}
+
+}  // namespace
+
 namespace ov {
 namespace genai {
 
@@ -24,11 +66,13 @@ EmbeddingsModel::EmbeddingsModel(const std::filesystem::path& model_dir,
     std::shared_ptr<ov::Model> m_model = core.read_model((model_dir / "openvino_text_embeddings_model.xml").string());
     // apply embedding postprocessing step by merging them into the model
     // HARD
+    init_embedding_table(m_model, scale_emb, device);
     merge_postprocess(m_model, scale_emb);
 
-    ov::CompiledModel compiled_model = core.compile_model(m_model, device, properties);
-    ov::genai::utils::print_compiled_model_properties(compiled_model, "text embeddings model");
-    m_request = compiled_model.create_infer_request();
+    m_compiled_model = core.compile_model(m_model, device, properties);
+    ov::genai::utils::print_compiled_model_properties(m_compiled_model, "text embeddings model");
+    m_request = m_compiled_model.create_infer_request();
+    m_external_output_request = m_compiled_model.create_infer_request();
 }
 
 EmbeddingsModel::EmbeddingsModel(const std::string& model,
@@ -38,14 +82,26 @@ EmbeddingsModel::EmbeddingsModel(const std::string& model,
                                  const ov::AnyMap& properties) {
     ov::Core core = utils::singleton_core();
     std::shared_ptr<ov::Model> m_model = core.read_model(model, weights);
+    init_embedding_table(m_model, scale_emb, device);
     // apply embedding postprocessing step by merging them into the model
     merge_postprocess(m_model, scale_emb);
 
-    ov::CompiledModel compiled_model = core.compile_model(m_model, device, properties);
-    m_request = compiled_model.create_infer_request();
+    m_compiled_model = core.compile_model(m_model, device, properties);
+    m_request = m_compiled_model.create_infer_request();
+    m_external_output_request = m_compiled_model.create_infer_request();
 }
 
 ov::Tensor EmbeddingsModel::infer(ov::Tensor input_idx) {
+    if (m_embedding_table) {
+        const ov::Shape& ids_shape = input_idx.get_shape();
+        const size_t hidden_size = m_embedding_table->weights->get_shape().at(1);
+        if (!m_gathered)
+            m_gathered = ov::Tensor(ov::element::f32, {ids_shape.at(0), ids_shape.at(1), hidden_size});
+        else
+            m_gathered.set_shape({ids_shape.at(0), ids_shape.at(1), hidden_size});
+        gather(input_idx, m_gathered);
+        return m_gathered;
+    }
     OPENVINO_ASSERT(m_request, "Text embeddings decoder model must be compiled first. Cannot infer non-compiled model");
 
     m_request.set_input_tensor(input_idx);
@@ -53,6 +109,103 @@ ov::Tensor EmbeddingsModel::infer(ov::Tensor input_idx) {
     return m_request.get_output_tensor();
 }
 
+void EmbeddingsModel::infer(const ov::Tensor& input_idx, const ov::Tensor& embeddings) {
+    if (m_embedding_table) {
+        gather(input_idx, embeddings);
+        return;
+    }
+    OPENVINO_ASSERT(m_external_output_request, "Text embeddings decoder model must be compiled first. Cannot infer non-compiled model");
+
+    m_external_output_request.set_input_tensor(input_idx);
+    m_external_output_request.set_output_tensor(embeddings);
+    m_external_output_request.infer();
+}
+
+ov::element::Type EmbeddingsModel::get_output_element_type() const {
+    OPENVINO_ASSERT(m_compiled_model, "Text embeddings decoder model must be compiled first");
+    return m_compiled_model.output().get_element_type();
+}
+
+void EmbeddingsModel::init_embedding_table(const std::shared_ptr<ov::Model>& model, float scale_emb, const std::string& device) {
+    // a model on other devices keeps its weights there, so a lookup on CPU would need another copy of the table
+    if (device != "CPU" || model->get_results().size() != 1)
+        return;
+    auto gather = ov::as_type_ptr<ov::op::util::GatherBase>(model->get_results().front()->get_input_node_shared_ptr(0));
+    if (!gather || gather->get_axis() != 0 || gather->get_batch_dims() != 0 || gather->get_output_element_type(0) != ov::element::f32)
+        return;
+
+    // weights may be compressed as Multiply(Subtract(Convert(weights), zero_point), scale) with optional Subtract
+    std::shared_ptr<ov::Node> node = skip_convert(gather->get_input_node_shared_ptr(0));
+    std::shared_ptr<ov::Node> scale_node, zero_point_node;
+    if (ov::is_type<ov::op::v1::Multiply>(node)) {
+        scale_node = node->get_input_node_shared_ptr(1);
+        node = skip_convert(node->get_input_node_shared_ptr(0));
+    }
+    if (ov::is_type<ov::op::v1::Subtract>(node)) {
+        zero_point_node = node->get_input_node_shared_ptr(1);
+        node = skip_convert(node->get_input_node_shared_ptr(0));
+    }
+    auto weights = ov::as_type_ptr<ov::op::v0::Constant>(node);
+    const std::vector<ov::element::Type> supported_types{ov::element::f32, ov::element::f16, ov::element::bf16, ov::element::i8, ov::element::u8};
+    if (!weights || weights->get_shape().size() != 2 ||
+        std::find(supported_types.begin(), supported_types.end(), weights->get_element_type()) == supported_types.end())
+        return;
+
+    EmbeddingTable table;
+    table.weights = weights;
+    table.scale_emb = scale_emb;
+    const size_t num_rows = weights->get_shape()[0];
+    if (scale_node) {
+        auto scales = get_row_values(scale_node, num_rows);
+        if (!scales)
+            return;
+        table.scales = std::move(*scales);
+    }
+    if (zero_point_node) {
+        auto zero_points = get_row_values(zero_point_node, num_rows);
+        if (!zero_points)
+            return;
+        table.zero_points = std::move(*zero_points);
+    }
+    m_embedding_table = std::move(table);
+}
+
+void EmbeddingsModel::gather(const ov::Tensor& input_idx, const ov::Tensor& embeddings) const {
+    const EmbeddingTable& table = *m_embedding_table;
+    const size_t num_rows = table.weights->get_shape()[0], hidden_size = table.weights->get_shape()[1];
+    OPENVINO_ASSERT(embeddings.get_element_type() == ov::element::f32, "Text embeddings are written to f32 tensors only");
+    OPENVINO_ASSERT(embeddings.get_size() == input_idx.get_size() * hidden_size,
+                    "Text embeddings tensor must have ", input_idx.get_size() * hidden_size, " elements, while it has ", embeddings.get_size());
+
+    std::vector<size_t> rows(input_idx.get_size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const int64_t token_id = input_idx.get_element_type() == ov::element::i32 ? input_idx.data<int32_t>()[i] : input_idx.data<int64_t>()[i];
+        OPENVINO_ASSERT(token_id >= 0 && static_cast<size_t>(token_id) < num_rows, "Token id ", token_id, " is out of vocabulary of size ", num_rows);
+        rows[i] = static_cast<size_t>(token_id);
+    }
+
+    float* dst = embeddings.data<float>();
+    switch (table.weights->get_element_type()) {
+    case ov::element::Type_t::f32:
+        gather_rows(table.weights->get_data_ptr<float>(), hidden_size, rows, table.scales, table.zero_points, table.scale_emb, dst);
+        break;
+    case ov::element::Type_t::f16:
+        gather_rows(table.weights->get_data_ptr<ov::float16>(), hidden_size, rows, table.scales, table.zero_points, table.scale_emb, dst);
+        break;
+    case ov::element::Type_t::bf16:
+        gather_rows(table.weights->get_data_ptr<ov::bfloat16>(), hidden_size, rows, table.scales, table.zero_points, table.scale_emb, dst);
+        break;
+    case ov::element::Type_t::i8:
+        gather_rows(table.weights->get_data_ptr<int8_t>(), hidden_size, rows, table.scales, table.zero_points, table.scale_emb, dst);
+        break;
+    case ov::element::Type_t::u8:
+        gather_rows(table.weights->get_data_ptr<uint8_t>(), hidden_size, rows, table.scales, table.zero_points, table.scale_emb, dst);
+        break;
+    default:
+        OPENVINO_THROW("Unsupported element type of text embeddings table: ", table.weights->get_element_type());
+    }
+}
+
 void EmbeddingsModel::merge_postprocess(std::shared_ptr<ov::Model> model, float scale_emb) const {
     ov::preprocess::PrePostProcessor ppp(model);
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
 #include <vector>
 #include <string>
 
@@ -12,6 +13,7 @@
 #include "openvino/runtime/tensor.hpp"
 #include "openvino/runtime/infer_request.hpp"
 #include "openvino/runtime/properties.hpp"
+#include "openvino/op/constant.hpp"
 
 #include "visual_language/vlm_config.hpp"
 
@@ -39,10 +41,39 @@ public:
 
     ov::Tensor infer(ov::Tensor input_idx);
 
+    /**
+     * Writes embeddings to a given tensor instead of the output tensor of the model, e.g. to an input tensor of a language model,
+     * so that the embeddings are neither allocated nor copied by each call.
+     * @param input_idx Token IDs of shape [batch, length].
+     * @param embeddings Tensor of shape [batch, length, hidden_size] and element type of the model output.
+     */
+    void infer(const ov::Tensor& input_idx, const ov::Tensor& embeddings);
+
+    ov::element::Type get_output_element_type() const;
+
 private:
+    // Embedding table of a model, which is a single Gather of token ids, with weights decompressed by a per-row scale and zero point.
+    // Looking rows up on CPU directly avoids an inference per prompt and per generated token.
+    struct EmbeddingTable {
+        std::shared_ptr<ov::op::v0::Constant> weights;
+        // either empty, a single value or a value per row
+        std::vector<float> scales, zero_points;
+        float scale_emb = 1.0f;
+    };
+
     void merge_postprocess(std::shared_ptr<ov::Model> model, float scale_emb) const;
 
+    void init_embedding_table(const std::shared_ptr<ov::Model>& model, float scale_emb, const std::string& device);
+
+    void gather(const ov::Tensor& input_idx, const ov::Tensor& embeddings) const;
+
+    std::optional<EmbeddingTable> m_embedding_table;
+    // output of infer(input_idx) by m_embedding_table, reused by subsequent calls like an output tensor of m_request
+    ov::Tensor m_gathered;
+    ov::CompiledModel m_compiled_model;
     ov::InferRequest m_request;
+    // request writing to external tensors, separate from m_request, whose output tensor is returned to callers
+    ov::InferRequest m_external_output_request;
 };
 
 } // namespace genai
@@ -8,6 +8,10 @@
 #include "visual_language/vision_encoder.hpp"
 #include "visual_language/embedding_model.hpp"
 
+#include <future>
+
+#include "openvino/core/parallel.hpp"
+
 #include "utils.hpp"
 
 
@@ -15,12 +19,91 @@ namespace {
 
 constexpr size_t BATCH_SIZE = 1;
 
+// properties selecting devices and properties of VLMPipeline submodels
+void remove_submodel_properties(ov::AnyMap& device_config) {
+    for (const auto& name : {ov::genai::vision_encoder_device.name(), ov::genai::text_embeddings_device.name(),
+                             ov::genai::language_model_device.name(), ov::genai::vision_encoder_properties.name(),
+                             ov::genai::text_embeddings_properties.name(), ov::genai::language_model_properties.name()}) {
+        device_config.erase(name);
+    }
+}
+
+// VLMPipeline properties are not known by plugins, only the vision encoder consumes them
+ov::AnyMap remove_pipeline_properties(ov::AnyMap device_config) {
+    remove_submodel_properties(device_config);
+    device_config.erase(ov::genai::embedded_image_preprocessing.name());
+    device_config.erase(ov::genai::vision_encoder_max_batch_size.name());
+    device_config.erase(ov::genai::vision_embeddings_cache_size.name());
+    device_config.erase(ov::genai::visual_tokens_keep_ratio.name());
+    return device_config;
+}
+
+float get_visual_tokens_keep_ratio(const ov::AnyMap& device_config) {
+    auto it = device_config.find(ov::genai::visual_tokens_keep_ratio.name());
+    if (it == device_config.end()) {
+        return 1.0f;
+    }
+    float keep_ratio = it->second.as<float>();
+    OPENVINO_ASSERT(keep_ratio > 0.0f && keep_ratio <= 1.0f, "visual_tokens_keep_ratio must be in (0, 1], got ", keep_ratio);
+    return keep_ratio;
+}
+
+// Reduces the number of tokens of image embeddings [N, seq_len, hidden_size] to round(seq_len * keep_ratio) by adaptive
+// average pooling: output token i averages input tokens [floor(i * seq_len / n), ceil((i + 1) * seq_len / n)).
+ov::Tensor pool_visual_tokens(const ov::Tensor& image_embeds, float keep_ratio) {
+    const ov::Shape& shape = image_embeds.get_shape();
+    OPENVINO_ASSERT(shape.size() == 3 && image_embeds.get_element_type() == ov::element::f32,
+                    "Image embeddings must be f32 of shape [N, seq_len, hidden_size]");
+    size_t num_rows = shape[0], seq_len = shape[1], hidden_size = shape[2];
+    size_t pooled_len = std::max<size_t>(1, static_cast<size_t>(std::lround(seq_len * keep_ratio)));
+    if (pooled_len >= seq_len) {
+        return image_embeds;
+    }
+
+    ov::Tensor pooled(ov::element::f32, {num_rows, pooled_len, hidden_size});
+    const float* src_data = image_embeds.data<float>();
+    float* dst_data = pooled.data<float>();
+    ov::parallel_for2d(num_rows, pooled_len, [&](size_t row, size_t token) {
+        size_t begin = token * seq_len / pooled_len, end = ((token + 1) * seq_len + pooled_len - 1) / pooled_len;
+        float* dst = dst_data + (row * pooled_len + token) * hidden_size;
+        std::fill_n(dst, hidden_size, 0.0f);
+        for (size_t src_token = begin; src_token < end; ++src_token) {
+            const float* src = src_data + (row * seq_len + src_token) * hidden_size;
+            for (size_t d = 0; d < hidden_size; ++d) {
+                dst[d] += src[d];
+            }
+        }
+        const float scale = 1.0f / (end - begin);
+        for (size_t d = 0; d < hidden_size; ++d) {
+            dst[d] *= scale;
+        }
+    });
+    return pooled;
+}
+
 } // namespace
 
 namespace ov::genai {
 
 const ModelsMap::mapped_type& get_model_weights_pair(const ModelsMap& models_map, const std::string& key);
 
+std::string get_submodel_device(const std::string& device, const ov::AnyMap& properties, const ov::Property<std::string>& device_property) {
+    auto it = properties.find(device_property.name());
+    return it == properties.end() ? device : it->second.as<std::string>();
+}
+
+ov::AnyMap get_submodel_properties(const ov::AnyMap& properties, const ov::Property<ov::AnyMap>& submodel_property) {
+    ov::AnyMap submodel_properties = properties;
+    auto it = properties.find(submodel_property.name());
+    if (it != properties.end()) {
+        for (const auto& [name, value] : it->second.as<ov::AnyMap>()) {
+            submodel_properties[name] = value;
+        }
+    }
+    remove_submodel_properties(submodel_properties);
+    return submodel_properties;
+}
+
 class InputsEmbedder::IInputsEmbedder {
 protected:
     // VLM config
@@ -48,9 +131,12 @@ protected:
     // If we use beam search sampling with chat mode we need to remove last answer of the model from kv cache and add best answer to history 
     // so, let's keep info about amount of tokens to trim from kv cache and amount of tokens to keep in history
     ov::genai::utils::HistoryRemoveManager m_kv_history_manager = {0, 0};
+    // Fraction of visual tokens of each image passed to the language model, see ov::genai::visual_tokens_keep_ratio
+    float m_visual_tokens_keep_ratio = 1.0f;
 
 public:
-    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) = 0;
+    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                         size_t temporal_pool_size) = 0;
 
     EmbeddingsModel get_embedding_model() const {
         return m_embedding;
@@ -69,16 +155,20 @@ public:
     }
 
     void update_tokenized_history(const std::vector<int64_t>& encoded_result, std::optional<int64_t> last_disappeared_token, bool is_beam_search, size_t last_answer_len) {
-        if (is_beam_search) {
+        // the last generated token is not fed to the model, it gets to KV cache with the next prompt only if it is kept
+        // as last_disappeared_token, e.g. EOS is not kept, so history holds the same tokens as KV cache
+        const size_t num_kept_answer_tokens = last_answer_len + (last_disappeared_token.has_value() ? 1 : 0);
+        // tokens of a matched stop string are removed from the answer, but not from KV cache, so it's removed as for beam search
+        if (is_beam_search || num_kept_answer_tokens > encoded_result.size()) {
             m_kv_history_manager.trusted_history_length = m_tokenized_history.size();
             m_kv_history_manager.num_tokens_to_remove_from_kv_cache = last_answer_len;
+            std::copy(encoded_result.begin(), encoded_result.end(), std::back_inserter(m_tokenized_history));
         } else {
             m_kv_history_manager.reset();
+            std::copy_n(encoded_result.begin(), num_kept_answer_tokens, std::back_inserter(m_tokenized_history));
         }
 
         m_last_disappeared_token = last_disappeared_token;
-  
-        std::copy(encoded_result.begin(), encoded_result.end(), std::back_inserter(m_tokenized_history));
     }
 
     virtual void start_chat(const std::string& system_message) {
@@ -120,9 +210,12 @@ protected:
         const std::string& device,
         const ov::AnyMap device_config) :
         m_vlm_config{vlm_config},
-        m_vision_encoder(model_dir, m_vlm_config.model_type, device, device_config),
-        m_embedding(model_dir, m_vlm_config.scale_emb, device, device_config),
-        m_tokenizer{model_dir, device_config} { }
+        m_vision_encoder(model_dir, m_vlm_config.model_type, get_submodel_device(device, device_config, vision_encoder_device),
+                         get_submodel_properties(device_config, vision_encoder_properties)),
+        m_embedding(model_dir, m_vlm_config.scale_emb, get_submodel_device(device, device_config, text_embeddings_device),
+                    remove_pipeline_properties(get_submodel_properties(device_config, text_embeddings_properties))),
+        m_tokenizer{model_dir, remove_pipeline_properties(device_config)},
+        m_visual_tokens_keep_ratio{get_visual_tokens_keep_ratio(device_config)} { }
     
     IInputsEmbedder(
         const VLMConfig& vlm_config,
@@ -137,17 +230,81 @@ protected:
             get_model_weights_pair(models_map, "vision_embeddings").second,
             config_dir_path,
             m_vlm_config.model_type,
-            device,
-            device_config
+            get_submodel_device(device, device_config, vision_encoder_device),
+            get_submodel_properties(device_config, vision_encoder_properties)
         ),
         m_embedding(
             get_model_weights_pair(models_map, "text_embeddings").first,
             get_model_weights_pair(models_map, "text_embeddings").second,
             m_vlm_config.scale_emb,
-            device,
-            device_config
+            get_submodel_device(device, device_config, text_embeddings_device),
+            remove_pipeline_properties(get_submodel_properties(device_config, text_embeddings_properties))
         ),
-        m_tokenizer(tokenizer) { }
+        m_tokenizer(tokenizer),
+        m_visual_tokens_keep_ratio{get_visual_tokens_keep_ratio(device_config)} { }
+
+    // Pools tokens of image embeddings [N, seq_len, hidden_size] according to m_visual_tokens_keep_ratio
+    ov::Tensor reduce_visual_tokens(const ov::Tensor& image_embeds) const {
+        return m_visual_tokens_keep_ratio < 1.0f ? pool_visual_tokens(image_embeds, m_visual_tokens_keep_ratio) : image_embeds;
+    }
+
+    // Starts encoding of images by the vision encoder in a separate thread, so that the prompt is tokenized and
+    // embedded meanwhile. The vision encoder and the embeddings model have own infer requests, images must outlive the result.
+    // Tokens of each temporal_pool_size consecutive images are averaged into a single encoded image.
+    // Only the encoding thread writes vision encoder metrics to raw_metrics until the result is got.
+    std::future<std::vector<EncodedImage>> encode_images_async(const std::vector<ov::Tensor>& images, ov::genai::VLMRawPerfMetrics& raw_metrics,
+                                                               size_t temporal_pool_size = 1) {
+        return std::async(images.empty() ? std::launch::deferred : std::launch::async, [this, &images, &raw_metrics, temporal_pool_size] {
+            return pool_temporally(m_vision_encoder.encode(images, ov::AnyMap{}, &raw_metrics), temporal_pool_size);
+        });
+    }
+
+    // Records a merge of image embeddings into text embeddings started at start_merge_time, which passes image_embeds
+    // [..., hidden_size] to the language model.
+    static void add_merge_metrics(ov::genai::VLMPerfMetrics& metrics, std::chrono::steady_clock::time_point start_merge_time,
+                                  const std::vector<ov::Tensor>& image_embeds) {
+        auto end_merge_time = std::chrono::steady_clock::now();
+        metrics.vlm_raw_metrics.embeddings_merge_durations.emplace_back(PerfMetrics::get_microsec(end_merge_time - start_merge_time));
+        for (const ov::Tensor& embeds : image_embeds) {
+            metrics.vlm_raw_metrics.num_image_tokens += embeds.get_size() / embeds.get_shape().back();
+        }
+    }
+
+    static size_t get_num_pooled_images(size_t num_images, size_t temporal_pool_size) {
+        return (num_images + temporal_pool_size - 1) / temporal_pool_size;
+    }
+
+    // Averages resized_source of groups of temporal_pool_size consecutive encoded images, the last group may be smaller.
+    // Images of a group must have the same shape, other fields are taken from the first image of a group.
+    static std::vector<EncodedImage> pool_temporally(std::vector<EncodedImage> encoded_images, size_t temporal_pool_size) {
+        if (temporal_pool_size == 1) {
+            return encoded_images;
+        }
+        std::vector<EncodedImage> pooled_images;
+        pooled_images.reserve(get_num_pooled_images(encoded_images.size(), temporal_pool_size));
+        for (size_t begin = 0; begin < encoded_images.size(); begin += temporal_pool_size) {
+            size_t end = std::min(begin + temporal_pool_size, encoded_images.size());
+            EncodedImage pooled = encoded_images[begin];
+            const ov::Tensor& first = encoded_images[begin].resized_source;
+            pooled.resized_source = ov::Tensor(first.get_element_type(), first.get_shape());
+            float* pooled_data = pooled.resized_source.data<float>();
+            std::copy_n(first.data<float>(), first.get_size(), pooled_data);
+            for (size_t idx = begin + 1; idx < end; ++idx) {
+                const ov::Tensor& frame = encoded_images[idx].resized_source;
+                OPENVINO_ASSERT(frame.get_shape() == first.get_shape(), "Temporally pooled images must have the same shape");
+                const float* frame_data = frame.data<float>();
+                for (size_t i = 0; i < first.get_size(); ++i) {
+                    pooled_data[i] += frame_data[i];
+                }
+            }
+            const float scale = 1.0f / (end - begin);
+            std::transform(pooled_data, pooled_data + first.get_size(), pooled_data, [scale](float value) {
+                return value * scale;
+            });
+            pooled_images.push_back(std::move(pooled));
+        }
+        return pooled_images;
+    }
 
     ov::Tensor get_encoded_input_ids(const std::string& prompt, ov::genai::VLMPerfMetrics& metrics, const std::string& chat_template_fallback = "") {
         ov::Tensor encoded_input_ids;
@@ -170,6 +327,21 @@ protected:
                 new_templated_chat_history = m_tokenizer.apply_chat_template(m_history, add_generation_prompt, chat_template_fallback);
             }
             auto start_tokenizer_time = std::chrono::steady_clock::now();
+            // m_templated_chat_history holds the text whose tokens are in KV cache: previous turns with their answers.
+            // If the new templated history only extends it, tokenize just the extension. Tokens of previous turns,
+            // including expanded image tokens, stay in KV cache and are neither re-tokenized nor re-embedded.
+            if (!m_tokenized_history.empty() && !m_kv_history_manager.does_kv_cache_need_to_update()
+                && new_templated_chat_history.compare(0, m_templated_chat_history.size(), m_templated_chat_history) == 0) {
+                encoded_input_ids = m_tokenizer.encode(new_templated_chat_history.substr(m_templated_chat_history.size()),
+                                                       ov::genai::add_special_tokens(false)).input_ids;
+                std::copy_n(encoded_input_ids.data<int64_t>(), encoded_input_ids.get_size(), std::back_inserter(m_tokenized_history));
+                if (m_last_disappeared_token.has_value())
+                    encoded_input_ids = ov::genai::utils::push_front_inputs(encoded_input_ids, *m_last_disappeared_token);
+                auto end_tokenizer_time = std::chrono::steady_clock::now();
+                metrics.raw_metrics.tokenization_durations.emplace_back(PerfMetrics::get_microsec(end_tokenizer_time - start_tokenizer_time));
+                m_templated_chat_history = std::move(new_templated_chat_history);
+                return encoded_input_ids;
+            }
             ov::Tensor new_chat_tokens = m_tokenizer.encode(new_templated_chat_history, ov::genai::add_special_tokens(false)).input_ids;
             TokenizedInputs prev_chat_tokens = m_tokenizer.encode(m_templated_chat_history, ov::genai::add_special_tokens(false));
 
@@ -278,6 +450,11 @@ class InputsEmbedderMiniCPM : public InputsEmbedder::IInputsEmbedder {
     // [70, 70, hidden_size]. 70 is the initial guess of the image
     // height and width after dividing by patch_size.
     ov::Tensor m_pos_embed_cache;
+    // 1D sin-cos embeddings of positions, from which m_pos_embed_cache is assembled when it grows.
+    // [num_positions, hidden_size / 2], extended on demand.
+    std::vector<float> m_pos_embed_1d;
+    // Inputs of m_resampler reused across resample() calls, reallocated only when they grow.
+    ov::Tensor m_resampler_pos_embed{ov::element::f32, {0, 0, 0}}, m_resampler_key_padding_mask{ov::element::f32, {0, 0}};
     // Used to insert <image_id>i</image_id> per image (not a slice).
     size_t m_image_id = 0;
 
@@ -289,7 +466,9 @@ public:
         const ov::AnyMap device_config) :
         IInputsEmbedder(vlm_config, model_dir, device, device_config) {
         auto compiled_model =
-            utils::singleton_core().compile_model(model_dir / "openvino_resampler_model.xml", device, device_config);
+            utils::singleton_core().compile_model(model_dir / "openvino_resampler_model.xml",
+                                                  get_submodel_device(device, device_config, vision_encoder_device),
+                                                  remove_pipeline_properties(get_submodel_properties(device_config, vision_encoder_properties)));
         ov::genai::utils::print_compiled_model_properties(compiled_model, "VLM resampler model");
         m_resampler = compiled_model.create_infer_request();
 
@@ -307,21 +486,23 @@ public:
             m_resampler = utils::singleton_core().compile_model(
                 get_model_weights_pair(models_map, "resampler").first,
                 get_model_weights_pair(models_map, "resampler").second,
-                device,
-                device_config
+                get_submodel_device(device, device_config, vision_encoder_device),
+                remove_pipeline_properties(get_submodel_properties(device_config, vision_encoder_properties))
             ).create_infer_request();
 
             m_pos_embed_cache = get_2d_sincos_pos_embed(m_vlm_config.hidden_size, {70, 70});
         }
 
-    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) override {
+    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                         size_t temporal_pool_size) override {
+        OPENVINO_ASSERT(temporal_pool_size == 1, "Temporal pooling is not supported by MiniCPM, which resamples each slice separately");
         std::string images_prompt;
         std::vector<EncodedImage> embeds;
 
         std::vector<ov::Tensor> single_images = to_single_image_tensors(images);
 
         for (const ov::Tensor& image : single_images) {
-            EncodedImage encoded_image = m_vision_encoder.encode(image);
+            EncodedImage encoded_image = m_vision_encoder.encode(std::vector<ov::Tensor>{image}, ov::AnyMap{}, &metrics.vlm_raw_metrics).at(0);
             if (m_vlm_config.use_image_id) {
                 images_prompt += m_vlm_config.im_id_start + std::to_string(m_image_id) + m_vlm_config.im_id_end;
                 ++m_image_id;
@@ -380,8 +561,14 @@ public:
         size_t encoded_input_size = encoded_input.get_size();
         int64_t* end = ids + encoded_input_size;
         float* inputs_embeds_data = inputs_embeds.data<float>();
+        std::vector<MicroSeconds>& resampling_durations = metrics.vlm_raw_metrics.resampling_durations;
+        const size_t prev_resampling_count = resampling_durations.size();
+        auto start_merge_time = std::chrono::steady_clock::now();
         for (const EncodedImage& encoded_image : embeds) {
+            auto start_resampling_time = std::chrono::steady_clock::now();
             const ov::Tensor& resampled_source = resample(encoded_image.resized_source, {encoded_image.resized_source_size});
+            resampling_durations.emplace_back(PerfMetrics::get_microsec(std::chrono::steady_clock::now() - start_resampling_time));
+            metrics.vlm_raw_metrics.num_image_tokens += m_vlm_config.query_num;
             float* emb = resampled_source.data<float>();
             ids = std::find(ids, end, im_start_id);
             OPENVINO_ASSERT(end != ids);
@@ -396,7 +583,10 @@ public:
                         size_t d2 = slices_shape.at(2);
                         size_t d3 = slices_shape.at(3);
                         ov::Tensor encoded_view{ov::element::f32, {1, d2, d3}, encoded_image.slices.data<float>() + (i * slices_shape.at(1) + ja) * d2 * d3};
+                        start_resampling_time = std::chrono::steady_clock::now();
                         const ov::Tensor& vision_embed_tensor_i_j = resample(encoded_view, {encoded_image.slices_size});
+                        resampling_durations.emplace_back(PerfMetrics::get_microsec(std::chrono::steady_clock::now() - start_resampling_time));
+                        metrics.vlm_raw_metrics.num_image_tokens += m_vlm_config.query_num;
                         ids = std::find(ids, end, slice_start_id);
                         OPENVINO_ASSERT(end != ids);
                         ++ids;
@@ -406,6 +596,14 @@ public:
                 }
             }
         }
+        if (!embeds.empty()) {
+            // the merge duration excludes resampling, which is recorded separately
+            MicroSeconds merge_duration{PerfMetrics::get_microsec(std::chrono::steady_clock::now() - start_merge_time)};
+            for (size_t idx = prev_resampling_count; idx < resampling_durations.size(); ++idx) {
+                merge_duration -= resampling_durations[idx];
+            }
+            metrics.vlm_raw_metrics.embeddings_merge_durations.push_back(merge_duration);
+        }
 
         if (!m_is_chat_conversation) {
             m_image_id = 0;
@@ -426,7 +624,7 @@ public:
 private:
     ov::Tensor resample(const ov::Tensor& encoded_image, const std::vector<ImageSize>& target_sizes) {
         size_t bs = encoded_image.get_shape().at(0);
-        std::vector<size_t> patch_len{target_sizes.size()};
+        std::vector<size_t> patch_len(target_sizes.size());
         std::transform(target_sizes.begin(), target_sizes.end(), patch_len.begin(), [](const ImageSize& height_width) {
             return height_width.height * height_width.width;
         });
@@ -436,18 +634,24 @@ private:
             m_pos_embed_cache
         );
         size_t max_patch_len = *std::max_element(patch_len.begin(), patch_len.end());
-        ov::Tensor key_padding_mask(ov::element::f32, {bs, max_patch_len});
+        ov::Tensor& key_padding_mask = m_resampler_key_padding_mask;
+        key_padding_mask.set_shape({bs, max_patch_len});
         float* mask_data = key_padding_mask.data<float>();
         size_t embed_len = m_pos_embed_cache.get_shape().at(2);
-        ov::Tensor pos_embed(ov::element::f32, {max_patch_len, bs, embed_len});  // BLD => L * B * D
+        ov::Tensor& pos_embed = m_resampler_pos_embed;
+        pos_embed.set_shape({max_patch_len, bs, embed_len});  // BLD => L * B * D
         float* pos_embed_data = pos_embed.data<float>();
         float* cache_data = m_pos_embed_cache.data<float>();
-        size_t _d0 = m_pos_embed_cache.get_shape().at(0);
         size_t _d1 = m_pos_embed_cache.get_shape().at(1);
         for (size_t i = 0; i < bs; ++i) {
             size_t target_h = target_sizes.at(i).height;
             size_t target_w = target_sizes.at(i).width;
-            for (size_t h_idx = 0; h_idx < target_h; ++h_idx) {
+            ov::parallel_for(target_h, [&](size_t h_idx) {
+                if (bs == 1) {
+                    // a row of the cache is contiguous in pos_embed as well
+                    std::copy_n(cache_data + h_idx * _d1 * embed_len, target_w * embed_len, pos_embed_data + h_idx * target_w * embed_len);
+                    return;
+                }
                 for (size_t w_idx = 0; w_idx < target_w; ++w_idx) {
                     std::copy_n(
                         cache_data + (h_idx * _d1 + w_idx) * embed_len,
@@ -455,7 +659,7 @@ private:
                         pos_embed_data + (h_idx * target_w + w_idx) * bs * embed_len + i * embed_len
                     );
                 }
-            }
+            });
             for (size_t flat = target_h * target_w; flat < max_patch_len; ++flat) {
                 std::fill_n(pos_embed_data + flat * bs * embed_len + i * embed_len, embed_len, 0.0f);
             }
@@ -469,100 +673,54 @@ private:
         return m_resampler.get_output_tensor();  // [N, query_num, new_hidden_size]
     }
 
-    ov::Tensor concatenate_last_dim(const ov::Tensor& first, const ov::Tensor& second) {
-        size_t res_d_0 = first.get_shape().at(0);
-        size_t res_d_1 = first.get_shape().at(1);
-        OPENVINO_ASSERT(second.get_shape().at(0) == res_d_0);
-        OPENVINO_ASSERT(second.get_shape().at(1) == res_d_1);
-        size_t res_d_2 = first.get_shape().at(2) + second.get_shape().at(2);
-        ov::Tensor res{first.get_element_type(), {res_d_0, res_d_1, res_d_2}};
-        float* first_data = first.data<float>();
-        float* second_data = second.data<float>();
-        float* res_data = res.data<float>();
-        for (size_t i = 0; i < res_d_0; ++i) {
-            for (size_t j = 0; j < res_d_1; ++j) {
-                size_t k = 0;
-                for (; k < first.get_shape().at(2); ++k) {
-                    res_data[i * res_d_1 * res_d_2 + j * res_d_2 + k]
-                        = first_data[i * res_d_1 * first.get_shape().at(2) + j * first.get_shape().at(2) + k];
-                }
-                for (size_t l = 0; l < second.get_shape().at(2); ++l, ++k) {
-                    res_data[i * res_d_1 * res_d_2 + j * res_d_2 + k]
-                        = second_data[i * res_d_1 * second.get_shape().at(2) + j * second.get_shape().at(2) + l];
-                }
-            }
-        }
-        return res;
-    }
-
+    /// Extends m_pos_embed_1d to cover positions [0, num_positions).
     /// embed_dim: output dimension for each position
-    /// pos: a list of positions to be encoded: size (H, W)
-    /// out: (H, W, D)
-    ov::Tensor get_1d_sincos_pos_embed_from_grid_new(size_t embed_dim, const ov::Tensor& pos) {
+    /// m_pos_embed_1d: (num_positions, D), sin of D/2 frequencies followed by their cos
+    void adjust_1d_sincos_pos_embed(size_t embed_dim, size_t num_positions) {
         OPENVINO_ASSERT(embed_dim % 2 == 0);
-        ov::Shape pos_shape = pos.get_shape();
-        size_t H = pos_shape[0];
-        size_t W = pos_shape[1];
+        size_t computed_positions = m_pos_embed_1d.size() / embed_dim;
+        if (num_positions <= computed_positions) {
+            return;
+        }
 
         std::vector<float> omega(embed_dim / 2);
         for (size_t i = 0; i < omega.size(); ++i) {
             omega[i] = 1.0f / std::pow(10000.0f, float(i) / (embed_dim / 2));
         }
 
-        std::vector<size_t> out_shape = {H, W, embed_dim};
-        ov::Tensor emb(ov::element::f32, out_shape);
-
-        float* pos_data = pos.data<float>();
-        float* emb_data = emb.data<float>();
-
-        size_t counter = 0;
-        for (size_t h = 0; h < H; ++h) {
-            for (size_t w = 0; w < W; ++w) {
-                for (size_t d = 0; d < embed_dim / 2; ++d) {
-                    // Correctly access the 2D position grid
-                    float value = omega[d] * pos_data[h * W + w];
-                    emb_data[h * W * embed_dim + w * embed_dim + d] = std::sin(value);
-                    emb_data[h * W * embed_dim + w * embed_dim + d + (embed_dim / 2)] = std::cos(value);
-                }
+        m_pos_embed_1d.resize(num_positions * embed_dim);
+        for (size_t pos = computed_positions; pos < num_positions; ++pos) {
+            float* emb_data = m_pos_embed_1d.data() + pos * embed_dim;
+            for (size_t d = 0; d < embed_dim / 2; ++d) {
+                float value = omega[d] * float(pos);
+                emb_data[d] = std::sin(value);
+                emb_data[d + (embed_dim / 2)] = std::cos(value);
             }
         }
-        return emb;
-    }
-
-    ov::Tensor get_2d_sincos_pos_embed_from_grid(size_t embed_dim, const ov::Tensor& grid) {
-        OPENVINO_ASSERT(embed_dim % 2 == 0);
-        ov::Shape grid_shape = grid.get_shape();
-        float* grid_data = grid.data<float>();
-        ov::Shape plane_shape{grid_shape.at(1), grid_shape.at(2)};
-        ov::Tensor emb_h = get_1d_sincos_pos_embed_from_grid_new(embed_dim / 2, ov::Tensor{
-            ov::element::f32,
-            plane_shape,
-            grid_data
-        });  // (H, W, D/2)
-        ov::Tensor emb_w = get_1d_sincos_pos_embed_from_grid_new(embed_dim / 2, ov::Tensor{
-            ov::element::f32,
-            plane_shape,
-            grid_data + plane_shape.at(0) * plane_shape.at(1)
-        });  // (H, W, D/2)
-        return concatenate_last_dim(emb_h, emb_w);
     }
 
     /// image_size: image_size or (image_height, image_width)
     /// return:
     /// pos_embed: [image_height, image_width, embed_dim]
+    /// The first half of the embedding at (y, x) encodes x and the second half encodes y, so the 2D grid is assembled
+    /// from 1D embeddings, which are computed once for each position and reused by later grids.
     ov::Tensor get_2d_sincos_pos_embed(size_t embed_dim, const ImageSize& image_size) {
+        OPENVINO_ASSERT(embed_dim % 2 == 0);
         size_t grid_h_size = image_size.height, grid_w_size = image_size.width;
-        ov::Tensor grid(ov::element::f32, {2, grid_h_size, grid_w_size});
-        float* data = grid.data<float>();
-        for (size_t y = 0; y < grid_h_size; ++y) {
-            std::iota(data, data + grid_w_size, 0.0f);
-            data += grid_w_size;
-        }
-        for (float y = 0.0f; y < grid_h_size; ++y) {
-            std::fill(data, data + grid_w_size, y);
-            data += grid_w_size;
-        }
-        return get_2d_sincos_pos_embed_from_grid(embed_dim, grid);
+        size_t half_dim = embed_dim / 2;
+        adjust_1d_sincos_pos_embed(half_dim, std::max(grid_h_size, grid_w_size));
+
+        ov::Tensor pos_embed(ov::element::f32, {grid_h_size, grid_w_size, embed_dim});
+        float* pos_embed_data = pos_embed.data<float>();
+        const float* emb_1d_data = m_pos_embed_1d.data();
+        ov::parallel_for(grid_h_size, [&](size_t y) {
+            float* row_data = pos_embed_data + y * grid_w_size * embed_dim;
+            for (size_t x = 0; x < grid_w_size; ++x) {
+                std::copy_n(emb_1d_data + x * half_dim, half_dim, row_data + x * embed_dim);
+                std::copy_n(emb_1d_data + y * half_dim, half_dim, row_data + x * embed_dim + half_dim);
+            }
+        });
+        return pos_embed;
     }
 
     void adjust_pos_cache(
@@ -612,20 +770,18 @@ public:
         const ov::AnyMap device_config) :
         IInputsEmbedder(vlm_config, models_map, tokenizer, config_dir_path, device, device_config) { }
 
-    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) override {
+    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                         size_t temporal_pool_size) override {
         std::string image_token = m_vlm_config.im_start;
         // Adapted from llava-1.5-7b-hf chat_template.json
         std::string chat_template_fallback = "{% for message in messages %}{% if message['role'] == 'user' %}{{ 'USER: ' + message['content'] + ' ' }}{% else %}{{ 'ASSISTANT: ' + message['content'] + ' ' }}{% endif %}{% endfor %}{% if add_generation_prompt %}{{ 'ASSISTANT:' }}{% endif %}";
         
         std::vector<ov::Tensor> single_images = to_single_image_tensors(images);
+        // the prompt depends only on the number of images, so it's embedded while images are encoded
+        std::future<std::vector<EncodedImage>> encoded_images = encode_images_async(single_images, metrics.vlm_raw_metrics, temporal_pool_size);
 
         std::string formatted_prompt;
-        std::vector<ov::Tensor> image_embeds;
-        image_embeds.reserve(single_images.size());
-
-        for (const auto& image : single_images) {
-            EncodedImage encoded_image = m_vision_encoder.encode(image);
-            image_embeds.push_back(std::move(encoded_image.resized_source));
+        for (size_t image_idx = 0; image_idx < get_num_pooled_images(single_images.size(), temporal_pool_size); ++image_idx) {
             formatted_prompt += image_token + "\n";
         }
         formatted_prompt += prompt;
@@ -633,6 +789,12 @@ public:
         ov::Tensor input_ids = get_encoded_input_ids(formatted_prompt, metrics, chat_template_fallback);
         ov::Tensor text_embeds = m_embedding.infer(input_ids);
 
+        std::vector<ov::Tensor> image_embeds;
+        image_embeds.reserve(single_images.size());
+        for (EncodedImage& encoded_image : encoded_images.get()) {
+            image_embeds.push_back(reduce_visual_tokens(encoded_image.resized_source));
+        }
+
         if (images.empty()) {
             return text_embeds;
         }
@@ -642,7 +804,10 @@ public:
         OPENVINO_ASSERT(metrics.raw_metrics.tokenization_durations.size() > 0);
         metrics.raw_metrics.tokenization_durations[metrics.raw_metrics.tokenization_durations.size() - 1] += ov::genai::MicroSeconds(PerfMetrics::get_microsec(end_tokenizer_time - start_tokenizer_time));
         int64_t image_token_id = encoded_image_token.data<int64_t>()[encoded_image_token.get_size() - 1];
-        return merge_text_and_image_embeddings_llava(input_ids, text_embeds, image_embeds, image_token_id);
+        auto start_merge_time = std::chrono::steady_clock::now();
+        ov::Tensor inputs_embeds = merge_text_and_image_embeddings_llava(input_ids, text_embeds, image_embeds, image_token_id);
+        add_merge_metrics(metrics, start_merge_time, image_embeds);
+        return inputs_embeds;
     }
 
 protected:
@@ -659,12 +824,14 @@ protected:
         const int64_t* input_ids_data = input_ids.data<const int64_t>();
         const float* text_embeds_data = text_embeds.data<const float>();
 
-        size_t num_image_tokens = 0;
+        // image tokens split the prompt into text spans, each span and each image is copied at once
+        std::vector<size_t> image_token_positions;
         for (size_t s = 0; s < text_embeds_seq_length; ++s) {
             if (input_ids_data[s] == image_token_id) {
-                num_image_tokens++;
+                image_token_positions.push_back(s);
             }
         }
+        size_t num_image_tokens = image_token_positions.size();
         auto num_images = image_embeds.size();
         OPENVINO_ASSERT(
             num_image_tokens == num_images,
@@ -685,23 +852,23 @@ protected:
         float* merged_data = merged_embeds.data<float>();
 
         size_t merged_idx = 0;
-        size_t image_idx = 0;
-        for (size_t s = 0; s < text_embeds_seq_length; ++s) {
-            if (input_ids_data[s] == image_token_id) {
-                const float* image_embeds_data = image_embeds[image_idx].data<const float>();
-                size_t image_seq_length = image_embeds[image_idx].get_shape()[1];
-
-                std::copy_n(image_embeds_data,
-                            image_seq_length * hidden_size,
-                            merged_data + merged_idx * hidden_size);
-                merged_idx += image_seq_length;
-                image_idx++;
-            } else {
-                std::copy_n(text_embeds_data + s * hidden_size,
-                            hidden_size,
-                            merged_data + merged_idx * hidden_size);
-                merged_idx++;
+        size_t text_begin = 0;
+        for (size_t image_idx = 0; image_idx <= num_images; ++image_idx) {
+            size_t text_end = image_idx < num_images ? image_token_positions[image_idx] : text_embeds_seq_length;
+            std::copy_n(text_embeds_data + text_begin * hidden_size,
+                        (text_end - text_begin) * hidden_size,
+                        merged_data + merged_idx * hidden_size);
+            merged_idx += text_end - text_begin;
+            if (image_idx == num_images) {
+                break;
             }
+
+            size_t image_seq_length = image_embeds[image_idx].get_shape()[1];
+            std::copy_n(image_embeds[image_idx].data<const float>(),
+                        image_seq_length * hidden_size,
+                        merged_data + merged_idx * hidden_size);
+            merged_idx += image_seq_length;
+            text_begin = text_end + 1;
         }
         return merged_embeds;
     }
@@ -725,21 +892,35 @@ public:
         const ov::AnyMap device_config) :
         InputsEmbedderLLaVA(vlm_config, models_map, tokenizer, config_dir_path, device, device_config) { }
 
-    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) override {
+    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                         size_t temporal_pool_size) override {
         std::string image_token = m_vlm_config.im_start;
         // Adapted from llava-1.5-7b-hf chat_template.json
         std::string chat_template_fallback = "{% for message in messages %}{% if message['role'] == 'user' %}{{ 'USER: ' + message['content'] + ' ' }}{% else %}{{ 'ASSISTANT: ' + message['content'] + ' ' }}{% endif %}{% endfor %}{% if add_generation_prompt %}{{ 'ASSISTANT:' }}{% endif %}";
 
         std::vector<ov::Tensor> single_images = to_single_image_tensors(images);
+        // the prompt depends only on the number of images, so it's embedded while images are encoded
+        std::future<std::vector<EncodedImage>> encoded_images_future = encode_images_async(single_images, metrics.vlm_raw_metrics, temporal_pool_size);
 
         std::string formatted_prompt;
+        for (size_t image_idx = 0; image_idx < get_num_pooled_images(single_images.size(), temporal_pool_size); ++image_idx) {
+            formatted_prompt += image_token + "\n";
+        }
+        formatted_prompt += prompt;
+
+        ov::Tensor input_ids = get_encoded_input_ids(formatted_prompt, metrics, chat_template_fallback);
+        ov::Tensor text_embeds = m_embedding.infer(input_ids);
+
         std::vector<ov::Tensor> image_embeds;
         image_embeds.reserve(single_images.size());
         
         ov::Tensor image_newline;
 
-        for (const auto& image : single_images) {
-            EncodedImage encoded_image = m_vision_encoder.encode(image);
+        std::vector<EncodedImage> encoded_images = encoded_images_future.get();
+        for (size_t image_idx = 0; image_idx < encoded_images.size(); ++image_idx) {
+            // pooled images have the size of the first image of their group
+            const ov::Tensor& image = single_images[image_idx * temporal_pool_size];
+            EncodedImage& encoded_image = encoded_images[image_idx];
 
             if (!image_newline) {
                 size_t embed_dim = encoded_image.resized_source.get_shape().at(2);
@@ -752,13 +933,8 @@ public:
 
             ov::Tensor packed_features = pack_image_features_llava_next(encoded_image, original_image_size, image_newline);
 
-            image_embeds.push_back(std::move(packed_features));
-            formatted_prompt += image_token + "\n";
+            image_embeds.push_back(reduce_visual_tokens(packed_features));
         }
-        formatted_prompt += prompt;
-
-        ov::Tensor input_ids = get_encoded_input_ids(formatted_prompt, metrics, chat_template_fallback);
-        ov::Tensor text_embeds = m_embedding.infer(input_ids);
 
         if (images.empty()) {
             return text_embeds;
@@ -769,7 +945,10 @@ public:
         OPENVINO_ASSERT(metrics.raw_metrics.tokenization_durations.size() > 0);
         metrics.raw_metrics.tokenization_durations[metrics.raw_metrics.tokenization_durations.size() - 1] += ov::genai::MicroSeconds(PerfMetrics::get_microsec(end_tokenizer_time - start_tokenizer_time));
         int64_t image_token_id = encoded_image_token.data<int64_t>()[encoded_image_token.get_size() - 1];
-        return merge_text_and_image_embeddings_llava(input_ids, text_embeds, image_embeds, image_token_id);
+        auto start_merge_time = std::chrono::steady_clock::now();
+        ov::Tensor inputs_embeds = merge_text_and_image_embeddings_llava(input_ids, text_embeds, image_embeds, image_token_id);
+        add_merge_metrics(metrics, start_merge_time, image_embeds);
+        return inputs_embeds;
     }
 
 private:
@@ -797,53 +976,63 @@ private:
         const float* newline_data = image_newline.data<float>();
 
         if (num_patches > 1) {
-            // Extract base image feature (first patch)
-            ov::Tensor base_image_feature(image_feature.get_element_type(), {1, patch_seq_len, embed_dim});
-            const float* src_data = image_feature.data<float>();
-            float* dst_data = base_image_feature.data<float>();
-            std::copy(src_data, src_data + patch_seq_len * embed_dim, dst_data);
-
-            // Extract other grid patches
-            ov::Tensor patches_image_feature(image_feature.get_element_type(), {num_patches - 1, patch_seq_len, embed_dim});
-            dst_data = patches_image_feature.data<float>();
-            std::copy(src_data + patch_seq_len * embed_dim,
-                    src_data + num_patches * patch_seq_len * embed_dim,
-                    dst_data);
-
-            // Process grid patches image feature
             size_t height = encoded_image.resized_source_size.height;
             size_t width = encoded_image.resized_source_size.width;
             size_t num_patch_height = encoded_image.patches_grid.first;
             size_t num_patch_width = encoded_image.patches_grid.second;
+            OPENVINO_ASSERT(
+                num_patches - 1 == num_patch_height * num_patch_width,
+                "Number of patches does not match the specified grid size"
+            );
+            OPENVINO_ASSERT(
+                patch_seq_len == height * width,
+                "Patch sequence length does not match the specified height and width"
+            );
 
-            ov::Tensor reshaped_image_feature = reshape_and_rearrange_image_feature(patches_image_feature, num_patch_height, num_patch_width, height, width);
-
-            ov::Tensor unpadded_image_feature = unpad_image(reshaped_image_feature, original_image_size);
-
-            ov::Tensor image_feature_with_newline = add_image_newline(unpadded_image_feature, image_newline);
-
-            ov::Tensor processed_image_feature = flatten_and_transpose(image_feature_with_newline);
-
-            // Concatenate base image feature ([1, seq_len_1, emded_dim]) and patches image feature ([seq_len_2, embed_dim])
-            auto base_shape = base_image_feature.get_shape();
-            auto processed_shape = processed_image_feature.get_shape();
-
-            const float* base_data = base_image_feature.data<float>();
-            const float* processed_data = processed_image_feature.data<float>();
+            // Grid patches form a (num_patch_height * height, num_patch_width * width) feature map, which is unpadded,
+            // appended with image_newline to each row and flattened. Embeddings are contiguous in both encoded_image and
+            // the result, so each position is copied from its patch at once, without intermediate transposed maps.
+            size_t current_height = num_patch_height * height;
+            size_t current_width = num_patch_width * width;
+            size_t row_offset = 0, col_offset = 0, num_rows = current_height, num_cols = current_width;
+            float original_aspect_ratio = static_cast<float>(original_image_size.width) / original_image_size.height;
+            float current_aspect_ratio = static_cast<float>(current_width) / current_height;
+            if (original_aspect_ratio > current_aspect_ratio) {
+                float scale_factor = static_cast<float>(current_width) / original_image_size.width;
+                size_t new_height = static_cast<size_t>(original_image_size.height * scale_factor);
+                row_offset = (current_height - new_height) / 2;
+                num_rows = std::min(new_height + 1, current_height - row_offset);
+            } else {
+                float scale_factor = static_cast<float>(current_height) / original_image_size.height;
+                size_t new_width = static_cast<size_t>(original_image_size.width * scale_factor);
+                col_offset = (current_width - new_width) / 2;
+                num_cols = std::min(new_width + 1, current_width - col_offset);
+            }
 
-            ov::Tensor result(image_feature.get_element_type(), {1, base_shape[1] + processed_shape[0], embed_dim});
-            // Copy base image feature data
-            std::copy(base_data, base_data + base_shape[1] * embed_dim, result.data<float>());
-            // Copy processed image feature data
-            std::copy(processed_data,
-                    processed_data + processed_shape[0] * embed_dim,
-                    result.data<float>() + base_shape[1] * embed_dim);
+            // Concatenate base image feature (first patch) and packed grid patches
+            ov::Tensor result(image_feature.get_element_type(), {1, patch_seq_len + num_rows * (num_cols + 1), embed_dim});
+            float* result_data = result.data<float>();
+            std::copy_n(image_feature_data, patch_seq_len * embed_dim, result_data);
+
+            const float* patches_data = image_feature_data + patch_seq_len * embed_dim;
+            float* packed_data = result_data + patch_seq_len * embed_dim;
+            ov::parallel_for(num_rows, [&](size_t row) {
+                size_t y = row + row_offset;
+                size_t patch_row = y / height, h = y % height;
+                float* dst = packed_data + row * (num_cols + 1) * embed_dim;
+                for (size_t col = 0; col < num_cols; ++col, dst += embed_dim) {
+                    size_t x = col + col_offset;
+                    size_t patch = patch_row * num_patch_width + x / width;
+                    std::copy_n(patches_data + (patch * patch_seq_len + h * width + x % width) * embed_dim, embed_dim, dst);
+                }
+                std::copy_n(newline_data, embed_dim, dst);
+            });
             return result;
         } else {
             // If there is only one patch, return the original (base) image feature concatenated with image_newline
             ov::Tensor result(image_feature.get_element_type(), {1, patch_seq_len + 1, embed_dim});
             // Copy base image feature data
-            std::copy(image_feature_data + embed_dim,
+            std::copy(image_feature_data,
                     image_feature_data + patch_seq_len * embed_dim,
                     result.data<float>());
             // Append image_newline data
@@ -853,185 +1042,6 @@ private:
             return result;
         }
     }
-
-    /**
-    * @brief Adds image newline tensor to patches image feature tensor.
-    * Used for packing image features of llava_next models.
-    *
-    * @param image_feature A tensor with a shape (embed_dim, height, width)
-    * @param image_newline A tensor with a shape (embed_dim)
-    * @return A tensor with a shape (embed_dim, height, width + 1)
-    */
-    ov::Tensor add_image_newline(const ov::Tensor& image_feature, const ov::Tensor& image_newline) {
-        auto shape = image_feature.get_shape();
-
-        OPENVINO_ASSERT(shape.size() == 3, "Input image_feature must have 3 dimensions");
-
-        size_t embed_dim = shape[0];
-        size_t height = shape[1];
-        size_t width = shape[2];
-
-        OPENVINO_ASSERT(image_newline.get_shape()[0] == embed_dim, "image_newline dimension must match embed_dim of image_feature");
-
-        const float* image_feature_data = image_feature.data<float>();
-        const float* newline_data = image_newline.data<float>();
-
-        ov::Tensor feature_with_newline{image_feature.get_element_type(), {embed_dim, height, width + 1}};
-        float* feature_with_newline_data = feature_with_newline.data<float>();
-
-        for (size_t e = 0; e < embed_dim; ++e) {
-            for (size_t h = 0; h < height; ++h) {
-                // Copy original image feature data
-                std::copy(
-                    image_feature_data + (e * height * width + h * width),
-                    image_feature_data + (e * height * width + (h + 1) * width),
-                    feature_with_newline_data + (e * height * (width + 1) + h * (width + 1))
-                );
-                // Add image newline
-                feature_with_newline_data[e * height * (width + 1) + h * (width + 1) + width] = newline_data[e];
-            }
-        }
-
-        return feature_with_newline;
-    }
-
-    /**
-    * @brief Flattens and transposes tensor.
-    * Used for packing image features of llava_next models.
-    *
-    * @param tensor A tensor with a shape (embed_dim, height, width)
-    * @return A tensor with a shape (height * width, embed_dim)
-    */
-    ov::Tensor flatten_and_transpose(const ov::Tensor& tensor) {
-        auto shape = tensor.get_shape();
-        OPENVINO_ASSERT(shape.size() == 3, "Flattening tensor must have 3 dimensions");
-        const float* data = tensor.data<float>();
-        size_t embed_dim = shape[0];
-        size_t height = shape[1];
-        size_t width = shape[2];
-        size_t flatten_dim = height * width;
-
-        ov::Tensor flatten_feature(tensor.get_element_type(), {flatten_dim, embed_dim});
-        float* flatten_feature_data = flatten_feature.data<float>();
-
-        for (size_t h = 0; h < height; ++h) {
-            for (size_t w = 0; w < width; ++w) {
-                for (size_t e = 0; e < embed_dim; ++e) {
-                    flatten_feature_data[(h * width + w) * embed_dim + e] = data[e * flatten_dim + h * width + w];
-                }
-            }
-        }
-
-        return flatten_feature;
-    }
-
-
-    ov::Tensor reshape_and_rearrange_image_feature(const ov::Tensor& image_feature,
-                                                   int num_patch_height,
-                                                   int num_patch_width,
-                                                   int height,
-                                                   int width) {
-        auto shape = image_feature.get_shape();
-        OPENVINO_ASSERT(shape.size() == 3, "image_feature tensor must have 3 dimensions");
-
-        size_t num_patches = shape[0];
-        size_t patch_seq_len = shape[1];
-        size_t embed_dim = shape[2];
-
-        OPENVINO_ASSERT(
-            num_patches == num_patch_height * num_patch_width,
-            "Number of patches does not match the specified grid size"
-        );
-
-        OPENVINO_ASSERT(
-            patch_seq_len == height * width,
-            "Patch sequence length does not match the specified height and width"
-        );
-
-        // Reshape tensor data and permute dimensions
-        // [num_patches, patch_seq_len, embed_dim] -> [embed_dim, num_patch_height, height, num_patch_width, width]
-        std::vector<float> reshaped_data(num_patches * patch_seq_len * embed_dim);
-        const float* image_feature_data = image_feature.data<float>();
-
-        for (int p = 0; p < num_patches; ++p) {
-            for (int i = 0; i < patch_seq_len; ++i) {
-                for (int e = 0; e < embed_dim; ++e) {
-                    int h = i / width;
-                    int w = i % width;
-                    int ph = p / num_patch_width;
-                    int pw = p % num_patch_width;
-                    reshaped_data[((((e * num_patch_height + ph) * height + h) * num_patch_width + pw) * width + w)] =
-                        image_feature_data[(p * patch_seq_len + i) * embed_dim + e];
-                }
-            }
-        }
-
-        ov::Tensor result(image_feature.get_element_type(),
-                          {static_cast<size_t>(embed_dim),
-                           static_cast<size_t>(num_patch_height * height),
-                           static_cast<size_t>(num_patch_width * width)}
-        );
-        std::copy(reshaped_data.begin(), reshaped_data.end(), result.data<float>());
-        return result;
-    }
-
-    /**
-    * @brief Unpads an image tensor of a padded and resized image.
-    * Used for packing image features of llava_next models.
-    *
-    * @param tensor An image tensor with a shape (embed_dim, height, width)
-    * @param original_size A size of original image
-    * @return An unpadded image tensor with a shape (embed_dim, new_height, new_width)
-    */
-    ov::Tensor unpad_image(const ov::Tensor& tensor, const ImageSize& original_size) {
-        size_t original_height = original_size.height;
-        size_t original_width = original_size.width;
-        auto shape = tensor.get_shape();
-        size_t embed_dim = shape[0];
-        size_t current_height = shape[1];
-        size_t current_width = shape[2];
-
-        float original_aspect_ratio = static_cast<float>(original_width) / original_height;
-        float current_aspect_ratio = static_cast<float>(current_width) / current_height;
-
-        ov::Tensor unpadded_tensor;
-
-        if (original_aspect_ratio > current_aspect_ratio) {
-            float scale_factor = static_cast<float>(current_width) / original_width;
-            size_t new_height = static_cast<size_t>(original_height * scale_factor);
-            size_t padding = (current_height - new_height) / 2;
-            size_t unpadded_height_dim = new_height + 1;
-            unpadded_tensor = ov::Tensor(tensor.get_element_type(), {embed_dim, unpadded_height_dim, current_width});
-
-            for (size_t e = 0; e < embed_dim; ++e) {
-                for (int h = 0; h < unpadded_height_dim; ++h) {
-                    std::copy(
-                        tensor.data<float>() + (e * current_height * current_width + (padding + h) * current_width),
-                        tensor.data<float>() + (e * current_height * current_width + (padding + h) * current_width + current_width),
-                        unpadded_tensor.data<float>() + (e * unpadded_height_dim * current_width + h * current_width)
-                    );
-                }
-            }
-        } else {
-            float scale_factor = static_cast<float>(current_height) / original_height;
-            size_t new_width = static_cast<size_t>(original_width * scale_factor);
-            size_t padding = (current_width - new_width) / 2;
-            size_t unpadded_width_dim = new_width + 1;
-            unpadded_tensor = ov::Tensor(tensor.get_element_type(), {embed_dim, current_height, unpadded_width_dim});
-
-            for (size_t e = 0; e < embed_dim; ++e) {
-                for (int h = 0; h < current_height; ++h) {
-                    std::copy(
-                        tensor.data<float>() + (e * current_height * current_width + h * current_width + padding),
-                        tensor.data<float>() + (e * current_height * current_width + h * current_width + padding + unpadded_width_dim),
-                        unpadded_tensor.data<float>() + (e * current_height * unpadded_width_dim + h * unpadded_width_dim)
-                    );
-                }
-            }
-        }
-
-        return unpadded_tensor;
-    }
 };
 
 class InputsEmbedderInternVLChat : public InputsEmbedder::IInputsEmbedder {
@@ -1052,7 +1062,8 @@ public:
         const ov::AnyMap device_config) :
         IInputsEmbedder(vlm_config, models_map, tokenizer, config_dir_path, device, device_config) { }
 
-    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) override {
+    virtual ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                         size_t temporal_pool_size) override {
         std::string image_start_token = m_vlm_config.image_start_token;
         std::string image_context_token = m_vlm_config.image_context_token;
         std::string image_end_token = m_vlm_config.image_end_token;
@@ -1063,9 +1074,8 @@ public:
         std::vector<ov::Tensor> image_embeds;
         image_embeds.reserve(single_images.size());
         
-        for (const auto& image : single_images) {
-            EncodedImage encoded_image = m_vision_encoder.encode(image);
-            ov::Tensor single_image_embeds = encoded_image.resized_source;
+        for (const EncodedImage& encoded_image : pool_temporally(m_vision_encoder.encode(single_images, ov::AnyMap{}, &metrics.vlm_raw_metrics), temporal_pool_size)) {
+            ov::Tensor single_image_embeds = reduce_visual_tokens(encoded_image.resized_source);
 
             const size_t num_patches = single_image_embeds.get_shape().at(0);
             const size_t num_image_tokens = single_image_embeds.get_shape().at(1);
@@ -1092,13 +1102,16 @@ public:
         OPENVINO_ASSERT(metrics.raw_metrics.tokenization_durations.size() > 0);
         metrics.raw_metrics.tokenization_durations[metrics.raw_metrics.tokenization_durations.size() - 1] += ov::genai::MicroSeconds(PerfMetrics::get_microsec(end_tokenizer_time - start_tokenizer_time));
         int64_t image_context_token_id = encoded_image_context_token.data<int64_t>()[encoded_image_context_token.get_size() - 1];
-        return merge_text_and_image_embeddings_internvl(input_ids, text_embeds, image_embeds, image_context_token_id);
+        auto start_merge_time = std::chrono::steady_clock::now();
+        ov::Tensor inputs_embeds = merge_text_and_image_embeddings_internvl(input_ids, text_embeds, image_embeds, image_context_token_id);
+        add_merge_metrics(metrics, start_merge_time, image_embeds);
+        return inputs_embeds;
     }
 
 protected:
     ov::Tensor merge_text_and_image_embeddings_internvl(
         const ov::Tensor& input_ids,
-        const ov::Tensor& text_embeds,
+        ov::Tensor& text_embeds,
         const std::vector<ov::Tensor>& image_embeds,
         int64_t image_context_token_id
     ) {
@@ -1107,53 +1120,46 @@ protected:
         size_t seq_len = text_embeds_shape.at(1);
         size_t embed_dim = text_embeds_shape.at(2);
 
-        ov::Tensor merged_embeds(text_embeds.get_element_type(), text_embeds_shape);
-
-        const float* text_embeds_data = text_embeds.data<float>();
+        // image context tokens are replaced in place, text embeddings are neither allocated nor copied again
         const int64_t* input_ids_data = input_ids.data<int64_t>();
-        float* merged_embeds_data = merged_embeds.data<float>();
+        float* merged_embeds_data = text_embeds.data<float>();
 
         size_t flattened_size = batch_size * seq_len;
-        std::vector<bool> image_context_tokens_mask(flattened_size, false);
-        size_t image_context_tokens_count = 0;
-
-        for (size_t i = 0; i < flattened_size; ++i) {
-            if (input_ids_data[i] == image_context_token_id) {
-                image_context_tokens_mask[i] = true;
-                ++image_context_tokens_count;
-            }
-        }
-
-        OPENVINO_ASSERT(image_context_tokens_count > 0, "input_ids does not contain image context token ids");
-
         size_t image_idx = 0;
         size_t image_context_token_idx = 0;
-        for (size_t i = 0; i < batch_size; ++i) {
-            for (size_t j = 0; j < seq_len; ++j) {
-                size_t flat_idx = i * seq_len + j;
-                size_t offset = flat_idx * embed_dim;
-
-                if (image_context_tokens_mask[flat_idx]) {
-                    const ov::Tensor& single_image_embeds = image_embeds[image_idx];
-                    const size_t num_all_image_tokens = single_image_embeds.get_shape().at(0) * single_image_embeds.get_shape().at(1); // num_patches * num_image_tokens
-                    const float* image_embeds_data = single_image_embeds.data<float>();
-                    std::copy_n(image_embeds_data + image_context_token_idx * embed_dim,
-                                embed_dim,
-                                merged_embeds_data + offset);
-                    
-                    ++image_context_token_idx;
-
-                    if (image_context_token_idx == num_all_image_tokens) {
-                        ++image_idx;
-                        image_context_token_idx = 0;
-                    }
-                } else {
-                    std::copy_n(text_embeds_data + offset, embed_dim, merged_embeds_data + offset);
+        size_t image_context_tokens_count = 0;
+        for (size_t flat_idx = 0; flat_idx < flattened_size;) {
+            if (input_ids_data[flat_idx] != image_context_token_id) {
+                ++flat_idx;
+                continue;
+            }
+            size_t run_end = flat_idx;
+            while (run_end < flattened_size && input_ids_data[run_end] == image_context_token_id) {
+                ++run_end;
+            }
+            image_context_tokens_count += run_end - flat_idx;
+
+            // a run of context tokens may span several images, each chunk within an image is copied at once
+            while (flat_idx < run_end) {
+                OPENVINO_ASSERT(image_idx < image_embeds.size(), "input_ids contain more image context tokens than image embeddings");
+                const ov::Tensor& single_image_embeds = image_embeds[image_idx];
+                const size_t num_all_image_tokens = single_image_embeds.get_shape().at(0) * single_image_embeds.get_shape().at(1); // num_patches * num_image_tokens
+                const size_t chunk = std::min(run_end - flat_idx, num_all_image_tokens - image_context_token_idx);
+                std::copy_n(single_image_embeds.data<const float>() + image_context_token_idx * embed_dim,
+                            chunk * embed_dim,
+                            merged_embeds_data + flat_idx * embed_dim);
+                flat_idx += chunk;
+                image_context_token_idx += chunk;
+                if (image_context_token_idx == num_all_image_tokens) {
+                    ++image_idx;
+                    image_context_token_idx = 0;
                 }
             }
         }
 
-        return merged_embeds;
+        OPENVINO_ASSERT(image_context_tokens_count > 0, "input_ids does not contain image context token ids");
+
+        return text_embeds;
     }
 };
 
@@ -1193,8 +1199,10 @@ InputsEmbedder::InputsEmbedder(const VLMConfig& vlm_config,
     }
 }
 
-ov::Tensor InputsEmbedder::get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics) {
-    return m_impl->get_inputs_embeds(prompt, images, metrics);
+ov::Tensor InputsEmbedder::get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                             size_t temporal_pool_size) {
+    OPENVINO_ASSERT(temporal_pool_size > 0, "temporal_pool_size must be positive");
+    return m_impl->get_inputs_embeds(prompt, images, metrics, temporal_pool_size);
 }
 
 EmbeddingsModel InputsEmbedder::get_embedding_model() const {
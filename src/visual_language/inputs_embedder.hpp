@@ -31,8 +31,10 @@ public:
                    const std::string& device,
                    const ov::AnyMap device_config);
 
-    // compute input embedding for prompt and multiple images
-    ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics);
+    // compute input embedding for prompt and multiple images, tokens of each temporal_pool_size consecutive images
+    // (e.g. video frames) are averaged into tokens of a single image
+    ov::Tensor get_inputs_embeds(const std::string& prompt, const std::vector<ov::Tensor>& images, ov::genai::VLMPerfMetrics& metrics,
+                                 size_t temporal_pool_size = 1);
 
     // returns embedding model which converts token_id(s) to embedding vectors
     EmbeddingsModel get_embedding_model() const;
@@ -67,4 +69,11 @@ private:
     friend class InputsEmbedderInternVLChat;
 };
 
+// returns the device of a VLM submodel set by device_property in properties or the pipeline device
+std::string get_submodel_device(const std::string& device, const ov::AnyMap& properties, const ov::Property<std::string>& device_property);
+
+// returns properties with ones of a VLM submodel set by submodel_property applied over them and without
+// properties selecting devices and properties of submodels
+ov::AnyMap get_submodel_properties(const ov::AnyMap& properties, const ov::Property<ov::AnyMap>& submodel_property);
+
 } // namespace ov::genai
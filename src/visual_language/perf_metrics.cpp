@@ -6,17 +6,69 @@
 namespace ov::genai {
 MeanStdPair calc_mean_and_std(const std::vector<MicroSeconds>& durations);
 
+namespace {
+void append(std::vector<MicroSeconds>& left, const std::vector<MicroSeconds>& right) {
+    left.insert(left.end(), right.begin(), right.end());
+}
+}
+
 MeanStdPair VLMPerfMetrics::get_prepare_embeddings_duration() {
     evaluate_statistics();
     return prepare_embeddings_duration;
 }
 
+MeanStdPair VLMPerfMetrics::get_image_preprocessing_duration() {
+    evaluate_statistics();
+    return image_preprocessing_duration;
+}
+
+MeanStdPair VLMPerfMetrics::get_vision_encoder_infer_duration() {
+    evaluate_statistics();
+    return vision_encoder_infer_duration;
+}
+
+MeanStdPair VLMPerfMetrics::get_vision_encoder_patch_duration() {
+    evaluate_statistics();
+    return vision_encoder_patch_duration;
+}
+
+MeanStdPair VLMPerfMetrics::get_resampling_duration() {
+    evaluate_statistics();
+    return resampling_duration;
+}
+
+MeanStdPair VLMPerfMetrics::get_embeddings_merge_duration() {
+    evaluate_statistics();
+    return embeddings_merge_duration;
+}
+
+size_t VLMPerfMetrics::get_num_image_tokens() const {
+    return vlm_raw_metrics.num_image_tokens;
+}
+
+float VLMPerfMetrics::get_vision_embeddings_cache_hit_rate() {
+    evaluate_statistics();
+    return vision_embeddings_cache_hit_rate;
+}
+
 void VLMPerfMetrics::evaluate_statistics(std::optional<TimePoint> start_time) {
     if (m_evaluated) {
         return;
     }
 
     prepare_embeddings_duration = ov::genai::calc_mean_and_std(vlm_raw_metrics.prepare_embeddings_durations);
+    image_preprocessing_duration = ov::genai::calc_mean_and_std(vlm_raw_metrics.image_preprocessing_durations);
+    vision_encoder_infer_duration = ov::genai::calc_mean_and_std(vlm_raw_metrics.vision_encoder_infer_durations);
+    std::vector<MicroSeconds> patch_durations;
+    patch_durations.reserve(vlm_raw_metrics.vision_encoder_infer_durations.size());
+    for (size_t idx = 0; idx < vlm_raw_metrics.vision_encoder_infer_durations.size(); ++idx) {
+        patch_durations.push_back(vlm_raw_metrics.vision_encoder_infer_durations[idx] / vlm_raw_metrics.vision_encoder_infer_batch_sizes.at(idx));
+    }
+    vision_encoder_patch_duration = ov::genai::calc_mean_and_std(patch_durations);
+    resampling_duration = ov::genai::calc_mean_and_std(vlm_raw_metrics.resampling_durations);
+    embeddings_merge_duration = ov::genai::calc_mean_and_std(vlm_raw_metrics.embeddings_merge_durations);
+    vision_embeddings_cache_hit_rate = vlm_raw_metrics.vision_embeddings_cache_lookups == 0 ? 0.0f
+        : float(vlm_raw_metrics.vision_embeddings_cache_hits) / vlm_raw_metrics.vision_embeddings_cache_lookups;
     PerfMetrics::evaluate_statistics(start_time);
 };
 
@@ -26,11 +78,19 @@ VLMPerfMetrics VLMPerfMetrics::operator+(const VLMPerfMetrics& right) const {
 
     result.vlm_raw_metrics = vlm_raw_metrics;
 
-    auto& result_prepare_embeddings_durations = result.vlm_raw_metrics.prepare_embeddings_durations;
-    auto& right_prepare_embeddings_durations = right.vlm_raw_metrics.prepare_embeddings_durations;
-    result_prepare_embeddings_durations.insert(result_prepare_embeddings_durations.end(),
-                                                right_prepare_embeddings_durations.begin(),
-                                                right_prepare_embeddings_durations.end());
+    VLMRawPerfMetrics& result_raw = result.vlm_raw_metrics;
+    const VLMRawPerfMetrics& right_raw = right.vlm_raw_metrics;
+    append(result_raw.prepare_embeddings_durations, right_raw.prepare_embeddings_durations);
+    append(result_raw.image_preprocessing_durations, right_raw.image_preprocessing_durations);
+    append(result_raw.vision_encoder_infer_durations, right_raw.vision_encoder_infer_durations);
+    result_raw.vision_encoder_infer_batch_sizes.insert(result_raw.vision_encoder_infer_batch_sizes.end(),
+                                                       right_raw.vision_encoder_infer_batch_sizes.begin(),
+                                                       right_raw.vision_encoder_infer_batch_sizes.end());
+    append(result_raw.resampling_durations, right_raw.resampling_durations);
+    append(result_raw.embeddings_merge_durations, right_raw.embeddings_merge_durations);
+    result_raw.num_image_tokens += right_raw.num_image_tokens;
+    result_raw.vision_embeddings_cache_hits += right_raw.vision_embeddings_cache_hits;
+    result_raw.vision_embeddings_cache_lookups += right_raw.vision_embeddings_cache_lookups;
     return result;
 }
-}
\ No newline at end of file
+}
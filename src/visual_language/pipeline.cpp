@@ -12,8 +12,11 @@
 #include "visual_language/inputs_embedder.hpp"
 #include "visual_language/embedding_model.hpp"
 
+#include "continuous_batching_impl.hpp"
 #include "sampler.hpp"
 #include "text_callback_streamer.hpp"
+#include "cancellable_streamer.hpp"
+#include "async_executor.hpp"
 #include "utils.hpp"
 #include "lm_encoding.hpp"
 
@@ -27,6 +30,32 @@ template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
 constexpr size_t BATCH_SIZE = 1;
 
+// Uniformly samples up to max_frames (0 means all) frames of a video of [NHWC] layout, a frame equal to the previous
+// sampled one is skipped, since it adds image tokens without new content. Frames share memory with the video.
+std::vector<ov::Tensor> sample_video_frames(const ov::Tensor& video, size_t max_frames) {
+    const ov::Shape& shape = video.get_shape();
+    OPENVINO_ASSERT(shape.size() == 4 && video.get_element_type() == ov::element::u8, "Video must be u8 of [NHWC] layout");
+    const size_t num_frames = shape[0];
+    const size_t num_sampled = max_frames == 0 ? num_frames : std::min(max_frames, num_frames);
+    const size_t frame_size = shape[1] * shape[2] * shape[3];
+    uint8_t* video_data = video.data<uint8_t>();
+
+    std::vector<ov::Tensor> frames;
+    frames.reserve(num_sampled);
+    const uint8_t* previous_frame = nullptr;
+    for (size_t i = 0; i < num_sampled; ++i) {
+        // centers of num_sampled equal parts of the video
+        size_t frame_idx = (2 * i + 1) * num_frames / (2 * num_sampled);
+        uint8_t* frame_data = video_data + frame_idx * frame_size;
+        if (previous_frame && std::equal(frame_data, frame_data + frame_size, previous_frame)) {
+            continue;
+        }
+        frames.emplace_back(ov::element::u8, ov::Shape{1, shape[1], shape[2], shape[3]}, frame_data);
+        previous_frame = frame_data;
+    }
+    return frames;
+}
+
 } // namespace
 
 namespace ov::genai {
@@ -66,6 +95,11 @@ public:
     size_t m_kv_cache_seq_length_axis = 2;
     // Component for applying sampling to lm outputs
     Sampler m_sampler;
+    // True if chat mode is activated to keep KV cache and conversation history between generate() calls
+    bool m_is_chat_conversation = false;
+    // Continuous batching pipeline running the language model with paged attention instead of m_language,
+    // set if properties contain ov::genai::scheduler_config
+    std::shared_ptr<ContinuousBatchingPipeline::ContinuousBatchingImpl> m_cb;
 
     VLMPipelineImpl(
         const std::filesystem::path& models_dir,
@@ -82,14 +116,27 @@ public:
                 models_dir, "generation_config.json"
             )
         } {
+        auto [plugin_config, scheduler_config] = split_scheduler_config(properties);
         m_inputs_embedder = std::make_shared<InputsEmbedder>(
-            m_vlm_config, models_dir, device, properties);
+            m_vlm_config, models_dir, device, plugin_config);
 
         m_tokenizer = m_inputs_embedder->get_tokenizer();
         m_embedding = m_inputs_embedder->get_embedding_model();
 
+        std::string language_device = get_submodel_device(device, plugin_config, ov::genai::language_model_device);
+        ov::AnyMap language_properties = get_submodel_properties(plugin_config, ov::genai::language_model_properties);
+        language_properties.erase(ov::genai::embedded_image_preprocessing.name());
+        language_properties.erase(ov::genai::vision_encoder_max_batch_size.name());
+        language_properties.erase(ov::genai::vision_embeddings_cache_size.name());
+        language_properties.erase(ov::genai::visual_tokens_keep_ratio.name());
+        if (scheduler_config.has_value()) {
+            init_continuous_batching(
+                utils::singleton_core().read_model(models_dir / "openvino_language_model.xml"),
+                *scheduler_config, language_device, language_properties);
+            return;
+        }
         auto compiled_language_model = utils::singleton_core().compile_model(
-            models_dir / "openvino_language_model.xml", device, properties
+            models_dir / "openvino_language_model.xml", language_device, language_properties
         );
         ov::genai::utils::print_compiled_model_properties(compiled_language_model, "VLM language model");
         auto language_model = compiled_language_model.get_runtime_model();
@@ -123,15 +170,28 @@ public:
         },
         m_generation_config{generation_config} {
         
+        auto [plugin_config, scheduler_config] = split_scheduler_config(properties);
         m_inputs_embedder = std::make_shared<InputsEmbedder>(
-            m_vlm_config, models_map, tokenizer, config_dir_path, device, properties);
+            m_vlm_config, models_map, tokenizer, config_dir_path, device, plugin_config);
 
         m_tokenizer = m_inputs_embedder->get_tokenizer();
         m_embedding = m_inputs_embedder->get_embedding_model();
 
         auto m_language_pair = get_model_weights_pair(models_map, "language");
+        std::string language_device = get_submodel_device(device, plugin_config, ov::genai::language_model_device);
+        ov::AnyMap language_properties = get_submodel_properties(plugin_config, ov::genai::language_model_properties);
+        language_properties.erase(ov::genai::embedded_image_preprocessing.name());
+        language_properties.erase(ov::genai::vision_encoder_max_batch_size.name());
+        language_properties.erase(ov::genai::vision_embeddings_cache_size.name());
+        language_properties.erase(ov::genai::visual_tokens_keep_ratio.name());
+        if (scheduler_config.has_value()) {
+            init_continuous_batching(
+                utils::singleton_core().read_model(m_language_pair.first, m_language_pair.second),
+                *scheduler_config, language_device, language_properties);
+            return;
+        }
         m_language = utils::singleton_core().compile_model(
-            m_language_pair.first, m_language_pair.second, device, properties
+            m_language_pair.first, m_language_pair.second, language_device, language_properties
         ).create_infer_request();
 
         m_language.get_tensor("attention_mask").set_shape({1, 0});
@@ -145,20 +205,129 @@ public:
         m_sampler.set_seed(m_generation_config.rng_seed);
     }
 
+    static std::pair<ov::AnyMap, std::optional<SchedulerConfig>> split_scheduler_config(const ov::AnyMap& properties) {
+        if (properties.find(ov::genai::scheduler_config.name()) == properties.end()) {
+            return {properties, std::nullopt};
+        }
+        auto [plugin_config, scheduler_config] = utils::split_scheduler_config(properties);
+        return {plugin_config, scheduler_config};
+    }
+
+    void init_continuous_batching(
+        const std::shared_ptr<ov::Model>& language_model,
+        const SchedulerConfig& scheduler_config,
+        const std::string& device,
+        const ov::AnyMap& language_properties
+    ) {
+        // If eos_token_id was not provided, take value
+        if (m_generation_config.eos_token_id == -1) {
+            m_generation_config.set_eos_token_id(m_tokenizer.get_eos_token_id());
+        }
+
+        // the language model takes inputs_embeds, tokens generated by requests are embedded by m_embedding
+        m_cb = std::make_shared<ContinuousBatchingPipeline::ContinuousBatchingImpl>(
+            language_model, m_tokenizer, scheduler_config, device, language_properties, m_generation_config);
+        m_cb->set_embedding_model(m_embedding);
+    }
+
+    // embeddings of requests are computed one by one, then requests are generated together by m_cb
+    std::vector<VLMDecodedResults> generate_continuous_batching(
+        const std::vector<std::string>& prompts,
+        const std::vector<std::vector<ov::Tensor>>& images,
+        const std::vector<GenerationConfig>& generation_configs,
+        const StreamerVariant& streamer,
+        size_t temporal_pool_size = 1
+    ) {
+        std::vector<ov::Tensor> input_ids, inputs_embeds;
+        std::vector<VLMPerfMetrics> perf_metrics(prompts.size());
+        input_ids.reserve(prompts.size());
+        inputs_embeds.reserve(prompts.size());
+        for (size_t request_id = 0; request_id < prompts.size(); ++request_id) {
+            auto start_prepare_embeddings_time = std::chrono::steady_clock::now();
+            ov::Tensor embeds = m_inputs_embedder->get_inputs_embeds(prompts[request_id], images[request_id], perf_metrics[request_id], temporal_pool_size);
+            perf_metrics[request_id].vlm_raw_metrics.prepare_embeddings_durations.emplace_back(
+                PerfMetrics::get_microsec(std::chrono::steady_clock::now() - start_prepare_embeddings_time));
+            perf_metrics[request_id].num_input_tokens = embeds.get_shape().at(1);
+            OPENVINO_ASSERT(embeds.get_element_type() == ov::element::f32,
+                "Continuous batching VLMPipeline requires f32 inputs embeddings");
+            // embeddings may be stored in an output tensor of the embeddings model, which is overwritten by the next prompt
+            ov::Tensor embeds_copy(embeds.get_element_type(), embeds.get_shape());
+            embeds.copy_to(embeds_copy);
+            inputs_embeds.push_back(embeds_copy);
+
+            // image positions keep pad_token_id, prefix caching matches positions by hashes of their embeddings
+            auto tokenized_history = m_inputs_embedder->get_tokenized_history();
+            ov::Tensor prompt_ids(ov::element::i64, {1, embeds.get_shape().at(1)});
+            std::fill_n(prompt_ids.data<int64_t>(), prompt_ids.get_size(), m_tokenizer.get_pad_token_id());
+            std::copy_n(tokenized_history.begin(), std::min(tokenized_history.size(), prompt_ids.get_size()), prompt_ids.data<int64_t>());
+            input_ids.push_back(prompt_ids);
+        }
+
+        std::vector<GenerationConfig> configs = generation_configs;
+        for (auto& config : configs) {
+            if (config.eos_token_id == -1)
+                config.set_eos_token_id(m_generation_config.eos_token_id);
+        }
+
+        std::vector<EncodedGenerationResult> encoded_results = m_cb->generate(input_ids, inputs_embeds, configs, streamer);
+
+        std::vector<VLMDecodedResults> results;
+        results.reserve(encoded_results.size());
+        for (size_t request_id = 0; request_id < encoded_results.size(); ++request_id) {
+            const EncodedGenerationResult& encoded_result = encoded_results[request_id];
+            VLMDecodedResults decoded;
+            decoded.perf_metrics = std::move(perf_metrics.at(request_id));
+            decoded.perf_metrics.load_time = m_load_time_ms;
+            for (size_t idx = 0; idx < encoded_result.m_generation_ids.size(); ++idx) {
+                decoded.texts.push_back(m_tokenizer.decode(encoded_result.m_generation_ids.at(idx)));
+                decoded.scores.push_back(encoded_result.m_scores.at(idx));
+            }
+            results.push_back(std::move(decoded));
+        }
+        return results;
+    }
+
+    std::vector<VLMDecodedResults> generate(
+        const std::vector<std::string>& prompts,
+        const std::vector<std::vector<ov::Tensor>>& images,
+        const std::vector<GenerationConfig>& generation_configs
+    ) {
+        OPENVINO_ASSERT(prompts.size() == images.size() && prompts.size() == generation_configs.size(),
+            "Numbers of prompts, image lists and generation configs must be equal");
+        if (m_cb) {
+            return generate_continuous_batching(prompts, images, generation_configs, std::monostate());
+        }
+        // stateful language model processes requests one by one
+        std::vector<VLMDecodedResults> results;
+        results.reserve(prompts.size());
+        for (size_t request_id = 0; request_id < prompts.size(); ++request_id) {
+            results.push_back(generate(prompts[request_id], images[request_id], generation_configs[request_id], std::monostate()));
+        }
+        return results;
+    }
+
     VLMDecodedResults generate(
         const std::string& prompt,
         const std::vector<ov::Tensor>& rgbs,
         GenerationConfig generation_config,
-        const StreamerVariant& streamer
+        const StreamerVariant& streamer,
+        size_t temporal_pool_size = 1
     ) {
+        if (m_cb) {
+            return generate_continuous_batching({prompt}, {rgbs}, {generation_config}, streamer, temporal_pool_size).at(0);
+        }
+
         // 验证和设置generation_config
         if (generation_config.eos_token_id == -1)
             generation_config.set_eos_token_id(m_generation_config.eos_token_id);
         generation_config.validate();
 
+        auto start_time = std::chrono::steady_clock::now();
         // 获取输入嵌入
-        ov::genai::VLMPerfMetrics tmpMetrics;
-        ov::Tensor inputs_embeds = m_inputs_embedder->get_inputs_embeds(prompt, rgbs, tmpMetrics);
+        VLMPerfMetrics perf_metrics;
+        ov::Tensor inputs_embeds = m_inputs_embedder->get_inputs_embeds(prompt, rgbs, perf_metrics, temporal_pool_size);
+        auto end_prepare_embeddings_time = std::chrono::steady_clock::now();
+        perf_metrics.vlm_raw_metrics.prepare_embeddings_durations.emplace_back(PerfMetrics::get_microsec(end_prepare_embeddings_time - start_time));
 
         // 处理KV缓存
         auto to_remove_from_hist = m_inputs_embedder->get_num_tokens_to_remove_from_hist();
@@ -207,10 +376,19 @@ public:
 
         // 解码结果
         VLMDecodedResults decoded;
+        auto decode_start_time = std::chrono::steady_clock::now();
         for (size_t idx = 0; idx < encoded_result.tokens.size(); ++idx) {
             decoded.texts.push_back(m_tokenizer.decode(encoded_result.tokens.at(idx)));
             decoded.scores.push_back(encoded_result.scores.at(idx));
         }
+        auto decode_stop_time = std::chrono::steady_clock::now();
+
+        decoded.perf_metrics = std::move(perf_metrics);
+        auto& raw_counters = decoded.perf_metrics.raw_metrics;
+        raw_counters.generate_durations.emplace_back(PerfMetrics::get_microsec(decode_stop_time - start_time));
+        raw_counters.detokenization_durations.emplace_back(PerfMetrics::get_microsec(decode_stop_time - decode_start_time));
+        decoded.perf_metrics.num_input_tokens = inputs_embeds_size;
+        decoded.perf_metrics.load_time = m_load_time_ms;
 
         // 更新历史记录
         m_inputs_embedder->update_tokenized_history(
@@ -219,9 +397,14 @@ public:
             generation_config.is_beam_search(),
             m_language.get_tensor("attention_mask").get_shape()[1] - (history_size + inputs_embeds_size));
 
-        // 重置状态
-        m_language.reset_state();
-        m_language.get_tensor("attention_mask").set_shape({1, 0});
+        if (m_is_chat_conversation) {
+            // KV cache is kept for the next turn, which appends only its new tokens to it
+            m_inputs_embedder->update_chat_history(decoded.texts.at(0));
+        } else {
+            // 重置状态
+            m_language.reset_state();
+            m_language.get_tensor("attention_mask").set_shape({1, 0});
+        }
 
         return decoded;
     }
@@ -232,9 +415,10 @@ public:
     ) {
         auto image = config_map.find(ov::genai::image.name());
         auto images = config_map.find(ov::genai::images.name());
+        auto video = config_map.find(ov::genai::video.name());
         OPENVINO_ASSERT(
-            config_map.end() == image || config_map.end() == images,
-            "Only one property can be set: image of images."
+            (config_map.end() != image) + (config_map.end() != images) + (config_map.end() != video) <= 1,
+            "Only one property can be set: image, images or video."
         );
         std::vector<ov::Tensor> rgbs;
         if (config_map.end() != image) {
@@ -242,6 +426,16 @@ public:
         } if (config_map.end() != images) {
             rgbs = images->second.as<std::vector<ov::Tensor>>();
         }
+        size_t temporal_pool_size = 1;
+        if (config_map.end() != video) {
+            auto max_frames = config_map.find(ov::genai::video_max_frames.name());
+            rgbs = sample_video_frames(video->second.as<ov::Tensor>(),
+                                       config_map.end() != max_frames ? max_frames->second.as<size_t>() : 0);
+            auto temporal_pool = config_map.find(ov::genai::video_temporal_pool.name());
+            if (config_map.end() != temporal_pool) {
+                temporal_pool_size = temporal_pool->second.as<size_t>();
+            }
+        }
         ov::genai::OptionalGenerationConfig config_arg = utils::get_config_from_map(config_map);
         GenerationConfig config = (config_arg.has_value()) ? *config_arg : get_generation_config();
         config.update_generation_config(config_map);
@@ -250,38 +444,41 @@ public:
             prompt,
             rgbs,
             config,
-            utils::get_streamer_from_map(config_map)
+            utils::get_streamer_from_map(config_map),
+            temporal_pool_size
         );
     }
 
-    // void start_chat(const std::string& system_message) {
-    //     m_is_chat_conversation = true;
-    //     bool have_state = 0 != m_language.get_tensor("attention_mask").get_size();
-    //     if (have_state) {
-    //         // Resetting state may be slow.
-    //         m_language.reset_state();
-    //         // Since if is already introduced, move all resetting here.
-    //         m_language.get_tensor("attention_mask").set_shape({1, 0});
-    //     }
-    //     m_inputs_embedder->start_chat(system_message);
-    // }
-
-    // void finish_chat() {
-    //     m_is_chat_conversation = false;
-    //     // Resetting state may be slow.
-    //     m_language.reset_state();
-    //     // clear all chat history
-    //     m_inputs_embedder->finish_chat();
-    // }
+    void start_chat(const std::string& system_message) {
+        OPENVINO_ASSERT(!m_cb, "Chat is not supported by VLMPipeline with continuous batching");
+        m_is_chat_conversation = true;
+        bool have_state = 0 != m_language.get_tensor("attention_mask").get_size();
+        if (have_state) {
+            // Resetting state may be slow.
+            m_language.reset_state();
+            // Since if is already introduced, move all resetting here.
+            m_language.get_tensor("attention_mask").set_shape({1, 0});
+        }
+        m_inputs_embedder->start_chat(system_message);
+    }
+
+    void finish_chat() {
+        m_is_chat_conversation = false;
+        // Resetting state may be slow.
+        m_language.reset_state();
+        m_language.get_tensor("attention_mask").set_shape({1, 0});
+        // clear all chat history
+        m_inputs_embedder->finish_chat();
+    }
 
     Tokenizer get_tokenizer() const {
         return m_tokenizer;
     }
 
-    // void set_chat_template(const std::string& new_template) {
-    //     OPENVINO_ASSERT(!m_is_chat_conversation, "Chat template cannot be changed once start_chat() is called. Please, finish current chat via finish_chat()");
-    //     m_tokenizer.set_chat_template(new_template);
-    // }
+    void set_chat_template(const std::string& new_template) {
+        OPENVINO_ASSERT(!m_is_chat_conversation, "Chat template cannot be changed once start_chat() is called. Please, finish current chat via finish_chat()");
+        m_tokenizer.set_chat_template(new_template);
+    }
 
     GenerationConfig get_generation_config() const {
         return m_generation_config;
@@ -290,6 +487,33 @@ public:
     void set_generation_config(const GenerationConfig& new_config) {
         m_generation_config = new_config;
     }
+
+    GenerationFuture<VLMDecodedResults> generate_async(
+        const std::string& prompt,
+        const std::vector<ov::Tensor>& rgbs,
+        const GenerationConfig& generation_config,
+        const StreamerVariant& streamer,
+        std::function<void(GenerationFuture<VLMDecodedResults>)> on_completion
+    ) {
+        OPENVINO_ASSERT(!m_is_chat_conversation, "generate_async() cannot be called during a chat");
+        {
+            std::lock_guard<std::mutex> lock(m_async_mutex);
+            if (!m_async_executor)
+                m_async_executor = std::make_unique<AsyncExecutor>(1);
+        }
+        const bool is_streaming_supported = generation_config.num_return_sequences == 1 &&
+            (generation_config.is_greedy_decoding() || generation_config.is_multinomial());
+        return m_async_executor->submit_generation<VLMDecodedResults>(
+            [this, prompt, rgbs, generation_config, streamer, is_streaming_supported](const std::shared_ptr<std::atomic<bool>>& is_cancelled) {
+                return generate(prompt, rgbs, generation_config, make_cancellable_streamer(streamer, is_cancelled, is_streaming_supported));
+            },
+            std::move(on_completion));
+    }
+
+private:
+    std::mutex m_async_mutex;
+    // runs generate_async() calls one by one, declared last to be stopped before the members used by generate() are destroyed
+    std::unique_ptr<AsyncExecutor> m_async_executor;
 };
 
 VLMPipeline::VLMPipeline(
@@ -344,17 +568,35 @@ VLMDecodedResults VLMPipeline::generate(
     return m_pimpl->generate(prompt, config_map);
 }
 
-// void VLMPipeline::start_chat(const std::string& system_message) {
-//     m_pimpl->start_chat(system_message);
-// }
+GenerationFuture<VLMDecodedResults> VLMPipeline::generate_async(
+    const std::string& prompt,
+    const std::vector<ov::Tensor>& rgbs,
+    const GenerationConfig& generation_config,
+    const StreamerVariant& streamer,
+    std::function<void(GenerationFuture<VLMDecodedResults>)> on_completion
+) {
+    return m_pimpl->generate_async(prompt, rgbs, generation_config, streamer, std::move(on_completion));
+}
+
+std::vector<VLMDecodedResults> VLMPipeline::generate(
+    const std::vector<std::string>& prompts,
+    const std::vector<std::vector<ov::Tensor>>& images,
+    const std::vector<GenerationConfig>& generation_configs
+) {
+    return m_pimpl->generate(prompts, images, generation_configs);
+}
+
+void VLMPipeline::start_chat(const std::string& system_message) {
+    m_pimpl->start_chat(system_message);
+}
 
-// void VLMPipeline::finish_chat() {
-//     m_pimpl->finish_chat();
-// }
+void VLMPipeline::finish_chat() {
+    m_pimpl->finish_chat();
+}
 
-// void VLMPipeline::set_chat_template(const std::string& new_template) {
-//     m_pimpl->set_chat_template(new_template);
-// }
+void VLMPipeline::set_chat_template(const std::string& new_template) {
+    m_pimpl->set_chat_template(new_template);
+}
 
 Tokenizer VLMPipeline::get_tokenizer() const {
     return m_pimpl->get_tokenizer();
@@ -5,6 +5,23 @@
 #include "visual_language/clip.hpp"
 #include "utils.hpp"
 
+#include <string_view>
+
+#include "openvino/genai/visual_language/pipeline.hpp"
+#include "openvino/op/add.hpp"
+#include "openvino/op/clamp.hpp"
+#include "openvino/op/constant.hpp"
+#include "openvino/op/convert.hpp"
+#include "openvino/op/divide.hpp"
+#include "openvino/op/floor.hpp"
+#include "openvino/op/gather.hpp"
+#include "openvino/op/interpolate.hpp"
+#include "openvino/op/multiply.hpp"
+#include "openvino/op/reduce_min.hpp"
+#include "openvino/op/shape_of.hpp"
+#include "openvino/op/slice.hpp"
+#include "openvino/op/subtract.hpp"
+
 using namespace ov::genai;
 
 namespace {
@@ -304,7 +321,8 @@ ov::Tensor prepare_vis_position_ids(
     return position_ids;
 }
 
-EncodedImage llava_image_embed_make_with_bytes_slice(clip_ctx& ctx_clip, const ov::Tensor& img, ov::InferRequest& encoder, int max_slice_nums, int scale_resolution, size_t patch_size, bool never_split) {
+EncodedImage llava_image_embed_make_with_bytes_slice(clip_ctx& ctx_clip, const ov::Tensor& img, ov::InferRequest& encoder, int max_slice_nums, int scale_resolution, size_t patch_size, bool never_split, ov::genai::VLMRawPerfMetrics* raw_metrics) {
+    auto start_preprocessing_time = std::chrono::steady_clock::now();
     clip_image_u8 source = tensor_to_clip_image_u8(img);
     std::vector<std::vector<clip_image_u8>> imgs = ::slice_image(source, max_slice_nums, scale_resolution, patch_size, never_split);
     std::vector<std::vector<ov::Tensor>> results;
@@ -402,7 +420,14 @@ EncodedImage llava_image_embed_make_with_bytes_slice(clip_ctx& ctx_clip, const o
     }
     ov::Tensor position_ids = prepare_vis_position_ids(pixel_values, patch_attention_mask, tgt_sizes, patch_size, ctx_clip.image_size / patch_size);
     encoder.set_tensor("position_ids", position_ids);
+    auto start_infer_time = std::chrono::steady_clock::now();
     encoder.infer();
+    if (raw_metrics) {
+        auto end_infer_time = std::chrono::steady_clock::now();
+        raw_metrics->image_preprocessing_durations.emplace_back(ov::genai::PerfMetrics::get_microsec(start_infer_time - start_preprocessing_time));
+        raw_metrics->vision_encoder_infer_durations.emplace_back(ov::genai::PerfMetrics::get_microsec(end_infer_time - start_infer_time));
+        raw_metrics->vision_encoder_infer_batch_sizes.push_back(n_images);
+    }
     const ov::Tensor& output_tensor = encoder.get_output_tensor();
 
     if (1 == preprocessed.size()) {
@@ -529,12 +554,15 @@ ov::Tensor get_pixel_values_llava_next(const ov::Tensor& image, const ProcessorC
     return concatenated_tensor;
 }
 
-std::vector<clip_image_u8> split_image_internvl(
+/**
+ * @brief Selects the grid of InternVL tiles, whose aspect ratio is the closest to the one of the image.
+ * @return (number of tiles along width, number of tiles along height)
+ */
+std::pair<int, int> get_tile_grid_internvl(
     const clip_image_u8& image,
     int image_size,
     int min_num = 1,
-    int max_num = 12,
-    bool use_thumbnail = true
+    int max_num = 12
 ) {
     int orig_width = image.nx;
     int orig_height = image.ny;
@@ -553,25 +581,29 @@ std::vector<clip_image_u8> split_image_internvl(
     std::sort(target_ratios.begin(), target_ratios.end(),
         [](const auto& a, const auto& b) { return a.first * a.second < b.first * b.second; });
 
-    auto find_closest_aspect_ratio = [&](float ar, const std::vector<std::pair<int, int>>& ratios) {
-        float best_ratio_diff = std::numeric_limits<float>::max();
-        std::pair<int, int> best_ratio = {1, 1};
-        int area = orig_width * orig_height;
-
-        for (const auto& ratio : ratios) {
-            float target_ar = static_cast<float>(ratio.first) / ratio.second;
-            float ratio_diff = std::abs(ar - target_ar);
-            if (ratio_diff < best_ratio_diff) {
-                best_ratio_diff = ratio_diff;
-                best_ratio = ratio;
-            } else if (ratio_diff == best_ratio_diff && area > 0.5 * image_size * image_size * ratio.first * ratio.second) {
-                best_ratio = ratio;
-            }
+    float best_ratio_diff = std::numeric_limits<float>::max();
+    std::pair<int, int> best_ratio = {1, 1};
+    int area = orig_width * orig_height;
+
+    for (const auto& ratio : target_ratios) {
+        float target_ar = static_cast<float>(ratio.first) / ratio.second;
+        float ratio_diff = std::abs(aspect_ratio - target_ar);
+        if (ratio_diff < best_ratio_diff) {
+            best_ratio_diff = ratio_diff;
+            best_ratio = ratio;
+        } else if (ratio_diff == best_ratio_diff && area > 0.5 * image_size * image_size * ratio.first * ratio.second) {
+            best_ratio = ratio;
         }
-        return best_ratio;
-    };
+    }
+    return best_ratio;
+}
 
-    auto target_aspect_ratio = find_closest_aspect_ratio(aspect_ratio, target_ratios);
+std::vector<clip_image_u8> split_image_internvl(
+    const clip_image_u8& image,
+    int image_size,
+    bool use_thumbnail = true
+) {
+    auto target_aspect_ratio = get_tile_grid_internvl(image, image_size);
 
     int target_width = image_size * target_aspect_ratio.first;
     int target_height = image_size * target_aspect_ratio.second;
@@ -590,14 +622,11 @@ std::vector<clip_image_u8> split_image_internvl(
         split_img.ny = image_size;
         split_img.buf.resize(3 * image_size * image_size);
 
+        // rows of a tile are contiguous in the resized image
         for (int dy = 0; dy < image_size; ++dy) {
-            for (int dx = 0; dx < image_size; ++dx) {
-                for (int c = 0; c < 3; ++c) {
-                    int src_idx = ((y + dy) * target_width + (x + dx)) * 3 + c;
-                    int dst_idx = (dy * image_size + dx) * 3 + c;
-                    split_img.buf[dst_idx] = resized_img.buf[src_idx];
-                }
-            }
+            std::copy_n(resized_img.buf.data() + ((y + dy) * target_width + x) * 3,
+                        image_size * 3,
+                        split_img.buf.data() + dy * image_size * 3);
         }
 
         processed_images.push_back(std::move(split_img));
@@ -612,48 +641,168 @@ std::vector<clip_image_u8> split_image_internvl(
     return processed_images;
 }
 
+/**
+ * @brief Preprocesses InternVL tiles and the thumbnail straight into a [num_tiles, 3, image_size, image_size] tensor.
+ * All tiles are normalized from a single resized image, rows of each tile are processed in parallel.
+ */
 ov::Tensor get_pixel_values_internvl(const ov::Tensor& image, const ProcessorConfig& config) {
     clip_image_u8 input_image = tensor_to_clip_image_u8(image);
 
-    const size_t image_size = config.size_shortest_edge;
+    const int image_size = static_cast<int>(config.size_shortest_edge);
 
     clip_ctx ctx;
     ctx.image_size = image_size;
     std::copy(config.image_mean.begin(), config.image_mean.end(), ctx.image_mean);
     std::copy(config.image_std.begin(), config.image_std.end(), ctx.image_std);
 
-    std::vector<clip_image_u8> splitted_images = split_image_internvl(input_image, image_size);
+    auto target_aspect_ratio = get_tile_grid_internvl(input_image, image_size);
+    const int blocks = target_aspect_ratio.first * target_aspect_ratio.second;
+    const size_t num_tiles = blocks == 1 ? 1 : blocks + 1;  // with thumbnail
+    const size_t tile_size = 3 * static_cast<size_t>(image_size) * image_size;
+
+    ov::Tensor output_tensor(ov::element::f32, {num_tiles, 3, static_cast<size_t>(image_size), static_cast<size_t>(image_size)});
+    float* output_data = output_tensor.data<float>();
 
-    std::vector<clip_image_f32> processed_images;
-    processed_images.reserve(splitted_images.size());
-    for (const auto& image : splitted_images) {
-        processed_images.push_back(clip_image_preprocess(ctx, image));
+    clip_image_u8 resized_img;
+    bicubic_resize(input_image, resized_img, image_size * target_aspect_ratio.first, image_size * target_aspect_ratio.second);
+    for (int i = 0; i < blocks; ++i) {
+        int x = (i % target_aspect_ratio.first) * image_size;
+        int y = (i / target_aspect_ratio.first) * image_size;
+        clip_image_preprocess_region(ctx, resized_img, x, y, image_size, image_size, output_data + i * tile_size);
     }
 
-    size_t batch_size = processed_images.size();
-    size_t channels = 3;
-    size_t height = processed_images[0].ny;
-    size_t width = processed_images[0].nx;
+    if (num_tiles != 1) {
+        clip_image_u8 thumbnail_img;
+        bicubic_resize(input_image, thumbnail_img, image_size, image_size);
+        clip_image_preprocess_region(ctx, thumbnail_img, 0, 0, image_size, image_size, output_data + blocks * tile_size);
+    }
+    return output_tensor;
+}
 
-    ov::Tensor output_tensor(ov::element::f32, {batch_size, channels, height, width});
-    float* output_data = output_tensor.data<float>();
+template <typename T>
+void hash_combine(size_t& seed, const T& value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
 
-    for (size_t i = 0; i < batch_size; ++i) {
-        const auto& img = processed_images[i];
-        std::copy(img.buf.begin(), img.buf.end(), output_data + i * channels * height * width);
+/**
+ * @brief Hashes image content and shape together with ProcessorConfig values, which affect its embeddings.
+ */
+size_t get_image_hash(const ov::Tensor& image, const ProcessorConfig& config) {
+    size_t hash = std::hash<std::string_view>{}(
+        std::string_view(static_cast<const char*>(image.data()), image.get_byte_size()));
+    for (size_t dim : image.get_shape()) {
+        hash_combine(hash, dim);
     }
-    return output_tensor;
+    for (size_t value : {config.image_size, config.patch_size, config.scale_resolution, config.max_slice_nums,
+                         config.crop_size_height, config.crop_size_width, config.size_shortest_edge}) {
+        hash_combine(hash, value);
+    }
+    for (const std::array<float, 3>* values : {&config.norm_mean, &config.norm_std, &config.image_mean, &config.image_std}) {
+        for (float value : *values) {
+            hash_combine(hash, value);
+        }
+    }
+    for (const auto& [height, width] : config.image_grid_pinpoints) {
+        hash_combine(hash, height);
+        hash_combine(hash, width);
+    }
+    return hash;
+}
+
+/**
+ * @brief Stacks u8 images of the same size to an OpenVINO tensor (NHWC).
+ */
+ov::Tensor clip_images_u8_to_tensor(const std::vector<clip_image_u8>& images) {
+    const size_t height = images.at(0).ny;
+    const size_t width = images.at(0).nx;
+    ov::Tensor images_tensor(ov::element::u8, {images.size(), height, width, 3});
+    uint8_t* images_data = images_tensor.data<uint8_t>();
+    for (const auto& image : images) {
+        OPENVINO_ASSERT(size_t(image.ny) == height && size_t(image.nx) == width,
+                        "Embedded image preprocessing requires image patches of the same size");
+        images_data = std::copy(image.buf.begin(), image.buf.end(), images_data);
+    }
+    return images_tensor;
+}
+
+/**
+ * @brief Embeds preprocessing of u8 NHWC images into the vision encoder: bicubic resize of the shortest edge to
+ * size_shortest_edge, center crop, normalization by image_mean and image_std and conversion to NCHW.
+ * InternVL2 images are already split to size_shortest_edge squares, so they are not cropped.
+ * Resize follows Pillow bicubic, resized values are clamped, but not rounded to u8 as by the CPU preprocessing.
+ */
+void merge_image_preprocessing(std::shared_ptr<ov::Model> model, const ProcessorConfig& config, VLMModelType model_type) {
+    using namespace ov::op;
+
+    const int64_t shortest_edge = config.size_shortest_edge;
+    const bool do_center_crop = model_type != VLMModelType::INTERNVL_CHAT;
+    const int64_t crop_height = do_center_crop ? config.crop_size_height : shortest_edge;
+    const int64_t crop_width = do_center_crop ? config.crop_size_width : shortest_edge;
+
+    ov::preprocess::PrePostProcessor ppp(model);
+
+    ppp.input("pixel_values").tensor()
+        .set_element_type(ov::element::u8)
+        .set_layout("NHWC")
+        .set_spatial_dynamic_shape();
+    ppp.input("pixel_values").model()
+        .set_layout("NCHW");
+
+    std::vector<float> mean(3), scale(3);
+    for (size_t c = 0; c < 3; ++c) {
+        mean[c] = config.image_mean[c] * 255.0f;
+        scale[c] = config.image_std[c] * 255.0f;
+    }
+
+    ppp.input("pixel_values").preprocess()
+        .convert_element_type(ov::element::f32)
+        .custom([=](const ov::Output<ov::Node>& port) {
+            // size of the shortest edge is scaled to shortest_edge, the other one is truncated
+            auto spatial_axes = v0::Constant::create(ov::element::i64, ov::Shape{2}, {1, 2});
+            auto spatial_shape = std::make_shared<v8::Gather>(
+                std::make_shared<v3::ShapeOf>(port, ov::element::i64),
+                spatial_axes,
+                v0::Constant::create(ov::element::i64, ov::Shape{}, {0}));
+            auto spatial_shape_f32 = std::make_shared<v0::Convert>(spatial_shape, ov::element::f32);
+            auto resize_scale = std::make_shared<v1::Divide>(
+                v0::Constant::create(ov::element::f32, ov::Shape{1}, {float(shortest_edge)}),
+                std::make_shared<v1::ReduceMin>(spatial_shape_f32,
+                                                v0::Constant::create(ov::element::i64, ov::Shape{1}, {0}),
+                                                true));
+            auto resized_shape = std::make_shared<v0::Convert>(
+                std::make_shared<v0::Floor>(std::make_shared<v1::Multiply>(spatial_shape_f32, resize_scale)),
+                ov::element::i64);
+
+            v11::Interpolate::InterpolateAttrs attrs(v11::Interpolate::InterpolateMode::BICUBIC_PILLOW,
+                                                     v11::Interpolate::ShapeCalcMode::SIZES,
+                                                     {0, 0, 0, 0},
+                                                     {0, 0, 0, 0});
+            auto resized = std::make_shared<v0::Clamp>(
+                std::make_shared<v11::Interpolate>(port, resized_shape, spatial_axes, attrs), 0.0, 255.0);
+
+            auto crop_size = v0::Constant::create(ov::element::i64, ov::Shape{2}, {crop_height, crop_width});
+            auto crop_begin = std::make_shared<v1::Divide>(
+                std::make_shared<v1::Subtract>(resized_shape, crop_size),
+                v0::Constant::create(ov::element::i64, ov::Shape{1}, {2}));
+            auto crop_end = std::make_shared<v1::Add>(crop_begin, crop_size);
+            return std::make_shared<v8::Slice>(resized,
+                                               crop_begin,
+                                               crop_end,
+                                               v0::Constant::create(ov::element::i64, ov::Shape{2}, {1, 1}),
+                                               spatial_axes);
+        })
+        .mean(mean)
+        .scale(scale)
+        .convert_layout();
+
+    ppp.build();
 }
 }
 
 VisionEncoder::VisionEncoder(const std::filesystem::path& model_dir, const VLMModelType model_type, const std::string& device, const ov::AnyMap device_config) :
     model_type(model_type) {
-    auto compiled_model = utils::singleton_core().compile_model(model_dir / "openvino_vision_embeddings_model.xml",
-                                                                device,
-                                                                device_config);
-    ov::genai::utils::print_compiled_model_properties(compiled_model, "VLM vision embeddings model");
-    m_vision_encoder = compiled_model.create_infer_request();
     m_processor_config = utils::from_config_json_if_exists<ProcessorConfig>(model_dir, "preprocessor_config.json");
+    compile(utils::singleton_core().read_model(model_dir / "openvino_vision_embeddings_model.xml"), device, device_config);
 }
 
 VisionEncoder::VisionEncoder(
@@ -665,24 +814,39 @@ VisionEncoder::VisionEncoder(
     const ov::AnyMap device_config
 ) :
     model_type(model_type) {
-        m_vision_encoder = utils::singleton_core().compile_model(model, weights, device, device_config).create_infer_request();
         m_processor_config = utils::from_config_json_if_exists<ProcessorConfig>(
             config_dir_path, "preprocessor_config.json"
         );
+        compile(utils::singleton_core().read_model(model, weights), device, device_config);
 }
 
-EncodedImage VisionEncoder::encode(const ov::Tensor& image, const ProcessorConfig& config) {
-    if (model_type == VLMModelType::MINICPM) {
-        return encode_minicpm(image, config);
-    } else if (model_type == VLMModelType::LLAVA) {
-        return encode_llava(image, config);
-    } else if (model_type == VLMModelType::LLAVA_NEXT) {
-        return encode_llava_next(image, config);
-    }  else if (model_type == VLMModelType::INTERNVL_CHAT) {
-        return encode_internvl(image, config);
-    } else {
-        OPENVINO_THROW("Unsupported type of VisionEncoder");
+void VisionEncoder::compile(const std::shared_ptr<ov::Model>& model, const std::string& device, const ov::AnyMap& device_config) {
+    ov::AnyMap compile_config = device_config;
+    if (compile_config.count(ov::genai::embedded_image_preprocessing.name())) {
+        m_embedded_preprocessing = compile_config.at(ov::genai::embedded_image_preprocessing.name()).as<bool>()
+            && model_type != VLMModelType::MINICPM;
+        compile_config.erase(ov::genai::embedded_image_preprocessing.name());
+    }
+    if (compile_config.count(ov::genai::vision_embeddings_cache_size.name())) {
+        m_cache_capacity = compile_config.at(ov::genai::vision_embeddings_cache_size.name()).as<size_t>();
+        compile_config.erase(ov::genai::vision_embeddings_cache_size.name());
     }
+    if (compile_config.count(ov::genai::vision_encoder_max_batch_size.name())) {
+        m_max_batch_size = compile_config.at(ov::genai::vision_encoder_max_batch_size.name()).as<size_t>();
+        compile_config.erase(ov::genai::vision_encoder_max_batch_size.name());
+    }
+    // consumed by InputsEmbedder
+    compile_config.erase(ov::genai::visual_tokens_keep_ratio.name());
+    if (m_embedded_preprocessing) {
+        merge_image_preprocessing(model, m_processor_config, model_type);
+    }
+    auto compiled_model = utils::singleton_core().compile_model(model, device, compile_config);
+    ov::genai::utils::print_compiled_model_properties(compiled_model, "VLM vision embeddings model");
+    m_vision_encoder = compiled_model.create_infer_request();
+}
+
+EncodedImage VisionEncoder::encode(const ov::Tensor& image, const ProcessorConfig& config) {
+    return encode(std::vector<ov::Tensor>{image}, config).at(0);
 }
 
 EncodedImage VisionEncoder::encode(const ov::Tensor& image, const ov::AnyMap& config_map) {
@@ -691,65 +855,208 @@ EncodedImage VisionEncoder::encode(const ov::Tensor& image, const ov::AnyMap& co
     ));
 }
 
-EncodedImage VisionEncoder::encode_minicpm(const ov::Tensor& image, const ProcessorConfig& config) {
-    clip_ctx ctx_clip;
-    ctx_clip.image_size = m_processor_config.image_size;
-    std::copy(config.norm_mean.begin(), config.norm_mean.end(), ctx_clip.image_mean);
-    std::copy(config.norm_std.begin(), config.norm_std.end(), ctx_clip.image_std);
-    return llava_image_embed_make_with_bytes_slice(ctx_clip, image, m_vision_encoder, config.max_slice_nums, config.scale_resolution, config.patch_size, 0 == config.max_slice_nums);
-}
-
-EncodedImage VisionEncoder::encode_llava(const ov::Tensor& image, const ProcessorConfig& config) {
-    ov::Tensor pixel_values = get_pixel_values_llava(image, config);
+std::vector<EncodedImage> VisionEncoder::encode(const std::vector<ov::Tensor>& images, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics) {
+    if (m_cache_capacity == 0) {
+        return encode_images(images, config, raw_metrics);
+    }
 
-    m_vision_encoder.set_tensor("pixel_values", pixel_values);
-    m_vision_encoder.infer();
+    std::vector<EncodedImage> encoded_images(images.size());
+    std::vector<size_t> hashes(images.size());
+    std::vector<ov::Tensor> missed_images;
+    std::vector<size_t> missed_indices;
+    for (size_t image_idx = 0; image_idx < images.size(); ++image_idx) {
+        hashes[image_idx] = get_image_hash(images[image_idx], config);
+        auto it = m_cache_index.find(hashes[image_idx]);
+        if (it != m_cache_index.end()) {
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            encoded_images[image_idx] = it->second->second;
+        } else {
+            missed_images.push_back(images[image_idx]);
+            missed_indices.push_back(image_idx);
+        }
+    }
 
-    const ov::Tensor& infer_output = m_vision_encoder.get_output_tensor();
-    ov::Tensor image_features(infer_output.get_element_type(), infer_output.get_shape());
-    std::memcpy(image_features.data(), infer_output.data(), infer_output.get_byte_size());
+    if (raw_metrics) {
+        raw_metrics->vision_embeddings_cache_lookups += images.size();
+        raw_metrics->vision_embeddings_cache_hits += images.size() - missed_images.size();
+    }
 
-    ImageSize resized_source_size{config.crop_size_height / config.patch_size, config.crop_size_width / config.patch_size};
+    std::vector<EncodedImage> encoded_missed_images = encode_images(missed_images, config, raw_metrics);
+    for (size_t missed_idx = 0; missed_idx < missed_indices.size(); ++missed_idx) {
+        const size_t image_idx = missed_indices[missed_idx];
+        add_to_cache(hashes[image_idx], encoded_missed_images[missed_idx]);
+        encoded_images[image_idx] = std::move(encoded_missed_images[missed_idx]);
+    }
+    return encoded_images;
+}
 
-    return {std::move(image_features), resized_source_size};
+void VisionEncoder::add_to_cache(size_t hash, const EncodedImage& encoded_image) {
+    const size_t byte_size = encoded_image.resized_source.get_byte_size()
+        + (encoded_image.slices ? encoded_image.slices.get_byte_size() : 0);
+    if (byte_size > m_cache_capacity || m_cache_index.count(hash)) {
+        return;
+    }
+    while (m_cache_size + byte_size > m_cache_capacity) {
+        const EncodedImage& evicted = m_cache.back().second;
+        m_cache_size -= evicted.resized_source.get_byte_size() + (evicted.slices ? evicted.slices.get_byte_size() : 0);
+        m_cache_index.erase(m_cache.back().first);
+        m_cache.pop_back();
+    }
+    m_cache.emplace_front(hash, encoded_image);
+    m_cache_index.emplace(hash, m_cache.begin());
+    m_cache_size += byte_size;
 }
 
-EncodedImage VisionEncoder::encode_llava_next(const ov::Tensor& image, const ProcessorConfig& config) {
-    ov::Tensor pixel_values = get_pixel_values_llava_next(image, config);
+std::vector<EncodedImage> VisionEncoder::encode_images(const std::vector<ov::Tensor>& images, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics) {
+    std::vector<EncodedImage> encoded_images;
+    encoded_images.reserve(images.size());
+    if (model_type == VLMModelType::MINICPM) {
+        // slices of an image are padded to its largest slice, so images are encoded one by one
+        for (const ov::Tensor& image : images) {
+            encoded_images.push_back(encode_minicpm(image, config, raw_metrics));
+        }
+        return encoded_images;
+    }
 
-    m_vision_encoder.set_tensor("pixel_values", pixel_values);
-    m_vision_encoder.infer();
+    std::vector<ov::Tensor> pixel_values;
+    pixel_values.reserve(images.size());
+    for (const ov::Tensor& image : images) {
+        auto start_preprocessing_time = std::chrono::steady_clock::now();
+        pixel_values.push_back(get_pixel_values(image, config));
+        if (raw_metrics) {
+            auto end_preprocessing_time = std::chrono::steady_clock::now();
+            raw_metrics->image_preprocessing_durations.emplace_back(PerfMetrics::get_microsec(end_preprocessing_time - start_preprocessing_time));
+        }
+    }
 
-    const ov::Tensor& infer_output = m_vision_encoder.get_output_tensor();
-    ov::Tensor image_features(infer_output.get_element_type(), infer_output.get_shape());
-    std::memcpy(image_features.data(), infer_output.data(), infer_output.get_byte_size());
+    auto same_item_shape = [](const ov::Shape& lhs, const ov::Shape& rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin() + 1, lhs.end(), rhs.begin() + 1);
+    };
 
-    ImageSize resized_source_size{config.crop_size_height / config.patch_size, config.crop_size_width / config.patch_size};
+    // pixel values of consecutive images of the same patch shape are stacked along the batch axis and encoded by
+    // infers of up to m_max_batch_size patches, features of each image are copied from outputs of the infers
+    size_t group_begin = 0;
+    while (group_begin < images.size()) {
+        const ov::Shape& item_shape = pixel_values[group_begin].get_shape();
+        size_t group_end = group_begin + 1;
+        size_t n_rows = item_shape.at(0);
+        while (group_end < images.size() && same_item_shape(item_shape, pixel_values[group_end].get_shape())) {
+            n_rows += pixel_values[group_end].get_shape().at(0);
+            ++group_end;
+        }
+
+        ov::Tensor stacked = pixel_values[group_begin];
+        if (group_end - group_begin > 1) {
+            ov::Shape stacked_shape = item_shape;
+            stacked_shape[0] = n_rows;
+            stacked = ov::Tensor(stacked.get_element_type(), stacked_shape);
+            uint8_t* stacked_data = static_cast<uint8_t*>(stacked.data());
+            for (size_t image_idx = group_begin; image_idx < group_end; ++image_idx) {
+                const ov::Tensor& image_pixel_values = pixel_values[image_idx];
+                std::memcpy(stacked_data, image_pixel_values.data(), image_pixel_values.get_byte_size());
+                stacked_data += image_pixel_values.get_byte_size();
+            }
+        }
+        const size_t row_byte_size = stacked.get_byte_size() / n_rows;
+
+        std::vector<ov::Tensor> image_features(group_end - group_begin);
+        size_t image_idx = group_begin, image_row = 0;
+        for (size_t chunk_begin = 0; chunk_begin < n_rows;) {
+            const size_t chunk_size = m_max_batch_size == 0 ? n_rows : std::min(m_max_batch_size, n_rows - chunk_begin);
+            ov::Shape chunk_shape = item_shape;
+            chunk_shape[0] = chunk_size;
+            ov::Tensor chunk_pixel_values(stacked.get_element_type(),
+                                          chunk_shape,
+                                          static_cast<uint8_t*>(stacked.data()) + chunk_begin * row_byte_size);
+
+            m_vision_encoder.set_tensor("pixel_values", chunk_pixel_values);
+            auto start_infer_time = std::chrono::steady_clock::now();
+            m_vision_encoder.infer();
+            if (raw_metrics) {
+                auto end_infer_time = std::chrono::steady_clock::now();
+                raw_metrics->vision_encoder_infer_durations.emplace_back(PerfMetrics::get_microsec(end_infer_time - start_infer_time));
+                raw_metrics->vision_encoder_infer_batch_sizes.push_back(chunk_size);
+            }
 
-    // Gen number of patches
-    ImageSize original_image_size{image.get_shape().at(1), image.get_shape().at(2)};
-    auto best_resolution = select_best_resolution({original_image_size.width, original_image_size.height}, config.image_grid_pinpoints);
-    int num_patches_w = best_resolution.first / config.size_shortest_edge;
-    int num_patches_h = best_resolution.second / config.size_shortest_edge;
+            const ov::Tensor& infer_output = m_vision_encoder.get_output_tensor();
+            const size_t output_row_byte_size = infer_output.get_byte_size() / chunk_size;
+            for (size_t row = 0; row < chunk_size;) {
+                const size_t image_rows = pixel_values[image_idx].get_shape().at(0);
+                ov::Tensor& features = image_features[image_idx - group_begin];
+                if (!features) {
+                    ov::Shape features_shape = infer_output.get_shape();
+                    features_shape[0] = image_rows;
+                    features = ov::Tensor(infer_output.get_element_type(), features_shape);
+                }
+                const size_t n_copied = std::min(chunk_size - row, image_rows - image_row);
+                std::memcpy(static_cast<uint8_t*>(features.data()) + image_row * output_row_byte_size,
+                            static_cast<const uint8_t*>(infer_output.data()) + row * output_row_byte_size,
+                            n_copied * output_row_byte_size);
+                row += n_copied;
+                image_row += n_copied;
+                if (image_row == image_rows) {
+                    ++image_idx;
+                    image_row = 0;
+                }
+            }
+            chunk_begin += chunk_size;
+        }
 
-    EncodedImage encoded_image;
-    encoded_image.resized_source = std::move(image_features);
-    encoded_image.resized_source_size = resized_source_size;
-    encoded_image.patches_grid = {num_patches_h, num_patches_w};
-    return encoded_image;
+        for (size_t idx = group_begin; idx < group_end; ++idx) {
+            encoded_images.push_back(get_encoded_image(std::move(image_features[idx - group_begin]), images[idx], config));
+        }
+        group_begin = group_end;
+    }
+    return encoded_images;
 }
 
-EncodedImage VisionEncoder::encode_internvl(const ov::Tensor& image, const ProcessorConfig& config) {
-    ov::Tensor pixel_values = get_pixel_values_internvl(image, config);
+std::vector<EncodedImage> VisionEncoder::encode(const std::vector<ov::Tensor>& images, const ov::AnyMap& config_map, VLMRawPerfMetrics* raw_metrics) {
+    return encode(images, from_any_map(
+        config_map, m_processor_config
+    ), raw_metrics);
+}
 
-    m_vision_encoder.set_tensor("pixel_values", pixel_values);
-    m_vision_encoder.infer();
+EncodedImage VisionEncoder::encode_minicpm(const ov::Tensor& image, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics) {
+    clip_ctx ctx_clip;
+    ctx_clip.image_size = m_processor_config.image_size;
+    std::copy(config.norm_mean.begin(), config.norm_mean.end(), ctx_clip.image_mean);
+    std::copy(config.norm_std.begin(), config.norm_std.end(), ctx_clip.image_std);
+    return llava_image_embed_make_with_bytes_slice(ctx_clip, image, m_vision_encoder, config.max_slice_nums, config.scale_resolution, config.patch_size, 0 == config.max_slice_nums, raw_metrics);
+}
 
-    const ov::Tensor& infer_output = m_vision_encoder.get_output_tensor();
-    ov::Tensor image_features(infer_output.get_element_type(), infer_output.get_shape());
-    std::memcpy(image_features.data(), infer_output.data(), infer_output.get_byte_size());
+ov::Tensor VisionEncoder::get_pixel_values(const ov::Tensor& image, const ProcessorConfig& config) {
+    if (model_type == VLMModelType::LLAVA) {
+        return m_embedded_preprocessing ? image : get_pixel_values_llava(image, config);
+    } else if (model_type == VLMModelType::LLAVA_NEXT) {
+        if (!m_embedded_preprocessing) {
+            return get_pixel_values_llava_next(image, config);
+        }
+        std::pair<int, int> size{config.size_shortest_edge, config.size_shortest_edge};
+        return clip_images_u8_to_tensor(
+            get_image_patches(tensor_to_clip_image_u8(image), config.image_grid_pinpoints, size, config.crop_size_height));
+    } else if (model_type == VLMModelType::INTERNVL_CHAT) {
+        return m_embedded_preprocessing
+            ? clip_images_u8_to_tensor(split_image_internvl(tensor_to_clip_image_u8(image), config.size_shortest_edge))
+            : get_pixel_values_internvl(image, config);
+    } else {
+        OPENVINO_THROW("Unsupported type of VisionEncoder");
+    }
+}
 
+EncodedImage VisionEncoder::get_encoded_image(ov::Tensor image_features, const ov::Tensor& image, const ProcessorConfig& config) {
     ImageSize resized_source_size{config.crop_size_height / config.patch_size, config.crop_size_width / config.patch_size};
 
-    return {std::move(image_features), resized_source_size};
+    EncodedImage encoded_image;
+    encoded_image.resized_source = std::move(image_features);
+    encoded_image.resized_source_size = resized_source_size;
+
+    if (model_type == VLMModelType::LLAVA_NEXT) {
+        // Gen number of patches
+        ImageSize original_image_size{image.get_shape().at(1), image.get_shape().at(2)};
+        auto best_resolution = select_best_resolution({original_image_size.width, original_image_size.height}, config.image_grid_pinpoints);
+        int num_patches_w = best_resolution.first / config.size_shortest_edge;
+        int num_patches_h = best_resolution.second / config.size_shortest_edge;
+        encoded_image.patches_grid = {num_patches_h, num_patches_w};
+    }
+    return encoded_image;
 }
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <list>
+#include <unordered_map>
 #include <openvino/openvino.hpp>
+#include "openvino/genai/visual_language/perf_metrics.hpp"
 #include "visual_language/processor_config.hpp"
 #include "visual_language/vlm_model_type.hpp"
 
@@ -124,6 +127,35 @@ public:
         const ov::Tensor& image, const ov::AnyMap& config_map
     );
 
+    /// @brief Compute embeddings of several images given ProcessorConfig.
+    /// Patches of images are stacked and encoded by infers of up to
+    /// vision_encoder_max_batch_size patches. MiniCPM-V images are
+    /// encoded one by one. Embeddings of images found in the cache
+    /// enabled by vision_embeddings_cache_size are not computed again.
+    /// @param images Images to infer embeddings for. Each image shape
+    /// must be [1HWC].
+    /// @param config A config to follow instead of the config obtained
+    /// in constructors.
+    /// @param raw_metrics If set, preprocessing and infer durations,
+    /// infer batch sizes and cache lookups are appended to it.
+    /// @return Resulting embeddings of each image.
+    std::vector<EncodedImage> encode(
+        const std::vector<ov::Tensor>& images, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics = nullptr
+    );
+
+    /// @brief Compute embeddings of several images given
+    /// ProcessorConfig members.
+    /// @param images Images to infer embeddings for. Each image shape
+    /// must be [1HWC].
+    /// @param config_map A config or its members values to follow
+    /// instead of the config obtained in constructors.
+    /// @param raw_metrics If set, preprocessing and infer durations,
+    /// infer batch sizes and cache lookups are appended to it.
+    /// @return Resulting embeddings of each image.
+    std::vector<EncodedImage> encode(
+        const std::vector<ov::Tensor>& images, const ov::AnyMap& config_map = {}, VLMRawPerfMetrics* raw_metrics = nullptr
+    );
+
     /// @brief Compute embeddings of an image given
     /// ProcessorConfig members.
     /// @param image An image to infer embeddings for. Image shape must be
@@ -143,20 +175,42 @@ public:
     }
 
 private:
-    EncodedImage encode_minicpm(
-        const ov::Tensor& image, const ProcessorConfig& config
+    /// @brief Whether m_vision_encoder takes u8 NHWC images and
+    /// resizes, crops and normalizes them itself.
+    bool m_embedded_preprocessing = false;
+    /// @brief Maximum number of patches per infer, 0 means unlimited.
+    size_t m_max_batch_size = 0;
+    /// @brief Maximum byte size of cached embeddings, 0 disables the cache.
+    size_t m_cache_capacity = 0;
+    /// @brief Byte size of cached embeddings.
+    size_t m_cache_size = 0;
+    /// @brief Embeddings of recently encoded images with hashes of the
+    /// images and their configs, the most recently used first.
+    std::list<std::pair<size_t, EncodedImage>> m_cache;
+    std::unordered_map<size_t, std::list<std::pair<size_t, EncodedImage>>::iterator> m_cache_index;
+
+    void compile(
+        const std::shared_ptr<ov::Model>& model,
+        const std::string& device,
+        const ov::AnyMap& device_config
     );
 
-    EncodedImage encode_llava(
-        const ov::Tensor& image, const ProcessorConfig& config
+    void add_to_cache(size_t hash, const EncodedImage& encoded_image);
+
+    std::vector<EncodedImage> encode_images(
+        const std::vector<ov::Tensor>& images, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics
     );
 
-    EncodedImage encode_llava_next(
-        const ov::Tensor& image, const ProcessorConfig& config
+    EncodedImage encode_minicpm(
+        const ov::Tensor& image, const ProcessorConfig& config, VLMRawPerfMetrics* raw_metrics
     );
 
-    EncodedImage encode_internvl(
+    ov::Tensor get_pixel_values(
         const ov::Tensor& image, const ProcessorConfig& config
     );
+
+    EncodedImage get_encoded_image(
+        ov::Tensor image_features, const ov::Tensor& image, const ProcessorConfig& config
+    );
 };
 }
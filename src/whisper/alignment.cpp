@@ -0,0 +1,316 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "whisper/alignment.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+
+#include "openvino/core/except.hpp"
+#include "openvino/opsets/opset13.hpp"
+
+namespace {
+
+using namespace ov::opset13;
+
+constexpr float inf = std::numeric_limits<float>::infinity();
+
+bool is_encoder_parameter(const ov::Node* node) {
+    while (ov::is_type<Convert>(node)) {
+        node = node->get_input_node_ptr(0);
+    }
+    if (!ov::is_type<Parameter>(node)) {
+        return false;
+    }
+    for (const auto& name : node->get_output_tensor(0).get_names()) {
+        if (name.find("encoder_hidden_states") != std::string::npos || name.find(".encoder.") != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Keys of cross-attention are projections of the encoder output or their cached values from past_key_values.*.encoder.*
+// inputs. Projections are not traversed further, since keys of self-attention are projections of hidden states, which
+// depend on the encoder output through the previous layers.
+bool is_cross_attention_key(const ov::Output<ov::Node>& key) {
+    std::vector<ov::Node*> stack{key.get_node()};
+    std::set<ov::Node*> visited;
+    while (!stack.empty()) {
+        ov::Node* node = stack.back();
+        stack.pop_back();
+        if (!visited.insert(node).second || ov::is_type<Constant>(node)) {
+            continue;
+        }
+        if (is_encoder_parameter(node)) {
+            return true;
+        }
+        if (ov::is_type<MatMul>(node)) {
+            for (size_t i = 0; i < node->get_input_size(); ++i) {
+                if (is_encoder_parameter(node->get_input_node_ptr(i))) {
+                    return true;
+                }
+            }
+            continue;
+        }
+        for (size_t i = 0; i < node->get_input_size(); ++i) {
+            stack.push_back(node->get_input_node_ptr(i));
+        }
+    }
+    return false;
+}
+
+ov::Output<ov::Node> select_heads(const ov::Output<ov::Node>& input, const std::vector<int64_t>& heads) {
+    auto indices = Constant::create(ov::element::i64, ov::Shape{heads.size()}, heads);
+    auto axis = Constant::create(ov::element::i64, ov::Shape{}, {1});
+    return std::make_shared<Gather>(input, indices, axis);
+}
+
+// softmax(q * k^T * scale + mask) of fused attention over the selected heads
+ov::Output<ov::Node> get_attention_weights(const std::shared_ptr<ScaledDotProductAttention>& sdpa,
+                                           const std::vector<int64_t>& heads) {
+    auto query = select_heads(sdpa->input_value(0), heads);
+    auto key = select_heads(sdpa->input_value(1), heads);
+
+    ov::Output<ov::Node> scale;
+    if (sdpa->get_input_size() > 4) {
+        scale = sdpa->input_value(4);
+    } else {
+        auto head_size = std::make_shared<Gather>(std::make_shared<ShapeOf>(query, ov::element::i64),
+                                                  Constant::create(ov::element::i64, ov::Shape{}, {-1}),
+                                                  Constant::create(ov::element::i64, ov::Shape{}, {0}));
+        auto one = std::make_shared<ConvertLike>(Constant::create(ov::element::f32, ov::Shape{}, {1.0f}), query);
+        scale = std::make_shared<Divide>(one, std::make_shared<Sqrt>(std::make_shared<ConvertLike>(head_size, query)));
+    }
+
+    ov::Output<ov::Node> scores =
+        std::make_shared<MatMul>(std::make_shared<Multiply>(query, scale), key, false, true);
+    if (sdpa->get_input_size() > 3 && !sdpa->get_causal() &&
+        sdpa->input_value(3).get_element_type() != ov::element::boolean) {
+        scores = std::make_shared<Add>(scores, sdpa->input_value(3));
+    }
+    return std::make_shared<Softmax>(scores, -1);
+}
+
+std::shared_ptr<MatMul> get_scores_matmul(const std::shared_ptr<Softmax>& softmax) {
+    ov::Node* node = softmax->get_input_node_ptr(0);
+    while (ov::is_type<Add>(node) || ov::is_type<Multiply>(node) || ov::is_type<Divide>(node) ||
+           ov::is_type<Convert>(node)) {
+        node = node->get_input_node_ptr(0);
+    }
+    return ov::as_type_ptr<MatMul>(node->shared_from_this());
+}
+
+// median of each element's window, the row is reflected at its borders
+void median_filter(std::vector<float>& row, const size_t width) {
+    const size_t size = row.size();
+    if (width <= 1 || size < width) {
+        return;
+    }
+    const std::vector<float> source = row;
+    const int64_t half = width / 2;
+    std::vector<float> window(width);
+    for (int64_t j = 0; j < static_cast<int64_t>(size); ++j) {
+        for (int64_t k = -half; k <= half; ++k) {
+            int64_t index = j + k;
+            if (index < 0) {
+                index = -index;
+            } else if (index >= static_cast<int64_t>(size)) {
+                index = 2 * (static_cast<int64_t>(size) - 1) - index;
+            }
+            window[k + half] = source[index];
+        }
+        std::nth_element(window.begin(), window.begin() + half, window.end());
+        row[j] = window[half];
+    }
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+void add_cross_attention_outputs(std::shared_ptr<ov::Model> model,
+                                 const std::vector<std::pair<size_t, size_t>>& alignment_heads) {
+    // cross-attention weights of decoder layers in topological order, which is the order of layers
+    std::vector<std::function<ov::Output<ov::Node>(const std::vector<int64_t>&)>> layers;
+    for (const auto& node : model->get_ordered_ops()) {
+        if (auto sdpa = ov::as_type_ptr<ScaledDotProductAttention>(node)) {
+            if (is_cross_attention_key(sdpa->input_value(1))) {
+                layers.push_back([sdpa](const std::vector<int64_t>& heads) {
+                    return get_attention_weights(sdpa, heads);
+                });
+            }
+        } else if (auto softmax = ov::as_type_ptr<Softmax>(node)) {
+            auto matmul = get_scores_matmul(softmax);
+            if (matmul && is_cross_attention_key(matmul->input_value(1))) {
+                layers.push_back([softmax](const std::vector<int64_t>& heads) {
+                    return select_heads(softmax->output(0), heads);
+                });
+            }
+        }
+    }
+
+    std::map<size_t, std::vector<int64_t>> heads_by_layer;
+    for (const auto& [layer, head] : alignment_heads) {
+        OPENVINO_ASSERT(layer < layers.size(),
+                        "Cross-attention of decoder layer ",
+                        layer,
+                        " is not found, the model has ",
+                        layers.size(),
+                        " cross-attention layers");
+        heads_by_layer[layer].push_back(static_cast<int64_t>(head));
+    }
+    OPENVINO_ASSERT(!heads_by_layer.empty(), "Alignment heads are required to output cross-attention weights");
+
+    ov::OutputVector weights;
+    for (const auto& [layer, heads] : heads_by_layer) {
+        weights.push_back(std::make_shared<Convert>(layers[layer](heads), ov::element::f32));
+    }
+
+    auto result = std::make_shared<Result>(std::make_shared<Concat>(weights, 1));
+    result->output(0).get_tensor().set_names({"cross_attention_weights"});
+    model->add_results({result});
+}
+
+TokenAlignment align_tokens(const std::vector<std::vector<float>>& attention_rows,
+                            const size_t n_heads,
+                            const size_t n_frames,
+                            const size_t n_valid_frames,
+                            const size_t median_filter_width) {
+    const size_t n_tokens = attention_rows.size();
+    const size_t n_cols = std::clamp<size_t>(n_valid_frames, 1, n_frames);
+    TokenAlignment alignment;
+    if (n_tokens == 0) {
+        return alignment;
+    }
+
+    std::vector<float> cost(n_tokens * n_cols, 0.0f);
+    std::vector<float> mean(n_cols), std_dev(n_cols), row(n_cols);
+    for (size_t head = 0; head < n_heads; ++head) {
+        // weights of each frame are standardized over tokens
+        std::fill(mean.begin(), mean.end(), 0.0f);
+        std::fill(std_dev.begin(), std_dev.end(), 0.0f);
+        for (const auto& attention_row : attention_rows) {
+            const float* weights = attention_row.data() + head * n_frames;
+            for (size_t j = 0; j < n_cols; ++j) {
+                mean[j] += weights[j];
+                std_dev[j] += weights[j] * weights[j];
+            }
+        }
+        for (size_t j = 0; j < n_cols; ++j) {
+            mean[j] /= n_tokens;
+            const float variance = std::max(std_dev[j] / n_tokens - mean[j] * mean[j], 0.0f);
+            std_dev[j] = variance > 0.0f ? std::sqrt(variance) : 1.0f;
+        }
+
+        for (size_t i = 0; i < n_tokens; ++i) {
+            const float* weights = attention_rows[i].data() + head * n_frames;
+            for (size_t j = 0; j < n_cols; ++j) {
+                row[j] = (weights[j] - mean[j]) / std_dev[j];
+            }
+            median_filter(row, median_filter_width);
+            // DTW minimizes the negated mean over heads
+            float* token_cost = cost.data() + i * n_cols;
+            for (size_t j = 0; j < n_cols; ++j) {
+                token_cost[j] -= row[j] / n_heads;
+            }
+        }
+    }
+
+    // tokens are spoken in order, so the path stays within a band around the diagonal, which is wide enough to
+    // absorb pauses and speech rate changes
+    const size_t band_radius = n_cols / 4 + n_cols / n_tokens + 1;
+    const auto [token_indices, frame_indices] = dtw(cost, n_tokens, n_cols, band_radius);
+
+    alignment.begins.assign(n_tokens, 0);
+    alignment.ends.assign(n_tokens, 0);
+    for (size_t k = 0; k < token_indices.size(); ++k) {
+        const size_t token = token_indices[k];
+        if (k == 0 || token != token_indices[k - 1]) {
+            alignment.begins[token] = frame_indices[k];
+        }
+        alignment.ends[token] = frame_indices[k] + 1;
+    }
+    return alignment;
+}
+
+std::pair<std::vector<size_t>, std::vector<size_t>> dtw(const std::vector<float>& cost,
+                                                        const size_t n_rows,
+                                                        const size_t n_cols,
+                                                        const size_t band_radius) {
+    OPENVINO_ASSERT(cost.size() == n_rows * n_cols, "DTW cost matrix must have n_rows * n_cols elements");
+
+    enum Move : uint8_t { DIAGONAL, UP, LEFT };
+
+    // accumulated costs of rows i - 1 and i, where index j + 1 holds column j and index 0 is a virtual column -1.
+    // Costs are inf outside of bands, the virtual row -1 has zero cost at the virtual column only.
+    std::vector<float> previous(n_cols + 1, inf), current(n_cols + 1, inf), vertical(n_cols);
+    std::vector<uint8_t> moves(n_rows * n_cols, LEFT);
+    previous[0] = 0.0f;
+    // indices of finite costs in previous
+    size_t previous_begin = 0, previous_end = 1;
+
+    for (size_t i = 0; i < n_rows; ++i) {
+        const float center = (i + 0.5f) * n_cols / n_rows;
+        const size_t begin = static_cast<size_t>(std::max(0.0f, center - band_radius));
+        const size_t end = std::min(n_cols, static_cast<size_t>(center + band_radius) + 1);
+
+        const float* row_cost = cost.data() + i * n_cols;
+        uint8_t* row_moves = moves.data() + i * n_cols;
+
+        // diagonal and vertical moves only depend on the previous row
+        for (size_t j = begin; j < end; ++j) {
+            const float diagonal = previous[j], up = previous[j + 1];
+            vertical[j] = std::min(diagonal, up);
+            row_moves[j] = diagonal <= up ? DIAGONAL : UP;
+        }
+
+        // horizontal moves are a sequential scan
+        float left = inf;
+        for (size_t j = begin; j < end; ++j) {
+            if (left < vertical[j]) {
+                row_moves[j] = LEFT;
+                left += row_cost[j];
+            } else {
+                left = vertical[j] + row_cost[j];
+            }
+            current[j + 1] = left;
+        }
+
+        std::swap(previous, current);
+        std::fill(current.begin() + previous_begin, current.begin() + previous_end, inf);
+        previous_begin = begin + 1;
+        previous_end = end + 1;
+    }
+    OPENVINO_ASSERT(previous_end == n_cols + 1, "DTW band doesn't reach the last column");
+
+    std::vector<size_t> row_indices, col_indices;
+    size_t i = n_rows, j = n_cols;
+    while (i > 0 && j > 0) {
+        row_indices.push_back(i - 1);
+        col_indices.push_back(j - 1);
+        switch (moves[(i - 1) * n_cols + j - 1]) {
+        case DIAGONAL:
+            --i;
+            --j;
+            break;
+        case UP:
+            --i;
+            break;
+        default:
+            --j;
+        }
+    }
+    std::reverse(row_indices.begin(), row_indices.end());
+    std::reverse(col_indices.begin(), col_indices.end());
+    return {row_indices, col_indices};
+}
+
+}  // namespace genai
+}  // namespace ov
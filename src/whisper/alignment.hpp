@@ -0,0 +1,54 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "openvino/core/model.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * @brief Adds "cross_attention_weights" output [batch, n_alignment_heads, seq_len, n_encoder_frames] to a decoder
+ * model with softmax weights of cross-attention of alignment heads given as (layer, head) pairs. Weights of fused
+ * ScaledDotProductAttention are computed by a parallel subgraph over the selected heads only.
+ */
+void add_cross_attention_outputs(std::shared_ptr<ov::Model> model,
+                                 const std::vector<std::pair<size_t, size_t>>& alignment_heads);
+
+struct TokenAlignment {
+    // [begin, end) encoder frames of each token
+    std::vector<size_t> begins;
+    std::vector<size_t> ends;
+};
+
+/**
+ * @brief Aligns tokens with encoder frames by DTW over cross-attention weights of alignment heads. Weights are
+ * normalized over tokens, median filtered over frames and averaged over heads as in the reference implementation.
+ *
+ * @param attention_rows weights of each query, which predicted a token, flattened [n_heads, n_frames]
+ * @param n_valid_frames number of frames covered by audio, other frames are ignored
+ */
+TokenAlignment align_tokens(const std::vector<std::vector<float>>& attention_rows,
+                            const size_t n_heads,
+                            const size_t n_frames,
+                            const size_t n_valid_frames,
+                            const size_t median_filter_width = 7);
+
+/**
+ * @brief DTW of a cost matrix [n_rows, n_cols] restricted to a band of band_radius columns around the diagonal.
+ * Each row is relaxed from the previous one by vectorizable element-wise minimums, followed by a scan for
+ * horizontal moves.
+ * @return row and column indices of the path from (0, 0) to (n_rows - 1, n_cols - 1)
+ */
+std::pair<std::vector<size_t>, std::vector<size_t>> dtw(const std::vector<float>& cost,
+                                                        const size_t n_rows,
+                                                        const size_t n_cols,
+                                                        const size_t band_radius);
+
+}  // namespace genai
+}  // namespace ov
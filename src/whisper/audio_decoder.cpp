@@ -0,0 +1,812 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifdef _WIN32
+#    define _USE_MATH_DEFINES
+#endif
+
+#include "whisper/audio_decoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include "openvino/core/except.hpp"
+
+namespace {
+
+// frames of integer PCM or IEEE float samples read by one block
+constexpr size_t pcm_block_frames = 4096;
+// limits of header values, so that a corrupted header fails instead of allocating huge buffers
+constexpr size_t max_n_channels = 64;
+constexpr size_t max_sampling_rate = 768000;
+// coefficients of all phases of a resampling filter, 128 MB
+constexpr size_t max_resampler_taps = size_t{1} << 25;
+
+uint32_t read_le(std::istream& stream, const size_t n_bytes) {
+    std::array<uint8_t, 4> bytes{};
+    stream.read(reinterpret_cast<char*>(bytes.data()), n_bytes);
+    OPENVINO_ASSERT(stream.gcount() == static_cast<std::streamsize>(n_bytes), "Unexpected end of audio file header");
+    uint32_t value = 0;
+    for (size_t i = 0; i < n_bytes; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+enum class SampleFormat { PCM = 1, IEEE_FLOAT = 3 };
+
+// Interleaved samples of WAV data chunks and headerless files
+class PcmDecoder : public ov::genai::AudioDecoder {
+public:
+    PcmDecoder(std::ifstream&& stream,
+               const SampleFormat format,
+               const size_t bits_per_sample,
+               const size_t sampling_rate,
+               const size_t n_channels,
+               const uint64_t data_size)
+        : m_stream{std::move(stream)},
+          m_format{format},
+          m_bytes_per_sample{bits_per_sample / 8},
+          m_remaining_size{data_size} {
+        const bool is_pcm = format == SampleFormat::PCM && (bits_per_sample == 8 || bits_per_sample == 16 ||
+                                                            bits_per_sample == 24 || bits_per_sample == 32);
+        const bool is_float = format == SampleFormat::IEEE_FLOAT && (bits_per_sample == 32 || bits_per_sample == 64);
+        OPENVINO_ASSERT(is_pcm || is_float,
+                        "Unsupported audio sample format ",
+                        static_cast<int>(format),
+                        " with ",
+                        bits_per_sample,
+                        " bits per sample");
+        OPENVINO_ASSERT(sampling_rate > 0 && n_channels > 0,
+                        "Audio sampling rate and number of channels must be positive");
+        OPENVINO_ASSERT(sampling_rate <= max_sampling_rate && n_channels <= max_n_channels,
+                        "Unsupported audio sampling rate ",
+                        sampling_rate,
+                        " or number of channels ",
+                        n_channels);
+        m_sampling_rate = sampling_rate;
+        m_n_channels = n_channels;
+    }
+
+    bool read_block(std::vector<float>& mono) override {
+        const size_t frame_size = m_bytes_per_sample * m_n_channels;
+        const size_t block_size =
+            static_cast<size_t>(std::min<uint64_t>(pcm_block_frames * frame_size, m_remaining_size));
+        m_bytes.resize(block_size);
+        m_stream.read(reinterpret_cast<char*>(m_bytes.data()), block_size);
+        const size_t n_frames = static_cast<size_t>(m_stream.gcount()) / frame_size;
+        m_remaining_size -= n_frames * frame_size;
+
+        mono.resize(n_frames);
+        const float channel_scale = 1.0f / m_n_channels;
+        const uint8_t* data = m_bytes.data();
+        for (size_t frame = 0; frame < n_frames; ++frame) {
+            float sum = 0.0f;
+            for (size_t channel = 0; channel < m_n_channels; ++channel, data += m_bytes_per_sample) {
+                sum += get_sample(data);
+            }
+            mono[frame] = sum * channel_scale;
+        }
+        return n_frames > 0;
+    }
+
+private:
+    std::ifstream m_stream;
+    SampleFormat m_format;
+    size_t m_bytes_per_sample;
+    uint64_t m_remaining_size;
+    std::vector<uint8_t> m_bytes;
+
+    float get_sample(const uint8_t* data) const {
+        if (m_format == SampleFormat::IEEE_FLOAT) {
+            if (m_bytes_per_sample == 4) {
+                float value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+            double value;
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<float>(value);
+        }
+        switch (m_bytes_per_sample) {
+        case 1:
+            // 8-bit samples are unsigned
+            return (static_cast<int32_t>(data[0]) - 128) / 128.0f;
+        case 2:
+            return static_cast<int16_t>(data[0] | (data[1] << 8)) / 32768.0f;
+        case 3: {
+            const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(data[0]) << 8) |
+                                                       (static_cast<uint32_t>(data[1]) << 16) |
+                                                       (static_cast<uint32_t>(data[2]) << 24));
+            return (value >> 8) / 8388608.0f;
+        }
+        default: {
+            const int32_t value =
+                static_cast<int32_t>(static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+                                     (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24));
+            return value / 2147483648.0f;
+        }
+        }
+    }
+};
+
+std::unique_ptr<ov::genai::AudioDecoder> open_wav(std::ifstream&& stream) {
+    // "RIFF" is already read
+    read_le(stream, 4);
+    std::array<char, 4> id{};
+    stream.read(id.data(), id.size());
+    OPENVINO_ASSERT(stream && std::memcmp(id.data(), "WAVE", 4) == 0, "RIFF audio file is not WAVE");
+
+    std::optional<SampleFormat> format;
+    size_t n_channels = 0, sampling_rate = 0, bits_per_sample = 0;
+    while (stream.read(id.data(), id.size())) {
+        uint64_t chunk_size = read_le(stream, 4);
+        if (std::memcmp(id.data(), "fmt ", 4) == 0) {
+            uint32_t format_tag = read_le(stream, 2);
+            n_channels = read_le(stream, 2);
+            sampling_rate = read_le(stream, 4);
+            // byte rate and block align
+            read_le(stream, 4);
+            read_le(stream, 2);
+            bits_per_sample = read_le(stream, 2);
+            size_t read_size = 16;
+            // WAVE_FORMAT_EXTENSIBLE keeps the format tag in the first bytes of the sub format GUID
+            if (format_tag == 0xFFFE && chunk_size >= 40) {
+                read_le(stream, 2);
+                read_le(stream, 2);
+                read_le(stream, 4);
+                format_tag = read_le(stream, 2);
+                read_size = 26;
+            }
+            OPENVINO_ASSERT(format_tag == static_cast<uint32_t>(SampleFormat::PCM) ||
+                                format_tag == static_cast<uint32_t>(SampleFormat::IEEE_FLOAT),
+                            "Unsupported WAV format tag ",
+                            format_tag);
+            format = static_cast<SampleFormat>(format_tag);
+            stream.seekg(chunk_size - read_size + (chunk_size & 1), std::ios::cur);
+        } else if (std::memcmp(id.data(), "data", 4) == 0) {
+            OPENVINO_ASSERT(format.has_value(), "WAV data chunk precedes fmt chunk");
+            // streamed WAV files don't know the data size
+            if (chunk_size == 0 || chunk_size == std::numeric_limits<uint32_t>::max()) {
+                chunk_size = std::numeric_limits<uint64_t>::max();
+            }
+            return std::make_unique<PcmDecoder>(std::move(stream),
+                                                *format,
+                                                bits_per_sample,
+                                                sampling_rate,
+                                                n_channels,
+                                                chunk_size);
+        } else {
+            stream.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+        }
+    }
+    OPENVINO_THROW("WAV file has no data chunk");
+}
+
+// MSB first bit reader of a byte stream
+class BitReader {
+public:
+    explicit BitReader(std::ifstream&& stream) : m_stream{std::move(stream)}, m_buffer(1 << 16) {}
+
+    // n <= 56
+    uint64_t read_bits(const size_t n) {
+        while (m_cache_bits < n) {
+            uint8_t byte;
+            OPENVINO_ASSERT(read_stream_byte(byte), "Unexpected end of FLAC file");
+            m_cache = (m_cache << 8) | byte;
+            m_cache_bits += 8;
+        }
+        m_cache_bits -= n;
+        return n == 0 ? 0 : (m_cache >> m_cache_bits) & ((uint64_t{1} << n) - 1);
+    }
+
+    int64_t read_signed_bits(const size_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        const uint64_t value = read_bits(n);
+        // sign extension of n-bit value
+        const uint64_t sign = uint64_t{1} << (n - 1);
+        return static_cast<int64_t>(value ^ sign) - static_cast<int64_t>(sign);
+    }
+
+    // number of zero bits before the next one bit, the one bit is consumed
+    uint32_t read_unary() {
+        uint32_t count = 0;
+        while (true) {
+            if (m_cache_bits == 0) {
+                uint8_t byte;
+                OPENVINO_ASSERT(read_stream_byte(byte), "Unexpected end of FLAC file");
+                m_cache = byte;
+                m_cache_bits = 8;
+            }
+            const uint64_t valid = m_cache & ((uint64_t{1} << m_cache_bits) - 1);
+            if (valid == 0) {
+                count += static_cast<uint32_t>(m_cache_bits);
+                m_cache_bits = 0;
+                continue;
+            }
+            size_t bit = m_cache_bits - 1;
+            while (((valid >> bit) & 1) == 0) {
+                --bit;
+            }
+            count += static_cast<uint32_t>(m_cache_bits - 1 - bit);
+            m_cache_bits = bit;
+            return count;
+        }
+    }
+
+    void align_to_byte() {
+        m_cache_bits -= m_cache_bits % 8;
+    }
+
+    // reads the next byte at a byte boundary, returns false at the end of the stream
+    bool read_byte(uint8_t& byte) {
+        if (m_cache_bits >= 8) {
+            m_cache_bits -= 8;
+            byte = static_cast<uint8_t>(m_cache >> m_cache_bits);
+            return true;
+        }
+        return read_stream_byte(byte);
+    }
+
+private:
+    std::ifstream m_stream;
+    std::vector<uint8_t> m_buffer;
+    size_t m_position = 0;
+    size_t m_size = 0;
+    uint64_t m_cache = 0;
+    size_t m_cache_bits = 0;
+
+    bool read_stream_byte(uint8_t& byte) {
+        if (m_position == m_size) {
+            m_stream.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+            m_size = static_cast<size_t>(m_stream.gcount());
+            m_position = 0;
+            if (m_size == 0) {
+                return false;
+            }
+        }
+        byte = m_buffer[m_position++];
+        return true;
+    }
+};
+
+// https://xiph.org/flac/format.html
+class FlacDecoder : public ov::genai::AudioDecoder {
+public:
+    // the stream is positioned after "fLaC"
+    explicit FlacDecoder(std::ifstream&& stream) : m_reader{std::move(stream)} {
+        bool is_last = false;
+        bool has_stream_info = false;
+        while (!is_last) {
+            is_last = m_reader.read_bits(1) == 1;
+            const uint64_t block_type = m_reader.read_bits(7);
+            const uint64_t block_size = m_reader.read_bits(24);
+            if (block_type == 0) {
+                // STREAMINFO: block sizes and frame sizes are not needed
+                m_reader.read_bits(32);
+                m_reader.read_bits(48);
+                m_sampling_rate = m_reader.read_bits(20);
+                m_n_channels = m_reader.read_bits(3) + 1;
+                m_bits_per_sample = m_reader.read_bits(5) + 1;
+                OPENVINO_ASSERT(m_sampling_rate <= max_sampling_rate, "Unsupported FLAC sampling rate ", m_sampling_rate);
+                OPENVINO_ASSERT(m_bits_per_sample >= 4, "Invalid FLAC bits per sample ", m_bits_per_sample);
+                // total samples and MD5 signature
+                m_reader.read_bits(36);
+                for (size_t i = 0; i < 16; ++i) {
+                    m_reader.read_bits(8);
+                }
+                has_stream_info = true;
+            } else {
+                for (uint64_t i = 0; i < block_size; ++i) {
+                    m_reader.read_bits(8);
+                }
+            }
+        }
+        OPENVINO_ASSERT(has_stream_info && m_sampling_rate > 0, "FLAC file has no STREAMINFO metadata block");
+    }
+
+    bool read_block(std::vector<float>& mono) override {
+        size_t block_size = 0, n_channels = 0, channel_assignment = 0, bits_per_sample = 0;
+        while (true) {
+            if (!find_frame_sync()) {
+                return false;
+            }
+            if (read_frame_header(block_size, channel_assignment, bits_per_sample)) {
+                n_channels = channel_assignment < 8 ? channel_assignment + 1 : 2;
+                break;
+            }
+        }
+
+        m_channels.resize(n_channels);
+        for (size_t channel = 0; channel < n_channels; ++channel) {
+            // side channel has one more bit
+            const bool is_side = (channel_assignment == 8 && channel == 1) ||
+                                 (channel_assignment == 9 && channel == 0) ||
+                                 (channel_assignment == 10 && channel == 1);
+            decode_subframe(m_channels[channel], block_size, bits_per_sample + (is_side ? 1 : 0));
+        }
+        m_reader.align_to_byte();
+        // CRC-16 of the frame
+        m_reader.read_bits(16);
+
+        decorrelate_channels(channel_assignment, block_size);
+
+        mono.resize(block_size);
+        const float scale = 1.0f / (static_cast<float>(int64_t{1} << (bits_per_sample - 1)) * n_channels);
+        for (size_t i = 0; i < block_size; ++i) {
+            int64_t sum = 0;
+            for (size_t channel = 0; channel < n_channels; ++channel) {
+                sum += m_channels[channel][i];
+            }
+            mono[i] = sum * scale;
+        }
+        return true;
+    }
+
+private:
+    BitReader m_reader;
+    size_t m_bits_per_sample = 0;
+    std::vector<std::vector<int64_t>> m_channels;
+
+    bool find_frame_sync() {
+        m_reader.align_to_byte();
+        uint8_t previous = 0, byte = 0;
+        while (m_reader.read_byte(byte)) {
+            // 14 sync bits, a reserved zero bit and a blocking strategy bit
+            if (previous == 0xFF && (byte & 0xFE) == 0xF8) {
+                return true;
+            }
+            previous = byte;
+        }
+        return false;
+    }
+
+    // returns false for reserved values, which mean a false frame sync
+    bool read_frame_header(size_t& block_size, size_t& channel_assignment, size_t& bits_per_sample) {
+        const uint64_t block_size_code = m_reader.read_bits(4);
+        const uint64_t sampling_rate_code = m_reader.read_bits(4);
+        channel_assignment = m_reader.read_bits(4);
+        const uint64_t sample_size_code = m_reader.read_bits(3);
+        m_reader.read_bits(1);
+        if (block_size_code == 0 || sampling_rate_code == 15 || channel_assignment > 10 || sample_size_code == 3) {
+            return false;
+        }
+
+        // frame or sample number is coded as UTF-8
+        const uint64_t first_byte = m_reader.read_bits(8);
+        size_t n_continuation_bytes = 0;
+        while (n_continuation_bytes < 7 && ((first_byte << n_continuation_bytes) & 0x80)) {
+            ++n_continuation_bytes;
+        }
+        for (size_t i = 1; i < n_continuation_bytes; ++i) {
+            m_reader.read_bits(8);
+        }
+
+        if (block_size_code == 1) {
+            block_size = 192;
+        } else if (block_size_code <= 5) {
+            block_size = size_t{576} << (block_size_code - 2);
+        } else if (block_size_code == 6) {
+            block_size = m_reader.read_bits(8) + 1;
+        } else if (block_size_code == 7) {
+            block_size = m_reader.read_bits(16) + 1;
+        } else {
+            block_size = size_t{256} << (block_size_code - 8);
+        }
+
+        // the sampling rate of STREAMINFO is used
+        if (sampling_rate_code == 12) {
+            m_reader.read_bits(8);
+        } else if (sampling_rate_code == 13 || sampling_rate_code == 14) {
+            m_reader.read_bits(16);
+        }
+        // CRC-8 of the header
+        m_reader.read_bits(8);
+
+        constexpr std::array<size_t, 8> sample_sizes{0, 8, 12, 0, 16, 20, 24, 32};
+        bits_per_sample = sample_size_code == 0 ? m_bits_per_sample : sample_sizes[sample_size_code];
+        return true;
+    }
+
+    void decode_subframe(std::vector<int64_t>& samples, const size_t block_size, size_t bits_per_sample) {
+        samples.resize(block_size);
+        m_reader.read_bits(1);
+        const uint64_t type = m_reader.read_bits(6);
+        size_t wasted_bits = 0;
+        if (m_reader.read_bits(1) == 1) {
+            wasted_bits = m_reader.read_unary() + 1;
+            // at least one bit of each sample is coded, which also bounds the shift restoring wasted bits
+            OPENVINO_ASSERT(wasted_bits < bits_per_sample, "Invalid FLAC number of wasted bits ", wasted_bits);
+            bits_per_sample -= wasted_bits;
+        }
+
+        if (type == 0) {
+            std::fill(samples.begin(), samples.end(), m_reader.read_signed_bits(bits_per_sample));
+        } else if (type == 1) {
+            for (auto& sample : samples) {
+                sample = m_reader.read_signed_bits(bits_per_sample);
+            }
+        } else if (type >= 8 && type <= 12) {
+            const size_t order = type - 8;
+            read_warm_up(samples, order, bits_per_sample);
+            read_residual(samples, order);
+            predict_fixed(samples, order);
+        } else if (type >= 32) {
+            const size_t order = type - 31;
+            read_warm_up(samples, order, bits_per_sample);
+            const size_t precision = m_reader.read_bits(4) + 1;
+            OPENVINO_ASSERT(precision < 16, "Invalid FLAC LPC coefficient precision");
+            const int64_t shift = m_reader.read_signed_bits(5);
+            OPENVINO_ASSERT(shift >= 0, "Negative FLAC LPC shift is not supported");
+            std::vector<int64_t> coefficients(order);
+            for (auto& coefficient : coefficients) {
+                coefficient = m_reader.read_signed_bits(precision);
+            }
+            read_residual(samples, order);
+            predict_lpc(samples, coefficients, static_cast<size_t>(shift));
+        } else {
+            OPENVINO_THROW("Reserved FLAC subframe type ", type);
+        }
+
+        if (wasted_bits > 0) {
+            for (auto& sample : samples) {
+                sample *= int64_t{1} << wasted_bits;
+            }
+        }
+    }
+
+    void read_warm_up(std::vector<int64_t>& samples, const size_t order, const size_t bits_per_sample) {
+        OPENVINO_ASSERT(order <= samples.size(), "FLAC predictor order exceeds block size");
+        for (size_t i = 0; i < order; ++i) {
+            samples[i] = m_reader.read_signed_bits(bits_per_sample);
+        }
+    }
+
+    // writes residuals after the warm-up samples
+    void read_residual(std::vector<int64_t>& samples, const size_t order) {
+        const uint64_t method = m_reader.read_bits(2);
+        OPENVINO_ASSERT(method <= 1, "Reserved FLAC residual coding method");
+        const size_t parameter_bits = method == 0 ? 4 : 5;
+        const uint64_t escape_parameter = (uint64_t{1} << parameter_bits) - 1;
+        const size_t partition_order = m_reader.read_bits(4);
+        const size_t n_partitions = size_t{1} << partition_order;
+        const size_t partition_size = samples.size() >> partition_order;
+        OPENVINO_ASSERT(partition_size >= order && partition_size * n_partitions == samples.size(),
+                        "Invalid FLAC residual partition order");
+
+        size_t i = order;
+        for (size_t partition = 0; partition < n_partitions; ++partition) {
+            const size_t end = (partition + 1) * partition_size;
+            const uint64_t parameter = m_reader.read_bits(parameter_bits);
+            if (parameter == escape_parameter) {
+                const size_t raw_bits = m_reader.read_bits(5);
+                for (; i < end; ++i) {
+                    samples[i] = m_reader.read_signed_bits(raw_bits);
+                }
+                continue;
+            }
+            for (; i < end; ++i) {
+                const uint64_t value = (static_cast<uint64_t>(m_reader.read_unary()) << parameter) |
+                                       m_reader.read_bits(parameter);
+                // zigzag coding of signed values
+                samples[i] = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+        }
+    }
+
+    static void predict_fixed(std::vector<int64_t>& samples, const size_t order) {
+        for (size_t i = order; i < samples.size(); ++i) {
+            switch (order) {
+            case 1:
+                samples[i] += samples[i - 1];
+                break;
+            case 2:
+                samples[i] += 2 * samples[i - 1] - samples[i - 2];
+                break;
+            case 3:
+                samples[i] += 3 * samples[i - 1] - 3 * samples[i - 2] + samples[i - 3];
+                break;
+            case 4:
+                samples[i] += 4 * samples[i - 1] - 6 * samples[i - 2] + 4 * samples[i - 3] - samples[i - 4];
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    static void predict_lpc(std::vector<int64_t>& samples,
+                            const std::vector<int64_t>& coefficients,
+                            const size_t shift) {
+        const size_t order = coefficients.size();
+        for (size_t i = order; i < samples.size(); ++i) {
+            int64_t prediction = 0;
+            for (size_t j = 0; j < order; ++j) {
+                prediction += coefficients[j] * samples[i - 1 - j];
+            }
+            samples[i] += prediction >> shift;
+        }
+    }
+
+    void decorrelate_channels(const size_t channel_assignment, const size_t block_size) {
+        if (channel_assignment < 8) {
+            return;
+        }
+        auto& first = m_channels[0];
+        auto& second = m_channels[1];
+        for (size_t i = 0; i < block_size; ++i) {
+            if (channel_assignment == 8) {
+                // left, side
+                second[i] = first[i] - second[i];
+            } else if (channel_assignment == 9) {
+                // side, right
+                first[i] += second[i];
+            } else {
+                // mid, side
+                const int64_t mid = (first[i] * 2) | (second[i] & 1);
+                const int64_t side = second[i];
+                first[i] = (mid + side) >> 1;
+                second[i] = (mid - side) >> 1;
+            }
+        }
+    }
+};
+
+// zeroth order modified Bessel function of the first kind
+double bessel_i0(const double x) {
+    double sum = 1.0, term = 1.0;
+    for (size_t k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+std::unique_ptr<AudioDecoder> open_audio_file(const std::filesystem::path& path, const WhisperPcmFormat& pcm_format) {
+    std::ifstream stream(path, std::ios::binary);
+    OPENVINO_ASSERT(stream.is_open(), "Failed to open audio file '", path, "'");
+
+    std::array<char, 4> id{};
+    stream.read(id.data(), id.size());
+    if (stream && std::memcmp(id.data(), "RIFF", 4) == 0) {
+        return open_wav(std::move(stream));
+    }
+    // FLAC files may start with ID3v2 tag
+    if (stream && std::memcmp(id.data(), "ID3", 3) == 0) {
+        std::array<uint8_t, 6> header{};
+        stream.read(reinterpret_cast<char*>(header.data()), header.size());
+        // tag size is coded by 7 bits of 4 bytes
+        const size_t tag_size = (header[2] << 21) | (header[3] << 14) | (header[4] << 7) | header[5];
+        stream.seekg(tag_size, std::ios::cur);
+        stream.read(id.data(), id.size());
+    }
+    if (stream && std::memcmp(id.data(), "fLaC", 4) == 0) {
+        return std::make_unique<FlacDecoder>(std::move(stream));
+    }
+
+    stream.clear();
+    stream.seekg(0);
+    return std::make_unique<PcmDecoder>(std::move(stream),
+                                        SampleFormat::PCM,
+                                        16,
+                                        pcm_format.sampling_rate,
+                                        pcm_format.n_channels,
+                                        std::numeric_limits<uint64_t>::max());
+}
+
+PolyphaseResampler::PolyphaseResampler(const size_t input_rate, const size_t output_rate) {
+    OPENVINO_ASSERT(input_rate > 0 && output_rate > 0, "Sampling rates must be positive");
+    OPENVINO_ASSERT(input_rate <= max_sampling_rate && output_rate <= max_sampling_rate,
+                    "Sampling rates must not exceed ",
+                    max_sampling_rate);
+    const size_t divisor = std::gcd(input_rate, output_rate);
+    m_up = output_rate / divisor;
+    m_down = input_rate / divisor;
+    if (m_up == m_down) {
+        return;
+    }
+
+    // the pass band ends a little below the lower Nyquist frequency, the filter spans zero_crossings on each side
+    constexpr double zero_crossings = 16.0;
+    constexpr double kaiser_beta = 8.0;
+    const double cutoff = 0.95 * std::min(1.0, static_cast<double>(m_up) / m_down);
+    m_half_taps = static_cast<size_t>(std::ceil(zero_crossings / cutoff));
+
+    const size_t n_taps = 2 * m_half_taps;
+    OPENVINO_ASSERT(m_up * n_taps <= max_resampler_taps,
+                    "Resampling from ",
+                    input_rate,
+                    " to ",
+                    output_rate,
+                    " Hz requires too long filter");
+    m_filters.resize(m_up * n_taps);
+    for (size_t phase = 0; phase < m_up; ++phase) {
+        float* taps = m_filters.data() + phase * n_taps;
+        double sum = 0.0;
+        for (size_t i = 0; i < n_taps; ++i) {
+            // distance in input samples from the output sample to input sample i of the phase
+            const double distance = static_cast<double>(phase) / m_up + m_half_taps - 1.0 - i;
+            const double x = cutoff * distance;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            const double window_position = distance / m_half_taps;
+            const double window = std::abs(window_position) >= 1.0
+                                      ? 0.0
+                                      : bessel_i0(kaiser_beta * std::sqrt(1.0 - window_position * window_position)) /
+                                            bessel_i0(kaiser_beta);
+            const double tap = cutoff * sinc * window;
+            taps[i] = static_cast<float>(tap);
+            sum += tap;
+        }
+        // unit gain of each phase keeps constant signals unchanged
+        for (size_t i = 0; i < n_taps; ++i) {
+            taps[i] = static_cast<float>(taps[i] / sum);
+        }
+    }
+
+    // input before the first sample is zero
+    m_input.assign(m_half_taps, 0.0f);
+    m_input_offset = -static_cast<int64_t>(m_half_taps);
+}
+
+void PolyphaseResampler::process(const std::vector<float>& input, std::vector<float>& output) {
+    if (m_up == m_down) {
+        output.insert(output.end(), input.begin(), input.end());
+        return;
+    }
+    m_input.insert(m_input.end(), input.begin(), input.end());
+    m_n_input_samples += input.size();
+    compute_outputs(std::numeric_limits<int64_t>::max(), output);
+}
+
+void PolyphaseResampler::finish(std::vector<float>& output) {
+    if (m_up == m_down) {
+        return;
+    }
+    m_input.insert(m_input.end(), m_half_taps, 0.0f);
+    // outputs up to the end of input
+    const int64_t n_outputs = (m_n_input_samples * static_cast<int64_t>(m_up) + m_down - 1) / m_down;
+    compute_outputs(n_outputs, output);
+}
+
+void PolyphaseResampler::compute_outputs(const int64_t n_outputs, std::vector<float>& output) {
+    const int64_t up = static_cast<int64_t>(m_up), down = static_cast<int64_t>(m_down);
+    const int64_t half_taps = static_cast<int64_t>(m_half_taps);
+    const size_t n_taps = 2 * m_half_taps;
+    const int64_t input_end = m_input_offset + static_cast<int64_t>(m_input.size());
+
+    for (; m_next_output < n_outputs; ++m_next_output) {
+        // the output sample is at input position base + phase / up
+        const int64_t position = m_next_output * down;
+        const int64_t base = position / up;
+        if (base + half_taps >= input_end) {
+            break;
+        }
+        const float* samples = m_input.data() + (base - half_taps + 1 - m_input_offset);
+        const float* taps = m_filters.data() + (position % up) * n_taps;
+
+        // independent partial sums let the compiler vectorize the unrolled loop
+        float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+        size_t i = 0;
+        for (; i + 4 <= n_taps; i += 4) {
+            sum0 += samples[i + 0] * taps[i + 0];
+            sum1 += samples[i + 1] * taps[i + 1];
+            sum2 += samples[i + 2] * taps[i + 2];
+            sum3 += samples[i + 3] * taps[i + 3];
+        }
+        for (; i < n_taps; ++i) {
+            sum0 += samples[i] * taps[i];
+        }
+        output.push_back((sum0 + sum1) + (sum2 + sum3));
+    }
+
+    // input samples before the first tap of the next output sample are not needed anymore
+    const int64_t first_needed = (m_next_output * down) / up - half_taps + 1;
+    if (first_needed > m_input_offset) {
+        const int64_t n_dropped = std::min<int64_t>(first_needed - m_input_offset, m_input.size());
+        m_input.erase(m_input.begin(), m_input.begin() + n_dropped);
+        m_input_offset += n_dropped;
+    }
+}
+
+void read_audio(const std::filesystem::path& path,
+                const WhisperPcmFormat& pcm_format,
+                const size_t sampling_rate,
+                const std::function<void(const std::vector<float>&)>& consumer) {
+    std::unique_ptr<AudioDecoder> decoder = open_audio_file(path, pcm_format);
+    PolyphaseResampler resampler(decoder->get_sampling_rate(), sampling_rate);
+
+    // blocks decoded ahead of resampling
+    constexpr size_t max_queued_blocks = 8;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::vector<float>> queue;
+    bool is_decoded = false;
+    bool is_stopped = false;
+    std::exception_ptr decoding_error;
+
+    std::thread decoding_thread([&]() {
+        try {
+            std::vector<float> block;
+            while (decoder->read_block(block)) {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&] {
+                    return queue.size() < max_queued_blocks || is_stopped;
+                });
+                if (is_stopped) {
+                    return;
+                }
+                queue.push_back(std::move(block));
+                condition.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoding_error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        is_decoded = true;
+        condition.notify_all();
+    });
+
+    std::vector<float> resampled;
+    try {
+        while (true) {
+            std::vector<float> block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&] {
+                    return !queue.empty() || is_decoded;
+                });
+                if (queue.empty()) {
+                    break;
+                }
+                block = std::move(queue.front());
+                queue.pop_front();
+                condition.notify_all();
+            }
+            resampled.clear();
+            resampler.process(block, resampled);
+            if (!resampled.empty()) {
+                consumer(resampled);
+            }
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_stopped = true;
+        }
+        condition.notify_all();
+        decoding_thread.join();
+        throw;
+    }
+    decoding_thread.join();
+    if (decoding_error) {
+        std::rethrow_exception(decoding_error);
+    }
+
+    resampled.clear();
+    resampler.finish(resampled);
+    if (!resampled.empty()) {
+        consumer(resampled);
+    }
+}
+
+}  // namespace genai
+}  // namespace ov
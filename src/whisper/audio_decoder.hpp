@@ -0,0 +1,89 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "openvino/genai/whisper_pipeline.hpp"
+
+namespace ov {
+namespace genai {
+
+/**
+ * Decoder of an audio file, which returns samples block by block with channels down-mixed to mono
+ */
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() = default;
+
+    size_t get_sampling_rate() const {
+        return m_sampling_rate;
+    }
+
+    /**
+     * @brief Replaces mono with the next block of samples normalized to [-1, 1]
+     * @return false at the end of the file
+     */
+    virtual bool read_block(std::vector<float>& mono) = 0;
+
+protected:
+    size_t m_sampling_rate = 0;
+    size_t m_n_channels = 0;
+};
+
+/**
+ * @brief Opens a WAV file (integer PCM or IEEE float samples) or a FLAC file detected by the file header, other files
+ * are read as headerless PCM of pcm_format
+ */
+std::unique_ptr<AudioDecoder> open_audio_file(const std::filesystem::path& path, const WhisperPcmFormat& pcm_format);
+
+/**
+ * Streaming resampler by a rational factor up / down. Each output sample is a dot product of input samples with one of
+ * up phases of a Kaiser windowed-sinc low-pass filter.
+ */
+class PolyphaseResampler {
+public:
+    PolyphaseResampler(const size_t input_rate, const size_t output_rate);
+
+    /**
+     * @brief Appends output samples, which are covered by input samples received so far, to output
+     */
+    void process(const std::vector<float>& input, std::vector<float>& output);
+
+    /**
+     * @brief Appends the remaining output samples, input is zero after its end
+     */
+    void finish(std::vector<float>& output);
+
+private:
+    size_t m_up = 1;
+    size_t m_down = 1;
+    // filter taps of each phase are applied to 2 * m_half_taps input samples
+    size_t m_half_taps = 0;
+    // flattened [m_up, 2 * m_half_taps]
+    std::vector<float> m_filters;
+    // input samples starting from sample m_input_offset, which are needed by the next output samples
+    std::vector<float> m_input;
+    int64_t m_input_offset = 0;
+    int64_t m_n_input_samples = 0;
+    int64_t m_next_output = 0;
+
+    void compute_outputs(const int64_t n_outputs, std::vector<float>& output);
+};
+
+/**
+ * @brief Decodes an audio file and resamples it to sampling_rate block by block. Decoding runs in a separate thread,
+ * while the calling thread resamples blocks and passes them to consumer, so the whole waveform is never kept in memory.
+ */
+void read_audio(const std::filesystem::path& path,
+                const WhisperPcmFormat& pcm_format,
+                const size_t sampling_rate,
+                const std::function<void(const std::vector<float>&)>& consumer);
+
+}  // namespace genai
+}  // namespace ov
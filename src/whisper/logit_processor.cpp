@@ -1,44 +1,78 @@
 // Copyright (C) 2023-2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
-#include <openvino/openvino.hpp>
+#include "whisper/logit_processor.hpp"
 
-#include "openvino/genai/whisper_generation_config.hpp"
-#include "sampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-namespace ov {
-namespace genai {
+namespace {
+
+constexpr float neg_inf = -std::numeric_limits<float>::infinity();
 
-void do_suppress_tokens(ov::Tensor& logits, const size_t batch_idx, const std::vector<int64_t>& suppress_tokens) {
-    OPENVINO_ASSERT(logits.get_shape()[0] >= batch_idx, "logits batch size doesn't match the batch number");
+float* get_last_position_logits(ov::Tensor& logits, const size_t batch_idx) {
+    OPENVINO_ASSERT(logits.get_shape().at(0) > batch_idx, "logits batch size doesn't match the batch number");
 
     size_t vocab_size = logits.get_shape().back();
     size_t batch_offset = batch_idx * logits.get_shape()[1] * vocab_size;
     size_t sequence_offset = (logits.get_shape()[1] - 1) * vocab_size;
-    float* logits_data = logits.data<float>() + batch_offset + sequence_offset;
+    return logits.data<float>() + batch_offset + sequence_offset;
+}
+
+// independent maxima of interleaved elements are vectorized, unlike a single running maximum of floats
+float max_value(const float* data, const size_t size) {
+    constexpr size_t n_lanes = 8;
+    float lanes[n_lanes];
+    std::fill(lanes, lanes + n_lanes, neg_inf);
 
-    for (auto supress_token : suppress_tokens) {
-        logits_data[supress_token] = -std::numeric_limits<float>::infinity();
+    size_t i = 0;
+    for (; i + n_lanes <= size; i += n_lanes) {
+        for (size_t lane = 0; lane < n_lanes; ++lane) {
+            lanes[lane] = std::max(lanes[lane], data[i + lane]);
+        }
+    }
+
+    float result = *std::max_element(lanes, lanes + n_lanes);
+    for (; i < size; ++i) {
+        result = std::max(result, data[i]);
     }
+    return result;
 }
 
-void process_whisper_timestamp_logits(ov::Tensor& logits,
-                                      const size_t batch_idx,
-                                      const ov::genai::WhisperGenerationConfig& config,
-                                      const std::vector<int64_t>& generated_tokens,
-                                      bool initial_step = false) {
-    const size_t batch_size = logits.get_shape().at(0);
-    OPENVINO_ASSERT(batch_size == 1, "Batch != 1 is not supported");
+}  // namespace
 
-    size_t vocab_size = logits.get_shape().back();
-    size_t batch_offset = batch_idx * logits.get_shape()[1] * vocab_size;
-    size_t sequence_offset = (logits.get_shape()[1] - 1) * vocab_size;
-    float* logits_data = logits.data<float>() + batch_offset + sequence_offset;
+namespace ov {
+namespace genai {
+
+void process_whisper_logits(ov::Tensor& logits,
+                            const size_t batch_idx,
+                            const ov::genai::WhisperGenerationConfig& config,
+                            const std::vector<int64_t>& generated_tokens,
+                            const bool return_timestamps,
+                            const bool initial_step) {
+    const size_t vocab_size = logits.get_shape().back();
+    float* logits_data = get_last_position_logits(logits, batch_idx);
+
+    if (initial_step) {
+        for (auto token : config.begin_suppress_tokens) {
+            logits_data[token] = neg_inf;
+        }
+    }
+    for (auto token : config.suppress_tokens) {
+        logits_data[token] = neg_inf;
+    }
+
+    if (!return_timestamps) {
+        return;
+    }
 
     // suppress<|notimestamps|>
-    logits_data[config.no_timestamps_token_id] = -std::numeric_limits<float>::infinity();
+    logits_data[config.no_timestamps_token_id] = neg_inf;
 
-    size_t timestamp_begin = config.no_timestamps_token_id + 1;
+    const size_t timestamp_begin = config.no_timestamps_token_id + 1;
+    float* text_end = logits_data + timestamp_begin;
+    float* logits_end = logits_data + vocab_size;
 
     // timestamps have to appear in pairs, except directly before eos_token; mask logits accordingly
     size_t generated_length = generated_tokens.size();
@@ -48,69 +82,51 @@ void process_whisper_timestamp_logits(ov::Tensor& logits,
     if (last_was_timestamp) {
         if (penultimate_was_timestamp) {
             // has to be non-timestamp
-            for (size_t i = timestamp_begin; i < vocab_size; i++) {
-                logits_data[i] = -std::numeric_limits<float>::infinity();
-            }
+            std::fill(text_end, logits_end, neg_inf);
         } else {
             // cannot be normal text token
-            for (size_t i = 0; i < config.eos_token_id; i++) {
-                logits_data[i] = -std::numeric_limits<float>::infinity();
-            }
+            std::fill(logits_data, logits_data + config.eos_token_id, neg_inf);
         }
     }
 
-    // filter generated timestamps
-    std::vector<int64_t> timestamps;
-    for (const auto token : generated_tokens) {
-        if (token >= timestamp_begin) {
-            timestamps.push_back(token);
-        }
-    }
-
-    if (timestamps.size() > 0) {
-        size_t timestamp_last;
+    auto last_timestamp = std::find_if(generated_tokens.rbegin(), generated_tokens.rend(), [&](int64_t token) {
+        return token >= static_cast<int64_t>(timestamp_begin);
+    });
+    if (last_timestamp != generated_tokens.rend()) {
         // `timestamps` shouldn't decrease; forbid timestamp tokens smaller than the last
         // The following lines of code are copied from: https://github.com/openai/whisper/pull/914/files#r1137085090
-        if (last_was_timestamp && !penultimate_was_timestamp) {
-            timestamp_last = timestamps.back();
-        } else {
-            // Avoid to emit <|0.00|> again
-            timestamp_last = timestamps.back() + 1;
-        }
-
-        for (size_t i = timestamp_begin; i < timestamp_last; i++) {
-            logits_data[i] = -std::numeric_limits<float>::infinity();
-        }
+        // Avoid to emit <|0.00|> again
+        const size_t timestamp_last =
+            last_was_timestamp && !penultimate_was_timestamp ? *last_timestamp : *last_timestamp + 1;
+        std::fill(text_end, logits_data + std::min(timestamp_last, vocab_size), neg_inf);
     }
 
-    // apply the `max_initial_timestamp` option
+    // apply the `max_initial_timestamp` option, text tokens are not allowed, so the comparison below is not needed
     if (initial_step) {
-        for (size_t i = 0; i < timestamp_begin; i++) {
-            logits_data[i] = -std::numeric_limits<float>::infinity();
-        }
+        std::fill(logits_data, text_end, neg_inf);
 
         size_t last_allowed = timestamp_begin + config.max_initial_timestamp_index;
-        for (size_t i = last_allowed + 1; i < vocab_size; i++) {
-            logits_data[i] = -std::numeric_limits<float>::infinity();
+        if (last_allowed + 1 < vocab_size) {
+            std::fill(logits_data + last_allowed + 1, logits_end, neg_inf);
         }
+        return;
     }
 
-    auto tokens = ov::genai::log_softmax(logits, 0);
-    float timestamp_exp_prov_sum = 0;
-
-    for (size_t i = timestamp_begin; i < vocab_size; i++) {
-        timestamp_exp_prov_sum += std::exp(tokens[i].m_log_prob);
+    // text tokens are suppressed, if the total probability of timestamps exceeds the probability of any text token.
+    // Softmax normalization cancels out: log(sum(exp(timestamp logits))) > max(text logits)
+    const float max_text_logit = max_value(logits_data, timestamp_begin);
+    const float max_timestamp_logit = max_value(text_end, vocab_size - timestamp_begin);
+    if (max_timestamp_logit == neg_inf) {
+        return;
     }
-    float timestamp_logprob = std::log(timestamp_exp_prov_sum);
 
-    auto max_logprob_token = std::max_element(tokens.begin(), tokens.end(), [](const Token& left, const Token& right) {
-        return left.m_log_prob < right.m_log_prob;
-    });
+    float timestamp_exp_sum = 0.0f;
+    for (const float* logit = text_end; logit != logits_end; ++logit) {
+        timestamp_exp_sum += std::exp(*logit - max_timestamp_logit);
+    }
 
-    if (timestamp_logprob > max_logprob_token->m_log_prob) {
-        for (size_t i = 0; i < timestamp_begin; i++) {
-            logits_data[i] = -std::numeric_limits<float>::infinity();
-        }
+    if (max_timestamp_logit + std::log(timestamp_exp_sum) > max_text_logit) {
+        std::fill(logits_data, text_end, neg_inf);
     }
 }
 
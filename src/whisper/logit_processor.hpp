@@ -10,13 +10,18 @@
 namespace ov {
 namespace genai {
 
-void do_suppress_tokens(ov::Tensor& logits, const size_t batch_idx, const std::vector<int64_t>& suppress_tokens);
-
-void process_whisper_timestamp_logits(ov::Tensor& logits,
-                                      const size_t batch_idx,
-                                      const ov::genai::WhisperGenerationConfig& config,
-                                      const std::vector<int64_t>& generated_tokens,
-                                      bool initial_step = false);
+/**
+ * @brief Processes logits of the last position of a batch row in place: suppresses config.suppress_tokens and
+ * config.begin_suppress_tokens at the initial step and, if return_timestamps is set, applies timestamp rules and
+ * suppresses text tokens, when timestamps are more probable in total than any text token. Masks are filled over
+ * contiguous ranges and the probability comparison takes a single pass over vocabulary without log-softmax.
+ */
+void process_whisper_logits(ov::Tensor& logits,
+                            const size_t batch_idx,
+                            const ov::genai::WhisperGenerationConfig& config,
+                            const std::vector<int64_t>& generated_tokens,
+                            const bool return_timestamps,
+                            const bool initial_step = false);
 
 }  // namespace genai
 }  // namespace ov
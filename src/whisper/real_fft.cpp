@@ -0,0 +1,261 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifdef _WIN32
+#    define _USE_MATH_DEFINES
+#endif
+
+#include "whisper/real_fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "openvino/core/except.hpp"
+
+namespace {
+
+using complex = std::complex<float>;
+
+// std::complex multiplication handles infinities and NaNs via a library call, which prevents vectorization
+inline complex mul(const complex& a, const complex& b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// multiplication by -i
+inline complex mul_neg_i(const complex& a) {
+    return {a.imag(), -a.real()};
+}
+
+complex root(size_t j, size_t n) {
+    const double theta = -2.0 * M_PI * static_cast<double>(j) / static_cast<double>(n);
+    return {static_cast<float>(std::cos(theta)), static_cast<float>(std::sin(theta))};
+}
+
+std::vector<size_t> factorize(size_t n) {
+    std::vector<size_t> radices;
+    for (size_t radix : {4, 2, 3, 5}) {
+        while (n % radix == 0) {
+            radices.push_back(radix);
+            n /= radix;
+        }
+    }
+    for (size_t radix = 7; radix * radix <= n; radix += 2) {
+        while (n % radix == 0) {
+            radices.push_back(radix);
+            n /= radix;
+        }
+    }
+    if (n > 1) {
+        radices.push_back(n);
+    }
+    return radices;
+}
+
+// x and y are viewed as [radix][m][s] and [m][radix][s] arrays, y[q][k][j] = W_n^(q * k) * sum_r x[r][q][j] * W_radix^(r * k)
+
+void radix_2(const complex* x, complex* y, const complex* twiddles, size_t m, size_t s) {
+    for (size_t q = 0; q < m; ++q) {
+        const complex w1 = twiddles[q];
+        const complex* x0 = x + s * q;
+        const complex* x1 = x0 + s * m;
+        complex* y0 = y + s * 2 * q;
+        complex* y1 = y0 + s;
+        for (size_t j = 0; j < s; ++j) {
+            const complex a0 = x0[j], a1 = x1[j];
+            y0[j] = a0 + a1;
+            y1[j] = mul(a0 - a1, w1);
+        }
+    }
+}
+
+void radix_3(const complex* x, complex* y, const complex* twiddles, size_t m, size_t s) {
+    // sin(2 * pi / 3)
+    constexpr float sin_60 = 0.866025403784438647f;
+    for (size_t q = 0; q < m; ++q) {
+        const complex w1 = twiddles[2 * q], w2 = twiddles[2 * q + 1];
+        const complex* x0 = x + s * q;
+        const complex* x1 = x0 + s * m;
+        const complex* x2 = x1 + s * m;
+        complex* y0 = y + s * 3 * q;
+        complex* y1 = y0 + s;
+        complex* y2 = y1 + s;
+        for (size_t j = 0; j < s; ++j) {
+            const complex a0 = x0[j], a1 = x1[j], a2 = x2[j];
+            const complex t1 = a1 + a2;
+            const complex t2 = a0 - 0.5f * t1;
+            const complex t3 = sin_60 * mul_neg_i(a1 - a2);
+            y0[j] = a0 + t1;
+            y1[j] = mul(t2 + t3, w1);
+            y2[j] = mul(t2 - t3, w2);
+        }
+    }
+}
+
+void radix_4(const complex* x, complex* y, const complex* twiddles, size_t m, size_t s) {
+    for (size_t q = 0; q < m; ++q) {
+        const complex w1 = twiddles[3 * q], w2 = twiddles[3 * q + 1], w3 = twiddles[3 * q + 2];
+        const complex* x0 = x + s * q;
+        const complex* x1 = x0 + s * m;
+        const complex* x2 = x1 + s * m;
+        const complex* x3 = x2 + s * m;
+        complex* y0 = y + s * 4 * q;
+        complex* y1 = y0 + s;
+        complex* y2 = y1 + s;
+        complex* y3 = y2 + s;
+        for (size_t j = 0; j < s; ++j) {
+            const complex a0 = x0[j], a1 = x1[j], a2 = x2[j], a3 = x3[j];
+            const complex t0 = a0 + a2, t1 = a0 - a2;
+            const complex t2 = a1 + a3, t3 = mul_neg_i(a1 - a3);
+            y0[j] = t0 + t2;
+            y1[j] = mul(t1 + t3, w1);
+            y2[j] = mul(t0 - t2, w2);
+            y3[j] = mul(t1 - t3, w3);
+        }
+    }
+}
+
+void radix_5(const complex* x, complex* y, const complex* twiddles, size_t m, size_t s) {
+    // cos and sin of 2 * pi / 5 and 4 * pi / 5
+    constexpr float cos_72 = 0.309016994374947424f, cos_144 = -0.809016994374947424f;
+    constexpr float sin_72 = 0.951056516295153572f, sin_144 = 0.587785252292473129f;
+    for (size_t q = 0; q < m; ++q) {
+        const complex w1 = twiddles[4 * q], w2 = twiddles[4 * q + 1], w3 = twiddles[4 * q + 2], w4 = twiddles[4 * q + 3];
+        const complex* x0 = x + s * q;
+        const complex* x1 = x0 + s * m;
+        const complex* x2 = x1 + s * m;
+        const complex* x3 = x2 + s * m;
+        const complex* x4 = x3 + s * m;
+        complex* y0 = y + s * 5 * q;
+        complex* y1 = y0 + s;
+        complex* y2 = y1 + s;
+        complex* y3 = y2 + s;
+        complex* y4 = y3 + s;
+        for (size_t j = 0; j < s; ++j) {
+            const complex a0 = x0[j], a1 = x1[j], a2 = x2[j], a3 = x3[j], a4 = x4[j];
+            const complex b1 = a1 + a4, b2 = a2 + a3;
+            const complex d1 = a1 - a4, d2 = a2 - a3;
+            const complex r1 = a0 + cos_72 * b1 + cos_144 * b2;
+            const complex r2 = a0 + cos_144 * b1 + cos_72 * b2;
+            const complex i1 = mul_neg_i(sin_72 * d1 + sin_144 * d2);
+            const complex i2 = mul_neg_i(sin_144 * d1 - sin_72 * d2);
+            y0[j] = a0 + b1 + b2;
+            y1[j] = mul(r1 + i1, w1);
+            y2[j] = mul(r2 + i2, w2);
+            y3[j] = mul(r2 - i2, w3);
+            y4[j] = mul(r1 - i1, w4);
+        }
+    }
+}
+
+// O(radix^2) butterfly of other prime radices, roots are exp(-2 * pi * i * j / n_total)
+void radix_generic(const complex* x, complex* y, const complex* twiddles, size_t radix, size_t m, size_t s,
+                   const std::vector<complex>& roots) {
+    const size_t n_total = roots.size();
+    const size_t root_step = n_total / radix;
+    for (size_t q = 0; q < m; ++q) {
+        for (size_t k = 0; k < radix; ++k) {
+            complex* yk = y + s * (radix * q + k);
+            for (size_t j = 0; j < s; ++j) {
+                complex sum = x[j + s * q];
+                for (size_t r = 1; r < radix; ++r) {
+                    sum += mul(x[j + s * (q + m * r)], roots[(r * k % radix) * root_step]);
+                }
+                yk[j] = k == 0 ? sum : mul(sum, twiddles[(radix - 1) * q + k - 1]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+RealFFT::RealFFT(size_t n) : m_size(n) {
+    OPENVINO_ASSERT(n > 0, "FFT size must be positive");
+    m_complex_size = n % 2 == 0 ? n / 2 : n;
+
+    size_t stage_size = m_complex_size;
+    for (size_t radix : factorize(m_complex_size)) {
+        Stage stage{radix, {}};
+        const size_t m = stage_size / radix;
+        stage.twiddles.reserve(m * (radix - 1));
+        for (size_t q = 0; q < m; ++q) {
+            for (size_t k = 1; k < radix; ++k) {
+                stage.twiddles.push_back(root(q * k, stage_size));
+            }
+        }
+        m_stages.push_back(std::move(stage));
+        stage_size = m;
+    }
+
+    m_roots.resize(m_complex_size);
+    for (size_t j = 0; j < m_complex_size; ++j) {
+        m_roots[j] = root(j, m_complex_size);
+    }
+
+    if (n % 2 == 0) {
+        m_split_twiddles.resize(n / 2 + 1);
+        for (size_t k = 0; k <= n / 2; ++k) {
+            m_split_twiddles[k] = root(k, n);
+        }
+    }
+}
+
+complex* RealFFT::transform(complex* x, complex* y) const {
+    size_t n = m_complex_size, s = 1;
+    for (const auto& stage : m_stages) {
+        const size_t m = n / stage.radix;
+        switch (stage.radix) {
+        case 2:
+            radix_2(x, y, stage.twiddles.data(), m, s);
+            break;
+        case 3:
+            radix_3(x, y, stage.twiddles.data(), m, s);
+            break;
+        case 4:
+            radix_4(x, y, stage.twiddles.data(), m, s);
+            break;
+        case 5:
+            radix_5(x, y, stage.twiddles.data(), m, s);
+            break;
+        default:
+            radix_generic(x, y, stage.twiddles.data(), stage.radix, m, s, m_roots);
+        }
+        std::swap(x, y);
+        n = m;
+        s *= stage.radix;
+    }
+    return x;
+}
+
+void RealFFT::forward(const float* in, complex* out, complex* workspace) const {
+    complex* x = workspace;
+    complex* y = workspace + m_complex_size;
+
+    if (m_size % 2 == 1) {
+        for (size_t j = 0; j < m_size; ++j) {
+            x[j] = {in[j], 0.0f};
+        }
+        const complex* z = transform(x, y);
+        std::copy(z, z + m_size / 2 + 1, out);
+        return;
+    }
+
+    // even and odd samples are packed as real and imaginary parts of z[j], whose spectrum Z is split into spectra of both halves
+    const size_t half = m_complex_size;
+    for (size_t j = 0; j < half; ++j) {
+        x[j] = {in[2 * j], in[2 * j + 1]};
+    }
+    const complex* z = transform(x, y);
+    for (size_t k = 0; k <= half; ++k) {
+        const complex z_k = z[k == half ? 0 : k];
+        const complex z_conj = std::conj(z[k == 0 ? 0 : half - k]);
+        const complex even = 0.5f * (z_k + z_conj);
+        const complex odd = 0.5f * mul_neg_i(z_k - z_conj);
+        out[k] = even + mul(odd, m_split_twiddles[k]);
+    }
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -0,0 +1,68 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ov {
+namespace genai {
+
+/**
+ * Precomputed plan of the forward FFT of real samples of a fixed size. Even sizes are computed as a complex FFT of
+ * half size, whose sizes are factorized into radices 4, 2, 3, 5 and other primes. Stages are iterative and self-sorting
+ * (Stockham), so that no bit-reversal is needed, and their inner loops run over contiguous elements.
+ * The plan is immutable, so that it can be used from several threads with own workspaces.
+ */
+class RealFFT {
+public:
+    RealFFT() = default;
+
+    /**
+     * @param n Number of real samples.
+     */
+    explicit RealFFT(size_t n);
+
+    size_t get_size() const {
+        return m_size;
+    }
+
+    /**
+     * @return Number of complex elements of a workspace required by forward().
+     */
+    size_t get_workspace_size() const {
+        return 2 * m_complex_size;
+    }
+
+    /**
+     * Computes the first n / 2 + 1 bins of the spectrum, the remaining ones are complex conjugates of them.
+     * @param in n real samples.
+     * @param out n / 2 + 1 complex bins.
+     * @param workspace get_workspace_size() complex elements, which are overwritten.
+     */
+    void forward(const float* in, std::complex<float>* out, std::complex<float>* workspace) const;
+
+private:
+    struct Stage {
+        size_t radix;
+        // W_n^(q * k) of the stage for q in [0, n / radix) and k in [1, radix)
+        std::vector<std::complex<float>> twiddles;
+    };
+
+    size_t m_size = 0;
+    // size of the complex FFT, n / 2 for even n, n otherwise
+    size_t m_complex_size = 0;
+    std::vector<Stage> m_stages;
+    // exp(-2 * pi * i * j / m_complex_size), used by radices without a dedicated butterfly
+    std::vector<std::complex<float>> m_roots;
+    // exp(-2 * pi * i * k / n) for k in [0, n / 2], used to split the half size FFT of even n
+    std::vector<std::complex<float>> m_split_twiddles;
+
+    // returns either x or y, which holds the result
+    std::complex<float>* transform(std::complex<float>* x, std::complex<float>* y) const;
+};
+
+}  // namespace genai
+}  // namespace ov
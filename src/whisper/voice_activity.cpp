@@ -0,0 +1,118 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "whisper/voice_activity.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "openvino/core/except.hpp"
+
+namespace {
+
+// energy of silent digital audio, frames of an audio, which is silent as a whole, are not speech
+constexpr float min_energy_db = -100.0f;
+
+std::vector<float> get_frame_energies(const ov::genai::RawSpeechInput& raw_speech, const size_t frame_size) {
+    const size_t n_frames = (raw_speech.size() + frame_size - 1) / frame_size;
+    std::vector<float> energies(n_frames);
+    for (size_t frame = 0; frame < n_frames; ++frame) {
+        const size_t begin = frame * frame_size;
+        const size_t end = std::min(begin + frame_size, raw_speech.size());
+        double sum_squares = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            sum_squares += static_cast<double>(raw_speech[i]) * raw_speech[i];
+        }
+        energies[frame] = static_cast<float>(10.0 * std::log10(sum_squares / (end - begin) + 1e-10));
+    }
+    return energies;
+}
+
+}  // namespace
+
+namespace ov {
+namespace genai {
+
+float SpeechRegions::to_original_time(const float packed_time, const bool is_end) const {
+    if (regions.empty() || packed_time < 0.0f) {
+        return packed_time;
+    }
+
+    const size_t packed_sample = static_cast<size_t>(std::round(packed_time * sampling_rate));
+    // the last region, which starts before packed_sample (at or before it for starts)
+    auto it = std::upper_bound(regions.begin(),
+                               regions.end(),
+                               packed_sample,
+                               [is_end](size_t sample, const SpeechRegion& region) {
+                                   return is_end ? sample <= region.packed_begin : sample < region.packed_begin;
+                               });
+    const SpeechRegion& region = it == regions.begin() ? regions.front() : *std::prev(it);
+
+    const size_t region_offset = packed_sample - std::min(packed_sample, region.packed_begin);
+    const size_t original_sample = std::min(region.begin + region_offset, region.end);
+    return static_cast<float>(original_sample) / sampling_rate;
+}
+
+SpeechRegions detect_speech_regions(const RawSpeechInput& raw_speech,
+                                    const size_t sampling_rate,
+                                    const ov::genai::WhisperGenerationConfig& config) {
+    OPENVINO_ASSERT(config.vad_threshold.has_value(), "'vad_threshold' must be set to detect speech regions");
+
+    SpeechRegions speech_regions;
+    speech_regions.sampling_rate = sampling_rate;
+    if (raw_speech.empty()) {
+        return speech_regions;
+    }
+
+    const size_t frame_size = sampling_rate / 50;
+    const std::vector<float> energies = get_frame_energies(raw_speech, frame_size);
+    const float max_energy = *std::max_element(energies.begin(), energies.end());
+    if (max_energy <= min_energy_db) {
+        return speech_regions;
+    }
+    const float threshold = max_energy + *config.vad_threshold;
+
+    const size_t min_silence_frames =
+        static_cast<size_t>(std::round(config.vad_min_silence_duration * sampling_rate / frame_size));
+    const size_t pad_samples = static_cast<size_t>(std::round(config.vad_speech_pad_duration * sampling_rate));
+
+    // [begin, end) frames of speech
+    std::vector<std::pair<size_t, size_t>> frame_regions;
+    for (size_t frame = 0; frame < energies.size(); ++frame) {
+        if (energies[frame] < threshold) {
+            continue;
+        }
+        if (!frame_regions.empty() && frame - frame_regions.back().second < min_silence_frames) {
+            frame_regions.back().second = frame + 1;
+        } else {
+            frame_regions.emplace_back(frame, frame + 1);
+        }
+    }
+
+    size_t packed_size = 0;
+    for (const auto& [begin_frame, end_frame] : frame_regions) {
+        const size_t begin = begin_frame * frame_size > pad_samples ? begin_frame * frame_size - pad_samples : 0;
+        const size_t end = std::min(end_frame * frame_size + pad_samples, raw_speech.size());
+
+        auto& regions = speech_regions.regions;
+        if (!regions.empty() && begin <= regions.back().end) {
+            packed_size += end - regions.back().end;
+            regions.back().end = end;
+        } else {
+            regions.push_back({begin, end, packed_size});
+            packed_size += end - begin;
+        }
+    }
+
+    speech_regions.packed.reserve(packed_size);
+    for (const auto& region : speech_regions.regions) {
+        speech_regions.packed.insert(speech_regions.packed.end(),
+                                     raw_speech.begin() + region.begin,
+                                     raw_speech.begin() + region.end);
+    }
+
+    return speech_regions;
+}
+
+}  // namespace genai
+}  // namespace ov
@@ -0,0 +1,48 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+
+#include "openvino/genai/whisper_generation_config.hpp"
+#include "openvino/genai/whisper_pipeline.hpp"
+
+namespace ov {
+namespace genai {
+
+struct SpeechRegion {
+    // [begin, end) samples of the original audio
+    size_t begin;
+    size_t end;
+    // first sample of the region in the packed audio
+    size_t packed_begin;
+};
+
+/**
+ * Speech regions of an audio found by an energy-based voice activity detection and packed one after another, so that
+ * silent regions are not encoded.
+ */
+struct SpeechRegions {
+    size_t sampling_rate;
+    std::vector<SpeechRegion> regions;
+    RawSpeechInput packed;
+
+    /**
+     * @brief Maps time of the packed audio in seconds to time of the original audio. Ends of segments at a border
+     * of regions are mapped to the end of the previous region rather than the beginning of the next one.
+     */
+    float to_original_time(const float packed_time, const bool is_end) const;
+};
+
+/**
+ * @brief Splits audio into 20 ms frames, where frames with energy above the loudest frame energy plus
+ * config.vad_threshold dB are speech. Speech frames divided by silence shorter than config.vad_min_silence_duration
+ * are merged into regions, which are padded by config.vad_speech_pad_duration.
+ */
+SpeechRegions detect_speech_regions(const RawSpeechInput& raw_speech,
+                                    const size_t sampling_rate,
+                                    const ov::genai::WhisperGenerationConfig& config);
+
+}  // namespace genai
+}  // namespace ov
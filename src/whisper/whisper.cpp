@@ -3,18 +3,29 @@
 
 #include "whisper.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
 #include <openvino/openvino.hpp>
+#include <random>
 #include <regex>
 #include <thread>
 
+#include "alignment.hpp"
 #include "context_tokens.hpp"
 #include "logit_processor.hpp"
 #include "openvino/genai/perf_metrics.hpp"
 #include "openvino/genai/whisper_generation_config.hpp"
 #include "openvino/genai/whisper_pipeline.hpp"
 #include "timestamps.hpp"
+#include "tracing.hpp"
 #include "utils.hpp"
+#include "voice_activity.hpp"
 #include "whisper_config.hpp"
 #include "whisper_feature_extractor.hpp"
 #include "whisper_models.hpp"
@@ -41,6 +52,7 @@ ov::Tensor encode(ov::InferRequest& request,
 
     request.set_tensor("input_features", input_tensor);
 
+    ov::genai::ScopedTrace trace("whisper encode");
     const auto infer_start = std::chrono::steady_clock::now();
     request.infer();
     const auto infer_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - infer_start);
@@ -52,6 +64,40 @@ ov::Tensor encode(ov::InferRequest& request,
     return request.get_tensor("last_hidden_state");
 }
 
+void start_encode(ov::InferRequest& request,
+                  std::vector<float>& mel_data,
+                  const size_t feature_size,
+                  const size_t nb_max_frames) {
+    OPENVINO_ASSERT(mel_data.size() == feature_size * nb_max_frames,
+                    "Mel spectrogram required size: ",
+                    feature_size,
+                    " * ",
+                    nb_max_frames,
+                    ". Actual size: ",
+                    mel_data.size(),
+                    ".");
+
+    ov::Tensor input_tensor(ov::element::f32, {1, feature_size, nb_max_frames}, mel_data.data());
+    request.set_tensor("input_features", input_tensor);
+    request.start_async();
+}
+
+// only waiting time is added to inference durations, the rest of encoding is hidden by decoding
+ov::Tensor wait_encode(ov::InferRequest& request,
+                       const size_t feature_size,
+                       const size_t nb_max_frames,
+                       ov::genai::RawPerfMetrics& raw_metrics) {
+    const auto wait_start = std::chrono::steady_clock::now();
+    request.wait();
+    const auto wait_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - wait_start);
+    raw_metrics.m_inference_durations[0] += MicroSeconds(wait_ms);
+
+    // reset input tensor
+    request.set_tensor("input_features", ov::Tensor(ov::element::f32, {0, feature_size, nb_max_frames}));
+
+    return request.get_tensor("last_hidden_state");
+}
+
 void set_past_key_value(ov::InferRequest& source, ov::InferRequest& dest) {
     // source outputs:
     // present.0.decoder.key
@@ -67,7 +113,7 @@ void set_past_key_value(ov::InferRequest& source, ov::InferRequest& dest) {
 
     for (auto& source_output : source.get_compiled_model().outputs()) {
         std::string source_output_name = source_output.get_any_name();
-        if (source_output_name.find("logits") != std::string::npos) {
+        if (source_output_name.find("present") == std::string::npos) {
             continue;
         }
 
@@ -79,15 +125,107 @@ void set_past_key_value(ov::InferRequest& source, ov::InferRequest& dest) {
     }
 }
 
-void infer_with_perf_metrics(ov::InferRequest& request, ov::genai::RawPerfMetrics& raw_metrics) {
+// copies rows of a batched tensor into a new tensor, rows may repeat. The tensor is shared if rows are 0, 1, ..., n - 1
+ov::Tensor select_rows(const ov::Tensor& tensor, const std::vector<size_t>& rows) {
+    ov::Shape shape = tensor.get_shape();
+    bool is_identity = rows.size() == shape[0];
+    for (size_t i = 0; is_identity && i < rows.size(); ++i) {
+        is_identity = rows[i] == i;
+    }
+    if (is_identity) {
+        return tensor;
+    }
+
+    const size_t row_byte_size = tensor.get_byte_size() / shape[0];
+    shape[0] = rows.size();
+    ov::Tensor selected(tensor.get_element_type(), shape);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        std::memcpy(static_cast<uint8_t*>(selected.data()) + i * row_byte_size,
+                    static_cast<const uint8_t*>(tensor.data()) + rows[i] * row_byte_size,
+                    row_byte_size);
+    }
+    return selected;
+}
+
+// KV-cache row i of dest is taken from row rows[i] of source, e.g. from parent beams
+void set_past_key_value(ov::InferRequest& source, ov::InferRequest& dest, const std::vector<size_t>& rows) {
+    for (auto& source_output : source.get_compiled_model().outputs()) {
+        std::string source_output_name = source_output.get_any_name();
+        if (source_output_name.find("present") == std::string::npos) {
+            continue;
+        }
+
+        std::string with_past_input_name =
+            std::regex_replace(source_output_name, std::regex("present"), "past_key_values");
+
+        dest.set_tensor(with_past_input_name, select_rows(source.get_tensor(source_output_name), rows));
+    }
+}
+
+// past key values of the request are cut to the first seq_len positions of decoder KV-cache, e.g. after rejected
+// speculative tokens. Encoder KV-cache is kept
+void trim_past_key_value(ov::InferRequest& request, const size_t seq_len) {
+    for (auto& input : request.get_compiled_model().inputs()) {
+        const std::string& input_name = input.get_any_name();
+        if (input_name.find("past_key_values") == std::string::npos ||
+            input_name.find("encoder") != std::string::npos) {
+            continue;
+        }
+
+        // [batch, n_heads, seq_len, head_size]
+        const ov::Tensor kv_tensor = request.get_tensor(input_name);
+        ov::Shape shape = kv_tensor.get_shape();
+        if (shape[2] == seq_len) {
+            continue;
+        }
+        OPENVINO_ASSERT(shape[2] > seq_len, "KV-cache of ", shape[2], " positions can't be cut to ", seq_len);
+
+        const size_t n_blocks = shape[0] * shape[1];
+        const size_t source_block_size = kv_tensor.get_byte_size() / n_blocks;
+        shape[2] = seq_len;
+        ov::Tensor trimmed(kv_tensor.get_element_type(), shape);
+        const size_t block_size = trimmed.get_byte_size() / n_blocks;
+        for (size_t block = 0; block < n_blocks; ++block) {
+            std::memcpy(static_cast<uint8_t*>(trimmed.data()) + block * block_size,
+                        static_cast<const uint8_t*>(kv_tensor.data()) + block * source_block_size,
+                        block_size);
+        }
+        request.set_tensor(input_name, trimmed);
+    }
+}
+
+// appends cross-attention weights of a query of the request, the last one by default, flattened [n_heads, n_frames]
+void collect_attention_row(ov::InferRequest& request,
+                           std::vector<std::vector<float>>& attention_rows,
+                           const std::optional<size_t> query = std::nullopt) {
+    // [batch, n_heads, seq_len, n_frames]
+    const ov::Tensor weights = request.get_tensor("cross_attention_weights");
+    const ov::Shape shape = weights.get_shape();
+    const size_t n_heads = shape[1], seq_len = shape[2], n_frames = shape[3];
+    const size_t query_idx = query.value_or(seq_len - 1);
+
+    std::vector<float> row(n_heads * n_frames);
+    const float* data = weights.data<const float>();
+    for (size_t head = 0; head < n_heads; ++head) {
+        const float* query_weights = data + (head * seq_len + query_idx) * n_frames;
+        std::copy(query_weights, query_weights + n_frames, row.begin() + head * n_frames);
+    }
+    attention_rows.push_back(std::move(row));
+}
+
+void infer_with_perf_metrics(ov::InferRequest& request,
+                             ov::genai::RawPerfMetrics& raw_metrics,
+                             const size_t batch_size = 1) {
     const auto infer_start = std::chrono::steady_clock::now();
     request.infer();
     const auto infer_end = std::chrono::steady_clock::now();
+    if (ov::genai::Tracer::is_enabled())
+        ov::genai::Tracer::record("whisper decode", infer_start, infer_end);
     const auto infer_ms = ov::genai::PerfMetrics::get_microsec(infer_end - infer_start);
     raw_metrics.m_inference_durations[0] += MicroSeconds(infer_ms);
     raw_metrics.m_token_infer_durations.emplace_back(infer_ms);
     raw_metrics.m_new_token_times.emplace_back(infer_end);
-    raw_metrics.m_batch_sizes.emplace_back(1);
+    raw_metrics.m_batch_sizes.emplace_back(batch_size);
 }
 
 int64_t decode(ov::Tensor& encoder_hidden_state,
@@ -107,12 +245,7 @@ int64_t decode(ov::Tensor& encoder_hidden_state,
     auto output_tensor = decoder.get_tensor("logits");
 
     if (apply_logit_processors) {
-        ov::genai::do_suppress_tokens(output_tensor, 0, config.begin_suppress_tokens);
-        ov::genai::do_suppress_tokens(output_tensor, 0, config.suppress_tokens);
-
-        if (return_timestamps) {
-            ov::genai::process_whisper_timestamp_logits(output_tensor, 0, config, {}, true);
-        }
+        ov::genai::process_whisper_logits(output_tensor, 0, config, {}, return_timestamps, true);
     }
 
     int64_t output_token = ov::genai::utils::argmax(output_tensor, 0);
@@ -142,17 +275,75 @@ int64_t decode_with_past(ov::Tensor& encoder_hidden_state,
 
     auto output_tensor = decoder_with_past.get_tensor("logits");
 
-    ov::genai::do_suppress_tokens(output_tensor, 0, config.suppress_tokens);
-
-    if (return_timestamps) {
-        ov::genai::process_whisper_timestamp_logits(output_tensor, 0, config, generated_tokens);
-    }
+    ov::genai::process_whisper_logits(output_tensor, 0, config, generated_tokens, return_timestamps);
 
     int64_t output_token = ov::genai::utils::argmax(output_tensor, 0);
 
     return output_token;
 }
 
+// input_ids of a single row start at cache_position, which is not set for the decoder without past. input_ids must
+// outlive the infer
+void set_decoder_inputs(ov::Tensor& encoder_hidden_state,
+                        ov::InferRequest& decoder,
+                        std::vector<int64_t>& input_ids,
+                        const std::optional<size_t> cache_position) {
+    decoder.set_tensor("encoder_hidden_states", ov::Tensor{encoder_hidden_state});
+
+    ov::Tensor input_ids_tensor(ov::element::i64, {1, input_ids.size()}, input_ids.data());
+    decoder.set_tensor("input_ids", input_ids_tensor);
+
+    if (cache_position.has_value()) {
+        ov::Tensor cache_position_tensor = decoder.get_tensor("cache_position");
+        cache_position_tensor.set_shape({input_ids.size()});
+        std::iota(cache_position_tensor.data<int64_t>(),
+                  cache_position_tensor.data<int64_t>() + input_ids.size(),
+                  static_cast<int64_t>(*cache_position));
+    }
+}
+
+// decodes init_ids after n_cached_ids, whose KV-cache is already set to decoder_with_past inputs
+int64_t decode_init_with_past(ov::Tensor& encoder_hidden_state,
+                              ov::InferRequest& decoder_with_past,
+                              const std::vector<int64_t>& init_ids,
+                              const size_t n_cached_ids,
+                              const ov::genai::WhisperGenerationConfig& config,
+                              ov::genai::RawPerfMetrics& raw_metrics,
+                              const bool return_timestamps) {
+    std::vector<int64_t> input_ids(init_ids.begin() + n_cached_ids, init_ids.end());
+    set_decoder_inputs(encoder_hidden_state, decoder_with_past, input_ids, n_cached_ids);
+
+    infer_with_perf_metrics(decoder_with_past, raw_metrics);
+
+    auto output_tensor = decoder_with_past.get_tensor("logits");
+    ov::genai::process_whisper_logits(output_tensor, 0, config, {}, return_timestamps, true);
+
+    return ov::genai::utils::argmax(output_tensor, 0);
+}
+
+// the most probable language token at the last position of batch row
+int64_t get_language_token(const ov::Tensor& logits,
+                           const size_t batch_idx,
+                           const ov::genai::WhisperGenerationConfig& config) {
+    if (config.lang_to_id.empty()) {
+        return ov::genai::utils::argmax(logits, batch_idx);
+    }
+
+    const ov::Shape shape = logits.get_shape();
+    const float* logits_data = logits.data<const float>() + (batch_idx * shape[1] + shape[1] - 1) * shape[2];
+    int64_t language_token = config.lang_to_id.begin()->second;
+    for (const auto& [_, token] : config.lang_to_id) {
+        if (logits_data[token] > logits_data[language_token]) {
+            language_token = token;
+        }
+    }
+    return language_token;
+}
+
+bool is_language_detected(const ov::genai::WhisperGenerationConfig& config) {
+    return config.is_multilingual && !config.language.has_value();
+}
+
 int64_t detect_language(ov::Tensor& encoder_hidden_state,
                         ov::InferRequest& decoder,
                         const ov::genai::WhisperGenerationConfig& config,
@@ -171,9 +362,25 @@ int64_t detect_language(ov::Tensor& encoder_hidden_state,
 
     auto output_tensor = decoder.get_tensor("logits");
 
-    int64_t output_token = ov::genai::utils::argmax(output_tensor, 0);
+    return get_language_token(output_tensor, 0, config);
+}
 
-    return output_token;
+std::vector<int64_t> get_init_tokens(const ov::genai::WhisperGenerationConfig& config,
+                                     const bool return_timestamps,
+                                     const int64_t language_token_id) {
+    int64_t task_token_id = config.transcribe_token_id;
+    if (config.task.has_value() && *config.task == "translate") {
+        task_token_id = config.translate_token_id;
+    }
+
+    if (return_timestamps) {
+        return std::vector<int64_t>{config.decoder_start_token_id, language_token_id, task_token_id};
+    }
+
+    return std::vector<int64_t>{config.decoder_start_token_id,
+                                language_token_id,
+                                task_token_id,
+                                config.no_timestamps_token_id};
 }
 
 std::vector<int64_t> prepare_init_tokens(ov::Tensor& encoder_hidden_state,
@@ -199,31 +406,174 @@ std::vector<int64_t> prepare_init_tokens(ov::Tensor& encoder_hidden_state,
         language_token_id = detect_language(encoder_hidden_state, decoder, config, raw_metrics);
     }
 
-    int64_t task_token_id = config.transcribe_token_id;
-    if (config.task.has_value() && *config.task == "translate") {
-        task_token_id = config.translate_token_id;
+    return get_init_tokens(config, return_timestamps, language_token_id);
+}
+
+// adds one entry per prediction of a speculative step as token by token decoding does, so that entries stay aligned
+// with output tokens. The step duration includes draft infers
+void add_step_metrics(ov::genai::RawPerfMetrics& raw_metrics,
+                      const MicroSeconds step_duration,
+                      const std::chrono::steady_clock::time_point step_end,
+                      const size_t n_predictions) {
+    raw_metrics.m_inference_durations[0] += step_duration;
+    for (size_t i = 0; i < n_predictions; ++i) {
+        raw_metrics.m_token_infer_durations.emplace_back(step_duration.count() / n_predictions);
+        raw_metrics.m_new_token_times.emplace_back(step_end);
+        raw_metrics.m_batch_sizes.emplace_back(1);
     }
+}
 
-    if (return_timestamps) {
-        return std::vector<int64_t>{config.decoder_start_token_id, language_token_id, task_token_id};
+// Continues greedy decoding by speculative steps. The draft decoder proposes up to config.num_assistant_tokens
+// tokens, which decoder_with_past verifies by one infer with the same encoder hidden state. Proposals are accepted
+// up to the first one, which differs from the argmax of verification, and this argmax is taken instead, so that the
+// output is the same as of greedy decoding. KV-cache of rejected proposals is cut off. decoder_with_past holds
+// KV-cache of init_ids and output_tokens except the last one.
+// @return true if the streamer requested to stop
+bool speculative_decode(ov::Tensor& encoder_hidden_state,
+                        const ov::genai::WhisperGenerationConfig& config,
+                        ov::genai::WhisperInitializedModels& models,
+                        const std::vector<int64_t>& init_ids,
+                        std::vector<int64_t>& output_tokens,
+                        const size_t max_new_tokens,
+                        const bool return_timestamps,
+                        ov::genai::RawPerfMetrics& raw_metrics,
+                        const std::shared_ptr<ov::genai::StreamerBase> streamer,
+                        std::vector<std::vector<float>>* attention_rows) {
+    ov::InferRequest& draft_decoder_with_past = *models.draft_decoder_with_past;
+    // the draft KV-cache holds the first n_draft_cached tokens
+    std::vector<int64_t> tokens = init_ids;
+    tokens.insert(tokens.end(), output_tokens.begin(), output_tokens.end());
+    size_t n_draft_cached = 0;
+
+    while (output_tokens.size() < max_new_tokens) {
+        const auto step_start = std::chrono::steady_clock::now();
+
+        // the verification of n_proposals tokens predicts one more token
+        const size_t n_proposals = std::min(config.num_assistant_tokens, max_new_tokens - output_tokens.size() - 1);
+        std::vector<int64_t> proposals;
+        std::vector<int64_t> generated_tokens = output_tokens;
+        while (proposals.size() < n_proposals) {
+            // the first proposal catches up with tokens, which are not passed to the draft yet
+            std::vector<int64_t> input_ids(tokens.begin() + n_draft_cached, tokens.end());
+            if (!proposals.empty()) {
+                input_ids = {proposals.back()};
+            }
+            ov::InferRequest& draft = n_draft_cached == 0 ? *models.draft_decoder : draft_decoder_with_past;
+            std::optional<size_t> cache_position;
+            if (n_draft_cached > 0) {
+                cache_position = n_draft_cached;
+            }
+            set_decoder_inputs(encoder_hidden_state, draft, input_ids, cache_position);
+            draft.infer();
+            n_draft_cached += input_ids.size();
+            set_past_key_value(draft, draft_decoder_with_past);
+
+            auto logits = draft.get_tensor("logits");
+            ov::genai::process_whisper_logits(logits, 0, config, generated_tokens, return_timestamps);
+            const int64_t proposal = ov::genai::utils::argmax(logits, 0);
+            proposals.push_back(proposal);
+            generated_tokens.push_back(proposal);
+            if (proposal == config.eos_token_id) {
+                break;
+            }
+        }
+
+        std::vector<int64_t> input_ids{tokens.back()};
+        input_ids.insert(input_ids.end(), proposals.begin(), proposals.end());
+        set_decoder_inputs(encoder_hidden_state, models.decoder_with_past, input_ids, tokens.size() - 1);
+        models.decoder_with_past.infer();
+        const auto step_end = std::chrono::steady_clock::now();
+
+        // position i predicts the token after proposals[i - 1]
+        auto logits = models.decoder_with_past.get_tensor("logits");
+        const size_t vocab_size = logits.get_shape().back();
+        size_t n_predictions = 0;
+        bool is_finished = false;
+        bool cancelled = false;
+        while (n_predictions < input_ids.size()) {
+            ov::Tensor position_logits(ov::element::f32,
+                                       {1, 1, vocab_size},
+                                       logits.data<float>() + n_predictions * vocab_size);
+            ov::genai::process_whisper_logits(position_logits, 0, config, output_tokens, return_timestamps);
+            const int64_t output_token = ov::genai::utils::argmax(position_logits, 0);
+
+            // the row predicting eos ends the last token
+            if (attention_rows) {
+                collect_attention_row(models.decoder_with_past, *attention_rows, n_predictions);
+            }
+            ++n_predictions;
+
+            if (output_token == config.eos_token_id) {
+                is_finished = true;
+                break;
+            }
+
+            output_tokens.push_back(output_token);
+            tokens.push_back(output_token);
+
+            if (!return_timestamps && streamer && streamer->put(output_token)) {
+                cancelled = true;
+                break;
+            }
+
+            if (n_predictions == input_ids.size() || output_token != proposals[n_predictions - 1]) {
+                break;
+            }
+        }
+
+        // predictions after a rejected proposal are not counted
+        add_step_metrics(raw_metrics,
+                         MicroSeconds(ov::genai::PerfMetrics::get_microsec(step_end - step_start)),
+                         step_end,
+                         n_predictions);
+        if (cancelled) {
+            return true;
+        }
+        if (is_finished) {
+            break;
+        }
+
+        // tokens except the last one are kept in KV-cache
+        set_past_key_value(models.decoder_with_past, models.decoder_with_past);
+        trim_past_key_value(models.decoder_with_past, tokens.size() - 1);
+        if (n_draft_cached > tokens.size() - 1) {
+            n_draft_cached = tokens.size() - 1;
+            trim_past_key_value(draft_decoder_with_past, n_draft_cached);
+        }
     }
 
-    return std::vector<int64_t>{config.decoder_start_token_id,
-                                language_token_id,
-                                task_token_id,
-                                config.no_timestamps_token_id};
+    return false;
 }
 
-std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_state,
-                                                  const ov::genai::WhisperGenerationConfig& config,
-                                                  ov::genai::WhisperInitializedModels& models,
-                                                  std::vector<int64_t> init_ids,
-                                                  const size_t max_new_tokens,
-                                                  const bool return_timestamps,
-                                                  ov::genai::RawPerfMetrics& raw_metrics,
-                                                  const std::shared_ptr<ov::genai::StreamerBase> streamer) {
-    int64_t output_token =
-        decode(encoder_hidden_state, models.decoder, init_ids, config, raw_metrics, true, return_timestamps);
+std::pair<bool, std::vector<int64_t>> greedy_decode(ov::Tensor& encoder_hidden_state,
+                                                    const ov::genai::WhisperGenerationConfig& config,
+                                                    ov::genai::WhisperInitializedModels& models,
+                                                    std::vector<int64_t> init_ids,
+                                                    const size_t max_new_tokens,
+                                                    const bool return_timestamps,
+                                                    ov::genai::RawPerfMetrics& raw_metrics,
+                                                    const std::shared_ptr<ov::genai::StreamerBase> streamer,
+                                                    std::vector<std::vector<float>>* attention_rows,
+                                                    const size_t n_cached_init_ids) {
+    int64_t output_token;
+    if (n_cached_init_ids > 0) {
+        // the decoder holds KV-cache of the first init_ids, e.g. of the start token after language detection
+        set_past_key_value(models.decoder, models.decoder_with_past);
+        output_token = decode_init_with_past(encoder_hidden_state,
+                                             models.decoder_with_past,
+                                             init_ids,
+                                             n_cached_init_ids,
+                                             config,
+                                             raw_metrics,
+                                             return_timestamps);
+    } else {
+        output_token =
+            decode(encoder_hidden_state, models.decoder, init_ids, config, raw_metrics, true, return_timestamps);
+    }
+    ov::InferRequest& first_request = n_cached_init_ids > 0 ? models.decoder_with_past : models.decoder;
+    if (attention_rows) {
+        collect_attention_row(first_request, *attention_rows);
+    }
 
     std::vector<int64_t> output_tokens{output_token};
 
@@ -235,7 +585,21 @@ std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_sta
         return {false, output_tokens};
     }
 
-    set_past_key_value(models.decoder, models.decoder_with_past);
+    set_past_key_value(first_request, models.decoder_with_past);
+
+    if (models.draft_decoder.has_value()) {
+        const bool cancelled = speculative_decode(encoder_hidden_state,
+                                                  config,
+                                                  models,
+                                                  init_ids,
+                                                  output_tokens,
+                                                  max_new_tokens,
+                                                  return_timestamps,
+                                                  raw_metrics,
+                                                  streamer,
+                                                  attention_rows);
+        return {cancelled, output_tokens};
+    }
 
     for (size_t i = 0; i < max_new_tokens - 1; i++) {
         auto output_token = decode_with_past(encoder_hidden_state,
@@ -251,6 +615,11 @@ std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_sta
             set_past_key_value(models.decoder_with_past, models.decoder_with_past);
         }
 
+        // the row predicting eos ends the last token
+        if (attention_rows) {
+            collect_attention_row(models.decoder_with_past, *attention_rows);
+        }
+
         if (output_token == config.eos_token_id) {
             break;
         }
@@ -265,6 +634,425 @@ std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_sta
     return {false, output_tokens};
 }
 
+struct DecodingCandidate {
+    std::vector<int64_t> tokens;
+    // includes log probability of eos for finished candidates
+    float sum_logprob = 0.0f;
+};
+
+float get_score(const DecodingCandidate& candidate, const float length_penalty) {
+    const float length = static_cast<float>(std::max<size_t>(candidate.tokens.size(), 1));
+    return candidate.sum_logprob / std::pow(length, length_penalty);
+}
+
+// number of tokens divided by the number of phrases of their greedy LZ77 parsing, where each phrase is the longest
+// match starting earlier or a single token
+float get_compression_ratio(const std::vector<int64_t>& tokens) {
+    if (tokens.empty()) {
+        return 1.0f;
+    }
+
+    size_t n_phrases = 0;
+    for (size_t position = 0; position < tokens.size(); ++n_phrases) {
+        size_t longest_match = 1;
+        for (size_t start = 0; start < position; ++start) {
+            size_t length = 0;
+            while (position + length < tokens.size() && tokens[start + length] == tokens[position + length]) {
+                ++length;
+            }
+            longest_match = std::max(longest_match, length);
+        }
+        position += longest_match;
+    }
+    return static_cast<float>(tokens.size()) / n_phrases;
+}
+
+bool needs_fallback(const DecodingCandidate& candidate, const ov::genai::WhisperGenerationConfig& config) {
+    if (config.compression_ratio_threshold.has_value() &&
+        get_compression_ratio(candidate.tokens) > *config.compression_ratio_threshold) {
+        return true;
+    }
+
+    if (config.logprob_threshold.has_value() &&
+        candidate.sum_logprob / (candidate.tokens.size() + 1) < *config.logprob_threshold) {
+        return true;
+    }
+
+    return false;
+}
+
+// log probabilities of the last position of a batch row
+std::vector<float> get_logprobs(const ov::Tensor& logits, const size_t batch_idx) {
+    const size_t seq_len = logits.get_shape()[1];
+    const size_t vocab_size = logits.get_shape().back();
+    const float* logits_data = logits.data<const float>() + (batch_idx * seq_len + seq_len - 1) * vocab_size;
+
+    const float max_logit = *std::max_element(logits_data, logits_data + vocab_size);
+    double sum_exp = 0.0;
+    for (size_t i = 0; i < vocab_size; ++i) {
+        sum_exp += std::exp(logits_data[i] - max_logit);
+    }
+    const float log_sum_exp = max_logit + static_cast<float>(std::log(sum_exp));
+
+    std::vector<float> logprobs(vocab_size);
+    for (size_t i = 0; i < vocab_size; ++i) {
+        logprobs[i] = logits_data[i] - log_sum_exp;
+    }
+    return logprobs;
+}
+
+// samples from softmax(logits / temperature), which equals softmax(logprobs / temperature)
+int64_t sample(const std::vector<float>& logprobs, const float temperature, std::mt19937_64& rng) {
+    const float max_logprob = *std::max_element(logprobs.begin(), logprobs.end());
+    std::vector<double> cumulative_weights(logprobs.size());
+    double total_weight = 0.0;
+    for (size_t i = 0; i < logprobs.size(); ++i) {
+        total_weight += std::exp((logprobs[i] - max_logprob) / temperature);
+        cumulative_weights[i] = total_weight;
+    }
+
+    const double threshold = std::uniform_real_distribution<double>(0.0, total_weight)(rng);
+    const auto it = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), threshold);
+    return std::min<int64_t>(it - cumulative_weights.begin(), logprobs.size() - 1);
+}
+
+// Selects tokens of beams from (num_beams + 1) best continuations of each beam. Eos continuations finish candidates,
+// so that beams stay filled. Returns true once num_beams candidates are finished.
+bool select_beams(const ov::Tensor& logits,
+                  std::vector<DecodingCandidate>& beams,
+                  std::vector<size_t>& parents,
+                  std::vector<DecodingCandidate>& finished,
+                  const ov::genai::WhisperGenerationConfig& config,
+                  const size_t max_new_tokens) {
+    const size_t num_beams = config.num_beams;
+
+    struct Continuation {
+        float sum_logprob;
+        size_t parent;
+        int64_t token;
+    };
+    std::vector<Continuation> continuations;
+    for (size_t beam = 0; beam < beams.size(); ++beam) {
+        const auto logprobs = get_logprobs(logits, beam);
+        const size_t top_k = std::min(num_beams + 1, logprobs.size());
+        std::vector<int64_t> top_tokens(logprobs.size());
+        std::iota(top_tokens.begin(), top_tokens.end(), 0);
+        std::partial_sort(top_tokens.begin(), top_tokens.begin() + top_k, top_tokens.end(), [&](int64_t a, int64_t b) {
+            return logprobs[a] > logprobs[b];
+        });
+        for (size_t i = 0; i < top_k; ++i) {
+            const float logprob = logprobs[top_tokens[i]];
+            if (logprob != -std::numeric_limits<float>::infinity()) {
+                continuations.push_back({beams[beam].sum_logprob + logprob, beam, top_tokens[i]});
+            }
+        }
+    }
+    std::sort(continuations.begin(), continuations.end(), [](const Continuation& a, const Continuation& b) {
+        return a.sum_logprob > b.sum_logprob;
+    });
+
+    std::vector<DecodingCandidate> next_beams;
+    parents.clear();
+    for (const auto& continuation : continuations) {
+        if (continuation.token == config.eos_token_id) {
+            if (finished.size() < num_beams) {
+                finished.push_back({beams[continuation.parent].tokens, continuation.sum_logprob});
+            }
+            continue;
+        }
+
+        next_beams.push_back({beams[continuation.parent].tokens, continuation.sum_logprob});
+        next_beams.back().tokens.push_back(continuation.token);
+        parents.push_back(continuation.parent);
+        if (next_beams.size() == num_beams) {
+            break;
+        }
+    }
+
+    if (finished.size() >= num_beams || next_beams.empty()) {
+        return true;
+    }
+
+    if (next_beams.front().tokens.size() >= max_new_tokens) {
+        finished.insert(finished.end(), next_beams.begin(), next_beams.end());
+        return true;
+    }
+
+    // the batch size is kept, if there were not enough continuations
+    while (next_beams.size() < num_beams) {
+        next_beams.push_back(next_beams.front());
+        parents.push_back(parents.front());
+    }
+    beams = std::move(next_beams);
+    return false;
+}
+
+// Samples the next token of each unfinished row independently. Returns true once all rows are finished.
+bool sample_rows(const ov::Tensor& logits,
+                 std::vector<DecodingCandidate>& rows,
+                 std::vector<bool>& is_row_finished,
+                 std::vector<DecodingCandidate>& finished,
+                 const ov::genai::WhisperGenerationConfig& config,
+                 const float temperature,
+                 const size_t max_new_tokens,
+                 std::mt19937_64& rng) {
+    bool all_finished = true;
+    for (size_t row = 0; row < rows.size(); ++row) {
+        if (is_row_finished[row]) {
+            continue;
+        }
+
+        const auto logprobs = get_logprobs(logits, logits.get_shape()[0] == 1 ? 0 : row);
+        const int64_t token = sample(logprobs, temperature, rng);
+        rows[row].sum_logprob += logprobs[token];
+
+        if (token == config.eos_token_id) {
+            is_row_finished[row] = true;
+            finished.push_back(rows[row]);
+            continue;
+        }
+
+        rows[row].tokens.push_back(token);
+        if (rows[row].tokens.size() >= max_new_tokens) {
+            is_row_finished[row] = true;
+            finished.push_back(rows[row]);
+            continue;
+        }
+        all_finished = false;
+    }
+    return all_finished;
+}
+
+// Decodes num_beams rows of one batch of the decoder with past, which continue the first decoder infer.
+// Zero temperature runs beam search, otherwise rows are sampled independently. The best finished candidate is returned.
+DecodingCandidate decode_candidates(ov::Tensor& encoder_hidden_state,
+                                    const ov::genai::WhisperGenerationConfig& config,
+                                    ov::genai::WhisperInitializedModels& models,
+                                    const size_t init_size,
+                                    const std::vector<float>& first_logits,
+                                    const float temperature,
+                                    const size_t max_new_tokens,
+                                    const bool return_timestamps,
+                                    std::mt19937_64& rng,
+                                    ov::genai::RawPerfMetrics& raw_metrics) {
+    const size_t n_rows = config.num_beams;
+    const bool is_sampling = temperature > 0.0f;
+
+    ov::Tensor logits(ov::element::f32, {1, 1, first_logits.size()});
+    std::copy(first_logits.begin(), first_logits.end(), logits.data<float>());
+    ov::genai::process_whisper_logits(logits, 0, config, {}, return_timestamps, true);
+
+    // all rows continue the single row of the first infer
+    std::vector<DecodingCandidate> rows(is_sampling ? n_rows : 1);
+    std::vector<bool> is_row_finished(n_rows, false);
+    std::vector<size_t> parents(n_rows, 0);
+    std::vector<DecodingCandidate> finished;
+
+    ov::Tensor hidden_state_rows;
+    ov::Tensor step_ids_tensor(ov::element::i64, {n_rows, 1});
+    int64_t* step_ids = step_ids_tensor.data<int64_t>();
+
+    for (size_t step = 0;; ++step) {
+        const bool is_done =
+            is_sampling
+                ? sample_rows(logits, rows, is_row_finished, finished, config, temperature, max_new_tokens, rng)
+                : select_beams(logits, rows, parents, finished, config, max_new_tokens);
+        if (is_done) {
+            break;
+        }
+
+        if (step == 0) {
+            set_past_key_value(models.decoder, models.decoder_with_past, parents);
+            hidden_state_rows = select_rows(encoder_hidden_state, parents);
+        } else if (is_sampling) {
+            // rows are independent, so KV-cache outputs are bound to inputs as is
+            if (step == 1) {
+                set_past_key_value(models.decoder_with_past, models.decoder_with_past);
+            }
+        } else {
+            set_past_key_value(models.decoder_with_past, models.decoder_with_past, parents);
+        }
+
+        for (size_t row = 0; row < n_rows; ++row) {
+            step_ids[row] = rows[row].tokens.empty() ? config.eos_token_id : rows[row].tokens.back();
+        }
+
+        models.decoder_with_past.set_tensor("encoder_hidden_states", ov::Tensor{hidden_state_rows});
+        models.decoder_with_past.set_tensor("input_ids", step_ids_tensor);
+
+        ov::Tensor cache_position_tensor = models.decoder_with_past.get_tensor("cache_position");
+        cache_position_tensor.set_shape({1});
+        cache_position_tensor.data<int64_t>()[0] = init_size + step;
+
+        infer_with_perf_metrics(models.decoder_with_past, raw_metrics, n_rows);
+
+        logits = models.decoder_with_past.get_tensor("logits");
+        for (size_t row = 0; row < n_rows; ++row) {
+            if (is_row_finished[row]) {
+                continue;
+            }
+            ov::genai::process_whisper_logits(logits, row, config, rows[row].tokens, return_timestamps);
+        }
+    }
+
+    if (finished.empty()) {
+        finished = rows;
+    }
+    return *std::max_element(finished.begin(),
+                             finished.end(),
+                             [&](const DecodingCandidate& a, const DecodingCandidate& b) {
+                                 return get_score(a, config.length_penalty) < get_score(b, config.length_penalty);
+                             });
+}
+
+// keeps entries of the first infer and of the chosen attempt, so that each output token has a single entry
+template <typename T>
+void keep_attempt_metrics(std::vector<T>& value, size_t offset, size_t attempt_offset, size_t n_tokens) {
+    const size_t attempt_end = std::min(value.size(), attempt_offset + (n_tokens > 0 ? n_tokens - 1 : 0));
+    value.erase(value.begin() + attempt_end, value.end());
+    value.erase(value.begin() + offset + std::min<size_t>(n_tokens, 1), value.begin() + attempt_offset);
+}
+
+bool is_greedy_decoding(const ov::genai::WhisperGenerationConfig& config) {
+    return config.num_beams == 1 && config.temperatures.size() == 1 && config.temperatures[0] == 0.0f;
+}
+
+// Decodes a window by beam search or sampling at config.temperatures in order, until the result passes the fallback
+// thresholds. The first decoder infer over init_ids is shared by all attempts. Cross-attention rows of output tokens
+// are collected by greedy decoding only, which also continues KV-cache of the first n_cached_init_ids left by the
+// decoder, other decoding recomputes it.
+std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_state,
+                                                  const ov::genai::WhisperGenerationConfig& config,
+                                                  ov::genai::WhisperInitializedModels& models,
+                                                  std::vector<int64_t> init_ids,
+                                                  const size_t max_new_tokens,
+                                                  const bool return_timestamps,
+                                                  ov::genai::RawPerfMetrics& raw_metrics,
+                                                  const std::shared_ptr<ov::genai::StreamerBase> streamer,
+                                                  std::vector<std::vector<float>>* attention_rows = nullptr,
+                                                  const size_t n_cached_init_ids = 0) {
+    if (is_greedy_decoding(config)) {
+        return greedy_decode(encoder_hidden_state,
+                             config,
+                             models,
+                             init_ids,
+                             max_new_tokens,
+                             return_timestamps,
+                             raw_metrics,
+                             streamer,
+                             attention_rows,
+                             n_cached_init_ids);
+    }
+    OPENVINO_ASSERT(!attention_rows, "Word timestamps require greedy decoding");
+
+    const size_t metrics_offset = raw_metrics.m_token_infer_durations.size();
+
+    models.decoder.set_tensor("encoder_hidden_states", ov::Tensor{encoder_hidden_state});
+    ov::Tensor input_ids_tensor(ov::element::i64, {1, init_ids.size()}, init_ids.data());
+    models.decoder.set_tensor("input_ids", input_ids_tensor);
+    infer_with_perf_metrics(models.decoder, raw_metrics);
+
+    const ov::Tensor logits = models.decoder.get_tensor("logits");
+    const size_t vocab_size = logits.get_shape().back();
+    const float* last_logits = logits.data<const float>() + (logits.get_shape()[1] - 1) * vocab_size;
+    const std::vector<float> first_logits(last_logits, last_logits + vocab_size);
+
+    std::mt19937_64 rng{config.rng_seed};
+    DecodingCandidate result;
+    size_t result_metrics_offset = metrics_offset + 1;
+    for (const float temperature : config.temperatures) {
+        result_metrics_offset = raw_metrics.m_token_infer_durations.size();
+        result = decode_candidates(encoder_hidden_state,
+                                   config,
+                                   models,
+                                   init_ids.size(),
+                                   first_logits,
+                                   temperature,
+                                   max_new_tokens,
+                                   return_timestamps,
+                                   rng,
+                                   raw_metrics);
+        if (!needs_fallback(result, config)) {
+            break;
+        }
+    }
+
+    const size_t n_tokens = result.tokens.size();
+    keep_attempt_metrics(raw_metrics.m_token_infer_durations, metrics_offset, result_metrics_offset, n_tokens);
+    keep_attempt_metrics(raw_metrics.m_new_token_times, metrics_offset, result_metrics_offset, n_tokens);
+    keep_attempt_metrics(raw_metrics.m_batch_sizes, metrics_offset, result_metrics_offset, n_tokens);
+
+    if (!return_timestamps && streamer) {
+        for (size_t i = 0; i < n_tokens; ++i) {
+            if (streamer->put(result.tokens[i])) {
+                result.tokens.resize(i + 1);
+                return {true, result.tokens};
+            }
+        }
+    }
+
+    return {false, result.tokens};
+}
+
+// window timestamps are relative to the window start
+void offset_segments(std::vector<ov::genai::Segment>& segments, const float time_offset) {
+    for (auto& segment : segments) {
+        segment.m_start += time_offset;
+        if (segment.m_end >= 0.0f) {
+            segment.m_end += time_offset;
+        }
+    }
+}
+
+void map_to_original_time(std::vector<ov::genai::Segment>& segments, const ov::genai::SpeechRegions& speech_regions) {
+    for (auto& segment : segments) {
+        segment.m_start = speech_regions.to_original_time(segment.m_start, false);
+        segment.m_end = speech_regions.to_original_time(segment.m_end, true);
+    }
+}
+
+// timestamps of window tokens relative to the window start. Text tokens are aligned to encoder frames by DTW over
+// cross-attention rows, timestamp tokens keep zero times and are filtered out with them
+std::vector<ov::genai::TokenTimestamp> align_window_tokens(const std::vector<int64_t>& tokens,
+                                                           std::vector<std::vector<float>>& attention_rows,
+                                                           const ov::genai::WhisperGenerationConfig& config,
+                                                           const size_t n_frames,
+                                                           const size_t n_valid_frames,
+                                                           const float time_precision) {
+    std::vector<ov::genai::TokenTimestamp> timestamps(tokens.size());
+    const int64_t timestamp_begin = config.no_timestamps_token_id + 1;
+
+    std::vector<size_t> text_indices;
+    std::vector<std::vector<float>> text_rows;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        timestamps[i] = {tokens[i], 0.0f, 0.0f};
+        if (tokens[i] < timestamp_begin && tokens[i] != config.eos_token_id && i < attention_rows.size()) {
+            text_indices.push_back(i);
+            text_rows.push_back(std::move(attention_rows[i]));
+        }
+    }
+    if (text_indices.empty()) {
+        return timestamps;
+    }
+    const bool has_eos_row = attention_rows.size() > tokens.size();
+    if (has_eos_row) {
+        text_rows.push_back(std::move(attention_rows[tokens.size()]));
+    }
+
+    const size_t n_heads = text_rows[0].size() / n_frames;
+    const ov::genai::TokenAlignment alignment = ov::genai::align_tokens(text_rows, n_heads, n_frames, n_valid_frames);
+
+    for (size_t k = 0; k < text_indices.size(); ++k) {
+        // a token lasts until the next token starts
+        const size_t end_frame = k + 1 < text_rows.size() ? alignment.begins[k + 1] : alignment.ends[k];
+        auto& timestamp = timestamps[text_indices[k]];
+        timestamp.m_start = alignment.begins[k] * time_precision;
+        timestamp.m_end = std::max(end_frame, alignment.begins[k]) * time_precision;
+    }
+
+    return timestamps;
+}
+
 template <typename T>
 void filter_by_ranges(std::vector<T>& value, size_t offset, std::vector<std::pair<size_t, size_t>>& ranges) {
     OPENVINO_ASSERT(ranges.empty() || value.size() >= (offset + ranges.back().second));
@@ -284,18 +1072,172 @@ void filter_non_segment_metrics(ov::genai::RawPerfMetrics& raw_metrics,
     filter_by_ranges(raw_metrics.m_batch_sizes, offset, ranges);
 }
 
+ov::Tensor encode_batch(ov::InferRequest& request,
+                        const std::vector<std::vector<float>>& mel_data,
+                        const size_t feature_size,
+                        const size_t nb_max_frames,
+                        ov::genai::RawPerfMetrics& raw_metrics) {
+    const size_t batch_size = mel_data.size();
+    ov::Tensor input_tensor(ov::element::f32, {batch_size, feature_size, nb_max_frames});
+    for (size_t row = 0; row < batch_size; ++row) {
+        OPENVINO_ASSERT(mel_data[row].size() == feature_size * nb_max_frames,
+                        "Mel spectrogram required size: ",
+                        feature_size,
+                        " * ",
+                        nb_max_frames,
+                        ". Actual size: ",
+                        mel_data[row].size(),
+                        ".");
+        std::copy(mel_data[row].begin(),
+                  mel_data[row].end(),
+                  input_tensor.data<float>() + row * feature_size * nb_max_frames);
+    }
+
+    request.set_tensor("input_features", input_tensor);
+
+    const auto infer_start = std::chrono::steady_clock::now();
+    request.infer();
+    const auto infer_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - infer_start);
+    raw_metrics.m_inference_durations[0] += MicroSeconds(infer_ms);
+
+    // reset input tensor
+    request.set_tensor("input_features", ov::Tensor(ov::element::f32, {0, feature_size, nb_max_frames}));
+
+    return request.get_tensor("last_hidden_state");
+}
+
+std::vector<int64_t> detect_languages(ov::Tensor& encoder_hidden_state,
+                                      ov::InferRequest& decoder,
+                                      const ov::genai::WhisperGenerationConfig& config,
+                                      ov::genai::RawPerfMetrics& raw_metrics) {
+    const size_t batch_size = encoder_hidden_state.get_shape()[0];
+    decoder.set_tensor("encoder_hidden_states", ov::Tensor{encoder_hidden_state});
+
+    std::vector<int64_t> input_ids(batch_size, config.decoder_start_token_id);
+    ov::Tensor input_ids_tensor(ov::element::i64, {batch_size, 1}, input_ids.data());
+    decoder.set_tensor("input_ids", input_ids_tensor);
+
+    const auto infer_start = std::chrono::steady_clock::now();
+    decoder.infer();
+    const auto infer_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - infer_start);
+    raw_metrics.m_inference_durations[0] += MicroSeconds(infer_ms);
+
+    auto output_tensor = decoder.get_tensor("logits");
+
+    std::vector<int64_t> language_token_ids(batch_size);
+    for (size_t row = 0; row < batch_size; ++row) {
+        language_token_ids[row] = get_language_token(output_tensor, row, config);
+    }
+    return language_token_ids;
+}
+
+// full_decode() of several windows with init_ids of the same length at once. Rows, which generated eos or
+// their max_new_tokens, are fed with their last token until all rows finish, their outputs are ignored.
+std::vector<std::vector<int64_t>> full_decode_batch(ov::Tensor& encoder_hidden_state,
+                                                    const ov::genai::WhisperGenerationConfig& config,
+                                                    ov::genai::WhisperInitializedModels& models,
+                                                    const std::vector<std::vector<int64_t>>& init_ids,
+                                                    const std::vector<size_t>& max_new_tokens,
+                                                    const std::vector<bool>& return_timestamps,
+                                                    ov::genai::RawPerfMetrics& raw_metrics) {
+    const size_t batch_size = init_ids.size();
+    const size_t init_size = init_ids[0].size();
+
+    ov::Tensor input_ids_tensor(ov::element::i64, {batch_size, init_size});
+    for (size_t row = 0; row < batch_size; ++row) {
+        OPENVINO_ASSERT(init_ids[row].size() == init_size, "Batched windows must have init tokens of the same length");
+        std::copy(init_ids[row].begin(), init_ids[row].end(), input_ids_tensor.data<int64_t>() + row * init_size);
+    }
+
+    models.decoder.set_tensor("encoder_hidden_states", ov::Tensor{encoder_hidden_state});
+    models.decoder.set_tensor("input_ids", input_ids_tensor);
+    infer_with_perf_metrics(models.decoder, raw_metrics, batch_size);
+
+    auto logits = models.decoder.get_tensor("logits");
+
+    std::vector<std::vector<int64_t>> output_tokens(batch_size);
+    std::vector<bool> finished(batch_size);
+    size_t n_finished = 0;
+    for (size_t row = 0; row < batch_size; ++row) {
+        ov::genai::process_whisper_logits(logits, row, config, {}, return_timestamps[row], true);
+        output_tokens[row].push_back(ov::genai::utils::argmax(logits, row));
+
+        if (max_new_tokens[row] <= 1) {
+            finished[row] = true;
+            ++n_finished;
+        }
+    }
+
+    if (n_finished == batch_size) {
+        return output_tokens;
+    }
+
+    set_past_key_value(models.decoder, models.decoder_with_past);
+
+    ov::Tensor step_ids_tensor(ov::element::i64, {batch_size, 1});
+    int64_t* step_ids = step_ids_tensor.data<int64_t>();
+
+    for (size_t i = 0; n_finished < batch_size; i++) {
+        for (size_t row = 0; row < batch_size; ++row) {
+            step_ids[row] = output_tokens[row].back();
+        }
+
+        models.decoder_with_past.set_tensor("encoder_hidden_states", ov::Tensor{encoder_hidden_state});
+        models.decoder_with_past.set_tensor("input_ids", step_ids_tensor);
+
+        ov::Tensor cache_position_tensor = models.decoder_with_past.get_tensor("cache_position");
+        cache_position_tensor.set_shape({1});
+        cache_position_tensor.data<int64_t>()[0] = init_size + i;
+
+        infer_with_perf_metrics(models.decoder_with_past, raw_metrics, batch_size - n_finished);
+
+        if (i == 0) {
+            set_past_key_value(models.decoder_with_past, models.decoder_with_past);
+        }
+
+        auto step_logits = models.decoder_with_past.get_tensor("logits");
+        for (size_t row = 0; row < batch_size; ++row) {
+            if (finished[row]) {
+                continue;
+            }
+
+            ov::genai::process_whisper_logits(step_logits, row, config, output_tokens[row], return_timestamps[row]);
+            const int64_t output_token = ov::genai::utils::argmax(step_logits, row);
+
+            if (output_token == config.eos_token_id) {
+                finished[row] = true;
+                ++n_finished;
+                continue;
+            }
+
+            output_tokens[row].push_back(output_token);
+            if (output_tokens[row].size() >= max_new_tokens[row]) {
+                finished[row] = true;
+                ++n_finished;
+            }
+        }
+    }
+
+    return output_tokens;
+}
+
 }  // namespace
 
 namespace ov {
 namespace genai {
 
-WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig& config,
-                                       const ov::genai::WhisperConfig& model_config,
-                                       const WhisperContextTokens& context_tokens,
-                                       const RawSpeechInput& raw_speech,
-                                       ov::genai::WhisperInitializedModels& models,
-                                       WhisperFeatureExtractor& feature_extractor,
-                                       const std::shared_ptr<ChunkStreamerBase> streamer) {
+namespace {
+
+// Extracts features of the input, speech_regions are set if silent regions are cut off. std::nullopt means no speech
+using FeaturesSource = std::function<std::optional<WhisperFeatures>(std::optional<SpeechRegions>& speech_regions)>;
+
+WhisperGenerateResult generate_from_features(const ov::genai::WhisperGenerationConfig& config,
+                                             const ov::genai::WhisperConfig& model_config,
+                                             const WhisperContextTokens& context_tokens,
+                                             const FeaturesSource& extract_features,
+                                             ov::genai::WhisperInitializedModels& models,
+                                             WhisperFeatureExtractor& feature_extractor,
+                                             const std::shared_ptr<ChunkStreamerBase> streamer) {
     size_t max_new_tokens = config.get_max_new_tokens();
 
     WhisperGenerateResult result;
@@ -307,9 +1249,23 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
     raw_metrics.m_inference_durations = {{MicroSeconds(0.0f)}};
 
     const auto infer_start = std::chrono::steady_clock::now();
-    auto input_features = feature_extractor.extract(raw_speech);
+    std::optional<SpeechRegions> speech_regions;
+    std::optional<WhisperFeatures> extracted_features = extract_features(speech_regions);
     const auto infer_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - infer_start);
     result.perf_metrics.whisper_raw_metrics.features_extraction_durations.emplace_back(infer_ms);
+    if (!extracted_features.has_value()) {
+        if (streamer) {
+            streamer->end();
+        }
+        if (config.return_timestamps) {
+            result.segments = std::vector<Segment>{};
+        }
+        if (config.word_timestamps) {
+            result.token_timestamps = std::vector<TokenTimestamp>{};
+        }
+        return result;
+    }
+    WhisperFeatures& input_features = *extracted_features;
 
     const bool is_shortform = input_features.n_frames <= feature_extractor.nb_max_frames;
     // long-form audio processing requires timestamps to be enabled
@@ -318,33 +1274,77 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
     std::vector<int64_t> init_tokens;
     std::vector<int64_t>& output_tokens = result.output_tokens;
     std::vector<Segment> segments;
+    std::vector<TokenTimestamp> token_timestamps;
 
     // 0.02 by default
     const float time_precision = static_cast<float>(feature_extractor.chunk_length) / model_config.max_source_positions;
+    const float frame_duration = static_cast<float>(feature_extractor.hop_length) / feature_extractor.sampling_rate;
     size_t segment_offset = 0;
 
+    // the next window is encoded at the nominal offset of a full window, while the current one is decoded, and it is
+    // encoded again, if timestamps move the window
+    const bool is_encoder_pipelined = models.pipelined_encoder.has_value() && !is_shortform;
+    std::vector<float> pipelined_features_chunk;
+    std::optional<size_t> pipelined_offset;
+
     for (size_t chunk_offset = 0; chunk_offset < input_features.n_frames; chunk_offset += segment_offset) {
         if (output_tokens.size() >= max_new_tokens) {
             break;
         }
 
-        auto input_features_chunk = input_features.get_data_with_offset(chunk_offset, feature_extractor.nb_max_frames);
+        ov::Tensor hidden_state_tensor;
+        if (pipelined_offset == chunk_offset) {
+            hidden_state_tensor = wait_encode(*models.pipelined_encoder,
+                                              feature_extractor.feature_size,
+                                              feature_extractor.nb_max_frames,
+                                              raw_metrics);
+            // the request holding hidden_state_tensor must not encode the next window
+            std::swap(models.encoder, *models.pipelined_encoder);
+        } else {
+            if (pipelined_offset.has_value()) {
+                models.pipelined_encoder->wait();
+            }
 
-        ov::Tensor hidden_state_tensor = encode(models.encoder,
-                                                input_features_chunk,
-                                                feature_extractor.feature_size,
-                                                feature_extractor.nb_max_frames,
-                                                raw_metrics);
+            auto input_features_chunk =
+                input_features.get_data_with_offset(chunk_offset, feature_extractor.nb_max_frames);
+
+            set_hidden_state_output(models.encoder, models, 1);
+            hidden_state_tensor = encode(models.encoder,
+                                         input_features_chunk,
+                                         feature_extractor.feature_size,
+                                         feature_extractor.nb_max_frames,
+                                         raw_metrics);
+        }
+        pipelined_offset.reset();
+
+        const size_t next_chunk_offset = chunk_offset + feature_extractor.nb_max_frames;
+        if (is_encoder_pipelined && next_chunk_offset < input_features.n_frames) {
+            pipelined_features_chunk =
+                input_features.get_data_with_offset(next_chunk_offset, feature_extractor.nb_max_frames);
+            set_hidden_state_output(*models.pipelined_encoder, models, 1);
+            start_encode(*models.pipelined_encoder,
+                         pipelined_features_chunk,
+                         feature_extractor.feature_size,
+                         feature_extractor.nb_max_frames);
+            pipelined_offset = next_chunk_offset;
+        }
 
-        // prepare init_ids just once for whole input
+        // prepare init_ids just once for whole input. Language detection decodes the start token, so the first
+        // window continues its KV-cache, unless prompt tokens precede the start token
+        size_t n_cached_init_tokens = 0;
         if (init_tokens.empty()) {
             init_tokens =
                 prepare_init_tokens(hidden_state_tensor, models.decoder, config, return_timestamps, raw_metrics);
+            n_cached_init_tokens = is_language_detected(config) ? 1 : 0;
         }
 
         std::vector<int64_t> chunk_init_tokens = ov::genai::get_prompt_tokens(context_tokens, config, chunk_offset);
+        if (!chunk_init_tokens.empty()) {
+            n_cached_init_tokens = 0;
+        }
         chunk_init_tokens.insert(chunk_init_tokens.end(), init_tokens.begin(), init_tokens.end());
 
+        std::vector<std::vector<float>> attention_rows;
         auto [cancelled, chunk_output_tokens] = full_decode(hidden_state_tensor,
                                                             config,
                                                             models,
@@ -352,10 +1352,29 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
                                                             max_new_tokens - output_tokens.size(),
                                                             return_timestamps,
                                                             raw_metrics,
-                                                            streamer);
+                                                            streamer,
+                                                            config.word_timestamps ? &attention_rows : nullptr,
+                                                            n_cached_init_tokens);
 
         models.decoder_with_past.reset_state();
 
+        std::vector<TokenTimestamp> chunk_token_timestamps;
+        if (config.word_timestamps) {
+            // the last window may be padded, its encoder frames cover 2 mel frames each
+            const size_t n_valid_frames =
+                (std::min(input_features.n_frames - chunk_offset, feature_extractor.nb_max_frames) + 1) / 2;
+            chunk_token_timestamps = align_window_tokens(chunk_output_tokens,
+                                                         attention_rows,
+                                                         config,
+                                                         hidden_state_tensor.get_shape()[1],
+                                                         n_valid_frames,
+                                                         time_precision);
+            for (auto& timestamp : chunk_token_timestamps) {
+                timestamp.m_start += chunk_offset * frame_duration;
+                timestamp.m_end += chunk_offset * frame_duration;
+            }
+        }
+
         if (return_timestamps) {
             auto extracted_segments = ov::genai::extract_segments(chunk_output_tokens,
                                                                   config,
@@ -363,7 +1382,11 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
                                                                   time_precision);
 
             filter_non_segment_metrics(raw_metrics, output_tokens.size(), extracted_segments.segment_ranges);
+            if (config.word_timestamps) {
+                filter_by_ranges(chunk_token_timestamps, 0, extracted_segments.segment_ranges);
+            }
 
+            offset_segments(extracted_segments.segments, chunk_offset * frame_duration);
             segments.insert(segments.end(), extracted_segments.segments.begin(), extracted_segments.segments.end());
 
             output_tokens.insert(output_tokens.end(),
@@ -379,6 +1402,7 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
         } else {
             output_tokens.insert(output_tokens.end(), chunk_output_tokens.begin(), chunk_output_tokens.end());
         }
+        token_timestamps.insert(token_timestamps.end(), chunk_token_timestamps.begin(), chunk_token_timestamps.end());
 
         if (is_shortform) {
             segment_offset = input_features.n_frames;
@@ -389,18 +1413,445 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
         }
     }
 
+    if (pipelined_offset.has_value()) {
+        models.pipelined_encoder->wait();
+        models.pipelined_encoder->set_tensor(
+            "input_features",
+            ov::Tensor(ov::element::f32, {0, feature_extractor.feature_size, feature_extractor.nb_max_frames}));
+    }
+
     if (streamer) {
         streamer->end();
     }
 
+    if (config.word_timestamps) {
+        if (speech_regions.has_value()) {
+            for (auto& timestamp : token_timestamps) {
+                timestamp.m_start = speech_regions->to_original_time(timestamp.m_start, false);
+                timestamp.m_end = speech_regions->to_original_time(timestamp.m_end, true);
+            }
+        }
+        result.token_timestamps = std::move(token_timestamps);
+    }
+
     // if return_timestamps wasn't enabled by user
     if (!config.return_timestamps) {
         return result;
     }
 
+    if (speech_regions.has_value()) {
+        map_to_original_time(segments, *speech_regions);
+    }
+
     result.segments = segments;
 
     return result;
 }
+
+}  // namespace
+
+void set_hidden_state_output(ov::InferRequest& encoder, const WhisperInitializedModels& models, const size_t batch_size) {
+    if (!models.hidden_state_context.has_value()) {
+        return;
+    }
+    const ov::Tensor current = encoder.get_tensor("last_hidden_state");
+    ov::Shape shape = current.get_shape();
+    if (shape.at(0) == batch_size) {
+        return;
+    }
+    shape[0] = batch_size;
+    encoder.set_tensor("last_hidden_state",
+                       models.hidden_state_context->create_host_tensor(current.get_element_type(), shape));
+}
+
+WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig& config,
+                                       const ov::genai::WhisperConfig& model_config,
+                                       const WhisperContextTokens& context_tokens,
+                                       const RawSpeechInput& raw_speech,
+                                       ov::genai::WhisperInitializedModels& models,
+                                       WhisperFeatureExtractor& feature_extractor,
+                                       const std::shared_ptr<ChunkStreamerBase> streamer) {
+    auto extract_features = [&](std::optional<SpeechRegions>& speech_regions) -> std::optional<WhisperFeatures> {
+        // silent regions are cut off before feature extraction, so that they are not encoded
+        if (config.vad_threshold.has_value()) {
+            speech_regions = detect_speech_regions(raw_speech, feature_extractor.sampling_rate, config);
+            if (speech_regions->regions.empty()) {
+                return std::nullopt;
+            }
+        }
+        return feature_extractor.extract(speech_regions.has_value() ? speech_regions->packed : raw_speech);
+    };
+    return generate_from_features(config,
+                                  model_config,
+                                  context_tokens,
+                                  extract_features,
+                                  models,
+                                  feature_extractor,
+                                  streamer);
+}
+
+WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig& config,
+                                       const ov::genai::WhisperConfig& model_config,
+                                       const WhisperContextTokens& context_tokens,
+                                       const std::filesystem::path& audio_path,
+                                       const WhisperPcmFormat& pcm_format,
+                                       ov::genai::WhisperInitializedModels& models,
+                                       WhisperFeatureExtractor& feature_extractor,
+                                       const std::shared_ptr<ChunkStreamerBase> streamer) {
+    OPENVINO_ASSERT(!config.vad_threshold.has_value(), "'vad_threshold' is not supported for audio file input");
+    auto extract_features = [&](std::optional<SpeechRegions>&) -> std::optional<WhisperFeatures> {
+        return feature_extractor.extract(audio_path, pcm_format);
+    };
+    return generate_from_features(config,
+                                  model_config,
+                                  context_tokens,
+                                  extract_features,
+                                  models,
+                                  feature_extractor,
+                                  streamer);
+}
+
+bool whisper_stream_step(WhisperStreamState& state,
+                         const ov::genai::WhisperConfig& model_config,
+                         ov::genai::WhisperInitializedModels& models,
+                         WhisperFeatureExtractor& feature_extractor,
+                         const bool is_final) {
+    const WhisperGenerationConfig& config = state.config;
+    const size_t max_new_tokens = config.get_max_new_tokens();
+    RawPerfMetrics& raw_metrics = state.result.perf_metrics.raw_metrics;
+    std::vector<int64_t>& output_tokens = state.result.output_tokens;
+
+    const float frame_duration = static_cast<float>(feature_extractor.hop_length) / feature_extractor.sampling_rate;
+    const size_t step_frames = static_cast<size_t>(state.streaming_config.step_duration / frame_duration);
+    const size_t lookahead_frames = static_cast<size_t>(state.streaming_config.lookahead_duration / frame_duration);
+    // 0.02 by default
+    const float time_precision = static_cast<float>(feature_extractor.chunk_length) / model_config.max_source_positions;
+
+    if (!state.result.segments.has_value()) {
+        state.result.segments = std::vector<Segment>{};
+    }
+
+    const size_t n_frames = feature_extractor.get_stream_n_frames();
+    while (!state.finished && state.committed_frames < n_frames) {
+        if (output_tokens.size() >= max_new_tokens) {
+            state.finished = true;
+            break;
+        }
+
+        const size_t window_frames = std::min(n_frames - state.committed_frames, feature_extractor.nb_max_frames);
+        const bool is_window_full = window_frames == feature_extractor.nb_max_frames;
+        if (!is_final && !is_window_full && n_frames < state.decoded_frames + step_frames) {
+            break;
+        }
+
+        auto input_features_chunk =
+            feature_extractor.get_stream_window(state.committed_frames, feature_extractor.nb_max_frames);
+        set_hidden_state_output(models.encoder, models, 1);
+        ov::Tensor hidden_state_tensor = encode(models.encoder,
+                                                input_features_chunk,
+                                                feature_extractor.feature_size,
+                                                feature_extractor.nb_max_frames,
+                                                raw_metrics);
+
+        // timestamps are required to find finalised segments
+        size_t n_cached_init_tokens = 0;
+        if (state.init_tokens.empty()) {
+            state.init_tokens = prepare_init_tokens(hidden_state_tensor, models.decoder, config, true, raw_metrics);
+            n_cached_init_tokens = is_language_detected(config) ? 1 : 0;
+        }
+
+        std::vector<int64_t> chunk_init_tokens =
+            ov::genai::get_prompt_tokens(state.context_tokens, config, state.committed_frames);
+        if (!chunk_init_tokens.empty()) {
+            n_cached_init_tokens = 0;
+        }
+        chunk_init_tokens.insert(chunk_init_tokens.end(), state.init_tokens.begin(), state.init_tokens.end());
+
+        auto [cancelled, chunk_output_tokens] = full_decode(hidden_state_tensor,
+                                                            config,
+                                                            models,
+                                                            chunk_init_tokens,
+                                                            max_new_tokens - output_tokens.size(),
+                                                            true,
+                                                            raw_metrics,
+                                                            nullptr,
+                                                            nullptr,
+                                                            n_cached_init_tokens);
+        models.decoder_with_past.reset_state();
+        state.decoded_frames = n_frames;
+
+        auto extracted_segments = ov::genai::extract_segments(chunk_output_tokens,
+                                                              config,
+                                                              feature_extractor.nb_max_frames,
+                                                              time_precision);
+        auto& segments = extracted_segments.segments;
+
+        // segments, which end before the look-ahead, are not changed by more audio
+        size_t n_final_segments = 0;
+        size_t commit_offset = 0;
+        const size_t final_frames = window_frames > lookahead_frames ? window_frames - lookahead_frames : 0;
+        for (const auto& segment : segments) {
+            const size_t end_frame = static_cast<size_t>(std::round(segment.m_end / frame_duration));
+            if (segment.m_end < 0.0f || end_frame > final_frames || end_frame == 0) {
+                break;
+            }
+            ++n_final_segments;
+            commit_offset = end_frame;
+        }
+        // the window can not be extended, so it is finalised as in whisper_generate()
+        if (is_final || is_window_full) {
+            n_final_segments = segments.size();
+            commit_offset = is_final || segments.empty()
+                                ? window_frames
+                                : std::min(extracted_segments.last_offset, window_frames);
+            if (commit_offset == 0) {
+                commit_offset = window_frames;
+            }
+        }
+
+        const float time_offset = state.committed_frames * frame_duration;
+        std::vector<int64_t> final_tokens;
+        for (size_t i = 0; i < n_final_segments; ++i) {
+            Segment segment = segments[i];
+            segment.m_start += time_offset;
+            if (segment.m_end >= 0.0f) {
+                segment.m_end += time_offset;
+            }
+            final_tokens.insert(final_tokens.end(), segment.m_tokens.begin(), segment.m_tokens.end());
+            state.result.segments->push_back(std::move(segment));
+        }
+        output_tokens.insert(output_tokens.end(), final_tokens.begin(), final_tokens.end());
+
+        std::vector<int64_t> partial_tokens;
+        for (size_t i = n_final_segments; i < segments.size(); ++i) {
+            partial_tokens.insert(partial_tokens.end(), segments[i].m_tokens.begin(), segments[i].m_tokens.end());
+        }
+
+        if (state.streamer) {
+            if (!final_tokens.empty() && state.streamer->put_chunk(final_tokens)) {
+                cancelled = true;
+            }
+            if (!cancelled && state.streamer->put_partial_chunk(partial_tokens)) {
+                cancelled = true;
+            }
+        }
+
+        state.committed_frames += commit_offset;
+        feature_extractor.drop_stream_frames(state.committed_frames);
+
+        if (cancelled) {
+            state.finished = true;
+            break;
+        }
+
+        // no finalised segments until more audio is received
+        if (commit_offset == 0) {
+            break;
+        }
+    }
+
+    return state.finished;
+}
+
+std::vector<WhisperGenerateResult> whisper_generate_batch(const ov::genai::WhisperGenerationConfig& config,
+                                                          const ov::genai::WhisperConfig& model_config,
+                                                          const WhisperContextTokens& context_tokens,
+                                                          const std::vector<RawSpeechInput>& raw_speeches,
+                                                          ov::genai::WhisperInitializedModels& models,
+                                                          WhisperFeatureExtractor& feature_extractor,
+                                                          const size_t max_batch_size) {
+    // beams or sampled candidates of a window fill the batch of the decoder with past, so inputs are decoded one by
+    // one. Cross-attention rows are collected for a single row as well
+    if (!is_greedy_decoding(config) || config.word_timestamps) {
+        std::vector<WhisperGenerateResult> results;
+        results.reserve(raw_speeches.size());
+        for (const auto& raw_speech : raw_speeches) {
+            results.push_back(
+                whisper_generate(config, model_config, context_tokens, raw_speech, models, feature_extractor, nullptr));
+        }
+        return results;
+    }
+
+    struct Stream {
+        WhisperFeatures features;
+        std::optional<SpeechRegions> speech_regions;
+        bool return_timestamps;
+        std::vector<int64_t> init_tokens;
+        size_t chunk_offset = 0;
+        std::vector<Segment> segments;
+    };
+
+    const size_t max_new_tokens = config.get_max_new_tokens();
+    const size_t n_streams = raw_speeches.size();
+
+    std::vector<WhisperGenerateResult> results(n_streams);
+    std::vector<Stream> streams(n_streams);
+
+    // infers are shared by all streams, so they share raw metrics
+    WhisperPerfMetrics perf_metrics;
+    RawPerfMetrics& raw_metrics = perf_metrics.raw_metrics;
+    perf_metrics.num_input_tokens = 0;
+    raw_metrics.m_inference_durations = {{MicroSeconds(0.0f)}};
+
+    for (size_t i = 0; i < n_streams; ++i) {
+        const auto infer_start = std::chrono::steady_clock::now();
+        if (config.vad_threshold.has_value()) {
+            streams[i].speech_regions = detect_speech_regions(raw_speeches[i], feature_extractor.sampling_rate, config);
+        }
+        // inputs without speech have no windows to decode
+        if (streams[i].speech_regions.has_value() && streams[i].speech_regions->regions.empty()) {
+            streams[i].features = WhisperFeatures{feature_extractor.feature_size, 0, {}};
+        } else {
+            streams[i].features = feature_extractor.extract(
+                streams[i].speech_regions.has_value() ? streams[i].speech_regions->packed : raw_speeches[i]);
+        }
+        const auto infer_ms = ov::genai::PerfMetrics::get_microsec(std::chrono::steady_clock::now() - infer_start);
+        perf_metrics.whisper_raw_metrics.features_extraction_durations.emplace_back(infer_ms);
+
+        // long-form audio processing requires timestamps to be enabled
+        const bool is_shortform = streams[i].features.n_frames <= feature_extractor.nb_max_frames;
+        streams[i].return_timestamps = config.return_timestamps || !is_shortform;
+    }
+
+    // 0.02 by default
+    const float time_precision = static_cast<float>(feature_extractor.chunk_length) / model_config.max_source_positions;
+    const float frame_duration = static_cast<float>(feature_extractor.hop_length) / feature_extractor.sampling_rate;
+    const bool needs_language_detection = config.is_multilingual && !config.language.has_value();
+
+    while (true) {
+        // streams leave the batch once all their windows are decoded, waiting streams join the next one
+        std::vector<size_t> batch;
+        for (size_t i = 0; i < n_streams && (max_batch_size == 0 || batch.size() < max_batch_size); ++i) {
+            if (streams[i].chunk_offset < streams[i].features.n_frames &&
+                results[i].output_tokens.size() < max_new_tokens) {
+                batch.push_back(i);
+            }
+        }
+        if (batch.empty()) {
+            break;
+        }
+
+        std::vector<std::vector<float>> input_features(batch.size());
+        for (size_t row = 0; row < batch.size(); ++row) {
+            auto& stream = streams[batch[row]];
+            input_features[row] =
+                stream.features.get_data_with_offset(stream.chunk_offset, feature_extractor.nb_max_frames);
+        }
+        set_hidden_state_output(models.encoder, models, batch.size());
+        ov::Tensor hidden_state_tensor = encode_batch(models.encoder,
+                                                      input_features,
+                                                      feature_extractor.feature_size,
+                                                      feature_extractor.nb_max_frames,
+                                                      raw_metrics);
+
+        // prepare init_ids just once for whole input of each stream
+        const bool has_new_streams = std::any_of(batch.begin(), batch.end(), [&](size_t i) {
+            return streams[i].init_tokens.empty();
+        });
+        if (has_new_streams) {
+            std::vector<int64_t> language_token_ids;
+            if (needs_language_detection) {
+                language_token_ids = detect_languages(hidden_state_tensor, models.decoder, config, raw_metrics);
+            }
+            for (size_t row = 0; row < batch.size(); ++row) {
+                auto& stream = streams[batch[row]];
+                if (!stream.init_tokens.empty()) {
+                    continue;
+                }
+                if (!config.is_multilingual) {
+                    stream.init_tokens = stream.return_timestamps
+                                             ? std::vector<int64_t>{config.decoder_start_token_id}
+                                             : std::vector<int64_t>{config.decoder_start_token_id,
+                                                                    config.no_timestamps_token_id};
+                } else {
+                    const int64_t language_token_id = needs_language_detection
+                                                          ? language_token_ids[row]
+                                                          : config.lang_to_id.at(*config.language);
+                    stream.init_tokens = get_init_tokens(config, stream.return_timestamps, language_token_id);
+                }
+            }
+        }
+
+        // windows with prompt tokens of different lengths are decoded by separate batches
+        std::map<size_t, std::vector<size_t>> rows_by_init_size;
+        std::vector<std::vector<int64_t>> chunk_init_tokens(batch.size());
+        for (size_t row = 0; row < batch.size(); ++row) {
+            auto& stream = streams[batch[row]];
+            chunk_init_tokens[row] = ov::genai::get_prompt_tokens(context_tokens, config, stream.chunk_offset);
+            chunk_init_tokens[row].insert(chunk_init_tokens[row].end(),
+                                          stream.init_tokens.begin(),
+                                          stream.init_tokens.end());
+            rows_by_init_size[chunk_init_tokens[row].size()].push_back(row);
+        }
+
+        for (const auto& [init_size, rows] : rows_by_init_size) {
+            std::vector<std::vector<int64_t>> group_init_tokens;
+            std::vector<size_t> group_max_new_tokens;
+            std::vector<bool> group_return_timestamps;
+            for (size_t row : rows) {
+                group_init_tokens.push_back(chunk_init_tokens[row]);
+                group_max_new_tokens.push_back(max_new_tokens - results[batch[row]].output_tokens.size());
+                group_return_timestamps.push_back(streams[batch[row]].return_timestamps);
+            }
+
+            ov::Tensor group_hidden_state = select_rows(hidden_state_tensor, rows);
+            auto group_output_tokens = full_decode_batch(group_hidden_state,
+                                                         config,
+                                                         models,
+                                                         group_init_tokens,
+                                                         group_max_new_tokens,
+                                                         group_return_timestamps,
+                                                         raw_metrics);
+            models.decoder_with_past.reset_state();
+
+            for (size_t i = 0; i < rows.size(); ++i) {
+                auto& stream = streams[batch[rows[i]]];
+                auto& output_tokens = results[batch[rows[i]]].output_tokens;
+                auto& chunk_output_tokens = group_output_tokens[i];
+                size_t segment_offset = 0;
+
+                if (stream.return_timestamps) {
+                    auto extracted_segments = ov::genai::extract_segments(chunk_output_tokens,
+                                                                          config,
+                                                                          feature_extractor.nb_max_frames,
+                                                                          time_precision);
+
+                    offset_segments(extracted_segments.segments, stream.chunk_offset * frame_duration);
+                    stream.segments.insert(stream.segments.end(),
+                                           extracted_segments.segments.begin(),
+                                           extracted_segments.segments.end());
+
+                    output_tokens.insert(output_tokens.end(),
+                                         extracted_segments.non_timestamp_tokens.begin(),
+                                         extracted_segments.non_timestamp_tokens.end());
+
+                    segment_offset = extracted_segments.last_offset;
+                } else {
+                    output_tokens.insert(output_tokens.end(), chunk_output_tokens.begin(), chunk_output_tokens.end());
+                }
+
+                if (stream.features.n_frames <= feature_extractor.nb_max_frames) {
+                    segment_offset = stream.features.n_frames;
+                }
+
+                stream.chunk_offset += segment_offset;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n_streams; ++i) {
+        results[i].perf_metrics = perf_metrics;
+        // if return_timestamps wasn't enabled by user
+        if (config.return_timestamps) {
+            if (streams[i].speech_regions.has_value()) {
+                map_to_original_time(streams[i].segments, *streams[i].speech_regions);
+            }
+            results[i].segments = std::move(streams[i].segments);
+        }
+    }
+
+    return results;
+}
+
 }  // namespace genai
 }  // namespace ov
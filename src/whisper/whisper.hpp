@@ -21,9 +21,17 @@ struct Segment {
     std::vector<int64_t> m_tokens;
 };
 
+struct TokenTimestamp {
+    int64_t m_token;
+    float m_start;
+    float m_end;
+};
+
 struct WhisperGenerateResult {
     std::vector<int64_t> output_tokens;
     std::optional<std::vector<Segment>> segments = std::nullopt;
+    // timestamps of output_tokens, set if word_timestamps is enabled
+    std::optional<std::vector<TokenTimestamp>> token_timestamps = std::nullopt;
     WhisperPerfMetrics perf_metrics;
 };
 
@@ -35,5 +43,65 @@ WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig&
                                        ov::genai::WhisperFeatureExtractor& feature_extractor,
                                        const std::shared_ptr<ChunkStreamerBase> streamer);
 
+/**
+ * Transcribes an audio file, whose features are extracted while it is decoded block by block
+ */
+WhisperGenerateResult whisper_generate(const ov::genai::WhisperGenerationConfig& config,
+                                       const ov::genai::WhisperConfig& model_config,
+                                       const WhisperContextTokens& context_tokens,
+                                       const std::filesystem::path& audio_path,
+                                       const WhisperPcmFormat& pcm_format,
+                                       ov::genai::WhisperInitializedModels& models,
+                                       ov::genai::WhisperFeatureExtractor& feature_extractor,
+                                       const std::shared_ptr<ChunkStreamerBase> streamer);
+
+/**
+ * Transcribes several audio inputs by batched encoder and decoder infers. Each batch holds the current 30 seconds
+ * windows of up to max_batch_size inputs (0 means all), inputs leave it after their last window and waiting inputs
+ * join the next batch. Per-row KV-cache is kept by the decoder with past, finished rows idle until the batch ends.
+ */
+std::vector<WhisperGenerateResult> whisper_generate_batch(const ov::genai::WhisperGenerationConfig& config,
+                                                          const ov::genai::WhisperConfig& model_config,
+                                                          const WhisperContextTokens& context_tokens,
+                                                          const std::vector<ov::genai::RawSpeechInput>& raw_speeches,
+                                                          ov::genai::WhisperInitializedModels& models,
+                                                          ov::genai::WhisperFeatureExtractor& feature_extractor,
+                                                          const size_t max_batch_size);
+
+struct WhisperStreamState {
+    WhisperGenerationConfig config;
+    WhisperStreamingConfig streaming_config;
+    WhisperContextTokens context_tokens;
+    std::shared_ptr<ChunkStreamerBase> streamer;
+    std::vector<int64_t> init_tokens;
+    // frames before committed_frames are transcribed by finalised segments, the current window starts from it
+    size_t committed_frames = 0;
+    // number of received frames at the last decoding of the current window
+    size_t decoded_frames = 0;
+    bool finished = false;
+    // segments have timestamps from the start of the stream
+    WhisperGenerateResult result;
+};
+
+/**
+ * Sets the output of the encoder to host memory of models.hidden_state_context for batch_size rows, if the context is set
+ * and the current output has a different number of rows.
+ */
+void set_hidden_state_output(ov::InferRequest& encoder,
+                             const ov::genai::WhisperInitializedModels& models,
+                             const size_t batch_size);
+
+/**
+ * Decodes the current window of the stream, if enough new frames are extracted since its last decoding. Finalised
+ * segments are appended to the result and passed to the streamer, the window is moved past them. With is_final
+ * all remaining frames are decoded and finalised.
+ * @return true if the streamer requested to stop or max_new_tokens are generated
+ */
+bool whisper_stream_step(WhisperStreamState& state,
+                         const ov::genai::WhisperConfig& model_config,
+                         ov::genai::WhisperInitializedModels& models,
+                         ov::genai::WhisperFeatureExtractor& feature_extractor,
+                         const bool is_final);
+
 }  // namespace genai
 }  // namespace ov
@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <complex>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -19,10 +21,34 @@
 #include <thread>
 #include <vector>
 
+#include "audio_decoder.hpp"
 #include "json_utils.hpp"
 #include "openvino/genai/visibility.hpp"
 
+namespace ov {
+namespace genai {
+
+// per thread buffers of log_mel_frame()
+struct LogMelFrameBuffers {
+    std::vector<float> fft_in;
+    std::vector<std::complex<float>> fft_out;
+    std::vector<std::complex<float>> fft_workspace;
+    std::vector<float> fft_power;
+
+    explicit LogMelFrameBuffers(const RealFFT& fft_plan)
+        : fft_in(fft_plan.get_size()),
+          fft_out(fft_plan.get_size() / 2 + 1),
+          fft_workspace(fft_plan.get_workspace_size()),
+          fft_power(fft_plan.get_size() / 2 + 1) {}
+};
+
+}  // namespace genai
+}  // namespace ov
+
 namespace {
+using ov::genai::LogMelFrameBuffers;
+using ov::genai::MelFilterBank;
+using ov::genai::RealFFT;
 using ov::genai::WhisperFeatures;
 
 static bool hann_window(const size_t length, const bool periodic, std::vector<float>& output) {
@@ -40,163 +66,183 @@ static bool hann_window(const size_t length, const bool periodic, std::vector<fl
     return true;
 }
 
-// naive Discrete Fourier Transform
-// input is real-valued
-// output is complex-valued
-static void dft(const std::vector<float>& in,
-                std::vector<float>& out,
-                const std::vector<float>& sin_vals,
-                const std::vector<float>& cos_vals,
-                const size_t n_fft) {
-    int N = in.size();
-
-    out.resize(N * 2);
-    const int sin_cos_step = n_fft / N;
-
-    for (int k = 0; k < N; k++) {
-        float re = 0;
-        float im = 0;
-
-        for (int n = 0; n < N; n++) {
-            int idx = (k * n * sin_cos_step) % (n_fft);  // t = 2*M_PI*k*n/N
-            re += in[n] * cos_vals[idx];                 // cos(t)
-            im -= in[n] * sin_vals[idx];                 // sin(t)
-        }
-
-        out[k * 2 + 0] = re;
-        out[k * 2 + 1] = im;
-    }
-}
-
-// Cooley-Tukey FFT
-// input is real-valued
-// output is complex-valued
-static void fft(const std::vector<float>& in,
-                std::vector<float>& out,
-                const std::vector<float>& sin_vals,
-                const std::vector<float>& cos_vals,
-                const size_t n_fft) {
-    out.resize(in.size() * 2);
-
-    int N = in.size();
-
-    if (N == 1) {
-        out[0] = in[0];
-        out[1] = 0;
-        return;
+// Writes log10 of mel spectrogram of a frame starting at samples to features[j * features_stride], j < mel_filter.size().
+// Only n_valid samples of the frame are read, the rest of the frame is zero.
+static void log_mel_frame(const float* samples,
+                          int n_valid,
+                          const std::vector<float>& hann,
+                          const RealFFT& fft_plan,
+                          const MelFilterBank& mel_filter,
+                          LogMelFrameBuffers& buffers,
+                          float* features,
+                          size_t features_stride) {
+    const int frame_size = static_cast<int>(fft_plan.get_size());
+    const int n_fft = 1 + (frame_size / 2);
+    std::vector<float>& fft_in = buffers.fft_in;
+    std::vector<std::complex<float>>& fft_out = buffers.fft_out;
+    std::vector<float>& fft_power = buffers.fft_power;
+
+    // apply Hanning window (~10% faster)
+    for (int j = 0; j < std::min(frame_size, n_valid); j++) {
+        fft_in[j] = hann[j] * samples[j];
     }
-
-    if (N % 2 == 1) {
-        dft(in, out, sin_vals, cos_vals, n_fft);
-        return;
+    // fill the rest with zeros
+    if (n_valid < frame_size) {
+        std::fill(fft_in.begin() + n_valid, fft_in.end(), 0.0);
     }
 
-    std::vector<float> even;
-    std::vector<float> odd;
+    // FFT
+    fft_plan.forward(fft_in.data(), fft_out.data(), buffers.fft_workspace.data());
 
-    even.reserve(N / 2);
-    odd.reserve(N / 2);
-
-    for (int i = 0; i < N; i++) {
-        if (i % 2 == 0) {
-            even.push_back(in[i]);
-        } else {
-            odd.push_back(in[i]);
-        }
+    // Calculate modulus^2 of complex numbers
+    // Use pow(fft_out[j].real(), 2) + pow(fft_out[j].imag(), 2) causes inference quality problem? Interesting.
+    for (int j = 0; j < n_fft; j++) {
+        fft_power[j] = fft_out[j].real() * fft_out[j].real() + fft_out[j].imag() * fft_out[j].imag();
     }
 
-    std::vector<float> even_fft;
-    std::vector<float> odd_fft;
-
-    fft(even, even_fft, sin_vals, cos_vals, n_fft);
-    fft(odd, odd_fft, sin_vals, cos_vals, n_fft);
-
-    const int sin_cos_step = n_fft / N;
-    for (int k = 0; k < N / 2; k++) {
-        int idx = k * sin_cos_step;  // t = 2*M_PI*k/N
-        float re = cos_vals[idx];    // cos(t)
-        float im = -sin_vals[idx];   // sin(t)
-
-        float re_odd = odd_fft[2 * k + 0];
-        float im_odd = odd_fft[2 * k + 1];
+    // mel spectrogram, only non-zero weights of each filter are applied
+    for (size_t j = 0; j < mel_filter.size(); j++) {
+        const float* power = fft_power.data() + mel_filter.begins[j];
+        const float* weights = mel_filter.weights.data() + mel_filter.offsets[j];
+        const size_t length = mel_filter.lengths[j];
+
+        // independent partial sums let the compiler vectorize the unrolled loop
+        double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+        size_t k = 0;
+        for (; k + 4 <= length; k += 4) {
+            sum0 += power[k + 0] * weights[k + 0];
+            sum1 += power[k + 1] * weights[k + 1];
+            sum2 += power[k + 2] * weights[k + 2];
+            sum3 += power[k + 3] * weights[k + 3];
+        }
 
-        out[2 * k + 0] = even_fft[2 * k + 0] + re * re_odd - im * im_odd;
-        out[2 * k + 1] = even_fft[2 * k + 1] + re * im_odd + im * re_odd;
+        // handle length remainder
+        for (; k < length; k++) {
+            sum0 += power[k] * weights[k];
+        }
 
-        out[2 * (k + N / 2) + 0] = even_fft[2 * k + 0] - re * re_odd + im * im_odd;
-        out[2 * (k + N / 2) + 1] = even_fft[2 * k + 1] - re * im_odd - im * re_odd;
+        const double sum = (sum0 + sum1) + (sum2 + sum3);
+        features[j * features_stride] = log10(std::max(sum, 1e-10));
     }
 }
 
-static void log_mel_spectrogram_worker_thread(int ith,
-                                              const std::vector<float>& hann,
-                                              const std::vector<float>& samples,
-                                              int n_samples,
-                                              int frame_size,
-                                              int frame_step,
-                                              int n_threads,
-                                              const std::vector<float>& mel_filter,
-                                              WhisperFeatures& features,
-                                              const std::vector<float>& sin_vals,
-                                              const std::vector<float>& cos_vals) {
-    std::vector<float> fft_in(frame_size, 0.0);
-    std::vector<float> fft_out(2 * frame_size);
-    int n_fft = 1 + (frame_size / 2);
-    int i = ith;
-
-    OPENVINO_ASSERT(mel_filter.size() == n_fft * features.feature_size);
-
-    // calculate FFT only when fft_in are not all zero
-    for (; i < std::min(n_samples / frame_step + 1, int(features.n_frames)); i += n_threads) {
-        const int offset = i * frame_step;
-
-        // apply Hanning window (~10% faster)
-        for (int j = 0; j < std::min(frame_size, n_samples - offset); j++) {
-            fft_in[j] = hann[j] * samples[offset + j];
-        }
-        // fill the rest with zeros
-        if (n_samples - offset < frame_size) {
-            std::fill(fft_in.begin() + (n_samples - offset), fft_in.end(), 0.0);
-        }
+// Samples of the padded speech starting from sample begin, which may be negative. The start of the speech is reflect
+// padded, samples after its end are zero.
+static const float* padded_frame(const std::vector<float>& raw_speech,
+                                 const int64_t begin,
+                                 const size_t frame_size,
+                                 std::vector<float>& frame) {
+    const int64_t size = static_cast<int64_t>(raw_speech.size());
+    if (begin >= 0 && begin + static_cast<int64_t>(frame_size) <= size) {
+        return raw_speech.data() + begin;
+    }
 
-        // FFT
-        fft(fft_in, fft_out, sin_vals, cos_vals, frame_size);
+    frame.resize(frame_size);
+    for (size_t j = 0; j < frame_size; j++) {
+        const int64_t index = std::abs(begin + static_cast<int64_t>(j));
+        frame[j] = index < size ? raw_speech[index] : 0.0f;
+    }
+    return frame.data();
+}
 
-        // Calculate modulus^2 of complex numbers
-        // Use pow(fft_out[2 * j + 0], 2) + pow(fft_out[2 * j + 1], 2) causes inference quality problem? Interesting.
-        for (int j = 0; j < n_fft; j++) {
-            fft_out[j] = (fft_out[2 * j + 0] * fft_out[2 * j + 0] + fft_out[2 * j + 1] * fft_out[2 * j + 1]);
+// Computes log10 mel frames [frame_offset, frame_offset + n_frames) of raw speech, which is padded by frame_size / 2 at
+// both sides, to window[j * stride + i], if window is set. Returns the maximum value.
+static float log_mel_frames_worker_thread(int ith,
+                                          const std::vector<float>& hann,
+                                          const std::vector<float>& raw_speech,
+                                          size_t frame_offset,
+                                          size_t n_frames,
+                                          int frame_size,
+                                          int frame_step,
+                                          int n_threads,
+                                          const MelFilterBank& mel_filter,
+                                          const RealFFT& fft_plan,
+                                          float* window,
+                                          size_t stride) {
+    LogMelFrameBuffers buffers(fft_plan);
+    std::vector<float> frame;
+    std::vector<float> column(mel_filter.size());
+    const int64_t reflect_pad_size = frame_size / 2;
+    float max_value = -1e20f;
+
+    OPENVINO_ASSERT(mel_filter.n_frequency_bins == 1 + (frame_size / 2));
+
+    for (size_t i = ith; i < n_frames; i += n_threads) {
+        const int64_t begin = static_cast<int64_t>(frame_offset + i) * frame_step - reflect_pad_size;
+        if (begin < static_cast<int64_t>(raw_speech.size())) {
+            log_mel_frame(padded_frame(raw_speech, begin, frame_size, frame),
+                          frame_size,
+                          hann,
+                          fft_plan,
+                          mel_filter,
+                          buffers,
+                          column.data(),
+                          1);
+        } else {
+            // fft_out are all zero
+            std::fill(column.begin(), column.end(), log10(1e-10));
         }
 
-        // mel spectrogram
-        for (int j = 0; j < features.feature_size; j++) {
-            double sum = 0.0;
-
-            // unroll loop (suggested by GH user @lunixbochs)
-            int k = 0;
-            for (k = 0; k < n_fft - 3; k += 4) {
-                sum += fft_out[k + 0] * mel_filter[j * n_fft + k + 0] + fft_out[k + 1] * mel_filter[j * n_fft + k + 1] +
-                       fft_out[k + 2] * mel_filter[j * n_fft + k + 2] + fft_out[k + 3] * mel_filter[j * n_fft + k + 3];
-            }
-
-            // handle n_fft remainder
-            for (; k < n_fft; k++) {
-                sum += fft_out[k] * mel_filter[j * n_fft + k];
+        for (size_t j = 0; j < column.size(); j++) {
+            max_value = std::max(max_value, column[j]);
+            if (window) {
+                window[j * stride + i] = column[j];
             }
+        }
+    }
 
-            sum = log10(std::max(sum, 1e-10));
+    return max_value;
+}
 
-            features.data[j * features.n_frames + i] = sum;
-        }
+static float log_mel_frames(const std::vector<float>& hann,
+                            const std::vector<float>& raw_speech,
+                            const size_t frame_offset,
+                            const size_t n_frames,
+                            const size_t frame_size,
+                            const size_t frame_step,
+                            const size_t n_threads,
+                            const MelFilterBank& mel_filter,
+                            const RealFFT& fft_plan,
+                            float* window,
+                            const size_t stride) {
+    std::vector<float> max_values(n_threads);
+    std::vector<std::thread> workers(n_threads - 1);
+    for (size_t iw = 0; iw < n_threads - 1; ++iw) {
+        workers[iw] = std::thread([&, iw]() {
+            max_values[iw + 1] = log_mel_frames_worker_thread(iw + 1,
+                                                              hann,
+                                                              raw_speech,
+                                                              frame_offset,
+                                                              n_frames,
+                                                              frame_size,
+                                                              frame_step,
+                                                              n_threads,
+                                                              mel_filter,
+                                                              fft_plan,
+                                                              window,
+                                                              stride);
+        });
     }
 
-    // Otherwise fft_out are all zero
-    double sum = log10(1e-10);
-    for (; i < features.n_frames; i += n_threads) {
-        for (int j = 0; j < features.feature_size; j++) {
-            features.data[j * features.n_frames + i] = sum;
-        }
+    // main thread
+    max_values[0] = log_mel_frames_worker_thread(0,
+                                                 hann,
+                                                 raw_speech,
+                                                 frame_offset,
+                                                 n_frames,
+                                                 frame_size,
+                                                 frame_step,
+                                                 n_threads,
+                                                 mel_filter,
+                                                 fft_plan,
+                                                 window,
+                                                 stride);
+
+    for (auto& worker : workers) {
+        worker.join();
     }
+
+    return *std::max_element(max_values.begin(), max_values.end());
 }
 
 // python implementation: https://github.com/huggingface/transformers/blob/check_gemma/src/transformers/audio_utils.py
@@ -302,120 +348,33 @@ std::vector<std::vector<float>> mel_filter_bank(const int64_t num_frequency_bins
     return mel_filters;
 }
 
-// In FFT, we frequently use sine and cosine operations with the same values.
-// We can use precalculated values to speed up the process.
-void fill_sin_cos_table(std::vector<float>& sin_vals, std::vector<float>& cos_vals, const size_t n_fft) {
-    sin_vals.resize(n_fft);
-    cos_vals.resize(n_fft);
-
-    for (size_t i = 0; i < n_fft; i++) {
-        double theta = (2 * M_PI * i) / n_fft;
-        sin_vals[i] = sinf(theta);
-        cos_vals[i] = cosf(theta);
-    }
-}
-
-std::vector<float> pad(const std::vector<float>& raw_speech,
-                       const size_t minimum_length,
-                       const size_t reflect_pad_size) {
-    // pad to minimum length if needed
-    size_t total_pad_length = std::max(raw_speech.size(), minimum_length) + 2 * reflect_pad_size;
-
-    std::vector<float> padded_raw_speech(total_pad_length, 0.f);
-
-    std::copy(raw_speech.begin(), raw_speech.end(), padded_raw_speech.begin() + reflect_pad_size);
-
-    // reflect pad
-    std::reverse_copy(padded_raw_speech.begin() + reflect_pad_size + 1,
-                      padded_raw_speech.begin() + reflect_pad_size + 1 + reflect_pad_size,
-                      padded_raw_speech.begin());
-
-    std::reverse_copy(padded_raw_speech.end() - reflect_pad_size - 1 - reflect_pad_size,
-                      padded_raw_speech.end() - reflect_pad_size - 1,
-                      padded_raw_speech.end() - reflect_pad_size);
-
-    return padded_raw_speech;
-}
-
-WhisperFeatures mel_spectrogram_convert_audio(const std::vector<float>& raw_speech,
-                                              const size_t sampling_rate,
-                                              const size_t feature_size,
-                                              const size_t n_fft,
-                                              const size_t hop_length,
-                                              const size_t n_threads,
-                                              const std::vector<float>& mel_filter,
-                                              const std::vector<float>& sin_vals,
-                                              const std::vector<float>& cos_vals) {
-    // Hanning window (Use cosf to eliminate difference)
-    // ref: https://pytorch.org/docs/stable/generated/torch.hann_window.html
-    // ref: https://github.com/openai/whisper/blob/main/whisper/audio.py#L147
-    std::vector<float> hann;
-    hann_window(n_fft, true, hann);
-
-    const size_t reflect_pad_size = n_fft / 2;
-    auto padded_raw_speech = pad(raw_speech, sampling_rate * 30, reflect_pad_size);
+// clamps log10 mel values to at most 8 below max_value and scales them
+void clamp_and_normalize(float* data, const size_t size, double max_value) {
+    max_value -= 8.0;
 
-    WhisperFeatures features;
-    features.feature_size = feature_size;
-    // https://github.com/pytorch/pytorch/blob/main/aten/src/ATen/native/SpectralOps.cpp#L936
-    // Calculate number of frames + remove the last frame
-    features.n_frames = (padded_raw_speech.size() - n_fft) / hop_length;
-    features.data.resize(features.feature_size * features.n_frames);
-
-    {
-        std::vector<std::thread> workers(n_threads - 1);
-        for (int iw = 0; iw < n_threads - 1; ++iw) {
-            workers[iw] = std::thread(log_mel_spectrogram_worker_thread,
-                                      iw + 1,
-                                      std::cref(hann),
-                                      padded_raw_speech,
-                                      raw_speech.size() + reflect_pad_size,
-                                      n_fft,
-                                      hop_length,
-                                      n_threads,
-                                      std::cref(mel_filter),
-                                      std::ref(features),
-                                      std::cref(sin_vals),
-                                      std::cref(cos_vals));
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] < max_value) {
+            data[i] = max_value;
         }
 
-        // main thread
-        log_mel_spectrogram_worker_thread(0,
-                                          hann,
-                                          padded_raw_speech,
-                                          raw_speech.size() + reflect_pad_size,
-                                          n_fft,
-                                          hop_length,
-                                          n_threads,
-                                          mel_filter,
-                                          features,
-                                          sin_vals,
-                                          cos_vals);
-
-        for (int iw = 0; iw < n_threads - 1; ++iw) {
-            workers[iw].join();
-        }
+        data[i] = (data[i] + 4.0) / 4.0;
     }
+}
 
-    // clamping and normalization
+// the same with the maximum of data
+void clamp_and_normalize(std::vector<float>& data) {
     double mmax = -1e20;
-    for (int i = 0; i < features.feature_size * features.n_frames; i++) {
-        if (features.data[i] > mmax) {
-            mmax = features.data[i];
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i] > mmax) {
+            mmax = data[i];
         }
     }
 
-    mmax -= 8.0;
-
-    for (int i = 0; i < features.feature_size * features.n_frames; i++) {
-        if (features.data[i] < mmax) {
-            features.data[i] = mmax;
-        }
-
-        features.data[i] = (features.data[i] + 4.0) / 4.0;
-    }
+    clamp_and_normalize(data.data(), data.size(), mmax);
+}
 
-    return features;
+size_t get_n_threads() {
+    return std::min(4, (int32_t)std::thread::hardware_concurrency());
 }
 
 }  // namespace
@@ -423,18 +382,16 @@ WhisperFeatures mel_spectrogram_convert_audio(const std::vector<float>& raw_spee
 namespace ov {
 namespace genai {
 
-std::vector<float> WhisperFeatures::get_data_with_offset(const size_t frame_offset, const size_t min_frames) {
+std::vector<float> WhisperFeatures::get_data_with_offset(const size_t frame_offset, const size_t min_frames) const {
     OPENVINO_ASSERT(n_frames > frame_offset);
 
     size_t copy_size = std::min(n_frames - frame_offset, min_frames);
-    std::vector<float> offset_data;
+    // frames after the end are zero padded
+    std::vector<float> offset_data(feature_size * min_frames, 0.0f);
 
+    compute_frames(frame_offset, copy_size, offset_data.data(), min_frames);
     for (size_t i = 0; i < feature_size; i++) {
-        size_t offset = frame_offset + (i * n_frames);
-        std::copy(data.begin() + offset, data.begin() + offset + copy_size, std::back_inserter(offset_data));
-        if (copy_size < min_frames) {
-            std::fill_n(std::back_inserter(offset_data), min_frames - copy_size, 0);
-        }
+        clamp_and_normalize(offset_data.data() + i * min_frames, copy_size, max_log_mel);
     }
 
     return offset_data;
@@ -442,7 +399,7 @@ std::vector<float> WhisperFeatures::get_data_with_offset(const size_t frame_offs
 
 WhisperFeatureExtractor::WhisperFeatureExtractor(const std::filesystem::path& preprocessor_json_path) {
     init_parameters(preprocessor_json_path);
-    fill_sin_cos_table(sin_vals, cos_vals, n_fft);
+    fft_plan = RealFFT(n_fft);
     init_mel_filter();
 }
 
@@ -470,26 +427,216 @@ void WhisperFeatureExtractor::init_parameters(const std::filesystem::path& prepr
 
 void WhisperFeatureExtractor::init_mel_filter() {
     auto mel_data = mel_filter_bank(1 + n_fft / 2, feature_size, sampling_rate);
-    mel_filter.resize(mel_data.size() * mel_data[0].size());
+    const size_t n_frequency_bins = mel_data.size();
+    const size_t n_filters = mel_data[0].size();
+
+    mel_filter = MelFilterBank{};
+    mel_filter.n_frequency_bins = n_frequency_bins;
+    mel_filter.begins.resize(n_filters);
+    mel_filter.lengths.resize(n_filters);
+    mel_filter.offsets.resize(n_filters);
+
+    for (size_t col = 0; col < n_filters; col++) {
+        size_t begin = 0;
+        while (begin < n_frequency_bins && mel_data[begin][col] == 0.0f) {
+            begin++;
+        }
+        size_t end = n_frequency_bins;
+        while (end > begin && mel_data[end - 1][col] == 0.0f) {
+            end--;
+        }
 
-    for (size_t col = 0; col < mel_data[0].size(); col++) {
-        for (size_t row = 0; row < mel_data.size(); row++) {
-            mel_filter[col * mel_data.size() + row] = mel_data[row][col];
+        mel_filter.begins[col] = begin;
+        mel_filter.lengths[col] = end - begin;
+        mel_filter.offsets[col] = mel_filter.weights.size();
+        for (size_t row = begin; row < end; row++) {
+            mel_filter.weights.push_back(mel_data[row][col]);
         }
     }
 }
 
 WhisperFeatures WhisperFeatureExtractor::extract(const std::vector<float>& raw_speech) {
-    size_t n_threads = std::min(4, (int32_t)std::thread::hardware_concurrency());
-    return mel_spectrogram_convert_audio(raw_speech,
-                                         sampling_rate,
-                                         feature_size,
-                                         n_fft,
-                                         hop_length,
-                                         n_threads,
-                                         mel_filter,
-                                         sin_vals,
-                                         cos_vals);
+    // Hanning window (Use cosf to eliminate difference)
+    // ref: https://pytorch.org/docs/stable/generated/torch.hann_window.html
+    // ref: https://github.com/openai/whisper/blob/main/whisper/audio.py#L147
+    auto hann = std::make_shared<std::vector<float>>();
+    hann_window(n_fft, true, *hann);
+
+    WhisperFeatures features;
+    features.feature_size = feature_size;
+    // speech is padded to 30 seconds and by n_fft / 2 at both sides
+    // https://github.com/pytorch/pytorch/blob/main/aten/src/ATen/native/SpectralOps.cpp#L936
+    // Calculate number of frames + remove the last frame
+    features.n_frames = (std::max(raw_speech.size(), sampling_rate * 30) + 2 * (n_fft / 2) - n_fft) / hop_length;
+
+    // the first pass keeps the maximum only, windows compute their frames again
+    features.max_log_mel = log_mel_frames(*hann,
+                                          raw_speech,
+                                          0,
+                                          features.n_frames,
+                                          n_fft,
+                                          hop_length,
+                                          get_n_threads(),
+                                          mel_filter,
+                                          fft_plan,
+                                          nullptr,
+                                          0);
+
+    features.compute_frames = [this, hann, &raw_speech](const size_t frame_offset,
+                                                        const size_t n_frames,
+                                                        float* window,
+                                                        const size_t stride) {
+        log_mel_frames(*hann,
+                       raw_speech,
+                       frame_offset,
+                       n_frames,
+                       n_fft,
+                       hop_length,
+                       get_n_threads(),
+                       mel_filter,
+                       fft_plan,
+                       window,
+                       stride);
+    };
+
+    return features;
+}
+
+WhisperFeatures WhisperFeatureExtractor::extract(const std::filesystem::path& audio_path,
+                                                 const WhisperPcmFormat& pcm_format) {
+    start_stream();
+    size_t n_raw_samples = 0;
+    read_audio(audio_path, pcm_format, sampling_rate, [&](const std::vector<float>& samples) {
+        n_raw_samples += samples.size();
+        push_stream(samples);
+    });
+    finish_stream();
+
+    // the layout of extract(): audio is padded to n_samples by silence and the last frame is removed
+    WhisperFeatures features;
+    features.feature_size = feature_size;
+    features.n_frames = std::max(n_raw_samples, n_samples) / hop_length;
+
+    // frames of the file are kept as computed by the stream, [n_frames, feature_size] without padding frames
+    const size_t n_stream_frames = std::min(get_stream_n_frames(), features.n_frames);
+    auto frames = std::make_shared<std::vector<float>>(std::move(stream.frames));
+    frames->resize(n_stream_frames * feature_size);
+    const float silence = log10(1e-10);
+    features.max_log_mel = n_stream_frames < features.n_frames ? silence : -1e20f;
+    for (const float value : *frames) {
+        features.max_log_mel = std::max(features.max_log_mel, value);
+    }
+
+    features.compute_frames = [frames, n_stream_frames, silence, feature_size = feature_size](
+                                  const size_t frame_offset,
+                                  const size_t n_frames,
+                                  float* window,
+                                  const size_t stride) {
+        for (size_t i = 0; i < n_frames; i++) {
+            const float* frame = frames->data() + (frame_offset + i) * feature_size;
+            const bool is_padding = frame_offset + i >= n_stream_frames;
+            for (size_t j = 0; j < feature_size; j++) {
+                window[j * stride + i] = is_padding ? silence : frame[j];
+            }
+        }
+    };
+
+    start_stream();
+    return features;
+}
+
+void WhisperFeatureExtractor::start_stream() {
+    stream = StreamState{};
+    hann_window(n_fft, true, stream.hann);
+    stream.buffers = std::make_shared<LogMelFrameBuffers>(fft_plan);
+}
+
+void WhisperFeatureExtractor::push_stream(const std::vector<float>& raw_speech) {
+    OPENVINO_ASSERT(stream.buffers, "Audio stream is not started");
+    stream.samples.insert(stream.samples.end(), raw_speech.begin(), raw_speech.end());
+
+    const size_t reflect_pad_size = n_fft / 2;
+    if (!stream.is_start_padded) {
+        // the same reflect padding as in extract(), which needs reflect_pad_size + 1 first samples
+        if (stream.samples.size() <= reflect_pad_size) {
+            return;
+        }
+        std::vector<float> start_pad(stream.samples.begin() + 1, stream.samples.begin() + 1 + reflect_pad_size);
+        stream.samples.insert(stream.samples.begin(), start_pad.rbegin(), start_pad.rend());
+        stream.is_start_padded = true;
+    }
+
+    compute_stream_frames();
+}
+
+void WhisperFeatureExtractor::finish_stream() {
+    OPENVINO_ASSERT(stream.buffers, "Audio stream is not started");
+    const size_t reflect_pad_size = n_fft / 2;
+    if (!stream.is_start_padded) {
+        // too short stream for reflection, pad by zeros
+        stream.samples.insert(stream.samples.begin(), reflect_pad_size, 0.0f);
+        stream.is_start_padded = true;
+    }
+    stream.samples.insert(stream.samples.end(), reflect_pad_size, 0.0f);
+    compute_stream_frames();
+}
+
+void WhisperFeatureExtractor::compute_stream_frames() {
+    const size_t frames_begin = stream.frames_offset + stream.frames.size() / feature_size;
+    size_t n_new_frames = 0;
+    // samples[0] is sample stream.samples_offset of the padded stream
+    while ((frames_begin + n_new_frames) * hop_length - stream.samples_offset + n_fft <= stream.samples.size()) {
+        ++n_new_frames;
+    }
+    if (n_new_frames == 0) {
+        return;
+    }
+
+    const size_t frames_size = stream.frames.size();
+    stream.frames.resize(frames_size + n_new_frames * feature_size);
+    for (size_t i = 0; i < n_new_frames; i++) {
+        const size_t sample_offset = (frames_begin + i) * hop_length - stream.samples_offset;
+        log_mel_frame(stream.samples.data() + sample_offset,
+                      n_fft,
+                      stream.hann,
+                      fft_plan,
+                      mel_filter,
+                      *stream.buffers,
+                      stream.frames.data() + frames_size + i * feature_size,
+                      1);
+    }
+
+    // samples before the next frame are not needed anymore
+    const size_t next_offset = (frames_begin + n_new_frames) * hop_length;
+    stream.samples.erase(stream.samples.begin(), stream.samples.begin() + (next_offset - stream.samples_offset));
+    stream.samples_offset = next_offset;
+}
+
+size_t WhisperFeatureExtractor::get_stream_n_frames() const {
+    return stream.frames_offset + stream.frames.size() / feature_size;
+}
+
+void WhisperFeatureExtractor::drop_stream_frames(const size_t frame_offset) {
+    OPENVINO_ASSERT(frame_offset >= stream.frames_offset && frame_offset <= get_stream_n_frames());
+    stream.frames.erase(stream.frames.begin(),
+                        stream.frames.begin() + (frame_offset - stream.frames_offset) * feature_size);
+    stream.frames_offset = frame_offset;
+}
+
+std::vector<float> WhisperFeatureExtractor::get_stream_window(const size_t frame_offset, const size_t n_frames) const {
+    OPENVINO_ASSERT(frame_offset >= stream.frames_offset && frame_offset <= get_stream_n_frames());
+    const size_t copy_size = std::min(get_stream_n_frames() - frame_offset, n_frames);
+    const float* frames = stream.frames.data() + (frame_offset - stream.frames_offset) * feature_size;
+
+    // frames beyond the received audio are silence, as zero padding of extract()
+    std::vector<float> window(feature_size * n_frames, log10(1e-10));
+    for (size_t i = 0; i < copy_size; i++) {
+        for (size_t j = 0; j < feature_size; j++) {
+            window[j * n_frames + i] = frames[i * feature_size + j];
+        }
+    }
+    clamp_and_normalize(window);
+    return window;
 }
 
 }  // namespace genai
@@ -4,19 +4,32 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "openvino/genai/visibility.hpp"
+#include "openvino/genai/whisper_pipeline.hpp"
+#include "whisper/real_fft.hpp"
 
 namespace ov {
 namespace genai {
 
+/**
+ * Log-mel features of an input. Frames are computed for a window on demand, so that the spectrogram of the whole input
+ * is never materialised. Values are clamped by the maximum of all frames, which is found at extraction.
+ */
 struct WhisperFeatures {
+    // writes log10 mel values of frames [frame_offset, frame_offset + n_frames) to window[j * stride + i]
+    using FramesSource =
+        std::function<void(const size_t frame_offset, const size_t n_frames, float* window, const size_t stride)>;
+
     size_t feature_size;
     size_t n_frames;
 
-    // flattened 2d array with shape [feature_size, n_frames]
-    std::vector<float> data;
+    // extract() sources refer to its raw speech and the extractor, which must outlive the features
+    FramesSource compute_frames;
+    float max_log_mel = 0.0f;
 
     /**
      * Return frames with specific offset
@@ -28,7 +41,26 @@ struct WhisperFeatures {
      * ****xxxxx****
      *
      */
-    std::vector<float> get_data_with_offset(const size_t frame_offset, const size_t min_frames);
+    std::vector<float> get_data_with_offset(const size_t frame_offset, const size_t min_frames) const;
+};
+
+struct LogMelFrameBuffers;
+
+/**
+ * Mel filters in a sparse form. Triangular filters are non-zero over a short contiguous range of frequency bins only,
+ * so each filter keeps the first bin and weights of this range.
+ */
+struct MelFilterBank {
+    size_t n_frequency_bins = 0;
+    std::vector<size_t> begins;
+    std::vector<size_t> lengths;
+    // weights of the j-th filter are weights[offsets[j], offsets[j] + lengths[j])
+    std::vector<size_t> offsets;
+    std::vector<float> weights;
+
+    size_t size() const {
+        return begins.size();
+    }
 };
 
 class WhisperFeatureExtractor {
@@ -44,19 +76,72 @@ public:
     explicit WhisperFeatureExtractor(const std::filesystem::path& preprocessor_json_path);
 
     /**
-     * @brief Create a flattened 2d log-mel spectrogram [feature_size, n_frames] from raw speech data
+     * @brief Create a log-mel spectrogram [feature_size, n_frames] from raw speech data. Frames of a window are
+     * computed from raw_speech, when they are requested, and raw_speech must outlive the result.
      *
      * @see [huggingface introduction to audio
      * data](https://huggingface.co/learn/audio-course/chapter1/audio_data#mel-spectrogram)
      */
     WhisperFeatures extract(const std::vector<float>& raw_speech);
 
+    /**
+     * @brief Create the same spectrogram as extract() from an audio file, which is decoded and resampled to
+     * sampling_rate block by block and passed to the stream extraction, so that the whole waveform is not kept in
+     * memory. Frames of the stream are moved to the result, which outlives the stream. Resets the stream.
+     */
+    WhisperFeatures extract(const std::filesystem::path& audio_path, const WhisperPcmFormat& pcm_format);
+
+    /**
+     * @brief Starts incremental extraction of log-mel frames of an audio stream, resets the previous stream
+     */
+    void start_stream();
+
+    /**
+     * @brief Appends raw speech to the stream and computes all frames, which are covered by received samples.
+     * Samples of frames overlapping with the next chunk are kept until the next call.
+     */
+    void push_stream(const std::vector<float>& raw_speech);
+
+    /**
+     * @brief Pads the end of the stream and computes its remaining frames
+     */
+    void finish_stream();
+
+    /**
+     * @return Number of frames computed since start_stream()
+     */
+    size_t get_stream_n_frames() const;
+
+    /**
+     * @brief Releases frames before frame_offset, which will not be requested anymore
+     */
+    void drop_stream_frames(const size_t frame_offset);
+
+    /**
+     * @brief Returns normalized frames [frame_offset, frame_offset + n_frames) of the stream as a flattened 2d array
+     * [feature_size, n_frames]. Frames, which are not received yet, are filled as silence.
+     */
+    std::vector<float> get_stream_window(const size_t frame_offset, const size_t n_frames) const;
+
 private:
-    std::vector<float> sin_vals;
-    std::vector<float> cos_vals;
-    std::vector<float> mel_filter;
+    struct StreamState {
+        std::vector<float> hann;
+        std::shared_ptr<LogMelFrameBuffers> buffers;
+        // samples of the padded stream starting from samples_offset
+        std::vector<float> samples;
+        size_t samples_offset = 0;
+        bool is_start_padded = false;
+        // log10 mel values before normalization, flattened 2d array [n_frames, feature_size] starting from frames_offset
+        std::vector<float> frames;
+        size_t frames_offset = 0;
+    };
+
+    RealFFT fft_plan;
+    MelFilterBank mel_filter;
+    StreamState stream;
 
     void init_mel_filter();
+    void compute_stream_frames();
     void init_parameters(const std::filesystem::path& preprocessor_json_path);
 };
 
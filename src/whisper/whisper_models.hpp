@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <openvino/openvino.hpp>
 
 namespace ov {
@@ -12,6 +14,16 @@ struct WhisperInitializedModels {
     ov::InferRequest encoder;
     ov::InferRequest decoder;
     ov::InferRequest decoder_with_past;
+    // second request of the encoder model, which encodes the next long-form window during decoding, if enabled
+    std::optional<ov::InferRequest> pipelined_encoder;
+    // decoders output "cross_attention_weights" of alignment heads, which are required by word timestamps
+    bool has_cross_attention_outputs = false;
+    // decoders of a draft model, which propose tokens of greedy decoding from hidden states of the encoder, if enabled
+    std::optional<ov::InferRequest> draft_decoder;
+    std::optional<ov::InferRequest> draft_decoder_with_past;
+    // context of the accelerator, whose host memory receives hidden states of the encoder, if the encoder and the decoders
+    // run on different devices, so that the decoders read them without a copy
+    std::optional<ov::RemoteContext> hidden_state_context;
 };
 }  // namespace genai
 }  // namespace ov
@@ -32,6 +32,9 @@ WhisperGenerationConfig::WhisperGenerationConfig(const std::filesystem::path& js
     read_json_param(data, "no_timestamps_token_id", no_timestamps_token_id);
     read_json_param(data, "max_initial_timestamp_index", max_initial_timestamp_index);
     read_json_param(data, "prev_sot_token_id", prev_sot_token_id);
+    read_json_param(data, "num_beams", num_beams);
+    read_json_param(data, "length_penalty", length_penalty);
+    read_json_param(data, "alignment_heads", alignment_heads);
 
     read_json_param(data, "is_multilingual", is_multilingual);
     if (is_multilingual) {
@@ -74,8 +77,20 @@ void WhisperGenerationConfig::update_generation_config(const ov::AnyMap& config_
     read_anymap_param(config_map, "lang_to_id", lang_to_id);
     read_anymap_param(config_map, "task", task);
     read_anymap_param(config_map, "return_timestamps", return_timestamps);
+    read_anymap_param(config_map, "word_timestamps", word_timestamps);
+    read_anymap_param(config_map, "alignment_heads", alignment_heads);
     read_anymap_param(config_map, "initial_prompt", initial_prompt);
     read_anymap_param(config_map, "hotwords", hotwords);
+    read_anymap_param(config_map, "num_beams", num_beams);
+    read_anymap_param(config_map, "length_penalty", length_penalty);
+    read_anymap_param(config_map, "temperatures", temperatures);
+    read_anymap_param(config_map, "compression_ratio_threshold", compression_ratio_threshold);
+    read_anymap_param(config_map, "logprob_threshold", logprob_threshold);
+    read_anymap_param(config_map, "rng_seed", rng_seed);
+    read_anymap_param(config_map, "num_assistant_tokens", num_assistant_tokens);
+    read_anymap_param(config_map, "vad_threshold", vad_threshold);
+    read_anymap_param(config_map, "vad_min_silence_duration", vad_min_silence_duration);
+    read_anymap_param(config_map, "vad_speech_pad_duration", vad_speech_pad_duration);
 }
 
 size_t WhisperGenerationConfig::get_max_new_tokens(size_t prompt_length) const {
@@ -98,6 +113,27 @@ void WhisperGenerationConfig::validate() const {
     OPENVINO_ASSERT(eos_token_id != -1 || max_new_tokens != SIZE_MAX || max_length != SIZE_MAX,
                     "Either 'eos_token_id', or 'max_new_tokens', or 'max_length' should be defined.");
 
+    OPENVINO_ASSERT(num_beams > 0, "'num_beams' must be greater than 0");
+    OPENVINO_ASSERT(!temperatures.empty(), "'temperatures' must contain at least one temperature");
+    for (float temperature : temperatures) {
+        OPENVINO_ASSERT(temperature >= 0.0f, "'temperatures' must be non-negative. Temperature provided: ", temperature);
+    }
+    OPENVINO_ASSERT(num_assistant_tokens > 0, "'num_assistant_tokens' must be greater than 0");
+    if (compression_ratio_threshold.has_value()) {
+        OPENVINO_ASSERT(*compression_ratio_threshold >= 1.0f, "'compression_ratio_threshold' must be at least 1.0");
+    }
+
+    if (word_timestamps) {
+        OPENVINO_ASSERT(num_beams == 1 && temperatures.size() == 1 && temperatures[0] == 0.0f,
+                        "'word_timestamps' are supported with greedy decoding only");
+    }
+
+    if (vad_threshold.has_value()) {
+        OPENVINO_ASSERT(*vad_threshold <= 0.0f, "'vad_threshold' must be non-positive");
+    }
+    OPENVINO_ASSERT(vad_min_silence_duration >= 0.0f, "'vad_min_silence_duration' must be non-negative");
+    OPENVINO_ASSERT(vad_speech_pad_duration >= 0.0f, "'vad_speech_pad_duration' must be non-negative");
+
     if (is_multilingual && language.has_value()) {
         OPENVINO_ASSERT(lang_to_id.count(*language),
                         "'language' " + *language + " must be provided in generation_config.json 'lang_to_id' map.");
@@ -4,11 +4,13 @@
 #include "openvino/genai/whisper_pipeline.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <openvino/openvino.hpp>
 #include <variant>
 
 #include "utils.hpp"
+#include "whisper/alignment.hpp"
 #include "whisper/context_tokens.hpp"
 #include "whisper/streamer.hpp"
 #include "whisper/whisper.hpp"
@@ -40,6 +42,16 @@ ov::genai::ChunkStreamerVariant get_chunk_streamer_from_map(const ov::AnyMap& co
     }
     return streamer;
 }
+
+std::shared_ptr<ov::genai::ChunkStreamerBase> get_chunk_streamer_ptr(const ov::genai::ChunkStreamerVariant& streamer,
+                                                                    const ov::genai::Tokenizer& tokenizer) {
+    if (auto streamer_obj = std::get_if<std::shared_ptr<ov::genai::ChunkStreamerBase>>(&streamer)) {
+        return *streamer_obj;
+    } else if (auto callback = std::get_if<std::function<bool(std::string)>>(&streamer)) {
+        return std::make_shared<ov::genai::ChunkTextCallbackStreamer>(tokenizer, *callback);
+    }
+    return nullptr;
+}
 }  // namespace
 
 namespace ov {
@@ -54,22 +66,97 @@ public:
                                 const ov::AnyMap& properties)
         : WhisperPipelineImplBase{models_path} {
         ov::Core core = utils::singleton_core();
-        auto [core_properties, compile_properties] = ov::genai::utils::split_core_compile_config(properties);
+        ov::AnyMap pipeline_properties = properties;
+        bool is_encoder_pipelined = false;
+        if (pipeline_properties.count(ov::genai::pipelined_encoder.name())) {
+            is_encoder_pipelined = pipeline_properties.at(ov::genai::pipelined_encoder.name()).as<bool>();
+            pipeline_properties.erase(ov::genai::pipelined_encoder.name());
+        }
+        bool has_word_timestamps = false;
+        if (pipeline_properties.count(ov::genai::word_timestamps.name())) {
+            has_word_timestamps = pipeline_properties.at(ov::genai::word_timestamps.name()).as<bool>();
+            pipeline_properties.erase(ov::genai::word_timestamps.name());
+        }
+        OPENVINO_ASSERT(!has_word_timestamps || !m_generation_config.alignment_heads.empty(),
+                        "Word timestamps require 'alignment_heads' in generation_config.json");
+        std::optional<std::filesystem::path> draft_models_path;
+        if (pipeline_properties.count(ov::genai::draft_decoder.name())) {
+            draft_models_path = pipeline_properties.at(ov::genai::draft_decoder.name()).as<std::string>();
+            pipeline_properties.erase(ov::genai::draft_decoder.name());
+        }
+        std::string encoder_device = device;
+        if (pipeline_properties.count(ov::genai::encoder_device.name())) {
+            encoder_device = pipeline_properties.at(ov::genai::encoder_device.name()).as<std::string>();
+            pipeline_properties.erase(ov::genai::encoder_device.name());
+        }
+        std::string decoder_device = device;
+        if (pipeline_properties.count(ov::genai::decoder_device.name())) {
+            decoder_device = pipeline_properties.at(ov::genai::decoder_device.name()).as<std::string>();
+            pipeline_properties.erase(ov::genai::decoder_device.name());
+        }
+        auto [core_properties, compile_properties] = ov::genai::utils::split_core_compile_config(pipeline_properties);
         core.set_property(core_properties);
 
         ov::CompiledModel compiled_model;
-        compiled_model =
-            core.compile_model((models_path / "openvino_encoder_model.xml").string(), device, compile_properties);
+        compiled_model = core.compile_model((models_path / "openvino_encoder_model.xml").string(),
+                                            encoder_device,
+                                            compile_properties);
         ov::genai::utils::print_compiled_model_properties(compiled_model, "whisper encoder model");
         m_models.encoder = compiled_model.create_infer_request();
-        compiled_model =
-            core.compile_model((models_path / "openvino_decoder_model.xml").string(), device, compile_properties);
+        if (is_encoder_pipelined) {
+            m_models.pipelined_encoder = compiled_model.create_infer_request();
+        }
+        if (encoder_device != decoder_device) {
+            // host memory of an accelerator is read by CPU and by the accelerator itself without a copy, the encoder
+            // is preferred, as it writes the whole hidden state
+            const bool is_encoder_on_cpu = encoder_device.find("CPU") != std::string::npos;
+            const std::string& accelerator = is_encoder_on_cpu ? decoder_device : encoder_device;
+            const ov::PartialShape hidden_state_shape = compiled_model.output("last_hidden_state").get_partial_shape();
+            if (accelerator.find("CPU") == std::string::npos && hidden_state_shape.rank().is_static() &&
+                hidden_state_shape.size() == 3 && hidden_state_shape[1].is_static() && hidden_state_shape[2].is_static()) {
+                m_models.hidden_state_context = core.get_default_context(accelerator);
+                // whisper_generate() resizes the output for batched encoding
+                const ov::Shape shape{1,
+                                      static_cast<size_t>(hidden_state_shape[1].get_length()),
+                                      static_cast<size_t>(hidden_state_shape[2].get_length())};
+                const ov::element::Type type = compiled_model.output("last_hidden_state").get_element_type();
+                m_models.encoder.set_tensor("last_hidden_state",
+                                            m_models.hidden_state_context->create_host_tensor(type, shape));
+                if (m_models.pipelined_encoder.has_value()) {
+                    m_models.pipelined_encoder->set_tensor("last_hidden_state",
+                                                           m_models.hidden_state_context->create_host_tensor(type, shape));
+                }
+            }
+        }
+        std::shared_ptr<ov::Model> decoder_model =
+            core.read_model((models_path / "openvino_decoder_model.xml").string());
+        std::shared_ptr<ov::Model> decoder_with_past_model =
+            core.read_model((models_path / "openvino_decoder_with_past_model.xml").string());
+        if (has_word_timestamps) {
+            add_cross_attention_outputs(decoder_model, m_generation_config.alignment_heads);
+            add_cross_attention_outputs(decoder_with_past_model, m_generation_config.alignment_heads);
+            m_models.has_cross_attention_outputs = true;
+        }
+        compiled_model = core.compile_model(decoder_model, decoder_device, compile_properties);
         ov::genai::utils::print_compiled_model_properties(compiled_model, "whisper decoder model");
         m_models.decoder = compiled_model.create_infer_request();
-        compiled_model = core.compile_model(models_path / "openvino_decoder_with_past_model.xml", device, compile_properties);
+        compiled_model = core.compile_model(decoder_with_past_model, decoder_device, compile_properties);
         m_models.decoder_with_past = compiled_model.create_infer_request();
         ov::genai::utils::print_compiled_model_properties(compiled_model, "whisper decoder with past model");
 
+        if (draft_models_path.has_value()) {
+            compiled_model = core.compile_model((*draft_models_path / "openvino_decoder_model.xml").string(),
+                                                decoder_device,
+                                                compile_properties);
+            ov::genai::utils::print_compiled_model_properties(compiled_model, "whisper draft decoder model");
+            m_models.draft_decoder = compiled_model.create_infer_request();
+            compiled_model = core.compile_model((*draft_models_path / "openvino_decoder_with_past_model.xml").string(),
+                                                decoder_device,
+                                                compile_properties);
+            ov::genai::utils::print_compiled_model_properties(compiled_model, "whisper draft decoder with past model");
+            m_models.draft_decoder_with_past = compiled_model.create_infer_request();
+        }
+
         // If eos_token_id was not provided, take value
         if (m_generation_config.eos_token_id == -1) {
             m_generation_config.set_eos_token_id(m_tokenizer.get_eos_token_id());
@@ -82,15 +169,10 @@ public:
         auto start_time = std::chrono::steady_clock::now();
         WhisperGenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
         config.validate();
+        OPENVINO_ASSERT(!config.word_timestamps || m_models.has_cross_attention_outputs,
+                        "Word timestamps require the pipeline to be created with ov::genai::word_timestamps(true)");
 
-        std::shared_ptr<ChunkStreamerBase> streamer_ptr;
-        if (auto streamer_obj = std::get_if<std::monostate>(&streamer)) {
-            streamer_ptr = nullptr;
-        } else if (auto streamer_obj = std::get_if<std::shared_ptr<ChunkStreamerBase>>(&streamer)) {
-            streamer_ptr = *streamer_obj;
-        } else if (auto callback = std::get_if<std::function<bool(std::string)>>(&streamer)) {
-            streamer_ptr = std::make_shared<ChunkTextCallbackStreamer>(m_tokenizer, *callback);
-        }
+        auto streamer_ptr = get_chunk_streamer_ptr(streamer, m_tokenizer);
 
         auto [context_tokens, tokenization_duration_microseconds] = prepare_context_tokens(config, m_tokenizer);
 
@@ -101,6 +183,166 @@ public:
                                                            m_models,
                                                            m_feature_extractor,
                                                            streamer_ptr);
+        return make_decoded_results(generate_result, tokenization_duration_microseconds, start_time);
+    }
+
+    WhisperDecodedResults generate(const std::filesystem::path& audio_path,
+                                   OptionalWhisperGenerationConfig generation_config,
+                                   ChunkStreamerVariant streamer,
+                                   const WhisperPcmFormat& pcm_format) override {
+        auto start_time = std::chrono::steady_clock::now();
+        WhisperGenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
+        config.validate();
+        OPENVINO_ASSERT(!config.word_timestamps || m_models.has_cross_attention_outputs,
+                        "Word timestamps require the pipeline to be created with ov::genai::word_timestamps(true)");
+        // features of the file are extracted by the stream of the feature extractor
+        OPENVINO_ASSERT(!m_stream.has_value(), "Audio files can't be transcribed during a streaming session");
+
+        auto streamer_ptr = get_chunk_streamer_ptr(streamer, m_tokenizer);
+
+        auto [context_tokens, tokenization_duration_microseconds] = prepare_context_tokens(config, m_tokenizer);
+
+        auto generate_result = ov::genai::whisper_generate(config,
+                                                           m_model_config,
+                                                           context_tokens,
+                                                           audio_path,
+                                                           pcm_format,
+                                                           m_models,
+                                                           m_feature_extractor,
+                                                           streamer_ptr);
+        return make_decoded_results(generate_result, tokenization_duration_microseconds, start_time);
+    }
+
+    std::vector<WhisperDecodedResults> generate(const std::vector<RawSpeechInput>& raw_speech_inputs,
+                                                OptionalWhisperGenerationConfig generation_config,
+                                                size_t max_batch_size) override {
+        auto start_time = std::chrono::steady_clock::now();
+        WhisperGenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
+        config.validate();
+        OPENVINO_ASSERT(!config.word_timestamps || m_models.has_cross_attention_outputs,
+                        "Word timestamps require the pipeline to be created with ov::genai::word_timestamps(true)");
+
+        auto [context_tokens, tokenization_duration_microseconds] = prepare_context_tokens(config, m_tokenizer);
+
+        auto generate_results = ov::genai::whisper_generate_batch(config,
+                                                                  m_model_config,
+                                                                  context_tokens,
+                                                                  raw_speech_inputs,
+                                                                  m_models,
+                                                                  m_feature_extractor,
+                                                                  max_batch_size);
+
+        std::vector<WhisperDecodedResults> results;
+        results.reserve(generate_results.size());
+        for (auto& generate_result : generate_results) {
+            results.push_back(make_decoded_results(generate_result, tokenization_duration_microseconds, start_time));
+        }
+        return results;
+    }
+
+    void start_stream(OptionalWhisperGenerationConfig generation_config,
+                      ChunkStreamerVariant streamer,
+                      const WhisperStreamingConfig& streaming_config) override {
+        m_stream_start_time = std::chrono::steady_clock::now();
+        WhisperGenerationConfig config = (generation_config.has_value()) ? *generation_config : m_generation_config;
+        config.validate();
+        OPENVINO_ASSERT(!config.word_timestamps, "Word timestamps are not supported by streaming sessions");
+        OPENVINO_ASSERT(streaming_config.step_duration >= 0.0f && streaming_config.lookahead_duration >= 0.0f,
+                        "step_duration and lookahead_duration of WhisperStreamingConfig must be non-negative");
+
+        m_stream = WhisperStreamState{};
+        m_stream->config = config;
+        m_stream->streaming_config = streaming_config;
+        m_stream->streamer = get_chunk_streamer_ptr(streamer, m_tokenizer);
+
+        auto [context_tokens, tokenization_duration_microseconds] = prepare_context_tokens(config, m_tokenizer);
+        m_stream->context_tokens = context_tokens;
+        m_stream_tokenization_duration = tokenization_duration_microseconds;
+
+        RawPerfMetrics& raw_metrics = m_stream->result.perf_metrics.raw_metrics;
+        m_stream->result.perf_metrics.num_input_tokens = 0;
+        raw_metrics.m_inference_durations = {{MicroSeconds(0.0f)}};
+
+        m_feature_extractor.start_stream();
+    }
+
+    bool push_audio(const RawSpeechInput& audio_chunk) override {
+        OPENVINO_ASSERT(m_stream.has_value(), "Streaming session is not started, call start_stream() first");
+
+        const auto extraction_start = std::chrono::steady_clock::now();
+        m_feature_extractor.push_stream(audio_chunk);
+        m_stream->result.perf_metrics.whisper_raw_metrics.features_extraction_durations.emplace_back(
+            PerfMetrics::get_microsec(std::chrono::steady_clock::now() - extraction_start));
+
+        return whisper_stream_step(*m_stream, m_model_config, m_models, m_feature_extractor, false);
+    }
+
+    WhisperDecodedResults finish_stream() override {
+        OPENVINO_ASSERT(m_stream.has_value(), "Streaming session is not started, call start_stream() first");
+
+        const auto extraction_start = std::chrono::steady_clock::now();
+        m_feature_extractor.finish_stream();
+        m_stream->result.perf_metrics.whisper_raw_metrics.features_extraction_durations.emplace_back(
+            PerfMetrics::get_microsec(std::chrono::steady_clock::now() - extraction_start));
+
+        whisper_stream_step(*m_stream, m_model_config, m_models, m_feature_extractor, true);
+        if (m_stream->streamer) {
+            m_stream->streamer->end();
+        }
+
+        WhisperGenerateResult generate_result = std::move(m_stream->result);
+        if (!m_stream->config.return_timestamps) {
+            generate_result.segments = std::nullopt;
+        }
+        m_stream.reset();
+        // releases samples and frames of the finished stream
+        m_feature_extractor.start_stream();
+
+        return make_decoded_results(generate_result, m_stream_tokenization_duration, m_stream_start_time);
+    }
+
+private:
+    std::optional<WhisperStreamState> m_stream;
+    std::chrono::steady_clock::time_point m_stream_start_time;
+    float m_stream_tokenization_duration = 0.0f;
+
+    // Groups timed tokens into words: a token starting with a space starts a new word, other tokens including
+    // punctuation continue the current one. Tokens are decoded at once, then words are.
+    std::vector<WhisperDecodedResultWord> make_words(const std::vector<TokenTimestamp>& token_timestamps) {
+        std::vector<std::vector<int64_t>> single_tokens;
+        single_tokens.reserve(token_timestamps.size());
+        for (const auto& timestamp : token_timestamps) {
+            single_tokens.push_back({timestamp.m_token});
+        }
+        const std::vector<std::string> token_texts =
+            single_tokens.empty() ? std::vector<std::string>{} : m_tokenizer.decode(single_tokens);
+
+        std::vector<WhisperDecodedResultWord> words;
+        std::vector<std::vector<int64_t>> word_tokens;
+        for (size_t i = 0; i < token_timestamps.size(); ++i) {
+            const auto& timestamp = token_timestamps[i];
+            const std::string& text = token_texts[i];
+            const bool starts_word = !text.empty() && std::isspace(static_cast<unsigned char>(text[0]));
+            if (words.empty() || starts_word) {
+                words.push_back(WhisperDecodedResultWord{timestamp.m_start, timestamp.m_end, ""});
+                word_tokens.push_back({});
+            }
+            words.back().end_ts = std::max(words.back().end_ts, timestamp.m_end);
+            word_tokens.back().push_back(timestamp.m_token);
+        }
+
+        if (!word_tokens.empty()) {
+            const std::vector<std::string> word_texts = m_tokenizer.decode(word_tokens);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i].word = word_texts[i];
+            }
+        }
+        return words;
+    }
+
+    WhisperDecodedResults make_decoded_results(WhisperGenerateResult& generate_result,
+                                               float tokenization_duration_microseconds,
+                                               std::chrono::steady_clock::time_point start_time) {
         auto decode_start_time = std::chrono::steady_clock::now();
         WhisperDecodedResults result{std::vector{m_tokenizer.decode(generate_result.output_tokens)}, std::vector{1.f}};
         generate_result.perf_metrics.raw_metrics.detokenization_durations.emplace_back(
@@ -126,6 +368,13 @@ public:
             result.chunks = chunks;
         }
 
+        if (generate_result.token_timestamps.has_value()) {
+            decode_start_time = std::chrono::steady_clock::now();
+            result.words = make_words(*generate_result.token_timestamps);
+            result.perf_metrics.raw_metrics.detokenization_durations.emplace_back(
+                PerfMetrics::get_microsec(std::chrono::steady_clock::now() - decode_start_time));
+        }
+
         auto& metrics = result.perf_metrics;
         metrics.load_time = this->m_load_time_ms;
         auto stop_time = std::chrono::steady_clock::now();
@@ -181,6 +430,42 @@ ov::genai::WhisperDecodedResults ov::genai::WhisperPipeline::generate(const RawS
     return m_impl->generate(raw_speech_input, config, get_chunk_streamer_from_map(config_map));
 }
 
+ov::genai::WhisperDecodedResults ov::genai::WhisperPipeline::generate(const std::filesystem::path& audio_path,
+                                                                      OptionalWhisperGenerationConfig generation_config,
+                                                                      ChunkStreamerVariant streamer,
+                                                                      const WhisperPcmFormat& pcm_format) {
+    return m_impl->generate(audio_path, generation_config, streamer, pcm_format);
+}
+
+std::vector<ov::genai::WhisperDecodedResults> ov::genai::WhisperPipeline::generate(
+    const std::vector<RawSpeechInput>& raw_speech_inputs,
+    OptionalWhisperGenerationConfig generation_config,
+    size_t max_batch_size) {
+    return m_impl->generate(raw_speech_inputs, generation_config, max_batch_size);
+}
+
+void ov::genai::WhisperPipeline::start_stream(OptionalWhisperGenerationConfig generation_config,
+                                             ChunkStreamerVariant streamer,
+                                             const WhisperStreamingConfig& streaming_config) {
+    m_impl->start_stream(generation_config, streamer, streaming_config);
+}
+
+bool ov::genai::WhisperPipeline::push_audio(const RawSpeechInput& audio_chunk) {
+    return m_impl->push_audio(audio_chunk);
+}
+
+ov::genai::WhisperDecodedResults ov::genai::WhisperPipeline::finish_stream() {
+    return m_impl->finish_stream();
+}
+
+void ov::genai::WhisperPipeline::warmup(size_t max_new_tokens) {
+    WhisperGenerationConfig config = get_generation_config();
+    config.max_new_tokens = max_new_tokens;
+    // a second of silence at 16 kHz, the sampling rate of Whisper feature extractors
+    const RawSpeechInput silence(16000, 0.0f);
+    m_impl->generate(silence, config, std::monostate());
+}
+
 ov::genai::WhisperGenerationConfig ov::genai::WhisperPipeline::get_generation_config() const {
     return m_impl->m_generation_config;
 }
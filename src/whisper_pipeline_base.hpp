@@ -4,6 +4,7 @@
 #pragma once
 
 #include "openvino/genai/whisper_pipeline.hpp"
+#include "whisper/audio_decoder.hpp"
 #include "whisper/whisper_config.hpp"
 #include "whisper/whisper_feature_extractor.hpp"
 
@@ -32,6 +33,44 @@ public:
                                            OptionalWhisperGenerationConfig generation_config,
                                            ChunkStreamerVariant streamer) = 0;
 
+    // implementations without feature extraction of a stream decode the whole file first
+    virtual WhisperDecodedResults generate(const std::filesystem::path& audio_path,
+                                           OptionalWhisperGenerationConfig generation_config,
+                                           ChunkStreamerVariant streamer,
+                                           const WhisperPcmFormat& pcm_format) {
+        RawSpeechInput raw_speech_input;
+        read_audio(audio_path, pcm_format, m_feature_extractor.sampling_rate, [&](const std::vector<float>& samples) {
+            raw_speech_input.insert(raw_speech_input.end(), samples.begin(), samples.end());
+        });
+        return generate(raw_speech_input, generation_config, streamer);
+    }
+
+    // implementations without batched infers process inputs one by one
+    virtual std::vector<WhisperDecodedResults> generate(const std::vector<RawSpeechInput>& raw_speech_inputs,
+                                                        OptionalWhisperGenerationConfig generation_config,
+                                                        size_t max_batch_size) {
+        std::vector<WhisperDecodedResults> results;
+        results.reserve(raw_speech_inputs.size());
+        for (const auto& raw_speech_input : raw_speech_inputs) {
+            results.push_back(generate(raw_speech_input, generation_config, std::monostate()));
+        }
+        return results;
+    }
+
+    virtual void start_stream(OptionalWhisperGenerationConfig generation_config,
+                              ChunkStreamerVariant streamer,
+                              const WhisperStreamingConfig& streaming_config) {
+        OPENVINO_THROW("Streaming transcription is not supported by this WhisperPipeline implementation");
+    }
+
+    virtual bool push_audio(const RawSpeechInput& audio_chunk) {
+        OPENVINO_THROW("Streaming transcription is not supported by this WhisperPipeline implementation");
+    }
+
+    virtual WhisperDecodedResults finish_stream() {
+        OPENVINO_THROW("Streaming transcription is not supported by this WhisperPipeline implementation");
+    }
+
     virtual ~WhisperPipelineImplBase() = default;
 };
 
@@ -142,8 +142,11 @@ int64_t decode(ov::Tensor& encoder_hidden_state,
                const ov::genai::WhisperGenerationConfig& config,
                const bool apply_logit_processors = true,
                const bool return_timestamps = false) {
-    // NB: Fill decoder inputs
-    encoder_hidden_state.copy_to(decoder.get_tensor("encoder_hidden_states"));
+    // NB: Fill decoder inputs, encoder may write its output directly to them
+    auto encoder_hidden_states = decoder.get_tensor("encoder_hidden_states");
+    if (encoder_hidden_state.data() != encoder_hidden_states.data()) {
+        encoder_hidden_state.copy_to(encoder_hidden_states);
+    }
     set_decoder_input_ids_attention_mask(decoder, init_ids, config.pad_token_id);
 
     decoder.infer();
@@ -151,12 +154,7 @@ int64_t decode(ov::Tensor& encoder_hidden_state,
     auto output_tensor = decoder.get_tensor("logits");
 
     if (apply_logit_processors) {
-        ov::genai::do_suppress_tokens(output_tensor, 0, config.begin_suppress_tokens);
-        ov::genai::do_suppress_tokens(output_tensor, 0, config.suppress_tokens);
-
-        if (return_timestamps) {
-            ov::genai::process_whisper_timestamp_logits(output_tensor, 0, config, {}, true);
-        }
+        ov::genai::process_whisper_logits(output_tensor, 0, config, {}, return_timestamps, true);
     }
 
     int64_t output_token = ov::genai::utils::argmax(output_tensor, 0);
@@ -178,11 +176,7 @@ int64_t decode_with_past(ov::InferRequest& decoder_with_past,
     decoder_with_past.infer();
 
     auto output_tensor = decoder_with_past.get_tensor("logits");
-    ov::genai::do_suppress_tokens(output_tensor, 0, config.suppress_tokens);
-
-    if (return_timestamps) {
-        ov::genai::process_whisper_timestamp_logits(output_tensor, 0, config, generated_tokens);
-    }
+    ov::genai::process_whisper_logits(output_tensor, 0, config, generated_tokens, return_timestamps);
 
     int64_t output_token = ov::genai::utils::argmax(output_tensor, 0);
     return output_token;
@@ -199,7 +193,9 @@ void zero_past_key_values(ov::InferRequest& request) {
     }
 }
 
-void prepare_decoder_with_past(ov::InferRequest& decoder_with_past, ov::InferRequest& decoder) {
+void prepare_decoder_with_past(ov::InferRequest& decoder_with_past,
+                               ov::InferRequest& decoder,
+                               const bool is_kvcache_shared) {
     // NB: Prepare attetion mask to be in a format [0, 0, 0, 1, 1, 1, 1, ..., 0, 1]
     // Mask should be inverted for decoder_with_past 
     auto attention_mask = decoder_with_past.get_tensor("attention_mask");
@@ -208,6 +204,11 @@ void prepare_decoder_with_past(ov::InferRequest& decoder_with_past, ov::InferReq
     std::fill(attention_mask_ptr + 3u, attention_mask_ptr + attention_mask.get_size() - 2, 1);
     attention_mask_ptr[attention_mask.get_size() - 2] = 0;
     attention_mask_ptr[attention_mask.get_size() - 1] = 1;
+    if (is_kvcache_shared) {
+        // NB: decoder has already written cross-attention and its self-attention KV-cache
+        // to decoder_with_past inputs, stale positions of the previous chunk are masked
+        return;
+    }
     // NB: Zero past_key_values.*.decoder.value tensors
     zero_past_key_values(decoder_with_past);
     // NB: Copy KV-caches from decoder
@@ -215,6 +216,76 @@ void prepare_decoder_with_past(ov::InferRequest& decoder_with_past, ov::InferReq
     update_past_key_value(decoder, decoder_with_past);
 };
 
+size_t get_kvcache_capacity(ov::InferRequest& decoder_with_past) {
+    // NB: attention_mask covers past_key_values positions and two more ones
+    return decoder_with_past.get_tensor("attention_mask").get_size() - 2;
+}
+
+void hand_over_kvcache(ov::InferRequest& source, ov::InferRequest& dest, const size_t kv_size) {
+    // NB: Cross-attention KV-cache is shared, the first kv_size positions of self-attention KV-cache are copied
+    for (auto& input : source.get_compiled_model().inputs()) {
+        const std::string input_name = input.get_any_name();
+        if (input_name.find("past_key_values") == std::string::npos) {
+            continue;
+        }
+        auto src_kv_tensor = source.get_tensor(input_name);
+        if (input_name.find("encoder") != std::string::npos) {
+            dest.set_tensor(input_name, src_kv_tensor);
+            continue;
+        }
+        auto dst_kv_tensor = dest.get_tensor(input_name);
+        make_tensor_slice(src_kv_tensor, 2u, 0u, kv_size).copy_to(make_tensor_slice(dst_kv_tensor, 2u, 0u, kv_size));
+    }
+
+    // NB: The same mask format as in prepare_decoder_with_past(), positions of the larger KV-cache are masked
+    auto attention_mask = dest.get_tensor("attention_mask");
+    auto* attention_mask_ptr = attention_mask.data<ov::float16>();
+    std::fill(attention_mask_ptr, attention_mask_ptr + kv_size, 0);
+    std::fill(attention_mask_ptr + kv_size, attention_mask_ptr + attention_mask.get_size() - 2, 1);
+    attention_mask_ptr[attention_mask.get_size() - 2] = 0;
+    attention_mask_ptr[attention_mask.get_size() - 1] = 1;
+}
+
+bool share_kvcache_tensors(ov::InferRequest& encoder, ov::InferRequest& decoder, ov::InferRequest& decoder_with_past) {
+    /* NB: Bind preallocated tensors once, so that no copy is needed per chunk:
+       - encoder writes last_hidden_state directly to decoder input
+       - decoder writes cross-attention KV-cache (present.*.encoder.*) directly to decoder_with_past inputs
+       - decoder writes self-attention KV-cache (present.*.decoder.*) to the first positions of decoder_with_past inputs
+       Plugins, which don't accept such tensors (e.g. strided slices), keep the default copying.
+    */
+    std::vector<std::pair<ov::InferRequest*, std::string>> bound_outputs;
+    try {
+        encoder.set_tensor("last_hidden_state", decoder.get_tensor("encoder_hidden_states"));
+        bound_outputs.emplace_back(&encoder, "last_hidden_state");
+
+        for (auto& source_output : decoder.get_compiled_model().outputs()) {
+            const std::string output_name = source_output.get_any_name();
+            if (output_name.find("present") == std::string::npos) {
+                continue;
+            }
+            const std::string with_past_input_name =
+                std::regex_replace(output_name, std::regex("present"), "past_key_values");
+            auto dst_kv_tensor = decoder_with_past.get_tensor(with_past_input_name);
+
+            if (output_name.find("encoder") != std::string::npos) {
+                decoder.set_tensor(output_name, dst_kv_tensor);
+            } else {
+                const auto kv_size = decoder.get_tensor(output_name).get_shape()[2];
+                decoder.set_tensor(output_name, make_tensor_slice(dst_kv_tensor, 2u, 0u, kv_size));
+            }
+            bound_outputs.emplace_back(&decoder, output_name);
+        }
+    } catch (const std::exception&) {
+        // NB: Restore own outputs for the tensors, which were already bound
+        for (auto& [request, output_name] : bound_outputs) {
+            const auto output_tensor = request->get_tensor(output_name);
+            request->set_tensor(output_name, ov::Tensor(output_tensor.get_element_type(), output_tensor.get_shape()));
+        }
+        return false;
+    }
+    return true;
+}
+
 int64_t detect_language(ov::Tensor& encoder_hidden_state,
                         ov::InferRequest decoder,
                         const ov::genai::WhisperGenerationConfig& config) {
@@ -286,9 +357,11 @@ std::vector<int32_t> prepare_init_ids(ov::Tensor& encoder_hidden_state,
 std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_state,
                                                   const ov::genai::WhisperGenerationConfig& config,
                                                   ov::genai::WhisperInitializedModels& models,
+                                                  std::vector<ov::InferRequest>& decoders_with_past,
                                                   std::vector<int32_t> init_ids,
                                                   const size_t max_new_tokens,
                                                   const bool return_timestamps,
+                                                  const bool is_kvcache_shared,
                                                   const std::shared_ptr<ov::genai::ChunkStreamerBase> streamer) {
     int64_t output_token = decode(encoder_hidden_state, models.decoder, init_ids, config, true, return_timestamps);
     std::vector<int64_t> output_tokens{output_token};
@@ -301,16 +374,25 @@ std::pair<bool, std::vector<int64_t>> full_decode(ov::Tensor& encoder_hidden_sta
         return {false, output_tokens};
     }
 
-    prepare_decoder_with_past(models.decoder_with_past, models.decoder);
+    // NB: Decoding starts with the smallest KV-cache, which is handed over to the next one when it is full
+    size_t bucket = 0;
+    prepare_decoder_with_past(decoders_with_past[bucket], models.decoder, is_kvcache_shared);
 
     for (size_t i = 0; i < max_new_tokens - 1; i++) {
-        auto output_token = decode_with_past(models.decoder_with_past,
+        const size_t position_id = i + init_ids.size();
+        if (bucket + 1 < decoders_with_past.size() && position_id >= get_kvcache_capacity(decoders_with_past[bucket])) {
+            hand_over_kvcache(decoders_with_past[bucket], decoders_with_past[bucket + 1], position_id);
+            ++bucket;
+        }
+        auto& decoder_with_past = decoders_with_past[bucket];
+
+        auto output_token = decode_with_past(decoder_with_past,
                                              output_tokens.back(),
-                                             i + init_ids.size(),
+                                             position_id,
                                              config,
                                              return_timestamps,
                                              output_tokens);
-        update_past_key_value(models.decoder_with_past, models.decoder_with_past, i + init_ids.size());
+        update_past_key_value(decoder_with_past, decoder_with_past, position_id);
 
         if (output_token == config.eos_token_id) {
             break;
@@ -541,19 +623,17 @@ WhisperPipeline::StaticWhisperPipeline::StaticWhisperPipeline(const std::filesys
     }
 
     size_t max_sequence_length = 448;
+    // NB: decoder_with_past is compiled for growing KV-cache sizes, so that short sequences
+    // don't attend over the whole padded KV-cache of max_sequence_length
+    const std::vector<size_t> kvcache_sizes{64u, 128u, max_sequence_length};
 
     reshape_to_static_encoder(encoder_model, m_feature_extractor.feature_size);
 
     auto last_hidden_state_shape = get_encoder_hidden_state_shape(encoder_model);
     reshape_to_static(decoder_model, 4, 4, last_hidden_state_shape);
-    reshape_to_static(decoder_with_past_model, 1, max_sequence_length, last_hidden_state_shape);
-
-    // Replace KV-tensors for the entire cache to tensors only for new token
-    decoder_with_past_model = redirect_new_kv_to_output(decoder_with_past_model);
 
     preprocess_encoder(encoder_model);
     preprocess_decoder(decoder_model);
-    preprocess_decoder(decoder_with_past_model);
 
     ov::CompiledModel compiled_model;
     compiled_model = core.compile_model(encoder_model, "NPU");
@@ -562,9 +642,24 @@ WhisperPipeline::StaticWhisperPipeline::StaticWhisperPipeline(const std::filesys
     compiled_model = core.compile_model(decoder_model, "NPU");
     ov::genai::utils::print_compiled_model_properties(compiled_model, "Static Whisper decoder model");
     m_models.decoder = compiled_model.create_infer_request();
-    compiled_model = core.compile_model(decoder_with_past_model, "NPU");
-    ov::genai::utils::print_compiled_model_properties(compiled_model, "Static Whisper decoder with past model");
-    m_models.decoder_with_past = compiled_model.create_infer_request();
+    for (const size_t kvcache_size : kvcache_sizes) {
+        auto bucket_model = decoder_with_past_model->clone();
+        reshape_to_static(bucket_model, 1, kvcache_size, last_hidden_state_shape);
+        // Replace KV-tensors for the entire cache to tensors only for new token
+        bucket_model = redirect_new_kv_to_output(bucket_model);
+        preprocess_decoder(bucket_model);
+
+        compiled_model = core.compile_model(bucket_model, "NPU");
+        ov::genai::utils::print_compiled_model_properties(
+            compiled_model,
+            ("Static Whisper decoder with past model, KV-cache size " + std::to_string(kvcache_size)).c_str());
+        m_decoders_with_past.push_back(compiled_model.create_infer_request());
+        // NB: KV-cache buffers are reused by all chunks, positions beyond the current one are masked
+        zero_past_key_values(m_decoders_with_past.back());
+    }
+    m_models.decoder_with_past = m_decoders_with_past.front();
+
+    m_is_kvcache_shared = share_kvcache_tensors(m_models.encoder, m_models.decoder, m_models.decoder_with_past);
 
     // If eos_token_id was not provided, take value
     if (m_generation_config.eos_token_id == -1) {
@@ -581,6 +676,10 @@ WhisperDecodedResults WhisperPipeline::StaticWhisperPipeline::generate(
 
     OPENVINO_ASSERT(!config.initial_prompt.has_value(), "'initial_prompt' parameter is not supported on NPU device.");
     OPENVINO_ASSERT(!config.hotwords.has_value(), "'hotwords' parameter is not supported on NPU device.");
+    OPENVINO_ASSERT(!config.word_timestamps, "'word_timestamps' parameter is not supported on NPU device.");
+    OPENVINO_ASSERT(config.num_beams == 1, "'num_beams' parameter is not supported on NPU device.");
+    OPENVINO_ASSERT(config.temperatures.size() == 1 && config.temperatures[0] == 0.0f,
+                    "'temperatures' parameter is not supported on NPU device.");
 
     std::shared_ptr<ChunkStreamerBase> streamer_ptr;
     if (auto streamer_obj = std::get_if<std::monostate>(&streamer)) {
@@ -629,9 +728,11 @@ WhisperDecodedResults WhisperPipeline::StaticWhisperPipeline::generate(
         auto [cancelled, chunk_output_tokens] = full_decode(hidden_state_tensor,
                                                             config,
                                                             m_models,
+                                                            m_decoders_with_past,
                                                             init_ids,
                                                             max_new_tokens - output_tokens.size(),
                                                             return_timestamps,
+                                                            m_is_kvcache_shared,
                                                             streamer_ptr);
 
         if (return_timestamps) {
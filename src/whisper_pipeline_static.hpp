@@ -5,6 +5,7 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "openvino/genai/streamer_base.hpp"
 #include "openvino/genai/tokenizer.hpp"
@@ -25,6 +26,10 @@ public:
 
 private:
     WhisperInitializedModels m_models;
+    // decoder_with_past requests for growing KV-cache sizes, m_models.decoder_with_past is the first one
+    std::vector<ov::InferRequest> m_decoders_with_past;
+    // encoder output and decoder KV-cache outputs are bound to inputs of the next model
+    bool m_is_kvcache_shared = false;
 };
 
 }  // namespace genai
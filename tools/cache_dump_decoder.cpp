@@ -0,0 +1,155 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Decodes a binary KV cache state dump written by ContinuousBatchingPipeline, when OPENVINO_GENAI_CACHE_DUMP environment
+// variable is set (see BinaryCacheStateDumper in src/cache_state_dumper.hpp for the file layout), and prints each record
+// as a JSON line. Without --blocks, block tables are summarized by numbers of blocks and shared blocks per sequence.
+//
+// Usage:
+//   cache_dump_decoder <dump file> [--blocks]
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+constexpr char MAGIC[8] = {'O', 'V', 'G', 'C', 'D', 'U', 'M', 'P'};
+constexpr uint32_t VERSION = 1;
+
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    T read() {
+        if (m_offset + sizeof(T) > m_size)
+            throw std::runtime_error("Unexpected end of KV cache state dump");
+        T value;
+        std::memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    const uint8_t* current() const {
+        return m_data + m_offset;
+    }
+
+    void skip(size_t size) {
+        if (m_offset + size > m_size)
+            throw std::runtime_error("Unexpected end of KV cache state dump");
+        m_offset += size;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+nlohmann::ordered_json decode_record(Reader& reader, bool print_blocks) {
+    nlohmann::ordered_json record;
+    record["step"] = reader.read<uint64_t>();
+    record["time_us"] = reader.read<uint64_t>();
+    const uint32_t total_blocks = reader.read<uint32_t>();
+    const uint32_t free_blocks = reader.read<uint32_t>();
+    const uint32_t overwriteable_blocks = reader.read<uint32_t>();
+    record["total_blocks"] = total_blocks;
+    record["free_blocks"] = free_blocks;
+    record["overwriteable_blocks"] = overwriteable_blocks;
+    record["used_blocks"] = total_blocks - free_blocks - overwriteable_blocks;
+    record["prefix_cache_hit_tokens"] = reader.read<uint64_t>();
+
+    nlohmann::ordered_json sequences = nlohmann::ordered_json::array();
+    const uint32_t num_sequences = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < num_sequences; ++i) {
+        nlohmann::ordered_json sequence;
+        const uint64_t request_id = reader.read<uint64_t>();
+        // sequences, which are not owned by a request, are marked by the max value
+        sequence["request_id"] = request_id == UINT64_MAX ? nlohmann::ordered_json() : nlohmann::ordered_json(request_id);
+        sequence["sequence_id"] = reader.read<uint64_t>();
+        const uint32_t num_blocks = reader.read<uint32_t>();
+        nlohmann::ordered_json blocks = nlohmann::ordered_json::array();
+        size_t num_shared_blocks = 0;
+        for (uint32_t j = 0; j < num_blocks; ++j) {
+            const uint32_t index = reader.read<uint32_t>(), references_count = reader.read<uint32_t>();
+            num_shared_blocks += references_count > 1;
+            if (print_blocks)
+                blocks.push_back({index, references_count});
+        }
+        sequence["num_blocks"] = num_blocks;
+        sequence["num_shared_blocks"] = num_shared_blocks;
+        if (print_blocks)
+            sequence["blocks"] = blocks;
+        sequences.push_back(sequence);
+    }
+    record["sequences"] = sequences;
+
+    nlohmann::ordered_json evictions = nlohmann::ordered_json::array();
+    const uint32_t num_evicted_sequences = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < num_evicted_sequences; ++i) {
+        nlohmann::ordered_json eviction;
+        eviction["sequence_id"] = reader.read<uint64_t>();
+        nlohmann::ordered_json logical_blocks_per_layer = nlohmann::ordered_json::array();
+        const uint32_t num_layers = reader.read<uint32_t>();
+        for (uint32_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
+            std::vector<uint32_t> logical_blocks(reader.read<uint32_t>());
+            for (uint32_t& logical_block : logical_blocks)
+                logical_block = reader.read<uint32_t>();
+            logical_blocks_per_layer.push_back(logical_blocks);
+        }
+        eviction["logical_blocks"] = logical_blocks_per_layer;
+        evictions.push_back(eviction);
+    }
+    record["evictions"] = evictions;
+    return record;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) try {
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[2]) != "--blocks"))
+        throw std::runtime_error(std::string{"Usage: "} + argv[0] + " <dump file> [--blocks]");
+    const bool print_blocks = argc == 3;
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error(std::string{"Failed to open "} + argv[1]);
+    const std::vector<uint8_t> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    Reader reader(data.data(), data.size());
+    char magic[sizeof(MAGIC)];
+    for (char& c : magic)
+        c = reader.read<char>();
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error(std::string{argv[1]} + " is not a KV cache state dump");
+    const uint32_t version = reader.read<uint32_t>();
+    if (version != VERSION)
+        throw std::runtime_error("Unsupported version of KV cache state dump: " + std::to_string(version));
+
+    nlohmann::ordered_json header;
+    header["interval"] = reader.read<uint32_t>();
+    header["num_records_taken"] = reader.read<uint64_t>();
+    const uint64_t num_records = reader.read<uint64_t>();
+    header["num_records"] = num_records;
+    std::cout << header.dump() << '\n';
+
+    for (uint64_t i = 0; i < num_records; ++i) {
+        const uint32_t size = reader.read<uint32_t>();
+        Reader record_reader(reader.current(), size);
+        reader.skip(size);
+        std::cout << decode_record(record_reader, print_blocks).dump() << '\n';
+    }
+    return EXIT_SUCCESS;
+} catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,288 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Replays a workload of requests against ContinuousBatchingPipeline and reports throughput, latency percentiles,
+// KV cache usage and preemptions as JSON, optionally for each combination of swept SchedulerConfig parameters.
+//
+// Usage:
+//   continuous_batching_benchmark --models_path <dir> [--device CPU] [--num_requests 100] [--request_rate 0]
+//       [--prompt_len 128] [--output_len 128] [--len_jitter 0] [--shared_prefix_ratio 0] [--trace <file>]
+//       [--max_num_batched_tokens 256[,...]] [--cache_size 1[,...]] [--max_num_seqs 256[,...]]
+//       [--enable_prefix_caching 0[,1]] [--seed 42] [--output <file>]
+//
+// Requests arrive as a Poisson process with --request_rate requests per second, or all at once if it's 0.
+// Prompt and output lengths are uniformly distributed within +-len_jitter fraction of --prompt_len and --output_len,
+// unless they are read from a trace: a JSON array of objects with "prompt_len", "output_len" and optionally
+// "arrival_time_ms" fields. Leading --shared_prefix_ratio fraction of each prompt is the same for all requests.
+// Parameters taking comma separated values are swept, a run is performed for each combination of them.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openvino/genai/continuous_batching_pipeline.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct WorkloadRequest {
+    size_t prompt_len;
+    size_t output_len;
+    double arrival_time_ms;
+};
+
+struct RequestResult {
+    ov::genai::RequestTimings timings;
+    double e2e_latency_ms = 0.0;
+    size_t num_generated_tokens = 0;
+};
+
+using Arguments = std::map<std::string, std::string>;
+
+Arguments parse_arguments(int argc, char* argv[]) {
+    Arguments arguments;
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        OPENVINO_ASSERT(name.rfind("--", 0) == 0 && i + 1 < argc, "Expected '--<name> <value>' arguments, got ", name);
+        arguments[name.substr(2)] = argv[i + 1];
+    }
+    return arguments;
+}
+
+std::string get_argument(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    auto it = arguments.find(name);
+    return it == arguments.end() ? default_value : it->second;
+}
+
+std::vector<size_t> get_sweep(const Arguments& arguments, const std::string& name, size_t default_value) {
+    std::vector<size_t> values;
+    std::stringstream stream(get_argument(arguments, name, std::to_string(default_value)));
+    for (std::string value; std::getline(stream, value, ',');) {
+        values.push_back(std::stoul(value));
+    }
+    return values;
+}
+
+std::vector<WorkloadRequest> make_workload(const Arguments& arguments, std::mt19937& rng) {
+    std::vector<WorkloadRequest> workload;
+    const std::string trace_path = get_argument(arguments, "trace", "");
+    if (!trace_path.empty()) {
+        std::ifstream file(trace_path);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", trace_path);
+        for (const auto& entry : nlohmann::json::parse(file)) {
+            workload.push_back({entry.at("prompt_len").get<size_t>(), entry.at("output_len").get<size_t>(),
+                                entry.value("arrival_time_ms", -1.0)});
+        }
+    } else {
+        const size_t num_requests = std::stoul(get_argument(arguments, "num_requests", "100"));
+        const double prompt_len = std::stod(get_argument(arguments, "prompt_len", "128"));
+        const double output_len = std::stod(get_argument(arguments, "output_len", "128"));
+        const double jitter = std::stod(get_argument(arguments, "len_jitter", "0"));
+        std::uniform_real_distribution<double> scale(1.0 - jitter, 1.0 + jitter);
+        for (size_t i = 0; i < num_requests; ++i) {
+            workload.push_back({std::max<size_t>(1, std::lround(prompt_len * scale(rng))),
+                                std::max<size_t>(1, std::lround(output_len * scale(rng))), -1.0});
+        }
+    }
+
+    // requests without arrival times from the trace follow Poisson process
+    const double request_rate = std::stod(get_argument(arguments, "request_rate", "0"));
+    std::exponential_distribution<double> inter_arrival_s(request_rate > 0.0 ? request_rate : 1.0);
+    double arrival_time_ms = 0.0;
+    for (auto& request : workload) {
+        if (request.arrival_time_ms < 0.0) {
+            if (request_rate > 0.0)
+                arrival_time_ms += inter_arrival_s(rng) * 1000.0;
+            request.arrival_time_ms = arrival_time_ms;
+        }
+    }
+    std::stable_sort(workload.begin(), workload.end(), [](const WorkloadRequest& lhs, const WorkloadRequest& rhs) {
+        return lhs.arrival_time_ms < rhs.arrival_time_ms;
+    });
+    return workload;
+}
+
+// prompts consist of random tokens, their leading part is shared by all requests to exercise prefix caching
+std::vector<ov::Tensor> make_prompts(const std::vector<WorkloadRequest>& workload, double shared_prefix_ratio, std::mt19937& rng) {
+    std::uniform_int_distribution<int64_t> token(100, 10000);
+    size_t max_prompt_len = 0;
+    for (const auto& request : workload)
+        max_prompt_len = std::max(max_prompt_len, request.prompt_len);
+    std::vector<int64_t> shared_prefix(max_prompt_len);
+    std::generate(shared_prefix.begin(), shared_prefix.end(), [&] { return token(rng); });
+
+    std::vector<ov::Tensor> prompts;
+    for (const auto& request : workload) {
+        ov::Tensor prompt(ov::element::i64, {1, request.prompt_len});
+        int64_t* data = prompt.data<int64_t>();
+        const size_t prefix_len = static_cast<size_t>(shared_prefix_ratio * request.prompt_len);
+        std::copy_n(shared_prefix.begin(), prefix_len, data);
+        std::generate(data + prefix_len, data + request.prompt_len, [&] { return token(rng); });
+        prompts.push_back(prompt);
+    }
+    return prompts;
+}
+
+nlohmann::json get_percentiles(std::vector<double> values) {
+    if (values.empty())
+        return nullptr;
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) {
+        return values[std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size()))];
+    };
+    return {{"mean", std::accumulate(values.begin(), values.end(), 0.0) / values.size()},
+            {"p50", percentile(50)}, {"p90", percentile(90)}, {"p99", percentile(99)}, {"max", values.back()}};
+}
+
+nlohmann::json run_benchmark(const std::string& models_path,
+                             const std::string& device,
+                             const ov::genai::SchedulerConfig& scheduler_config,
+                             const std::vector<WorkloadRequest>& workload,
+                             const std::vector<ov::Tensor>& prompts) {
+    ov::genai::ContinuousBatchingPipeline pipeline(models_path, scheduler_config, device);
+
+    std::vector<ov::genai::GenerationHandle> handles(workload.size());
+    std::vector<RequestResult> results(workload.size());
+    std::vector<Clock::time_point> arrival_times(workload.size());
+    std::vector<bool> is_finished(workload.size(), false);
+    float max_cache_usage = 0.0f, sum_cache_usage = 0.0f;
+    size_t num_steps = 0;
+
+    const auto start_time = Clock::now();
+    size_t num_added = 0, num_finished = 0;
+    while (num_finished < workload.size()) {
+        const double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start_time).count();
+        for (; num_added < workload.size() && workload[num_added].arrival_time_ms <= elapsed_ms; ++num_added) {
+            ov::genai::GenerationConfig config;
+            config.max_new_tokens = workload[num_added].output_len;
+            config.ignore_eos = true;
+            arrival_times[num_added] = Clock::now();
+            handles[num_added] = pipeline.add_request(num_added, prompts[num_added], config);
+            // outputs are counted instead of being buffered for the whole run
+            handles[num_added]->set_callback([&result = results[num_added]](ov::genai::GenerationOutputs outputs) {
+                for (const auto& output : outputs)
+                    result.num_generated_tokens += output.second.generated_ids.size();
+            });
+        }
+
+        if (!pipeline.has_non_finished_requests()) {
+            const double wait_ms = workload[num_added].arrival_time_ms - elapsed_ms;
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(wait_ms));
+            continue;
+        }
+
+        pipeline.step();
+        ov::genai::PipelineMetrics metrics = pipeline.get_metrics();
+        max_cache_usage = std::max(max_cache_usage, metrics.cache_usage);
+        sum_cache_usage += metrics.cache_usage;
+        ++num_steps;
+
+        const auto now = Clock::now();
+        for (size_t i = 0; i < num_added; ++i) {
+            if (!is_finished[i] && handles[i]->get_status() != ov::genai::GenerationStatus::RUNNING) {
+                is_finished[i] = true;
+                ++num_finished;
+                results[i].timings = handles[i]->get_timings();
+                results[i].e2e_latency_ms = std::chrono::duration<double, std::milli>(now - arrival_times[i]).count();
+            }
+        }
+    }
+    const double duration_s = std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    std::vector<double> ttft_ms, tpot_ms, e2e_latency_ms, queue_wait_ms;
+    size_t num_prompt_tokens = 0, num_generated_tokens = 0, num_preempted_requests = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RequestResult& result = results[i];
+        ttft_ms.push_back(result.timings.ttft_ms);
+        queue_wait_ms.push_back(result.timings.queue_wait_ms);
+        e2e_latency_ms.push_back(result.e2e_latency_ms);
+        const auto& intervals = result.timings.token_intervals_ms;
+        if (!intervals.empty())
+            tpot_ms.push_back(std::accumulate(intervals.begin(), intervals.end(), 0.0) / intervals.size());
+        num_prompt_tokens += workload[i].prompt_len;
+        num_generated_tokens += result.num_generated_tokens;
+        num_preempted_requests += result.timings.num_preemptions > 0;
+    }
+
+    const ov::genai::PipelineMetrics metrics = pipeline.get_metrics();
+    return {
+        {"scheduler_config", {
+            {"max_num_batched_tokens", scheduler_config.max_num_batched_tokens},
+            {"cache_size", scheduler_config.cache_size},
+            {"max_num_seqs", scheduler_config.max_num_seqs},
+            {"enable_prefix_caching", scheduler_config.enable_prefix_caching}}},
+        {"num_requests", workload.size()},
+        {"duration_s", duration_s},
+        {"request_throughput", workload.size() / duration_s},
+        {"output_throughput", num_generated_tokens / duration_s},
+        {"total_token_throughput", (num_prompt_tokens + num_generated_tokens) / duration_s},
+        {"ttft_ms", get_percentiles(ttft_ms)},
+        {"tpot_ms", get_percentiles(tpot_ms)},
+        {"e2e_latency_ms", get_percentiles(e2e_latency_ms)},
+        {"queue_wait_ms", get_percentiles(queue_wait_ms)},
+        {"max_cache_usage", max_cache_usage},
+        {"avg_cache_usage", num_steps > 0 ? sum_cache_usage / num_steps : 0.0f},
+        {"num_steps", metrics.num_steps},
+        {"num_preemptions", metrics.num_preemptions},
+        {"num_preempted_requests", num_preempted_requests},
+        {"prefix_cache_hit_rate", metrics.num_prefix_cache_queried_tokens > 0 ?
+            static_cast<double>(metrics.num_prefix_cache_hit_tokens) / metrics.num_prefix_cache_queried_tokens : 0.0}
+    };
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) try {
+    const Arguments arguments = parse_arguments(argc, argv);
+    const std::string models_path = get_argument(arguments, "models_path", "");
+    OPENVINO_ASSERT(!models_path.empty(), "--models_path is required");
+    const std::string device = get_argument(arguments, "device", "CPU");
+
+    std::mt19937 rng(std::stoul(get_argument(arguments, "seed", "42")));
+    const std::vector<WorkloadRequest> workload = make_workload(arguments, rng);
+    OPENVINO_ASSERT(!workload.empty(), "Workload has no requests");
+    const std::vector<ov::Tensor> prompts = make_prompts(workload, std::stod(get_argument(arguments, "shared_prefix_ratio", "0")), rng);
+
+    nlohmann::json runs = nlohmann::json::array();
+    for (size_t max_num_batched_tokens : get_sweep(arguments, "max_num_batched_tokens", 256)) {
+        for (size_t cache_size : get_sweep(arguments, "cache_size", 1)) {
+            for (size_t max_num_seqs : get_sweep(arguments, "max_num_seqs", 256)) {
+                for (size_t enable_prefix_caching : get_sweep(arguments, "enable_prefix_caching", 0)) {
+                    ov::genai::SchedulerConfig scheduler_config;
+                    scheduler_config.max_num_batched_tokens = max_num_batched_tokens;
+                    scheduler_config.cache_size = cache_size;
+                    scheduler_config.max_num_seqs = max_num_seqs;
+                    scheduler_config.enable_prefix_caching = enable_prefix_caching != 0;
+                    runs.push_back(run_benchmark(models_path, device, scheduler_config, workload, prompts));
+                    std::cerr << runs.back().dump() << std::endl;
+                }
+            }
+        }
+    }
+
+    const std::string report = nlohmann::json{{"device", device}, {"runs", runs}}.dump(2);
+    const std::string output_path = get_argument(arguments, "output", "");
+    if (output_path.empty()) {
+        std::cout << report << std::endl;
+    } else {
+        std::ofstream file(output_path);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", output_path);
+        file << report << std::endl;
+    }
+    return EXIT_SUCCESS;
+} catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,361 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Micro-benchmarks of CPU-side hot paths of the continuous batching engine on synthetic inputs, so that their cost can be
+// tracked independently of a model: Sampler::sample, LogitProcessor::apply, BlockManager::allocate / append_slots /
+// restore_cached_blocks, CacheEvictionAlgorithm::evict_logical_blocks and, if a tokenizer is passed, Tokenizer::encode.
+// Each measurement is printed as a JSON line with per-iteration time statistics in microseconds.
+//
+// Usage:
+//   engine_benchmark [--filter <substring>] [--vocab_sizes 32000,128256,256000] [--batch_sizes 1,8,64,512]
+//       [--num_blocks 1000,10000,100000] [--block_size 32] [--num_tokens 1024,8192,32768] [--tokenizer_path <dir>]
+//       [--min_time_ms 500] [--seed 42]
+//
+// The executable is built from sources of the library, since the benchmarked classes are not exported.
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "block_manager.hpp"
+#include "cache_eviction.hpp"
+#include "logit_processor.hpp"
+#include "sampler.hpp"
+#include "sequence_group.hpp"
+
+using namespace ov::genai;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Arguments = std::map<std::string, std::string>;
+
+Arguments parse_arguments(int argc, char* argv[]) {
+    Arguments arguments;
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        OPENVINO_ASSERT(name.rfind("--", 0) == 0 && i + 1 < argc, "Expected '--<name> <value>' arguments, got ", name);
+        arguments[name.substr(2)] = argv[i + 1];
+    }
+    return arguments;
+}
+
+std::string get_argument(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    auto it = arguments.find(name);
+    return it == arguments.end() ? default_value : it->second;
+}
+
+std::vector<size_t> get_list(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    std::vector<size_t> values;
+    std::stringstream stream(get_argument(arguments, name, default_value));
+    for (std::string value; std::getline(stream, value, ',');) {
+        values.push_back(std::stoul(value));
+    }
+    return values;
+}
+
+class Benchmark {
+public:
+    Benchmark(const std::string& filter, double min_time_ms) : m_filter(filter), m_min_time_ms(min_time_ms) {}
+
+    bool is_selected(const std::string& name) const {
+        return m_filter.empty() || name.find(m_filter) != std::string::npos;
+    }
+
+    /**
+     * Runs iterations until min_time_ms of measured time is accumulated and prints their statistics.
+     * @param iteration Performs an iteration and returns its measured duration, so that it can exclude preparation of inputs.
+     */
+    void run(const std::string& name, const nlohmann::json& parameters, const std::function<Clock::duration()>& iteration) {
+        // the first iteration warms up caches and lazily created state
+        iteration();
+        std::vector<double> durations_us;
+        for (double total_us = 0.0; total_us < m_min_time_ms * 1000.0 || durations_us.size() < MIN_ITERATIONS;) {
+            durations_us.push_back(std::chrono::duration<double, std::micro>(iteration()).count());
+            total_us += durations_us.back();
+        }
+        std::sort(durations_us.begin(), durations_us.end());
+        auto percentile = [&durations_us](double p) {
+            return durations_us[std::min(durations_us.size() - 1, static_cast<size_t>(p / 100.0 * durations_us.size()))];
+        };
+        nlohmann::json result = {
+            {"benchmark", name},
+            {"parameters", parameters},
+            {"iterations", durations_us.size()},
+            {"mean_us", std::accumulate(durations_us.begin(), durations_us.end(), 0.0) / durations_us.size()},
+            {"p50_us", percentile(50)},
+            {"p99_us", percentile(99)},
+            {"min_us", durations_us.front()}
+        };
+        std::cout << result.dump() << std::endl;
+    }
+
+private:
+    static constexpr size_t MIN_ITERATIONS = 10;
+    std::string m_filter;
+    double m_min_time_ms;
+};
+
+template <typename Function>
+Clock::duration measure(Function&& function) {
+    const auto start = Clock::now();
+    function();
+    return Clock::now() - start;
+}
+
+std::vector<float> make_logits(size_t size, std::mt19937& rng) {
+    std::normal_distribution<float> distribution(0.0f, 4.0f);
+    std::vector<float> logits(size);
+    std::generate(logits.begin(), logits.end(), [&] { return distribution(rng); });
+    return logits;
+}
+
+GenerationConfig make_generation_config(const std::string& mode) {
+    GenerationConfig config;
+    config.max_new_tokens = std::numeric_limits<size_t>::max() / 2;
+    config.ignore_eos = true;
+    if (mode == "multinomial") {
+        config.do_sample = true;
+        config.temperature = 0.7f;
+        config.top_p = 0.9f;
+        config.top_k = 50;
+        config.repetition_penalty = 1.1f;
+    }
+    return config;
+}
+
+std::vector<SequenceGroup::Ptr> make_sequence_groups(size_t batch_size, const TokenIds& prompt, const GenerationConfig& config,
+                                                     size_t block_size, bool enable_prefix_caching, uint64_t first_request_id = 0) {
+    std::vector<SequenceGroup::Ptr> sequence_groups;
+    for (size_t i = 0; i < batch_size; ++i) {
+        sequence_groups.push_back(std::make_shared<SequenceGroup>(first_request_id + i, prompt, config, block_size, enable_prefix_caching));
+    }
+    return sequence_groups;
+}
+
+// decoding steps of a batch, logits are restored before each step, since some of the transforms modify them in place
+void benchmark_sampler(Benchmark& benchmark, size_t vocab_size, size_t batch_size, const std::string& mode, std::mt19937& rng) {
+    const std::vector<float> reference_logits = make_logits(batch_size * vocab_size, rng);
+    ov::Tensor logits(ov::element::f32, {batch_size, 1, vocab_size});
+    const GenerationConfig config = make_generation_config(mode);
+
+    Sampler sampler;
+    std::vector<SequenceGroup::Ptr> sequence_groups = make_sequence_groups(batch_size, {1}, config, 32, false);
+    size_t num_steps = 0;
+    benchmark.run("sampler_sample", {{"mode", mode}, {"vocab_size", vocab_size}, {"batch_size", batch_size}}, [&] {
+        // generated sequences grow with each step, they are restarted to keep the measured state stable
+        if (++num_steps % 256 == 0) {
+            for (const auto& sequence_group : sequence_groups)
+                sampler.clear_request_info(sequence_group->get_request_id());
+            sequence_groups = make_sequence_groups(batch_size, {1}, config, 32, false, num_steps * batch_size);
+        }
+        std::copy(reference_logits.begin(), reference_logits.end(), logits.data<float>());
+        for (const auto& sequence_group : sequence_groups)
+            sequence_group->schedule_tokens(1);
+        return measure([&] { sampler.sample(sequence_groups, logits); });
+    });
+}
+
+void benchmark_logit_processor(Benchmark& benchmark, size_t vocab_size, const std::string& mode, std::mt19937& rng) {
+    const std::vector<float> reference_logits = make_logits(vocab_size, rng);
+    std::vector<float> logits_data(vocab_size);
+    TokenIds prompt(1024);
+    std::uniform_int_distribution<int64_t> token(0, vocab_size - 1);
+    std::generate(prompt.begin(), prompt.end(), [&] { return token(rng); });
+
+    LogitProcessor logit_processor(make_generation_config(mode), prompt);
+    benchmark.run("logit_processor_apply", {{"mode", mode}, {"vocab_size", vocab_size}}, [&] {
+        std::copy(reference_logits.begin(), reference_logits.end(), logits_data.begin());
+        Logits logits(logits_data.data(), vocab_size);
+        auto duration = measure([&] { logit_processor.apply(logits); });
+        logit_processor.release_candidates(logits);
+        return duration;
+    });
+}
+
+// allocation and release of a sequence's blocks, while half of the cache is occupied by other sequences
+void benchmark_block_manager_allocate(Benchmark& benchmark, size_t num_blocks, size_t block_size) {
+    const size_t blocks_per_sequence = 16;
+    if (num_blocks < 4 * blocks_per_sequence)
+        return;
+
+    BlockManager block_manager(num_blocks, false, block_size);
+    const GenerationConfig config = make_generation_config("greedy");
+    std::vector<SequenceGroup::Ptr> occupying_groups = make_sequence_groups(num_blocks / 2 / blocks_per_sequence, {1}, config, block_size, false);
+    for (const auto& sequence_group : occupying_groups)
+        block_manager.allocate((*sequence_group)[0], blocks_per_sequence);
+
+    SequenceGroup::Ptr sequence_group = make_sequence_groups(1, {1}, config, block_size, false, occupying_groups.size())[0];
+    Sequence::Ptr sequence = (*sequence_group)[0];
+    benchmark.run("block_manager_allocate", {{"num_blocks", num_blocks}, {"block_size", block_size}, {"blocks_per_sequence", blocks_per_sequence}}, [&] {
+        return measure([&] {
+            block_manager.allocate(sequence, blocks_per_sequence);
+            block_manager.free_sequence(sequence->get_id());
+        });
+    });
+}
+
+// a decoding step of a batch: each sequence gets a slot for its next token
+void benchmark_block_manager_append_slots(Benchmark& benchmark, size_t num_blocks, size_t block_size, size_t batch_size) {
+    const size_t prompt_len = 256;
+    const size_t num_prompt_blocks = (prompt_len + block_size - 1) / block_size;
+    // each restart of the batch leaves room for at least one block per sequence
+    if (batch_size * (num_prompt_blocks + 2) > num_blocks)
+        return;
+
+    BlockManager block_manager(num_blocks, false, block_size);
+    const GenerationConfig config = make_generation_config("greedy");
+    const TokenIds prompt(prompt_len, 1);
+    std::vector<SequenceGroup::Ptr> sequence_groups;
+    uint64_t next_request_id = 0;
+    auto restart_batch = [&] {
+        for (const auto& sequence_group : sequence_groups)
+            block_manager.free_sequence((*sequence_group)[0]->get_id());
+        sequence_groups = make_sequence_groups(batch_size, prompt, config, block_size, false, next_request_id);
+        next_request_id += batch_size;
+        for (const auto& sequence_group : sequence_groups) {
+            sequence_group->schedule_tokens(prompt_len);
+            block_manager.append_slots(sequence_group);
+            sequence_group->finish_iteration();
+            (*sequence_group)[0]->append_token(1, 0.0f);
+        }
+    };
+    restart_batch();
+
+    benchmark.run("block_manager_append_slots", {{"num_blocks", num_blocks}, {"block_size", block_size}, {"batch_size", batch_size}}, [&] {
+        if (block_manager.num_free_blocks() < batch_size)
+            restart_batch();
+        for (const auto& sequence_group : sequence_groups)
+            sequence_group->schedule_tokens(1);
+        auto duration = measure([&] {
+            for (const auto& sequence_group : sequence_groups)
+                block_manager.append_slots(sequence_group);
+        });
+        for (const auto& sequence_group : sequence_groups) {
+            sequence_group->finish_iteration();
+            (*sequence_group)[0]->append_token(1, 0.0f);
+        }
+        return duration;
+    });
+}
+
+// lookup of a prompt, whose blocks were released by a previous request with the same prompt, in the prefix cache
+void benchmark_block_manager_restore_cached_blocks(Benchmark& benchmark, size_t num_blocks, size_t block_size, std::mt19937& rng) {
+    const size_t prompt_len = std::min<size_t>(4096, num_blocks / 2 * block_size);
+    TokenIds prompt(prompt_len);
+    std::uniform_int_distribution<int64_t> token(0, 32000);
+    std::generate(prompt.begin(), prompt.end(), [&] { return token(rng); });
+
+    BlockManager block_manager(num_blocks, true, block_size);
+    const GenerationConfig config = make_generation_config("greedy");
+    SequenceGroup::Ptr cached_group = make_sequence_groups(1, prompt, config, block_size, true)[0];
+    cached_group->schedule_tokens(prompt_len);
+    block_manager.append_slots(cached_group);
+    cached_group->finish_iteration();
+    block_manager.free_sequence((*cached_group)[0]->get_id());
+
+    uint64_t next_request_id = 1;
+    benchmark.run("block_manager_restore_cached_blocks", {{"num_blocks", num_blocks}, {"block_size", block_size}, {"prompt_len", prompt_len}}, [&] {
+        SequenceGroup::Ptr sequence_group = make_sequence_groups(1, prompt, config, block_size, true, next_request_id++)[0];
+        auto duration = measure([&] { block_manager.restore_cached_blocks(sequence_group); });
+        block_manager.free_sequence((*sequence_group)[0]->get_id());
+        return duration;
+    });
+}
+
+// compression of a sequence's cache, which exceeds the configured size, after registration of scores of all its tokens
+void benchmark_cache_eviction(Benchmark& benchmark, size_t num_tokens, size_t block_size, std::mt19937& rng) {
+    const size_t num_decoder_layers = 32;
+    const CacheEvictionConfig eviction_config(4 * block_size, 4 * block_size, 32 * block_size, AggregationMode::NORM_SUM);
+    if (num_tokens <= eviction_config.get_max_cache_size())
+        return;
+
+    AttentionScoresForEachDecoderLayer scores(num_decoder_layers);
+    std::uniform_real_distribution<float> score(0.0f, 1.0f);
+    for (auto& layer_scores : scores) {
+        layer_scores = ov::Tensor(ov::element::f32, {num_tokens});
+        std::generate_n(layer_scores.data<float>(), num_tokens, [&] { return score(rng); });
+    }
+
+    benchmark.run("cache_eviction_evict_logical_blocks", {{"num_tokens", num_tokens}, {"block_size", block_size}, {"num_decoder_layers", num_decoder_layers}}, [&] {
+        CacheEvictionAlgorithm algorithm(eviction_config, block_size, num_decoder_layers);
+        return measure([&] {
+            algorithm.register_new_token_scores(scores);
+            algorithm.evict_logical_blocks();
+        });
+    });
+}
+
+void benchmark_tokenizer(Benchmark& benchmark, const std::string& tokenizer_path, size_t num_words, std::mt19937& rng) {
+    static const std::vector<std::string> words = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "continuous",
+        "batching", "scheduler", "allocates", "blocks", "for", "every", "sequence", "in", "a", "step", "tokens", "12345", ",", "."};
+    std::uniform_int_distribution<size_t> word(0, words.size() - 1);
+    std::string text;
+    for (size_t i = 0; i < num_words; ++i)
+        text += (i ? " " : "") + words[word(rng)];
+
+    static Tokenizer tokenizer(tokenizer_path);
+    benchmark.run("tokenizer_encode", {{"num_words", num_words}}, [&] {
+        return measure([&] { tokenizer.encode(text); });
+    });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) try {
+    const Arguments arguments = parse_arguments(argc, argv);
+    Benchmark benchmark(get_argument(arguments, "filter", ""), std::stod(get_argument(arguments, "min_time_ms", "500")));
+    std::mt19937 rng(std::stoul(get_argument(arguments, "seed", "42")));
+
+    const std::vector<size_t> vocab_sizes = get_list(arguments, "vocab_sizes", "32000,128256,256000");
+    const std::vector<size_t> batch_sizes = get_list(arguments, "batch_sizes", "1,8,64,512");
+    const std::vector<size_t> num_blocks_list = get_list(arguments, "num_blocks", "1000,10000,100000");
+    const std::vector<size_t> num_tokens_list = get_list(arguments, "num_tokens", "1024,8192,32768");
+    const size_t block_size = std::stoul(get_argument(arguments, "block_size", "32"));
+
+    for (const std::string mode : {"greedy", "multinomial"}) {
+        for (size_t vocab_size : vocab_sizes) {
+            if (benchmark.is_selected("logit_processor_apply"))
+                benchmark_logit_processor(benchmark, vocab_size, mode, rng);
+            for (size_t batch_size : batch_sizes) {
+                if (benchmark.is_selected("sampler_sample"))
+                    benchmark_sampler(benchmark, vocab_size, batch_size, mode, rng);
+            }
+        }
+    }
+
+    for (size_t num_blocks : num_blocks_list) {
+        if (benchmark.is_selected("block_manager_allocate"))
+            benchmark_block_manager_allocate(benchmark, num_blocks, block_size);
+        for (size_t batch_size : batch_sizes) {
+            if (benchmark.is_selected("block_manager_append_slots"))
+                benchmark_block_manager_append_slots(benchmark, num_blocks, block_size, batch_size);
+        }
+        if (benchmark.is_selected("block_manager_restore_cached_blocks"))
+            benchmark_block_manager_restore_cached_blocks(benchmark, num_blocks, block_size, rng);
+    }
+
+    for (size_t num_tokens : num_tokens_list) {
+        if (benchmark.is_selected("cache_eviction_evict_logical_blocks"))
+            benchmark_cache_eviction(benchmark, num_tokens, block_size, rng);
+    }
+
+    const std::string tokenizer_path = get_argument(arguments, "tokenizer_path", "");
+    if (!tokenizer_path.empty() && benchmark.is_selected("tokenizer_encode")) {
+        for (size_t num_words : {16, 256, 4096})
+            benchmark_tokenizer(benchmark, tokenizer_path, num_words, rng);
+    }
+    return EXIT_SUCCESS;
+} catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,177 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures throughput and per-stage latency of Text2ImagePipeline for combinations of resolutions and numbers of
+// inference steps and reports them as JSON.
+//
+// Usage:
+//   text2image_benchmark --models_path <dir> [--device CPU] [--prompt <text>] [--resolutions 512x512,1024x1024]
+//       [--num_inference_steps 20,50] [--num_images_per_prompt 1] [--num_iterations 3] [--output <file>]
+//
+// Stages are delimited by step callbacks: the callback is called after each denoising step, so time before the first
+// callback minus a step is spent on prompt encoding and latents preparation, and time after the last callback is spent
+// on VAE decoding.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openvino/genai/image_generation/text2image_pipeline.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Arguments = std::map<std::string, std::string>;
+
+struct Resolution {
+    int64_t height, width;
+};
+
+struct StageTimings {
+    double total_ms = 0.0, prepare_ms = 0.0, denoising_ms = 0.0, step_ms = 0.0, decode_ms = 0.0;
+};
+
+Arguments parse_arguments(int argc, char* argv[]) {
+    Arguments arguments;
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        OPENVINO_ASSERT(name.rfind("--", 0) == 0 && i + 1 < argc, "Expected '--<name> <value>' arguments, got ", name);
+        arguments[name.substr(2)] = argv[i + 1];
+    }
+    return arguments;
+}
+
+std::string get_argument(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    auto it = arguments.find(name);
+    return it == arguments.end() ? default_value : it->second;
+}
+
+std::vector<std::string> get_list(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    std::vector<std::string> values;
+    std::stringstream stream(get_argument(arguments, name, default_value));
+    for (std::string value; std::getline(stream, value, ',');) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+Resolution parse_resolution(const std::string& resolution) {
+    const size_t separator = resolution.find('x');
+    OPENVINO_ASSERT(separator != std::string::npos, "Resolution must be in <height>x<width> format, got ", resolution);
+    return {std::stoll(resolution.substr(0, separator)), std::stoll(resolution.substr(separator + 1))};
+}
+
+StageTimings run_generation(ov::genai::Text2ImagePipeline& pipeline, const std::string& prompt, const Resolution& resolution,
+                            size_t num_inference_steps, size_t num_images_per_prompt) {
+    std::vector<Clock::time_point> step_ends;
+    auto callback = [&step_ends](size_t step, size_t num_steps, ov::Tensor& latent) {
+        step_ends.push_back(Clock::now());
+        return false;
+    };
+
+    const auto start = Clock::now();
+    pipeline.generate(prompt,
+                      ov::genai::height(resolution.height),
+                      ov::genai::width(resolution.width),
+                      ov::genai::num_inference_steps(num_inference_steps),
+                      ov::genai::num_images_per_prompt(num_images_per_prompt),
+                      ov::genai::callback(callback));
+    const auto end = Clock::now();
+    OPENVINO_ASSERT(!step_ends.empty(), "Pipeline did not perform denoising steps");
+
+    auto milliseconds = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+    StageTimings timings;
+    timings.total_ms = milliseconds(start, end);
+    // duration of the first step isn't observed, it's estimated by the following ones
+    timings.step_ms = step_ends.size() > 1 ? milliseconds(step_ends.front(), step_ends.back()) / (step_ends.size() - 1)
+                                           : milliseconds(start, step_ends.front());
+    timings.denoising_ms = milliseconds(step_ends.front(), step_ends.back()) + timings.step_ms;
+    timings.prepare_ms = std::max(0.0, milliseconds(start, step_ends.front()) - timings.step_ms);
+    timings.decode_ms = milliseconds(step_ends.back(), end);
+    return timings;
+}
+
+nlohmann::json get_mean_and_std(const std::vector<double>& values) {
+    const double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    double variance = 0.0;
+    for (double value : values)
+        variance += (value - mean) * (value - mean);
+    return {{"mean", mean}, {"std", std::sqrt(variance / values.size())}};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) try {
+    const Arguments arguments = parse_arguments(argc, argv);
+    const std::string models_path = get_argument(arguments, "models_path", "");
+    OPENVINO_ASSERT(!models_path.empty(), "--models_path is required");
+    const std::string device = get_argument(arguments, "device", "CPU");
+    const std::string prompt = get_argument(arguments, "prompt", "a photo of an astronaut riding a horse on mars");
+    const size_t num_images_per_prompt = std::stoul(get_argument(arguments, "num_images_per_prompt", "1"));
+    const size_t num_iterations = std::stoul(get_argument(arguments, "num_iterations", "3"));
+    OPENVINO_ASSERT(num_iterations > 0, "--num_iterations must be positive");
+
+    const auto load_start = Clock::now();
+    ov::genai::Text2ImagePipeline pipeline(models_path, device);
+    const double load_time_ms = std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+
+    nlohmann::json runs = nlohmann::json::array();
+    for (const std::string& resolution_str : get_list(arguments, "resolutions", "512x512")) {
+        const Resolution resolution = parse_resolution(resolution_str);
+        for (const std::string& num_steps_str : get_list(arguments, "num_inference_steps", "20")) {
+            const size_t num_inference_steps = std::stoul(num_steps_str);
+            // warm up, the first generation for a resolution includes shape dependent compilation
+            run_generation(pipeline, prompt, resolution, num_inference_steps, num_images_per_prompt);
+
+            std::vector<double> total_ms, prepare_ms, denoising_ms, step_ms, decode_ms;
+            for (size_t iteration = 0; iteration < num_iterations; ++iteration) {
+                const StageTimings timings = run_generation(pipeline, prompt, resolution, num_inference_steps, num_images_per_prompt);
+                total_ms.push_back(timings.total_ms);
+                prepare_ms.push_back(timings.prepare_ms);
+                denoising_ms.push_back(timings.denoising_ms);
+                step_ms.push_back(timings.step_ms);
+                decode_ms.push_back(timings.decode_ms);
+            }
+            const double mean_total_ms = std::accumulate(total_ms.begin(), total_ms.end(), 0.0) / total_ms.size();
+            runs.push_back({
+                {"height", resolution.height},
+                {"width", resolution.width},
+                {"num_inference_steps", num_inference_steps},
+                {"num_images_per_prompt", num_images_per_prompt},
+                {"images_per_second", num_images_per_prompt * 1000.0 / mean_total_ms},
+                {"total_ms", get_mean_and_std(total_ms)},
+                {"prepare_ms", get_mean_and_std(prepare_ms)},
+                {"denoising_ms", get_mean_and_std(denoising_ms)},
+                {"denoising_step_ms", get_mean_and_std(step_ms)},
+                {"decode_ms", get_mean_and_std(decode_ms)}
+            });
+            std::cerr << runs.back().dump() << std::endl;
+        }
+    }
+
+    const std::string report = nlohmann::json{{"device", device}, {"models_path", models_path}, {"load_time_ms", load_time_ms},
+                                              {"runs", runs}}.dump(2);
+    const std::string output_path = get_argument(arguments, "output", "");
+    if (output_path.empty()) {
+        std::cout << report << std::endl;
+    } else {
+        std::ofstream file(output_path);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", output_path);
+        file << report << std::endl;
+    }
+    return EXIT_SUCCESS;
+} catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+}
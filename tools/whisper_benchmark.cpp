@@ -0,0 +1,260 @@
+// Copyright (C) 2023-2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures real-time factor of WhisperPipeline over a manifest of audio files and reports it as JSON.
+//
+// Usage:
+//   whisper_benchmark --models_path <dir> --manifest <file> [--device CPU] [--mode long_form|batched|all]
+//       [--batch_sizes 1,4,8] [--num_iterations 1] [--output <file>]
+//
+// Manifest is a JSON lines file of objects with "path" to an audio file and optional "duration_s". Long-form mode
+// transcribes files one by one with generate() for a file path, so audio longer than 30 seconds is processed window by
+// window; duration of FLAC files must be set in the manifest for this mode. Batched mode decodes all files to memory and
+// transcribes them together by batched generate() for each batch size, which requires 16 kHz WAV files.
+// Real-time factor is processing time divided by audio duration, so values below 1 are faster than real time.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openvino/genai/whisper_pipeline.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Arguments = std::map<std::string, std::string>;
+
+constexpr size_t SAMPLING_RATE = 16000;
+
+struct ManifestEntry {
+    std::string path;
+    float duration_s;
+};
+
+Arguments parse_arguments(int argc, char* argv[]) {
+    Arguments arguments;
+    for (int i = 1; i < argc; i += 2) {
+        std::string name = argv[i];
+        OPENVINO_ASSERT(name.rfind("--", 0) == 0 && i + 1 < argc, "Expected '--<name> <value>' arguments, got ", name);
+        arguments[name.substr(2)] = argv[i + 1];
+    }
+    return arguments;
+}
+
+std::string get_argument(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    auto it = arguments.find(name);
+    return it == arguments.end() ? default_value : it->second;
+}
+
+std::vector<size_t> get_list(const Arguments& arguments, const std::string& name, const std::string& default_value) {
+    std::vector<size_t> values;
+    std::stringstream stream(get_argument(arguments, name, default_value));
+    for (std::string value; std::getline(stream, value, ',');) {
+        values.push_back(std::stoul(value));
+    }
+    return values;
+}
+
+struct WavFile {
+    uint16_t format = 0, num_channels = 0, bits_per_sample = 0;
+    uint32_t sampling_rate = 0;
+    std::vector<char> data;
+};
+
+// reads chunks of RIFF WAV file needed to decode integer PCM or IEEE float samples
+WavFile read_wav(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", path);
+    char riff_header[12];
+    file.read(riff_header, sizeof(riff_header));
+    OPENVINO_ASSERT(file && std::memcmp(riff_header, "RIFF", 4) == 0 && std::memcmp(riff_header + 8, "WAVE", 4) == 0,
+                    path, " is not a WAV file");
+
+    WavFile wav;
+    char chunk_id[4];
+    uint32_t chunk_size;
+    while (file.read(chunk_id, 4) && file.read(reinterpret_cast<char*>(&chunk_size), sizeof(chunk_size))) {
+        if (std::memcmp(chunk_id, "fmt ", 4) == 0) {
+            std::vector<char> fmt(chunk_size);
+            file.read(fmt.data(), chunk_size);
+            std::memcpy(&wav.format, fmt.data(), 2);
+            std::memcpy(&wav.num_channels, fmt.data() + 2, 2);
+            std::memcpy(&wav.sampling_rate, fmt.data() + 4, 4);
+            std::memcpy(&wav.bits_per_sample, fmt.data() + 14, 2);
+        } else if (std::memcmp(chunk_id, "data", 4) == 0) {
+            wav.data.resize(chunk_size);
+            file.read(wav.data.data(), chunk_size);
+            break;
+        } else {
+            // chunks are padded to even size
+            file.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+        }
+    }
+    OPENVINO_ASSERT(wav.num_channels > 0 && wav.bits_per_sample > 0 && !wav.data.empty(), "Failed to read samples of ", path);
+    return wav;
+}
+
+float get_duration_s(const WavFile& wav) {
+    return static_cast<float>(wav.data.size()) / (wav.sampling_rate * wav.num_channels * (wav.bits_per_sample / 8));
+}
+
+// decodes 16 kHz WAV file to mono samples in [-1, 1] range
+ov::genai::RawSpeechInput read_raw_speech(const std::string& path) {
+    const WavFile wav = read_wav(path);
+    OPENVINO_ASSERT(wav.sampling_rate == SAMPLING_RATE, "Batched mode requires ", SAMPLING_RATE, " Hz audio, ", path, " has ", wav.sampling_rate, " Hz");
+    const size_t bytes_per_sample = wav.bits_per_sample / 8;
+    const size_t num_frames = wav.data.size() / (bytes_per_sample * wav.num_channels);
+
+    auto read_sample = [&](size_t index) -> float {
+        const char* sample = wav.data.data() + index * bytes_per_sample;
+        if (wav.format == 3 && wav.bits_per_sample == 32) {
+            float value;
+            std::memcpy(&value, sample, sizeof(value));
+            return value;
+        }
+        OPENVINO_ASSERT(wav.format == 1 && (wav.bits_per_sample == 16 || wav.bits_per_sample == 32), "Unsupported WAV sample format of ", path);
+        if (wav.bits_per_sample == 16) {
+            int16_t value;
+            std::memcpy(&value, sample, sizeof(value));
+            return value / 32768.0f;
+        }
+        int32_t value;
+        std::memcpy(&value, sample, sizeof(value));
+        return value / 2147483648.0f;
+    };
+
+    ov::genai::RawSpeechInput raw_speech(num_frames);
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        float sum = 0.0f;
+        for (size_t channel = 0; channel < wav.num_channels; ++channel)
+            sum += read_sample(frame * wav.num_channels + channel);
+        raw_speech[frame] = sum / wav.num_channels;
+    }
+    return raw_speech;
+}
+
+std::vector<ManifestEntry> read_manifest(const std::string& manifest_path) {
+    std::ifstream file(manifest_path);
+    OPENVINO_ASSERT(file.is_open(), "Failed to open ", manifest_path);
+    std::vector<ManifestEntry> manifest;
+    for (std::string line; std::getline(file, line);) {
+        if (line.empty())
+            continue;
+        const nlohmann::json entry = nlohmann::json::parse(line);
+        const std::string path = entry.at("path").get<std::string>();
+        const float duration_s = entry.contains("duration_s") ? entry["duration_s"].get<float>() : get_duration_s(read_wav(path));
+        manifest.push_back({path, duration_s});
+    }
+    OPENVINO_ASSERT(!manifest.empty(), "Manifest ", manifest_path, " has no entries");
+    return manifest;
+}
+
+nlohmann::json to_json(ov::genai::MeanStdPair value) {
+    return {{"mean", value.mean}, {"std", value.std}};
+}
+
+nlohmann::json run_long_form(ov::genai::WhisperPipeline& pipeline, const std::vector<ManifestEntry>& manifest, size_t num_iterations) {
+    nlohmann::json files = nlohmann::json::array();
+    double total_processing_s = 0.0, total_duration_s = 0.0;
+    for (const ManifestEntry& entry : manifest) {
+        std::vector<double> processing_s;
+        ov::genai::WhisperPerfMetrics perf_metrics;
+        for (size_t iteration = 0; iteration < num_iterations; ++iteration) {
+            const auto start = Clock::now();
+            ov::genai::WhisperDecodedResults result = pipeline.generate(std::filesystem::path(entry.path));
+            processing_s.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+            perf_metrics = iteration == 0 ? result.perf_metrics : perf_metrics + result.perf_metrics;
+        }
+        const double mean_processing_s = std::accumulate(processing_s.begin(), processing_s.end(), 0.0) / processing_s.size();
+        total_processing_s += mean_processing_s;
+        total_duration_s += entry.duration_s;
+        files.push_back({
+            {"path", entry.path},
+            {"duration_s", entry.duration_s},
+            {"processing_s", mean_processing_s},
+            {"rtf", mean_processing_s / entry.duration_s},
+            {"features_extraction_ms", to_json(perf_metrics.get_features_extraction_duration())},
+            {"ttft_ms", to_json(perf_metrics.get_ttft())},
+            {"tpot_ms", to_json(perf_metrics.get_tpot())},
+            {"num_generated_tokens", perf_metrics.get_num_generated_tokens()}
+        });
+    }
+    return {{"mode", "long_form"}, {"audio_duration_s", total_duration_s}, {"processing_s", total_processing_s},
+            {"rtf", total_processing_s / total_duration_s}, {"files", files}};
+}
+
+nlohmann::json run_batched(ov::genai::WhisperPipeline& pipeline, const std::vector<ManifestEntry>& manifest,
+                           const std::vector<size_t>& batch_sizes, size_t num_iterations) {
+    std::vector<ov::genai::RawSpeechInput> raw_speech_inputs;
+    double total_duration_s = 0.0;
+    for (const ManifestEntry& entry : manifest) {
+        raw_speech_inputs.push_back(read_raw_speech(entry.path));
+        total_duration_s += static_cast<double>(raw_speech_inputs.back().size()) / SAMPLING_RATE;
+    }
+
+    nlohmann::json runs = nlohmann::json::array();
+    for (size_t batch_size : batch_sizes) {
+        double processing_s = 0.0;
+        for (size_t iteration = 0; iteration < num_iterations; ++iteration) {
+            const auto start = Clock::now();
+            pipeline.generate(raw_speech_inputs, std::nullopt, batch_size);
+            processing_s += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        processing_s /= num_iterations;
+        runs.push_back({{"max_batch_size", batch_size}, {"processing_s", processing_s}, {"rtf", processing_s / total_duration_s},
+                        {"audio_seconds_per_second", total_duration_s / processing_s}});
+    }
+    return {{"mode", "batched"}, {"audio_duration_s", total_duration_s}, {"runs", runs}};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) try {
+    const Arguments arguments = parse_arguments(argc, argv);
+    const std::string models_path = get_argument(arguments, "models_path", "");
+    const std::string manifest_path = get_argument(arguments, "manifest", "");
+    OPENVINO_ASSERT(!models_path.empty() && !manifest_path.empty(), "--models_path and --manifest are required");
+    const std::string device = get_argument(arguments, "device", "CPU");
+    const std::string mode = get_argument(arguments, "mode", "all");
+    OPENVINO_ASSERT(mode == "long_form" || mode == "batched" || mode == "all", "Unknown mode ", mode);
+    const size_t num_iterations = std::stoul(get_argument(arguments, "num_iterations", "1"));
+    OPENVINO_ASSERT(num_iterations > 0, "--num_iterations must be positive");
+
+    const std::vector<ManifestEntry> manifest = read_manifest(manifest_path);
+
+    const auto load_start = Clock::now();
+    ov::genai::WhisperPipeline pipeline(models_path, device);
+    const double load_time_ms = std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+    // warm up, so that the first measured file doesn't include lazy initialization
+    pipeline.generate(std::filesystem::path(manifest.front().path));
+
+    nlohmann::json results = nlohmann::json::array();
+    if (mode != "batched")
+        results.push_back(run_long_form(pipeline, manifest, num_iterations));
+    if (mode != "long_form")
+        results.push_back(run_batched(pipeline, manifest, get_list(arguments, "batch_sizes", "1,4,8"), num_iterations));
+
+    const std::string report = nlohmann::json{{"device", device}, {"models_path", models_path}, {"load_time_ms", load_time_ms},
+                                              {"results", results}}.dump(2);
+    const std::string output_path = get_argument(arguments, "output", "");
+    if (output_path.empty()) {
+        std::cout << report << std::endl;
+    } else {
+        std::ofstream file(output_path);
+        OPENVINO_ASSERT(file.is_open(), "Failed to open ", output_path);
+        file << report << std::endl;
+    }
+    return EXIT_SUCCESS;
+} catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+}